@@ -94,10 +94,16 @@ class MessagesQueue final {
   // Stores message into a file archive (if SetStorageDirectory was called with a valid directory),
   // otherwise stores messages in-memory.
   // Executed on the WorkerThread.
+  // Messages are batched: only the message which comes to the empty buffer adds a command,
+  // the command stores all the messages which were appended to the buffer before it runs.
   void PushMessage(const std::string & message) {
     {
       std::lock_guard<std::mutex> lock(messages_mutex_);
+      const bool command_is_pending = !messages_buffer_.empty();
       messages_buffer_.append(message);
+      if (command_is_pending) {
+        return;
+      }
     }
     std::lock_guard<std::mutex> lock(commands_mutex_);
     commands_queue_.push_back(std::bind(&MessagesQueue::ProcessMessageCommand, this));
@@ -267,6 +273,7 @@ class MessagesQueue final {
  private:
   TFileArchiver file_archiver_;
   // Synchronized buffer to pass messages between threads.
+  // It's not empty only when ProcessMessageCommand is in the commands queue.
   std::string messages_buffer_;
   // Directory with a slash at the end, where we store "current" file and archived files.
   std::string storage_directory_;
@@ -24,7 +24,7 @@ ifeq ($(NDK_DEBUG),1)
   APP_CFLAGS += -DDEBUG -D_DEBUG
 else
   APP_OPTIM := release
-  APP_CFLAGS += -DRELEASE -D_RELEASE
+  APP_CFLAGS += -DRELEASE -D_RELEASE -DOMIM_LOG_MIN_LEVEL=LINFO
 ifeq ($(PRODUCTION),1)
   APP_CFLAGS += -DOMIM_PRODUCTION
 endif
@@ -59,7 +59,7 @@ void AndroidAssertMessage(SrcPoint const & src, string const & s)
 void InitSystemLog()
 {
 #ifdef MWM_LOG_TO_FILE
-  SetLogMessageFn(&LogMessageFile);
+  SetLogMessageFn(&LogMessageFileAsync);
 #else
   SetLogMessageFn(&AndroidLogMessage);
 #endif
@@ -68,6 +68,7 @@ namespace android
      m_isCleanSingleClick(false),
      m_doLoadState(true),
      m_lastCompass(0.0),
+     m_isCompassPosted(false),
      m_wasLongClick(false),
      m_densityDpi(0),
      m_screenWidth(0),
@@ -106,8 +107,28 @@ namespace android
     if (force || fabs(ang::GetShortestDistance(m_lastCompass, info.m_bearing)) >= COMPASS_THRESHOLD)
     {
       m_lastCompass = info.m_bearing;
-      Platform::RunOnGuiThreadImpl(bind(&::Framework::OnCompassUpdate, ref(m_work), info));
+
+      {
+        lock_guard<mutex> lock(m_compassMutex);
+        m_pendingCompass = info;
+        // The posted task isn't processed yet, it takes this info too.
+        if (m_isCompassPosted)
+          return;
+        m_isCompassPosted = true;
+      }
+      Platform::RunOnGuiThreadImpl(bind(&Framework::ApplyPendingCompass, this));
+    }
+  }
+
+  void Framework::ApplyPendingCompass()
+  {
+    location::CompassInfo info;
+    {
+      lock_guard<mutex> lock(m_compassMutex);
+      info = m_pendingCompass;
+      m_isCompassPosted = false;
     }
+    m_work.OnCompassUpdate(info);
   }
 
   void Framework::UpdateCompassSensor(int ind, float * arr)
@@ -584,7 +605,7 @@ namespace android
                     oldBm->GetScale(), oldBm->GetTimeStamp());
 
     pOld->DeleteBookmark(ind.second);
-    pOld->SaveToKMLFile();
+    pOld->SaveToFile();
 
     return AddBookmark(newCat, pt, bm).second;
   }
@@ -16,6 +16,7 @@
 #include "indexer/map_style.hpp"
 
 #include "std/map.hpp"
+#include "std/mutex.hpp"
 #include "std/shared_ptr.hpp"
 #include "std/unique_ptr.hpp"
 
@@ -63,6 +64,15 @@ namespace android
     math::LowPassVector<float, 3> m_sensors[2];
     double m_lastCompass;
 
+    /// @name Compass comes from the sensors thread much more often than the gui thread
+    /// processes it. Only the latest compass info waits for the gui thread.
+    //@{
+    mutex m_compassMutex;
+    location::CompassInfo m_pendingCompass;
+    bool m_isCompassPosted;
+    void ApplyPendingCompass();
+    //@}
+
     unique_ptr<DeferredTask> m_deferredTask;
     bool m_wasLongClick;
 
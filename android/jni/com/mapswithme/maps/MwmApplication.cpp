@@ -69,6 +69,12 @@ extern "C"
                            jni::ToNativeString(env, value));
   }
 
+  JNIEXPORT void JNICALL
+  Java_com_mapswithme_maps_MwmApplication_nativeTrimMemory(JNIEnv * env, jobject thiz, jdouble share)
+  {
+    g_framework->NativeFramework()->MemoryWarning(share);
+  }
+
   JNIEXPORT jint JNICALL
   Java_com_mapswithme_maps_MwmApplication_nativeGetInt(JNIEnv * env, jobject thiz, jstring name, jint defaultValue)
   {
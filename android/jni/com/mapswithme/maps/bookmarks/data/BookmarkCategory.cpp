@@ -32,7 +32,7 @@ extern "C"
   {
     BookmarkCategory * pCat = getBmCategory(id);
     pCat->SetVisible(b);
-    pCat->SaveToKMLFile();
+    pCat->SaveToFile();
   }
 
   JNIEXPORT void JNICALL
@@ -41,7 +41,7 @@ extern "C"
   {
     BookmarkCategory * pCat = getBmCategory(id);
     pCat->SetName(jni::ToNativeString(env, n));
-    pCat->SaveToKMLFile();
+    pCat->SaveToFile();
   }
 
   JNIEXPORT jstring JNICALL
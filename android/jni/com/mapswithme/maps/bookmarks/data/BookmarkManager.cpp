@@ -2,6 +2,7 @@
 
 #include "../../../core/jni_helper.hpp"
 
+#include "coding/internal/file_data.hpp"
 #include "coding/zip_creator.hpp"
 
 
@@ -55,7 +56,7 @@ extern "C"
     if (pCat)
     {
       pCat->DeleteBookmark(bmk);
-      pCat->SaveToKMLFile();
+      pCat->SaveToFile();
     }
   }
 
@@ -67,7 +68,7 @@ extern "C"
     if (pCat)
     {
       pCat->DeleteTrack(trk);
-      pCat->SaveToKMLFile();
+      pCat->SaveToFile();
     }
   }
 
@@ -79,7 +80,13 @@ extern "C"
     if (pCat)
     {
       string const name = pCat->GetName();
-      if (CreateZipFromPathDeflatedAndDefaultCompression(pCat->GetFileName(), jni::ToNativeString(env, tmpPath) + name + ".kmz"))
+      string const path = jni::ToNativeString(env, tmpPath) + name;
+      // Categories are stored in the binary format, so KML is exported for sharing.
+      string const kmlFile = path + BOOKMARKS_FILE_EXTENSION;
+      bool const isSaved = pCat->ExportToKMLFile(kmlFile) &&
+          CreateZipFromPathDeflatedAndDefaultCompression(kmlFile, path + ".kmz");
+      my::DeleteFileX(kmlFile);
+      if (isSaved)
         return jni::ToJavaString(env, name);
     }
 
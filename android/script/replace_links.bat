@@ -5,6 +5,7 @@ mkdir assets
 cp ../data/categories.txt assets/
 cp ../data/classificator.txt assets/
 cp ../data/copyright.html assets/
+cp ../data/countries.bin assets/
 cp ../data/countries.txt assets/
 cp ../data/drules_proto.bin assets/
 cp ../data/drules_proto_dark.bin assets/
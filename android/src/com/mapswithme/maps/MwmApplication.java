@@ -101,6 +101,24 @@ public class MwmApplication extends android.app.Application implements ActiveCou
     mPrefs = getSharedPreferences(getString(R.string.pref_file_name), MODE_PRIVATE);
   }
 
+  @Override
+  public void onTrimMemory(int level)
+  {
+    super.onTrimMemory(level);
+    if (!mIsFrameworkInitialized)
+      return;
+
+    // Part of the native caches memory to free.
+    final double share;
+    if (level >= TRIM_MEMORY_COMPLETE || level == TRIM_MEMORY_RUNNING_CRITICAL)
+      share = 1.0;
+    else if (level >= TRIM_MEMORY_BACKGROUND || level == TRIM_MEMORY_RUNNING_LOW)
+      share = 0.5;
+    else
+      share = 0.25;
+    nativeTrimMemory(share);
+  }
+
   public synchronized void initNativeCore()
   {
     if (mIsFrameworkInitialized)
@@ -196,6 +214,8 @@ public class MwmApplication extends android.app.Application implements ActiveCou
 
   private native void nativeAddLocalization(String name, String value);
 
+  private native void nativeTrimMemory(double share);
+
   // Dealing with Settings
   public native boolean nativeGetBoolean(String name, boolean defaultValue);
 
@@ -4,8 +4,6 @@
 #include "base/assert.hpp"
 #include "base/timer.hpp"
 
-#include "std/algorithm.hpp"
-
 
 namespace anim
 {
@@ -20,18 +18,39 @@ namespace anim
     m_controller->Unlock();
   }
 
+  Controller::Controller()
+    : m_pending(nullptr)
+    , m_LockCount(0)
+    , m_hasVisualTasks(false)
+    , m_hasRunningTasks(false)
+    , m_lastStepTime(0.0)
+  {
+  }
+
+  Controller::~Controller()
+  {
+    PendingTask * p = m_pending.exchange(nullptr);
+    while (p != nullptr)
+    {
+      PendingTask * next = p->m_next;
+      delete p;
+      p = next;
+    }
+  }
+
   void Controller::AddTask(TTaskPtr const & task)
   {
-    m_tasks.ProcessList([&] (TTasks & taskList)
+    task->SetController(this);
+
+    PendingTask * p = new PendingTask{task, m_pending.load(memory_order_relaxed)};
+    while (!m_pending.compare_exchange_weak(p->m_next, p, memory_order_release, memory_order_relaxed))
     {
-      taskList.push_back(task);
-      task->SetController(this);
-    });
+    }
   }
 
   bool Controller::HasTasks()
   {
-    return !m_tasks.Empty();
+    return m_hasRunningTasks || m_pending.load(memory_order_acquire) != nullptr;
   }
 
   bool Controller::HasVisualTasks()
@@ -51,56 +70,70 @@ namespace anim
 
   int Controller::LockCount()
   {
-    ASSERT(m_LockCount >=0, ("Lock/Unlock is unbalanced! LockCount < 0!"));
-    return m_LockCount;
+    int const count = m_LockCount;
+    ASSERT(count >= 0, ("Lock/Unlock is unbalanced! LockCount < 0!"));
+    return count;
   }
 
   void Controller::PerformStep()
   {
-    m_tasks.ProcessList([this] (TTasks & from)
+    // New tasks go after the running ones in the order they were added.
+    TTasks newTasks;
+    PendingTask * p = m_pending.exchange(nullptr, memory_order_acquire);
+    while (p != nullptr)
     {
-      m_tasksList.clear();
-      swap(from, m_tasksList);
-    });
-
-    double ts = GetCurrentTime();
+      newTasks.push_front(move(p->m_task));
+      PendingTask * next = p->m_next;
+      delete p;
+      p = next;
+    }
+    m_tasksList.splice(m_tasksList.end(), newTasks);
 
-    TTasks resultList;
+    double const ts = GetCurrentTime();
+    double stepStart = ts;
 
-    for (TTaskPtr const & task : m_tasksList)
+    bool hasVisualTasks = false;
+    for (auto it = m_tasksList.begin(); it != m_tasksList.end();)
     {
-      task->Lock();
+      Task & task = **it;
+      task.Lock();
 
-      if (task->IsReady())
+      if (task.IsReady())
       {
-        task->Start();
-        task->OnStart(ts);
+        task.Start();
+        task.OnStart(ts);
       }
-      if (task->IsRunning())
-        task->OnStep(ts);
+      if (task.IsRunning())
+        task.OnStep(ts);
 
-      if (task->IsRunning())
-        resultList.push_back(task);
+      bool const isRunning = task.IsRunning();
+      if (!isRunning)
+      {
+        if (task.IsCancelled())
+          task.OnCancel(ts);
+        if (task.IsEnded())
+          task.OnEnd(ts);
+      }
       else
       {
-        if (task->IsCancelled())
-          task->OnCancel(ts);
-        if (task->IsEnded())
-          task->OnEnd(ts);
+        hasVisualTasks |= task.IsVisual();
       }
 
-      task->Unlock();
+      double const stepEnd = GetCurrentTime();
+      task.AddStepTime(stepEnd - stepStart);
+      stepStart = stepEnd;
+
+      task.Unlock();
+
+      if (isRunning)
+        ++it;
+      else
+        it = m_tasksList.erase(it);
     }
 
-    m_hasVisualTasks = false;
-    m_tasks.ProcessList([&] (TTasks & to)
-    {
-      for_each(resultList.begin(), resultList.end(), [&] (TTaskPtr const & task)
-      {
-        m_hasVisualTasks |= task->IsVisual();
-        to.push_back(task);
-      });
-    });
+    m_lastStepTime = stepStart - ts;
+    m_hasVisualTasks = hasVisualTasks;
+    m_hasRunningTasks = !m_tasksList.empty();
   }
 
   double Controller::GetCurrentTime() const
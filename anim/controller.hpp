@@ -1,15 +1,15 @@
 #pragma once
 
+#include "std/atomic.hpp"
+#include "std/list.hpp"
 #include "std/shared_ptr.hpp"
 
-#include "base/thread.hpp"
-#include "base/threaded_list.hpp"
-
 namespace anim
 {
   class Task;
 
   // Animation controller class.
+  // Tasks may be added from any thread, they are stepped on the render thread only.
   class Controller
   {
   private:
@@ -18,12 +18,24 @@ namespace anim
     // Container for tasks
     typedef list<TTaskPtr> TTasks;
 
-    ThreadedList<TTaskPtr> m_tasks;
-    // Task for the current step.
+    struct PendingTask
+    {
+      TTaskPtr m_task;
+      PendingTask * m_next;
+    };
+
+    // Tasks added since the last step, the last added one is on top.
+    // AddTask() publishes a task with a single CAS, PerformStep() takes all of them at once.
+    atomic<PendingTask *> m_pending;
+    // Tasks for the current step, touched by PerformStep() only.
     TTasks m_tasksList;
 
-    int m_LockCount = 0;
-    bool m_hasVisualTasks = false;
+    atomic<int> m_LockCount;
+    atomic<bool> m_hasVisualTasks;
+    atomic<bool> m_hasRunningTasks;
+
+    // Duration of the last PerformStep(), in seconds.
+    double m_lastStepTime;
 
   public:
 
@@ -34,6 +46,9 @@ namespace anim
       ~Guard();
     };
 
+    Controller();
+    ~Controller();
+
     // Adding animation task to the controller
     void AddTask(TTaskPtr const & task);
     // Do we have animation tasks, which are currently running?
@@ -48,8 +63,10 @@ namespace anim
     void Unlock();
     // Getting current lock count
     int LockCount();
-    // Perform single animation step
+    // Perform single animation step, should be called from the render thread only.
     void PerformStep();
+    // Duration of the last step of all the tasks, in seconds.
+    double GetLastStepTime() const { return m_lastStepTime; }
     // Getting current simulation time
     double GetCurrentTime() const;
   };
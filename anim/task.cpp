@@ -9,6 +9,9 @@ namespace anim
 {
   Task::Task()
     : m_State(EReady)
+    , m_controller(nullptr)
+    , m_stepsTime(0.0)
+    , m_stepsCount(0)
   {}
 
   Task::~Task()
@@ -117,4 +120,20 @@ namespace anim
   {
     return m_controller;
   }
+
+  void Task::AddStepTime(double t)
+  {
+    m_stepsTime += t;
+    ++m_stepsCount;
+  }
+
+  double Task::GetStepsTime() const
+  {
+    return m_stepsTime;
+  }
+
+  size_t Task::GetStepsCount() const
+  {
+    return m_stepsCount;
+  }
 }
@@ -37,11 +37,15 @@ namespace anim
 
     Controller * m_controller;
 
+    double m_stepsTime;
+    size_t m_stepsCount;
+
   protected:
 
     void SetState(EState state);
     friend class Controller;
     void SetController(Controller * controller);
+    void AddStepTime(double t);
 
   public:
 
@@ -74,5 +78,10 @@ namespace anim
     virtual bool IsVisual() const;
 
     void AddCallback(EState state, TCallback const & cb);
+
+    /// Time spent by the controller in the callbacks of this task, in seconds,
+    /// and the number of the steps it took.
+    double GetStepsTime() const;
+    size_t GetStepsCount() const;
   };
 }
@@ -0,0 +1,108 @@
+#include "base/arena.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstdlib.hpp"
+
+namespace my
+{
+namespace
+{
+// Alignment of the blocks which are allocated by malloc.
+union MaxAlign
+{
+  long double m_ld;
+  long long m_ll;
+  void * m_p;
+};
+size_t const kMaxAlignment = alignof(MaxAlign);
+}  // namespace
+
+// static
+size_t const Arena::kDefaultBlockSize;
+// static
+size_t const Arena::kMaxBlockSize;
+
+Arena::Arena(size_t blockSize)
+  : m_current(nullptr), m_end(nullptr), m_blockSize(max(blockSize, size_t(64))), m_allocated(0),
+    m_destructors(nullptr)
+{
+}
+
+Arena::~Arena()
+{
+  Clear();
+  for (Block const & block : m_blocks)
+    free(block.m_data);
+}
+
+void * Arena::Allocate(size_t size, size_t alignment)
+{
+  ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, (alignment));
+  ASSERT_LESS_OR_EQUAL(alignment, kMaxAlignment, ());
+
+  uintptr_t const current = reinterpret_cast<uintptr_t>(m_current);
+  size_t padding = (alignment - current % alignment) % alignment;
+  if (m_current == nullptr || padding + size > static_cast<size_t>(m_end - m_current))
+  {
+    AddBlock(size);
+    padding = 0;
+  }
+
+  char * p = m_current + padding;
+  m_current = p + size;
+  m_allocated += padding + size;
+  return p;
+}
+
+void Arena::Clear()
+{
+  for (Destructor * d = m_destructors; d != nullptr; d = d->m_prev)
+    d->m_fn(d->m_object);
+  m_destructors = nullptr;
+
+  if (m_blocks.size() > 1)
+  {
+    for (size_t i = 1; i < m_blocks.size(); ++i)
+      free(m_blocks[i].m_data);
+    m_blocks.resize(1);
+  }
+  if (!m_blocks.empty())
+  {
+    m_current = m_blocks.front().m_data;
+    m_end = m_current + m_blocks.front().m_size;
+  }
+  m_allocated = 0;
+}
+
+size_t Arena::GetReservedSize() const
+{
+  size_t size = 0;
+  for (Block const & block : m_blocks)
+    size += block.m_size;
+  return size;
+}
+
+void Arena::AddDestructor(void (*fn)(void *), void * object)
+{
+  Destructor * d = static_cast<Destructor *>(Allocate(sizeof(Destructor), alignof(Destructor)));
+  d->m_fn = fn;
+  d->m_object = object;
+  d->m_prev = m_destructors;
+  m_destructors = d;
+}
+
+void Arena::AddBlock(size_t minSize)
+{
+  size_t size = m_blockSize;
+  if (!m_blocks.empty())
+    size = min(kMaxBlockSize, max(size, m_blocks.back().m_size * 2));
+  size = max(size, minSize);
+
+  char * data = static_cast<char *>(malloc(size));
+  if (data == nullptr)
+    throw std::bad_alloc();
+  m_blocks.push_back({data, size});
+  m_current = data;
+  m_end = data + size;
+}
+}  // namespace my
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "base/assert.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/limits.hpp"
+#include "std/noncopyable.hpp"
+#include "std/type_traits.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+#include <new>
+
+namespace my
+{
+/// Bump allocator of the temporary objects of one scope, e.g. of a search query or
+/// of the reading of a tile. Memory is cut from big blocks and is freed at once by Clear(),
+/// the first block is kept for the next scope, so the scopes which fit into it don't call
+/// malloc at all. Not thread-safe, each thread uses its own arena.
+class Arena : private noncopyable
+{
+public:
+  static size_t const kDefaultBlockSize = 16 * 1024;
+  /// Blocks grow twice up to it.
+  static size_t const kMaxBlockSize = 1024 * 1024;
+
+  explicit Arena(size_t blockSize = kDefaultBlockSize);
+  ~Arena();
+
+  /// @param alignment Power of two, not greater than the alignment of malloc.
+  void * Allocate(size_t size, size_t alignment);
+
+  /// Creates an object which lives until Clear(), the destructors are called by Clear()
+  /// in the reverse order of the creation.
+  template <typename T, typename... TArgs>
+  T * New(TArgs &&... args)
+  {
+    void * p = Allocate(sizeof(T), alignof(T));
+    T * t = new (p) T(forward<TArgs>(args)...);
+    if (!is_trivially_destructible<T>::value)
+      AddDestructor(&Destroy<T>, t);
+    return t;
+  }
+
+  /// Destroys the objects created by New() and frees the memory. Memory isn't given back
+  /// to the system except the blocks after the first one.
+  void Clear();
+
+  /// Bytes allocated since the last Clear().
+  size_t GetAllocatedSize() const { return m_allocated; }
+  /// Memory held by the blocks.
+  size_t GetReservedSize() const;
+
+private:
+  struct Block
+  {
+    char * m_data;
+    size_t m_size;
+  };
+
+  struct Destructor
+  {
+    void (*m_fn)(void *);
+    void * m_object;
+    Destructor * m_prev;
+  };
+
+  template <typename T>
+  static void Destroy(void * p)
+  {
+    static_cast<T *>(p)->~T();
+  }
+
+  void AddDestructor(void (*fn)(void *), void * object);
+  void AddBlock(size_t minSize);
+
+  vector<Block> m_blocks;
+  // Free space of the last block.
+  char * m_current;
+  char * m_end;
+  size_t m_blockSize;
+  size_t m_allocated;
+  Destructor * m_destructors;
+};
+
+/// STL allocator which takes the memory from the arena, deallocate() is no-op.
+/// The arena must outlive the containers which use it.
+template <typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = T const *;
+  using reference = T &;
+  using const_reference = T const &;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+
+  template <typename U>
+  struct rebind
+  {
+    using other = ArenaAllocator<U>;
+  };
+
+  explicit ArenaAllocator(Arena & arena) : m_arena(&arena) {}
+  template <typename U>
+  ArenaAllocator(ArenaAllocator<U> const & rhs) : m_arena(rhs.GetArena()) {}
+
+  T * allocate(size_t n, void const * = nullptr)
+  {
+    return static_cast<T *>(m_arena->Allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T *, size_t) {}
+
+  template <typename U, typename... TArgs>
+  void construct(U * p, TArgs &&... args)
+  {
+    new (p) U(forward<TArgs>(args)...);
+  }
+  template <typename U>
+  void destroy(U * p)
+  {
+    p->~U();
+  }
+
+  T * address(T & t) const { return &t; }
+  T const * address(T const & t) const { return &t; }
+  size_t max_size() const { return numeric_limits<size_t>::max() / sizeof(T); }
+
+  Arena * GetArena() const { return m_arena; }
+
+private:
+  Arena * m_arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(ArenaAllocator<T> const & lhs, ArenaAllocator<U> const & rhs)
+{
+  return lhs.GetArena() == rhs.GetArena();
+}
+
+template <typename T, typename U>
+inline bool operator!=(ArenaAllocator<T> const & lhs, ArenaAllocator<U> const & rhs)
+{
+  return !(lhs == rhs);
+}
+}  // namespace my
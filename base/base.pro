@@ -8,7 +8,9 @@ ROOT_DIR = ..
 include($$ROOT_DIR/common.pri)
 
 SOURCES += \
+    arena.cpp \
     base.cpp \
+    cache_governor.cpp \
     commands_queue.cpp \
     condition.cpp \
     deferred_task.cpp \
@@ -23,23 +25,29 @@ SOURCES += \
     runner.cpp \
     shared_buffer_manager.cpp \
     src_point.cpp \
+    stats.cpp \
     string_format.cpp \
     string_utils.cpp \
     strings_bundle.cpp \
+    task_scheduler.cpp \
     thread.cpp \
     thread_checker.cpp \
     thread_pool.cpp \
     threaded_container.cpp \
     timer.cpp \
+    tracing.cpp \
+    work_stealing_pool.cpp \
 
 HEADERS += \
     SRC_FIRST.hpp \
+    arena.hpp \
     array_adapters.hpp \
     assert.hpp \
     base.hpp \
     bits.hpp \
     buffer_vector.hpp \
     cache.hpp \
+    cache_governor.hpp \
     cancellable.hpp \
     commands_queue.hpp \
     condition.hpp \
@@ -74,6 +82,7 @@ HEADERS += \
     string_utils.hpp \
     strings_bundle.hpp \
     swap.hpp \
+    task_scheduler.hpp \
     thread.hpp \
     thread_checker.hpp \
     thread_pool.hpp \
@@ -81,4 +90,6 @@ HEADERS += \
     threaded_list.hpp \
     threaded_priority_queue.hpp \
     timer.hpp \
+    tracing.hpp \
+    work_stealing_pool.hpp \
     worker_thread.hpp \
@@ -0,0 +1,83 @@
+#include "testing/testing.hpp"
+
+#include "base/arena.hpp"
+
+#include "std/map.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+class Counted
+{
+public:
+  Counted(int & alive, string const & name) : m_alive(alive), m_name(name) { ++m_alive; }
+  ~Counted() { --m_alive; }
+
+  string const & GetName() const { return m_name; }
+
+private:
+  int & m_alive;
+  string m_name;
+};
+}  // namespace
+
+UNIT_TEST(Arena_Allocate)
+{
+  my::Arena arena(128);
+  for (size_t alignment = 1; alignment <= 8; alignment *= 2)
+  {
+    void * p = arena.Allocate(3, alignment);
+    TEST_EQUAL(reinterpret_cast<uintptr_t>(p) % alignment, 0, (alignment));
+  }
+
+  // Bigger than a block.
+  char * big = static_cast<char *>(arena.Allocate(1000, 1));
+  fill(big, big + 1000, 'a');
+  TEST_GREATER_OR_EQUAL(arena.GetAllocatedSize(), 1000, ());
+
+  size_t const reserved = arena.GetReservedSize();
+  arena.Clear();
+  TEST_EQUAL(arena.GetAllocatedSize(), 0, ());
+  TEST_LESS(arena.GetReservedSize(), reserved, ());
+
+  // The first block is reused.
+  void * p1 = arena.Allocate(8, 8);
+  arena.Clear();
+  void * p2 = arena.Allocate(8, 8);
+  TEST_EQUAL(p1, p2, ());
+}
+
+UNIT_TEST(Arena_New)
+{
+  int alive = 0;
+  {
+    my::Arena arena;
+    for (int i = 0; i < 100; ++i)
+      TEST_EQUAL(arena.New<Counted>(alive, "object")->GetName(), "object", ());
+    TEST_EQUAL(alive, 100, ());
+    arena.Clear();
+    TEST_EQUAL(alive, 0, ());
+
+    arena.New<Counted>(alive, "last");
+    TEST_EQUAL(alive, 1, ());
+  }
+  TEST_EQUAL(alive, 0, ());
+}
+
+UNIT_TEST(Arena_Allocator)
+{
+  my::Arena arena;
+  using TAllocator = my::ArenaAllocator<pair<int const, string>>;
+  map<int, string, less<int>, TAllocator> m((less<int>()), TAllocator(arena));
+  for (int i = 0; i < 1000; ++i)
+    m[i % 10] += "x";
+  TEST_EQUAL(m.size(), 10, ());
+  TEST_EQUAL(m[3], string(100, 'x'), ());
+
+  vector<int, my::ArenaAllocator<int>> v((my::ArenaAllocator<int>(arena)));
+  for (int i = 0; i < 1000; ++i)
+    v.push_back(i);
+  TEST_EQUAL(v[999], 999, ());
+  TEST_GREATER(arena.GetAllocatedSize(), 1000 * sizeof(int), ());
+}
@@ -12,9 +12,11 @@ include($$ROOT_DIR/common.pri)
 
 SOURCES += \
   ../../testing/testingmain.cpp \
+  arena_test.cpp \
   assert_test.cpp \
   bits_test.cpp \
   buffer_vector_test.cpp \
+  cache_governor_test.cpp \
   cache_test.cpp \
   commands_queue_test.cpp \
   condition_test.cpp \
@@ -30,14 +32,19 @@ SOURCES += \
   observer_list_test.cpp \
   regexp_test.cpp \
   rolling_hash_test.cpp \
+  shared_buffer_manager_test.cpp \
   scope_guard_test.cpp \
+  stats_test.cpp \
   stl_add_test.cpp \
   string_format_test.cpp \
   string_utils_test.cpp \
+  task_scheduler_test.cpp \
   thread_pool_tests.cpp \
   threaded_list_test.cpp \
   threads_test.cpp \
   timer_test.cpp \
+  tracing_test.cpp \
+  work_stealing_pool_test.cpp \
   worker_thread_test.cpp \
 
 HEADERS +=
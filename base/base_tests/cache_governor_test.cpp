@@ -0,0 +1,40 @@
+#include "testing/testing.hpp"
+
+#include "base/cache_governor.hpp"
+
+UNIT_TEST(CacheGovernor_Trim)
+{
+  CacheGovernor & governor = CacheGovernor::Instance();
+
+  double lowShare = 0.0;
+  double highShare = 0.0;
+  uint64_t lowBytes = 100;
+  CacheGovernor::TCacheId const lowId = governor.Register("low", CacheGovernor::LOW,
+      [&lowBytes]() { return lowBytes; },
+      [&lowShare, &lowBytes](double share)
+      {
+        lowShare = share;
+        lowBytes -= static_cast<uint64_t>(lowBytes * share);
+      });
+  CacheGovernor::TCacheId const highId = governor.Register("high", CacheGovernor::HIGH,
+      CacheGovernor::TGetBytesFn(), [&highShare](double share) { highShare = share; });
+  TEST_NOT_EQUAL(lowId, highId, ());
+
+  uint64_t const otherBytes = governor.GetTotalBytes() - lowBytes;
+
+  governor.Trim(0.25);
+  TEST_ALMOST_EQUAL_ULPS(lowShare, 0.5, ());
+  TEST_ALMOST_EQUAL_ULPS(highShare, 0.125, ());
+  TEST_EQUAL(governor.GetTotalBytes() - otherBytes, 50, ());
+
+  governor.Trim(1.0);
+  TEST_ALMOST_EQUAL_ULPS(lowShare, 1.0, ());
+  TEST_ALMOST_EQUAL_ULPS(highShare, 0.5, ());
+  TEST_EQUAL(lowBytes, 0, ());
+
+  governor.Unregister(lowId);
+  governor.Unregister(highId);
+  lowShare = 0.0;
+  governor.Trim(1.0);
+  TEST_ALMOST_EQUAL_ULPS(lowShare, 0.0, ());
+}
@@ -4,6 +4,10 @@
 #include "base/stl_add.hpp"
 
 #include "std/bind.hpp"
+#include "std/mutex.hpp"
+#include "std/string.hpp"
+#include "std/thread.hpp"
+#include "std/vector.hpp"
 
 namespace
 {
@@ -180,3 +184,129 @@ UNIT_TEST(Cache_Init)
   TEST_EQUAL(cache.Find(5, found), 'b', ());
   TEST(found, ());
 }
+
+UNIT_TEST(SetAssociativeCache_Smoke)
+{
+  my::SetAssociativeCache<uint32_t, int> cache(16 /* count */, 16 /* maxWeight */);
+  TEST_EQUAL(cache.GetCapacity(), 16, ());
+
+  int value = 0;
+  TEST(!cache.Find(1, value), ());
+  TEST(cache.Insert(1, 10), ());
+  TEST(cache.Find(1, value), ());
+  TEST_EQUAL(value, 10, ());
+
+  TEST(cache.Insert(1, 11), ());
+  TEST(cache.Find(1, value), ());
+  TEST_EQUAL(value, 11, ());
+
+  TEST(cache.Erase(1), ());
+  TEST(!cache.Find(1, value), ());
+
+  my::cache::Stats const stats = cache.GetStats();
+  TEST_EQUAL(stats.m_hits, 2, ());
+  TEST_EQUAL(stats.m_misses, 2, ());
+  TEST_EQUAL(stats.m_count, 0, ());
+  TEST_ALMOST_EQUAL_ULPS(stats.GetHitRate(), 0.5, ());
+}
+
+UNIT_TEST(SetAssociativeCache_Weight)
+{
+  struct Weight
+  {
+    size_t operator()(string const & s) const { return s.size(); }
+  };
+  my::SetAssociativeCache<uint32_t, string, hash<uint32_t>, Weight> cache(64, 10);
+
+  TEST(!cache.Insert(0, string(11, 'a')), ("Heavier than the cache."));
+  for (uint32_t i = 0; i < 10; ++i)
+    TEST(cache.Insert(i, "aaa"), ());
+
+  my::cache::Stats stats = cache.GetStats();
+  TEST_EQUAL(stats.m_count, 3, ());
+  TEST_EQUAL(stats.m_weight, 9, ());
+  TEST_EQUAL(stats.m_evictions, 7, ());
+  TEST_EQUAL(stats.m_rejections, 1, ());
+
+  // The last inserted entry is kept.
+  string value;
+  TEST(cache.Find(9, value), ());
+
+  cache.SetMaxWeight(3);
+  stats = cache.GetStats();
+  TEST_LESS_OR_EQUAL(stats.m_weight, 3, ());
+
+  cache.Clear();
+  TEST_EQUAL(cache.GetStats().m_weight, 0, ());
+}
+
+UNIT_TEST(SetAssociativeCache_Clock)
+{
+  // One set, so all the keys compete for its entries.
+  my::SetAssociativeCache<uint32_t, int> cache(8, 8);
+  for (uint32_t i = 0; i < 8; ++i)
+    cache.Insert(i, i);
+
+  int value;
+  TEST(cache.Find(0, value), ());
+  TEST(cache.Insert(100, 100), ());
+  // The found entry got the second chance.
+  TEST(cache.Find(0, value), ());
+  TEST(!cache.Find(1, value), ());
+  TEST(cache.Find(100, value), ());
+}
+
+UNIT_TEST(SetAssociativeCache_TinyLfu)
+{
+  my::SetAssociativeCache<uint32_t, int> cache(8, 8, my::cache::Eviction::TinyLfu);
+  int value;
+  for (size_t round = 0; round < 5; ++round)
+  {
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+      if (!cache.Find(i, value))
+        cache.Insert(i, i);
+    }
+  }
+
+  // One-time keys don't take the places of the frequent ones.
+  for (uint32_t i = 100; i < 150; ++i)
+  {
+    if (!cache.Find(i, value))
+      cache.Insert(i, i);
+  }
+  for (uint32_t i = 0; i < 8; ++i)
+    TEST(cache.Find(i, value), (i));
+  TEST_GREATER(cache.GetStats().m_rejections, 0, ());
+}
+
+UNIT_TEST(SetAssociativeCache_Threads)
+{
+  my::SetAssociativeCache<uint32_t, uint32_t, hash<uint32_t>, my::cache::UnitWeight<uint32_t>,
+                          mutex> cache(1024, 1024);
+  vector<thread> threads;
+  for (size_t t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&cache]()
+    {
+      for (uint32_t i = 0; i < 10000; ++i)
+      {
+        uint32_t value;
+        uint32_t const key = i % 300;
+        if (cache.Find(key, value))
+        {
+          TEST_EQUAL(value, key * 2, ());
+        }
+        else
+        {
+          cache.Insert(key, key * 2);
+        }
+      }
+    });
+  }
+  for (thread & t : threads)
+    t.join();
+
+  my::cache::Stats const stats = cache.GetStats();
+  TEST_EQUAL(stats.m_hits + stats.m_misses, 40000, ());
+}
@@ -6,6 +6,7 @@
 
 #include "std/atomic.hpp"
 #include "std/bind.hpp"
+#include "std/vector.hpp"
 
 void add_int(core::CommandsQueue::Environment const & env,
              atomic<int> & i,
@@ -117,3 +118,70 @@ UNIT_TEST(CommandsQueue_TestJoinCommand)
 
   TEST(i == 24, ("core::CommandsQueue::Command::join doesn't work"));
 }
+
+namespace
+{
+void wait_for_count(core::CommandsQueue::Environment const & env, atomic<int> & count, int expected,
+                    atomic<bool> & isTimedOut)
+{
+  for (int i = 0; i < 100 && count != expected; ++i)
+    threads::Sleep(20);
+  isTimedOut = (count != expected);
+}
+
+void push_value(core::CommandsQueue::Environment const & env, threads::Mutex & mutex,
+                vector<int> & values, int value)
+{
+  threads::MutexGuard guard(mutex);
+  UNUSED_VALUE(guard);
+  values.push_back(value);
+}
+}  // namespace
+
+UNIT_TEST(CommandsQueue_StealCommands)
+{
+  core::CommandsQueue queue(2);
+  queue.Start();
+
+  atomic<int> count(0);
+  atomic<bool> isTimedOut(false);
+
+  // Commands are spread over both executors, so the blocked one's commands are stolen.
+  queue.AddCommand(bind(&wait_for_count, _1, ref(count), 3, ref(isTimedOut)));
+  for (int i = 0; i < 3; ++i)
+    queue.AddCommand([&count](core::CommandsQueue::Environment const &) { ++count; });
+
+  queue.Join();
+  queue.Cancel();
+
+  TEST(!isTimedOut, ());
+  TEST_EQUAL(count, 3, ());
+}
+
+UNIT_TEST(CommandsQueue_PrioritiesAndSequences)
+{
+  core::CommandsQueue queue(1);
+
+  threads::Mutex mutex;
+  vector<int> values;
+
+  queue.AddCommand(bind(&push_value, _1, ref(mutex), ref(values), 1), core::CommandsQueue::ELowPriority, 1);
+  queue.AddCommand(bind(&push_value, _1, ref(mutex), ref(values), 2), core::CommandsQueue::EHighPriority, 1);
+  queue.AddCommand(bind(&push_value, _1, ref(mutex), ref(values), 3), core::CommandsQueue::EHighPriority, 0);
+  queue.AddCommand(bind(&push_value, _1, ref(mutex), ref(values), 4), core::CommandsQueue::ELowPriority,
+                   core::CommandsQueue::kNoSequenceID);
+  queue.SetSequenceID(1);
+
+  queue.Start();
+  queue.Join();
+  queue.Cancel();
+
+  // The command of the sequence 0 is dropped.
+  vector<int> const expected = {2, 1, 4};
+  TEST_EQUAL(values, expected, ());
+
+  core::CommandsQueue::Stats const stats = queue.GetStats();
+  TEST_EQUAL(stats.m_executedCount, 3, ());
+  TEST_EQUAL(stats.m_droppedCount, 1, ());
+  TEST_LESS_OR_EQUAL(stats.m_avgLatency, stats.m_maxLatency, ());
+}
@@ -39,6 +39,14 @@ UNIT_TEST(Logging_Level)
   my::g_LogLevel = logLevelSaved;
 }
 
+UNIT_TEST(Logging_Message)
+{
+  TEST_EQUAL(my::impl::Message(), "", ());
+  TEST_EQUAL(my::impl::Message(1), "1", ());
+  TEST_EQUAL(my::impl::Message("Point", 1, 2.5, 'c'), "Point 1 2.5 c", ());
+  TEST_EQUAL(my::impl::Message(make_pair(1, 2), vector<int>{3}), "(1, 2) [1: 3 ]", ());
+}
+
 UNIT_TEST(NullMessage)
 {
   char const * ptr = 0;
@@ -0,0 +1,81 @@
+#include "testing/testing.hpp"
+
+#include "base/shared_buffer_manager.hpp"
+
+#include "std/thread.hpp"
+#include "std/vector.hpp"
+
+UNIT_TEST(SharedBufferManager_Reuse)
+{
+  SharedBufferManager & mng = SharedBufferManager::instance();
+  mng.ReleaseCached();
+  SharedBufferManager::Stats const before = mng.GetStats();
+  TEST_EQUAL(before.m_cachedCount, 0, ());
+
+  SharedBufferManager::shared_buffer_ptr_t buf = mng.reserveSharedBuffer(100);
+  TEST_EQUAL(buf->size(), 100, ());
+  uint8_t * p = SharedBufferManager::GetRawPointer(buf);
+  mng.freeSharedBuffer(100, buf);
+  buf.reset();
+  TEST_EQUAL(mng.GetStats().m_cachedCount, 1, ());
+
+  // Buffers of the same size class are reused without reallocation.
+  buf = mng.reserveSharedBuffer(120);
+  TEST_EQUAL(buf->size(), 120, ());
+  TEST_EQUAL(SharedBufferManager::GetRawPointer(buf), p, ());
+  mng.freeSharedBuffer(120, buf);
+  buf.reset();
+
+  SharedBufferManager::Stats const after = mng.GetStats();
+  TEST_EQUAL(after.m_reserved - before.m_reserved, 2, ());
+  TEST_EQUAL(after.m_threadHits - before.m_threadHits, 1, ());
+  TEST_EQUAL(after.m_cachedSize, 128, ());
+
+  mng.ReleaseCached();
+  TEST_EQUAL(mng.GetStats().m_cachedSize, 0, ());
+}
+
+UNIT_TEST(SharedBufferManager_Limits)
+{
+  SharedBufferManager & mng = SharedBufferManager::instance();
+  mng.ReleaseCached();
+  mng.SetMaxCachedSize(1024);
+  uint64_t const dropped = mng.GetStats().m_dropped;
+
+  SharedBufferManager::shared_buffer_ptr_t bufs[3];
+  for (auto & buf : bufs)
+    buf = mng.reserveSharedBuffer(512);
+  for (auto & buf : bufs)
+    mng.freeSharedBuffer(512, buf);
+
+  SharedBufferManager::Stats const stats = mng.GetStats();
+  TEST_EQUAL(stats.m_cachedSize, 1024, ());
+  TEST_EQUAL(stats.m_dropped - dropped, 1, ());
+
+  mng.SetMaxCachedSize(SharedBufferManager::kDefaultMaxCachedSize);
+  mng.ReleaseCached();
+}
+
+UNIT_TEST(SharedBufferManager_Threads)
+{
+  SharedBufferManager & mng = SharedBufferManager::instance();
+  mng.ReleaseCached();
+
+  // Buffers freed by the other thread are taken from the shared cache when its
+  // thread cache is full.
+  thread t([&mng]()
+  {
+    vector<SharedBufferManager::shared_buffer_ptr_t> bufs;
+    for (size_t i = 0; i < 20; ++i)
+      bufs.push_back(mng.reserveSharedBuffer(128 * 1024));
+    for (auto & buf : bufs)
+      mng.freeSharedBuffer(buf->size(), buf);
+  });
+  t.join();
+
+  uint64_t const sharedHits = mng.GetStats().m_sharedHits;
+  auto buf = mng.reserveSharedBuffer(128 * 1024);
+  TEST_EQUAL(mng.GetStats().m_sharedHits - sharedHits, 1, ());
+  mng.freeSharedBuffer(buf->size(), buf);
+  mng.ReleaseCached();
+}
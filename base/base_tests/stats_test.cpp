@@ -0,0 +1,28 @@
+#include "testing/testing.hpp"
+
+#include "base/stats.hpp"
+
+#include "std/target_os.hpp"
+
+
+UNIT_TEST(GetPercentile_Smoke)
+{
+  vector<double> const one = {5.0};
+  TEST_EQUAL(my::GetPercentile(one, 0.0), 5.0, ());
+  TEST_EQUAL(my::GetPercentile(one, 1.0), 5.0, ());
+
+  vector<double> const sorted = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0};
+  TEST_EQUAL(my::GetPercentile(sorted, 0.0), 1.0, ());
+  TEST_EQUAL(my::GetPercentile(sorted, 0.5), 6.0, ());
+  TEST_EQUAL(my::GetPercentile(sorted, 0.99), 10.0, ());
+  TEST_EQUAL(my::GetPercentile(sorted, 1.0), 10.0, ());
+}
+
+UNIT_TEST(GetPeakRssBytes_Smoke)
+{
+  uint64_t const peak = my::GetPeakRssBytes();
+#ifndef OMIM_OS_WINDOWS
+  TEST_GREATER(peak, 0, ());
+#endif
+  TEST_LESS_OR_EQUAL(peak, my::GetPeakRssBytes(), ());
+}
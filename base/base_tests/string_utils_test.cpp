@@ -5,6 +5,7 @@
 
 #include "std/iomanip.hpp"
 #include "std/fstream.hpp"
+#include "std/iterator.hpp"
 #include "std/bind.hpp"
 #include "std/unordered_map.hpp"
 
@@ -375,6 +376,43 @@ UNIT_TEST(MakeUniString_Smoke)
   TEST_EQUAL(strings::UniString(&s[0], &s[0] + ARRAY_SIZE(s) - 1), strings::MakeUniString(s), ());
 }
 
+UNIT_TEST(MakeUniString_Runs)
+{
+  // The runs of ASCII chars of the different lengths, which are decoded by 8 chars at once.
+  string const parts[] = {"", "a", "Minsk", "Independence avenue", "\xD0\x9C", "\xE2\x84\x96",
+                          "\xF0\x9F\x98\x80"};
+  strings::UniString buffer;
+  for (auto const & p1 : parts)
+  {
+    for (auto const & p2 : parts)
+    {
+      for (auto const & p3 : parts)
+      {
+        string const s = p1 + p2 + p3 + p1;
+        strings::UniString expected;
+        utf8::unchecked::utf8to32(s.begin(), s.end(), back_inserter(expected));
+        TEST_EQUAL(strings::MakeUniString(s), expected, (s));
+        // The buffer is reused.
+        strings::MakeUniString(s, buffer);
+        TEST_EQUAL(buffer, expected, (s));
+      }
+    }
+  }
+}
+
+UNIT_TEST(IsASCIIString)
+{
+  TEST(strings::IsASCIIString(""), ());
+  TEST(strings::IsASCIIString("Independence avenue, 1"), ());
+  TEST(!strings::IsASCIIString("Independence avenue\xD0\x9C"), ());
+  TEST(!strings::IsASCIIString("\xD0\x9C"), ());
+
+  string const s = "0123456789abcdef\xD0\x9C";
+  TEST_EQUAL(strings::GetASCIIPrefixSize(s.data(), s.size()), 16, ());
+  TEST_EQUAL(strings::GetASCIIPrefixSize(s.data() + 3, s.size() - 3), 13, ());
+  TEST_EQUAL(strings::GetASCIIPrefixSize(s.data(), 5), 5, ());
+}
+
 UNIT_TEST(Normalize)
 {
   strings::UniChar const s[] = { 0x1f101, 'H', 0xfef0, 0xfdfc, 0x2150 };
@@ -0,0 +1,149 @@
+#include "testing/testing.hpp"
+
+#include "base/task_scheduler.hpp"
+
+#include "std/atomic.hpp"
+#include "std/cstdint.hpp"
+#include "std/exception.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+uint64_t Fib(threads::TaskScheduler & scheduler, uint64_t n)
+{
+  if (n < 2)
+    return n;
+  if (n < 10)
+    return Fib(scheduler, n - 1) + Fib(scheduler, n - 2);
+  // Waiting task runs the queued ones, so the recursion doesn't exhaust the workers.
+  auto lhs = scheduler.Async([&scheduler, n]() { return Fib(scheduler, n - 1); });
+  uint64_t const rhs = Fib(scheduler, n - 2);
+  return lhs.Get() + rhs;
+}
+}  // namespace
+
+UNIT_TEST(TaskScheduler_AsyncResults)
+{
+  threads::TaskScheduler scheduler(4 /* threadsCount */);
+  TEST_EQUAL(scheduler.GetThreadsCount(), 4, ());
+
+  vector<threads::Future<size_t>> futures;
+  for (size_t i = 0; i < 1000; ++i)
+    futures.push_back(scheduler.Async([i]() { return i * i; }));
+  for (size_t i = 0; i < futures.size(); ++i)
+    TEST_EQUAL(futures[i].Get(), i * i, ());
+
+  TEST_EQUAL(Fib(scheduler, 25), 75025, ());
+}
+
+UNIT_TEST(TaskScheduler_FutureException)
+{
+  threads::TaskScheduler scheduler(2 /* threadsCount */);
+  auto future = scheduler.Async([]() -> int { throw runtime_error("failed"); });
+  bool thrown = false;
+  try
+  {
+    future.Get();
+  }
+  catch (runtime_error const & e)
+  {
+    thrown = true;
+    TEST_EQUAL(string(e.what()), "failed", ());
+  }
+  TEST(thrown, ());
+  TEST(future.IsReady(), ());
+}
+
+UNIT_TEST(TaskScheduler_FutureThen)
+{
+  threads::TaskScheduler scheduler(2 /* threadsCount */);
+  auto future = scheduler.Async([]() { return 20; })
+                    .Then([](threads::Future<int> const & f) { return f.Get() + 1; })
+                    .Then([](threads::Future<int> const & f) { return f.Get() * 2; });
+  TEST_EQUAL(future.Get(), 42, ());
+
+  atomic<int> done(0);
+  auto last = scheduler.Async([&done]() { ++done; })
+                  .Then([&done](threads::Future<void> const &) { ++done; });
+  last.Wait();
+  TEST_EQUAL(done, 2, ());
+}
+
+UNIT_TEST(TaskScheduler_TaskGroup)
+{
+  threads::TaskScheduler scheduler(3 /* threadsCount */);
+  atomic<size_t> done(0);
+  {
+    threads::TaskGroup group(scheduler);
+    for (size_t i = 0; i < 500; ++i)
+      group.Run([&done]() { ++done; });
+    group.Wait();
+    TEST_EQUAL(done, 500, ());
+  }
+
+  // The first exception is rethrown and the group is cancelled.
+  threads::TaskGroup group(scheduler);
+  group.Run([]() { throw runtime_error("failed"); });
+  bool thrown = false;
+  try
+  {
+    group.Wait();
+  }
+  catch (runtime_error const &)
+  {
+    thrown = true;
+  }
+  TEST(thrown, ());
+  TEST(group.IsCancelled(), ());
+
+  // Tasks of the cancelled groups and of their children are skipped.
+  threads::TaskGroup child(scheduler, &group);
+  TEST(child.IsCancelled(), ());
+  child.Run([&done]() { ++done; });
+  child.Wait();
+  TEST_EQUAL(done, 500, ());
+}
+
+UNIT_TEST(TaskScheduler_ParallelFor)
+{
+  threads::TaskScheduler scheduler(4 /* threadsCount */);
+  for (size_t grainSize : {0, 1, 7, 1000})
+  {
+    vector<int> values(777, 0);
+    threads::ParallelFor(0, values.size(), [&values](size_t i) { values[i] += static_cast<int>(i); },
+                         grainSize, scheduler);
+    for (size_t i = 0; i < values.size(); ++i)
+      TEST_EQUAL(values[i], i, (grainSize));
+  }
+
+  // Empty ranges are fine.
+  threads::ParallelFor(5, 5, [](size_t) { TEST(false, ()); }, 0, scheduler);
+}
+
+UNIT_TEST(TaskScheduler_ParallelReduce)
+{
+  threads::TaskScheduler scheduler(4 /* threadsCount */);
+  auto const sum = threads::ParallelReduce(
+      size_t(1), size_t(10001), uint64_t(0), [](size_t b, size_t e)
+      {
+        uint64_t s = 0;
+        for (size_t i = b; i < e; ++i)
+          s += i;
+        return s;
+      },
+      [](uint64_t lhs, uint64_t rhs) { return lhs + rhs; }, 0, scheduler);
+  TEST_EQUAL(sum, 50005000, ());
+
+  // Chunks are combined in order, so a non-commutative combine gives the sequential result.
+  string const s = threads::ParallelReduce(
+      0, 26, string(), [](size_t b, size_t e)
+      {
+        string s;
+        for (size_t i = b; i < e; ++i)
+          s += static_cast<char>('a' + i);
+        return s;
+      },
+      [](string const & lhs, string const & rhs) { return lhs + rhs; }, 3, scheduler);
+  TEST_EQUAL(s, "abcdefghijklmnopqrstuvwxyz", ());
+}
@@ -0,0 +1,85 @@
+#include "testing/testing.hpp"
+
+#include "base/tracing.hpp"
+
+#include "std/sstream.hpp"
+#include "std/string.hpp"
+#include "std/thread.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+size_t CountOf(string const & s, string const & part)
+{
+  size_t count = 0;
+  for (size_t pos = s.find(part); pos != string::npos; pos = s.find(part, pos + 1))
+    ++count;
+  return count;
+}
+
+string GetTrace()
+{
+  ostringstream out;
+  my::tracing::WriteChromeTrace(out);
+  return out.str();
+}
+}  // namespace
+
+UNIT_TEST(Tracing_Smoke)
+{
+  {
+    TRACE_SCOPE("test", "NotStarted");
+  }
+
+  my::tracing::Start();
+  {
+    TRACE_SCOPE("test", "Outer");
+    TRACE_SCOPE("test", "Inner \"quoted\"");
+  }
+
+  vector<thread> threads;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    threads.emplace_back([]()
+    {
+      my::tracing::SetThreadName("Worker");
+      for (size_t j = 0; j < 10; ++j)
+      {
+        TRACE_SCOPE("test", "Task");
+      }
+    });
+  }
+  for (thread & t : threads)
+    t.join();
+  my::tracing::Stop();
+
+  {
+    TRACE_SCOPE("test", "Stopped");
+  }
+
+  string const trace = GetTrace();
+  TEST_EQUAL(trace.find("{\"traceEvents\":["), 0, (trace));
+  TEST_EQUAL(CountOf(trace, "\"NotStarted\""), 0, ());
+  TEST_EQUAL(CountOf(trace, "\"Stopped\""), 0, ());
+  TEST_EQUAL(CountOf(trace, "\"Outer\""), 1, ());
+  TEST_EQUAL(CountOf(trace, "\"Inner \\\"quoted\\\"\""), 1, ());
+  TEST_EQUAL(CountOf(trace, "\"Task\""), 30, ());
+  // Threads may get the ids of the finished ones, so there is at least one name.
+  TEST_GREATER_OR_EQUAL(CountOf(trace, "\"thread_name\""), 1, ());
+
+  // Start() clears the previous events.
+  my::tracing::Start();
+  my::tracing::Stop();
+  TEST_EQUAL(CountOf(GetTrace(), "\"ph\":\"X\""), 0, ());
+}
+
+UNIT_TEST(Tracing_RingOverflow)
+{
+  my::tracing::Start();
+  for (size_t i = 0; i < my::tracing::kThreadEventsCount + 10; ++i)
+  {
+    TRACE_SCOPE("test", "Event");
+  }
+  my::tracing::Stop();
+  TEST_EQUAL(CountOf(GetTrace(), "\"Event\""), my::tracing::kThreadEventsCount, ());
+}
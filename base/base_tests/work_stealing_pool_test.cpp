@@ -0,0 +1,58 @@
+#include "testing/testing.hpp"
+
+#include "base/work_stealing_pool.hpp"
+
+#include "std/atomic.hpp"
+#include "std/chrono.hpp"
+#include "std/vector.hpp"
+
+UNIT_TEST(WorkStealingPool_AllTasksAreDone)
+{
+  size_t const kTasksCount = 10000;
+  vector<int> results(kTasksCount, 0);
+  atomic<size_t> done(0);
+
+  threads::WorkStealingPool pool(4 /* threadsCount */, 16 /* maxPendingTasks */);
+  TEST_EQUAL(pool.GetThreadsCount(), 4, ());
+  for (size_t i = 0; i < kTasksCount; ++i)
+  {
+    pool.Push([&results, &done, i]()
+    {
+      results[i] = static_cast<int>(i);
+      ++done;
+    });
+  }
+  pool.WaitForDone();
+
+  TEST_EQUAL(done, kTasksCount, ());
+  for (size_t i = 0; i < kTasksCount; ++i)
+    TEST_EQUAL(results[i], i, ());
+}
+
+UNIT_TEST(WorkStealingPool_PendingTasksAreBounded)
+{
+  size_t const kTasksCount = 50;
+  size_t const kMaxPendingTasks = 3;
+  atomic<size_t> done(0);
+  {
+    threads::WorkStealingPool pool(2 /* threadsCount */, kMaxPendingTasks);
+    for (size_t i = 0; i < kTasksCount; ++i)
+    {
+      pool.Push([&done]()
+      {
+        this_thread::sleep_for(milliseconds(1));
+        ++done;
+      });
+      TEST_LESS_OR_EQUAL(i + 1 - done, kMaxPendingTasks, ());
+    }
+    // The destructor waits for the pushed tasks.
+  }
+  TEST_EQUAL(done, kTasksCount, ());
+}
+
+UNIT_TEST(WorkStealingPool_Empty)
+{
+  threads::WorkStealingPool pool(0 /* threadsCount */, 1 /* maxPendingTasks */);
+  TEST_GREATER(pool.GetThreadsCount(), 0, ());
+  pool.WaitForDone();
+}
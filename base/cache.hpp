@@ -1,10 +1,18 @@
+#pragma once
+
 #include "base/assert.hpp"
 #include "base/base.hpp"
 #include "base/macros.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/functional.hpp"
+#include "std/mutex.hpp"
+#include "std/sstream.hpp"
+#include "std/string.hpp"
 #include "std/type_traits.hpp"
 #include "std/unique_ptr.hpp"
 #include "std/utility.hpp"
+#include "std/vector.hpp"
 
 
 namespace my
@@ -164,4 +172,386 @@ namespace my
     uint64_t m_miss;
     uint64_t m_access;
   };
+
+  namespace cache
+  {
+    enum class Eviction
+    {
+      /// Second chance: entries which were found since the last pass of the clock hand are kept.
+      Clock,
+      /// Clock victims are replaced only by the keys which are looked up not less often.
+      /// Frequencies of the keys are estimated by a count-min sketch which is halved
+      /// periodically, so the cache adapts to the changes of the workload.
+      TinyLfu
+    };
+
+    /// Mutex of the caches which are used by one thread.
+    struct NoLock
+    {
+      void lock() {}
+      void unlock() {}
+    };
+
+    template <typename TValue>
+    struct UnitWeight
+    {
+      size_t operator()(TValue const &) const { return 1; }
+    };
+
+    struct Stats
+    {
+      uint64_t m_hits = 0;
+      uint64_t m_misses = 0;
+      uint64_t m_evictions = 0;
+      /// Inserts which aren't admitted by TinyLfu or are heavier than the cache.
+      uint64_t m_rejections = 0;
+      size_t m_count = 0;
+      size_t m_weight = 0;
+
+      double GetHitRate() const
+      {
+        uint64_t const lookups = m_hits + m_misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(m_hits) / lookups;
+      }
+    };
+
+    inline string DebugPrint(Stats const & stats)
+    {
+      ostringstream out;
+      out << "cache::Stats [ hits: " << stats.m_hits << ", misses: " << stats.m_misses
+          << ", hit rate: " << stats.GetHitRate() << ", evictions: " << stats.m_evictions
+          << ", rejections: " << stats.m_rejections << ", count: " << stats.m_count
+          << ", weight: " << stats.m_weight << " ]";
+      return out.str();
+    }
+  }  // namespace cache
+
+  /// Cache where each key lives in one set of kWays entries, so a lookup scans a few adjacent
+  /// keys. Entries are evicted by CLOCK or TinyLfu when their set is full, and by a global
+  /// CLOCK hand when the total weight, e.g. in bytes, exceeds the limit.
+  /// It's thread-safe with TMutex = mutex. Values are copied out, so the big values should be
+  /// kept by shared_ptr.
+  template <typename TKey, typename TValue, typename THash = hash<TKey>,
+            typename TWeight = cache::UnitWeight<TValue>, typename TMutex = cache::NoLock>
+  class SetAssociativeCache
+  {
+    DISALLOW_COPY_AND_MOVE(SetAssociativeCache);
+
+  public:
+    static size_t const kWays = 8;
+
+    /// @param count Number of the entries, it's rounded up to kWays times a power of two.
+    /// @param maxWeight Limit of the total weight of the entries.
+    SetAssociativeCache(size_t count, size_t maxWeight,
+                        cache::Eviction eviction = cache::Eviction::Clock,
+                        THash const & hasher = THash(), TWeight const & weigher = TWeight())
+      : m_hasher(hasher), m_weigher(weigher), m_eviction(eviction), m_sweep(0), m_weight(0),
+        m_maxWeight(maxWeight), m_count(0), m_sketchAdditions(0)
+    {
+      size_t setsCount = 1;
+      while (setsCount * kWays < count)
+        setsCount *= 2;
+      m_setsMask = setsCount - 1;
+
+      size_t const capacity = setsCount * kWays;
+      m_keys.resize(capacity);
+      m_values.resize(capacity);
+      m_weights.resize(capacity, 0);
+      m_flags.resize(capacity, 0);
+      m_hands.resize(setsCount, 0);
+
+      if (m_eviction == cache::Eviction::TinyLfu)
+      {
+        // Each row has a counter per entry at least, so the keys rarely collide.
+        size_t const width = max(capacity, kSketchMinWidth);
+        m_sketch.resize(kSketchRows * width, 0);
+        m_sketchMask = width - 1;
+      }
+    }
+
+    /// @return False when the key isn't cached.
+    bool Find(TKey const & key, TValue & value)
+    {
+      lock_guard<TMutex> lock(m_mutex);
+      uint64_t const h = GetHash(key);
+      if (!m_sketch.empty())
+        RecordAccess(h);
+
+      size_t const i = FindEntry(GetSet(h), key);
+      if (i == kNotFound)
+      {
+        ++m_stats.m_misses;
+        return false;
+      }
+
+      ++m_stats.m_hits;
+      m_flags[i] |= kReferenced;
+      value = m_values[i];
+      return true;
+    }
+
+    /// Puts the value or replaces the cached one.
+    /// @return False when the value isn't admitted.
+    bool Insert(TKey const & key, TValue const & value)
+    {
+      lock_guard<TMutex> lock(m_mutex);
+      size_t const weight = m_weigher(value);
+      if (weight > m_maxWeight)
+      {
+        ++m_stats.m_rejections;
+        return false;
+      }
+
+      uint64_t const h = GetHash(key);
+      size_t const set = GetSet(h);
+      size_t i = FindEntry(set, key);
+      if (i == kNotFound)
+      {
+        i = FindFree(set);
+        if (i == kNotFound)
+        {
+          i = SelectVictim(set);
+          if (!m_sketch.empty() &&
+              EstimateFrequency(h) < EstimateFrequency(GetHash(m_keys[i])))
+          {
+            ++m_stats.m_rejections;
+            return false;
+          }
+          Evict(i);
+        }
+        m_keys[i] = key;
+        m_flags[i] = kOccupied;
+        ++m_count;
+      }
+      else
+      {
+        m_weight -= m_weights[i];
+        m_flags[i] |= kReferenced;
+      }
+
+      m_values[i] = value;
+      m_weights[i] = weight;
+      m_weight += weight;
+      EvictOverweight(i);
+      return true;
+    }
+
+    /// @return False when the key isn't cached.
+    bool Erase(TKey const & key)
+    {
+      lock_guard<TMutex> lock(m_mutex);
+      size_t const i = FindEntry(GetSet(GetHash(key)), key);
+      if (i == kNotFound)
+        return false;
+      Remove(i);
+      return true;
+    }
+
+    void Clear()
+    {
+      lock_guard<TMutex> lock(m_mutex);
+      for (size_t i = 0; i < m_flags.size(); ++i)
+      {
+        if (m_flags[i] & kOccupied)
+          Remove(i);
+      }
+    }
+
+    /// Entries are evicted until they fit the limit.
+    void SetMaxWeight(size_t maxWeight)
+    {
+      lock_guard<TMutex> lock(m_mutex);
+      m_maxWeight = maxWeight;
+      EvictOverweight(kNotFound);
+    }
+
+    size_t GetMaxWeight() const
+    {
+      lock_guard<TMutex> lock(m_mutex);
+      return m_maxWeight;
+    }
+
+    size_t GetCapacity() const { return m_keys.size(); }
+
+    cache::Stats GetStats() const
+    {
+      lock_guard<TMutex> lock(m_mutex);
+      cache::Stats stats = m_stats;
+      stats.m_count = m_count;
+      stats.m_weight = m_weight;
+      return stats;
+    }
+
+    /// Calls f(key, value) for each entry.
+    template <typename F>
+    void ForEach(F && f) const
+    {
+      lock_guard<TMutex> lock(m_mutex);
+      for (size_t i = 0; i < m_flags.size(); ++i)
+      {
+        if (m_flags[i] & kOccupied)
+          f(m_keys[i], m_values[i]);
+      }
+    }
+
+  private:
+    static size_t const kNotFound = static_cast<size_t>(-1);
+    static size_t const kSketchRows = 4;
+    static uint8_t const kSketchMaxCounter = 15;
+    static size_t const kSketchMinWidth = 1024;
+    // Counters are halved after the accesses of this factor times the width of the sketch.
+    static size_t const kSketchResetFactor = 10;
+
+    enum Flags : uint8_t
+    {
+      kOccupied = 1,
+      kReferenced = 2
+    };
+
+    uint64_t GetHash(TKey const & key) const
+    {
+      // Finalizer of MurmurHash3, the standard hashes of integers are identities.
+      uint64_t h = static_cast<uint64_t>(m_hasher(key));
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return h;
+    }
+
+    size_t GetSet(uint64_t h) const { return static_cast<size_t>(h) & m_setsMask; }
+
+    size_t FindEntry(size_t set, TKey const & key) const
+    {
+      size_t const begin = set * kWays;
+      for (size_t i = begin; i < begin + kWays; ++i)
+      {
+        if ((m_flags[i] & kOccupied) && m_keys[i] == key)
+          return i;
+      }
+      return kNotFound;
+    }
+
+    size_t FindFree(size_t set) const
+    {
+      size_t const begin = set * kWays;
+      for (size_t i = begin; i < begin + kWays; ++i)
+      {
+        if (!(m_flags[i] & kOccupied))
+          return i;
+      }
+      return kNotFound;
+    }
+
+    /// Clock over the full set.
+    size_t SelectVictim(size_t set)
+    {
+      uint8_t & hand = m_hands[set];
+      while (true)
+      {
+        size_t const i = set * kWays + hand;
+        hand = static_cast<uint8_t>((hand + 1) % kWays);
+        if (!(m_flags[i] & kReferenced))
+          return i;
+        m_flags[i] &= ~kReferenced;
+      }
+    }
+
+    /// Evicts the entries except keep by the global clock hand.
+    void EvictOverweight(size_t keep)
+    {
+      while (m_weight > m_maxWeight && m_count > (keep == kNotFound ? 0 : 1))
+      {
+        size_t const i = m_sweep;
+        m_sweep = (m_sweep + 1) % m_flags.size();
+        if (i == keep || !(m_flags[i] & kOccupied))
+          continue;
+        if (m_flags[i] & kReferenced)
+        {
+          m_flags[i] &= ~kReferenced;
+          continue;
+        }
+        Evict(i);
+      }
+    }
+
+    void Evict(size_t i)
+    {
+      ++m_stats.m_evictions;
+      Remove(i);
+    }
+
+    void Remove(size_t i)
+    {
+      ASSERT(m_flags[i] & kOccupied, ());
+      m_weight -= m_weights[i];
+      m_weights[i] = 0;
+      m_flags[i] = 0;
+      // The memory of the value is freed at once.
+      m_values[i] = TValue();
+      --m_count;
+    }
+
+    size_t GetSketchIndex(uint64_t h, size_t row) const
+    {
+      uint64_t const step = (h >> 32) | 1;
+      return row * (m_sketchMask + 1) + static_cast<size_t>((h + row * step) & m_sketchMask);
+    }
+
+    void RecordAccess(uint64_t h)
+    {
+      for (size_t row = 0; row < kSketchRows; ++row)
+      {
+        uint8_t & counter = m_sketch[GetSketchIndex(h, row)];
+        if (counter < kSketchMaxCounter)
+          ++counter;
+      }
+
+      if (++m_sketchAdditions == kSketchResetFactor * (m_sketchMask + 1))
+      {
+        for (uint8_t & counter : m_sketch)
+          counter /= 2;
+        m_sketchAdditions = 0;
+      }
+    }
+
+    uint8_t EstimateFrequency(uint64_t h) const
+    {
+      uint8_t frequency = kSketchMaxCounter;
+      for (size_t row = 0; row < kSketchRows; ++row)
+        frequency = min(frequency, m_sketch[GetSketchIndex(h, row)]);
+      return frequency;
+    }
+
+    mutable TMutex m_mutex;
+    THash m_hasher;
+    TWeight m_weigher;
+    cache::Eviction const m_eviction;
+
+    size_t m_setsMask;
+    // Entries of the set i are [i * kWays, (i + 1) * kWays).
+    vector<TKey> m_keys;
+    vector<TValue> m_values;
+    vector<size_t> m_weights;
+    vector<uint8_t> m_flags;
+    vector<uint8_t> m_hands;
+    size_t m_sweep;
+
+    size_t m_weight;
+    size_t m_maxWeight;
+    size_t m_count;
+
+    // Count-min sketch of TinyLfu, kSketchRows rows of m_sketchMask + 1 counters.
+    vector<uint8_t> m_sketch;
+    size_t m_sketchMask;
+    size_t m_sketchAdditions;
+
+    cache::Stats m_stats;
+  };
+
+  template <typename TKey, typename TValue, typename THash, typename TWeight, typename TMutex>
+  size_t const SetAssociativeCache<TKey, TValue, THash, TWeight, TMutex>::kWays;
+  template <typename TKey, typename TValue, typename THash, typename TWeight, typename TMutex>
+  size_t const SetAssociativeCache<TKey, TValue, THash, TWeight, TMutex>::kSketchMinWidth;
 }
@@ -0,0 +1,91 @@
+#include "base/cache_governor.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/sstream.hpp"
+
+namespace
+{
+double GetPriorityShare(CacheGovernor::Priority priority, double share)
+{
+  switch (priority)
+  {
+  case CacheGovernor::LOW:
+    return min(1.0, 2.0 * share);
+  case CacheGovernor::NORMAL:
+    return share;
+  case CacheGovernor::HIGH:
+    return 0.5 * share;
+  }
+  return share;
+}
+}  // namespace
+
+// static
+CacheGovernor::TCacheId const CacheGovernor::kInvalidId;
+
+// static
+CacheGovernor & CacheGovernor::Instance()
+{
+  static CacheGovernor instance;
+  return instance;
+}
+
+CacheGovernor::TCacheId CacheGovernor::Register(string const & name, Priority priority,
+                                                TGetBytesFn const & getBytes, TTrimFn const & trim)
+{
+  ASSERT(trim, (name));
+  lock_guard<mutex> lock(m_mutex);
+  m_caches.push_back({++m_lastId, name, priority, getBytes, trim});
+  return m_lastId;
+}
+
+void CacheGovernor::Unregister(TCacheId id)
+{
+  lock_guard<mutex> lock(m_mutex);
+  auto const it = find_if(m_caches.begin(), m_caches.end(), [id](Entry const & e)
+  {
+    return e.m_id == id;
+  });
+  if (it != m_caches.end())
+    m_caches.erase(it);
+}
+
+void CacheGovernor::Trim(double share)
+{
+  ASSERT_GREATER_OR_EQUAL(share, 0.0, ());
+  ASSERT_LESS_OR_EQUAL(share, 1.0, ());
+  if (share <= 0.0)
+    return;
+
+  lock_guard<mutex> lock(m_mutex);
+  for (Entry const & e : m_caches)
+    e.m_trim(GetPriorityShare(e.m_priority, share));
+}
+
+vector<CacheGovernor::CacheInfo> CacheGovernor::GetReport() const
+{
+  vector<CacheInfo> report;
+  lock_guard<mutex> lock(m_mutex);
+  report.reserve(m_caches.size());
+  for (Entry const & e : m_caches)
+    report.push_back({e.m_name, e.m_priority, e.m_getBytes ? e.m_getBytes() : 0});
+  return report;
+}
+
+uint64_t CacheGovernor::GetTotalBytes() const
+{
+  uint64_t total = 0;
+  for (CacheInfo const & info : GetReport())
+    total += info.m_bytes;
+  return total;
+}
+
+string DebugPrint(CacheGovernor::CacheInfo const & info)
+{
+  ostringstream ss;
+  ss << "CacheInfo [ " << info.m_name << ", priority: " << static_cast<int>(info.m_priority)
+     << ", bytes: " << info.m_bytes << " ]";
+  return ss.str();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "base/macros.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/function.hpp"
+#include "std/mutex.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+/// Registry of the caches of all the subsystems. On the memory pressure it asks every cache
+/// to free the same share of its memory, so no cache is emptied while others stay full.
+/// Cheap caches are trimmed harder than the expensive ones, see Priority.
+class CacheGovernor
+{
+public:
+  enum Priority
+  {
+    /// Cheap to rebuild, gets twice the requested share.
+    LOW,
+    NORMAL,
+    /// Expensive to rebuild, gets half of the requested share.
+    HIGH
+  };
+
+  /// @return Memory used by the cache in bytes.
+  typedef function<uint64_t()> TGetBytesFn;
+  /// @param share Part of the cache to free, from 0 to 1. Caches which can't be freed partially
+  /// should be cleared when it's 0.5 or more.
+  typedef function<void(double share)> TTrimFn;
+
+  typedef uint32_t TCacheId;
+  static TCacheId const kInvalidId = 0;
+
+  struct CacheInfo
+  {
+    string m_name;
+    Priority m_priority;
+    uint64_t m_bytes;
+  };
+
+  static CacheGovernor & Instance();
+
+  /// @param getBytes May be empty when the cache can't measure itself.
+  /// Callbacks are called under the governor's lock, so they must not call the governor.
+  TCacheId Register(string const & name, Priority priority, TGetBytesFn const & getBytes,
+                    TTrimFn const & trim);
+  void Unregister(TCacheId id);
+
+  /// Asks every cache to free the share of its memory, from 0 to 1.
+  void Trim(double share);
+
+  vector<CacheInfo> GetReport() const;
+  uint64_t GetTotalBytes() const;
+
+private:
+  CacheGovernor() = default;
+  DISALLOW_COPY_AND_MOVE(CacheGovernor);
+
+  struct Entry
+  {
+    TCacheId m_id;
+    string m_name;
+    Priority m_priority;
+    TGetBytesFn m_getBytes;
+    TTrimFn m_trim;
+  };
+
+  mutable mutex m_mutex;
+  vector<Entry> m_caches;
+  TCacheId m_lastId = kInvalidId;
+};
+
+string DebugPrint(CacheGovernor::CacheInfo const & info);
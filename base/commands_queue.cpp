@@ -3,6 +3,9 @@
 #include "base/logging.hpp"
 #include "base/assert.hpp"
 
+#include "base/macros.hpp"
+
+#include "std/algorithm.hpp"
 #include "std/bind.hpp"
 
 #include "base/commands_queue.hpp"
@@ -61,6 +64,11 @@ namespace core
 
   CommandsQueue::Command::Command(bool isWaitable)
     : BaseCommand(isWaitable)
+    , m_priority(EHighPriority), m_sequenceID(kNoSequenceID), m_addTime(0.0)
+  {}
+
+  CommandsQueue::Stats::Stats()
+    : m_executedCount(0), m_droppedCount(0), m_avgLatency(0.0), m_maxLatency(0.0)
   {}
 
   void CommandsQueue::Command::perform(Environment const & env) const
@@ -70,7 +78,7 @@ namespace core
   }
 
   CommandsQueue::Routine::Routine(CommandsQueue * parent, size_t idx)
-    : m_parent(parent), m_env(idx)
+    : m_parent(parent), m_env(idx), m_sequenceID(kNoSequenceID)
   {}
 
   void CommandsQueue::Routine::Do()
@@ -84,16 +92,27 @@ namespace core
     // main loop
     while (!IsCancelled())
     {
-      shared_ptr<CommandsQueue::Command> cmd = m_parent->m_commands.Front(true);
-
-      if (m_parent->m_commands.IsCancelled())
-        break;
-
+      shared_ptr<CommandsQueue::Command> cmd = m_parent->TakeCommand(m_env.threadNum());
+      if (!cmd)
+      {
+        if (!m_parent->WaitForCommands())
+          break;
+        continue;
+      }
+
+      // The sequence is published before the check, so SetSequenceID
+      // either sees it and cancels the command or the command is dropped here.
+      m_sequenceID = cmd->m_sequenceID;
       m_env.Reset();
 
-      cmd->perform(m_env);
+      bool const isDropped = m_parent->IsObsolete(*cmd);
+      if (isDropped)
+        cmd->finish();
+      else
+        cmd->perform(m_env);
 
-      m_parent->FinishCommand();
+      m_sequenceID = kNoSequenceID;
+      m_parent->FinishCommand(isDropped);
     }
 
     // performing finalization tasks
@@ -121,6 +140,13 @@ namespace core
     m_env.Cancel();
   }
 
+  void CommandsQueue::Routine::CancelSequence(int sequenceID)
+  {
+    int const current = m_sequenceID;
+    if (current != kNoSequenceID && current < sequenceID)
+      m_env.Cancel();
+  }
+
   void CommandsQueue::Executor::Cancel()
   {
     if (m_thread.GetRoutine())
@@ -134,9 +160,21 @@ namespace core
     routine->CancelCommand();
   }
 
+  void CommandsQueue::Executor::CancelSequence(int sequenceID)
+  {
+    // The sequence can be set before the queue is started.
+    if (m_thread.GetRoutine())
+      m_thread.GetRoutineAs<Routine>()->CancelSequence(sequenceID);
+  }
+
   CommandsQueue::CommandsQueue(size_t executorsCount)
-      : m_executors(executorsCount), m_activeCommands(0)
+      : m_executors(executorsCount), m_nextLane(0), m_sequenceID(kNoSequenceID)
+      , m_activeCommands(0), m_queuedCommands(0), m_isCancelled(false), m_latencySum(0.0)
   {
+    CHECK_GREATER(executorsCount, 0, ());
+    m_lanes.reserve(executorsCount);
+    for (size_t i = 0; i < executorsCount; ++i)
+      m_lanes.emplace_back(new Lane());
   }
 
   CommandsQueue::~CommandsQueue()
@@ -147,7 +185,11 @@ namespace core
 
   void CommandsQueue::Cancel()
   {
-    m_commands.Cancel();
+    {
+      threads::ConditionGuard g(m_cond);
+      m_isCancelled = true;
+      g.Signal(true);
+    }
 
     for (auto & executor : m_executors)
       executor.Cancel();
@@ -168,9 +210,96 @@ namespace core
 
   void CommandsQueue::AddCommand(shared_ptr<Command> const & cmd)
   {
+    ASSERT_LESS(cmd->m_priority, EPrioritiesCount, ());
+    cmd->m_addTime = m_timer.ElapsedSeconds();
+
+    // The counters are updated after the command is queued, so an executor,
+    // which has found the lanes empty, is woken up by the signal below.
+    Lane & lane = *m_lanes[m_nextLane++ % m_lanes.size()];
+    {
+      threads::MutexGuard lg(lane.m_mutex);
+      UNUSED_VALUE(lg);
+      lane.m_commands[cmd->m_priority].push_back(cmd);
+    }
+
     threads::ConditionGuard g(m_cond);
-    m_commands.PushBack(cmd);
     ++m_activeCommands;
+    ++m_queuedCommands;
+    g.Signal(true);
+  }
+
+  shared_ptr<CommandsQueue::Command> CommandsQueue::TakeCommand(size_t laneIdx)
+  {
+    shared_ptr<Command> cmd;
+    for (size_t priority = 0; priority < EPrioritiesCount && !cmd; ++priority)
+    {
+      for (size_t i = 0; i < m_lanes.size() && !cmd; ++i)
+      {
+        Lane & lane = *m_lanes[(laneIdx + i) % m_lanes.size()];
+        threads::MutexGuard lg(lane.m_mutex);
+        UNUSED_VALUE(lg);
+
+        deque<shared_ptr<Command> > & commands = lane.m_commands[priority];
+        if (commands.empty())
+          continue;
+
+        // Own commands are taken in the order of adding, the stolen ones are the latest.
+        if (i == 0)
+        {
+          cmd = commands.front();
+          commands.pop_front();
+        }
+        else
+        {
+          cmd = commands.back();
+          commands.pop_back();
+        }
+      }
+    }
+
+    if (cmd)
+    {
+      double const latency = m_timer.ElapsedSeconds() - cmd->m_addTime;
+
+      threads::ConditionGuard g(m_cond);
+      --m_queuedCommands;
+      m_latencySum += latency;
+      m_stats.m_maxLatency = max(m_stats.m_maxLatency, latency);
+    }
+    return cmd;
+  }
+
+  bool CommandsQueue::WaitForCommands()
+  {
+    threads::ConditionGuard g(m_cond);
+    while (m_queuedCommands == 0 && !m_isCancelled)
+      g.Wait();
+    return !m_isCancelled;
+  }
+
+  bool CommandsQueue::IsObsolete(Command const & cmd) const
+  {
+    return cmd.m_sequenceID != kNoSequenceID && cmd.m_sequenceID < m_sequenceID;
+  }
+
+  void CommandsQueue::SetSequenceID(int sequenceID)
+  {
+    int const prevSequenceID = m_sequenceID.exchange(sequenceID);
+    if (sequenceID <= prevSequenceID)
+      return;
+
+    for (auto & executor : m_executors)
+      executor.CancelSequence(sequenceID);
+  }
+
+  CommandsQueue::Stats CommandsQueue::GetStats() const
+  {
+    threads::ConditionGuard g(m_cond);
+    Stats stats = m_stats;
+    size_t const takenCount = stats.m_executedCount + stats.m_droppedCount;
+    if (takenCount != 0)
+      stats.m_avgLatency = m_latencySum / takenCount;
+    return stats;
   }
 
   void CommandsQueue::AddInitCommand(shared_ptr<Command> const & cmd)
@@ -188,10 +317,15 @@ namespace core
     m_cancelCommands.push_back(cmd);
   }
 
-  void CommandsQueue::FinishCommand()
+  void CommandsQueue::FinishCommand(bool isDropped)
   {
     threads::ConditionGuard g(m_cond);
 
+    if (isDropped)
+      ++m_stats.m_droppedCount;
+    else
+      ++m_stats.m_executedCount;
+
     --m_activeCommands;
 
     if (m_activeCommands == 0)
@@ -205,28 +339,34 @@ namespace core
       g.Wait();
   }
 
-  void CommandsQueue::ClearImpl(list<shared_ptr<CommandsQueue::Command> > & l)
-  {
-    threads::ConditionGuard g(m_cond);
-    size_t s = l.size();
-    l.clear();
-    m_activeCommands -= s;
-    if (m_activeCommands == 0)
-      g.Signal(true);
-  }
-
   void CommandsQueue::Clear()
   {
     /// let us assume that decreasing m_activeCommands is an "operation A"
-    /// and clearing the list of commands is an "operation B"
+    /// and clearing the lanes is an "operation B"
     /// we should perform them atomically (both or none at the same time)
     /// to prevent the situation when Executor could start processing some command
-    /// between "operation A" and "operation B" which could lead to underflow of m_activeCommands
+    /// between "operation A" and "operation B" which could lead to underflow of m_activeCommands.
+    /// Executors lock a lane and m_cond one after another, never both at once,
+    /// so the lanes are locked under m_cond here.
 
-    m_commands.ProcessList([this](list<shared_ptr<CommandsQueue::Command> > & l)
-                           {
-                             ClearImpl(l);
-                           });
+    threads::ConditionGuard g(m_cond);
+
+    size_t s = 0;
+    for (auto const & lane : m_lanes)
+    {
+      threads::MutexGuard lg(lane->m_mutex);
+      UNUSED_VALUE(lg);
+      for (auto & commands : lane->m_commands)
+      {
+        s += commands.size();
+        commands.clear();
+      }
+    }
+
+    m_activeCommands -= s;
+    m_queuedCommands -= s;
+    if (m_activeCommands == 0)
+      g.Signal(true);
   }
 
   size_t CommandsQueue::ExecutorsCount() const
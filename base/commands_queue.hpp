@@ -1,17 +1,26 @@
 #pragma once
 
+#include "std/atomic.hpp"
+#include "std/deque.hpp"
 #include "std/function.hpp"
+#include "std/list.hpp"
 #include "std/shared_ptr.hpp"
+#include "std/unique_ptr.hpp"
 #include "std/vector.hpp"
 
 #include "base/cancellable.hpp"
+#include "base/condition.hpp"
+#include "base/mutex.hpp"
 #include "base/thread.hpp"
-#include "base/threaded_list.hpp"
+#include "base/timer.hpp"
 
 namespace core
 {
   /// class, that executes task, specified as a functors on the specified number of threads
-  /// - all tasks are stored in the single ThreadedList
+  /// - every executor has its own deque of tasks, commands are spread over the deques
+  ///   and an idle executor steals tasks from the deques of the others
+  /// - high priority tasks are taken before the low priority ones from all the deques
+  /// - tasks of the sequence older than SetSequenceID are dropped or cancelled
   class CommandsQueue
   {
   private:
@@ -20,6 +29,29 @@ namespace core
   public:
     struct Command;
 
+    enum EPriority
+    {
+      EHighPriority = 0,  //< e.g. tiles on the screen
+      ELowPriority,       //< e.g. prefetched tiles
+      EPrioritiesCount
+    };
+
+    /// the command doesn't belong to any sequence, it's never dropped by SetSequenceID
+    static int const kNoSequenceID = -1;
+
+    /// statistics of the commands since the queue start
+    struct Stats
+    {
+      Stats();
+
+      size_t m_executedCount;
+      /// dropped by SetSequenceID without execution
+      size_t m_droppedCount;
+      /// time from adding the command to the start of its execution in seconds
+      double m_avgLatency;
+      double m_maxLatency;
+    };
+
     /// execution environment for single command
     /// - passed into the task functor
     /// - task functor should check the IsCancelled()
@@ -93,11 +125,17 @@ namespace core
       function_t m_fn;
 
     public:
+      EPriority m_priority;
+      int m_sequenceID;
+      /// when the command was added, by the queue timer
+      double m_addTime;
+
       Command(bool isWaitable = false);
 
       template <typename tt>
       Command(tt t, bool isWaitable = false)
         : BaseCommand(isWaitable), m_fn(t)
+        , m_priority(EHighPriority), m_sequenceID(kNoSequenceID), m_addTime(0.0)
       {}
 
       void perform(Environment const & env) const;
@@ -110,6 +148,8 @@ namespace core
     private:
       CommandsQueue * m_parent;
       Environment m_env;
+      /// sequence of the executing command
+      atomic<int> m_sequenceID;
 
     public:
       Routine(CommandsQueue * parent, size_t idx);
@@ -119,6 +159,8 @@ namespace core
       void Cancel() override;
 
       void CancelCommand();
+      /// cancel the executing command when it's older than the sequenceID
+      void CancelSequence(int sequenceID);
     };
 
     /// class, which excapsulates thread and routine into single class.
@@ -128,10 +170,22 @@ namespace core
 
       void Cancel();
       void CancelCommand();
+      void CancelSequence(int sequenceID);
+    };
+
+    /// commands of one executor
+    /// - the executor takes them from the front, others steal them from the back
+    struct Lane
+    {
+      threads::Mutex m_mutex;
+      deque<shared_ptr<Command> > m_commands[EPrioritiesCount];
     };
 
     vector<Executor> m_executors;
-    ThreadedList<shared_ptr<Command> > m_commands;
+    vector<unique_ptr<Lane> > m_lanes;
+    atomic<size_t> m_nextLane;
+    atomic<int> m_sequenceID;
+    my::Timer m_timer;
 
     list<shared_ptr<Command> > m_initCommands;
     list<shared_ptr<Command> > m_finCommands;
@@ -139,15 +193,24 @@ namespace core
 
     friend class Routine;
 
-    threads::Condition m_cond;
+    /// guards the counters and the stats, executors wait on it for the commands
+    mutable threads::Condition m_cond;
     size_t m_activeCommands;
-    void FinishCommand();
+    size_t m_queuedCommands;
+    bool m_isCancelled;
+    Stats m_stats;
+    double m_latencySum;
+
+    /// @return empty pointer when there are no commands
+    shared_ptr<Command> TakeCommand(size_t laneIdx);
+    /// @return false when the queue is cancelled
+    bool WaitForCommands();
+    bool IsObsolete(Command const & cmd) const;
+    void FinishCommand(bool isDropped);
 
     CommandsQueue(CommandsQueue const &);
     CommandsQueue const & operator=(CommandsQueue const &);
 
-    void ClearImpl(list<shared_ptr<Command> > & l);
-
   public:
     CommandsQueue(size_t executorsCount);
     ~CommandsQueue();
@@ -169,6 +232,11 @@ namespace core
     void Join();
     void Clear();
 
+    /// queued commands of the older sequences are dropped,
+    /// the executing ones are cancelled through their Environment
+    void SetSequenceID(int sequenceID);
+    Stats GetStats() const;
+
     template<typename command_tt>
     shared_ptr<Command> AddCommand(command_tt cmd, bool isWaitable = false)
     {
@@ -177,6 +245,16 @@ namespace core
       return pcmd;
     }
 
+    template<typename command_tt>
+    shared_ptr<Command> AddCommand(command_tt cmd, EPriority priority, int sequenceID)
+    {
+      shared_ptr<Command> pcmd(new Command(cmd));
+      pcmd->m_priority = priority;
+      pcmd->m_sequenceID = sequenceID;
+      AddCommand(pcmd);
+      return pcmd;
+    }
+
     template <typename command_tt>
     shared_ptr<Command> AddInitCommand(command_tt cmd, bool isWaitable = false)
     {
@@ -120,17 +120,27 @@ namespace my
 {
   namespace impl
   {
-    inline string Message()
+    inline void AppendMessage(string &)
     {
-      return string();
     }
-    template <typename T> string Message(T const & t)
+    template <typename T, typename... ARGS>
+    void AppendMessage(string & s, T const & t, ARGS const & ... others)
     {
-      return DebugPrint(t);
+      s += ' ';
+      s += DebugPrint(t);
+      AppendMessage(s, others...);
+    }
+
+    inline string Message()
+    {
+      return string();
     }
+    /// Parts are appended to one string, so long messages aren't copied for every argument.
     template <typename T, typename... ARGS> string Message(T const & t, ARGS const & ... others)
     {
-      return DebugPrint(t) + " " + Message(others...);
+      string s = DebugPrint(t);
+      AppendMessage(s, others...);
+      return s;
     }
   }
 }
@@ -27,17 +27,31 @@ namespace my
   void LogMessageTests(LogLevel level, SrcPoint const & srcPoint, string const & msg);
 }
 
+/// Messages of the levels below it are removed by the compiler with their arguments,
+/// e.g. DEFINES += OMIM_LOG_MIN_LEVEL=LINFO removes LOG(LDEBUG) from the hot loops.
+#ifndef OMIM_LOG_MIN_LEVEL
+#define OMIM_LOG_MIN_LEVEL LDEBUG
+#endif
+
+namespace my
+{
+  LogLevel const kLogMinLevel = OMIM_LOG_MIN_LEVEL;
+}
+
 using ::my::LDEBUG;
 using ::my::LINFO;
 using ::my::LWARNING;
 using ::my::LERROR;
 using ::my::LCRITICAL;
 
-// Logging macro.
+/// @return True when the messages of the level are filtered out at compile time or at run time.
+#define LOG_IS_FILTERED(level) ((level) < ::my::kLogMinLevel || (level) < ::my::g_LogLevel)
+
+// Logging macro. Arguments are evaluated and formatted only when the message isn't filtered.
 // Example usage: LOG(LINFO, (Calc(), m_Var, "Some string constant"));
-#define LOG(level, msg) do { if ((level) < ::my::g_LogLevel) {} \
+#define LOG(level, msg) do { if (LOG_IS_FILTERED(level)) {} \
   else { ::my::LogMessage(level, SRC(), ::my::impl::Message msg);} } while (false)
 
 // Logging macro with short info (without entry point)
-#define LOG_SHORT(level, msg) do { if ((level) < ::my::g_LogLevel) {} \
+#define LOG_SHORT(level, msg) do { if (LOG_IS_FILTERED(level)) {} \
   else { ::my::LogMessage(level, my::SrcPoint(), ::my::impl::Message msg);} } while (false)
@@ -106,6 +106,11 @@ namespace my
       return m_maxWeight;
     }
 
+    int CurrentWeight() const
+    {
+      return m_curWeight;
+    }
+
     void Resize(int maxWeight)
     {
       m_maxWeight = maxWeight;
@@ -251,7 +256,7 @@ namespace my
     void Clear()
     {
       for (typename map_t::iterator it = m_map.begin(); it != m_map.end(); ++it)
-        ValueTraitsT::Evict(it->second);
+        ValueTraitsT::Evict(it->second.m_value);
 
       m_map.clear();
       m_keys.clear();
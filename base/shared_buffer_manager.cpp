@@ -1,5 +1,87 @@
 #include "base/shared_buffer_manager.hpp"
 
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+
+#include "std/sstream.hpp"
+
+namespace
+{
+size_t GetClassSize(size_t sizeClass, size_t minClassBits)
+{
+  return static_cast<size_t>(1) << (sizeClass + minClassBits);
+}
+
+/// @return The biggest class which isn't above size.
+size_t GetFloorClass(size_t size, size_t minClassBits)
+{
+  size_t sizeClass = 0;
+  while (GetClassSize(sizeClass + 1, minClassBits) <= size)
+    ++sizeClass;
+  return sizeClass;
+}
+}  // namespace
+
+// static
+size_t const SharedBufferManager::kMaxCachedBufferSize;
+// static
+size_t const SharedBufferManager::kThreadCacheSize;
+// static
+size_t const SharedBufferManager::kDefaultMaxCachedSize;
+// static
+size_t const SharedBufferManager::kMinClassBits;
+// static
+size_t const SharedBufferManager::kClassesCount;
+// static
+size_t const SharedBufferManager::kMaxThreadsCount;
+
+static_assert(SharedBufferManager::kMaxCachedBufferSize == 4 * 1024 * 1024,
+              "Size classes must cover the cached buffers.");
+
+SharedBufferManager::Stats::Stats()
+  : m_reserved(0), m_threadHits(0), m_sharedHits(0), m_dropped(0), m_cachedSize(0), m_cachedCount(0)
+{
+}
+
+SharedBufferManager::Cache::Cache() : m_size(0), m_count(0) {}
+
+SharedBufferManager::shared_buffer_ptr_t SharedBufferManager::Cache::Pop(size_t sizeClass)
+{
+  shared_buffer_ptr_list_t & l = m_buffers[sizeClass];
+  if (l.empty())
+    return shared_buffer_ptr_t();
+
+  shared_buffer_ptr_t res = move(l.back());
+  l.pop_back();
+  m_size -= GetClassSize(sizeClass, kMinClassBits);
+  --m_count;
+  return res;
+}
+
+void SharedBufferManager::Cache::Push(size_t sizeClass, shared_buffer_ptr_t && buf)
+{
+  m_buffers[sizeClass].push_back(move(buf));
+  m_size += GetClassSize(sizeClass, kMinClassBits);
+  ++m_count;
+}
+
+void SharedBufferManager::Cache::Clear(vector<shared_buffer_ptr_t> & released)
+{
+  for (shared_buffer_ptr_list_t & l : m_buffers)
+  {
+    for (shared_buffer_ptr_t & buf : l)
+      released.push_back(move(buf));
+    l.clear();
+  }
+  m_size = 0;
+  m_count = 0;
+}
+
+SharedBufferManager::SharedBufferManager()
+  : m_threadsCount(0), m_cachedSize(0), m_maxCachedSize(kDefaultMaxCachedSize), m_dropped(0),
+    m_uncachedReserved(0)
+{
+}
 
 SharedBufferManager & SharedBufferManager::instance()
 {
@@ -7,31 +89,182 @@ SharedBufferManager & SharedBufferManager::instance()
   return i;
 }
 
-SharedBufferManager::shared_buffer_ptr_t SharedBufferManager::reserveSharedBuffer(size_t s)
+SharedBufferManager::ThreadCache * SharedBufferManager::GetThreadCache()
 {
+  thread::id const id = this_thread::get_id();
+  size_t const count = m_threadsCount.load(memory_order_acquire);
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (m_threads[i]->m_id == id)
+      return m_threads[i];
+  }
+
   threads::MutexGuard g(m_mutex);
+  size_t const i = m_threadsCount.load(memory_order_relaxed);
+  if (i == kMaxThreadsCount)
+    return nullptr;
+  m_threads[i] = new ThreadCache(id);
+  m_threadsCount.store(i + 1, memory_order_release);
+  return m_threads[i];
+}
 
-  shared_buffer_ptr_list_t & l = m_sharedBuffers[s];
+SharedBufferManager::shared_buffer_ptr_t SharedBufferManager::reserveSharedBuffer(size_t s)
+{
+  if (s > kMaxCachedBufferSize)
+  {
+    m_uncachedReserved.fetch_add(1, memory_order_relaxed);
+    return make_shared<shared_buffer_t>(s);
+  }
 
-  if (l.empty())
-    l.push_back(make_shared<shared_buffer_t>(s));
+  size_t sizeClass = GetFloorClass(s, kMinClassBits);
+  if (GetClassSize(sizeClass, kMinClassBits) < s)
+    ++sizeClass;
+  ASSERT_LESS(sizeClass, kClassesCount, (s));
+  size_t const classSize = GetClassSize(sizeClass, kMinClassBits);
 
-  shared_buffer_ptr_t res = l.front();
-  l.pop_front();
+  shared_buffer_ptr_t res;
+  ThreadCache * tc = GetThreadCache();
+  if (tc != nullptr)
+  {
+    threads::MutexGuard g(tc->m_mutex);
+    ++tc->m_reserved;
+    res = tc->m_cache.Pop(sizeClass);
+    if (res)
+      ++tc->m_threadHits;
+  }
+  else
+  {
+    m_uncachedReserved.fetch_add(1, memory_order_relaxed);
+  }
 
+  if (!res)
+  {
+    threads::MutexGuard g(m_mutex);
+    res = m_sharedCache.Pop(sizeClass);
+    if (res && tc != nullptr)
+    {
+      threads::MutexGuard tg(tc->m_mutex);
+      ++tc->m_sharedHits;
+    }
+  }
+
+  if (res)
+  {
+    m_cachedSize.fetch_sub(classSize, memory_order_relaxed);
+  }
+  else
+  {
+    res = make_shared<shared_buffer_t>();
+    res->reserve(classSize);
+  }
+
+  // Capacity is the class size, so it doesn't reallocate.
+  res->resize(s);
   return res;
 }
 
 void SharedBufferManager::freeSharedBuffer(size_t s, shared_buffer_ptr_t buf)
 {
-  threads::MutexGuard g(m_mutex);
+  ASSERT(buf, ());
+  ASSERT_LESS_OR_EQUAL(s, buf->capacity(), ());
+  UNUSED_VALUE(s);
+
+  size_t const capacity = buf->capacity();
+  if (capacity < GetClassSize(0, kMinClassBits) || capacity > kMaxCachedBufferSize)
+    return;
 
-  shared_buffer_ptr_list_t & l = m_sharedBuffers[s];
+  // The biggest class which fits the capacity, it's the class of the buffers made by
+  // reserveSharedBuffer.
+  size_t const sizeClass = GetFloorClass(capacity, kMinClassBits);
+  size_t const classSize = GetClassSize(sizeClass, kMinClassBits);
 
-  l.push_back(buf);
+  size_t const cachedSize = m_cachedSize.fetch_add(classSize, memory_order_relaxed) + classSize;
+  if (cachedSize > m_maxCachedSize.load(memory_order_relaxed))
+  {
+    m_cachedSize.fetch_sub(classSize, memory_order_relaxed);
+    m_dropped.fetch_add(1, memory_order_relaxed);
+    return;
+  }
+
+  ThreadCache * tc = GetThreadCache();
+  if (tc != nullptr)
+  {
+    threads::MutexGuard g(tc->m_mutex);
+    if (tc->m_cache.m_size + classSize <= kThreadCacheSize)
+    {
+      tc->m_cache.Push(sizeClass, move(buf));
+      return;
+    }
+  }
+
+  threads::MutexGuard g(m_mutex);
+  m_sharedCache.Push(sizeClass, move(buf));
 }
 
 uint8_t * SharedBufferManager::GetRawPointer(SharedBufferManager::shared_buffer_ptr_t ptr)
 {
   return &((*ptr)[0]);
 }
+
+void SharedBufferManager::ReleaseCached()
+{
+  // Buffers are freed after the locks.
+  vector<shared_buffer_ptr_t> released;
+  size_t releasedSize = 0;
+  {
+    threads::MutexGuard g(m_mutex);
+    releasedSize += m_sharedCache.m_size;
+    m_sharedCache.Clear(released);
+  }
+
+  size_t const count = m_threadsCount.load(memory_order_acquire);
+  for (size_t i = 0; i < count; ++i)
+  {
+    threads::MutexGuard g(m_threads[i]->m_mutex);
+    releasedSize += m_threads[i]->m_cache.m_size;
+    m_threads[i]->m_cache.Clear(released);
+  }
+  m_cachedSize.fetch_sub(releasedSize, memory_order_relaxed);
+}
+
+void SharedBufferManager::SetMaxCachedSize(size_t size)
+{
+  m_maxCachedSize.store(size, memory_order_relaxed);
+  if (m_cachedSize.load(memory_order_relaxed) > size)
+    ReleaseCached();
+}
+
+SharedBufferManager::Stats SharedBufferManager::GetStats()
+{
+  Stats stats;
+  stats.m_reserved = m_uncachedReserved.load(memory_order_relaxed);
+  stats.m_dropped = m_dropped.load(memory_order_relaxed);
+  {
+    threads::MutexGuard g(m_mutex);
+    stats.m_cachedSize += m_sharedCache.m_size;
+    stats.m_cachedCount += m_sharedCache.m_count;
+  }
+
+  size_t const count = m_threadsCount.load(memory_order_acquire);
+  for (size_t i = 0; i < count; ++i)
+  {
+    ThreadCache const & tc = *m_threads[i];
+    threads::MutexGuard g(m_threads[i]->m_mutex);
+    stats.m_reserved += tc.m_reserved;
+    stats.m_threadHits += tc.m_threadHits;
+    stats.m_sharedHits += tc.m_sharedHits;
+    stats.m_cachedSize += tc.m_cache.m_size;
+    stats.m_cachedCount += tc.m_cache.m_count;
+  }
+  return stats;
+}
+
+string DebugPrint(SharedBufferManager::Stats const & stats)
+{
+  ostringstream out;
+  out << "SharedBufferManager::Stats [ reserved: " << stats.m_reserved
+      << ", thread hits: " << stats.m_threadHits << ", shared hits: " << stats.m_sharedHits
+      << ", dropped: " << stats.m_dropped << ", cached: " << stats.m_cachedCount << " buffers, "
+      << stats.m_cachedSize << " bytes ]";
+  return out.str();
+}
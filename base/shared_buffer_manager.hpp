@@ -1,28 +1,111 @@
 #pragma once
 
 #include "base/mutex.hpp"
+#include "std/atomic.hpp"
+#include "std/cstdint.hpp"
+#include "std/thread.hpp"
 #include "std/vector.hpp"
 #include "std/shared_ptr.hpp"
-#include "std/list.hpp"
-#include "std/map.hpp"
+#include "std/string.hpp"
 
+/// Cache of the buffers for glyph images and graphics buffers. Buffers are kept in power of two
+/// size classes, first in the cache of the freeing thread, which is used without contention,
+/// then in the shared cache. The total size of the cached buffers is bounded, the buffers above
+/// it are freed at once.
 class SharedBufferManager
 {
 public:
   typedef vector<uint8_t> shared_buffer_t;
   typedef shared_ptr<shared_buffer_t> shared_buffer_ptr_t;
-  typedef list<shared_buffer_ptr_t> shared_buffer_ptr_list_t;
-  typedef map<size_t, shared_buffer_ptr_list_t> shared_buffers_t;
+
+  /// Buffers above it aren't cached.
+  static size_t const kMaxCachedBufferSize = 4 * 1024 * 1024;
+  /// Size of the buffers cached by each thread.
+  static size_t const kThreadCacheSize = 1024 * 1024;
+  static size_t const kDefaultMaxCachedSize = 16 * 1024 * 1024;
+
+  struct Stats
+  {
+    Stats();
+
+    uint64_t m_reserved;
+    /// Buffers taken from the cache of the reserving thread and from the shared cache.
+    uint64_t m_threadHits;
+    uint64_t m_sharedHits;
+    /// Buffers freed because of the total size limit.
+    uint64_t m_dropped;
+    /// Size and count of the cached buffers.
+    size_t m_cachedSize;
+    size_t m_cachedCount;
+  };
+
 private:
+  static size_t const kMinClassBits = 6;
+  static size_t const kClassesCount = 17;
+  static size_t const kMaxThreadsCount = 64;
+
+  typedef vector<shared_buffer_ptr_t> shared_buffer_ptr_list_t;
+
+  struct Cache
+  {
+    Cache();
+
+    /// @return Nullptr when there is no buffer of the class.
+    shared_buffer_ptr_t Pop(size_t sizeClass);
+    void Push(size_t sizeClass, shared_buffer_ptr_t && buf);
+    void Clear(vector<shared_buffer_ptr_t> & released);
+
+    shared_buffer_ptr_list_t m_buffers[kClassesCount];
+    size_t m_size;
+    size_t m_count;
+  };
+
+  struct ThreadCache
+  {
+    explicit ThreadCache(thread::id id) : m_id(id), m_reserved(0), m_threadHits(0), m_sharedHits(0) {}
+
+    thread::id const m_id;
+    // It's locked by its thread and by the statistics and the releasing, so it's not contended.
+    threads::Mutex m_mutex;
+    Cache m_cache;
+    uint64_t m_reserved;
+    uint64_t m_threadHits;
+    uint64_t m_sharedHits;
+  };
+
+  /// @return Nullptr when there are too many threads.
+  ThreadCache * GetThreadCache();
 
   threads::Mutex m_mutex;
-  shared_buffers_t m_sharedBuffers;
+  Cache m_sharedCache;
+
+  // Caches are added under m_mutex and never removed, so the threads look for theirs without it.
+  ThreadCache * m_threads[kMaxThreadsCount];
+  atomic<size_t> m_threadsCount;
+
+  atomic<size_t> m_cachedSize;
+  atomic<size_t> m_maxCachedSize;
+  atomic<uint64_t> m_dropped;
+  // Reserves of the threads which have no cache.
+  atomic<uint64_t> m_uncachedReserved;
+
+  SharedBufferManager();
 
 public:
   static SharedBufferManager & instance();
 
+  /// @return Buffer of size s, its content is undefined.
   shared_buffer_ptr_t reserveSharedBuffer(size_t s);
   void freeSharedBuffer(size_t s, shared_buffer_ptr_t buf);
 
   static uint8_t * GetRawPointer(shared_buffer_ptr_t ptr);
+
+  /// Frees all the cached buffers, e.g. on the memory warning.
+  void ReleaseCached();
+  /// Frees all the cached buffers when they are above the new limit.
+  void SetMaxCachedSize(size_t size);
+
+  Stats GetStats();
 };
+
+string DebugPrint(SharedBufferManager::Stats const & stats);
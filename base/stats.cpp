@@ -0,0 +1,36 @@
+#include "base/stats.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/target_os.hpp"
+
+#ifndef OMIM_OS_WINDOWS
+#include <sys/resource.h>
+#endif
+
+namespace my
+{
+double GetPercentile(vector<double> const & sorted, double p)
+{
+  ASSERT(!sorted.empty(), ());
+  return sorted[min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+
+uint64_t GetPeakRssBytes()
+{
+#ifdef OMIM_OS_WINDOWS
+  return 0;
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef OMIM_OS_MAC
+  // ru_maxrss is in bytes on Mac OS X and in kilobytes on Linux.
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+}  // namespace my
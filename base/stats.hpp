@@ -1,8 +1,10 @@
 #pragma once
 #include "base/base.hpp"
 
+#include "std/cstdint.hpp"
 #include "std/sstream.hpp"
 #include "std/string.hpp"
+#include "std/vector.hpp"
 
 
 namespace my
@@ -51,4 +53,10 @@ private:
   double m_Sum;
 };
 
+/// @return Value of the p-quantile (0 <= p <= 1) of the sorted not empty samples.
+double GetPercentile(vector<double> const & sorted, double p);
+
+/// @return Peak resident set size of the process or zero if it's not supported.
+uint64_t GetPeakRssBytes();
+
 }
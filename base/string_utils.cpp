@@ -4,6 +4,7 @@
 #include "std/target_os.hpp"
 #include "std/iterator.hpp"
 #include "std/cmath.hpp"
+#include "std/cstring.hpp"
 #include "std/iomanip.hpp"
 
 #include <boost/algorithm/string.hpp> // boost::trim
@@ -19,13 +20,20 @@ bool UniString::IsEqualAscii(char const * s) const
 
 SimpleDelimiter::SimpleDelimiter(char const * delimChars)
 {
+  m_ascii[0] = m_ascii[1] = 0;
   string const s(delimChars);
   string::const_iterator it = s.begin();
   while (it != s.end())
-    m_delims.push_back(utf8::unchecked::next(it));
+  {
+    UniChar const c = utf8::unchecked::next(it);
+    if (c < 0x80)
+      m_ascii[c >> 6] |= uint64_t(1) << (c & 0x3F);
+    else
+      m_delims.push_back(c);
+  }
 }
 
-bool SimpleDelimiter::operator()(UniChar c) const
+bool SimpleDelimiter::IsOtherDelimiter(UniChar c) const
 {
   for (UniString::const_iterator it = m_delims.begin(); it != m_delims.end(); ++it)
     if (*it == c)
@@ -146,10 +154,33 @@ bool EqualNoCase(string const & s1, string const & s2)
 UniString MakeUniString(string const & utf8s)
 {
   UniString result;
-  utf8::unchecked::utf8to32(utf8s.begin(), utf8s.end(), back_inserter(result));
+  MakeUniString(utf8s, result);
   return result;
 }
 
+void MakeUniString(string const & utf8s, UniString & result)
+{
+  // There are no more chars than bytes, so the result is written in place and is cut then.
+  result.resize_no_init(utf8s.size());
+  UniChar * out = result.data();
+
+  char const * it = utf8s.data();
+  char const * const end = it + utf8s.size();
+  while (it != end)
+  {
+    size_t const ascii = GetASCIIPrefixSize(it, end - it);
+    for (size_t i = 0; i < ascii; ++i)
+      *out++ = static_cast<unsigned char>(it[i]);
+    it += ascii;
+
+    // Multibyte chars are usually followed by the others in the non-latin text.
+    while (it != end && static_cast<unsigned char>(*it) >= 0x80)
+      *out++ = utf8::unchecked::next(it);
+  }
+
+  result.resize_no_init(out - result.data());
+}
+
 string ToUtf8(UniString const & s)
 {
   string result;
@@ -159,10 +190,24 @@ string ToUtf8(UniString const & s)
 
 bool IsASCIIString(string const & str)
 {
-  for (size_t i = 0; i < str.size(); ++i)
-    if (str[i] & 0x80)
-      return false;
-  return true;
+  return GetASCIIPrefixSize(str.data(), str.size()) == str.size();
+}
+
+size_t GetASCIIPrefixSize(char const * s, size_t size)
+{
+  uint64_t const kHighBits = 0x8080808080808080ULL;
+
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+  {
+    uint64_t word;
+    memcpy(&word, s + i, sizeof(word));
+    if (word & kHighBits)
+      break;
+  }
+  while (i < size && !(s[i] & 0x80))
+    ++i;
+  return i;
 }
 
 bool StartsWith(string const & s1, char const * s2)
@@ -55,8 +55,13 @@ string MakeLowerCase(string const & s);
 bool EqualNoCase(string const & s1, string const & s2);
 
 UniString MakeUniString(string const & utf8s);
+/// Decodes to the buffer, so one buffer may be reused for the many strings.
+/// The runs of ASCII chars are decoded by 8 chars at once.
+void MakeUniString(string const & utf8s, UniString & result);
 string ToUtf8(UniString const & s);
 bool IsASCIIString(string const & str);
+/// @return Length of the prefix of ASCII chars of the string [s, s + size).
+size_t GetASCIIPrefixSize(char const * s, size_t size);
 
 inline string DebugPrint(UniString const & s)
 {
@@ -139,25 +144,58 @@ public:
 
 class SimpleDelimiter
 {
+  /// Bitmap of the ASCII delimiters, the other ones are in m_delims.
+  uint64_t m_ascii[2];
   UniString m_delims;
 public:
   SimpleDelimiter(char const * delimChars);
   /// @return true if c is delimiter
-  bool operator()(UniChar c) const;
+  inline bool operator()(UniChar c) const
+  {
+    if (c < 0x80)
+      return (m_ascii[c >> 6] >> (c & 0x3F)) & 1;
+    return IsOtherDelimiter(c);
+  }
+
+private:
+  bool IsOtherDelimiter(UniChar c) const;
 };
 
 typedef TokenizeIterator<SimpleDelimiter,
                          ::utf8::unchecked::iterator<string::const_iterator> > SimpleTokenizer;
 
+/// Calls f for the tokens of str in one pass, ASCII chars are checked without decoding.
 template <typename FunctorT>
 void Tokenize(string const & str, char const * delims, FunctorT f)
 {
-  SimpleTokenizer iter(str, delims);
-  while (iter)
+  SimpleDelimiter const delimiter(delims);
+  char const * const begin = str.data();
+  char const * const end = begin + str.size();
+  char const * tokenBegin = nullptr;
+  for (char const * it = begin; it != end;)
   {
-    f(*iter);
-    ++iter;
+    char const * const charBegin = it;
+    UniChar c = static_cast<unsigned char>(*it);
+    if (c < 0x80)
+      ++it;
+    else
+      c = ::utf8::unchecked::next(it);
+
+    if (delimiter(c))
+    {
+      if (tokenBegin)
+      {
+        f(string(tokenBegin, charBegin));
+        tokenBegin = nullptr;
+      }
+    }
+    else if (!tokenBegin)
+    {
+      tokenBegin = charBegin;
+    }
   }
+  if (tokenBegin)
+    f(string(tokenBegin, end));
 }
 
 /// @return code of last symbol in string or 0 if s is empty
@@ -0,0 +1,232 @@
+#include "base/task_scheduler.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+namespace threads
+{
+namespace
+{
+// Tasks per worker when the grain size isn't set, a few of them balance the uneven chunks.
+size_t const kChunksPerWorker = 4;
+}  // namespace
+
+TaskScheduler::TaskScheduler(size_t threadsCount)
+  : m_queuedCount(0), m_nextWorker(0), m_stopped(false)
+{
+  if (threadsCount == 0)
+    threadsCount = max(thread::hardware_concurrency(), 1u);
+
+  m_workers.reserve(threadsCount);
+  for (size_t i = 0; i < threadsCount; ++i)
+    m_workers.emplace_back(new Worker());
+
+  // Workers lock m_mutex before they run any task, so the tasks see all the ids.
+  lock_guard<mutex> lock(m_mutex);
+  for (size_t i = 0; i < threadsCount; ++i)
+  {
+    Worker & worker = *m_workers[i];
+    worker.m_thread = thread(&TaskScheduler::Run, this, i);
+    worker.m_id = worker.m_thread.get_id();
+  }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+  m_cv.notify_all();
+
+  for (auto & worker : m_workers)
+    worker->m_thread.join();
+  ASSERT_EQUAL(m_queuedCount, 0, ());
+}
+
+// static
+TaskScheduler & TaskScheduler::Instance()
+{
+  static TaskScheduler scheduler;
+  return scheduler;
+}
+
+void TaskScheduler::Submit(TTask && task)
+{
+  size_t index = GetWorkerIndex();
+  if (index == m_workers.size())
+  {
+    lock_guard<mutex> lock(m_mutex);
+    index = m_nextWorker;
+    m_nextWorker = (m_nextWorker + 1) % m_workers.size();
+  }
+
+  // The worker mutex is always locked before m_mutex.
+  Worker & worker = *m_workers[index];
+  lock_guard<mutex> workerLock(worker.m_mutex);
+  worker.m_tasks.push_back(move(task));
+
+  lock_guard<mutex> lock(m_mutex);
+  ++m_queuedCount;
+  m_cv.notify_one();
+}
+
+bool TaskScheduler::RunPendingTask()
+{
+  TTask task;
+  if (!PopTask(GetWorkerIndex(), task))
+    return false;
+  RunTask(task);
+  return true;
+}
+
+void TaskScheduler::Run(size_t index)
+{
+  while (true)
+  {
+    {
+      unique_lock<mutex> lock(m_mutex);
+      m_cv.wait(lock, [this]() { return m_queuedCount != 0 || m_stopped; });
+      // Queues are drained before the stop.
+      if (m_queuedCount == 0)
+        return;
+    }
+
+    TTask task;
+    if (PopTask(index, task))
+      RunTask(task);
+  }
+}
+
+size_t TaskScheduler::GetWorkerIndex() const
+{
+  thread::id const id = this_thread::get_id();
+  for (size_t i = 0; i < m_workers.size(); ++i)
+  {
+    if (m_workers[i]->m_id == id)
+      return i;
+  }
+  return m_workers.size();
+}
+
+bool TaskScheduler::PopTask(size_t index, TTask & task)
+{
+  size_t const count = m_workers.size();
+  for (size_t i = 0; i < count; ++i)
+  {
+    // The own queue goes first and is used as a stack, the others' queues are robbed from the
+    // front, where the oldest and usually the biggest tasks are.
+    bool const isOwn = index < count && i == 0;
+    Worker & worker = *m_workers[(index + i) % count];
+
+    lock_guard<mutex> workerLock(worker.m_mutex);
+    if (worker.m_tasks.empty())
+      continue;
+    if (isOwn)
+    {
+      task = move(worker.m_tasks.back());
+      worker.m_tasks.pop_back();
+    }
+    else
+    {
+      task = move(worker.m_tasks.front());
+      worker.m_tasks.pop_front();
+    }
+
+    lock_guard<mutex> lock(m_mutex);
+    --m_queuedCount;
+    return true;
+  }
+  return false;
+}
+
+// static
+void TaskScheduler::RunTask(TTask & task)
+{
+  try
+  {
+    task();
+  }
+  catch (exception const & e)
+  {
+    LOG(LERROR, ("Task failed:", e.what()));
+  }
+  catch (...)
+  {
+    LOG(LERROR, ("Task failed by an unknown exception."));
+  }
+}
+
+TaskGroup::TaskGroup(TaskScheduler & scheduler, my::Cancellable const * parent)
+  : m_scheduler(scheduler), m_parent(parent), m_pendingCount(0)
+{
+}
+
+TaskGroup::~TaskGroup() { WaitImpl(); }
+
+void TaskGroup::Run(TaskScheduler::TTask && task)
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    ++m_pendingCount;
+  }
+
+  m_scheduler.Submit([this, task]()
+  {
+    exception_ptr error;
+    if (!IsCancelled())
+    {
+      try
+      {
+        task();
+      }
+      catch (...)
+      {
+        error = current_exception();
+      }
+    }
+
+    if (error)
+      Cancel();
+
+    // Notify under the lock: the group may be destroyed right after the waiter wakes up.
+    lock_guard<mutex> lock(m_mutex);
+    if (error && !m_error)
+      m_error = error;
+    if (--m_pendingCount == 0)
+      m_cv.notify_all();
+  });
+}
+
+void TaskGroup::Wait()
+{
+  WaitImpl();
+
+  exception_ptr error;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    error = m_error;
+    m_error = nullptr;
+  }
+  if (error)
+    rethrow_exception(error);
+}
+
+bool TaskGroup::IsCancelled() const
+{
+  return my::Cancellable::IsCancelled() || (m_parent != nullptr && m_parent->IsCancelled());
+}
+
+void TaskGroup::WaitImpl()
+{
+  impl::HelpUntil(m_scheduler, m_mutex, m_cv, [this]() { return m_pendingCount == 0; });
+}
+
+size_t GetChunkSize(size_t count, size_t grainSize, TaskScheduler const & scheduler)
+{
+  if (grainSize != 0)
+    return grainSize;
+  size_t const chunksCount = scheduler.GetThreadsCount() * kChunksPerWorker;
+  return max(static_cast<size_t>(1), (count + chunksCount - 1) / chunksCount);
+}
+}  // namespace threads
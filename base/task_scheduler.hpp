@@ -0,0 +1,349 @@
+#pragma once
+
+#include "base/cancellable.hpp"
+#include "base/macros.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/chrono.hpp"
+#include "std/condition_variable.hpp"
+#include "std/deque.hpp"
+#include "std/exception.hpp"
+#include "std/function.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/thread.hpp"
+#include "std/type_traits.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace threads
+{
+template <typename T>
+class Future;
+
+/// Work-stealing scheduler of short CPU tasks, e.g. of the parallel parts of search, routing and
+/// the generator. Each worker has its own queue, tasks which are submitted by a worker go to its
+/// queue and are run first (LIFO), the idle workers steal the oldest tasks from the other queues.
+/// Threads which wait for Future or TaskGroup run the queued tasks meanwhile, so the tasks may
+/// wait for their subtasks without exhausting the workers.
+/// Tasks must not block for I/O for long, use the dedicated threads for it.
+class TaskScheduler
+{
+public:
+  using TTask = function<void()>;
+
+  /// @param threadsCount Number of worker threads, zero means the number of cores.
+  explicit TaskScheduler(size_t threadsCount = 0);
+
+  /// Runs the submitted tasks and stops the workers.
+  ~TaskScheduler();
+
+  /// Scheduler shared by the app, it has a worker per core.
+  static TaskScheduler & Instance();
+
+  /// Exceptions of the task are logged and swallowed, use Async() or TaskGroup to get them.
+  void Submit(TTask && task);
+
+  /// @return Future of the result of f().
+  template <typename F>
+  auto Async(F && f) -> Future<decltype(f())>;
+
+  /// Runs one of the queued tasks on the calling thread.
+  /// @return False when there are no queued tasks.
+  bool RunPendingTask();
+
+  inline size_t GetThreadsCount() const { return m_workers.size(); }
+
+private:
+  struct Worker
+  {
+    mutex m_mutex;
+    deque<TTask> m_tasks;
+    thread m_thread;
+    thread::id m_id;
+  };
+
+  void Run(size_t index);
+  /// @return Index of the worker of the calling thread or the number of the workers.
+  size_t GetWorkerIndex() const;
+  bool PopTask(size_t index, TTask & task);
+  static void RunTask(TTask & task);
+
+  vector<unique_ptr<Worker>> m_workers;
+
+  mutex m_mutex;
+  condition_variable m_cv;
+  // Number of the tasks in the queues.
+  size_t m_queuedCount;
+  size_t m_nextWorker;
+  bool m_stopped;
+
+  DISALLOW_COPY_AND_MOVE(TaskScheduler);
+};
+
+namespace impl
+{
+template <typename T>
+struct FutureValue
+{
+  using TResult = T const &;
+
+  template <typename F>
+  void Set(F & f)
+  {
+    m_value.reset(new T(f()));
+  }
+  TResult Get() const { return *m_value; }
+
+  unique_ptr<T> m_value;
+};
+
+template <>
+struct FutureValue<void>
+{
+  using TResult = void;
+
+  template <typename F>
+  void Set(F & f)
+  {
+    f();
+  }
+  TResult Get() const {}
+};
+
+/// It's waited with the help to the scheduler, so the waiting thread runs the queued tasks.
+template <typename TIsDone>
+void HelpUntil(TaskScheduler & scheduler, mutex & m, condition_variable & cv, TIsDone && isDone)
+{
+  while (true)
+  {
+    {
+      lock_guard<mutex> lock(m);
+      if (isDone())
+        return;
+    }
+    if (scheduler.RunPendingTask())
+      continue;
+
+    // Nothing to help with, the last tasks are running on the workers.
+    unique_lock<mutex> lock(m);
+    cv.wait_for(lock, milliseconds(1), isDone);
+  }
+}
+}  // namespace impl
+
+/// Result of a task of TaskScheduler. Copies of the future share the result.
+template <typename T>
+class Future
+{
+public:
+  using TResult = typename impl::FutureValue<T>::TResult;
+
+  Future() = default;
+
+  bool IsValid() const { return m_state != nullptr; }
+
+  bool IsReady() const
+  {
+    lock_guard<mutex> lock(m_state->m_mutex);
+    return m_state->m_isReady;
+  }
+
+  /// Waits for the result, the calling thread runs the queued tasks meanwhile.
+  void Wait() const
+  {
+    State & state = *m_state;
+    impl::HelpUntil(state.m_scheduler, state.m_mutex, state.m_cv,
+                    [&state]() { return state.m_isReady; });
+  }
+
+  /// Waits for the result and rethrows the exception of the task.
+  TResult Get() const
+  {
+    Wait();
+    if (m_state->m_error)
+      rethrow_exception(m_state->m_error);
+    return m_state->m_value.Get();
+  }
+
+  /// @return Future of f(*this), f is run on the scheduler when the result is ready.
+  template <typename F>
+  auto Then(F && f) -> Future<decltype(f(declval<Future<T>>()))>
+  {
+    using TNext = decltype(f(declval<Future<T>>()));
+    Future<TNext> next(m_state->m_scheduler);
+    auto nextState = next.m_state;
+    Future<T> self = *this;
+    typename decay<F>::type fn(forward<F>(f));
+    AddContinuation([nextState, self, fn]() mutable
+    {
+      nextState->Run([&]() { return fn(self); });
+    });
+    return next;
+  }
+
+private:
+  friend class TaskScheduler;
+  template <typename U>
+  friend class Future;
+
+  struct State
+  {
+    explicit State(TaskScheduler & scheduler) : m_scheduler(scheduler) {}
+
+    template <typename F>
+    void Run(F && f)
+    {
+      try
+      {
+        m_value.Set(f);
+      }
+      catch (...)
+      {
+        m_error = current_exception();
+      }
+
+      vector<TaskScheduler::TTask> continuations;
+      {
+        // Notify under the lock: the waiter may destroy the state right after it wakes up.
+        lock_guard<mutex> lock(m_mutex);
+        m_isReady = true;
+        continuations.swap(m_continuations);
+        m_cv.notify_all();
+      }
+      for (auto & continuation : continuations)
+        m_scheduler.Submit(move(continuation));
+    }
+
+    TaskScheduler & m_scheduler;
+    mutex m_mutex;
+    condition_variable m_cv;
+    bool m_isReady = false;
+    exception_ptr m_error;
+    impl::FutureValue<T> m_value;
+    vector<TaskScheduler::TTask> m_continuations;
+  };
+
+  explicit Future(TaskScheduler & scheduler) : m_state(make_shared<State>(scheduler)) {}
+
+  void AddContinuation(TaskScheduler::TTask && task)
+  {
+    {
+      lock_guard<mutex> lock(m_state->m_mutex);
+      if (!m_state->m_isReady)
+      {
+        m_state->m_continuations.push_back(move(task));
+        return;
+      }
+    }
+    m_state->m_scheduler.Submit(move(task));
+  }
+
+  shared_ptr<State> m_state;
+};
+
+template <typename F>
+auto TaskScheduler::Async(F && f) -> Future<decltype(f())>
+{
+  using TResult = decltype(f());
+  Future<TResult> future(*this);
+  auto state = future.m_state;
+  typename decay<F>::type fn(forward<F>(f));
+  Submit([state, fn]() mutable { state->Run(fn); });
+  return future;
+}
+
+/// Tasks which are waited together. The group is cancelled by Cancel(), by the first exception
+/// of its tasks or when the parent is cancelled, then the tasks which aren't started yet are
+/// skipped and the running ones may check IsCancelled().
+class TaskGroup : public my::Cancellable
+{
+public:
+  explicit TaskGroup(TaskScheduler & scheduler = TaskScheduler::Instance(),
+                     my::Cancellable const * parent = nullptr);
+
+  /// Waits for the tasks, their exceptions are dropped.
+  ~TaskGroup();
+
+  void Run(TaskScheduler::TTask && task);
+
+  /// Waits for all the tasks, the calling thread runs the queued tasks meanwhile.
+  /// Rethrows the first exception of the tasks.
+  void Wait();
+
+  // my::Cancellable overrides:
+  bool IsCancelled() const override;
+
+  inline TaskScheduler & GetScheduler() const { return m_scheduler; }
+
+private:
+  void WaitImpl();
+
+  TaskScheduler & m_scheduler;
+  my::Cancellable const * m_parent;
+
+  mutex m_mutex;
+  condition_variable m_cv;
+  size_t m_pendingCount;
+  exception_ptr m_error;
+
+  DISALLOW_COPY_AND_MOVE(TaskGroup);
+};
+
+/// @param grainSize Number of the indices which are processed by one task,
+///                  zero means the range is split into a few tasks per worker.
+/// @return Number of the indices of [0, count) in each chunk.
+size_t GetChunkSize(size_t count, size_t grainSize, TaskScheduler const & scheduler);
+
+/// Calls f(i) for each i from [begin, end) in parallel, exceptions are rethrown.
+template <typename F>
+void ParallelFor(size_t begin, size_t end, F && f, size_t grainSize = 0,
+                 TaskScheduler & scheduler = TaskScheduler::Instance())
+{
+  if (begin >= end)
+    return;
+
+  size_t const chunkSize = GetChunkSize(end - begin, grainSize, scheduler);
+  TaskGroup group(scheduler);
+  for (size_t b = begin; b < end; b += chunkSize)
+  {
+    size_t const e = min(end, b + chunkSize);
+    group.Run([&f, &group, b, e]()
+    {
+      for (size_t i = b; i < e && !group.IsCancelled(); ++i)
+        f(i);
+    });
+  }
+  group.Wait();
+}
+
+/// Reduces [begin, end) by map(b, e), which returns the value of [b, e), and combine(lhs, rhs).
+/// Chunks are combined in their order, so combine only needs to be associative.
+template <typename T, typename TMap, typename TCombine>
+T ParallelReduce(size_t begin, size_t end, T const & identity, TMap && map, TCombine && combine,
+                 size_t grainSize = 0, TaskScheduler & scheduler = TaskScheduler::Instance())
+{
+  if (begin >= end)
+    return identity;
+
+  size_t const chunkSize = GetChunkSize(end - begin, grainSize, scheduler);
+  vector<T> values((end - begin + chunkSize - 1) / chunkSize, identity);
+  {
+    TaskGroup group(scheduler);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      size_t const b = begin + i * chunkSize;
+      size_t const e = min(end, b + chunkSize);
+      T & value = values[i];
+      group.Run([&map, &value, b, e]() { value = map(b, e); });
+    }
+    group.Wait();
+  }
+
+  T result = identity;
+  for (T const & value : values)
+    result = combine(result, value);
+  return result;
+}
+}  // namespace threads
@@ -0,0 +1,178 @@
+#include "base/tracing.hpp"
+
+#include "std/chrono.hpp"
+#include "std/fstream.hpp"
+#include "std/mutex.hpp"
+#include "std/thread.hpp"
+#include "std/vector.hpp"
+
+namespace my
+{
+namespace tracing
+{
+namespace
+{
+/// Threads above it aren't traced.
+size_t const kMaxThreadsCount = 256;
+
+struct Event
+{
+  char const * m_category;
+  char const * m_name;
+  uint64_t m_begin;
+  uint64_t m_end;
+};
+
+struct ThreadEvents
+{
+  ThreadEvents(thread::id id, uint32_t tid) : m_id(id), m_tid(tid), m_next(0), m_isFull(false) {}
+
+  thread::id const m_id;
+  uint32_t const m_tid;
+
+  // It's locked by the thread for each event and by the dump, so it's almost never contended.
+  mutex m_mutex;
+  string m_name;
+  vector<Event> m_events;
+  size_t m_next;
+  bool m_isFull;
+};
+
+steady_clock::time_point const g_startTime = steady_clock::now();
+
+// Buffers of the threads, they are added under g_threadsMutex and never removed, so the threads
+// look for their buffers without the lock.
+mutex g_threadsMutex;
+ThreadEvents * g_threads[kMaxThreadsCount];
+atomic<size_t> g_threadsCount(0);
+
+ThreadEvents * GetThreadEvents()
+{
+  thread::id const id = this_thread::get_id();
+  size_t const count = g_threadsCount.load(memory_order_acquire);
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (g_threads[i]->m_id == id)
+      return g_threads[i];
+  }
+
+  lock_guard<mutex> lock(g_threadsMutex);
+  size_t const i = g_threadsCount.load(memory_order_relaxed);
+  if (i == kMaxThreadsCount)
+    return nullptr;
+  g_threads[i] = new ThreadEvents(id, static_cast<uint32_t>(i + 1));
+  g_threadsCount.store(i + 1, memory_order_release);
+  return g_threads[i];
+}
+
+void WriteJsonString(ostream & out, char const * s)
+{
+  out << '"';
+  for (; *s; ++s)
+  {
+    if (*s == '"' || *s == '\\')
+      out << '\\';
+    out << *s;
+  }
+  out << '"';
+}
+}  // namespace
+
+atomic<bool> g_isStarted(false);
+
+void Start()
+{
+  size_t const count = g_threadsCount.load(memory_order_acquire);
+  for (size_t i = 0; i < count; ++i)
+  {
+    lock_guard<mutex> lock(g_threads[i]->m_mutex);
+    g_threads[i]->m_next = 0;
+    g_threads[i]->m_isFull = false;
+  }
+  g_isStarted.store(true, memory_order_relaxed);
+}
+
+void Stop() { g_isStarted.store(false, memory_order_relaxed); }
+
+void SetThreadName(string const & name)
+{
+  ThreadEvents * events = GetThreadEvents();
+  if (events == nullptr)
+    return;
+  lock_guard<mutex> lock(events->m_mutex);
+  events->m_name = name;
+}
+
+void WriteChromeTrace(ostream & out)
+{
+  out << "{\"traceEvents\":[";
+  bool isFirst = true;
+  auto const separate = [&]()
+  {
+    if (!isFirst)
+      out << ",\n";
+    isFirst = false;
+  };
+
+  size_t const count = g_threadsCount.load(memory_order_acquire);
+  for (size_t i = 0; i < count; ++i)
+  {
+    ThreadEvents & events = *g_threads[i];
+    lock_guard<mutex> lock(events.m_mutex);
+    if (!events.m_name.empty())
+    {
+      separate();
+      out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << events.m_tid
+          << ",\"args\":{\"name\":";
+      WriteJsonString(out, events.m_name.c_str());
+      out << "}}";
+    }
+
+    // The oldest event is the next one to overwrite when the ring is full.
+    size_t const size = events.m_isFull ? events.m_events.size() : events.m_next;
+    size_t const first = events.m_isFull ? events.m_next : 0;
+    for (size_t j = 0; j < size; ++j)
+    {
+      Event const & e = events.m_events[(first + j) % events.m_events.size()];
+      separate();
+      out << "{\"name\":";
+      WriteJsonString(out, e.m_name);
+      out << ",\"cat\":";
+      WriteJsonString(out, e.m_category);
+      out << ",\"ph\":\"X\",\"ts\":" << e.m_begin << ",\"dur\":" << e.m_end - e.m_begin
+          << ",\"pid\":1,\"tid\":" << events.m_tid << "}";
+    }
+  }
+  out << "]}\n";
+}
+
+bool WriteChromeTrace(string const & path)
+{
+  ofstream out(path);
+  WriteChromeTrace(out);
+  return static_cast<bool>(out);
+}
+
+uint64_t Now()
+{
+  return duration_cast<microseconds>(steady_clock::now() - g_startTime).count();
+}
+
+void AddEvent(char const * category, char const * name, uint64_t begin, uint64_t end)
+{
+  ThreadEvents * events = GetThreadEvents();
+  if (events == nullptr)
+    return;
+
+  lock_guard<mutex> lock(events->m_mutex);
+  if (events->m_events.empty())
+    events->m_events.resize(kThreadEventsCount);
+  events->m_events[events->m_next] = {category, name, begin, end};
+  if (++events->m_next == events->m_events.size())
+  {
+    events->m_next = 0;
+    events->m_isFull = true;
+  }
+}
+}  // namespace tracing
+}  // namespace my
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "std/atomic.hpp"
+#include "std/cstdint.hpp"
+#include "std/iostream.hpp"
+#include "std/string.hpp"
+
+/// Scoped tracing of the work of the threads, it shows how search, rendering, routing and storage
+/// tasks interleave. Each thread records its events to its own ring buffer while tracing is
+/// started, the events are dumped to the Chrome trace event JSON, which is opened by
+/// chrome://tracing. When tracing isn't started, the cost of a scope is a relaxed atomic load.
+///
+/// Usage: TRACE_SCOPE("search", "Query::Search");
+/// Category and name must be string literals, they are stored as pointers.
+/// OMIM_DISABLE_TRACING removes the scopes from the code, production builds define it.
+namespace my
+{
+namespace tracing
+{
+/// Events which are kept for each thread, the older ones are overwritten.
+size_t const kThreadEventsCount = 1 << 15;
+
+extern atomic<bool> g_isStarted;
+
+inline bool IsStarted() { return g_isStarted.load(memory_order_relaxed); }
+
+/// Clears the recorded events and starts the recording.
+void Start();
+void Stop();
+
+/// Names the current thread in the trace, e.g. "ReadMWM" or "Search".
+void SetThreadName(string const & name);
+
+/// Writes the recorded events of all the threads.
+void WriteChromeTrace(ostream & out);
+/// @return False when the file can't be written.
+bool WriteChromeTrace(string const & path);
+
+/// Microseconds since the first call.
+uint64_t Now();
+void AddEvent(char const * category, char const * name, uint64_t begin, uint64_t end);
+
+class ScopedEvent
+{
+public:
+  ScopedEvent(char const * category, char const * name)
+    : m_category(category), m_name(name), m_isStarted(IsStarted()), m_begin(m_isStarted ? Now() : 0)
+  {
+  }
+
+  ~ScopedEvent()
+  {
+    if (m_isStarted)
+      AddEvent(m_category, m_name, m_begin, Now());
+  }
+
+private:
+  char const * m_category;
+  char const * m_name;
+  bool const m_isStarted;
+  uint64_t const m_begin;
+};
+}  // namespace tracing
+}  // namespace my
+
+#if defined(OMIM_PRODUCTION) && !defined(OMIM_DISABLE_TRACING)
+#define OMIM_DISABLE_TRACING
+#endif
+
+#define TRACE_CONCAT_IMPL(x, y) x##y
+#define TRACE_CONCAT(x, y) TRACE_CONCAT_IMPL(x, y)
+
+#ifdef OMIM_DISABLE_TRACING
+#define TRACE_SCOPE(category, name) static_cast<void>(0)
+#else
+#define TRACE_SCOPE(category, name) \
+  ::my::tracing::ScopedEvent const TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+#endif
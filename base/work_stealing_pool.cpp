@@ -0,0 +1,120 @@
+#include "base/work_stealing_pool.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+
+namespace threads
+{
+WorkStealingPool::WorkStealingPool(size_t threadsCount, size_t maxPendingTasks)
+  : m_maxPendingTasks(max(maxPendingTasks, static_cast<size_t>(1)))
+{
+  if (threadsCount == 0)
+    threadsCount = max(thread::hardware_concurrency(), 1u);
+
+  m_workers.reserve(threadsCount);
+  for (size_t i = 0; i < threadsCount; ++i)
+    m_workers.emplace_back(new Worker());
+  // Threads are started after all the queues are created as they steal from each other.
+  for (size_t i = 0; i < threadsCount; ++i)
+    m_workers[i]->m_thread = thread(&WorkStealingPool::Run, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+  m_cv.notify_all();
+
+  for (auto & worker : m_workers)
+    worker->m_thread.join();
+}
+
+void WorkStealingPool::Push(TTask && task)
+{
+  size_t index;
+  {
+    unique_lock<mutex> lock(m_mutex);
+    ASSERT(!m_stopped, ());
+    m_cv.wait(lock, [this]() { return m_pendingCount < m_maxPendingTasks; });
+    ++m_pendingCount;
+    index = m_nextWorker;
+    m_nextWorker = (m_nextWorker + 1) % m_workers.size();
+  }
+
+  {
+    Worker & worker = *m_workers[index];
+    lock_guard<mutex> lock(worker.m_mutex);
+    worker.m_tasks.push_back(move(task));
+  }
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    ++m_queuedCount;
+  }
+  m_cv.notify_all();
+}
+
+void WorkStealingPool::WaitForDone()
+{
+  unique_lock<mutex> lock(m_mutex);
+  m_cv.wait(lock, [this]() { return m_pendingCount == 0; });
+}
+
+bool WorkStealingPool::PopTask(size_t index, TTask & task)
+{
+  size_t const count = m_workers.size();
+  for (size_t i = 0; i < count; ++i)
+  {
+    Worker & worker = *m_workers[(index + i) % count];
+    lock_guard<mutex> lock(worker.m_mutex);
+    if (worker.m_tasks.empty())
+      continue;
+
+    // The own queue is used as a stack to keep the recent data in the cache,
+    // the other queues are stolen from the front.
+    if (i == 0)
+    {
+      task = move(worker.m_tasks.back());
+      worker.m_tasks.pop_back();
+    }
+    else
+    {
+      task = move(worker.m_tasks.front());
+      worker.m_tasks.pop_front();
+    }
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingPool::Run(size_t index)
+{
+  while (true)
+  {
+    {
+      unique_lock<mutex> lock(m_mutex);
+      m_cv.wait(lock, [this]() { return m_queuedCount != 0 || m_stopped; });
+      if (m_queuedCount == 0)
+        return;
+      // The task is reserved by the counter, so it's in one of the queues
+      // or is being put there.
+      --m_queuedCount;
+    }
+
+    TTask task;
+    while (!PopTask(index, task))
+      this_thread::yield();
+
+    task();
+
+    {
+      lock_guard<mutex> lock(m_mutex);
+      --m_pendingCount;
+    }
+    m_cv.notify_all();
+  }
+}
+}  // namespace threads
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "base/macros.hpp"
+
+#include "std/condition_variable.hpp"
+#include "std/deque.hpp"
+#include "std/function.hpp"
+#include "std/mutex.hpp"
+#include "std/thread.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+namespace threads
+{
+/// WorkStealingPool runs tasks on a fixed number of threads. Each worker has its own queue,
+/// pushed tasks are spread over the queues, a worker takes tasks from the back of its queue
+/// and steals from the front of the other queues when its queue is empty.
+/// Push() blocks while the pool has maxPendingTasks queued or running tasks, so a fast producer
+/// doesn't accumulate an unbounded amount of work.
+class WorkStealingPool
+{
+public:
+  using TTask = function<void()>;
+
+  /// @param threadsCount Number of worker threads, zero means the number of cores.
+  WorkStealingPool(size_t threadsCount, size_t maxPendingTasks);
+
+  /// Waits for all the pushed tasks.
+  ~WorkStealingPool();
+
+  /// May be called from any thread but the workers, a task pushing tasks may block forever.
+  void Push(TTask && task);
+
+  /// Waits until all the pushed tasks are done.
+  void WaitForDone();
+
+  inline size_t GetThreadsCount() const { return m_workers.size(); }
+
+private:
+  struct Worker
+  {
+    mutex m_mutex;
+    deque<TTask> m_tasks;
+    thread m_thread;
+  };
+
+  void Run(size_t index);
+  bool PopTask(size_t index, TTask & task);
+
+  vector<unique_ptr<Worker>> m_workers;
+  size_t const m_maxPendingTasks;
+
+  mutex m_mutex;
+  condition_variable m_cv;
+  // Number of tasks in the queues.
+  size_t m_queuedCount = 0;
+  // Number of tasks in the queues and running ones.
+  size_t m_pendingCount = 0;
+  size_t m_nextWorker = 0;
+  bool m_stopped = false;
+
+  DISALLOW_COPY_AND_MOVE(WorkStealingPool);
+};
+}  // namespace threads
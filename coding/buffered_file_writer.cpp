@@ -0,0 +1,97 @@
+#include "coding/buffered_file_writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/algorithm.hpp"
+
+// static
+size_t constexpr BufferedFileWriter::kDefaultBufferSize;
+
+BufferedFileWriter::BufferedFileWriter(string const & fileName, FileWriter::Op op,
+                                       size_t bufferSize)
+  : m_file(fileName, op), m_bufferSize(bufferSize)
+{
+  ASSERT_GREATER(m_bufferSize, 0, ());
+  m_bufferPos = static_cast<uint64_t>(m_file.Pos());
+  m_size = m_file.Size();
+  m_buffer.reserve(m_bufferSize);
+}
+
+BufferedFileWriter::~BufferedFileWriter()
+{
+  try
+  {
+    Flush();
+  }
+  catch (Writer::Exception const & e)
+  {
+    LOG(LERROR, ("Can't write", GetName(), e.Msg()));
+  }
+}
+
+void BufferedFileWriter::Seek(int64_t pos)
+{
+  ASSERT_GREATER_OR_EQUAL(pos, 0, ());
+  WriteBuffer();
+  m_task.Wait();
+  m_file.Seek(pos);
+  m_bufferPos = static_cast<uint64_t>(pos);
+}
+
+int64_t BufferedFileWriter::Pos() const
+{
+  return static_cast<int64_t>(m_bufferPos + m_buffer.size());
+}
+
+void BufferedFileWriter::Write(void const * p, size_t size)
+{
+  char const * src = static_cast<char const *>(p);
+  while (size > 0)
+  {
+    size_t const part = min(size, m_bufferSize - m_buffer.size());
+    m_buffer.insert(m_buffer.end(), src, src + part);
+    src += part;
+    size -= part;
+
+    if (m_buffer.size() == m_bufferSize)
+      WriteBuffer();
+  }
+}
+
+uint64_t BufferedFileWriter::Size() const
+{
+  return max(m_size, static_cast<uint64_t>(Pos()));
+}
+
+void BufferedFileWriter::Flush()
+{
+  WriteBuffer();
+  m_task.Wait();
+  m_file.Flush();
+}
+
+void BufferedFileWriter::Preallocate(uint64_t size)
+{
+  m_task.Wait();
+  m_file.Preallocate(size);
+}
+
+void BufferedFileWriter::WriteBuffer()
+{
+  if (m_buffer.empty())
+    return;
+
+  // The previous buffer has to be written before the next one.
+  m_task.Wait();
+  m_writing.swap(m_buffer);
+  m_buffer.clear();
+  m_buffer.reserve(m_bufferSize);
+
+  m_bufferPos += m_writing.size();
+  m_size = max(m_size, m_bufferPos);
+  m_task.Start([this]()
+  {
+    m_file.Write(m_writing.data(), m_writing.size());
+  });
+}
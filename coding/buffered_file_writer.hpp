@@ -0,0 +1,58 @@
+#pragma once
+#include "coding/file_sort.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/writer.hpp"
+
+#include "base/macros.hpp"
+
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+/// Writer for the big output streams made of lots of small writes. The data is collected
+/// in a big buffer and the full buffer is written on a background thread while the next one
+/// is filled, so two buffers are in use at most. Seek() waits for all the data to be written.
+/// Not thread safe.
+class BufferedFileWriter : public Writer
+{
+public:
+  static size_t constexpr kDefaultBufferSize = 8 * 1024 * 1024;
+
+  explicit BufferedFileWriter(string const & fileName,
+                              FileWriter::Op op = FileWriter::OP_WRITE_TRUNCATE,
+                              size_t bufferSize = kDefaultBufferSize);
+  ~BufferedFileWriter() override;
+
+  // Writer overrides:
+  void Seek(int64_t pos) override;
+  int64_t Pos() const override;
+  void Write(void const * p, size_t size) override;
+
+  uint64_t Size() const;
+
+  /// Writes all the data to the file.
+  void Flush();
+
+  /// @see FileWriter::Preallocate.
+  void Preallocate(uint64_t size);
+
+  string const & GetName() const { return m_file.GetName(); }
+
+private:
+  /// Passes the filled buffer to the background thread.
+  void WriteBuffer();
+
+  FileWriter m_file;
+  size_t const m_bufferSize;
+
+  vector<char> m_buffer;
+  /// Buffer which is being written on the background thread.
+  vector<char> m_writing;
+  /// Position of the beginning of m_buffer in the file.
+  uint64_t m_bufferPos;
+  /// Size of the file when all the written buffers are in it.
+  uint64_t m_size;
+
+  file_sort::BackgroundTask m_task;
+
+  DISALLOW_COPY_AND_MOVE(BufferedFileWriter);
+};
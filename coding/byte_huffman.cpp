@@ -0,0 +1,182 @@
+#include "coding/byte_huffman.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/functional.hpp"
+#include "std/queue.hpp"
+#include "std/utility.hpp"
+
+namespace coding
+{
+namespace
+{
+/// Computes the Huffman code lengths of the symbols.
+/// @return The maximal code length.
+uint32_t CalcCodeLengths(ByteHuffmanCoder::TFrequencies const & freqs,
+                         array<uint8_t, ByteHuffmanCoder::kSymbolsCount> & lengths)
+{
+  size_t const count = ByteHuffmanCoder::kSymbolsCount;
+
+  // Leaves are [0, count), internal nodes go after them, so a parent's index is always
+  // greater than its children's ones.
+  vector<uint32_t> parents(2 * count - 1, 0);
+  using TNode = pair<uint64_t, uint32_t>;
+  priority_queue<TNode, vector<TNode>, greater<TNode>> nodes;
+  for (uint32_t i = 0; i < count; ++i)
+    nodes.emplace(freqs[i], i);
+
+  uint32_t next = static_cast<uint32_t>(count);
+  while (nodes.size() > 1)
+  {
+    TNode const lhs = nodes.top();
+    nodes.pop();
+    TNode const rhs = nodes.top();
+    nodes.pop();
+    parents[lhs.second] = parents[rhs.second] = next;
+    nodes.emplace(lhs.first + rhs.first, next++);
+  }
+
+  vector<uint32_t> depths(parents.size(), 0);
+  for (size_t i = parents.size() - 1; i > 0; --i)
+    depths[i - 1] = depths[parents[i - 1]] + 1;
+
+  uint32_t maxLength = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    lengths[i] = static_cast<uint8_t>(min(depths[i], 0xFFu));
+    maxLength = max(maxLength, depths[i]);
+  }
+  return maxLength;
+}
+}  // namespace
+
+// static
+uint32_t const ByteHuffmanCoder::kMaxCodeLength;
+// static
+size_t const ByteHuffmanCoder::kSymbolsCount;
+
+ByteHuffmanCoder::ByteHuffmanCoder()
+{
+  m_lengths.fill(0);
+  m_codes.fill(0);
+}
+
+// static
+void ByteHuffmanCoder::AddFrequencies(string const & s, TFrequencies & freqs)
+{
+  for (char const c : s)
+    ++freqs[static_cast<uint8_t>(c)];
+}
+
+void ByteHuffmanCoder::Build(TFrequencies const & freqs)
+{
+  TFrequencies weights;
+  for (size_t i = 0; i < kSymbolsCount; ++i)
+    weights[i] = max(freqs[i], static_cast<uint64_t>(1));
+
+  // Flattening of the weights shortens the longest codes, all the equal weights give 8 bits.
+  while (CalcCodeLengths(weights, m_lengths) > kMaxCodeLength)
+  {
+    for (uint64_t & w : weights)
+      w = (w >> 1) | 1;
+  }
+
+  VERIFY(BuildTable(), ());
+}
+
+bool ByteHuffmanCoder::BuildTable()
+{
+  m_table.clear();
+
+  // The code must be complete, so every kMaxCodeLength bits start with a code.
+  uint32_t kraftSum = 0;
+  for (uint8_t const length : m_lengths)
+  {
+    if (length == 0 || length > kMaxCodeLength)
+      return false;
+    kraftSum += 1 << (kMaxCodeLength - length);
+  }
+  if (kraftSum != (1u << kMaxCodeLength))
+    return false;
+
+  array<uint16_t, kSymbolsCount> symbols;
+  for (size_t i = 0; i < kSymbolsCount; ++i)
+    symbols[i] = static_cast<uint16_t>(i);
+  stable_sort(symbols.begin(), symbols.end(), [this](uint16_t lhs, uint16_t rhs)
+  {
+    return m_lengths[lhs] < m_lengths[rhs];
+  });
+
+  m_table.resize(1 << kMaxCodeLength);
+  uint32_t code = 0;
+  uint32_t prevLength = m_lengths[symbols[0]];
+  for (uint16_t const symbol : symbols)
+  {
+    uint32_t const length = m_lengths[symbol];
+    code <<= length - prevLength;
+    prevLength = length;
+    m_codes[symbol] = static_cast<uint16_t>(code);
+
+    uint32_t const first = code << (kMaxCodeLength - length);
+    uint32_t const last = first + (1 << (kMaxCodeLength - length));
+    for (uint32_t i = first; i < last; ++i)
+      m_table[i] = static_cast<uint16_t>((length << 8) | symbol);
+    ++code;
+  }
+  return true;
+}
+
+void ByteHuffmanCoder::Encode(string const & s, vector<uint8_t> & out) const
+{
+  ASSERT(!IsEmpty(), ());
+
+  uint32_t bits = 0;
+  uint32_t bitsCount = 0;
+  for (char const c : s)
+  {
+    uint8_t const symbol = static_cast<uint8_t>(c);
+    bits = (bits << m_lengths[symbol]) | m_codes[symbol];
+    bitsCount += m_lengths[symbol];
+    while (bitsCount >= 8)
+    {
+      bitsCount -= 8;
+      out.push_back(static_cast<uint8_t>(bits >> bitsCount));
+    }
+    bits &= (1u << bitsCount) - 1;
+  }
+  if (bitsCount != 0)
+    out.push_back(static_cast<uint8_t>(bits << (8 - bitsCount)));
+}
+
+bool ByteHuffmanCoder::Decode(uint8_t const * data, size_t size, size_t count, string & s) const
+{
+  if (IsEmpty())
+    return false;
+
+  s.resize(count);
+
+  uint32_t const mask = (1u << kMaxCodeLength) - 1;
+  uint32_t bits = 0;
+  uint32_t bitsCount = 0;
+  size_t pos = 0;
+  uint64_t decodedBits = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    // Bytes after the end are zeros, the overrun is checked below.
+    while (bitsCount < kMaxCodeLength)
+    {
+      bits = (bits << 8) | (pos < size ? data[pos] : 0);
+      ++pos;
+      bitsCount += 8;
+    }
+
+    uint16_t const entry = m_table[(bits >> (bitsCount - kMaxCodeLength)) & mask];
+    uint32_t const length = entry >> 8;
+    s[i] = static_cast<char>(entry & 0xFF);
+    bitsCount -= length;
+    bits &= (1u << bitsCount) - 1;
+    decodedBits += length;
+  }
+
+  return (decodedBits + 7) / 8 == size;
+}
+}  // namespace coding
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "base/assert.hpp"
+
+#include "std/array.hpp"
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace coding
+{
+/// Canonical Huffman code of bytes, it's trained on the feature names of an mwm.
+/// Code lengths are limited by kMaxCodeLength, so a byte is decoded by a single lookup
+/// of the next kMaxCodeLength bits in the table instead of a walk over the tree.
+/// Codes are written from the most significant bit of a byte.
+class ByteHuffmanCoder
+{
+public:
+  static uint32_t const kMaxCodeLength = 12;
+  static size_t const kSymbolsCount = 256;
+
+  using TFrequencies = array<uint64_t, kSymbolsCount>;
+
+  ByteHuffmanCoder();
+
+  static void AddFrequencies(string const & s, TFrequencies & freqs);
+
+  /// Builds the code of the bytes by their frequencies. Bytes which aren't met get
+  /// the longest codes, so any string may be encoded.
+  void Build(TFrequencies const & freqs);
+
+  inline bool IsEmpty() const { return m_table.empty(); }
+
+  /// Writes the code lengths of the bytes.
+  template <typename TSink>
+  void Write(TSink & sink) const
+  {
+    ASSERT(!IsEmpty(), ());
+    sink.Write(m_lengths.data(), m_lengths.size());
+  }
+
+  /// @return False when the code is malformed.
+  template <typename TSource>
+  bool Read(TSource & src)
+  {
+    src.Read(m_lengths.data(), m_lengths.size());
+    return BuildTable();
+  }
+
+  /// Appends the bits of s to out, the last byte is padded by zero bits.
+  void Encode(string const & s, vector<uint8_t> & out) const;
+
+  /// Decodes count bytes from [data, data + size) to s.
+  /// @return False when the data aren't exactly the code of count bytes.
+  bool Decode(uint8_t const * data, size_t size, size_t count, string & s) const;
+
+private:
+  /// Builds the codes and the decoding table by m_lengths.
+  bool BuildTable();
+
+  array<uint8_t, kSymbolsCount> m_lengths;
+  array<uint16_t, kSymbolsCount> m_codes;
+  // Code length << 8 | byte, indexed by the next kMaxCodeLength bits.
+  vector<uint16_t> m_table;
+};
+}  // namespace coding
@@ -13,17 +13,24 @@ SOURCES += \
     $$ROOT_DIR/3party/lodepng/lodepng.cpp \
     arithmetic_codec.cpp \
     base64.cpp \
+    buffered_file_writer.cpp \
+    byte_huffman.cpp \
 #    blob_indexer.cpp \
 #    blob_storage.cpp \
+    compressed_bitmap.cpp \
     compressed_bit_vector.cpp \
+    compressed_section.cpp \
 #    compressed_varnum_vector.cpp \
+    container_diff.cpp \
     file_container.cpp \
     file_name_utils.cpp \
+    file_sort.cpp \
     file_reader.cpp \
     file_writer.cpp \
     hex.cpp \
     huffman.cpp \
     internal/file_data.cpp \
+    mmap_policy.cpp \
     mmap_reader.cpp \
     multilang_utf8_string.cpp \
     png_memory_encoder.cpp \
@@ -31,7 +38,9 @@ SOURCES += \
     reader_streambuf.cpp \
     reader_writer_ops.cpp \
     sha2.cpp \
+    shared_page_cache.cpp \
     uri.cpp \
+    varint.cpp \
 #    varint_vector.cpp \
     zip_creator.cpp \
     zip_reader.cpp \
@@ -47,12 +56,17 @@ HEADERS += \
 #    blob_indexer.hpp \
 #    blob_storage.hpp \
     buffer_reader.hpp \
+    buffered_file_writer.hpp \
+    byte_huffman.hpp \
     byte_stream.hpp \
     coder.hpp \
     coder_util.hpp \
+    compressed_bitmap.hpp \
     compressed_bit_vector.hpp \
+    compressed_section.hpp \
 #    compressed_varnum_vector.hpp \
     constants.hpp \
+    container_diff.hpp \
     dd_vector.hpp \
     diff.hpp \
     diff_patch_common.hpp \
@@ -68,7 +82,9 @@ HEADERS += \
     huffman.hpp \
     internal/file64_api.hpp \
     internal/file_data.hpp \
+    mapped_section.hpp \
     matrix_traversal.hpp \
+    mmap_policy.hpp \
     mmap_reader.hpp \
     multilang_utf8_string.hpp \
     parse_xml.hpp \
@@ -81,6 +97,7 @@ HEADERS += \
     reader_wrapper.hpp \
     reader_writer_ops.hpp \
     sha2.hpp \
+    shared_page_cache.hpp \
     streams.hpp \
     streams_common.hpp \
     streams_sink.hpp \
@@ -0,0 +1,73 @@
+#include "testing/testing.hpp"
+
+#include "coding/buffered_file_writer.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+string const kFileName = "buffered_file_writer_test.tmp";
+
+vector<char> ReadFile()
+{
+  FileReader reader(kFileName);
+  vector<char> data(static_cast<size_t>(reader.Size()));
+  reader.Read(0, data.data(), data.size());
+  return data;
+}
+}  // namespace
+
+UNIT_TEST(BufferedFileWriter_Smoke)
+{
+  vector<char> expected;
+  {
+    // The writes are smaller and bigger than the buffer.
+    BufferedFileWriter writer(kFileName, FileWriter::OP_WRITE_TRUNCATE, 100 /* bufferSize */);
+    for (size_t size = 1; size < 300; size += 7)
+    {
+      vector<char> const data(size, static_cast<char>(size));
+      writer.Write(data.data(), data.size());
+      expected.insert(expected.end(), data.begin(), data.end());
+      TEST_EQUAL(writer.Pos(), expected.size(), ());
+      TEST_EQUAL(writer.Size(), expected.size(), ());
+    }
+
+    writer.Seek(10);
+    writer.Write("abc", 3);
+    TEST_EQUAL(writer.Pos(), 13, ());
+    TEST_EQUAL(writer.Size(), expected.size(), ());
+    copy_n("abc", 3, expected.begin() + 10);
+
+    writer.Seek(expected.size());
+    writer.Write("x", 1);
+    expected.push_back('x');
+  }
+  TEST(ReadFile() == expected, ());
+
+  {
+    BufferedFileWriter writer(kFileName, FileWriter::OP_APPEND, 4 /* bufferSize */);
+    writer.Write("yz", 2);
+    writer.Flush();
+    expected.push_back('y');
+    expected.push_back('z');
+    TEST(ReadFile() == expected, ());
+  }
+
+  TEST(my::DeleteFileX(kFileName), ());
+}
+
+UNIT_TEST(BufferedFileWriter_Preallocate)
+{
+  {
+    BufferedFileWriter writer(kFileName);
+    writer.Preallocate(1024 * 1024);
+    writer.Write("abc", 3);
+  }
+  // The file size isn't changed.
+  TEST_EQUAL(FileReader(kFileName).Size(), 3, ());
+  TEST(my::DeleteFileX(kFileName), ());
+}
@@ -0,0 +1,126 @@
+#include "testing/testing.hpp"
+
+#include "coding/byte_huffman.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "std/random.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+using coding::ByteHuffmanCoder;
+
+namespace
+{
+void TestRoundTrip(ByteHuffmanCoder const & coder, string const & s)
+{
+  vector<uint8_t> encoded;
+  coder.Encode(s, encoded);
+
+  string decoded;
+  TEST(coder.Decode(encoded.data(), encoded.size(), s.size(), decoded), (s));
+  TEST_EQUAL(decoded, s, ());
+}
+}  // namespace
+
+UNIT_TEST(ByteHuffman_Smoke)
+{
+  vector<string> const names = {"Main street", "Second street", "Central station", "Baker street"};
+
+  ByteHuffmanCoder::TFrequencies freqs;
+  freqs.fill(0);
+  for (string const & name : names)
+    ByteHuffmanCoder::AddFrequencies(name, freqs);
+
+  ByteHuffmanCoder coder;
+  TEST(coder.IsEmpty(), ());
+  coder.Build(freqs);
+  TEST(!coder.IsEmpty(), ());
+
+  size_t rawSize = 0;
+  size_t encodedSize = 0;
+  for (string const & name : names)
+  {
+    TestRoundTrip(coder, name);
+    vector<uint8_t> encoded;
+    coder.Encode(name, encoded);
+    rawSize += name.size();
+    encodedSize += encoded.size();
+  }
+  TEST_LESS(encodedSize, rawSize, ());
+
+  // Bytes which aren't met are encoded too.
+  TestRoundTrip(coder, "Новая улица");
+  TestRoundTrip(coder, string("\0\xFF\x01", 3));
+  TestRoundTrip(coder, "");
+
+  // The wrong count or the truncated data aren't decoded.
+  vector<uint8_t> encoded;
+  coder.Encode("Baker street", encoded);
+  string decoded;
+  TEST(!coder.Decode(encoded.data(), encoded.size(), 40, decoded), ());
+  TEST(!coder.Decode(encoded.data(), encoded.size() - 1, 12, decoded), ());
+}
+
+UNIT_TEST(ByteHuffman_LengthLimit)
+{
+  // Fibonacci frequencies give the longest Huffman codes.
+  ByteHuffmanCoder::TFrequencies freqs;
+  uint64_t a = 1, b = 1;
+  for (size_t i = 0; i < freqs.size(); ++i)
+  {
+    freqs[i] = i < 60 ? a : 0;
+    uint64_t const c = a + b;
+    a = b;
+    b = c;
+  }
+
+  ByteHuffmanCoder coder;
+  coder.Build(freqs);
+
+  mt19937 rng(0);
+  uniform_int_distribution<int> byte(0, 255);
+  string s;
+  for (size_t i = 0; i < 1000; ++i)
+    s.push_back(static_cast<char>(byte(rng)));
+  TestRoundTrip(coder, s);
+}
+
+UNIT_TEST(ByteHuffman_Serialization)
+{
+  ByteHuffmanCoder::TFrequencies freqs;
+  freqs.fill(1);
+  freqs['a'] = 100;
+  freqs['b'] = 10;
+
+  ByteHuffmanCoder coder;
+  coder.Build(freqs);
+
+  vector<char> buffer;
+  {
+    MemWriter<vector<char>> writer(buffer);
+    coder.Write(writer);
+  }
+
+  ByteHuffmanCoder loaded;
+  {
+    MemReader reader(buffer.data(), buffer.size());
+    ReaderSource<MemReader> src(reader);
+    TEST(loaded.Read(src), ());
+  }
+
+  string const s = "abracadabra";
+  vector<uint8_t> encoded;
+  coder.Encode(s, encoded);
+  string decoded;
+  TEST(loaded.Decode(encoded.data(), encoded.size(), s.size(), decoded), ());
+  TEST_EQUAL(decoded, s, ());
+
+  // The incomplete code isn't loaded.
+  buffer[0] = static_cast<char>(ByteHuffmanCoder::kMaxCodeLength);
+  buffer[1] = static_cast<char>(ByteHuffmanCoder::kMaxCodeLength);
+  MemReader reader(buffer.data(), buffer.size());
+  ReaderSource<MemReader> src(reader);
+  TEST(!loaded.Read(src), ());
+  TEST(loaded.IsEmpty(), ());
+}
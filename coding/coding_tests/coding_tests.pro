@@ -15,10 +15,15 @@ SOURCES += ../../testing/testingmain.cpp \
     base64_for_user_id_test.cpp \
     base64_test.cpp \
     bit_streams_test.cpp \
+    buffered_file_writer_test.cpp \
+    byte_huffman_test.cpp \
 #    blob_storage_test.cpp \
     coder_util_test.cpp \
+    compressed_bitmap_test.cpp \
     compressed_bit_vector_test.cpp \
+    compressed_section_test.cpp \
 #    compressed_varnum_vector_test.cpp \
+    container_diff_test.cpp \
     dd_vector_test.cpp \
     diff_test.cpp \
     endianness_test.cpp \
@@ -30,12 +35,14 @@ SOURCES += ../../testing/testingmain.cpp \
     huffman_test.cpp \
     mem_file_reader_test.cpp \
     mem_file_writer_test.cpp \
+    mmap_policy_test.cpp \
     multilang_utf8_string_test.cpp \
     png_decoder_test.cpp \
     reader_cache_test.cpp \
     reader_test.cpp \
     reader_writer_ops_test.cpp \
     sha2_test.cpp \
+    shared_page_cache_test.cpp \
     succinct_trie_test.cpp \
     trie_test.cpp \
     uri_test.cpp \
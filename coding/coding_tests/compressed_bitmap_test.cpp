@@ -0,0 +1,148 @@
+#include "testing/testing.hpp"
+
+#include "coding/compressed_bitmap.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/iterator.hpp"
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+
+namespace
+{
+// Positions with sparse, dense and continuous chunks.
+vector<uint32_t> MakePositions(uint32_t seed)
+{
+  mt19937 rng(seed);
+  vector<uint32_t> positions;
+  for (uint32_t key = 0; key < 8; ++key)
+  {
+    uint32_t const base = (key * 3 + seed % 3) << 16;
+    switch ((key + seed) % 4)
+    {
+    case 0:
+      for (uint32_t i = 0; i < 100; ++i)
+        positions.push_back(base + rng() % (1 << 16));
+      break;
+    case 1:
+      for (uint32_t i = 0; i < 20000; ++i)
+        positions.push_back(base + rng() % (1 << 16));
+      break;
+    case 2:
+      for (uint32_t i = 0; i < 10; ++i)
+      {
+        uint32_t const start = static_cast<uint32_t>(rng() % (1 << 16));
+        uint32_t const finish = min(start + static_cast<uint32_t>(rng() % 3000), uint32_t(1 << 16));
+        for (uint32_t pos = start; pos < finish; ++pos)
+          positions.push_back(base + pos);
+      }
+      break;
+    case 3:
+      break;
+    }
+  }
+  sort(positions.begin(), positions.end());
+  positions.erase(unique(positions.begin(), positions.end()), positions.end());
+  return positions;
+}
+
+void CheckOps(vector<uint32_t> const & a, vector<uint32_t> const & b, bool optimize)
+{
+  CompressedBitmap ba(a), bb(b);
+  if (optimize)
+  {
+    ba.RunOptimize();
+    bb.RunOptimize();
+  }
+  TEST_EQUAL(ba.GetCardinality(), a.size(), ());
+  TEST_EQUAL(ba.ToVector(), a, ());
+
+  vector<uint32_t> expected;
+  set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(expected));
+  CompressedBitmap const andRes = CompressedBitmap::And(ba, bb);
+  TEST_EQUAL(andRes.ToVector(), expected, ());
+  TEST_EQUAL(andRes.GetCardinality(), expected.size(), ());
+
+  expected.clear();
+  set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(expected));
+  TEST_EQUAL(CompressedBitmap::Or(ba, bb).ToVector(), expected, ());
+
+  expected.clear();
+  set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(expected));
+  TEST_EQUAL(CompressedBitmap::AndNot(ba, bb).ToVector(), expected, ());
+}
+}  // namespace
+
+UNIT_TEST(CompressedBitmap_Smoke)
+{
+  CompressedBitmap const empty;
+  TEST(empty.IsEmpty(), ());
+  TEST_EQUAL(empty.GetCardinality(), 0, ());
+  TEST(!empty.Contains(0), ());
+
+  vector<uint32_t> const positions = {0, 1, 2, 3, 65535, 65536, 0xFFFFFFFF};
+  CompressedBitmap bitmap(positions);
+  for (int i = 0; i < 2; ++i)
+  {
+    TEST_EQUAL(bitmap.ToVector(), positions, ());
+    for (uint32_t pos : positions)
+      TEST(bitmap.Contains(pos), (pos));
+    TEST(!bitmap.Contains(4), ());
+    TEST(!bitmap.Contains(65537), ());
+    TEST(!bitmap.Contains(0xFFFFFFFE), ());
+    bitmap.RunOptimize();
+  }
+}
+
+UNIT_TEST(CompressedBitmap_SetOps)
+{
+  for (uint32_t seed = 0; seed < 6; ++seed)
+  {
+    vector<uint32_t> const a = MakePositions(seed);
+    vector<uint32_t> const b = MakePositions(seed + 1);
+    CheckOps(a, b, false /* optimize */);
+    CheckOps(a, b, true /* optimize */);
+    CheckOps(a, a, true /* optimize */);
+    CheckOps(a, vector<uint32_t>(), false /* optimize */);
+  }
+}
+
+UNIT_TEST(CompressedBitmap_RunOptimize)
+{
+  vector<uint32_t> positions;
+  for (uint32_t pos = 1000; pos < 50000; ++pos)
+    positions.push_back(pos);
+
+  CompressedBitmap bitmap(positions);
+  size_t const size = bitmap.GetDataSize();
+  bitmap.RunOptimize();
+  TEST_LESS(bitmap.GetDataSize(), size, ());
+  TEST_EQUAL(bitmap.ToVector(), positions, ());
+  TEST(bitmap.Contains(1000), ());
+  TEST(bitmap.Contains(49999), ());
+  TEST(!bitmap.Contains(999), ());
+  TEST(!bitmap.Contains(50000), ());
+}
+
+UNIT_TEST(CompressedBitmap_Serialization)
+{
+  for (uint32_t seed = 0; seed < 4; ++seed)
+  {
+    vector<uint32_t> const positions = MakePositions(seed);
+    CompressedBitmap bitmap(positions);
+    if (seed % 2 == 0)
+      bitmap.RunOptimize();
+
+    vector<uint8_t> buffer;
+    {
+      MemWriter<vector<uint8_t>> writer(buffer);
+      bitmap.Serialize(writer);
+    }
+    MemReader reader(buffer.data(), buffer.size());
+    CompressedBitmap const decoded = CompressedBitmap::Deserialize(reader);
+    TEST_EQUAL(decoded.GetCardinality(), positions.size(), ());
+    TEST_EQUAL(decoded.ToVector(), positions, ());
+  }
+}
@@ -0,0 +1,177 @@
+#include "testing/testing.hpp"
+
+#include "coding/compressed_section.hpp"
+#include "coding/file_container.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+using namespace compressed_section;
+
+namespace
+{
+string const kFileName = "compressed_section_test.tmp";
+
+/// Data which is compressed well but not too well.
+vector<char> MakeData(size_t size)
+{
+  vector<char> data(size);
+  uint32_t x = 1;
+  for (size_t i = 0; i < size; ++i)
+  {
+    x = x * 1103515245 + 12345;
+    data[i] = static_cast<char>((x >> 16) % 16);
+  }
+  return data;
+}
+
+void TestRead(Reader const & reader, vector<char> const & data, uint64_t pos, size_t size)
+{
+  vector<char> buffer(size);
+  reader.Read(pos, buffer.data(), size);
+  TEST(equal(buffer.begin(), buffer.end(), data.begin() + pos), (pos, size));
+}
+}  // namespace
+
+UNIT_TEST(CompressedSection_Smoke)
+{
+  vector<char> const data = MakeData(10000);
+  for (uint32_t const blockSize : {1000, 1024, 4096, 20000})
+  {
+    {
+      FileWriter writer(kFileName);
+      Compress(MemReader(data.data(), data.size()), writer, blockSize);
+    }
+    TEST_LESS(FileReader(kFileName).Size(), data.size(), (blockSize));
+
+    BlockCache cache(BlockCache::kDefaultMaxBytes);
+    CompressedReader const reader(new FileReader(kFileName), cache);
+    TEST_EQUAL(reader.Size(), data.size(), ());
+    TEST_EQUAL(reader.GetBlockSize(), blockSize, ());
+    TEST_EQUAL(reader.GetBlocksCount(), (data.size() + blockSize - 1) / blockSize, ());
+
+    TestRead(reader, data, 0, data.size());
+    TestRead(reader, data, 1, 0);
+    TestRead(reader, data, 999, 2);
+    TestRead(reader, data, 5000, 5000);
+
+    unique_ptr<CompressedReader> const subReader(reader.CreateSubReader(3000, 4000));
+    TEST_EQUAL(subReader->Size(), 4000, ());
+    vector<char> const subData(data.begin() + 3000, data.begin() + 7000);
+    TestRead(*subReader, subData, 0, subData.size());
+    TestRead(*subReader, subData, 1023, 1025);
+  }
+  my::DeleteFileX(kFileName);
+}
+
+UNIT_TEST(CompressedSection_Empty)
+{
+  {
+    FileWriter writer(kFileName);
+    Compress(MemReader(nullptr, 0), writer);
+  }
+  CompressedReader const reader(new FileReader(kFileName));
+  TEST_EQUAL(reader.Size(), 0, ());
+  TEST_EQUAL(reader.GetBlocksCount(), 0, ());
+  my::DeleteFileX(kFileName);
+}
+
+UNIT_TEST(CompressedSection_Cache)
+{
+  vector<char> const data = MakeData(10000);
+  {
+    FileWriter writer(kFileName);
+    Compress(MemReader(data.data(), data.size()), writer, 1000);
+  }
+
+  BlockCache cache(BlockCache::kDefaultMaxBytes);
+  CompressedReader const reader(new FileReader(kFileName), cache);
+  {
+    unique_ptr<CompressedReader> const subReader(reader.CreateSubReader(500, 1000));
+    TestRead(*subReader, vector<char>(data.begin() + 500, data.end()), 0, 1000);
+  }
+  TEST_EQUAL(cache.GetStats().m_misses, 2, ());
+  TEST_EQUAL(cache.GetBytes(), 2000, ());
+
+  // The sub readers share the blocks.
+  TestRead(reader, data, 1500, 1000);
+  TEST_EQUAL(cache.GetStats().m_hits, 1, ());
+  TEST_EQUAL(cache.GetStats().m_misses, 3, ());
+
+  cache.SetMaxBytes(2000);
+  TEST_EQUAL(cache.GetBytes(), 2000, ());
+  cache.Trim(0.5);
+  TEST_EQUAL(cache.GetBytes(), 1000, ());
+  cache.Clear();
+  TEST_EQUAL(cache.GetBytes(), 0, ());
+  TestRead(reader, data, 0, data.size());
+  my::DeleteFileX(kFileName);
+}
+
+UNIT_TEST(CompressedSection_FilesContainer)
+{
+  vector<char> const data = MakeData(10000);
+  vector<char> const raw = MakeData(100);
+  {
+    FilesContainerW writer(kFileName);
+    writer.Write(raw, "raw");
+    writer.Write(data, "geom0");
+  }
+  {
+    FilesContainerW writer(kFileName, FileWriter::OP_WRITE_EXISTING);
+    writer.WriteCompressed(MemReader(data.data(), data.size()), "geom0", 1024, kDefaultLevel);
+  }
+
+  FilesContainerR const container(kFileName);
+  TEST(container.IsExist("raw"), ());
+  TEST(container.IsExist("geom0"), ());
+  TEST(!container.IsExist("geom1"), ());
+
+  // The raw section is replaced by the compressed one.
+  vector<string> tags;
+  container.ForEachTag([&tags](string const & tag) { tags.push_back(tag); });
+  TEST_EQUAL(tags, vector<string>({"geom0.z", "raw"}), ());
+
+  BlockCache::Stats const stats = BlockCache::Instance().GetStats();
+  FilesContainerR::ReaderT const reader = container.GetReader("geom0");
+  TEST_EQUAL(reader.Size(), data.size(), ());
+  TestRead(*reader.GetPtr(), data, 0, data.size());
+  TestRead(*reader.SubReader(100, 9000).GetPtr(), vector<char>(data.begin() + 100, data.end()),
+           2000, 3000);
+  TestRead(*container.GetReader("raw").GetPtr(), raw, 0, raw.size());
+
+  // All the readers of the section share the blocks.
+  TestRead(*container.GetReader("geom0").GetPtr(), data, 0, data.size());
+  TEST_EQUAL(BlockCache::Instance().GetStats().m_misses - stats.m_misses, 10, ());
+
+  my::DeleteFileX(kFileName);
+}
+
+UNIT_TEST(CompressedSection_Writer)
+{
+  vector<char> const data = MakeData(10000);
+  {
+    FileWriter file(kFileName);
+    // The section doesn't start at the beginning of the file.
+    file.Write("head", 4);
+    CompressedWriter writer(file, 1000);
+    for (size_t pos = 0, size = 1; pos < data.size(); pos += size, size = size * 2 + 1)
+    {
+      size = min(size, data.size() - pos);
+      TEST_EQUAL(writer.Pos(), pos, ());
+      writer.Write(data.data() + pos, size);
+    }
+    TEST_EQUAL(writer.Pos(), data.size(), ());
+  }
+
+  FileReader const file(kFileName);
+  CompressedReader const reader(file.CreateSubReader(4, file.Size() - 4));
+  TEST_EQUAL(reader.Size(), data.size(), ());
+  TEST_EQUAL(reader.GetBlocksCount(), 10, ());
+  TestRead(reader, data, 0, data.size());
+  my::DeleteFileX(kFileName);
+}
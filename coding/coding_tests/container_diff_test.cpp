@@ -0,0 +1,61 @@
+#include "testing/testing.hpp"
+
+#include "coding/container_diff.hpp"
+#include "coding/file_container.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "base/scope_guard.hpp"
+
+#include "std/bind.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+void WriteContainer(string const & fName, vector<pair<string, string>> const & sections)
+{
+  FilesContainerW writer(fName);
+  for (auto const & section : sections)
+    writer.Write(vector<char>(section.second.begin(), section.second.end()), section.first);
+}
+
+string ReadFile(string const & fName)
+{
+  string content;
+  FileReader(fName).ReadAsString(content);
+  return content;
+}
+}  // namespace
+
+UNIT_TEST(ContainerDiff_Smoke)
+{
+  string const oldName = "container_diff_old.tmp";
+  string const newName = "container_diff_new.tmp";
+  string const diffName = "container_diff.tmp";
+  string const patchedName = "container_diff_patched.tmp";
+  MY_SCOPE_GUARD(deleteFiles, [&]()
+  {
+    for (string const & name : {oldName, newName, diffName, patchedName})
+      (void)my::DeleteFileX(name);
+  });
+
+  string const unchanged(100000, 'u');
+  WriteContainer(oldName, {{"header", "v1"}, {"geometry", unchanged}, {"search", "old index"}, {"removed", "r"}});
+  WriteContainer(newName, {{"header", "v2"}, {"geometry", unchanged}, {"search", "new index"}, {"added", "a"}});
+
+  TEST(diff::MakeContainerDiff(oldName, newName, diffName), ());
+
+  uint64_t diffSize, newSize;
+  TEST(my::GetFileSize(diffName, diffSize), ());
+  TEST(my::GetFileSize(newName, newSize), ());
+  TEST_LESS(diffSize, newSize - unchanged.size() + 100, ("Unchanged section is copied"));
+
+  TEST(diff::ApplyContainerDiff(oldName, diffName, patchedName), ());
+  TEST_EQUAL(ReadFile(patchedName), ReadFile(newName), ());
+
+  // The diff doesn't belong to the new version.
+  (void)my::DeleteFileX(patchedName);
+  TEST(!diff::ApplyContainerDiff(newName, diffName, patchedName), ());
+  uint64_t size;
+  TEST(!my::GetFileSize(patchedName, size), ());
+}
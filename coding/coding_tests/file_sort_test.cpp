@@ -8,14 +8,16 @@
 
 namespace
 {
-  void TestFileSorter(vector<uint32_t> & data, char const * tmpFileName, size_t bufferSize)
+  void TestFileSorter(vector<uint32_t> & data, char const * tmpFileName, size_t bufferSize,
+                      size_t threadsCount = 1, bool compressRuns = false)
   {
     vector<char> serial;
     typedef MemWriter<vector<char> > MemWriterType;
     MemWriterType writer(serial);
     typedef WriterFunctor<MemWriterType> OutT;
     OutT out(writer);
-    FileSorter<uint32_t, OutT> sorter(bufferSize, tmpFileName, out);
+    FileSorter<uint32_t, OutT> sorter(bufferSize, tmpFileName, out, less<uint32_t>(), threadsCount,
+                                      compressRuns);
     for (size_t i = 0; i < data.size(); ++i)
       sorter.Add(data[i]);
     sorter.SortAndFinish();
@@ -49,3 +51,22 @@ UNIT_TEST(FileSorter_Random)
 
   TestFileSorter(data, "file_sorter_test_random.tmp", data.size() / 10);
 }
+
+UNIT_TEST(FileSorter_ParallelAndCompressed)
+{
+  mt19937 rng(0);
+  vector<uint32_t> data(100000);
+  // Small values are compressed well.
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = rng() % 1000;
+
+  for (size_t threadsCount : {1, 2, 3, 8})
+  {
+    for (bool compressRuns : {false, true})
+    {
+      vector<uint32_t> copy = data;
+      TestFileSorter(copy, "file_sorter_test_parallel.tmp", 4 * 1024 * sizeof(uint32_t),
+                     threadsCount, compressRuns);
+    }
+  }
+}
@@ -0,0 +1,65 @@
+#include "testing/testing.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/mmap_policy.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/vector.hpp"
+
+using namespace mmap_policy;
+
+UNIT_TEST(MmapPolicy_Overrides)
+{
+  TEST_EQUAL(Get("sdx", Random), Random, ());
+
+  TEST(SetOverrides("sdx=random+hugepages,mercedes=populate,trie=default"), ());
+  TEST_EQUAL(Get("sdx", Sequential), Random | HugePages, ());
+  TEST_EQUAL(Get("mercedes", Random), Populate, ());
+  TEST_EQUAL(Get("trie", Random), Default, ());
+  TEST_EQUAL(Get("geom0", WillNeed), WillNeed, ());
+
+  // Overrides aren't changed by the bad ones.
+  TEST(!SetOverrides("sdx=fast"), ());
+  TEST(!SetOverrides("=random"), ());
+  TEST(!SetOverrides("sdx"), ());
+  TEST_EQUAL(Get("sdx", Default), Random | HugePages, ());
+
+  TEST(SetOverrides(""), ());
+  TEST_EQUAL(Get("sdx", Sequential), Sequential, ());
+}
+
+UNIT_TEST(MmapPolicy_ToString)
+{
+  TEST_EQUAL(ToString(Default), "default", ());
+  TEST_EQUAL(ToString(Random), "random", ());
+  TEST_EQUAL(ToString(Sequential | WillNeed | Populate), "sequential+willneed+populate", ());
+}
+
+UNIT_TEST(MmapPolicy_Map)
+{
+  string const fName = "mmap_policy_test.tmp";
+  vector<char> data(100000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 251);
+
+  {
+    FilesContainerW writer(fName);
+    // The big section doesn't start at the page boundary.
+    writer.Write(vector<char>(1, 'x'), "small");
+    writer.Write(data, "big");
+  }
+
+  {
+    FilesMappingContainer cont(fName);
+    vector<TPolicy> const policies = {Default, Random, Sequential | WillNeed, HugePages, Populate};
+    for (TPolicy const policy : policies)
+    {
+      FilesMappingContainer::Handle h = cont.Map("big", policy);
+      TEST(h.IsValid(), ());
+      TEST_EQUAL(h.GetSize(), data.size(), ());
+      TEST(equal(data.begin(), data.end(), h.GetData<char>()), (ToString(policy)));
+    }
+  }
+
+  FileWriter::DeleteFileX(fName);
+}
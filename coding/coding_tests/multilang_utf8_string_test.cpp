@@ -1,6 +1,8 @@
 #include "testing/testing.hpp"
 
 #include "coding/multilang_utf8_string.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
 
 #include "3party/utfcpp/source/utf8.h"
 
@@ -103,3 +105,29 @@ UNIT_TEST(MultilangString_Unique)
   TEST(s.GetString(1, cmp), ());
   TEST_EQUAL(cmp, "yyy", ());
 }
+
+UNIT_TEST(MultilangString_Compressed)
+{
+  StringUtf8Multilang s;
+  for (size_t i = 0; i < ARRAY_SIZE(gArr); ++i)
+    s.AddString(gArr[i].m_lang, gArr[i].m_str);
+
+  coding::ByteHuffmanCoder::TFrequencies freqs;
+  freqs.fill(0);
+  s.AddFrequencies(freqs);
+  coding::ByteHuffmanCoder coder;
+  coder.Build(freqs);
+
+  vector<char> buffer;
+  {
+    MemWriter<vector<char>> writer(buffer);
+    s.Write(writer, coder);
+  }
+
+  StringUtf8Multilang loaded;
+  MemReader reader(buffer.data(), buffer.size());
+  ReaderSource<MemReader> src(reader);
+  loaded.Read(src, coder);
+  TEST_EQUAL(src.Size(), 0, ());
+  TEST(loaded == s, ());
+}
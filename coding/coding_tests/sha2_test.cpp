@@ -13,3 +13,13 @@ UNIT_TEST(Sha2_256)
   TEST_EQUAL(sha2::digest256("b", false),
              string(zero, ARRAY_SIZE(zero) - 1), ());
 }
+
+UNIT_TEST(Sha2_256_ByParts)
+{
+  sha2::Hasher256 hasher;
+  hasher.Update("Hello", 5);
+  hasher.Update("", 0);
+  hasher.Update(", world!", 8);
+  TEST_EQUAL(hasher.Digest(true),
+             "315F5BDB76D078C43B8AC0064E4A0164612B1FCE77C869345BFC94C75894EDD3", ());
+}
@@ -0,0 +1,138 @@
+#include "testing/testing.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/shared_page_cache.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/random.hpp"
+#include "std/thread.hpp"
+#include "std/vector.hpp"
+
+
+namespace
+{
+string const kFileName = "shared_page_cache_test.tmp";
+size_t const kFileSize = 100 * 1024 + 17;
+uint32_t const kLogPageSize = 10;
+
+vector<char> MakeData(size_t size, uint32_t seed)
+{
+  mt19937 rng(seed);
+  vector<char> data(size);
+  for (char & c : data)
+    c = static_cast<char>(rng());
+  return data;
+}
+
+void WriteData(string const & fileName, vector<char> const & data)
+{
+  FileWriter writer(fileName);
+  writer.Write(data.data(), data.size());
+}
+
+void CheckRandomReads(SharedPageCache & cache, SharedPageCache::File const & file,
+                      my::FileData const & fileData, vector<char> const & data, uint32_t seed)
+{
+  mt19937 rng(seed);
+  vector<char> buffer;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    uint64_t const pos = rng() % data.size();
+    size_t const size = min(static_cast<size_t>(rng() % 5000), data.size() - pos);
+    buffer.assign(size, 0);
+    cache.Read(file, fileData, data.size(), pos, buffer.data(), size);
+    TEST(equal(buffer.begin(), buffer.end(), data.begin() + pos), (pos, size));
+  }
+}
+}  // namespace
+
+UNIT_TEST(SharedPageCache_ConcurrentReads)
+{
+  vector<char> const data = MakeData(kFileSize, 1);
+  WriteData(kFileName, data);
+
+  {
+    // The budget is smaller than the file, so the pages are evicted all the time.
+    SharedPageCache cache(16 * 1024, 4);
+    shared_ptr<SharedPageCache::File> const file = cache.Open(kFileName, kLogPageSize);
+    my::FileData const fileData(kFileName, my::FileData::OP_READ);
+
+    vector<thread> threads;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+      threads.emplace_back([&, i]()
+      {
+        CheckRandomReads(cache, *file, fileData, data, i);
+      });
+    }
+    for (auto & t : threads)
+      t.join();
+
+    TEST_LESS_OR_EQUAL(cache.GetPagesCount() << kLogPageSize, cache.GetMaxBytes(), ());
+  }
+
+  FileWriter::DeleteFileX(kFileName);
+}
+
+UNIT_TEST(SharedPageCache_SharedPages)
+{
+  vector<char> const data = MakeData(kFileSize, 2);
+  WriteData(kFileName, data);
+
+  {
+    SharedPageCache cache(1024 * 1024, 4);
+    shared_ptr<SharedPageCache::File> const file1 = cache.Open(kFileName, kLogPageSize);
+    shared_ptr<SharedPageCache::File> const file2 = cache.Open(kFileName, kLogPageSize);
+    TEST_EQUAL(file1->GetId(), file2->GetId(), ());
+    my::FileData const fileData(kFileName, my::FileData::OP_READ);
+
+    vector<char> buffer(4000);
+    cache.Read(*file1, fileData, data.size(), 5000, buffer.data(), buffer.size());
+    size_t const pagesCount = cache.GetPagesCount();
+    TEST_EQUAL(pagesCount, 5, ());
+
+    // The second reader of the file hits the pages of the first one.
+    cache.Read(*file2, fileData, data.size(), 5000, buffer.data(), buffer.size());
+    TEST_EQUAL(cache.GetPagesCount(), pagesCount, ());
+    TEST(equal(buffer.begin(), buffer.end(), data.begin() + 5000), ());
+
+    // Big reads go to the file directly.
+    buffer.resize(SharedPageCache::kMaxCachedReadSize);
+    cache.Read(*file1, fileData, data.size(), 0, buffer.data(), buffer.size());
+    TEST_EQUAL(cache.GetPagesCount(), pagesCount, ());
+    TEST(equal(buffer.begin(), buffer.end(), data.begin()), ());
+
+    cache.SetMaxBytes(0);
+    TEST_EQUAL(cache.GetPagesCount(), 0, ());
+  }
+
+  FileWriter::DeleteFileX(kFileName);
+}
+
+UNIT_TEST(SharedPageCache_ReplacedFile)
+{
+  string const tmpFileName = kFileName + ".new";
+  vector<char> const oldData = MakeData(kFileSize, 3);
+  vector<char> const newData = MakeData(kFileSize, 4);
+  WriteData(kFileName, oldData);
+
+  vector<char> buffer(1000);
+  FileReader const oldReader(kFileName);
+  oldReader.Read(100, buffer.data(), buffer.size());
+  TEST(equal(buffer.begin(), buffer.end(), oldData.begin() + 100), ());
+
+  // The file is replaced while the reader of the old one is alive.
+  WriteData(tmpFileName, newData);
+  TEST(my::RenameFileX(tmpFileName, kFileName), ());
+
+  FileReader const newReader(kFileName);
+  newReader.Read(100, buffer.data(), buffer.size());
+  TEST(equal(buffer.begin(), buffer.end(), newData.begin() + 100), ());
+
+  oldReader.Read(100, buffer.data(), buffer.size());
+  TEST(equal(buffer.begin(), buffer.end(), oldData.begin() + 100), ());
+
+  FileWriter::DeleteFileX(kFileName);
+}
@@ -1,5 +1,6 @@
 #include "testing/testing.hpp"
 
+#include "coding/byte_stream.hpp"
 #include "coding/succinct_trie_builder.hpp"
 #include "coding/succinct_trie_reader.hpp"
 #include "coding/trie_builder.hpp"
@@ -11,9 +12,12 @@
 
 #include "indexer/search_trie.hpp"
 
+#include "base/logging.hpp"
 #include "base/string_utils.hpp"
+#include "base/timer.hpp"
 
 #include "std/algorithm.hpp"
+#include "std/random.hpp"
 #include "std/vector.hpp"
 
 namespace
@@ -100,6 +104,23 @@ struct SimpleValueList
   vector<uint8_t> m_valueList;
 };
 
+// Value list for the old trie builder, it's dumped to the sinks of different types.
+struct Uint8ValueList
+{
+  size_t size() const { return m_valueList.size(); }
+  bool empty() const { return m_valueList.empty(); }
+
+  template <typename TSink>
+  void Dump(TSink & sink) const
+  {
+    sink.Write(m_valueList.data(), m_valueList.size());
+  }
+
+  void Append(uint8_t x) { m_valueList.push_back(x); }
+
+  vector<uint8_t> m_valueList;
+};
+
 void ReadAllValues(unique_ptr<trie::SuccinctTrieIterator<MemReader, SimpleValueReader,
                                                          trie::EmptyValueReader>> const & root,
                    vector<uint8_t> & values)
@@ -119,6 +140,60 @@ void CollectInSubtree(unique_ptr<trie::SuccinctTrieIterator<MemReader, SimpleVal
   if (auto r = root->GoToEdge(1))
     CollectInSubtree(r, collectedValues);
 }
+using TSuccinctIterator = trie::SuccinctTrieIterator<MemReader, SimpleValueReader,
+                                                     trie::EmptyValueReader>;
+using TIterator0 = trie::Iterator<SimpleValueReader::ValueType, trie::EmptyValueReader::ValueType>;
+
+void CollectInSubtreeByChildren(TSuccinctIterator const & root, vector<uint8_t> & collectedValues)
+{
+  unique_ptr<TSuccinctIterator> const it = root.Clone();
+  for (size_t i = 0; i < it->NumValues(); ++i)
+    collectedValues.push_back(it->GetValue(i));
+
+  root.ForEachChild([&](size_t /* edge */, unique_ptr<TSuccinctIterator> && child)
+  {
+    CollectInSubtreeByChildren(*child, collectedValues);
+  });
+}
+
+// Random lowercase keys, which share the first letters like the names in the search index.
+vector<StringsFileEntryMock> MakeEntries(size_t count)
+{
+  mt19937 rng(0);
+  vector<StringsFileEntryMock> entries;
+  for (size_t i = 0; i < count; ++i)
+  {
+    string key(4 + rng() % 9, 'a');
+    for (char & c : key)
+      c = 'a' + rng() % 26;
+    entries.emplace_back(key, static_cast<uint8_t>(i));
+  }
+  sort(entries.begin(), entries.end());
+  return entries;
+}
+
+// Moves by the edges of the old trie, |s| may end inside of an edge.
+bool MoveToString0(TIterator0 const & root, strings::UniString const & s)
+{
+  unique_ptr<TIterator0> it(root.Clone());
+  size_t pos = 0;
+  while (pos < s.size())
+  {
+    size_t i = 0;
+    while (i < it->m_edge.size() && it->m_edge[i].m_str[0] != s[pos])
+      ++i;
+    if (i == it->m_edge.size())
+      return false;
+
+    auto const & edge = it->m_edge[i].m_str;
+    size_t const n = min(edge.size(), s.size() - pos);
+    if (!equal(edge.begin(), edge.begin() + n, s.begin() + pos))
+      return false;
+    pos += n;
+    it.reset(it->GoToEdge(i));
+  }
+  return true;
+}
 }  // namespace
 
 namespace trie
@@ -270,4 +345,97 @@ UNIT_TEST(SuccinctTrie_MoveToString)
   }
 }
 
+UNIT_TEST(SuccinctTrie_CachedLevels)
+{
+  vector<StringsFileEntryMock> data = MakeEntries(2000);
+
+  vector<uint8_t> buf;
+  using TWriter = MemWriter<vector<uint8_t>>;
+  TWriter memWriter(buf);
+  trie::BuildSuccinctTrie<TWriter, vector<StringsFileEntryMock>::iterator, trie::EmptyEdgeBuilder,
+                          SimpleValueList<TWriter>>(memWriter, data.begin(), data.end(),
+                                                    trie::EmptyEdgeBuilder());
+  MemReader memReader(buf.data(), buf.size());
+
+  vector<uint8_t> expectedValues;
+  for (uint32_t numCachedLevels : {0, 1, 5, 14, 1000})
+  {
+    auto trieRoot = trie::ReadSuccinctTrie(memReader, SimpleValueReader(),
+                                           trie::EmptyValueReader(), numCachedLevels);
+
+    vector<uint8_t> collectedValues;
+    CollectInSubtree(trieRoot, collectedValues);
+    vector<uint8_t> childrenValues;
+    CollectInSubtreeByChildren(*trieRoot, childrenValues);
+    TEST_EQUAL(collectedValues, childrenValues, (numCachedLevels));
+    if (expectedValues.empty())
+      expectedValues = collectedValues;
+    TEST_EQUAL(collectedValues, expectedValues, (numCachedLevels));
+
+    for (auto const & entry : data)
+    {
+      auto it = trieRoot->GoToString(strings::UniString(entry.m_key.begin(), entry.m_key.end()));
+      TEST(it != nullptr, ());
+      vector<uint8_t> values;
+      ReadAllValues(it, values);
+      TEST(find(values.begin(), values.end(), entry.m_value) != values.end(), ());
+    }
+    TEST(trieRoot->GoToString(strings::MakeUniString("zzzzzzzzzzzzzzzz")) == nullptr, ());
+  }
+}
+
+UNIT_TEST(SuccinctTrie_Benchmark)
+{
+  vector<StringsFileEntryMock> data = MakeEntries(20000);
+
+  vector<strings::UniString> queries;
+  for (auto const & entry : data)
+  {
+    strings::UniString const s(entry.m_key.begin(), entry.m_key.end());
+    // Prefixes are looked up while a user types.
+    for (size_t i = 1; i <= 3; ++i)
+      queries.emplace_back(s.begin(), s.begin() + i);
+    queries.push_back(s);
+  }
+
+  vector<uint8_t> buf;
+  using TWriter = MemWriter<vector<uint8_t>>;
+  TWriter memWriter(buf);
+  trie::BuildSuccinctTrie<TWriter, vector<StringsFileEntryMock>::iterator, trie::EmptyEdgeBuilder,
+                          SimpleValueList<TWriter>>(memWriter, data.begin(), data.end(),
+                                                    trie::EmptyEdgeBuilder());
+  MemReader memReader(buf.data(), buf.size());
+
+  vector<uint8_t> buf0;
+  PushBackByteSink<vector<uint8_t>> sink(buf0);
+  trie::Build<PushBackByteSink<vector<uint8_t>>, vector<StringsFileEntryMock>::iterator,
+              trie::EmptyEdgeBuilder, Uint8ValueList>(
+      sink, data.begin(), data.end(), trie::EmptyEdgeBuilder());
+  reverse(buf0.begin(), buf0.end());
+  MemReader memReader0(buf0.data(), buf0.size());
+  unique_ptr<TIterator0> const root0(
+      trie::ReadTrie(memReader0, SimpleValueReader(), trie::EmptyValueReader()));
+
+  my::Timer timer;
+  for (auto const & query : queries)
+    TEST(MoveToString0(*root0, query), ());
+  double const seconds0 = timer.ElapsedSeconds();
+
+  double seconds[2];
+  uint32_t const levels[2] = {0, trie::TopologyAndOffsets<MemReader, SimpleValueReader,
+                                  trie::EmptyValueReader>::kDefaultCachedLevels};
+  for (size_t i = 0; i < 2; ++i)
+  {
+    auto trieRoot =
+        trie::ReadSuccinctTrie(memReader, SimpleValueReader(), trie::EmptyValueReader(), levels[i]);
+    timer.Reset();
+    for (auto const & query : queries)
+      TEST(trieRoot->GoToString(query) != nullptr, ());
+    seconds[i] = timer.ElapsedSeconds();
+  }
+
+  LOG(LINFO, ("Queries:", queries.size(), "Iterator0:", seconds0, "Succinct:", seconds[0],
+              "Succinct with cached levels:", seconds[1]));
+}
+
 }  // namespace trie
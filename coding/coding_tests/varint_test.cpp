@@ -3,8 +3,15 @@
 
 #include "coding/byte_stream.hpp"
 
+#include "base/logging.hpp"
 #include "base/macros.hpp"
 #include "base/stl_add.hpp"
+#include "base/timer.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/limits.hpp"
+#include "std/random.hpp"
+#include "std/vector.hpp"
 
 
 namespace
@@ -34,6 +41,29 @@ namespace
     size_t const bytesRead = src.PtrUC() - &data[0];
     TEST_EQUAL(bytesRead, data.size(), (x));
   }
+
+  // Values of 1 to 10 bytes, small ones are the most frequent like the geometry deltas.
+  vector<uint64_t> MakeValues(size_t count, uint32_t seed)
+  {
+    mt19937 rng(seed);
+    vector<uint64_t> values(count);
+    for (uint64_t & value : values)
+    {
+      uint32_t const bits = rng() % 4 == 0 ? rng() % 65 : rng() % 8;
+      value = (static_cast<uint64_t>(rng()) << 32 | rng());
+      value = bits == 64 ? value : value & ((1ULL << bits) - 1);
+    }
+    return values;
+  }
+
+  vector<uint8_t> Encode(vector<uint64_t> const & values)
+  {
+    vector<uint8_t> data;
+    PushBackByteSink<vector<uint8_t> > dst(data);
+    for (uint64_t value : values)
+      WriteVarUint(dst, value);
+    return data;
+  }
 }
 
 UNIT_TEST(VarUint0)
@@ -178,3 +208,121 @@ UNIT_TEST(ReadVarInt64Array)
   }
 }
 
+
+UNIT_TEST(DecodeVarUint64Array)
+{
+  for (size_t count : {0, 1, 7, 15, 16, 17, 100, 1000})
+  {
+    for (uint32_t seed = 0; seed < 10; ++seed)
+    {
+      vector<uint64_t> const values = MakeValues(count, seed);
+      vector<uint8_t> const data = Encode(values);
+      vector<uint64_t> result(data.size());
+      size_t const decoded =
+          DecodeVarUint64Array(data.data(), data.data() + data.size(), result.data());
+      result.resize(decoded);
+      TEST_EQUAL(values, result, (count, seed));
+    }
+  }
+
+  // Long values only.
+  vector<uint64_t> const values(100, numeric_limits<uint64_t>::max());
+  vector<uint8_t> const data = Encode(values);
+  vector<uint64_t> result(data.size());
+  result.resize(DecodeVarUint64Array(data.data(), data.data() + data.size(), result.data()));
+  TEST_EQUAL(values, result, ());
+}
+
+UNIT_TEST(DecodeVarUint32Array)
+{
+  vector<uint64_t> values = MakeValues(1000, 1);
+  for (uint64_t & value : values)
+    value &= 0xFFFFFFFF;
+  vector<uint8_t> const data = Encode(values);
+
+  for (size_t count : {0, 1, 17, 500, 1000})
+  {
+    vector<uint32_t> result(count);
+    uint8_t const * p = DecodeVarUint32Array(data.data(), data.data() + data.size(), count,
+                                             result.data());
+    TEST(equal(result.begin(), result.end(), values.begin()), (count));
+
+    ArrayByteSource src(data.data());
+    for (size_t i = 0; i < count; ++i)
+      UNUSED_VALUE(ReadVarUint<uint32_t>(src));
+    TEST_EQUAL(p, src.PtrUC(), (count));
+  }
+}
+
+UNIT_TEST(DecodeVarUintArray_NotTerminated)
+{
+  vector<uint8_t> data(20, 0x80);
+  data[0] = 1;
+  vector<uint64_t> result(data.size());
+  bool thrown = false;
+  try
+  {
+    DecodeVarUint64Array(data.data(), data.data() + data.size(), result.data());
+  }
+  catch (ReadVarIntException const &)
+  {
+    thrown = true;
+  }
+  TEST(thrown, ());
+
+  thrown = false;
+  vector<uint32_t> result32(2);
+  try
+  {
+    DecodeVarUint32Array(data.data(), data.data() + data.size(), 2, result32.data());
+  }
+  catch (ReadVarIntException const &)
+  {
+    thrown = true;
+  }
+  TEST(thrown, ());
+}
+
+// Compares the byte by byte and the bulk decoding, the speeds are logged.
+UNIT_TEST(DecodeVarUint64Array_Benchmark)
+{
+  vector<uint64_t> const values = MakeValues(1000000, 2);
+  vector<uint8_t> const data = Encode(values);
+  uint8_t const * beg = data.data();
+  uint8_t const * end = beg + data.size();
+  vector<uint64_t> result(data.size());
+
+  my::Timer timer;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    result.clear();
+    ReadVarUint64Array(beg, end, MakeBackInsertFunctor(result));
+  }
+  double const byteSeconds = timer.ElapsedSeconds();
+  TEST_EQUAL(result, values, ());
+
+  result.resize(data.size());
+  timer.Reset();
+  size_t decoded = 0;
+  for (size_t i = 0; i < 10; ++i)
+    decoded = DecodeVarUint64Array(beg, end, result.data());
+  double const bulkSeconds = timer.ElapsedSeconds();
+  result.resize(decoded);
+  TEST_EQUAL(result, values, ());
+
+  timer.Reset();
+  uint64_t sum = 0;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    ArrayByteSource src(beg);
+    for (size_t j = 0; j < values.size(); ++j)
+      sum += ReadVarUint<uint64_t>(src);
+    TEST_EQUAL(src.PtrUC(), end, ());
+  }
+  double const sourceSeconds = timer.ElapsedSeconds();
+
+  double const mbytes = 10.0 * data.size() / (1024 * 1024);
+  LOG(LINFO, ("ReadVarUint:", mbytes / sourceSeconds, "MB/s",
+              "ReadVarUint64Array:", mbytes / byteSeconds, "MB/s",
+              "DecodeVarUint64Array:", mbytes / bulkSeconds, "MB/s", sum));
+}
@@ -216,3 +216,52 @@ UNIT_TEST(ZipFileSizes)
 
   FileWriter::DeleteFileX(ZIPFILE);
 }
+
+UNIT_TEST(ZipReaderReplacedContainer)
+{
+  string const ZIPFILE = "replaced_test.zip";
+  {
+    FileWriter f(ZIPFILE);
+    f.Write(zipBytes, ARRAY_SIZE(zipBytes) - 1);
+  }
+
+  for (int i = 0; i < 2; ++i)
+  {
+    string s;
+    ZipFileReader(ZIPFILE, "test.txt").ReadAsString(s);
+    TEST_EQUAL(s, "Test\n", (i));
+
+    bool located = true;
+    try
+    {
+      ZipFileReader r(ZIPFILE, "1.txt");
+    }
+    catch (ZipFileReader::LocateZipException const &)
+    {
+      located = false;
+    }
+    TEST(!located, (i));
+  }
+
+  // Entries of the replaced container are scanned again.
+  {
+    FileWriter f(ZIPFILE);
+    f.Write(zipBytes2, ARRAY_SIZE(zipBytes2) - 1);
+  }
+  string s;
+  ZipFileReader(ZIPFILE, "2.txt").ReadAsString(s);
+  TEST_EQUAL(s, "2\n", ());
+
+  bool located = true;
+  try
+  {
+    ZipFileReader r(ZIPFILE, "test.txt");
+  }
+  catch (ZipFileReader::LocateZipException const &)
+  {
+    located = false;
+  }
+  TEST(!located, ());
+
+  FileWriter::DeleteFileX(ZIPFILE);
+}
@@ -0,0 +1,640 @@
+#include "coding/compressed_bitmap.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/iterator.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define COMPRESSED_BITMAP_SSE2
+#include <emmintrin.h>
+#endif
+
+using impl::BitmapContainer;
+
+namespace
+{
+// Arrays of at most kMaxArraySize values are smaller than the bitmaps.
+uint32_t const kMaxArraySize = 4096;
+size_t const kWordsCount = (1 << 16) / 64;
+
+struct AndOp
+{
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a & b; }
+#ifdef COMPRESSED_BITMAP_SSE2
+  static __m128i Apply(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+#endif
+};
+
+struct OrOp
+{
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a | b; }
+#ifdef COMPRESSED_BITMAP_SSE2
+  static __m128i Apply(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+#endif
+};
+
+struct AndNotOp
+{
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a & ~b; }
+#ifdef COMPRESSED_BITMAP_SSE2
+  static __m128i Apply(__m128i a, __m128i b) { return _mm_andnot_si128(b, a); }
+#endif
+};
+
+uint32_t CountBits(vector<uint64_t> const & words)
+{
+  uint32_t count = 0;
+  for (uint64_t w : words)
+    count += static_cast<uint32_t>(bits::popcount(w));
+  return count;
+}
+
+/// Applies TOp to the words of two bitmaps.
+template <typename TOp>
+void ApplyWords(vector<uint64_t> const & lhs, vector<uint64_t> const & rhs, vector<uint64_t> & out)
+{
+  ASSERT_EQUAL(lhs.size(), kWordsCount, ());
+  ASSERT_EQUAL(rhs.size(), kWordsCount, ());
+  out.resize(kWordsCount);
+#ifdef COMPRESSED_BITMAP_SSE2
+  static_assert(kWordsCount % 2 == 0, "");
+  for (size_t i = 0; i < kWordsCount; i += 2)
+  {
+    __m128i const a = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&lhs[i]));
+    __m128i const b = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&rhs[i]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(&out[i]), TOp::Apply(a, b));
+  }
+#else
+  for (size_t i = 0; i < kWordsCount; ++i)
+    out[i] = TOp::Apply(lhs[i], rhs[i]);
+#endif
+}
+
+bool TestBit(vector<uint64_t> const & words, uint16_t v)
+{
+  return (words[v >> 6] >> (v & 63)) & 1;
+}
+
+void SetBit(vector<uint64_t> & words, uint16_t v) { words[v >> 6] |= uint64_t(1) << (v & 63); }
+
+void ClearBit(vector<uint64_t> & words, uint16_t v) { words[v >> 6] &= ~(uint64_t(1) << (v & 63)); }
+
+/// Sets bits [start, finish] of the bitmap.
+void SetRange(vector<uint64_t> & words, uint32_t start, uint32_t finish)
+{
+  uint32_t const first = start >> 6;
+  uint32_t const last = finish >> 6;
+  uint64_t const firstMask = ~uint64_t(0) << (start & 63);
+  uint64_t const lastMask = ~uint64_t(0) >> (63 - (finish & 63));
+  if (first == last)
+  {
+    words[first] |= firstMask & lastMask;
+    return;
+  }
+  words[first] |= firstMask;
+  for (uint32_t i = first + 1; i < last; ++i)
+    words[i] = ~uint64_t(0);
+  words[last] |= lastMask;
+}
+
+void ToBitmap(BitmapContainer & c)
+{
+  if (c.m_type == BitmapContainer::TYPE_BITMAP)
+    return;
+
+  vector<uint64_t> words(kWordsCount, 0);
+  if (c.m_type == BitmapContainer::TYPE_ARRAY)
+  {
+    for (uint16_t v : c.m_values)
+      SetBit(words, v);
+  }
+  else
+  {
+    for (size_t i = 0; i < c.m_values.size(); i += 2)
+      SetRange(words, c.m_values[i], c.m_values[i] + c.m_values[i + 1]);
+  }
+  c.m_type = BitmapContainer::TYPE_BITMAP;
+  c.m_words.swap(words);
+  vector<uint16_t>().swap(c.m_values);
+}
+
+void ToArray(BitmapContainer & c)
+{
+  if (c.m_type == BitmapContainer::TYPE_ARRAY)
+    return;
+
+  vector<uint16_t> values;
+  values.reserve(c.m_cardinality);
+  c.ForEach([&values](uint32_t pos)
+  {
+    values.push_back(static_cast<uint16_t>(pos));
+  });
+  c.m_type = BitmapContainer::TYPE_ARRAY;
+  c.m_values.swap(values);
+  vector<uint64_t>().swap(c.m_words);
+}
+
+/// Chooses the array or the bitmap by the cardinality, the runs are converted too.
+void Normalize(BitmapContainer & c)
+{
+  if (c.m_cardinality <= kMaxArraySize)
+    ToArray(c);
+  else
+    ToBitmap(c);
+}
+
+/// @return c when it's an array or a bitmap, its decoded copy in tmp otherwise.
+BitmapContainer const & GetPlain(BitmapContainer const & c, BitmapContainer & tmp)
+{
+  if (c.m_type != BitmapContainer::TYPE_RUN)
+    return c;
+  tmp = c;
+  Normalize(tmp);
+  return tmp;
+}
+
+uint32_t CountRuns(BitmapContainer const & c)
+{
+  switch (c.m_type)
+  {
+  case BitmapContainer::TYPE_ARRAY:
+  {
+    uint32_t runs = 0;
+    for (size_t i = 0; i < c.m_values.size(); ++i)
+    {
+      if (i == 0 || c.m_values[i] != c.m_values[i - 1] + 1)
+        ++runs;
+    }
+    return runs;
+  }
+  case BitmapContainer::TYPE_BITMAP:
+  {
+    // A run starts at every one which has zero at the previous position.
+    uint32_t runs = 0;
+    uint64_t carry = 0;
+    for (uint64_t w : c.m_words)
+    {
+      runs += static_cast<uint32_t>(bits::popcount(w & ~((w << 1) | carry)));
+      carry = w >> 63;
+    }
+    return runs;
+  }
+  case BitmapContainer::TYPE_RUN: return static_cast<uint32_t>(c.m_values.size() / 2);
+  }
+  return 0;
+}
+
+void ToRuns(BitmapContainer & c)
+{
+  if (c.m_type == BitmapContainer::TYPE_RUN)
+    return;
+
+  vector<uint16_t> runs;
+  bool first = true;
+  c.ForEach([&](uint32_t pos)
+  {
+    uint16_t const v = static_cast<uint16_t>(pos);
+    if (!first && runs[runs.size() - 2] + runs.back() + 1 == v)
+    {
+      ++runs.back();
+      return;
+    }
+    first = false;
+    runs.push_back(v);
+    runs.push_back(0);
+  });
+  c.m_type = BitmapContainer::TYPE_RUN;
+  c.m_values.swap(runs);
+  vector<uint64_t>().swap(c.m_words);
+}
+
+size_t GetContainerDataSize(BitmapContainer const & c)
+{
+  return c.m_values.size() * sizeof(uint16_t) + c.m_words.size() * sizeof(uint64_t);
+}
+
+void IntersectArrays(vector<uint16_t> const & lhs, vector<uint16_t> const & rhs,
+                     vector<uint16_t> & out)
+{
+  vector<uint16_t> const & small = lhs.size() <= rhs.size() ? lhs : rhs;
+  vector<uint16_t> const & large = lhs.size() <= rhs.size() ? rhs : lhs;
+  if (small.size() * 64 < large.size())
+  {
+    // Galloping through the large array.
+    auto it = large.begin();
+    for (uint16_t v : small)
+    {
+      it = lower_bound(it, large.end(), v);
+      if (it == large.end())
+        break;
+      if (*it == v)
+        out.push_back(v);
+    }
+    return;
+  }
+  set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), back_inserter(out));
+}
+
+BitmapContainer And(BitmapContainer const & lhs, BitmapContainer const & rhs)
+{
+  BitmapContainer res;
+  res.m_key = lhs.m_key;
+  if (lhs.m_type == BitmapContainer::TYPE_ARRAY && rhs.m_type == BitmapContainer::TYPE_ARRAY)
+  {
+    IntersectArrays(lhs.m_values, rhs.m_values, res.m_values);
+  }
+  else if (lhs.m_type == BitmapContainer::TYPE_BITMAP && rhs.m_type == BitmapContainer::TYPE_BITMAP)
+  {
+    ApplyWords<AndOp>(lhs.m_words, rhs.m_words, res.m_words);
+    res.m_type = BitmapContainer::TYPE_BITMAP;
+    res.m_cardinality = CountBits(res.m_words);
+    Normalize(res);
+    return res;
+  }
+  else
+  {
+    BitmapContainer const & array = lhs.m_type == BitmapContainer::TYPE_ARRAY ? lhs : rhs;
+    BitmapContainer const & bitmap = lhs.m_type == BitmapContainer::TYPE_ARRAY ? rhs : lhs;
+    for (uint16_t v : array.m_values)
+    {
+      if (TestBit(bitmap.m_words, v))
+        res.m_values.push_back(v);
+    }
+  }
+  res.m_cardinality = static_cast<uint32_t>(res.m_values.size());
+  return res;
+}
+
+BitmapContainer Or(BitmapContainer const & lhs, BitmapContainer const & rhs)
+{
+  BitmapContainer res;
+  res.m_key = lhs.m_key;
+  if (lhs.m_type == BitmapContainer::TYPE_ARRAY && rhs.m_type == BitmapContainer::TYPE_ARRAY)
+  {
+    set_union(lhs.m_values.begin(), lhs.m_values.end(), rhs.m_values.begin(),
+              rhs.m_values.end(), back_inserter(res.m_values));
+    res.m_cardinality = static_cast<uint32_t>(res.m_values.size());
+    Normalize(res);
+    return res;
+  }
+
+  if (lhs.m_type == BitmapContainer::TYPE_BITMAP && rhs.m_type == BitmapContainer::TYPE_BITMAP)
+  {
+    ApplyWords<OrOp>(lhs.m_words, rhs.m_words, res.m_words);
+  }
+  else
+  {
+    BitmapContainer const & array = lhs.m_type == BitmapContainer::TYPE_ARRAY ? lhs : rhs;
+    BitmapContainer const & bitmap = lhs.m_type == BitmapContainer::TYPE_ARRAY ? rhs : lhs;
+    res.m_words = bitmap.m_words;
+    for (uint16_t v : array.m_values)
+      SetBit(res.m_words, v);
+  }
+  res.m_type = BitmapContainer::TYPE_BITMAP;
+  res.m_cardinality = CountBits(res.m_words);
+  return res;
+}
+
+BitmapContainer AndNot(BitmapContainer const & lhs, BitmapContainer const & rhs)
+{
+  BitmapContainer res;
+  res.m_key = lhs.m_key;
+  if (lhs.m_type == BitmapContainer::TYPE_ARRAY)
+  {
+    if (rhs.m_type == BitmapContainer::TYPE_ARRAY)
+    {
+      set_difference(lhs.m_values.begin(), lhs.m_values.end(), rhs.m_values.begin(),
+                     rhs.m_values.end(), back_inserter(res.m_values));
+    }
+    else
+    {
+      for (uint16_t v : lhs.m_values)
+      {
+        if (!TestBit(rhs.m_words, v))
+          res.m_values.push_back(v);
+      }
+    }
+    res.m_cardinality = static_cast<uint32_t>(res.m_values.size());
+    return res;
+  }
+
+  if (rhs.m_type == BitmapContainer::TYPE_BITMAP)
+  {
+    ApplyWords<AndNotOp>(lhs.m_words, rhs.m_words, res.m_words);
+  }
+  else
+  {
+    res.m_words = lhs.m_words;
+    for (uint16_t v : rhs.m_values)
+      ClearBit(res.m_words, v);
+  }
+  res.m_type = BitmapContainer::TYPE_BITMAP;
+  res.m_cardinality = CountBits(res.m_words);
+  Normalize(res);
+  return res;
+}
+
+template <typename TSource>
+BitmapContainer ReadContainer(TSource & src, uint16_t key)
+{
+  BitmapContainer c;
+  c.m_key = key;
+  uint8_t const type = ReadPrimitiveFromSource<uint8_t>(src);
+  CHECK_LESS_OR_EQUAL(type, BitmapContainer::TYPE_RUN, ());
+  c.m_type = static_cast<BitmapContainer::Type>(type);
+  c.m_cardinality = ReadVarUint<uint32_t>(src) + 1;
+  CHECK_LESS_OR_EQUAL(c.m_cardinality, 1 << 16, ());
+
+  switch (c.m_type)
+  {
+  case BitmapContainer::TYPE_ARRAY:
+  {
+    CHECK_LESS_OR_EQUAL(c.m_cardinality, kMaxArraySize, ());
+    c.m_values.resize(c.m_cardinality);
+    uint32_t prev = ReadVarUint<uint32_t>(src);
+    c.m_values[0] = static_cast<uint16_t>(prev);
+    for (size_t i = 1; i < c.m_values.size(); ++i)
+    {
+      prev += ReadVarUint<uint32_t>(src) + 1;
+      c.m_values[i] = static_cast<uint16_t>(prev);
+    }
+    CHECK_LESS(prev, 1 << 16, ());
+    break;
+  }
+  case BitmapContainer::TYPE_BITMAP:
+    c.m_words.resize(kWordsCount);
+    for (uint64_t & w : c.m_words)
+      w = ReadPrimitiveFromSource<uint64_t>(src);
+    CHECK_EQUAL(c.m_cardinality, CountBits(c.m_words), ());
+    break;
+  case BitmapContainer::TYPE_RUN:
+  {
+    uint32_t const runs = ReadVarUint<uint32_t>(src) + 1;
+    CHECK_LESS_OR_EQUAL(runs, c.m_cardinality, ());
+    c.m_values.resize(2 * runs);
+    uint32_t next = 0;
+    uint32_t count = 0;
+    for (size_t i = 0; i < c.m_values.size(); i += 2)
+    {
+      uint32_t const start = next + ReadVarUint<uint32_t>(src);
+      uint32_t const length = ReadVarUint<uint32_t>(src) + 1;
+      CHECK_LESS_OR_EQUAL(start + length, 1 << 16, ());
+      c.m_values[i] = static_cast<uint16_t>(start);
+      c.m_values[i + 1] = static_cast<uint16_t>(length - 1);
+      // Runs are separated by at least one zero.
+      next = start + length + 1;
+      count += length;
+    }
+    CHECK_EQUAL(c.m_cardinality, count, ());
+    break;
+  }
+  }
+  return c;
+}
+
+template <typename TSink>
+void WriteContainer(TSink & sink, BitmapContainer const & c)
+{
+  WriteToSink(sink, static_cast<uint8_t>(c.m_type));
+  WriteVarUint(sink, c.m_cardinality - 1);
+
+  switch (c.m_type)
+  {
+  case BitmapContainer::TYPE_ARRAY:
+    WriteVarUint(sink, c.m_values[0]);
+    for (size_t i = 1; i < c.m_values.size(); ++i)
+      WriteVarUint(sink, static_cast<uint32_t>(c.m_values[i] - c.m_values[i - 1] - 1));
+    break;
+  case BitmapContainer::TYPE_BITMAP:
+    for (uint64_t w : c.m_words)
+      WriteToSink(sink, w);
+    break;
+  case BitmapContainer::TYPE_RUN:
+  {
+    WriteVarUint(sink, static_cast<uint32_t>(c.m_values.size() / 2 - 1));
+    uint32_t next = 0;
+    for (size_t i = 0; i < c.m_values.size(); i += 2)
+    {
+      WriteVarUint(sink, c.m_values[i] - next);
+      WriteVarUint(sink, c.m_values[i + 1]);
+      next = c.m_values[i] + c.m_values[i + 1] + 2;
+    }
+    break;
+  }
+  }
+}
+}  // namespace
+
+// static
+uint8_t const CompressedBitmap::kVersion;
+
+CompressedBitmap::CompressedBitmap(vector<uint32_t> const & positions)
+{
+  for (size_t i = 0; i < positions.size(); ++i)
+  {
+    ASSERT(i == 0 || positions[i - 1] < positions[i], (i));
+    uint16_t const key = static_cast<uint16_t>(positions[i] >> 16);
+    if (m_containers.empty() || m_containers.back().m_key != key)
+    {
+      if (!m_containers.empty())
+        Normalize(m_containers.back());
+      m_containers.emplace_back();
+      m_containers.back().m_key = key;
+    }
+    BitmapContainer & c = m_containers.back();
+    c.m_values.push_back(static_cast<uint16_t>(positions[i]));
+    ++c.m_cardinality;
+  }
+  if (!m_containers.empty())
+    Normalize(m_containers.back());
+}
+
+// static
+CompressedBitmap CompressedBitmap::And(CompressedBitmap const & lhs, CompressedBitmap const & rhs)
+{
+  CompressedBitmap res;
+  BitmapContainer tmp1, tmp2;
+  auto it1 = lhs.m_containers.begin();
+  auto it2 = rhs.m_containers.begin();
+  while (it1 != lhs.m_containers.end() && it2 != rhs.m_containers.end())
+  {
+    if (it1->m_key < it2->m_key)
+    {
+      ++it1;
+    }
+    else if (it2->m_key < it1->m_key)
+    {
+      ++it2;
+    }
+    else
+    {
+      BitmapContainer c = ::And(GetPlain(*it1, tmp1), GetPlain(*it2, tmp2));
+      if (c.m_cardinality != 0)
+        res.m_containers.push_back(move(c));
+      ++it1;
+      ++it2;
+    }
+  }
+  return res;
+}
+
+// static
+CompressedBitmap CompressedBitmap::Or(CompressedBitmap const & lhs, CompressedBitmap const & rhs)
+{
+  CompressedBitmap res;
+  BitmapContainer tmp1, tmp2;
+  auto it1 = lhs.m_containers.begin();
+  auto it2 = rhs.m_containers.begin();
+  while (it1 != lhs.m_containers.end() || it2 != rhs.m_containers.end())
+  {
+    if (it2 == rhs.m_containers.end() ||
+        (it1 != lhs.m_containers.end() && it1->m_key < it2->m_key))
+    {
+      res.m_containers.push_back(*it1++);
+    }
+    else if (it1 == lhs.m_containers.end() || it2->m_key < it1->m_key)
+    {
+      res.m_containers.push_back(*it2++);
+    }
+    else
+    {
+      res.m_containers.push_back(::Or(GetPlain(*it1, tmp1), GetPlain(*it2, tmp2)));
+      ++it1;
+      ++it2;
+    }
+  }
+  return res;
+}
+
+// static
+CompressedBitmap CompressedBitmap::AndNot(CompressedBitmap const & lhs,
+                                          CompressedBitmap const & rhs)
+{
+  CompressedBitmap res;
+  BitmapContainer tmp1, tmp2;
+  auto it2 = rhs.m_containers.begin();
+  for (auto const & c1 : lhs.m_containers)
+  {
+    while (it2 != rhs.m_containers.end() && it2->m_key < c1.m_key)
+      ++it2;
+    if (it2 == rhs.m_containers.end() || it2->m_key != c1.m_key)
+    {
+      res.m_containers.push_back(c1);
+      continue;
+    }
+    BitmapContainer c = ::AndNot(GetPlain(c1, tmp1), GetPlain(*it2, tmp2));
+    if (c.m_cardinality != 0)
+      res.m_containers.push_back(move(c));
+  }
+  return res;
+}
+
+bool CompressedBitmap::Contains(uint32_t pos) const
+{
+  uint16_t const key = static_cast<uint16_t>(pos >> 16);
+  uint16_t const v = static_cast<uint16_t>(pos);
+  auto const it = lower_bound(m_containers.begin(), m_containers.end(), key,
+                              [](BitmapContainer const & c, uint16_t k)
+                              {
+                                return c.m_key < k;
+                              });
+  if (it == m_containers.end() || it->m_key != key)
+    return false;
+
+  switch (it->m_type)
+  {
+  case BitmapContainer::TYPE_ARRAY:
+    return binary_search(it->m_values.begin(), it->m_values.end(), v);
+  case BitmapContainer::TYPE_BITMAP:
+    return TestBit(it->m_words, v);
+  case BitmapContainer::TYPE_RUN:
+  {
+    // Finds the last run which starts not after v.
+    size_t lo = 0, hi = it->m_values.size() / 2;
+    while (lo < hi)
+    {
+      size_t const mid = (lo + hi) / 2;
+      if (it->m_values[2 * mid] <= v)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo != 0 && v <= it->m_values[2 * (lo - 1)] + it->m_values[2 * (lo - 1) + 1];
+  }
+  }
+  return false;
+}
+
+uint64_t CompressedBitmap::GetCardinality() const
+{
+  uint64_t cardinality = 0;
+  for (auto const & c : m_containers)
+    cardinality += c.m_cardinality;
+  return cardinality;
+}
+
+void CompressedBitmap::RunOptimize()
+{
+  for (auto & c : m_containers)
+  {
+    size_t const runsSize = CountRuns(c) * 2 * sizeof(uint16_t);
+    if (runsSize < GetContainerDataSize(c))
+      ToRuns(c);
+  }
+}
+
+size_t CompressedBitmap::GetDataSize() const
+{
+  size_t size = 0;
+  for (auto const & c : m_containers)
+    size += GetContainerDataSize(c);
+  return size;
+}
+
+vector<uint32_t> CompressedBitmap::ToVector() const
+{
+  vector<uint32_t> res;
+  res.reserve(static_cast<size_t>(GetCardinality()));
+  ForEach([&res](uint32_t pos)
+  {
+    res.push_back(pos);
+  });
+  return res;
+}
+
+void CompressedBitmap::Serialize(Writer & writer) const
+{
+  WriteToSink(writer, kVersion);
+  WriteVarUint(writer, static_cast<uint32_t>(m_containers.size()));
+  for (auto const & c : m_containers)
+  {
+    WriteToSink(writer, c.m_key);
+    WriteContainer(writer, c);
+  }
+}
+
+// static
+CompressedBitmap CompressedBitmap::Deserialize(Reader & reader)
+{
+  ReaderSource<Reader &> src(reader);
+  uint8_t const version = ReadPrimitiveFromSource<uint8_t>(src);
+  CHECK_EQUAL(version, kVersion, ());
+
+  CompressedBitmap res;
+  uint32_t const count = ReadVarUint<uint32_t>(src);
+  CHECK_LESS_OR_EQUAL(count, 1 << 16, ());
+  res.m_containers.reserve(count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    uint16_t const key = ReadPrimitiveFromSource<uint16_t>(src);
+    CHECK(res.m_containers.empty() || res.m_containers.back().m_key < key, (key));
+    res.m_containers.push_back(ReadContainer(src, key));
+  }
+  return res;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "base/bits.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+class Reader;
+class Writer;
+
+namespace impl
+{
+/// Chunk of CompressedBitmap, it keeps low 16 bits of the positions with the same high 16 bits.
+struct BitmapContainer
+{
+  enum Type : uint8_t
+  {
+    // Sorted low bits of the positions in m_values.
+    TYPE_ARRAY = 0,
+    // 2^16 bits in m_words.
+    TYPE_BITMAP = 1,
+    // Pairs (start, length - 1) of the ranges of ones in m_values.
+    TYPE_RUN = 2
+  };
+
+  template <typename ToDo>
+  void ForEach(ToDo && toDo) const
+  {
+    uint32_t const base = static_cast<uint32_t>(m_key) << 16;
+    switch (m_type)
+    {
+    case TYPE_ARRAY:
+      for (uint16_t v : m_values)
+        toDo(base | v);
+      break;
+    case TYPE_BITMAP:
+      for (size_t i = 0; i < m_words.size(); ++i)
+      {
+        for (uint64_t w = m_words[i]; w != 0; w &= w - 1)
+        {
+          // Number of the trailing zeros is the number of ones below the lowest one.
+          uint32_t const bit = static_cast<uint32_t>(bits::popcount((w & (~w + 1)) - 1));
+          toDo(base | static_cast<uint32_t>(i * 64 + bit));
+        }
+      }
+      break;
+    case TYPE_RUN:
+      for (size_t i = 0; i < m_values.size(); i += 2)
+      {
+        uint32_t const start = base | m_values[i];
+        for (uint32_t j = 0; j <= m_values[i + 1]; ++j)
+          toDo(start + j);
+      }
+      break;
+    }
+  }
+
+  uint16_t m_key = 0;
+  Type m_type = TYPE_ARRAY;
+  uint32_t m_cardinality = 0;
+  vector<uint16_t> m_values;
+  vector<uint64_t> m_words;
+};
+}  // namespace impl
+
+/// Compressed bitmap of uint32_t positions which is split into the chunks of 2^16 positions.
+/// Each chunk is a sorted array when it's sparse, a plain bitmap when it's dense, or a list of
+/// the ranges of ones after RunOptimize(), so set operations work on chunks without decoding
+/// the whole set. It's an in-memory alternative to BuildCompressedBitVector's position lists.
+/// Usage:
+///   CompressedBitmap const a(posOnes1), b(posOnes2);
+///   vector<uint32_t> const andRes = CompressedBitmap::And(a, b).ToVector();
+class CompressedBitmap
+{
+public:
+  /// Version of the serialized format.
+  static uint8_t const kVersion = 0;
+
+  CompressedBitmap() = default;
+
+  /// @param positions Sorted positions of ones without duplicates.
+  explicit CompressedBitmap(vector<uint32_t> const & positions);
+
+  static CompressedBitmap And(CompressedBitmap const & lhs, CompressedBitmap const & rhs);
+  static CompressedBitmap Or(CompressedBitmap const & lhs, CompressedBitmap const & rhs);
+  /// @return Positions of lhs which are not in rhs.
+  static CompressedBitmap AndNot(CompressedBitmap const & lhs, CompressedBitmap const & rhs);
+
+  bool Contains(uint32_t pos) const;
+  uint64_t GetCardinality() const;
+  bool IsEmpty() const { return m_containers.empty(); }
+
+  /// Converts chunks into the lists of ranges when they are smaller.
+  void RunOptimize();
+
+  /// @return Number of bytes of the chunks' data.
+  size_t GetDataSize() const;
+
+  /// Calls toDo for all positions in increasing order.
+  template <typename ToDo>
+  void ForEach(ToDo && toDo) const
+  {
+    for (auto const & container : m_containers)
+      container.ForEach(toDo);
+  }
+
+  vector<uint32_t> ToVector() const;
+
+  void Serialize(Writer & writer) const;
+  static CompressedBitmap Deserialize(Reader & reader);
+
+private:
+  // Sorted by the keys, there are no empty containers.
+  vector<impl::BitmapContainer> m_containers;
+};
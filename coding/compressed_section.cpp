@@ -0,0 +1,334 @@
+#include "coding/compressed_section.hpp"
+
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstring.hpp"
+#include "std/limits.hpp"
+
+#include "zlib.h"
+
+namespace compressed_section
+{
+namespace
+{
+uint8_t constexpr kVersion = 0;
+// blockSize, rawSize, blocksCount, version.
+uint64_t constexpr kFooterSize = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t) + 1;
+}  // namespace
+
+char const kTagSuffix[] = ".z";
+
+void Compress(Reader const & reader, Writer & writer, uint32_t blockSize, int level)
+{
+  CompressedWriter compressed(writer, blockSize, level);
+  vector<char> buffer(blockSize);
+  uint64_t const rawSize = reader.Size();
+  for (uint64_t pos = 0; pos < rawSize; pos += blockSize)
+  {
+    size_t const size = static_cast<size_t>(min(static_cast<uint64_t>(blockSize), rawSize - pos));
+    reader.Read(pos, buffer.data(), size);
+    compressed.Write(buffer.data(), size);
+  }
+  compressed.Finish();
+}
+
+// CompressedWriter --------------------------------------------------------------------------------
+CompressedWriter::CompressedWriter(Writer & writer, uint32_t blockSize, int level)
+  : m_writer(writer), m_blockSize(blockSize), m_level(level), m_start(writer.Pos())
+{
+  ASSERT_GREATER(m_blockSize, 0, ());
+  m_block.reserve(m_blockSize);
+  m_compressed.resize(compressBound(m_blockSize));
+}
+
+CompressedWriter::~CompressedWriter()
+{
+  if (!m_finished)
+    Finish();
+}
+
+void CompressedWriter::Seek(int64_t pos)
+{
+  if (pos != Pos())
+    MYTHROW(Writer::SeekException, ("Compressed section is written sequentially", pos, Pos()));
+}
+
+int64_t CompressedWriter::Pos() const
+{
+  return static_cast<int64_t>(m_rawSize);
+}
+
+void CompressedWriter::Write(void const * p, size_t size)
+{
+  ASSERT(!m_finished, ());
+  char const * src = static_cast<char const *>(p);
+  m_rawSize += size;
+  while (size > 0)
+  {
+    size_t const part = min(size, m_blockSize - m_block.size());
+    m_block.insert(m_block.end(), src, src + part);
+    src += part;
+    size -= part;
+
+    if (m_block.size() == m_blockSize)
+      WriteBlock();
+  }
+}
+
+void CompressedWriter::Finish()
+{
+  ASSERT(!m_finished, ());
+  m_finished = true;
+
+  if (!m_block.empty())
+    WriteBlock();
+  uint64_t const blocksCount = m_offsets.size();
+  CHECK_LESS_OR_EQUAL(blocksCount, numeric_limits<uint32_t>::max(), ());
+  m_offsets.push_back(m_writer.Pos() - m_start);
+
+  for (uint64_t offset : m_offsets)
+    WriteToSink(m_writer, offset);
+  WriteToSink(m_writer, m_blockSize);
+  WriteToSink(m_writer, m_rawSize);
+  WriteToSink(m_writer, static_cast<uint32_t>(blocksCount));
+  WriteToSink(m_writer, kVersion);
+}
+
+void CompressedWriter::WriteBlock()
+{
+  m_offsets.push_back(m_writer.Pos() - m_start);
+
+  uLongf compressedSize = m_compressed.size();
+  int const res = compress2(reinterpret_cast<Bytef *>(m_compressed.data()), &compressedSize,
+                            reinterpret_cast<Bytef const *>(m_block.data()), m_block.size(),
+                            m_level);
+  if (res == Z_OK && compressedSize < m_block.size())
+    m_writer.Write(m_compressed.data(), compressedSize);
+  else
+    m_writer.Write(m_block.data(), m_block.size());
+  m_block.clear();
+}
+
+// BlockCache --------------------------------------------------------------------------------------
+// static
+size_t const BlockCache::kDefaultMaxBytes;
+
+BlockCache::BlockCache(size_t maxBytes) : m_maxBytes(maxBytes), m_lastSectionId(0)
+{
+  m_governorId = CacheGovernor::Instance().Register("CompressedSections", CacheGovernor::LOW,
+                                                    [this]() { return GetBytes(); },
+                                                    [this](double share) { Trim(share); });
+}
+
+BlockCache::~BlockCache()
+{
+  CacheGovernor::Instance().Unregister(m_governorId);
+}
+
+// static
+BlockCache & BlockCache::Instance()
+{
+  static BlockCache cache(kDefaultMaxBytes);
+  return cache;
+}
+
+BlockCache::TBlock BlockCache::Find(uint64_t sectionId, uint32_t block)
+{
+  lock_guard<mutex> lock(m_mutex);
+  auto const it = m_index.find(make_pair(sectionId, block));
+  if (it == m_index.end())
+  {
+    ++m_stats.m_misses;
+    return TBlock();
+  }
+
+  ++m_stats.m_hits;
+  m_lru.splice(m_lru.begin(), m_lru, it->second);
+  return it->second->second;
+}
+
+void BlockCache::Add(uint64_t sectionId, uint32_t block, TBlock const & data)
+{
+  lock_guard<mutex> lock(m_mutex);
+  if (data->size() > m_maxBytes)
+    return;
+
+  TKey const key(sectionId, block);
+  if (m_index.find(key) != m_index.end())
+    return;
+
+  m_lru.emplace_front(key, data);
+  m_index.emplace(key, m_lru.begin());
+  m_bytes += data->size();
+  EvictTo(m_maxBytes);
+}
+
+void BlockCache::SetMaxBytes(size_t maxBytes)
+{
+  lock_guard<mutex> lock(m_mutex);
+  m_maxBytes = maxBytes;
+  EvictTo(m_maxBytes);
+}
+
+void BlockCache::Trim(double share)
+{
+  lock_guard<mutex> lock(m_mutex);
+  EvictTo(static_cast<size_t>(m_bytes * (1.0 - min(max(share, 0.0), 1.0))));
+}
+
+size_t BlockCache::GetBytes() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_bytes;
+}
+
+BlockCache::Stats BlockCache::GetStats() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_stats;
+}
+
+void BlockCache::EvictTo(size_t maxBytes)
+{
+  while (m_bytes > maxBytes)
+  {
+    ASSERT(!m_lru.empty(), ());
+    m_bytes -= m_lru.back().second->size();
+    m_index.erase(m_lru.back().first);
+    m_lru.pop_back();
+  }
+}
+
+// CompressedReader --------------------------------------------------------------------------------
+struct CompressedReader::Section
+{
+  Section(ModelReaderPtr const & reader, BlockCache & cache)
+    : m_reader(reader), m_cache(cache), m_id(cache.NewSectionId())
+  {
+  }
+
+  ModelReaderPtr m_reader;
+  BlockCache & m_cache;
+  uint64_t const m_id;
+  uint32_t m_blockSize = 0;
+  uint64_t m_rawSize = 0;
+  /// Offsets of the blocks and of the end of the last one.
+  vector<uint64_t> m_offsets;
+};
+
+CompressedReader::CompressedReader(ModelReaderPtr const & reader, BlockCache & cache)
+  : ModelReader(reader.GetName()), m_offset(0)
+{
+  shared_ptr<Section> s = make_shared<Section>(reader, cache);
+
+  uint64_t const size = reader.Size();
+  if (size < kFooterSize)
+    MYTHROW(Reader::ReadException, ("Too small compressed section", reader.GetName()));
+
+  uint64_t pos = size - kFooterSize;
+  s->m_blockSize = ReadPrimitiveFromPos<uint32_t>(reader, pos);
+  pos += sizeof(uint32_t);
+  s->m_rawSize = ReadPrimitiveFromPos<uint64_t>(reader, pos);
+  pos += sizeof(uint64_t);
+  uint32_t const blocksCount = ReadPrimitiveFromPos<uint32_t>(reader, pos);
+  pos += sizeof(uint32_t);
+  uint8_t const version = ReadPrimitiveFromPos<uint8_t>(reader, pos);
+
+  uint64_t const offsetsSize = (static_cast<uint64_t>(blocksCount) + 1) * sizeof(uint64_t);
+  if (version != kVersion || s->m_blockSize == 0 || offsetsSize > size - kFooterSize ||
+      (s->m_rawSize + s->m_blockSize - 1) / s->m_blockSize != blocksCount)
+  {
+    MYTHROW(Reader::ReadException, ("Bad compressed section", reader.GetName(), version));
+  }
+
+  ReaderSource<ModelReaderPtr> src(reader);
+  src.Skip(size - kFooterSize - offsetsSize);
+  s->m_offsets.resize(blocksCount + 1);
+  for (uint64_t & offset : s->m_offsets)
+    offset = ReadPrimitiveFromSource<uint64_t>(src);
+  if (s->m_offsets.back() != size - kFooterSize - offsetsSize)
+    MYTHROW(Reader::ReadException, ("Bad offsets of compressed section", reader.GetName()));
+
+  m_size = s->m_rawSize;
+  m_section = move(s);
+}
+
+CompressedReader::CompressedReader(shared_ptr<Section const> const & section, uint64_t offset,
+                                   uint64_t size)
+  : ModelReader(section->m_reader.GetName()), m_section(section), m_offset(offset), m_size(size)
+{
+}
+
+void CompressedReader::Read(uint64_t pos, void * p, size_t size) const
+{
+  ASSERT_LESS_OR_EQUAL(pos + size, m_size, ());
+
+  uint32_t const blockSize = m_section->m_blockSize;
+  char * out = static_cast<char *>(p);
+  pos += m_offset;
+  while (size > 0)
+  {
+    uint32_t const block = static_cast<uint32_t>(pos / blockSize);
+    size_t const inBlock = static_cast<size_t>(pos % blockSize);
+    BlockCache::TBlock const data = GetBlock(block);
+    size_t const count = min(size, data->size() - inBlock);
+    memcpy(out, data->data() + inBlock, count);
+    out += count;
+    pos += count;
+    size -= count;
+  }
+}
+
+CompressedReader * CompressedReader::CreateSubReader(uint64_t pos, uint64_t size) const
+{
+  ASSERT_LESS_OR_EQUAL(pos + size, m_size, ());
+  return new CompressedReader(m_section, m_offset + pos, size);
+}
+
+uint32_t CompressedReader::GetBlockSize() const { return m_section->m_blockSize; }
+
+uint32_t CompressedReader::GetBlocksCount() const
+{
+  return static_cast<uint32_t>(m_section->m_offsets.size() - 1);
+}
+
+BlockCache::TBlock CompressedReader::GetBlock(uint32_t block) const
+{
+  Section const & s = *m_section;
+  ASSERT_LESS(block + 1, s.m_offsets.size(), ());
+
+  BlockCache::TBlock data = s.m_cache.Find(s.m_id, block);
+  if (data)
+    return data;
+
+  // Blocks are decompressed outside of the cache lock, so the concurrent readers may
+  // decompress the same block twice, but they never wait for each other.
+  uint64_t const rawPos = static_cast<uint64_t>(block) * s.m_blockSize;
+  size_t const rawSize =
+      static_cast<size_t>(min(static_cast<uint64_t>(s.m_blockSize), s.m_rawSize - rawPos));
+  size_t const storedSize = static_cast<size_t>(s.m_offsets[block + 1] - s.m_offsets[block]);
+
+  shared_ptr<vector<char>> raw = make_shared<vector<char>>(rawSize);
+  if (storedSize == rawSize)
+  {
+    s.m_reader.Read(s.m_offsets[block], raw->data(), rawSize);
+  }
+  else
+  {
+    vector<char> stored(storedSize);
+    s.m_reader.Read(s.m_offsets[block], stored.data(), storedSize);
+    uLongf size = rawSize;
+    int const res = uncompress(reinterpret_cast<Bytef *>(raw->data()), &size,
+                               reinterpret_cast<Bytef const *>(stored.data()), storedSize);
+    if (res != Z_OK || size != rawSize)
+      MYTHROW(Reader::ReadException, ("Can't decompress block", block, "of", s.m_reader.GetName(), res));
+  }
+
+  data = move(raw);
+  s.m_cache.Add(s.m_id, block, data);
+  return data;
+}
+}  // namespace compressed_section
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/cache_governor.hpp"
+#include "base/macros.hpp"
+
+#include "std/atomic.hpp"
+#include "std/cstdint.hpp"
+#include "std/functional.hpp"
+#include "std/list.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/unordered_map.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+/// Seekable block compression of the container sections. A section is split into the blocks of
+/// the fixed size which are compressed by zlib apart, and the offsets of the blocks are kept, so
+/// a read decompresses only the blocks it touches. Decompressed blocks are kept in BlockCache
+/// which is shared by all the readers.
+///
+/// Format: compressed blocks, blocksCount + 1 offsets of the blocks (uint64_t), blockSize
+/// (uint32_t), rawSize (uint64_t), blocksCount (uint32_t), version (uint8_t). A block which
+/// doesn't shrink is stored as is.
+namespace compressed_section
+{
+uint32_t constexpr kDefaultBlockSize = 64 * 1024;
+/// zlib compression level, from 1 (fast) to 9 (small).
+int constexpr kDefaultLevel = 6;
+
+/// Compressed section "tag" is stored in the container as "tag" + kTagSuffix.
+/// FilesContainerR reads it when there is no raw section, while the old readers don't find
+/// the section at all instead of taking the compressed data for the raw one.
+extern char const kTagSuffix[];
+
+void Compress(Reader const & reader, Writer & writer, uint32_t blockSize = kDefaultBlockSize,
+              int level = kDefaultLevel);
+
+/// Compresses the data as it's written, a block is compressed when it's filled. The section
+/// is written to the end of writer and it's completed by Finish() or by the destructor.
+/// Seek() is supported to the current position only.
+class CompressedWriter : public Writer
+{
+public:
+  explicit CompressedWriter(Writer & writer, uint32_t blockSize = kDefaultBlockSize,
+                            int level = kDefaultLevel);
+  ~CompressedWriter() override;
+
+  // Writer overrides:
+  void Seek(int64_t pos) override;
+  /// @return Position in the decompressed data.
+  int64_t Pos() const override;
+  void Write(void const * p, size_t size) override;
+
+  /// Writes the last block and the offsets of the blocks, nothing can be written after it.
+  void Finish();
+
+private:
+  DISALLOW_COPY_AND_MOVE(CompressedWriter);
+
+  void WriteBlock();
+
+  Writer & m_writer;
+  uint32_t const m_blockSize;
+  int const m_level;
+  uint64_t const m_start;
+
+  vector<char> m_block;
+  vector<char> m_compressed;
+  vector<uint64_t> m_offsets;
+  uint64_t m_rawSize = 0;
+  bool m_finished = false;
+};
+
+/// Process-wide cache of the decompressed blocks, it's registered in CacheGovernor.
+class BlockCache
+{
+public:
+  typedef shared_ptr<vector<char> const> TBlock;
+
+  static size_t const kDefaultMaxBytes = 8 * 1024 * 1024;
+
+  struct Stats
+  {
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+  };
+
+  explicit BlockCache(size_t maxBytes);
+  ~BlockCache();
+
+  static BlockCache & Instance();
+
+  /// @return Unique id of a section to keep its blocks.
+  uint64_t NewSectionId() { return ++m_lastSectionId; }
+
+  TBlock Find(uint64_t sectionId, uint32_t block);
+  void Add(uint64_t sectionId, uint32_t block, TBlock const & data);
+
+  void SetMaxBytes(size_t maxBytes);
+
+  /// Frees the share of the cached blocks, from 0 to 1.
+  void Trim(double share);
+  void Clear() { Trim(1.0); }
+
+  size_t GetBytes() const;
+  Stats GetStats() const;
+
+private:
+  DISALLOW_COPY_AND_MOVE(BlockCache);
+
+  typedef pair<uint64_t, uint32_t> TKey;
+
+  struct KeyHash
+  {
+    size_t operator()(TKey const & key) const
+    {
+      return hash<uint64_t>()(key.first) ^ (static_cast<size_t>(key.second) * 0x9E3779B9);
+    }
+  };
+
+  typedef list<pair<TKey, TBlock>> TLru;
+
+  /// Evicts the least recently used blocks until the cache fits maxBytes.
+  void EvictTo(size_t maxBytes);
+
+  mutable mutex m_mutex;
+  TLru m_lru;
+  unordered_map<TKey, TLru::iterator, KeyHash> m_index;
+  size_t m_bytes = 0;
+  size_t m_maxBytes;
+  Stats m_stats;
+  atomic<uint64_t> m_lastSectionId;
+
+  CacheGovernor::TCacheId m_governorId = CacheGovernor::kInvalidId;
+};
+
+/// Reader of the decompressed data of a compressed section. It's thread-safe when the reader
+/// of the compressed data is. The sub readers share the blocks in the cache, while the other
+/// readers of the same data don't, so a section should be opened once.
+class CompressedReader : public ModelReader
+{
+public:
+  /// @throw Reader::ReadException when reader has no compressed section.
+  explicit CompressedReader(ModelReaderPtr const & reader,
+                            BlockCache & cache = BlockCache::Instance());
+
+  // Reader overrides:
+  uint64_t Size() const override { return m_size; }
+  void Read(uint64_t pos, void * p, size_t size) const override;
+
+  // ModelReader overrides:
+  CompressedReader * CreateSubReader(uint64_t pos, uint64_t size) const override;
+
+  uint32_t GetBlockSize() const;
+  uint32_t GetBlocksCount() const;
+
+private:
+  struct Section;
+
+  CompressedReader(shared_ptr<Section const> const & section, uint64_t offset, uint64_t size);
+
+  BlockCache::TBlock GetBlock(uint32_t block) const;
+
+  shared_ptr<Section const> m_section;
+  uint64_t m_offset;
+  uint64_t m_size;
+};
+}  // namespace compressed_section
@@ -0,0 +1,176 @@
+#include "coding/container_diff.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/logging.hpp"
+#include "base/stl_add.hpp"
+
+#include "defines.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstring.hpp"
+#include "std/vector.hpp"
+
+namespace diff
+{
+namespace
+{
+uint8_t const kVersion = 1;
+
+// Operations with the sections of the new container.
+uint8_t const kCopySection = 0;
+uint8_t const kNewSection = 1;
+
+size_t const kCompareBufferSize = 64 * 1024;
+
+bool IsSameSection(FilesContainerR const & oldCont, FilesContainerR const & newCont,
+                   FilesContainerBase::Tag const & tag)
+{
+  if (!oldCont.IsExist(tag))
+    return false;
+
+  ModelReaderPtr const oldReader = oldCont.GetReader(tag);
+  ModelReaderPtr const newReader = newCont.GetReader(tag);
+  uint64_t const size = newReader.Size();
+  if (oldReader.Size() != size)
+    return false;
+
+  vector<char> oldBuffer(kCompareBufferSize);
+  vector<char> newBuffer(kCompareBufferSize);
+  for (uint64_t pos = 0; pos < size; pos += kCompareBufferSize)
+  {
+    size_t const count = static_cast<size_t>(min(static_cast<uint64_t>(kCompareBufferSize), size - pos));
+    oldReader.Read(pos, oldBuffer.data(), count);
+    newReader.Read(pos, newBuffer.data(), count);
+    if (memcmp(oldBuffer.data(), newBuffer.data(), count) != 0)
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
+bool MakeContainerDiff(string const & oldPath, string const & newPath, string const & diffPath)
+{
+  string const tmpPath = diffPath + EXTENSION_TMP;
+  try
+  {
+    FilesContainerR const oldCont(oldPath);
+    FilesContainerR const newCont(newPath);
+
+    vector<FilesContainerBase::Tag> tags;
+    newCont.ForEachTagByOffset(MakeBackInsertFunctor(tags));
+
+    {
+      FileWriter writer(tmpPath);
+      WriteToSink(writer, kVersion);
+      WriteVarUint(writer, oldCont.GetFileSize());
+      WriteVarUint(writer, newCont.GetFileSize());
+      WriteVarUint(writer, tags.size());
+
+      uint64_t copiedSize = 0;
+      for (FilesContainerBase::Tag const & tag : tags)
+      {
+        ModelReaderPtr const reader = newCont.GetReader(tag);
+        rw::Write(writer, tag);
+        if (IsSameSection(oldCont, newCont, tag))
+        {
+          WriteToSink(writer, kCopySection);
+          WriteVarUint(writer, reader.Size());
+          copiedSize += reader.Size();
+        }
+        else
+        {
+          WriteToSink(writer, kNewSection);
+          WriteVarUint(writer, reader.Size());
+          ReaderSource<ModelReaderPtr> src(reader);
+          rw::ReadAndWrite(src, writer);
+        }
+      }
+
+      LOG(LINFO, ("Diff of", newPath, "copies", copiedSize, "bytes of", newCont.GetFileSize(),
+                  "from", oldPath));
+    }
+
+    if (my::RenameFileX(tmpPath, diffPath))
+      return true;
+    LOG(LWARNING, ("Can't rename", tmpPath, "to", diffPath));
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Can't make diff of", oldPath, "and", newPath, e.Msg()));
+  }
+
+  (void)my::DeleteFileX(tmpPath);
+  return false;
+}
+
+bool ApplyContainerDiff(string const & oldPath, string const & diffPath, string const & newPath)
+{
+  string const tmpPath = newPath + EXTENSION_TMP;
+  try
+  {
+    FileReader diffReader(diffPath);
+    ReaderSource<FileReader> src(diffReader);
+
+    uint8_t const version = ReadPrimitiveFromSource<uint8_t>(src);
+    if (version != kVersion)
+      MYTHROW(RootException, ("Unknown diff version", static_cast<int>(version)));
+
+    uint64_t const oldSize = ReadVarUint<uint64_t>(src);
+    uint64_t const newSize = ReadVarUint<uint64_t>(src);
+
+    FilesContainerR const oldCont(oldPath);
+    if (oldCont.GetFileSize() != oldSize)
+      MYTHROW(RootException, ("Diff is made for another file"));
+
+    {
+      FilesContainerW newCont(tmpPath);
+      uint64_t const count = ReadVarUint<uint64_t>(src);
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        FilesContainerBase::Tag tag;
+        rw::Read(src, tag);
+        uint8_t const op = ReadPrimitiveFromSource<uint8_t>(src);
+        uint64_t const size = ReadVarUint<uint64_t>(src);
+
+        if (op == kCopySection)
+        {
+          ModelReaderPtr const reader = oldCont.GetReader(tag);
+          if (reader.Size() != size)
+            MYTHROW(RootException, ("Diff is made for another file, section", tag));
+          newCont.Write(reader, tag);
+        }
+        else if (op == kNewSection)
+        {
+          newCont.Write(ModelReaderPtr(diffReader.CreateSubReader(src.Pos(), size)), tag);
+          src.Skip(size);
+        }
+        else
+        {
+          MYTHROW(RootException, ("Unknown operation", static_cast<int>(op), "for section", tag));
+        }
+      }
+      newCont.Finish();
+    }
+
+    uint64_t size;
+    if (!my::GetFileSize(tmpPath, size) || size != newSize)
+      MYTHROW(RootException, ("Wrong size of the patched file"));
+
+    if (my::RenameFileX(tmpPath, newPath))
+      return true;
+    LOG(LWARNING, ("Can't rename", tmpPath, "to", newPath));
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Can't apply diff", diffPath, "to", oldPath, e.Msg()));
+  }
+
+  (void)my::DeleteFileX(tmpPath);
+  return false;
+}
+}  // namespace diff
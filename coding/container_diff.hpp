@@ -0,0 +1,20 @@
+#pragma once
+
+#include "std/string.hpp"
+
+namespace diff
+{
+/// Section level difference of two versions of a files container (e.g. mwm).
+/// Sections which are the same in both versions are copied from the old container
+/// when the diff is applied, the changed and the new ones are stored in the diff as is.
+///
+/// @return false when the containers can't be read or the diff can't be written.
+bool MakeContainerDiff(string const & oldPath, string const & newPath, string const & diffPath);
+
+/// Rebuilds the new container from the old one and the diff, sections are streamed one by one.
+/// The new container is the same as the one the diff was made from byte to byte.
+///
+/// @return false when the diff doesn't belong to the old container or on i/o errors,
+///         newPath isn't touched then.
+bool ApplyContainerDiff(string const & oldPath, string const & diffPath, string const & newPath);
+}  // namespace diff
@@ -1,10 +1,14 @@
 #include "base/SRC_FIRST.hpp"
 
 #include "coding/file_container.hpp"
+#include "coding/compressed_section.hpp"
 #include "coding/read_write_utils.hpp"
 #include "coding/write_to_sink.hpp"
 #include "coding/internal/file_data.hpp"
 
+#include "std/map.hpp"
+#include "std/mutex.hpp"
+
 #ifndef OMIM_OS_WINDOWS
   #include <unistd.h>
   #include <sys/mman.h>
@@ -61,16 +65,23 @@ void FilesContainerBase::ReadInfo(ReaderT & reader)
 // FilesContainerR
 /////////////////////////////////////////////////////////////////////////////
 
+struct FilesContainerR::CompressedSections
+{
+  mutex m_mutex;
+  map<Tag, ReaderT> m_readers;
+};
+
 FilesContainerR::FilesContainerR(string const & filePath,
                                  uint32_t logPageSize,
                                  uint32_t logPageCount)
-  : m_source(new FileReader(filePath, logPageSize, logPageCount))
+  : m_source(new FileReader(filePath, logPageSize, logPageCount)),
+    m_compressed(make_shared<CompressedSections>())
 {
   ReadInfo(m_source);
 }
 
 FilesContainerR::FilesContainerR(ReaderT const & file)
-  : m_source(file)
+  : m_source(file), m_compressed(make_shared<CompressedSections>())
 {
   ReadInfo(m_source);
 }
@@ -80,8 +91,27 @@ FilesContainerR::ReaderT FilesContainerR::GetReader(Tag const & tag) const
   Info const * p = GetInfo(tag);
   if (p)
     return m_source.SubReader(p->m_offset, p->m_size);
-  else
-    MYTHROW(Reader::OpenException, (tag));
+
+  p = GetInfo(tag + compressed_section::kTagSuffix);
+  if (p)
+  {
+    lock_guard<mutex> lock(m_compressed->m_mutex);
+    auto it = m_compressed->m_readers.find(tag);
+    if (it == m_compressed->m_readers.end())
+    {
+      ReaderT const reader(new compressed_section::CompressedReader(
+          m_source.SubReader(p->m_offset, p->m_size)));
+      it = m_compressed->m_readers.emplace(tag, reader).first;
+    }
+    return it->second.SubReader(0, it->second.Size());
+  }
+
+  MYTHROW(Reader::OpenException, (tag));
+}
+
+bool FilesContainerR::IsExist(Tag const & tag) const
+{
+  return GetInfo(tag) != 0 || GetInfo(tag + compressed_section::kTagSuffix) != 0;
 }
 
 FilesContainerBase::Info const * FilesContainerBase::GetInfo(Tag const & tag) const
@@ -152,7 +182,8 @@ void FilesMappingContainer::Close()
   m_name.clear();
 }
 
-FilesMappingContainer::Handle FilesMappingContainer::Map(Tag const & tag) const
+FilesMappingContainer::Handle FilesMappingContainer::Map(Tag const & tag,
+                                                         mmap_policy::TPolicy policy) const
 {
   Info const * p = GetInfo(tag);
   if (p)
@@ -176,10 +207,19 @@ FilesMappingContainer::Handle FilesMappingContainer::Map(Tag const & tag) const
     if (pMap == NULL)
       MYTHROW(Reader::OpenException, ("Can't map section:", tag, "with [offset, size]:", *p, "win last error:", GetLastError()));
 #else
-    void * pMap = mmap(0, length, PROT_READ, MAP_SHARED, m_fd, offset);
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (policy & mmap_policy::Populate)
+    {
+      flags |= MAP_POPULATE;
+      policy &= ~mmap_policy::Populate;
+    }
+#endif
+    void * pMap = mmap(0, length, PROT_READ, flags, m_fd, offset);
     if (pMap == MAP_FAILED)
       MYTHROW(Reader::OpenException, ("Can't map section:", tag, "with [offset, size]:", *p));
 #endif
+    mmap_policy::Apply(pMap, length, policy);
 
     char const * data = reinterpret_cast<char const *>(pMap);
     char const * d = data + (p->m_offset - offset);
@@ -398,6 +438,17 @@ void FilesContainerW::Write(vector<char> const & buffer, Tag const & tag)
     GetWriter(tag).Write(&buffer[0], buffer.size());
 }
 
+void FilesContainerW::WriteCompressed(Reader const & reader, Tag const & tag,
+                                      uint32_t blockSize, int level)
+{
+  // Sections of the writer are sorted by offsets, so they are looked for one by one.
+  if (find_if(m_info.begin(), m_info.end(), EqualTag(tag)) != m_info.end())
+    DeleteSection(tag);
+
+  FileWriter writer = GetWriter(tag + compressed_section::kTagSuffix);
+  compressed_section::Compress(reader, writer, blockSize, level);
+}
+
 void FilesContainerW::Finish()
 {
   ASSERT(!m_bFinished, ());
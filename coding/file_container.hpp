@@ -1,7 +1,10 @@
 #pragma once
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/mmap_policy.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/shared_ptr.hpp"
 #include "std/vector.hpp"
 #include "std/string.hpp"
 #include "std/noncopyable.hpp"
@@ -112,19 +115,37 @@ public:
                            uint32_t logPageCount = 10);
   explicit FilesContainerR(ReaderT const & file);
 
+  /// Reads the compressed section "tag" + compressed_section::kTagSuffix when there is
+  /// no raw one.
   ReaderT GetReader(Tag const & tag) const;
 
+  /// @return True when there is the raw or the compressed section.
+  bool IsExist(Tag const & tag) const;
+
   template <typename F> void ForEachTag(F f) const
   {
     for (size_t i = 0; i < m_info.size(); ++i)
       f(m_info[i].m_tag);
   }
 
+  /// Calls f(tag) in the order of the sections in the file.
+  template <typename F> void ForEachTagByOffset(F f) const
+  {
+    InfoContainer info(m_info);
+    sort(info.begin(), info.end(), LessOffset());
+    for (size_t i = 0; i < info.size(); ++i)
+      f(info[i].m_tag);
+  }
+
   inline uint64_t GetFileSize() const { return m_source.Size(); }
   inline string const & GetFileName() const { return m_source.GetName(); }
 
 private:
+  struct CompressedSections;
+
   ReaderT m_source;
+  /// Compressed sections are opened once, so all their readers share the cached blocks.
+  shared_ptr<CompressedSections> m_compressed;
 };
 
 class FilesMappingContainer : public FilesContainerBase
@@ -183,7 +204,8 @@ public:
     uint64_t m_origSize;
   };
 
-  Handle Map(Tag const & tag) const;
+  /// @param policy Access pattern of the section, see mmap_policy.hpp.
+  Handle Map(Tag const & tag, mmap_policy::TPolicy policy = mmap_policy::Default) const;
   FileReader GetReader(Tag const & tag) const;
 
   string const & GetName() const { return m_name; }
@@ -211,6 +233,10 @@ public:
   void Write(ModelReaderPtr reader, Tag const & tag);
   void Write(vector<char> const & buffer, Tag const & tag);
 
+  /// Writes the section compressed, see compressed_section.hpp. The raw section "tag"
+  /// is deleted when it exists.
+  void WriteCompressed(Reader const & reader, Tag const & tag, uint32_t blockSize, int level);
+
   void Finish();
 
   /// Delete section with rewriting file.
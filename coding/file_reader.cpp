@@ -1,10 +1,16 @@
 #include "coding/file_reader.hpp"
-#include "coding/reader_cache.hpp"
+#include "coding/shared_page_cache.hpp"
 #include "coding/internal/file_data.hpp"
 
-#ifndef LOG_FILE_READER_STATS
-#define LOG_FILE_READER_STATS 0
-#endif // LOG_FILE_READER_STATS
+#include "base/logging.hpp"
+
+#include "std/atomic.hpp"
+#include "std/sstream.hpp"
+#include "std/target_os.hpp"
+
+#if !defined(OMIM_OS_WINDOWS) && !defined(OMIM_OS_TIZEN)
+#include <sys/stat.h>
+#endif
 
 #if LOG_FILE_READER_STATS && !defined(LOG_FILE_READER_EVERY_N_READS_MASK)
 #define LOG_FILE_READER_EVERY_N_READS_MASK 0xFFFFFFFF
@@ -30,8 +36,10 @@ namespace
 class FileReader::FileReaderData
 {
 public:
-  FileReaderData(string const & fileName, uint32_t logPageSize, uint32_t logPageCount)
-    : m_FileData(fileName), m_ReaderCache(logPageSize, logPageCount)
+  FileReaderData(string const & fileName, uint32_t logPageSize)
+    : m_FileData(fileName),
+      m_CacheFile(SharedPageCache::Instance().Open(FileReader::GetFileKey(fileName, m_FileData.Size()),
+                                                   logPageSize))
   {
 #if LOG_FILE_READER_STATS
     m_ReadCallCount = 0;
@@ -41,7 +49,7 @@ public:
   ~FileReaderData()
   {
 #if LOG_FILE_READER_STATS
-    LOG(LINFO, ("FileReader", GetName(), m_ReaderCache.GetStatsStr()));
+    LOG(LINFO, ("FileReader", m_FileData.GetName(), SharedPageCache::Instance().GetStatsStr()));
 #endif
   }
 
@@ -52,28 +60,51 @@ public:
 #if LOG_FILE_READER_STATS
     if (((++m_ReadCallCount) & LOG_FILE_READER_EVERY_N_READS_MASK) == 0)
     {
-      LOG(LINFO, ("FileReader", GetName(), m_ReaderCache.GetStatsStr()));
+      LOG(LINFO, ("FileReader", m_FileData.GetName(), SharedPageCache::Instance().GetStatsStr()));
     }
 #endif
 
-    return m_ReaderCache.Read(m_FileData, pos, p, size);
+    SharedPageCache::Instance().Read(*m_CacheFile, m_FileData, m_FileData.Size(), pos, p, size);
   }
 
+  void Prefetch(uint64_t pos, uint64_t size) const { m_FileData.Prefetch(pos, size); }
+
 private:
   FileDataWithCachedSize m_FileData;
-  ReaderCache<FileDataWithCachedSize, LOG_FILE_READER_STATS> m_ReaderCache;
+  shared_ptr<SharedPageCache::File> m_CacheFile;
 
 #if LOG_FILE_READER_STATS
-  uint32_t m_ReadCallCount;
+  atomic<uint32_t> m_ReadCallCount;
 #endif
 };
 
-FileReader::FileReader(string const & fileName, uint32_t logPageSize, uint32_t logPageCount)
-  : base_type(fileName), m_pFileData(new FileReaderData(fileName, logPageSize, logPageCount)),
+FileReader::FileReader(string const & fileName, uint32_t logPageSize,
+                       uint32_t /* logPageCount */)
+  : base_type(fileName), m_pFileData(new FileReaderData(fileName, logPageSize)),
   m_Offset(0), m_Size(m_pFileData->Size())
 {
 }
 
+// static
+string FileReader::GetFileKey(string const & fileName, uint64_t size)
+{
+  ostringstream key;
+  key << fileName << ':' << size;
+#if !defined(OMIM_OS_WINDOWS) && !defined(OMIM_OS_TIZEN)
+  struct stat s;
+  if (stat(fileName.c_str(), &s) == 0)
+  {
+    key << ':' << s.st_dev << ':' << s.st_ino << ':' << s.st_mtime;
+#if defined(OMIM_OS_MAC) || defined(OMIM_OS_IPHONE)
+    key << '.' << s.st_mtimespec.tv_nsec;
+#elif defined(OMIM_OS_LINUX)
+    key << '.' << s.st_mtim.tv_nsec;
+#endif
+  }
+#endif
+  return key.str();
+}
+
 FileReader::FileReader(FileReader const & reader, uint64_t offset, uint64_t size)
   : base_type(reader.GetName()), m_pFileData(reader.m_pFileData), m_Offset(offset), m_Size(size)
 {
@@ -90,6 +121,12 @@ void FileReader::Read(uint64_t pos, void * p, size_t size) const
   m_pFileData->Read(m_Offset + pos, p, size);
 }
 
+void FileReader::Prefetch(uint64_t pos, uint64_t size) const
+{
+  ASSERT ( AssertPosAndSize(pos, size), () );
+  m_pFileData->Prefetch(m_Offset + pos, size);
+}
+
 FileReader FileReader::SubReader(uint64_t pos, uint64_t size) const
 {
   ASSERT ( AssertPosAndSize(pos, size), () );
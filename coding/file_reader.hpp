@@ -3,14 +3,18 @@
 #include "base/base.hpp"
 #include "std/shared_ptr.hpp"
 
-// FileReader, cheap to copy, not thread safe.
+// FileReader, cheap to copy, thread safe.
 // It is assumed that file is not modified during FireReader lifetime,
 // because of caching and assumption that Size() is constant.
+// Pages of the file are cached in SharedPageCache, they are shared with the other readers
+// of the file.
 class FileReader : public ModelReader
 {
   typedef ModelReader base_type;
 
 public:
+  /// @param logPageCount Isn't used, the total size of the cached pages is limited by
+  /// SharedPageCache::SetMaxBytes.
   explicit FileReader(string const & fileName,
                       uint32_t logPageSize = 10,
                       uint32_t logPageCount = 4);
@@ -19,9 +23,15 @@ public:
 
   uint64_t Size() const;
   void Read(uint64_t pos, void * p, size_t size) const;
+  /// Reads ahead the file pages to the OS cache (posix_fadvise on POSIX).
+  void Prefetch(uint64_t pos, uint64_t size) const override;
   FileReader SubReader(uint64_t pos, uint64_t size) const;
   FileReader * CreateSubReader(uint64_t pos, uint64_t size) const;
 
+  /// @return Key of the file of the size, the file replaced by another one with the same name
+  /// gets a new key.
+  static string GetFileKey(string const & fileName, uint64_t size);
+
 protected:
   /// Make assertion that pos + size in FileReader bounds.
   bool AssertPosAndSize(uint64_t pos, uint64_t size) const;
@@ -0,0 +1,95 @@
+#include "coding/file_sort.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+
+#include "zlib.h"
+
+namespace file_sort
+{
+void WriteRunBlock(FileWriter & writer, void const * data, size_t size, bool compress,
+                   vector<char> & buffer)
+{
+  ASSERT_LESS_OR_EQUAL(size, kRunBlockBytes, ());
+  uint32_t storedSize = static_cast<uint32_t>(size);
+  if (compress)
+  {
+    buffer.resize(compressBound(size));
+    uLongf compressedSize = buffer.size();
+    int const res = compress2(reinterpret_cast<Bytef *>(buffer.data()), &compressedSize,
+                              static_cast<Bytef const *>(data), size, Z_BEST_SPEED);
+    CHECK_EQUAL(res, Z_OK, ("Can't compress a block of", size, "bytes."));
+    // The block is kept as is when it can't be compressed.
+    if (compressedSize < size)
+    {
+      storedSize = static_cast<uint32_t>(compressedSize);
+      data = buffer.data();
+    }
+  }
+
+  WriteToSink(writer, static_cast<uint32_t>(size));
+  WriteToSink(writer, storedSize);
+  writer.Write(data, storedSize);
+}
+
+uint64_t ReadRunBlock(FileReader const & reader, uint64_t pos, vector<char> & block,
+                      vector<char> & buffer)
+{
+  uint32_t const size = ReadPrimitiveFromPos<uint32_t>(reader, pos);
+  uint32_t const storedSize = ReadPrimitiveFromPos<uint32_t>(reader, pos + sizeof(uint32_t));
+  pos += 2 * sizeof(uint32_t);
+
+  block.resize(size);
+  if (storedSize == size)
+  {
+    reader.Read(pos, block.data(), size);
+  }
+  else
+  {
+    buffer.resize(storedSize);
+    reader.Read(pos, buffer.data(), storedSize);
+    uLongf uncompressedSize = size;
+    int const res = uncompress(reinterpret_cast<Bytef *>(block.data()), &uncompressedSize,
+                               reinterpret_cast<Bytef const *>(buffer.data()), storedSize);
+    CHECK(res == Z_OK && uncompressedSize == size, ("Corrupted block of the sorted run.", res));
+  }
+  return pos + storedSize;
+}
+
+BackgroundTask::~BackgroundTask()
+{
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+void BackgroundTask::Start(function<void()> && fn)
+{
+  Wait();
+  m_thread = thread([this](function<void()> const & fn)
+  {
+    try
+    {
+      fn();
+    }
+    catch (...)
+    {
+      m_exception = current_exception();
+    }
+  }, move(fn));
+}
+
+void BackgroundTask::Wait()
+{
+  if (m_thread.joinable())
+    m_thread.join();
+
+  if (m_exception)
+  {
+    exception_ptr e;
+    swap(e, m_exception);
+    rethrow_exception(e);
+  }
+}
+}  // namespace file_sort
@@ -6,13 +6,53 @@
 #include "base/exception.hpp"
 #include "std/algorithm.hpp"
 #include "std/cstdlib.hpp"
+#include "std/cstring.hpp"
+#include "std/exception.hpp"
+#include "std/function.hpp"
 #include "std/functional.hpp"
 #include "std/queue.hpp"
+#include "std/thread.hpp"
 #include "std/unique_ptr.hpp"
 #include "std/string.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
 
+namespace file_sort
+{
+/// Size of the blocks the sorted runs are written by.
+size_t constexpr kRunBlockBytes = 64 * 1024;
+/// Size of the batches the merged items are passed to the output sink by.
+size_t constexpr kOutputBatchBytes = 1024 * 1024;
+
+/// Writes the block of the run, it's compressed when compress is true and it pays off.
+void WriteRunBlock(FileWriter & writer, void const * data, size_t size, bool compress,
+                   vector<char> & buffer);
+
+/// Reads the block written by WriteRunBlock at pos.
+/// @return Position of the next block.
+uint64_t ReadRunBlock(FileReader const & reader, uint64_t pos, vector<char> & block,
+                      vector<char> & buffer);
+
+/// Runs a function on a background thread. An exception thrown by the function
+/// is rethrown by Wait().
+class BackgroundTask
+{
+public:
+  BackgroundTask() = default;
+  ~BackgroundTask();
+
+  /// Waits for the previous function.
+  void Start(function<void()> && fn);
+  void Wait();
+
+private:
+  thread m_thread;
+  exception_ptr m_exception;
+
+  DISALLOW_COPY_AND_MOVE(BackgroundTask);
+};
+}  // namespace file_sort
+
 template <typename LessT>
 struct Sorter
 {
@@ -24,6 +64,13 @@ struct Sorter
   }
 };
 
+/// FileSorter sorts the items which don't fit in memory: sorted runs of bufferBytes are written
+/// to the tmp file and merged to the output sink.
+/// When threadsCount > 1 a run is sorted by threadsCount threads while the next run is collected,
+/// the items are merged while the output sink consumes the previous batch of items. Then two
+/// buffers are in use and each of them takes a half of bufferBytes.
+/// When compressRuns is true the runs are compressed, it saves disk space and IO for the items
+/// with long common prefixes.
 template <
     typename T,                                       // Item type.
     class OutputSinkT = FileWriter,                   // Sink to output into result file.
@@ -36,9 +83,13 @@ public:
   FileSorter(size_t bufferBytes,
              string const & tmpFileName,
              OutputSinkT & outputSink,
-             LessT fLess = LessT()) :
+             LessT fLess = LessT(),
+             size_t threadsCount = 1,
+             bool compressRuns = false) :
   m_TmpFileName(tmpFileName),
-  m_BufferCapacity(max(size_t(16), bufferBytes / sizeof(T))),
+  m_ThreadsCount(max(threadsCount, size_t(1))),
+  m_BufferCapacity(max(size_t(16), bufferBytes / sizeof(T) / (m_ThreadsCount > 1 ? 2 : 1))),
+  m_CompressRuns(compressRuns),
   m_OutputSink(outputSink),
   m_ItemCount(0),
   m_Less(fLess)
@@ -59,25 +110,33 @@ public:
   {
     ASSERT(m_pTmpWriter.get(), ());
     FlushToTmpFile();
+    m_FlushTask.Wait();
 
     // Write output.
     {
       m_pTmpWriter.reset();
       FileReader reader(m_TmpFileName);
+      vector<RunReader> runs;
+      runs.reserve(m_Runs.size());
+      for (auto const & run : m_Runs)
+        runs.emplace_back(reader, run.first, run.second);
+
       ItemIndexPairGreater fGreater(m_Less);
       PriorityQueueType q(fGreater);
-      for (uint32_t i = 0; i < m_ItemCount; i += m_BufferCapacity)
-        Push(q, i, reader);
+      for (uint32_t i = 0; i < runs.size(); ++i)
+        Push(q, i, runs);
 
+      OutputBuffer output(m_OutputSink, m_ThreadsCount > 1);
       while (!q.empty())
       {
-        m_OutputSink(q.top().first);
-        uint32_t const i = q.top().second + 1;
+        output.Add(q.top().first);
+        uint32_t const i = q.top().second;
         q.pop();
-        if (i % m_BufferCapacity != 0 && i < m_ItemCount)
-          Push(q, i, reader);
+        Push(q, i, runs);
       }
+      output.Finish();
     }
+    m_Runs.clear();
     FileWriter::DeleteFileX(m_TmpFileName);
   }
 
@@ -114,28 +173,202 @@ private:
   typedef priority_queue<pair<T, uint32_t>, vector<pair<T, uint32_t> >, ItemIndexPairGreater>
       PriorityQueueType;
 
+  /// Reads items of the run [begin, end) of the tmp file block by block.
+  class RunReader
+  {
+  public:
+    RunReader(FileReader const & reader, uint64_t begin, uint64_t end)
+      : m_reader(reader), m_pos(begin), m_end(end), m_offset(0)
+    {
+    }
+
+    bool Next(T & item)
+    {
+      if (m_offset == m_block.size())
+      {
+        if (m_pos == m_end)
+          return false;
+        m_pos = file_sort::ReadRunBlock(m_reader, m_pos, m_block, m_buffer);
+        m_offset = 0;
+        ASSERT_LESS_OR_EQUAL(m_pos, m_end, ());
+        ASSERT_EQUAL(m_block.size() % sizeof(T), 0, ());
+      }
+      memcpy(&item, &m_block[m_offset], sizeof(T));
+      m_offset += sizeof(T);
+      return true;
+    }
+
+  private:
+    FileReader const & m_reader;
+    uint64_t m_pos;
+    uint64_t m_end;
+    vector<char> m_block;
+    size_t m_offset;
+    vector<char> m_buffer;
+  };
+
+  /// Passes the items to the sink by batches, the sink consumes a batch on a background thread
+  /// while the next batch is collected if async is true.
+  class OutputBuffer
+  {
+  public:
+    OutputBuffer(OutputSinkT & sink, bool async)
+      : m_sink(sink), m_async(async), m_capacity(max(size_t(1), file_sort::kOutputBatchBytes / sizeof(T)))
+    {
+      if (m_async)
+        m_batch.reserve(m_capacity);
+    }
+
+    void Add(T const & item)
+    {
+      if (!m_async)
+      {
+        m_sink(item);
+        return;
+      }
+      m_batch.push_back(item);
+      if (m_batch.size() == m_capacity)
+        Flush();
+    }
+
+    void Finish()
+    {
+      if (m_async)
+      {
+        Flush();
+        m_task.Wait();
+      }
+    }
+
+  private:
+    void Flush()
+    {
+      m_task.Wait();
+      m_batch.swap(m_writtenBatch);
+      m_batch.clear();
+      m_task.Start([this]()
+      {
+        for (T const & item : m_writtenBatch)
+          m_sink(item);
+      });
+    }
+
+    OutputSinkT & m_sink;
+    bool const m_async;
+    size_t const m_capacity;
+    vector<T> m_batch;
+    vector<T> m_writtenBatch;
+    file_sort::BackgroundTask m_task;
+  };
+
   void FlushToTmpFile()
   {
     if (m_Buffer.empty())
       return;
-    SorterT<LessT> sorter(m_Less);
-    sorter(m_Buffer.begin(), m_Buffer.end());
-    m_pTmpWriter->Write(&m_Buffer[0], m_Buffer.size() * sizeof(T));
+
+    if (m_ThreadsCount == 1)
+    {
+      SortAndWriteRun(m_Buffer);
+      m_Buffer.clear();
+      return;
+    }
+
+    // The previous run is sorted and written while the next one is collected.
+    m_FlushTask.Wait();
+    m_Buffer.swap(m_FlushBuffer);
     m_Buffer.clear();
+    m_Buffer.reserve(m_BufferCapacity);
+    m_FlushTask.Start([this]()
+    {
+      SortAndWriteRun(m_FlushBuffer);
+    });
   }
 
-  void Push(PriorityQueueType & q, uint32_t i, FileReader const & reader)
+  void SortAndWriteRun(vector<T> & buffer)
+  {
+    Sort(buffer);
+
+    uint64_t const begin = m_pTmpWriter->Pos();
+    size_t const blockItems = max(size_t(1), file_sort::kRunBlockBytes / sizeof(T));
+    for (size_t i = 0; i < buffer.size(); i += blockItems)
+    {
+      size_t const count = min(blockItems, buffer.size() - i);
+      file_sort::WriteRunBlock(*m_pTmpWriter, &buffer[i], count * sizeof(T), m_CompressRuns,
+                               m_CompressBuffer);
+    }
+    m_Runs.emplace_back(begin, m_pTmpWriter->Pos());
+  }
+
+  /// Sorts parts of the buffer on m_ThreadsCount threads and merges them.
+  void Sort(vector<T> & buffer) const
+  {
+    SorterT<LessT> sorter(m_Less);
+    size_t const partsCount = min(m_ThreadsCount, buffer.size());
+    if (partsCount <= 1)
+    {
+      sorter(buffer.begin(), buffer.end());
+      return;
+    }
+
+    vector<size_t> bounds(partsCount + 1);
+    for (size_t i = 0; i <= partsCount; ++i)
+      bounds[i] = buffer.size() * i / partsCount;
+
+    typedef typename vector<T>::iterator IterT;
+    IterT const begin = buffer.begin();
+    {
+      vector<thread> threads;
+      for (size_t i = 1; i < partsCount; ++i)
+        threads.emplace_back([&sorter, begin, &bounds, i]()
+        {
+          sorter(begin + bounds[i], begin + bounds[i + 1]);
+        });
+      sorter(begin + bounds[0], begin + bounds[1]);
+      for (auto & t : threads)
+        t.join();
+    }
+
+    // Neighbouring parts are merged pairwise until one part is left.
+    LessT const & fLess = m_Less;
+    for (size_t step = 1; step < partsCount; step *= 2)
+    {
+      vector<thread> threads;
+      for (size_t i = 0; i + step < partsCount; i += 2 * step)
+      {
+        IterT const first = begin + bounds[i];
+        IterT const middle = begin + bounds[i + step];
+        IterT const last = begin + bounds[min(i + 2 * step, partsCount)];
+        threads.emplace_back([first, middle, last, &fLess]()
+        {
+          inplace_merge(first, middle, last, fLess);
+        });
+      }
+      for (auto & t : threads)
+        t.join();
+    }
+  }
+
+  void Push(PriorityQueueType & q, uint32_t i, vector<RunReader> & runs)
   {
     T item;
-    reader.Read(static_cast<uint64_t>(i) * sizeof(T), &item, sizeof(T));
-    q.push(pair<T, uint32_t>(item, i));
+    if (runs[i].Next(item))
+      q.push(pair<T, uint32_t>(item, i));
   }
 
   string const m_TmpFileName;
+  size_t const m_ThreadsCount;
   size_t const m_BufferCapacity;
+  bool const m_CompressRuns;
   OutputSinkT & m_OutputSink;
   unique_ptr<FileWriter> m_pTmpWriter;
   vector<T> m_Buffer;
   uint32_t m_ItemCount;
   LessT m_Less;
+
+  // [begin, end) offsets of the sorted runs in the tmp file.
+  vector<pair<uint64_t, uint64_t>> m_Runs;
+  vector<T> m_FlushBuffer;
+  vector<char> m_CompressBuffer;
+  // It's the last member to be destroyed before the buffers it uses.
+  file_sort::BackgroundTask m_FlushTask;
 };
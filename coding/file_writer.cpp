@@ -68,6 +68,11 @@ void FileWriter::Reserve(uint64_t size)
   }
 }
 
+void FileWriter::Preallocate(uint64_t size)
+{
+  m_pFileData->Preallocate(size);
+}
+
 void FileWriter::DeleteFileX(string const & fName)
 {
   (void)my::DeleteFileX(fName);
@@ -44,6 +44,10 @@ public:
 
   void Reserve(uint64_t size);
 
+  /// Reserves the disk space for size bytes without changing the file size, so the big file
+  /// isn't fragmented. It's only a hint, it does nothing where it's not supported.
+  void Preallocate(uint64_t size);
+
   static void DeleteFileX(string const & fName);
 
   string const & GetName() const;
@@ -6,8 +6,11 @@
 
 #include "base/exception.hpp"
 #include "base/logging.hpp"
+#include "base/macros.hpp"
 
+#include "std/algorithm.hpp"
 #include "std/cerrno.hpp"
+#include "std/limits.hpp"
 #include "std/cstring.hpp"
 #include "std/exception.hpp"
 #include "std/fstream.hpp"
@@ -15,6 +18,9 @@
 
 #ifdef OMIM_OS_WINDOWS
   #include <io.h>
+#elif !defined(OMIM_OS_TIZEN)
+  #include <fcntl.h>
+  #include <unistd.h>
 #endif
 
 #ifdef OMIM_OS_TIZEN
@@ -134,6 +140,47 @@ void FileData::Read(uint64_t pos, void * p, size_t size)
 #endif
 }
 
+void FileData::ReadAt(uint64_t pos, void * p, size_t size) const
+{
+#if defined(OMIM_OS_WINDOWS) || defined(OMIM_OS_TIZEN)
+  lock_guard<mutex> lock(m_readMutex);
+  const_cast<FileData *>(this)->Read(pos, p, size);
+#else
+  int const fd = fileno(m_File);
+  char * dst = static_cast<char *>(p);
+  size_t bytesRead = 0;
+  while (bytesRead < size)
+  {
+#ifdef OMIM_OS_ANDROID
+    ssize_t const res = pread64(fd, dst + bytesRead, size - bytesRead, pos + bytesRead);
+#else
+    ssize_t const res = pread(fd, dst + bytesRead, size - bytesRead, pos + bytesRead);
+#endif
+    if (res < 0 && errno == EINTR)
+      continue;
+    if (res <= 0)
+      MYTHROW(Reader::ReadException, (GetErrorProlog(), bytesRead, pos, size));
+    bytesRead += static_cast<size_t>(res);
+  }
+#endif
+}
+
+void FileData::Prefetch(uint64_t pos, uint64_t size) const
+{
+#if defined(OMIM_OS_LINUX) || defined(OMIM_OS_ANDROID)
+  // It's only a hint, errors are ignored.
+  UNUSED_VALUE(posix_fadvise(fileno(m_File), pos, size, POSIX_FADV_WILLNEED));
+#elif defined(OMIM_OS_MAC) || defined(OMIM_OS_IPHONE)
+  radvisory advisory;
+  advisory.ra_offset = static_cast<off_t>(pos);
+  advisory.ra_count = static_cast<int>(min(size, static_cast<uint64_t>(numeric_limits<int>::max())));
+  UNUSED_VALUE(fcntl(fileno(m_File), F_RDADVISE, &advisory));
+#else
+  UNUSED_VALUE(pos);
+  UNUSED_VALUE(size);
+#endif
+}
+
 uint64_t FileData::Pos() const
 {
 #ifdef OMIM_OS_TIZEN
@@ -178,6 +225,16 @@ void FileData::Write(void const * p, size_t size)
 #endif
 }
 
+void FileData::Preallocate(uint64_t size)
+{
+#if defined(OMIM_OS_LINUX)
+  // It's only a hint, errors are ignored.
+  UNUSED_VALUE(fallocate(fileno(m_File), FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)));
+#else
+  UNUSED_VALUE(size);
+#endif
+}
+
 void FileData::Flush()
 {
 #ifdef OMIM_OS_TIZEN
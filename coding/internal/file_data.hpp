@@ -3,6 +3,7 @@
 
 #include "base/base.hpp"
 
+#include "std/mutex.hpp"
 #include "std/string.hpp"
 #include "std/target_os.hpp"
 #include "std/noncopyable.hpp"
@@ -35,7 +36,14 @@ public:
   void Seek(uint64_t pos);
 
   void Read(uint64_t pos, void * p, size_t size);
+  /// Thread-safe version of Read which doesn't change the position of the file,
+  /// it's pread on POSIX systems.
+  void ReadAt(uint64_t pos, void * p, size_t size) const;
+  /// Asks the OS to read ahead [pos, pos + size), it does nothing where it's not supported.
+  void Prefetch(uint64_t pos, uint64_t size) const;
   void Write(void const * p, size_t size);
+  /// @see FileWriter::Preallocate.
+  void Preallocate(uint64_t size);
 
   void Flush();
   void Truncate(uint64_t sz);
@@ -52,6 +60,11 @@ private:
   string m_FileName;
   Op m_Op;
 
+#if defined(OMIM_OS_WINDOWS) || defined(OMIM_OS_TIZEN)
+  // Guards Seek and Read in ReadAt.
+  mutable mutex m_readMutex;
+#endif
+
   string GetErrorProlog() const;
 };
 
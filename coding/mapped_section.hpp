@@ -0,0 +1,65 @@
+#pragma once
+
+#include "coding/byte_stream.hpp"
+#include "coding/mmap_policy.hpp"
+#include "coding/mmap_reader.hpp"
+#include "coding/reader.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/cstdint.hpp"
+
+
+/// Read-only view of a section of the memory mapped file, the decoders work in place on
+/// the mapped memory without intermediate buffers. The view is empty when the reader isn't
+/// memory mapped, then the data should be read through the reader.
+class MappedSection
+{
+public:
+  MappedSection() : m_reader(nullptr) {}
+
+  explicit MappedSection(ModelReaderPtr const & reader)
+    : m_reader(reader), m_data(GetData(reader)), m_size(m_data ? reader.Size() : 0)
+  {
+  }
+
+  bool IsMapped() const { return m_data != nullptr; }
+
+  uint8_t const * Data() const { return m_data; }
+  uint64_t Size() const { return m_size; }
+
+  ArrayByteSource GetSource(uint64_t pos) const
+  {
+    ASSERT(IsMapped(), ());
+    ASSERT_LESS_OR_EQUAL(pos, m_size, ());
+    return ArrayByteSource(m_data + pos);
+  }
+
+  /// Hints that [pos, pos + size) of the section is going to be read soon.
+  void Prefetch(uint64_t pos, uint64_t size) const
+  {
+    ASSERT_LESS_OR_EQUAL(pos + size, m_size, ());
+    m_reader.Prefetch(pos, size);
+  }
+
+  /// Sets the access pattern of the section, see mmap_policy.hpp. Does nothing when the section
+  /// isn't mapped. The policy lasts while the file is mapped.
+  void Advise(mmap_policy::TPolicy policy) const
+  {
+    if (IsMapped())
+      mmap_policy::Apply(m_data, m_size, policy);
+  }
+
+  /// @return Pointer to the reader's data when it's memory mapped, nullptr otherwise.
+  static uint8_t const * GetData(ModelReaderPtr const & reader)
+  {
+    MmapReader const * p = dynamic_cast<MmapReader const *>(reader.GetPtr());
+    return (p ? p->Data() : nullptr);
+  }
+
+private:
+  // Keeps the mapping alive.
+  ModelReaderPtr m_reader;
+  uint8_t const * m_data = nullptr;
+  uint64_t m_size = 0;
+};
@@ -0,0 +1,136 @@
+#include "coding/mmap_policy.hpp"
+
+#include "base/macros.hpp"
+#include "base/string_utils.hpp"
+
+#include "std/map.hpp"
+#include "std/mutex.hpp"
+#include "std/target_os.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+#ifndef OMIM_OS_WINDOWS
+  #include <unistd.h>
+  #include <sys/mman.h>
+#endif
+
+namespace mmap_policy
+{
+namespace
+{
+pair<char const *, TPolicy> const kNames[] = {{"random", Random},
+                                              {"sequential", Sequential},
+                                              {"willneed", WillNeed},
+                                              {"hugepages", HugePages},
+                                              {"populate", Populate}};
+
+mutex g_overridesMutex;
+map<string, TPolicy> g_overrides;
+
+#ifndef OMIM_OS_WINDOWS
+void Advise(uint8_t * begin, size_t size, int advice)
+{
+  UNUSED_VALUE(madvise(begin, size, advice));
+}
+#endif
+}  // namespace
+
+void Apply(void const * data, uint64_t size, TPolicy policy)
+{
+#ifndef OMIM_OS_WINDOWS
+  if (policy == Default || size == 0)
+    return;
+
+  // madvise needs the address aligned to the page size.
+  uintptr_t const pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  uintptr_t const address = reinterpret_cast<uintptr_t>(data);
+  uint8_t * begin = reinterpret_cast<uint8_t *>(address - address % pageSize);
+  size_t const length = static_cast<size_t>(address + size - reinterpret_cast<uintptr_t>(begin));
+
+  if (policy & Random)
+    Advise(begin, length, MADV_RANDOM);
+  if (policy & Sequential)
+    Advise(begin, length, MADV_SEQUENTIAL);
+  if (policy & WillNeed)
+    Advise(begin, length, MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+  if (policy & HugePages)
+    Advise(begin, length, MADV_HUGEPAGE);
+#endif
+  if (policy & Populate)
+  {
+    // Each page is touched, as MAP_POPULATE does for the whole mapping.
+    uint8_t volatile const * p = begin;
+    uint8_t sum = 0;
+    for (size_t offset = 0; offset < length; offset += pageSize)
+      sum += p[offset];
+    UNUSED_VALUE(sum);
+  }
+#else
+  UNUSED_VALUE(data);
+  UNUSED_VALUE(size);
+  UNUSED_VALUE(policy);
+#endif
+}
+
+TPolicy Get(string const & tag, TPolicy defaultPolicy)
+{
+  lock_guard<mutex> lock(g_overridesMutex);
+  auto const it = g_overrides.find(tag);
+  return it == g_overrides.end() ? defaultPolicy : it->second;
+}
+
+bool SetOverrides(string const & overrides)
+{
+  map<string, TPolicy> parsed;
+  bool ok = true;
+  strings::Tokenize(overrides, ",", [&](string const & item)
+  {
+    size_t const eq = item.find('=');
+    if (eq == string::npos || eq == 0)
+    {
+      ok = false;
+      return;
+    }
+
+    TPolicy policy = Default;
+    strings::Tokenize(item.substr(eq + 1), "+", [&](string const & name)
+    {
+      if (name == "default")
+        return;
+      for (auto const & p : kNames)
+      {
+        if (name == p.first)
+        {
+          policy |= p.second;
+          return;
+        }
+      }
+      ok = false;
+    });
+    parsed[item.substr(0, eq)] = policy;
+  });
+
+  if (!ok)
+    return false;
+
+  lock_guard<mutex> lock(g_overridesMutex);
+  g_overrides.swap(parsed);
+  return true;
+}
+
+string ToString(TPolicy policy)
+{
+  string res;
+  for (auto const & p : kNames)
+  {
+    if (policy & p.second)
+    {
+      if (!res.empty())
+        res += '+';
+      res += p.first;
+    }
+  }
+  return res.empty() ? "default" : res;
+}
+}  // namespace mmap_policy
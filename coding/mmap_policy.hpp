@@ -0,0 +1,41 @@
+#pragma once
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+
+/// Hints to the kernel on the access pattern of the mapped memory. The callers which know how
+/// a section is read set its policy, the flags are combined by |. The hints are best effort:
+/// the errors are ignored and the kernel may ignore the hints.
+namespace mmap_policy
+{
+enum Flags : uint32_t
+{
+  Default = 0,
+  /// No readahead, for the data which is read at random, e.g. search tries and routing matrices.
+  Random = 1 << 0,
+  /// Aggressive readahead, for the data which is read from the start to the end.
+  Sequential = 1 << 1,
+  /// Starts to read the pages in the background.
+  WillNeed = 1 << 2,
+  /// Transparent huge pages, fewer TLB misses on the random reads of the big sections.
+  /// Linux only, for the file mappings it needs CONFIG_READ_ONLY_THP_FOR_FS.
+  HugePages = 1 << 3,
+  /// Reads all the pages at once, so the first reads don't fault, for the small hot sections.
+  Populate = 1 << 4
+};
+
+typedef uint32_t TPolicy;
+
+/// Applies the policy to [data, data + size) of a mapping, the range is widened to the pages.
+void Apply(void const * data, uint64_t size, TPolicy policy);
+
+/// @return Policy of the section: the one which is set by SetOverrides() or defaultPolicy.
+TPolicy Get(string const & tag, TPolicy defaultPolicy);
+
+/// Overrides the policies of the sections set by the callers, for the benchmarks.
+/// @param overrides Like "sdx=random+hugepages,mercedes=populate", "default" clears the flags.
+/// @return False when overrides can't be parsed, the overrides aren't changed then.
+bool SetOverrides(string const & overrides);
+
+string ToString(TPolicy policy);
+}  // namespace mmap_policy
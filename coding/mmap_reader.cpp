@@ -1,4 +1,7 @@
 #include "coding/mmap_reader.hpp"
+#include "coding/mmap_policy.hpp"
+
+#include "base/macros.hpp"
 
 #include "std/target_os.hpp"
 #include "std/cstring.hpp"
@@ -85,9 +88,15 @@ MmapReader * MmapReader::CreateSubReader(uint64_t pos, uint64_t size) const
   return new MmapReader(*this, m_offset + pos, size);
 }
 
+void MmapReader::Prefetch(uint64_t pos, uint64_t size) const
+{
+  ASSERT_LESS_OR_EQUAL(pos + size, Size(), (pos, size));
+  mmap_policy::Apply(m_data->m_memory + m_offset + pos, size, mmap_policy::WillNeed);
+}
+
 uint8_t * MmapReader::Data() const
 {
-  return m_data->m_memory;
+  return m_data->m_memory + m_offset;
 }
 
 void MmapReader::SetOffsetAndSize(uint64_t offset, uint64_t size)
@@ -22,8 +22,10 @@ public:
   virtual uint64_t Size() const;
   virtual void Read(uint64_t pos, void * p, size_t size) const;
   virtual MmapReader * CreateSubReader(uint64_t pos, uint64_t size) const;
+  /// madvise(MADV_WILLNEED) for the pages of the range.
+  void Prefetch(uint64_t pos, uint64_t size) const override;
 
-  /// Direct file/memory access
+  /// Direct file/memory access, points to the beginning of this (sub)reader.
   uint8_t * Data() const;
 
 protected:
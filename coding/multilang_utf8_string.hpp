@@ -1,10 +1,13 @@
 #pragma once
 
+#include "coding/byte_huffman.hpp"
 #include "coding/varint.hpp"
 
 #include "base/assert.hpp"
+#include "base/buffer_vector.hpp"
 
 #include "std/string.hpp"
+#include "std/vector.hpp"
 
 
 namespace utils
@@ -94,6 +97,36 @@ public:
   {
     utils::ReadString(src, m_s);
   }
+
+  /// @name Strings compressed by the code of the mwm, see version::v6.
+  //@{
+  void AddFrequencies(coding::ByteHuffmanCoder::TFrequencies & freqs) const
+  {
+    coding::ByteHuffmanCoder::AddFrequencies(m_s, freqs);
+  }
+
+  template <class TSink> void Write(TSink & sink, coding::ByteHuffmanCoder const & coder) const
+  {
+    CHECK(!m_s.empty(), ());
+
+    vector<uint8_t> encoded;
+    coder.Encode(m_s, encoded);
+    WriteVarUint(sink, static_cast<uint32_t>(m_s.size() - 1));
+    WriteVarUint(sink, static_cast<uint32_t>(encoded.size()));
+    sink.Write(encoded.data(), encoded.size());
+  }
+
+  /// The string is empty when the data can't be decoded.
+  template <class TSource> void Read(TSource & src, coding::ByteHuffmanCoder const & coder)
+  {
+    uint32_t const sz = ReadVarUint<uint32_t>(src) + 1;
+    uint32_t const encodedSize = ReadVarUint<uint32_t>(src);
+    buffer_vector<uint8_t, 128> encoded(encodedSize);
+    src.Read(encoded.data(), encodedSize);
+    if (!coder.Decode(encoded.data(), encoded.size(), sz, m_s))
+      m_s.clear();
+  }
+  //@}
 };
 
 string DebugPrint(StringUtf8Multilang const & s);
@@ -24,6 +24,10 @@ public:
   virtual void Read(uint64_t pos, void * p, size_t size) const = 0;
   virtual Reader * CreateSubReader(uint64_t pos, uint64_t size) const = 0;
 
+  /// Hints that [pos, pos + size) is going to be read soon, so the data can be read ahead
+  /// while the caller is busy. It does nothing by default.
+  virtual void Prefetch(uint64_t /* pos */, uint64_t /* size */) const {}
+
   void ReadAsString(string & s) const;
 
   static bool IsEqual(string const & name1, string const & name2);
@@ -133,6 +137,11 @@ public:
     m_p->ReadAsString(s);
   }
 
+  void Prefetch(uint64_t pos, uint64_t size) const
+  {
+    m_p->Prefetch(pos, size);
+  }
+
   ReaderT * GetPtr() const { return m_p.get(); }
 };
 
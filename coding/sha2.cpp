@@ -1,6 +1,7 @@
 #include "coding/sha2.hpp"
 #include "coding/hex.hpp"
 
+#include "base/assert.hpp"
 #include "base/macros.hpp"
 
 #include "3party/tomcrypt/src/headers/tomcrypt.h"
@@ -22,4 +23,27 @@ namespace sha2
     }
     return string();
   }
+
+  Hasher256::Hasher256() : m_state(new hash_state())
+  {
+    VERIFY(CRYPT_OK == sha256_init(m_state.get()), ());
+  }
+
+  Hasher256::~Hasher256()
+  {
+  }
+
+  void Hasher256::Update(void const * data, size_t dataSize)
+  {
+    VERIFY(CRYPT_OK == sha256_process(m_state.get(), static_cast<unsigned char const *>(data),
+                                      dataSize), ());
+  }
+
+  string Hasher256::Digest(bool returnAsHexString)
+  {
+    unsigned char out[256/8] = { 0 };
+    VERIFY(CRYPT_OK == sha256_done(m_state.get(), out), ());
+    string const digest(reinterpret_cast<char const *>(out), ARRAY_SIZE(out));
+    return returnAsHexString ? ToHex(digest) : digest;
+  }
 }
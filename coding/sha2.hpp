@@ -1,6 +1,10 @@
 #pragma once
 
+#include "std/noncopyable.hpp"
 #include "std/string.hpp"
+#include "std/unique_ptr.hpp"
+
+union Hash_state;
 
 namespace sha2
 {
@@ -16,6 +20,21 @@ namespace sha2
     return digest256(data.c_str(), data.size(), returnAsHexString);
   }
 
+  /// Incremental sha256 of the data given by parts.
+  class Hasher256 : private noncopyable
+  {
+  public:
+    Hasher256();
+    ~Hasher256();
+
+    void Update(void const * data, size_t dataSize);
+    /// The hasher can't be updated after the digest is taken.
+    string Digest(bool returnAsHexString);
+
+  private:
+    unique_ptr<Hash_state> m_state;
+  };
+
   string digest384(char const * data, size_t dataSize, bool returnAsHexString);
   inline string digest384(string const & data, bool returnAsHexString = true)
   {
@@ -0,0 +1,217 @@
+#include "coding/shared_page_cache.hpp"
+
+#include "coding/internal/file_data.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstring.hpp"
+#include "std/sstream.hpp"
+
+// static
+uint64_t constexpr SharedPageCache::kDefaultMaxBytes;
+// static
+size_t constexpr SharedPageCache::kMaxCachedReadSize;
+
+// static
+SharedPageCache & SharedPageCache::Instance()
+{
+  // The cache is never destroyed, readers in static objects may outlive it otherwise.
+  static SharedPageCache * cache = new SharedPageCache();
+  return *cache;
+}
+
+SharedPageCache::SharedPageCache(uint64_t maxBytes, size_t shardsCount) : m_maxBytes(maxBytes)
+{
+  ASSERT_GREATER(shardsCount, 0, ());
+  for (size_t i = 0; i < shardsCount; ++i)
+  {
+    m_shards.emplace_back(new Shard());
+    m_shards.back()->m_maxBytes = maxBytes / shardsCount;
+  }
+}
+
+void SharedPageCache::SetMaxBytes(uint64_t maxBytes)
+{
+  {
+    lock_guard<mutex> lock(m_filesMutex);
+    m_maxBytes = maxBytes;
+  }
+  for (auto & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard->m_mutex);
+    shard->m_maxBytes = maxBytes / m_shards.size();
+    shard->EvictToFit(0);
+  }
+}
+
+uint64_t SharedPageCache::GetMaxBytes() const
+{
+  lock_guard<mutex> lock(m_filesMutex);
+  return m_maxBytes;
+}
+
+shared_ptr<SharedPageCache::File> SharedPageCache::Open(string const & key, uint32_t logPageSize)
+{
+  auto const fileKey = make_pair(key, logPageSize);
+  lock_guard<mutex> lock(m_filesMutex);
+  weak_ptr<File> & weakFile = m_files[fileKey];
+  shared_ptr<File> file = weakFile.lock();
+  if (!file)
+  {
+    // Ids aren't reused, so the pages of the closed files are never hit.
+    file.reset(new File(m_nextFileId++, logPageSize), [this, fileKey](File * p)
+    {
+      Close(fileKey);
+      delete p;
+    });
+    weakFile = file;
+  }
+  return file;
+}
+
+void SharedPageCache::Read(File const & file, my::FileData const & data, uint64_t fileSize,
+                           uint64_t pos, void * p, size_t size)
+{
+  if (size == 0)
+    return;
+  ASSERT_LESS_OR_EQUAL(pos + size, fileSize, (pos, size, fileSize));
+
+  if (size >= kMaxCachedReadSize)
+  {
+    data.ReadAt(pos, p, size);
+    return;
+  }
+
+  uint32_t const logPageSize = file.GetLogPageSize();
+  size_t const pageSize = size_t(1) << logPageSize;
+  char * dst = static_cast<char *>(p);
+  uint64_t pageNum = pos >> logPageSize;
+  size_t offset = static_cast<size_t>(pos - (pageNum << logPageSize));
+  while (size > 0)
+  {
+    size_t const copySize = min(size, pageSize - offset);
+    TKey const key(file.GetId(), pageNum);
+    Shard & shard = *m_shards[KeyHash()(key) % m_shards.size()];
+    if (!shard.Read(key, offset, dst, copySize))
+    {
+      // The page is read outside of the lock, concurrent misses of one page just read it twice.
+      uint64_t const pagePos = pageNum << logPageSize;
+      vector<char> page(static_cast<size_t>(min(static_cast<uint64_t>(pageSize), fileSize - pagePos)));
+      data.ReadAt(pagePos, page.data(), page.size());
+      memcpy(dst, page.data() + offset, copySize);
+
+      lock_guard<mutex> lock(shard.m_mutex);
+      shard.Insert(key, move(page));
+    }
+    size -= copySize;
+    dst += copySize;
+    offset = 0;
+    ++pageNum;
+  }
+}
+
+size_t SharedPageCache::GetPagesCount() const
+{
+  size_t count = 0;
+  for (auto const & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard->m_mutex);
+    count += shard->m_index.size();
+  }
+  return count;
+}
+
+string SharedPageCache::GetStatsStr() const
+{
+  ostringstream out;
+  out << "MaxBytes: " << GetMaxBytes() << " Pages: " << GetPagesCount();
+  for (size_t i = 0; i < m_shards.size(); ++i)
+  {
+    Shard const & shard = *m_shards[i];
+    lock_guard<mutex> lock(shard.m_mutex);
+    out << " Shard " << i << " Bytes: " << shard.m_bytes << " "
+        << shard.m_stats.GetStatsStr(0, static_cast<uint32_t>(shard.m_index.size()));
+  }
+  return out.str();
+}
+
+void SharedPageCache::Close(pair<string, uint32_t> const & key)
+{
+  lock_guard<mutex> lock(m_filesMutex);
+  auto const it = m_files.find(key);
+  // The file may be opened again before the deleter of the previous one is called.
+  if (it != m_files.end() && it->second.expired())
+    m_files.erase(it);
+}
+
+bool SharedPageCache::Shard::Read(TKey const & key, size_t offset, void * p, size_t size)
+{
+  lock_guard<mutex> lock(m_mutex);
+  m_stats.m_ReadSize(static_cast<uint32_t>(size));
+  auto const it = m_index.find(key);
+  m_stats.m_CacheHit(it != m_index.end() ? 1 : 0);
+  if (it == m_index.end())
+    return false;
+
+  Page & page = m_pages[it->second];
+  ASSERT_LESS_OR_EQUAL(offset + size, page.m_data.size(), ());
+  page.m_referenced = true;
+  memcpy(p, page.m_data.data() + offset, size);
+  return true;
+}
+
+void SharedPageCache::Shard::Insert(TKey const & key, vector<char> && data)
+{
+  if (data.size() > m_maxBytes || m_index.count(key) != 0)
+    return;
+
+  EvictToFit(data.size());
+
+  size_t index;
+  if (m_free.empty())
+  {
+    index = m_pages.size();
+    m_pages.emplace_back();
+  }
+  else
+  {
+    index = m_free.back();
+    m_free.pop_back();
+  }
+
+  Page & page = m_pages[index];
+  page.m_key = key;
+  page.m_data = move(data);
+  page.m_used = true;
+  page.m_referenced = false;
+  m_bytes += page.m_data.size();
+  m_index[key] = index;
+}
+
+void SharedPageCache::Shard::EvictToFit(uint64_t bytes)
+{
+  while (!m_index.empty() && m_bytes + bytes > m_maxBytes)
+  {
+    if (m_hand >= m_pages.size())
+      m_hand = 0;
+    Page & page = m_pages[m_hand];
+    if (page.m_used)
+    {
+      if (page.m_referenced)
+      {
+        // The second chance.
+        page.m_referenced = false;
+      }
+      else
+      {
+        m_index.erase(page.m_key);
+        m_bytes -= page.m_data.size();
+        vector<char>().swap(page.m_data);
+        page.m_used = false;
+        m_free.push_back(m_hand);
+      }
+    }
+    ++m_hand;
+  }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "coding/reader_cache.hpp"
+
+#include "base/macros.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/map.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/string.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/unordered_map.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+#include "std/weak_ptr.hpp"
+
+#ifndef LOG_FILE_READER_STATS
+#define LOG_FILE_READER_STATS 0
+#endif // LOG_FILE_READER_STATS
+
+namespace my
+{
+class FileData;
+}
+
+/// Process-wide cache of the file pages which is shared by all FileReaders. Pages are keyed by
+/// (file, page number), so the readers of the same file warm one cache. The cache is split into
+/// shards with their own locks and CLOCK eviction, the pages are read by pread outside of the
+/// locks, so the readers of different pages don't wait for each other.
+class SharedPageCache
+{
+public:
+  /// Opened file, the pages of the file are dropped from the cache lazily when the last
+  /// FileReader of the file is destroyed.
+  class File
+  {
+  public:
+    File(uint64_t id, uint32_t logPageSize) : m_id(id), m_logPageSize(logPageSize) {}
+
+    uint64_t GetId() const { return m_id; }
+    uint32_t GetLogPageSize() const { return m_logPageSize; }
+
+  private:
+    uint64_t const m_id;
+    uint32_t const m_logPageSize;
+  };
+
+  /// Default total size of the cached pages.
+  static uint64_t constexpr kDefaultMaxBytes = 32 * 1024 * 1024;
+  /// Reads of at least this size aren't cached, they go to the file directly.
+  static size_t constexpr kMaxCachedReadSize = 64 * 1024;
+
+  static SharedPageCache & Instance();
+
+  explicit SharedPageCache(uint64_t maxBytes = kDefaultMaxBytes, size_t shardsCount = 16);
+
+  /// Sets the total size of the cached pages, extra pages are evicted.
+  void SetMaxBytes(uint64_t maxBytes);
+  uint64_t GetMaxBytes() const;
+
+  /// @param key Identity of the file, the readers with equal keys share the pages.
+  shared_ptr<File> Open(string const & key, uint32_t logPageSize);
+
+  /// Reads [pos, pos + size) of data which is fileSize bytes long. Thread-safe.
+  void Read(File const & file, my::FileData const & data, uint64_t fileSize, uint64_t pos,
+            void * p, size_t size);
+
+  /// @return Number of the cached pages.
+  size_t GetPagesCount() const;
+
+  string GetStatsStr() const;
+
+private:
+  using TKey = pair<uint64_t, uint64_t>;
+
+  struct KeyHash
+  {
+    size_t operator()(TKey const & key) const
+    {
+      return static_cast<size_t>((key.first * 0x9E3779B97F4A7C15ULL) ^ key.second);
+    }
+  };
+
+  struct Page
+  {
+    TKey m_key;
+    vector<char> m_data;
+    bool m_used = false;
+    // CLOCK reference bit, it's set on every hit.
+    bool m_referenced = false;
+  };
+
+  /// Read locks the shard, Insert and EvictToFit are called under m_mutex.
+  struct Shard
+  {
+    /// @return false if the page isn't cached.
+    bool Read(TKey const & key, size_t offset, void * p, size_t size);
+    void Insert(TKey const & key, vector<char> && data);
+    void EvictToFit(uint64_t bytes);
+
+    mutable mutex m_mutex;
+    unordered_map<TKey, size_t, KeyHash> m_index;
+    vector<Page> m_pages;
+    vector<size_t> m_free;
+    size_t m_hand = 0;
+    uint64_t m_bytes = 0;
+    uint64_t m_maxBytes = 0;
+    impl::ReaderCacheStats<LOG_FILE_READER_STATS> m_stats;
+  };
+
+  void Close(pair<string, uint32_t> const & key);
+
+  vector<unique_ptr<Shard>> m_shards;
+
+  mutable mutex m_filesMutex;
+  map<pair<string, uint32_t>, weak_ptr<File>> m_files;
+  uint64_t m_nextFileId = 0;
+  uint64_t m_maxBytes;
+
+  DISALLOW_COPY_AND_MOVE(SharedPageCache);
+};
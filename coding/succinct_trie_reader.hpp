@@ -28,11 +28,15 @@ public:
   using TValue = typename TValueReader::ValueType;
   using TEdgeValue = typename TEdgeValueReader::ValueType;
 
+  // Number of the top levels of the trie which children are memoized by default.
+  static uint32_t const kDefaultCachedLevels = 14;
+
   TopologyAndOffsets(TReader const & reader, TValueReader const & valueReader,
-                     TEdgeValueReader const & edgeValueReader)
+                     TEdgeValueReader const & edgeValueReader,
+                     uint32_t numCachedLevels = kDefaultCachedLevels)
     : m_reader(reader), m_valueReader(valueReader), m_edgeValueReader(edgeValueReader)
   {
-    Parse();
+    Parse(numCachedLevels);
   }
 
   // Returns the topology of the trie in the external node representation.
@@ -46,6 +50,52 @@ public:
   // Returns the number of trie nodes.
   uint32_t NumNodes() const { return m_numNodes; }
 
+  // Returns the number of nodes which children are memoized.
+  uint32_t NumCachedNodes() const { return static_cast<uint32_t>(m_childIds.size() / 2); }
+
+  // Returns false if the node |id| has no child |i|, otherwise sets |childId|.
+  // Nodes are numbered from 0 in the level order.
+  bool GetChild(uint32_t id, size_t i, uint32_t & childId) const
+  {
+    ASSERT_LESS(i, 2, ("Bad edge id of a binary trie."));
+    if (id >= m_numNodes)
+      return false;
+    if (id < NumCachedNodes())
+    {
+      childId = m_childIds[2 * id + i];
+      return childId != kNoChild;
+    }
+    // The child bit of the node in the external node representation.
+    uint64_t const bit = 2 * static_cast<uint64_t>(id) + 1 + i;
+    if (!m_trieTopology[bit])
+      return false;
+    childId = static_cast<uint32_t>(m_trieTopology.rank(bit + 1) - 1);
+    return true;
+  }
+
+  // Fills |childIds| with the ids of the children of the node |id| or
+  // kNoChild when there is no child, only one rank is computed for both children.
+  void GetChildren(uint32_t id, uint32_t (&childIds)[2]) const
+  {
+    if (id >= m_numNodes)
+    {
+      childIds[0] = childIds[1] = kNoChild;
+      return;
+    }
+    if (id < NumCachedNodes())
+    {
+      childIds[0] = m_childIds[2 * id];
+      childIds[1] = m_childIds[2 * id + 1];
+      return;
+    }
+    uint64_t const bit = 2 * static_cast<uint64_t>(id) + 1;
+    uint32_t nextId = static_cast<uint32_t>(m_trieTopology.rank(bit));
+    for (size_t i = 0; i < 2; ++i)
+      childIds[i] = m_trieTopology[bit + i] ? nextId++ : kNoChild;
+  }
+
+  static uint32_t const kNoChild = static_cast<uint32_t>(-1);
+
   // Returns the Huffman encoding that was used to encode the strings
   // before adding them to this trie.
   coding::HuffmanCoder const & GetEncoding() const { return m_huffman; }
@@ -77,7 +127,7 @@ public:
   TReader const & GetReader() const { return m_reader; }
 
 private:
-  void Parse()
+  void Parse(uint32_t numCachedLevels)
   {
     ReaderSource<TReader> src(m_reader);
 
@@ -92,6 +142,7 @@ private:
       bv[i + 1] = bitReader.Read(1) == 1;
 
     succinct::rs_bit_vector(bv).swap(m_trieTopology);
+    CacheTopLevels(bv, numCachedLevels);
 
     uint32_t const numFinalNodes = ReadVarUint<uint32_t, ReaderSource<TReader>>(src);
     m_finalNodeIndex.assign(m_numNodes, -1);
@@ -110,6 +161,31 @@ private:
     m_reader = m_reader.SubReader(src.Pos(), src.Size());
   }
 
+  // Memoizes the children of the nodes of the top levels. The nodes are in the level order,
+  // so they are the first ones and the children of the nodes [b, e) are the bits [2b + 1, 2e + 1).
+  void CacheTopLevels(vector<bool> const & bv, uint32_t numCachedLevels)
+  {
+    uint32_t levelBegin = 0;
+    uint32_t levelEnd = m_numNodes == 0 ? 0 : 1;
+    for (uint32_t level = 0; level < numCachedLevels && levelBegin < levelEnd; ++level)
+    {
+      uint32_t nextEnd = levelEnd;
+      for (size_t i = 2 * levelBegin + 1; i < 2 * levelEnd + 1; ++i)
+        nextEnd += bv[i] ? 1 : 0;
+      levelBegin = levelEnd;
+      levelEnd = nextEnd;
+    }
+
+    uint32_t const numCachedNodes = levelBegin;
+    m_childIds.resize(2 * numCachedNodes);
+    uint32_t ones = bv.empty() ? 0 : 1;
+    for (size_t i = 1; i < 2 * numCachedNodes + 1; ++i)
+    {
+      ones += bv[i] ? 1 : 0;
+      m_childIds[i - 1] = bv[i] ? ones - 1 : kNoChild;
+    }
+  }
+
   TReader m_reader;
 
   // todo(@pimenov) Why do we even need an instance? Type name is enough.
@@ -120,6 +196,10 @@ private:
   coding::HuffmanCoder m_huffman;
   succinct::rs_bit_vector m_trieTopology;
 
+  // m_childIds[2 * i + j] is the id of the j'th child of the node i, it's filled
+  // for the nodes of the top levels only.
+  vector<uint32_t> m_childIds;
+
   // m_finalNodeIndex[i] is the 0-based index of the i'th
   // node in the list of all final nodes, or -1 if the
   // node is not final.
@@ -127,6 +207,12 @@ private:
   vector<uint32_t> m_offsetTable;
 };
 
+template <class TReader, class TValueReader, class TEdgeValueReader>
+uint32_t const TopologyAndOffsets<TReader, TValueReader, TEdgeValueReader>::kDefaultCachedLevels;
+
+template <class TReader, class TValueReader, class TEdgeValueReader>
+uint32_t const TopologyAndOffsets<TReader, TValueReader, TEdgeValueReader>::kNoChild;
+
 template <class TReader, class TValueReader, class TEdgeValueReader>
 class SuccinctTrieIterator
 {
@@ -135,32 +221,35 @@ public:
   using TEdgeValue = typename TEdgeValueReader::ValueType;
   using TCommonData = TopologyAndOffsets<TReader, TValueReader, TEdgeValueReader>;
 
-  SuccinctTrieIterator(TReader const & reader, shared_ptr<TCommonData> common,
-                       uint32_t nodeBitPosition)
-    : m_reader(reader), m_common(common), m_nodeBitPosition(nodeBitPosition), m_valuesRead(false)
+  SuccinctTrieIterator(TReader const & reader, shared_ptr<TCommonData> common, uint32_t nodeId)
+    : m_reader(reader), m_common(common), m_nodeId(nodeId), m_valuesRead(false)
   {
   }
 
   unique_ptr<SuccinctTrieIterator> Clone() const
   {
-    return make_unique<SuccinctTrieIterator>(m_reader, m_common, m_nodeBitPosition);
+    return make_unique<SuccinctTrieIterator>(m_reader, m_common, m_nodeId);
   }
 
   unique_ptr<SuccinctTrieIterator> GoToEdge(size_t i) const
   {
-    ASSERT_LESS(i, 2, ("Bad edge id of a binary trie."));
-    ASSERT_EQUAL(m_common->GetTopology()[m_nodeBitPosition - 1], 1, (m_nodeBitPosition));
-
-    // rank(x) returns the number of ones in [0, x) but we count bit positions from 1
-    uint32_t childBitPosition = 2 * m_common->GetTopology().rank(m_nodeBitPosition);
-    if (i == 1)
-      ++childBitPosition;
-    if (childBitPosition > 2 * m_common->NumNodes() ||
-        m_common->GetTopology()[childBitPosition - 1] == 0)
-    {
+    uint32_t childId;
+    if (!m_common->GetChild(m_nodeId, i, childId))
       return nullptr;
+    return make_unique<SuccinctTrieIterator>(m_reader, m_common, childId);
+  }
+
+  // Calls |toDo| with the edge id and the iterator of every child of the node.
+  template <typename TToDo>
+  void ForEachChild(TToDo && toDo) const
+  {
+    uint32_t childIds[2];
+    m_common->GetChildren(m_nodeId, childIds);
+    for (size_t i = 0; i < 2; ++i)
+    {
+      if (childIds[i] != TCommonData::kNoChild)
+        toDo(i, make_unique<SuccinctTrieIterator>(m_reader, m_common, childIds[i]));
     }
-    return make_unique<SuccinctTrieIterator>(m_reader, m_common, childBitPosition);
   }
 
   template <typename TEncodingReader>
@@ -174,16 +263,15 @@ public:
 
     BitReader<ReaderSource<TEncodingReader>> bitReader(src);
 
-    auto ret = Clone();
+    // Only the ids are moved along the path, the iterator is created for the last node.
+    uint32_t id = m_nodeId;
     for (uint32_t i = 0; i < numBits; ++i)
     {
-      uint8_t bit = bitReader.Read(1);
-      auto nxt = ret->GoToEdge(bit);
-      if (!nxt)
+      uint8_t const bit = bitReader.Read(1);
+      if (!m_common->GetChild(id, bit, id))
         return nullptr;
-      ret = move(nxt);
     }
-    return ret;
+    return make_unique<SuccinctTrieIterator>(m_reader, m_common, id);
   }
 
   unique_ptr<SuccinctTrieIterator> GoToString(strings::UniString const & s)
@@ -219,8 +307,6 @@ private:
     if (m_valuesRead)
       return;
     m_valuesRead = true;
-    // Back to 0-based indices.
-    uint32_t m_nodeId = m_common->GetTopology().rank(m_nodeBitPosition) - 1;
     if (!m_common->NodeIsFinal(m_nodeId))
       return;
     uint32_t offset = m_common->Offset(m_nodeId);
@@ -238,9 +324,8 @@ private:
   TReader const & m_reader;
   shared_ptr<TCommonData> m_common;
 
-  // The bit with this 1-based index represents this node
-  // in the external node representation of binary trie.
-  uint32_t m_nodeBitPosition;
+  // 0-based index of this node in the level order.
+  uint32_t m_nodeId;
 
   vector<TValue> m_values;
   bool m_valuesRead;
@@ -249,13 +334,16 @@ private:
 template <typename TReader, typename TValueReader, typename TEdgeValueReader>
 unique_ptr<SuccinctTrieIterator<TReader, TValueReader, TEdgeValueReader>> ReadSuccinctTrie(
     TReader const & reader, TValueReader valueReader = TValueReader(),
-    TEdgeValueReader edgeValueReader = TEdgeValueReader())
+    TEdgeValueReader edgeValueReader = TEdgeValueReader(),
+    uint32_t numCachedLevels =
+        TopologyAndOffsets<TReader, TValueReader, TEdgeValueReader>::kDefaultCachedLevels)
 {
   using TCommonData = TopologyAndOffsets<TReader, TValueReader, TEdgeValueReader>;
   using TIter = SuccinctTrieIterator<TReader, TValueReader, TEdgeValueReader>;
 
-  shared_ptr<TCommonData> common(new TCommonData(reader, valueReader, edgeValueReader));
-  return make_unique<TIter>(common->GetReader(), common, 1 /* bitPosition */);
+  shared_ptr<TCommonData> common(
+      new TCommonData(reader, valueReader, edgeValueReader, numCachedLevels));
+  return make_unique<TIter>(common->GetReader(), common, 0 /* nodeId */);
 }
 
 }  // namespace trie
@@ -72,6 +72,22 @@ public:
     ASSERT_EQUAL(pos, m_ReaderSize, ());
   }
 
+  /// Reads raw bytes, which can cover several consecutive records.
+  void ReadRaw(uint64_t pos, void * p, size_t size) const
+  {
+    ASSERT_LESS_OR_EQUAL(pos + size, m_ReaderSize, ());
+    m_Reader.Read(pos, p, size);
+  }
+
+  /// Hints that [pos, pos + size) is going to be read soon.
+  void Prefetch(uint64_t pos, uint64_t size) const
+  {
+    ASSERT_LESS_OR_EQUAL(pos + size, m_ReaderSize, ());
+    m_Reader.Prefetch(pos, size);
+  }
+
+  uint64_t Size() const { return m_ReaderSize; }
+
   bool IsEqual(string const & fName) const { return m_Reader.IsEqual(fName); }
 
 protected:
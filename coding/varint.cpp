@@ -0,0 +1,155 @@
+#include "coding/varint.hpp"
+#include "coding/endianness.hpp"
+
+#include "base/macros.hpp"
+
+#include "std/cstring.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define VARINT_SSE2
+#include <emmintrin.h>
+#elif !defined(ENDIAN_IS_BIG)
+#define VARINT_SWAR
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+inline uint32_t NumTrailingZeroBits(uint32_t n)
+{
+  ASSERT_NOT_EQUAL(n, 0, ());
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, n);
+  return static_cast<uint32_t>(index);
+#else
+  return static_cast<uint32_t>(__builtin_ctz(n));
+#endif
+}
+
+/// Assembles the value of length bytes, only the last byte has no continuation bit.
+template <typename T>
+inline T Assemble(uint8_t const * p, uint32_t length)
+{
+  switch (length)
+  {
+  case 1: return p[0];
+  case 2: return static_cast<T>(p[0] & 127) | (static_cast<T>(p[1]) << 7);
+  case 3:
+    return static_cast<T>(p[0] & 127) | (static_cast<T>(p[1] & 127) << 7) |
+           (static_cast<T>(p[2]) << 14);
+  }
+  T res = 0;
+  for (uint32_t i = 0; i < length; ++i)
+    res |= static_cast<T>(p[i] & 127) << (7 * i);
+  return res;
+}
+
+#if defined(VARINT_SSE2)
+uint32_t const kBlockSize = 16;
+
+/// @return Mask of the continuation bits of 16 bytes.
+inline uint32_t GetContinuationMask(uint8_t const * p)
+{
+  __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+  return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+}
+#elif defined(VARINT_SWAR)
+uint32_t const kBlockSize = 8;
+
+/// @return Mask of the continuation bits of 8 bytes, they are gathered by one multiplication.
+inline uint32_t GetContinuationMask(uint8_t const * p)
+{
+  uint64_t word;
+  memcpy(&word, p, sizeof(word));
+  return static_cast<uint32_t>(((word & 0x8080808080808080ULL) * 0x0002040810204081ULL) >> 56);
+}
+#endif
+
+/// Decodes at most maxCount values from [beg, end).
+template <typename T>
+uint8_t const * DecodeArray(uint8_t const * beg, uint8_t const * end, size_t maxCount, T * out,
+                            size_t & count)
+{
+  uint8_t const * p = beg;
+  count = 0;
+
+#if defined(VARINT_SSE2) || defined(VARINT_SWAR)
+  uint32_t const kFullMask = (1U << kBlockSize) - 1;
+  // The continuation bits of a block are found at once, then the values which end
+  // in the block are assembled without testing every byte.
+  while (count < maxCount && end - p >= static_cast<ptrdiff_t>(kBlockSize))
+  {
+    uint32_t const mask = GetContinuationMask(p);
+    if (mask == 0 && maxCount - count >= kBlockSize)
+    {
+      // All the values are single bytes, it's the most common case for the deltas.
+      for (uint32_t i = 0; i < kBlockSize; ++i)
+        out[count + i] = p[i];
+      count += kBlockSize;
+      p += kBlockSize;
+      continue;
+    }
+
+    uint32_t stops = ~mask & kFullMask;
+    if (stops == 0)
+    {
+      // The value is longer than the block.
+      uint8_t const * q = p;
+      while (q < end && (*q & 128))
+        ++q;
+      if (q == end)
+        MYTHROW(ReadVarIntException, ());
+      out[count++] = Assemble<T>(p, static_cast<uint32_t>(q - p + 1));
+      p = q + 1;
+      continue;
+    }
+
+    uint32_t start = 0;
+    while (stops != 0 && count < maxCount)
+    {
+      uint32_t const stop = NumTrailingZeroBits(stops);
+      out[count++] = Assemble<T>(p + start, stop - start + 1);
+      start = stop + 1;
+      stops &= stops - 1;
+    }
+    p += start;
+  }
+#endif
+
+  // Tail of the buffer.
+  while (count < maxCount && p < end)
+  {
+    uint8_t const * q = p;
+    while (q < end && (*q & 128))
+      ++q;
+    if (q == end)
+      MYTHROW(ReadVarIntException, ());
+    out[count++] = Assemble<T>(p, static_cast<uint32_t>(q - p + 1));
+    p = q + 1;
+  }
+  return p;
+}
+}  // namespace
+
+size_t DecodeVarUint64Array(uint8_t const * beg, uint8_t const * end, uint64_t * out)
+{
+  size_t count = 0;
+  uint8_t const * p = DecodeArray(beg, end, static_cast<size_t>(end - beg), out, count);
+  ASSERT_EQUAL(p, end, ());
+  UNUSED_VALUE(p);
+  return count;
+}
+
+uint8_t const * DecodeVarUint32Array(uint8_t const * beg, uint8_t const * end, size_t count,
+                                     uint32_t * out)
+{
+  size_t decoded = 0;
+  uint8_t const * p = DecodeArray(beg, end, count, out, decoded);
+  if (decoded != count)
+    MYTHROW(ReadVarIntException, (count, decoded));
+  return p;
+}
@@ -272,3 +272,17 @@ void const * ReadVarUint64Array(void const * pBeg, size_t count, F f)
   return impl::ReadVarInt64Array(pBeg, impl::ReadVarInt64ArrayGivenSize(count), f, IdFunctor());
 }
 
+
+/// @name Bulk decoding of the buffers, the continuation bits of the blocks of bytes are found
+/// at once (by SSE2 or by a 64-bit word), so each byte isn't tested with a branch.
+/// They throw ReadVarIntException when the last value isn't terminated within the buffer.
+//@{
+/// Decodes all the varuints of [beg, end) to out, which should fit (end - beg) values.
+/// @return Number of the decoded values.
+size_t DecodeVarUint64Array(uint8_t const * beg, uint8_t const * end, uint64_t * out);
+
+/// Decodes count varuints starting from beg, they should fit in [beg, end).
+/// @return Pointer to the byte after the last decoded value.
+uint8_t const * DecodeVarUint32Array(uint8_t const * beg, uint8_t const * end, size_t count,
+                                     uint32_t * out);
+//@}
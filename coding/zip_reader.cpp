@@ -7,38 +7,124 @@
 #include "coding/constants.hpp"
 
 #include "std/bind.hpp"
+#include "std/mutex.hpp"
+#include "std/unordered_map.hpp"
+#include "std/vector.hpp"
 
 #include "3party/minizip/unzip.h"
 
 
-ZipFileReader::ZipFileReader(string const & container, string const & file,
-                             uint32_t logPageSize, uint32_t logPageCount)
-  : FileReader(container, logPageSize, logPageCount), m_uncompressedFileSize(0)
+namespace
 {
-  unzFile zip = unzOpen64(container.c_str());
-  if (!zip)
-    MYTHROW(OpenZipException, ("Can't get zip file handle", container));
+/// Entries of the zip containers which ZipFileReader opens. The central directory of a container
+/// is scanned once, so the files absent in it don't scan it again, and the offsets of the data of
+/// the files are located at the first open. Platform::GetReader probes the same containers for
+/// all the resources, that's where it's needed.
+class ZipEntriesCache
+{
+public:
+  struct Entry
+  {
+    unz64_file_pos m_pos;
+    // Zero until the entry is opened.
+    uint64_t m_offset = 0;
+    uint64_t m_compressedSize = 0;
+    uint64_t m_uncompressedSize = 0;
+  };
+
+  static ZipEntriesCache & Instance()
+  {
+    static ZipEntriesCache cache;
+    return cache;
+  }
 
-  MY_SCOPE_GUARD(zipGuard, bind(&unzClose, zip));
+  /// @param containerSize Size of the container file, which is checked against the data offset.
+  Entry GetEntry(string const & container, uint64_t containerSize, string const & file)
+  {
+    string const key = FileReader::GetFileKey(container, containerSize);
 
-  if (UNZ_OK != unzLocateFile(zip, file.c_str(), 1))
-    MYTHROW(LocateZipException, ("Can't locate file inside zip", file));
+    lock_guard<mutex> guard(m_mutex);
+    auto it = m_containers.find(key);
+    if (it == m_containers.end())
+      it = m_containers.emplace(key, ScanContainer(container)).first;
 
-  if (UNZ_OK != unzOpenCurrentFile(zip))
-    MYTHROW(LocateZipException, ("Can't open file inside zip", file));
+    auto const entryIt = it->second.find(file);
+    if (entryIt == it->second.end())
+      MYTHROW(ZipFileReader::LocateZipException, ("Can't locate file inside zip", file));
 
-  uint64_t const offset = unzGetCurrentFileZStreamPos64(zip);
-  (void) unzCloseCurrentFile(zip);
+    Entry & entry = entryIt->second;
+    if (entry.m_offset == 0)
+      OpenEntry(container, containerSize, file, entry);
+    return entry;
+  }
 
-  if (offset == 0 || offset > Size())
-    MYTHROW(LocateZipException, ("Invalid offset inside zip", file));
+private:
+  using TEntries = unordered_map<string, Entry>;
 
-  unz_file_info64 fileInfo;
-  if (UNZ_OK != unzGetCurrentFileInfo64(zip, &fileInfo, NULL, 0, NULL, 0, NULL, 0))
-    MYTHROW(LocateZipException, ("Can't get compressed file size inside zip", file));
+  static TEntries ScanContainer(string const & container)
+  {
+    unzFile const zip = unzOpen64(container.c_str());
+    if (!zip)
+      MYTHROW(ZipFileReader::OpenZipException, ("Can't get zip file handle", container));
+    MY_SCOPE_GUARD(zipGuard, bind(&unzClose, zip));
+
+    TEntries entries;
+    vector<char> name;
+    for (int res = unzGoToFirstFile(zip); res == UNZ_OK; res = unzGoToNextFile(zip))
+    {
+      unz_file_info64 fileInfo;
+      if (UNZ_OK != unzGetCurrentFileInfo64(zip, &fileInfo, NULL, 0, NULL, 0, NULL, 0))
+        MYTHROW(ZipFileReader::LocateZipException, ("Can't get file info inside zip", container));
+      name.resize(fileInfo.size_filename + 1);
+      if (UNZ_OK != unzGetCurrentFileInfo64(zip, NULL, name.data(), name.size(), NULL, 0, NULL, 0))
+        MYTHROW(ZipFileReader::LocateZipException, ("Can't get file name inside zip", container));
+
+      Entry entry;
+      if (UNZ_OK != unzGetFilePos64(zip, &entry.m_pos))
+        MYTHROW(ZipFileReader::LocateZipException, ("Can't get file position inside zip", container));
+      entry.m_compressedSize = fileInfo.compressed_size;
+      entry.m_uncompressedSize = fileInfo.uncompressed_size;
+      // The first of the same names is found by unzLocateFile.
+      entries.emplace(string(name.data(), fileInfo.size_filename), entry);
+    }
+    return entries;
+  }
+
+  static void OpenEntry(string const & container, uint64_t containerSize, string const & file,
+                        Entry & entry)
+  {
+    unzFile const zip = unzOpen64(container.c_str());
+    if (!zip)
+      MYTHROW(ZipFileReader::OpenZipException, ("Can't get zip file handle", container));
+    MY_SCOPE_GUARD(zipGuard, bind(&unzClose, zip));
+
+    if (UNZ_OK != unzGoToFilePos64(zip, &entry.m_pos))
+      MYTHROW(ZipFileReader::LocateZipException, ("Can't locate file inside zip", file));
+
+    if (UNZ_OK != unzOpenCurrentFile(zip))
+      MYTHROW(ZipFileReader::LocateZipException, ("Can't open file inside zip", file));
+
+    uint64_t const offset = unzGetCurrentFileZStreamPos64(zip);
+    (void) unzCloseCurrentFile(zip);
 
-  SetOffsetAndSize(offset, fileInfo.compressed_size);
-  m_uncompressedFileSize = fileInfo.uncompressed_size;
+    if (offset == 0 || offset > containerSize)
+      MYTHROW(ZipFileReader::LocateZipException, ("Invalid offset inside zip", file));
+    entry.m_offset = offset;
+  }
+
+  mutex m_mutex;
+  // Entries of the containers by FileReader::GetFileKey() of them.
+  unordered_map<string, TEntries> m_containers;
+};
+}  // namespace
+
+ZipFileReader::ZipFileReader(string const & container, string const & file,
+                             uint32_t logPageSize, uint32_t logPageCount)
+  : FileReader(container, logPageSize, logPageCount), m_uncompressedFileSize(0)
+{
+  ZipEntriesCache::Entry const entry = ZipEntriesCache::Instance().GetEntry(container, Size(), file);
+  SetOffsetAndSize(entry.m_offset, entry.m_compressedSize);
+  m_uncompressedFileSize = entry.m_uncompressedSize;
 }
 
 void ZipFileReader::FilesList(string const & zipContainer, FileListT & filesList)
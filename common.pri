@@ -42,6 +42,8 @@ CONFIG(production) {
 
 CONFIG(release, debug|release) {
   DEFINES *= RELEASE _RELEASE NDEBUG
+  # Debug messages are off in release anyway, so they are removed from the code.
+  android-*: DEFINES *= OMIM_LOG_MIN_LEVEL=LINFO
   CONFIG(production) {
     CONFIG_NAME = production
   } else {
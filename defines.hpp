@@ -7,11 +7,13 @@
 #define EXTENSION_TMP ".tmp"
 #define ADDR_FILE_EXTENSION ".addr"
 #define RAW_GEOM_FILE_EXTENSION ".rawgeom"
+#define DIFF_FILE_EXTENSION ".mwmdiff"
 
 #define NODES_FILE "nodes.dat"
 #define WAYS_FILE "ways.dat"
 #define RELATIONS_FILE "relations.dat"
 #define OFFSET_EXT ".offs"
+#define COMPRESSED_CACHE_EXT ".z"
 #define ID2REL_EXT ".id2rel"
 
 #define DATA_FILE_TAG "dat"
@@ -23,6 +25,8 @@
 #define VERSION_FILE_TAG "version"
 #define METADATA_FILE_TAG "meta"
 #define METADATA_INDEX_FILE_TAG "metaidx"
+#define METADATA_OFFSETS_FILE_TAG "metaoffsets"
+#define NAMES_CODE_FILE_TAG "names_code"
 #define COMPRESSED_SEARCH_INDEX_FILE_TAG "csdx"
 
 #define ROUTING_MATRIX_FILE_TAG "mercedes"
@@ -33,11 +37,27 @@
 
 #define ROUTING_FTSEG_FILE_TAG  "ftseg"
 #define ROUTING_NODEIND_TO_FTSEGIND_FILE_TAG  "node2ftseg"
+#define ROUTING_SEGMENTS_INDEX_FILE_TAG "ftseg_rtree"
+#define ROUTING_TURNS_INFO_FILE_TAG "turns_info"
+
+#define PEDESTRIAN_LANDMARKS_FILE_TAG "landmarks"
+#define PEDESTRIAN_ROAD_GRAPH_FILE_TAG "pedestrian_graph"
+#define BICYCLE_ROAD_GRAPH_FILE_TAG "bicycle_graph"
+#define PEDESTRIAN_CROSS_CONTEXT_FILE_TAG "pedestrian_cross"
+
+#define LOCALITY_INDEX_FILE_TAG "localities"
+#define HOUSES_INDEX_FILE_TAG "houses"
+
+#define FEATURE_SCALES_FILE_TAG "feature_scales"
+#define FEATURE_ATTRIBUTES_FILE_TAG "feature_attributes"
+#define FEATURES_OFFSETS_FILE_TAG "features_offsets"
+#define COARSE_CELLS_INDEX_FILE_TAG "coarse_cells"
 
 #define READY_FILE_EXTENSION ".ready"
 #define RESUME_FILE_EXTENSION ".resume3"
 #define DOWNLOADING_FILE_EXTENSION ".downloading3"
 #define BOOKMARKS_FILE_EXTENSION ".kml"
+#define BOOKMARKS_BINARY_FILE_EXTENSION ".kmb"
 #define ROUTING_FILE_EXTENSION ".routing"
 
 #define GEOM_INDEX_TMP_EXT ".geomidx.tmp"
@@ -45,6 +65,7 @@
 #define CELL2FEATURE_TMP_EXT ".c2f.tmp"
 
 #define COUNTRIES_FILE  "countries.txt"
+#define COUNTRIES_BINARY_FILE "countries.bin"
 
 #define WORLD_FILE_NAME "World"
 #define WORLD_COASTS_FILE_NAME "WorldCoasts"
@@ -55,6 +76,12 @@
 
 #define PACKED_POLYGONS_FILE "packed_polygons.bin"
 #define PACKED_POLYGONS_INFO_TAG "info"
+#define PACKED_POLYGONS_GRID_TAG "grid"
+
+#define CROSS_MWM_OVERLAY_FILE "cross_mwm_overlay.bin"
+#define ROUTE_CACHE_FILE "route_cache.bin"
+#define LAST_ROUTE_FILE "last_route.bin"
+#define MWM_INFO_CACHE_FILE "mwm_info_cache.bin"
 
 #define EXTERNAL_RESOURCES_FILE "external_resources.txt"
 
@@ -20,9 +20,10 @@ public:
 
   }
 
-  void SetVAO(RefPointer<VertexArrayBuffer> buffer)
+  void SetBucket(RefPointer<RenderBucket> bucket)
   {
-    m_buffer = buffer;
+    m_bucket = bucket;
+    m_buffer = bucket->GetBuffer();
   }
 
   bool IsVAOFilled() const
@@ -38,6 +39,7 @@ public:
       m_overlay->AddDynamicAttribute(info, offset, count);
     }
     m_buffer->UploadData(info, data, count);
+    m_bucket->AddToBoundingRect(info, data, count);
   }
 
   uint16_t * GetIndexStorage(uint16_t size, uint16_t & startIndex)
@@ -75,6 +77,7 @@ public:
 
 private:
   GLState const & m_state;
+  RefPointer<RenderBucket>      m_bucket;
   RefPointer<VertexArrayBuffer> m_buffer;
   RefPointer<OverlayHandle>     m_overlay;
   vector<uint16_t>              m_indexStorage;
@@ -139,6 +142,39 @@ void Batcher::InsertListOfStrip(GLState const & state, RefPointer<AttributeProvi
   InsertTriangles<TriangleListOfStripBatch>(state, params, handle, vertexStride);
 }
 
+void Batcher::InsertInstance(GLState const & state, RefPointer<AttributeProvider> mesh,
+                             uint16_t const * meshIndexes, uint16_t meshIndexCount,
+                             RefPointer<AttributeProvider> instance, TransferPointer<OverlayHandle> transferHandle)
+{
+  ASSERT_EQUAL(mesh->GetStreamCount(), 1, ());
+  ASSERT_EQUAL(instance->GetStreamCount(), 1, ());
+  ASSERT_EQUAL(instance->GetVertexCount(), 1, ("Overlay handle keeps a single instance"));
+
+  RefPointer<RenderBucket> bucket = GetBucket(state);
+  if (bucket->GetBuffer()->IsFilled())
+  {
+    FinalizeBucket(state);
+    bucket = GetBucket(state);
+  }
+
+  RefPointer<VertexArrayBuffer> vao = bucket->GetBuffer();
+  if (!vao->IsInstanced())
+  {
+    vao->UploadMesh(mesh->GetBindingInfo(0), mesh->GetRawPointer(0), mesh->GetVertexCount(),
+                    meshIndexes, meshIndexCount);
+  }
+
+  uint16_t const instanceIndex = vao->UploadInstances(instance->GetBindingInfo(0),
+                                                      instance->GetRawPointer(0),
+                                                      instance->GetVertexCount());
+  bucket->AddToBoundingRect(instance->GetBindingInfo(0), instance->GetRawPointer(0),
+                            instance->GetVertexCount());
+
+  MasterPointer<OverlayHandle> handle(transferHandle);
+  handle->IndexStorage(1)[0] = instanceIndex;
+  bucket->AddOverlayHandle(handle.Move());
+}
+
 void Batcher::StartSession(flush_fn const & flusher)
 {
   m_flushInterface = flusher;
@@ -157,8 +193,7 @@ void Batcher::ChangeBuffer(RefPointer<CallbacksWrapper> wrapper, bool checkFille
     GLState const & state = wrapper->GetState();
     FinalizeBucket(state);
 
-    RefPointer<RenderBucket> bucket = GetBucket(state);
-    wrapper->SetVAO(bucket->GetBuffer());
+    wrapper->SetBucket(GetBucket(state));
   }
 }
 
@@ -202,13 +237,12 @@ void Batcher::InsertTriangles(GLState const & state,
                               uint8_t vertexStride)
 {
   RefPointer<RenderBucket> bucket = GetBucket(state);
-  RefPointer<VertexArrayBuffer> vao = bucket->GetBuffer();
 
   MasterPointer<OverlayHandle> handle(transferHandle);
 
   {
     Batcher::CallbacksWrapper wrapper(state, handle.GetRefPointer());
-    wrapper.SetVAO(vao);
+    wrapper.SetBucket(bucket);
 
     BatchCallbacks callbacks;
     callbacks.m_flushVertex = bind(&CallbacksWrapper::FlushData, &wrapper, _1, _2, _3);
@@ -38,6 +38,11 @@ public:
   void InsertListOfStrip(GLState const & state, RefPointer<AttributeProvider> params,
                          TransferPointer<OverlayHandle> handle, uint8_t vertexStride);
 
+  /// Draws the mesh once per instance, all the instances of the state must have the same mesh.
+  /// The mesh is a list of triangles, its indexes start from 0.
+  void InsertInstance(GLState const & state, RefPointer<AttributeProvider> mesh,
+                      uint16_t const * meshIndexes, uint16_t meshIndexCount,
+                      RefPointer<AttributeProvider> instance, TransferPointer<OverlayHandle> handle);
 
   typedef function<void (GLState const &, TransferPointer<RenderBucket> )> flush_fn;
   void StartSession(flush_fn const & flusher);
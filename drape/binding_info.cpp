@@ -26,6 +26,11 @@ uint16_t sizeOfType(glConst type)
 
 } // namespace
 
+bool BindingDecl::IsNormalized() const
+{
+  return m_componentType != gl_const::GLFloatType;
+}
+
 bool BindingDecl::operator!=(BindingDecl const & other) const
 {
   return m_attributeName != other.m_attributeName ||
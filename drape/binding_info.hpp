@@ -16,6 +16,9 @@ struct BindingDecl
   uint8_t   m_stride;
   uint16_t  m_offset;
 
+  /// Components of integer types are normalized to [0, 1] or [-1, 1] on fetching.
+  bool IsNormalized() const;
+
   bool operator != (BindingDecl const & other) const;
   bool operator < (BindingDecl const & other) const;
 };
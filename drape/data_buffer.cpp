@@ -3,8 +3,8 @@
 namespace dp
 {
 
-DataBuffer::DataBuffer(uint8_t elementSize, uint16_t capacity)
-  : GPUBuffer(GPUBuffer::ElementBuffer, elementSize, capacity)
+DataBuffer::DataBuffer(uint8_t elementSize, uint16_t capacity, bool isDynamic)
+  : GPUBuffer(GPUBuffer::ElementBuffer, elementSize, capacity, isDynamic)
 {
 }
 
@@ -8,7 +8,7 @@ namespace dp
 class DataBuffer : public GPUBuffer
 {
 public:
-  DataBuffer(uint8_t elementSize, uint16_t capacity);
+  DataBuffer(uint8_t elementSize, uint16_t capacity, bool isDynamic = false);
 };
 
 } // namespace dp
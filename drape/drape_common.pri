@@ -8,6 +8,7 @@ SOURCES += \
     $$ROOT_DIR/3party/stb_image/sdf_image.cpp \
     $$ROOT_DIR/3party/stb_image/stb_image.c \
     $$DRAPE_DIR/data_buffer.cpp \
+    $$DRAPE_DIR/frame_fences.cpp \
     $$DRAPE_DIR/binding_info.cpp \
     $$DRAPE_DIR/batcher.cpp \
     $$DRAPE_DIR/attribute_provider.cpp \
@@ -18,12 +19,15 @@ SOURCES += \
     $$DRAPE_DIR/index_buffer.cpp \
     $$DRAPE_DIR/gpu_program.cpp \
     $$DRAPE_DIR/gpu_program_manager.cpp \
+    $$DRAPE_DIR/program_binary_cache.cpp \
     $$DRAPE_DIR/glconstants.cpp \
     $$DRAPE_DIR/glstate.cpp \
     $$DRAPE_DIR/gpu_buffer.cpp \
+    $$DRAPE_DIR/gpu_buffer_pool.cpp \
     $$DRAPE_DIR/shader_def.cpp \
     $$DRAPE_DIR/glextensions_list.cpp \
     $$DRAPE_DIR/pointers.cpp \
+    $$DRAPE_DIR/pooled_object.cpp \
     $$DRAPE_DIR/uniform_values_storage.cpp \
     $$DRAPE_DIR/color.cpp \
     $$DRAPE_DIR/oglcontextfactory.cpp \
@@ -40,6 +44,7 @@ SOURCES += \
     $$DRAPE_DIR/attribute_buffer_mutator.cpp \
     $$DRAPE_DIR/stipple_pen_resource.cpp \
     $$DRAPE_DIR/texture_of_colors.cpp \
+    $$DRAPE_DIR/glyph_cache.cpp \
     $$DRAPE_DIR/glyph_manager.cpp \
     $$DRAPE_DIR/utils/vertex_decl.cpp
 
@@ -47,6 +52,7 @@ HEADERS += \
     $$ROOT_DIR/sdf_image/sdf_image.h \
     $$ROOT_DIR/stb_image/stb_image.h \
     $$DRAPE_DIR/data_buffer.hpp \
+    $$DRAPE_DIR/frame_fences.hpp \
     $$DRAPE_DIR/binding_info.hpp \
     $$DRAPE_DIR/batcher.hpp \
     $$DRAPE_DIR/attribute_provider.hpp \
@@ -55,14 +61,17 @@ HEADERS += \
     $$DRAPE_DIR/texture.hpp \
     $$DRAPE_DIR/shader.hpp \
     $$DRAPE_DIR/pointers.hpp \
+    $$DRAPE_DIR/pooled_object.hpp \
     $$DRAPE_DIR/index_buffer.hpp \
     $$DRAPE_DIR/gpu_program.hpp \
     $$DRAPE_DIR/gpu_program_manager.hpp \
+    $$DRAPE_DIR/program_binary_cache.hpp \
     $$DRAPE_DIR/glstate.hpp \
     $$DRAPE_DIR/glIncludes.hpp \
     $$DRAPE_DIR/glconstants.hpp \
     $$DRAPE_DIR/glfunctions.hpp \
     $$DRAPE_DIR/gpu_buffer.hpp \
+    $$DRAPE_DIR/gpu_buffer_pool.hpp \
     $$DRAPE_DIR/shader_def.hpp \
     $$DRAPE_DIR/glextensions_list.hpp \
     $$DRAPE_DIR/oglcontext.hpp \
@@ -87,5 +96,6 @@ HEADERS += \
     $$DRAPE_DIR/texture_of_colors.hpp \
     $$DRAPE_DIR/glsl_types.hpp \
     $$DRAPE_DIR/glsl_func.hpp \
+    $$DRAPE_DIR/glyph_cache.hpp \
     $$DRAPE_DIR/glyph_manager.hpp \
     $$DRAPE_DIR/utils/vertex_decl.hpp
@@ -2,6 +2,7 @@
 #include "drape/drape_tests/memory_comparer.hpp"
 
 #include "drape/glconstants.hpp"
+#include "drape/glextensions_list.hpp"
 #include "drape/batcher.hpp"
 #include "drape/gpu_program_manager.hpp"
 #include "drape/shader_def.hpp"
@@ -24,6 +25,7 @@ using testing::InSequence;
 using testing::Invoke;
 using testing::IgnoreResult;
 using testing::AnyOf;
+using testing::AnyNumber;
 using namespace dp;
 
 namespace
@@ -385,3 +387,176 @@ UNIT_TEST(BatchListOfStript_partial)
       vaoAcceptor.m_vao[i].Destroy();
   }
 }
+
+namespace
+{
+  struct UploadRecorder
+  {
+    struct Upload
+    {
+      glConst m_target;
+      uint32_t m_offset;
+      vector<uint8_t> m_data;
+    };
+
+    void Record(glConst target, uint32_t size, void const * data, uint32_t offset)
+    {
+      Upload upload;
+      upload.m_target = target;
+      upload.m_offset = offset;
+      upload.m_data.assign(static_cast<uint8_t const *>(data), static_cast<uint8_t const *>(data) + size);
+      m_uploads.push_back(upload);
+    }
+
+    vector<Upload> m_uploads;
+  };
+
+  template <typename T>
+  bool IsUploadEqual(UploadRecorder::Upload const & upload, glConst target, uint32_t offset,
+                     T const * data, uint32_t count)
+  {
+    return upload.m_target == target && upload.m_offset == offset &&
+           upload.m_data.size() == count * sizeof(T) &&
+           memcmp(upload.m_data.data(), data, upload.m_data.size()) == 0;
+  }
+}
+
+UNIT_TEST(BatchInstances_Test)
+{
+  EXPECTGL(glHasExtension(_)).WillRepeatedly(Return(false));
+  EXPECTGL(glGenBuffer()).WillRepeatedly(Return(1));
+  EXPECTGL(glBindBuffer(_, _)).Times(AnyNumber());
+  EXPECTGL(glBufferData(_, _, NULL, _)).Times(AnyNumber());
+  EXPECTGL(glDeleteBuffer(_)).Times(AnyNumber());
+
+  UploadRecorder recorder;
+  EXPECTGL(glBufferSubData(_, _, _, _)).WillRepeatedly(Invoke(&recorder, &UploadRecorder::Record));
+
+  BindingInfo meshBinding(1);
+  BindingDecl & meshDecl = meshBinding.GetBindingDecl(0);
+  meshDecl.m_attributeName = "corner";
+  meshDecl.m_componentCount = 2;
+  meshDecl.m_componentType = gl_const::GLFloatType;
+  meshDecl.m_offset = 0;
+  meshDecl.m_stride = 0;
+
+  BindingInfo instanceBinding(1, 1);
+  BindingDecl & instanceDecl = instanceBinding.GetBindingDecl(0);
+  instanceDecl.m_attributeName = "position";
+  instanceDecl.m_componentCount = 3;
+  instanceDecl.m_componentType = gl_const::GLFloatType;
+  instanceDecl.m_offset = 0;
+  instanceDecl.m_stride = 0;
+
+  float mesh[] = { -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f, -1.0f };
+  uint16_t meshIndexes[] = { 0, 1, 2, 1, 2, 3 };
+  float instances[] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
+  int const kInstanceCount = 3;
+
+  AttributeProvider meshProvider(1, 4);
+  meshProvider.InitStream(0, meshBinding, MakeStackRefPointer(mesh));
+
+  VAOAcceptor vaoAcceptor;
+  vector<OverlayHandle *> handles;
+  Batcher batcher;
+  batcher.StartSession(bind(&VAOAcceptor::FlushFullBucket, &vaoAcceptor, _1, _2));
+  for (int i = 0; i < kInstanceCount; ++i)
+  {
+    AttributeProvider instanceProvider(1, 1);
+    instanceProvider.InitStream(0, instanceBinding, MakeStackRefPointer(instances + 3 * i));
+    handles.push_back(new SquareHandle(FeatureID(), dp::Center, m2::PointD(i, i), m2::PointD(1.0, 1.0), i));
+    batcher.InsertInstance(GLState(0, GLState::OverlayLayer), MakeStackRefPointer(&meshProvider),
+                           meshIndexes, ARRAY_SIZE(meshIndexes), MakeStackRefPointer(&instanceProvider),
+                           MovePointer(handles.back()));
+  }
+  batcher.EndSession();
+
+  TEST_EQUAL(vaoAcceptor.m_vao.size(), 1, ());
+  RefPointer<VertexArrayBuffer> vao = vaoAcceptor.m_vao[0]->GetBuffer();
+  TEST(vao->IsInstanced(), ());
+  TEST_EQUAL(vao->GetInstanceCount(), kInstanceCount, ());
+
+  // The mesh and its indexes are uploaded once, then instances go one by one.
+  vector<UploadRecorder::Upload> const & uploads = recorder.m_uploads;
+  TEST_EQUAL(uploads.size(), 2 + kInstanceCount, ());
+  TEST(IsUploadEqual(uploads[0], gl_const::GLArrayBuffer, 0, mesh, ARRAY_SIZE(mesh)), ());
+  TEST(IsUploadEqual(uploads[1], gl_const::GLElementArrayBuffer, 0, meshIndexes, ARRAY_SIZE(meshIndexes)), ());
+  for (int i = 0; i < kInstanceCount; ++i)
+  {
+    TEST(IsUploadEqual(uploads[2 + i], gl_const::GLArrayBuffer, 3 * i * sizeof(float), instances + 3 * i, 3), (i));
+    // The handle keeps the index of its instance.
+    TEST_EQUAL(handles[i]->GetIndexCount(), 1, ());
+  }
+
+  // Visible instances are packed to the start of the instance buffer.
+  // The mock GL doesn't map buffers, so it's checked when the buffers are updated by glBufferSubData only.
+  if (!GLExtensionsList::Instance().IsSupported(GLExtensionsList::MapBuffer))
+  {
+    IndexBufferMutator indexMutator(2);
+    handles[2]->SetIsVisible(true);
+    handles[2]->GetElementIndexes(MakeStackRefPointer(&indexMutator));
+    handles[0]->SetIsVisible(true);
+    handles[0]->GetElementIndexes(MakeStackRefPointer(&indexMutator));
+    AttributeBufferMutator attributeMutator;
+    vao->ApplyMutation(MakeStackRefPointer(&indexMutator), MakeStackRefPointer(&attributeMutator));
+
+    float const expected[] = { 6.0f, 7.0f, 8.0f, 0.0f, 1.0f, 2.0f };
+    TEST_EQUAL(uploads.size(), 3 + kInstanceCount, ());
+    TEST(IsUploadEqual(uploads.back(), gl_const::GLArrayBuffer, 0, expected, ARRAY_SIZE(expected)), ());
+
+    // The same instances aren't uploaded again.
+    vao->ApplyMutation(MakeStackRefPointer(&indexMutator), MakeStackRefPointer(&attributeMutator));
+    TEST_EQUAL(uploads.size(), 3 + kInstanceCount, ());
+  }
+
+  for (size_t i = 0; i < vaoAcceptor.m_vao.size(); ++i)
+    vaoAcceptor.m_vao[i].Destroy();
+}
+
+UNIT_TEST(BatchBoundingRect_Test)
+{
+  EXPECTGL(glHasExtension(_)).WillRepeatedly(Return(false));
+  EXPECTGL(glGenBuffer()).WillRepeatedly(Return(1));
+  EXPECTGL(glBindBuffer(_, _)).Times(AnyNumber());
+  EXPECTGL(glBufferData(_, _, NULL, _)).Times(AnyNumber());
+  EXPECTGL(glBufferSubData(_, _, _, _)).Times(AnyNumber());
+  EXPECTGL(glDeleteBuffer(_)).Times(AnyNumber());
+
+  BindingInfo binding(2);
+  BindingDecl & posDecl = binding.GetBindingDecl(0);
+  posDecl.m_attributeName = "a_position";
+  posDecl.m_componentCount = 3;
+  posDecl.m_componentType = gl_const::GLFloatType;
+  posDecl.m_offset = 0;
+  posDecl.m_stride = 5 * sizeof(float);
+
+  BindingDecl & normalDecl = binding.GetBindingDecl(1);
+  normalDecl.m_attributeName = "a_normal";
+  normalDecl.m_componentCount = 2;
+  normalDecl.m_componentType = gl_const::GLFloatType;
+  normalDecl.m_offset = 3 * sizeof(float);
+  normalDecl.m_stride = posDecl.m_stride;
+
+  // Normals are pixel offsets, they don't extend the bounding rect.
+  float data[] = { 1.0f, 2.0f, 0.0f, 100.0f, 100.0f,
+                   3.0f, -1.0f, 0.0f, -100.0f, -100.0f,
+                   2.0f, 5.0f, 0.0f, 100.0f, -100.0f };
+
+  AttributeProvider provider(1, 3);
+  provider.InitStream(0, binding, MakeStackRefPointer(data));
+
+  VAOAcceptor vaoAcceptor;
+  Batcher batcher;
+  batcher.StartSession(bind(&VAOAcceptor::FlushFullBucket, &vaoAcceptor, _1, _2));
+  batcher.InsertTriangleList(GLState(0, GLState::GeometryLayer), MakeStackRefPointer(&provider));
+  batcher.EndSession();
+
+  TEST_EQUAL(vaoAcceptor.m_vao.size(), 1, ());
+  RefPointer<RenderBucket> bucket = vaoAcceptor.m_vao[0].GetRefPointer();
+  TEST_EQUAL(bucket->GetBoundingRect(), m2::RectD(1.0, -1.0, 3.0, 5.0), ());
+  TEST(!bucket->IsCulled(m2::AnyRectD(m2::RectD(2.5, 4.5, 10.0, 10.0))), ());
+  TEST(bucket->IsCulled(m2::AnyRectD(m2::RectD(3.5, -10.0, 10.0, 10.0))), ());
+
+  for (size_t i = 0; i < vaoAcceptor.m_vao.size(); ++i)
+    vaoAcceptor.m_vao[i].Destroy();
+}
@@ -1,6 +1,7 @@
 #include "testing/testing.hpp"
 
 #include "drape/binding_info.hpp"
+#include "drape/utils/vertex_decl.hpp"
 
 using namespace dp;
 
@@ -29,3 +30,31 @@ UNIT_TEST(DynamicHandlingTest)
     TEST_EQUAL(info.IsDynamic(), true, ());
   }
 }
+
+UNIT_TEST(PackedTexCoordTest)
+{
+  gpu::PackedTexCoord const zero(glsl::vec2(0.0f, 0.0f));
+  TEST_EQUAL(zero.m_x, 0, ());
+  TEST_EQUAL(zero.m_y, 0, ());
+
+  gpu::PackedTexCoord const clamped(glsl::vec2(-0.5f, 1.5f));
+  TEST_EQUAL(clamped.m_x, 0, ());
+  TEST_EQUAL(clamped.m_y, 65535, ());
+
+  float const kEps = 1.0f / 65535.0f;
+  gpu::PackedTexCoord const coord(glsl::vec2(0.25f, 0.7f));
+  TEST_LESS(fabs(coord.Unpack().x - 0.25f), kEps, ());
+  TEST_LESS(fabs(coord.Unpack().y - 0.7f), kEps, ());
+}
+
+UNIT_TEST(PackedTexCoordBindingTest)
+{
+  BindingInfo const & info = gpu::SolidTexturingVertex::GetBindingInfo();
+  TEST_EQUAL(info.GetElementSize(), sizeof(gpu::SolidTexturingVertex), ());
+
+  BindingDecl const & posDecl = info.GetBindingDecl(0);
+  TEST(!posDecl.IsNormalized(), ());
+  BindingDecl const & texCoordDecl = info.GetBindingDecl(2);
+  TEST_EQUAL(texCoordDecl.m_componentType, gl_const::GLUnsignedShortType, ());
+  TEST(texCoordDecl.IsNormalized(), ());
+}
@@ -3,6 +3,7 @@
 #include "drape/drape_tests/glmock_functions.hpp"
 
 #include "drape/gpu_buffer.hpp"
+#include "drape/gpu_buffer_pool.hpp"
 #include "drape/data_buffer.hpp"
 #include "drape/index_buffer.hpp"
 
@@ -102,3 +103,41 @@ UNIT_TEST(ParticalUploadDataTest)
 
   delete buffer;
 }
+
+UNIT_TEST(PooledBufferReuseTest)
+{
+  GPUBufferPool & pool = GPUBufferPool::Instance();
+  pool.Enable(4096);
+
+  {
+    InSequence s;
+    // Storage of the pooled buffer is rounded up to the size class.
+    EXPECTGL(glGenBuffer()).WillOnce(Return(1));
+    EXPECTGL(glBindBuffer(1, gl_const::GLArrayBuffer));
+    EXPECTGL(glBufferData(gl_const::GLArrayBuffer, 2048, NULL, gl_const::GLStaticDraw));
+    EXPECTGL(glBindBuffer(0, gl_const::GLArrayBuffer));
+    // The buffer of the same size class is taken from the pool.
+    EXPECTGL(glBindBuffer(0, gl_const::GLArrayBuffer));
+    // The pool is full.
+    EXPECTGL(glGenBuffer()).WillOnce(Return(2));
+    EXPECTGL(glBindBuffer(2, gl_const::GLArrayBuffer));
+    EXPECTGL(glBufferData(gl_const::GLArrayBuffer, 4096, NULL, gl_const::GLStaticDraw));
+    EXPECTGL(glBindBuffer(0, gl_const::GLArrayBuffer));
+    EXPECTGL(glDeleteBuffer(2));
+    EXPECTGL(glDeleteBuffer(1));
+  }
+
+  delete new DataBuffer(3 * sizeof(float), 100);
+  TEST_EQUAL(pool.GetFreeBytes(), 2048, ());
+
+  delete new DataBuffer(3 * sizeof(float), 150);
+  TEST_EQUAL(pool.GetFreeBytes(), 2048, ());
+
+  GPUBuffer * buffer = new DataBuffer(3 * sizeof(float), 300);
+  TEST_EQUAL(pool.GetFreeBytes(), 2048, ());
+  delete buffer;
+
+  pool.Disable();
+  TEST_EQUAL(pool.GetFreeBytes(), 0, ());
+  TEST(!pool.IsEnabled(), ());
+}
@@ -29,12 +29,16 @@ SOURCES += \
     compile_shaders_test.cpp \
     batcher_tests.cpp \
     pointers_tests.cpp \
+    pooled_object_tests.cpp \
     bingind_info_tests.cpp \
     stipple_pen_tests.cpp \
     texture_of_colors_tests.cpp \
+    glyph_cache_tests.cpp \
+    program_binary_cache_tests.cpp \
     glyph_mng_tests.cpp \
     glyph_packer_test.cpp \
     font_texture_tests.cpp \
+    overlay_tree_tests.cpp \
     img.cpp \
 
 HEADERS += \
@@ -254,8 +254,53 @@ void GLFunctions::glUniformValueiv(int8_t location, int32_t * v, uint32_t size)
 
 void * GLFunctions::glMapBuffer(glConst target) { return 0; }
 
+void * GLFunctions::glMapBufferRange(glConst target, uint32_t offset, uint32_t length, glConst access)
+{
+  return 0;
+}
+
 void GLFunctions::glUnmapBuffer(glConst target) {}
 
+void * GLFunctions::glFenceSync() { return 0; }
+
+bool GLFunctions::glIsSyncSignaled(void * sync) { return false; }
+
+void GLFunctions::glDeleteSync(void * sync) {}
+
 void GLFunctions::glDrawElements(uint16_t indexCount) {}
 
+void GLFunctions::glDrawElementsInstanced(uint16_t indexCount, uint32_t instanceCount)
+{
+  MOCK_CALL(glDrawElementsInstanced(indexCount, instanceCount));
+}
+
+void GLFunctions::glVertexAttributeDivisor(int32_t attrLocation, uint32_t divisor)
+{
+  MOCK_CALL(glVertexAttributeDivisor(attrLocation, divisor));
+}
+
+string GLFunctions::glGetString(glConst pname) { return string(); }
+
+bool GLFunctions::glGetProgramBinary(uint32_t programID, glConst & format, vector<uint8_t> & binary)
+{
+  return false;
+}
+
+bool GLFunctions::glProgramBinary(uint32_t programID, glConst format, void const * binary, uint32_t size)
+{
+  return false;
+}
+
+uint32_t GLFunctions::glGenQuery() { return 0; }
+
+void GLFunctions::glDeleteQuery(uint32_t id) {}
+
+void GLFunctions::glBeginTimeElapsedQuery(uint32_t id) {}
+
+void GLFunctions::glEndTimeElapsedQuery() {}
+
+bool GLFunctions::glIsQueryResultAvailable(uint32_t id) { return false; }
+
+uint64_t GLFunctions::glGetQueryResult(uint32_t id) { return 0; }
+
 void GLFunctions::glPixelStore(glConst name, uint32_t value) {}
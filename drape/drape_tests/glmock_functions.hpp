@@ -60,6 +60,8 @@ public:
                                              bool needNormalize,
                                              uint32_t stride,
                                              uint32_t offset));
+  MOCK_METHOD2(glVertexAttributeDivisor, void(int32_t attrLocation, uint32_t divisor));
+  MOCK_METHOD2(glDrawElementsInstanced, void(uint16_t indexCount, uint32_t instanceCount));
 
   MOCK_METHOD1(glUseProgram, void(uint32_t programID));
   MOCK_METHOD1(glHasExtension, bool(string const & extName));
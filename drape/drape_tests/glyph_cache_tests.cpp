@@ -0,0 +1,63 @@
+#include "testing/testing.hpp"
+
+#include "drape/glyph_cache.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/internal/file_data.hpp"
+
+namespace
+{
+dp::GlyphCache::Entry MakeEntry(float advance, uint32_t width, uint32_t height)
+{
+  dp::GlyphCache::Entry entry;
+  entry.m_metrics = dp::GlyphManager::GlyphMetrics{advance, 0.0f, 1.5f, -2.0f, true};
+  entry.m_width = width;
+  entry.m_height = height;
+  for (uint32_t i = 0; i < width * height; ++i)
+    entry.m_image.push_back(static_cast<uint8_t>(i * 7));
+  return entry;
+}
+
+void TestEntry(dp::GlyphCache const & cache, strings::UniChar c, dp::GlyphCache::Entry const & expected)
+{
+  dp::GlyphCache::Entry const * entry = cache.Find(c);
+  TEST(entry != nullptr, (c));
+  TEST_EQUAL(entry->m_metrics.m_xAdvance, expected.m_metrics.m_xAdvance, ());
+  TEST_EQUAL(entry->m_metrics.m_xOffset, expected.m_metrics.m_xOffset, ());
+  TEST_EQUAL(entry->m_metrics.m_yOffset, expected.m_metrics.m_yOffset, ());
+  TEST(entry->m_metrics.m_isValid, ());
+  TEST_EQUAL(entry->m_width, expected.m_width, ());
+  TEST_EQUAL(entry->m_height, expected.m_height, ());
+  TEST_EQUAL(entry->m_image, expected.m_image, ());
+}
+}  // namespace
+
+UNIT_TEST(GlyphCache_SaveLoad)
+{
+  string const filePath = GetPlatform().WritablePathForFile("glyph_cache_test.cache");
+
+  dp::GlyphCache::Entry const letter = MakeEntry(10.0f, 5, 7);
+  dp::GlyphCache::Entry const space = MakeEntry(4.0f, 0, 0);
+  {
+    dp::GlyphCache cache(filePath, "fonts 1");
+    TEST(!cache.Load(), ());
+    cache.Add(0x41, dp::GlyphCache::Entry(letter));
+    cache.Add(0x20, dp::GlyphCache::Entry(space));
+    cache.Save();
+  }
+
+  dp::GlyphCache cache(filePath, "fonts 1");
+  TEST(cache.Load(), ());
+  TEST_EQUAL(cache.GetCount(), 2, ());
+  TestEntry(cache, 0x41, letter);
+  TestEntry(cache, 0x20, space);
+  TEST(cache.Find(0x42) == nullptr, ());
+
+  // The cache of the other fonts is ignored.
+  dp::GlyphCache otherCache(filePath, "fonts 2");
+  TEST(!otherCache.Load(), ());
+  TEST_EQUAL(otherCache.GetCount(), 0, ());
+
+  TEST(my::DeleteFileX(filePath), ());
+}
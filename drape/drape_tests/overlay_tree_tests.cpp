@@ -0,0 +1,184 @@
+#include "testing/testing.hpp"
+
+#include "drape/overlay_tree.hpp"
+
+#include "geometry/any_rect2d.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include "std/random.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+typedef vector<unique_ptr<dp::OverlayHandle>> THandles;
+
+ScreenBase MakeScreen(int width, int height)
+{
+  ScreenBase screen;
+  screen.OnSize(0, 0, width, height);
+  screen.SetFromRect(m2::AnyRectD(m2::RectD(0, 0, width, height)));
+  return screen;
+}
+
+void MakeHandles(int count, int width, int height, uint32_t seed, THandles & handles)
+{
+  mt19937 rnd(seed);
+  uniform_int_distribution<int> x(-50, width + 50);
+  uniform_int_distribution<int> y(-50, height + 50);
+  uniform_int_distribution<int> size(4, 80);
+  // Priorities repeat to check that equal priorities are resolved the same way.
+  uniform_int_distribution<int> priority(0, count / 4);
+
+  // m4::Tree misses the touching rects sometimes, so the sizes are chosen never to be touching.
+  double const kSizeShift = 0.3;
+
+  for (int i = 0; i < count; ++i)
+  {
+    m2::PointD const pxSize(size(rnd) + kSizeShift, size(rnd) + kSizeShift);
+    handles.emplace_back(new dp::SquareHandle(FeatureID(), dp::Center, m2::PointD(x(rnd), y(rnd)),
+                                              pxSize, priority(rnd)));
+  }
+}
+
+/// The placing on m4::Tree, the OverlayTree was built on it before.
+class TreePlacing
+{
+  struct Traits
+  {
+    ScreenBase m_modelView;
+
+    m2::RectD const LimitRect(dp::OverlayHandle * handle)
+    {
+      return handle->GetPixelRect(m_modelView);
+    }
+  };
+
+public:
+  void Place(ScreenBase const & screen, THandles const & handles)
+  {
+    m4::Tree<dp::OverlayHandle *, Traits> tree;
+    for (unique_ptr<dp::OverlayHandle> const & handle : handles)
+    {
+      handle->SetIsVisible(false);
+      m2::RectD const pixelRect = handle->GetPixelRect(screen);
+      if (!screen.PixelRect().IsIntersect(pixelRect))
+        continue;
+
+      vector<dp::OverlayHandle *> elements;
+      tree.ForEachInRect(pixelRect, [&](dp::OverlayHandle * r)
+      {
+        if (handle->IsIntersect(screen, *r))
+          elements.push_back(r);
+      });
+
+      bool isHidden = false;
+      for (dp::OverlayHandle * element : elements)
+        isHidden = isHidden || handle->GetPriority() < element->GetPriority();
+      if (isHidden)
+        continue;
+
+      for (dp::OverlayHandle * element : elements)
+        tree.Erase(element, element->GetPixelRect(screen));
+      tree.Add(handle.get(), pixelRect);
+    }
+
+    tree.ForEach([](dp::OverlayHandle * handle)
+    {
+      handle->SetIsVisible(true);
+    });
+  }
+};
+
+void Place(dp::OverlayTree & tree, ScreenBase const & screen, THandles const & handles)
+{
+  tree.StartOverlayPlacing(screen);
+  for (unique_ptr<dp::OverlayHandle> const & handle : handles)
+    tree.Add(dp::MakeStackRefPointer(handle.get()));
+  tree.EndOverlayPlacing();
+}
+
+vector<bool> GetVisibility(THandles const & handles)
+{
+  vector<bool> visibility;
+  for (unique_ptr<dp::OverlayHandle> const & handle : handles)
+    visibility.push_back(handle->IsVisible());
+  return visibility;
+}
+}  // namespace
+
+UNIT_TEST(OverlayTree_SameAsTreePlacing)
+{
+  int const kWidth = 1024;
+  int const kHeight = 768;
+  ScreenBase const screen = MakeScreen(kWidth, kHeight);
+
+  THandles handles;
+  MakeHandles(2000, kWidth, kHeight, 1, handles);
+
+  TreePlacing().Place(screen, handles);
+  vector<bool> const expected = GetVisibility(handles);
+
+  dp::OverlayTree tree;
+  Place(tree, screen, handles);
+  TEST_EQUAL(GetVisibility(handles), expected, ());
+
+  // The same frame is reused.
+  Place(tree, screen, handles);
+  TEST_EQUAL(GetVisibility(handles), expected, ());
+
+  // Changed handles are placed again.
+  handles.pop_back();
+  MakeHandles(100, kWidth, kHeight, 2, handles);
+  TreePlacing().Place(screen, handles);
+  vector<bool> const changed = GetVisibility(handles);
+  Place(tree, screen, handles);
+  TEST_EQUAL(GetVisibility(handles), changed, ());
+
+  ScreenBase moved = screen;
+  moved.Move(100.0, 50.0);
+  TreePlacing().Place(moved, handles);
+  vector<bool> const movedExpected = GetVisibility(handles);
+  Place(tree, moved, handles);
+  TEST_EQUAL(GetVisibility(handles), movedExpected, ());
+}
+
+UNIT_TEST(OverlayTree_Benchmark)
+{
+  int const kWidth = 1920;
+  int const kHeight = 1080;
+  int const kFrames = 10;
+  ScreenBase screen = MakeScreen(kWidth, kHeight);
+
+  THandles handles;
+  MakeHandles(5000, kWidth, kHeight, 3, handles);
+
+  my::Timer timer;
+  TreePlacing treePlacing;
+  for (int i = 0; i < kFrames; ++i)
+  {
+    screen.Move(1.0, 0.0);
+    treePlacing.Place(screen, handles);
+  }
+  double const treeTime = timer.ElapsedSeconds();
+
+  timer.Reset();
+  dp::OverlayTree tree;
+  for (int i = 0; i < kFrames; ++i)
+  {
+    screen.Move(-1.0, 0.0);
+    Place(tree, screen, handles);
+  }
+  double const gridTime = timer.ElapsedSeconds();
+
+  timer.Reset();
+  for (int i = 0; i < kFrames; ++i)
+    Place(tree, screen, handles);
+  double const reuseTime = timer.ElapsedSeconds();
+
+  LOG(LINFO, ("Overlays placing of", handles.size(), "handles per frame, m4::Tree:", treeTime / kFrames,
+              "grid:", gridTime / kFrames, "reused frame:", reuseTime / kFrames));
+}
@@ -0,0 +1,83 @@
+#include "testing/testing.hpp"
+
+#include "drape/pooled_object.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/thread.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+
+class Pooled : public dp::PooledObject
+{
+public:
+  explicit Pooled(uint64_t value) : m_value(value), m_check(~value) {}
+  virtual ~Pooled() {}
+
+  bool IsValid() const { return m_value == ~m_check; }
+  uint64_t GetValue() const { return m_value; }
+
+private:
+  uint64_t m_value;
+  uint64_t m_check;
+};
+
+class BigPooled : public Pooled
+{
+public:
+  explicit BigPooled(uint64_t value) : Pooled(value) { fill(begin(m_data), end(m_data), 'a'); }
+
+private:
+  char m_data[dp::SmallObjectPool::kMaxObjectSize];
+};
+
+} // namespace
+
+UNIT_TEST(PooledObject_Reuse)
+{
+  Pooled * p1 = new Pooled(1);
+  TEST_EQUAL(reinterpret_cast<uintptr_t>(p1) % 8, 0, ());
+  delete p1;
+  Pooled * p2 = new Pooled(2);
+  TEST_EQUAL(p1, p2, ());
+  TEST(p2->IsValid(), ());
+  delete p2;
+
+  // Objects above the size classes go to the global heap.
+  Pooled * big = new BigPooled(3);
+  TEST(big->IsValid(), ());
+  TEST_EQUAL(big->GetValue(), 3, ());
+  delete big;
+}
+
+UNIT_TEST(PooledObject_Threads)
+{
+  size_t const kThreadsCount = 4;
+  size_t const kObjectsCount = 10000;
+  vector<thread> threads;
+  vector<bool> isValid(kThreadsCount, true);
+  for (size_t t = 0; t < kThreadsCount; ++t)
+  {
+    threads.emplace_back([t, &isValid]()
+    {
+      vector<Pooled *> objects;
+      for (size_t round = 0; round < 10; ++round)
+      {
+        for (size_t i = 0; i < kObjectsCount; ++i)
+          objects.push_back(new Pooled(t * kObjectsCount + i));
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+          if (!objects[i]->IsValid() || objects[i]->GetValue() != t * kObjectsCount + i)
+            isValid[t] = false;
+          delete objects[i];
+        }
+        objects.clear();
+      }
+    });
+  }
+  for (thread & t : threads)
+    t.join();
+  for (size_t t = 0; t < kThreadsCount; ++t)
+    TEST(isValid[t], (t));
+}
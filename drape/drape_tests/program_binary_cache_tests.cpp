@@ -0,0 +1,56 @@
+#include "testing/testing.hpp"
+
+#include "drape/program_binary_cache.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/internal/file_data.hpp"
+
+namespace
+{
+dp::ProgramBinaryCache::Entry MakeEntry(uint32_t format, string const & sourcesHash, size_t size)
+{
+  dp::ProgramBinaryCache::Entry entry;
+  entry.m_format = format;
+  entry.m_sourcesHash = sourcesHash;
+  for (size_t i = 0; i < size; ++i)
+    entry.m_binary.push_back(static_cast<uint8_t>(i * 13));
+  return entry;
+}
+}  // namespace
+
+UNIT_TEST(ProgramBinaryCache_SaveLoad)
+{
+  string const filePath = GetPlatform().WritablePathForFile("program_binary_cache_test.bin");
+  string const hash = dp::ProgramBinaryCache::GetSourcesHash("vertex", "fragment");
+  TEST_NOT_EQUAL(hash, dp::ProgramBinaryCache::GetSourcesHash("vertexf", "ragment"), ());
+
+  dp::ProgramBinaryCache::Entry const line = MakeEntry(0x8E21, hash, 1000);
+  {
+    dp::ProgramBinaryCache cache(filePath, "driver 1");
+    TEST(!cache.Load(), ());
+    cache.Add(3, dp::ProgramBinaryCache::Entry(line));
+    cache.Add(5, MakeEntry(0x8E21, hash, 10));
+    cache.Remove(5);
+    cache.Save();
+  }
+
+  dp::ProgramBinaryCache cache(filePath, "driver 1");
+  TEST(cache.Load(), ());
+  TEST_EQUAL(cache.GetCount(), 1, ());
+  dp::ProgramBinaryCache::Entry const * entry = cache.Find(3, hash);
+  TEST(entry != nullptr, ());
+  TEST_EQUAL(entry->m_format, line.m_format, ());
+  TEST_EQUAL(entry->m_binary, line.m_binary, ());
+
+  // Binaries of the changed shaders aren't used.
+  TEST(cache.Find(3, dp::ProgramBinaryCache::GetSourcesHash("vertex", "changed")) == nullptr, ());
+  TEST(cache.Find(5, hash) == nullptr, ());
+
+  // The cache of the other driver is ignored.
+  dp::ProgramBinaryCache otherCache(filePath, "driver 2");
+  TEST(!otherCache.Load(), ());
+  TEST_EQUAL(otherCache.GetCount(), 0, ());
+
+  TEST(my::DeleteFileX(filePath), ());
+}
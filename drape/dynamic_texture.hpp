@@ -27,6 +27,8 @@ public:
   virtual void UpdateState()
   {
     ASSERT(!m_indexer.IsNull(), ());
+    if (!m_indexer->HasPendingResources())
+      return;
 
     Bind();
     m_indexer->UploadResources(MakeStackRefPointer<Texture>(this));
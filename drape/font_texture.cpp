@@ -93,8 +93,13 @@ RefPointer<Texture::ResourceInfo> GlyphIndex::MapResource(GlyphKey const & key)
   m2::RectU r;
   if (!m_packer.PackGlyph(glyph.m_image.m_width, glyph.m_image.m_height, r))
   {
-    glyph.m_image.Destroy();
-    return RefPointer<GlyphInfo>();
+    if (glyph.m_image.m_data)
+      glyph.m_image.Destroy();
+    LOG(LWARNING, ("Glyph texture is full, glyph", uniChar, "isn't drawn"));
+    // The empty glyph is remembered, so the glyph isn't rasterized again.
+    GlyphManager::GlyphMetrics const emptyMetrics = {0.0f, 0.0f, 0.0f, 0.0f, false};
+    auto res = m_index.emplace(uniChar, GlyphInfo(m2::RectF(0.0f, 0.0f, 0.0f, 0.0f), emptyMetrics));
+    return MakeStackRefPointer<GlyphInfo>(&res.first->second);
   }
 
   m_pendingNodes.emplace_back(r, glyph);
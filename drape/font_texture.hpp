@@ -62,9 +62,10 @@ class GlyphIndex
 public:
   GlyphIndex(m2::PointU size, RefPointer<GlyphManager> mng);
 
-  /// can return nullptr
+  /// Returns an empty glyph when the texture is full.
   RefPointer<Texture::ResourceInfo> MapResource(GlyphKey const & key);
   void UploadResources(RefPointer<Texture> texture);
+  bool HasPendingResources() const { return !m_pendingNodes.empty(); }
 
   glConst GetMinFilter() const { return gl_const::GLLinear; }
   glConst GetMagFilter() const { return gl_const::GLLinear; }
@@ -0,0 +1,61 @@
+#include "drape/frame_fences.hpp"
+#include "drape/glextensions_list.hpp"
+#include "drape/glfunctions.hpp"
+
+namespace dp
+{
+
+// static
+FrameFences & FrameFences::Instance()
+{
+  static FrameFences fences;
+  return fences;
+}
+
+FrameFences::FrameFences()
+  : m_currentFrame(1)
+  , m_completedFrame(0)
+{
+}
+
+void FrameFences::EndFrame()
+{
+  if (GLExtensionsList::Instance().IsSupported(GLExtensionsList::Sync))
+  {
+    void * sync = GLFunctions::glFenceSync();
+    if (sync != nullptr)
+      m_fences.emplace_back(m_currentFrame, sync);
+    // Polled here too, so the fences don't pile up when nobody asks for the frames.
+    PollFences();
+  }
+  ++m_currentFrame;
+}
+
+bool FrameFences::IsFrameCompleted(uint64_t frame)
+{
+  if (frame > m_completedFrame)
+    PollFences();
+  return frame <= m_completedFrame;
+}
+
+void FrameFences::Release()
+{
+  for (auto const & fence : m_fences)
+    GLFunctions::glDeleteSync(fence.second);
+  m_fences.clear();
+  // Frames of the old context are never used again.
+  m_completedFrame = m_currentFrame - 1;
+}
+
+void FrameFences::PollFences()
+{
+  // The GPU executes the frames in order, so the fences are signaled in order too.
+  while (!m_fences.empty() && GLFunctions::glIsSyncSignaled(m_fences.front().second))
+  {
+    m_completedFrame = m_fences.front().first;
+    GLFunctions::glDeleteSync(m_fences.front().second);
+    m_fences.pop_front();
+  }
+}
+
+} // namespace dp
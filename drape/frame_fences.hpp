@@ -0,0 +1,41 @@
+#pragma once
+
+#include "std/cstdint.hpp"
+#include "std/deque.hpp"
+#include "std/noncopyable.hpp"
+#include "std/utility.hpp"
+
+namespace dp
+{
+
+/// Frames which are completed by the GPU. A fence is inserted at the end of each frame, so
+/// the buffers which are written on a frame are rewritten without waiting when it's completed.
+/// It's used on the rendering thread only. Without GLExtensionsList::Sync the frames which
+/// are rendered aren't known as completed.
+class FrameFences : private noncopyable
+{
+public:
+  static FrameFences & Instance();
+
+  /// Index of the frame which is rendered now, frames start from 1.
+  uint64_t GetCurrentFrame() const { return m_currentFrame; }
+  void EndFrame();
+
+  /// @return True when the GPU has executed all the commands of the frame.
+  /// Frame 0 is always completed.
+  bool IsFrameCompleted(uint64_t frame);
+
+  /// Deletes the fences, it must be called before the context is destroyed.
+  void Release();
+
+private:
+  FrameFences();
+
+  void PollFences();
+
+  deque<pair<uint64_t, void *>> m_fences;
+  uint64_t m_currentFrame;
+  uint64_t m_completedFrame;
+};
+
+} // namespace dp
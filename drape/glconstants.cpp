@@ -33,6 +33,31 @@
   #define WRITE_ONLY_DEF 0x88B9
 #endif
 
+#if defined(GL_MAP_WRITE_BIT)
+  #define MAP_WRITE_BIT_DEF GL_MAP_WRITE_BIT
+  #define MAP_UNSYNCHRONIZED_BIT_DEF GL_MAP_UNSYNCHRONIZED_BIT
+#elif defined(GL_MAP_WRITE_BIT_EXT)
+  #define MAP_WRITE_BIT_DEF GL_MAP_WRITE_BIT_EXT
+  #define MAP_UNSYNCHRONIZED_BIT_DEF GL_MAP_UNSYNCHRONIZED_BIT_EXT
+#else
+  #define MAP_WRITE_BIT_DEF 0x0002
+  #define MAP_UNSYNCHRONIZED_BIT_DEF 0x0020
+#endif
+
+#if defined(GL_NUM_PROGRAM_BINARY_FORMATS)
+  #define NUM_PROGRAM_BINARY_FORMATS_DEF GL_NUM_PROGRAM_BINARY_FORMATS
+#elif defined(GL_NUM_PROGRAM_BINARY_FORMATS_OES)
+  #define NUM_PROGRAM_BINARY_FORMATS_DEF GL_NUM_PROGRAM_BINARY_FORMATS_OES
+#else
+  #define NUM_PROGRAM_BINARY_FORMATS_DEF 0x87FE
+#endif
+
+#if defined(GL_PIXEL_UNPACK_BUFFER)
+  #define PIXEL_UNPACK_BUFFER_DEF GL_PIXEL_UNPACK_BUFFER
+#else
+  #define PIXEL_UNPACK_BUFFER_DEF 0x88EC
+#endif
+
 namespace gl_const
 {
 
@@ -41,11 +66,19 @@ const glConst GLUnpackAlignment     = GL_UNPACK_ALIGNMENT;
 const glConst GLMaxFragmentTextures = GL_MAX_TEXTURE_IMAGE_UNITS;
 const glConst GLMaxVertexTextures   = GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS;
 const glConst GLMaxTextureSize      = GL_MAX_TEXTURE_SIZE;
+const glConst GLNumProgramBinaryFormats = NUM_PROGRAM_BINARY_FORMATS_DEF;
+
+const glConst GLVendor              = GL_VENDOR;
+const glConst GLRenderer            = GL_RENDERER;
+const glConst GLVersion             = GL_VERSION;
 
 const glConst GLArrayBuffer         = GL_ARRAY_BUFFER;
 const glConst GLElementArrayBuffer  = GL_ELEMENT_ARRAY_BUFFER;
+const glConst GLPixelUnpackBuffer   = PIXEL_UNPACK_BUFFER_DEF;
 
 const glConst GLWriteOnly           = WRITE_ONLY_DEF;
+const glConst GLMapWriteBit         = MAP_WRITE_BIT_DEF;
+const glConst GLMapUnsynchronizedBit = MAP_UNSYNCHRONIZED_BIT_DEF;
 
 const glConst GLStaticDraw          = GL_STATIC_DRAW;
 const glConst GLStreamDraw          = GL_STREAM_DRAW;
@@ -12,13 +12,23 @@ extern const glConst GLUnpackAlignment;
 extern const glConst GLMaxFragmentTextures;
 extern const glConst GLMaxVertexTextures;
 extern const glConst GLMaxTextureSize;
+extern const glConst GLNumProgramBinaryFormats;
+
+/// Driver description strings
+extern const glConst GLVendor;
+extern const glConst GLRenderer;
+extern const glConst GLVersion;
 
 /// Buffer targets
 extern const glConst GLArrayBuffer;
 extern const glConst GLElementArrayBuffer;
+extern const glConst GLPixelUnpackBuffer;
 
 /// VBO Access
 extern const glConst GLWriteOnly;
+/// Access bits of glMapBufferRange
+extern const glConst GLMapWriteBit;
+extern const glConst GLMapUnsynchronizedBit;
 
 /// BufferUsage
 extern const glConst GLStaticDraw;
@@ -16,7 +16,12 @@ namespace dp
   public:
     void CheckExtension(GLExtensionsList::ExtensionName const & enumName, const string & extName)
     {
-      m_supportedMap[enumName] = GLFunctions::glHasExtension(extName);
+      SetSupported(enumName, GLFunctions::glHasExtension(extName));
+    }
+
+    void SetSupported(GLExtensionsList::ExtensionName const & enumName, bool isSupported)
+    {
+      m_supportedMap[enumName] = isSupported;
     }
 
     bool IsSupported(GLExtensionsList::ExtensionName const & enumName) const
@@ -40,7 +45,12 @@ namespace dp
   public:
     void CheckExtension(GLExtensionsList::ExtensionName const & enumName, const string & extName)
     {
-      if (GLFunctions::glHasExtension(extName))
+      SetSupported(enumName, GLFunctions::glHasExtension(extName));
+    }
+
+    void SetSupported(GLExtensionsList::ExtensionName const & enumName, bool isSupported)
+    {
+      if (isSupported)
         m_supported.insert(enumName);
     }
 
@@ -65,11 +75,51 @@ GLExtensionsList::GLExtensionsList()
   m_impl->CheckExtension(TextureNPOT, "GL_OES_texture_npot");
   m_impl->CheckExtension(RequiredInternalFormat, "GL_OES_required_internalformat");
   m_impl->CheckExtension(MapBuffer, "GL_OES_mapbuffer");
+  // GL_EXT_disjoint_timer_query functions aren't loaded by GLFunctions.
+  m_impl->SetSupported(TimerQuery, false);
+#if defined(OMIM_OS_IPHONE)
+  m_impl->CheckExtension(InstancedArrays, "GL_EXT_instanced_arrays");
+#else
+  // Instancing functions aren't loaded on Android.
+  m_impl->SetSupported(InstancedArrays, false);
+#endif
+#if defined(OMIM_OS_IPHONE)
+  // There are no program binaries formats on iOS.
+  m_impl->SetSupported(ProgramBinary, false);
+#else
+  m_impl->CheckExtension(ProgramBinary, "GL_OES_get_program_binary");
+#endif
+  // Pixel unpack buffers are in OpenGL ES 3.0 only.
+  m_impl->SetSupported(PixelBufferObject, false);
+  // Buffer ranges and sync objects functions aren't loaded on mobile platforms.
+  m_impl->SetSupported(MapBufferRange, false);
+  m_impl->SetSupported(Sync, false);
 #else
   m_impl->CheckExtension(VertexArrayObject, "GL_APPLE_vertex_array_object");
   m_impl->CheckExtension(TextureNPOT, "GL_ARB_texture_non_power_of_two");
   m_impl->CheckExtension(RequiredInternalFormat, "GL_OES_required_internalformat");
   m_impl->CheckExtension(MapBuffer, "GL_OES_mapbuffer");
+#if defined(OMIM_OS_MAC)
+  m_impl->CheckExtension(TimerQuery, "GL_EXT_timer_query");
+#else
+  m_impl->CheckExtension(TimerQuery, "GL_ARB_timer_query");
+#endif
+  m_impl->CheckExtension(InstancedArrays, "GL_ARB_instanced_arrays");
+#if defined(OMIM_OS_MAC)
+  // Program binaries functions aren't loaded on Mac, there is no such extension in the legacy profile.
+  m_impl->SetSupported(ProgramBinary, false);
+#else
+  m_impl->CheckExtension(ProgramBinary, "GL_ARB_get_program_binary");
+#endif
+  m_impl->CheckExtension(PixelBufferObject, "GL_ARB_pixel_buffer_object");
+#if defined(OMIM_OS_MAC)
+  // There are no such functions in the legacy profile.
+  m_impl->SetSupported(MapBufferRange, false);
+  m_impl->SetSupported(Sync, false);
+#else
+  m_impl->CheckExtension(MapBufferRange, "GL_ARB_map_buffer_range");
+  m_impl->CheckExtension(Sync, "GL_ARB_sync");
+#endif
 #endif
 }
 
@@ -13,7 +13,13 @@ public:
     VertexArrayObject,
     TextureNPOT,
     RequiredInternalFormat,
-    MapBuffer
+    MapBuffer,
+    TimerQuery,
+    InstancedArrays,
+    ProgramBinary,
+    PixelBufferObject,
+    MapBufferRange,
+    Sync
   };
 
   static GLExtensionsList & Instance();
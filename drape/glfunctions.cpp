@@ -43,6 +43,19 @@ namespace
   void (APIENTRY *glBindVertexArrayFn)(GLuint id)                                                                  = NULL;
   void (APIENTRY *glDeleteVertexArrayFn)(GLsizei n, GLuint const * ids)                                            = NULL;
 
+  /// Timer queries
+  void (APIENTRY *glGenQueriesFn)(GLsizei n, GLuint * ids)                                                         = NULL;
+  void (APIENTRY *glDeleteQueriesFn)(GLsizei n, GLuint const * ids)                                                = NULL;
+  void (APIENTRY *glBeginQueryFn)(GLenum target, GLuint id)                                                        = NULL;
+  void (APIENTRY *glEndQueryFn)(GLenum target)                                                                     = NULL;
+  void (APIENTRY *glGetQueryObjectuivFn)(GLuint id, GLenum name, GLuint * p)                                       = NULL;
+  void (APIENTRY *glGetQueryObjectui64vFn)(GLuint id, GLenum name, uint64_t * p)                                   = NULL;
+
+  /// Sync objects
+  void * (APIENTRY *glFenceSyncFn)(GLenum condition, GLbitfield flags)                                             = NULL;
+  GLenum (APIENTRY *glClientWaitSyncFn)(void * sync, GLbitfield flags, uint64_t timeout)                           = NULL;
+  void (APIENTRY *glDeleteSyncFn)(void * sync)                                                                     = NULL;
+
   /// VBO
   void (APIENTRY *glGenBuffersFn)(GLsizei n, GLuint * buffers)                                                     = NULL;
   void (APIENTRY *glBindBufferFn)(GLenum target, GLuint buffer)                                                    = NULL;
@@ -50,6 +63,7 @@ namespace
   void (APIENTRY *glBufferDataFn)(GLenum target, GLsizeiptr size, GLvoid const * data, GLenum usage)               = NULL;
   void (APIENTRY *glBufferSubDataFn)(GLenum target, GLintptr offset, GLsizeiptr size, GLvoid const * data)         = NULL;
   void * (APIENTRY *glMapBufferFn)(GLenum target, GLenum access)                                                   = NULL;
+  void * (APIENTRY *glMapBufferRangeFn)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)      = NULL;
   GLboolean (APIENTRY *glUnmapBufferFn)(GLenum target)                                                             = NULL;
 
   /// Shaders
@@ -68,6 +82,11 @@ namespace
   void (APIENTRY *glGetProgramivFn)(GLuint programID, GLenum name, GLint * p)                                      = NULL;
   void (APIENTRY *glGetProgramInfoLogFn)(GLuint programID, GLsizei maxLength, GLsizei * length, GLchar * infoLog)  = NULL;
 
+  /// Program binaries
+  void (APIENTRY *glGetProgramBinaryFn)(GLuint programID, GLsizei bufSize, GLsizei * length,
+                                        GLenum * format, GLvoid * binary)                                         = NULL;
+  void (APIENTRY *glProgramBinaryFn)(GLuint programID, GLenum format, GLvoid const * binary, GLint length)         = NULL;
+
   void (APIENTRY *glUseProgramFn)(GLuint programID)                                                                = NULL;
   GLint (APIENTRY *glGetAttribLocationFn)(GLuint program, GLchar const * name)                                     = NULL;
   void (APIENTRY *glBindAttribLocationFn)(GLuint program, GLuint index, GLchar const * name)                       = NULL;
@@ -80,6 +99,11 @@ namespace
                                      GLsizei stride,
                                      GLvoid const * p)                                                    = NULL;
 
+  /// Instancing
+  void (APIENTRY *glVertexAttribDivisorFn)(GLuint index, GLuint divisor)                                           = NULL;
+  void (APIENTRY *glDrawElementsInstancedFn)(GLenum mode, GLsizei count, GLenum type,
+                                             GLvoid const * indices, GLsizei instanceCount)                       = NULL;
+
   GLint (APIENTRY *glGetUniformLocationFn)(GLuint programID, GLchar const * name)                                  = NULL;
 
   void (APIENTRY *glGetActiveUniformFn)(GLuint programID,
@@ -104,6 +128,39 @@ namespace
 
   void (APIENTRY *glUniformMatrix4fvFn)(GLint location, GLsizei count, GLboolean transpose, GLfloat const * value) = NULL;
 
+#if defined(OMIM_OS_MOBILE)
+  // Timer queries functions aren't loaded on mobile platforms.
+  int const GLTimeElapsed = 0;
+  int const GLQueryResult = 0;
+  int const GLQueryResultAvailable = 0;
+#else
+  #if defined(OMIM_OS_MAC)
+    int const GLTimeElapsed = GL_TIME_ELAPSED_EXT;
+  #else
+    int const GLTimeElapsed = GL_TIME_ELAPSED;
+  #endif
+  int const GLQueryResult = GL_QUERY_RESULT;
+  int const GLQueryResultAvailable = GL_QUERY_RESULT_AVAILABLE;
+#endif
+
+#if defined(GL_PROGRAM_BINARY_LENGTH)
+  int const GLProgramBinaryLength = GL_PROGRAM_BINARY_LENGTH;
+#elif defined(GL_PROGRAM_BINARY_LENGTH_OES)
+  int const GLProgramBinaryLength = GL_PROGRAM_BINARY_LENGTH_OES;
+#else
+  int const GLProgramBinaryLength = 0x8741;
+#endif
+
+#if defined(GL_SYNC_GPU_COMMANDS_COMPLETE)
+  int const GLSyncGpuCommandsComplete = GL_SYNC_GPU_COMMANDS_COMPLETE;
+  int const GLAlreadySignaled = GL_ALREADY_SIGNALED;
+  int const GLConditionSatisfied = GL_CONDITION_SATISFIED;
+#else
+  int const GLSyncGpuCommandsComplete = 0x9117;
+  int const GLAlreadySignaled = 0x911A;
+  int const GLConditionSatisfied = 0x911C;
+#endif
+
   int const GLCompileStatus = GL_COMPILE_STATUS;
   int const GLLinkStatus = GL_LINK_STATUS;
 }
@@ -117,18 +174,52 @@ void GLFunctions::Init()
   glDeleteVertexArrayFn = &glDeleteVertexArraysAPPLE;
   glMapBufferFn = &::glMapBuffer;
   glUnmapBufferFn = &::glUnmapBuffer;
+  glGenQueriesFn = &::glGenQueries;
+  glDeleteQueriesFn = &::glDeleteQueries;
+  glBeginQueryFn = &::glBeginQuery;
+  glEndQueryFn = &::glEndQuery;
+  glGetQueryObjectuivFn = &::glGetQueryObjectuiv;
+  glGetQueryObjectui64vFn = &::glGetQueryObjectui64vEXT;
+  glVertexAttribDivisorFn = &::glVertexAttribDivisorARB;
+  glDrawElementsInstancedFn = &::glDrawElementsInstancedARB;
 #elif defined(OMIM_OS_LINUX)
   glGenVertexArraysFn = &::glGenVertexArrays;
   glBindVertexArrayFn = &::glBindVertexArray;
   glDeleteVertexArrayFn = &::glDeleteVertexArrays;
   glMapBufferFn = &::glMapBuffer;  // I don't know correct name for linux!
   glUnmapBufferFn = &::glUnmapBuffer; // I don't know correct name for linux!
+  glGenQueriesFn = &::glGenQueries;
+  glDeleteQueriesFn = &::glDeleteQueries;
+  glBeginQueryFn = &::glBeginQuery;
+  glEndQueryFn = &::glEndQuery;
+  glGetQueryObjectuivFn = &::glGetQueryObjectuiv;
+  typedef void (APIENTRY *glGetQueryObjectui64v_Type)(GLuint id, GLenum name, uint64_t * p);
+  glGetQueryObjectui64vFn = reinterpret_cast<glGetQueryObjectui64v_Type>(&::glGetQueryObjectui64v);
+  glVertexAttribDivisorFn = &::glVertexAttribDivisor;
+  glDrawElementsInstancedFn = &::glDrawElementsInstanced;
+  glGetProgramBinaryFn = &::glGetProgramBinary;
+  glProgramBinaryFn = &::glProgramBinary;
+  typedef void * (APIENTRY *glMapBufferRange_Type)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+  glMapBufferRangeFn = reinterpret_cast<glMapBufferRange_Type>(&::glMapBufferRange);
+  typedef void * (APIENTRY *glFenceSync_Type)(GLenum condition, GLbitfield flags);
+  glFenceSyncFn = reinterpret_cast<glFenceSync_Type>(&::glFenceSync);
+  typedef GLenum (APIENTRY *glClientWaitSync_Type)(void * sync, GLbitfield flags, uint64_t timeout);
+  glClientWaitSyncFn = reinterpret_cast<glClientWaitSync_Type>(&::glClientWaitSync);
+  typedef void (APIENTRY *glDeleteSync_Type)(void * sync);
+  glDeleteSyncFn = reinterpret_cast<glDeleteSync_Type>(&::glDeleteSync);
 #elif defined(OMIM_OS_MOBILE)
   glGenVertexArraysFn = &glGenVertexArraysOES;
   glBindVertexArrayFn = &glBindVertexArrayOES;
   glDeleteVertexArrayFn = &glDeleteVertexArraysOES;
   glMapBufferFn = &::glMapBufferOES;
   glUnmapBufferFn = &::glUnmapBufferOES;
+#if defined(OMIM_OS_IPHONE)
+  glVertexAttribDivisorFn = &::glVertexAttribDivisorEXT;
+  glDrawElementsInstancedFn = &::glDrawElementsInstancedEXT;
+#else
+  glGetProgramBinaryFn = &::glGetProgramBinaryOES;
+  glProgramBinaryFn = &::glProgramBinaryOES;
+#endif
 #endif
 
   glBindFramebufferFn = &::glBindFramebuffer;
@@ -188,7 +279,7 @@ void GLFunctions::Init()
 
 bool GLFunctions::glHasExtension(string const & name)
 {
-  char const* extensions = reinterpret_cast<char const * >(glGetString(GL_EXTENSIONS));
+  char const* extensions = reinterpret_cast<char const * >(::glGetString(GL_EXTENSIONS));
   char const * extName = name.c_str();
   char const * ptr = NULL;
   while ((ptr = strstr(extensions, extName)) != NULL)
@@ -245,6 +336,13 @@ int32_t GLFunctions::glGetInteger(glConst pname)
   return (int32_t)value;
 }
 
+string GLFunctions::glGetString(glConst pname)
+{
+  char const * str = reinterpret_cast<char const *>(::glGetString(pname));
+  GLCHECKCALL();
+  return str == NULL ? string() : string(str);
+}
+
 void GLFunctions::glEnable(glConst mode)
 {
   GLCHECK(::glEnable(mode));
@@ -310,6 +408,70 @@ void GLFunctions::glDeleteVertexArray(uint32_t vao)
   GLCHECK(glDeleteVertexArrayFn(1, &vao));
 }
 
+uint32_t GLFunctions::glGenQuery()
+{
+  ASSERT(glGenQueriesFn != NULL, ());
+  GLuint result = 0;
+  GLCHECK(glGenQueriesFn(1, &result));
+  return result;
+}
+
+void GLFunctions::glDeleteQuery(uint32_t id)
+{
+  ASSERT(glDeleteQueriesFn != NULL, ());
+  GLCHECK(glDeleteQueriesFn(1, &id));
+}
+
+void GLFunctions::glBeginTimeElapsedQuery(uint32_t id)
+{
+  ASSERT(glBeginQueryFn != NULL, ());
+  GLCHECK(glBeginQueryFn(GLTimeElapsed, id));
+}
+
+void GLFunctions::glEndTimeElapsedQuery()
+{
+  ASSERT(glEndQueryFn != NULL, ());
+  GLCHECK(glEndQueryFn(GLTimeElapsed));
+}
+
+bool GLFunctions::glIsQueryResultAvailable(uint32_t id)
+{
+  ASSERT(glGetQueryObjectuivFn != NULL, ());
+  GLuint result = GL_FALSE;
+  GLCHECK(glGetQueryObjectuivFn(id, GLQueryResultAvailable, &result));
+  return result == GL_TRUE;
+}
+
+uint64_t GLFunctions::glGetQueryResult(uint32_t id)
+{
+  ASSERT(glGetQueryObjectui64vFn != NULL, ());
+  uint64_t result = 0;
+  GLCHECK(glGetQueryObjectui64vFn(id, GLQueryResult, &result));
+  return result;
+}
+
+void * GLFunctions::glFenceSync()
+{
+  ASSERT(glFenceSyncFn != NULL, ());
+  void * result = glFenceSyncFn(GLSyncGpuCommandsComplete, 0);
+  GLCHECKCALL();
+  return result;
+}
+
+bool GLFunctions::glIsSyncSignaled(void * sync)
+{
+  ASSERT(glClientWaitSyncFn != NULL, ());
+  GLenum const result = glClientWaitSyncFn(sync, 0, 0);
+  GLCHECKCALL();
+  return result == GLAlreadySignaled || result == GLConditionSatisfied;
+}
+
+void GLFunctions::glDeleteSync(void * sync)
+{
+  ASSERT(glDeleteSyncFn != NULL, ());
+  GLCHECK(glDeleteSyncFn(sync));
+}
+
 uint32_t GLFunctions::glGenBuffer()
 {
   ASSERT(glGenBuffersFn != NULL, ());
@@ -359,6 +521,14 @@ void * GLFunctions::glMapBuffer(glConst target)
   return result;
 }
 
+void * GLFunctions::glMapBufferRange(glConst target, uint32_t offset, uint32_t length, glConst access)
+{
+  ASSERT(glMapBufferRangeFn != NULL, ());
+  void * result = glMapBufferRangeFn(target, offset, length, access);
+  GLCHECKCALL();
+  return result;
+}
+
 void GLFunctions::glUnmapBuffer(glConst target)
 {
   ASSERT(glUnmapBufferFn != NULL, ());
@@ -447,6 +617,35 @@ bool GLFunctions::glLinkProgram(uint32_t programID, string & errorLog)
   return false;
 }
 
+bool GLFunctions::glGetProgramBinary(uint32_t programID, glConst & format, vector<uint8_t> & binary)
+{
+  ASSERT(glGetProgramBinaryFn != NULL, ());
+  ASSERT(glGetProgramivFn != NULL, ());
+  GLint length = 0;
+  GLCHECK(glGetProgramivFn(programID, GLProgramBinaryLength, &length));
+  if (length <= 0)
+    return false;
+
+  binary.resize(length);
+  GLenum binaryFormat = 0;
+  GLsizei written = 0;
+  GLCHECK(glGetProgramBinaryFn(programID, length, &written, &binaryFormat, binary.data()));
+  binary.resize(written);
+  format = binaryFormat;
+  return !binary.empty();
+}
+
+bool GLFunctions::glProgramBinary(uint32_t programID, glConst format, void const * binary, uint32_t size)
+{
+  ASSERT(glProgramBinaryFn != NULL, ());
+  ASSERT(glGetProgramivFn != NULL, ());
+  GLCHECK(glProgramBinaryFn(programID, format, binary, size));
+
+  GLint result = GL_FALSE;
+  GLCHECK(glGetProgramivFn(programID, GLLinkStatus, &result));
+  return result == GL_TRUE;
+}
+
 void GLFunctions::glDeleteProgram(uint32_t programID)
 {
   ASSERT(glDeleteProgramFn != NULL, ());
@@ -496,6 +695,12 @@ void GLFunctions::glVertexAttributePointer(int attrLocation,
                                      reinterpret_cast<void *>(offset)));
 }
 
+void GLFunctions::glVertexAttributeDivisor(int32_t attrLocation, uint32_t divisor)
+{
+  ASSERT(glVertexAttribDivisorFn != NULL, ());
+  GLCHECK(glVertexAttribDivisorFn(attrLocation, divisor));
+}
+
 void GLFunctions::glGetActiveUniform(uint32_t programID, uint32_t uniformIndex,
                                      int32_t * uniformSize, glConst * type, string & name)
 {
@@ -648,6 +853,12 @@ void GLFunctions::glDrawElements(uint16_t indexCount)
   GLCHECK(::glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, 0));
 }
 
+void GLFunctions::glDrawElementsInstanced(uint16_t indexCount, uint32_t instanceCount)
+{
+  ASSERT(glDrawElementsInstancedFn != NULL, ());
+  GLCHECK(glDrawElementsInstancedFn(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, 0, instanceCount));
+}
+
 void CheckGLError()
 {
   GLenum result = glGetError();
@@ -2,6 +2,7 @@
 
 #include "drape/glconstants.hpp"
 #include "std/string.hpp"
+#include "std/vector.hpp"
 
 class GLFunctions
 {
@@ -18,6 +19,7 @@ public:
   static void glPixelStore(glConst name, uint32_t value);
 
   static int32_t glGetInteger(glConst pname);
+  static string glGetString(glConst pname);
 
   static void glEnable(glConst mode);
   static void glDisable(glConst mode);
@@ -34,6 +36,15 @@ public:
   static void glBindVertexArray(uint32_t vao);
   static void glDeleteVertexArray(uint32_t vao);
 
+  /// Timer queries support, it's available with GLExtensionsList::TimerQuery only
+  static uint32_t glGenQuery();
+  static void glDeleteQuery(uint32_t id);
+  static void glBeginTimeElapsedQuery(uint32_t id);
+  static void glEndTimeElapsedQuery();
+  static bool glIsQueryResultAvailable(uint32_t id);
+  /// Elapsed time in nanoseconds
+  static uint64_t glGetQueryResult(uint32_t id);
+
   /// VBO support
   static uint32_t glGenBuffer();
   /// target - type of buffer to bind. Look GLConst
@@ -44,8 +55,16 @@ public:
   static void glBufferSubData(glConst target, uint32_t size, void const * data, uint32_t offset);
 
   static void * glMapBuffer(glConst target);
+  /// It's available with GLExtensionsList::MapBufferRange only. access - Look GLConst.
+  static void * glMapBufferRange(glConst target, uint32_t offset, uint32_t length, glConst access);
   static void glUnmapBuffer(glConst target);
 
+  /// Sync objects support, it's available with GLExtensionsList::Sync only
+  static void * glFenceSync();
+  /// Doesn't wait for the fence.
+  static bool glIsSyncSignaled(void * sync);
+  static void glDeleteSync(void * sync);
+
   /// Shaders support
   static uint32_t glCreateShader(glConst type);
   static void glShaderSource(uint32_t shaderID, string const & src);
@@ -58,6 +77,12 @@ public:
   static bool glLinkProgram(uint32_t programID, string & errorLog);
   static void glDeleteProgram(uint32_t programID);
 
+  /// Program binaries support, it's available with GLExtensionsList::ProgramBinary only.
+  /// Returns false when the driver hasn't given the binary.
+  static bool glGetProgramBinary(uint32_t programID, glConst & format, vector<uint8_t> & binary);
+  /// Returns the link status, binaries of other drivers and driver versions are rejected.
+  static bool glProgramBinary(uint32_t programID, glConst format, void const * binary, uint32_t size);
+
   static void glUseProgram(uint32_t programID);
   static int8_t glGetAttribLocation(uint32_t programID, string const & name);
   static void glBindAttribLocation(uint32_t programID, uint8_t index, string const & name);
@@ -78,6 +103,9 @@ public:
                                        bool needNormalize,
                                        uint32_t stride,
                                        uint32_t offset);
+  /// Attribute advances once per divisor instances, 0 means once per vertex.
+  /// It's available with GLExtensionsList::InstancedArrays only.
+  static void glVertexAttributeDivisor(int32_t attrLocation, uint32_t divisor);
 
   static void glGetActiveUniform(uint32_t programID, uint32_t uniformIndex,
                                  int32_t * uniformSize, glConst * type, string & name);
@@ -112,6 +140,8 @@ public:
 
   // Draw support
   static void glDrawElements(uint16_t indexCount);
+  /// It's available with GLExtensionsList::InstancedArrays only.
+  static void glDrawElementsInstanced(uint16_t indexCount, uint32_t instanceCount);
 };
 
 void CheckGLError();
@@ -84,6 +84,18 @@ namespace
   {
     value.Apply(program);
   }
+
+  void ApplyTexture(RefPointer<Texture> tex, string const & uniformName, uint8_t unit,
+                    RefPointer<GpuProgram> program)
+  {
+    if (tex.IsNull())
+      return;
+
+    int8_t const texLoc = program->GetUniformLocation(uniformName);
+    GLFunctions::glActiveTexture(gl_const::GLTexture0 + unit);
+    tex->Bind();
+    GLFunctions::glUniformValuei(texLoc, unit);
+  }
 }
 
 void ApplyUniforms(UniformValuesStorage const & uniforms, RefPointer<GpuProgram> program)
@@ -93,24 +105,46 @@ void ApplyUniforms(UniformValuesStorage const & uniforms, RefPointer<GpuProgram>
 
 void ApplyState(GLState state, RefPointer<GpuProgram> program)
 {
-  RefPointer<Texture> tex = state.GetColorTexture();
-  if (!tex.IsNull())
+  ApplyTexture(state.GetColorTexture(), "u_colorTex", 0, program);
+  ApplyTexture(state.GetMaskTexture(), "u_maskTex", 1, program);
+  state.GetBlending().Apply();
+}
+
+GLStateApplier::GLStateApplier()
+  : m_state(0, GLState::GeometryLayer)
+  , m_program(nullptr)
+  , m_isBlendingApplied(false)
+{
+}
+
+void GLStateApplier::Reset()
+{
+  m_program = nullptr;
+  m_isBlendingApplied = false;
+}
+
+void GLStateApplier::Apply(GLState const & state, RefPointer<GpuProgram> program)
+{
+  // Samplers are uniforms of the program, so they're set again on the program change.
+  bool const isProgramChanged = (m_program != program.GetRaw());
+  if (isProgramChanged)
   {
-    int8_t const colorTexLoc = program->GetUniformLocation("u_colorTex");
-    GLFunctions::glActiveTexture(gl_const::GLTexture0);
-    tex->Bind();
-    GLFunctions::glUniformValuei(colorTexLoc, 0);
+    program->Bind();
+    m_program = program.GetRaw();
   }
 
-  tex = state.GetMaskTexture();
-  if (!tex.IsNull())
+  if (isProgramChanged || state.GetColorTexture().GetRaw() != m_state.GetColorTexture().GetRaw())
+    ApplyTexture(state.GetColorTexture(), "u_colorTex", 0, program);
+  if (isProgramChanged || state.GetMaskTexture().GetRaw() != m_state.GetMaskTexture().GetRaw())
+    ApplyTexture(state.GetMaskTexture(), "u_maskTex", 1, program);
+
+  if (!m_isBlendingApplied || !(state.GetBlending() == m_state.GetBlending()))
   {
-    int8_t const maskTexLoc = program->GetUniformLocation("u_maskTex");
-    GLFunctions::glActiveTexture(gl_const::GLTexture0 + 1);
-    tex->Bind();
-    GLFunctions::glUniformValuei(maskTexLoc, 1);
+    state.GetBlending().Apply();
+    m_isBlendingApplied = true;
   }
-  state.GetBlending().Apply();
+
+  m_state = state;
 }
 
 }
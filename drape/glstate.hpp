@@ -61,6 +61,24 @@ private:
   RefPointer<Texture> m_maskTexture;
 };
 
+/// Applies states of the sorted render groups one by one, GL is called for the parts
+/// of the state which differ from the previous one only. GL state isn't read back,
+/// so Reset must be called when it could be changed by someone else, e.g. on the frame start.
+class GLStateApplier
+{
+public:
+  GLStateApplier();
+
+  void Reset();
+  /// Binds the program and applies the state.
+  void Apply(GLState const & state, RefPointer<GpuProgram> program);
+
+private:
+  GLState m_state;
+  GpuProgram const * m_program;
+  bool m_isBlendingApplied;
+};
+
 void ApplyUniforms(UniformValuesStorage const & uniforms, RefPointer<GpuProgram> program);
 void ApplyState(GLState state, RefPointer<GpuProgram> program);
 
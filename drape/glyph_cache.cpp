@@ -0,0 +1,162 @@
+#include "drape/glyph_cache.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/logging.hpp"
+
+namespace dp
+{
+
+namespace
+{
+
+typedef ReaderSource<MemReader> TSource;
+
+// The cache is local for the device, so floats are written in the native byte order.
+void WriteFloat(Writer & writer, float value)
+{
+  writer.Write(&value, sizeof(value));
+}
+
+float ReadFloat(TSource & src)
+{
+  float value;
+  src.Read(&value, sizeof(value));
+  return value;
+}
+
+// Counts of the file mustn't exceed the rest of it.
+uint32_t ReadCount(TSource & src)
+{
+  uint32_t const count = ReadVarUint<uint32_t>(src);
+  if (count > src.Size())
+    MYTHROW(Reader::SizeException, ("Broken glyph cache file", count, src.Size()));
+  return count;
+}
+
+} // namespace
+
+// static
+uint8_t const GlyphCache::kVersion;
+
+GlyphCache::GlyphCache(string const & filePath, string const & key)
+  : m_filePath(filePath)
+  , m_key(key)
+  , m_isChanged(false)
+{
+}
+
+bool GlyphCache::Load()
+{
+  m_entries.clear();
+  m_isChanged = false;
+  if (m_filePath.empty() || !Platform::IsFileExistsByFullPath(m_filePath))
+    return false;
+
+  try
+  {
+    string data;
+    FileReader(m_filePath).ReadAsString(data);
+    MemReader reader(data.data(), data.size());
+    TSource src(reader);
+
+    if (ReadPrimitiveFromSource<uint8_t>(src) != kVersion)
+      return false;
+    string key;
+    rw::Read(src, key);
+    if (key != m_key)
+      return false;
+
+    uint32_t const count = ReadCount(src);
+    strings::UniChar unicodePoint = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      unicodePoint += ReadVarUint<uint32_t>(src);
+      Entry & entry = m_entries[unicodePoint];
+      entry.m_metrics.m_xAdvance = ReadFloat(src);
+      entry.m_metrics.m_yAdvance = ReadFloat(src);
+      entry.m_metrics.m_xOffset = ReadFloat(src);
+      entry.m_metrics.m_yOffset = ReadFloat(src);
+      entry.m_metrics.m_isValid = true;
+      entry.m_width = ReadVarUint<uint32_t>(src);
+      entry.m_height = ReadVarUint<uint32_t>(src);
+      if (entry.m_width * entry.m_height > src.Size())
+        MYTHROW(Reader::SizeException, ("Broken glyph cache file", entry.m_width, entry.m_height));
+      entry.m_image.resize(entry.m_width * entry.m_height);
+      if (!entry.m_image.empty())
+        src.Read(entry.m_image.data(), entry.m_image.size());
+    }
+    return true;
+  }
+  catch (Reader::Exception const & ex)
+  {
+    LOG(LWARNING, ("Can't load glyph cache", m_filePath, ex.Msg()));
+    m_entries.clear();
+    return false;
+  }
+}
+
+void GlyphCache::Save()
+{
+  if (m_filePath.empty() || !m_isChanged)
+    return;
+
+  // The file is replaced at once, so it's never read half-written.
+  string const tmpPath = m_filePath + ".tmp";
+  try
+  {
+    {
+      FileWriter writer(tmpPath);
+      WriteToSink(writer, kVersion);
+      rw::Write(writer, m_key);
+
+      WriteVarUint(writer, static_cast<uint32_t>(m_entries.size()));
+      strings::UniChar prevUnicodePoint = 0;
+      for (auto const & node : m_entries)
+      {
+        Entry const & entry = node.second;
+        WriteVarUint(writer, static_cast<uint32_t>(node.first - prevUnicodePoint));
+        WriteFloat(writer, entry.m_metrics.m_xAdvance);
+        WriteFloat(writer, entry.m_metrics.m_yAdvance);
+        WriteFloat(writer, entry.m_metrics.m_xOffset);
+        WriteFloat(writer, entry.m_metrics.m_yOffset);
+        WriteVarUint(writer, entry.m_width);
+        WriteVarUint(writer, entry.m_height);
+        writer.Write(entry.m_image.data(), entry.m_image.size());
+        prevUnicodePoint = node.first;
+      }
+    }
+    if (my::RenameFileX(tmpPath, m_filePath))
+      m_isChanged = false;
+    else
+      LOG(LWARNING, ("Can't rename glyph cache file", tmpPath, "to", m_filePath));
+  }
+  catch (Writer::Exception const & ex)
+  {
+    LOG(LWARNING, ("Can't save glyph cache", m_filePath, ex.Msg()));
+    my::DeleteFileX(tmpPath);
+  }
+}
+
+GlyphCache::Entry const * GlyphCache::Find(strings::UniChar unicodePoint) const
+{
+  auto const it = m_entries.find(unicodePoint);
+  return it != m_entries.end() ? &it->second : nullptr;
+}
+
+void GlyphCache::Add(strings::UniChar unicodePoint, Entry && entry)
+{
+  ASSERT(entry.m_metrics.m_isValid, ());
+  ASSERT_EQUAL(entry.m_image.size(), entry.m_width * entry.m_height, ());
+  m_entries[unicodePoint] = move(entry);
+  m_isChanged = true;
+}
+
+} // namespace dp
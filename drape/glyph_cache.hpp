@@ -0,0 +1,49 @@
+#pragma once
+
+#include "drape/glyph_manager.hpp"
+
+#include "base/string_utils.hpp"
+
+#include "std/map.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace dp
+{
+
+/// SDF images and metrics of the rasterized glyphs. The cache file is valid only
+/// for the fonts and the rasterization parameters it was written with, they're given by the key.
+/// The class isn't thread safe.
+class GlyphCache
+{
+public:
+  struct Entry
+  {
+    GlyphManager::GlyphMetrics m_metrics;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    vector<uint8_t> m_image;
+  };
+
+  /// @param filePath The cache is kept in memory only when it's empty.
+  GlyphCache(string const & filePath, string const & key);
+
+  /// @return False when there is no valid cache file.
+  bool Load();
+  /// Writes the file when glyphs were added since the loading.
+  void Save();
+
+  Entry const * Find(strings::UniChar unicodePoint) const;
+  void Add(strings::UniChar unicodePoint, Entry && entry);
+  size_t GetCount() const { return m_entries.size(); }
+
+private:
+  static uint8_t const kVersion = 0;
+
+  string const m_filePath;
+  string const m_key;
+  map<strings::UniChar, Entry> m_entries;
+  bool m_isChanged;
+};
+
+} // namespace dp
@@ -1,4 +1,5 @@
 #include "drape/glyph_manager.hpp"
+#include "drape/glyph_cache.hpp"
 #include "3party/sdf_image/sdf_image.h"
 
 #include "platform/platform.hpp"
@@ -8,8 +9,12 @@
 #include "base/string_utils.hpp"
 #include "base/logging.hpp"
 #include "base/math.hpp"
+#include "base/mutex.hpp"
+#include "base/thread.hpp"
 #include "base/timer.hpp"
 
+#include "std/cstring.hpp"
+
 #include <ft2build.h>
 #include FT_TYPES_H
 #include FT_SYSTEM_H
@@ -61,6 +66,8 @@ namespace
 int const SDF_SCALE_FACTOR = 4;
 int const SDF_BORDER = 4 * SDF_SCALE_FACTOR;
 
+char const * const kCacheFileName = "glyphs.cache";
+
 template <typename ToDo>
 void ParseUniBlocks(string const & uniBlocksFile, ToDo toDo)
 {
@@ -152,6 +159,8 @@ public:
     m_fontFace = nullptr;
   }
 
+  uint64_t GetFileSize() const { return m_fontReader.Size(); }
+
   bool HasGlyph(strings::UniChar unicodePoint) const
   {
     return FT_Get_Char_Index(m_fontFace, unicodePoint) != 0;
@@ -241,6 +250,47 @@ private:
   FT_Face m_fontFace;
 };
 
+GlyphCache::Entry ToCacheEntry(GlyphManager::Glyph const & glyph)
+{
+  GlyphCache::Entry entry;
+  entry.m_metrics = glyph.m_metrics;
+  if (glyph.m_image.m_data)
+  {
+    entry.m_width = glyph.m_image.m_width;
+    entry.m_height = glyph.m_image.m_height;
+    uint8_t const * data = SharedBufferManager::GetRawPointer(glyph.m_image.m_data);
+    entry.m_image.assign(data, data + entry.m_width * entry.m_height);
+  }
+  return entry;
+}
+
+GlyphManager::Glyph FromCacheEntry(GlyphCache::Entry const & entry)
+{
+  GlyphManager::Glyph glyph;
+  glyph.m_metrics = entry.m_metrics;
+  glyph.m_image.m_width = entry.m_width;
+  glyph.m_image.m_height = entry.m_height;
+  if (!entry.m_image.empty())
+  {
+    glyph.m_image.m_data = SharedBufferManager::instance().reserveSharedBuffer(my::NextPowOf2(entry.m_image.size()));
+    memcpy(SharedBufferManager::GetRawPointer(glyph.m_image.m_data), entry.m_image.data(), entry.m_image.size());
+  }
+  return glyph;
+}
+
+class PrewarmRoutine : public threads::IRoutine
+{
+public:
+  typedef function<void (my::Cancellable const &)> TPrewarmFn;
+
+  PrewarmRoutine(TPrewarmFn const & fn) : m_fn(fn) {}
+
+  virtual void Do() { m_fn(*this); }
+
+private:
+  TPrewarmFn m_fn;
+};
+
 }
 
 /// Information about single unicode block.
@@ -298,6 +348,11 @@ struct GlyphManager::Impl
   vector<Font> m_fonts;
 
   uint32_t m_baseGlyphHeight;
+
+  // Guards FreeType and the cache, glyphs are rasterized on the prewarm thread too.
+  threads::Mutex m_mutex;
+  unique_ptr<GlyphCache> m_cache;
+  threads::Thread m_prewarmThread;
 };
 
 GlyphManager::GlyphManager(GlyphManager::Params const & params)
@@ -420,10 +475,53 @@ GlyphManager::GlyphManager(GlyphManager::Params const & params)
   }
 
   m_impl->m_lastUsedBlock = m_impl->m_blocks.end();
+
+  // Cached glyphs are valid for the same fonts and the same rasterization only.
+  string cacheKey = params.m_uniBlocks + ";" + params.m_whitelist + ";" + params.m_blacklist + ";" +
+                    strings::to_string(params.m_baseGlyphHeight) + ";" +
+                    strings::to_string(SDF_SCALE_FACTOR) + ";" + strings::to_string(SDF_BORDER);
+  for (size_t i = 0; i < params.m_fonts.size(); ++i)
+    cacheKey += ";" + params.m_fonts[i];
+  for (Font const & f : m_impl->m_fonts)
+    cacheKey += ";" + strings::to_string(f.GetFileSize());
+
+  string const cachePath = params.m_cacheDir.empty() ? string() : params.m_cacheDir + kCacheFileName;
+  m_impl->m_cache.reset(new GlyphCache(cachePath, cacheKey));
+  m_impl->m_cache->Load();
+
+  vector<strings::UniChar> prewarmPoints;
+  for (string const & name : params.m_prewarmBlocks)
+  {
+    auto const it = find_if(m_impl->m_blocks.begin(), m_impl->m_blocks.end(), [&name](UnicodeBlock const & block)
+    {
+      return block.m_name == name;
+    });
+    if (it == m_impl->m_blocks.end())
+    {
+      LOG(LWARNING, ("Unknown unicode block to prewarm", name));
+      continue;
+    }
+    for (strings::UniChar c = it->m_start; c <= it->m_end; ++c)
+    {
+      if (m_impl->m_cache->Find(c) == nullptr)
+        prewarmPoints.push_back(c);
+    }
+  }
+
+  if (!prewarmPoints.empty())
+  {
+    m_impl->m_prewarmThread.Create(make_unique<PrewarmRoutine>([this, prewarmPoints](my::Cancellable const & cancellable)
+    {
+      Prewarm(prewarmPoints, cancellable);
+    }));
+  }
 }
 
 GlyphManager::~GlyphManager()
 {
+  m_impl->m_prewarmThread.Cancel();
+  m_impl->m_cache->Save();
+
   for (Font & f : m_impl->m_fonts)
     f.DestroyFont();
 
@@ -432,6 +530,42 @@ GlyphManager::~GlyphManager()
 }
 
 GlyphManager::Glyph GlyphManager::GetGlyph(strings::UniChar unicodePoint)
+{
+  threads::MutexGuard guard(m_impl->m_mutex);
+  UNUSED_VALUE(guard);
+
+  if (GlyphCache::Entry const * entry = m_impl->m_cache->Find(unicodePoint))
+    return FromCacheEntry(*entry);
+
+  Glyph const glyph = RasterizeGlyph(unicodePoint);
+  if (glyph.m_metrics.m_isValid)
+    m_impl->m_cache->Add(unicodePoint, ToCacheEntry(glyph));
+  return glyph;
+}
+
+void GlyphManager::Prewarm(vector<strings::UniChar> const & unicodePoints, my::Cancellable const & cancellable)
+{
+  for (strings::UniChar const c : unicodePoints)
+  {
+    if (cancellable.IsCancelled())
+      return;
+
+    threads::MutexGuard guard(m_impl->m_mutex);
+    UNUSED_VALUE(guard);
+    if (m_impl->m_cache->Find(c) != nullptr)
+      continue;
+
+    Glyph glyph = RasterizeGlyph(c);
+    if (!glyph.m_metrics.m_isValid)
+      continue;
+
+    m_impl->m_cache->Add(c, ToCacheEntry(glyph));
+    if (glyph.m_image.m_data)
+      glyph.m_image.Destroy();
+  }
+}
+
+GlyphManager::Glyph GlyphManager::RasterizeGlyph(strings::UniChar unicodePoint) const
 {
   TUniBlockIter iter = m_impl->m_blocks.end();
   if (m_impl->m_lastUsedBlock != m_impl->m_blocks.end() && m_impl->m_lastUsedBlock->HasSymbol(unicodePoint))
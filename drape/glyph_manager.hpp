@@ -1,5 +1,6 @@
 #pragma once
 
+#include "base/cancellable.hpp"
 #include "base/shared_buffer_manager.hpp"
 #include "base/string_utils.hpp"
 
@@ -24,6 +25,11 @@ public:
     vector<string> m_fonts;
 
     uint32_t m_baseGlyphHeight = 20;
+
+    /// Directory of the file with the rasterized glyphs, they aren't stored when it's empty.
+    string m_cacheDir;
+    /// Names of the unicode blocks which glyphs are rasterized on a background thread at the start.
+    vector<string> m_prewarmBlocks;
   };
 
   struct GlyphMetrics
@@ -62,6 +68,7 @@ public:
   GlyphManager(Params const & params);
   ~GlyphManager();
 
+  /// The glyph is taken from the cache or rasterized on the calling thread. It's thread safe.
   Glyph GetGlyph(strings::UniChar unicodePoints);
 
   typedef function<void (strings::UniChar start, strings::UniChar end)> TUniBlockCallback;
@@ -69,6 +76,8 @@ public:
 
 private:
   Glyph GetInvalidGlyph() const;
+  Glyph RasterizeGlyph(strings::UniChar unicodePoint) const;
+  void Prewarm(vector<strings::UniChar> const & unicodePoints, my::Cancellable const & cancellable);
 
 private:
   struct Impl;
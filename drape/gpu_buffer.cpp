@@ -1,4 +1,6 @@
 #include "drape/gpu_buffer.hpp"
+#include "drape/frame_fences.hpp"
+#include "drape/gpu_buffer_pool.hpp"
 #include "drape/glfunctions.hpp"
 #include "drape/glextensions_list.hpp"
 
@@ -11,11 +13,26 @@ namespace dp
 
 namespace
 {
+  // One copy is drawn by the GPU, the next one may be in the driver queue yet.
+  size_t const kDynamicCopiesCount = 3;
+
   bool IsMapBufferSupported()
   {
     static bool const isSupported = GLExtensionsList::Instance().IsSupported(GLExtensionsList::MapBuffer);
     return isSupported;
   }
+
+  bool IsMapBufferRangeSupported()
+  {
+    static bool const isSupported = GLExtensionsList::Instance().IsSupported(GLExtensionsList::MapBufferRange);
+    return isSupported;
+  }
+
+  bool IsSyncSupported()
+  {
+    static bool const isSupported = GLExtensionsList::Instance().IsSupported(GLExtensionsList::Sync);
+    return isSupported;
+  }
 }
 
 glConst glTarget(GPUBuffer::Target t)
@@ -26,21 +43,63 @@ glConst glTarget(GPUBuffer::Target t)
   return gl_const::GLElementArrayBuffer;
 }
 
-GPUBuffer::GPUBuffer(Target t, uint8_t elementSize, uint16_t capacity)
+GPUBuffer::GPUBuffer(Target t, uint8_t elementSize, uint16_t capacity, bool isDynamic)
   : base_t(elementSize, capacity)
   , m_t(t)
+  , m_storageSize(0)
+  , m_currentCopy(0)
+  , m_isCopyFree(false)
 #ifdef DEBUG
   , m_isMapped(false)
 #endif
 {
-  m_bufferID = GLFunctions::glGenBuffer();
-  Resize(capacity);
+  GPUBufferPool & pool = GPUBufferPool::Instance();
+  if (!pool.IsEnabled())
+  {
+    m_bufferID = GLFunctions::glGenBuffer();
+    Resize(capacity);
+  }
+  else
+  {
+    // The pooled storage may be larger than the capacity, it's never used then.
+    uint32_t const storageSize = GPUBufferPool::GetSizeClass(GetCapacity() * GetElementSize());
+    m_bufferID = pool.Take(glTarget(m_t), storageSize);
+    if (m_bufferID != 0)
+    {
+      m_storageSize = storageSize;
+    }
+    else
+    {
+      m_bufferID = GLFunctions::glGenBuffer();
+      AllocateStorage(storageSize);
+    }
+  }
+
+  // Without fences it isn't known when a copy is free, so copies are useless.
+  if (!isDynamic || !IsSyncSupported())
+    return;
+
+  uint32_t const firstID = m_bufferID;
+  m_copies.push_back(firstID);
+  for (size_t i = 1; i < kDynamicCopiesCount; ++i)
+  {
+    m_bufferID = GLFunctions::glGenBuffer();
+    AllocateStorage(m_storageSize);
+    m_copies.push_back(m_bufferID);
+  }
+  m_copyFrames.resize(m_copies.size(), 0);
+  m_bufferID = firstID;
 }
 
 GPUBuffer::~GPUBuffer()
 {
   GLFunctions::glBindBuffer(0, glTarget(m_t));
-  GLFunctions::glDeleteBuffer(m_bufferID);
+  // The first copy may be pooled, the other ones are deleted.
+  uint32_t const bufferID = m_copies.empty() ? m_bufferID : m_copies.front();
+  for (size_t i = 1; i < m_copies.size(); ++i)
+    GLFunctions::glDeleteBuffer(m_copies[i]);
+  if (!GPUBufferPool::Instance().Return(glTarget(m_t), m_storageSize, bufferID))
+    GLFunctions::glDeleteBuffer(bufferID);
 }
 
 void GPUBuffer::UploadData(void const * data, uint16_t elementCount)
@@ -50,8 +109,21 @@ void GPUBuffer::UploadData(void const * data, uint16_t elementCount)
   uint16_t currentSize = GetCurrentSize();
   uint8_t elementSize = GetElementSize();
   ASSERT(GetCapacity() >= elementCount + currentSize, ("Not enough memory to upload ", elementCount, " elements"));
-  Bind();
-  GLFunctions::glBufferSubData(glTarget(m_t), elementCount * elementSize, data, currentSize * elementSize);
+  if (m_copies.empty())
+  {
+    Bind();
+    GLFunctions::glBufferSubData(glTarget(m_t), elementCount * elementSize, data, currentSize * elementSize);
+  }
+  else
+  {
+    // All the copies have the same data initially.
+    for (uint32_t const bufferID : m_copies)
+    {
+      GLFunctions::glBindBuffer(bufferID, glTarget(m_t));
+      GLFunctions::glBufferSubData(glTarget(m_t), elementCount * elementSize, data, currentSize * elementSize);
+    }
+    Bind();
+  }
   base_t::UploadData(elementCount);
 }
 
@@ -60,6 +132,22 @@ void GPUBuffer::Bind()
   GLFunctions::glBindBuffer(m_bufferID, glTarget(m_t));
 }
 
+void GPUBuffer::SwitchCopy()
+{
+  ASSERT(m_isMapped == false, ());
+  if (m_copies.empty())
+    return;
+
+  // Mutations write all the vertices which are drawn, so the data of the copy written some
+  // frames ago is rewritten where it matters.
+  FrameFences & fences = FrameFences::Instance();
+  m_currentCopy = (m_currentCopy + 1) % m_copies.size();
+  m_bufferID = m_copies[m_currentCopy];
+  m_isCopyFree = fences.IsFrameCompleted(m_copyFrames[m_currentCopy]);
+  // The copy is drawn on the same frame.
+  m_copyFrames[m_currentCopy] = fences.GetCurrentFrame();
+}
+
 void * GPUBuffer::Map()
 {
 #ifdef DEBUG
@@ -67,6 +155,14 @@ void * GPUBuffer::Map()
   m_isMapped = true;
 #endif
 
+  // When the GPU is far behind the copy is mapped as usual, so it waits for the GPU.
+  if (m_isCopyFree && IsMapBufferRangeSupported())
+  {
+    m_isCopyFree = false;
+    return GLFunctions::glMapBufferRange(glTarget(m_t), 0, m_storageSize,
+                                         gl_const::GLMapWriteBit | gl_const::GLMapUnsynchronizedBit);
+  }
+
   if (IsMapBufferSupported())
     return GLFunctions::glMapBuffer(glTarget(m_t));
 
@@ -79,42 +175,52 @@ void GPUBuffer::UpdateData(void * gpuPtr, void const * data, uint16_t elementOff
   uint32_t const byteOffset = elementOffset * (uint32_t)elementSize;
   uint32_t const byteCount = elementCount * (uint32_t)elementSize;
   ASSERT(m_isMapped == true, ());
-  if (IsMapBufferSupported())
+  if (gpuPtr != NULL)
   {
-    ASSERT(gpuPtr != NULL, ());
     memcpy((uint8_t *)gpuPtr + byteOffset, data, byteCount);
   }
   else
   {
-    ASSERT(gpuPtr == NULL, ());
     if (byteOffset == 0 && byteCount == GetCapacity())
+    {
       GLFunctions::glBufferData(glTarget(m_t), byteCount, data, gl_const::GLStaticDraw);
+      m_storageSize = byteCount;
+    }
     else
       GLFunctions::glBufferSubData(glTarget(m_t), byteCount, data, byteOffset);
   }
 }
 
-void GPUBuffer::Unmap()
+void GPUBuffer::Unmap(void * gpuPtr)
 {
 #ifdef DEBUG
   ASSERT(m_isMapped == true, ());
   m_isMapped = false;
 #endif
-  if (IsMapBufferSupported())
+  if (gpuPtr != NULL)
     GLFunctions::glUnmapBuffer(glTarget(m_t));
 }
 
 void GPUBuffer::Resize(uint16_t elementCount)
 {
+  ASSERT(m_copies.empty(), ("Copies of dynamic buffers aren't resized"));
   base_t::Resize(elementCount);
+  AllocateStorage(GetCapacity() * GetElementSize());
+}
+
+void GPUBuffer::AllocateStorage(uint32_t byteSize)
+{
+  m_storageSize = byteSize;
   Bind();
-  GLFunctions::glBufferData(glTarget(m_t), GetCapacity() * GetElementSize(), NULL, gl_const::GLStaticDraw);
+  GLFunctions::glBufferData(glTarget(m_t), byteSize, NULL, gl_const::GLStaticDraw);
 }
 
 ////////////////////////////////////////////////////////////////////////////
 GPUBufferMapper::GPUBufferMapper(RefPointer<GPUBuffer> buffer)
   : m_buffer(buffer)
 {
+  m_buffer->SwitchCopy();
+
 #ifdef DEBUG
   if (m_buffer->m_t == GPUBuffer::ElementBuffer)
   {
@@ -147,7 +253,7 @@ GPUBufferMapper::~GPUBufferMapper()
   }
 #endif
 
-  m_buffer->Unmap();
+  m_buffer->Unmap(m_gpuPtr);
 }
 
 void GPUBufferMapper::UpdateData(void const * data, uint16_t elementOffset, uint16_t elementCount)
@@ -3,6 +3,8 @@
 #include "drape/pointers.hpp"
 #include "drape/buffer_base.hpp"
 
+#include "std/vector.hpp"
+
 namespace dp
 {
 
@@ -17,24 +19,41 @@ public:
   };
 
 public:
-  GPUBuffer(Target t, uint8_t elementSize, uint16_t capacity);
+  /// Dynamic buffers are rewritten by the mutations every frame. When fences are supported
+  /// they have some copies of the storage which are written in turn, so the GPU never waits
+  /// for the copy which it still draws from.
+  GPUBuffer(Target t, uint8_t elementSize, uint16_t capacity, bool isDynamic = false);
   ~GPUBuffer();
 
   void UploadData(void const * data, uint16_t elementCount);
   void Bind();
 
 protected:
+  /// Takes the next copy of a dynamic buffer for writing.
+  void SwitchCopy();
   void * Map();
   void UpdateData(void * gpuPtr, void const * data, uint16_t elementOffset, uint16_t elementCount);
-  void Unmap();
+  void Unmap(void * gpuPtr);
 
   /// discard old data
   void Resize(uint16_t elementCount);
 
 private:
+  void AllocateStorage(uint32_t byteSize);
+
   friend class GPUBufferMapper;
   Target m_t;
   uint32_t m_bufferID;
+  /// Size of the buffer object storage in bytes, it's not less than the capacity.
+  uint32_t m_storageSize;
+
+  /// Buffer objects of the copies of a dynamic buffer, m_bufferID is the current one.
+  vector<uint32_t> m_copies;
+  /// Frames on which the copies were written and drawn.
+  vector<uint64_t> m_copyFrames;
+  size_t m_currentCopy;
+  /// The current copy isn't used by the GPU, so it's mapped without synchronization.
+  bool m_isCopyFree;
 
 #ifdef DEBUG
   bool m_isMapped;
@@ -0,0 +1,85 @@
+#include "drape/gpu_buffer_pool.hpp"
+#include "drape/glfunctions.hpp"
+
+#include "base/math.hpp"
+
+namespace dp
+{
+
+// static
+GPUBufferPool & GPUBufferPool::Instance()
+{
+  static GPUBufferPool pool;
+  return pool;
+}
+
+GPUBufferPool::GPUBufferPool()
+  : m_freeBytes(0)
+  , m_maxBytes(0)
+  , m_isEnabled(false)
+{
+}
+
+void GPUBufferPool::Enable(uint32_t maxBytes)
+{
+  threads::MutexGuard guard(m_mutex);
+  m_maxBytes = maxBytes;
+  m_isEnabled = true;
+}
+
+void GPUBufferPool::Disable()
+{
+  threads::MutexGuard guard(m_mutex);
+  for (auto const & buffers : m_buffers)
+  {
+    for (uint32_t bufferID : buffers.second)
+      GLFunctions::glDeleteBuffer(bufferID);
+  }
+  m_buffers.clear();
+  m_freeBytes = 0;
+  m_isEnabled = false;
+}
+
+bool GPUBufferPool::IsEnabled() const
+{
+  threads::MutexGuard guard(m_mutex);
+  return m_isEnabled;
+}
+
+// static
+uint32_t GPUBufferPool::GetSizeClass(uint32_t byteSize)
+{
+  return my::NextPowOf2(byteSize);
+}
+
+uint32_t GPUBufferPool::Take(glConst target, uint32_t byteSize)
+{
+  threads::MutexGuard guard(m_mutex);
+  auto const it = m_buffers.find(make_pair(target, byteSize));
+  if (it == m_buffers.end() || it->second.empty())
+    return 0;
+
+  uint32_t const bufferID = it->second.back();
+  it->second.pop_back();
+  m_freeBytes -= byteSize;
+  return bufferID;
+}
+
+bool GPUBufferPool::Return(glConst target, uint32_t byteSize, uint32_t bufferID)
+{
+  threads::MutexGuard guard(m_mutex);
+  if (!m_isEnabled || byteSize == 0 || byteSize != GetSizeClass(byteSize) || m_freeBytes + byteSize > m_maxBytes)
+    return false;
+
+  m_buffers[make_pair(target, byteSize)].push_back(bufferID);
+  m_freeBytes += byteSize;
+  return true;
+}
+
+uint32_t GPUBufferPool::GetFreeBytes() const
+{
+  threads::MutexGuard guard(m_mutex);
+  return m_freeBytes;
+}
+
+} // namespace dp
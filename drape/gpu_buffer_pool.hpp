@@ -0,0 +1,52 @@
+#pragma once
+
+#include "drape/glconstants.hpp"
+
+#include "base/mutex.hpp"
+
+#include "std/map.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace dp
+{
+
+/// Free OpenGL buffer objects grouped by target and storage size. Buffers of the tiles which
+/// leave the screen are taken by the new tiles of the same size class, so neither glGenBuffers
+/// nor glBufferData is called for them. Buffers are created on the upload thread and deleted
+/// on the render one, so the pool is shared and locked.
+/// The pool is disabled by default, GPUBuffer creates and deletes buffers itself then.
+class GPUBufferPool
+{
+public:
+  static GPUBufferPool & Instance();
+
+  /// @param maxBytes Storage size of all free buffers the pool keeps.
+  void Enable(uint32_t maxBytes);
+  /// Deletes the free buffers and disables the pool.
+  /// It must be called on a thread with OpenGL context.
+  void Disable();
+  bool IsEnabled() const;
+
+  /// Storage size of the buffer which is pooled for byteSize bytes.
+  static uint32_t GetSizeClass(uint32_t byteSize);
+
+  /// @return Buffer object with the storage of byteSize bytes or 0 when there is no free one.
+  uint32_t Take(glConst target, uint32_t byteSize);
+  /// @return False when the buffer isn't taken by the pool and must be deleted.
+  bool Return(glConst target, uint32_t byteSize, uint32_t bufferID);
+
+  uint32_t GetFreeBytes() const;
+
+private:
+  GPUBufferPool();
+
+  typedef pair<glConst, uint32_t> TKey;
+  map<TKey, vector<uint32_t>> m_buffers;
+  uint32_t m_freeBytes;
+  uint32_t m_maxBytes;
+  bool m_isEnabled;
+  mutable threads::Mutex m_mutex;
+};
+
+} // namespace dp
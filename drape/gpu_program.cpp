@@ -72,6 +72,14 @@ GpuProgram::GpuProgram(RefPointer<Shader> vertexShader, RefPointer<Shader> fragm
 #endif
 }
 
+GpuProgram::GpuProgram(uint32_t programID)
+  : m_programID(programID)
+{
+#ifdef DEBUG
+  m_validator.reset(new UniformValidator(m_programID));
+#endif
+}
+
 GpuProgram::~GpuProgram()
 {
   Unbind();
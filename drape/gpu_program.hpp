@@ -24,8 +24,12 @@ class GpuProgram
 public:
   GpuProgram(RefPointer<Shader> vertexShader,
              RefPointer<Shader> fragmentShader);
+  /// Takes the program which is linked already, e.g. from the binary.
+  explicit GpuProgram(uint32_t programID);
   ~GpuProgram();
 
+  uint32_t GetID() const { return m_programID; }
+
   void Bind();
   void Unbind();
 
@@ -1,8 +1,11 @@
 #include "drape/gpu_program_manager.hpp"
+#include "drape/glextensions_list.hpp"
+#include "drape/glfunctions.hpp"
 #include "drape/shader_def.hpp"
 
 #include "base/stl_add.hpp"
 #include "base/assert.hpp"
+#include "base/logging.hpp"
 
 namespace dp
 {
@@ -31,8 +34,16 @@ private:
 
 static ShaderMapper s_mapper;
 
+char const kBinaryCacheFileName[] = "programs.bin";
+
 } // namespace
 
+GpuProgramManager::GpuProgramManager(string const & cacheDir)
+  : m_cacheDir(cacheDir)
+  , m_isBinaryCacheInitialized(false)
+{
+}
+
 GpuProgramManager::~GpuProgramManager()
 {
   (void)GetRangeDeletor(m_programs, MasterPointerDeleter())();
@@ -46,6 +57,23 @@ RefPointer<GpuProgram> GpuProgramManager::GetProgram(int index)
     return it->second.GetRefPointer();
 
   gpu::ProgramInfo const & programInfo = s_mapper.GetShaders(index);
+  MasterPointer<GpuProgram> & result = m_programs[index];
+
+  if (!m_isBinaryCacheInitialized)
+    InitBinaryCache();
+
+  string sourcesHash;
+  if (m_binaryCache)
+  {
+    sourcesHash = ProgramBinaryCache::GetSourcesHash(programInfo.m_vertexSource, programInfo.m_fragmentSource);
+    GpuProgram * program = LoadProgramBinary(index, sourcesHash);
+    if (program != nullptr)
+    {
+      result.Reset(program);
+      return result.GetRefPointer();
+    }
+  }
+
   RefPointer<Shader> vertexShader = GetShader(programInfo.m_vertexIndex,
                                               programInfo.m_vertexSource,
                                               Shader::VertexShader);
@@ -53,8 +81,9 @@ RefPointer<GpuProgram> GpuProgramManager::GetProgram(int index)
                                                 programInfo.m_fragmentSource,
                                                 Shader::FragmentShader);
 
-  MasterPointer<GpuProgram> & result = m_programs[index];
   result.Reset(new GpuProgram(vertexShader, fragmentShader));
+  if (m_binaryCache)
+    SaveProgramBinary(index, sourcesHash, *result.GetRaw());
   return result.GetRefPointer();
 }
 
@@ -71,4 +100,51 @@ RefPointer<Shader> GpuProgramManager::GetShader(int index, string const & source
     return it->second.GetRefPointer();
 }
 
+void GpuProgramManager::InitBinaryCache()
+{
+  m_isBinaryCacheInitialized = true;
+  if (m_cacheDir.empty() || !GLExtensionsList::Instance().IsSupported(GLExtensionsList::ProgramBinary))
+    return;
+
+  // Some drivers advertise the extension, but they don't give any binary format.
+  if (GLFunctions::glGetInteger(gl_const::GLNumProgramBinaryFormats) <= 0)
+    return;
+
+  // Binaries are valid for the same driver version only.
+  string const key = GLFunctions::glGetString(gl_const::GLVendor) + ";" +
+                     GLFunctions::glGetString(gl_const::GLRenderer) + ";" +
+                     GLFunctions::glGetString(gl_const::GLVersion);
+  m_binaryCache.reset(new ProgramBinaryCache(m_cacheDir + kBinaryCacheFileName, key));
+  m_binaryCache->Load();
+}
+
+GpuProgram * GpuProgramManager::LoadProgramBinary(int index, string const & sourcesHash)
+{
+  ProgramBinaryCache::Entry const * entry = m_binaryCache->Find(index, sourcesHash);
+  if (entry == nullptr)
+    return nullptr;
+
+  uint32_t const programID = GLFunctions::glCreateProgram();
+  if (GLFunctions::glProgramBinary(programID, entry->m_format, entry->m_binary.data(), entry->m_binary.size()))
+    return new GpuProgram(programID);
+
+  LOG(LINFO, ("Program binary", index, "isn't accepted by the driver, it's compiled from the sources"));
+  GLFunctions::glDeleteProgram(programID);
+  m_binaryCache->Remove(index);
+  m_binaryCache->Save();
+  return nullptr;
+}
+
+void GpuProgramManager::SaveProgramBinary(int index, string const & sourcesHash, GpuProgram const & program)
+{
+  ProgramBinaryCache::Entry entry;
+  entry.m_sourcesHash = sourcesHash;
+  if (!GLFunctions::glGetProgramBinary(program.GetID(), entry.m_format, entry.m_binary))
+    return;
+
+  // The file is written at once, the application can be killed without the destruction on mobiles.
+  m_binaryCache->Add(index, move(entry));
+  m_binaryCache->Save();
+}
+
 } // namespace dp
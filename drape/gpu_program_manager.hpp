@@ -2,10 +2,12 @@
 
 #include "drape/pointers.hpp"
 #include "drape/gpu_program.hpp"
+#include "drape/program_binary_cache.hpp"
 #include "drape/shader.hpp"
 
 #include "std/map.hpp"
 #include "std/noncopyable.hpp"
+#include "std/unique_ptr.hpp"
 
 namespace dp
 {
@@ -13,18 +15,29 @@ namespace dp
 class GpuProgramManager : public noncopyable
 {
 public:
+  /// Linked programs are cached in cacheDir when GLExtensionsList::ProgramBinary is supported,
+  /// the cache isn't used when cacheDir is empty.
+  explicit GpuProgramManager(string const & cacheDir = string());
   ~GpuProgramManager();
 
   RefPointer<GpuProgram> GetProgram(int index);
 
 private:
   RefPointer<Shader> GetShader(int index, string const & source, Shader::Type t);
+  void InitBinaryCache();
+  GpuProgram * LoadProgramBinary(int index, string const & sourcesHash);
+  void SaveProgramBinary(int index, string const & sourcesHash, GpuProgram const & program);
 
 private:
   typedef map<int, MasterPointer<GpuProgram> > program_map_t;
   typedef map<int, MasterPointer<Shader> > shader_map_t;
   program_map_t m_programs;
   shader_map_t m_shaders;
+
+  string const m_cacheDir;
+  // It needs GL context, so it's created on the first program request.
+  bool m_isBinaryCacheInitialized;
+  unique_ptr<ProgramBinaryCache> m_binaryCache;
 };
 
 } // namespace dp
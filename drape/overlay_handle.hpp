@@ -4,6 +4,7 @@
 #include "drape/binding_info.hpp"
 #include "drape/index_buffer_mutator.hpp"
 #include "drape/attribute_buffer_mutator.hpp"
+#include "drape/pooled_object.hpp"
 
 #include "indexer/feature_decl.hpp"
 
@@ -16,7 +17,7 @@
 namespace dp
 {
 
-class OverlayHandle
+class OverlayHandle : public PooledObject
 {
 public:
   typedef vector<m2::RectF> Rects;
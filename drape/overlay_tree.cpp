@@ -1,71 +1,202 @@
 #include "drape/overlay_tree.hpp"
 
-#include "std/bind.hpp"
+#include "base/buffer_vector.hpp"
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/limits.hpp"
 
 namespace dp
 {
 
+namespace
+{
+
+double const kCellSize = 64.0;
+
+} // namespace
+
+OverlayTree::OverlayTree()
+  : m_canOverlap(false)
+  , m_prevCanOverlap(false)
+  , m_isReusing(false)
+  , m_cellsWidth(0)
+  , m_cellsHeight(0)
+  , m_queryStamp(0)
+{
+}
+
 void OverlayTree::StartOverlayPlacing(ScreenBase const & screen, bool canOverlap)
 {
-  m_traits.m_modelView = screen;
+  ASSERT(m_nodes.empty(), ());
+  m_modelView = screen;
   m_canOverlap = canOverlap;
-  ASSERT(IsEmpty(), ());
+  m_isReusing = !m_prevNodes.empty() && m_prevModelView == screen && m_prevCanOverlap == canOverlap;
+
+  m2::RectD const & pixelRect = screen.PixelRect();
+  m_cellsWidth = max(1, static_cast<int>(ceil(pixelRect.SizeX() / kCellSize)));
+  m_cellsHeight = max(1, static_cast<int>(ceil(pixelRect.SizeY() / kCellSize)));
+  // Cells keep their storage, so it's allocated on the first frames only.
+  m_cells.resize(m_cellsWidth * m_cellsHeight);
 }
 
 void OverlayTree::Add(RefPointer<OverlayHandle> handle)
 {
-  ScreenBase const & modelView = GetModelView();
-
   handle->SetIsVisible(m_canOverlap);
-  handle->Update(modelView);
+  handle->Update(m_modelView);
 
-  if (!handle->IsValid())
-    return;
+  Node node;
+  node.m_handle = handle.GetRaw();
+  node.m_priority = handle->GetPriority();
+  node.m_isCandidate = false;
+  node.m_isPlaced = false;
 
-  m2::RectD const pixelRect = handle->GetPixelRect(modelView);
-  if (!m_traits.m_modelView.PixelRect().IsIntersect(pixelRect))
+  if (handle->IsValid())
   {
-    handle->SetIsVisible(false);
+    node.m_pixelRect = handle->GetPixelRect(m_modelView);
+    if (m_modelView.PixelRect().IsIntersect(node.m_pixelRect))
+      node.m_isCandidate = true;
+    else
+      handle->SetIsVisible(false);
+  }
+
+  m_nodes.push_back(node);
+
+  if (m_isReusing)
+  {
+    if (IsSameAsPrevious(node))
+      return;
+    ReplayFrame();
     return;
   }
 
-  typedef buffer_vector<RefPointer<OverlayHandle>, 8> OverlayContainerT;
-  OverlayContainerT elements;
-  /*
-   * Find elements that already on OverlayTree and it's pixel rect
-   * intersect with handle pixel rect ("Intersected elements")
-   */
-  ForEachInRect(pixelRect, [&] (RefPointer<OverlayHandle> r)
+  if (node.m_isCandidate)
+    Place(m_nodes.size() - 1);
+}
+
+void OverlayTree::EndOverlayPlacing()
+{
+  if (m_isReusing && m_nodes.size() != m_prevNodes.size())
+    ReplayFrame();
+
+  for (size_t i = 0; i < m_nodes.size(); ++i)
+  {
+    Node & node = m_nodes[i];
+    if (m_isReusing)
+      node.m_isPlaced = m_prevNodes[i].m_isPlaced;
+    if (node.m_isPlaced)
+      node.m_handle->SetIsVisible(true);
+  }
+
+  for (vector<uint32_t> & cell : m_cells)
+    cell.clear();
+
+  m_prevNodes.swap(m_nodes);
+  m_nodes.clear();
+  m_prevModelView = m_modelView;
+  m_prevCanOverlap = m_canOverlap;
+  m_isReusing = false;
+}
+
+void OverlayTree::Place(uint32_t nodeIndex)
+{
+  Node & node = m_nodes[nodeIndex];
+  ASSERT(node.m_isCandidate, ());
+
+  if (m_queryStamp == numeric_limits<uint32_t>::max())
   {
-    if (handle->IsIntersect(modelView, *r.GetRaw()))
-      elements.push_back(r);
-  });
+    m_queryStamp = 0;
+    fill(m_queryStamps.begin(), m_queryStamps.end(), 0);
+  }
+  ++m_queryStamp;
+  m_queryStamps.resize(m_nodes.size(), 0);
+
+  int minX, minY, maxX, maxY;
+  GetCellsRange(node.m_pixelRect, minX, minY, maxX, maxY);
 
-  double const inputPriority = handle->GetPriority();
   /*
-   * In this loop we decide which element must be visible
-   * If input element "handle" more priority than all "Intersected elements"
-   * than we remove all "Intersected elements" and insert input element "handle"
-   * But if some of already inserted elements more priority than we don't insert "handle"
+   * Find placed elements which pixel rects intersect with the handle pixel rect
+   * and which shapes intersect with the handle shape ("Intersected elements")
    */
-  for (OverlayContainerT::const_iterator it = elements.begin(); it != elements.end(); ++it)
-    if (inputPriority < (*it)->GetPriority())
-      return;
+  typedef buffer_vector<uint32_t, 8> TIntersected;
+  TIntersected intersected;
+  for (int y = minY; y <= maxY; ++y)
+  {
+    for (int x = minX; x <= maxX; ++x)
+    {
+      for (uint32_t const index : m_cells[y * m_cellsWidth + x])
+      {
+        if (m_queryStamps[index] == m_queryStamp)
+          continue;
+        m_queryStamps[index] = m_queryStamp;
+
+        Node const & other = m_nodes[index];
+        if (!other.m_isPlaced || !other.m_pixelRect.IsIntersect(node.m_pixelRect))
+          continue;
+
+        /*
+         * If some of the intersected elements has the greater priority
+         * then the handle isn't placed
+         */
+        if (node.m_handle->IsIntersect(m_modelView, *other.m_handle))
+        {
+          if (node.m_priority < other.m_priority)
+            return;
+          intersected.push_back(index);
+        }
+      }
+    }
+  }
 
-  for (OverlayContainerT::const_iterator it = elements.begin(); it != elements.end(); ++it)
-    Erase(*it);
+  // Hidden elements stay in the cells till the end of the frame.
+  for (uint32_t const index : intersected)
+    m_nodes[index].m_isPlaced = false;
 
-  BaseT::Add(handle, pixelRect);
+  node.m_isPlaced = true;
+  for (int y = minY; y <= maxY; ++y)
+    for (int x = minX; x <= maxX; ++x)
+      m_cells[y * m_cellsWidth + x].push_back(nodeIndex);
 }
 
-void OverlayTree::EndOverlayPlacing()
+void OverlayTree::ReplayFrame()
+{
+  m_isReusing = false;
+  for (size_t i = 0; i < m_nodes.size(); ++i)
+  {
+    if (m_nodes[i].m_isCandidate)
+      Place(i);
+  }
+}
+
+bool OverlayTree::IsSameAsPrevious(Node const & node) const
+{
+  size_t const index = m_nodes.size() - 1;
+  if (index >= m_prevNodes.size())
+    return false;
+
+  Node const & prev = m_prevNodes[index];
+  if (prev.m_handle != node.m_handle || prev.m_isCandidate != node.m_isCandidate)
+    return false;
+
+  if (!node.m_isCandidate)
+    return true;
+
+  return prev.m_priority == node.m_priority && prev.m_pixelRect == node.m_pixelRect;
+}
+
+void OverlayTree::GetCellsRange(m2::RectD const & rect, int & minX, int & minY, int & maxX, int & maxY) const
 {
-  ForEach([] (RefPointer<OverlayHandle> handle)
+  m2::RectD const & pixelRect = m_modelView.PixelRect();
+  auto const toCell = [](double v, double origin, int count)
   {
-    handle->SetIsVisible(true);
-  });
+    return static_cast<int>(floor(my::clamp((v - origin) / kCellSize, 0.0, count - 1.0)));
+  };
 
-  Clear();
+  minX = toCell(rect.minX(), pixelRect.minX(), m_cellsWidth);
+  maxX = toCell(rect.maxX(), pixelRect.minX(), m_cellsWidth);
+  minY = toCell(rect.minY(), pixelRect.minY(), m_cellsHeight);
+  maxY = toCell(rect.maxY(), pixelRect.minY(), m_cellsHeight);
 }
 
 } // namespace dp
@@ -3,41 +3,67 @@
 #include "drape/overlay_handle.hpp"
 
 #include "geometry/screenbase.hpp"
-#include "geometry/tree4d.hpp"
 
+#include "std/vector.hpp"
 
-namespace dp
-{
 
-namespace detail
-{
-
-struct OverlayTraits
+namespace dp
 {
-  ScreenBase m_modelView;
-
-  inline m2::RectD const LimitRect(RefPointer<OverlayHandle> handle)
-  {
-    return handle->GetPixelRect(m_modelView);
-  }
-};
 
-}
-
-class OverlayTree : public m4::Tree<RefPointer<OverlayHandle>, detail::OverlayTraits>
+/// Places overlays of one frame on the screen. Handles are added in the order of the
+/// placing, a handle is hidden when it intersects an already placed one of the greater
+/// priority, otherwise it hides all intersected ones. So on equal priorities the later
+/// handle wins and the result depends on the order of adding only.
+///
+/// Placed handles are kept in a uniform grid of screen cells, which storage is reused
+/// between the frames. When the screen isn't changed and the same handles come in the
+/// same order with the same pixel rects, intersections aren't tested again and the
+/// previous frame result is applied.
+class OverlayTree
 {
-  typedef m4::Tree<RefPointer<OverlayHandle>, detail::OverlayTraits> BaseT;
-
 public:
+  OverlayTree();
+
   void StartOverlayPlacing(ScreenBase const & screen, bool canOverlap = false);
   void Add(RefPointer<OverlayHandle> handle);
   void EndOverlayPlacing();
 
 private:
-  ScreenBase const & GetModelView() const { return m_traits.m_modelView; }
+  struct Node
+  {
+    OverlayHandle * m_handle;
+    m2::RectD m_pixelRect;
+    double m_priority;
+    // The handle is valid and it's on the screen.
+    bool m_isCandidate;
+    // The handle is placed and it isn't hidden by the later ones.
+    bool m_isPlaced;
+  };
+
+  void Place(uint32_t nodeIndex);
+  void ReplayFrame();
+  bool IsSameAsPrevious(Node const & node) const;
+
+  void GetCellsRange(m2::RectD const & rect, int & minX, int & minY, int & maxX, int & maxY) const;
 
 private:
+  ScreenBase m_modelView;
   bool m_canOverlap;
+
+  vector<Node> m_nodes;
+  vector<Node> m_prevNodes;
+  ScreenBase m_prevModelView;
+  bool m_prevCanOverlap;
+  // The frame goes the same way as the previous one, so nothing is placed yet.
+  bool m_isReusing;
+
+  // Indexes of the nodes placed into a cell, rows go one by one.
+  vector<vector<uint32_t>> m_cells;
+  int m_cellsWidth;
+  int m_cellsHeight;
+  // A node is checked once per query, though it can be in several cells.
+  vector<uint32_t> m_queryStamps;
+  uint32_t m_queryStamp;
 };
 
 } // namespace dp
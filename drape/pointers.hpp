@@ -251,6 +251,14 @@ public:
     Reset(NULL);
   }
 
+  /// Gives up the ownership, the object must be deleted or passed to MovePointer later.
+  T * Release()
+  {
+    T * p = GetRaw();
+    base_t::Reset(NULL);
+    return p;
+  }
+
   void Reset(T * p)
   {
     base_t::Destroy();
@@ -0,0 +1,214 @@
+#include "drape/pooled_object.hpp"
+
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+
+#include "std/atomic.hpp"
+#include "std/cstdlib.hpp"
+#include "std/mutex.hpp"
+
+#include <new>
+
+namespace dp
+{
+
+namespace
+{
+
+/// Block of a size class starts with the header, the object goes after it.
+struct Header
+{
+  uint32_t m_class;
+  // 1-based index of the block in its size class.
+  uint32_t m_index;
+};
+
+size_t const kHeaderSize = 8;
+size_t const kGranularity = 16;
+size_t const kClassesCount = 16;
+// Header of the objects allocated by the global operator new.
+uint32_t const kGlobalClass = static_cast<uint32_t>(kClassesCount);
+
+size_t const kChunkSize = 64 * 1024;
+// 64 Mb of each size class at most, the blocks above it are allocated by operator new.
+size_t const kMaxChunksCount = 1024;
+
+static_assert(sizeof(Header) == kHeaderSize, "");
+static_assert(kClassesCount * kGranularity - kHeaderSize == SmallObjectPool::kMaxObjectSize, "");
+
+class SizeClass
+{
+public:
+  SizeClass(uint32_t classIndex, size_t blockSize)
+    : m_classIndex(classIndex)
+    , m_blockSize(blockSize)
+    , m_blocksPerChunk(static_cast<uint32_t>(kChunkSize / blockSize))
+    , m_head(0)
+    , m_chunksCount(0)
+  {
+    for (atomic<char *> & chunk : m_chunks)
+      chunk.store(nullptr, memory_order_relaxed);
+  }
+
+  /// @return Object memory or nullptr when the class can't grow.
+  void * Pop()
+  {
+    // The head is the index of the first free block and the count of the changes of the list,
+    // the count protects from ABA when the block is popped and pushed back meanwhile.
+    uint64_t head = m_head.load(memory_order_acquire);
+    while (true)
+    {
+      uint32_t const index = static_cast<uint32_t>(head);
+      if (index == 0)
+      {
+        if (!Grow())
+          return nullptr;
+        head = m_head.load(memory_order_acquire);
+        continue;
+      }
+
+      char * block = GetBlock(index);
+      // The block may be popped by another thread at this moment, then the next index is
+      // garbage, but the CAS fails since the count is changed. Chunks are never freed, so
+      // the read itself is safe.
+      uint32_t const next = GetNext(block)->load(memory_order_relaxed);
+      uint64_t const newHead = MakeHead(head, next);
+      if (m_head.compare_exchange_weak(head, newHead, memory_order_acquire, memory_order_acquire))
+        return block + kHeaderSize;
+    }
+  }
+
+  void Push(uint32_t index)
+  {
+    char * block = GetBlock(index);
+    PushList(index, block);
+  }
+
+  char * GetBlock(uint32_t index) const
+  {
+    uint32_t const i = index - 1;
+    char * chunk = m_chunks[i / m_blocksPerChunk].load(memory_order_acquire);
+    ASSERT(chunk != nullptr, (index));
+    return chunk + (i % m_blocksPerChunk) * m_blockSize;
+  }
+
+private:
+  static uint64_t MakeHead(uint64_t prevHead, uint32_t index)
+  {
+    return (((prevHead >> 32) + 1) << 32) | index;
+  }
+
+  static atomic<uint32_t> * GetNext(char * block)
+  {
+    return reinterpret_cast<atomic<uint32_t> *>(block + kHeaderSize);
+  }
+
+  /// Pushes the list of the linked blocks from first to last.
+  void PushList(uint32_t first, char * last)
+  {
+    atomic<uint32_t> * next = new (last + kHeaderSize) atomic<uint32_t>(0);
+    uint64_t head = m_head.load(memory_order_relaxed);
+    do
+    {
+      next->store(static_cast<uint32_t>(head), memory_order_relaxed);
+    } while (!m_head.compare_exchange_weak(head, MakeHead(head, first), memory_order_release,
+                                           memory_order_relaxed));
+  }
+
+  bool Grow()
+  {
+    lock_guard<mutex> lock(m_growMutex);
+    if (static_cast<uint32_t>(m_head.load(memory_order_acquire)) != 0)
+      return true;
+
+    uint32_t const chunkIndex = m_chunksCount.load(memory_order_relaxed);
+    if (chunkIndex == kMaxChunksCount)
+      return false;
+
+    char * chunk = static_cast<char *>(malloc(kChunkSize));
+    if (chunk == nullptr)
+      return false;
+    m_chunks[chunkIndex].store(chunk, memory_order_release);
+    m_chunksCount.store(chunkIndex + 1, memory_order_relaxed);
+
+    uint32_t const first = chunkIndex * m_blocksPerChunk + 1;
+    for (uint32_t i = 0; i < m_blocksPerChunk; ++i)
+    {
+      char * block = chunk + i * m_blockSize;
+      new (block) Header{m_classIndex, first + i};
+      new (block + kHeaderSize) atomic<uint32_t>(first + i + 1);
+    }
+    PushList(first, chunk + (m_blocksPerChunk - 1) * m_blockSize);
+    return true;
+  }
+
+  uint32_t const m_classIndex;
+  size_t const m_blockSize;
+  uint32_t const m_blocksPerChunk;
+
+  atomic<uint64_t> m_head;
+
+  // Chunks are added under m_growMutex and are read without it.
+  atomic<char *> m_chunks[kMaxChunksCount];
+  atomic<uint32_t> m_chunksCount;
+  mutex m_growMutex;
+
+  DISALLOW_COPY_AND_MOVE(SizeClass);
+};
+
+SizeClass & GetSizeClass(size_t index)
+{
+  ASSERT_LESS(index, kClassesCount, ());
+  // Deleted chunks may be referenced by the objects which outlive the static objects,
+  // so the classes are never destroyed.
+  static SizeClass * classes = []()
+  {
+    SizeClass * classes = static_cast<SizeClass *>(malloc(kClassesCount * sizeof(SizeClass)));
+    for (size_t i = 0; i < kClassesCount; ++i)
+      new (&classes[i]) SizeClass(static_cast<uint32_t>(i), (i + 1) * kGranularity);
+    return classes;
+  }();
+  return classes[index];
+}
+
+} // namespace
+
+// static
+size_t const SmallObjectPool::kMaxObjectSize;
+
+// static
+void * SmallObjectPool::Allocate(size_t size)
+{
+  if (size <= kMaxObjectSize)
+  {
+    size_t const classIndex = (size + kHeaderSize - 1) / kGranularity;
+    void * p = GetSizeClass(classIndex).Pop();
+    if (p != nullptr)
+      return p;
+  }
+
+  char * block = static_cast<char *>(::operator new(size + kHeaderSize));
+  new (block) Header{kGlobalClass, 0};
+  return block + kHeaderSize;
+}
+
+// static
+void SmallObjectPool::Deallocate(void * p)
+{
+  if (p == nullptr)
+    return;
+
+  char * block = static_cast<char *>(p) - kHeaderSize;
+  Header const * header = reinterpret_cast<Header const *>(block);
+  if (header->m_class == kGlobalClass)
+  {
+    ::operator delete(block);
+    return;
+  }
+
+  SizeClass & sizeClass = GetSizeClass(header->m_class);
+  ASSERT_EQUAL(sizeClass.GetBlock(header->m_index), block, ());
+  sizeClass.Push(header->m_index);
+}
+
+} // namespace dp
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "std/cstdint.hpp"
+
+namespace dp
+{
+
+/// Lock-free allocator of the small objects which are created and deleted on every frame by
+/// the drape threads: messages, overlay handles, render buckets. Blocks of each size class lie
+/// in a free list which is popped and pushed by one CAS, the lists grow by big chunks which
+/// are never freed, so in the steady state no malloc is called and no mutex is locked.
+/// Objects bigger than the biggest size class are allocated by the global operator new.
+/// The returned memory is aligned for 8 bytes.
+class SmallObjectPool
+{
+public:
+  static size_t const kMaxObjectSize = 248;
+
+  static void * Allocate(size_t size);
+  static void Deallocate(void * p);
+};
+
+/// Base of the classes whose objects are allocated by SmallObjectPool. MasterPointer and
+/// TransferPointer delete them by delete, so the ownership model doesn't change.
+class PooledObject
+{
+public:
+  static void * operator new(size_t size) { return SmallObjectPool::Allocate(size); }
+  static void operator delete(void * p) { SmallObjectPool::Deallocate(p); }
+};
+
+} // namespace dp
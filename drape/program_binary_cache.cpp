@@ -0,0 +1,140 @@
+#include "drape/program_binary_cache.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/sha2.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+namespace dp
+{
+
+// static
+uint8_t const ProgramBinaryCache::kVersion;
+
+ProgramBinaryCache::ProgramBinaryCache(string const & filePath, string const & key)
+  : m_filePath(filePath)
+  , m_key(key)
+  , m_isChanged(false)
+{
+}
+
+// static
+string ProgramBinaryCache::GetSourcesHash(string const & vertexSource, string const & fragmentSource)
+{
+  // Sources are separated, so the moved text between the shaders changes the hash.
+  return sha2::digest256(vertexSource + '\0' + fragmentSource, false /* returnAsHexString */);
+}
+
+bool ProgramBinaryCache::Load()
+{
+  m_entries.clear();
+  m_isChanged = false;
+  if (m_filePath.empty() || !Platform::IsFileExistsByFullPath(m_filePath))
+    return false;
+
+  try
+  {
+    string data;
+    FileReader(m_filePath).ReadAsString(data);
+    MemReader reader(data.data(), data.size());
+    ReaderSource<MemReader> src(reader);
+
+    if (ReadPrimitiveFromSource<uint8_t>(src) != kVersion)
+      return false;
+    string key;
+    rw::Read(src, key);
+    if (key != m_key)
+      return false;
+
+    uint32_t const count = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      int const programIndex = ReadVarInt<int32_t>(src);
+      Entry & entry = m_entries[programIndex];
+      entry.m_format = ReadVarUint<uint32_t>(src);
+      rw::Read(src, entry.m_sourcesHash);
+
+      uint32_t const size = ReadVarUint<uint32_t>(src);
+      if (size > src.Size())
+        MYTHROW(Reader::SizeException, ("Broken program binary cache file", size, src.Size()));
+      entry.m_binary.resize(size);
+      if (size > 0)
+        src.Read(entry.m_binary.data(), size);
+    }
+    return true;
+  }
+  catch (Reader::Exception const & ex)
+  {
+    LOG(LWARNING, ("Can't load program binary cache", m_filePath, ex.Msg()));
+    m_entries.clear();
+    return false;
+  }
+}
+
+void ProgramBinaryCache::Save()
+{
+  if (m_filePath.empty() || !m_isChanged)
+    return;
+
+  // The file is replaced at once, so it's never read half-written.
+  string const tmpPath = m_filePath + ".tmp";
+  try
+  {
+    {
+      FileWriter writer(tmpPath);
+      WriteToSink(writer, kVersion);
+      rw::Write(writer, m_key);
+
+      WriteVarUint(writer, static_cast<uint32_t>(m_entries.size()));
+      for (auto const & node : m_entries)
+      {
+        Entry const & entry = node.second;
+        WriteVarInt(writer, static_cast<int32_t>(node.first));
+        WriteVarUint(writer, entry.m_format);
+        rw::Write(writer, entry.m_sourcesHash);
+        WriteVarUint(writer, static_cast<uint32_t>(entry.m_binary.size()));
+        writer.Write(entry.m_binary.data(), entry.m_binary.size());
+      }
+    }
+    if (my::RenameFileX(tmpPath, m_filePath))
+      m_isChanged = false;
+    else
+      LOG(LWARNING, ("Can't rename program binary cache file", tmpPath, "to", m_filePath));
+  }
+  catch (Writer::Exception const & ex)
+  {
+    LOG(LWARNING, ("Can't save program binary cache", m_filePath, ex.Msg()));
+    my::DeleteFileX(tmpPath);
+  }
+}
+
+ProgramBinaryCache::Entry const * ProgramBinaryCache::Find(int programIndex, string const & sourcesHash) const
+{
+  auto const it = m_entries.find(programIndex);
+  if (it == m_entries.end() || it->second.m_sourcesHash != sourcesHash)
+    return nullptr;
+  return &it->second;
+}
+
+void ProgramBinaryCache::Add(int programIndex, Entry && entry)
+{
+  ASSERT(!entry.m_binary.empty(), ());
+  m_entries[programIndex] = move(entry);
+  m_isChanged = true;
+}
+
+void ProgramBinaryCache::Remove(int programIndex)
+{
+  if (m_entries.erase(programIndex) > 0)
+    m_isChanged = true;
+}
+
+} // namespace dp
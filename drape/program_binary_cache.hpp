@@ -0,0 +1,50 @@
+#pragma once
+
+#include "std/map.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace dp
+{
+
+/// Binaries of the linked programs, they save compiling of the shaders on startup.
+/// The cache file is valid only for the driver it was written with, it's given by the key.
+/// Every binary keeps the hash of its shaders sources, so changed programs are
+/// compiled again. The class isn't thread safe.
+class ProgramBinaryCache
+{
+public:
+  struct Entry
+  {
+    uint32_t m_format = 0;
+    string m_sourcesHash;
+    vector<uint8_t> m_binary;
+  };
+
+  /// @param filePath The cache is kept in memory only when it's empty.
+  ProgramBinaryCache(string const & filePath, string const & key);
+
+  static string GetSourcesHash(string const & vertexSource, string const & fragmentSource);
+
+  /// @return False when there is no valid cache file.
+  bool Load();
+  /// Writes the file when binaries were changed since the loading.
+  void Save();
+
+  /// @return Null when there is no binary of the same sources.
+  Entry const * Find(int programIndex, string const & sourcesHash) const;
+  void Add(int programIndex, Entry && entry);
+  /// The binary is dropped when the driver doesn't accept it.
+  void Remove(int programIndex);
+  size_t GetCount() const { return m_entries.size(); }
+
+private:
+  static uint8_t const kVersion = 0;
+
+  string const m_filePath;
+  string const m_key;
+  map<int, Entry> m_entries;
+  bool m_isChanged;
+};
+
+} // namespace dp
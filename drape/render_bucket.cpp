@@ -1,5 +1,6 @@
 #include "drape/render_bucket.hpp"
 
+#include "drape/binding_info.hpp"
 #include "drape/overlay_handle.hpp"
 #include "drape/attribute_buffer_mutator.hpp"
 #include "drape/vertex_array_buffer.hpp"
@@ -13,6 +14,7 @@ namespace dp
 
 RenderBucket::RenderBucket(TransferPointer<VertexArrayBuffer> buffer)
   : m_buffer(buffer)
+  , m_hasDynamicPositions(false)
 {
 }
 
@@ -32,6 +34,40 @@ void RenderBucket::AddOverlayHandle(TransferPointer<OverlayHandle> handle)
   m_overlay.push_back(MasterPointer<OverlayHandle>(handle));
 }
 
+void RenderBucket::AddToBoundingRect(BindingInfo const & info, void const * data, uint16_t count)
+{
+  for (uint16_t i = 0; i < info.GetCount(); ++i)
+  {
+    BindingDecl const & decl = info.GetBindingDecl(i);
+    if (decl.m_attributeName != "a_position")
+      continue;
+
+    if (info.IsDynamic())
+    {
+      m_hasDynamicPositions = true;
+      return;
+    }
+
+    ASSERT_EQUAL(decl.m_componentType, gl_const::GLFloatType, ());
+    ASSERT_GREATER_OR_EQUAL(decl.m_componentCount, 2, ());
+    uint16_t const stride = decl.m_stride != 0 ? decl.m_stride : info.GetElementSize();
+    uint8_t const * p = static_cast<uint8_t const *>(data) + decl.m_offset;
+    for (uint16_t v = 0; v < count; ++v, p += stride)
+    {
+      float const * pos = reinterpret_cast<float const *>(p);
+      m_boundingRect.Add(m2::PointD(pos[0], pos[1]));
+    }
+    return;
+  }
+}
+
+bool RenderBucket::IsCulled(m2::AnyRectD const & clipRect) const
+{
+  if (m_hasDynamicPositions || !m_boundingRect.IsValid())
+    return false;
+  return !clipRect.IsIntersect(m2::AnyRectD(m_boundingRect));
+}
+
 void RenderBucket::Update(ScreenBase const & modelView)
 {
   for_each(m_overlay.begin(), m_overlay.end(), bind(&OverlayHandle::Update,
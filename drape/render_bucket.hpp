@@ -1,17 +1,22 @@
 #pragma once
 
 #include "drape/pointers.hpp"
+#include "drape/pooled_object.hpp"
+
+#include "geometry/any_rect2d.hpp"
+#include "geometry/rect2d.hpp"
 
 class ScreenBase;
 
 namespace dp
 {
 
+class BindingInfo;
 class OverlayHandle;
 class OverlayTree;
 class VertexArrayBuffer;
 
-class RenderBucket
+class RenderBucket : public PooledObject
 {
 public:
   RenderBucket(TransferPointer<VertexArrayBuffer> buffer);
@@ -21,6 +26,13 @@ public:
 
   void AddOverlayHandle(TransferPointer<OverlayHandle> handle);
 
+  /// Extends the bounding rect by the "a_position" attributes of the uploaded vertices.
+  /// Positions are in global coordinates, pixel offsets of the vertices aren't taken into account.
+  void AddToBoundingRect(BindingInfo const & info, void const * data, uint16_t count);
+  m2::RectD const & GetBoundingRect() const { return m_boundingRect; }
+  /// @return True when the bucket is surely out of clipRect and needn't be rendered.
+  bool IsCulled(m2::AnyRectD const & clipRect) const;
+
   void Update(ScreenBase const & modelView);
   void CollectOverlayHandles(RefPointer<OverlayTree> tree);
   void Render(ScreenBase const & screen);
@@ -36,6 +48,9 @@ public:
 private:
   vector<MasterPointer<OverlayHandle> > m_overlay;
   MasterPointer<VertexArrayBuffer> m_buffer;
+  m2::RectD m_boundingRect;
+  /// Positions are changed on rendering, so the bounding rect is unknown.
+  bool m_hasDynamicPositions;
 };
 
 } // namespace dp
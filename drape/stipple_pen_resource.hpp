@@ -100,6 +100,7 @@ public:
   StipplePenIndex(m2::PointU const & canvasSize) : m_packer(canvasSize) {}
   RefPointer<Texture::ResourceInfo> MapResource(StipplePenKey const & key);
   void UploadResources(RefPointer<Texture> texture);
+  bool HasPendingResources() const { return !m_pendingNodes.empty(); }
   glConst GetMinFilter() const;
   glConst GetMagFilter() const;
 
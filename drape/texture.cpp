@@ -5,11 +5,22 @@
 
 #include "base/math.hpp"
 
+#include "std/atomic.hpp"
+
 #define ASSERT_ID ASSERT(GetID() != -1, ())
 
 namespace dp
 {
 
+namespace
+{
+
+atomic<uint32_t> g_allocatedBytes(0);
+/// Pixel unpack buffer of the uploads, 0 when the uploads are synchronous.
+uint32_t g_uploadBufferID = 0;
+
+} // namespace
+
 Texture::ResourceInfo::ResourceInfo(m2::RectF const & texRect)
   : m_texRect(texRect) {}
 
@@ -31,7 +42,10 @@ Texture::Texture()
 Texture::~Texture()
 {
   if (m_textureID != -1)
+  {
     GLFunctions::glDeleteTexture(m_textureID);
+    g_allocatedBytes -= GetBytesSize();
+  }
 }
 
 void Texture::Create(uint32_t width, uint32_t height, TextureFormat format)
@@ -58,6 +72,7 @@ void Texture::Create(uint32_t width, uint32_t height, TextureFormat format, RefP
   UnpackFormat(format, layout, pixelType);
 
   GLFunctions::glTexImage2D(m_width, m_height, layout, pixelType, data.GetRaw());
+  g_allocatedBytes += GetBytesSize();
   SetFilterParams(gl_const::GLLinear, gl_const::GLLinear);
   SetWrapMode(gl_const::GLClampToEdge, gl_const::GLClampToEdge);
 }
@@ -86,7 +101,20 @@ void Texture::UploadData(uint32_t x, uint32_t y, uint32_t width, uint32_t height
 
   UnpackFormat(format, layout, pixelType);
 
-  GLFunctions::glTexSubImage2D(x, y, width, height, layout, pixelType, data.GetRaw());
+  if (g_uploadBufferID == 0)
+  {
+    GLFunctions::glTexSubImage2D(x, y, width, height, layout, pixelType, data.GetRaw());
+    return;
+  }
+
+  // glBufferData gives new storage to the buffer each time, so the upload doesn't wait
+  // for the transfer of the previous one, and glTexSubImage2D reads from the buffer at offset 0.
+  uint32_t const bytesCount = width * height * GetBytesPerPixel(format);
+  GLFunctions::glBindBuffer(g_uploadBufferID, gl_const::GLPixelUnpackBuffer);
+  GLFunctions::glBufferData(gl_const::GLPixelUnpackBuffer, bytesCount, data.GetRaw(),
+                            gl_const::GLStreamDraw);
+  GLFunctions::glTexSubImage2D(x, y, width, height, layout, pixelType, nullptr);
+  GLFunctions::glBindBuffer(0, gl_const::GLPixelUnpackBuffer);
 }
 
 TextureFormat Texture::GetFormat() const
@@ -129,6 +157,53 @@ uint32_t Texture::GetMaxTextureSize()
   return GLFunctions::glGetInteger(gl_const::GLMaxTextureSize);
 }
 
+// static
+uint32_t Texture::GetAllocatedBytes()
+{
+  return g_allocatedBytes;
+}
+
+// static
+void Texture::CreateUploadBuffer()
+{
+  if (g_uploadBufferID == 0 &&
+      GLExtensionsList::Instance().IsSupported(GLExtensionsList::PixelBufferObject))
+  {
+    g_uploadBufferID = GLFunctions::glGenBuffer();
+  }
+}
+
+// static
+void Texture::DestroyUploadBuffer()
+{
+  if (g_uploadBufferID != 0)
+  {
+    GLFunctions::glDeleteBuffer(g_uploadBufferID);
+    g_uploadBufferID = 0;
+  }
+}
+
+uint32_t Texture::GetBytesSize() const
+{
+  return m_width * m_height * GetBytesPerPixel(m_format);
+}
+
+// static
+uint32_t Texture::GetBytesPerPixel(TextureFormat format)
+{
+  switch (format)
+  {
+  case RGBA8:
+    return 4;
+  case RGBA4:
+    return 2;
+  case ALPHA:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
 void Texture::UnpackFormat(TextureFormat format, glConst & layout, glConst & pixelType)
 {
   bool requiredFormat = GLExtensionsList::Instance().IsSupported(GLExtensionsList::RequiredInternalFormat);
@@ -67,10 +67,23 @@ public:
   void Bind() const;
 
   static uint32_t GetMaxTextureSize();
+  /// GPU memory of all created textures in bytes.
+  static uint32_t GetAllocatedBytes();
+
+  /// @name Pixel buffer of the uploads.
+  /// When it's created, UploadData() copies the data to the buffer and returns without waiting
+  /// for the texture, the driver transfers it to the texture asynchronously. Both must be called
+  /// on the thread which uploads the textures.
+  //@{
+  static void CreateUploadBuffer();
+  static void DestroyUploadBuffer();
+  //@}
 
 private:
   void UnpackFormat(TextureFormat format, glConst & layout, glConst & pixelType);
+  static uint32_t GetBytesPerPixel(TextureFormat format);
   int32_t GetID() const;
+  uint32_t GetBytesSize() const;
 
 private:
   int32_t m_textureID;
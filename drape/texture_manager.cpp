@@ -10,8 +10,12 @@
 
 #include "coding/file_name_utils.hpp"
 
+#include "base/logging.hpp"
+#include "base/math.hpp"
 #include "base/stl_add.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
 #include "std/vector.hpp"
 #include "std/bind.hpp"
 
@@ -20,6 +24,9 @@ namespace dp
 
 uint32_t const STIPPLE_TEXTURE_SIZE = 1024;
 uint32_t const COLOR_TEXTURE_SIZE = 1024;
+uint32_t const MIN_GLYPH_TEXTURE_SIZE = 256;
+// Part of the glyph texture which is filled by glyphs of the average size.
+double const GLYPH_TEXTURE_FILLING = 0.9;
 
 bool TextureManager::BaseRegion::IsValid() const
 {
@@ -117,12 +124,25 @@ void TextureManager::UpdateDynamicTextures()
 
 void TextureManager::AllocateGlyphTexture(TextureManager::GlyphGroup & group) const
 {
-  group.m_texture.Reset(new FontTexture(m2::PointU(m_maxTextureSize, m_maxTextureSize), m_glyphManager.GetRefPointer()));
+  // Groups of small unicode blocks don't need the whole texture.
+  uint32_t const glyphCount = group.m_endChar + 1 - group.m_startChar;
+  double const square = glyphCount * m_baseGlyphHeight * m_baseGlyphHeight / GLYPH_TEXTURE_FILLING;
+  uint32_t const minSize = min(MIN_GLYPH_TEXTURE_SIZE, m_maxTextureSize);
+  uint32_t size = my::clamp(my::NextPowOf2(static_cast<uint32_t>(ceil(sqrt(square)))), minSize, m_maxTextureSize);
+
+  while (size > minSize && m_glyphTexturesBytes + size * size > m_glyphTexturesBudget)
+    size /= 2;
+  if (m_glyphTexturesBytes + size * size > m_glyphTexturesBudget)
+    LOG(LWARNING, ("Glyph textures budget is exceeded", m_glyphTexturesBytes, m_glyphTexturesBudget));
+
+  group.m_texture.Reset(new FontTexture(m2::PointU(size, size), m_glyphManager.GetRefPointer()));
+  m_glyphTexturesBytes += size * size;
 }
 
 void TextureManager::Init(Params const & params)
 {
   GLFunctions::glPixelStore(gl_const::GLUnpackAlignment, 1);
+  Texture::CreateUploadBuffer();
   SymbolsTexture * symbols = new SymbolsTexture();
   symbols->Load(my::JoinFoldersToPath(string("resources-") + params.m_resPrefix, "symbols"));
   m_symbolTexture.Reset(symbols);
@@ -132,13 +152,29 @@ void TextureManager::Init(Params const & params)
 
   m_glyphManager.Reset(new GlyphManager(params.m_glyphMngParams));
   m_maxTextureSize = GLFunctions::glGetInteger(gl_const::GLMaxTextureSize);
+  m_baseGlyphHeight = params.m_glyphMngParams.m_baseGlyphHeight;
+  m_glyphTexturesBudget = params.m_glyphTexturesBudget;
+  m_glyphTexturesBytes = 0;
+  m_glyphsCache.Resize(params.m_glyphsCacheSize);
+  m_glyphsCacheId = CacheGovernor::Instance().Register("GlyphRegions", CacheGovernor::LOW,
+      [this]() -> uint64_t
+      {
+        lock_guard<mutex> lock(m_glyphsCacheMutex);
+        return m_glyphsCache.CurrentWeight() * sizeof(GlyphRegion);
+      },
+      [this](double share)
+      {
+        if (share < 0.5)
+          return;
+        lock_guard<mutex> lock(m_glyphsCacheMutex);
+        m_glyphsCache.Clear();
+      });
 
   uint32_t const textureSquare = m_maxTextureSize * m_maxTextureSize;
-  uint32_t const baseGlyphHeight = params.m_glyphMngParams.m_baseGlyphHeight;
-  uint32_t const avarageGlyphSquare = baseGlyphHeight * baseGlyphHeight;
+  uint32_t const avarageGlyphSquare = m_baseGlyphHeight * m_baseGlyphHeight;
 
   m_glyphGroups.push_back(GlyphGroup());
-  uint32_t glyphCount = ceil(0.9 * textureSquare / avarageGlyphSquare);
+  uint32_t glyphCount = ceil(GLYPH_TEXTURE_FILLING * textureSquare / avarageGlyphSquare);
   m_glyphManager->ForEachUnicodeBlock([this, glyphCount](strings::UniChar const & start, strings::UniChar const & end)
   {
     if (m_glyphGroups.empty())
@@ -169,6 +205,19 @@ void TextureManager::Release()
   });
 
   DeleteRange(m_hybridGlyphGroups, MasterPointerDeleter());
+  m_glyphTexturesBytes = 0;
+  Texture::DestroyUploadBuffer();
+
+  CacheGovernor::Instance().Unregister(m_glyphsCacheId);
+  m_glyphsCacheId = CacheGovernor::kInvalidId;
+  {
+    lock_guard<mutex> lock(m_glyphsCacheMutex);
+    m_glyphsCache.Clear();
+    LOG(LINFO, ("Glyphs cache hits :", m_glyphsCacheStats.m_hits, "misses :", m_glyphsCacheStats.m_misses));
+    m_glyphsCacheStats = GlyphsCacheStats();
+  }
+
+  m_glyphManager.Destroy();
 }
 
 void TextureManager::GetSymbolRegion(string const & symbolName, SymbolRegion & region) const
@@ -193,6 +242,39 @@ void TextureManager::GetColorRegion(Color const & color, ColorRegion & region) c
 }
 
 void TextureManager::GetGlyphRegions(strings::UniString const & text, TGlyphsBuffer & regions) const
+{
+  {
+    lock_guard<mutex> lock(m_glyphsCacheMutex);
+    if (m_glyphsCache.HasElem(text))
+    {
+      ++m_glyphsCacheStats.m_hits;
+      TGlyphsBuffer const & cached = m_glyphsCache.Find(text);
+      regions.append(cached.begin(), cached.end());
+      return;
+    }
+    ++m_glyphsCacheStats.m_misses;
+  }
+
+  TGlyphsBuffer found;
+  FindGlyphRegions(text, found);
+  regions.append(found.begin(), found.end());
+
+  // Texts of the hybrid groups get no regions yet, they aren't worth caching.
+  if (found.empty())
+    return;
+
+  lock_guard<mutex> lock(m_glyphsCacheMutex);
+  if (!m_glyphsCache.HasElem(text) && static_cast<int>(found.size()) <= m_glyphsCache.MaxWeight())
+    m_glyphsCache.Add(text, found, found.size());
+}
+
+TextureManager::GlyphsCacheStats TextureManager::GetGlyphsCacheStats() const
+{
+  lock_guard<mutex> lock(m_glyphsCacheMutex);
+  return m_glyphsCacheStats;
+}
+
+void TextureManager::FindGlyphRegions(strings::UniString const & text, TGlyphsBuffer & regions) const
 {
   size_t const INVALID_GROUP = static_cast<size_t>(-1);
   size_t groupIndex = INVALID_GROUP;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "base/cache_governor.hpp"
+#include "base/mru_cache.hpp"
 #include "base/string_utils.hpp"
 
 #include "drape/color.hpp"
@@ -7,6 +9,8 @@
 #include "drape/texture.hpp"
 #include "drape/glyph_manager.hpp"
 
+#include "std/mutex.hpp"
+
 namespace dp
 {
 
@@ -62,6 +66,17 @@ public:
   {
     string m_resPrefix;
     GlyphManager::Params m_glyphMngParams;
+    /// GPU memory for the glyph textures in bytes. When it's spent new glyph
+    /// textures get the minimal size, so some glyphs may not be drawn.
+    uint32_t m_glyphTexturesBudget = 32 * 1024 * 1024;
+    /// Maximal count of glyphs in the cache of the text glyph regions.
+    uint32_t m_glyphsCacheSize = 16 * 1024;
+  };
+
+  struct GlyphsCacheStats
+  {
+    uint32_t m_hits = 0;
+    uint32_t m_misses = 0;
   };
 
   void Init(Params const & params);
@@ -72,9 +87,16 @@ public:
   void GetColorRegion(Color const & color, ColorRegion & region) const;
 
   typedef buffer_vector<GlyphRegion, 32> TGlyphsBuffer;
+  /// Glyph regions of recently requested texts are cached, so repeated labels
+  /// don't look up every glyph again. It's safe as glyphs are never removed
+  /// from the textures until Release().
   void GetGlyphRegions(strings::UniString const & text, TGlyphsBuffer & regions) const;
+  GlyphsCacheStats GetGlyphsCacheStats() const;
   void UpdateDynamicTextures();
 
+  /// GPU memory of the glyph textures in bytes.
+  uint32_t GetGlyphTexturesBytes() const { return m_glyphTexturesBytes; }
+
 private:
   struct GlyphGroup
   {
@@ -89,8 +111,12 @@ private:
   };
 
   uint32_t m_maxTextureSize;
+  uint32_t m_baseGlyphHeight = 0;
+  uint32_t m_glyphTexturesBudget = 0;
+  mutable uint32_t m_glyphTexturesBytes = 0;
 
   void AllocateGlyphTexture(TextureManager::GlyphGroup & group) const;
+  void FindGlyphRegions(strings::UniString const & text, TGlyphsBuffer & regions) const;
 
 private:
   MasterPointer<Texture> m_symbolTexture;
@@ -101,6 +127,12 @@ private:
 
   mutable buffer_vector<GlyphGroup, 64> m_glyphGroups;
   mutable buffer_vector<MasterPointer<Texture>, 4> m_hybridGlyphGroups;
+
+  /// Weight of a cached text is its glyphs count.
+  mutable my::MRUCache<strings::UniString, TGlyphsBuffer> m_glyphsCache;
+  mutable GlyphsCacheStats m_glyphsCacheStats;
+  mutable mutex m_glyphsCacheMutex;
+  CacheGovernor::TCacheId m_glyphsCacheId = CacheGovernor::kInvalidId;
 };
 
 } // namespace dp
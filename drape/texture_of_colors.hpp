@@ -32,6 +32,7 @@ public:
 
   RefPointer<Texture::ResourceInfo> MapResource(ColorKey const & key);
   void UploadResources(RefPointer<Texture> texture);
+  bool HasPendingResources() const { return !m_pendingNodes.empty(); }
   glConst GetMinFilter() const;
   glConst GetMagFilter() const;
 
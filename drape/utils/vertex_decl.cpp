@@ -1,17 +1,23 @@
 #include "drape/utils/vertex_decl.hpp"
 
+#include "base/math.hpp"
+
 namespace gpu
 {
 
 namespace
 {
 
+float const kMaxPackedValue = 65535.0f;
+
 enum VertexType
 {
   SolidTexturing,
   TextStatic,
   TextDynamic,
   Line,
+  InstanceMesh,
+  Symbol,
   TypeCount
 };
 
@@ -47,8 +53,8 @@ dp::BindingInfo SolidTexturingBindingInit()
 
   dp::BindingDecl & colorTexCoordDecl = info.GetBindingDecl(2);
   colorTexCoordDecl.m_attributeName = "a_colorTexCoords";
-  colorTexCoordDecl.m_componentCount = glsl::GetComponentCount<SolidTexturingVertex::TTexCoord>();
-  colorTexCoordDecl.m_componentType = gl_const::GLFloatType;
+  colorTexCoordDecl.m_componentCount = SolidTexturingVertex::TTexCoord::GetComponentCount();
+  colorTexCoordDecl.m_componentType = SolidTexturingVertex::TTexCoord::GetComponentType();
   colorTexCoordDecl.m_offset = normalDecl.m_offset + sizeof(SolidTexturingVertex::TNormal);
   colorTexCoordDecl.m_stride = posDecl.m_stride;
 
@@ -70,22 +76,22 @@ dp::BindingInfo TextStaticBindingInit()
 
   dp::BindingDecl & colorDecl = info.GetBindingDecl(1);
   colorDecl.m_attributeName = "a_colorTexCoord";
-  colorDecl.m_componentCount = glsl::GetComponentCount<TextStaticVertex::TTexCoord>();
-  colorDecl.m_componentType = gl_const::GLFloatType;
+  colorDecl.m_componentCount = TextStaticVertex::TTexCoord::GetComponentCount();
+  colorDecl.m_componentType = TextStaticVertex::TTexCoord::GetComponentType();
   colorDecl.m_offset = sizeof(TextStaticVertex::TPosition);
   colorDecl.m_stride = posDecl.m_stride;
 
   dp::BindingDecl & outlineDecl = info.GetBindingDecl(2);
   outlineDecl.m_attributeName = "a_outlineColorTexCoord";
-  outlineDecl.m_componentCount = glsl::GetComponentCount<TextStaticVertex::TTexCoord>();
-  outlineDecl.m_componentType = gl_const::GLFloatType;
+  outlineDecl.m_componentCount = TextStaticVertex::TTexCoord::GetComponentCount();
+  outlineDecl.m_componentType = TextStaticVertex::TTexCoord::GetComponentType();
   outlineDecl.m_offset = colorDecl.m_offset + sizeof(TextStaticVertex::TTexCoord);
   outlineDecl.m_stride = posDecl.m_stride;
 
   dp::BindingDecl & maskDecl = info.GetBindingDecl(3);
   maskDecl.m_attributeName = "a_maskTexCoord";
-  maskDecl.m_componentCount = glsl::GetComponentCount<TextStaticVertex::TTexCoord>();
-  maskDecl.m_componentType = gl_const::GLFloatType;
+  maskDecl.m_componentCount = TextStaticVertex::TTexCoord::GetComponentCount();
+  maskDecl.m_componentType = TextStaticVertex::TTexCoord::GetComponentType();
   maskDecl.m_offset = outlineDecl.m_offset + sizeof(TextStaticVertex::TTexCoord);
   maskDecl.m_stride = posDecl.m_stride;
 
@@ -130,15 +136,15 @@ dp::BindingInfo LineBindingInit()
 
   dp::BindingDecl & colorDecl = info.GetBindingDecl(2);
   colorDecl.m_attributeName = "a_colorTexCoord";
-  colorDecl.m_componentCount = glsl::GetComponentCount<LineVertex::TTexCoord>();
-  colorDecl.m_componentType = gl_const::GLFloatType;
+  colorDecl.m_componentCount = LineVertex::TTexCoord::GetComponentCount();
+  colorDecl.m_componentType = LineVertex::TTexCoord::GetComponentType();
   colorDecl.m_offset = normalDecl.m_offset + sizeof(LineVertex::TNormal);
   colorDecl.m_stride = posDecl.m_stride;
 
   dp::BindingDecl & maskDecl = info.GetBindingDecl(3);
   maskDecl.m_attributeName = "a_maskTexCoord";
-  maskDecl.m_componentCount = glsl::GetComponentCount<LineVertex::TTexCoord>();
-  maskDecl.m_componentType = gl_const::GLFloatType;
+  maskDecl.m_componentCount = LineVertex::TTexCoord::GetComponentCount();
+  maskDecl.m_componentType = LineVertex::TTexCoord::GetComponentType();
   maskDecl.m_offset = colorDecl.m_offset + sizeof(LineVertex::TTexCoord);
   maskDecl.m_stride = posDecl.m_stride;
 
@@ -152,13 +158,61 @@ dp::BindingInfo LineBindingInit()
   return info;
 }
 
+dp::BindingInfo InstanceMeshBindingInit()
+{
+  static_assert(sizeof(InstanceMeshVertex) == sizeof(InstanceMeshVertex::TNormal), "");
+  dp::BindingInfo info(1);
+
+  dp::BindingDecl & decl = info.GetBindingDecl(0);
+  decl.m_attributeName = "a_corner";
+  decl.m_componentCount = glsl::GetComponentCount<InstanceMeshVertex::TNormal>();
+  decl.m_componentType = gl_const::GLFloatType;
+  decl.m_offset = 0;
+  decl.m_stride = sizeof(InstanceMeshVertex);
+
+  return info;
+}
+
+dp::BindingInfo SymbolInstanceBindingInit()
+{
+  static_assert(sizeof(SymbolInstance) == (sizeof(SymbolInstance::TPosition) +
+                                           sizeof(SymbolInstance::TNormal) +
+                                           sizeof(SymbolInstance::TTexRect)), "");
+  dp::BindingInfo info(3);
+
+  dp::BindingDecl & posDecl = info.GetBindingDecl(0);
+  posDecl.m_attributeName = "a_position";
+  posDecl.m_componentCount = glsl::GetComponentCount<SymbolInstance::TPosition>();
+  posDecl.m_componentType = gl_const::GLFloatType;
+  posDecl.m_offset = 0;
+  posDecl.m_stride = sizeof(SymbolInstance);
+
+  dp::BindingDecl & sizeDecl = info.GetBindingDecl(1);
+  sizeDecl.m_attributeName = "a_halfSize";
+  sizeDecl.m_componentCount = glsl::GetComponentCount<SymbolInstance::TNormal>();
+  sizeDecl.m_componentType = gl_const::GLFloatType;
+  sizeDecl.m_offset = sizeof(SymbolInstance::TPosition);
+  sizeDecl.m_stride = posDecl.m_stride;
+
+  dp::BindingDecl & texRectDecl = info.GetBindingDecl(2);
+  texRectDecl.m_attributeName = "a_texRect";
+  texRectDecl.m_componentCount = SymbolInstance::TTexRect::GetComponentCount();
+  texRectDecl.m_componentType = SymbolInstance::TTexRect::GetComponentType();
+  texRectDecl.m_offset = sizeDecl.m_offset + sizeof(SymbolInstance::TNormal);
+  texRectDecl.m_stride = posDecl.m_stride;
+
+  return info;
+}
+
 BindingNode g_bindingNodes[TypeCount];
 TInitFunction g_initFunctions[TypeCount] =
 {
   &SolidTexturingBindingInit,
   &TextStaticBindingInit,
   &TextDynamicBindingInit,
-  &LineBindingInit
+  &LineBindingInit,
+  &InstanceMeshBindingInit,
+  &SymbolInstanceBindingInit
 };
 
 dp::BindingInfo const & GetBinding(VertexType type)
@@ -175,10 +229,27 @@ dp::BindingInfo const & GetBinding(VertexType type)
 
 } // namespace
 
+PackedTexCoord::PackedTexCoord()
+  : m_x(0)
+  , m_y(0)
+{
+}
+
+PackedTexCoord::PackedTexCoord(glsl::vec2 const & texCoord)
+{
+  m_x = static_cast<uint16_t>(my::clamp(texCoord.x, 0.0f, 1.0f) * kMaxPackedValue + 0.5f);
+  m_y = static_cast<uint16_t>(my::clamp(texCoord.y, 0.0f, 1.0f) * kMaxPackedValue + 0.5f);
+}
+
+glsl::vec2 PackedTexCoord::Unpack() const
+{
+  return glsl::vec2(m_x / kMaxPackedValue, m_y / kMaxPackedValue);
+}
+
 SolidTexturingVertex::SolidTexturingVertex()
   : m_position(0.0, 0.0, 0.0)
   , m_normal(0.0, 0.0)
-  , m_colorTexCoord(0.0, 0.0)
+  , m_colorTexCoord()
 {
 }
 
@@ -197,9 +268,9 @@ dp::BindingInfo const & SolidTexturingVertex::GetBindingInfo()
 
 TextStaticVertex::TextStaticVertex()
   : m_position(0.0, 0.0, 0.0)
-  , m_colorTexCoord(0.0, 0.0)
-  , m_outlineTexCoord(0.0, 0.0)
-  , m_maskTexCoord(0.0, 0.0)
+  , m_colorTexCoord()
+  , m_outlineTexCoord()
+  , m_maskTexCoord()
 {
 }
 
@@ -240,8 +311,8 @@ uint32_t TextDynamicVertex::GetDynamicStreamID()
 LineVertex::LineVertex()
   : m_position(0.0, 0.0, 0.0)
   , m_normal(0.0, 0.0)
-  , m_colorTexCoord(0.0, 0.0)
-  , m_maskTexCoord(0.0, 0.0)
+  , m_colorTexCoord()
+  , m_maskTexCoord()
   , m_dxdy(0.0, 0.0)
 {
 }
@@ -262,5 +333,49 @@ dp::BindingInfo const & LineVertex::GetBindingInfo()
   return GetBinding(Line);
 }
 
-} //namespace gpu
+InstanceMeshVertex::InstanceMeshVertex()
+  : m_corner(0.0, 0.0)
+{
+}
+
+InstanceMeshVertex::InstanceMeshVertex(TNormal const & corner)
+  : m_corner(corner)
+{
+}
 
+dp::BindingInfo const & InstanceMeshVertex::GetBindingInfo()
+{
+  return GetBinding(InstanceMesh);
+}
+
+SymbolInstance::TTexRect::TTexRect()
+{
+}
+
+SymbolInstance::TTexRect::TTexRect(glsl::vec4 const & texRect)
+  : m_min(glsl::vec2(texRect.x, texRect.y))
+  , m_max(glsl::vec2(texRect.z, texRect.w))
+{
+}
+
+SymbolInstance::SymbolInstance()
+  : m_position(0.0, 0.0, 0.0)
+  , m_halfSize(0.0, 0.0)
+  , m_texRect()
+{
+}
+
+SymbolInstance::SymbolInstance(TPosition const & position, TNormal const & halfSize,
+                               TTexRect const & texRect)
+  : m_position(position)
+  , m_halfSize(halfSize)
+  , m_texRect(texRect)
+{
+}
+
+dp::BindingInfo const & SymbolInstance::GetBindingInfo()
+{
+  return GetBinding(Symbol);
+}
+
+} //namespace gpu
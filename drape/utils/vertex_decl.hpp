@@ -8,11 +8,27 @@
 namespace gpu
 {
 
+/// Texture coordinates in [0, 1] (others are clamped) packed into normalized unsigned shorts. Attributes of integer
+/// types are normalized on fetching, so vertex shaders get them as usual vec2.
+struct PackedTexCoord
+{
+  PackedTexCoord();
+  PackedTexCoord(glsl::vec2 const & texCoord);
+
+  glsl::vec2 Unpack() const;
+
+  static uint8_t GetComponentCount() { return 2; }
+  static glConst GetComponentType() { return gl_const::GLUnsignedShortType; }
+
+  uint16_t m_x;
+  uint16_t m_y;
+};
+
 struct BaseVertex
 {
   typedef glsl::vec3 TPosition;
   typedef glsl::vec2 TNormal;
-  typedef glsl::vec2 TTexCoord;
+  typedef PackedTexCoord TTexCoord;
 };
 
 struct SolidTexturingVertex : BaseVertex
@@ -75,4 +91,41 @@ struct LineVertex : BaseVertex
   static dp::BindingInfo const & GetBindingInfo();
 };
 
+/// Vertex of the mesh which is drawn by instances, the corner is scaled by the instance size.
+struct InstanceMeshVertex : BaseVertex
+{
+  InstanceMeshVertex();
+  InstanceMeshVertex(TNormal const & corner);
+
+  TNormal m_corner;
+
+  static dp::BindingInfo const & GetBindingInfo();
+};
+
+/// Instance of a symbol or a circle. Corners of the mesh in [-1, 1] map to the texture rect.
+struct SymbolInstance : BaseVertex
+{
+  /// (minX, minY, maxX, maxY) of the texture rect.
+  struct TTexRect
+  {
+    TTexRect();
+    TTexRect(glsl::vec4 const & texRect);
+
+    static uint8_t GetComponentCount() { return 4; }
+    static glConst GetComponentType() { return PackedTexCoord::GetComponentType(); }
+
+    PackedTexCoord m_min;
+    PackedTexCoord m_max;
+  };
+
+  SymbolInstance();
+  SymbolInstance(TPosition const & position, TNormal const & halfSize, TTexRect const & texRect);
+
+  TPosition m_position;
+  TNormal m_halfSize;
+  TTexRect m_texRect;
+
+  static dp::BindingInfo const & GetBindingInfo();
+};
+
 } // namespace gpu
@@ -5,13 +5,24 @@
 #include "base/stl_add.hpp"
 #include "base/assert.hpp"
 
+#include "std/cstring.hpp"
+
 namespace dp
 {
 
+namespace
+{
+
+VertexArrayBuffer::DrawStats g_drawStats = { 0, 0 };
+
+} // namespace
+
 VertexArrayBuffer::VertexArrayBuffer(uint32_t indexBufferSize, uint32_t dataBufferSize)
   : m_VAO(0)
   , m_dataBufferSize(dataBufferSize)
   , m_program()
+  , m_isInstanced(false)
+  , m_drawnInstanceCount(0)
 {
   m_indexBuffer.Reset(new IndexBuffer(indexBufferSize));
 }
@@ -19,6 +30,7 @@ VertexArrayBuffer::VertexArrayBuffer(uint32_t indexBufferSize, uint32_t dataBuff
 VertexArrayBuffer::~VertexArrayBuffer()
 {
   m_indexBuffer.Destroy();
+  m_instanceBuffer.Destroy();
   DeleteRange(m_staticBuffers, MasterPointerDeleter());
   DeleteRange(m_dynamicBuffers, MasterPointerDeleter());
 
@@ -52,10 +64,47 @@ void VertexArrayBuffer::Render()
 
     BindDynamicBuffers();
     m_indexBuffer->Bind();
-    GLFunctions::glDrawElements(m_indexBuffer->GetCurrentSize());
+
+    if (!IsInstanced())
+    {
+      GLFunctions::glDrawElements(m_indexBuffer->GetCurrentSize());
+
+      ++g_drawStats.m_drawCalls;
+      g_drawStats.m_indexesCount += m_indexBuffer->GetCurrentSize();
+      return;
+    }
+
+    if (m_drawnInstanceCount == 0)
+      return;
+
+    bool const hasVAO = GLExtensionsList::Instance().IsSupported(GLExtensionsList::VertexArrayObject);
+    if (!hasVAO)
+      BindInstanceBuffer(1);
+
+    GLFunctions::glDrawElementsInstanced(m_indexBuffer->GetCurrentSize(), m_drawnInstanceCount);
+
+    /// without VAO the divisors stay in the global state and break the next not instanced draws
+    if (!hasVAO)
+      BindInstanceBuffer(0);
+
+    ++g_drawStats.m_drawCalls;
+    g_drawStats.m_indexesCount += m_indexBuffer->GetCurrentSize() * m_drawnInstanceCount;
   }
 }
 
+// static
+VertexArrayBuffer::DrawStats const & VertexArrayBuffer::GetDrawStats()
+{
+  return g_drawStats;
+}
+
+// static
+void VertexArrayBuffer::ResetDrawStats()
+{
+  g_drawStats.m_drawCalls = 0;
+  g_drawStats.m_indexesCount = 0;
+}
+
 void VertexArrayBuffer::Build(RefPointer<GpuProgram> program)
 {
   ASSERT(m_VAO == 0 && m_program.IsNull(), ("No-no-no! You can't rebuild VertexArrayBuffer"));
@@ -70,6 +119,8 @@ void VertexArrayBuffer::Build(RefPointer<GpuProgram> program)
   m_VAO = GLFunctions::glGenVertexArray();
   Bind();
   BindStaticBuffers();
+  if (IsInstanced())
+    BindInstanceBuffer(1);
 }
 
 void VertexArrayBuffer::UploadData(BindingInfo const & bindingInfo, void const * data, uint16_t count)
@@ -124,7 +175,7 @@ RefPointer<DataBuffer> VertexArrayBuffer::GetOrCreateBuffer(BindingInfo const &
   if (it == buffers->end())
   {
     MasterPointer<DataBuffer> & buffer = (*buffers)[bindingInfo];
-    buffer.Reset(new DataBuffer(bindingInfo.GetElementSize(), m_dataBufferSize));
+    buffer.Reset(new DataBuffer(bindingInfo.GetElementSize(), m_dataBufferSize, isDynamic));
     return buffer.GetRefPointer();
   }
 
@@ -173,6 +224,9 @@ uint16_t VertexArrayBuffer::GetDynamicBufferOffset(BindingInfo const & bindingIn
 
 bool VertexArrayBuffer::IsFilled() const
 {
+  if (IsInstanced())
+    return GetAvailableInstanceCount() == 0;
+
   return GetAvailableIndexCount() < 3 || GetAvailableVertexCount() < 3;
 }
 
@@ -182,9 +236,72 @@ void VertexArrayBuffer::UploadIndexes(uint16_t const * data, uint16_t count)
   m_indexBuffer->UploadData(data, count);
 }
 
+void VertexArrayBuffer::UploadMesh(BindingInfo const & bindingInfo, void const * data, uint16_t count,
+                                   uint16_t const * indexes, uint16_t indexCount)
+{
+  ASSERT(m_staticBuffers.empty() && m_dynamicBuffers.empty(), ("Mesh can't be mixed with other geometry"));
+  ASSERT(!bindingInfo.IsDynamic(), ());
+
+  MasterPointer<DataBuffer> & buffer = m_staticBuffers[bindingInfo];
+  buffer.Reset(new DataBuffer(bindingInfo.GetElementSize(), count));
+  buffer->UploadData(data, count);
+
+  m_indexBuffer.Destroy();
+  m_indexBuffer.Reset(new IndexBuffer(indexCount));
+  m_indexBuffer->UploadData(indexes, indexCount);
+
+  m_isInstanced = true;
+}
+
+uint16_t VertexArrayBuffer::UploadInstances(BindingInfo const & bindingInfo, void const * data, uint16_t count)
+{
+  ASSERT(IsInstanced(), ("UploadMesh must be called before"));
+  ASSERT_LESS_OR_EQUAL(count, GetAvailableInstanceCount(), ());
+  uint16_t const elementSize = bindingInfo.GetElementSize();
+  if (m_instanceData.empty())
+  {
+    m_instanceBinding = bindingInfo;
+    m_instanceBuffer.Reset(new DataBuffer(elementSize, m_dataBufferSize / 4));
+  }
+  ASSERT_EQUAL(m_instanceBinding.GetElementSize(), elementSize, ());
+
+  uint16_t const firstInstance = GetInstanceCount();
+  m_instanceBuffer->UploadData(data, count);
+  uint8_t const * bytes = static_cast<uint8_t const *>(data);
+  m_instanceData.insert(m_instanceData.end(), bytes, bytes + count * elementSize);
+
+  m_drawnInstanceCount = GetInstanceCount();
+  m_drawnInstances.clear();
+  return firstInstance;
+}
+
+uint16_t VertexArrayBuffer::GetInstanceCount() const
+{
+  if (m_instanceData.empty())
+    return 0;
+  return m_instanceData.size() / m_instanceBinding.GetElementSize();
+}
+
+uint16_t VertexArrayBuffer::GetAvailableInstanceCount() const
+{
+  return m_dataBufferSize / 4 - GetInstanceCount();
+}
+
+bool VertexArrayBuffer::IsInstanced() const
+{
+  return m_isInstanced;
+}
+
 void VertexArrayBuffer::ApplyMutation(RefPointer<IndexBufferMutator> indexMutator,
                                       RefPointer<AttributeBufferMutator> attrMutator)
 {
+  if (IsInstanced())
+  {
+    ASSERT(attrMutator->GetMutateData().empty(), ("Dynamic attributes aren't supported for instances"));
+    ApplyInstancesMutation(indexMutator);
+    return;
+  }
+
   m_indexBuffer->UpdateData(indexMutator->GetIndexes(), indexMutator->GetIndexCount());
 
   typedef AttributeBufferMutator::TMutateData TMutateData;
@@ -205,6 +322,30 @@ void VertexArrayBuffer::ApplyMutation(RefPointer<IndexBufferMutator> indexMutato
   }
 }
 
+void VertexArrayBuffer::ApplyInstancesMutation(RefPointer<IndexBufferMutator> indexMutator)
+{
+  uint16_t const * instances = indexMutator->GetIndexes();
+  uint16_t const count = indexMutator->GetIndexCount();
+  if (count == m_drawnInstances.size() && equal(instances, instances + count, m_drawnInstances.begin()))
+    return;
+
+  m_drawnInstances.assign(instances, instances + count);
+  m_drawnInstanceCount = count;
+  if (count == 0)
+    return;
+
+  uint16_t const elementSize = m_instanceBinding.GetElementSize();
+  vector<uint8_t> visible(count * elementSize);
+  for (uint16_t i = 0; i < count; ++i)
+  {
+    ASSERT_LESS(instances[i], GetInstanceCount(), ());
+    memcpy(&visible[i * elementSize], &m_instanceData[instances[i] * elementSize], elementSize);
+  }
+
+  GPUBufferMapper mapper(m_instanceBuffer.GetRefPointer());
+  mapper.UpdateData(visible.data(), 0, count);
+}
+
 void VertexArrayBuffer::Bind() const
 {
   ASSERT(m_VAO != 0, ("You need to call Build method before bind it and render"));
@@ -239,11 +380,39 @@ void VertexArrayBuffer::BindBuffers(TBuffersMap const & buffers) const
       GLFunctions::glVertexAttributePointer(attributeLocation,
                                             decl.m_componentCount,
                                             decl.m_componentType,
-                                            false,
+                                            decl.IsNormalized(),
                                             decl.m_stride,
                                             decl.m_offset);
     }
   }
 }
 
+void VertexArrayBuffer::BindInstanceBuffer(uint32_t divisor) const
+{
+  if (m_instanceData.empty())
+    return;
+
+  m_instanceBuffer.GetRefPointer()->Bind();
+  for (uint16_t i = 0; i < m_instanceBinding.GetCount(); ++i)
+  {
+    BindingDecl const & decl = m_instanceBinding.GetBindingDecl(i);
+    int8_t attributeLocation = m_program->GetAttributeLocation(decl.m_attributeName);
+    ASSERT(attributeLocation != -1, ());
+    if (divisor == 0)
+    {
+      GLFunctions::glVertexAttributeDivisor(attributeLocation, 0);
+      continue;
+    }
+
+    GLFunctions::glEnableVertexAttribute(attributeLocation);
+    GLFunctions::glVertexAttributePointer(attributeLocation,
+                                          decl.m_componentCount,
+                                          decl.m_componentType,
+                                          decl.IsNormalized(),
+                                          decl.m_stride,
+                                          decl.m_offset);
+    GLFunctions::glVertexAttributeDivisor(attributeLocation, divisor);
+  }
+}
+
 } // namespace dp
@@ -9,6 +9,7 @@
 #include "drape/gpu_program.hpp"
 
 #include "std/map.hpp"
+#include "std/vector.hpp"
 
 namespace dp
 {
@@ -17,6 +18,12 @@ class VertexArrayBuffer
 {
   typedef map<BindingInfo, MasterPointer<DataBuffer> > TBuffersMap;
 public:
+  struct DrawStats
+  {
+    uint32_t m_drawCalls;
+    uint32_t m_indexesCount;
+  };
+
   VertexArrayBuffer(uint32_t indexBufferSize, uint32_t dataBufferSize);
   ~VertexArrayBuffer();
 
@@ -31,6 +38,11 @@ public:
   void Build(RefPointer<GpuProgram> program);
   ///@}
 
+  /// Draws of all the buffers since the last reset. Buffers are rendered on the single thread,
+  /// so call it on the rendering thread.
+  static DrawStats const & GetDrawStats();
+  static void ResetDrawStats();
+
   uint16_t GetAvailableVertexCount() const;
   uint16_t GetAvailableIndexCount() const;
   uint16_t GetStartIndexValue() const;
@@ -40,6 +52,20 @@ public:
   void UploadData(BindingInfo const & bindingInfo, void const * data, uint16_t count);
   void UploadIndexes(uint16_t const * data, uint16_t count);
 
+  ///{@
+  /// Instanced buffer draws one static mesh per instance. The mesh is uploaded once into the buffers
+  /// of the exact size, and instance attributes go to the single buffer with the divisor 1.
+  /// Overlay handles keep the index of their instance, so the hidden instances are dropped by
+  /// the compaction of the instance buffer, the index buffer isn't changed.
+  void UploadMesh(BindingInfo const & bindingInfo, void const * data, uint16_t count,
+                  uint16_t const * indexes, uint16_t indexCount);
+  /// Returns the index of the first uploaded instance.
+  uint16_t UploadInstances(BindingInfo const & bindingInfo, void const * data, uint16_t count);
+  uint16_t GetInstanceCount() const;
+  uint16_t GetAvailableInstanceCount() const;
+  bool IsInstanced() const;
+  ///@}
+
   void ApplyMutation(RefPointer<IndexBufferMutator> indexMutator,
                      RefPointer<AttributeBufferMutator> attrMutator);
 
@@ -54,6 +80,8 @@ private:
   void BindStaticBuffers() const;
   void BindDynamicBuffers() const;
   void BindBuffers(TBuffersMap const & buffers) const;
+  void BindInstanceBuffer(uint32_t divisor) const;
+  void ApplyInstancesMutation(RefPointer<IndexBufferMutator> indexMutator);
 
 private:
   int m_VAO;
@@ -64,6 +92,14 @@ private:
   uint32_t m_dataBufferSize;
 
   RefPointer<GpuProgram> m_program;
+
+  bool m_isInstanced;
+  BindingInfo m_instanceBinding;
+  MasterPointer<DataBuffer> m_instanceBuffer;
+  /// Copy of all the instances, visible ones are uploaded from it.
+  vector<uint8_t> m_instanceData;
+  uint16_t m_drawnInstanceCount;
+  vector<uint16_t> m_drawnInstances;
 };
 
 } // namespace dp
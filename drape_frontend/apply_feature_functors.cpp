@@ -17,10 +17,14 @@
 #include "drape/color.hpp"
 #include "drape/stipple_pen_resource.hpp"
 
+#include "geometry/distance.hpp"
+#include "geometry/simplification.hpp"
+
 #include "graphics/defines.hpp"
 
 #include "std/algorithm.hpp"
 #include "std/utility.hpp"
+#include "std/vector.hpp"
 
 namespace df
 {
@@ -28,6 +32,9 @@ namespace df
 namespace
 {
 
+// Line simplification doesn't change the line on the screen more than this.
+double const kSimplificationPixelTolerance = 0.5;
+
 dp::Color ToDrapeColor(uint32_t src)
 {
   return dp::Extract(src, 255 - (src >> 24));
@@ -264,14 +271,27 @@ ApplyLineFeature::ApplyLineFeature(EngineContext & context, TileKey tileKey,
 
 void ApplyLineFeature::operator() (m2::PointD const & point)
 {
-  if (m_spline.IsNull())
-    m_spline.Reset(new m2::Spline());
+  m_points.push_back(point);
+}
+
+void ApplyLineFeature::SimplifyGeometry()
+{
+  m_spline.Reset(new m2::Spline());
+  if (m_points.size() <= 2)
+  {
+    for (m2::PointD const & point : m_points)
+      m_spline->AddPoint(point);
+    return;
+  }
 
-  m_spline->AddPoint(point);
+  double const epsilon = kSimplificationPixelTolerance / m_currentScaleGtoP;
+  SimplifyDP(m_points.begin(), m_points.end(), epsilon * epsilon, m2::DistanceToLineSquare<m2::PointD>(),
+             [this](m2::PointD const & point) { m_spline->AddPoint(point); });
 }
 
 bool ApplyLineFeature::HasGeometry() const
 {
+  ASSERT(!m_spline.IsNull(), ("SimplifyGeometry must be called before"));
   return m_spline->IsValid();
 }
 
@@ -90,11 +90,16 @@ public:
                    double currentScaleGtoP);
 
   void operator() (m2::PointD const & point);
+  /// Geometry of the feature is stored for some scales only, so between them it has
+  /// more points than the tile needs. Points which are closer to the line than
+  /// the pixel tolerance of the tile are dropped, it must be called before HasGeometry.
+  void SimplifyGeometry();
   bool HasGeometry() const;
   void ProcessRule(Stylist::rule_wrapper_t const & rule);
   void Finish();
 
 private:
+  vector<m2::PointD> m_points;
   m2::SharedSpline m_spline;
   double m_currentScaleGtoP;
 };
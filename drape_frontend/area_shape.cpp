@@ -1,4 +1,5 @@
 #include "drape_frontend/area_shape.hpp"
+#include "drape_frontend/shape_serialization.hpp"
 
 #include "drape/shader_def.hpp"
 #include "drape/glstate.hpp"
@@ -44,4 +45,23 @@ void AreaShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::Tex
   batcher->InsertTriangleList(state, dp::MakeStackRefPointer(&provider));
 }
 
+void AreaShape::Serialize(Writer & writer) const
+{
+  WriteShapeValue(writer, static_cast<uint8_t>(AreaType));
+  WriteShapeValue(writer, m_vertexes);
+  WriteShapeValue(writer, m_params.m_depth);
+  WriteShapeValue(writer, m_params.m_color);
+}
+
+// static
+AreaShape * AreaShape::Deserialize(FeatureID const & /* id */, TShapeSource & src)
+{
+  vector<m2::PointF> vertexes;
+  AreaViewParams params;
+  ReadShapeValue(src, vertexes);
+  ReadShapeValue(src, params.m_depth);
+  ReadShapeValue(src, params.m_color);
+  return new AreaShape(move(vertexes), params);
+}
+
 } // namespace df
@@ -17,6 +17,9 @@ public:
   AreaShape(vector<m2::PointF> && triangleList, AreaViewParams const & params);
 
   virtual void Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const;
+  virtual void Serialize(Writer & writer) const;
+
+  static AreaShape * Deserialize(FeatureID const & id, TShapeSource & src);
 
 private:
   vector<m2::PointF> m_vertexes;
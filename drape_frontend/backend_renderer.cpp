@@ -7,16 +7,27 @@
 #include "drape_frontend/threads_commutator.hpp"
 #include "drape_frontend/message_subclasses.hpp"
 
+#include "drape/gpu_buffer_pool.hpp"
 #include "drape/oglcontextfactory.hpp"
 #include "drape/texture_manager.hpp"
 
 #include "platform/platform.hpp"
 
+#include "base/tracing.hpp"
+
 #include "std/bind.hpp"
 
 namespace df
 {
 
+namespace
+{
+
+// Storage of the free vertex and index buffers, it's about the buffers of a dozen tiles.
+uint32_t const kGPUBufferPoolBytes = 16 * 1024 * 1024;
+
+} // namespace
+
 BackendRenderer::BackendRenderer(dp::RefPointer<ThreadsCommutator> commutator,
                                  dp::RefPointer<dp::OGLContextFactory> oglcontextfactory,
                                  MapDataProvider const & model)
@@ -43,6 +54,7 @@ BackendRenderer::~BackendRenderer()
 /////////////////////////////////////////
 void BackendRenderer::AcceptMessage(dp::RefPointer<Message> message)
 {
+  TRACE_SCOPE("drape", "BackendRenderer::AcceptMessage");
   switch (message->GetType())
   {
   case Message::UpdateReadManager:
@@ -56,6 +68,7 @@ void BackendRenderer::AcceptMessage(dp::RefPointer<Message> message)
   case Message::InvalidateReadManagerRect:
     {
       InvalidateReadManagerRectMessage * msg = df::CastMessage<InvalidateReadManagerRectMessage>(message);
+      m_batchersPool->SetInvalidationGeneration(msg->GetGeneration());
       m_readManager->Invalidate(msg->GetTilesForInvalidate());
       break;
     }
@@ -105,12 +118,16 @@ void BackendRenderer::ReleaseResources()
 
   m_textures->Release();
   m_textures.Destroy();
+
+  // The frontend renderer is already stopped, so nobody returns buffers to the pool.
+  dp::GPUBufferPool::Instance().Disable();
 }
 
 BackendRenderer::Routine::Routine(BackendRenderer & renderer) : m_renderer(renderer) {}
 
 void BackendRenderer::Routine::Do()
 {
+  my::tracing::SetThreadName("BackendRenderer");
   m_renderer.m_contextFactory->getResourcesUploadContext()->makeCurrent();
   m_renderer.InitGLDependentResource();
 
@@ -128,8 +145,11 @@ void BackendRenderer::InitGLDependentResource()
   params.m_glyphMngParams.m_whitelist = "fonts_whitelist.txt";
   params.m_glyphMngParams.m_blacklist = "fonts_blacklist.txt";
   GetPlatform().GetFontNames(params.m_glyphMngParams.m_fonts);
+  params.m_glyphMngParams.m_cacheDir = GetPlatform().WritableDir();
+  params.m_glyphMngParams.m_prewarmBlocks = {"Basic_Latin", "Latin-1_Supplement", "Cyrillic"};
 
   m_textures->Init(params);
+  dp::GPUBufferPool::Instance().Enable(kGPUBufferPoolBytes);
 }
 
 void BackendRenderer::FlushGeometry(dp::TransferPointer<Message> message)
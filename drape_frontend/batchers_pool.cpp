@@ -16,11 +16,12 @@ namespace
 {
 
 void FlushGeometry(BatchersPool::TSendMessageFn const & sendMessage,
+                   uint64_t const & generation,
                    TileKey const & key,
                    dp::GLState const & state,
                    dp::TransferPointer<dp::RenderBucket> buffer)
 {
-  sendMessage(dp::MovePointer<Message>(new FlushRenderBucketMessage(key, state, buffer)));
+  sendMessage(dp::MovePointer<Message>(new FlushRenderBucketMessage(key, state, buffer, generation)));
 }
 
 } // namespace
@@ -45,7 +46,8 @@ void BatchersPool::ReserveBatcher(TileKey const & key)
   }
   Batcher * batcher = m_pool.Get();
   m_batchs.insert(make_pair(key, make_pair(batcher, 1)));
-  batcher->StartSession(bind(&FlushGeometry, m_sendMessageFn, key, _1, _2));
+  // The generation is taken on flush, as the buckets were posted by then.
+  batcher->StartSession(bind(&FlushGeometry, m_sendMessageFn, cref(m_generation), key, _1, _2));
 }
 
 dp::RefPointer<dp::Batcher> BatchersPool::GetTileBatcher(TileKey const & key)
@@ -27,6 +27,10 @@ public:
   dp::RefPointer<dp::Batcher> GetTileBatcher(TileKey const & key);
   void ReleaseBatcher(TileKey const & key);
 
+  /// Sets the generation of the last handled invalidation of the tiles, the buckets
+  /// flushed after it are stamped with it.
+  void SetInvalidationGeneration(uint64_t generation) { m_generation = generation; }
+
 private:
   typedef pair<dp::Batcher *, int> TBatcherPair;
   typedef map<TileKey, TBatcherPair> TBatcherMap;
@@ -35,6 +39,7 @@ private:
 
   ObjectPool<dp::Batcher, dp::BatcherFactory> m_pool;
   TBatcherMap m_batchs;
+  uint64_t m_generation = 0;
 };
 
 } // namespace df
@@ -1,8 +1,10 @@
 #include "drape_frontend/circle_shape.hpp"
+#include "drape_frontend/shape_serialization.hpp"
 
 #include "drape/utils/vertex_decl.hpp"
 #include "drape/batcher.hpp"
 #include "drape/attribute_provider.hpp"
+#include "drape/glextensions_list.hpp"
 #include "drape/glstate.hpp"
 #include "drape/shader_def.hpp"
 #include "drape/texture_manager.hpp"
@@ -25,6 +27,46 @@ void CircleShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::T
   textures->GetColorRegion(m_params.m_color, region);
   glsl::vec2 colorPoint(glsl::ToVec2(region.GetTexRect().Center()));
 
+  dp::OverlayHandle * overlay = new dp::SquareHandle(m_params.m_id,
+                                                     dp::Center, m_pt,
+                                                     m2::PointD(m_params.m_radius, m_params.m_radius),
+                                                     m_params.m_depth);
+
+  if (dp::GLExtensionsList::Instance().IsSupported(dp::GLExtensionsList::InstancedArrays))
+  {
+    // The unit circle is scaled by the radius in the shader.
+    buffer_vector<gpu::InstanceMeshVertex, TriangleCount + 2> mesh;
+    mesh.push_back(gpu::InstanceMeshVertex(glsl::vec2(0.0f, 0.0f)));
+    buffer_vector<uint16_t, 3 * TriangleCount> indexes;
+    for (int i = 0; i < TriangleCount + 1; ++i)
+    {
+      mesh.push_back(gpu::InstanceMeshVertex(glsl::ToVec2(m2::Rotate(m2::PointD(0.0, 1.0), i * etalonSector))));
+      if (i < TriangleCount)
+      {
+        indexes.push_back(0);
+        indexes.push_back(i + 1);
+        indexes.push_back(i + 2);
+      }
+    }
+
+    dp::GLState state(gpu::INSTANCED_CIRCLE_PROGRAM, dp::GLState::OverlayLayer);
+    state.SetBlending(dp::Blending(true));
+    state.SetColorTexture(region.GetTexture());
+
+    gpu::SymbolInstance instance(glsl::vec3(glsl::ToVec2(m_pt), m_params.m_depth),
+                                 glsl::vec2(m_params.m_radius, m_params.m_radius),
+                                 glsl::vec4(colorPoint, colorPoint));
+
+    dp::AttributeProvider meshProvider(1, mesh.size());
+    meshProvider.InitStream(0, gpu::InstanceMeshVertex::GetBindingInfo(), dp::MakeStackRefPointer<void>(mesh.data()));
+    dp::AttributeProvider provider(1, 1);
+    provider.InitStream(0, gpu::SymbolInstance::GetBindingInfo(), dp::MakeStackRefPointer<void>(&instance));
+
+    batcher->InsertInstance(state, dp::MakeStackRefPointer(&meshProvider), indexes.data(), indexes.size(),
+                            dp::MakeStackRefPointer(&provider), dp::MovePointer(overlay));
+    return;
+  }
+
   buffer_vector<gpu::SolidTexturingVertex, 22> vertexes;
   vertexes.push_back(gpu::SolidTexturingVertex
   {
@@ -50,14 +92,30 @@ void CircleShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::T
   state.SetBlending(dp::Blending(true));
   state.SetColorTexture(region.GetTexture());
 
-  dp::OverlayHandle * overlay = new dp::SquareHandle(m_params.m_id,
-                                                     dp::Center, m_pt,
-                                                     m2::PointD(m_params.m_radius, m_params.m_radius),
-                                                     m_params.m_depth);
-
   dp::AttributeProvider provider(1, TriangleCount + 2);
   provider.InitStream(0, gpu::SolidTexturingVertex::GetBindingInfo(), dp::MakeStackRefPointer<void>(vertexes.data()));
   batcher->InsertTriangleFan(state, dp::MakeStackRefPointer(&provider), dp::MovePointer(overlay));
 }
 
+void CircleShape::Serialize(Writer & writer) const
+{
+  WriteShapeValue(writer, static_cast<uint8_t>(CircleType));
+  WriteShapeValue(writer, m_pt);
+  WriteShapeValue(writer, m_params.m_depth);
+  WriteShapeValue(writer, m_params.m_color);
+  WriteShapeValue(writer, m_params.m_radius);
+}
+
+// static
+CircleShape * CircleShape::Deserialize(FeatureID const & id, TShapeSource & src)
+{
+  m2::PointF pt;
+  CircleViewParams params(id);
+  ReadShapeValue(src, pt);
+  ReadShapeValue(src, params.m_depth);
+  ReadShapeValue(src, params.m_color);
+  ReadShapeValue(src, params.m_radius);
+  return new CircleShape(pt, params);
+}
+
 } // namespace df
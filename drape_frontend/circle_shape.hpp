@@ -12,6 +12,9 @@ public:
   CircleShape(m2::PointF const & mercatorPt, CircleViewParams const & params);
 
   virtual void Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const;
+  virtual void Serialize(Writer & writer) const;
+
+  static CircleShape * Deserialize(FeatureID const & id, TShapeSource & src);
 
 private:
   m2::PointF m_pt;
@@ -52,4 +52,9 @@ void DrapeEngine::UpdateCoverage(ScreenBase const & screen)
                                   dp::MovePointer<Message>(new UpdateModelViewMessage(screen)));
 }
 
+void DrapeEngine::GetFrameStats(vector<FrameInfo> & frames) const
+{
+  m_frontend->GetFrameStats(frames);
+}
+
 } // namespace df
@@ -27,6 +27,9 @@ public:
   void Resize(int w, int h);
   void UpdateCoverage(ScreenBase const & screen);
 
+  /// Timings of the last rendered frames from the oldest one.
+  void GetFrameStats(vector<FrameInfo> & frames) const;
+
 private:
   dp::MasterPointer<FrontendRenderer> m_frontend;
   dp::MasterPointer<BackendRenderer>  m_backend;
@@ -13,6 +13,7 @@ SOURCES += \
     engine_context.cpp \
     memory_feature_index.cpp \
     message_queue.cpp \
+    frame_stats.cpp \
     message.cpp \
     threads_commutator.cpp \
     message_acceptor.cpp \
@@ -29,6 +30,9 @@ SOURCES += \
     rule_drawer.cpp \
     viewport.cpp \
     tile_key.cpp \
+    tile_scheduler.cpp \
+    tile_cache.cpp \
+    shape_serialization.cpp \
     apply_feature_functors.cpp \
     visual_params.cpp \
     poi_symbol_shape.cpp \
@@ -39,12 +43,14 @@ SOURCES += \
     path_symbol_shape.cpp \
     text_layout.cpp \
     map_data_provider.cpp \
+    tile_invalidations.cpp \
 
 HEADERS += \
     engine_context.hpp \
     memory_feature_index.hpp \
     tile_info.hpp \
     message_queue.hpp \
+    frame_stats.hpp \
     message.hpp \
     threads_commutator.hpp \
     message_acceptor.hpp \
@@ -63,6 +69,9 @@ HEADERS += \
     rule_drawer.hpp \
     viewport.hpp \
     tile_key.hpp \
+    tile_scheduler.hpp \
+    tile_cache.hpp \
+    shape_serialization.hpp \
     apply_feature_functors.hpp \
     visual_params.hpp \
     poi_symbol_shape.hpp \
@@ -75,3 +84,4 @@ HEADERS += \
     text_layout.hpp \
     intrusive_vector.hpp \
     map_data_provider.hpp \
+    tile_invalidations.hpp \
@@ -4,7 +4,7 @@ CONFIG += console warn_on
 CONFIG -= app_bundle
 TEMPLATE = app
 
-DEPENDENCIES = drape_frontend drape base fribidi
+DEPENDENCIES = drape_frontend drape indexer geometry platform coding base fribidi
 ROOT_DIR = ../..
 include($$ROOT_DIR/common.pri)
 
@@ -13,3 +13,8 @@ SOURCES += \
     memory_feature_index_tests.cpp \
     fribidi_tests.cpp \
     object_pool_tests.cpp \
+    tile_scheduler_tests.cpp \
+    tile_cache_tests.cpp \
+    message_queue_tests.cpp \
+    frame_stats_tests.cpp \
+    tile_invalidations_tests.cpp
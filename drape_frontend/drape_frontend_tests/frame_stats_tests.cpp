@@ -0,0 +1,65 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/frame_stats.hpp"
+
+#include "std/vector.hpp"
+
+namespace
+{
+df::FrameInfo MakeFrame(uint64_t index)
+{
+  df::FrameInfo frame;
+  frame.m_index = index;
+  frame.m_frameTime = index * 0.001;
+  frame.m_drawCalls = static_cast<uint32_t>(index);
+  return frame;
+}
+
+vector<uint64_t> GetIndexes(df::FrameStats const & stats)
+{
+  vector<df::FrameInfo> frames;
+  stats.GetFrames(frames);
+  vector<uint64_t> indexes;
+  for (df::FrameInfo const & frame : frames)
+    indexes.push_back(frame.m_index);
+  return indexes;
+}
+}  // namespace
+
+UNIT_TEST(FrameStats_RingBuffer)
+{
+  df::FrameStats stats(3);
+  TEST(GetIndexes(stats).empty(), ());
+
+  stats.PushFrame(MakeFrame(1));
+  stats.PushFrame(MakeFrame(2));
+  TEST_EQUAL(GetIndexes(stats), vector<uint64_t>({1, 2}), ());
+
+  stats.PushFrame(MakeFrame(3));
+  stats.PushFrame(MakeFrame(4));
+  stats.PushFrame(MakeFrame(5));
+  TEST_EQUAL(GetIndexes(stats), vector<uint64_t>({3, 4, 5}), ());
+
+  vector<df::FrameInfo> frames;
+  stats.GetFrames(frames);
+  TEST_EQUAL(frames[1].m_drawCalls, 4, ());
+  TEST_LESS(frames[1].m_gpuTime, 0.0, ());
+}
+
+UNIT_TEST(FrameStats_GpuTime)
+{
+  df::FrameStats stats(2);
+  stats.PushFrame(MakeFrame(1));
+  stats.PushFrame(MakeFrame(2));
+  stats.PushFrame(MakeFrame(3));
+
+  // The first frame has left the buffer.
+  stats.SetGpuTime(1, 0.5);
+  stats.SetGpuTime(3, 0.25);
+
+  vector<df::FrameInfo> frames;
+  stats.GetFrames(frames);
+  TEST_EQUAL(frames.size(), 2, ());
+  TEST_LESS(frames[0].m_gpuTime, 0.0, ());
+  TEST_EQUAL(frames[1].m_gpuTime, 0.25, ());
+}
@@ -0,0 +1,123 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/message_queue.hpp"
+
+#include "std/thread.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+class TestMessage : public df::Message
+{
+public:
+  TestMessage(int producer, int number, Priority priority)
+    : m_producer(producer), m_number(number)
+  {
+    SetType(UpdateModelView);
+    SetPriority(priority);
+  }
+
+  int m_producer;
+  int m_number;
+};
+
+void Push(df::MessageQueue & queue, int producer, int number,
+          df::Message::Priority priority = df::Message::NormalPriority)
+{
+  queue.PushMessage(dp::MovePointer<df::Message>(new TestMessage(producer, number, priority)));
+}
+
+// Pops the message and returns its number, -1 when the queue is empty.
+int Pop(df::MessageQueue & queue, int & producer)
+{
+  dp::TransferPointer<df::Message> transfer = queue.PopMessage(0);
+  dp::MasterPointer<df::Message> message(transfer);
+  if (message.IsNull())
+    return -1;
+  TestMessage const * msg = static_cast<TestMessage const *>(message.GetRaw());
+  producer = msg->m_producer;
+  int const number = msg->m_number;
+  message.Destroy();
+  return number;
+}
+}  // namespace
+
+UNIT_TEST(MessageQueue_Priorities)
+{
+  df::MessageQueue queue;
+  Push(queue, 0, 1, df::Message::LowPriority);
+  Push(queue, 0, 2, df::Message::NormalPriority);
+  Push(queue, 0, 3, df::Message::LowPriority);
+  Push(queue, 0, 4, df::Message::HighPriority);
+  Push(queue, 0, 5, df::Message::NormalPriority);
+
+  TEST_EQUAL(queue.GetStats().m_depth, 5, ());
+  TEST_EQUAL(queue.GetStats().m_maxDepth, 5, ());
+
+  int producer;
+  vector<int> numbers;
+  for (int number = Pop(queue, producer); number != -1; number = Pop(queue, producer))
+    numbers.push_back(number);
+  TEST_EQUAL(numbers, vector<int>({4, 2, 5, 1, 3}), ());
+
+  df::MessageQueue::Stats const stats = queue.GetStats();
+  TEST_EQUAL(stats.m_depth, 0, ());
+  TEST_EQUAL(stats.m_poppedCount, 5, ());
+  TEST_GREATER_OR_EQUAL(stats.m_maxLatency, stats.m_averageLatency, ());
+
+  queue.ResetStats();
+  TEST_EQUAL(queue.GetStats().m_poppedCount, 0, ());
+  TEST_EQUAL(queue.GetStats().m_maxDepth, 0, ());
+}
+
+UNIT_TEST(MessageQueue_ManyProducers)
+{
+  int const kProducers = 4;
+  int const kMessages = 20000;
+
+  df::MessageQueue queue;
+  vector<thread> producers;
+  for (int i = 0; i < kProducers; ++i)
+  {
+    producers.emplace_back([&queue, i]()
+    {
+      for (int number = 0; number < kMessages; ++number)
+        Push(queue, i, number);
+    });
+  }
+
+  // Messages of each producer keep their order.
+  vector<int> lastNumbers(kProducers, -1);
+  int received = 0;
+  while (received < kProducers * kMessages)
+  {
+    dp::TransferPointer<df::Message> transfer = queue.PopMessage(1000);
+    dp::MasterPointer<df::Message> message(transfer);
+    TEST(!message.IsNull(), (received));
+    TestMessage const * msg = static_cast<TestMessage const *>(message.GetRaw());
+    TEST_EQUAL(msg->m_number, lastNumbers[msg->m_producer] + 1, ());
+    lastNumbers[msg->m_producer] = msg->m_number;
+    message.Destroy();
+    ++received;
+  }
+
+  for (thread & producer : producers)
+    producer.join();
+
+  int producer;
+  TEST_EQUAL(Pop(queue, producer), -1, ());
+}
+
+UNIT_TEST(MessageQueue_ClearQuery)
+{
+  df::MessageQueue queue;
+  for (int number = 0; number < 10; ++number)
+    Push(queue, 0, number, number % 2 == 0 ? df::Message::HighPriority : df::Message::LowPriority);
+  queue.ClearQuery();
+
+  int producer;
+  TEST_EQUAL(Pop(queue, producer), -1, ());
+  Push(queue, 1, 7);
+  TEST_EQUAL(Pop(queue, producer), 7, ());
+  TEST_EQUAL(producer, 1, ());
+}
@@ -0,0 +1,152 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/line_shape.hpp"
+#include "drape_frontend/poi_symbol_shape.hpp"
+#include "drape_frontend/text_shape.hpp"
+#include "drape_frontend/tile_cache.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/internal/file_data.hpp"
+#include "coding/writer.hpp"
+
+#include "std/shared_ptr.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+string Serialize(df::MapShape const & shape)
+{
+  string data;
+  MemWriter<string> writer(data);
+  shape.Serialize(writer);
+  return data;
+}
+
+string MakeShapes(FeatureID const & id)
+{
+  df::LineViewParams lineParams;
+  lineParams.m_depth = 1.0f;
+  lineParams.m_color = dp::Color(10, 20, 30, 40);
+  lineParams.m_width = 3.0f;
+  lineParams.m_cap = dp::RoundCap;
+  lineParams.m_join = dp::BevelJoin;
+  lineParams.m_pattern.push_back(4);
+  lineParams.m_pattern.push_back(2);
+  lineParams.m_baseGtoPScale = 0.5f;
+  vector<m2::PointD> const path = {m2::PointD(0.0, 0.0), m2::PointD(1.0, 2.0), m2::PointD(3.0, 1.0)};
+
+  df::PoiSymbolViewParams poiParams(id);
+  poiParams.m_depth = 2.0f;
+  poiParams.m_symbolName = "cafe";
+
+  df::TextViewParams textParams;
+  textParams.m_featureID = id;
+  textParams.m_depth = 3.0f;
+  textParams.m_primaryText = "Main street";
+  textParams.m_primaryTextFont = df::FontDecl(dp::Color::Black(), 12.0f, dp::Color::White());
+  textParams.m_secondaryText = "12";
+  textParams.m_anchor = dp::Top;
+
+  return Serialize(df::LineShape(m2::SharedSpline(path), lineParams)) +
+         Serialize(df::PoiSymbolShape(m2::PointF(5.0f, 6.0f), poiParams)) +
+         Serialize(df::TextShape(m2::PointF(7.0f, 8.0f), textParams));
+}
+
+string ReadShapes(df::TileCache::Tile const & tile, FeatureID const & id, bool & found)
+{
+  string shapes;
+  found = tile.ForEachShape(id, [&shapes, &id](df::MapShape * shape)
+  {
+    shapes += Serialize(*shape);
+    delete shape;
+  });
+  return shapes;
+}
+}  // namespace
+
+UNIT_TEST(TileCache_SaveLoad)
+{
+  MwmSet::MwmId const mwmId(make_shared<MwmInfo>());
+  FeatureID const drawnId(mwmId, 5);
+  FeatureID const emptyId(mwmId, 1);
+  FeatureID const unknownId(mwmId, 7);
+  df::TileKey const key(-3, 4, 12);
+
+  df::TileCache const cache(GetPlatform().WritableDir(), "style 1");
+  string const filePath = GetPlatform().WritablePathForFile("12_-3_4.tile");
+
+  df::TileCache::Tile tile;
+  TEST(!cache.Load(key, tile), ());
+  TEST(tile.IsEmpty(), ());
+
+  string const shapes = MakeShapes(drawnId);
+  tile.SetShapes(drawnId, string(shapes));
+  tile.SetShapes(emptyId, string());
+  cache.Save(key, tile);
+
+  df::TileCache::Tile loaded;
+  TEST(cache.Load(key, loaded), ());
+
+  bool found = false;
+  TEST_EQUAL(ReadShapes(loaded, drawnId, found), shapes, ());
+  TEST(found, ());
+  TEST_EQUAL(ReadShapes(loaded, emptyId, found), string(), ());
+  TEST(found, ());
+  ReadShapes(loaded, unknownId, found);
+  TEST(!found, ());
+
+  // Files of the other styles are ignored.
+  df::TileCache const otherCache(GetPlatform().WritableDir(), "style 2");
+  TEST(!otherCache.Load(key, loaded), ());
+  TEST(loaded.IsEmpty(), ());
+
+  TEST(my::DeleteFileX(filePath), ());
+}
+
+UNIT_TEST(FeatureShapesCache_Lru)
+{
+  MwmSet::MwmId const mwmId(make_shared<MwmInfo>());
+  FeatureID const id1(mwmId, 1);
+  FeatureID const id2(mwmId, 2);
+  FeatureID const id3(mwmId, 3);
+
+  df::FeatureShapesCache cache(10);
+  cache.SetShapes(id1, 12, "aaaa");
+  cache.SetShapes(id2, 12, "bbbb");
+  cache.SetShapes(id1, 13, string());
+  TEST_EQUAL(cache.GetSize(), 8, ());
+
+  string shapes;
+  TEST(cache.GetShapes(id1, 12, shapes), ());
+  TEST_EQUAL(shapes, "aaaa", ());
+  // Features of other zoom levels are other entries.
+  TEST(cache.GetShapes(id1, 13, shapes), ());
+  TEST_EQUAL(shapes, string(), ());
+  TEST(!cache.GetShapes(id2, 13, shapes), ());
+
+  // id2 is the least recently used one.
+  cache.SetShapes(id3, 12, "cccc");
+  TEST_EQUAL(cache.GetSize(), 8, ());
+  TEST(!cache.GetShapes(id2, 12, shapes), ());
+  TEST(cache.GetShapes(id1, 12, shapes), ());
+  TEST(cache.GetShapes(id3, 12, shapes), ());
+  TEST_EQUAL(shapes, "cccc", ());
+
+  // Shapes are replaced.
+  cache.SetShapes(id3, 12, "dd");
+  TEST_EQUAL(cache.GetSize(), 6, ());
+  TEST(cache.GetShapes(id3, 12, shapes), ());
+  TEST_EQUAL(shapes, "dd", ());
+
+  // Too large shapes aren't cached.
+  cache.SetShapes(id2, 12, "eeeeeeeeeee");
+  TEST(!cache.GetShapes(id2, 12, shapes), ());
+  TEST_EQUAL(cache.GetSize(), 6, ());
+
+  cache.Clear();
+  TEST_EQUAL(cache.GetSize(), 0, ());
+  TEST(!cache.GetShapes(id1, 12, shapes), ());
+}
@@ -0,0 +1,110 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/message_queue.hpp"
+#include "drape_frontend/message_subclasses.hpp"
+#include "drape_frontend/tile_invalidations.hpp"
+
+#include "std/vector.hpp"
+
+namespace
+{
+void PushFlush(df::MessageQueue & queue, df::TileKey const & key, uint64_t generation)
+{
+  dp::GLState const state(0, dp::GLState::GeometryLayer);
+  queue.PushMessage(dp::MovePointer<df::Message>(new df::FlushRenderBucketMessage(
+      key, state, dp::MovePointer<dp::RenderBucket>(nullptr), generation)));
+}
+
+// Handles the messages as the frontend does and returns the generations of the accepted buckets.
+vector<uint64_t> HandleMessages(df::MessageQueue & queue, df::TileInvalidations & invalidations,
+                                set<df::TileKey> const & invalidatedTiles)
+{
+  vector<uint64_t> accepted;
+  while (true)
+  {
+    dp::TransferPointer<df::Message> transfer = queue.PopMessage(0);
+    dp::MasterPointer<df::Message> message(transfer);
+    if (message.IsNull())
+      break;
+
+    if (message->GetType() == df::Message::InvalidateRect)
+    {
+      invalidations.Invalidate(invalidatedTiles);
+    }
+    else
+    {
+      df::FlushRenderBucketMessage const * msg =
+          static_cast<df::FlushRenderBucketMessage const *>(message.GetRaw());
+      if (invalidations.AcceptBucket(msg->GetKey(), msg->GetGeneration()))
+        accepted.push_back(msg->GetGeneration());
+    }
+    message.Destroy();
+  }
+  return accepted;
+}
+}  // namespace
+
+UNIT_TEST(TileInvalidations_Smoke)
+{
+  df::TileKey const key(1, 2, 3);
+  df::TileKey const other(2, 2, 3);
+
+  df::TileInvalidations invalidations;
+  TEST(invalidations.AcceptBucket(key, 0), ());
+
+  uint64_t const generation = invalidations.Invalidate({key});
+  TEST_GREATER(generation, 0, ());
+  TEST_EQUAL(invalidations.GetPendingCount(), 1, ());
+  TEST(!invalidations.AcceptBucket(key, generation - 1), ());
+  TEST(invalidations.AcceptBucket(other, generation - 1), ());
+
+  TEST_GREATER(invalidations.Invalidate({other}), generation, ());
+  TEST_EQUAL(invalidations.GetPendingCount(), 2, ());
+  TEST(invalidations.AcceptBucket(key, generation), ());
+  TEST(!invalidations.AcceptBucket(other, generation), ());
+}
+
+UNIT_TEST(TileInvalidations_StaleBucketAfterInvalidation)
+{
+  df::TileKey const key(1, 2, 3);
+  df::TileKey const other(2, 2, 3);
+  df::TileInvalidations invalidations;
+  df::MessageQueue queue;
+
+  // The buckets are flushed before the invalidation reaches the backend, the invalidation of
+  // high priority is handled first.
+  PushFlush(queue, key, 0 /* generation */);
+  PushFlush(queue, other, 0 /* generation */);
+  queue.PushMessage(dp::MovePointer<df::Message>(new df::InvalidateRectMessage(m2::RectD())));
+
+  // The stale bucket of the invalidated tile is dropped, the other tile keeps its bucket.
+  TEST_EQUAL(HandleMessages(queue, invalidations, {key}), vector<uint64_t>({0}), ());
+
+  TEST_EQUAL(invalidations.GetPendingCount(), 1, ());
+
+  // The bucket read after the backend has handled the invalidation is accepted.
+  PushFlush(queue, key, 1 /* generation */);
+  TEST_EQUAL(HandleMessages(queue, invalidations, {key}), vector<uint64_t>({1}), ());
+  TEST_EQUAL(invalidations.GetPendingCount(), 0, ());
+}
+
+UNIT_TEST(TileInvalidations_Pruning)
+{
+  df::TileInvalidations invalidations;
+
+  // Panning over the tiles which are invalidated but never read again, e.g. they left
+  // the coverage or they are empty.
+  uint64_t generation = 0;
+  for (int x = 0; x < 100; ++x)
+    generation = invalidations.Invalidate({df::TileKey(x, 0, 10)});
+  TEST_EQUAL(invalidations.GetPendingCount(), 100, ());
+
+  // A stale bucket doesn't forget the invalidations which are newer than it.
+  TEST(!invalidations.AcceptBucket(df::TileKey(99, 0, 10), generation - 1), ());
+  TEST_EQUAL(invalidations.GetPendingCount(), 1, ());
+
+  // Any bucket flushed after the backend has handled the invalidations forgets all of them.
+  TEST(invalidations.AcceptBucket(df::TileKey(0, 1, 10), generation), ());
+  TEST_EQUAL(invalidations.GetPendingCount(), 0, ());
+  TEST(invalidations.AcceptBucket(df::TileKey(99, 0, 10), generation), ());
+}
@@ -0,0 +1,90 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/tile_scheduler.hpp"
+
+#include "geometry/any_rect2d.hpp"
+#include "geometry/screenbase.hpp"
+
+#include "base/math.hpp"
+
+#include "std/set.hpp"
+
+namespace
+{
+int const kZoomLevel = 10;
+
+// Screen which shows the tile (x, y) and its neighbours.
+ScreenBase MakeScreen(double x, double y)
+{
+  m2::RectD const rect = df::TileKey(0, 0, kZoomLevel).GetGlobalRect();
+  m2::PointD const center((x + 0.5) * rect.SizeX(), (y + 0.5) * rect.SizeY());
+  return ScreenBase(m2::RectI(0, 0, 256, 256),
+                    m2::AnyRectD(m2::RectD(center.x - rect.SizeX(), center.y - rect.SizeY(),
+                                           center.x + rect.SizeX(), center.y + rect.SizeY())));
+}
+}  // namespace
+
+UNIT_TEST(TileScheduler_PriorityWithoutMotion)
+{
+  df::TileScheduler scheduler;
+  scheduler.UpdateScreen(MakeScreen(0, 0), 0.0);
+
+  TEST_EQUAL(scheduler.GetVelocity(), m2::PointD(0.0, 0.0), ());
+  double const center = scheduler.GetPriority(df::TileKey(0, 0, kZoomLevel));
+  double const left = scheduler.GetPriority(df::TileKey(-1, 0, kZoomLevel));
+  double const right = scheduler.GetPriority(df::TileKey(1, 0, kZoomLevel));
+  TEST_LESS(center, left, ());
+  TEST(my::AlmostEqualAbs(left, right, 1.0E-9), (left, right));
+  TEST(my::AlmostEqualAbs(left, 1.0, 1.0E-9), (left));
+
+  set<df::TileKey> tiles = {df::TileKey(0, 0, kZoomLevel)};
+  set<df::TileKey> prefetch;
+  scheduler.GetPrefetchTiles(tiles, prefetch);
+  TEST(prefetch.empty(), ());
+}
+
+UNIT_TEST(TileScheduler_MotionAhead)
+{
+  df::TileScheduler scheduler;
+  // The screen moves to the right by a tile per 0.1 second.
+  for (int i = 0; i < 5; ++i)
+    scheduler.UpdateScreen(MakeScreen(i, 0), 0.1 * i);
+
+  TEST_GREATER(scheduler.GetVelocity().x, 0.0, ());
+  TEST(my::AlmostEqualAbs(scheduler.GetVelocity().y, 0.0, 1.0E-9), ());
+
+  // Tiles ahead of the motion are more urgent than the trailing ones.
+  double const ahead = scheduler.GetPriority(df::TileKey(5, 0, kZoomLevel));
+  double const behind = scheduler.GetPriority(df::TileKey(3, 0, kZoomLevel));
+  TEST_LESS(ahead, behind, ());
+
+  set<df::TileKey> tiles;
+  for (int x = 3; x <= 5; ++x)
+  {
+    for (int y = -1; y <= 1; ++y)
+      tiles.insert(df::TileKey(x, y, kZoomLevel));
+  }
+  set<df::TileKey> prefetch;
+  scheduler.GetPrefetchTiles(tiles, prefetch);
+  set<df::TileKey> const expected = {df::TileKey(6, -1, kZoomLevel), df::TileKey(6, 0, kZoomLevel),
+                                     df::TileKey(6, 1, kZoomLevel)};
+  TEST(prefetch == expected, ());
+}
+
+UNIT_TEST(TileScheduler_ResetMotion)
+{
+  df::TileScheduler scheduler;
+  scheduler.UpdateScreen(MakeScreen(0, 0), 0.0);
+  scheduler.UpdateScreen(MakeScreen(0, 1), 0.1);
+  TEST_GREATER(scheduler.GetVelocity().y, 0.0, ());
+
+  // The motion is forgotten after a long pause.
+  scheduler.UpdateScreen(MakeScreen(0, 2), 10.0);
+  TEST_EQUAL(scheduler.GetVelocity(), m2::PointD(0.0, 0.0), ());
+
+  scheduler.UpdateScreen(MakeScreen(0, 3), 10.1);
+  TEST_GREATER(scheduler.GetVelocity().y, 0.0, ());
+  scheduler.ResetMotion();
+  TEST_EQUAL(scheduler.GetVelocity(), m2::PointD(0.0, 0.0), ());
+  TEST_EQUAL(scheduler.GetPredictedCenter(), MakeScreen(0, 3).ClipRect().Center(), ());
+}
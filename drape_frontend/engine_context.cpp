@@ -26,7 +26,9 @@ void EngineContext::BeginReadTile(TileKey const & key)
 
 void EngineContext::InsertShape(TileKey const & key, dp::TransferPointer<MapShape> shape)
 {
-  PostMessage(new MapShapeReadedMessage(key, shape));
+  dp::MasterPointer<MapShape> master(shape);
+  master->Prepare();
+  PostMessage(new MapShapeReadedMessage(key, master.Move()));
 }
 
 void EngineContext::EndReadTile(TileKey const & key)
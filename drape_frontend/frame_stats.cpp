@@ -0,0 +1,157 @@
+#include "drape_frontend/frame_stats.hpp"
+
+#include "drape/glextensions_list.hpp"
+#include "drape/glfunctions.hpp"
+
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+
+namespace df
+{
+
+namespace
+{
+
+// Results are ready in a couple of frames usually.
+size_t const kQueriesCount = 4;
+
+} // namespace
+
+FrameInfo::FrameInfo()
+  : m_index(0)
+  , m_frameTime(0.0)
+  , m_resolveTilesTime(0.0)
+  , m_overlayTime(0.0)
+  , m_renderGroupsTime(0.0)
+  , m_flushTime(0.0)
+  , m_gpuTime(-1.0)
+  , m_drawCalls(0)
+  , m_verticesCount(0)
+  , m_culledBuckets(0)
+{
+}
+
+FrameStats::FrameStats(size_t capacity)
+  : m_capacity(capacity)
+  , m_next(0)
+{
+  ASSERT_GREATER(capacity, 0, ());
+  m_frames.reserve(capacity);
+}
+
+void FrameStats::PushFrame(FrameInfo const & frame)
+{
+  threads::MutexGuard guard(m_mutex);
+  UNUSED_VALUE(guard);
+
+  if (m_frames.size() < m_capacity)
+  {
+    m_frames.push_back(frame);
+    return;
+  }
+
+  m_frames[m_next] = frame;
+  m_next = (m_next + 1) % m_capacity;
+}
+
+void FrameStats::SetGpuTime(uint64_t frameIndex, double gpuTime)
+{
+  threads::MutexGuard guard(m_mutex);
+  UNUSED_VALUE(guard);
+
+  for (FrameInfo & frame : m_frames)
+  {
+    if (frame.m_index == frameIndex)
+    {
+      frame.m_gpuTime = gpuTime;
+      return;
+    }
+  }
+}
+
+void FrameStats::GetFrames(vector<FrameInfo> & frames) const
+{
+  threads::MutexGuard guard(m_mutex);
+  UNUSED_VALUE(guard);
+
+  frames.clear();
+  frames.reserve(m_frames.size());
+  frames.insert(frames.end(), m_frames.begin() + m_next, m_frames.end());
+  frames.insert(frames.end(), m_frames.begin(), m_frames.begin() + m_next);
+}
+
+GpuFrameTimer::GpuFrameTimer()
+  : m_current(0)
+  , m_isStarted(false)
+{
+}
+
+GpuFrameTimer::~GpuFrameTimer()
+{
+  ASSERT(m_queries.empty(), ("Release must be called on the rendering thread"));
+}
+
+void GpuFrameTimer::Init()
+{
+  ASSERT(m_queries.empty(), ());
+  if (!dp::GLExtensionsList::Instance().IsSupported(dp::GLExtensionsList::TimerQuery))
+    return;
+
+  m_queries.resize(kQueriesCount);
+  for (Query & query : m_queries)
+  {
+    query.m_id = GLFunctions::glGenQuery();
+    query.m_frameIndex = 0;
+    query.m_isPending = false;
+  }
+  m_current = 0;
+}
+
+void GpuFrameTimer::Release()
+{
+  ASSERT(!m_isStarted, ());
+  for (Query const & query : m_queries)
+    GLFunctions::glDeleteQuery(query.m_id);
+  m_queries.clear();
+}
+
+void GpuFrameTimer::BeginFrame(uint64_t frameIndex)
+{
+  ASSERT(!m_isStarted, ());
+  if (m_queries.empty())
+    return;
+
+  // All the queries wait for results, this frame isn't measured.
+  Query & query = m_queries[m_current];
+  if (query.m_isPending)
+    return;
+
+  query.m_frameIndex = frameIndex;
+  GLFunctions::glBeginTimeElapsedQuery(query.m_id);
+  m_isStarted = true;
+}
+
+void GpuFrameTimer::EndFrame()
+{
+  if (!m_isStarted)
+    return;
+
+  GLFunctions::glEndTimeElapsedQuery();
+  m_queries[m_current].m_isPending = true;
+  m_current = (m_current + 1) % m_queries.size();
+  m_isStarted = false;
+}
+
+void GpuFrameTimer::CollectResults(FrameStats & stats)
+{
+  for (Query & query : m_queries)
+  {
+    if (!query.m_isPending || !GLFunctions::glIsQueryResultAvailable(query.m_id))
+      continue;
+
+    stats.SetGpuTime(query.m_frameIndex, GLFunctions::glGetQueryResult(query.m_id) * 1.0E-9);
+    query.m_isPending = false;
+  }
+}
+
+} // namespace df
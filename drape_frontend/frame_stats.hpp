@@ -0,0 +1,84 @@
+#pragma once
+
+#include "base/mutex.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/noncopyable.hpp"
+#include "std/vector.hpp"
+
+namespace df
+{
+
+/// Timings of a rendered frame in seconds.
+struct FrameInfo
+{
+  FrameInfo();
+
+  uint64_t m_index;
+  /// From the frame start to the presenting, it includes messages processing.
+  double m_frameTime;
+  double m_resolveTilesTime;
+  double m_overlayTime;
+  double m_renderGroupsTime;
+  /// Building of the flushed buckets.
+  double m_flushTime;
+  /// Rendering time on GPU, it's negative when it isn't known (yet).
+  double m_gpuTime;
+  uint32_t m_drawCalls;
+  /// Drawn vertices, each index is counted.
+  uint32_t m_verticesCount;
+  /// Buckets which are out of the screen and aren't drawn.
+  uint32_t m_culledBuckets;
+};
+
+/// Ring buffer of the last frames. It's filled by the rendering thread and read by any one.
+class FrameStats : private noncopyable
+{
+public:
+  explicit FrameStats(size_t capacity);
+
+  void PushFrame(FrameInfo const & frame);
+  /// GPU time comes some frames later, it's dropped when the frame has left the buffer.
+  void SetGpuTime(uint64_t frameIndex, double gpuTime);
+  /// Frames from the oldest one.
+  void GetFrames(vector<FrameInfo> & frames) const;
+
+private:
+  mutable threads::Mutex m_mutex;
+  vector<FrameInfo> m_frames;
+  size_t m_capacity;
+  // Where the next frame is pushed when the buffer is full.
+  size_t m_next;
+};
+
+/// GPU timings of the frames by GL timer queries. Results are read when they are ready,
+/// so the frame isn't stalled. It must be used on the rendering thread only.
+class GpuFrameTimer : private noncopyable
+{
+public:
+  GpuFrameTimer();
+  ~GpuFrameTimer();
+
+  /// Queries are created when GLExtensionsList::TimerQuery is supported.
+  void Init();
+  void Release();
+
+  void BeginFrame(uint64_t frameIndex);
+  void EndFrame();
+  /// Reports ready results.
+  void CollectResults(FrameStats & stats);
+
+private:
+  struct Query
+  {
+    uint32_t m_id;
+    uint64_t m_frameIndex;
+    bool m_isPending;
+  };
+
+  vector<Query> m_queries;
+  size_t m_current;
+  bool m_isStarted;
+};
+
+} // namespace df
@@ -2,6 +2,8 @@
 
 #include "base/string_utils.hpp"
 
+#include "std/algorithm.hpp"
+
 #include "3party/fribidi/lib/fribidi.h"
 
 namespace fribidi
@@ -13,6 +15,11 @@ strings::UniString log2vis(strings::UniString const & str)
   if (count == 0)
     return str;
 
+  // Scripts before Hebrew have no right-to-left characters, so the visual order
+  // of such a text is the logical one. It's the most of the labels.
+  if (all_of(str.begin(), str.end(), [](strings::UniChar c) { return c < 0x0590; }))
+    return str;
+
   strings::UniString res(count);
 
   FriBidiParType dir = FRIBIDI_PAR_LTR;  // requested base direction
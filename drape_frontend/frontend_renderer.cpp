@@ -2,9 +2,16 @@
 #include "drape_frontend/message_subclasses.hpp"
 #include "drape_frontend/visual_params.hpp"
 
+#include "drape/frame_fences.hpp"
+#include "drape/texture.hpp"
+#include "drape/vertex_array_buffer.hpp"
+
+#include "platform/platform.hpp"
+
 #include "base/timer.hpp"
 #include "base/assert.hpp"
 #include "base/stl_add.hpp"
+#include "base/tracing.hpp"
 
 #include "geometry/any_rect2d.hpp"
 
@@ -25,6 +32,13 @@ const double VSyncInterval = 0.014;
 //const double InitAvarageTimePerMessage = 0.001;
 #endif
 
+// About 5 seconds of rendering.
+size_t const kFrameStatsCount = 300;
+
+// Bounding rects of the buckets don't include pixel offsets of the vertices: widths of the lines,
+// sizes of the symbols and the labels. So the screen is widened by the biggest offset.
+double const kCullingMarginPx = 256.0;
+
 void OrthoMatrix(float * m, float left, float right, float bottom, float top, float nearClip, float farClip)
 {
   memset(m, 0, 16 * sizeof(float));
@@ -44,8 +58,9 @@ FrontendRenderer::FrontendRenderer(dp::RefPointer<ThreadsCommutator> commutator,
                                    Viewport viewport)
   : m_commutator(commutator)
   , m_contextFactory(oglcontextfactory)
-  , m_gpuProgramManager(new dp::GpuProgramManager())
+  , m_gpuProgramManager(new dp::GpuProgramManager(GetPlatform().WritableDir()))
   , m_viewport(viewport)
+  , m_frameStats(kFrameStatsCount)
 {
 #ifdef DRAW_INFO
   m_tpf = 0,0;
@@ -64,6 +79,11 @@ FrontendRenderer::~FrontendRenderer()
   StopThread();
 }
 
+void FrontendRenderer::GetFrameStats(vector<FrameInfo> & frames) const
+{
+  m_frameStats.GetFrames(frames);
+}
+
 #ifdef DRAW_INFO
 void FrontendRenderer::BeforeDrawFrame()
 {
@@ -87,19 +107,30 @@ void FrontendRenderer::AfterDrawFrame()
 
     LOG(LINFO, ("Average Fps : ", m_fps));
     LOG(LINFO, ("Average Tpf : ", m_tpf));
+
+    MessageQueue::Stats const stats = GetQueueStats();
+    ResetQueueStats();
+    LOG(LINFO, ("Messages queue depth : ", stats.m_depth, "max : ", stats.m_maxDepth));
+    LOG(LINFO, ("Messages latency : ", stats.m_averageLatency, "max : ", stats.m_maxLatency));
+    LOG(LINFO, ("Textures memory : ", dp::Texture::GetAllocatedBytes()));
   }
 }
 #endif
 
 void FrontendRenderer::AcceptMessage(dp::RefPointer<Message> message)
 {
+  TRACE_SCOPE("drape", "FrontendRenderer::AcceptMessage");
   switch (message->GetType())
   {
   case Message::FlushTile:
     {
+      my::Timer const flushTimer;
       FlushRenderBucketMessage * msg = df::CastMessage<FlushRenderBucketMessage>(message);
       dp::GLState const & state = msg->GetState();
       TileKey const & key = msg->GetKey();
+      // The message destroys the bucket of the tile invalidated after its flush.
+      if (!m_invalidations.AcceptBucket(key, msg->GetGeneration()))
+        break;
       dp::MasterPointer<dp::RenderBucket> bucket(msg->AcceptBuffer());
       dp::RefPointer<dp::GpuProgram> program = m_gpuProgramManager->GetProgram(state.GetProgramIndex());
       program->Bind();
@@ -107,6 +138,7 @@ void FrontendRenderer::AcceptMessage(dp::RefPointer<Message> message)
       RenderGroup * group = new RenderGroup(state, key);
       group->AddBucket(bucket.Move());
       m_renderGroups.push_back(group);
+      m_frame.m_flushTime += flushTimer.ElapsedSeconds();
       break;
     }
 
@@ -143,8 +175,9 @@ void FrontendRenderer::AcceptMessage(dp::RefPointer<Message> message)
       set<TileKey> keyStorage;
       ResolveTileKeys(keyStorage, m->GetRect());
       InvalidateRenderGroups(keyStorage);
+      uint64_t const generation = m_invalidations.Invalidate(keyStorage);
 
-      Message * msgToBackend = new InvalidateReadManagerRectMessage(keyStorage);
+      Message * msgToBackend = new InvalidateReadManagerRectMessage(keyStorage, generation);
       m_commutator->PostMessage(ThreadsCommutator::ResourceUploadThread, dp::MovePointer(msgToBackend));
       break;
     }
@@ -156,12 +189,16 @@ void FrontendRenderer::AcceptMessage(dp::RefPointer<Message> message)
 
 void FrontendRenderer::RenderScene()
 {
+  TRACE_SCOPE("drape", "FrontendRenderer::RenderScene");
 #ifdef DRAW_INFO
   BeforeDrawFrame();
 #endif
 
+  my::Timer phaseTimer;
   RenderBucketComparator comparator(GetTileKeyStorage());
   sort(m_renderGroups.begin(), m_renderGroups.end(), bind(&RenderBucketComparator::operator (), &comparator, _1, _2));
+  if (comparator.NeedGroupMergeOperation())
+    MergeRenderGroups();
 
   m_overlayTree.StartOverlayPlacing(m_view);
   size_t eraseCount = 0;
@@ -192,6 +229,11 @@ void FrontendRenderer::RenderScene()
   }
   m_overlayTree.EndOverlayPlacing();
   m_renderGroups.resize(m_renderGroups.size() - eraseCount);
+  m_frame.m_overlayTime = phaseTimer.ElapsedSeconds();
+
+  phaseTimer.Reset();
+  m_gpuTimer.BeginFrame(m_frame.m_index);
+  dp::VertexArrayBuffer::ResetDrawStats();
 
   m_viewport.Apply();
   GLFunctions::glEnable(gl_const::GLDepthTest);
@@ -203,6 +245,12 @@ void FrontendRenderer::RenderScene()
 
   GLFunctions::glClear();
 
+  // Programs and buffers are bound on the messages processing.
+  m_stateApplier.Reset();
+  double const margin = kCullingMarginPx * VisualParams::Instance().GetVisualScale() * m_view.GetScale();
+  m2::AnyRectD const clipRect = m2::Inflate(m_view.GlobalRect(), margin, margin);
+  m_frame.m_culledBuckets = 0;
+
   dp::GLState::DepthLayer prevLayer = dp::GLState::GeometryLayer;
   for (size_t i = 0; i < m_renderGroups.size(); ++i)
   {
@@ -216,24 +264,54 @@ void FrontendRenderer::RenderScene()
     ASSERT_LESS_OR_EQUAL(prevLayer, layer, ());
 
     dp::RefPointer<dp::GpuProgram> program = m_gpuProgramManager->GetProgram(state.GetProgramIndex());
-    program->Bind();
-    ApplyUniforms(m_generalUniforms, program);
-    ApplyState(state, program);
+    m_stateApplier.Apply(state, program);
+    if (m_programsWithUniforms.insert(state.GetProgramIndex()).second)
+      ApplyUniforms(m_generalUniforms, program);
 
-    group->Render(m_view);
+    m_frame.m_culledBuckets += group->Render(m_view, clipRect);
   }
 
+  m_gpuTimer.EndFrame();
+  dp::FrameFences::Instance().EndFrame();
+  dp::VertexArrayBuffer::DrawStats const & drawStats = dp::VertexArrayBuffer::GetDrawStats();
+  m_frame.m_drawCalls = drawStats.m_drawCalls;
+  m_frame.m_verticesCount = drawStats.m_indexesCount;
+  m_frame.m_renderGroupsTime = phaseTimer.ElapsedSeconds();
+
 #ifdef DRAW_INFO
   AfterDrawFrame();
 #endif
 }
 
+void FrontendRenderer::MergeRenderGroups()
+{
+  // Groups of the same state and tile are neighbours after sorting, groups to delete go last.
+  size_t count = 0;
+  for (size_t i = 0; i < m_renderGroups.size(); ++i)
+  {
+    RenderGroup * group = m_renderGroups[i];
+    if (count > 0 && !group->IsPendingOnDelete())
+    {
+      RenderGroup * prev = m_renderGroups[count - 1];
+      if (prev->GetState() == group->GetState() && prev->GetTileKey() == group->GetTileKey())
+      {
+        prev->MergeGroup(*group);
+        delete group;
+        continue;
+      }
+    }
+    m_renderGroups[count++] = group;
+  }
+  m_renderGroups.resize(count);
+}
+
 void FrontendRenderer::RefreshProjection()
 {
   float m[4*4];
 
   OrthoMatrix(m, 0.0f, m_viewport.GetWidth(), m_viewport.GetHeight(), 0.0f, -20000.0f, 20000.0f);
   m_generalUniforms.SetMatrix4x4Value("projection", m);
+  m_programsWithUniforms.clear();
 }
 
 void FrontendRenderer::RefreshModelView()
@@ -249,6 +327,7 @@ void FrontendRenderer::RefreshModelView()
   mv(3, 0) = m(0, 2); mv(3, 1) = m(1, 2); mv(3, 2) = 0; mv(3, 3) = m(2, 2);
 
   m_generalUniforms.SetMatrix4x4Value("modelView", mv.m_data);
+  m_programsWithUniforms.clear();
 }
 
 void FrontendRenderer::ResolveTileKeys()
@@ -263,6 +342,8 @@ void FrontendRenderer::ResolveTileKeys(set<TileKey> & keyStorage, m2::RectD cons
 
 void FrontendRenderer::ResolveTileKeys(set<TileKey> & keyStorage, int tileScale)
 {
+  my::Timer const timer;
+
   // equal for x and y
   double const range = MercatorBounds::maxX - MercatorBounds::minX;
   double const rectSize = range / (1 << tileScale);
@@ -284,6 +365,8 @@ void FrontendRenderer::ResolveTileKeys(set<TileKey> & keyStorage, int tileScale)
         keyStorage.insert(key);
     }
   }
+
+  m_frame.m_resolveTilesTime += timer.ElapsedSeconds();
 }
 
 void FrontendRenderer::InvalidateRenderGroups(set<TileKey> & keyStorage)
@@ -296,6 +379,21 @@ void FrontendRenderer::InvalidateRenderGroups(set<TileKey> & keyStorage)
   }
 }
 
+void FrontendRenderer::BeginFrame()
+{
+  uint64_t const index = m_frame.m_index + 1;
+  m_frame = FrameInfo();
+  m_frame.m_index = index;
+  m_frameTimer.Reset();
+}
+
+void FrontendRenderer::EndFrame()
+{
+  m_frame.m_frameTime = m_frameTimer.ElapsedSeconds();
+  m_frameStats.PushFrame(m_frame);
+  m_gpuTimer.CollectResults(m_frameStats);
+}
+
 set<TileKey> & FrontendRenderer::GetTileKeyStorage()
 {
   return m_tiles;
@@ -317,8 +415,10 @@ FrontendRenderer::Routine::Routine(FrontendRenderer & renderer) : m_renderer(ren
 
 void FrontendRenderer::Routine::Do()
 {
+  my::tracing::SetThreadName("FrontendRenderer");
   dp::OGLContext * context = m_renderer.m_contextFactory->getDrawContext();
   context->makeCurrent();
+  m_renderer.m_gpuTimer.Init();
 
   my::Timer timer;
   //double processingTime = InitAvarageTimePerMessage; // By init we think that one message processed by 1ms
@@ -326,6 +426,7 @@ void FrontendRenderer::Routine::Do()
   timer.Reset();
   while (!IsCancelled())
   {
+    m_renderer.BeginFrame();
     context->setDefaultFramebuffer();
     m_renderer.RenderScene();
 
@@ -344,6 +445,7 @@ void FrontendRenderer::Routine::Do()
     //processingTime = (timer.ElapsedSeconds() - processingTime) / messageCount;
 
     context->present();
+    m_renderer.EndFrame();
     timer.Reset();
   }
 
@@ -353,6 +455,9 @@ void FrontendRenderer::Routine::Do()
 void FrontendRenderer::ReleaseResources()
 {
   DeleteRenderData();
+  m_gpuTimer.Release();
+  dp::FrameFences::Instance().Release();
+  m_programsWithUniforms.clear();
   m_gpuProgramManager.Destroy();
 }
 
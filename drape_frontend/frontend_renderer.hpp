@@ -8,11 +8,13 @@
   #include "../std/numeric.hpp"
 #endif
 
+#include "drape_frontend/frame_stats.hpp"
 #include "drape_frontend/message_acceptor.hpp"
 #include "drape_frontend/threads_commutator.hpp"
 #include "drape_frontend/tile_info.hpp"
 #include "drape_frontend/backend_renderer.hpp"
 #include "drape_frontend/render_group.hpp"
+#include "drape_frontend/tile_invalidations.hpp"
 
 #include "drape/pointers.hpp"
 #include "drape/glstate.hpp"
@@ -25,6 +27,8 @@
 
 #include "geometry/screenbase.hpp"
 
+#include "base/timer.hpp"
+
 #include "std/map.hpp"
 
 namespace dp { class RenderBucket; }
@@ -41,6 +45,9 @@ public:
 
   ~FrontendRenderer() override;
 
+  /// Stats of the last frames, it can be called on any thread.
+  void GetFrameStats(vector<FrameInfo> & frames) const;
+
 #ifdef DRAW_INFO
   double m_tpf;
   double m_fps;
@@ -59,6 +66,7 @@ protected:
 
 private:
   void RenderScene();
+  void MergeRenderGroups();
   void RefreshProjection();
   void RefreshModelView();
 
@@ -69,6 +77,9 @@ private:
 
   void InvalidateRenderGroups(set<TileKey> & keyStorage);
 
+  void BeginFrame();
+  void EndFrame();
+
 private:
   class Routine : public threads::IRoutine
   {
@@ -99,12 +110,22 @@ private:
   vector<RenderGroup *> m_renderGroups;
 
   dp::UniformValuesStorage m_generalUniforms;
+  /// Programs which have got the current general uniforms, they're kept by GL between the frames.
+  set<int> m_programsWithUniforms;
+  dp::GLStateApplier m_stateApplier;
 
   Viewport m_viewport;
   ScreenBase m_view;
   set<TileKey> m_tiles;
+  /// Buckets of the invalidated tiles may come after the invalidation, as they're of lower priority.
+  TileInvalidations m_invalidations;
 
   dp::OverlayTree m_overlayTree;
+
+  FrameStats m_frameStats;
+  GpuFrameTimer m_gpuTimer;
+  FrameInfo m_frame;
+  my::Timer m_frameTimer;
 };
 
 } // namespace df
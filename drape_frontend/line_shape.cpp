@@ -1,4 +1,5 @@
 #include "drape_frontend/line_shape.hpp"
+#include "drape_frontend/shape_serialization.hpp"
 
 #include "drape/utils/vertex_decl.hpp"
 #include "drape/glsl_types.hpp"
@@ -7,6 +8,7 @@
 #include "drape/attribute_provider.hpp"
 #include "drape/glstate.hpp"
 #include "drape/batcher.hpp"
+#include "drape/stipple_pen_resource.hpp"
 #include "drape/texture_manager.hpp"
 
 namespace df
@@ -36,14 +38,17 @@ namespace
     {
     }
 
-    void SetRegion(dp::TextureManager::StippleRegion const & region, bool isSolid)
+    /// Mask coordinates are generated in the unit square of the stipple pen,
+    /// they're mapped to its texture region on the upload, see MapToRegion().
+    void SetPattern(dp::TextureManager::TStipplePattern const & pattern)
     {
-      m_isSolid = isSolid;
-      m_region = region;
+      m_isSolid = pattern.empty();
       if (!m_isSolid)
       {
-        m_maskLength = static_cast<float>(m_region.GetMaskPixelLength());
-        m_patternLength = static_cast<float>(m_region.GetPatternPixelLength());
+        dp::StipplePenKey const key(pattern);
+        dp::StipplePenRasterizator const rasterizator(key);
+        m_maskLength = static_cast<float>(rasterizator.GetSize());
+        m_patternLength = static_cast<float>(rasterizator.GetPatternSize());
       }
     }
 
@@ -51,37 +56,41 @@ namespace
     {
       if (m_isSolid)
       {
-        desc.m_texCoord = glsl::ToVec2(m_region.GetTexRect().Center());
+        desc.m_texCoord = glsl::vec2(0.5f, 0.5f);
         return true;
       }
 
       float const pxLength = desc.m_globalLength * m_baseGtoPScale;
       float const maskRest = m_maskLength - m_pxCursor;
 
-      m2::RectF const & texRect = m_region.GetTexRect();
       if (maskRest < pxLength)
       {
         desc.m_globalLength = maskRest * m_basePtoGScale;
-        desc.m_texCoord = glsl::vec2(texRect.maxX(), texRect.Center().y);
+        desc.m_texCoord = glsl::vec2(1.0f, 0.5f);
         return false;
       }
 
-      float texX = texRect.minX() + ((m_pxCursor + pxLength) / m_maskLength) * texRect.SizeX();
+      float texX = (m_pxCursor + pxLength) / m_maskLength;
       m_pxCursor = fmodf(m_pxCursor + pxLength, m_patternLength);
 
-      desc.m_texCoord = glsl::vec2(texX, texRect.Center().y);
+      desc.m_texCoord = glsl::vec2(texX, 0.5f);
       return true;
     }
 
   private:
     float const m_baseGtoPScale;
     float const m_basePtoGScale;
-    dp::TextureManager::StippleRegion m_region;
     float m_maskLength = 0.0f;
     float m_patternLength = 0.0f;
     bool m_isSolid = true;
     float m_pxCursor = 0.0f;
   };
+
+  glsl::vec2 MapToRegion(glsl::vec2 const & unitCoord, m2::RectF const & texRect)
+  {
+    return glsl::vec2(texRect.minX() + unitCoord.x * texRect.SizeX(),
+                      texRect.minY() + unitCoord.y * texRect.SizeY());
+  }
 }
 
 LineShape::LineShape(m2::SharedSpline const & spline,
@@ -92,24 +101,58 @@ LineShape::LineShape(m2::SharedSpline const & spline,
   ASSERT_GREATER(m_spline->GetPath().size(), 1, ());
 }
 
+void LineShape::Prepare()
+{
+  m_geometry.clear();
+  BuildGeometry(m_geometry);
+}
+
 void LineShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const
 {
-  typedef gpu::LineVertex LV;
-  buffer_vector<gpu::LineVertex, 128> geometry;
-  vector<m2::PointD> const & path = m_spline->GetPath();
+  vector<gpu::LineVertex> geometry;
+  if (m_geometry.empty())
+    BuildGeometry(geometry);
+  else
+    geometry = m_geometry;
 
   dp::TextureManager::ColorRegion colorRegion;
   textures->GetColorRegion(m_params.m_color, colorRegion);
-  glsl::vec2 colorCoord(glsl::ToVec2(colorRegion.GetTexRect().Center()));
+  glsl::vec2 const colorCoord(glsl::ToVec2(colorRegion.GetTexRect().Center()));
 
-  TextureCoordGenerator texCoordGen(m_params.m_baseGtoPScale);
   dp::TextureManager::StippleRegion maskRegion;
   if (m_params.m_pattern.empty())
     textures->GetStippleRegion(dp::TextureManager::TStipplePattern{1}, maskRegion);
   else
     textures->GetStippleRegion(m_params.m_pattern, maskRegion);
+  m2::RectF const & maskRect = maskRegion.GetTexRect();
+
+  for (gpu::LineVertex & vertex : geometry)
+  {
+    vertex.m_colorTexCoord = colorCoord;
+    vertex.m_maskTexCoord = MapToRegion(vertex.m_maskTexCoord.Unpack(), maskRect);
+  }
+
+  dp::GLState state(gpu::LINE_PROGRAM, dp::GLState::GeometryLayer);
+  state.SetBlending(true);
+  state.SetColorTexture(colorRegion.GetTexture());
+  state.SetMaskTexture(maskRegion.GetTexture());
+
+  dp::AttributeProvider provider(1, geometry.size());
+  provider.InitStream(0, gpu::LineVertex::GetBindingInfo(), dp::MakeStackRefPointer<void>(geometry.data()));
 
-  texCoordGen.SetRegion(maskRegion, m_params.m_pattern.empty());
+  batcher->InsertListOfStrip(state, dp::MakeStackRefPointer(&provider), 4);
+}
+
+void LineShape::BuildGeometry(vector<gpu::LineVertex> & geometry) const
+{
+  typedef gpu::LineVertex LV;
+  vector<m2::PointD> const & path = m_spline->GetPath();
+
+  // Color coordinates are set in Draw().
+  glsl::vec2 const colorCoord(0.0f, 0.0f);
+
+  TextureCoordGenerator texCoordGen(m_params.m_baseGtoPScale);
+  texCoordGen.SetPattern(m_params.m_pattern);
   float const halfWidth = m_params.m_width / 2.0f;
   float const glbHalfWidth = halfWidth / m_params.m_baseGtoPScale;
   bool generateCap = m_params.m_cap != dp::ButtCap;
@@ -289,16 +332,41 @@ void LineShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::Tex
     geometry.push_back(LV(pivot, leftNormal + tangent, colorCoord, texCoords[TEX_END_IDX].m_texCoord, leftCap));
     geometry.push_back(LV(pivot, rightNormal + tangent, colorCoord, texCoords[TEX_END_IDX].m_texCoord, rightCap));
   }
+}
 
-  dp::GLState state(gpu::LINE_PROGRAM, dp::GLState::GeometryLayer);
-  state.SetBlending(true);
-  state.SetColorTexture(colorRegion.GetTexture());
-  state.SetMaskTexture(maskRegion.GetTexture());
-
-  dp::AttributeProvider provider(1, geometry.size());
-  provider.InitStream(0, gpu::LineVertex::GetBindingInfo(), dp::MakeStackRefPointer<void>(geometry.data()));
+void LineShape::Serialize(Writer & writer) const
+{
+  WriteShapeValue(writer, static_cast<uint8_t>(LineType));
+  WriteShapeValue(writer, m_params.m_depth);
+  WriteShapeValue(writer, m_params.m_color);
+  WriteShapeValue(writer, m_params.m_width);
+  WriteShapeEnum(writer, m_params.m_cap);
+  WriteShapeEnum(writer, m_params.m_join);
+  WriteShapeValue(writer, static_cast<uint8_t>(m_params.m_pattern.size()));
+  for (uint8_t v : m_params.m_pattern)
+    WriteShapeValue(writer, v);
+  WriteShapeValue(writer, m_params.m_baseGtoPScale);
+  WriteShapeValue(writer, m_spline);
+}
 
-  batcher->InsertListOfStrip(state, dp::MakeStackRefPointer(&provider), 4);
+// static
+LineShape * LineShape::Deserialize(FeatureID const & /* id */, TShapeSource & src)
+{
+  LineViewParams params;
+  ReadShapeValue(src, params.m_depth);
+  ReadShapeValue(src, params.m_color);
+  ReadShapeValue(src, params.m_width);
+  ReadShapeEnum(src, params.m_cap);
+  ReadShapeEnum(src, params.m_join);
+  uint8_t patternSize;
+  ReadShapeValue(src, patternSize);
+  params.m_pattern.resize(patternSize);
+  for (uint8_t & v : params.m_pattern)
+    ReadShapeValue(src, v);
+  ReadShapeValue(src, params.m_baseGtoPScale);
+  m2::SharedSpline spline;
+  ReadShapeValue(src, spline);
+  return new LineShape(spline, params);
 }
 
 } // namespace df
@@ -3,8 +3,12 @@
 #include "drape_frontend/map_shape.hpp"
 #include "drape_frontend/shape_view_params.hpp"
 
+#include "drape/utils/vertex_decl.hpp"
+
 #include "geometry/spline.hpp"
 
+#include "std/vector.hpp"
+
 namespace df
 {
 
@@ -14,11 +18,19 @@ public:
   LineShape(m2::SharedSpline const & spline,
             LineViewParams const & params);
 
+  virtual void Prepare();
   virtual void Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const;
+  virtual void Serialize(Writer & writer) const;
+
+  static LineShape * Deserialize(FeatureID const & id, TShapeSource & src);
 
 private:
+  /// Tessellates the line, texture coordinates of the mask are in the unit square of the pen.
+  void BuildGeometry(vector<gpu::LineVertex> & geometry) const;
+
   LineViewParams m_params;
   m2::SharedSpline m_spline;
+  vector<gpu::LineVertex> m_geometry;
 };
 
 } // namespace df
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "drape_frontend/message.hpp"
-#include "drape_frontend/tile_info.hpp"
+#include "drape_frontend/tile_key.hpp"
 
 #include "drape/pointers.hpp"
 
+#include "coding/reader.hpp"
+
+class Writer;
+
 namespace dp
 {
   class Batcher;
@@ -14,11 +18,32 @@ namespace dp
 namespace df
 {
 
+typedef ReaderSource<MemReader> TShapeSource;
+
 class MapShape
 {
 public:
+  /// Types of the serialized shapes, don't change the values.
+  enum Type
+  {
+    AreaType = 0,
+    CircleType = 1,
+    LineType = 2,
+    PathSymbolType = 3,
+    PathTextType = 4,
+    PoiSymbolType = 5,
+    TextType = 6
+  };
+
   virtual ~MapShape(){}
+  /// Does the part of the work which doesn't need textures and OpenGL,
+  /// it's called on the reading thread before the shape is posted to the backend renderer.
+  virtual void Prepare() {}
   virtual void Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const = 0;
+
+  /// Writes the type and the parameters of the shape except the feature id,
+  /// see DeserializeShape() in shape_serialization.hpp.
+  virtual void Serialize(Writer & writer) const = 0;
 };
 
 class MapShapeReadedMessage : public Message
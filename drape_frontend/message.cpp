@@ -6,7 +6,12 @@ namespace df
 {
 
 Message::Message()
-  : m_type(Unknown) {}
+  : m_type(Unknown)
+  , m_priority(NormalPriority)
+  , m_next(nullptr)
+  , m_postTime(0.0)
+{
+}
 
 Message::Type Message::GetType() const
 {
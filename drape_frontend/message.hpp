@@ -1,9 +1,13 @@
 #pragma once
 
+#include "drape/pooled_object.hpp"
+
+#include "std/atomic.hpp"
+
 namespace df
 {
 
-class Message
+class Message : public dp::PooledObject
 {
 public:
   enum Type
@@ -23,15 +27,35 @@ public:
     Rotate
   };
 
+  /// Messages of higher priority are processed before the posted earlier ones of lower priority,
+  /// the order of messages of the same priority is kept.
+  enum Priority
+  {
+    HighPriority,
+    NormalPriority,
+    LowPriority,
+    PrioritiesCount
+  };
+
   Message();
   virtual ~Message() {}
   Type GetType() const;
+  Priority GetPriority() const { return m_priority; }
 
 protected:
   void SetType(Type t);
+  void SetPriority(Priority p) { m_priority = p; }
 
 private:
+  friend class MessageQueue;
+
   Type m_type;
+  Priority m_priority;
+
+  // Link of MessageQueue, so posting of a message doesn't allocate.
+  atomic<Message *> m_next;
+  // Time of posting in seconds, for the latency of MessageQueue.
+  double m_postTime;
 };
 
 } // namespace df
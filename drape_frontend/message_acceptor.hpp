@@ -21,6 +21,10 @@ protected:
   void ProcessSingleMessage(unsigned maxTimeWait = -1);
   void CloseQueue();
 
+  /// Depth and latency of the queue since the last reset, must be called on message target thread.
+  MessageQueue::Stats GetQueueStats() const { return m_messageQueue.GetStats(); }
+  void ResetQueueStats() { m_messageQueue.ResetStats(); }
+
 private:
   friend class ThreadsCommutator;
 
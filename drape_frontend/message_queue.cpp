@@ -1,11 +1,77 @@
 #include "drape_frontend/message_queue.hpp"
 
 #include "base/assert.hpp"
-#include "base/stl_add.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/chrono.hpp"
+#include "std/thread.hpp"
 
 namespace df
 {
 
+MessageQueue::Stats::Stats()
+  : m_depth(0)
+  , m_maxDepth(0)
+  , m_averageLatency(0.0)
+  , m_maxLatency(0.0)
+  , m_poppedCount(0)
+{
+}
+
+MessageQueue::IntrusiveList::IntrusiveList()
+  : m_head(&m_stub)
+  , m_tail(&m_stub)
+{
+}
+
+void MessageQueue::IntrusiveList::Push(Message * message)
+{
+  message->m_next.store(nullptr, memory_order_relaxed);
+  Message * prev = m_head.exchange(message, memory_order_acq_rel);
+  prev->m_next.store(message, memory_order_release);
+}
+
+Message * MessageQueue::IntrusiveList::Pop()
+{
+  Message * tail = m_tail;
+  Message * next = tail->m_next.load(memory_order_acquire);
+  if (tail == &m_stub)
+  {
+    if (next == nullptr)
+      return nullptr;
+    m_tail = next;
+    tail = next;
+    next = next->m_next.load(memory_order_acquire);
+  }
+
+  if (next != nullptr)
+  {
+    m_tail = next;
+    return tail;
+  }
+
+  // The tail is the last message, a producer may be linking the next one after it.
+  if (tail != m_head.load(memory_order_acquire))
+    return nullptr;
+
+  Push(&m_stub);
+  next = tail->m_next.load(memory_order_acquire);
+  if (next != nullptr)
+  {
+    m_tail = next;
+    return tail;
+  }
+  return nullptr;
+}
+
+MessageQueue::MessageQueue()
+  : m_size(0)
+  , m_maxSize(0)
+  , m_isWaiting(false)
+  , m_isWaitCanceled(false)
+{
+}
+
 MessageQueue::~MessageQueue()
 {
   CancelWait();
@@ -14,45 +80,108 @@ MessageQueue::~MessageQueue()
 
 dp::TransferPointer<Message> MessageQueue::PopMessage(unsigned maxTimeWait)
 {
-  threads::ConditionGuard guard(m_condition);
-
-  WaitMessage(maxTimeWait);
+  unique_lock<mutex> lock(m_mutex);
 
   /// even waitNonEmpty == true m_messages can be empty after WaitMessage call
   /// if application preparing to close and CancelWait been called
-  if (m_messages.empty())
+  if (!WaitMessage(lock, maxTimeWait))
     return dp::MovePointer<Message>(NULL);
 
-  dp::MasterPointer<Message> msg = m_messages.front();
-  m_messages.pop_front();
-  return msg.Move();
+  Message * message = PopAny();
+
+  double const latency = m_timer.ElapsedSeconds() - message->m_postTime;
+  ++m_stats.m_poppedCount;
+  m_stats.m_averageLatency += (latency - m_stats.m_averageLatency) / m_stats.m_poppedCount;
+  m_stats.m_maxLatency = max(m_stats.m_maxLatency, latency);
+
+  return dp::MovePointer(message);
 }
 
 void MessageQueue::PushMessage(dp::TransferPointer<Message> message)
 {
-  threads::ConditionGuard guard(m_condition);
+  Message * raw = dp::MasterPointer<Message>(message).Release();
+  raw->m_postTime = m_timer.ElapsedSeconds();
+  m_lists[raw->GetPriority()].Push(raw);
+
+  size_t const size = ++m_size;
+  size_t maxSize = m_maxSize.load();
+  while (size > maxSize && !m_maxSize.compare_exchange_weak(maxSize, size))
+  {
+  }
+
+  // m_size is changed before the check, and the consumer sets the flag before it checks m_size,
+  // so either the consumer sees the message or it's woken up here.
+  if (m_isWaiting)
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_condition.notify_one();
+  }
+}
+
+bool MessageQueue::WaitMessage(unique_lock<mutex> & lock, unsigned maxTimeWait)
+{
+  if (m_size > 0)
+    return true;
 
-  bool wasEmpty = m_messages.empty();
-  m_messages.push_back(dp::MasterPointer<Message>(message));
+  m_isWaiting = true;
+  auto const isReady = [this]() { return m_size > 0 || m_isWaitCanceled; };
+  if (maxTimeWait == static_cast<unsigned>(-1))
+    m_condition.wait(lock, isReady);
+  else
+    m_condition.wait_for(lock, milliseconds(maxTimeWait), isReady);
+  m_isWaiting = false;
+  m_isWaitCanceled = false;
 
-  if (wasEmpty)
-    guard.Signal();
+  return m_size > 0;
 }
 
-void MessageQueue::WaitMessage(unsigned maxTimeWait)
+Message * MessageQueue::PopAny()
 {
-  if (m_messages.empty())
-    m_condition.Wait(maxTimeWait);
+  ASSERT_GREATER(m_size.load(), 0, ());
+  while (true)
+  {
+    for (IntrusiveList & list : m_lists)
+    {
+      if (Message * message = list.Pop())
+      {
+        --m_size;
+        return message;
+      }
+    }
+    // The counted message is behind a message which a producer is linking now.
+    this_thread::yield();
+  }
 }
 
 void MessageQueue::CancelWait()
 {
-  m_condition.Signal();
+  lock_guard<mutex> lock(m_mutex);
+  if (m_isWaiting)
+  {
+    m_isWaitCanceled = true;
+    m_condition.notify_one();
+  }
 }
 
 void MessageQueue::ClearQuery()
 {
-  DeleteRange(m_messages, dp::MasterPointerDeleter());
+  lock_guard<mutex> lock(m_mutex);
+  while (m_size > 0)
+    dp::MovePointer(PopAny()).Destroy();
+}
+
+MessageQueue::Stats MessageQueue::GetStats() const
+{
+  Stats stats = m_stats;
+  stats.m_depth = m_size;
+  stats.m_maxDepth = m_maxSize;
+  return stats;
+}
+
+void MessageQueue::ResetStats()
+{
+  m_stats = Stats();
+  m_maxSize = m_size.load();
 }
 
 } // namespace df
@@ -4,30 +4,86 @@
 
 #include "drape/pointers.hpp"
 
-#include "base/condition.hpp"
+#include "base/timer.hpp"
 
-#include "std/list.hpp"
+#include "std/atomic.hpp"
+#include "std/condition_variable.hpp"
+#include "std/cstdint.hpp"
+#include "std/mutex.hpp"
 
 namespace df
 {
 
+/// Queue of messages from many threads to a single one. Posting doesn't lock or allocate:
+/// messages are linked into lock-free intrusive lists, one per priority. Only the waiting
+/// for messages locks, and producers take the lock only to wake up the waiting consumer.
 class MessageQueue
 {
 public:
+  struct Stats
+  {
+    Stats();
+
+    /// Number of messages in the queue.
+    size_t m_depth;
+    size_t m_maxDepth;
+    /// Time between posting and popping of the messages in seconds.
+    double m_averageLatency;
+    double m_maxLatency;
+    uint64_t m_poppedCount;
+  };
+
+  MessageQueue();
   ~MessageQueue();
 
   /// if queue is empty than return NULL
+  /// @param maxTimeWait Time in milliseconds, -1 to wait infinitely.
   dp::TransferPointer<Message> PopMessage(unsigned maxTimeWait);
   void PushMessage(dp::TransferPointer<Message> message);
   void CancelWait();
   void ClearQuery();
 
+  /// Statistics since the last ResetStats(), it must be called on the popping thread.
+  Stats GetStats() const;
+  void ResetStats();
+
 private:
-  void WaitMessage(unsigned maxTimeWait);
+  /// Intrusive lock-free FIFO of many producers and a single consumer.
+  class IntrusiveList
+  {
+  public:
+    IntrusiveList();
+
+    void Push(Message * message);
+    /// @return NULL when the list is empty or the last message isn't linked yet.
+    Message * Pop();
+
+  private:
+    // The last pushed message.
+    atomic<Message *> m_head;
+    // The next message to pop.
+    Message * m_tail;
+    // It's linked when the list becomes empty, so m_head is never null.
+    Message m_stub;
+  };
+
+  bool WaitMessage(unique_lock<mutex> & lock, unsigned maxTimeWait);
+  Message * PopAny();
 
 private:
-  threads::Condition m_condition;
-  list<dp::MasterPointer<Message> > m_messages;
+  IntrusiveList m_lists[Message::PrioritiesCount];
+
+  atomic<size_t> m_size;
+  atomic<size_t> m_maxSize;
+  atomic<bool> m_isWaiting;
+  atomic<bool> m_isWaitCanceled;
+
+  // Guards the consumer side and the sleeping.
+  mutex m_mutex;
+  condition_variable m_condition;
+
+  my::Timer m_timer;
+  Stats m_stats;
 };
 
 } // namespace df
@@ -11,6 +11,7 @@
 #include "drape/pointers.hpp"
 #include "drape/render_bucket.hpp"
 
+#include "std/cstdint.hpp"
 #include "std/shared_ptr.hpp"
 #include "std/set.hpp"
 
@@ -49,11 +50,17 @@ public:
 class FlushRenderBucketMessage : public BaseTileMessage
 {
 public:
-  FlushRenderBucketMessage(TileKey const & key, dp::GLState const & state, dp::TransferPointer<dp::RenderBucket> buffer)
+  /// @param generation Generation of the last invalidation of the tiles handled by the backend,
+  ///                   see TileInvalidations.
+  FlushRenderBucketMessage(TileKey const & key, dp::GLState const & state,
+                           dp::TransferPointer<dp::RenderBucket> buffer, uint64_t generation)
     : BaseTileMessage(key, Message::FlushTile)
     , m_state(state)
     , m_buffer(buffer)
+    , m_generation(generation)
   {
+    // Bulk geometry mustn't delay the updates of the screen.
+    SetPriority(LowPriority);
   }
 
   ~FlushRenderBucketMessage()
@@ -63,10 +70,12 @@ public:
 
   dp::GLState const & GetState() const { return m_state; }
   dp::MasterPointer<dp::RenderBucket> AcceptBuffer() { return dp::MasterPointer<dp::RenderBucket>(m_buffer); }
+  uint64_t GetGeneration() const { return m_generation; }
 
 private:
   dp::GLState m_state;
   dp::TransferPointer<dp::RenderBucket> m_buffer;
+  uint64_t m_generation;
 };
 
 class ResizeMessage : public Message
@@ -75,6 +84,7 @@ public:
   ResizeMessage(Viewport const & viewport) : m_viewport(viewport)
   {
     SetType(Resize);
+    SetPriority(HighPriority);
   }
 
   Viewport const & GetViewport() const { return m_viewport; }
@@ -90,6 +100,7 @@ public:
     : m_screen(screen)
   {
     SetType(UpdateModelView);
+    SetPriority(HighPriority);
   }
 
   ScreenBase const & GetScreen() const { return m_screen; }
@@ -105,6 +116,7 @@ public:
     : m_rect(rect)
   {
     SetType(InvalidateRect);
+    SetPriority(HighPriority);
   }
 
   m2::RectD const & GetRect() const { return m_rect; }
@@ -132,16 +144,21 @@ private:
 class InvalidateReadManagerRectMessage : public Message
 {
 public:
-  InvalidateReadManagerRectMessage(set<TileKey> const & tiles)
+  InvalidateReadManagerRectMessage(set<TileKey> const & tiles, uint64_t generation)
     : m_tiles(tiles)
+    , m_generation(generation)
   {
+    // Keeps the order with the shapes of the tiles, so the shapes read before the invalidation
+    // are flushed with the previous generation.
     SetType(InvalidateReadManagerRect);
   }
 
   set<TileKey> const & GetTilesForInvalidate() const { return m_tiles; }
+  uint64_t GetGeneration() const { return m_generation; }
 
 private:
   set<TileKey> m_tiles;
+  uint64_t m_generation;
 };
 
 template <typename T>
@@ -1,4 +1,5 @@
 #include "drape_frontend/path_symbol_shape.hpp"
+#include "drape_frontend/shape_serialization.hpp"
 #include "drape_frontend/visual_params.hpp"
 
 #include "drape/utils/vertex_decl.hpp"
@@ -67,4 +68,30 @@ void PathSymbolShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<d
   batcher->InsertListOfStrip(state, dp::MakeStackRefPointer(&provider), 4);
 }
 
+void PathSymbolShape::Serialize(Writer & writer) const
+{
+  WriteShapeValue(writer, static_cast<uint8_t>(PathSymbolType));
+  WriteShapeValue(writer, m_params.m_depth);
+  WriteShapeValue(writer, m_params.m_symbolName);
+  WriteShapeValue(writer, m_params.m_offset);
+  WriteShapeValue(writer, m_params.m_step);
+  WriteShapeValue(writer, m_params.m_baseGtoPScale);
+  WriteShapeValue(writer, m_spline);
+}
+
+// static
+PathSymbolShape * PathSymbolShape::Deserialize(FeatureID const & id, TShapeSource & src)
+{
+  PathSymbolViewParams params;
+  params.m_featureID = id;
+  ReadShapeValue(src, params.m_depth);
+  ReadShapeValue(src, params.m_symbolName);
+  ReadShapeValue(src, params.m_offset);
+  ReadShapeValue(src, params.m_step);
+  ReadShapeValue(src, params.m_baseGtoPScale);
+  m2::SharedSpline spline;
+  ReadShapeValue(src, spline);
+  return new PathSymbolShape(spline, params);
+}
+
 }
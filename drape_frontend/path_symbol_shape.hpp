@@ -13,6 +13,9 @@ class PathSymbolShape : public MapShape
 public:
   PathSymbolShape(m2::SharedSpline const & spline, PathSymbolViewParams const & params);
   virtual void Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const;
+  virtual void Serialize(Writer & writer) const;
+
+  static PathSymbolShape * Deserialize(FeatureID const & id, TShapeSource & src);
 
 private:
   PathSymbolViewParams m_params;
@@ -1,4 +1,5 @@
 #include "drape_frontend/path_text_shape.hpp"
+#include "drape_frontend/shape_serialization.hpp"
 #include "drape_frontend/text_layout.hpp"
 #include "drape_frontend/visual_params.hpp"
 #include "drape_frontend/intrusive_vector.hpp"
@@ -29,14 +30,13 @@ namespace
   public:
     PathTextHandle(m2::SharedSpline const & spl,
                    df::SharedTextLayout const & layout,
-                   float const mercatorOffset,
+                   m2::Spline::iterator const & centerPointIter,
                    float const depth)
       : OverlayHandle(FeatureID(), dp::Center, depth)
       , m_spline(spl)
+      , m_centerPointIter(centerPointIter)
       , m_layout(layout)
     {
-      m_centerPointIter = m_spline.CreateIterator();
-      m_centerPointIter.Advance(mercatorOffset);
       m_normals.resize(4 * m_layout->GetGlyphCount());
     }
 
@@ -190,16 +190,17 @@ void PathTextShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp:
   state.SetMaskTexture(layout->GetMaskTexture());
 
   ASSERT(!offsets.empty(), ());
+  vector<Spline::iterator> iters;
+  m_spline.CreateIterators(vector<double>(offsets.begin(), offsets.end()), iters);
+
   gpu::TTextStaticVertexBuffer staticBuffer;
   gpu::TTextDynamicVertexBuffer dynBuffer;
   SharedTextLayout layoutPtr(layout);
-  for (float offset : offsets)
+  for (Spline::iterator const & iter : iters)
   {
     staticBuffer.clear();
     dynBuffer.clear();
 
-    Spline::iterator iter = m_spline.CreateIterator();
-    iter.Advance(offset);
     layout->CacheStaticGeometry(glsl::vec3(glsl::ToVec2(iter.m_pos), m_params.m_depth),
                                 color, outline, staticBuffer);
 
@@ -209,9 +210,32 @@ void PathTextShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp:
     provider.InitStream(0, gpu::TextStaticVertex::GetBindingInfo(), dp::MakeStackRefPointer<void>(staticBuffer.data()));
     provider.InitStream(1, gpu::TextDynamicVertex::GetBindingInfo(), dp::MakeStackRefPointer<void>(dynBuffer.data()));
 
-    dp::OverlayHandle * handle = new PathTextHandle(m_spline, layoutPtr, offset, m_params.m_depth);
+    dp::OverlayHandle * handle = new PathTextHandle(m_spline, layoutPtr, iter, m_params.m_depth);
     batcher->InsertListOfStrip(state, dp::MakeStackRefPointer(&provider), dp::MovePointer(handle), 4);
   }
 }
 
+void PathTextShape::Serialize(Writer & writer) const
+{
+  WriteShapeValue(writer, static_cast<uint8_t>(PathTextType));
+  WriteShapeValue(writer, m_params.m_depth);
+  WriteShapeValue(writer, m_params.m_textFont);
+  WriteShapeValue(writer, m_params.m_text);
+  WriteShapeValue(writer, m_params.m_baseGtoPScale);
+  WriteShapeValue(writer, m_spline);
+}
+
+// static
+PathTextShape * PathTextShape::Deserialize(FeatureID const & /* id */, TShapeSource & src)
+{
+  PathTextViewParams params;
+  ReadShapeValue(src, params.m_depth);
+  ReadShapeValue(src, params.m_textFont);
+  ReadShapeValue(src, params.m_text);
+  ReadShapeValue(src, params.m_baseGtoPScale);
+  m2::SharedSpline spline;
+  ReadShapeValue(src, spline);
+  return new PathTextShape(spline, params);
+}
+
 }
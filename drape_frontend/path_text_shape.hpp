@@ -14,6 +14,9 @@ public:
   PathTextShape(m2::SharedSpline const & spline,
                 PathTextViewParams const & params);
   virtual void Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const;
+  virtual void Serialize(Writer & writer) const;
+
+  static PathTextShape * Deserialize(FeatureID const & id, TShapeSource & src);
 
 private:
   m2::SharedSpline m_spline;
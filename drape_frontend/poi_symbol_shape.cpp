@@ -1,16 +1,34 @@
 #include "drape_frontend/poi_symbol_shape.hpp"
+#include "drape_frontend/shape_serialization.hpp"
 
 #include "drape/utils/vertex_decl.hpp"
 #include "drape/attribute_provider.hpp"
 #include "drape/texture_manager.hpp"
 #include "drape/glstate.hpp"
 #include "drape/batcher.hpp"
+#include "drape/glextensions_list.hpp"
 
 #include "drape/shader_def.hpp"
 
 namespace df
 {
 
+namespace
+{
+
+// The quad is drawn as a strip, corners go in the same order as the vertexes of the strip.
+gpu::InstanceMeshVertex const kQuadMesh[] =
+{
+  gpu::InstanceMeshVertex(glsl::vec2(-1.0f, 1.0f)),
+  gpu::InstanceMeshVertex(glsl::vec2(-1.0f, -1.0f)),
+  gpu::InstanceMeshVertex(glsl::vec2(1.0f, 1.0f)),
+  gpu::InstanceMeshVertex(glsl::vec2(1.0f, -1.0f))
+};
+
+uint16_t const kQuadIndexes[] = { 0, 1, 2, 1, 2, 3 };
+
+} // namespace
+
 PoiSymbolShape::PoiSymbolShape(m2::PointF const & mercatorPt, PoiSymbolViewParams const & params)
   : m_pt(mercatorPt)
   , m_params(params)
@@ -28,6 +46,31 @@ void PoiSymbolShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp
 
   glsl::vec3 position = glsl::vec3(glsl::ToVec2(m_pt), m_params.m_depth);
 
+  dp::OverlayHandle * handle = new dp::SquareHandle(m_params.m_id,
+                                                    dp::Center,
+                                                    m_pt,
+                                                    pixelSize,
+                                                    m_params.m_depth);
+
+  if (dp::GLExtensionsList::Instance().IsSupported(dp::GLExtensionsList::InstancedArrays))
+  {
+    dp::GLState state(gpu::INSTANCED_SYMBOL_PROGRAM, dp::GLState::OverlayLayer);
+    state.SetBlending(dp::Blending(true));
+    state.SetColorTexture(region.GetTexture());
+
+    gpu::SymbolInstance instance(position, glsl::ToVec2(halfSize),
+                                 glsl::vec4(texRect.minX(), texRect.minY(), texRect.maxX(), texRect.maxY()));
+
+    dp::AttributeProvider mesh(1, ARRAY_SIZE(kQuadMesh));
+    mesh.InitStream(0, gpu::InstanceMeshVertex::GetBindingInfo(), dp::MakeStackRefPointer<void>((void *)kQuadMesh));
+    dp::AttributeProvider provider(1, 1);
+    provider.InitStream(0, gpu::SymbolInstance::GetBindingInfo(), dp::MakeStackRefPointer<void>(&instance));
+
+    batcher->InsertInstance(state, dp::MakeStackRefPointer(&mesh), kQuadIndexes, ARRAY_SIZE(kQuadIndexes),
+                            dp::MakeStackRefPointer(&provider), dp::MovePointer(handle));
+    return;
+  }
+
   gpu::SolidTexturingVertex vertexes[] =
   {
     gpu::SolidTexturingVertex{ position,
@@ -51,13 +94,26 @@ void PoiSymbolShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp
   dp::AttributeProvider provider(1, 4);
   provider.InitStream(0, gpu::SolidTexturingVertex::GetBindingInfo(), dp::MakeStackRefPointer<void>(vertexes));
 
-  dp::OverlayHandle * handle = new dp::SquareHandle(m_params.m_id,
-                                                    dp::Center,
-                                                    m_pt,
-                                                    pixelSize,
-                                                    m_params.m_depth);
-
   batcher->InsertTriangleStrip(state, dp::MakeStackRefPointer(&provider), dp::MovePointer(handle));
 }
 
+void PoiSymbolShape::Serialize(Writer & writer) const
+{
+  WriteShapeValue(writer, static_cast<uint8_t>(PoiSymbolType));
+  WriteShapeValue(writer, m_pt);
+  WriteShapeValue(writer, m_params.m_depth);
+  WriteShapeValue(writer, m_params.m_symbolName);
+}
+
+// static
+PoiSymbolShape * PoiSymbolShape::Deserialize(FeatureID const & id, TShapeSource & src)
+{
+  m2::PointF pt;
+  PoiSymbolViewParams params(id);
+  ReadShapeValue(src, pt);
+  ReadShapeValue(src, params.m_depth);
+  ReadShapeValue(src, params.m_symbolName);
+  return new PoiSymbolShape(pt, params);
+}
+
 } // namespace df
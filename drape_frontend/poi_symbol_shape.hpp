@@ -12,6 +12,9 @@ public:
   PoiSymbolShape(m2::PointF const & mercatorPt, PoiSymbolViewParams const & params);
 
   virtual void Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const;
+  virtual void Serialize(Writer & writer) const;
+
+  static PoiSymbolShape * Deserialize(FeatureID const & id, TShapeSource & src);
 
 private:
   m2::PointF const m_pt;
@@ -1,10 +1,16 @@
 #include "drape_frontend/read_manager.hpp"
 #include "drape_frontend/visual_params.hpp"
 
+#include "indexer/map_style_reader.hpp"
+
 #include "platform/platform.hpp"
 
+#include "coding/sha2.hpp"
+
 #include "base/buffer_vector.hpp"
+#include "base/logging.hpp"
 #include "base/stl_add.hpp"
+#include "base/string_utils.hpp"
 
 #include "std/bind.hpp"
 #include "std/algorithm.hpp"
@@ -28,14 +34,55 @@ struct LessCoverageCell
   }
 };
 
+string const kTileCacheDir = "tiles_cache/";
+size_t const kFeatureShapesCacheSize = 16 * 1024 * 1024;
+
+// Shapes of the cached tiles depend on the drawing rules and on the visual parameters.
+string GetTileCacheStyleKey()
+{
+  string rules;
+  GetStyleReader().GetDrawingRulesReader().ReadAsString(rules);
+
+  VisualParams const & params = VisualParams::Instance();
+  return params.GetResourcePostfix() + " " + strings::to_string(params.GetTileSize()) + " " +
+         strings::to_string(params.GetVisualScale()) + " " + sha2::digest256(rules);
+}
+
+TileCache * CreateTileCache()
+{
+  Platform & platform = GetPlatform();
+  string const dir = platform.WritablePathForFile(kTileCacheDir);
+  Platform::EError const err = platform.MkDir(dir);
+  if (err != Platform::ERR_OK && err != Platform::ERR_FILE_ALREADY_EXISTS)
+  {
+    LOG(LWARNING, ("Can't create tile cache directory", dir, err));
+    return nullptr;
+  }
+
+  try
+  {
+    return new TileCache(dir, GetTileCacheStyleKey());
+  }
+  catch (RootException const & ex)
+  {
+    LOG(LWARNING, ("Can't read drawing rules for tile cache", ex.Msg()));
+    return nullptr;
+  }
+}
+
 } // namespace
 
 ReadManager::ReadManager(EngineContext & context, MapDataProvider & model)
   : m_context(context)
   , m_model(model)
-  , myPool(64, ReadMWMTaskFactory(m_memIndex, m_model, m_context))
+  , m_tileCache(CreateTileCache())
+  , m_shapesCache(kFeatureShapesCacheSize)
+  , myPool(64, ReadMWMTaskFactory(m_memIndex, m_model, m_context, m_tileCache.get(), &m_shapesCache))
+  , m_runningTasks(0)
+  , m_readCount(ReadCount())
+  , m_isStopped(false)
 {
-  m_pool.Reset(new threads::ThreadPool(ReadCount(), bind(&ReadManager::OnTaskFinished, this, _1)));
+  m_pool.Reset(new threads::ThreadPool(m_readCount, bind(&ReadManager::OnTaskFinished, this, _1)));
 }
 
 void ReadManager::OnTaskFinished(threads::IRoutine * task)
@@ -44,6 +91,11 @@ void ReadManager::OnTaskFinished(threads::IRoutine * task)
   ReadMWMTask * t = static_cast<ReadMWMTask *>(task);
   t->Reset();
   myPool.Return(t);
+
+  lock_guard<mutex> lock(m_pendingMutex);
+  ASSERT_GREATER(m_runningTasks, 0, ());
+  --m_runningTasks;
+  StartPendingTasks();
 }
 
 void ReadManager::UpdateCoverage(ScreenBase const & screen, set<TileKey> const & tiles)
@@ -53,13 +105,21 @@ void ReadManager::UpdateCoverage(ScreenBase const & screen, set<TileKey> const &
 
   if (MustDropAllTiles(screen))
   {
+    ClearPendingTasks();
     for_each(m_tileInfos.begin(), m_tileInfos.end(), bind(&ReadManager::CancelTileInfo, this, _1));
     m_tileInfos.clear();
+    for (auto const & prefetchTile : m_prefetchTiles)
+      CancelTileInfo(prefetchTile.second);
+    m_prefetchTiles.clear();
 
+    m_scheduler.ResetMotion();
+    m_scheduler.UpdateScreen(screen, m_timer.ElapsedSeconds());
     for_each(tiles.begin(), tiles.end(), bind(&ReadManager::PushTaskBackForTileKey, this, _1));
   }
   else
   {
+    m_scheduler.UpdateScreen(screen, m_timer.ElapsedSeconds());
+
     // Find rects that go out from viewport
     buffer_vector<tileinfo_ptr, 8> outdatedTiles;
 #ifdef _MSC_VER
@@ -80,13 +140,30 @@ void ReadManager::UpdateCoverage(ScreenBase const & screen, set<TileKey> const &
 
     for_each(outdatedTiles.begin(), outdatedTiles.end(), bind(&ReadManager::ClearTileInfo, this, _1));
     for_each(m_tileInfos.begin(), m_tileInfos.end(), bind(&ReadManager::PushTaskFront, this, _1));
-    for_each(inputRects.begin(),  inputRects.end(),  bind(&ReadManager::PushTaskBackForTileKey, this, _1));
+    for (TileKey const & tileKey : inputRects)
+    {
+      // The prefetched tile keeps its feature index and reads only features.
+      auto const it = m_prefetchTiles.find(tileKey);
+      if (it == m_prefetchTiles.end())
+      {
+        PushTaskBackForTileKey(tileKey);
+        continue;
+      }
+      m_tileInfos.insert(it->second);
+      PushTaskFront(it->second);
+      m_prefetchTiles.erase(it);
+    }
   }
+  UpdatePrefetchTiles(tiles);
+  UpdatePendingPriorities();
   m_currentViewport = screen;
 }
 
 void ReadManager::Invalidate(set<TileKey> const & keyStorage)
 {
+  // Features of the invalidated tiles may be changed.
+  m_shapesCache.Clear();
+
   tile_set_t::iterator it = m_tileInfos.begin();
   for (; it != m_tileInfos.end(); ++it)
   {
@@ -100,8 +177,17 @@ void ReadManager::Invalidate(set<TileKey> const & keyStorage)
 
 void ReadManager::Stop()
 {
+  {
+    lock_guard<mutex> lock(m_pendingMutex);
+    m_isStopped = true;
+    m_pendingTasks.clear();
+  }
+
   for_each(m_tileInfos.begin(), m_tileInfos.end(), bind(&ReadManager::CancelTileInfo, this, _1));
   m_tileInfos.clear();
+  for (auto const & prefetchTile : m_prefetchTiles)
+    CancelTileInfo(prefetchTile.second);
+  m_prefetchTiles.clear();
 
   m_pool->Stop();
   m_pool.Destroy();
@@ -109,7 +195,7 @@ void ReadManager::Stop()
 
 size_t ReadManager::ReadCount()
 {
-  return max(GetPlatform().CpuCores() - 2, 1);
+  return max(static_cast<int>(GetPlatform().CpuCores()) - 2, 1);
 }
 
 bool ReadManager::MustDropAllTiles(ScreenBase const & screen) const
@@ -123,16 +209,101 @@ void ReadManager::PushTaskBackForTileKey(TileKey const & tileKey)
 {
   tileinfo_ptr tileInfo(new TileInfo(tileKey));
   m_tileInfos.insert(tileInfo);
-  ReadMWMTask * task = myPool.Get();
-  task->Init(tileInfo);
-  m_pool->PushBack(task);
+  ScheduleTile(tileInfo, false /* indexOnly */);
 }
 
 void ReadManager::PushTaskFront(tileinfo_ptr const & tileToReread)
 {
-  ReadMWMTask * task = myPool.Get();
-  task->Init(tileToReread);
-  m_pool->PushFront(task);
+  ScheduleTile(tileToReread, false /* indexOnly */);
+}
+
+void ReadManager::ScheduleTile(tileinfo_ptr const & tile, bool indexOnly)
+{
+  lock_guard<mutex> lock(m_pendingMutex);
+  auto it = find_if(m_pendingTasks.begin(), m_pendingTasks.end(),
+                    [&tile](PendingTask const & task) { return task.m_tile == tile; });
+  if (it == m_pendingTasks.end())
+    it = m_pendingTasks.insert(m_pendingTasks.end(), {tile, 0.0, indexOnly});
+  else
+    it->m_indexOnly = it->m_indexOnly && indexOnly;
+  it->m_priority = GetTilePriority(tile->GetTileKey(), it->m_indexOnly);
+
+  StartPendingTasks();
+}
+
+void ReadManager::StartPendingTasks()
+{
+  while (!m_isStopped && m_runningTasks < m_readCount && !m_pendingTasks.empty())
+  {
+    auto const it = min_element(m_pendingTasks.begin(), m_pendingTasks.end(),
+                                [](PendingTask const & l, PendingTask const & r)
+                                {
+                                  return l.m_priority < r.m_priority;
+                                });
+    ReadMWMTask * task = myPool.Get();
+    task->Init(it->m_tile, it->m_indexOnly);
+    swap(*it, m_pendingTasks.back());
+    m_pendingTasks.pop_back();
+
+    ++m_runningTasks;
+    m_pool->PushBack(task);
+  }
+}
+
+void ReadManager::RemovePendingTask(tileinfo_ptr const & tile)
+{
+  lock_guard<mutex> lock(m_pendingMutex);
+  m_pendingTasks.erase(remove_if(m_pendingTasks.begin(), m_pendingTasks.end(),
+                                 [&tile](PendingTask const & task) { return task.m_tile == tile; }),
+                       m_pendingTasks.end());
+}
+
+void ReadManager::ClearPendingTasks()
+{
+  lock_guard<mutex> lock(m_pendingMutex);
+  m_pendingTasks.clear();
+}
+
+void ReadManager::UpdatePendingPriorities()
+{
+  lock_guard<mutex> lock(m_pendingMutex);
+  for (PendingTask & task : m_pendingTasks)
+    task.m_priority = GetTilePriority(task.m_tile->GetTileKey(), task.m_indexOnly);
+}
+
+void ReadManager::UpdatePrefetchTiles(set<TileKey> const & tiles)
+{
+  set<TileKey> prefetchKeys;
+  m_scheduler.GetPrefetchTiles(tiles, prefetchKeys);
+
+  for (auto it = m_prefetchTiles.begin(); it != m_prefetchTiles.end();)
+  {
+    if (prefetchKeys.count(it->first) == 0)
+    {
+      RemovePendingTask(it->second);
+      CancelTileInfo(it->second);
+      it = m_prefetchTiles.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  for (TileKey const & tileKey : prefetchKeys)
+  {
+    if (m_prefetchTiles.count(tileKey) != 0)
+      continue;
+    tileinfo_ptr tileInfo(new TileInfo(tileKey));
+    m_prefetchTiles.insert(make_pair(tileKey, tileInfo));
+    ScheduleTile(tileInfo, true /* indexOnly */);
+  }
+}
+
+double ReadManager::GetTilePriority(TileKey const & tileKey, bool indexOnly) const
+{
+  double const priority = m_scheduler.GetPriority(tileKey);
+  return indexOnly ? priority + TileScheduler::kPrefetchPriority : priority;
 }
 
 void ReadManager::CancelTileInfo(tileinfo_ptr const & tileToCancel)
@@ -142,6 +313,7 @@ void ReadManager::CancelTileInfo(tileinfo_ptr const & tileToCancel)
 
 void ReadManager::ClearTileInfo(tileinfo_ptr const & tileToClear)
 {
+  RemovePendingTask(tileToClear);
   CancelTileInfo(tileToClear);
   m_tileInfos.erase(tileToClear);
 }
@@ -4,6 +4,8 @@
 #include "drape_frontend/engine_context.hpp"
 #include "drape_frontend/tile_info.hpp"
 #include "drape_frontend/read_mwm_task.hpp"
+#include "drape_frontend/tile_cache.hpp"
+#include "drape_frontend/tile_scheduler.hpp"
 
 #include "geometry/screenbase.hpp"
 
@@ -11,9 +13,14 @@
 #include "drape/object_pool.hpp"
 
 #include "base/thread_pool.hpp"
+#include "base/timer.hpp"
 
+#include "std/map.hpp"
+#include "std/mutex.hpp"
 #include "std/set.hpp"
 #include "std/shared_ptr.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
 
 namespace df
 {
@@ -41,6 +48,17 @@ private:
   void PushTaskBackForTileKey(TileKey const & tileKey);
   void PushTaskFront(tileinfo_ptr const & tileToReread);
 
+  /// Adds the tile to the pending tasks or updates the priority of its pending task.
+  void ScheduleTile(tileinfo_ptr const & tile, bool indexOnly);
+  /// Starts the most urgent pending tasks while there are free reading threads.
+  /// m_pendingMutex must be locked.
+  void StartPendingTasks();
+  void RemovePendingTask(tileinfo_ptr const & tile);
+  void ClearPendingTasks();
+  void UpdatePendingPriorities();
+  void UpdatePrefetchTiles(set<TileKey> const & tiles);
+  double GetTilePriority(TileKey const & tileKey, bool indexOnly) const;
+
 private:
   MemoryFeatureIndex m_memIndex;
   EngineContext & m_context;
@@ -62,8 +80,33 @@ private:
   typedef set<tileinfo_ptr, LessByTileKey> tile_set_t;
   tile_set_t m_tileInfos;
 
+  // It's null when the cache directory can't be created.
+  unique_ptr<TileCache> m_tileCache;
+  FeatureShapesCache m_shapesCache;
   ObjectPool<ReadMWMTask, ReadMWMTaskFactory> myPool;
 
+  TileScheduler m_scheduler;
+  my::Timer m_timer;
+
+  struct PendingTask
+  {
+    tileinfo_ptr m_tile;
+    double m_priority;
+    bool m_indexOnly;
+  };
+
+  // The pool reads tasks in FIFO order, so it gets only as many tasks as there are threads
+  // and the rest waits here to be started in the order of priorities. The finished tasks start
+  // the next ones from the reading threads, that's why these fields are guarded by the mutex.
+  mutex m_pendingMutex;
+  vector<PendingTask> m_pendingTasks;
+  size_t m_runningTasks;
+  size_t const m_readCount;
+  bool m_isStopped;
+
+  // Tiles ahead of the screen motion which feature index is read in advance.
+  map<TileKey, tileinfo_ptr> m_prefetchTiles;
+
   void CancelTileInfo(tileinfo_ptr const & tileToCancel);
   void ClearTileInfo(tileinfo_ptr const & tileToClear);
 };
@@ -1,23 +1,33 @@
 #include "drape_frontend/read_mwm_task.hpp"
 
+#include "base/scope_guard.hpp"
+#include "base/tracing.hpp"
+
+#include "std/bind.hpp"
+
 #include "std/shared_ptr.hpp"
 
 namespace df
 {
 ReadMWMTask::ReadMWMTask(MemoryFeatureIndex & memIndex, MapDataProvider & model,
-                         EngineContext & context)
-  : m_memIndex(memIndex)
+                         EngineContext & context, TileCache * cache,
+                         FeatureShapesCache * shapesCache)
+  : m_indexOnly(false)
+  , m_memIndex(memIndex)
   , m_model(model)
   , m_context(context)
+  , m_cache(cache)
+  , m_shapesCache(shapesCache)
 {
 #ifdef DEBUG
   m_checker = false;
 #endif
 }
 
-void ReadMWMTask::Init(weak_ptr<TileInfo> const & tileInfo)
+void ReadMWMTask::Init(weak_ptr<TileInfo> const & tileInfo, bool indexOnly)
 {
   m_tileInfo = tileInfo;
+  m_indexOnly = indexOnly;
 #ifdef DEBUG
   m_checker = true;
 #endif
@@ -32,6 +42,7 @@ void ReadMWMTask::Reset()
 
 void ReadMWMTask::Do()
 {
+  TRACE_SCOPE("drape", "ReadMWMTask::Do");
 #ifdef DEBUG
   ASSERT(m_checker, ());
 #endif
@@ -39,10 +50,12 @@ void ReadMWMTask::Do()
   if (tileInfo == NULL)
     return;
 
+  MY_SCOPE_GUARD(clearArena, bind(&my::Arena::Clear, &m_arena));
   try
   {
     tileInfo->ReadFeatureIndex(m_model);
-    tileInfo->ReadFeatures(m_model, m_memIndex, m_context);
+    if (!m_indexOnly)
+      tileInfo->ReadFeatures(m_model, m_memIndex, m_context, m_arena, m_cache, m_shapesCache);
   }
   catch (TileInfo::ReadCanceledException & ex)
   {
@@ -2,6 +2,7 @@
 
 #include "drape_frontend/tile_info.hpp"
 
+#include "base/arena.hpp"
 #include "base/thread.hpp"
 
 #ifdef DEBUG
@@ -14,24 +15,35 @@ namespace df
 {
 
 class EngineContext;
+class TileCache;
+class FeatureShapesCache;
 
 class ReadMWMTask : public threads::IRoutine
 {
 public:
   ReadMWMTask(MemoryFeatureIndex & memIndex,
               MapDataProvider & model,
-              EngineContext & context);
+              EngineContext & context,
+              TileCache * cache,
+              FeatureShapesCache * shapesCache);
 
   virtual void Do();
 
-  void Init(weak_ptr<TileInfo> const & tileInfo);
+  /// @param indexOnly Read only the feature index of the tile, e.g. to prefetch it.
+  void Init(weak_ptr<TileInfo> const & tileInfo, bool indexOnly = false);
   void Reset();
 
 private:
   weak_ptr<TileInfo> m_tileInfo;
+  bool m_indexOnly;
   MemoryFeatureIndex & m_memIndex;
   MapDataProvider & m_model;
   EngineContext & m_context;
+  TileCache * m_cache;
+  FeatureShapesCache * m_shapesCache;
+
+  // Temporary objects of the tile, the tasks are reused, so are the arena blocks.
+  my::Arena m_arena;
 
 #ifdef DEBUG
   dbg::ObjectTracker m_objTracker;
@@ -44,20 +56,26 @@ class ReadMWMTaskFactory
 public:
   ReadMWMTaskFactory(MemoryFeatureIndex & memIndex,
                      MapDataProvider & model,
-                     EngineContext & context)
+                     EngineContext & context,
+                     TileCache * cache,
+                     FeatureShapesCache * shapesCache)
     : m_memIndex(memIndex)
     , m_model(model)
-    , m_context(context) {}
+    , m_context(context)
+    , m_cache(cache)
+    , m_shapesCache(shapesCache) {}
 
   ReadMWMTask * GetNew() const
   {
-    return new ReadMWMTask(m_memIndex, m_model, m_context);
+    return new ReadMWMTask(m_memIndex, m_model, m_context, m_cache, m_shapesCache);
   }
 
 private:
   MemoryFeatureIndex & m_memIndex;
   MapDataProvider & m_model;
   EngineContext & m_context;
+  TileCache * m_cache;
+  FeatureShapesCache * m_shapesCache;
 };
 
 } // namespace df
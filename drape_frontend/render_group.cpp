@@ -34,11 +34,18 @@ void RenderGroup::CollectOverlay(dp::RefPointer<dp::OverlayTree> tree)
                                                                 tree));
 }
 
-void RenderGroup::Render(ScreenBase const & screen)
+uint32_t RenderGroup::Render(ScreenBase const & screen, m2::AnyRectD const & clipRect)
 {
   ASSERT(m_pendingOnDelete == false, ());
-  for_each(m_renderBuckets.begin(), m_renderBuckets.end(), bind(&dp::RenderBucket::Render,
-                                                                bind(&dp::NonConstGetter<dp::RenderBucket>, _1), screen));
+  uint32_t culledCount = 0;
+  for (dp::MasterPointer<dp::RenderBucket> & bucket : m_renderBuckets)
+  {
+    if (bucket->IsCulled(clipRect))
+      ++culledCount;
+    else
+      bucket->Render(screen);
+  }
+  return culledCount;
 }
 
 void RenderGroup::PrepareForAdd(size_t countForAdd)
@@ -51,6 +58,15 @@ void RenderGroup::AddBucket(dp::TransferPointer<dp::RenderBucket> bucket)
   m_renderBuckets.push_back(dp::MasterPointer<dp::RenderBucket>(bucket));
 }
 
+void RenderGroup::MergeGroup(RenderGroup & other)
+{
+  ASSERT(m_state == other.m_state && m_tileKey == other.m_tileKey, ());
+  PrepareForAdd(other.m_renderBuckets.size());
+  for (dp::MasterPointer<dp::RenderBucket> & bucket : other.m_renderBuckets)
+    AddBucket(bucket.Move());
+  other.m_renderBuckets.clear();
+}
+
 bool RenderGroup::IsLess(RenderGroup const & other) const
 {
   return m_state < other.m_state;
@@ -90,7 +106,11 @@ bool RenderBucketComparator::operator()(RenderGroup const * l, RenderGroup const
     m_needGroupMergeOperation = true;
 
   if (rPendingOnDelete == lPendingOnDelete)
-    return lState < rState;
+  {
+    if (!(lState == rState))
+      return lState < rState;
+    return lKey < rKey;
+  }
 
   if (rPendingOnDelete)
     return true;
@@ -23,10 +23,14 @@ public:
 
   void Update(ScreenBase const & modelView);
   void CollectOverlay(dp::RefPointer<dp::OverlayTree> tree);
-  void Render(ScreenBase const & screen);
+  /// Buckets out of clipRect aren't rendered.
+  /// @return Number of the skipped buckets.
+  uint32_t Render(ScreenBase const & screen, m2::AnyRectD const & clipRect);
 
   void PrepareForAdd(size_t countForAdd);
   void AddBucket(dp::TransferPointer<dp::RenderBucket> bucket);
+  /// Takes the buckets of the group with the same state and tile, the other group becomes empty.
+  void MergeGroup(RenderGroup & other);
 
   dp::GLState const & GetState() const { return m_state; }
   TileKey const & GetTileKey() const { return m_tileKey; }
@@ -52,8 +56,12 @@ public:
 
   void ResetInternalState();
 
+  /// Groups are sorted by the state, then by the tile, groups to delete go last.
   bool operator()(RenderGroup const * l, RenderGroup const * r);
 
+  /// There are groups of the same state and tile, which could be merged after sorting.
+  bool NeedGroupMergeOperation() const { return m_needGroupMergeOperation; }
+
 private:
   set<TileKey> const & m_activeTiles;
   bool m_needGroupMergeOperation;
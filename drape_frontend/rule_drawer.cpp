@@ -13,10 +13,13 @@
 namespace df
 {
 
-RuleDrawer::RuleDrawer(drawer_callback_fn const & fn, TileKey const & tileKey, EngineContext & context)
+RuleDrawer::RuleDrawer(drawer_callback_fn const & fn, TileKey const & tileKey, EngineContext & context,
+                       my::Arena & arena)
   : m_callback(fn)
   , m_tileKey(tileKey)
   , m_context(context)
+  , m_coastlines(less<string>(), my::ArenaAllocator<string>(arena))
+  , m_isLastFeatureTileDependent(false)
 {
   m_globalRect = m_tileKey.GetGlobalRect();
 
@@ -29,11 +32,13 @@ RuleDrawer::RuleDrawer(drawer_callback_fn const & fn, TileKey const & tileKey, E
 void RuleDrawer::operator()(FeatureType const & f)
 {
   Stylist s;
+  m_isLastFeatureTileDependent = false;
   m_callback(f, s);
 
   if (s.IsEmpty())
     return;
 
+  m_isLastFeatureTileDependent = s.IsCoastLine();
   if (s.IsCoastLine() && (!m_coastlines.insert(s.GetCaptionDescription().GetMainText()).second))
     return;
 
@@ -64,6 +69,7 @@ void RuleDrawer::operator()(FeatureType const & f)
                            s.GetCaptionDescription(),
                            m_currentScaleGtoP);
     f.ForEachPointRef(apply, m_tileKey.m_zoomLevel);
+    apply.SimplifyGeometry();
 
     if (apply.HasGeometry())
       s.ForEachRule(bind(&ApplyLineFeature::ProcessRule, &apply, _1));
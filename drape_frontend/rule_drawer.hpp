@@ -5,6 +5,8 @@
 #include "geometry/rect2d.hpp"
 #include "geometry/screenbase.hpp"
 
+#include "base/arena.hpp"
+
 #include "std/function.hpp"
 #include "std/set.hpp"
 #include "std/string.hpp"
@@ -21,12 +23,18 @@ typedef function<void (FeatureType const &, Stylist &)> drawer_callback_fn;
 class RuleDrawer
 {
 public:
+  /// @param arena Temporary objects of the tile, it must outlive the drawer.
   RuleDrawer(drawer_callback_fn const & fn,
              TileKey const & tileKey,
-             EngineContext & context);
+             EngineContext & context,
+             my::Arena & arena);
 
   void operator() (FeatureType const & f);
 
+  /// Coastlines of the same name are drawn once per tile, so the shapes of such a feature
+  /// depend on the other features of the tile.
+  bool IsLastFeatureTileDependent() const { return m_isLastFeatureTileDependent; }
+
 private:
   drawer_callback_fn m_callback;
   TileKey m_tileKey;
@@ -34,7 +42,8 @@ private:
   m2::RectD m_globalRect;
   ScreenBase m_geometryConvertor;
   double m_currentScaleGtoP;
-  set<string> m_coastlines;
+  set<string, less<string>, my::ArenaAllocator<string>> m_coastlines;
+  bool m_isLastFeatureTileDependent;
 };
 
 } // namespace dfo
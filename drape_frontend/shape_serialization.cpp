@@ -0,0 +1,31 @@
+#include "drape_frontend/shape_serialization.hpp"
+
+#include "drape_frontend/area_shape.hpp"
+#include "drape_frontend/circle_shape.hpp"
+#include "drape_frontend/line_shape.hpp"
+#include "drape_frontend/path_symbol_shape.hpp"
+#include "drape_frontend/path_text_shape.hpp"
+#include "drape_frontend/poi_symbol_shape.hpp"
+#include "drape_frontend/text_shape.hpp"
+
+namespace df
+{
+
+MapShape * DeserializeShape(FeatureID const & id, TShapeSource & src)
+{
+  uint8_t type;
+  ReadShapeValue(src, type);
+  switch (type)
+  {
+  case MapShape::AreaType: return AreaShape::Deserialize(id, src);
+  case MapShape::CircleType: return CircleShape::Deserialize(id, src);
+  case MapShape::LineType: return LineShape::Deserialize(id, src);
+  case MapShape::PathSymbolType: return PathSymbolShape::Deserialize(id, src);
+  case MapShape::PathTextType: return PathTextShape::Deserialize(id, src);
+  case MapShape::PoiSymbolType: return PoiSymbolShape::Deserialize(id, src);
+  case MapShape::TextType: return TextShape::Deserialize(id, src);
+  }
+  MYTHROW(UnknownShapeException, ("Unknown shape type", static_cast<int>(type)));
+}
+
+} // namespace df
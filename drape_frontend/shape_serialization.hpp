@@ -0,0 +1,128 @@
+#pragma once
+
+#include "drape_frontend/map_shape.hpp"
+#include "drape_frontend/shape_view_params.hpp"
+
+#include "drape/color.hpp"
+
+#include "geometry/spline.hpp"
+
+#include "coding/read_write_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/exception.hpp"
+
+#include "std/string.hpp"
+#include "std/type_traits.hpp"
+#include "std/vector.hpp"
+
+/// Helpers to write shapes into TileCache. The cache is local for the device,
+/// so plain values are written in the native byte order.
+namespace df
+{
+
+template <typename T>
+void WriteShapeValue(Writer & writer, T const & value)
+{
+  static_assert(is_arithmetic<T>::value, "");
+  writer.Write(&value, sizeof(value));
+}
+
+template <typename T>
+void ReadShapeValue(TShapeSource & src, T & value)
+{
+  static_assert(is_arithmetic<T>::value, "");
+  src.Read(&value, sizeof(value));
+}
+
+template <typename T>
+void WriteShapeValue(Writer & writer, m2::Point<T> const & pt)
+{
+  WriteShapeValue(writer, pt.x);
+  WriteShapeValue(writer, pt.y);
+}
+
+template <typename T>
+void ReadShapeValue(TShapeSource & src, m2::Point<T> & pt)
+{
+  ReadShapeValue(src, pt.x);
+  ReadShapeValue(src, pt.y);
+}
+
+inline void WriteShapeValue(Writer & writer, string const & value) { rw::Write(writer, value); }
+inline void ReadShapeValue(TShapeSource & src, string & value) { rw::Read(src, value); }
+
+inline void WriteShapeValue(Writer & writer, dp::Color const & color)
+{
+  uint8_t const rgba[] = {color.GetRed(), color.GetGreen(), color.GetBlue(), color.GetAlfa()};
+  writer.Write(rgba, sizeof(rgba));
+}
+
+inline void ReadShapeValue(TShapeSource & src, dp::Color & color)
+{
+  uint8_t rgba[4];
+  src.Read(rgba, sizeof(rgba));
+  color = dp::Color(rgba[0], rgba[1], rgba[2], rgba[3]);
+}
+
+template <typename TEnum>
+void WriteShapeEnum(Writer & writer, TEnum value)
+{
+  WriteShapeValue(writer, static_cast<int32_t>(value));
+}
+
+template <typename TEnum>
+void ReadShapeEnum(TShapeSource & src, TEnum & value)
+{
+  int32_t v;
+  ReadShapeValue(src, v);
+  value = static_cast<TEnum>(v);
+}
+
+inline void WriteShapeValue(Writer & writer, FontDecl const & font)
+{
+  WriteShapeValue(writer, font.m_color);
+  WriteShapeValue(writer, font.m_outlineColor);
+  WriteShapeValue(writer, font.m_size);
+}
+
+inline void ReadShapeValue(TShapeSource & src, FontDecl & font)
+{
+  ReadShapeValue(src, font.m_color);
+  ReadShapeValue(src, font.m_outlineColor);
+  ReadShapeValue(src, font.m_size);
+}
+
+/// Vectors of points are written as is.
+template <typename T>
+void WriteShapeValue(Writer & writer, vector<T> const & values)
+{
+  rw::WriteVectorOfPOD(writer, values);
+}
+
+template <typename T>
+void ReadShapeValue(TShapeSource & src, vector<T> & values)
+{
+  rw::ReadVectorOfPOD(src, values);
+}
+
+inline void WriteShapeValue(Writer & writer, m2::SharedSpline const & spline)
+{
+  WriteShapeValue(writer, spline->GetPath());
+}
+
+inline void ReadShapeValue(TShapeSource & src, m2::SharedSpline & spline)
+{
+  vector<m2::PointD> path;
+  ReadShapeValue(src, path);
+  spline.Reset(path);
+}
+
+DECLARE_EXCEPTION(UnknownShapeException, RootException);
+
+/// Reads the shape written by MapShape::Serialize().
+/// @param id Feature of the shape in the current set of mwms.
+MapShape * DeserializeShape(FeatureID const & id, TShapeSource & src);
+
+} // namespace df
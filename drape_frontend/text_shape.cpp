@@ -1,4 +1,5 @@
 #include "drape_frontend/text_shape.hpp"
+#include "drape_frontend/shape_serialization.hpp"
 #include "drape_frontend/text_layout.hpp"
 
 #include "drape/utils/vertex_decl.hpp"
@@ -150,4 +151,32 @@ void TextShape::DrawSubString(StraightTextLayout const & layout,
   batcher->InsertListOfStrip(state, dp::MakeStackRefPointer(&provider), dp::MovePointer(handle), 4);
 }
 
+void TextShape::Serialize(Writer & writer) const
+{
+  WriteShapeValue(writer, static_cast<uint8_t>(TextType));
+  WriteShapeValue(writer, m_basePoint);
+  WriteShapeValue(writer, m_params.m_depth);
+  WriteShapeValue(writer, m_params.m_primaryTextFont);
+  WriteShapeValue(writer, m_params.m_primaryText);
+  WriteShapeValue(writer, m_params.m_secondaryTextFont);
+  WriteShapeValue(writer, m_params.m_secondaryText);
+  WriteShapeEnum(writer, m_params.m_anchor);
+}
+
+// static
+TextShape * TextShape::Deserialize(FeatureID const & id, TShapeSource & src)
+{
+  m2::PointF basePoint;
+  TextViewParams params;
+  params.m_featureID = id;
+  ReadShapeValue(src, basePoint);
+  ReadShapeValue(src, params.m_depth);
+  ReadShapeValue(src, params.m_primaryTextFont);
+  ReadShapeValue(src, params.m_primaryText);
+  ReadShapeValue(src, params.m_secondaryTextFont);
+  ReadShapeValue(src, params.m_secondaryText);
+  ReadShapeEnum(src, params.m_anchor);
+  return new TextShape(basePoint, params);
+}
+
 } //end of df namespace
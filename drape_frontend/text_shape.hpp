@@ -17,6 +17,10 @@ public:
   TextShape(m2::PointF const & basePoint, TextViewParams const & params);
 
   void Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const;
+  void Serialize(Writer & writer) const;
+
+  static TextShape * Deserialize(FeatureID const & id, TShapeSource & src);
+
 private:
   void DrawSubString(StraightTextLayout const & layout, df::FontDecl const & font,
                      glsl::vec2 const & baseOffset, dp::RefPointer<dp::Batcher> batcher,
@@ -0,0 +1,280 @@
+#include "drape_frontend/tile_cache.hpp"
+#include "drape_frontend/shape_serialization.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+
+namespace df
+{
+
+namespace
+{
+
+// Strings and counts of the file mustn't exceed the rest of it.
+uint32_t ReadCount(TShapeSource & src)
+{
+  uint32_t const count = ReadVarUint<uint32_t>(src);
+  if (count > src.Size())
+    MYTHROW(Reader::SizeException, ("Broken tile cache file", count, src.Size()));
+  return count;
+}
+
+void ReadBlob(TShapeSource & src, string & blob)
+{
+  blob.resize(ReadCount(src));
+  if (!blob.empty())
+    src.Read(&blob[0], blob.size());
+}
+
+} // namespace
+
+// static
+uint8_t const TileCache::kVersion;
+
+void TileCache::Tile::SetShapes(FeatureID const & id, string && shapes)
+{
+  m_mwms[GetMwmKey(id)][id.m_index] = move(shapes);
+}
+
+bool TileCache::Tile::ForEachShape(FeatureID const & id, TShapeFn const & toDo) const
+{
+  auto const mwmIt = m_mwms.find(GetMwmKey(id));
+  if (mwmIt == m_mwms.end())
+    return false;
+  auto const it = mwmIt->second.find(id.m_index);
+  if (it == mwmIt->second.end())
+    return false;
+
+  TileCache::ForEachShape(id, it->second, toDo);
+  return true;
+}
+
+// static
+TileCache::Tile::TMwmKey TileCache::Tile::GetMwmKey(FeatureID const & id)
+{
+  shared_ptr<MwmInfo> const & info = id.m_mwmId.GetInfo();
+  ASSERT(info, (id));
+  return info ? TMwmKey(info->GetCountryName(), info->GetVersion()) : TMwmKey();
+}
+
+// static
+void TileCache::ForEachShape(FeatureID const & id, string const & shapes, TShapeFn const & toDo)
+{
+  MemReader reader(shapes.data(), shapes.size());
+  TShapeSource src(reader);
+  while (src.Size() > 0)
+    toDo(DeserializeShape(id, src));
+}
+
+TileCache::TileCache(string const & dir, string const & styleKey)
+  : m_dir(dir)
+  , m_styleKey(styleKey)
+{
+}
+
+bool TileCache::Load(TileKey const & key, Tile & tile) const
+{
+  tile.Clear();
+  string const path = GetFilePath(key);
+  if (!Platform::IsFileExistsByFullPath(path))
+    return false;
+
+  try
+  {
+    string data;
+    FileReader(path).ReadAsString(data);
+    MemReader reader(data.data(), data.size());
+    TShapeSource src(reader);
+
+    if (ReadPrimitiveFromSource<uint8_t>(src) != kVersion)
+      return false;
+    string styleKey;
+    ReadBlob(src, styleKey);
+    if (styleKey != m_styleKey)
+      return false;
+
+    uint32_t const mwmsCount = ReadCount(src);
+    for (uint32_t i = 0; i < mwmsCount; ++i)
+    {
+      Tile::TMwmKey mwmKey;
+      ReadBlob(src, mwmKey.first);
+      mwmKey.second = ReadVarInt<int64_t>(src);
+
+      Tile::TFeatures & features = tile.m_mwms[mwmKey];
+      uint32_t const featuresCount = ReadCount(src);
+      uint32_t index = 0;
+      for (uint32_t j = 0; j < featuresCount; ++j)
+      {
+        index += ReadVarUint<uint32_t>(src);
+        ReadBlob(src, features[index]);
+      }
+    }
+    return true;
+  }
+  catch (Reader::Exception const & ex)
+  {
+    LOG(LWARNING, ("Can't load tile cache", path, ex.Msg()));
+    tile.Clear();
+    return false;
+  }
+}
+
+void TileCache::Save(TileKey const & key, Tile const & tile) const
+{
+  string const path = GetFilePath(key);
+  // The file is replaced at once, so it's never read half-written.
+  string const tmpPath = path + ".tmp";
+
+  threads::MutexGuard guard(m_saveMutex);
+  UNUSED_VALUE(guard);
+
+  try
+  {
+    {
+      FileWriter writer(tmpPath);
+      WriteToSink(writer, kVersion);
+      rw::Write(writer, m_styleKey);
+
+      WriteVarUint(writer, static_cast<uint32_t>(tile.m_mwms.size()));
+      for (auto const & mwm : tile.m_mwms)
+      {
+        rw::Write(writer, mwm.first.first);
+        WriteVarInt(writer, mwm.first.second);
+
+        WriteVarUint(writer, static_cast<uint32_t>(mwm.second.size()));
+        uint32_t prevIndex = 0;
+        for (auto const & feature : mwm.second)
+        {
+          WriteVarUint(writer, feature.first - prevIndex);
+          rw::Write(writer, feature.second);
+          prevIndex = feature.first;
+        }
+      }
+    }
+    if (!my::RenameFileX(tmpPath, path))
+      LOG(LWARNING, ("Can't rename tile cache file", tmpPath, "to", path));
+  }
+  catch (Writer::Exception const & ex)
+  {
+    LOG(LWARNING, ("Can't save tile cache", path, ex.Msg()));
+    my::DeleteFileX(tmpPath);
+  }
+}
+
+string TileCache::GetFilePath(TileKey const & key) const
+{
+  return m_dir + strings::to_string(key.m_zoomLevel) + "_" + strings::to_string(key.m_x) + "_" +
+         strings::to_string(key.m_y) + ".tile";
+}
+
+FeatureShapesCache::FeatureShapesCache(size_t maxSize)
+  : m_maxSize(maxSize)
+  , m_size(0)
+{
+}
+
+void FeatureShapesCache::SetShapes(FeatureID const & id, int zoomLevel, string const & shapes)
+{
+  threads::MutexGuard guard(m_mutex);
+  UNUSED_VALUE(guard);
+
+  TKey const key(id, zoomLevel);
+  auto it = m_entries.find(key);
+  if (it != m_entries.end())
+    Erase(it);
+
+  if (shapes.size() > m_maxSize)
+    return;
+
+  m_lru.push_front(key);
+  Entry & entry = m_entries[key];
+  entry.m_shapes = shapes;
+  entry.m_lruIt = m_lru.begin();
+  m_size += shapes.size();
+
+  while (m_size > m_maxSize)
+  {
+    ASSERT(!m_lru.empty(), ());
+    Erase(m_entries.find(m_lru.back()));
+  }
+}
+
+bool FeatureShapesCache::GetShapes(FeatureID const & id, int zoomLevel, string & shapes)
+{
+  threads::MutexGuard guard(m_mutex);
+  UNUSED_VALUE(guard);
+
+  auto const it = m_entries.find(TKey(id, zoomLevel));
+  if (it == m_entries.end())
+    return false;
+
+  m_lru.splice(m_lru.begin(), m_lru, it->second.m_lruIt);
+  shapes = it->second.m_shapes;
+  return true;
+}
+
+void FeatureShapesCache::Clear()
+{
+  threads::MutexGuard guard(m_mutex);
+  UNUSED_VALUE(guard);
+
+  m_entries.clear();
+  m_lru.clear();
+  m_size = 0;
+}
+
+size_t FeatureShapesCache::GetSize() const
+{
+  threads::MutexGuard guard(m_mutex);
+  UNUSED_VALUE(guard);
+
+  return m_size;
+}
+
+void FeatureShapesCache::Erase(map<TKey, Entry>::iterator it)
+{
+  ASSERT(it != m_entries.end(), ());
+  ASSERT_GREATER_OR_EQUAL(m_size, it->second.m_shapes.size(), ());
+  m_size -= it->second.m_shapes.size();
+  m_lru.erase(it->second.m_lruIt);
+  m_entries.erase(it);
+}
+
+TileCacheRecorder::TileCacheRecorder(EngineContext const & context, TFeatureShapesFn const & fn)
+  : EngineContext(context)
+  , m_fn(fn)
+{
+}
+
+void TileCacheRecorder::BeginFeature(FeatureID const & id)
+{
+  m_featureID = id;
+  m_shapes.clear();
+}
+
+void TileCacheRecorder::EndFeature()
+{
+  m_fn(m_featureID, move(m_shapes));
+  m_shapes.clear();
+}
+
+void TileCacheRecorder::InsertShape(TileKey const & key, dp::TransferPointer<MapShape> shape)
+{
+  dp::MasterPointer<MapShape> master(shape);
+  {
+    MemWriter<string> writer(m_shapes);
+    writer.Seek(m_shapes.size());
+    master->Serialize(writer);
+  }
+  EngineContext::InsertShape(key, master.Move());
+}
+
+} // namespace df
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "drape_frontend/engine_context.hpp"
+#include "drape_frontend/map_shape.hpp"
+#include "drape_frontend/tile_key.hpp"
+
+#include "indexer/feature_decl.hpp"
+
+#include "base/mutex.hpp"
+
+#include "std/function.hpp"
+#include "std/list.hpp"
+#include "std/map.hpp"
+#include "std/noncopyable.hpp"
+#include "std/string.hpp"
+#include "std/utility.hpp"
+
+namespace df
+{
+
+/// Persistent cache of the shapes of tiles, so revisited tiles and tiles of the previous runs
+/// don't decode and style features again. Shapes are kept per feature together with the name
+/// and the version of its mwm, hence the features of updated mwms are read again, and the files
+/// of other styles are ignored. Batched geometry isn't cached as glyphs, symbols and colors
+/// get their texture regions at runtime. It's thread safe.
+class TileCache : private noncopyable
+{
+public:
+  /// Version of the files format.
+  static uint8_t const kVersion = 0;
+
+  typedef function<void (MapShape * shape)> TShapeFn;
+
+  /// Cached features of a tile, it's not thread safe.
+  class Tile
+  {
+  public:
+    /// Sets serialized shapes of the feature, the feature may have no shapes.
+    void SetShapes(FeatureID const & id, string && shapes);
+
+    /// @return False when the feature isn't cached, otherwise calls toDo for its new shapes.
+    bool ForEachShape(FeatureID const & id, TShapeFn const & toDo) const;
+
+    bool IsEmpty() const { return m_mwms.empty(); }
+    void Clear() { m_mwms.clear(); }
+
+  private:
+    friend class TileCache;
+
+    // Country name and version of mwm.
+    typedef pair<string, int64_t> TMwmKey;
+    // Serialized shapes of the features by their indices.
+    typedef map<uint32_t, string> TFeatures;
+
+    static TMwmKey GetMwmKey(FeatureID const & id);
+
+    map<TMwmKey, TFeatures> m_mwms;
+  };
+
+  /// Calls toDo for the new shapes deserialized from the string written by TileCacheRecorder.
+  static void ForEachShape(FeatureID const & id, string const & shapes, TShapeFn const & toDo);
+
+  /// @param dir Directory of the files with a trailing slash, it must exist.
+  /// @param styleKey Identifies the style and the visual parameters of the shapes.
+  TileCache(string const & dir, string const & styleKey);
+
+  /// @return False when there is no valid file for the tile of the current style.
+  bool Load(TileKey const & key, Tile & tile) const;
+  void Save(TileKey const & key, Tile const & tile) const;
+
+private:
+  string GetFilePath(TileKey const & key) const;
+
+  string const m_dir;
+  string const m_styleKey;
+  // Saving of the same tile from different threads mustn't mix the files.
+  mutable threads::Mutex m_saveMutex;
+};
+
+/// In-memory cache of the shapes of features which is shared by all the tiles. Shapes of a feature
+/// depend on the zoom level only, so the tiles of zoom steps and the tiles read again after panning
+/// take the features already read for other tiles instead of decoding and styling them again.
+/// The least recently used features are dropped when the shapes exceed the size. It's thread safe.
+class FeatureShapesCache : private noncopyable
+{
+public:
+  /// @param maxSize Size of the serialized shapes in bytes.
+  explicit FeatureShapesCache(size_t maxSize);
+
+  void SetShapes(FeatureID const & id, int zoomLevel, string const & shapes);
+  /// @return False when the feature of the zoom level isn't cached.
+  bool GetShapes(FeatureID const & id, int zoomLevel, string & shapes);
+  void Clear();
+
+  size_t GetSize() const;
+
+private:
+  typedef pair<FeatureID, int> TKey;
+  typedef list<TKey> TLru;
+
+  struct Entry
+  {
+    string m_shapes;
+    TLru::iterator m_lruIt;
+  };
+
+  void Erase(map<TKey, Entry>::iterator it);
+
+  mutable threads::Mutex m_mutex;
+  map<TKey, Entry> m_entries;
+  // The most recently used features go first.
+  TLru m_lru;
+  size_t const m_maxSize;
+  size_t m_size;
+};
+
+/// Context of the tile reading which also serializes the shapes of each read feature.
+class TileCacheRecorder : public EngineContext
+{
+public:
+  typedef function<void (FeatureID const & id, string && shapes)> TFeatureShapesFn;
+
+  /// @param fn Gets the shapes on the end of each feature.
+  TileCacheRecorder(EngineContext const & context, TFeatureShapesFn const & fn);
+
+  void BeginFeature(FeatureID const & id);
+  void EndFeature();
+
+  virtual void InsertShape(TileKey const & key, dp::TransferPointer<MapShape> shape);
+
+private:
+  TFeatureShapesFn m_fn;
+  FeatureID m_featureID;
+  string m_shapes;
+};
+
+} // namespace df
@@ -62,7 +62,10 @@ void TileInfo::ReadFeatureIndex(MapDataProvider const & model)
 
 void TileInfo::ReadFeatures(MapDataProvider const & model,
                             MemoryFeatureIndex & memIndex,
-                            EngineContext & context)
+                            EngineContext & context,
+                            my::Arena & arena,
+                            TileCache * cache,
+                            FeatureShapesCache * shapesCache)
 {
   CheckCanceled();
   vector<size_t> indexes;
@@ -78,11 +81,85 @@ void TileInfo::ReadFeatures(MapDataProvider const & model,
     vector<FeatureID> featuresToRead;
     for_each(indexes.begin(), indexes.end(), IDsAccumulator(featuresToRead, m_featureInfo));
 
-    RuleDrawer drawer(bind(&TileInfo::InitStylist, this, _1 ,_2), m_key, context);
+    if (cache != nullptr || shapesCache != nullptr)
+    {
+      ReadCachedFeatures(model, context, arena, cache, shapesCache, featuresToRead);
+      return;
+    }
+
+    RuleDrawer drawer(bind(&TileInfo::InitStylist, this, _1 ,_2), m_key, context, arena);
     model.ReadFeatures(ref(drawer), featuresToRead);
   }
 }
 
+void TileInfo::ReadCachedFeatures(MapDataProvider const & model, EngineContext & context,
+                                  my::Arena & arena, TileCache * cache, FeatureShapesCache * shapesCache,
+                                  vector<FeatureID> const & featuresToRead)
+{
+  threads::MutexGuard guard(m_cacheMutex);
+  UNUSED_VALUE(guard);
+
+  if (cache != nullptr && m_cachedTile == nullptr)
+  {
+    m_cachedTile.reset(new TileCache::Tile());
+    cache->Load(m_key, *m_cachedTile);
+  }
+
+  auto const insertShape = [this, &context](MapShape * shape)
+  {
+    context.InsertShape(m_key, dp::MovePointer(shape));
+  };
+
+  // Only the features which aren't cached by the tile nor by the other tiles are read.
+  bool isTileChanged = false;
+  vector<FeatureID> missedFeatures;
+  string shapes;
+  for (FeatureID const & id : featuresToRead)
+  {
+    CheckCanceled();
+    if (m_cachedTile != nullptr && m_cachedTile->ForEachShape(id, insertShape))
+      continue;
+
+    if (shapesCache != nullptr && shapesCache->GetShapes(id, m_key.m_zoomLevel, shapes))
+    {
+      TileCache::ForEachShape(id, shapes, insertShape);
+      if (m_cachedTile != nullptr)
+      {
+        m_cachedTile->SetShapes(id, move(shapes));
+        isTileChanged = true;
+      }
+      continue;
+    }
+
+    missedFeatures.push_back(id);
+  }
+
+  if (!missedFeatures.empty())
+  {
+    bool isTileDependent = false;
+    TileCacheRecorder recorder(context, [&](FeatureID const & id, string && shapes)
+    {
+      if (shapesCache != nullptr && !isTileDependent)
+        shapesCache->SetShapes(id, m_key.m_zoomLevel, shapes);
+      if (m_cachedTile != nullptr)
+        m_cachedTile->SetShapes(id, move(shapes));
+    });
+
+    RuleDrawer drawer(bind(&TileInfo::InitStylist, this, _1 ,_2), m_key, recorder, arena);
+    model.ReadFeatures([&recorder, &drawer, &isTileDependent](FeatureType const & f)
+    {
+      recorder.BeginFeature(f.GetID());
+      drawer(f);
+      isTileDependent = drawer.IsLastFeatureTileDependent();
+      recorder.EndFeature();
+    }, missedFeatures);
+    isTileChanged = true;
+  }
+
+  if (cache != nullptr && isTileChanged)
+    cache->Save(m_key, *m_cachedTile);
+}
+
 void TileInfo::Cancel(MemoryFeatureIndex & memIndex)
 {
   m_isCanceled = true;
@@ -2,12 +2,16 @@
 
 #include "drape_frontend/tile_key.hpp"
 #include "drape_frontend/memory_feature_index.hpp"
+#include "drape_frontend/tile_cache.hpp"
 
 #include "indexer/feature_decl.hpp"
 
+#include "base/arena.hpp"
 #include "base/mutex.hpp"
 #include "base/exception.hpp"
 
+#include "std/atomic.hpp"
+#include "std/unique_ptr.hpp"
 #include "std/vector.hpp"
 #include "std/noncopyable.hpp"
 
@@ -28,9 +32,15 @@ public:
   TileInfo(TileKey const & key);
 
   void ReadFeatureIndex(MapDataProvider const & model);
+  /// @param arena Temporary objects of the reading, it's cleared by the caller.
+  /// @param cache Shapes of the cached features aren't built again, it may be null.
+  /// @param shapesCache Features read for other tiles of the zoom level, it may be null.
   void ReadFeatures(MapDataProvider const & model,
                     MemoryFeatureIndex & memIndex,
-                    EngineContext & context);
+                    EngineContext & context,
+                    my::Arena & arena,
+                    TileCache * cache = nullptr,
+                    FeatureShapesCache * shapesCache = nullptr);
   void Cancel(MemoryFeatureIndex & memIndex);
 
   m2::RectD GetGlobalRect() const;
@@ -42,6 +52,9 @@ private:
   void ProcessID(FeatureID const & id);
   void InitStylist(FeatureType const & f, Stylist & s);
   void RequestFeatures(MemoryFeatureIndex & memIndex, vector<size_t> & featureIndexes);
+  void ReadCachedFeatures(MapDataProvider const & model, EngineContext & context,
+                          my::Arena & arena, TileCache * cache, FeatureShapesCache * shapesCache,
+                          vector<FeatureID> const & featuresToRead);
   void CheckCanceled() const;
   bool DoNeedReadIndex() const;
 
@@ -51,8 +64,14 @@ private:
   TileKey m_key;
   vector<FeatureInfo> m_featureInfo;
 
-  bool m_isCanceled;
+  // It's checked by the reading thread for each feature, so the tile's reading stops
+  // as soon as it's canceled without waiting for m_mutex.
+  atomic<bool> m_isCanceled;
   threads::Mutex m_mutex;
+
+  // Loaded on the first reading when the cache is used, guarded by m_cacheMutex.
+  unique_ptr<TileCache::Tile> m_cachedTile;
+  threads::Mutex m_cacheMutex;
 };
 
 } // namespace df
@@ -0,0 +1,35 @@
+#include "drape_frontend/tile_invalidations.hpp"
+
+#include "base/assert.hpp"
+
+namespace df
+{
+
+uint64_t TileInvalidations::Invalidate(set<TileKey> const & tiles)
+{
+  ++m_generation;
+  for (TileKey const & key : tiles)
+    m_tiles[key] = m_generation;
+  return m_generation;
+}
+
+bool TileInvalidations::AcceptBucket(TileKey const & key, uint64_t generation)
+{
+  ASSERT_GREATER_OR_EQUAL(generation, m_flushedGeneration, ());
+  if (generation > m_flushedGeneration)
+  {
+    m_flushedGeneration = generation;
+    for (auto it = m_tiles.begin(); it != m_tiles.end();)
+    {
+      if (it->second <= generation)
+        it = m_tiles.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  // The tiles which are invalidated before the bucket's generation are forgotten above.
+  return m_tiles.find(key) == m_tiles.end();
+}
+
+} // namespace df
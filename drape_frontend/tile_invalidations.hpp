@@ -0,0 +1,38 @@
+#pragma once
+
+#include "drape_frontend/tile_key.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/map.hpp"
+#include "std/set.hpp"
+
+namespace df
+{
+
+/// Generations of the invalidations of the tiles on the frontend. The backend stamps the flushed
+/// buckets with the last generation it has handled, so the buckets of the tiles which were flushed
+/// before their invalidation reached the backend are dropped, even if the frontend gets the
+/// invalidation before them. It's not thread safe.
+class TileInvalidations
+{
+public:
+  /// @return Generation of the invalidation, it's greater than the ones of the previous calls.
+  uint64_t Invalidate(set<TileKey> const & tiles);
+
+  /// The buckets must be passed in the order of their flush, so their generations don't decrease.
+  /// The invalidations which are older than the bucket are forgotten, as no bucket flushed
+  /// before them comes anymore.
+  /// @return False when the bucket of the tile stamped by the generation is flushed before
+  ///         the last invalidation of the tile.
+  bool AcceptBucket(TileKey const & key, uint64_t generation);
+
+  /// @return Number of the tiles whose invalidations aren't handled by the backend yet.
+  size_t GetPendingCount() const { return m_tiles.size(); }
+
+private:
+  uint64_t m_generation = 0;
+  uint64_t m_flushedGeneration = 0;
+  map<TileKey, uint64_t> m_tiles;
+};
+
+} // namespace df
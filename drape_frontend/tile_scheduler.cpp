@@ -0,0 +1,111 @@
+#include "drape_frontend/tile_scheduler.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "std/cmath.hpp"
+
+namespace df
+{
+
+namespace
+{
+
+// The motion is forgotten when the screens are more distant in time.
+double const kMaxScreensInterval = 0.5;
+// Weight of the last measured velocity in the smoothed one.
+double const kVelocityWeight = 0.5;
+// The screen is moving when it passes this part of a tile during the prediction time.
+double const kMinMotion = 0.25;
+// Motion along an axis is ignored when it's less than this part of the whole motion.
+double const kMinAxisMotion = 0.3;
+
+int GetDirection(double motion, double length)
+{
+  if (fabs(motion) < kMinAxisMotion * length)
+    return 0;
+  return motion > 0 ? 1 : -1;
+}
+
+} // namespace
+
+// static
+double constexpr TileScheduler::kPredictionSeconds;
+// static
+double constexpr TileScheduler::kPrefetchPriority;
+
+TileScheduler::TileScheduler()
+  : m_center(0.0, 0.0)
+  , m_velocity(0.0, 0.0)
+  , m_timestamp(0.0)
+  , m_hasScreen(false)
+{
+}
+
+void TileScheduler::UpdateScreen(ScreenBase const & screen, double timestamp)
+{
+  m2::PointD const center = screen.ClipRect().Center();
+  if (m_hasScreen)
+  {
+    double const dt = timestamp - m_timestamp;
+    if (dt > kMaxScreensInterval)
+      m_velocity = m2::PointD(0.0, 0.0);
+    else if (dt > 0.0)
+      m_velocity = m_velocity * (1.0 - kVelocityWeight) + (center - m_center) * (kVelocityWeight / dt);
+  }
+  m_center = center;
+  m_timestamp = timestamp;
+  m_hasScreen = true;
+}
+
+void TileScheduler::ResetMotion()
+{
+  m_velocity = m2::PointD(0.0, 0.0);
+  m_hasScreen = false;
+}
+
+m2::PointD TileScheduler::GetPredictedCenter() const
+{
+  return m_center + m_velocity * kPredictionSeconds;
+}
+
+double TileScheduler::GetPriority(TileKey const & key) const
+{
+  m2::RectD const rect = key.GetGlobalRect();
+  m2::PointD const center = rect.Center();
+  // Without motion it's the distance to the screen center.
+  double const distance = (center.Length(m_center) + center.Length(GetPredictedCenter())) / 2.0;
+  return distance / rect.SizeX();
+}
+
+void TileScheduler::GetPrefetchTiles(set<TileKey> const & tiles, set<TileKey> & result) const
+{
+  result.clear();
+  if (tiles.empty())
+    return;
+
+  m2::PointD const motion = m_velocity * kPredictionSeconds;
+  double const length = motion.Length();
+  if (length < kMinMotion * tiles.begin()->GetGlobalRect().SizeX())
+    return;
+
+  int const dx = GetDirection(motion.x, length);
+  int const dy = GetDirection(motion.y, length);
+  m2::RectD const world = MercatorBounds::FullRect();
+  auto const addTile = [&](TileKey const & key)
+  {
+    if (tiles.count(key) == 0 && world.IsPointInside(key.GetGlobalRect().Center()))
+      result.insert(key);
+  };
+
+  for (TileKey const & key : tiles)
+  {
+    if (dx != 0)
+      addTile(TileKey(key.m_x + dx, key.m_y, key.m_zoomLevel));
+    if (dy != 0)
+      addTile(TileKey(key.m_x, key.m_y + dy, key.m_zoomLevel));
+    if (dx != 0 && dy != 0)
+      addTile(TileKey(key.m_x + dx, key.m_y + dy, key.m_zoomLevel));
+  }
+}
+
+} // namespace df
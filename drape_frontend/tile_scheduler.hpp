@@ -0,0 +1,51 @@
+#pragma once
+
+#include "drape_frontend/tile_key.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/screenbase.hpp"
+
+#include "std/set.hpp"
+
+namespace df
+{
+
+/// Orders the tiles for reading. The tiles which are closer to the screen center and to the
+/// viewport predicted by the motion of the screen are more urgent, so during pans and flings
+/// the tiles ahead of the motion are read before the trailing ones. The motion is estimated
+/// by the history of the screens.
+class TileScheduler
+{
+public:
+  /// The screen center is predicted on this time ahead.
+  static double constexpr kPredictionSeconds = 0.3;
+  /// Priorities of the prefetched tiles are greater than the ones of all visible tiles.
+  static double constexpr kPrefetchPriority = 1.0E6;
+
+  TileScheduler();
+
+  /// Adds the screen to the history.
+  /// @param timestamp Time of the screen in seconds.
+  void UpdateScreen(ScreenBase const & screen, double timestamp);
+  /// Forgets the motion, e.g. when the scale is changed.
+  void ResetMotion();
+
+  /// @return Velocity of the screen center in the global units per second.
+  m2::PointD const & GetVelocity() const { return m_velocity; }
+  m2::PointD GetPredictedCenter() const;
+
+  /// @return Priority of the tile measured in tile sizes, the less is the more urgent.
+  double GetPriority(TileKey const & key) const;
+
+  /// Fills |result| with the ring of tiles around |tiles| ahead of the motion,
+  /// it's empty when the screen doesn't move.
+  void GetPrefetchTiles(set<TileKey> const & tiles, set<TileKey> & result) const;
+
+private:
+  m2::PointD m_center;
+  m2::PointD m_velocity;
+  double m_timestamp;
+  bool m_hasScreen;
+};
+
+} // namespace df
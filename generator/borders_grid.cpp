@@ -0,0 +1,114 @@
+#include "generator/borders_grid.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+
+namespace
+{
+// Cells closer than kEps to a border are checked exactly, it's much greater than the precision
+// of Region::Contains().
+double constexpr kEps = 1.0E-7;
+}  // namespace
+
+namespace borders
+{
+// static
+size_t constexpr RegionsGrid::kCellsCount;
+
+RegionsGrid::RegionsGrid(RegionsContainerT const & regions)
+{
+  regions.ForEach([this](Region const & region)
+  {
+    m_rect.Add(region.GetRect());
+  });
+  if (regions.IsEmpty())
+    return;
+
+  m_rect.Inflate(kEps, kEps);
+  m_cellWidth = m_rect.SizeX() / kCellsCount;
+  m_cellHeight = m_rect.SizeY() / kCellsCount;
+  m_cells = vector<atomic<uint8_t>>(kCellsCount * kCellsCount);
+
+  regions.ForEach([this](Region const & region)
+  {
+    size_t const count = region.GetPointsCount();
+    auto const begin = region.Begin();
+    for (size_t i = 0; i < count; ++i)
+      MarkBorder(*(begin + i), *(begin + (i + 1) % count));
+  });
+}
+
+bool RegionsGrid::Contains(RegionsContainerT const & regions, m2::PointD const & pt) const
+{
+  if (m_cells.empty() || !m_rect.IsPointInside(pt))
+    return false;
+
+  size_t const x = GetCellX(pt.x);
+  size_t const y = GetCellY(pt.y);
+  atomic<uint8_t> & cell = m_cells[y * kCellsCount + x];
+  uint8_t state = cell.load(memory_order_relaxed);
+  if (state == Border)
+    return ContainsExactly(regions, pt);
+
+  if (state == Unknown)
+  {
+    // All the points of the cell are inside or outside, the center is as good as any other point.
+    m2::PointD const center(m_rect.minX() + (x + 0.5) * m_cellWidth,
+                            m_rect.minY() + (y + 0.5) * m_cellHeight);
+    state = ContainsExactly(regions, center) ? Inside : Outside;
+    // Concurrent threads calculate the same state.
+    cell.store(state, memory_order_relaxed);
+  }
+  return state == Inside;
+}
+
+// static
+bool RegionsGrid::ContainsExactly(RegionsContainerT const & regions, m2::PointD const & pt)
+{
+  bool contains = false;
+  regions.ForEachInRect(m2::RectD(pt, pt), [&contains, &pt](Region const & region)
+  {
+    if (!contains)
+      contains = region.Contains(pt);
+  });
+  return contains;
+}
+
+size_t RegionsGrid::GetCellX(double x) const
+{
+  double const cell = floor((x - m_rect.minX()) / m_cellWidth);
+  return static_cast<size_t>(my::clamp(cell, 0.0, static_cast<double>(kCellsCount - 1)));
+}
+
+size_t RegionsGrid::GetCellY(double y) const
+{
+  double const cell = floor((y - m_rect.minY()) / m_cellHeight);
+  return static_cast<size_t>(my::clamp(cell, 0.0, static_cast<double>(kCellsCount - 1)));
+}
+
+void RegionsGrid::MarkBorder(m2::PointD const & p1, m2::PointD const & p2)
+{
+  // The edge is split into parts shorter than a half of a cell, so the bounding rects
+  // of the parts don't cover much more cells than the edge crosses.
+  m2::PointD const d = p2 - p1;
+  size_t const partsCount =
+      static_cast<size_t>(ceil(2 * max(fabs(d.x) / m_cellWidth, fabs(d.y) / m_cellHeight))) + 1;
+
+  for (size_t i = 0; i < partsCount; ++i)
+  {
+    m2::RectD rect(p1 + d * (static_cast<double>(i) / partsCount),
+                   p1 + d * (static_cast<double>(i + 1) / partsCount));
+    rect.Inflate(kEps, kEps);
+
+    size_t const maxX = GetCellX(rect.maxX());
+    size_t const maxY = GetCellY(rect.maxY());
+    for (size_t y = GetCellY(rect.minY()); y <= maxY; ++y)
+    {
+      for (size_t x = GetCellX(rect.minX()); x <= maxX; ++x)
+        m_cells[y * kCellsCount + x].store(Border, memory_order_relaxed);
+    }
+  }
+}
+}  // namespace borders
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+#include "geometry/region2d.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "base/macros.hpp"
+
+#include "std/atomic.hpp"
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+namespace borders
+{
+typedef m2::RegionD Region;
+typedef m4::Tree<Region> RegionsContainerT;
+
+/// RegionsGrid speeds up point-in-country tests. The bounding rect of the regions is split into
+/// kCellsCount x kCellsCount cells. Points of the cells crossed by a border are checked exactly,
+/// the answer is the same for all points of any other cell, it's calculated once and cached.
+class RegionsGrid
+{
+public:
+  static size_t constexpr kCellsCount = 256;
+
+  explicit RegionsGrid(RegionsContainerT const & regions);
+
+  /// @param regions The same regions the grid was made of.
+  /// @note Thread-safe.
+  bool Contains(RegionsContainerT const & regions, m2::PointD const & pt) const;
+
+  static bool ContainsExactly(RegionsContainerT const & regions, m2::PointD const & pt);
+
+private:
+  enum CellState : uint8_t
+  {
+    Unknown = 0,
+    Inside,
+    Outside,
+    Border
+  };
+
+  size_t GetCellX(double x) const;
+  size_t GetCellY(double y) const;
+  void MarkBorder(m2::PointD const & p1, m2::PointD const & p2);
+
+  m2::RectD m_rect;
+  double m_cellWidth = 0;
+  double m_cellHeight = 0;
+  mutable vector<atomic<uint8_t>> m_cells;
+
+  DISALLOW_COPY_AND_MOVE(RegionsGrid);
+};
+}  // namespace borders
@@ -5,6 +5,7 @@
 
 #include "platform/platform.hpp"
 
+#include "storage/countries_grid.hpp"
 #include "storage/country_polygon.hpp"
 
 #include "indexer/geometry_serialization.hpp"
@@ -17,6 +18,8 @@
 #include "coding/file_container.hpp"
 #include "coding/read_write_utils.hpp"
 #include "coding/file_name_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
 
 #include "base/logging.hpp"
 #include "base/string_utils.hpp"
@@ -58,6 +61,7 @@ public:
     if (!m_polygons.IsEmpty())
     {
       ASSERT_NOT_EQUAL ( m_rect, m2::RectD::GetEmptyRect(), () );
+      m_polygons.m_grid = make_shared<RegionsGrid>(m_polygons.m_regions);
       m_countries.Add(m_polygons, m_rect);
     }
 
@@ -105,6 +109,7 @@ class PackedBordersGenerator
   FilesContainerW m_writer;
 
   vector<storage::CountryDef> m_polys;
+  storage::CountriesGrid m_grid;
 
 public:
   PackedBordersGenerator(string const & baseDir)
@@ -124,6 +129,7 @@ public:
       rect.Add(border.GetRect());
 
     // store polygon info
+    size_t const id = m_polys.size();
     m_polys.push_back(storage::CountryDef(name, rect));
 
     // write polygons as paths
@@ -142,7 +148,16 @@ public:
       SimplifyNearOptimal(20, in.begin(), in.end(), eps, dist,
                           AccumulateSkipSmallTrg<DistanceT, m2::PointD>(dist, out, eps));
 
-      serial::SaveOuterPath(out, cp, w);
+      vector<char> buffer;
+      MemWriter<vector<char>> bufferWriter(buffer);
+      serial::SaveOuterPath(out, cp, bufferWriter);
+      w.Write(buffer.data(), buffer.size());
+
+      // The grid is built by the decoded points exactly as they are read by CountryInfoGetter.
+      VectorT decoded;
+      ReaderSource<MemReader> src(MemReader(buffer.data(), buffer.size()));
+      serial::LoadOuterPath(src, cp, decoded);
+      m_grid.AddRegion(id, m2::RegionD(decoded.begin(), decoded.end()));
     }
   }
 
@@ -150,8 +165,14 @@ public:
 
   void WritePolygonsInfo()
   {
-    FileWriter w = m_writer.GetWriter(PACKED_POLYGONS_INFO_TAG);
-    rw::Write(w, m_polys);
+    {
+      FileWriter w = m_writer.GetWriter(PACKED_POLYGONS_INFO_TAG);
+      rw::Write(w, m_polys);
+    }
+
+    m_grid.Finish();
+    FileWriter w = m_writer.GetWriter(PACKED_POLYGONS_GRID_TAG);
+    m_grid.Serialize(w);
   }
 };
 
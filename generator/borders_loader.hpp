@@ -1,8 +1,8 @@
 #pragma once
 
-#include "geometry/region2d.hpp"
-#include "geometry/tree4d.hpp"
+#include "generator/borders_grid.hpp"
 
+#include "std/shared_ptr.hpp"
 #include "std/string.hpp"
 
 #define BORDERS_DIR "borders/"
@@ -10,9 +10,6 @@
 
 namespace borders
 {
-  typedef m2::RegionD Region;
-  typedef m4::Tree<Region> RegionsContainerT;
-
   struct CountryPolygons
   {
     CountryPolygons(string const & name = "") : m_name(name), m_index(-1) {}
@@ -21,11 +18,22 @@ namespace borders
     void Clear()
     {
       m_regions.Clear();
+      m_grid.reset();
       m_name.clear();
       m_index = -1;
     }
 
+    /// @note Thread-safe.
+    bool Contains(m2::PointD const & pt) const
+    {
+      if (m_grid)
+        return m_grid->Contains(m_regions, pt);
+      return RegionsGrid::ContainsExactly(m_regions, pt);
+    }
+
     RegionsContainerT m_regions;
+    // Shared by the copies of the polygons, it's filled by the calls of Contains().
+    shared_ptr<RegionsGrid const> m_grid;
     string m_name;
     mutable int m_index;
   };
@@ -0,0 +1,296 @@
+#include "generator/build_manifest.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_name_utils.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "base/logging.hpp"
+#include "base/macros.hpp"
+
+#include "defines.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstdlib.hpp"
+#include "std/unordered_set.hpp"
+
+#include "3party/jansson/myjansson.hpp"
+
+namespace manifest
+{
+namespace
+{
+uint32_t constexpr kVersion = 1;
+char const kOsrmExtension[] = ".osrm";
+
+json_t * ToJSONArray(vector<string> const & values)
+{
+  json_t * array = json_array();
+  for (string const & value : values)
+    json_array_append_new(array, json_string(value.c_str()));
+  return array;
+}
+
+void FromJSONArray(json_t * root, char const * name, vector<string> & values)
+{
+  json_t * array = json_object_get(root, name);
+  if (!json_is_array(array))
+    MYTHROW(ManifestException, ("Missing array", name));
+  values.clear();
+  for (size_t i = 0; i < json_array_size(array); ++i)
+  {
+    char const * value = json_string_value(json_array_get(array, i));
+    if (value == nullptr)
+      MYTHROW(ManifestException, ("Not a string in", name));
+    values.push_back(value);
+  }
+}
+
+string GetString(json_t * root, char const * name)
+{
+  char const * value = json_string_value(json_object_get(root, name));
+  if (value == nullptr)
+    MYTHROW(ManifestException, ("Missing string", name));
+  return value;
+}
+}  // namespace
+
+Job const * Manifest::FindJob(string const & id) const
+{
+  auto const it = find_if(m_jobs.begin(), m_jobs.end(),
+                          [&id](Job const & job) { return job.GetId() == id; });
+  return it == m_jobs.end() ? nullptr : &*it;
+}
+
+vector<string> const & GetSupportedStages()
+{
+  static vector<string> const kStages = {"generate_geometry", "generate_index",
+                                         "generate_search_index", "make_routing",
+                                         "make_cross_section", "make_turns_info"};
+  return kStages;
+}
+
+void MakeJobs(vector<string> const & countries, vector<string> const & stages,
+              feature::GenerateInfo const & info, string const & osrmDir, Manifest & manifest)
+{
+  vector<string> const & supported = GetSupportedStages();
+  vector<string> sorted;
+  for (string const & stage : supported)
+  {
+    if (find(stages.begin(), stages.end(), stage) != stages.end())
+      sorted.push_back(stage);
+  }
+  for (string const & stage : stages)
+  {
+    if (find(supported.begin(), supported.end(), stage) == supported.end())
+      MYTHROW(ManifestException, ("Stage", stage, "can't be run as a job"));
+  }
+
+  for (string const & country : countries)
+  {
+    string const mwm = info.GetTargetFileName(country);
+    string const routing =
+        info.GetTargetFileName(country, DATA_FILE_EXTENSION ROUTING_FILE_EXTENSION);
+    string const osrm = my::JoinFoldersToPath(osrmDir, country + kOsrmExtension);
+
+    string previous;
+    for (string const & stage : sorted)
+    {
+      Job job;
+      job.m_country = country;
+      job.m_stage = stage;
+      job.m_args = {"--output=" + country, "--" + stage};
+
+      if (stage == "generate_geometry")
+      {
+        job.m_inputs.push_back(info.GetTmpFileName(country));
+        job.m_outputs.push_back(mwm);
+      }
+      else if (stage == "generate_index" || stage == "generate_search_index")
+      {
+        job.m_inputs.push_back(mwm);
+        job.m_outputs.push_back(mwm);
+      }
+      else
+      {
+        if (stage != "make_turns_info")
+        {
+          job.m_args.push_back("--osrm_file_name=" + osrm);
+          job.m_inputs.push_back(osrm);
+        }
+        job.m_inputs.push_back(mwm);
+        if (stage != "make_routing")
+          job.m_inputs.push_back(routing);
+        job.m_outputs.push_back(routing);
+      }
+
+      if (!previous.empty())
+        job.m_dependencies.push_back(previous);
+      previous = job.GetId();
+      manifest.m_jobs.push_back(move(job));
+    }
+  }
+}
+
+string ToJSON(Manifest const & manifest)
+{
+  my::JsonHandle root;
+  root.AttachNew(json_object());
+  json_object_set_new(root.get(), "version", json_integer(kVersion));
+  json_object_set_new(root.get(), "common_args", ToJSONArray(manifest.m_commonArgs));
+
+  json_t * jobs = json_array();
+  for (Job const & job : manifest.m_jobs)
+  {
+    json_t * jJob = json_object();
+    json_object_set_new(jJob, "id", json_string(job.GetId().c_str()));
+    json_object_set_new(jJob, "country", json_string(job.m_country.c_str()));
+    json_object_set_new(jJob, "stage", json_string(job.m_stage.c_str()));
+    json_object_set_new(jJob, "args", ToJSONArray(job.m_args));
+    json_object_set_new(jJob, "inputs", ToJSONArray(job.m_inputs));
+    json_object_set_new(jJob, "outputs", ToJSONArray(job.m_outputs));
+    json_object_set_new(jJob, "depends_on", ToJSONArray(job.m_dependencies));
+    json_array_append_new(jobs, jJob);
+  }
+  json_object_set_new(root.get(), "jobs", jobs);
+
+  char * res = json_dumps(root.get(), JSON_PRESERVE_ORDER | JSON_INDENT(2));
+  string const json = res;
+  free(res);
+  return json;
+}
+
+void FromJSON(string const & json, Manifest & manifest)
+{
+  try
+  {
+    my::Json root(json.c_str());
+    json_int_t const version = json_integer_value(json_object_get(root.get(), "version"));
+    if (version != kVersion)
+      MYTHROW(ManifestException, ("Unsupported manifest version", version));
+
+    Manifest res;
+    FromJSONArray(root.get(), "common_args", res.m_commonArgs);
+
+    json_t * jobs = json_object_get(root.get(), "jobs");
+    if (!json_is_array(jobs))
+      MYTHROW(ManifestException, ("Missing array jobs"));
+
+    unordered_set<string> ids;
+    for (size_t i = 0; i < json_array_size(jobs); ++i)
+    {
+      json_t * jJob = json_array_get(jobs, i);
+      Job job;
+      job.m_country = GetString(jJob, "country");
+      job.m_stage = GetString(jJob, "stage");
+      FromJSONArray(jJob, "args", job.m_args);
+      FromJSONArray(jJob, "inputs", job.m_inputs);
+      FromJSONArray(jJob, "outputs", job.m_outputs);
+      FromJSONArray(jJob, "depends_on", job.m_dependencies);
+      // The dependencies go before the job, so the manifest has no cycles.
+      for (string const & dependency : job.m_dependencies)
+      {
+        if (ids.count(dependency) == 0)
+          MYTHROW(ManifestException, ("Unknown dependency", dependency, "of", job.GetId()));
+      }
+      if (!ids.insert(job.GetId()).second)
+        MYTHROW(ManifestException, ("Duplicate job", job.GetId()));
+      res.m_jobs.push_back(move(job));
+    }
+    manifest = move(res);
+  }
+  catch (my::Json::Exception const & ex)
+  {
+    MYTHROW(ManifestException, (ex.Msg()));
+  }
+}
+
+bool Save(Manifest const & manifest, string const & path)
+{
+  try
+  {
+    string const json = ToJSON(manifest);
+    FileWriter writer(path);
+    writer.Write(json.data(), json.size());
+  }
+  catch (Writer::Exception const & ex)
+  {
+    LOG(LERROR, ("Can't write the manifest to", path, ex.Msg()));
+    return false;
+  }
+  LOG(LINFO, ("Manifest with", manifest.m_jobs.size(), "jobs is written to", path));
+  return true;
+}
+
+bool Load(string const & path, Manifest & manifest)
+{
+  try
+  {
+    string json;
+    FileReader(path).ReadAsString(json);
+    FromJSON(json, manifest);
+  }
+  catch (RootException const & ex)
+  {
+    LOG(LERROR, ("Can't load the manifest", path, ex.Msg()));
+    return false;
+  }
+  return true;
+}
+
+JobsState::JobsState(string const & manifestPath) : m_dir(manifestPath + ".state")
+{
+  UNUSED_VALUE(GetPlatform().MkDir(m_dir));
+}
+
+bool JobsState::IsDone(string const & id) const
+{
+  return Platform::IsFileExistsByFullPath(GetStampPath(id));
+}
+
+bool JobsState::MarkDone(string const & id) const
+{
+  // The stamp is renamed to its place, so it can't be seen half-written by the other nodes.
+  string const path = GetStampPath(id);
+  string const tmpPath = path + ".tmp";
+  try
+  {
+    FileWriter writer(tmpPath);
+  }
+  catch (Writer::Exception const & ex)
+  {
+    LOG(LERROR, ("Can't write the stamp", tmpPath, ex.Msg()));
+    return false;
+  }
+  return my::RenameFileX(tmpPath, path);
+}
+
+bool JobsState::IsReady(Job const & job) const
+{
+  return all_of(job.m_dependencies.begin(), job.m_dependencies.end(),
+                [this](string const & id) { return IsDone(id); });
+}
+
+vector<Job const *> JobsState::GetReadyJobs(Manifest const & manifest) const
+{
+  vector<Job const *> jobs;
+  for (Job const & job : manifest.m_jobs)
+  {
+    if (!IsDone(job.GetId()) && IsReady(job))
+      jobs.push_back(&job);
+  }
+  return jobs;
+}
+
+string JobsState::GetReportPath(string const & id) const
+{
+  return my::JoinFoldersToPath(m_dir, id + ".json");
+}
+
+string JobsState::GetStampPath(string const & id) const
+{
+  return my::JoinFoldersToPath(m_dir, id + ".done");
+}
+}  // namespace manifest
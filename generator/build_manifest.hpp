@@ -0,0 +1,84 @@
+#pragma once
+
+#include "generator/generate_info.hpp"
+
+#include "base/exception.hpp"
+
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+/// Manifest of the distributed planet build. The per-country stages of the generator are
+/// described as jobs with their input and output files and the jobs they depend on, so the
+/// jobs can be run on different nodes sharing the data directory. Each job is run by
+/// generator_tool --manifest=<file> --job=<id>, the done jobs are marked by the stamps next
+/// to the manifest, so the failed ones can be rerun.
+namespace manifest
+{
+DECLARE_EXCEPTION(ManifestException, RootException);
+
+struct Job
+{
+  string GetId() const { return m_country + "." + m_stage; }
+
+  string m_country;
+  string m_stage;
+  /// Command line flags of generator_tool to run the job with, like "--generate_index".
+  vector<string> m_args;
+  vector<string> m_inputs;
+  vector<string> m_outputs;
+  /// Ids of the jobs which must be done before this one.
+  vector<string> m_dependencies;
+};
+
+struct Manifest
+{
+  Job const * FindJob(string const & id) const;
+
+  /// Flags which are common for all the jobs, like "--data_path=...".
+  vector<string> m_commonArgs;
+  vector<Job> m_jobs;
+};
+
+/// @return Stages which can be run as the jobs, in the order they are run for a country.
+vector<string> const & GetSupportedStages();
+
+/// Makes the jobs of the stages for each country. The stages of a country depend on each other
+/// in the order of GetSupportedStages(), as all of them update the same files.
+/// @param osrmDir Directory of <country>.osrm files for the routing stages.
+/// @throw ManifestException if a stage is not supported.
+void MakeJobs(vector<string> const & countries, vector<string> const & stages,
+              feature::GenerateInfo const & info, string const & osrmDir, Manifest & manifest);
+
+string ToJSON(Manifest const & manifest);
+/// @throw ManifestException if json is not a valid manifest.
+void FromJSON(string const & json, Manifest & manifest);
+
+/// @return false if the manifest can't be written.
+bool Save(Manifest const & manifest, string const & path);
+/// @return false if the manifest can't be read or parsed.
+bool Load(string const & path, Manifest & manifest);
+
+/// State of the jobs of the manifest, it's kept in <manifest>.state directory: <id>.done stamps
+/// of the done jobs and <id>.json stages reports of them.
+class JobsState
+{
+public:
+  explicit JobsState(string const & manifestPath);
+
+  bool IsDone(string const & id) const;
+  /// @return false if the stamp can't be written.
+  bool MarkDone(string const & id) const;
+
+  /// @return true if all the dependencies of the job are done.
+  bool IsReady(Job const & job) const;
+  /// @return Jobs which are not done and all of their dependencies are done.
+  vector<Job const *> GetReadyJobs(Manifest const & manifest) const;
+
+  string GetReportPath(string const & id) const;
+
+private:
+  string GetStampPath(string const & id) const;
+
+  string m_dir;
+};
+}  // namespace manifest
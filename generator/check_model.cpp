@@ -2,23 +2,49 @@
 
 #include "defines.hpp"
 
+#include "indexer/coarse_cells_index.hpp"
+#include "indexer/data_factory.hpp"
+#include "indexer/feature_attributes_table.hpp"
+#include "indexer/feature_meta_index.hpp"
+#include "indexer/features_offsets_table.hpp"
 #include "indexer/features_vector.hpp"
 #include "indexer/classificator.hpp"
 #include "indexer/feature_visibility.hpp"
+#include "indexer/mercator.hpp"
+#include "indexer/scale_index.hpp"
+
+#include "coding/var_record_reader.hpp"
 
 #include "base/logging.hpp"
+#include "base/stl_add.hpp"
+#include "base/task_scheduler.hpp"
+#include "base/timer.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/limits.hpp"
 
 
 using namespace feature;
 
 namespace check_model
 {
-  void ReadFeatures(string const & fName)
+namespace
+{
+  // Features are checked by the chunks of this size, each chunk is read by its own cursor.
+  uint32_t const kChunkSize = 4096;
+
+  class FeatureChecker
   {
-    Classificator const & c = classif();
+  public:
+    explicit FeatureChecker(DataHeader const & header)
+      : m_header(header), m_bounds(MercatorBounds::FullRect())
+    {
+      m_bounds.Inflate(1.0, 1.0);
+    }
 
-    FeaturesVectorTest(fName).GetVector().ForEach([&] (FeatureType const & ft, uint32_t)
+    void operator() (FeatureType const & ft, uint32_t) const
     {
+      Classificator const & c = classif();
       TypesHolder types(ft);
 
       vector<uint32_t> vTypes;
@@ -39,8 +65,174 @@ namespace check_model
         CHECK_GREATER(ft.GetPointsCount(), 1, ());
 
       IsDrawableLike(vTypes, ft.GetFeatureType());
+
+      // Geometry of each scale is decoded.
+      for (size_t i = 0; i < m_header.GetScalesCount(); ++i)
+      {
+        int const scale = m_header.GetScale(i);
+        if (type == GEOM_LINE)
+        {
+          ft.ParseGeometry(scale);
+          size_t const count = ft.GetPointsCount();
+          CHECK(count == 0 || count > 1, (count, scale));
+          for (size_t j = 0; j < count; ++j)
+            CheckPoint(ft.GetPoint(j));
+        }
+        else if (type == GEOM_AREA)
+        {
+          ft.ForEachTriangle([this](m2::PointD const & p1, m2::PointD const & p2,
+                                    m2::PointD const & p3)
+          {
+            CheckPoint(p1);
+            CheckPoint(p2);
+            CheckPoint(p3);
+          }, scale);
+        }
+      }
+    }
+
+  private:
+    void CheckPoint(m2::PointD const & p) const
+    {
+      CHECK(m_bounds.IsPointInside(p), (p));
+    }
+
+    DataHeader const & m_header;
+    m2::RectD m_bounds;
+  };
+
+  /// Offsets in the table should be the ones of the records in the data section.
+  void CheckOffsetsTable(FilesContainerR const & cont, FeaturesOffsetsTable const & table)
+  {
+    VarRecordReader<FilesContainerR::ReaderT, &VarRecordSizeReaderVarint> const reader(
+        cont.GetReader(DATA_FILE_TAG), 256);
+    size_t index = 0;
+    reader.ForEachRecord([&](uint32_t pos, char const *, uint32_t)
+    {
+      CHECK_LESS(index, table.size(), ());
+      CHECK_EQUAL(table.GetFeatureOffset(index), pos, (index));
+      ++index;
     });
+    CHECK_EQUAL(index, table.size(), ());
+  }
+
+  /// Features of the buckets of the scale index should be in the features vector.
+  void CheckScaleIndexBucket(ScaleIndex<ModelReaderPtr> const & index, uint32_t bucket,
+                             size_t featuresCount)
+  {
+    size_t count = 0;
+    index.ForEachInIntervalAndBucket([&](uint32_t feature)
+    {
+      CHECK_LESS(feature, featuresCount, (bucket));
+      ++count;
+    }, 0, numeric_limits<uint64_t>::max(), bucket);
+    LOG(LDEBUG, ("Bucket", bucket, "of the scale index has", count, "entries."));
+  }
+
+  void CheckSections(FilesContainerR const & cont, size_t featuresCount)
+  {
+    if (cont.IsExist(FEATURE_ATTRIBUTES_FILE_TAG))
+    {
+      AttributesTable table;
+      CHECK(table.Load(cont.GetReader(FEATURE_ATTRIBUTES_FILE_TAG)), ());
+      CHECK_EQUAL(table.GetCount(), featuresCount, ());
+    }
+
+    if (cont.IsExist(COARSE_CELLS_INDEX_FILE_TAG))
+    {
+      covering::CoarseCellsIndex index;
+      CHECK(index.Load(cont.GetReader(COARSE_CELLS_INDEX_FILE_TAG)), ());
+      if (!index.IsEmpty())
+      {
+        auto const checkFeature = [featuresCount](uint32_t feature)
+        {
+          CHECK_LESS(feature, featuresCount, ());
+        };
+        index.ForEachInRect(MercatorBounds::FullRect(), index.GetMaxScale(), checkFeature);
+      }
+    }
+
+    if (cont.IsExist(METADATA_OFFSETS_FILE_TAG))
+    {
+      MetadataIndex index;
+      CHECK(index.Load(cont), ());
+      uint64_t const size = cont.IsExist(METADATA_FILE_TAG)
+                                ? cont.GetReader(METADATA_FILE_TAG).Size() : 0;
+      for (uint32_t i = 0; i < featuresCount; ++i)
+      {
+        uint32_t offset;
+        if (index.Get(i, offset))
+          CHECK_LESS(offset, size, (i));
+      }
+    }
+  }
+
+  /// Each section should be readable within the file.
+  void ReadSection(FilesContainerR const & cont, string const & tag)
+  {
+    FilesContainerR::ReaderT const reader = cont.GetReader(tag);
+    vector<char> buffer(1024 * 1024);
+    for (uint64_t pos = 0; pos < reader.Size(); pos += buffer.size())
+    {
+      size_t const size = static_cast<size_t>(min<uint64_t>(buffer.size(), reader.Size() - pos));
+      reader.Read(pos, buffer.data(), size);
+    }
+  }
+}  // namespace
+
+  void ReadFeatures(string const & fName)
+  {
+    my::Timer timer;
+
+    FeaturesVectorTest features(fName);
+    FilesContainerR const & cont = features.GetContainer();
+    DataHeader const & header = features.GetHeader();
+    FeaturesOffsetsTable const * table = features.GetTable();
+    FeatureChecker const checker(header);
+
+    threads::TaskGroup group;
+
+    vector<string> tags;
+    cont.ForEachTag(MakeBackInsertFunctor(tags));
+    for (string const & tag : tags)
+      group.Run([&cont, tag]() { ReadSection(cont, tag); });
+
+    if (!table)
+    {
+      // Features of the old formats are found by the offsets only, they are read sequentially.
+      features.GetVector().ForEach(checker);
+      group.Wait();
+      LOG(LINFO, ("OK", fName, "in", timer.ElapsedSeconds(), "seconds."));
+      return;
+    }
+
+    size_t const featuresCount = table->size();
+    group.Run([&cont, table]() { CheckOffsetsTable(cont, *table); });
+    group.Run([&cont, featuresCount]() { CheckSections(cont, featuresCount); });
+
+    IndexFactory factory;
+    factory.Load(cont);
+    ScaleIndex<ModelReaderPtr> const index(cont.GetReader(INDEX_FILE_TAG), factory);
+    for (uint32_t bucket = 0; bucket < ScaleIndexBase::GetBucketsCount(); ++bucket)
+    {
+      group.Run([&index, bucket, featuresCount]()
+      {
+        CheckScaleIndexBucket(index, bucket, featuresCount);
+      });
+    }
+
+    FeaturesVector const & featuresVector = features.GetVector();
+    size_t const chunksCount = (featuresCount + kChunkSize - 1) / kChunkSize;
+    threads::ParallelFor(0, chunksCount, [&](size_t chunk)
+    {
+      vector<uint32_t> indices;
+      for (size_t i = chunk * kChunkSize; i < min(featuresCount, (chunk + 1) * kChunkSize); ++i)
+        indices.push_back(static_cast<uint32_t>(i));
+      FeaturesVector::Cursor(featuresVector).ForEachByIndex(indices, checker);
+    }, 1 /* grainSize */);
 
-    LOG(LINFO, ("OK"));
+    group.Wait();
+    LOG(LINFO, ("OK", fName, "features:", featuresCount, "sections:", tags.size(), "in",
+                timer.ElapsedSeconds(), "seconds."));
   }
 }
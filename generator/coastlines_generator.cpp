@@ -7,10 +7,13 @@
 
 #include "base/string_utils.hpp"
 #include "base/logging.hpp"
+#include "base/timer.hpp"
 
+#include "std/algorithm.hpp"
 #include "std/bind.hpp"
 #include "std/condition_variable.hpp"
 #include "std/function.hpp"
+#include "std/shared_ptr.hpp"
 #include "std/thread.hpp"
 #include "std/utility.hpp"
 
@@ -134,8 +137,11 @@ namespace
 
 bool CoastlineFeaturesGenerator::Finish()
 {
+  my::Timer timer;
   DoAddToTree doAdd(*this);
   m_merger.DoMerge(doAdd);
+  LOG(LINFO, ("Coastlines are merged in", timer.ElapsedSeconds(), "seconds, regions count:",
+              m_tree.GetSize()));
 
   if (doAdd.HasNotMergedCoasts())
   {
@@ -186,6 +192,16 @@ public:
     return count;
   }
 
+  /// Moves the parts of the regions which are inside the source rect, the source rect is left.
+  void MoveRegions(vector<RegionT> & regions)
+  {
+    regions.clear();
+    regions.reserve(m_res.size() - 1);
+    for (size_t i = 1; i < m_res.size(); ++i)
+      regions.push_back(move(m_res[i]));
+    m_res.resize(1);
+  }
+
   void AssignGeometry(FeatureBuilder1 & fb)
   {
     for (size_t i = 0; i < m_res.size(); ++i)
@@ -209,14 +225,28 @@ public:
   static int constexpr kStartLevel = 4;
   static int constexpr kHighLevel = 10;
   static int constexpr kMaxPoints = 20000;
+  // Progress is logged each time this number of cells is done.
+  static size_t constexpr kProgressStep = 256;
 
 protected:
+  using TRegions = vector<RegionT>;
+
+  struct Task
+  {
+    TCell m_cell;
+    // The parts of the regions inside the parent cell are intersected with the cell instead of
+    // the whole regions of the index, they are shared by the children of the cell.
+    shared_ptr<TRegions const> m_regions;
+  };
+
   struct Context
   {
     mutex mutexTasks;
-    list<TCell> listTasks;
+    list<Task> listTasks;
     condition_variable listCondVar;
     size_t inWork = 0;
+    size_t doneCount = 0;
+    size_t splitCount = 0;
     TProcessResultFunc processResultFunc;
   };
 
@@ -234,7 +264,7 @@ public:
     Context ctx;
 
     for (size_t i = 0; i < TCell::TotalCellsOnLevel(baseScale); ++i)
-      ctx.listTasks.push_back(TCell::FromBitsAndLevel(i, static_cast<int>(baseScale)));
+      ctx.listTasks.push_back({TCell::FromBitsAndLevel(i, static_cast<int>(baseScale)), nullptr});
 
     ctx.processResultFunc = funcResult;
 
@@ -249,12 +279,17 @@ public:
     for (auto & thread : threads)
       thread.join();
 
+    LOG(LINFO, ("Coast cells done:", ctx.doneCount, "split:", ctx.splitCount));
+
     // return true if listTask has no error cells
     return ctx.listTasks.empty();
   }
 
-  bool ProcessCell(TCell const & cell)
+  /// @param parts The parts of the regions inside the cell when it has too many points.
+  bool ProcessCell(Task const & task, TRegions & parts)
   {
+    TCell const & cell = task.m_cell;
+
     // get rect cell
     double minX, minY, maxX, maxY;
     CellIdConverter<MercatorBounds, TCell>::GetCellBounds(cell, minX, minY, maxX, maxY);
@@ -267,11 +302,26 @@ public:
     // Do 'and' with all regions and accumulate the result, including bound region.
     // In 'odd' parts we will have an ocean.
     DoDifference doDiff(rectR);
-    m_index.ForEachInRect(GetLimitRect(rectR), bind<void>(ref(doDiff), _1));
+    if (task.m_regions)
+    {
+      RectT const rect = rectR.GetRect();
+      for (RegionT const & r : *task.m_regions)
+      {
+        if (rect.IsIntersect(r.GetRect()))
+          doDiff(r);
+      }
+    }
+    else
+    {
+      m_index.ForEachInRect(GetLimitRect(rectR), bind<void>(ref(doDiff), _1));
+    }
 
     // Check if too many points for feature.
     if (cell.Level() < kHighLevel && doDiff.GetPointsCount() >= kMaxPoints)
+    {
+      doDiff.MoveRegions(parts);
       return false;
+    }
 
     m_ctx.processResultFunc(cell, doDiff);
     return true;
@@ -287,19 +337,29 @@ public:
       if (m_ctx.listTasks.empty())
         break;
 
-      TCell currentCell = m_ctx.listTasks.front();
+      Task currentTask = move(m_ctx.listTasks.front());
       m_ctx.listTasks.pop_front();
       ++m_ctx.inWork;
       lock.unlock();
 
-      bool const done = ProcessCell(currentCell);
+      TRegions parts;
+      bool const done = ProcessCell(currentTask, parts);
+      currentTask.m_regions.reset();
+      shared_ptr<TRegions const> const childRegions =
+          done ? nullptr : make_shared<TRegions>(move(parts));
 
       lock.lock();
       // return to queue not ready cells
-      if (!done)
+      if (done)
       {
+        if (++m_ctx.doneCount % kProgressStep == 0)
+          LOG(LINFO, ("Coast cells done:", m_ctx.doneCount, "in queue:", m_ctx.listTasks.size()));
+      }
+      else
+      {
+        ++m_ctx.splitCount;
         for (int8_t i = 0; i < TCell::MAX_CHILDREN; ++i)
-          m_ctx.listTasks.push_back(currentCell.Child(i));
+          m_ctx.listTasks.push_back({currentTask.m_cell.Child(i), childRegions});
       }
       --m_ctx.inWork;
       m_ctx.listCondVar.notify_all();
@@ -312,13 +372,16 @@ void CoastlineFeaturesGenerator::GetFeatures(vector<FeatureBuilder1> & features)
   size_t const maxThreads = thread::hardware_concurrency();
   CHECK_GREATER(maxThreads, 0, ("Not supported platform"));
 
+  my::Timer timer;
   mutex featuresMutex;
+  vector<pair<int64_t, FeatureBuilder1>> cellFeatures;
   RegionInCellSplitter::Process(
       maxThreads, RegionInCellSplitter::kStartLevel, m_tree,
-      [&features, &featuresMutex, this](RegionInCellSplitter::TCell const & cell, DoDifference & cellData)
+      [&cellFeatures, &featuresMutex, this](RegionInCellSplitter::TCell const & cell, DoDifference & cellData)
       {
+        int64_t const cellId = cell.ToInt64(RegionInCellSplitter::kHighLevel + 1);
         FeatureBuilder1 fb;
-        fb.SetCoastCell(cell.ToInt64(RegionInCellSplitter::kHighLevel + 1), cell.ToString());
+        fb.SetCoastCell(cellId, cell.ToString());
 
         cellData.AssignGeometry(fb);
         fb.SetArea();
@@ -330,6 +393,19 @@ void CoastlineFeaturesGenerator::GetFeatures(vector<FeatureBuilder1> & features)
 
         // save result
         lock_guard<mutex> lock(featuresMutex);
-        features.emplace_back(move(fb));
+        cellFeatures.emplace_back(cellId, move(fb));
       });
+
+  // The cells are done in any order, the features are sorted to get the same result every time.
+  sort(cellFeatures.begin(), cellFeatures.end(),
+       [](pair<int64_t, FeatureBuilder1> const & a, pair<int64_t, FeatureBuilder1> const & b)
+       {
+         return a.first < b.first;
+       });
+  features.reserve(features.size() + cellFeatures.size());
+  for (auto & cellFeature : cellFeatures)
+    features.emplace_back(move(cellFeature.second));
+
+  LOG(LINFO, ("Coast cells features:", cellFeatures.size(), "are made in", timer.ElapsedSeconds(),
+              "seconds"));
 }
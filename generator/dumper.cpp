@@ -9,9 +9,11 @@
 #include "coding/multilang_utf8_string.hpp"
 
 #include "base/logging.hpp"
+#include "base/timer.hpp"
 
 #include "std/algorithm.hpp"
 #include "std/bind.hpp"
+#include "std/iomanip.hpp"
 #include "std/iostream.hpp"
 #include "std/map.hpp"
 #include "std/queue.hpp"
@@ -202,7 +204,7 @@ namespace feature
 
     unique_ptr<trie::DefaultIterator> const pTrieRoot(
         trie::ReadTrie(container.GetReader(SEARCH_INDEX_FILE_TAG), trie::ValueReader(cp),
-                       trie::TEdgeValueReader()));
+                       trie::TEdgeValueReader(header.GetFormat())));
 
     SearchTokensCollector f;
     trie::ForEachRef(*pTrieRoot, f, strings::UniString());
@@ -216,4 +218,58 @@ namespace feature
     }
   }
 
+  struct NamesCollector
+  {
+    vector<string> m_names;
+
+    bool operator()(int8_t, string const & name)
+    {
+      m_names.push_back(name);
+      return true;
+    }
+
+    void operator()(FeatureType & f, uint32_t)
+    {
+      f.ForEachNameRef(*this);
+    }
+  };
+
+  void BenchmarkNormalization(string const & fPath)
+  {
+    NamesCollector collector;
+    feature::ForEachFromDat(fPath, collector);
+    vector<string> const & names = collector.m_names;
+
+    // Each name is decoded and normalized in place, as it was done before the lookup table.
+    size_t referenceChars = 0;
+    my::Timer timer;
+    for (string const & name : names)
+    {
+      strings::UniString s = strings::MakeUniString(name);
+      search::NormalizeAndSimplifyUniString(s);
+      referenceChars += s.size();
+    }
+    double const referenceSeconds = timer.ElapsedSeconds();
+
+    size_t chars = 0;
+    size_t bytes = 0;
+    strings::UniString buffer;
+    timer.Reset();
+    for (string const & name : names)
+    {
+      search::NormalizeAndSimplifyString(name, buffer);
+      chars += buffer.size();
+      bytes += name.size();
+    }
+    double const seconds = timer.ElapsedSeconds();
+    CHECK_EQUAL(chars, referenceChars, ());
+
+    double const megabyte = 1024.0 * 1024.0;
+    cout << fixed << setprecision(3);
+    cout << "NORMALIZATION[ names:" << names.size() << " MB:" << bytes / megabyte
+         << " reference seconds:" << referenceSeconds << " seconds:" << seconds
+         << " MB per second:" << (seconds == 0 ? 0.0 : bytes / megabyte / seconds) << " ]"
+         << endl;
+  }
+
 }  // namespace feature
@@ -7,4 +7,6 @@ namespace feature
   void DumpTypes(string const & fPath);
   void DumpPrefixes(string const & fPath);
   void DumpSearchTokens(string const & fPath);
+  /// Prints the throughput of the search normalization of the names of the mwm.
+  void BenchmarkNormalization(string const & fPath);
 }
@@ -0,0 +1,56 @@
+#include "generator/feature_attributes_generator.hpp"
+
+#include "indexer/classificator.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/feature_algo.hpp"
+#include "indexer/feature_attributes_table.hpp"
+#include "indexer/feature_data.hpp"
+#include "indexer/feature_processor.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/logging.hpp"
+
+#include "defines.hpp"
+
+namespace feature
+{
+bool BuildAttributesTableFromDatFile(string const & datFile)
+{
+  try
+  {
+    Classificator const & c = classif();
+    vector<AttributesTable::Attributes> attributes;
+    auto const addFeature = [&c, &attributes](FeatureType const & ft, uint32_t index)
+    {
+      if (attributes.size() <= index)
+        attributes.resize(index + 1);
+
+      AttributesTable::Attributes & a = attributes[index];
+      a.m_center = GetCenter(ft, FeatureType::WORST_GEOMETRY);
+      a.m_rank = ft.GetRank();
+      for (uint32_t const type : TypesHolder(ft))
+        a.m_typeIndices.push_back(c.GetIndexForType(type));
+    };
+    ForEachFromDat(datFile, addFeature);
+
+    FilesContainerW container(datFile, FileWriter::OP_WRITE_EXISTING);
+    FileWriter writer = container.GetWriter(FEATURE_ATTRIBUTES_FILE_TAG);
+    AttributesTable::Serialize(attributes, writer);
+    LOG(LINFO, ("Feature attributes of", attributes.size(), "features are written to", datFile));
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LERROR, ("Error while reading file:", e.Msg()));
+    return false;
+  }
+  catch (Writer::Exception const & e)
+  {
+    LOG(LERROR, ("Error writing feature attributes:", e.Msg()));
+    return false;
+  }
+
+  return true;
+}
+}  // namespace feature
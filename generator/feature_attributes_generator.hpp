@@ -0,0 +1,10 @@
+#pragma once
+
+#include "std/string.hpp"
+
+namespace feature
+{
+/// Builds the feature attributes section (see indexer/feature_attributes_table.hpp) and writes
+/// it into the mwm. Like the scales section, it should be built after the features are sorted.
+bool BuildAttributesTableFromDatFile(string const & datFile);
+}  // namespace feature
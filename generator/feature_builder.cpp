@@ -155,7 +155,7 @@ FeatureBase FeatureBuilder1::GetFeatureBase() const
   memcpy(f.m_types, &m_params.m_Types[0], sizeof(uint32_t) * m_params.m_Types.size());
   f.m_limitRect = m_limitRect;
 
-  f.m_bTypesParsed = f.m_bCommonParsed = true;
+  f.m_parsed = feature::FIELD_TYPES | feature::FIELD_COMMON;
 
   return f;
 }
@@ -326,11 +326,12 @@ bool FeatureBuilder1::CheckValid() const
   return true;
 }
 
-void FeatureBuilder1::SerializeBase(TBuffer & data, serial::CodingParams const & params, bool needSerializeAdditionalInfo) const
+void FeatureBuilder1::SerializeBase(TBuffer & data, serial::CodingParams const & params, bool needSerializeAdditionalInfo,
+                                    coding::ByteHuffmanCoder const * namesCoder) const
 {
   PushBackByteSink<TBuffer> sink(data);
 
-  m_params.Write(sink, needSerializeAdditionalInfo);
+  m_params.Write(sink, needSerializeAdditionalInfo, namesCoder);
 
   if (m_params.GetGeomType() == GEOM_POINT)
     serial::SavePoint(sink, m_center, params);
@@ -561,12 +562,14 @@ namespace
   };
 }
 
-void FeatureBuilder2::Serialize(SupportingData & data, serial::CodingParams const & params)
+void FeatureBuilder2::Serialize(SupportingData & data, serial::CodingParams const & params,
+                                coding::ByteHuffmanCoder const & namesCoder)
 {
   data.m_buffer.clear();
 
   // header data serialization
-  SerializeBase(data.m_buffer, params, false /* don't store additional info from FeatureParams*/);
+  SerializeBase(data.m_buffer, params, false /* don't store additional info from FeatureParams*/,
+                &namesCoder);
 
   PushBackByteSink<TBuffer> sink(data.m_buffer);
 
@@ -78,7 +78,8 @@ public:
   /// @name Serialization.
   //@{
   void Serialize(TBuffer & data) const;
-  void SerializeBase(TBuffer & data, serial::CodingParams const & params, bool needSearializeAdditionalInfo = true) const;
+  void SerializeBase(TBuffer & data, serial::CodingParams const & params, bool needSearializeAdditionalInfo = true,
+                     coding::ByteHuffmanCoder const * namesCoder = nullptr) const;
 
   void Deserialize(TBuffer & data);
   //@}
@@ -178,6 +179,7 @@ public:
   }
 
   string GetName(int8_t lang = StringUtf8Multilang::DEFAULT_CODE) const;
+  inline StringUtf8Multilang const & GetMultilangName() const { return m_params.name; }
   uint8_t GetRank() const { return m_params.rank; }
 
   /// @name For diagnostic use only.
@@ -244,7 +246,9 @@ public:
   /// @name Overwrite from base_type.
   //@{
   bool PreSerialize(SupportingData const & data);
-  void Serialize(SupportingData & data, serial::CodingParams const & params);
+  /// @param namesCoder Code of the names of the mwm, see version::v6.
+  void Serialize(SupportingData & data, serial::CodingParams const & params,
+                 coding::ByteHuffmanCoder const & namesCoder);
   //@}
 };
 
@@ -32,12 +32,11 @@ FeaturesCollector::FeaturesCollector(string const & fName)
 
 FeaturesCollector::~FeaturesCollector()
 {
-  FlushBuffer();
   // Check file size
   (void)GetFileSize(m_datFile);
 }
 
-uint32_t FeaturesCollector::GetFileSize(FileWriter const & f)
+uint32_t FeaturesCollector::GetFileSize(Writer const & f)
 {
   // .dat file should be less than 4Gb
   uint64_t const pos = f.Pos();
@@ -64,40 +63,19 @@ pair<char[ValueSizeT], uint8_t> PackValue(ValueT v)
   return res;
 }
 
-void FeaturesCollector::FlushBuffer()
-{
-  m_datFile.Write(m_writeBuffer, m_writePosition);
-  m_writePosition = 0;
-}
-
 void FeaturesCollector::Flush()
 {
-  FlushBuffer();
   m_datFile.Flush();
 }
 
-void FeaturesCollector::Write(char const * src, size_t size)
-{
-  do
-  {
-    if (m_writePosition == sizeof(m_writeBuffer))
-      FlushBuffer();
-    size_t const part_size = min(size, sizeof(m_writeBuffer) - m_writePosition);
-    memcpy(&m_writeBuffer[m_writePosition], src, part_size);
-    m_writePosition += part_size;
-    size -= part_size;
-    src += part_size;
-  } while (size > 0);
-}
-
 uint32_t FeaturesCollector::WriteFeatureBase(vector<char> const & bytes, FeatureBuilder1 const & fb)
 {
   size_t const sz = bytes.size();
   CHECK(sz != 0, ("Empty feature not allowed here!"));
 
   auto const & packedSize = PackValue(sz);
-  Write(packedSize.first, packedSize.second);
-  Write(&bytes[0], sz);
+  m_datFile.Write(packedSize.first, packedSize.second);
+  m_datFile.Write(&bytes[0], sz);
 
   m_bounds.Add(fb.GetLimitRect());
   return m_featureID++;
@@ -2,7 +2,7 @@
 
 #include "geometry/rect2d.hpp"
 
-#include "coding/file_writer.hpp"
+#include "coding/buffered_file_writer.hpp"
 
 #include "std/string.hpp"
 #include "std/vector.hpp"
@@ -14,20 +14,13 @@ namespace feature
 // Writes features to dat file.
 class FeaturesCollector
 {
-  char m_writeBuffer[48000];
-  size_t m_writePosition = 0;
   uint32_t m_featureID = 0;
 
 protected:
-  FileWriter m_datFile;
+  BufferedFileWriter m_datFile;
   m2::RectD m_bounds;
 
-private:
-  void Write(char const * src, size_t size);
-  void FlushBuffer();
-
-protected:
-  static uint32_t GetFileSize(FileWriter const & f);
+  static uint32_t GetFileSize(Writer const & f);
 
   /// @return feature offset in the file, which is used as an ID later
   uint32_t WriteFeatureBase(vector<char> const & bytes, FeatureBuilder1 const & fb);
@@ -43,7 +36,7 @@ public:
 
 class FeaturesAndRawGeometryCollector : public FeaturesCollector
 {
-  FileWriter m_rawGeometryFileStream;
+  BufferedFileWriter m_rawGeometryFileStream;
   size_t m_rawGeometryCounter = 0;
 
 public:
@@ -0,0 +1,52 @@
+#include "generator/feature_scales_generator.hpp"
+
+#include "indexer/feature.hpp"
+#include "indexer/feature_data.hpp"
+#include "indexer/feature_processor.hpp"
+#include "indexer/feature_scales_table.hpp"
+#include "indexer/feature_visibility.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/logging.hpp"
+
+#include "defines.hpp"
+
+namespace feature
+{
+bool BuildScalesTableFromDatFile(string const & datFile)
+{
+  try
+  {
+    vector<ScalesTable::Ranges> ranges;
+    auto const addFeature = [&ranges](FeatureType const & ft, uint32_t index)
+    {
+      if (ranges.size() <= index)
+        ranges.resize(index + 1);
+
+      TypesHolder const types(ft);
+      ranges[index] = ScalesTable::Ranges(
+          GetDrawableScaleRange(types), GetDrawableScaleRangeForRules(types, RULE_ANY_TEXT | RULE_SYMBOL));
+    };
+    ForEachFromDat(datFile, addFeature);
+
+    FilesContainerW container(datFile, FileWriter::OP_WRITE_EXISTING);
+    FileWriter writer = container.GetWriter(FEATURE_SCALES_FILE_TAG);
+    ScalesTable::Serialize(ranges, writer);
+    LOG(LINFO, ("Feature scales of", ranges.size(), "features are written to", datFile));
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LERROR, ("Error while reading file:", e.Msg()));
+    return false;
+  }
+  catch (Writer::Exception const & e)
+  {
+    LOG(LERROR, ("Error writing feature scales:", e.Msg()));
+    return false;
+  }
+
+  return true;
+}
+}  // namespace feature
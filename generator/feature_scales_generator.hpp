@@ -0,0 +1,10 @@
+#pragma once
+
+#include "std/string.hpp"
+
+namespace feature
+{
+/// Builds the feature scales section (see indexer/feature_scales_table.hpp) and writes it into
+/// the mwm. It should be called after the features are sorted, as it's indexed by their indices.
+bool BuildScalesTableFromDatFile(string const & datFile);
+}  // namespace feature
@@ -10,6 +10,7 @@
 #include "indexer/feature_processor.hpp"
 #include "indexer/feature_visibility.hpp"
 #include "indexer/feature_impl.hpp"
+#include "indexer/feature_meta_index.hpp"
 #include "indexer/geometry_serialization.hpp"
 #include "indexer/scales.hpp"
 
@@ -17,17 +18,30 @@
 
 #include "geometry/polygon.hpp"
 
+#include "coding/buffered_file_writer.hpp"
+#include "coding/byte_huffman.hpp"
 #include "coding/internal/file_data.hpp"
 #include "coding/file_container.hpp"
 #include "coding/file_name_utils.hpp"
 
+#include "coding/writer.hpp"
+
 #include "base/string_utils.hpp"
 #include "base/logging.hpp"
 
+#include "std/condition_variable.hpp"
+#include "std/deque.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/thread.hpp"
+
 namespace
 {
   typedef pair<uint64_t, uint64_t> CellAndOffsetT;
 
+  // There are geometry and triangles files for each scale, they're smaller than the dat file.
+  size_t constexpr kSmallBufferSize = 1024 * 1024;
+
   class CalculateMidPoints
   {
     m2::PointD m_midLoc, m_midAll;
@@ -38,9 +52,12 @@ namespace
     CalculateMidPoints() :
       m_midAll(0, 0), m_allCount(0), m_coordBits(serial::CodingParams().GetCoordBits())
     {
+      m_namesFrequencies.fill(0);
     }
 
     vector<CellAndOffsetT> m_vec;
+    /// Bytes of the names of the features, the names code of the mwm is built by them.
+    coding::ByteHuffmanCoder::TFrequencies m_namesFrequencies;
 
     void operator() (FeatureBuilder1 const & ft, uint64_t pos)
     {
@@ -60,6 +77,7 @@ namespace
       {
         uint64_t const order = (static_cast<uint64_t>(minScale) << 59) | (pointAsInt64 >> 5);
         m_vec.push_back(make_pair(order, pos));
+        ft.GetMultilangName().AddFrequencies(m_namesFrequencies);
       }
     }
 
@@ -87,29 +105,38 @@ namespace feature
   {
     FilesContainerW m_writer;
 
-    vector<FileWriter*> m_geoFile, m_trgFile;
+    vector<BufferedFileWriter*> m_geoFile, m_trgFile;
 
-    unique_ptr<FileWriter> m_MetadataWriter;
+    unique_ptr<BufferedFileWriter> m_MetadataWriter;
 
-    struct MetadataIndexValueT { uint32_t key, value; };
-    vector<MetadataIndexValueT> m_MetadataIndex;
+    MetadataIndex::Builder m_MetadataIndex;
+    uint32_t m_featuresCount = 0;
 
     DataHeader m_header;
     uint32_t m_versionDate;
+    coding::ByteHuffmanCoder const m_namesCoder;
 
     gen::OsmID2FeatureID m_osm2ft;
 
   public:
-    FeaturesCollector2(string const & fName, DataHeader const & header, uint32_t versionDate)
-      : FeaturesCollector(fName + DATA_FILE_TAG), m_writer(fName), m_header(header), m_versionDate(versionDate)
+    FeaturesCollector2(string const & fName, DataHeader const & header, uint32_t versionDate,
+                       coding::ByteHuffmanCoder const & namesCoder)
+      : FeaturesCollector(fName + DATA_FILE_TAG), m_writer(fName), m_header(header), m_versionDate(versionDate),
+        m_namesCoder(namesCoder)
     {
-      m_MetadataWriter.reset(new FileWriter(fName + METADATA_FILE_TAG));
+      m_MetadataWriter.reset(new BufferedFileWriter(fName + METADATA_FILE_TAG,
+                                                    FileWriter::OP_WRITE_TRUNCATE,
+                                                    kSmallBufferSize));
 
       for (size_t i = 0; i < m_header.GetScalesCount(); ++i)
       {
         string const postfix = strings::to_string(i);
-        m_geoFile.push_back(new FileWriter(fName + GEOMETRY_FILE_TAG + postfix));
-        m_trgFile.push_back(new FileWriter(fName + TRIANGLE_FILE_TAG + postfix));
+        m_geoFile.push_back(new BufferedFileWriter(fName + GEOMETRY_FILE_TAG + postfix,
+                                                   FileWriter::OP_WRITE_TRUNCATE,
+                                                   kSmallBufferSize));
+        m_trgFile.push_back(new BufferedFileWriter(fName + TRIANGLE_FILE_TAG + postfix,
+                                                   FileWriter::OP_WRITE_TRUNCATE,
+                                                   kSmallBufferSize));
       }
     }
 
@@ -128,6 +155,11 @@ namespace feature
         m_header.Save(w);
       }
 
+      {
+        FileWriter w = m_writer.GetWriter(NAMES_CODE_FILE_TAG);
+        m_namesCoder.Write(w);
+      }
+
       // assume like we close files
       Flush();
 
@@ -156,12 +188,10 @@ namespace feature
       }
 
       {
-        FileWriter w = m_writer.GetWriter(METADATA_INDEX_FILE_TAG);
-        for (auto const & v : m_MetadataIndex)
-        {
-          WriteToSink(w, v.key);
-          WriteToSink(w, v.value);
-        }
+        string const indexFile = m_writer.GetFileName() + METADATA_OFFSETS_FILE_TAG;
+        m_MetadataIndex.Save(indexFile, m_featuresCount);
+        m_writer.Write(indexFile, METADATA_OFFSETS_FILE_TAG);
+        FileWriter::DeleteFileX(indexFile);
       }
 
       m_MetadataWriter->Flush();
@@ -178,6 +208,16 @@ namespace feature
       }
     }
 
+    /// Geometry of a feature which is simplified and triangulated but isn't written yet.
+    /// Outer points and triangles are serialized to memory, their offsets are set by Write().
+    struct FeatureGeometry
+    {
+      FeatureBuilder2::SupportingData m_buffer;
+      // Scale indices and serialized data in the order the offsets are kept in the feature.
+      vector<pair<int, vector<char>>> m_outerPts;
+      vector<pair<int, vector<char>>> m_outerTrg;
+    };
+
   private:
     typedef vector<m2::PointD> points_t;
     typedef list<points_t> polygons_t;
@@ -185,11 +225,11 @@ namespace feature
     class GeometryHolder
     {
     public:
-      FeatureBuilder2::SupportingData m_buffer;
+      FeatureBuilder2::SupportingData & m_buffer;
 
     private:
-      FeaturesCollector2 & m_rMain;
-      FeatureBuilder2 & m_rFB;
+      FeatureGeometry & m_geometry;
+      FeatureBuilder2 const & m_rFB;
 
       points_t m_current;
 
@@ -208,19 +248,28 @@ namespace feature
         points_t toSave(points.begin() + 1, points.end());
 
         m_buffer.m_ptsMask |= (1 << i);
-        m_buffer.m_ptsOffset.push_back(m_rMain.GetFileSize(*m_rMain.m_geoFile[i]));
-        serial::SaveOuterPath(toSave, cp, *m_rMain.m_geoFile[i]);
+        m_geometry.m_outerPts.emplace_back(i, vector<char>());
+        MemWriter<vector<char>> writer(m_geometry.m_outerPts.back().second);
+        serial::SaveOuterPath(toSave, cp, writer);
       }
 
       void WriteOuterTriangles(polygons_t const & polys, int i)
       {
         // tesselation
-        tesselator::TrianglesInfo info;
-        if (0 == tesselator::TesselateInterior(polys, info))
+        // Simplification often gives the same polygons at the neighbour scales,
+        // so the triangles of the last polygons are reused.
+        if (m_trgCount < 0 || polys != m_trgPolys)
+        {
+          m_trgInfo = tesselator::TrianglesInfo();
+          m_trgCount = tesselator::TesselateInterior(polys, m_trgInfo);
+          m_trgPolys = polys;
+        }
+        if (0 == m_trgCount)
         {
           LOG(LINFO, ("NO TRIANGLES in", polys));
           return;
         }
+        tesselator::TrianglesInfo const & info = m_trgInfo;
 
         serial::CodingParams const cp = m_header.GetCodingParams(i);
 
@@ -241,10 +290,11 @@ namespace feature
 
         //CHECK_LESS_OR_EQUAL(saver.GetBufferSize(), checkSaver.GetBufferSize(), ());
 
-        // saving to file
+        // saving to memory
         m_buffer.m_trgMask |= (1 << i);
-        m_buffer.m_trgOffset.push_back(m_rMain.GetFileSize(*m_rMain.m_trgFile[i]));
-        saver.Save(*m_rMain.m_trgFile[i]);
+        m_geometry.m_outerTrg.emplace_back(i, vector<char>());
+        MemWriter<vector<char>> writer(m_geometry.m_outerTrg.back().second);
+        saver.Save(writer);
       }
 
       void FillInnerPointsMask(points_t const & points, uint32_t scaleIndex)
@@ -276,6 +326,11 @@ namespace feature
 
       bool m_ptsInner, m_trgInner;
 
+      // Last tesselated polygons and their triangles.
+      polygons_t m_trgPolys;
+      tesselator::TrianglesInfo m_trgInfo;
+      int m_trgCount = -1;
+
       class strip_emitter
       {
         points_t const & m_src;
@@ -293,10 +348,10 @@ namespace feature
       };
 
     public:
-      GeometryHolder(FeaturesCollector2 & rMain,
-                     FeatureBuilder2 & fb,
+      GeometryHolder(FeatureGeometry & geometry,
+                     FeatureBuilder2 const & fb,
                      DataHeader const & header)
-        : m_rMain(rMain), m_rFB(fb), m_header(header),
+        : m_buffer(geometry.m_buffer), m_geometry(geometry), m_rFB(fb), m_header(header),
           m_ptsInner(true), m_trgInner(true)
       {
       }
@@ -379,8 +434,8 @@ namespace feature
       }
     };
 
-    void SimplifyPoints(points_t const & in, points_t & out, int level,
-                        bool isCoast, m2::RectD const & rect)
+    static void SimplifyPoints(points_t const & in, points_t & out, int level,
+                               bool isCoast, m2::RectD const & rect)
     {
       if (isCoast)
       {
@@ -423,7 +478,16 @@ namespace feature
   public:
     void operator() (FeatureBuilder2 & fb)
     {
-      GeometryHolder holder(*this, fb, m_header);
+      FeatureGeometry geometry;
+      MakeGeometry(fb, geometry);
+      Write(fb, geometry);
+    }
+
+    /// Simplifies and triangulates geometry of the feature for all the scales.
+    /// Doesn't change the collector, so it may be called on several threads at once.
+    void MakeGeometry(FeatureBuilder2 const & fb, FeatureGeometry & geometry) const
+    {
+      GeometryHolder holder(geometry, fb, m_header);
 
       bool const isLine = fb.IsLine();
       bool const isArea = fb.IsArea();
@@ -494,17 +558,36 @@ namespace feature
           }
         }
       }
+    }
 
-      if (fb.PreSerialize(holder.m_buffer))
+    /// Writes the geometry and the feature, features are written in the order of the calls.
+    void Write(FeatureBuilder2 & fb, FeatureGeometry & geometry)
+    {
+      FeatureBuilder2::SupportingData & buffer = geometry.m_buffer;
+      for (auto const & pts : geometry.m_outerPts)
+      {
+        BufferedFileWriter & w = *m_geoFile[pts.first];
+        buffer.m_ptsOffset.push_back(GetFileSize(w));
+        w.Write(pts.second.data(), pts.second.size());
+      }
+      for (auto const & trg : geometry.m_outerTrg)
       {
-        fb.Serialize(holder.m_buffer, m_header.GetDefCodingParams());
+        BufferedFileWriter & w = *m_trgFile[trg.first];
+        buffer.m_trgOffset.push_back(GetFileSize(w));
+        w.Write(trg.second.data(), trg.second.size());
+      }
+
+      if (fb.PreSerialize(buffer))
+      {
+        fb.Serialize(buffer, m_header.GetDefCodingParams(), m_namesCoder);
 
-        uint32_t const ftID = WriteFeatureBase(holder.m_buffer.m_buffer, fb);
+        uint32_t const ftID = WriteFeatureBase(buffer.m_buffer, fb);
+        m_featuresCount = ftID + 1;
 
         if (!fb.GetMetadata().Empty())
         {
           uint64_t offset = m_MetadataWriter->Pos();
-          m_MetadataIndex.push_back({ ftID, static_cast<uint32_t>(offset) });
+          m_MetadataIndex.Add(ftID, static_cast<uint32_t>(offset));
           fb.GetMetadata().SerializeToMWM(*m_MetadataWriter);
         }
 
@@ -521,6 +604,115 @@ namespace feature
     return static_cast<FeatureBuilder2 &>(fb);
   }
 
+  /// Builds geometry of the sorted features on the worker threads while the calling thread
+  /// reads the next features and writes the ready ones in the sorted order. So the result
+  /// doesn't depend on the number of threads.
+  class GeometryPipeline
+  {
+    // Features are passed to the workers by batches to keep synchronization cheap.
+    static size_t constexpr kBatchSize = 256;
+    // Number of batches per thread which are read ahead of writing.
+    static size_t constexpr kReadAheadPerThread = 2;
+
+    struct Batch
+    {
+      vector<FeatureBuilder1> m_features;
+      vector<FeaturesCollector2::FeatureGeometry> m_geometries;
+      bool m_ready = false;
+    };
+
+    FeaturesCollector2 & m_collector;
+    size_t const m_threadsCount;
+
+    mutex m_mutex;
+    condition_variable m_cv;
+    deque<shared_ptr<Batch>> m_queue;
+    bool m_done = false;
+
+    void Work()
+    {
+      while (true)
+      {
+        shared_ptr<Batch> batch;
+        {
+          unique_lock<mutex> lock(m_mutex);
+          m_cv.wait(lock, [this]() { return !m_queue.empty() || m_done; });
+          if (m_queue.empty())
+            return;
+          batch = m_queue.front();
+          m_queue.pop_front();
+        }
+
+        for (size_t i = 0; i < batch->m_features.size(); ++i)
+          m_collector.MakeGeometry(GetFeatureBuilder2(batch->m_features[i]), batch->m_geometries[i]);
+
+        lock_guard<mutex> lock(m_mutex);
+        batch->m_ready = true;
+        m_cv.notify_all();
+      }
+    }
+
+  public:
+    GeometryPipeline(FeaturesCollector2 & collector, size_t threadsCount)
+      : m_collector(collector), m_threadsCount(threadsCount)
+    {
+    }
+
+    void Run(FileReader const & reader, vector<CellAndOffsetT> const & features)
+    {
+      vector<thread> workers;
+      for (size_t i = 0; i < m_threadsCount; ++i)
+        workers.emplace_back(&GeometryPipeline::Work, this);
+
+      size_t next = 0;
+      deque<shared_ptr<Batch>> batches;
+      while (next < features.size() || !batches.empty())
+      {
+        while (next < features.size() && batches.size() < kReadAheadPerThread * m_threadsCount)
+        {
+          auto batch = make_shared<Batch>();
+          size_t const count = min(kBatchSize, features.size() - next);
+          batch->m_features.resize(count);
+          batch->m_geometries.resize(count);
+          for (auto & fb : batch->m_features)
+          {
+            ReaderSource<FileReader> src(reader);
+            src.Skip(features[next++].second);
+            ReadFromSourceRowFormat(src, fb);
+          }
+          batches.push_back(batch);
+
+          lock_guard<mutex> lock(m_mutex);
+          m_queue.push_back(batch);
+          m_cv.notify_all();
+        }
+
+        shared_ptr<Batch> batch = batches.front();
+        batches.pop_front();
+        {
+          unique_lock<mutex> lock(m_mutex);
+          m_cv.wait(lock, [&batch]() { return batch->m_ready; });
+        }
+
+        for (size_t i = 0; i < batch->m_features.size(); ++i)
+          m_collector.Write(GetFeatureBuilder2(batch->m_features[i]), batch->m_geometries[i]);
+      }
+
+      {
+        lock_guard<mutex> lock(m_mutex);
+        m_done = true;
+        m_cv.notify_all();
+      }
+      for (auto & worker : workers)
+        worker.join();
+    }
+  };
+
+  // static
+  size_t constexpr GeometryPipeline::kBatchSize;
+  // static
+  size_t constexpr GeometryPipeline::kReadAheadPerThread;
+
   class DoStoreLanguages
   {
     DataHeader & m_header;
@@ -590,18 +782,28 @@ namespace feature
       // Transform features from raw format to optimized format.
       try
       {
-        FeaturesCollector2 collector(datFilePath, header, info.m_versionDate);
+        coding::ByteHuffmanCoder namesCoder;
+        namesCoder.Build(midPoints.m_namesFrequencies);
 
-        for (size_t i = 0; i < midPoints.m_vec.size(); ++i)
+        FeaturesCollector2 collector(datFilePath, header, info.m_versionDate, namesCoder);
+
+        if (info.m_geometryThreadsCount > 1)
         {
-          ReaderSource<FileReader> src(reader);
-          src.Skip(midPoints.m_vec[i].second);
+          GeometryPipeline(collector, info.m_geometryThreadsCount).Run(reader, midPoints.m_vec);
+        }
+        else
+        {
+          for (size_t i = 0; i < midPoints.m_vec.size(); ++i)
+          {
+            ReaderSource<FileReader> src(reader);
+            src.Skip(midPoints.m_vec[i].second);
 
-          FeatureBuilder1 f;
-          ReadFromSourceRowFormat(src, f);
+            FeatureBuilder1 f;
+            ReadFromSourceRowFormat(src, f);
 
-          // emit the feature
-          collector(GetFeatureBuilder2(f));
+            // emit the feature
+            collector(GetFeatureBuilder2(f));
+          }
         }
       }
       catch (Writer::Exception const & ex)
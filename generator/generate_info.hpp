@@ -6,6 +6,7 @@
 
 #include "coding/file_name_utils.hpp"
 
+#include "std/set.hpp"
 #include "std/string.hpp"
 #include "std/vector.hpp"
 
@@ -18,13 +19,15 @@ struct GenerateInfo
   {
     Memory,
     Index,
-    File
+    File,
+    Packed
   };
 
   enum class OsmSourceType
   {
     XML,
-    O5M
+    O5M,
+    PBF
   };
 
 
@@ -41,10 +44,22 @@ struct GenerateInfo
   NodeStorageType m_nodeStorageType;
   OsmSourceType m_osmFileType;
   string m_osmFileName;
+  // OsmChange file the intermediate data is updated with.
+  string m_osmChangeFileName;
+  // Number of threads to decode the osm file.
+  size_t m_osmThreadsCount = 1;
+  // Number of the osm elements processed by the last pass, it's filled by the pass.
+  uint64_t m_osmElementsCount = 0;
+  // Number of threads to simplify and triangulate geometry of a country.
+  size_t m_geometryThreadsCount = 1;
+  // Number of threads to merge the line features of the world, zero merges them in memory.
+  size_t m_worldMergeThreadsCount = 0;
 
   uint32_t m_versionDate = 0;
 
   vector<string> m_bucketNames;
+  // Countries to generate when splitting by polygons, all of them if it's empty.
+  set<string> m_countriesToGenerate;
 
   bool m_createWorld = false;
   bool m_splitByPolygons = false;
@@ -53,6 +68,7 @@ struct GenerateInfo
   bool m_genAddresses = false;
   bool m_failOnCoasts = false;
   bool m_preloadCache = false;
+  bool m_compressCache = false;
 
 
   GenerateInfo() = default;
@@ -63,6 +79,8 @@ struct GenerateInfo
       m_osmFileType = OsmSourceType::XML;
     else if (type == "o5m")
       m_osmFileType = OsmSourceType::O5M;
+    else if (type == "pbf")
+      m_osmFileType = OsmSourceType::PBF;
     else
       LOG(LCRITICAL, ("Unknown source type:", type));
   }
@@ -75,6 +93,8 @@ struct GenerateInfo
       m_nodeStorageType = NodeStorageType::Index;
     else if (type == "mem")
       m_nodeStorageType = NodeStorageType::Memory;
+    else if (type == "packed")
+      m_nodeStorageType = NodeStorageType::Packed;
     else
       LOG(LCRITICAL, ("Incorrect node_storage type:", type));
   }
@@ -9,24 +9,35 @@ ROOT_DIR = ..
 include($$ROOT_DIR/common.pri)
 
 INCLUDEPATH *= $$ROOT_DIR/3party/gflags/src $$ROOT_DIR/3party/expat/lib \
-               $$ROOT_DIR/3party/osrm/osrm-backend/include
+               $$ROOT_DIR/3party/osrm/osrm-backend/include $$ROOT_DIR/3party/jansson/src
 
 QT *= core
 
 SOURCES += \
     borders_generator.cpp \
+    borders_grid.cpp \
     borders_loader.cpp \
+    build_manifest.cpp \
     check_model.cpp \
     coastlines_generator.cpp \
     dumper.cpp \
     feature_builder.cpp \
     feature_generator.cpp \
     feature_merger.cpp \
+    feature_attributes_generator.cpp \
+    feature_scales_generator.cpp \
     feature_sorter.cpp \
+    houses_index_generator.cpp \
+    landmarks_generator.cpp \
+    locality_index_generator.cpp \
     osm2type.cpp \
     osm_id.cpp \
+    osm_pbf_source.cpp \
     osm_source.cpp \
+    parallel_feature_merger.cpp \
+    road_graph_generator.cpp \
     routing_generator.cpp \
+    stages_profiler.cpp \
     statistics.cpp \
     tesselator.cpp \
     unpack_mwm.cpp \
@@ -35,7 +46,9 @@ SOURCES += \
 
 HEADERS += \
     borders_generator.hpp \
+    borders_grid.hpp \
     borders_loader.hpp \
+    build_manifest.hpp \
     check_model.hpp \
     coastlines_generator.hpp \
     dumper.hpp \
@@ -45,18 +58,28 @@ HEADERS += \
     feature_emitter_iface.hpp \
     feature_generator.hpp \
     feature_merger.hpp \
+    feature_attributes_generator.hpp \
+    feature_scales_generator.hpp \
     feature_sorter.hpp \
     gen_mwm_info.hpp \
     generate_info.hpp \
+    houses_index_generator.hpp \
+    landmarks_generator.hpp \
+    locality_index_generator.hpp \
     osm2meta.hpp \
     osm2type.hpp \
     osm2meta.hpp \
+    osm_change_source.hpp \
     osm_element.hpp \
     osm_id.hpp \
     osm_o5m_source.hpp \
+    osm_pbf_source.hpp \
     osm_xml_source.hpp \
+    parallel_feature_merger.hpp \
     polygonizer.hpp \
+    road_graph_generator.hpp \
     routing_generator.hpp \
+    stages_profiler.hpp \
     statistics.hpp \
     tesselator.hpp \
     unpack_mwm.hpp \
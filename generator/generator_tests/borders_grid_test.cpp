@@ -0,0 +1,62 @@
+#include "testing/testing.hpp"
+
+#include "generator/borders_grid.hpp"
+
+#include "std/vector.hpp"
+
+namespace
+{
+void AddRegion(borders::RegionsContainerT & regions, vector<m2::PointD> && points)
+{
+  m2::RegionD region(move(points));
+  m2::RectD const rect = region.GetRect();
+  regions.Add(region, rect);
+}
+
+void TestGrid(borders::RegionsContainerT const & regions)
+{
+  borders::RegionsGrid const grid(regions);
+  m2::RectD rect;
+  regions.ForEach([&rect](m2::RegionD const & region) { rect.Add(region.GetRect()); });
+  rect.Inflate(1.0, 1.0);
+
+  // Points are checked twice, the second time the states of the cells are cached.
+  size_t const kSteps = 300;
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    for (size_t i = 0; i <= kSteps; ++i)
+    {
+      for (size_t j = 0; j <= kSteps; ++j)
+      {
+        m2::PointD const pt(rect.minX() + rect.SizeX() * i / kSteps,
+                            rect.minY() + rect.SizeY() * j / kSteps);
+        TEST_EQUAL(grid.Contains(regions, pt),
+                   borders::RegionsGrid::ContainsExactly(regions, pt), (pt));
+      }
+    }
+  }
+}
+}  // namespace
+
+UNIT_TEST(RegionsGrid_Concave)
+{
+  borders::RegionsContainerT regions;
+  AddRegion(regions, {{0, 0}, {10, 0}, {10, 10}, {5, 3}, {0, 10}});
+  TestGrid(regions);
+}
+
+UNIT_TEST(RegionsGrid_SeveralRegions)
+{
+  borders::RegionsContainerT regions;
+  AddRegion(regions, {{-20, -20}, {-10, -20}, {-15, -10}});
+  AddRegion(regions, {{0, 0}, {7, 1}, {10, 10}, {1, 7}});
+  AddRegion(regions, {{30, 40}, {31, 40}, {31, 40.5}, {30, 40.5}});
+  TestGrid(regions);
+}
+
+UNIT_TEST(RegionsGrid_Empty)
+{
+  borders::RegionsContainerT regions;
+  borders::RegionsGrid const grid(regions);
+  TEST(!grid.Contains(regions, m2::PointD(0, 0)), ());
+}
@@ -0,0 +1,130 @@
+#include "testing/testing.hpp"
+
+#include "generator/build_manifest.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_name_utils.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+using namespace manifest;
+
+namespace
+{
+vector<string> GetIds(vector<Job const *> const & jobs)
+{
+  vector<string> ids;
+  for (Job const * job : jobs)
+    ids.push_back(job->GetId());
+  return ids;
+}
+
+bool IsValidManifest(string const & json)
+{
+  try
+  {
+    Manifest manifest;
+    FromJSON(json, manifest);
+  }
+  catch (ManifestException const &)
+  {
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+UNIT_TEST(BuildManifest_Jobs)
+{
+  feature::GenerateInfo info;
+  info.m_tmpDir = "tmp";
+  info.m_targetDir = "data";
+
+  Manifest manifest;
+  manifest.m_commonArgs = {"--data_path=data"};
+  // The stages are sorted in the order they are run.
+  MakeJobs({"Belarus", "Latvia"}, {"make_routing", "generate_index", "generate_geometry"}, info,
+           "osrm", manifest);
+  TEST_EQUAL(manifest.m_jobs.size(), 6, ());
+
+  Job const * geometry = manifest.FindJob("Belarus.generate_geometry");
+  TEST(geometry != nullptr, ());
+  TEST_EQUAL(geometry->m_args, vector<string>({"--output=Belarus", "--generate_geometry"}), ());
+  TEST_EQUAL(geometry->m_inputs, vector<string>({my::JoinFoldersToPath("tmp", "Belarus.mwm.tmp")}),
+             ());
+  TEST(geometry->m_dependencies.empty(), ());
+
+  Job const * routing = manifest.FindJob("Latvia.make_routing");
+  TEST(routing != nullptr, ());
+  TEST_EQUAL(routing->m_dependencies, vector<string>({"Latvia.generate_index"}), ());
+  TEST_EQUAL(routing->m_args.back(),
+             "--osrm_file_name=" + my::JoinFoldersToPath("osrm", "Latvia.osrm"), ());
+  TEST_EQUAL(routing->m_outputs,
+             vector<string>({my::JoinFoldersToPath("data", "Latvia.mwm.routing")}), ());
+
+  TEST(manifest.FindJob("Latvia.generate_search_index") == nullptr, ());
+  try
+  {
+    Manifest unsupported;
+    MakeJobs({"Belarus"}, {"generate_features"}, info, "osrm", unsupported);
+    TEST(false, ("The stage is not supported"));
+  }
+  catch (ManifestException const &)
+  {
+  }
+
+  Manifest loaded;
+  FromJSON(ToJSON(manifest), loaded);
+  TEST_EQUAL(loaded.m_commonArgs, manifest.m_commonArgs, ());
+  TEST_EQUAL(loaded.m_jobs.size(), manifest.m_jobs.size(), ());
+  for (size_t i = 0; i < loaded.m_jobs.size(); ++i)
+  {
+    TEST_EQUAL(loaded.m_jobs[i].GetId(), manifest.m_jobs[i].GetId(), ());
+    TEST_EQUAL(loaded.m_jobs[i].m_args, manifest.m_jobs[i].m_args, ());
+    TEST_EQUAL(loaded.m_jobs[i].m_inputs, manifest.m_jobs[i].m_inputs, ());
+    TEST_EQUAL(loaded.m_jobs[i].m_outputs, manifest.m_jobs[i].m_outputs, ());
+    TEST_EQUAL(loaded.m_jobs[i].m_dependencies, manifest.m_jobs[i].m_dependencies, ());
+  }
+
+  TEST(!IsValidManifest("{\"version\": 1}"), ());
+  TEST(!IsValidManifest("not a json"), ());
+  // A job can't depend on the jobs which go after it.
+  TEST(!IsValidManifest("{\"version\": 1, \"common_args\": [], \"jobs\": [{\"country\": \"A\", "
+                        "\"stage\": \"generate_index\", \"args\": [], \"inputs\": [], "
+                        "\"outputs\": [], \"depends_on\": [\"A.generate_geometry\"]}]}"),
+       ());
+}
+
+UNIT_TEST(BuildManifest_ReadyJobs)
+{
+  feature::GenerateInfo info;
+  Manifest manifest;
+  MakeJobs({"Belarus", "Latvia"}, {"generate_geometry", "generate_index"}, info, "", manifest);
+
+  string const path = GetPlatform().WritablePathForFile("build_manifest_test.json");
+  TEST(Save(manifest, path), ());
+  Manifest loaded;
+  TEST(Load(path, loaded), ());
+  TEST_EQUAL(loaded.m_jobs.size(), 4, ());
+
+  JobsState const state(path);
+  TEST_EQUAL(GetIds(state.GetReadyJobs(loaded)),
+             vector<string>({"Belarus.generate_geometry", "Latvia.generate_geometry"}), ());
+
+  TEST(state.MarkDone("Belarus.generate_geometry"), ());
+  TEST(state.IsDone("Belarus.generate_geometry"), ());
+  TEST(state.IsReady(*loaded.FindJob("Belarus.generate_index")), ());
+  TEST(!state.IsReady(*loaded.FindJob("Latvia.generate_index")), ());
+  TEST_EQUAL(GetIds(state.GetReadyJobs(loaded)),
+             vector<string>({"Belarus.generate_index", "Latvia.generate_geometry"}), ());
+
+  // The state is kept between the runs.
+  TEST(JobsState(path).IsDone("Belarus.generate_geometry"), ());
+
+  my::DeleteFileX(path + ".state/Belarus.generate_geometry.done");
+  Platform::RmDir(path + ".state");
+  my::DeleteFileX(path);
+}
@@ -1,6 +1,12 @@
 #include "testing/testing.hpp"
 
 #include "generator/feature_merger.hpp"
+#include "generator/parallel_feature_merger.hpp"
+
+#include "indexer/classificator.hpp"
+#include "indexer/classificator_loader.hpp"
+
+#include "platform/platform.hpp"
 
 
 namespace
@@ -180,3 +186,54 @@ UNIT_TEST(FeatureMerger_Rounds)
 
   TEST_EQUAL(emitter.GetSize(), 1, ());
 }
+
+UNIT_TEST(ParallelFeatureMerger_Seams)
+{
+  classificator::Load();
+  uint32_t const type = classif().GetTypeByPath({"highway", "primary"});
+
+  // The line crosses the cells of the grid, the round feature is on the border of the cells.
+  vector<FeatureBuilder1> vF;
+  for (int x = -170; x < 170; x += 10)
+  {
+    vF.push_back(FeatureBuilder1());
+    vF.back().AddPoint(P(x, 1));
+    vF.back().AddPoint(P(x + 10, 1));
+  }
+  vF.push_back(FeatureBuilder1());
+  vF.back().AddPoint(P(-5, 5));
+  vF.back().AddPoint(P(5, 5));
+  vF.back().AddPoint(P(5, -5));
+  vF.back().AddPoint(P(-5, -5));
+  vF.back().AddPoint(P(-5, 5));
+  vF.push_back(FeatureBuilder1());
+  vF.back().AddPoint(P(-5, -5));
+  vF.back().AddPoint(P(-20, -20));
+  // Separate line inside a cell.
+  vF.push_back(FeatureBuilder1());
+  vF.back().AddPoint(P(100, 100));
+  vF.back().AddPoint(P(101, 101));
+
+  for (auto & fb : vF)
+  {
+    fb.SetLinear();
+    fb.AddType(type);
+  }
+
+  string const prefix = GetPlatform().WritablePathForFile("parallel_feature_merger_test.");
+  size_t resultSize = 0;
+  for (size_t threadsCount : {1, 3})
+  {
+    ParallelFeatureMerger merger(POINT_COORD_BITS, prefix, threadsCount, 4 /* cellsPerSide */);
+    for (auto const & fb : vF)
+      merger(fb);
+
+    VectorEmitter emitter;
+    merger.DoMerge(emitter);
+    emitter.Check(type, 3);
+    if (threadsCount != 1)
+      TEST_EQUAL(emitter.GetSize(), resultSize, ());
+    resultSize = emitter.GetSize();
+  }
+  TEST_EQUAL(resultSize, 3, ());
+}
@@ -8,8 +8,15 @@
 
 #include "testing/testing.hpp"
 
+#include "generator/intermediate_data.hpp"
 #include "generator/intermediate_elements.hpp"
 
+#include "platform/platform.hpp"
+
+#include "coding/internal/file_data.hpp"
+
+#include "std/cmath.hpp"
+
 
 UNIT_TEST(Intermediate_Data_empty_way_element_save_load_test)
 {
@@ -99,3 +106,153 @@ UNIT_TEST(Intermediate_Data_relation_element_save_load_test)
   TEST_NOT_EQUAL(e2.tags["key1old"], "value1old", ());
   TEST_NOT_EQUAL(e2.tags["key2old"], "value2old", ());
 }
+
+UNIT_TEST(Intermediate_Data_packed_point_storage_test)
+{
+  string const name = GetPlatform().WritablePathForFile("packed_point_storage_test.bin");
+
+  // Ids are sparse and go over 32 bits, the last block isn't completed.
+  vector<uint64_t> ids;
+  for (uint64_t id = 1; ids.size() < 1000; id += 1 + ids.size() % 7)
+    ids.push_back(id);
+  for (uint64_t id = 7000000000ULL; ids.size() < 1100; id += 1 + ids.size() % 1000)
+    ids.push_back(id);
+
+  auto const getLat = [](size_t i) { return -89.0 + 0.17 * i; };
+  auto const getLon = [](size_t i) { return 179.0 - 0.31 * i; };
+
+  {
+    cache::PackedFilePointStorage<cache::EMode::Write> storage(name);
+    for (size_t i = 0; i < ids.size(); ++i)
+      storage.AddPoint(ids[i], getLat(i), getLon(i));
+    TEST_EQUAL(storage.GetProcessedPoint(), ids.size(), ());
+  }
+
+  {
+    cache::PackedFilePointStorage<cache::EMode::Read> storage(name);
+    double lat, lon;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      TEST(storage.GetPoint(ids[i], lat, lon), (ids[i]));
+      TEST_LESS(fabs(lat - getLat(i)), 1e-6, (ids[i]));
+      TEST_LESS(fabs(lon - getLon(i)), 1e-6, (ids[i]));
+    }
+
+    TEST(!storage.GetPoint(0, lat, lon), ());
+    TEST(!storage.GetPoint(ids[5] + 1, lat, lon), ());
+    TEST(!storage.GetPoint(ids[999] + 1, lat, lon), ());
+    TEST(!storage.GetPoint(ids.back() + 1, lat, lon), ());
+  }
+
+  my::DeleteFileX(name);
+  my::DeleteFileX(name + ".blocks");
+}
+
+UNIT_TEST(Intermediate_Data_append_test)
+{
+  string const name = GetPlatform().WritablePathForFile("append_cache_test.bin");
+
+  auto const makeWay = [](uint64_t id, vector<uint64_t> const & nodes)
+  {
+    WayElement way(id);
+    way.nodes = nodes;
+    return way;
+  };
+
+  {
+    cache::OSMElementCache<cache::EMode::Write> ways(name);
+    ways.Write(1, makeWay(1, {1, 2}));
+    ways.Write(2, makeWay(2, {3, 4}));
+    ways.SaveOffsets();
+
+    cache::MapFilePointStorage<cache::EMode::Write> points(name);
+    points.AddPoint(1, 10.0, 20.0);
+    points.AddPoint(2, 30.0, 40.0);
+  }
+
+  {
+    cache::AppendTag const tag;
+    cache::OSMElementCache<cache::EMode::Write> ways(name, tag);
+    ways.Write(2, makeWay(2, {3, 5, 4}));
+    ways.Write(3, makeWay(3, {6, 7}));
+    ways.SaveOffsets();
+
+    cache::MapFilePointStorage<cache::EMode::Write> points(name, tag);
+    points.AddPoint(2, 50.0, 60.0);
+    points.AddPoint(3, 70.0, 80.0);
+  }
+
+  {
+    cache::OSMElementCache<cache::EMode::Read> ways(name);
+    ways.LoadOffsets();
+    vector<vector<uint64_t>> const expected = {{1, 2}, {3, 5, 4}, {6, 7}};
+    for (uint64_t id = 1; id <= expected.size(); ++id)
+    {
+      WayElement way(id);
+      TEST(ways.Read(id, way), (id));
+      TEST_EQUAL(way.nodes, expected[id - 1], (id));
+    }
+
+    cache::MapFilePointStorage<cache::EMode::Read> points(name);
+    double lat, lon;
+    TEST(points.GetPoint(1, lat, lon), ());
+    TEST_LESS(fabs(lat - 10.0) + fabs(lon - 20.0), 1e-6, ());
+    TEST(points.GetPoint(2, lat, lon), ());
+    TEST_LESS(fabs(lat - 50.0) + fabs(lon - 60.0), 1e-6, ());
+    TEST(points.GetPoint(3, lat, lon), ());
+    TEST_LESS(fabs(lat - 70.0) + fabs(lon - 80.0), 1e-6, ());
+  }
+
+  my::DeleteFileX(name);
+  my::DeleteFileX(name + OFFSET_EXT);
+  my::DeleteFileX(name + ".short");
+}
+
+UNIT_TEST(Intermediate_Data_compressed_cache_test)
+{
+  string const name = GetPlatform().WritablePathForFile("compressed_cache_test.bin");
+
+  // Node ids of a way go back and forth, the ways take several blocks.
+  auto const makeNodes = [](uint64_t id)
+  {
+    vector<uint64_t> nodes;
+    for (uint64_t i = 0; i < id % 50 + 1; ++i)
+      nodes.push_back(id * 1000 + (i % 2 == 0 ? i : 5000000000ULL - i));
+    return nodes;
+  };
+  auto const writeWays = [&makeNodes](cache::OSMElementCache<cache::EMode::Write> & ways,
+                                      uint64_t from, uint64_t to)
+  {
+    for (uint64_t id = from; id < to; ++id)
+    {
+      WayElement way(id);
+      way.nodes = makeNodes(id);
+      ways.Write(id, way);
+    }
+    ways.SaveOffsets();
+  };
+
+  {
+    cache::OSMElementCache<cache::EMode::Write> ways(name, false /* preload */, true /* compress */);
+    writeWays(ways, 1, 5000);
+  }
+  {
+    cache::OSMElementCache<cache::EMode::Write> ways(name, cache::AppendTag(), true /* compress */);
+    writeWays(ways, 5000, 6000);
+  }
+
+  for (bool const preload : {false, true})
+  {
+    cache::OSMElementCache<cache::EMode::Read> ways(name, preload, true /* compress */);
+    ways.LoadOffsets();
+    for (uint64_t id = 1; id < 6000; id += 7)
+    {
+      WayElement way(id);
+      TEST(ways.Read(id, way), (id));
+      TEST_EQUAL(way.nodes, makeNodes(id), (id));
+    }
+  }
+
+  my::DeleteFileX(name + COMPRESSED_CACHE_EXT);
+  my::DeleteFileX(name + OFFSET_EXT);
+}
@@ -0,0 +1,278 @@
+#include "testing/testing.hpp"
+
+#include "generator/osm_element.hpp"
+#include "generator/osm_source.hpp"
+
+#include "source_data.hpp"
+
+#include "std/cmath.hpp"
+#include "std/map.hpp"
+#include "std/sstream.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+#include "zlib.h"
+
+namespace
+{
+class ProtoWriter
+{
+public:
+  void AddVarint(uint32_t field, uint64_t value)
+  {
+    WriteVarint((static_cast<uint64_t>(field) << 3) | 0);
+    WriteVarint(value);
+  }
+
+  void AddBytes(uint32_t field, string const & bytes)
+  {
+    WriteVarint((static_cast<uint64_t>(field) << 3) | 2);
+    WriteVarint(bytes.size());
+    m_data += bytes;
+  }
+
+  void AddPacked(uint32_t field, vector<uint64_t> const & values)
+  {
+    ProtoWriter packed;
+    for (uint64_t const value : values)
+      packed.WriteVarint(value);
+    AddBytes(field, packed.m_data);
+  }
+
+  string const & GetData() const { return m_data; }
+
+  static uint64_t ZigZag(int64_t value)
+  {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+  }
+
+private:
+  void WriteVarint(uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      m_data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    m_data.push_back(static_cast<char>(value));
+  }
+
+  string m_data;
+};
+
+/// Writes elements to a .osm.pbf stream, each blob keeps blobSize elements.
+class PbfWriter
+{
+public:
+  string Write(vector<OsmElement> const & elements, size_t blobSize)
+  {
+    ProtoWriter header;
+    header.AddBytes(4, "OsmSchema-V0.6");
+    header.AddBytes(4, "DenseNodes");
+    WriteBlob("OSMHeader", header.GetData());
+
+    for (size_t i = 0; i < elements.size(); i += blobSize)
+    {
+      vector<OsmElement> const block(elements.begin() + i,
+                                     elements.begin() + min(i + blobSize, elements.size()));
+      WriteBlob("OSMData", MakePrimitiveBlock(block));
+    }
+    return m_stream;
+  }
+
+private:
+  uint64_t GetString(string const & s)
+  {
+    auto const it = m_strings.find(s);
+    if (it != m_strings.end())
+      return it->second;
+    uint64_t const index = m_strings.size();
+    m_strings[s] = index;
+    m_table.push_back(s);
+    return index;
+  }
+
+  void AddTags(ProtoWriter & writer, OsmElement const & e)
+  {
+    vector<uint64_t> keys, vals;
+    for (auto const & tag : e.Tags())
+    {
+      keys.push_back(GetString(tag.key));
+      vals.push_back(GetString(tag.value));
+    }
+    writer.AddPacked(2, keys);
+    writer.AddPacked(3, vals);
+  }
+
+  static int64_t ToCoord(double value) { return static_cast<int64_t>(round(value * 1e7)); }
+
+  string MakePrimitiveBlock(vector<OsmElement> const & elements)
+  {
+    // The first string is empty as the format requires.
+    m_strings.clear();
+    m_table.clear();
+    GetString("");
+
+    vector<string> groups;
+    for (size_t i = 0; i < elements.size();)
+    {
+      ProtoWriter group;
+      if (elements[i].type == OsmElement::EntityType::Node)
+      {
+        // Consecutive nodes are written as a single DenseNodes message.
+        vector<uint64_t> ids, lats, lons, keysVals;
+        int64_t prevId = 0, prevLat = 0, prevLon = 0;
+        for (; i < elements.size() && elements[i].type == OsmElement::EntityType::Node; ++i)
+        {
+          OsmElement const & e = elements[i];
+          int64_t const id = static_cast<int64_t>(e.id);
+          ids.push_back(ProtoWriter::ZigZag(id - prevId));
+          lats.push_back(ProtoWriter::ZigZag(ToCoord(e.lat) - prevLat));
+          lons.push_back(ProtoWriter::ZigZag(ToCoord(e.lon) - prevLon));
+          prevId = id;
+          prevLat = ToCoord(e.lat);
+          prevLon = ToCoord(e.lon);
+          for (auto const & tag : e.Tags())
+          {
+            keysVals.push_back(GetString(tag.key));
+            keysVals.push_back(GetString(tag.value));
+          }
+          keysVals.push_back(0);
+        }
+        ProtoWriter dense;
+        dense.AddPacked(1, ids);
+        dense.AddPacked(8, lats);
+        dense.AddPacked(9, lons);
+        dense.AddPacked(10, keysVals);
+        group.AddBytes(2, dense.GetData());
+      }
+      else if (elements[i].type == OsmElement::EntityType::Way)
+      {
+        OsmElement const & e = elements[i++];
+        ProtoWriter way;
+        way.AddVarint(1, e.id);
+        AddTags(way, e);
+        vector<uint64_t> refs;
+        int64_t prev = 0;
+        for (uint64_t const nd : e.Nodes())
+        {
+          refs.push_back(ProtoWriter::ZigZag(static_cast<int64_t>(nd) - prev));
+          prev = static_cast<int64_t>(nd);
+        }
+        way.AddPacked(8, refs);
+        group.AddBytes(3, way.GetData());
+      }
+      else
+      {
+        OsmElement const & e = elements[i++];
+        ProtoWriter relation;
+        relation.AddVarint(1, e.id);
+        AddTags(relation, e);
+        vector<uint64_t> roles, memids, types;
+        int64_t prev = 0;
+        for (auto const & member : e.Members())
+        {
+          roles.push_back(GetString(member.role));
+          memids.push_back(ProtoWriter::ZigZag(static_cast<int64_t>(member.ref) - prev));
+          prev = static_cast<int64_t>(member.ref);
+          if (member.type == OsmElement::EntityType::Node)
+            types.push_back(0);
+          else if (member.type == OsmElement::EntityType::Way)
+            types.push_back(1);
+          else
+            types.push_back(2);
+        }
+        relation.AddPacked(8, roles);
+        relation.AddPacked(9, memids);
+        relation.AddPacked(10, types);
+        group.AddBytes(4, relation.GetData());
+      }
+      groups.push_back(group.GetData());
+    }
+
+    ProtoWriter table;
+    for (string const & s : m_table)
+      table.AddBytes(1, s);
+
+    ProtoWriter block;
+    block.AddBytes(1, table.GetData());
+    for (string const & group : groups)
+      block.AddBytes(2, group);
+    // Parameters after the groups must be taken into account too.
+    block.AddVarint(17, 100);
+    return block.GetData();
+  }
+
+  void WriteBlob(string const & type, string const & data)
+  {
+    // Blobs are compressed and raw in turn.
+    ProtoWriter blob;
+    if (m_blobsCount++ % 2 == 0)
+    {
+      string compressed(compressBound(data.size()), 0);
+      uLongf size = compressed.size();
+      TEST_EQUAL(compress(reinterpret_cast<Bytef *>(&compressed[0]), &size,
+                          reinterpret_cast<Bytef const *>(data.data()), data.size()),
+                 Z_OK, ());
+      compressed.resize(size);
+      blob.AddVarint(2, data.size());
+      blob.AddBytes(3, compressed);
+    }
+    else
+    {
+      blob.AddBytes(1, data);
+    }
+
+    ProtoWriter header;
+    header.AddBytes(1, type);
+    header.AddVarint(3, blob.GetData().size());
+
+    uint32_t const headerSize = static_cast<uint32_t>(header.GetData().size());
+    for (int shift = 24; shift >= 0; shift -= 8)
+      m_stream.push_back(static_cast<char>((headerSize >> shift) & 0xFF));
+    m_stream += header.GetData();
+    m_stream += blob.GetData();
+  }
+
+  string m_stream;
+  size_t m_blobsCount = 0;
+  map<string, uint64_t> m_strings;
+  vector<string> m_table;
+};
+
+vector<OsmElement> ReadXML(char const * data)
+{
+  istringstream ss(data);
+  SourceReader reader(ss);
+  vector<OsmElement> elements;
+  BuildFeaturesFromXML(reader, [&elements](OsmElement * e) { elements.push_back(*e); });
+  return elements;
+}
+
+vector<OsmElement> ReadPBF(string const & data, size_t threadsCount)
+{
+  istringstream ss(data);
+  SourceReader reader(ss);
+  vector<OsmElement> elements;
+  BuildFeaturesFromPBF(reader, [&elements](OsmElement * e) { elements.push_back(*e); },
+                       threadsCount);
+  return elements;
+}
+}  // namespace
+
+UNIT_TEST(Source_To_Element_check_pbf_equivalence)
+{
+  for (char const * data : {way_xml_data, relation_xml_data})
+  {
+    vector<OsmElement> const elementsXML = ReadXML(data);
+    for (size_t blobSize : {1, 3, 100})
+    {
+      string const pbf = PbfWriter().Write(elementsXML, blobSize);
+      for (size_t threadsCount : {1, 2, 4})
+      {
+        vector<OsmElement> const elementsPBF = ReadPBF(pbf, threadsCount);
+        TEST_EQUAL(elementsXML, elementsPBF, (blobSize, threadsCount));
+      }
+    }
+  }
+}
@@ -1,6 +1,7 @@
 #include "testing/testing.hpp"
 
 #include "coding/parse_xml.hpp"
+#include "generator/osm_change_source.hpp"
 #include "generator/osm_source.hpp"
 #include "generator/osm_element.hpp"
 
@@ -64,3 +65,69 @@ UNIT_TEST(Source_To_Element_check_equivalence)
     TEST_EQUAL(elementsXML[i], elementsO5M[i], ());
   }
 }
+
+UNIT_TEST(Source_To_Element_check_o5m_threads_equivalence)
+{
+  string src(begin(relation_o5m_data), end(relation_o5m_data));
+
+  istringstream ss1(src);
+  SourceReader reader1(ss1);
+  vector<OsmElement> elements;
+  BuildFeaturesFromO5M(reader1, [&elements](OsmElement * e) { elements.push_back(*e); });
+
+  istringstream ss2(src);
+  SourceReader reader2(ss2);
+  vector<OsmElement> elementsParallel;
+  BuildFeaturesFromO5M(reader2, [&elementsParallel](OsmElement * e)
+  {
+    elementsParallel.push_back(*e);
+  }, 4 /* threadsCount */);
+
+  TEST_EQUAL(elements, elementsParallel, ());
+}
+
+UNIT_TEST(Source_To_Element_osm_change_test)
+{
+  char const osc[] = "<?xml version='1.0' encoding='UTF-8'?>\
+<osmChange version='0.6' generator='osmosis'>\
+<create>\
+<node id='10' version='1' lat='53.9' lon='27.5'><tag k='amenity' v='cafe'/></node>\
+<way id='20' version='1'><nd ref='10'/><nd ref='11'/></way>\
+</create>\
+<modify>\
+<node id='11' version='2' lat='53.8' lon='27.6'/>\
+</modify>\
+<delete>\
+<relation id='30' version='3'><member type='way' ref='20' role='outer'/></relation>\
+</delete>\
+</osmChange>";
+
+  istringstream ss(osc);
+  SourceReader reader(ss);
+
+  vector<pair<OsmChangeSource::Action, OsmElement>> changes;
+  OsmChangeSource parser([&changes](OsmChangeSource::Action action, OsmElement * e)
+  {
+    changes.emplace_back(action, *e);
+  });
+  ParseXMLSequence(reader, parser);
+
+  TEST_EQUAL(changes.size(), 4, ());
+
+  TEST_EQUAL(changes[0].first, OsmChangeSource::Action::Create, ());
+  TEST_EQUAL(changes[0].second.type, OsmElement::EntityType::Node, ());
+  TEST_EQUAL(changes[0].second.id, 10, ());
+  TEST_EQUAL(changes[0].second.Tags().size(), 1, ());
+
+  TEST_EQUAL(changes[1].first, OsmChangeSource::Action::Create, ());
+  TEST_EQUAL(changes[1].second.type, OsmElement::EntityType::Way, ());
+  TEST_EQUAL(changes[1].second.Nodes(), vector<uint64_t>({10, 11}), ());
+
+  TEST_EQUAL(changes[2].first, OsmChangeSource::Action::Modify, ());
+  TEST_EQUAL(changes[2].second.id, 11, ());
+  TEST_ALMOST_EQUAL_ULPS(changes[2].second.lat, 53.8, ());
+
+  TEST_EQUAL(changes[3].first, OsmChangeSource::Action::Delete, ());
+  TEST_EQUAL(changes[3].second.type, OsmElement::EntityType::Relation, ());
+  TEST_EQUAL(changes[3].second.Members().size(), 1, ());
+}
@@ -0,0 +1,97 @@
+#include "testing/testing.hpp"
+
+#include "generator/stages_profiler.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+#include "3party/jansson/myjansson.hpp"
+
+UNIT_TEST(StagesProfiler_Report)
+{
+  string const path = GetPlatform().WritablePathForFile("stages_profiler_test.mwm");
+  {
+    FilesContainerW cont(path);
+    cont.Write(vector<char>(10, 'a'), "first");
+    cont.Write(vector<char>(5, 'b'), "second");
+  }
+
+  stats::StagesProfiler profiler;
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "generate_features");
+    stage.SetElementsCount(100);
+  }
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "generate_index", "country");
+  }
+  profiler.AddFileSections("country", path);
+  // Missing files are skipped.
+  profiler.AddFileSections("missing", path + ".missing");
+  my::DeleteFileX(path);
+
+  TEST_EQUAL(profiler.GetStages().size(), 2, ());
+  TEST_EQUAL(profiler.GetFiles().size(), 1, ());
+
+  my::Json root(profiler.ToJSON().c_str());
+  TEST(json_is_object(root.get()), ());
+
+  json_t * stages = json_object_get(root.get(), "stages");
+  TEST_EQUAL(json_array_size(stages), 2, ());
+
+  json_t * features = json_array_get(stages, 0);
+  TEST_EQUAL(string(json_string_value(json_object_get(features, "name"))), "generate_features", ());
+  TEST(json_object_get(features, "file") == nullptr, ());
+  TEST_EQUAL(json_integer_value(json_object_get(features, "elements")), 100, ());
+  TEST(json_is_real(json_object_get(features, "seconds")), ());
+
+  json_t * index = json_array_get(stages, 1);
+  TEST_EQUAL(string(json_string_value(json_object_get(index, "file"))), "country", ());
+  TEST(json_object_get(index, "elements") == nullptr, ());
+
+  json_t * files = json_object_get(root.get(), "files");
+  TEST_EQUAL(json_array_size(files), 1, ());
+  json_t * file = json_array_get(files, 0);
+  TEST_EQUAL(string(json_string_value(json_object_get(file, "name"))), "country", ());
+  json_t * sections = json_object_get(file, "sections");
+  TEST_EQUAL(json_integer_value(json_object_get(sections, "first")), 10, ());
+  TEST_EQUAL(json_integer_value(json_object_get(sections, "second")), 5, ());
+  TEST_EQUAL(json_integer_value(json_object_get(file, "bytes")), 15, ());
+}
+
+UNIT_TEST(StagesProfiler_Merge)
+{
+  vector<string> reports;
+  for (string const country : {"Belarus", "Latvia"})
+  {
+    stats::StagesProfiler profiler;
+    {
+      stats::StagesProfiler::ScopedStage stage(profiler, "generate_geometry", country);
+      stage.SetElementsCount(10);
+    }
+    {
+      stats::StagesProfiler::ScopedStage stage(profiler, "generate_index", country);
+    }
+    reports.push_back(profiler.ToJSON());
+  }
+
+  string merged;
+  TEST(stats::StagesProfiler::MergeJSON(reports, merged), ());
+  my::Json root(merged.c_str());
+  TEST_EQUAL(json_integer_value(json_object_get(root.get(), "reports")), 2, ());
+  TEST_EQUAL(json_array_size(json_object_get(root.get(), "stages")), 4, ());
+
+  json_t * summary = json_object_get(root.get(), "stages_summary");
+  TEST_EQUAL(json_object_size(summary), 2, ());
+  json_t * geometry = json_object_get(summary, "generate_geometry");
+  TEST_EQUAL(json_integer_value(json_object_get(geometry, "count")), 2, ());
+  TEST_EQUAL(json_integer_value(json_object_get(geometry, "elements")), 20, ());
+  TEST_EQUAL(json_integer_value(json_object_get(json_object_get(summary, "generate_index"), "count")),
+             2, ());
+
+  TEST(!stats::StagesProfiler::MergeJSON({"not a json"}, merged), ());
+}
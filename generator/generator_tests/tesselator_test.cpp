@@ -4,6 +4,8 @@
 
 #include "base/logging.hpp"
 
+#include "std/algorithm.hpp"
+
 
 namespace
 {
@@ -72,3 +74,63 @@ UNIT_TEST(Tesselator_Odd)
 
   TEST_EQUAL(2, RunTest(l), ());
 }
+
+UNIT_TEST(Tesselator_Convex)
+{
+  // Fan of the convex contour keeps its orientation.
+  P arr[] = { P(0, 0), P(4, 0), P(5, 2), P(4, 4), P(0, 4) };
+  list<vector<P> > l;
+  l.push_back(vector<P>(arr, arr + ARRAY_SIZE(arr)));
+
+  tesselator::TrianglesInfo info;
+  TEST_EQUAL(3, tesselator::TesselateInterior(l, info), ());
+  info.ForEachTriangle([](P const & p1, P const & p2, P const & p3)
+  {
+    TEST_GREATER(m2::CrossProduct(p2 - p1, p3 - p1), 0.0, (p1, p2, p3));
+  });
+
+  reverse(l.back().begin(), l.back().end());
+  tesselator::TrianglesInfo reversed;
+  TEST_EQUAL(3, tesselator::TesselateInterior(l, reversed), ());
+  reversed.ForEachTriangle([](P const & p1, P const & p2, P const & p3)
+  {
+    TEST_LESS(m2::CrossProduct(p2 - p1, p3 - p1), 0.0, (p1, p2, p3));
+  });
+
+  // Contour with the collinear points is left to libtess2.
+  P collinear[] = { P(0, 0), P(2, 0), P(4, 0), P(4, 4), P(0, 4) };
+  TEST_EQUAL(3, RunTess(collinear, ARRAY_SIZE(collinear)), ());
+}
+
+UNIT_TEST(Tesselator_Star)
+{
+  // All the turns of the pentagram are the same, but only the tips have the odd winding.
+  P arr[] = { P(0, 10), P(6, -8), P(-9.5, 3), P(9.5, 3), P(-6, -8) };
+  TEST_EQUAL(5, RunTess(arr, ARRAY_SIZE(arr)), ());
+}
+
+UNIT_TEST(Tesselator_ProcessPortionsTwice)
+{
+  P arr[] = { P(0, 0), P(4, 0), P(5, 2), P(4, 4), P(0, 4), P(2, 2) };
+  list<vector<P> > l;
+  l.push_back(vector<P>(arr, arr + ARRAY_SIZE(arr)));
+
+  tesselator::TrianglesInfo info;
+  TEST_GREATER(tesselator::TesselateInterior(l, info), 0, ());
+
+  tesselator::PointsInfo points;
+  info.GetPointsInfo(m2::PointU(0, 0), m2::PointU(100, 100), [](m2::PointD const & p)
+  {
+    return m2::PointU(static_cast<uint32_t>(p.x * 10), static_cast<uint32_t>(p.y * 10));
+  }, points);
+
+  // The triangles are kept to be serialized for several scales.
+  size_t chains[2] = {0, 0};
+  for (size_t & count : chains)
+  {
+    auto emitter = [&count](m2::PointU const *, vector<tesselator::Edge> const &) { ++count; };
+    info.ProcessPortions(points, emitter);
+  }
+  TEST_GREATER(chains[0], 0, ());
+  TEST_EQUAL(chains[0], chains[1], ());
+}
@@ -1,4 +1,7 @@
+#include "generator/build_manifest.hpp"
 #include "generator/feature_generator.hpp"
+#include "generator/feature_attributes_generator.hpp"
+#include "generator/feature_scales_generator.hpp"
 #include "generator/feature_sorter.hpp"
 #include "generator/update_generator.hpp"
 #include "generator/borders_generator.hpp"
@@ -7,9 +10,14 @@
 #include "generator/statistics.hpp"
 #include "generator/unpack_mwm.hpp"
 #include "generator/generate_info.hpp"
+#include "generator/landmarks_generator.hpp"
+#include "generator/houses_index_generator.hpp"
+#include "generator/locality_index_generator.hpp"
+#include "generator/road_graph_generator.hpp"
 #include "generator/check_model.hpp"
 #include "generator/routing_generator.hpp"
 #include "generator/osm_source.hpp"
+#include "generator/stages_profiler.hpp"
 
 #include "indexer/drawing_rules.hpp"
 #include "indexer/classificator_loader.hpp"
@@ -19,8 +27,13 @@
 #include "indexer/index_builder.hpp"
 #include "indexer/search_index_builder.hpp"
 
+#include "coding/container_diff.hpp"
 #include "coding/file_name_utils.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
 
+#include "base/stl_add.hpp"
+#include "base/string_utils.hpp"
 #include "base/timer.hpp"
 
 #include "defines.hpp"
@@ -38,6 +51,7 @@
 DEFINE_bool(generate_update, false,
               "If specified, update.maps file will be generated from cells in the data path");
 
+DEFINE_bool(generate_countries_binary, false, "Generate countries.bin from countries.txt.");
 DEFINE_bool(generate_classif, false, "Generate classificator.");
 
 DEFINE_bool(preprocess, false, "1st pass - create nodes/ways/relations data");
@@ -46,33 +60,153 @@ DEFINE_bool(emit_coasts, false, "push coasts features from intermediate file to
 
 DEFINE_bool(generate_features, false, "2nd pass - generate intermediate features");
 DEFINE_bool(generate_geometry, false, "3rd pass - split and simplify geometry and triangles for features");
+DEFINE_uint64(geometry_threads_count, 1, "Number of threads to simplify and triangulate geometry of a country");
 DEFINE_bool(generate_index, false, "4rd pass - generate index");
+DEFINE_uint64(index_threads_count, 1, "Number of threads to cover features and build scale index of a country");
 DEFINE_bool(generate_search_index, false, "5th pass - generate search index");
+DEFINE_uint64(search_index_threads_count, 1, "Number of threads to make search tokens of a country");
+DEFINE_uint64(search_index_memory_mb, indexer::kSearchIndexMaxMemoryBytes / (1024 * 1024),
+              "Memory cap of the search tokens of a country, they are sorted and spilled to disk "
+              "by groups above it");
 DEFINE_bool(calc_statistics, false, "Calculate feature statistics for specified mwm bucket files");
 DEFINE_bool(type_statistics, false, "Calculate statistics by type for specified mwm bucket files");
 DEFINE_bool(preload_cache, false, "Preload all ways and relations cache");
-DEFINE_string(node_storage, "map", "Type of storage for intermediate points representation. Available: raw, map, mem");
+DEFINE_bool(compress_cache, false, "Compress ways and relations cache by blocks, use it for all the passes");
+DEFINE_string(node_storage, "map", "Type of storage for intermediate points representation. Available: raw, map, mem, packed");
 DEFINE_string(data_path, "", "Working directory, 'path_to_exe/../../data' if empty.");
 DEFINE_string(output, "", "File name for process (without 'mwm' ext).");
 DEFINE_string(intermediate_data_path, "", "Path to stored nodes, ways, relations.");
 DEFINE_bool(generate_world, false, "Generate separate world file");
+DEFINE_uint64(world_merge_threads_count, 0, "Number of threads to merge world line features by "
+              "cells spilled to disk, 0 merges them in memory on one thread");
 DEFINE_bool(split_by_polygons, false, "Use countries borders to split planet by regions and countries");
 DEFINE_bool(dump_types, false, "Prints all types combinations and their total count");
 DEFINE_bool(dump_prefixes, false, "Prints statistics on feature's' name prefixes");
 DEFINE_bool(dump_search_tokens, false, "Print statistics on search tokens.");
+DEFINE_bool(benchmark_normalization, false, "Print throughput of the names normalization.");
 DEFINE_bool(unpack_mwm, false, "Unpack each section of mwm into a separate file with name filePath.sectionName.");
 DEFINE_bool(generate_packed_borders, false, "Generate packed file with country polygons.");
 DEFINE_bool(check_mwm, false, "Check map file to be correct.");
 DEFINE_string(delete_section, "", "Delete specified section (defines.hpp) from container.");
+DEFINE_string(compress_sections, "", "Comma-separated sections to compress by blocks for the seekable "
+              "reads, e.g. 'geom,trg,meta'. Compressed mwms aren't read by the older apps.");
+DEFINE_uint64(compress_block_size, 64 * 1024, "Size of the blocks of the compressed sections.");
+DEFINE_string(benchmark_compression, "", "Comma-separated sections to print the size and the read "
+              "throughput of when they are compressed.");
 DEFINE_bool(fail_on_coasts, false, "Stop and exit with '255' code if some coastlines are not merged.");
 DEFINE_bool(generate_addresses_file, false, "Generate .addr file (for '--output' option) with full addresses list.");
 DEFINE_string(osrm_file_name, "", "Input osrm file to generate routing info");
 DEFINE_bool(make_routing, false, "Make routing info based on osrm file");
 DEFINE_bool(make_cross_section, false, "Make corss section in routing file for cross mwm routing");
+DEFINE_bool(make_turns_info, false, "Make section of junction descriptors in routing file for turns");
+DEFINE_bool(make_cross_mwm_overlay, false, "Make overlay graph of cross sections of all routing files");
+DEFINE_bool(make_pedestrian_landmarks, false, "Make landmarks section in mwm file for pedestrian routing");
+DEFINE_bool(make_pedestrian_graph, false, "Make road graph section in mwm file for pedestrian routing");
+DEFINE_bool(make_bicycle_graph, false, "Make road graph section in mwm file for bicycle routing");
+DEFINE_bool(make_pedestrian_cross_context, false, "Make border vertices section in mwm file for cross mwm pedestrian routing");
+DEFINE_bool(make_locality_index, false, "Make locality index section in world mwm file for search");
+DEFINE_bool(make_houses_index, false, "Make houses index section in mwm file for address search");
 DEFINE_string(osm_file_name, "", "Input osm area file");
-DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m]");
+DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m, pbf]");
+DEFINE_string(osm_change_file_name, "", "OsmChange (.osc) file to update the intermediate data "
+              "with on --preprocess, then only the affected countries are generated from "
+              "the updated --osm_file_name");
+DEFINE_uint64(osm_threads_count, 1, "Number of threads to decode the input osm file");
 DEFINE_string(user_resource_path, "", "User defined resource path for classificator.txt and etc.");
 DEFINE_uint64(planet_version, my::TodayAsYYMMDD(), "Version as YYMMDD, by default - today");
+DEFINE_string(diff_from, "", "Older mwm file to make the diff (.mwmdiff) to the '--output' mwm from, "
+              "it's served as diffs/<old version>/<name>.mwmdiff next to the new maps.");
+DEFINE_string(stages_report, "", "JSON file to write durations, peak memory and throughput of "
+              "the generator stages and section sizes of the generated files to");
+DEFINE_string(write_manifest, "", "JSON manifest to write the jobs of '--manifest_stages' for each "
+              "generated country to, for the distributed build.");
+DEFINE_string(manifest_stages, "generate_geometry,generate_index,generate_search_index",
+              "Comma-separated stages of the manifest jobs.");
+DEFINE_string(manifest_osrm_path, "", "Directory of <country>.osrm files for the routing jobs of "
+              "the manifest, '--intermediate_data_path' if empty.");
+DEFINE_string(manifest, "", "Manifest of the distributed build, see '--job', '--list_ready_jobs' "
+              "and '--merge_stages_reports'.");
+DEFINE_string(job, "", "Id of the manifest job to run, the job is marked done on success.");
+DEFINE_bool(list_ready_jobs, false, "Print ids of the manifest jobs which are not done and all "
+            "of their dependencies are done.");
+DEFINE_string(merge_stages_reports, "", "JSON file to merge the stages reports of the done "
+              "manifest jobs to.");
+
+namespace
+{
+void WriteStagesReport(stats::StagesProfiler const & profiler)
+{
+  if (!FLAGS_stages_report.empty())
+    profiler.WriteJSON(FLAGS_stages_report);
+}
+
+/// Sets the flags like "--name=value" or "--name", the flags from the command line are kept.
+bool SetFlags(vector<string> const & args)
+{
+  for (string const & arg : args)
+  {
+    size_t const start = arg.find_first_not_of('-');
+    size_t const eq = arg.find('=');
+    string const name = arg.substr(start, eq == string::npos ? string::npos : eq - start);
+    string const value = eq == string::npos ? "true" : arg.substr(eq + 1);
+    if (google::SetCommandLineOptionWithMode(name.c_str(), value.c_str(),
+                                             google::SET_FLAGS_DEFAULT).empty())
+    {
+      LOG(LERROR, ("Can't set flag", arg));
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WriteManifest(feature::GenerateInfo const & genInfo, string const & dataPath)
+{
+  manifest::Manifest buildManifest;
+  vector<string> & commonArgs = buildManifest.m_commonArgs;
+  commonArgs.push_back("--data_path=" + dataPath);
+  if (!FLAGS_intermediate_data_path.empty())
+    commonArgs.push_back("--intermediate_data_path=" + FLAGS_intermediate_data_path);
+  if (!FLAGS_user_resource_path.empty())
+    commonArgs.push_back("--user_resource_path=" + FLAGS_user_resource_path);
+  commonArgs.push_back("--planet_version=" + strings::to_string(FLAGS_planet_version));
+
+  vector<string> stages;
+  strings::Tokenize(FLAGS_manifest_stages, ",", MakeBackInsertFunctor(stages));
+  string const osrmDir =
+      FLAGS_manifest_osrm_path.empty() ? genInfo.m_intermediateDir : FLAGS_manifest_osrm_path;
+  try
+  {
+    manifest::MakeJobs(genInfo.m_bucketNames, stages, genInfo, osrmDir, buildManifest);
+  }
+  catch (manifest::ManifestException const & ex)
+  {
+    LOG(LERROR, (ex.Msg()));
+    return false;
+  }
+  return manifest::Save(buildManifest, FLAGS_write_manifest);
+}
+
+bool MergeStagesReports(manifest::Manifest const & buildManifest,
+                        manifest::JobsState const & state)
+{
+  vector<string> reports;
+  for (manifest::Job const & job : buildManifest.m_jobs)
+  {
+    string const reportPath = state.GetReportPath(job.GetId());
+    if (!state.IsDone(job.GetId()) || !Platform::IsFileExistsByFullPath(reportPath))
+      continue;
+    reports.emplace_back();
+    FileReader(reportPath).ReadAsString(reports.back());
+  }
+  LOG(LINFO, ("Merging", reports.size(), "stages reports of", buildManifest.m_jobs.size(), "jobs"));
+
+  string merged;
+  if (!stats::StagesProfiler::MergeJSON(reports, merged))
+    return false;
+  FileWriter(FLAGS_merge_stages_reports).Write(merged.data(), merged.size());
+  return true;
+}
+}  // namespace
 
 int main(int argc, char ** argv)
 {
@@ -81,6 +215,48 @@ int main(int argc, char ** argv)
 
   google::ParseCommandLineFlags(&argc, &argv, true);
 
+  if (!FLAGS_manifest.empty())
+  {
+    manifest::Manifest buildManifest;
+    if (!manifest::Load(FLAGS_manifest, buildManifest))
+      return -1;
+    manifest::JobsState const state(FLAGS_manifest);
+
+    if (FLAGS_list_ready_jobs)
+    {
+      for (manifest::Job const * job : state.GetReadyJobs(buildManifest))
+        cout << job->GetId() << endl;
+      return 0;
+    }
+
+    if (!FLAGS_merge_stages_reports.empty())
+      return MergeStagesReports(buildManifest, state) ? 0 : -1;
+
+    if (!FLAGS_job.empty())
+    {
+      manifest::Job const * job = buildManifest.FindJob(FLAGS_job);
+      if (job == nullptr)
+      {
+        LOG(LERROR, ("No job", FLAGS_job, "in", FLAGS_manifest));
+        return -1;
+      }
+      if (state.IsDone(FLAGS_job))
+      {
+        LOG(LINFO, ("Job", FLAGS_job, "is already done"));
+        return 0;
+      }
+      if (!state.IsReady(*job))
+      {
+        LOG(LERROR, ("Dependencies of job", FLAGS_job, "are not done:", job->m_dependencies));
+        return -1;
+      }
+      if (!SetFlags(buildManifest.m_commonArgs) || !SetFlags(job->m_args))
+        return -1;
+      if (FLAGS_stages_report.empty())
+        FLAGS_stages_report = state.GetReportPath(FLAGS_job);
+    }
+  }
+
   Platform & pl = GetPlatform();
 
   if (!FLAGS_user_resource_path.empty())
@@ -103,8 +279,13 @@ int main(int argc, char ** argv)
   }
 
   genInfo.m_osmFileName = FLAGS_osm_file_name;
+  genInfo.m_osmChangeFileName = FLAGS_osm_change_file_name;
+  genInfo.m_osmThreadsCount = static_cast<size_t>(FLAGS_osm_threads_count);
+  genInfo.m_geometryThreadsCount = static_cast<size_t>(FLAGS_geometry_threads_count);
+  genInfo.m_worldMergeThreadsCount = static_cast<size_t>(FLAGS_world_merge_threads_count);
   genInfo.m_failOnCoasts = FLAGS_fail_on_coasts;
   genInfo.m_preloadCache = FLAGS_preload_cache;
+  genInfo.m_compressCache = FLAGS_compress_cache;
 
   genInfo.m_versionDate = static_cast<uint32_t>(FLAGS_planet_version);
 
@@ -113,21 +294,44 @@ int main(int argc, char ** argv)
   if (!FLAGS_osm_file_type.empty())
     genInfo.SetOsmFileType(FLAGS_osm_file_type);
 
+  stats::StagesProfiler profiler;
+
   // Generating intermediate files
-  if (FLAGS_preprocess)
+  if (FLAGS_preprocess && !FLAGS_osm_change_file_name.empty())
+  {
+    LOG(LINFO, ("Updating intermediate data ...."));
+    {
+      stats::StagesProfiler::ScopedStage stage(profiler, "update_intermediate_data");
+      if (!UpdateIntermediateData(genInfo))
+        return -1;
+      stage.SetElementsCount(genInfo.m_osmElementsCount);
+    }
+
+    if (genInfo.m_countriesToGenerate.empty())
+    {
+      LOG(LINFO, ("No countries are affected by", FLAGS_osm_change_file_name));
+      WriteStagesReport(profiler);
+      return 0;
+    }
+  }
+  else if (FLAGS_preprocess)
   {
     LOG(LINFO, ("Generating intermediate data ...."));
+    stats::StagesProfiler::ScopedStage stage(profiler, "preprocess");
     if (!GenerateIntermediateData(genInfo))
     {
       return -1;
     }
+    stage.SetElementsCount(genInfo.m_osmElementsCount);
   }
 
   // load classificator only if necessary
   if (FLAGS_make_coasts || FLAGS_generate_features || FLAGS_generate_geometry ||
       FLAGS_generate_index || FLAGS_generate_search_index ||
       FLAGS_calc_statistics || FLAGS_type_statistics || FLAGS_dump_types || FLAGS_dump_prefixes ||
-      FLAGS_check_mwm)
+      FLAGS_check_mwm || FLAGS_make_pedestrian_landmarks || FLAGS_make_pedestrian_graph ||
+      FLAGS_make_bicycle_graph || FLAGS_make_pedestrian_cross_context || FLAGS_make_locality_index ||
+      FLAGS_make_houses_index || FLAGS_benchmark_normalization)
   {
     classificator::Load();
     classif().SortClassificator();
@@ -145,8 +349,13 @@ int main(int argc, char ** argv)
     genInfo.m_fileName = FLAGS_output;
     genInfo.m_genAddresses = FLAGS_generate_addresses_file;
 
-    if (!GenerateFeatures(genInfo))
-      return -1;
+    {
+      stats::StagesProfiler::ScopedStage stage(
+          profiler, FLAGS_make_coasts ? "make_coasts" : "generate_features");
+      if (!GenerateFeatures(genInfo))
+        return -1;
+      stage.SetElementsCount(genInfo.m_osmElementsCount);
+    }
 
     if (FLAGS_generate_world)
     {
@@ -160,7 +369,11 @@ int main(int argc, char ** argv)
       genInfo.m_bucketNames.push_back(FLAGS_output);
   }
 
+  if (!FLAGS_write_manifest.empty() && !WriteManifest(genInfo, path))
+    return -1;
+
   // Enumerate over all dat files that were created.
+  bool hasFailures = false;
   size_t const count = genInfo.m_bucketNames.size();
   for (size_t i = 0; i < count; ++i)
   {
@@ -176,9 +389,11 @@ int main(int argc, char ** argv)
       if (country == WORLD_COASTS_FILE_NAME)
         mapType = feature::DataHeader::worldcoasts;
 
+      stats::StagesProfiler::ScopedStage stage(profiler, "generate_geometry", country);
       if (!feature::GenerateFinalFeatures(genInfo, country, mapType))
       {
         // If error - move to next bucket without index generation
+        hasFailures = true;
         continue;
       }
     }
@@ -189,17 +404,31 @@ int main(int argc, char ** argv)
     {
       LOG(LINFO, ("Generating index for ", datFile));
 
-      if (!indexer::BuildIndexFromDatFile(datFile, FLAGS_intermediate_data_path + country))
+      stats::StagesProfiler::ScopedStage stage(profiler, "generate_index", country);
+      if (!indexer::BuildIndexFromDatFile(datFile, FLAGS_intermediate_data_path + country,
+                                          FLAGS_index_threads_count))
         LOG(LCRITICAL, ("Error generating index."));
+      if (!feature::BuildScalesTableFromDatFile(datFile))
+        LOG(LCRITICAL, ("Error generating feature scales."));
+      if (!feature::BuildAttributesTableFromDatFile(datFile))
+        LOG(LCRITICAL, ("Error generating feature attributes."));
     }
 
     if (FLAGS_generate_search_index)
     {
       LOG(LINFO, ("Generating search index for ", datFile));
 
-      if (!indexer::BuildSearchIndexFromDatFile(datFile, true))
+      stats::StagesProfiler::ScopedStage stage(profiler, "generate_search_index", country);
+      indexer::SearchIndexStats searchStats;
+      if (!indexer::BuildSearchIndexFromDatFile(datFile, true, FLAGS_search_index_threads_count,
+                                                FLAGS_search_index_memory_mb * 1024 * 1024,
+                                                &searchStats))
         LOG(LCRITICAL, ("Error generating search index."));
+      stage.SetElementsCount(searchStats.m_pairsCount);
     }
+
+    if (FLAGS_generate_geometry || FLAGS_generate_index || FLAGS_generate_search_index)
+      profiler.AddFileSections(country, datFile);
   }
 
   // Create http update list for countries and corresponding files
@@ -209,6 +438,13 @@ int main(int argc, char ** argv)
     update::UpdateCountries(path);
   }
 
+  if (FLAGS_generate_countries_binary)
+  {
+    LOG(LINFO, ("Generating binary countries file..."));
+    if (!update::GenerateCountriesBinary(path))
+      LOG(LCRITICAL, ("Error generating binary countries file."));
+  }
+
   string const datFile = path + FLAGS_output + DATA_FILE_EXTENSION;
 
   if (FLAGS_calc_statistics)
@@ -241,23 +477,127 @@ int main(int argc, char ** argv)
   if (FLAGS_dump_search_tokens)
     feature::DumpSearchTokens(datFile);
 
+  if (FLAGS_benchmark_normalization)
+    feature::BenchmarkNormalization(datFile);
+
   if (FLAGS_unpack_mwm)
     UnpackMwm(datFile);
 
   if (!FLAGS_delete_section.empty())
     DeleteSection(datFile, FLAGS_delete_section);
 
+  if (!FLAGS_compress_sections.empty())
+  {
+    vector<string> tags;
+    strings::Tokenize(FLAGS_compress_sections, ",", MakeBackInsertFunctor(tags));
+    CompressSections(datFile, tags, static_cast<uint32_t>(FLAGS_compress_block_size));
+  }
+
+  if (!FLAGS_benchmark_compression.empty())
+  {
+    vector<string> tags;
+    strings::Tokenize(FLAGS_benchmark_compression, ",", MakeBackInsertFunctor(tags));
+    BenchmarkCompression(datFile, tags, static_cast<uint32_t>(FLAGS_compress_block_size));
+  }
+
   if (FLAGS_generate_packed_borders)
     borders::GeneratePackedBorders(path);
 
   if (FLAGS_check_mwm)
     check_model::ReadFeatures(datFile);
 
+  if (FLAGS_make_pedestrian_landmarks)
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_pedestrian_landmarks", FLAGS_output);
+    routing::BuildPedestrianLandmarks(path, FLAGS_output);
+  }
+
+  if (FLAGS_make_pedestrian_graph)
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_pedestrian_graph", FLAGS_output);
+    routing::BuildPedestrianRoadGraph(path, FLAGS_output);
+  }
+
+  if (FLAGS_make_bicycle_graph)
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_bicycle_graph", FLAGS_output);
+    routing::BuildBicycleRoadGraph(path, FLAGS_output);
+  }
+
+  if (FLAGS_make_pedestrian_cross_context)
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_pedestrian_cross_context", FLAGS_output);
+    routing::BuildPedestrianCrossContext(path, FLAGS_output);
+  }
+
+  if (FLAGS_make_locality_index)
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_locality_index", FLAGS_output);
+    indexer::BuildLocalityIndex(path, FLAGS_output);
+  }
+
+  if (FLAGS_make_houses_index)
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_houses_index", FLAGS_output);
+    indexer::BuildHousesIndex(path, FLAGS_output);
+  }
+
   if (!FLAGS_osrm_file_name.empty() && FLAGS_make_routing)
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_routing", FLAGS_output);
     routing::BuildRoutingIndex(path, FLAGS_output, FLAGS_osrm_file_name);
+  }
 
   if (!FLAGS_osrm_file_name.empty() && FLAGS_make_cross_section)
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_cross_section", FLAGS_output);
     routing::BuildCrossRoutingIndex(path, FLAGS_output, FLAGS_osrm_file_name);
+  }
+
+  if (FLAGS_make_turns_info)
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_turns_info", FLAGS_output);
+    routing::BuildTurnsInfo(path, FLAGS_output);
+  }
 
+  if (FLAGS_make_cross_mwm_overlay)
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_cross_mwm_overlay");
+    routing::BuildCrossMwmOverlay(path);
+  }
+
+  if (!FLAGS_diff_from.empty())
+  {
+    stats::StagesProfiler::ScopedStage stage(profiler, "make_diff", FLAGS_output);
+    string const diffFile = path + FLAGS_output + DIFF_FILE_EXTENSION;
+    LOG(LINFO, ("Making diff", diffFile, "from", FLAGS_diff_from));
+    if (!diff::MakeContainerDiff(FLAGS_diff_from, datFile, diffFile))
+    {
+      WriteStagesReport(profiler);
+      return -1;
+    }
+  }
+
+  if (FLAGS_make_pedestrian_landmarks || FLAGS_make_pedestrian_graph || FLAGS_make_bicycle_graph ||
+      FLAGS_make_pedestrian_cross_context || FLAGS_make_locality_index || FLAGS_make_houses_index)
+  {
+    profiler.AddFileSections(FLAGS_output, datFile);
+  }
+  if ((!FLAGS_osrm_file_name.empty() && (FLAGS_make_routing || FLAGS_make_cross_section)) ||
+      FLAGS_make_turns_info)
+  {
+    profiler.AddFileSections(FLAGS_output + ROUTING_FILE_EXTENSION,
+                             datFile + ROUTING_FILE_EXTENSION);
+  }
+
+  WriteStagesReport(profiler);
+
+  // The failed job isn't marked, so it's run again when the build is resumed.
+  if (!FLAGS_job.empty())
+  {
+    if (hasFailures || !manifest::JobsState(FLAGS_manifest).MarkDone(FLAGS_job))
+      return -1;
+    LOG(LINFO, ("Job", FLAGS_job, "is done"));
+  }
   return 0;
 }
@@ -0,0 +1,123 @@
+#include "generator/houses_index_generator.hpp"
+
+#include "indexer/data_header.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/feature_impl.hpp"
+#include "indexer/feature_processor.hpp"
+#include "indexer/ftypes_matcher.hpp"
+#include "indexer/houses_index.hpp"
+#include "indexer/mercator.hpp"
+
+#include "geometry/distance.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include "std/limits.hpp"
+
+#include "defines.hpp"
+
+namespace indexer
+{
+namespace
+{
+// The same as search::HouseDetector::DEFAULT_OFFSET_M, the houses which are farther from
+// the streets are not found by the search.
+double constexpr kMaxHouseToStreetDistanceM = 200.0;
+
+struct Segment
+{
+  uint32_t m_street;
+  m2::ProjectionToSection<m2::PointD> m_projection;
+};
+}  // namespace
+
+void BuildHousesIndex(string const & baseDir, string const & countryName)
+{
+  string const mwmFile = baseDir + countryName + DATA_FILE_EXTENSION;
+  LOG(LINFO, ("Building houses index for", mwmFile));
+  my::Timer timer;
+
+  vector<HousesIndex::Street> streets;
+  vector<Segment> segments;
+  m4::Tree<uint32_t> segmentsTree;
+  vector<HousesIndex::House> houses;
+
+  auto const addFeature = [&](FeatureType const & ft, uint32_t index)
+  {
+    if (ft.GetFeatureType() == feature::GEOM_LINE && ftypes::IsStreetChecker::Instance()(ft))
+    {
+      string name;
+      if (!ft.GetName(FeatureType::DEFAULT_LANG, name) || name.empty())
+        return;
+
+      uint32_t const street = static_cast<uint32_t>(streets.size());
+      streets.emplace_back();
+      streets.back().m_featureId = index;
+
+      ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+      for (size_t i = 1; i < ft.GetPointsCount(); ++i)
+      {
+        m2::PointD const & p0 = ft.GetPoint(i - 1);
+        m2::PointD const & p1 = ft.GetPoint(i);
+        Segment segment;
+        segment.m_street = street;
+        segment.m_projection.SetBounds(p0, p1);
+        m2::RectD rect(p0, p1);
+        segmentsTree.Add(static_cast<uint32_t>(segments.size()), rect);
+        segments.push_back(segment);
+      }
+      return;
+    }
+
+    if (!ftypes::IsBuildingChecker::Instance()(ft))
+      return;
+    string const number = ft.GetHouseNumber();
+    if (!feature::IsHouseNumber(number))
+      return;
+    houses.emplace_back(number, index, ft.GetLimitRect(FeatureType::BEST_GEOMETRY).Center());
+  };
+  feature::ForEachFromDat(mwmFile, addFeature);
+  segmentsTree.Optimize();
+
+  size_t attributed = 0;
+  for (HousesIndex::House const & house : houses)
+  {
+    m2::RectD const rect =
+        MercatorBounds::RectByCenterXYAndSizeInMeters(house.m_point, kMaxHouseToStreetDistanceM);
+    double minDistance = numeric_limits<double>::max();
+    uint32_t nearest = numeric_limits<uint32_t>::max();
+    segmentsTree.ForEachInRect(rect, [&](uint32_t i)
+    {
+      Segment const & segment = segments[i];
+      double const distance =
+          MercatorBounds::DistanceOnEarth(house.m_point, segment.m_projection(house.m_point));
+      if (distance < minDistance ||
+          (distance == minDistance && segment.m_street < nearest))
+      {
+        minDistance = distance;
+        nearest = segment.m_street;
+      }
+    });
+    if (minDistance > kMaxHouseToStreetDistanceM)
+      continue;
+    streets[nearest].m_houses.push_back(house);
+    ++attributed;
+  }
+
+  uint32_t const coordBits =
+      feature::DataHeader((FilesContainerR(mwmFile))).GetDefCodingParams().GetCoordBits();
+
+  FilesContainerW container(mwmFile, FileWriter::OP_WRITE_EXISTING);
+  FileWriter writer = container.GetWriter(HOUSES_INDEX_FILE_TAG);
+  uint64_t const startPos = writer.Pos();
+  HousesIndex::Serialize(streets, coordBits, writer);
+  LOG(LINFO, ("Streets:", streets.size(), "houses:", attributed, "of", houses.size(),
+              "section size, bytes:", writer.Pos() - startPos, "elapsed, seconds:",
+              timer.ElapsedSeconds()));
+}
+}  // namespace indexer
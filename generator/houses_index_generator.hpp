@@ -0,0 +1,12 @@
+#pragma once
+
+#include "std/string.hpp"
+
+namespace indexer
+{
+/// Builds houses index section (see indexer/houses_index.hpp) and writes it into the mwm.
+/// The houses with numbers are attributed to the nearest named street.
+/// @param[in]  baseDir   Full path to .mwm files directory.
+/// @param[in]  countryName   Country name same with .mwm file name.
+void BuildHousesIndex(string const & baseDir, string const & countryName);
+}  // namespace indexer
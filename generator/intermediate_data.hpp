@@ -2,10 +2,15 @@
 
 #include "generator/intermediate_elements.hpp"
 
+#include "coding/buffered_file_writer.hpp"
+#include "coding/byte_stream.hpp"
+#include "coding/compressed_section.hpp"
 #include "coding/file_name_utils.hpp"
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
 #include "coding/mmap_reader.hpp"
+#include "coding/varint.hpp"
 
 #include "base/logging.hpp"
 
@@ -13,6 +18,7 @@
 #include "std/deque.hpp"
 #include "std/exception.hpp"
 #include "std/limits.hpp"
+#include "std/unique_ptr.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
 
@@ -27,6 +33,9 @@ namespace cache
 
 enum class EMode { Write = true, Read = false };
 
+/// Selects constructors which open existing caches to update them.
+struct AppendTag {};
+
 namespace detail
 {
 template <class TFile, class TValue>
@@ -60,6 +69,8 @@ class IndexFile
 
 public:
   explicit IndexFile(string const & name) : m_file(name.c_str()) {}
+  /// Adds elements to the existing file, used in Write mode only.
+  IndexFile(string const & name, AppendTag) : m_file(name.c_str(), FileWriter::OP_APPEND) {}
 
   string GetFileName() const { return m_file.GetName(); }
 
@@ -94,6 +105,8 @@ public:
     m_file.Read(0, &m_elements[0], CheckedCast(fileSize));
 
     sort(m_elements.begin(), m_elements.end(), ElementComparator());
+    // Updates of the intermediate data may add the same elements again.
+    m_elements.erase(unique(m_elements.begin(), m_elements.end()), m_elements.end());
 
     LOG_SHORT(LINFO, ("Offsets reading is finished"));
   }
@@ -106,10 +119,12 @@ public:
     m_elements.push_back(make_pair(k, v));
   }
 
+  /// Gets the greatest value by the key, when an element is updated its new offset is greater
+  /// than the old ones.
   bool GetValueByKey(TKey key, TValue & value) const
   {
-    auto it = lower_bound(m_elements.begin(), m_elements.end(), key, ElementComparator());
-    if ((it != m_elements.end()) && ((*it).first == key))
+    auto it = upper_bound(m_elements.begin(), m_elements.end(), key, ElementComparator());
+    if ((it != m_elements.begin()) && ((*(--it)).first == key))
     {
       value = (*it).second;
       return true;
@@ -128,6 +143,108 @@ public:
     }
   }
 };
+
+// Elements are read at random, so the blocks are small.
+uint32_t constexpr kCacheBlockSize = 16 * 1024;
+size_t constexpr kCacheBlockCacheBytes = 64 * 1024 * 1024;
+
+/// File of OSMElementCache. A compressed cache is written by blocks to name + COMPRESSED_CACHE_EXT
+/// and it's mapped when it's read, so only the recently used blocks take memory.
+template <EMode TMode>
+class CacheStorage;
+
+template <>
+class CacheStorage<EMode::Write>
+{
+public:
+  CacheStorage(string const & name, bool compress)
+  {
+    if (!compress)
+    {
+      m_file.reset(new BufferedFileWriter(name));
+      return;
+    }
+    m_file.reset(new BufferedFileWriter(name + COMPRESSED_CACHE_EXT));
+    m_compressed.reset(new compressed_section::CompressedWriter(*m_file, kCacheBlockSize));
+  }
+
+  CacheStorage(string const & name, bool compress, AppendTag)
+  {
+    if (!compress)
+    {
+      // Offsets of the elements are taken from Pos(), it's not valid in the append mode.
+      m_file.reset(new BufferedFileWriter(name, FileWriter::OP_WRITE_EXISTING));
+      m_file->Seek(m_file->Size());
+      return;
+    }
+
+    // The compressed file can't be continued, so its data is copied to the new one.
+    string const fileName = name + COMPRESSED_CACHE_EXT;
+    string const oldFileName = fileName + ".old";
+    CHECK(my::RenameFileX(fileName, oldFileName), (fileName));
+    m_file.reset(new BufferedFileWriter(fileName));
+    m_compressed.reset(new compressed_section::CompressedWriter(*m_file, kCacheBlockSize));
+    {
+      compressed_section::BlockCache cache(kCacheBlockSize);
+      compressed_section::CompressedReader const reader(new FileReader(oldFileName), cache);
+      vector<char> buffer(kCacheBlockSize);
+      for (uint64_t pos = 0; pos < reader.Size(); pos += buffer.size())
+      {
+        size_t const size = static_cast<size_t>(min<uint64_t>(buffer.size(), reader.Size() - pos));
+        reader.Read(pos, buffer.data(), size);
+        m_compressed->Write(buffer.data(), size);
+      }
+    }
+    my::DeleteFileX(oldFileName);
+  }
+
+  int64_t Pos() const { return m_compressed ? m_compressed->Pos() : m_file->Pos(); }
+
+  void Write(void const * p, size_t size)
+  {
+    if (m_compressed)
+      m_compressed->Write(p, size);
+    else
+      m_file->Write(p, size);
+  }
+
+private:
+  unique_ptr<BufferedFileWriter> m_file;
+  // It's destroyed before m_file to complete the section.
+  unique_ptr<compressed_section::CompressedWriter> m_compressed;
+};
+
+template <>
+class CacheStorage<EMode::Read>
+{
+#ifdef OMIM_OS_WINDOWS
+  using TFileReader = FileReader;
+#else
+  using TFileReader = MmapReader;
+#endif
+
+public:
+  CacheStorage(string const & name, bool compress)
+    : m_cache(kCacheBlockCacheBytes), m_reader(Open(name, compress, m_cache))
+  {
+  }
+
+  uint64_t Size() const { return m_reader.Size(); }
+  void Read(uint64_t pos, void * p, size_t size) const { m_reader.Read(pos, p, size); }
+
+private:
+  static ModelReaderPtr Open(string const & name, bool compress,
+                             compressed_section::BlockCache & cache)
+  {
+    if (!compress)
+      return new FileReader(name);
+    return new compressed_section::CompressedReader(
+        new TFileReader(name + COMPRESSED_CACHE_EXT), cache);
+  }
+
+  compressed_section::BlockCache m_cache;
+  ModelReaderPtr m_reader;
+};
 } // namespace detail
 
 template <EMode TMode>
@@ -135,8 +252,9 @@ class OSMElementCache
 {
 public:
   using TKey = uint64_t;
-  using TStorage = typename conditional<TMode == EMode::Write, FileWriter, FileReader>::type;
-  using TOffsetFile = typename conditional<TMode == EMode::Write, FileWriter, FileReader>::type;
+  using TStorage = detail::CacheStorage<TMode>;
+  using TOffsetFile =
+      typename conditional<TMode == EMode::Write, BufferedFileWriter, FileReader>::type;
 
 protected:
   using TBuffer = vector<uint8_t>;
@@ -147,8 +265,10 @@ protected:
   bool m_preload = false;
 
 public:
-  OSMElementCache(string const & name, bool preload = false)
-  : m_storage(name)
+  /// @param compress Elements are kept in the block compressed file, it has to be the same
+  /// for the writer and the reader of a cache.
+  OSMElementCache(string const & name, bool preload = false, bool compress = false)
+  : m_storage(name, compress)
   , m_offsets(name + OFFSET_EXT)
   , m_name(name)
   , m_preload(preload)
@@ -156,6 +276,15 @@ public:
     InitStorage<TMode>();
   }
 
+  /// Opens the existing cache to add new and updated elements to its end, used in Write mode only.
+  /// Read() finds the new versions of the updated elements as they have the greatest offsets.
+  OSMElementCache(string const & name, AppendTag tag, bool compress = false)
+  : m_storage(name, compress, tag)
+  , m_offsets(name + OFFSET_EXT, tag)
+  , m_name(name)
+  {
+  }
+
   template <EMode T>
   typename enable_if<T == EMode::Write, void>::type InitStorage() {}
 
@@ -252,6 +381,7 @@ class RawFilePointStorage : public PointStorage
   using TFileReader = MmapReader;
 #endif
 
+  // Each point is written after a seek, so the writes aren't buffered.
   typename conditional<TMode == EMode::Write, FileWriter, TFileReader>::type m_file;
 
   constexpr static double const kValueOrder = 1E+7;
@@ -259,6 +389,10 @@ class RawFilePointStorage : public PointStorage
 public:
   explicit RawFilePointStorage(string const & name) : m_file(name) {}
 
+  /// Updates points of the existing file, used in Write mode only.
+  /// RawMemPointStorage files have the same format, so they're updated by this class too.
+  RawFilePointStorage(string const & name, AppendTag) : m_file(name, FileWriter::OP_WRITE_EXISTING) {}
+
   template <EMode T = TMode>
   typename enable_if<T == EMode::Write, void>::type AddPoint(uint64_t id, double lat, double lng)
   {
@@ -366,7 +500,7 @@ public:
 template <EMode TMode>
 class MapFilePointStorage : public PointStorage
 {
-  typename conditional<TMode == EMode::Write, FileWriter, FileReader>::type m_file;
+  typename conditional<TMode == EMode::Write, BufferedFileWriter, FileReader>::type m_file;
   unordered_map<uint64_t, pair<int32_t, int32_t>> m_map;
 
   constexpr static double const kValueOrder = 1E+7;
@@ -374,6 +508,13 @@ class MapFilePointStorage : public PointStorage
 public:
   explicit MapFilePointStorage(string const & name) : m_file(name + ".short") { InitStorage<TMode>(); }
 
+  /// Adds points to the existing file, used in Write mode only. The last added point with an id
+  /// is used.
+  MapFilePointStorage(string const & name, AppendTag)
+  : m_file(name + ".short", FileWriter::OP_APPEND)
+  {
+  }
+
   template <EMode T>
   typename enable_if<T == EMode::Write, void>::type InitStorage() {}
 
@@ -390,7 +531,7 @@ public:
       LatLonPos ll;
       m_file.Read(pos, &ll, sizeof(ll));
 
-      m_map.emplace(make_pair(ll.pos, make_pair(ll.lat, ll.lon)));
+      m_map[ll.pos] = make_pair(ll.lat, ll.lon);
 
       pos += sizeof(ll);
     }
@@ -425,4 +566,177 @@ public:
   }
 };
 
+/// Keeps nodes sorted by id in blocks of kBlockSize nodes, so the file size depends on the number
+/// of nodes, not on the max node id. A block is made of varint coded deltas of ids followed by
+/// the coordinates, the first id and the offset of each block are kept in the index file.
+/// A lookup is a binary search over the blocks and decoding of a single block.
+/// Nodes have to be added in the increasing order of ids as they're kept in planet dumps.
+template <EMode TMode>
+class PackedFilePointStorage : public PointStorage
+{
+#ifdef OMIM_OS_WINDOWS
+  using TFileReader = FileReader;
+#else
+  using TFileReader = MmapReader;
+#endif
+
+  struct BlockInfo
+  {
+    uint64_t firstId;
+    uint64_t offset;
+  };
+  static_assert(sizeof(BlockInfo) == 16, "Invalid structure size");
+
+  typename conditional<TMode == EMode::Write, BufferedFileWriter, TFileReader>::type m_file;
+  string const m_indexName;
+
+  constexpr static double const kValueOrder = 1E+7;
+  // A block takes 2.5Kb at most, so a lookup touches a page or two of the file.
+  static uint32_t constexpr kBlockSize = 256;
+  static size_t constexpr kMaxDeltasSize = (kBlockSize - 1) * 10;
+
+  vector<BlockInfo> m_blocks;
+  uint32_t m_lastBlockSize = 0;
+
+  // Current block, used in Write mode only.
+  vector<uint8_t> m_deltas;
+  vector<LatLon> m_coords;
+  uint64_t m_lastId = 0;
+
+public:
+  explicit PackedFilePointStorage(string const & name) : m_file(name), m_indexName(name + ".blocks")
+  {
+    InitStorage<TMode>();
+  }
+
+  ~PackedFilePointStorage() { DoneStorage<TMode>(); }
+
+  template <EMode T>
+  typename enable_if<T == EMode::Write, void>::type InitStorage() {}
+
+  template <EMode T>
+  typename enable_if<T == EMode::Read, void>::type InitStorage()
+  {
+    FileReader index(m_indexName);
+    uint32_t blockSize = 0;
+    index.Read(0, &blockSize, sizeof(blockSize));
+    CHECK_EQUAL(blockSize, kBlockSize, ("Nodes file was made with another block size."));
+    index.Read(sizeof(blockSize), &m_lastBlockSize, sizeof(m_lastBlockSize));
+
+    uint64_t const headerSize = sizeof(blockSize) + sizeof(m_lastBlockSize);
+    m_blocks.resize((index.Size() - headerSize) / sizeof(BlockInfo));
+    if (!m_blocks.empty())
+      index.Read(headerSize, m_blocks.data(), m_blocks.size() * sizeof(BlockInfo));
+    LOG(LINFO, ("Nodes index has", m_blocks.size(), "blocks."));
+  }
+
+  template <EMode T>
+  typename enable_if<T == EMode::Write, void>::type DoneStorage()
+  {
+    FlushBlock();
+
+    FileWriter index(m_indexName);
+    uint32_t const blockSize = kBlockSize;
+    index.Write(&blockSize, sizeof(blockSize));
+    index.Write(&m_lastBlockSize, sizeof(m_lastBlockSize));
+    if (!m_blocks.empty())
+      index.Write(m_blocks.data(), m_blocks.size() * sizeof(BlockInfo));
+  }
+
+  template <EMode T>
+  typename enable_if<T == EMode::Read, void>::type DoneStorage() {}
+
+  template <EMode T = TMode>
+  typename enable_if<T == EMode::Write, void>::type AddPoint(uint64_t id, double lat, double lng)
+  {
+    int64_t const lat64 = lat * kValueOrder;
+    int64_t const lng64 = lng * kValueOrder;
+
+    LatLon ll;
+    ll.lat = static_cast<int32_t>(lat64);
+    ll.lon = static_cast<int32_t>(lng64);
+    CHECK_EQUAL(static_cast<int64_t>(ll.lat), lat64, ("Latitude is out of 32bit boundary!"));
+    CHECK_EQUAL(static_cast<int64_t>(ll.lon), lng64, ("Longtitude is out of 32bit boundary!"));
+    CHECK(GetProcessedPoint() == 0 || id > m_lastId,
+          ("Nodes are not sorted by id, use another node storage.", id, m_lastId));
+
+    if (m_coords.size() == kBlockSize)
+      FlushBlock();
+
+    if (m_coords.empty())
+    {
+      m_blocks.push_back({id, static_cast<uint64_t>(m_file.Pos())});
+    }
+    else
+    {
+      PushBackByteSink<vector<uint8_t>> sink(m_deltas);
+      WriteVarUint(sink, id - m_lastId);
+    }
+    m_coords.push_back(ll);
+    m_lastId = id;
+
+    IncProcessedPoint();
+  }
+
+  template <EMode T = TMode>
+  typename enable_if<T == EMode::Read, bool>::type GetPoint(uint64_t id, double & lat,
+                                                            double & lng) const
+  {
+    auto const it = upper_bound(m_blocks.begin(), m_blocks.end(), id,
+                                [](uint64_t id, BlockInfo const & block)
+                                {
+                                  return id < block.firstId;
+                                });
+    if (it == m_blocks.begin())
+      return false;
+
+    size_t const block = distance(m_blocks.begin(), it) - 1;
+    bool const isLast = block + 1 == m_blocks.size();
+    uint32_t const count = isLast ? m_lastBlockSize : kBlockSize;
+    uint64_t const end = isLast ? m_file.Size() : m_blocks[block + 1].offset;
+    uint64_t const coordsOffset = end - count * sizeof(LatLon);
+    size_t const deltasSize = static_cast<size_t>(coordsOffset - m_blocks[block].offset);
+    CHECK_LESS_OR_EQUAL(deltasSize, kMaxDeltasSize, ("Nodes file is corrupted."));
+
+    uint8_t deltas[kMaxDeltasSize];
+    m_file.Read(m_blocks[block].offset, deltas, deltasSize);
+    ArrayByteSource src(deltas);
+    uint64_t current = m_blocks[block].firstId;
+    uint32_t pos = 0;
+    while (current < id && pos + 1 < count)
+    {
+      current += ReadVarUint<uint64_t>(src);
+      ++pos;
+    }
+    if (current != id)
+      return false;
+
+    LatLon ll;
+    m_file.Read(coordsOffset + pos * sizeof(LatLon), &ll, sizeof(ll));
+    lat = static_cast<double>(ll.lat) / kValueOrder;
+    lng = static_cast<double>(ll.lon) / kValueOrder;
+    return true;
+  }
+
+private:
+  void FlushBlock()
+  {
+    if (m_coords.empty())
+      return;
+    if (!m_deltas.empty())
+      m_file.Write(m_deltas.data(), m_deltas.size());
+    m_file.Write(m_coords.data(), m_coords.size() * sizeof(LatLon));
+    m_lastBlockSize = static_cast<uint32_t>(m_coords.size());
+    m_deltas.clear();
+    m_coords.clear();
+  }
+};
+
+// static
+template <EMode TMode>
+uint32_t constexpr PackedFilePointStorage<TMode>::kBlockSize;
+// static
+template <EMode TMode>
+size_t constexpr PackedFilePointStorage<TMode>::kMaxDeltasSize;
+
 }  // namespace cache
@@ -53,8 +53,13 @@ struct WayElement
   {
     uint64_t count = nodes.size();
     WriteVarUint(writer, count);
+    // Nodes of a way have close ids, so the deltas are written.
+    uint64_t prev = 0;
     for (uint64_t e : nodes)
-      WriteVarUint(writer, e);
+    {
+      WriteVarInt(writer, static_cast<int64_t>(e - prev));
+      prev = e;
+    }
   }
 
   template <class TReader>
@@ -63,8 +68,12 @@ struct WayElement
     ReaderSource<MemReader> r(reader);
     uint64_t count = ReadVarUint<uint64_t>(r);
     nodes.resize(count);
+    uint64_t prev = 0;
     for (uint64_t & e : nodes)
-      e = ReadVarUint<uint64_t>(r);
+    {
+      e = prev + static_cast<uint64_t>(ReadVarInt<int64_t>(r));
+      prev = e;
+    }
   }
 
   string ToString() const
@@ -133,10 +142,12 @@ public:
     {
       uint64_t count = members.size();
       WriteVarUint(writer, count);
+      uint64_t prev = 0;
       for (auto const & e : members)
       {
-        // write id
-        WriteVarUint(writer, e.first);
+        // write delta of id
+        WriteVarInt(writer, static_cast<int64_t>(e.first - prev));
+        prev = e.first;
         // write role
         StringWriter(e.second);
       }
@@ -173,10 +184,12 @@ public:
     {
       uint64_t count = ReadVarUint<uint64_t>(r);
       members.resize(count);
+      uint64_t prev = 0;
       for (auto & e : members)
       {
         // decode id
-        e.first = ReadVarUint<uint64_t>(r);
+        e.first = prev + static_cast<uint64_t>(ReadVarInt<int64_t>(r));
+        prev = e.first;
         // decode role
         StringReader(e.second);
       }
@@ -0,0 +1,55 @@
+#include "generator/landmarks_generator.hpp"
+
+#include "routing/landmarks.hpp"
+#include "routing/pedestrian_model.hpp"
+
+#include "indexer/feature.hpp"
+#include "indexer/feature_processor.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include "defines.hpp"
+
+#include "std/vector.hpp"
+
+namespace routing
+{
+void BuildPedestrianLandmarks(string const & baseDir, string const & countryName)
+{
+  string const mwmFile = baseDir + countryName + DATA_FILE_EXTENSION;
+  LOG(LINFO, ("Building pedestrian landmarks for", mwmFile));
+  my::Timer timer;
+
+  // The same vehicle model is used by FeaturesRoadGraph, see GetFeatureCountryName().
+  string const modelCountry = countryName.substr(0, countryName.find('_'));
+  shared_ptr<IVehicleModel> const model = PedestrianModelFactory().GetVehicleModelForCountry(modelCountry);
+
+  vector<LandmarksTable::TRoad> roads;
+  auto const addRoad = [&](FeatureType const & ft, uint32_t /* index */)
+  {
+    if (ft.GetFeatureType() != feature::GEOM_LINE || model->GetSpeed(ft) <= 0.0)
+      return;
+
+    ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+    LandmarksTable::TRoad road;
+    road.reserve(ft.GetPointsCount());
+    for (size_t i = 0; i < ft.GetPointsCount(); ++i)
+      road.push_back(ft.GetPoint(i));
+    roads.push_back(move(road));
+  };
+  feature::ForEachFromDat(mwmFile, addRoad);
+
+  LandmarksTable table;
+  table.Build(roads, LandmarksTable::kDefaultLandmarksCount);
+  LOG(LINFO, ("Roads:", roads.size(), "vertices:", table.GetVerticesCount(),
+              "landmarks:", table.GetLandmarksCount(), "elapsed, seconds:", timer.ElapsedSeconds()));
+
+  FilesContainerW container(mwmFile, FileWriter::OP_WRITE_EXISTING);
+  FileWriter writer = container.GetWriter(PEDESTRIAN_LANDMARKS_FILE_TAG);
+  table.Serialize(writer);
+}
+}  // namespace routing
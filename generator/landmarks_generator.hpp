@@ -0,0 +1,12 @@
+#pragma once
+
+#include "std/string.hpp"
+
+namespace routing
+{
+/// Builds landmarks section for pedestrian routing (see routing/landmarks.hpp) and
+/// writes it into the mwm.
+/// @param[in]  baseDir   Full path to .mwm files directory.
+/// @param[in]  countryName   Country name same with .mwm file name.
+void BuildPedestrianLandmarks(string const & baseDir, string const & countryName);
+}  // namespace routing
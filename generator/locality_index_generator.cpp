@@ -0,0 +1,54 @@
+#include "generator/locality_index_generator.hpp"
+
+#include "indexer/data_header.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/feature_processor.hpp"
+#include "indexer/ftypes_matcher.hpp"
+#include "indexer/locality_index.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include "defines.hpp"
+
+namespace indexer
+{
+void BuildLocalityIndex(string const & baseDir, string const & countryName)
+{
+  string const mwmFile = baseDir + countryName + DATA_FILE_EXTENSION;
+  LOG(LINFO, ("Building locality index for", mwmFile));
+  my::Timer timer;
+
+  // The same localities are loaded by search::LocalityFinder without the index.
+  vector<LocalityIndex::Locality> localities;
+  auto const addLocality = [&](FeatureType const & ft, uint32_t index)
+  {
+    if (ft.GetFeatureType() != feature::GEOM_POINT)
+      return;
+
+    ftypes::Type const type = ftypes::IsLocalityChecker::Instance().GetType(ft);
+    if (type != ftypes::CITY && type != ftypes::TOWN)
+      return;
+
+    uint32_t const population = ftypes::GetPopulation(ft);
+    if (population == 0)
+      return;
+
+    localities.emplace_back(index, population, ft.GetCenter());
+  };
+  feature::ForEachFromDat(mwmFile, addLocality);
+
+  uint32_t const coordBits =
+      feature::DataHeader((FilesContainerR(mwmFile))).GetDefCodingParams().GetCoordBits();
+
+  FilesContainerW container(mwmFile, FileWriter::OP_WRITE_EXISTING);
+  FileWriter writer = container.GetWriter(LOCALITY_INDEX_FILE_TAG);
+  uint64_t const startPos = writer.Pos();
+  LocalityIndex::Serialize(localities, coordBits, writer);
+  LOG(LINFO, ("Localities:", localities.size(), "section size, bytes:", writer.Pos() - startPos,
+              "elapsed, seconds:", timer.ElapsedSeconds()));
+}
+}  // namespace indexer
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "std/string.hpp"
+
+namespace indexer
+{
+/// Builds locality index section (see indexer/locality_index.hpp) and writes it into the mwm.
+/// It's needed for the world mwm only, as search::LocalityFinder reads localities from it.
+/// @param[in]  baseDir   Full path to .mwm files directory.
+/// @param[in]  countryName   Country name same with .mwm file name.
+void BuildLocalityIndex(string const & baseDir, string const & countryName);
+}  // namespace indexer
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "generator/osm_xml_source.hpp"
+
+#include "std/function.hpp"
+#include "std/string.hpp"
+
+/// Parses OsmChange (.osc) files, the elements of <create>, <modify> and <delete> sections
+/// are passed to the emitter with the action of the section.
+class OsmChangeSource
+{
+public:
+  enum class Action
+  {
+    Create,
+    Modify,
+    Delete
+  };
+
+  using TEmitterFn = function<void(Action, OsmElement *)>;
+
+  OsmChangeSource(TEmitterFn fn)
+  : m_source([this](OsmElement * e) { m_emitterFn(m_action, e); }), m_emitterFn(fn)
+  {
+  }
+
+  void CharData(string const & data) { m_source.CharData(data); }
+
+  void AddAttr(string const & key, string const & value)
+  {
+    if (m_depth > 1)
+      m_source.AddAttr(key, value);
+  }
+
+  bool Push(string const & tagName)
+  {
+    // <osmChange> is skipped, the sections are the roots of XMLSource.
+    if (++m_depth == 1)
+      return true;
+
+    if (m_depth == 2)
+    {
+      if (tagName == "create")
+        m_action = Action::Create;
+      else if (tagName == "modify")
+        m_action = Action::Modify;
+      else if (tagName == "delete")
+        m_action = Action::Delete;
+      else
+        LOG(LWARNING, ("Unknown section of the OsmChange file:", tagName));
+    }
+    return m_source.Push(tagName);
+  }
+
+  void Pop(string const & tagName)
+  {
+    if (--m_depth > 0)
+      m_source.Pop(tagName);
+  }
+
+private:
+  XMLSource m_source;
+  TEmitterFn m_emitterFn;
+  Action m_action = Action::Modify;
+  size_t m_depth = 0;
+};
+
+inline string DebugPrint(OsmChangeSource::Action action)
+{
+  switch (action)
+  {
+    case OsmChangeSource::Action::Create: return "create";
+    case OsmChangeSource::Action::Modify: return "modify";
+    case OsmChangeSource::Action::Delete: return "delete";
+  }
+  return "unknown";
+}
@@ -132,4 +132,5 @@ struct OsmElement
 };
 
 string DebugPrint(OsmElement const & e);
+string DebugPrint(OsmElement::EntityType e);
 
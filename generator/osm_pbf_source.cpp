@@ -0,0 +1,465 @@
+#include "generator/osm_pbf_source.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/iterator.hpp"
+
+#include "zlib.h"
+
+namespace osm
+{
+namespace
+{
+// Limits from the format definition.
+uint32_t constexpr kMaxBlobHeaderSize = 64 * 1024;
+uint32_t constexpr kMaxBlobSize = 32 * 1024 * 1024;
+
+char const * const kSupportedFeatures[] = {"OsmSchema-V0.6", "DenseNodes"};
+
+/// ProtoReader walks fields of a serialized protobuf message.
+/// Only the wire types used by the PBF format are supported.
+class ProtoReader
+{
+public:
+  enum WireType
+  {
+    Varint = 0,
+    Fixed64 = 1,
+    Bytes = 2,
+    Fixed32 = 5
+  };
+
+  ProtoReader(char const * data, size_t size) : m_pos(data), m_end(data + size) {}
+  explicit ProtoReader(string const & data) : ProtoReader(data.data(), data.size()) {}
+
+  /// Reads the key of the next field.
+  /// @return False at the end of the message.
+  bool Next()
+  {
+    if (m_pos == m_end)
+      return false;
+    uint64_t const key = ReadVarint();
+    m_field = static_cast<uint32_t>(key >> 3);
+    m_wireType = static_cast<uint32_t>(key & 0x7);
+    return true;
+  }
+
+  inline uint32_t GetField() const { return m_field; }
+
+  uint64_t GetVarint()
+  {
+    CHECK_EQUAL(m_wireType, Varint, ("Field", m_field));
+    return ReadVarint();
+  }
+
+  int64_t GetSVarint() { return DecodeZigZag(GetVarint()); }
+
+  ProtoReader GetMessage()
+  {
+    CHECK_EQUAL(m_wireType, Bytes, ("Field", m_field));
+    size_t const size = static_cast<size_t>(ReadVarint());
+    CHECK_LESS_OR_EQUAL(size, static_cast<size_t>(m_end - m_pos), ("Field", m_field));
+    ProtoReader message(m_pos, size);
+    m_pos += size;
+    return message;
+  }
+
+  string GetString()
+  {
+    ProtoReader const message = GetMessage();
+    return string(message.m_pos, message.m_end);
+  }
+
+  /// Calls fn(value) for each varint of the repeated field, both packed and not packed
+  /// encodings are accepted.
+  template <typename TFn>
+  void ForEachVarint(TFn && fn)
+  {
+    if (m_wireType == Varint)
+    {
+      fn(ReadVarint());
+      return;
+    }
+    ProtoReader packed = GetMessage();
+    while (packed.m_pos != packed.m_end)
+      fn(packed.ReadVarint());
+  }
+
+  void Skip()
+  {
+    switch (m_wireType)
+    {
+      case Varint: ReadVarint(); break;
+      case Fixed64: Advance(8); break;
+      case Bytes: GetMessage(); break;
+      case Fixed32: Advance(4); break;
+      default: CHECK(false, ("Unsupported wire type", m_wireType, "of field", m_field));
+    }
+  }
+
+  static int64_t DecodeZigZag(uint64_t value)
+  {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+private:
+  uint64_t ReadVarint()
+  {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+      CHECK(m_pos != m_end, ("Truncated varint of field", m_field));
+      uint8_t const byte = static_cast<uint8_t>(*m_pos++);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+    CHECK(false, ("Malformed varint of field", m_field));
+    return value;
+  }
+
+  void Advance(size_t size)
+  {
+    CHECK_LESS_OR_EQUAL(size, static_cast<size_t>(m_end - m_pos), ("Field", m_field));
+    m_pos += size;
+  }
+
+  char const * m_pos;
+  char const * m_end;
+  uint32_t m_field = 0;
+  uint32_t m_wireType = Varint;
+};
+
+template <typename T>
+void ReadRepeated(ProtoReader & reader, vector<T> & values)
+{
+  reader.ForEachVarint([&values](uint64_t v) { values.push_back(static_cast<T>(v)); });
+}
+
+void Decompress(string const & blobData, string & data)
+{
+  ProtoReader blob(blobData);
+  string zlibData;
+  size_t rawSize = 0;
+  bool hasRaw = false;
+  while (blob.Next())
+  {
+    switch (blob.GetField())
+    {
+      case 1: data = blob.GetString(); hasRaw = true; break;
+      case 2: rawSize = static_cast<size_t>(blob.GetVarint()); break;
+      case 3: zlibData = blob.GetString(); break;
+      case 4: CHECK(false, ("LZMA compressed blobs are not supported.")); break;
+      default: blob.Skip(); break;
+    }
+  }
+  if (hasRaw)
+    return;
+
+  CHECK_LESS_OR_EQUAL(rawSize, kMaxBlobSize, ());
+  data.resize(rawSize);
+  uLongf size = static_cast<uLongf>(rawSize);
+  int const res = uncompress(reinterpret_cast<Bytef *>(&data[0]), &size,
+                             reinterpret_cast<Bytef const *>(zlibData.data()),
+                             static_cast<uLong>(zlibData.size()));
+  CHECK_EQUAL(res, Z_OK, ("Can't decompress the blob."));
+  CHECK_EQUAL(size, rawSize, ());
+}
+
+/// Decoding context of a PrimitiveBlock.
+class PrimitiveBlock
+{
+public:
+  explicit PrimitiveBlock(vector<OsmElement> & elements) : m_elements(elements) {}
+
+  void Decode(string const & data)
+  {
+    // Groups may precede the block parameters, so they are decoded after the whole block is read.
+    vector<ProtoReader> groups;
+    ProtoReader block(data);
+    while (block.Next())
+    {
+      switch (block.GetField())
+      {
+        case 1: ReadStringTable(block.GetMessage()); break;
+        case 2: groups.push_back(block.GetMessage()); break;
+        case 17: m_granularity = static_cast<int64_t>(block.GetVarint()); break;
+        case 19: m_latOffset = static_cast<int64_t>(block.GetVarint()); break;
+        case 20: m_lonOffset = static_cast<int64_t>(block.GetVarint()); break;
+        default: block.Skip(); break;
+      }
+    }
+
+    for (ProtoReader & group : groups)
+    {
+      while (group.Next())
+      {
+        switch (group.GetField())
+        {
+          case 1: ReadNode(group.GetMessage()); break;
+          case 2: ReadDenseNodes(group.GetMessage()); break;
+          case 3: ReadWay(group.GetMessage()); break;
+          case 4: ReadRelation(group.GetMessage()); break;
+          default: group.Skip(); break;
+        }
+      }
+    }
+  }
+
+private:
+  void ReadStringTable(ProtoReader table)
+  {
+    while (table.Next())
+    {
+      if (table.GetField() == 1)
+        m_strings.push_back(table.GetString());
+      else
+        table.Skip();
+    }
+  }
+
+  string const & GetString(uint64_t index) const
+  {
+    CHECK_LESS(index, m_strings.size(), ("Bad string table index."));
+    return m_strings[index];
+  }
+
+  double GetLat(int64_t lat) const { return 1e-9 * (m_latOffset + m_granularity * lat); }
+  double GetLon(int64_t lon) const { return 1e-9 * (m_lonOffset + m_granularity * lon); }
+
+  OsmElement & AddElement(OsmElement::EntityType type, int64_t id)
+  {
+    m_elements.emplace_back();
+    OsmElement & e = m_elements.back();
+    e.type = type;
+    e.id = static_cast<uint64_t>(id);
+    return e;
+  }
+
+  void AddTags(OsmElement & e, vector<uint32_t> const & keys, vector<uint32_t> const & vals) const
+  {
+    CHECK_EQUAL(keys.size(), vals.size(), ("Element", e.id));
+    for (size_t i = 0; i < keys.size(); ++i)
+      e.AddTag(GetString(keys[i]), GetString(vals[i]));
+  }
+
+  void ReadNode(ProtoReader node)
+  {
+    int64_t id = 0, lat = 0, lon = 0;
+    vector<uint32_t> keys, vals;
+    while (node.Next())
+    {
+      switch (node.GetField())
+      {
+        case 1: id = node.GetSVarint(); break;
+        case 2: ReadRepeated(node, keys); break;
+        case 3: ReadRepeated(node, vals); break;
+        case 8: lat = node.GetSVarint(); break;
+        case 9: lon = node.GetSVarint(); break;
+        default: node.Skip(); break;
+      }
+    }
+
+    OsmElement & e = AddElement(OsmElement::EntityType::Node, id);
+    e.lat = GetLat(lat);
+    e.lon = GetLon(lon);
+    AddTags(e, keys, vals);
+  }
+
+  void ReadDenseNodes(ProtoReader dense)
+  {
+    vector<uint64_t> ids, lats, lons;
+    vector<uint32_t> keysVals;
+    while (dense.Next())
+    {
+      switch (dense.GetField())
+      {
+        case 1: ReadRepeated(dense, ids); break;
+        case 8: ReadRepeated(dense, lats); break;
+        case 9: ReadRepeated(dense, lons); break;
+        case 10: ReadRepeated(dense, keysVals); break;
+        default: dense.Skip(); break;
+      }
+    }
+    CHECK_EQUAL(ids.size(), lats.size(), ());
+    CHECK_EQUAL(ids.size(), lons.size(), ());
+
+    // Ids and coordinates are delta coded, tags of the nodes are separated by zeroes.
+    int64_t id = 0, lat = 0, lon = 0;
+    size_t kv = 0;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      id += ProtoReader::DecodeZigZag(ids[i]);
+      lat += ProtoReader::DecodeZigZag(lats[i]);
+      lon += ProtoReader::DecodeZigZag(lons[i]);
+      OsmElement & e = AddElement(OsmElement::EntityType::Node, id);
+      e.lat = GetLat(lat);
+      e.lon = GetLon(lon);
+      while (kv < keysVals.size() && keysVals[kv] != 0)
+      {
+        CHECK_LESS(kv + 1, keysVals.size(), ("Element", e.id));
+        e.AddTag(GetString(keysVals[kv]), GetString(keysVals[kv + 1]));
+        kv += 2;
+      }
+      ++kv;
+    }
+  }
+
+  void ReadWay(ProtoReader way)
+  {
+    int64_t id = 0;
+    vector<uint32_t> keys, vals;
+    vector<uint64_t> refs;
+    while (way.Next())
+    {
+      switch (way.GetField())
+      {
+        case 1: id = static_cast<int64_t>(way.GetVarint()); break;
+        case 2: ReadRepeated(way, keys); break;
+        case 3: ReadRepeated(way, vals); break;
+        case 8: ReadRepeated(way, refs); break;
+        default: way.Skip(); break;
+      }
+    }
+
+    OsmElement & e = AddElement(OsmElement::EntityType::Way, id);
+    int64_t ref = 0;
+    for (uint64_t const delta : refs)
+    {
+      ref += ProtoReader::DecodeZigZag(delta);
+      e.AddNd(static_cast<uint64_t>(ref));
+    }
+    AddTags(e, keys, vals);
+  }
+
+  void ReadRelation(ProtoReader relation)
+  {
+    int64_t id = 0;
+    vector<uint32_t> keys, vals, roles, types;
+    vector<uint64_t> memids;
+    while (relation.Next())
+    {
+      switch (relation.GetField())
+      {
+        case 1: id = static_cast<int64_t>(relation.GetVarint()); break;
+        case 2: ReadRepeated(relation, keys); break;
+        case 3: ReadRepeated(relation, vals); break;
+        case 8: ReadRepeated(relation, roles); break;
+        case 9: ReadRepeated(relation, memids); break;
+        case 10: ReadRepeated(relation, types); break;
+        default: relation.Skip(); break;
+      }
+    }
+    CHECK_EQUAL(memids.size(), roles.size(), ("Relation", id));
+    CHECK_EQUAL(memids.size(), types.size(), ("Relation", id));
+
+    OsmElement & e = AddElement(OsmElement::EntityType::Relation, id);
+    int64_t ref = 0;
+    for (size_t i = 0; i < memids.size(); ++i)
+    {
+      ref += ProtoReader::DecodeZigZag(memids[i]);
+      OsmElement::EntityType type = OsmElement::EntityType::Unknown;
+      switch (types[i])
+      {
+        case 0: type = OsmElement::EntityType::Node; break;
+        case 1: type = OsmElement::EntityType::Way; break;
+        case 2: type = OsmElement::EntityType::Relation; break;
+      }
+      e.AddMember(static_cast<uint64_t>(ref), type, GetString(roles[i]));
+    }
+    AddTags(e, keys, vals);
+  }
+
+  vector<OsmElement> & m_elements;
+  vector<string> m_strings;
+  int64_t m_granularity = 100;
+  int64_t m_latOffset = 0;
+  int64_t m_lonOffset = 0;
+};
+}  // namespace
+
+bool PbfBlobReader::Read(PbfBlob & blob)
+{
+  string & buffer = m_headerBuffer;
+  if (!ReadBytes(4, buffer))
+    return false;
+
+  // Size of BlobHeader is in network byte order.
+  uint32_t headerSize = 0;
+  for (char const c : buffer)
+    headerSize = (headerSize << 8) | static_cast<uint8_t>(c);
+  CHECK_LESS_OR_EQUAL(headerSize, kMaxBlobHeaderSize, ("Bad BlobHeader size."));
+  CHECK(ReadBytes(headerSize, buffer), ("Truncated BlobHeader."));
+
+  string type;
+  uint64_t dataSize = 0;
+  ProtoReader header(buffer);
+  while (header.Next())
+  {
+    switch (header.GetField())
+    {
+      case 1: type = header.GetString(); break;
+      case 3: dataSize = header.GetVarint(); break;
+      default: header.Skip(); break;
+    }
+  }
+  CHECK_LESS_OR_EQUAL(dataSize, kMaxBlobSize, ("Bad Blob size."));
+
+  if (type == "OSMHeader")
+    blob.m_type = PbfBlob::Type::Header;
+  else if (type == "OSMData")
+    blob.m_type = PbfBlob::Type::Data;
+  else
+    blob.m_type = PbfBlob::Type::Unknown;
+
+  CHECK(ReadBytes(static_cast<size_t>(dataSize), blob.m_data), ("Truncated Blob."));
+  return true;
+}
+
+bool PbfBlobReader::ReadBytes(size_t size, string & buffer)
+{
+  buffer.resize(size);
+  size_t read = 0;
+  while (read < size)
+  {
+    size_t const n = m_reader(reinterpret_cast<uint8_t *>(&buffer[read]), size - read);
+    if (n == 0)
+      break;
+    read += n;
+  }
+  return read == size;
+}
+
+void CheckPbfHeader(PbfBlob const & blob)
+{
+  ASSERT(blob.m_type == PbfBlob::Type::Header, ());
+
+  string data;
+  Decompress(blob.m_data, data);
+  ProtoReader header(data);
+  while (header.Next())
+  {
+    if (header.GetField() != 4)
+    {
+      header.Skip();
+      continue;
+    }
+    string const feature = header.GetString();
+    CHECK(find(begin(kSupportedFeatures), end(kSupportedFeatures), feature) !=
+              end(kSupportedFeatures),
+          ("Unsupported PBF feature:", feature));
+  }
+}
+
+void DecodePbfBlob(PbfBlob const & blob, vector<OsmElement> & elements)
+{
+  ASSERT(blob.m_type == PbfBlob::Type::Data, ());
+
+  string data;
+  Decompress(blob.m_data, data);
+  PrimitiveBlock(elements).Decode(data);
+}
+
+}  // namespace osm
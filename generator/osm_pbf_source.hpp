@@ -0,0 +1,55 @@
+// See PBF Format definition at http://wiki.openstreetmap.org/wiki/PBF_Format
+#pragma once
+
+#include "generator/osm_element.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/function.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace osm
+{
+
+/// PbfBlob is a file block of a .osm.pbf file, the blocks are independent from each other
+/// so several blobs can be decoded at the same time.
+struct PbfBlob
+{
+  enum class Type
+  {
+    Header,
+    Data,
+    Unknown
+  };
+
+  Type m_type = Type::Unknown;
+  // Serialized Blob message, it's decompressed by DecodePbfBlob.
+  string m_data;
+};
+
+/// PbfBlobReader splits a .osm.pbf stream into blobs without decoding them.
+class PbfBlobReader
+{
+public:
+  using TReadFunc = function<size_t(uint8_t *, size_t)>;
+
+  explicit PbfBlobReader(TReadFunc reader) : m_reader(reader) {}
+
+  /// @return False at the end of the stream.
+  bool Read(PbfBlob & blob);
+
+private:
+  bool ReadBytes(size_t size, string & buffer);
+
+  TReadFunc m_reader;
+  string m_headerBuffer;
+};
+
+/// Checks that all the features required by the OSMHeader blob are supported.
+void CheckPbfHeader(PbfBlob const & blob);
+
+/// Decodes the OSMData blob and appends its nodes, ways and relations to the elements
+/// in the order they are kept in the blob.
+void DecodePbfBlob(PbfBlob const & blob, vector<OsmElement> & elements);
+
+}  // namespace osm
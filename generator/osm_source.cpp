@@ -1,9 +1,12 @@
+#include "generator/borders_loader.hpp"
 #include "generator/coastlines_generator.hpp"
 #include "generator/feature_generator.hpp"
 #include "generator/intermediate_data.hpp"
 #include "generator/intermediate_elements.hpp"
+#include "generator/osm_change_source.hpp"
 #include "generator/osm_translator.hpp"
 #include "generator/osm_o5m_source.hpp"
+#include "generator/osm_pbf_source.hpp"
 #include "generator/osm_xml_source.hpp"
 #include "generator/osm_source.hpp"
 #include "generator/polygonizer.hpp"
@@ -15,7 +18,13 @@
 
 #include "coding/parse_xml.hpp"
 
+#include "std/condition_variable.hpp"
+#include "std/deque.hpp"
 #include "std/fstream.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/thread.hpp"
+#include "std/unordered_map.hpp"
 
 #include "defines.hpp"
 
@@ -67,6 +76,9 @@ class IntermediateData
   TIndex m_nodeToRelations;
   TIndex m_wayToRelations;
 
+  // Number of the added nodes, ways and relations, including the relations which aren't stored.
+  uint64_t m_addedCount = 0;
+
   template <class TElement, class ToDo>
   struct ElementProcessorBase
   {
@@ -111,21 +123,42 @@ class IntermediateData
 public:
   IntermediateData(TNodesHolder & nodes, feature::GenerateInfo & info)
   : m_nodes(nodes)
-  , m_ways(info.GetIntermediateFileName(WAYS_FILE, ""), info.m_preloadCache)
-  , m_relations(info.GetIntermediateFileName(RELATIONS_FILE, ""), info.m_preloadCache)
+  , m_ways(info.GetIntermediateFileName(WAYS_FILE, ""), info.m_preloadCache, info.m_compressCache)
+  , m_relations(info.GetIntermediateFileName(RELATIONS_FILE, ""), info.m_preloadCache,
+                info.m_compressCache)
   , m_nodeToRelations(info.GetIntermediateFileName(NODES_FILE, ID2REL_EXT))
   , m_wayToRelations(info.GetIntermediateFileName(WAYS_FILE,ID2REL_EXT))
   {
   }
 
-  void AddNode(TKey id, double lat, double lng) { m_nodes.AddPoint(id, lat, lng); }
+  /// Opens the existing intermediate data to add new and updated elements to it.
+  IntermediateData(TNodesHolder & nodes, feature::GenerateInfo & info, cache::AppendTag tag)
+  : m_nodes(nodes)
+  , m_ways(info.GetIntermediateFileName(WAYS_FILE, ""), tag, info.m_compressCache)
+  , m_relations(info.GetIntermediateFileName(RELATIONS_FILE, ""), tag, info.m_compressCache)
+  , m_nodeToRelations(info.GetIntermediateFileName(NODES_FILE, ID2REL_EXT), tag)
+  , m_wayToRelations(info.GetIntermediateFileName(WAYS_FILE, ID2REL_EXT), tag)
+  {
+  }
+
+  void AddNode(TKey id, double lat, double lng)
+  {
+    ++m_addedCount;
+    m_nodes.AddPoint(id, lat, lng);
+  }
   bool GetNode(TKey id, double & lat, double & lng) { return m_nodes.GetPoint(id, lat, lng); }
 
-  void AddWay(TKey id, WayElement const & e) { m_ways.Write(id, e); }
+  void AddWay(TKey id, WayElement const & e)
+  {
+    ++m_addedCount;
+    m_ways.Write(id, e);
+  }
   bool GetWay(TKey id, WayElement & e) { return m_ways.Read(id, e); }
+  bool GetRelation(TKey id, RelationElement & e) { return m_relations.Read(id, e); }
 
   void AddRelation(TKey id, RelationElement const & e)
   {
+    ++m_addedCount;
     string const & relationType = e.GetType();
     if (!(relationType == "multipolygon" || relationType == "route" || relationType == "boundary"))
       return;
@@ -156,6 +189,8 @@ public:
     m_wayToRelations.ForEachByKey(id, processor);
   }
 
+  uint64_t GetAddedCount() const { return m_addedCount; }
+
   void SaveIndex()
   {
     m_ways.SaveOffsets();
@@ -409,14 +444,60 @@ void BuildIntermediateDataFromO5M(SourceReader & stream, TCache & cache)
     AddElementToCache(cache, e);
 }
 
-void BuildFeaturesFromO5M(SourceReader & stream, function<void(OsmElement *)> processor)
+namespace
 {
-  using TType = osm::O5MSource::EntityType;
+// Elements are passed between threads by batches to keep synchronization cheap.
+size_t constexpr kElementsBatchSize = 4096;
+// Number of batches or blocks per thread which are read ahead of processing.
+size_t constexpr kReadAheadPerThread = 2;
+
+/// BoundedQueue passes values from a producer thread to a consumer one,
+/// Push() blocks while the queue is full.
+template <typename T>
+class BoundedQueue
+{
+public:
+  explicit BoundedQueue(size_t maxSize) : m_maxSize(maxSize) {}
 
-  osm::O5MSource dataset([&stream](uint8_t * buffer, size_t size)
+  void Push(T && value)
   {
-    return stream.Read(reinterpret_cast<char *>(buffer), size);
-  });
+    unique_lock<mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_queue.size() < m_maxSize; });
+    m_queue.push_back(move(value));
+    m_cv.notify_all();
+  }
+
+  /// @return False when the queue is closed and all the values are popped.
+  bool Pop(T & value)
+  {
+    unique_lock<mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return !m_queue.empty() || m_closed; });
+    if (m_queue.empty())
+      return false;
+    value = move(m_queue.front());
+    m_queue.pop_front();
+    m_cv.notify_all();
+    return true;
+  }
+
+  void Close()
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_closed = true;
+    m_cv.notify_all();
+  }
+
+private:
+  size_t const m_maxSize;
+  bool m_closed = false;
+  deque<T> m_queue;
+  mutex m_mutex;
+  condition_variable m_cv;
+};
+
+void O5MEntityToOsmElement(osm::O5MSource::Entity const & em, OsmElement & p)
+{
+  using TType = osm::O5MSource::EntityType;
 
   auto translate = [](TType t) -> OsmElement::EntityType
   {
@@ -429,42 +510,241 @@ void BuildFeaturesFromO5M(SourceReader & stream, function<void(OsmElement *)> pr
     }
   };
 
-  for (auto const & em : dataset)
+  p.id = em.id;
+
+  switch (em.type)
   {
-    OsmElement p;
-    p.id = em.id;
+    case TType::Node:
+    {
+      p.type = OsmElement::EntityType::Node;
+      p.lat = em.lat;
+      p.lon = em.lon;
+      break;
+    }
+    case TType::Way:
+    {
+      p.type = OsmElement::EntityType::Way;
+      for (uint64_t nd : em.Nodes())
+        p.AddNd(nd);
+      break;
+    }
+    case TType::Relation:
+    {
+      p.type = OsmElement::EntityType::Relation;
+      for (auto const & member : em.Members())
+        p.AddMember(member.ref, translate(member.type), member.role);
+      break;
+    }
+    default: break;
+  }
 
-    switch (em.type)
+  for (auto const & tag : em.Tags())
+    p.AddTag(tag.key, tag.value);
+}
+
+void DecodePbfBlock(osm::PbfBlob const & blob, vector<OsmElement> & elements)
+{
+  switch (blob.m_type)
+  {
+    case osm::PbfBlob::Type::Header: osm::CheckPbfHeader(blob); break;
+    case osm::PbfBlob::Type::Data: osm::DecodePbfBlob(blob, elements); break;
+    case osm::PbfBlob::Type::Unknown: break;
+  }
+}
+
+/// PbfPipeline reads blobs of a .osm.pbf stream on its own thread, decodes them on
+/// a number of worker threads and passes the elements to the processor on the calling thread
+/// in the order of the stream.
+class PbfPipeline
+{
+public:
+  PbfPipeline(SourceReader & stream, size_t threadsCount)
+    : m_stream(stream), m_threadsCount(threadsCount), m_maxBlocks(kReadAheadPerThread * threadsCount)
+  {
+  }
+
+  void Run(function<void(OsmElement *)> const & processor)
+  {
+    vector<thread> workers;
+    for (size_t i = 0; i < m_threadsCount; ++i)
+      workers.emplace_back(&PbfPipeline::Decode, this);
+    thread reader(&PbfPipeline::Read, this);
+
+    Consume(processor);
+
+    reader.join();
+    for (auto & worker : workers)
+      worker.join();
+  }
+
+private:
+  struct Block
+  {
+    osm::PbfBlob m_blob;
+    vector<OsmElement> m_elements;
+    bool m_ready = false;
+  };
+
+  void Read()
+  {
+    osm::PbfBlobReader reader([this](uint8_t * buffer, size_t size)
     {
-      case TType::Node:
-      {
-        p.type = OsmElement::EntityType::Node;
-        p.lat = em.lat;
-        p.lon = em.lon;
+      return m_stream.Read(reinterpret_cast<char *>(buffer), size);
+    });
+
+    while (true)
+    {
+      auto block = make_shared<Block>();
+      if (!reader.Read(block->m_blob))
         break;
+
+      unique_lock<mutex> lock(m_mutex);
+      m_cv.wait(lock, [this]() { return m_blocks.size() < m_maxBlocks; });
+      m_blocks.push_back(block);
+      m_decodeQueue.push_back(block);
+      m_cv.notify_all();
+    }
+
+    lock_guard<mutex> lock(m_mutex);
+    m_readDone = true;
+    m_cv.notify_all();
+  }
+
+  void Decode()
+  {
+    while (true)
+    {
+      shared_ptr<Block> block;
+      {
+        unique_lock<mutex> lock(m_mutex);
+        m_cv.wait(lock, [this]() { return !m_decodeQueue.empty() || m_readDone; });
+        if (m_decodeQueue.empty())
+          return;
+        block = m_decodeQueue.front();
+        m_decodeQueue.pop_front();
       }
-      case TType::Way:
+
+      DecodePbfBlock(block->m_blob, block->m_elements);
+      string().swap(block->m_blob.m_data);
+
+      lock_guard<mutex> lock(m_mutex);
+      block->m_ready = true;
+      m_cv.notify_all();
+    }
+  }
+
+  void Consume(function<void(OsmElement *)> const & processor)
+  {
+    while (true)
+    {
+      shared_ptr<Block> block;
       {
-        p.type = OsmElement::EntityType::Way;
-        for (uint64_t nd : em.Nodes())
-          p.AddNd(nd);
-        break;
+        unique_lock<mutex> lock(m_mutex);
+        m_cv.wait(lock, [this]()
+        {
+          return (!m_blocks.empty() && m_blocks.front()->m_ready) || (m_blocks.empty() && m_readDone);
+        });
+        if (m_blocks.empty())
+          return;
+        block = m_blocks.front();
+        m_blocks.pop_front();
+        m_cv.notify_all();
       }
-      case TType::Relation:
+
+      for (auto & e : block->m_elements)
+        processor(&e);
+    }
+  }
+
+  SourceReader & m_stream;
+  size_t const m_threadsCount;
+  size_t const m_maxBlocks;
+
+  mutex m_mutex;
+  condition_variable m_cv;
+  // Blocks in the order of the stream which are not processed yet.
+  deque<shared_ptr<Block>> m_blocks;
+  deque<shared_ptr<Block>> m_decodeQueue;
+  bool m_readDone = false;
+};
+}  // namespace
+
+void BuildFeaturesFromO5M(SourceReader & stream, function<void(OsmElement *)> processor,
+                          size_t threadsCount)
+{
+  osm::O5MSource dataset([&stream](uint8_t * buffer, size_t size)
+  {
+    return stream.Read(reinterpret_cast<char *>(buffer), size);
+  });
+
+  if (threadsCount <= 1)
+  {
+    for (auto const & em : dataset)
+    {
+      OsmElement p;
+      O5MEntityToOsmElement(em, p);
+      processor(&p);
+    }
+    return;
+  }
+
+  // Datasets of o5m depend on the previous ones by delta coding and the string table, and
+  // planet dumps are reset rarely, so the stream is decoded on a single thread
+  // while the elements are processed on the calling one.
+  using TBatch = vector<OsmElement>;
+  BoundedQueue<TBatch> queue(kReadAheadPerThread * threadsCount);
+  thread decoder([&dataset, &queue]()
+  {
+    TBatch batch;
+    batch.reserve(kElementsBatchSize);
+    for (auto const & em : dataset)
+    {
+      batch.emplace_back();
+      O5MEntityToOsmElement(em, batch.back());
+      if (batch.size() == kElementsBatchSize)
       {
-        p.type = OsmElement::EntityType::Relation;
-        for (auto const & member : em.Members())
-          p.AddMember(member.ref, translate(member.type), member.role);
-        break;
+        queue.Push(move(batch));
+        batch = TBatch();
+        batch.reserve(kElementsBatchSize);
       }
-      default: break;
     }
+    if (!batch.empty())
+      queue.Push(move(batch));
+    queue.Close();
+  });
+
+  TBatch batch;
+  while (queue.Pop(batch))
+  {
+    for (auto & e : batch)
+      processor(&e);
+  }
+  decoder.join();
+}
 
-    for (auto const & tag : em.Tags())
-      p.AddTag(tag.key, tag.value);
+void BuildFeaturesFromPBF(SourceReader & stream, function<void(OsmElement *)> processor,
+                          size_t threadsCount)
+{
+  if (threadsCount <= 1)
+  {
+    osm::PbfBlobReader reader([&stream](uint8_t * buffer, size_t size)
+    {
+      return stream.Read(reinterpret_cast<char *>(buffer), size);
+    });
 
-    processor(&p);
+    osm::PbfBlob blob;
+    vector<OsmElement> elements;
+    while (reader.Read(blob))
+    {
+      elements.clear();
+      DecodePbfBlock(blob, elements);
+      for (auto & e : elements)
+        processor(&e);
+    }
+    return;
   }
+
+  PbfPipeline(stream, threadsCount).Run(processor);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -487,7 +767,12 @@ bool GenerateFeaturesImpl(feature::GenerateInfo & info)
         bucketer, cache, info.m_makeCoasts ? classif().GetCoastType() : 0,
         info.GetAddressesFileName());
 
-    auto fn = [&parser](OsmElement * e) { parser.EmitElement(e); };
+    uint64_t elementsCount = 0;
+    auto fn = [&parser, &elementsCount](OsmElement * e)
+    {
+      ++elementsCount;
+      parser.EmitElement(e);
+    };
 
     SourceReader reader = info.m_osmFileName.empty() ? SourceReader() : SourceReader(info.m_osmFileName);
     switch (info.m_osmFileType)
@@ -496,11 +781,15 @@ bool GenerateFeaturesImpl(feature::GenerateInfo & info)
         BuildFeaturesFromXML(reader, fn);
         break;
       case feature::GenerateInfo::OsmSourceType::O5M:
-        BuildFeaturesFromO5M(reader, fn);
+        BuildFeaturesFromO5M(reader, fn, info.m_osmThreadsCount);
+        break;
+      case feature::GenerateInfo::OsmSourceType::PBF:
+        BuildFeaturesFromPBF(reader, fn, info.m_osmThreadsCount);
         break;
     }
 
     LOG(LINFO, ("Processing", info.m_osmFileName, "done."));
+    info.m_osmElementsCount = elementsCount;
 
     parser.Finish();
 
@@ -531,17 +820,26 @@ bool GenerateIntermediateDataImpl(feature::GenerateInfo & info)
 
     LOG(LINFO, ("Data source:", info.m_osmFileName));
 
+    auto addToCache = [&cache](OsmElement * e) { AddElementToCache(cache, *e); };
+
     switch (info.m_osmFileType)
     {
       case feature::GenerateInfo::OsmSourceType::XML:
         BuildIntermediateDataFromXML(reader, cache);
         break;
       case feature::GenerateInfo::OsmSourceType::O5M:
-        BuildIntermediateDataFromO5M(reader, cache);
+        if (info.m_osmThreadsCount <= 1)
+          BuildIntermediateDataFromO5M(reader, cache);
+        else
+          BuildFeaturesFromO5M(reader, addToCache, info.m_osmThreadsCount);
+        break;
+      case feature::GenerateInfo::OsmSourceType::PBF:
+        BuildFeaturesFromPBF(reader, addToCache, info.m_osmThreadsCount);
         break;
     }
 
     cache.SaveIndex();
+    info.m_osmElementsCount = cache.GetAddedCount();
     LOG(LINFO, ("Added points count = ", nodes.GetProcessedPoint()));
   }
   catch (Writer::Exception const & e)
@@ -561,6 +859,8 @@ bool GenerateFeatures(feature::GenerateInfo & info)
       return GenerateFeaturesImpl<cache::MapFilePointStorage<cache::EMode::Read>>(info);
     case feature::GenerateInfo::NodeStorageType::Memory:
       return GenerateFeaturesImpl<cache::RawMemPointStorage<cache::EMode::Read>>(info);
+    case feature::GenerateInfo::NodeStorageType::Packed:
+      return GenerateFeaturesImpl<cache::PackedFilePointStorage<cache::EMode::Read>>(info);
   }
   return false;
 }
@@ -575,6 +875,163 @@ bool GenerateIntermediateData(feature::GenerateInfo & info)
       return GenerateIntermediateDataImpl<cache::MapFilePointStorage<cache::EMode::Write>>(info);
     case feature::GenerateInfo::NodeStorageType::Memory:
       return GenerateIntermediateDataImpl<cache::RawMemPointStorage<cache::EMode::Write>>(info);
+    case feature::GenerateInfo::NodeStorageType::Packed:
+      return GenerateIntermediateDataImpl<cache::PackedFilePointStorage<cache::EMode::Write>>(info);
+  }
+  return false;
+}
+
+template <class TReadNodes, class TWriteNodes>
+bool UpdateIntermediateDataImpl(feature::GenerateInfo & info)
+{
+  using TAction = OsmChangeSource::Action;
+  vector<pair<TAction, OsmElement>> changes;
+  {
+    SourceReader reader(info.m_osmChangeFileName);
+    OsmChangeSource parser([&changes](TAction action, OsmElement * e)
+    {
+      changes.emplace_back(action, *e);
+    });
+    ParseXMLSequence(reader, parser);
+  }
+  LOG(LINFO, ("Changed elements count =", changes.size()));
+
+  set<string> & affectedCountries = info.m_countriesToGenerate;
+  affectedCountries.clear();
+
+  try
+  {
+    // The countries are found by the points of the old and of the new versions of the changed
+    // elements before the intermediate data is updated.
+    {
+      borders::CountriesContainerT countries;
+      CHECK(borders::LoadCountriesList(info.m_targetDir, countries),
+            ("Error loading country polygons files"));
+
+      TReadNodes nodes(info.GetIntermediateFileName(NODES_FILE, ""));
+      IntermediateData<TReadNodes, cache::EMode::Read> dataCache(nodes, info);
+      dataCache.LoadIndex();
+
+      // The changed nodes aren't looked up in the cache, the new ones are not there.
+      unordered_map<uint64_t, m2::PointD> changedNodes;
+      for (auto const & change : changes)
+      {
+        OsmElement const & e = change.second;
+        if (e.type == OsmElement::EntityType::Node && change.first != TAction::Delete)
+          changedNodes[e.id] = MercatorBounds::FromLatLon(e.lat, e.lon);
+      }
+
+      auto const addPoint = [&countries, &affectedCountries](m2::PointD const & pt)
+      {
+        countries.ForEachInRect(m2::RectD(pt, pt), [&](borders::CountryPolygons const & country)
+        {
+          if (affectedCountries.count(country.m_name) == 0 && country.Contains(pt))
+            affectedCountries.insert(country.m_name);
+        });
+      };
+      auto const addNode = [&](uint64_t id)
+      {
+        auto const it = changedNodes.find(id);
+        if (it != changedNodes.end())
+        {
+          addPoint(it->second);
+          return;
+        }
+        double y, x;
+        if (dataCache.GetNode(id, y, x))
+          addPoint(m2::PointD(x, y));
+      };
+      auto const addWay = [&](uint64_t id)
+      {
+        WayElement way(id);
+        if (dataCache.GetWay(id, way))
+          for_each(way.nodes.begin(), way.nodes.end(), addNode);
+      };
+
+      for (auto const & change : changes)
+      {
+        OsmElement const & e = change.second;
+        bool const hasOldVersion = change.first != TAction::Create;
+        bool const hasNewVersion = change.first != TAction::Delete;
+        switch (e.type)
+        {
+          case OsmElement::EntityType::Node:
+            if (hasNewVersion)
+              addPoint(changedNodes[e.id]);
+            break;
+          case OsmElement::EntityType::Way:
+            if (hasOldVersion)
+              addWay(e.id);
+            if (hasNewVersion)
+              for_each(e.Nodes().begin(), e.Nodes().end(), addNode);
+            break;
+          case OsmElement::EntityType::Relation:
+          {
+            // Node members are skipped, they are not used for the geometry of the features.
+            RelationElement relation;
+            if (hasOldVersion && dataCache.GetRelation(e.id, relation))
+            {
+              for (auto const & member : relation.ways)
+                addWay(member.first);
+            }
+            if (hasNewVersion)
+            {
+              for (auto const & member : e.Members())
+              {
+                if (member.type == OsmElement::EntityType::Way)
+                  addWay(member.ref);
+              }
+            }
+            break;
+          }
+          default:
+            break;
+        }
+      }
+    }
+    LOG(LINFO, ("Affected countries:", affectedCountries));
+
+    // Deleted elements are left in the intermediate data, they are not referenced by the
+    // elements of the updated osm file.
+    {
+      cache::AppendTag const tag;
+      TWriteNodes nodes(info.GetIntermediateFileName(NODES_FILE, ""), tag);
+      IntermediateData<TWriteNodes, cache::EMode::Write> dataCache(nodes, info, tag);
+      for (auto const & change : changes)
+      {
+        if (change.first != TAction::Delete)
+          AddElementToCache(dataCache, change.second);
+      }
+      dataCache.SaveIndex();
+      info.m_osmElementsCount = dataCache.GetAddedCount();
+      LOG(LINFO, ("Updated points count = ", nodes.GetProcessedPoint()));
+    }
+  }
+  catch (RootException const & e)
+  {
+    LOG(LCRITICAL, ("Error with file ", e.what()));
+  }
+  return true;
+}
+
+bool UpdateIntermediateData(feature::GenerateInfo & info)
+{
+  switch (info.m_nodeStorageType)
+  {
+    case feature::GenerateInfo::NodeStorageType::File:
+      return UpdateIntermediateDataImpl<cache::RawFilePointStorage<cache::EMode::Read>,
+                                        cache::RawFilePointStorage<cache::EMode::Write>>(info);
+    case feature::GenerateInfo::NodeStorageType::Index:
+      return UpdateIntermediateDataImpl<cache::MapFilePointStorage<cache::EMode::Read>,
+                                        cache::MapFilePointStorage<cache::EMode::Write>>(info);
+    case feature::GenerateInfo::NodeStorageType::Memory:
+      // The file of the memory storage has the same format as the raw file one, it's updated
+      // in place to avoid loading all the points.
+      return UpdateIntermediateDataImpl<cache::RawFilePointStorage<cache::EMode::Read>,
+                                        cache::RawFilePointStorage<cache::EMode::Write>>(info);
+    case feature::GenerateInfo::NodeStorageType::Packed:
+      LOG(LCRITICAL, ("Packed node storage can't be updated, use raw, map or mem storage."));
+      break;
   }
   return false;
 }
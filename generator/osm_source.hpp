@@ -34,7 +34,16 @@ public:
 
 bool GenerateFeatures(feature::GenerateInfo & info);
 bool GenerateIntermediateData(feature::GenerateInfo & info);
-
-void BuildFeaturesFromO5M(SourceReader & stream, function<void(OsmElement *)> processor);
+/// Adds the elements of info.m_osmChangeFileName to the existing intermediate data
+/// and fills info.m_countriesToGenerate with the countries the changed elements belong to.
+bool UpdateIntermediateData(feature::GenerateInfo & info);
+
+/// When threadsCount is greater than one, o5m stream is decoded on a separate thread
+/// and pbf blobs are decoded on threadsCount threads. In any case the processor is called
+/// on the calling thread in the order of the stream.
+void BuildFeaturesFromO5M(SourceReader & stream, function<void(OsmElement *)> processor,
+                          size_t threadsCount = 1);
+void BuildFeaturesFromPBF(SourceReader & stream, function<void(OsmElement *)> processor,
+                          size_t threadsCount = 1);
 void BuildFeaturesFromXML(SourceReader & stream, function<void(OsmElement *)> processor);
 
@@ -9,6 +9,8 @@
 #include "indexer/feature_visibility.hpp"
 #include "indexer/classificator.hpp"
 
+#include "coding/buffered_file_writer.hpp"
+
 #include "geometry/tree4d.hpp"
 
 #include "base/string_utils.hpp"
@@ -217,7 +219,7 @@ class OsmToFeatureTranslator
   TEmitter & m_emitter;
   TCache & m_holder;
   uint32_t m_coastType;
-  unique_ptr<FileWriter> m_addrWriter;
+  unique_ptr<BufferedFileWriter> m_addrWriter;
   m4::Tree<Place> m_places;
   RelationTagsNode m_nodeRelations;
   RelationTagsWay m_wayRelations;
@@ -531,7 +533,7 @@ public:
     : m_emitter(emitter), m_holder(holder), m_coastType(coastType)
   {
     if (!addrFilePath.empty())
-      m_addrWriter.reset(new FileWriter(addrFilePath));
+      m_addrWriter.reset(new BufferedFileWriter(addrFilePath));
   }
 
   void Finish()
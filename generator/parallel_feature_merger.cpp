@@ -0,0 +1,287 @@
+#include "generator/parallel_feature_merger.hpp"
+
+#include "indexer/mercator.hpp"
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/varint.hpp"
+
+#include "base/logging.hpp"
+#include "base/math.hpp"
+#include "base/string_utils.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/condition_variable.hpp"
+#include "std/deque.hpp"
+#include "std/limits.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/thread.hpp"
+
+namespace
+{
+uint32_t constexpr kSeveralCells = numeric_limits<uint32_t>::max();
+// Number of cells per thread which are merged ahead of emitting.
+size_t constexpr kMergeAheadPerThread = 2;
+
+void WriteFeature(FeatureBuilder1 const & fb, FileWriter & writer)
+{
+  FeatureBuilder1::TBuffer buffer;
+  fb.Serialize(buffer);
+  WriteVarUint(writer, static_cast<uint32_t>(buffer.size()));
+  writer.Write(buffer.data(), buffer.size());
+}
+
+class VectorEmitter : public FeatureEmitterIFace
+{
+public:
+  explicit VectorEmitter(vector<FeatureBuilder1> & features) : m_features(features) {}
+
+  void operator()(FeatureBuilder1 const & fb) override { m_features.push_back(fb); }
+
+private:
+  vector<FeatureBuilder1> & m_features;
+};
+}  // namespace
+
+// static
+uint32_t constexpr ParallelFeatureMerger::kDefaultCellsPerSide;
+
+struct ParallelFeatureMerger::CellResult
+{
+  uint32_t m_cell = 0;
+  vector<FeatureBuilder1> m_features;
+  vector<FeatureBuilder1> m_seams;
+  bool m_ready = false;
+};
+
+ParallelFeatureMerger::ParallelFeatureMerger(uint32_t coordBits, string const & filesPrefix,
+                                             size_t threadsCount, uint32_t cellsPerSide)
+  : m_coordBits(coordBits)
+  , m_filesPrefix(filesPrefix)
+  , m_threadsCount(max(threadsCount, static_cast<size_t>(1)))
+  , m_cellsPerSide(max(cellsPerSide, static_cast<uint32_t>(1)))
+  , m_cells(m_cellsPerSide * m_cellsPerSide)
+{
+}
+
+ParallelFeatureMerger::~ParallelFeatureMerger()
+{
+  for (uint32_t cell = 0; cell < m_cells.size(); ++cell)
+  {
+    if (m_cells[cell].m_featuresCount != 0)
+    {
+      m_cells[cell].m_writer.reset();
+      my::DeleteFileX(GetCellFileName(cell));
+    }
+  }
+}
+
+void ParallelFeatureMerger::operator()(MergedFeatureBuilder1 * p)
+{
+  unique_ptr<MergedFeatureBuilder1> holder(p);
+  (*this)(static_cast<FeatureBuilder1 const &>(*p));
+}
+
+void ParallelFeatureMerger::operator()(FeatureBuilder1 const & fb)
+{
+  uint32_t const cell = GetCell(fb.GetOuterGeometry().front());
+  Cell & c = m_cells[cell];
+  if (!c.m_writer)
+    c.m_writer = make_unique<FileWriter>(GetCellFileName(cell));
+  WriteFeature(fb, *c.m_writer);
+  ++c.m_featuresCount;
+
+  ForEachKey(fb, [this, cell](int64_t key)
+  {
+    auto const res = m_keyCells.emplace(key, cell);
+    if (!res.second && res.first->second != cell)
+      res.first->second = kSeveralCells;
+  });
+}
+
+void ParallelFeatureMerger::DoMerge(FeatureEmitterIFace & emitter)
+{
+  vector<uint32_t> cells;
+  uint64_t featuresCount = 0;
+  for (uint32_t cell = 0; cell < m_cells.size(); ++cell)
+  {
+    if (m_cells[cell].m_featuresCount == 0)
+      continue;
+    m_cells[cell].m_writer.reset();
+    cells.push_back(cell);
+    featuresCount += m_cells[cell].m_featuresCount;
+  }
+  LOG(LINFO, ("Merging", featuresCount, "features in", cells.size(), "cells on", m_threadsCount,
+              "threads, key points:", m_keyCells.size()));
+
+  // The cells are merged on the workers and are emitted on the calling thread in the order of
+  // the cells, the seam chains are spilled to a file until all the cells are done.
+  mutex mu;
+  condition_variable cv;
+  deque<shared_ptr<CellResult>> queue;
+  bool done = false;
+
+  auto const work = [&]()
+  {
+    while (true)
+    {
+      shared_ptr<CellResult> result;
+      {
+        unique_lock<mutex> lock(mu);
+        cv.wait(lock, [&]() { return !queue.empty() || done; });
+        if (queue.empty())
+          return;
+        result = queue.front();
+        queue.pop_front();
+      }
+
+      MergeCell(result->m_cell, *result);
+
+      lock_guard<mutex> lock(mu);
+      result->m_ready = true;
+      cv.notify_all();
+    }
+  };
+
+  vector<thread> workers;
+  for (size_t i = 0; i < m_threadsCount; ++i)
+    workers.emplace_back(work);
+
+  uint64_t seamsCount = 0;
+  {
+    FileWriter seamsWriter(GetSeamsFileName());
+    size_t next = 0;
+    deque<shared_ptr<CellResult>> results;
+    while (next < cells.size() || !results.empty())
+    {
+      while (next < cells.size() && results.size() < kMergeAheadPerThread * m_threadsCount)
+      {
+        auto result = make_shared<CellResult>();
+        result->m_cell = cells[next++];
+        results.push_back(result);
+
+        lock_guard<mutex> lock(mu);
+        queue.push_back(result);
+        cv.notify_all();
+      }
+
+      shared_ptr<CellResult> result = results.front();
+      results.pop_front();
+      {
+        unique_lock<mutex> lock(mu);
+        cv.wait(lock, [&result]() { return result->m_ready; });
+      }
+
+      for (FeatureBuilder1 const & fb : result->m_features)
+        emitter(fb);
+      for (FeatureBuilder1 const & fb : result->m_seams)
+        WriteFeature(fb, seamsWriter);
+      seamsCount += result->m_seams.size();
+    }
+
+    {
+      lock_guard<mutex> lock(mu);
+      done = true;
+      cv.notify_all();
+    }
+    for (auto & worker : workers)
+      worker.join();
+  }
+  // The files of the cells are deleted by the workers.
+  for (Cell & c : m_cells)
+    c.m_featuresCount = 0;
+
+  LOG(LINFO, ("Stitching", seamsCount, "chains on the seams of the cells"));
+  FeatureMergeProcessor stitcher(m_coordBits);
+  feature::ForEachFromDatRawFormat(GetSeamsFileName(),
+                                   [&stitcher](FeatureBuilder1 const & fb, uint64_t)
+                                   {
+                                     stitcher(fb);
+                                   });
+  my::DeleteFileX(GetSeamsFileName());
+  stitcher.DoMerge(emitter);
+
+  m_keyCells.clear();
+}
+
+uint32_t ParallelFeatureMerger::GetCell(m2::PointD const & pt) const
+{
+  auto const toIndex = [this](double v, double minV, double maxV)
+  {
+    double const index = (v - minV) / (maxV - minV) * m_cellsPerSide;
+    return static_cast<uint32_t>(my::clamp(index, 0.0, static_cast<double>(m_cellsPerSide - 1)));
+  };
+  return toIndex(pt.y, MercatorBounds::minY, MercatorBounds::maxY) * m_cellsPerSide +
+         toIndex(pt.x, MercatorBounds::minX, MercatorBounds::maxX);
+}
+
+string ParallelFeatureMerger::GetCellFileName(uint32_t cell) const
+{
+  return m_filesPrefix + strings::to_string(cell) + ".tmp";
+}
+
+string ParallelFeatureMerger::GetSeamsFileName() const
+{
+  return m_filesPrefix + "seams.tmp";
+}
+
+template <class ToDo>
+void ParallelFeatureMerger::ForEachKey(FeatureBuilder1 const & fb, ToDo && toDo) const
+{
+  // The points are rounded as they are spilled, so the keys of the features and of the merged
+  // chains which are read back are the same.
+  auto const getKey = [this](m2::PointD const & pt)
+  {
+    return PointToInt64(PointU2PointD(PointD2PointU(pt, POINT_COORD_BITS), POINT_COORD_BITS),
+                        m_coordBits);
+  };
+
+  FeatureBuilder1::TPointSeq const & points = fb.GetOuterGeometry();
+  int64_t const first = getKey(points.front());
+  int64_t const last = getKey(points.back());
+  toDo(first);
+  if (first != last)
+  {
+    toDo(last);
+    return;
+  }
+  // The middle points of the round features are the keys too.
+  for (size_t i = 1; i + 1 < points.size(); ++i)
+    toDo(getKey(points[i]));
+}
+
+bool ParallelFeatureMerger::IsSeam(FeatureBuilder1 const & fb) const
+{
+  bool seam = false;
+  ForEachKey(fb, [this, &seam](int64_t key)
+  {
+    auto const it = m_keyCells.find(key);
+    if (it != m_keyCells.end() && it->second == kSeveralCells)
+      seam = true;
+  });
+  return seam;
+}
+
+void ParallelFeatureMerger::MergeCell(uint32_t cell, CellResult & result) const
+{
+  FeatureMergeProcessor processor(m_coordBits);
+  string const fileName = GetCellFileName(cell);
+  feature::ForEachFromDatRawFormat(fileName, [&processor](FeatureBuilder1 const & fb, uint64_t)
+  {
+    processor(fb);
+  });
+  my::DeleteFileX(fileName);
+
+  vector<FeatureBuilder1> merged;
+  VectorEmitter emitter(merged);
+  processor.DoMerge(emitter);
+  for (FeatureBuilder1 & fb : merged)
+  {
+    if (IsSeam(fb))
+      result.m_seams.push_back(move(fb));
+    else
+      result.m_features.push_back(move(fb));
+  }
+}
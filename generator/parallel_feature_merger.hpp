@@ -0,0 +1,68 @@
+#pragma once
+
+#include "generator/feature_merger.hpp"
+
+#include "base/macros.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/unordered_map.hpp"
+#include "std/vector.hpp"
+
+class FileWriter;
+
+/// Merges the line features like FeatureMergeProcessor, but with bounded memory and on several
+/// threads. The features are partitioned to the cells of a grid by their first point and are
+/// spilled to a file per cell. DoMerge() merges the cells on the worker threads, the merged
+/// chains with the key points which are shared with the other cells are stitched by the final
+/// pass of FeatureMergeProcessor. Only the key points and the cells they are in are kept in memory.
+class ParallelFeatureMerger
+{
+public:
+  static uint32_t constexpr kDefaultCellsPerSide = 16;
+
+  /// @param filesPrefix Prefix of the files the features are spilled to.
+  ParallelFeatureMerger(uint32_t coordBits, string const & filesPrefix, size_t threadsCount,
+                        uint32_t cellsPerSide = kDefaultCellsPerSide);
+  ~ParallelFeatureMerger();
+
+  /// Takes the ownership of p, like FeatureMergeProcessor.
+  void operator()(MergedFeatureBuilder1 * p);
+  void operator()(FeatureBuilder1 const & fb);
+
+  /// Emits the merged features in the order which doesn't depend on the number of threads.
+  void DoMerge(FeatureEmitterIFace & emitter);
+
+private:
+  struct Cell
+  {
+    unique_ptr<FileWriter> m_writer;
+    uint64_t m_featuresCount = 0;
+  };
+
+  struct CellResult;
+
+  uint32_t GetCell(m2::PointD const & pt) const;
+  string GetCellFileName(uint32_t cell) const;
+  string GetSeamsFileName() const;
+
+  /// Calls toDo for the key points of fb, as FeatureMergeProcessor inserts them.
+  template <class ToDo>
+  void ForEachKey(FeatureBuilder1 const & fb, ToDo && toDo) const;
+  /// @return true if fb can be merged with the features of the other cells.
+  bool IsSeam(FeatureBuilder1 const & fb) const;
+
+  void MergeCell(uint32_t cell, CellResult & result) const;
+
+  uint32_t const m_coordBits;
+  string const m_filesPrefix;
+  size_t const m_threadsCount;
+  uint32_t const m_cellsPerSide;
+
+  vector<Cell> m_cells;
+  /// Cell of the features with the key point or kSeveralCells.
+  unordered_map<int64_t, uint32_t> m_keyCells;
+
+  DISALLOW_COPY_AND_MOVE(ParallelFeatureMerger);
+};
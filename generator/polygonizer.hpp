@@ -15,6 +15,7 @@
 #include "base/buffer_vector.hpp"
 #include "base/macros.hpp"
 
+#include "std/mutex.hpp"
 #include "std/string.hpp"
 
 
@@ -23,10 +24,7 @@
 #endif
 
 #if PARALLEL_POLYGONIZER
-#include <QtCore/QSemaphore>
-#include <QtCore/QThreadPool>
-#include <QtCore/QMutex>
-#include <QtCore/QMutexLocker>
+#include "base/work_stealing_pool.hpp"
 #endif
 
 
@@ -43,25 +41,40 @@ namespace feature
     borders::CountriesContainerT m_countries;
 
 #if PARALLEL_POLYGONIZER
-    QThreadPool m_ThreadPool;
-    QSemaphore m_ThreadPoolSemaphore;
-    QMutex m_EmitFeatureMutex;
+    // Number of the tasks per thread which may wait in the pool.
+    static size_t constexpr kPendingTasksPerThread = 8;
+
+    threads::WorkStealingPool m_pool;
+    mutex m_EmitFeatureMutex;
 #endif
 
   public:
     explicit Polygonizer(feature::GenerateInfo const & info) : m_info(info)
 #if PARALLEL_POLYGONIZER
-    , m_ThreadPoolSemaphore(m_ThreadPool.maxThreadCount() * 8)
+    , m_pool(0 /* threadsCount */, kPendingTasksPerThread * max(thread::hardware_concurrency(), 1u))
 #endif
     {
 #if PARALLEL_POLYGONIZER
-      LOG(LINFO, ("Polygonizer thread pool threads:", m_ThreadPool.maxThreadCount()));
+      LOG(LINFO, ("Polygonizer thread pool threads:", m_pool.GetThreadsCount()));
 #endif
 
       if (info.m_splitByPolygons)
       {
         CHECK(borders::LoadCountriesList(info.m_targetDir, m_countries),
             ("Error loading country polygons files"));
+
+        if (!info.m_countriesToGenerate.empty())
+        {
+          borders::CountriesContainerT countries;
+          m_countries.ForEachWithRect([&countries, &info](m2::RectD const & rect,
+                                                          borders::CountryPolygons const & country)
+          {
+            if (info.m_countriesToGenerate.count(country.m_name) != 0)
+              countries.Add(country, rect);
+          });
+          m_countries = countries;
+          LOG(LINFO, ("Countries to generate:", m_countries.GetSize()));
+        }
       }
       else
       {
@@ -78,23 +91,17 @@ namespace feature
 
     struct PointChecker
     {
-      borders::RegionsContainerT const & m_regions;
+      borders::CountryPolygons const & m_country;
       bool m_belongs;
 
-      PointChecker(borders::RegionsContainerT const & regions)
-        : m_regions(regions), m_belongs(false) {}
+      PointChecker(borders::CountryPolygons const & country)
+        : m_country(country), m_belongs(false) {}
 
       bool operator()(m2::PointD const & pt)
       {
-        m_regions.ForEachInRect(m2::RectD(pt, pt), bind<void>(ref(*this), _1, cref(pt)));
+        m_belongs = m_country.Contains(pt);
         return !m_belongs;
       }
-
-      void operator() (borders::Region const & rgn, borders::Region::ValueT const & point)
-      {
-        if (!m_belongs)
-          m_belongs = rgn.Contains(point);
-      }
     };
 
     class InsertCountriesPtr
@@ -125,11 +132,9 @@ namespace feature
       default:
         {
 #if PARALLEL_POLYGONIZER
-          m_ThreadPoolSemaphore.acquire();
-          m_ThreadPool.start(new PolygonizerTask(this, vec, fb));
+          m_pool.Push([this, vec, fb]() { EmitToBelonging(vec, fb); });
 #else
-          PolygonizerTask task(this, vec, fb);
-          task.RunBase();
+          EmitToBelonging(vec, fb);
 #endif
         }
       }
@@ -138,15 +143,14 @@ namespace feature
     void Finish()
     {
 #if PARALLEL_POLYGONIZER
-      m_ThreadPool.waitForDone();
+      m_pool.WaitForDone();
 #endif
     }
 
     void EmitFeature(borders::CountryPolygons const * country, FeatureBuilder1 const & fb)
     {
 #if PARALLEL_POLYGONIZER
-      QMutexLocker mutexLocker(&m_EmitFeatureMutex);
-      UNUSED_VALUE(mutexLocker);
+      lock_guard<mutex> lock(m_EmitFeatureMutex);
 #endif
       if (country->m_index == -1)
       {
@@ -164,44 +168,17 @@ namespace feature
     }
 
   private:
-    friend class PolygonizerTask;
-
-    class PolygonizerTask
-#if PARALLEL_POLYGONIZER
-      : public QRunnable
-#endif
+    void EmitToBelonging(buffer_vector<borders::CountryPolygons const *, 32> const & countries,
+                         FeatureBuilder1 const & fb)
     {
-    public:
-      PolygonizerTask(Polygonizer * pPolygonizer,
-                      buffer_vector<borders::CountryPolygons const *, 32> const & countries,
-                      FeatureBuilder1 const & fb)
-        : m_pPolygonizer(pPolygonizer), m_Countries(countries), m_FB(fb) {}
-
-      void RunBase()
+      for (borders::CountryPolygons const * country : countries)
       {
-        for (size_t i = 0; i < m_Countries.size(); ++i)
-        {
-          PointChecker doCheck(m_Countries[i]->m_regions);
-          m_FB.ForEachGeometryPoint(doCheck);
+        PointChecker doCheck(*country);
+        fb.ForEachGeometryPoint(doCheck);
 
-          if (doCheck.m_belongs)
-            m_pPolygonizer->EmitFeature(m_Countries[i], m_FB);
-        }
+        if (doCheck.m_belongs)
+          EmitFeature(country, fb);
       }
-
-#if PARALLEL_POLYGONIZER
-      void run()
-      {
-        RunBase();
-
-        m_pPolygonizer->m_ThreadPoolSemaphore.release();
-      }
-#endif
-
-    private:
-      Polygonizer * m_pPolygonizer;
-      buffer_vector<borders::CountryPolygons const *, 32> m_Countries;
-      FeatureBuilder1 m_FB;
-    };
+    }
   };
 }
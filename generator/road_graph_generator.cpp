@@ -0,0 +1,277 @@
+#include "generator/road_graph_generator.hpp"
+
+#include "generator/borders_loader.hpp"
+
+#include "routing/bicycle_model.hpp"
+#include "routing/pedestrian_model.hpp"
+#include "routing/road_graph_cross_context.hpp"
+#include "routing/road_graph_section.hpp"
+
+#include "indexer/data_header.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/feature_processor.hpp"
+#include "indexer/mercator.hpp"
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+#include "base/work_stealing_pool.hpp"
+
+#include "defines.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+#include "std/functional.hpp"
+#include "std/queue.hpp"
+#include "std/thread.hpp"
+#include "std/unordered_map.hpp"
+
+namespace routing
+{
+namespace
+{
+double constexpr KMPH2MPS = 1000.0 / (60 * 60);
+
+// Border vertices are processed by the chunks on the threads of the generator.
+size_t constexpr kBordersChunkSize = 16;
+size_t constexpr kPendingChunksPerThread = 4;
+
+/// Loads the roads of the mwm which have positive speeds in the vehicle model of the country.
+/// @return Number of the points of the roads.
+size_t LoadRoads(string const & mwmFile, string const & countryName,
+                 IVehicleModelFactory const & modelFactory, RoadGraphSection::TRoads & roads)
+{
+  // The same vehicle model is used by FeaturesRoadGraph, see GetFeatureCountryName().
+  string const modelCountry = countryName.substr(0, countryName.find('_'));
+  shared_ptr<IVehicleModel> const model = modelFactory.GetVehicleModelForCountry(modelCountry);
+
+  size_t pointsCount = 0;
+  auto const addRoad = [&](FeatureType const & ft, uint32_t index)
+  {
+    if (ft.GetFeatureType() != feature::GEOM_LINE)
+      return;
+    double const speedKMPH = model->GetSpeed(ft);
+    if (speedKMPH <= 0.0)
+      return;
+
+    ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+    IRoadGraph::RoadInfo ri;
+    ri.m_speedKMPH = speedKMPH;
+    ri.m_bidirectional = !model->IsOneWay(ft);
+    ft.SwapPoints(ri.m_points);
+    pointsCount += ri.m_points.size();
+    roads.emplace_back(index, move(ri));
+  };
+  feature::ForEachFromDat(mwmFile, addRoad);
+  return pointsCount;
+}
+
+uint32_t GetCoordBits(string const & mwmFile)
+{
+  return feature::DataHeader((FilesContainerR(mwmFile))).GetDefCodingParams().GetCoordBits();
+}
+
+void BuildRoadGraph(string const & baseDir, string const & countryName,
+                    IVehicleModelFactory const & modelFactory, string const & tag)
+{
+  string const mwmFile = baseDir + countryName + DATA_FILE_EXTENSION;
+  LOG(LINFO, ("Building", tag, "for", mwmFile));
+  my::Timer timer;
+
+  RoadGraphSection::TRoads roads;
+  size_t const pointsCount = LoadRoads(mwmFile, countryName, modelFactory, roads);
+  uint32_t const coordBits = GetCoordBits(mwmFile);
+
+  FilesContainerW container(mwmFile, FileWriter::OP_WRITE_EXISTING);
+  FileWriter writer = container.GetWriter(tag);
+  RoadGraphSection::Serialize(roads, coordBits, writer);
+  LOG(LINFO, ("Roads:", roads.size(), "points:", pointsCount, "section size, bytes:", writer.Size(),
+              "elapsed, seconds:", timer.ElapsedSeconds()));
+}
+
+/// Directed graph of the road vertices, the edges are weighted by the times in seconds.
+class VertexGraph
+{
+public:
+  struct Edge
+  {
+    uint32_t m_target;
+    double m_seconds;
+  };
+
+  VertexGraph(RoadGraphSection::TRoads const & roads, uint32_t coordBits)
+  {
+    // Points of the roads are decoded from the mwm, so the equal points have equal keys.
+    auto const getVertex = [&](m2::PointD const & point)
+    {
+      m2::PointU const pu = PointD2PointU(point, coordBits);
+      uint64_t const key = (static_cast<uint64_t>(pu.x) << 32) | pu.y;
+      auto const it = m_vertices.emplace(key, static_cast<uint32_t>(m_points.size()));
+      if (it.second)
+      {
+        m_points.push_back(point);
+        m_edges.emplace_back();
+      }
+      return it.first->second;
+    };
+
+    for (auto const & road : roads)
+    {
+      IRoadGraph::RoadInfo const & ri = road.second;
+      double const speedMPS = ri.m_speedKMPH * KMPH2MPS;
+      for (size_t i = 1; i < ri.m_points.size(); ++i)
+      {
+        uint32_t const from = getVertex(ri.m_points[i - 1]);
+        uint32_t const to = getVertex(ri.m_points[i]);
+        if (from == to)
+          continue;
+        double const seconds =
+            MercatorBounds::DistanceOnEarth(ri.m_points[i - 1], ri.m_points[i]) / speedMPS;
+        m_edges[from].push_back({to, seconds});
+        if (ri.m_bidirectional)
+          m_edges[to].push_back({from, seconds});
+      }
+    }
+  }
+
+  inline size_t GetVerticesCount() const { return m_points.size(); }
+  inline m2::PointD const & GetPoint(uint32_t vertex) const { return m_points[vertex]; }
+  inline vector<Edge> const & GetEdges(uint32_t vertex) const { return m_edges[vertex]; }
+
+private:
+  unordered_map<uint64_t, uint32_t> m_vertices;
+  vector<m2::PointD> m_points;
+  vector<vector<Edge>> m_edges;
+};
+
+/// Calls fn(vertex, seconds) for the vertices which are reachable from the source vertex
+/// in kMaxWeightSeconds.
+template <typename TFn>
+void ForEachReachable(VertexGraph const & graph, uint32_t source, TFn && fn)
+{
+  using TQueueItem = pair<double, uint32_t>;
+  priority_queue<TQueueItem, vector<TQueueItem>, greater<TQueueItem>> queue;
+  unordered_map<uint32_t, double> bestSeconds;
+  bestSeconds[source] = 0.0;
+  queue.emplace(0.0, source);
+  while (!queue.empty())
+  {
+    TQueueItem const item = queue.top();
+    queue.pop();
+    if (item.first > bestSeconds[item.second])
+      continue;
+    fn(item.second, item.first);
+
+    for (auto const & edge : graph.GetEdges(item.second))
+    {
+      double const seconds = item.first + edge.m_seconds;
+      if (seconds > RoadGraphCrossContext::kMaxWeightSeconds)
+        continue;
+      auto const it = bestSeconds.emplace(edge.m_target, seconds);
+      if (!it.second && it.first->second <= seconds)
+        continue;
+      it.first->second = seconds;
+      queue.emplace(seconds, edge.m_target);
+    }
+  }
+}
+}  // namespace
+
+void BuildPedestrianRoadGraph(string const & baseDir, string const & countryName)
+{
+  BuildRoadGraph(baseDir, countryName, PedestrianModelFactory(), PEDESTRIAN_ROAD_GRAPH_FILE_TAG);
+}
+
+void BuildBicycleRoadGraph(string const & baseDir, string const & countryName)
+{
+  BuildRoadGraph(baseDir, countryName, BicycleModelFactory(), BICYCLE_ROAD_GRAPH_FILE_TAG);
+}
+
+void BuildPedestrianCrossContext(string const & baseDir, string const & countryName)
+{
+  string const mwmFile = baseDir + countryName + DATA_FILE_EXTENSION;
+  LOG(LINFO, ("Building pedestrian cross context for", mwmFile));
+  my::Timer timer;
+
+  borders::CountriesContainerT countries;
+  CHECK(borders::LoadCountriesList(baseDir, countries), ("Error loading country polygons files"));
+  borders::CountryPolygons const * border = nullptr;
+  countries.ForEach([&](borders::CountryPolygons const & c)
+  {
+    if (c.m_name == countryName)
+      border = &c;
+  });
+  if (border == nullptr)
+  {
+    LOG(LWARNING, ("No borders of", countryName));
+    return;
+  }
+
+  RoadGraphSection::TRoads roads;
+  LoadRoads(mwmFile, countryName, PedestrianModelFactory(), roads);
+  uint32_t const coordBits = GetCoordBits(mwmFile);
+  VertexGraph const graph(roads, coordBits);
+
+  // The mwms keep the whole roads crossing their borders, so both ends of the segments
+  // crossing the border are the vertices of the mwms on both sides.
+  vector<bool> inside(graph.GetVerticesCount());
+  for (uint32_t vertex = 0; vertex < graph.GetVerticesCount(); ++vertex)
+    inside[vertex] = border->Contains(graph.GetPoint(vertex));
+
+  vector<uint32_t> borderVertices;
+  unordered_map<uint32_t, uint32_t> vertexToBorder;
+  for (uint32_t vertex = 0; vertex < graph.GetVerticesCount(); ++vertex)
+  {
+    for (auto const & edge : graph.GetEdges(vertex))
+    {
+      if (inside[edge.m_target] == inside[vertex])
+        continue;
+      for (uint32_t const v : {vertex, edge.m_target})
+      {
+        if (vertexToBorder.emplace(v, static_cast<uint32_t>(borderVertices.size())).second)
+          borderVertices.push_back(v);
+      }
+    }
+  }
+
+  RoadGraphCrossContext::TWeights weights(borderVertices.size());
+  atomic<size_t> weightsCount(0);
+  {
+    size_t const threadsCount = max(thread::hardware_concurrency(), 1u);
+    threads::WorkStealingPool pool(threadsCount, kPendingChunksPerThread * threadsCount);
+    LOG(LINFO, ("Computing weights of", borderVertices.size(), "border vertices on",
+                pool.GetThreadsCount(), "threads"));
+    for (size_t begin = 0; begin < borderVertices.size(); begin += kBordersChunkSize)
+    {
+      size_t const end = min(begin + kBordersChunkSize, borderVertices.size());
+      pool.Push([&, begin, end]()
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          ForEachReachable(graph, borderVertices[i], [&](uint32_t vertex, double seconds)
+          {
+            auto const it = vertexToBorder.find(vertex);
+            if (it != vertexToBorder.end() && it->second != i)
+              weights[i].emplace_back(it->second, seconds);
+          });
+          weightsCount += weights[i].size();
+        }
+      });
+    }
+  }
+
+  vector<m2::PointD> points;
+  points.reserve(borderVertices.size());
+  for (uint32_t const vertex : borderVertices)
+    points.push_back(graph.GetPoint(vertex));
+
+  FilesContainerW container(mwmFile, FileWriter::OP_WRITE_EXISTING);
+  FileWriter writer = container.GetWriter(PEDESTRIAN_CROSS_CONTEXT_FILE_TAG);
+  RoadGraphCrossContext::Serialize(points, weights, coordBits, writer);
+  LOG(LINFO, ("Border vertices:", points.size(), "weights:", weightsCount.load(),
+              "section size, bytes:", writer.Size(), "elapsed, seconds:", timer.ElapsedSeconds()));
+}
+}  // namespace routing
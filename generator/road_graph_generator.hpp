@@ -0,0 +1,21 @@
+#pragma once
+
+#include "std/string.hpp"
+
+namespace routing
+{
+/// Builds road graph section for pedestrian routing (see routing/road_graph_section.hpp) and
+/// writes it into the mwm.
+/// @param[in]  baseDir   Full path to .mwm files directory.
+/// @param[in]  countryName   Country name same with .mwm file name.
+void BuildPedestrianRoadGraph(string const & baseDir, string const & countryName);
+
+/// Builds road graph section for bicycle routing, it's the same section as the pedestrian one
+/// made of the roads and the speeds of BicycleModel.
+void BuildBicycleRoadGraph(string const & baseDir, string const & countryName);
+
+/// Builds the border vertices of the pedestrian road graph and the times of the routes
+/// between them (see routing/road_graph_cross_context.hpp) and writes them into the mwm.
+/// Borders of the country are loaded from baseDir/borders.
+void BuildPedestrianCrossContext(string const & baseDir, string const & countryName);
+}  // namespace routing
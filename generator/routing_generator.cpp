@@ -4,9 +4,14 @@
 #include "generator/borders_loader.hpp"
 #include "generator/gen_mwm_info.hpp"
 
+#include "routing/cross_mwm_overlay.hpp"
 #include "routing/osrm2feature_map.hpp"
 #include "routing/osrm_data_facade.hpp"
 #include "routing/osrm_engine.hpp"
+#include "routing/road_segments_index.hpp"
+#include "routing/routing_mapping.hpp"
+#include "routing/turns_generator.hpp"
+#include "routing/turns_info.hpp"
 #include "routing/cross_routing_context.hpp"
 
 #include "indexer/classificator_loader.hpp"
@@ -19,12 +24,23 @@
 #include "geometry/distance_on_sphere.hpp"
 
 #include "coding/file_container.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/writer.hpp"
 #include "coding/read_write_utils.hpp"
 #include "coding/internal/file_data.hpp"
 
+#include "platform/mwm_version.hpp"
+#include "platform/platform.hpp"
+
 #include "base/logging.hpp"
+#include "base/timer.hpp"
+#include "base/work_stealing_pool.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
 #include "std/fstream.hpp"
+#include "std/map.hpp"
+#include "std/thread.hpp"
 
 #include "3party/osrm/osrm-backend/data_structures/edge_based_node_data.hpp"
 #include "3party/osrm/osrm-backend/data_structures/query_edge.hpp"
@@ -40,6 +56,234 @@ using RawRouteResult = InternalRouteResult;
 
 static double const EQUAL_POINT_RADIUS_M = 2.0;
 
+namespace
+{
+// Nodes are processed by chunks of this size on the generator threads.
+size_t constexpr kNodesChunkSize = 1 << 12;
+size_t constexpr kPendingChunksPerThread = 2;
+
+/// Counters of the matching of the OSRM segments to the features.
+struct MatchingStats
+{
+  void Add(MatchingStats const & rhs)
+  {
+    m_all += rhs.m_all;
+    m_found += rhs.m_found;
+    m_multiple += rhs.m_multiple;
+    m_equal += rhs.m_equal;
+    m_stored += rhs.m_stored;
+  }
+
+  uint32_t m_all = 0;
+  uint32_t m_found = 0;
+  uint32_t m_multiple = 0;
+  uint32_t m_equal = 0;
+  uint32_t m_stored = 0;
+};
+
+/// Segment of the road segments index which is emitted by a node.
+struct EmittedSegment
+{
+  uint64_t m_key;
+  RoadSegmentsIndex::Segment m_segment;
+  WritedNodeID m_nodeId;
+  bool m_forward;
+};
+
+/// Node which crosses the mwm border, the outgoing nodes have the names of the neighbour mwms.
+struct CrossNode
+{
+  WritedNodeID m_nodeId;
+  m2::PointD m_point;
+  string m_mwmName;
+};
+
+/// Results of the matching of a chunk of nodes. They are applied by the chunks in order of
+/// the nodes, so the routing file doesn't depend on the threads.
+struct NodesChunk
+{
+  vector<OsrmFtSegMappingBuilder::FtSegVectorT> m_segs;
+  vector<EmittedSegment> m_emitted;
+  MatchingStats m_stats;
+};
+
+/// Calls fn(begin, end) for the chunks of [0, count) on the threads of the generator
+/// and logs the progress.
+template <typename TFn>
+void ForEachChunk(size_t count, size_t chunkSize, string const & what, TFn && fn)
+{
+  size_t const reportPeriod = max(count / 10, static_cast<size_t>(1));
+  atomic<size_t> processed(0);
+  my::Timer timer;
+  {
+    size_t const threadsCount = max(thread::hardware_concurrency(), 1u);
+    threads::WorkStealingPool pool(threadsCount, kPendingChunksPerThread * threadsCount);
+    LOG(LINFO, (what, "of", count, "nodes on", pool.GetThreadsCount(), "threads"));
+    for (size_t begin = 0; begin < count; begin += chunkSize)
+    {
+      size_t const end = min(begin + chunkSize, count);
+      pool.Push([&, begin, end]()
+      {
+        fn(begin, end);
+        size_t const prev = processed.fetch_add(end - begin);
+        if (prev / reportPeriod != (prev + end - begin) / reportPeriod)
+        {
+          LOG(LINFO, (what, "progress:", (prev + end - begin) * 100 / count, "%, elapsed seconds:",
+                      timer.ElapsedSeconds()));
+        }
+      });
+    }
+  }
+  LOG(LINFO, (what, "is done, elapsed seconds:", timer.ElapsedSeconds()));
+}
+
+void MatchNode(WritedNodeID nodeId, osrm::NodeData const & data,
+               gen::OsmID2FeatureID const & osm2ft, Index::FeaturesLoaderGuard & loader,
+               NodesChunk & chunk)
+{
+  chunk.m_segs.emplace_back();
+  OsrmFtSegMappingBuilder::FtSegVectorT & vec = chunk.m_segs.back();
+
+  for (auto const & seg : data.m_segments)
+  {
+    m2::PointD const pts[2] = { { seg.lon1, seg.lat1 }, { seg.lon2, seg.lat2 } };
+    m2::PointD const segVector = MercatorBounds::FromLatLon(seg.lat2, seg.lon2) -
+                                 MercatorBounds::FromLatLon(seg.lat1, seg.lon1);
+    ++chunk.m_stats.m_all;
+
+    // now need to determine feature id and segments in it
+    uint32_t const fID = osm2ft.GetFeatureID(seg.wayId);
+    if (fID == 0)
+    {
+      LOG(LWARNING, ("No feature id for way:", seg.wayId));
+      continue;
+    }
+
+    FeatureType ft;
+    loader.GetFeatureByIndex(fID, ft);
+
+    ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+
+    typedef pair<int, double> IndexT;
+    vector<IndexT> indices[2];
+
+    // Match input segment points on feature points.
+    for (size_t j = 0; j < ft.GetPointsCount(); ++j)
+    {
+      double const lon = MercatorBounds::XToLon(ft.GetPoint(j).x);
+      double const lat = MercatorBounds::YToLat(ft.GetPoint(j).y);
+      for (int k = 0; k < 2; ++k)
+      {
+        double const dist = ms::DistanceOnEarth(pts[k].y, pts[k].x, lat, lon);
+        if (dist <= EQUAL_POINT_RADIUS_M)
+          indices[k].push_back(make_pair(static_cast<int>(j), dist));
+      }
+    }
+
+    if (!indices[0].empty() && !indices[1].empty())
+    {
+      for (int k = 0; k < 2; ++k)
+      {
+        sort(indices[k].begin(), indices[k].end(), [] (IndexT const & r1, IndexT const & r2)
+        {
+          return (r1.second < r2.second);
+        });
+      }
+
+      // Show warnings for multiple or equal choices.
+      if (indices[0].size() != 1 && indices[1].size() != 1)
+      {
+        ++chunk.m_stats.m_multiple;
+        //LOG(LWARNING, ("Multiple index choices for way:", seg.wayId, indices[0], indices[1]));
+      }
+
+      {
+        size_t const count = min(indices[0].size(), indices[1].size());
+        size_t i = 0;
+        for (; i < count; ++i)
+          if (indices[0][i].first != indices[1][i].first)
+            break;
+
+        if (i == count)
+        {
+          ++chunk.m_stats.m_equal;
+          LOG(LWARNING, ("Equal choices for way:", seg.wayId, indices[0], indices[1]));
+        }
+      }
+
+      // Find best matching for multiple choices.
+      int ind1 = -1, ind2 = -1, dist = numeric_limits<int>::max();
+      for (auto i1 : indices[0])
+        for (auto i2 : indices[1])
+        {
+          // We use delta of the indexes to avoid P formed curves cases.
+          int const d = abs(i1.first - i2.first);
+          if (d < dist && i1.first != i2.first)
+          {
+            // Check if resulting vector has same direction with the edge.
+            m2::PointD candidateVector = ft.GetPoint(i2.first) - ft.GetPoint(i1.first);
+            if (m2::DotProduct(candidateVector, segVector) < 0)
+              continue;
+            ind1 = i1.first;
+            ind2 = i2.first;
+            dist = d;
+          }
+        }
+
+      if (ind1 != -1 && ind2 != -1)
+      {
+        ++chunk.m_stats.m_found;
+
+        // Emit segment.
+        OsrmMappingTypes::FtSeg ftSeg(fID, ind1, ind2);
+        for (int i = min(ind1, ind2); i < max(ind1, ind2); ++i)
+        {
+          uint64_t const key = (static_cast<uint64_t>(fID) << 32) | static_cast<uint32_t>(i);
+          chunk.m_emitted.push_back(
+              {key, RoadSegmentsIndex::Segment(fID, i, ft.GetPoint(i), ft.GetPoint(i + 1)), nodeId,
+               ind1 < ind2});
+        }
+        if (vec.empty() || !vec.back().Merge(ftSeg))
+        {
+          vec.push_back(ftSeg);
+          ++chunk.m_stats.m_stored;
+        }
+
+        continue;
+      }
+    }
+
+    // Matching error. Print warning message.
+    LOG(LWARNING, ("!!!!! Match not found:", seg.wayId));
+    LOG(LWARNING, ("(Lat, Lon):", pts[0].y, pts[0].x, "; (Lat, Lon):", pts[1].y, pts[1].x));
+
+    int ind1 = -1;
+    int ind2 = -1;
+    double dist1 = numeric_limits<double>::max();
+    double dist2 = numeric_limits<double>::max();
+    for (size_t j = 0; j < ft.GetPointsCount(); ++j)
+    {
+      double lon = MercatorBounds::XToLon(ft.GetPoint(j).x);
+      double lat = MercatorBounds::YToLat(ft.GetPoint(j).y);
+      double const d1 = ms::DistanceOnEarth(pts[0].y, pts[0].x, lat, lon);
+      double const d2 = ms::DistanceOnEarth(pts[1].y, pts[1].x, lat, lon);
+      if (d1 < dist1)
+      {
+        ind1 = j;
+        dist1 = d1;
+      }
+      if (d2 < dist2)
+      {
+        ind2 = j;
+        dist2 = d2;
+      }
+    }
+
+    LOG(LWARNING, ("ind1 =", ind1, "ind2 =", ind2, "dist1 =", dist1, "dist2 =", dist2));
+  }
+}
+}  // namespace
+
 bool LoadIndexes(string const & mwmFile, string const & osrmFile, osrm::NodeDataVectorT & nodeData, gen::OsmID2FeatureID & osm2ft)
 {
   if (!osrm::LoadNodeDataFromFile(osrmFile + ".nodeData", nodeData))
@@ -91,66 +335,84 @@ void FindCrossNodes(osrm::NodeDataVectorT const & nodeData, gen::OsmID2FeatureID
       });
   });
 
-  for (WritedNodeID nodeId = 0; nodeId < nodeData.size(); ++nodeId)
+  // Cross nodes of the chunks are added to the context in order of the nodes.
+  vector<vector<CrossNode>> chunks((nodeData.size() + kNodesChunkSize - 1) / kNodesChunkSize);
+  ForEachChunk(nodeData.size(), kNodesChunkSize, "Finding cross nodes",
+               [&](size_t begin, size_t end)
   {
-    auto const & data = nodeData[nodeId];
-
-    // Check for outgoing candidates.
-    if (!data.m_segments.empty())
+    vector<CrossNode> & nodes = chunks[begin / kNodesChunkSize];
+    for (WritedNodeID nodeId = begin; nodeId < end; ++nodeId)
     {
-      auto const & startSeg = data.m_segments.front();
-      auto const & endSeg = data.m_segments.back();
-      // Check if we have geometry for our candidate.
-      if (osm2ft.GetFeatureID(startSeg.wayId) || osm2ft.GetFeatureID(endSeg.wayId))
+      auto const & data = nodeData[nodeId];
+
+      // Check for outgoing candidates.
+      if (!data.m_segments.empty())
       {
-        // Check mwm borders crossing.
-        for (m2::RegionD const & border: regionBorders)
+        auto const & startSeg = data.m_segments.front();
+        auto const & endSeg = data.m_segments.back();
+        // Check if we have geometry for our candidate.
+        if (osm2ft.GetFeatureID(startSeg.wayId) || osm2ft.GetFeatureID(endSeg.wayId))
         {
-          if (!CheckBBoxCrossingBorder(border, data))
-            continue;
-
-          m2::PointD intersection = m2::PointD::Zero();
-          for (auto const & segment : data.m_segments)
+          // Check mwm borders crossing.
+          for (m2::RegionD const & border: regionBorders)
           {
-            bool const outStart =
-                border.Contains(MercatorBounds::FromLatLon(segment.lat1, segment.lon1));
-            bool const outEnd =
-                border.Contains(MercatorBounds::FromLatLon(segment.lat2, segment.lon2));
-            if (outStart == outEnd)
+            if (!CheckBBoxCrossingBorder(border, data))
               continue;
 
-            border.FindIntersection(MercatorBounds::FromLatLon(segment.lat1, segment.lon1),
-                                    MercatorBounds::FromLatLon(segment.lat2, segment.lon2),
-                                    intersection);
-
-            // for old format compatibility
-            intersection = m2::PointD(MercatorBounds::XToLon(intersection.x), MercatorBounds::YToLat(intersection.y));
-            if (!outStart && outEnd)
-              crossContext.AddIngoingNode(nodeId, intersection);
-            else if (outStart && !outEnd)
+            m2::PointD intersection = m2::PointD::Zero();
+            for (auto const & segment : data.m_segments)
             {
-              string mwmName;
-              m2::PointD const & mercatorPoint = MercatorBounds::FromLatLon(endSeg.lat2, endSeg.lon2);
-              m_countries.ForEachInRect(m2::RectD(mercatorPoint, mercatorPoint), [&](borders::CountryPolygons const & c)
+              bool const outStart =
+                  border.Contains(MercatorBounds::FromLatLon(segment.lat1, segment.lon1));
+              bool const outEnd =
+                  border.Contains(MercatorBounds::FromLatLon(segment.lat2, segment.lon2));
+              if (outStart == outEnd)
+                continue;
+
+              border.FindIntersection(MercatorBounds::FromLatLon(segment.lat1, segment.lon1),
+                                      MercatorBounds::FromLatLon(segment.lat2, segment.lon2),
+                                      intersection);
+
+              // for old format compatibility
+              intersection = m2::PointD(MercatorBounds::XToLon(intersection.x), MercatorBounds::YToLat(intersection.y));
+              if (!outStart && outEnd)
+                nodes.push_back({nodeId, intersection, string()});
+              else if (outStart && !outEnd)
               {
-                if (c.m_name == countryName)
-                  return;
-                c.m_regions.ForEachInRect(m2::RectD(mercatorPoint, mercatorPoint), [&](m2::RegionD const & region)
+                string mwmName;
+                m2::PointD const & mercatorPoint = MercatorBounds::FromLatLon(endSeg.lat2, endSeg.lon2);
+                m_countries.ForEachInRect(m2::RectD(mercatorPoint, mercatorPoint), [&](borders::CountryPolygons const & c)
                 {
-                  // Sometimes Contains make errors for cases near the border.
-                  if (region.Contains(mercatorPoint) || region.AtBorder(mercatorPoint, 0.01 /*Near border accuracy. In mercator.*/))
-                    mwmName = c.m_name;
+                  if (c.m_name == countryName)
+                    return;
+                  c.m_regions.ForEachInRect(m2::RectD(mercatorPoint, mercatorPoint), [&](m2::RegionD const & region)
+                  {
+                    // Sometimes Contains make errors for cases near the border.
+                    if (region.Contains(mercatorPoint) || region.AtBorder(mercatorPoint, 0.01 /*Near border accuracy. In mercator.*/))
+                      mwmName = c.m_name;
+                  });
                 });
-              });
-              if (!mwmName.empty())
-                crossContext.AddOutgoingNode(nodeId, mwmName, intersection);
-              else
-                LOG(LINFO, ("Unknowing outgoing edge", endSeg.lat2, endSeg.lon2, startSeg.lat1, startSeg.lon1));
+                if (!mwmName.empty())
+                  nodes.push_back({nodeId, intersection, mwmName});
+                else
+                  LOG(LINFO, ("Unknowing outgoing edge", endSeg.lat2, endSeg.lon2, startSeg.lat1, startSeg.lon1));
+              }
             }
           }
         }
       }
     }
+  });
+
+  for (auto const & nodes : chunks)
+  {
+    for (CrossNode const & node : nodes)
+    {
+      if (node.m_mwmName.empty())
+        crossContext.AddIngoingNode(node.m_nodeId, node.m_point);
+      else
+        crossContext.AddOutgoingNode(node.m_nodeId, node.m_mwmName, node.m_point);
+    }
   }
 }
 
@@ -203,6 +465,7 @@ void WriteCrossSection(routing::CrossRoutingContextWriter const & crossContext,
 void BuildCrossRoutingIndex(string const & baseDir, string const & countryName, string const & osrmFile)
 {
   LOG(LINFO, ("Cross mwm routing section builder"));
+  my::Timer timer;
   string const mwmFile = baseDir + countryName + DATA_FILE_EXTENSION;
   osrm::NodeDataVectorT nodeData;
   gen::OsmID2FeatureID osm2ft;
@@ -221,6 +484,89 @@ void BuildCrossRoutingIndex(string const & baseDir, string const & countryName,
 
   CalculateCrossAdjacency(mwmRoutingPath, crossContext);
   WriteCrossSection(crossContext, mwmRoutingPath);
+  LOG(LINFO, ("Cross mwm routing section is built, elapsed seconds:", timer.ElapsedSeconds()));
+}
+
+void BuildCrossMwmOverlay(string const & baseDir)
+{
+  LOG(LINFO, ("Cross mwm overlay builder"));
+  string const extension = string(DATA_FILE_EXTENSION) + ROUTING_FILE_EXTENSION;
+  Platform::FilesList files;
+  Platform::GetFilesByExt(baseDir, extension, files);
+  sort(files.begin(), files.end());
+
+  routing::CrossMwmOverlay overlay;
+  for (string const & file : files)
+  {
+    FilesContainerR routingCont(baseDir + file);
+    if (!routingCont.IsExist(ROUTING_CROSS_CONTEXT_TAG))
+      continue;
+
+    version::MwmVersion version;
+    if (!version::ReadVersion(routingCont, version))
+    {
+      LOG(LWARNING, ("Can't read version of", file));
+      continue;
+    }
+
+    ModelReaderPtr reader = routingCont.GetReader(ROUTING_CROSS_CONTEXT_TAG);
+    routing::CrossRoutingContextReader crossContext;
+    crossContext.Load(*reader.GetPtr());
+    overlay.AddMwm(file.substr(0, file.size() - extension.size()), version.timestamp, crossContext);
+  }
+  overlay.Link();
+
+  FileWriter writer(baseDir + CROSS_MWM_OVERLAY_FILE);
+  overlay.Serialize(writer);
+  LOG(LINFO, ("Cross mwm overlay is built, bytes written:", writer.Pos()));
+}
+
+void BuildTurnsInfo(string const & baseDir, string const & countryName)
+{
+  LOG(LINFO, ("Turns info section builder"));
+  classificator::Load();
+
+  LocalCountryFile localFile(baseDir, CountryFile(countryName), 0 /* version */);
+  localFile.SyncWithDisk();
+  string const mwmRoutingPath = localFile.GetPath(MapOptions::CarRouting);
+
+  vector<char> section;
+  {
+    Index index;
+    auto const p = index.Register(localFile);
+    if (p.second != MwmSet::RegResult::Success)
+    {
+      LOG(LCRITICAL, ("MWM file not found"));
+      return;
+    }
+
+    RoutingMapping mapping(countryName, &index);
+    if (!mapping.IsValid())
+    {
+      LOG(LERROR, ("Routing file", mwmRoutingPath, "can't be used:", mapping.GetError()));
+      return;
+    }
+    // The mapping is released before the section is written to the routing file.
+    mapping.Map();
+    mapping.LoadFacade();
+
+    vector<turns::NodeTurnInfo> infos(mapping.m_dataFacade.GetNumberOfNodes());
+    ForEachChunk(infos.size(), kNodesChunkSize, "Calculating turns info",
+                 [&](size_t begin, size_t end)
+    {
+      for (size_t node = begin; node < end; ++node)
+        turns::CalculateNodeTurnInfo(index, mapping, static_cast<NodeID>(node), infos[node]);
+    });
+
+    MemWriter<vector<char>> w(section);
+    turns::TurnsInfoSection::Serialize(infos, w);
+    mapping.FreeFacade();
+    mapping.Unmap();
+  }
+
+  FilesContainerW routingCont(mwmRoutingPath, FileWriter::OP_WRITE_EXISTING);
+  routingCont.Write(section, ROUTING_TURNS_INFO_FILE_TAG);
+  LOG(LINFO, ("Turns info section is built, bytes written:", section.size()));
 }
 
 void BuildRoutingIndex(string const & baseDir, string const & countryName, string const & osrmFile)
@@ -246,155 +592,50 @@ void BuildRoutingIndex(string const & baseDir, string const & countryName, strin
   if (!LoadIndexes(localFile.GetPath(MapOptions::Map), osrmFile, nodeData, osm2ft))
     return;
 
-  OsrmFtSegMappingBuilder mapping;
-
-  uint32_t found = 0, all = 0, multiple = 0, equal = 0, moreThan1Seg = 0, stored = 0;
+  my::Timer timer;
 
-  for (WritedNodeID nodeId = 0; nodeId < nodeData.size(); ++nodeId)
+  vector<NodesChunk> chunks((nodeData.size() + kNodesChunkSize - 1) / kNodesChunkSize);
+  ForEachChunk(nodeData.size(), kNodesChunkSize, "Matching to features",
+               [&](size_t begin, size_t end)
   {
-    auto const & data = nodeData[nodeId];
+    Index::FeaturesLoaderGuard loader(index, p.first);
+    NodesChunk & chunk = chunks[begin / kNodesChunkSize];
+    chunk.m_segs.reserve(end - begin);
+    for (size_t nodeId = begin; nodeId < end; ++nodeId)
+      MatchNode(static_cast<WritedNodeID>(nodeId), nodeData[nodeId], osm2ft, loader, chunk);
+  });
 
-    OsrmFtSegMappingBuilder::FtSegVectorT vec;
+  OsrmFtSegMappingBuilder mapping;
+  // Segments of the road segments index by keys of their features and first points.
+  map<uint64_t, RoadSegmentsIndex::Segment> indexSegments;
+  MatchingStats stats;
+  uint32_t moreThan1Seg = 0;
 
-    for (auto const & seg : data.m_segments)
+  WritedNodeID nodeId = 0;
+  for (NodesChunk & chunk : chunks)
+  {
+    for (auto const & vec : chunk.m_segs)
     {
-      m2::PointD const pts[2] = { { seg.lon1, seg.lat1 }, { seg.lon2, seg.lat2 } };
-      m2::PointD const segVector = MercatorBounds::FromLatLon(seg.lat2, seg.lon2) -
-                                   MercatorBounds::FromLatLon(seg.lat1, seg.lon1);
-      ++all;
-
-      // now need to determine feature id and segments in it
-      uint32_t const fID = osm2ft.GetFeatureID(seg.wayId);
-      if (fID == 0)
-      {
-        LOG(LWARNING, ("No feature id for way:", seg.wayId));
-        continue;
-      }
-
-      FeatureType ft;
-      Index::FeaturesLoaderGuard loader(index, p.first);
-      loader.GetFeatureByIndex(fID, ft);
-
-      ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
-
-      typedef pair<int, double> IndexT;
-      vector<IndexT> indices[2];
-
-      // Match input segment points on feature points.
-      for (int j = 0; j < ft.GetPointsCount(); ++j)
-      {
-        double const lon = MercatorBounds::XToLon(ft.GetPoint(j).x);
-        double const lat = MercatorBounds::YToLat(ft.GetPoint(j).y);
-        for (int k = 0; k < 2; ++k)
-        {
-          double const dist = ms::DistanceOnEarth(pts[k].y, pts[k].x, lat, lon);
-          if (dist <= EQUAL_POINT_RADIUS_M)
-            indices[k].push_back(make_pair(j, dist));
-        }
-      }
-
-      if (!indices[0].empty() && !indices[1].empty())
-      {
-        for (int k = 0; k < 2; ++k)
-        {
-          sort(indices[k].begin(), indices[k].end(), [] (IndexT const & r1, IndexT const & r2)
-          {
-            return (r1.second < r2.second);
-          });
-        }
-
-        // Show warnings for multiple or equal choices.
-        if (indices[0].size() != 1 && indices[1].size() != 1)
-        {
-          ++multiple;
-          //LOG(LWARNING, ("Multiple index choices for way:", seg.wayId, indices[0], indices[1]));
-        }
-
-        {
-          size_t const count = min(indices[0].size(), indices[1].size());
-          size_t i = 0;
-          for (; i < count; ++i)
-            if (indices[0][i].first != indices[1][i].first)
-              break;
-
-          if (i == count)
-          {
-            ++equal;
-            LOG(LWARNING, ("Equal choices for way:", seg.wayId, indices[0], indices[1]));
-          }
-        }
-
-        // Find best matching for multiple choices.
-        int ind1 = -1, ind2 = -1, dist = numeric_limits<int>::max();
-        for (auto i1 : indices[0])
-          for (auto i2 : indices[1])
-          {
-            // We use delta of the indexes to avoid P formed curves cases.
-            int const d = abs(i1.first - i2.first);
-            if (d < dist && i1.first != i2.first)
-            {
-              // Check if resulting vector has same direction with the edge.
-              m2::PointD candidateVector = ft.GetPoint(i2.first) - ft.GetPoint(i1.first);
-              if (m2::DotProduct(candidateVector, segVector) < 0)
-                continue;
-              ind1 = i1.first;
-              ind2 = i2.first;
-              dist = d;
-            }
-          }
-
-        if (ind1 != -1 && ind2 != -1)
-        {
-          ++found;
-
-          // Emit segment.
-          OsrmMappingTypes::FtSeg ftSeg(fID, ind1, ind2);
-          if (vec.empty() || !vec.back().Merge(ftSeg))
-          {
-            vec.push_back(ftSeg);
-            ++stored;
-          }
-
-          continue;
-        }
-      }
-
-      // Matching error. Print warning message.
-      LOG(LWARNING, ("!!!!! Match not found:", seg.wayId));
-      LOG(LWARNING, ("(Lat, Lon):", pts[0].y, pts[0].x, "; (Lat, Lon):", pts[1].y, pts[1].x));
-
-      int ind1 = -1;
-      int ind2 = -1;
-      double dist1 = numeric_limits<double>::max();
-      double dist2 = numeric_limits<double>::max();
-      for (int j = 0; j < ft.GetPointsCount(); ++j)
-      {
-        double lon = MercatorBounds::XToLon(ft.GetPoint(j).x);
-        double lat = MercatorBounds::YToLat(ft.GetPoint(j).y);
-        double const d1 = ms::DistanceOnEarth(pts[0].y, pts[0].x, lat, lon);
-        double const d2 = ms::DistanceOnEarth(pts[1].y, pts[1].x, lat, lon);
-        if (d1 < dist1)
-        {
-          ind1 = j;
-          dist1 = d1;
-        }
-        if (d2 < dist2)
-        {
-          ind2 = j;
-          dist2 = d2;
-        }
-      }
-
-      LOG(LWARNING, ("ind1 =", ind1, "ind2 =", ind2, "dist1 =", dist1, "dist2 =", dist2));
+      if (vec.size() > 1)
+        ++moreThan1Seg;
+      mapping.Append(nodeId++, vec);
     }
-
-    if (vec.size() > 1)
-      ++moreThan1Seg;
-    mapping.Append(nodeId, vec);
+    for (EmittedSegment const & emitted : chunk.m_emitted)
+    {
+      auto const res = indexSegments.emplace(emitted.m_key, emitted.m_segment);
+      if (emitted.m_forward)
+        res.first->second.m_forwardNodeId = emitted.m_nodeId;
+      else
+        res.first->second.m_reverseNodeId = emitted.m_nodeId;
+    }
+    stats.Add(chunk.m_stats);
+    chunk = NodesChunk();
   }
+  CHECK_EQUAL(nodeId, nodeData.size(), ());
 
-  LOG(LINFO, ("All:", all, "Found:", found, "Not found:", all - found, "More that one segs in node:", moreThan1Seg,
-              "Multiple:", multiple, "Equal:", equal));
+  LOG(LINFO, ("All:", stats.m_all, "Found:", stats.m_found, "Not found:", stats.m_all - stats.m_found,
+              "More that one segs in node:", moreThan1Seg, "Multiple:", stats.m_multiple,
+              "Equal:", stats.m_equal));
 
   LOG(LINFO, ("Collect all data into one file..."));
   string const fPath = localFile.GetPath(MapOptions::CarRouting);
@@ -411,7 +652,32 @@ void BuildRoutingIndex(string const & baseDir, string const & countryName, strin
     w.WritePaddingByEnd(4);
   }
 
+  // The road segments index is packed while the Elias-Fano list of the mapping is packed
+  // and written, only the writes to the container are sequential.
+  vector<char> segmentsIndex;
+  size_t const segmentsCount = indexSegments.size();
+  thread segmentsIndexThread([&]()
+  {
+    vector<RoadSegmentsIndex::Segment> segments;
+    segments.reserve(indexSegments.size());
+    for (auto const & segment : indexSegments)
+      segments.push_back(segment.second);
+    map<uint64_t, RoadSegmentsIndex::Segment>().swap(indexSegments);
+
+    string const mwmFile = localFile.GetPath(MapOptions::Map);
+    uint32_t const coordBits =
+        feature::DataHeader((FilesContainerR(mwmFile))).GetDefCodingParams().GetCoordBits();
+    MemWriter<vector<char>> w(segmentsIndex);
+    RoadSegmentsIndex::Serialize(segments, coordBits, w);
+  });
+
+  my::Timer packTimer;
   mapping.Save(routingCont);
+  LOG(LINFO, ("Features mapping is packed, elapsed seconds:", packTimer.ElapsedSeconds()));
+  segmentsIndexThread.join();
+  routingCont.Write(segmentsIndex, ROUTING_SEGMENTS_INDEX_FILE_TAG);
+  LOG(LINFO, ("Road segments index:", segmentsCount, "segments,", segmentsIndex.size(), "bytes,",
+              "elapsed seconds:", packTimer.ElapsedSeconds()));
 
   auto appendFile = [&] (string const & tag)
   {
@@ -429,6 +695,7 @@ void BuildRoutingIndex(string const & baseDir, string const & countryName, strin
 
   uint64_t sz;
   VERIFY(my::GetFileSize(fPath, sz), ());
-  LOG(LINFO, ("Nodes stored:", stored, "Routing index file size:", sz));
+  LOG(LINFO, ("Nodes stored:", stats.m_stored, "Routing index file size:", sz, "elapsed seconds:",
+              timer.ElapsedSeconds()));
 }
 }
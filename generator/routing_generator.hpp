@@ -15,4 +15,14 @@ void BuildRoutingIndex(string const & baseDir, string const & countryName, strin
 /// @param[in]  countryName   Country name same with .mwm and .border file name.
 /// @param[in]  osrmFile  Full path to .osrm file (all prepared osrm files should be there).
 void BuildCrossRoutingIndex(string const & baseDir, string const & countryName, string const & osrmFile);
+
+/// Builds the section of the junction descriptors of all the OSRM nodes, which the turns of
+/// the car routes are made of. The routing file must be built.
+/// @param[in]  baseDir   Full path to .mwm files directory.
+/// @param[in]  countryName   Country name same with .mwm and .routing file name.
+void BuildTurnsInfo(string const & baseDir, string const & countryName);
+
+/// Builds the overlay graph of cross mwm routing from cross sections of all the routing files.
+/// @param[in]  baseDir      Full path to .mwm.routing files directory, the overlay is written there.
+void BuildCrossMwmOverlay(string const & baseDir);
 }
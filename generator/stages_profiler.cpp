@@ -0,0 +1,215 @@
+#include "generator/stages_profiler.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/stats.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstdlib.hpp"
+
+#include "3party/jansson/myjansson.hpp"
+
+namespace stats
+{
+StagesProfiler::ScopedStage::ScopedStage(StagesProfiler & profiler, string const & name,
+                                         string const & file)
+  : m_profiler(profiler), m_name(name), m_file(file)
+{
+}
+
+StagesProfiler::ScopedStage::~ScopedStage()
+{
+  Stage stage;
+  stage.m_name = m_name;
+  stage.m_file = m_file;
+  stage.m_seconds = m_timer.ElapsedSeconds();
+  stage.m_elementsCount = m_elementsCount;
+  stage.m_peakRssBytes = my::GetPeakRssBytes();
+  m_profiler.AddStage(stage);
+}
+
+void StagesProfiler::AddStage(Stage const & stage)
+{
+  LOG(LINFO, ("Stage", stage.m_name, stage.m_file, "is done in", stage.m_seconds,
+              "seconds, elements:", stage.m_elementsCount, "peak RSS:", stage.m_peakRssBytes));
+  m_stages.push_back(stage);
+}
+
+void StagesProfiler::AddFileSections(string const & name, string const & path)
+{
+  try
+  {
+    FilesContainerR cont(path);
+    File file;
+    file.m_name = name;
+    cont.ForEachTag([&cont, &file](FilesContainerR::Tag const & tag)
+    {
+      file.m_sections.push_back({tag, cont.GetReader(tag).Size()});
+    });
+    m_files.push_back(file);
+  }
+  catch (Reader::Exception const & ex)
+  {
+    LOG(LWARNING, ("Error reading file:", path, ex.Msg()));
+  }
+}
+
+string StagesProfiler::ToJSON() const
+{
+  my::JsonHandle root;
+  root.AttachNew(json_object());
+  json_object_set_new(root.get(), "total_seconds", json_real(m_timer.ElapsedSeconds()));
+  json_object_set_new(root.get(), "peak_rss_bytes", json_integer(my::GetPeakRssBytes()));
+
+  my::JsonHandle stages;
+  stages.AttachNew(json_array());
+  for (Stage const & stage : m_stages)
+  {
+    my::JsonHandle jStage;
+    jStage.AttachNew(json_object());
+    json_object_set_new(jStage.get(), "name", json_string(stage.m_name.c_str()));
+    if (!stage.m_file.empty())
+      json_object_set_new(jStage.get(), "file", json_string(stage.m_file.c_str()));
+    json_object_set_new(jStage.get(), "seconds", json_real(stage.m_seconds));
+    if (stage.m_elementsCount != 0)
+    {
+      json_object_set_new(jStage.get(), "elements", json_integer(stage.m_elementsCount));
+      if (stage.m_seconds > 0.0)
+      {
+        json_object_set_new(jStage.get(), "elements_per_second",
+                            json_real(stage.m_elementsCount / stage.m_seconds));
+      }
+    }
+    json_object_set_new(jStage.get(), "peak_rss_bytes", json_integer(stage.m_peakRssBytes));
+    json_array_append(stages.get(), jStage.get());
+  }
+  json_object_set(root.get(), "stages", stages.get());
+
+  my::JsonHandle files;
+  files.AttachNew(json_array());
+  for (File const & file : m_files)
+  {
+    my::JsonHandle jFile;
+    jFile.AttachNew(json_object());
+    json_object_set_new(jFile.get(), "name", json_string(file.m_name.c_str()));
+
+    my::JsonHandle sections;
+    sections.AttachNew(json_object());
+    uint64_t totalBytes = 0;
+    for (Section const & section : file.m_sections)
+    {
+      json_object_set_new(sections.get(), section.m_tag.c_str(), json_integer(section.m_bytes));
+      totalBytes += section.m_bytes;
+    }
+    json_object_set_new(jFile.get(), "bytes", json_integer(totalBytes));
+    json_object_set(jFile.get(), "sections", sections.get());
+    json_array_append(files.get(), jFile.get());
+  }
+  json_object_set(root.get(), "files", files.get());
+
+  char * res = json_dumps(root.get(), JSON_PRESERVE_ORDER | JSON_INDENT(2));
+  string const json = res;
+  free(res);
+  return json;
+}
+
+bool StagesProfiler::WriteJSON(string const & path) const
+{
+  try
+  {
+    string const json = ToJSON();
+    FileWriter writer(path);
+    writer.Write(json.data(), json.size());
+  }
+  catch (Writer::Exception const & ex)
+  {
+    LOG(LERROR, ("Can't write the stages report to", path, ex.Msg()));
+    return false;
+  }
+  LOG(LINFO, ("Stages report is written to", path));
+  return true;
+}
+
+// static
+bool StagesProfiler::MergeJSON(vector<string> const & reports, string & merged)
+{
+  double totalSeconds = 0.0;
+  json_int_t peakRssBytes = 0;
+  my::JsonHandle stages;
+  stages.AttachNew(json_array());
+  my::JsonHandle files;
+  files.AttachNew(json_array());
+  my::JsonHandle summary;
+  summary.AttachNew(json_object());
+
+  for (string const & report : reports)
+  {
+    try
+    {
+      my::Json root(report.c_str());
+      totalSeconds += json_number_value(json_object_get(root.get(), "total_seconds"));
+      peakRssBytes = max(peakRssBytes,
+                         json_integer_value(json_object_get(root.get(), "peak_rss_bytes")));
+      json_array_extend(files.get(), json_object_get(root.get(), "files"));
+
+      json_t * reportStages = json_object_get(root.get(), "stages");
+      json_array_extend(stages.get(), reportStages);
+      for (size_t i = 0; i < json_array_size(reportStages); ++i)
+      {
+        json_t * stage = json_array_get(reportStages, i);
+        char const * name = json_string_value(json_object_get(stage, "name"));
+        if (name == nullptr)
+          continue;
+        double const seconds = json_number_value(json_object_get(stage, "seconds"));
+        json_int_t const elements = json_integer_value(json_object_get(stage, "elements"));
+        json_int_t const rss = json_integer_value(json_object_get(stage, "peak_rss_bytes"));
+
+        json_t * total = json_object_get(summary.get(), name);
+        if (total == nullptr)
+        {
+          total = json_object();
+          json_object_set_new(total, "count", json_integer(1));
+          json_object_set_new(total, "seconds", json_real(seconds));
+          json_object_set_new(total, "max_seconds", json_real(seconds));
+          json_object_set_new(total, "elements", json_integer(elements));
+          json_object_set_new(total, "peak_rss_bytes", json_integer(rss));
+          json_object_set_new(summary.get(), name, total);
+          continue;
+        }
+        json_t * value = json_object_get(total, "count");
+        json_integer_set(value, json_integer_value(value) + 1);
+        value = json_object_get(total, "seconds");
+        json_real_set(value, json_real_value(value) + seconds);
+        value = json_object_get(total, "max_seconds");
+        json_real_set(value, max(json_real_value(value), seconds));
+        value = json_object_get(total, "elements");
+        json_integer_set(value, json_integer_value(value) + elements);
+        value = json_object_get(total, "peak_rss_bytes");
+        json_integer_set(value, max(json_integer_value(value), rss));
+      }
+    }
+    catch (my::Json::Exception const & ex)
+    {
+      LOG(LERROR, ("Can't parse the stages report:", ex.Msg()));
+      return false;
+    }
+  }
+
+  my::JsonHandle root;
+  root.AttachNew(json_object());
+  json_object_set_new(root.get(), "total_seconds", json_real(totalSeconds));
+  json_object_set_new(root.get(), "peak_rss_bytes", json_integer(peakRssBytes));
+  json_object_set_new(root.get(), "reports", json_integer(reports.size()));
+  json_object_set(root.get(), "stages", stages.get());
+  json_object_set(root.get(), "files", files.get());
+  json_object_set(root.get(), "stages_summary", summary.get());
+
+  char * res = json_dumps(root.get(), JSON_PRESERVE_ORDER | JSON_INDENT(2));
+  merged = res;
+  free(res);
+  return true;
+}
+
+}  // namespace stats
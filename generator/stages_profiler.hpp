@@ -0,0 +1,83 @@
+#pragma once
+
+#include "base/macros.hpp"
+#include "base/timer.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace stats
+{
+/// StagesProfiler collects the durations, the memory usage and the throughput of the generator
+/// stages and the sizes of the sections of the generated files, the report is written as JSON.
+class StagesProfiler
+{
+public:
+  struct Stage
+  {
+    string m_name;
+    // File the stage works on, it's empty for the stages over the whole planet.
+    string m_file;
+    double m_seconds = 0.0;
+    // Number of the processed elements, zero when it's unknown.
+    uint64_t m_elementsCount = 0;
+    // Peak resident set size of the process by the end of the stage.
+    uint64_t m_peakRssBytes = 0;
+  };
+
+  struct Section
+  {
+    string m_tag;
+    uint64_t m_bytes;
+  };
+
+  struct File
+  {
+    string m_name;
+    vector<Section> m_sections;
+  };
+
+  /// Adds the stage which lasts from the construction to the destruction of ScopedStage.
+  class ScopedStage
+  {
+  public:
+    ScopedStage(StagesProfiler & profiler, string const & name, string const & file = string());
+    ~ScopedStage();
+
+    void SetElementsCount(uint64_t count) { m_elementsCount = count; }
+
+  private:
+    StagesProfiler & m_profiler;
+    string m_name;
+    string m_file;
+    uint64_t m_elementsCount = 0;
+    my::Timer m_timer;
+
+    DISALLOW_COPY_AND_MOVE(ScopedStage);
+  };
+
+  void AddStage(Stage const & stage);
+
+  /// Adds the sizes of the sections of the files container, it's skipped if it can't be read.
+  void AddFileSections(string const & name, string const & path);
+
+  vector<Stage> const & GetStages() const { return m_stages; }
+  vector<File> const & GetFiles() const { return m_files; }
+
+  string ToJSON() const;
+  /// @return false if the report can't be written.
+  bool WriteJSON(string const & path) const;
+
+  /// Merges the reports of the shards of the build, e.g. the jobs of the build manifest:
+  /// the stages and the files are concatenated, the totals are summed, the peak RSS is the max
+  /// of them and "stages_summary" sums the stages with the same name.
+  /// @return false if a report can't be parsed.
+  static bool MergeJSON(vector<string> const & reports, string & merged);
+
+private:
+  vector<Stage> m_stages;
+  vector<File> m_files;
+  my::Timer m_timer;
+};
+}  // namespace stats
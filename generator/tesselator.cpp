@@ -17,8 +17,63 @@
 
 namespace tesselator
 {
+namespace
+{
+/// @return True when all the turns of the contour are of the same direction and the contour
+/// goes around once. The contour without the repeated points and the collinear edges passes.
+bool IsStrictlyConvex(PointsT const & contour)
+{
+  size_t const count = contour.size();
+  if (count < 3)
+    return false;
+
+  int turnSign = 0;
+  int firstDxSign = 0;
+  int dxSign = 0;
+  int dxSignChanges = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    m2::PointD const & p0 = contour[i];
+    m2::PointD const & p1 = contour[(i + 1) % count];
+    m2::PointD const & p2 = contour[(i + 2) % count];
+
+    double const cross = m2::CrossProduct(p1 - p0, p2 - p1);
+    int const sign = cross > 0.0 ? 1 : (cross < 0.0 ? -1 : 0);
+    if (sign == 0 || (turnSign != 0 && sign != turnSign))
+      return false;
+    turnSign = sign;
+
+    // Contour which goes around several times, like a star, changes the x direction more often.
+    double const dx = p1.x - p0.x;
+    int const curDxSign = dx > 0.0 ? 1 : (dx < 0.0 ? -1 : 0);
+    if (curDxSign == 0)
+      continue;
+    if (firstDxSign == 0)
+      firstDxSign = curDxSign;
+    else if (curDxSign != dxSign)
+      ++dxSignChanges;
+    dxSign = curDxSign;
+  }
+  if (firstDxSign != dxSign)
+    ++dxSignChanges;
+  return dxSignChanges <= 2;
+}
+}  // namespace
+
 int TesselateInterior(PolygonsT const & polys, TrianglesInfo & info)
 {
+  if (polys.size() == 1 && IsStrictlyConvex(polys.front()))
+  {
+    // The fan keeps the orientation of the contour, libtess2 keeps it too.
+    PointsT const & contour = polys.front();
+    info.AssignPoints(contour.begin(), contour.end());
+    int const count = static_cast<int>(contour.size()) - 2;
+    info.Reserve(count);
+    for (int i = 1; i <= count; ++i)
+      info.Add(0, i, i + 1);
+    return count;
+  }
+
   int constexpr kCoordinatesPerVertex = 2;
   int constexpr kVerticesInPolygon = 3;
 
@@ -95,7 +95,7 @@ namespace tesselator
 
       void Start() const
       {
-        m_visited.resize(m_triangles.size());
+        m_visited.assign(m_triangles.size(), false);
       }
 
       bool HasUnvisited() const
@@ -181,6 +181,8 @@ namespace tesselator
   };
 
   /// Main tesselate function.
+  /// Strictly convex polygons without holes are split into a fan of triangles,
+  /// the rest ones are tesselated by libtess2.
   /// @returns number of resulting triangles after triangulation.
   int TesselateInterior(PolygonsT const & polys, TrianglesInfo & info);
 }
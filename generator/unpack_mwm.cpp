@@ -1,25 +1,100 @@
 #include "generator/unpack_mwm.hpp"
 
+#include "coding/compressed_section.hpp"
 #include "coding/file_container.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
 #include "coding/read_write_utils.hpp"
 
 #include "base/logging.hpp"
 #include "base/stl_add.hpp"
+#include "base/task_scheduler.hpp"
+#include "base/timer.hpp"
 
 #include "std/algorithm.hpp"
+#include "std/cctype.hpp"
+#include "std/iomanip.hpp"
+#include "std/iostream.hpp"
+#include "std/random.hpp"
 #include "std/vector.hpp"
 
+namespace
+{
+/// @return Sections of the container which match the tags, see CompressSections().
+vector<string> GetSections(string const & filePath, vector<string> const & tags)
+{
+  vector<string> sections;
+  FilesContainerR container(filePath);
+  container.ForEachTag([&](string const & tag)
+  {
+    string name = tag;
+    if (find(tags.begin(), tags.end(), name) == tags.end() && !name.empty() &&
+        isdigit(name.back()))
+    {
+      name.pop_back();
+    }
+    if (find(tags.begin(), tags.end(), name) != tags.end())
+      sections.push_back(tag);
+  });
+  return sections;
+}
+
+void ReadSection(string const & filePath, string const & tag, vector<char> & buffer)
+{
+  FilesContainerR container(filePath);
+  FilesContainerR::ReaderT const reader = container.GetReader(tag);
+  buffer.resize(reader.Size());
+  reader.Read(0, buffer.data(), buffer.size());
+}
+
+/// Prints the throughput of the sequential reads by 4K and of the random reads of 256 bytes,
+/// which are about the sizes of the feature geometry and metadata.
+void PrintReadThroughput(string const & tag, int level, uint64_t rawSize, uint64_t size,
+                         Reader const & reader)
+{
+  size_t constexpr kChunkSize = 4 * 1024;
+  size_t constexpr kRandomReadSize = 256;
+  size_t constexpr kRandomReadsCount = 100000;
+
+  vector<char> chunk(kChunkSize);
+  my::Timer timer;
+  for (uint64_t pos = 0; pos < rawSize; pos += kChunkSize)
+    reader.Read(pos, chunk.data(), static_cast<size_t>(min<uint64_t>(kChunkSize, rawSize - pos)));
+  double const sequentialSeconds = timer.ElapsedSeconds();
+
+  double randomSeconds = 0;
+  if (rawSize > kRandomReadSize)
+  {
+    mt19937 rng(0);
+    uniform_int_distribution<uint64_t> distribution(0, rawSize - kRandomReadSize);
+    timer.Reset();
+    for (size_t i = 0; i < kRandomReadsCount; ++i)
+      reader.Read(distribution(rng), chunk.data(), kRandomReadSize);
+    randomSeconds = timer.ElapsedSeconds();
+  }
+
+  double const megabyte = 1024.0 * 1024.0;
+  cout << fixed << setprecision(3);
+  cout << "COMPRESSION[ section:" << tag << " level:" << level << " MB:" << size / megabyte
+       << " ratio:" << (rawSize == 0 ? 1.0 : static_cast<double>(size) / rawSize)
+       << " sequential MB per second:"
+       << (sequentialSeconds == 0 ? 0.0 : rawSize / megabyte / sequentialSeconds)
+       << " random reads per second:"
+       << (randomSeconds == 0 ? 0.0 : kRandomReadsCount / randomSeconds) << " ]" << endl;
+}
+}  // namespace
 
 void UnpackMwm(string const & filePath)
 {
   LOG(LINFO, ("Unpacking mwm sections..."));
+  my::Timer timer;
 
   FilesContainerR container(filePath);
   vector<string> tags;
   container.ForEachTag(MakeBackInsertFunctor<vector<string> >(tags));
 
-  for (size_t i = 0; i < tags.size(); ++i)
+  // Sections are independent, so they are unpacked in parallel.
+  threads::ParallelFor(0, tags.size(), [&](size_t i)
   {
     LOG(LINFO, ("Unpacking", tags[i]));
 
@@ -27,12 +102,61 @@ void UnpackMwm(string const & filePath)
     FileWriter writer(filePath + "." + tags[i]);
 
     rw::ReadAndWrite(reader, writer, 1024 * 1024);
-  }
+  }, 1 /* grainSize */);
 
-  LOG(LINFO, ("Unpacking done."));
+  LOG(LINFO, ("Unpacking done in", timer.ElapsedSeconds(), "seconds."));
 }
 
 void DeleteSection(string const & filePath, string const & tag)
 {
   FilesContainerW(filePath, FileWriter::OP_WRITE_EXISTING).DeleteSection(tag);
 }
+
+
+void CompressSections(string const & filePath, vector<string> const & tags, uint32_t blockSize)
+{
+  for (string const & tag : GetSections(filePath, tags))
+  {
+    vector<char> buffer;
+    ReadSection(filePath, tag, buffer);
+
+    FilesContainerW container(filePath, FileWriter::OP_WRITE_EXISTING);
+    container.WriteCompressed(MemReader(buffer.data(), buffer.size()), tag, blockSize,
+                              compressed_section::kDefaultLevel);
+    LOG(LINFO, ("Section", tag, "of", buffer.size(), "bytes is compressed"));
+  }
+}
+
+void BenchmarkCompression(string const & filePath, vector<string> const & tags,
+                          uint32_t blockSize)
+{
+  string const tmpFile = filePath + ".compressed.tmp";
+  for (string const & tag : GetSections(filePath, tags))
+  {
+    vector<char> buffer;
+    ReadSection(filePath, tag, buffer);
+    uint64_t const rawSize = buffer.size();
+
+    {
+      FileWriter writer(tmpFile);
+      writer.Write(buffer.data(), buffer.size());
+    }
+    // Level 0 stands for the raw section.
+    PrintReadThroughput(tag, 0, rawSize, rawSize, FileReader(tmpFile));
+
+    for (int const level : {1, compressed_section::kDefaultLevel, 9})
+    {
+      {
+        FileWriter writer(tmpFile);
+        compressed_section::Compress(MemReader(buffer.data(), buffer.size()), writer, blockSize,
+                                     level);
+      }
+      // Each level has its own cache, so the blocks of the previous one aren't read.
+      compressed_section::BlockCache cache(compressed_section::BlockCache::kDefaultMaxBytes);
+      FileReader file(tmpFile);
+      compressed_section::CompressedReader const reader(new FileReader(tmpFile), cache);
+      PrintReadThroughput(tag, level, rawSize, file.Size(), reader);
+    }
+  }
+  my::DeleteFileX(tmpFile);
+}
@@ -3,9 +3,18 @@
 #include "base/base.hpp"
 
 #include "std/string.hpp"
+#include "std/vector.hpp"
 
 
 // Unpack each section of mwm into a separate file with name filePath.sectionName
 void UnpackMwm(string const & filePath);
 
 void DeleteSection(string const & filePath, string const & tag);
+
+/// Compresses the sections by blocks, see coding/compressed_section.hpp. A tag matches the section
+/// with the same name and the sections of the scales, e.g. "geom" matches "geom0" to "geom3".
+void CompressSections(string const & filePath, vector<string> const & tags, uint32_t blockSize);
+
+/// Prints the size and the read throughput of the sections compressed by the different levels.
+void BenchmarkCompression(string const & filePath, vector<string> const & tags,
+                          uint32_t blockSize);
@@ -143,4 +143,21 @@ namespace update
 
     return true;
   }
+
+  bool GenerateCountriesBinary(string const & dataDir)
+  {
+    string jsonBuffer;
+    ReaderPtr<Reader>(GetPlatform().GetReader(COUNTRIES_FILE)).ReadAsString(jsonBuffer);
+
+    storage::CountriesContainerT countries;
+    int64_t const version = storage::LoadCountries(jsonBuffer, countries);
+    if (version < 0)
+      return false;
+
+    string const outFileName = dataDir + COUNTRIES_BINARY_FILE;
+    FileWriter f(outFileName);
+    storage::SaveCountriesBinary(version, jsonBuffer, countries, f);
+    LOG(LINFO, ("Saved binary countries to", outFileName));
+    return true;
+  }
 } // namespace update
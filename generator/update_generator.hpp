@@ -5,4 +5,7 @@
 namespace update
 {
   bool UpdateCountries(string const & dataDir);
+
+  /// Builds the binary countries file from countries.txt, Storage loads it instead of the json.
+  bool GenerateCountriesBinary(string const & dataDir);
 } // namespace update
@@ -2,6 +2,7 @@
 
 #include "generator/feature_merger.hpp"
 #include "generator/generate_info.hpp"
+#include "generator/parallel_feature_merger.hpp"
 
 #include "geometry/polygon.hpp"
 #include "geometry/region2d.hpp"
@@ -13,6 +14,8 @@
 
 #include "defines.hpp"
 
+#include "std/unique_ptr.hpp"
+
 namespace
 {
 class WaterBoundaryChecker
@@ -178,14 +181,27 @@ class WorldMapGenerator
   EmitterImpl m_worldBucket;
   FeatureTypesProcessor m_typesCorrector;
   FeatureMergeProcessor m_merger;
+  unique_ptr<ParallelFeatureMerger> m_parallelMerger;
   WaterBoundaryChecker m_boundaryChecker;
 
+  static uint32_t GetMergeCoordBits()
+  {
+    return POINT_COORD_BITS - (scales::GetUpperScale() - scales::GetUpperWorldScale()) / 2;
+  }
+
 public:
   explicit WorldMapGenerator(feature::GenerateInfo const & info)
       : m_worldBucket(info),
-        m_merger(POINT_COORD_BITS - (scales::GetUpperScale() - scales::GetUpperWorldScale()) / 2),
+        m_merger(GetMergeCoordBits()),
         m_boundaryChecker(info)
   {
+    if (info.m_worldMergeThreadsCount != 0)
+    {
+      m_parallelMerger = make_unique<ParallelFeatureMerger>(
+          GetMergeCoordBits(), info.GetIntermediateFileName(WORLD_FILE_NAME, ".merge."),
+          info.m_worldMergeThreadsCount);
+    }
+
     // Do not strip last types for given tags,
     // for example, do not cut 'admin_level' in  'boundary-administrative-XXX'.
     char const * arr1[][3] = {{"boundary", "administrative", "2"},
@@ -215,7 +231,11 @@ public:
       case feature::GEOM_LINE:
       {
         MergedFeatureBuilder1 * p = m_typesCorrector(fb);
-        if (p)
+        if (p == nullptr)
+          return;
+        if (m_parallelMerger)
+          (*m_parallelMerger)(p);
+        else
           m_merger(p);
         return;
       }
@@ -235,7 +255,13 @@ public:
       m_worldBucket.PushSure(fb);
   }
 
-  void DoMerge() { m_merger.DoMerge(m_worldBucket); }
+  void DoMerge()
+  {
+    if (m_parallelMerger)
+      m_parallelMerger->DoMerge(m_worldBucket);
+    else
+      m_merger.DoMerge(m_worldBucket);
+  }
 };
 
 template <class FeatureOutT>
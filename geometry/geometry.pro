@@ -33,6 +33,7 @@ HEADERS += \
   pointu_to_uint64.hpp \
   polygon.hpp \
   polyline2d.hpp \
+  prepared_region.hpp \
   rect2d.hpp \
   rect_intersect.hpp \
   region2d.hpp \
@@ -42,6 +43,7 @@ HEADERS += \
   screenbase.hpp \
   simplification.hpp \
   spline.hpp \
+  static_tree4d.hpp \
   transformations.hpp \
   tree4d.hpp \
   triangle2d.hpp \
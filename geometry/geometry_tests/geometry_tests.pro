@@ -32,12 +32,14 @@ SOURCES += \
   polygon_test.cpp \
   rect_test.cpp \
   region2d_binary_op_test.cpp \
+  prepared_region_test.cpp \
   region_test.cpp \
   robust_test.cpp \
   screen_test.cpp \
   segments_intersect_test.cpp \
   simplification_test.cpp \
   spline_test.cpp \
+  static_tree_test.cpp \
   transformations_test.cpp \
   tree_test.cpp \
   vector_test.cpp \
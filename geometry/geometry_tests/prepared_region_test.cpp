@@ -0,0 +1,129 @@
+#include "testing/testing.hpp"
+
+#include "geometry/geometry_tests/large_polygon.hpp"
+
+#include "geometry/prepared_region.hpp"
+#include "geometry/region2d.hpp"
+
+#include "base/logging.hpp"
+#include "base/macros.hpp"
+#include "base/timer.hpp"
+
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+template <class PointT>
+void TestSameAsRegion(m2::Region<PointT> const & region, vector<PointT> const & points)
+{
+  m2::PreparedRegion<PointT> const prepared(region);
+  for (PointT const & pt : points)
+    TEST_EQUAL(prepared.Contains(pt), region.Contains(pt), (pt));
+}
+
+template <class PointT>
+void AddRegionPoints(m2::Region<PointT> const & region, vector<PointT> & points)
+{
+  for (auto it = region.Begin(); it != region.End(); ++it)
+  {
+    points.push_back(*it);
+    auto next = it + 1;
+    if (next == region.End())
+      next = region.Begin();
+    points.push_back((*it + *next) / 2);
+  }
+}
+
+vector<m2::PointD> MakeRandomPoints(m2::RectD const & rect, size_t count, uint32_t seed)
+{
+  int const kSteps = 1000000;
+  mt19937 rnd(seed);
+  uniform_int_distribution<int> dist(-kSteps / 10, kSteps + kSteps / 10);
+
+  vector<m2::PointD> points;
+  for (size_t i = 0; i < count; ++i)
+  {
+    points.emplace_back(rect.minX() + rect.SizeX() * dist(rnd) / kSteps,
+                        rect.minY() + rect.SizeY() * dist(rnd) / kSteps);
+  }
+  return points;
+}
+}  // namespace
+
+UNIT_TEST(PreparedRegion_Simple)
+{
+  m2::PointI const arr[] = {m2::PointI(0, 0), m2::PointI(10, 0), m2::PointI(10, 10),
+                            m2::PointI(5, 5), m2::PointI(0, 10)};
+  m2::Region<m2::PointI> region(arr, arr + ARRAY_SIZE(arr));
+
+  vector<m2::PointI> points;
+  for (int x = -2; x <= 12; ++x)
+  {
+    for (int y = -2; y <= 12; ++y)
+      points.emplace_back(x, y);
+  }
+  TestSameAsRegion(region, points);
+
+  m2::PreparedRegion<m2::PointI> const prepared(region);
+  TEST(prepared.Contains(m2::PointI(1, 8)), ());
+  TEST(prepared.Contains(m2::PointI(5, 5)), ());
+  TEST(!prepared.Contains(m2::PointI(5, 8)), ());
+}
+
+UNIT_TEST(PreparedRegion_Degenerated)
+{
+  m2::RegionD region;
+  TEST(!m2::PreparedRegionD(region).Contains(m2::PointD(0, 0)), ());
+
+  m2::PointD const arr[] = {m2::PointD(0, 1), m2::PointD(2, 1), m2::PointD(4, 1)};
+  region.Assign(arr, arr + ARRAY_SIZE(arr));
+  vector<m2::PointD> points;
+  AddRegionPoints(region, points);
+  points.emplace_back(1, 2);
+  points.emplace_back(5, 1);
+  TestSameAsRegion(region, points);
+}
+
+UNIT_TEST(PreparedRegion_LargePolygon)
+{
+  m2::RegionD const region(LargePolygon::kLargePolygon,
+                           LargePolygon::kLargePolygon + ARRAY_SIZE(LargePolygon::kLargePolygon));
+
+  vector<m2::PointD> points = MakeRandomPoints(region.GetRect(), 20000, 1);
+  AddRegionPoints(region, points);
+  TestSameAsRegion(region, points);
+}
+
+UNIT_TEST(PreparedRegion_Benchmark)
+{
+  m2::RegionD const region(LargePolygon::kLargePolygon,
+                           LargePolygon::kLargePolygon + ARRAY_SIZE(LargePolygon::kLargePolygon));
+  vector<m2::PointD> const points = MakeRandomPoints(region.GetRect(), 20000, 2);
+
+  my::Timer timer;
+  size_t regionCount = 0;
+  for (m2::PointD const & pt : points)
+  {
+    if (region.Contains(pt))
+      ++regionCount;
+  }
+  double const regionTime = timer.ElapsedSeconds();
+
+  timer.Reset();
+  m2::PreparedRegionD const prepared(region);
+  double const prepareTime = timer.ElapsedSeconds();
+
+  timer.Reset();
+  size_t preparedCount = 0;
+  for (m2::PointD const & pt : points)
+  {
+    if (prepared.Contains(pt))
+      ++preparedCount;
+  }
+  double const preparedTime = timer.ElapsedSeconds();
+
+  TEST_EQUAL(regionCount, preparedCount, ());
+  LOG(LINFO, ("Contains of", points.size(), "points in", region.Size(), "points region, Region:",
+              regionTime, "PreparedRegion:", preparedTime, "preparing:", prepareTime));
+}
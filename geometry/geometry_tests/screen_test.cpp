@@ -167,3 +167,31 @@ UNIT_TEST(ScreenBase_CombineTransforms)
   TEST(is_equal(p1, pp1), (p1, pp1));
   TEST(is_equal(p2, pp2), (p2, pp2));
 }
+
+UNIT_TEST(ScreenBase_BatchTransforms)
+{
+  ScreenBase s;
+  s.OnSize(0, 0, 640, 480);
+  s.SetFromRect(m2::AnyRectD(m2::RectD(50, 25, 55, 30)));
+  s.SetAngle(1.0);
+
+  m2::PointD const src[] = { m2::PointD(40, 50), m2::PointD(52, 27), m2::PointD(-3, 60.5) };
+  size_t const count = ARRAY_SIZE(src);
+
+  m2::PointD px[count];
+  s.GtoP(src, count, px);
+  for (size_t i = 0; i < count; ++i)
+  {
+    TEST(is_equal(px[i], s.GtoP(src[i])), (i));
+
+    double x = src[i].x;
+    double y = src[i].y;
+    s.GtoP(x, y);
+    TEST(is_equal(px[i], m2::PointD(x, y)), (i));
+  }
+
+  // In place.
+  s.PtoG(px, count, px);
+  for (size_t i = 0; i < count; ++i)
+    TEST(is_equal(px[i], src[i]), (i));
+}
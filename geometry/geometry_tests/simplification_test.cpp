@@ -166,6 +166,100 @@ UNIT_TEST(Simpfication_DP_DegenerateTrg)
   CheckDPStrict(arr2, ARRAY_SIZE(arr2), 1.0, 4);
 }
 
+namespace
+{
+// Straightforward versions of the algorithms, the optimized ones must give the same points.
+void ReferenceDP(P const * first, P const * last, double eps, DistanceF & dist, vector<P> & out)
+{
+  pair<double, P const *> const maxDist = impl::MaxDistance(first, last, dist);
+  if (maxDist.second == last || maxDist.first < eps)
+  {
+    out.push_back(*last);
+    return;
+  }
+  ReferenceDP(first, maxDist.second, eps, dist, out);
+  ReferenceDP(maxDist.second, last, eps, dist, out);
+}
+
+template <typename DistanceT>
+void ReferenceNearOptimal(int32_t maxFalseLookAhead, P const * beg, int32_t n, double eps,
+                          DistanceT dist, vector<P> & out)
+{
+  vector<impl::SimplifyOptimalRes> F(n);
+  F[n - 1] = impl::SimplifyOptimalRes(n, 1);
+  for (int32_t i = n - 2; i >= 0; --i)
+  {
+    for (int32_t falseCount = 0, j = i + 1; j < n && falseCount < maxFalseLookAhead; ++j)
+    {
+      uint32_t const newPointCount = F[j].m_PointCount + 1;
+      if (newPointCount < F[i].m_PointCount)
+      {
+        if (impl::MaxDistance(beg + i, beg + j, dist).first < eps)
+        {
+          F[i].m_NextPoint = j;
+          F[i].m_PointCount = newPointCount;
+        }
+        else
+        {
+          ++falseCount;
+        }
+      }
+    }
+  }
+  for (int32_t i = 0; i < n; i = F[i].m_NextPoint)
+    out.push_back(beg[i]);
+}
+
+// Keeps the points of the right half plane, as the generator keeps the points near the borders.
+class KeepRightDistance : public DistanceF
+{
+public:
+  double operator()(P const & p) const
+  {
+    return p.x > m_x ? numeric_limits<double>::max() : DistanceF::operator()(p);
+  }
+
+  double m_x = 0.0;
+};
+}  // namespace
+
+UNIT_TEST(Simplification_SameAsReference)
+{
+  P const * points = LargePolylineTestData::m_Data;
+  size_t const count = LargePolylineTestData::m_Size;
+
+  for (double eps = 0.00001; eps < 0.11; eps *= 10)
+  {
+    vector<P> expected(1, points[0]);
+    DistanceF dist;
+    ReferenceDP(points, points + count - 1, eps, dist, expected);
+    vector<P> result;
+    SimplifyDP(points, points + count, eps, DistanceF(), MakeBackInsertFunctor(result));
+    TEST_EQUAL(result, expected, (eps));
+
+    for (int lookAhead : {1, 10, 20, 200})
+    {
+      expected.clear();
+      ReferenceNearOptimal(lookAhead, points, static_cast<int32_t>(count), eps, DistanceF(),
+                           expected);
+      result.clear();
+      SimplifyNearOptimal(lookAhead, points, points + count, eps, DistanceF(),
+                          MakeBackInsertFunctor(result));
+      TEST_EQUAL(result, expected, (eps, lookAhead));
+
+      KeepRightDistance keepRight;
+      keepRight.m_x = 0.5 * (points[0].x + points[count / 2].x);
+      expected.clear();
+      ReferenceNearOptimal(lookAhead, points, static_cast<int32_t>(count), eps, keepRight,
+                           expected);
+      result.clear();
+      SimplifyNearOptimal(lookAhead, points, points + count, eps, keepRight,
+                          MakeBackInsertFunctor(result));
+      TEST_EQUAL(result, expected, (eps, lookAhead));
+    }
+  }
+}
+
 #include "geometry/geometry_tests/large_polygon.hpp"
 
 m2::PointD const * LargePolylineTestData::m_Data = LargePolygon::kLargePolygon;
@@ -205,3 +205,45 @@ UNIT_TEST(Length)
   TEST_ALMOST_EQUAL_ULPS(len1, len2, ());
 }
 
+
+UNIT_TEST(LongSteps)
+{
+  // Zigzag of the diagonal segments, the nodes are at (i, 0) and (i, 1).
+  vector<PointD> path;
+  for (int i = 0; i <= 1000; ++i)
+    path.push_back(PointD(i, i % 2));
+
+  Spline spl(path);
+  double const segment = sqrt(2.0);
+  TEST_ALMOST_EQUAL_ULPS(spl.GetLength(), 1000 * segment, ());
+
+  Spline::iterator itr;
+  itr.Attach(spl);
+  itr.Advance(500.5 * segment);
+  TEST(itr.m_pos.EqualDxDy(PointD(500.5, 0.5), 1e-9), (itr.m_pos));
+  TEST(my::AlmostEqualAbs(itr.GetLength(), 500.5 * segment, 1e-9), ());
+  itr.Advance(-300.25 * segment);
+  TEST(itr.m_pos.EqualDxDy(PointD(200.25, 0.25), 1e-9), (itr.m_pos));
+  TEST(!itr.BeginAgain(), ());
+  itr.Advance(-300.0 * segment);
+  TEST(itr.m_pos.EqualDxDy(PointD(0, 0), 1e-9), (itr.m_pos));
+  TEST(itr.BeginAgain(), ());
+
+  itr.Attach(spl);
+  itr.Advance(1001 * segment);
+  TEST(itr.BeginAgain(), ());
+  TEST(itr.m_pos.EqualDxDy(PointD(1001, -1), 1e-9), (itr.m_pos));
+
+  vector<double> const distances = {999.75 * segment, 0.0, 10.0 * segment, 2.5 * segment};
+  vector<Spline::iterator> iters;
+  spl.GetIterators(distances, iters);
+  TEST_EQUAL(iters.size(), distances.size(), ());
+  for (size_t i = 0; i < distances.size(); ++i)
+  {
+    itr.Attach(spl);
+    itr.Advance(distances[i]);
+    TEST(iters[i].m_pos.EqualDxDy(itr.m_pos, 1e-9), (i));
+    TEST(iters[i].m_dir.EqualDxDy(itr.m_dir, 1e-9), (i));
+    TEST(my::AlmostEqualAbs(iters[i].GetLength(), distances[i], 1e-9), (i));
+  }
+}
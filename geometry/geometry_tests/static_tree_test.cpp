@@ -0,0 +1,128 @@
+#include "testing/testing.hpp"
+
+#include "geometry/static_tree4d.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+typedef m2::RectD R;
+
+struct Traits
+{
+  vector<R> const & m_rects;
+  m2::RectD LimitRect(size_t i) const { return m_rects[i]; }
+};
+
+typedef m4::Tree<size_t, Traits> TreeT;
+typedef m4::StaticTree<size_t, Traits> StaticTreeT;
+
+vector<R> MakeRects(size_t count, double maxSize, uint32_t seed)
+{
+  int const kSteps = 100000;
+  mt19937 rnd(seed);
+  uniform_int_distribution<int> coord(0, kSteps);
+  uniform_int_distribution<int> size(0, kSteps);
+
+  vector<R> rects;
+  for (size_t i = 0; i < count; ++i)
+  {
+    double const x = 1000.0 * coord(rnd) / kSteps;
+    double const y = 1000.0 * coord(rnd) / kSteps;
+    rects.emplace_back(x, y, x + maxSize * size(rnd) / kSteps, y + maxSize * size(rnd) / kSteps);
+  }
+  return rects;
+}
+
+template <class TTree>
+vector<size_t> GetInRect(TTree const & tree, R const & rect)
+{
+  vector<size_t> result;
+  tree.ForEachInRect(rect, [&result](size_t i) { result.push_back(i); });
+  sort(result.begin(), result.end());
+  return result;
+}
+}  // namespace
+
+UNIT_TEST(StaticTree_Smoke)
+{
+  vector<R> const rects = {R(0, 0, 1, 1), R(1, 1, 2, 2), R(2, 2, 3, 3)};
+  StaticTreeT tree(Traits{rects});
+  TEST(tree.IsEmpty(), ());
+  tree.Build();
+  TEST(GetInRect(tree, R(0, 0, 10, 10)).empty(), ());
+
+  tree.Clear();
+  for (size_t i = 0; i < rects.size(); ++i)
+    tree.Add(i);
+  tree.Build();
+  TEST_EQUAL(tree.GetSize(), 3, ());
+
+  TEST_EQUAL(GetInRect(tree, R(1.5, 1.5, 1.5, 1.5)), vector<size_t>({1}), ());
+  TEST_EQUAL(GetInRect(tree, R(0.5, 0.5, 2.5, 2.5)), vector<size_t>({0, 1, 2}), ());
+  // Touching rects aren't reported.
+  TEST(GetInRect(tree, R(3, 3, 4, 4)).empty(), ());
+}
+
+UNIT_TEST(StaticTree_SameAsTree)
+{
+  for (size_t const count : {1, 15, 16, 17, 300, 5000})
+  {
+    vector<R> const rects = MakeRects(count, 20.0, static_cast<uint32_t>(count));
+    TreeT tree(Traits{rects});
+    StaticTreeT staticTree(Traits{rects});
+    for (size_t i = 0; i < rects.size(); ++i)
+    {
+      tree.Add(i);
+      staticTree.Add(i);
+    }
+    staticTree.Build();
+    TEST_EQUAL(staticTree.GetSize(), count, ());
+
+    for (R const & query : MakeRects(200, 100.0, 1))
+      TEST_EQUAL(GetInRect(staticTree, query), GetInRect(tree, query), (count, query));
+  }
+}
+
+UNIT_TEST(StaticTree_Benchmark)
+{
+  vector<R> const rects = MakeRects(100000, 5.0, 2);
+  vector<R> const queries = MakeRects(20000, 20.0, 3);
+
+  my::Timer timer;
+  TreeT tree(Traits{rects});
+  for (size_t i = 0; i < rects.size(); ++i)
+    tree.Add(i);
+  tree.Optimize();
+  double const treeBuildTime = timer.ElapsedSeconds();
+
+  timer.Reset();
+  size_t treeCount = 0;
+  for (R const & query : queries)
+    tree.ForEachInRect(query, [&treeCount](size_t) { ++treeCount; });
+  double const treeTime = timer.ElapsedSeconds();
+
+  timer.Reset();
+  StaticTreeT staticTree(Traits{rects});
+  for (size_t i = 0; i < rects.size(); ++i)
+    staticTree.Add(i);
+  staticTree.Build();
+  double const staticBuildTime = timer.ElapsedSeconds();
+
+  timer.Reset();
+  size_t staticCount = 0;
+  for (R const & query : queries)
+    staticTree.ForEachInRect(query, [&staticCount](size_t) { ++staticCount; });
+  double const staticTime = timer.ElapsedSeconds();
+
+  TEST_EQUAL(treeCount, staticCount, ());
+  LOG(LINFO, (queries.size(), "queries in", rects.size(), "rects, found", staticCount));
+  LOG(LINFO, ("m4::Tree build:", treeBuildTime, "queries:", treeTime));
+  LOG(LINFO, ("m4::StaticTree build:", staticBuildTime, "queries:", staticTime));
+}
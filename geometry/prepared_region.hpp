@@ -0,0 +1,164 @@
+#pragma once
+
+#include "geometry/region2d.hpp"
+
+#include "base/assert.hpp"
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/cstdint.hpp"
+#include "std/type_traits.hpp"
+#include "std/vector.hpp"
+
+namespace m2
+{
+/// Region prepared for the lots of Contains queries. Edges are split into horizontal slabs,
+/// a query checks the edges of its slab only, with the same arithmetic as Region::Contains,
+/// so the results are exactly the same. Edges are put into the slabs with the points
+/// precision, so the vertices which are equal to the point are found too.
+/// The region must outlive the prepared one and it must not be changed.
+template <class PointT>
+class PreparedRegion
+{
+public:
+  typedef Region<PointT> RegionT;
+  typedef typename PointT::value_type CoordT;
+
+  /// Average count of edges in a slab, a slab is checked by a query.
+  static size_t const kEdgesPerSlab = 4;
+
+  explicit PreparedRegion(RegionT const & region) : m_region(region)
+  {
+    size_t const count = region.Size();
+    Rect<CoordT> const & rect = region.GetRect();
+    if (count < 2 || rect.IsEmptyInterior())
+    {
+      // All edges are in one slab.
+      m_minY = 0.0;
+      m_slabHeight = 0.0;
+      m_offsets.assign(2, 0);
+      for (size_t i = 0; i < count; ++i)
+        m_edges.push_back(static_cast<uint32_t>(i));
+      m_offsets[1] = static_cast<uint32_t>(m_edges.size());
+      return;
+    }
+
+    size_t const slabsCount = max(count / kEdgesPerSlab, size_t(1));
+    m_minY = static_cast<double>(rect.minY());
+    m_slabHeight = (static_cast<double>(rect.maxY()) - m_minY) / slabsCount;
+    m_offsets.assign(slabsCount + 1, 0);
+
+    // Counts edges of each slab at offset + 1, then fills them.
+    ForEachEdgeSlab([this](size_t, size_t slab) { ++m_offsets[slab + 1]; });
+    for (size_t i = 1; i < m_offsets.size(); ++i)
+      m_offsets[i] += m_offsets[i - 1];
+
+    m_edges.resize(m_offsets.back());
+    vector<uint32_t> next(m_offsets.begin(), m_offsets.end() - 1);
+    ForEachEdgeSlab([this, &next](size_t edge, size_t slab)
+    {
+      m_edges[next[slab]++] = static_cast<uint32_t>(edge);
+    });
+  }
+
+  /// The same as Region::Contains.
+  bool Contains(PointT const & pt) const
+  {
+    if (!m_region.GetRect().IsPointInside(pt))
+      return false;
+
+    typedef typename TraitsT::BigType BigCoordT;
+    typedef Point<BigCoordT> BigPointT;
+    typename TraitsT::EqualType const equalF;
+
+    int rCross = 0; /* number of right edge/ray crossings */
+    int lCross = 0; /* number of left edge/ray crossings */
+
+    typename RegionT::IteratorT const points = m_region.Begin();
+    size_t const numPoints = m_region.Size();
+    size_t const slab = GetSlab(static_cast<double>(pt.y));
+    for (uint32_t i = m_offsets[slab]; i < m_offsets[slab + 1]; ++i)
+    {
+      // Edge i goes from the previous point to the i-th one.
+      size_t const index = m_edges[i];
+      PointT const & currPoint = points[index];
+      PointT const & prevPoint = points[index == 0 ? numPoints - 1 : index - 1];
+      if (equalF.EqualPoints(currPoint, pt) || equalF.EqualPoints(prevPoint, pt))
+        return true;
+
+      BigPointT const prev = BigPointT(prevPoint) - BigPointT(pt);
+      BigPointT const curr = BigPointT(currPoint) - BigPointT(pt);
+
+      bool const rCheck = ((curr.y > 0) != (prev.y > 0));
+      bool const lCheck = ((curr.y < 0) != (prev.y < 0));
+
+      if (rCheck || lCheck)
+      {
+        ASSERT_NOT_EQUAL(curr.y, prev.y, ());
+
+        BigCoordT const delta = prev.y - curr.y;
+        BigCoordT const cp = CrossProduct(curr, prev);
+
+        if (!equalF.EqualZero(cp, delta))
+        {
+          bool const PrevGreaterCurr = delta > 0.0;
+
+          if (rCheck && ((cp > 0) == PrevGreaterCurr)) ++rCross;
+          if (lCheck && ((cp > 0) != PrevGreaterCurr)) ++lCross;
+        }
+      }
+    }
+
+    /* q on the edge if left and right cross are not the same parity. */
+    if ((rCross & 1) != (lCross & 1))
+      return true;  // on the edge
+
+    /* q inside if an odd number of crossings. */
+    return (rCross & 1) != 0;
+  }
+
+  inline RegionT const & GetRegion() const { return m_region; }
+
+private:
+  typedef detail::TraitsType<is_floating_point<CoordT>::value> TraitsT;
+
+  static double GetPrecision()
+  {
+    return is_floating_point<CoordT>::value ? detail::DefEqualFloat::kPrecision : 0.0;
+  }
+
+  size_t GetSlab(double y) const
+  {
+    if (m_slabHeight == 0.0)
+      return 0;
+    double const slab = floor((y - m_minY) / m_slabHeight);
+    return static_cast<size_t>(my::clamp(slab, 0.0, static_cast<double>(m_offsets.size() - 2)));
+  }
+
+  template <class TFn>
+  void ForEachEdgeSlab(TFn && fn) const
+  {
+    typename RegionT::IteratorT const points = m_region.Begin();
+    size_t const numPoints = m_region.Size();
+    double const eps = GetPrecision();
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      double const y1 = static_cast<double>(points[i == 0 ? numPoints - 1 : i - 1].y);
+      double const y2 = static_cast<double>(points[i].y);
+      size_t const last = GetSlab(max(y1, y2) + eps);
+      for (size_t slab = GetSlab(min(y1, y2) - eps); slab <= last; ++slab)
+        fn(i, slab);
+    }
+  }
+
+  RegionT const & m_region;
+  double m_minY;
+  double m_slabHeight;
+  /// Edges of slab i are [m_offsets[i], m_offsets[i + 1]) in m_edges.
+  vector<uint32_t> m_offsets;
+  vector<uint32_t> m_edges;
+};
+
+typedef PreparedRegion<m2::PointD> PreparedRegionD;
+}  // namespace m2
@@ -191,6 +191,16 @@ void ScreenBase::SetGtoPMatrix(MatrixT const & m)
   UpdateDependentParameters();
 }
 
+void ScreenBase::GtoP(m2::PointD const * src, size_t count, m2::PointD * dst) const
+{
+  math::TransformPoints(m_GtoP, src, src + count, dst);
+}
+
+void ScreenBase::PtoG(m2::PointD const * src, size_t count, m2::PointD * dst) const
+{
+  math::TransformPoints(m_PtoG, src, src + count, dst);
+}
+
 void ScreenBase::GtoP(m2::RectD const & glbRect, m2::RectD & pxRect) const
 {
   pxRect = m2::RectD(GtoP(glbRect.LeftTop()), GtoP(glbRect.RightBottom()));
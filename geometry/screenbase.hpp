@@ -88,7 +88,7 @@ public:
   {
     double tempX = x;
     x = tempX * m_GtoP(0, 0) + y * m_GtoP(1, 0) + m_GtoP(2, 0);
-    y = tempX * m_GtoP(1, 0) + y * m_GtoP(1, 1) + m_GtoP(2, 1);
+    y = tempX * m_GtoP(0, 1) + y * m_GtoP(1, 1) + m_GtoP(2, 1);
   }
 
   inline void PtoG(double & x, double & y) const
@@ -98,6 +98,10 @@ public:
     y = tempX * m_PtoG(0, 1) + y * m_PtoG(1, 1) + m_PtoG(2, 1);
   }
 
+  /// Transforms count points of src to dst, src and dst may be the same.
+  void GtoP(m2::PointD const * src, size_t count, m2::PointD * dst) const;
+  void PtoG(m2::PointD const * src, size_t count, m2::PointD * dst) const;
+
   void GtoP(m2::RectD const & gr, m2::RectD & sr) const;
   void PtoG(m2::RectD const & pr, m2::RectD & gr) const;
 
@@ -39,19 +39,56 @@ pair<double, IterT> MaxDistance(IterT first, IterT last, DistanceF & dist)
 }
 
 // Actual SimplifyDP implementation.
+// Ranges are split by an explicit stack instead of the recursion, so long polylines with
+// badly balanced splits, like spirals, don't overflow the call stack. The right range is
+// pushed first, so the points are given in the same order as the recursion gives them.
 template <typename DistanceF, typename IterT, typename OutT>
 void SimplifyDP(IterT first, IterT last, double epsilon, DistanceF & dist, OutT & out)
 {
-  pair<double, IterT> maxDist = impl::MaxDistance(first, last, dist);
-  if (maxDist.second == last || maxDist.first < epsilon)
+  vector<pair<IterT, IterT>> ranges;
+  ranges.emplace_back(first, last);
+  while (!ranges.empty())
   {
-    out(*last);
+    pair<IterT, IterT> const range = ranges.back();
+    ranges.pop_back();
+
+    pair<double, IterT> const maxDist = impl::MaxDistance(range.first, range.second, dist);
+    if (maxDist.second == range.second || maxDist.first < epsilon)
+    {
+      out(*range.second);
+    }
+    else
+    {
+      ranges.emplace_back(maxDist.second, range.second);
+      ranges.emplace_back(range.first, maxDist.second);
+    }
   }
-  else
+}
+
+// Same as MaxDistance(first, last, dist).first < epsilon, but stops on the first far point.
+// The far point is checked first by the next call, because the ranges of the next calls
+// differ by a single end point and the same point is likely to be far again.
+template <typename DistanceF, typename IterT>
+bool IsCloser(IterT first, IterT last, double epsilon, DistanceF & dist, IterT & farPoint)
+{
+  if (!(0.0 < epsilon))
+    return false;
+  if (distance(first, last) <= 1)
+    return true;
+
+  dist.SetBounds(*first, *last);
+  if (first < farPoint && farPoint < last && dist(*farPoint) >= epsilon)
+    return false;
+
+  for (IterT i = first + 1; i != last; ++i)
   {
-    impl::SimplifyDP(first, maxDist.second, epsilon, dist, out);
-    impl::SimplifyDP(maxDist.second, last, epsilon, dist, out);
+    if (dist(*i) >= epsilon)
+    {
+      farPoint = i;
+      return false;
+    }
   }
+  return true;
 }
 //@}
 
@@ -102,12 +139,15 @@ void SimplifyNearOptimal(int kMaxFalseLookAhead, IterT beg, IterT end,
   F[n - 1] = impl::SimplifyOptimalRes(n, 1);
   for (int32_t i = n - 2; i >= 0; --i)
   {
+    // Only the fact that the range is close matters, so the distances aren't computed
+    // past the first far point.
+    IterT farPoint = beg;
     for (int32_t falseCount = 0, j = i + 1; j < n && falseCount < kMaxFalseLookAhead; ++j)
     {
       uint32_t const newPointCount = F[j].m_PointCount + 1;
       if (newPointCount < F[i].m_PointCount)
       {
-          if (impl::MaxDistance(beg + i, beg + j, dist).first < epsilon)
+          if (impl::IsCloser(beg + i, beg + j, epsilon, dist, farPoint))
           {
             F[i].m_NextPoint = j;
             F[i].m_PointCount = newPointCount;
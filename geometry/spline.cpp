@@ -2,7 +2,7 @@
 
 #include "base/logging.hpp"
 
-#include "std/numeric.hpp"
+#include "std/algorithm.hpp"
 
 namespace m2
 {
@@ -14,12 +14,14 @@ Spline::Spline(vector<PointD> const & path)
   size_t cnt = m_position.size() - 1;
   m_direction = vector<PointD>(cnt);
   m_length = vector<double>(cnt);
+  m_lengthFromStart = vector<double>(cnt + 1);
 
   for(int i = 0; i < cnt; ++i)
   {
     m_direction[i] = path[i+1] - path[i];
     m_length[i] = m_direction[i].Length();
     m_direction[i] = m_direction[i].Normalize();
+    m_lengthFromStart[i + 1] = m_lengthFromStart[i] + m_length[i];
   }
 }
 
@@ -34,13 +36,17 @@ void Spline::AddPoint(PointD const & pt)
   }
 
   if(IsEmpty())
+  {
     m_position.push_back(pt);
+    m_lengthFromStart.push_back(0.0);
+  }
   else
   {
     PointD dir = pt - m_position.back();
     m_position.push_back(pt);
     m_length.push_back(dir.Length());
     m_direction.push_back(dir.Normalize());
+    m_lengthFromStart.push_back(m_lengthFromStart.back() + m_length.back());
   }
 }
 
@@ -61,13 +67,31 @@ Spline const & Spline::operator = (Spline const & spl)
     m_position = spl.m_position;
     m_direction = spl.m_direction;
     m_length = spl.m_length;
+    m_lengthFromStart = spl.m_lengthFromStart;
   }
   return *this;
 }
 
 double Spline::GetLength() const
 {
-  return accumulate(m_length.begin(), m_length.end(), 0.0);
+  return m_lengthFromStart.empty() ? 0.0 : m_lengthFromStart.back();
+}
+
+void Spline::GetIterators(vector<double> const & distances, vector<iterator> & iterators) const
+{
+  iterators.resize(distances.size());
+  for (size_t i = 0; i < distances.size(); ++i)
+  {
+    iterators[i].Attach(*this);
+    iterators[i].Advance(distances[i]);
+  }
+}
+
+int Spline::FindSegment(int first, double distance) const
+{
+  ASSERT_LESS(first, m_lengthFromStart.size(), ());
+  auto const it = lower_bound(m_lengthFromStart.begin() + first + 1, m_lengthFromStart.end(), distance);
+  return static_cast<int>(it - m_lengthFromStart.begin()) - 1;
 }
 
 Spline::iterator::iterator()
@@ -125,7 +149,7 @@ void Spline::iterator::Advance(double step)
 
 double Spline::iterator::GetLength() const
 {
-  return accumulate(m_spl->m_length.begin(), m_spl->m_length.begin() + m_index, m_dist);
+  return m_spl->m_lengthFromStart[m_index] + m_dist;
 }
 
 double Spline::iterator::GetFullLength() const
@@ -151,10 +175,12 @@ int Spline::iterator::GetIndex() const
 void Spline::iterator::AdvanceBackward(double step)
 {
   m_dist += step;
-  while(m_dist < 0.0f)
+  if (m_dist < 0.0)
   {
-    m_index--;
-    if (m_index < 0)
+    // The node before the point is found by the binary search, so the long steps
+    // don't walk all the segments.
+    double const length = m_spl->m_lengthFromStart[m_index] + m_dist;
+    if (length < 0.0)
     {
       m_index = 0;
       m_checker = true;
@@ -165,7 +191,9 @@ void Spline::iterator::AdvanceBackward(double step)
       return;
     }
 
-    m_dist += m_spl->m_length[m_index];
+    auto const begin = m_spl->m_lengthFromStart.begin();
+    m_index = static_cast<int>(upper_bound(begin, begin + m_index, length) - begin) - 1;
+    m_dist = length - m_spl->m_lengthFromStart[m_index];
   }
   m_dir = m_spl->m_direction[m_index];
   m_avrDir = -m_pos;
@@ -181,17 +209,17 @@ void Spline::iterator::AdvanceForward(double step)
     m_pos = m_spl->m_position[m_index] + m_dir * m_dist;
     return;
   }
-  while (m_dist > m_spl->m_length[m_index])
+  if (m_dist > m_spl->m_length[m_index])
   {
-    m_dist -= m_spl->m_length[m_index];
-    m_index++;
-    if (m_index >= m_spl->m_direction.size())
+    double const length = m_spl->m_lengthFromStart[m_index] + m_dist;
+    m_index = m_spl->FindSegment(m_index + 1, length);
+    int const segmentsCount = static_cast<int>(m_spl->m_direction.size());
+    if (m_index >= segmentsCount)
     {
-      m_index--;
-      m_dist += m_spl->m_length[m_index];
+      m_index = segmentsCount - 1;
       m_checker = true;
-      break;
     }
+    m_dist = length - m_spl->m_lengthFromStart[m_index];
   }
   m_dir = m_spl->m_direction[m_index];
   m_avrDir = -m_pos;
@@ -239,6 +267,12 @@ Spline::iterator SharedSpline::CreateIterator() const
   return result;
 }
 
+void SharedSpline::CreateIterators(vector<double> const & distances,
+                                   vector<Spline::iterator> & iterators) const
+{
+  m_spline->GetIterators(distances, iterators);
+}
+
 Spline * SharedSpline::operator->()
 {
   ASSERT(!IsNull(), ());
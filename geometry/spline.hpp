@@ -70,10 +70,21 @@ public:
 
   double GetLength() const;
 
+  /// Fills the iterators which are attached to the spline and advanced by the distances,
+  /// each one takes O(log n) of the count of the nodes.
+  void GetIterators(vector<double> const & distances, vector<iterator> & iterators) const;
+
 private:
+  /// @return Index of the segment which has the point at the distance from the start,
+  /// the segments before the first one aren't checked. The point at a node belongs to the
+  /// segment before the node. Count of the segments is returned when the point is past the end.
+  int FindSegment(int first, double distance) const;
+
   vector<PointD> m_position;
   vector<PointD> m_direction;
   vector<double> m_length;
+  /// Length of the spline from the start to the i-th node.
+  vector<double> m_lengthFromStart;
 };
 
 class SharedSpline
@@ -89,6 +100,7 @@ public:
   void Reset(vector<PointD> const & path);
 
   Spline::iterator CreateIterator() const;
+  void CreateIterators(vector<double> const & distances, vector<Spline::iterator> & iterators) const;
 
   Spline * operator->();
   Spline const * operator->() const;
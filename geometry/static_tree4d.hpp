@@ -0,0 +1,215 @@
+#pragma once
+
+#include "geometry/rect2d.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "base/assert.hpp"
+#include "base/buffer_vector.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/cstdint.hpp"
+#include "std/iterator.hpp"
+#include "std/vector.hpp"
+
+namespace m4
+{
+/// Static R-tree of rects, packed by the Sort-Tile-Recursive algorithm. Values and nodes are
+/// kept in the contiguous arrays, so it's built faster and queried faster than m4::Tree,
+/// but it can't be changed after Build(). ForEachInRect has the same semantics as m4::Tree
+/// one: the rects which are only touching the query rect aren't reported.
+///
+/// Usage: Add() all the values, call Build() once, query it.
+template <class T, typename Traits = TraitsDef<T>>
+class StaticTree
+{
+public:
+  /// Maximal number of children of a node.
+  static size_t const kNodeCapacity = 16;
+
+  StaticTree(Traits const & traits = Traits()) : m_traits(traits), m_isBuilt(false) {}
+
+  typedef T elem_t;
+
+  void Add(T const & obj) { Add(obj, m_traits.LimitRect(obj)); }
+  void Add(T const & obj, m2::RectD const & rect)
+  {
+    ASSERT(!m_isBuilt, ("Values can't be added after Build()"));
+    m_values.emplace_back(obj, rect);
+  }
+
+  /// Packs the values, it must be called after the last Add() and before the queries.
+  void Build()
+  {
+    ASSERT(!m_isBuilt, ());
+    m_isBuilt = true;
+    m_nodes.clear();
+    if (m_values.empty())
+      return;
+
+    SortTiles(m_values.begin(), m_values.end());
+    size_t levelBegin = 0;
+    MakeParents(m_values, 0, true /* isLeaf */);
+    // Upper levels are built of the nodes of the previous one till the root.
+    while (m_nodes.size() - levelBegin > 1)
+    {
+      size_t const levelEnd = m_nodes.size();
+      SortTiles(m_nodes.begin() + levelBegin, m_nodes.end());
+      MakeParents(m_nodes, levelBegin, false /* isLeaf */);
+      levelBegin = levelEnd;
+    }
+    m_nodes.shrink_to_fit();
+    m_values.shrink_to_fit();
+  }
+
+  template <class ToDo>
+  void ForEachInRect(m2::RectD const & rect, ToDo && toDo) const
+  {
+    ASSERT(m_isBuilt, ());
+    if (m_nodes.empty())
+      return;
+
+    // Nodes of the first level refer to the values, upper ones refer to the nodes.
+    buffer_vector<uint32_t, 128> stack;
+    stack.push_back(static_cast<uint32_t>(m_nodes.size() - 1));
+    while (!stack.empty())
+    {
+      Node const & node = m_nodes[stack.back()];
+      stack.pop_back();
+      if (!node.m_box.IsIntersect(rect))
+        continue;
+
+      size_t const last = node.m_first + node.m_count;
+      if (node.m_isLeaf)
+      {
+        for (size_t i = node.m_first; i < last; ++i)
+        {
+          if (m_values[i].m_box.IsIntersect(rect))
+            toDo(m_values[i].m_val);
+        }
+      }
+      else
+      {
+        for (uint32_t i = node.m_first; i < last; ++i)
+          stack.push_back(i);
+      }
+    }
+  }
+
+  template <class ToDo>
+  void ForEach(ToDo && toDo) const
+  {
+    for (Value const & v : m_values)
+      toDo(v.m_val);
+  }
+
+  bool IsEmpty() const { return m_values.empty(); }
+
+  size_t GetSize() const { return m_values.size(); }
+
+  void Clear()
+  {
+    m_values.clear();
+    m_nodes.clear();
+    m_isBuilt = false;
+  }
+
+private:
+  struct Box
+  {
+    Box() = default;
+    explicit Box(m2::RectD const & r)
+      : m_minX(r.minX()), m_minY(r.minY()), m_maxX(r.maxX()), m_maxY(r.maxY())
+    {
+    }
+
+    /// The same as m4::Tree intersection.
+    bool IsIntersect(m2::RectD const & r) const
+    {
+      return !((m_maxX <= r.minX()) || (m_minX >= r.maxX()) ||
+               (m_maxY <= r.minY()) || (m_minY >= r.maxY()));
+    }
+
+    void Add(Box const & b)
+    {
+      m_minX = min(m_minX, b.m_minX);
+      m_minY = min(m_minY, b.m_minY);
+      m_maxX = max(m_maxX, b.m_maxX);
+      m_maxY = max(m_maxY, b.m_maxY);
+    }
+
+    double CenterX() const { return m_minX + m_maxX; }
+    double CenterY() const { return m_minY + m_maxY; }
+
+    double m_minX, m_minY, m_maxX, m_maxY;
+  };
+
+  struct Value
+  {
+    Value(T const & val, m2::RectD const & r) : m_box(r), m_val(val) {}
+
+    Box m_box;
+    T m_val;
+  };
+
+  struct Node
+  {
+    Box m_box;
+    uint32_t m_first;
+    uint32_t m_count;
+    bool m_isLeaf;
+  };
+
+  /// Sorts the items by x, splits them into vertical slices and sorts the slices by y,
+  /// so each kNodeCapacity items in a row are close to each other.
+  template <class IterT>
+  static void SortTiles(IterT first, IterT last)
+  {
+    typedef typename iterator_traits<IterT>::value_type ItemT;
+    size_t const count = distance(first, last);
+    size_t const parentsCount = (count + kNodeCapacity - 1) / kNodeCapacity;
+    size_t const slicesCount = static_cast<size_t>(ceil(sqrt(static_cast<double>(parentsCount))));
+    size_t const sliceSize = slicesCount * kNodeCapacity;
+
+    sort(first, last, [](ItemT const & a, ItemT const & b)
+    {
+      return a.m_box.CenterX() < b.m_box.CenterX();
+    });
+    for (size_t i = 0; i < count; i += sliceSize)
+    {
+      sort(first + i, first + min(i + sliceSize, count), [](ItemT const & a, ItemT const & b)
+      {
+        return a.m_box.CenterY() < b.m_box.CenterY();
+      });
+    }
+  }
+
+  /// Adds the nodes for each kNodeCapacity items from begin of the children.
+  template <class ItemsT>
+  void MakeParents(ItemsT const & children, size_t begin, bool isLeaf)
+  {
+    // Children may be m_nodes, so they are accessed by the indices only.
+    size_t const end = children.size();
+    for (size_t i = begin; i < end; i += kNodeCapacity)
+    {
+      Node node;
+      node.m_box = children[i].m_box;
+      node.m_first = static_cast<uint32_t>(i);
+      node.m_count = static_cast<uint32_t>(min(kNodeCapacity, end - i));
+      node.m_isLeaf = isLeaf;
+      for (size_t j = i + 1; j < i + node.m_count; ++j)
+        node.m_box.Add(children[j].m_box);
+      m_nodes.push_back(node);
+    }
+  }
+
+  Traits m_traits;
+  vector<Value> m_values;
+  /// Levels from the leaves to the root, the root is the last one.
+  vector<Node> m_nodes;
+  bool m_isBuilt;
+};
+
+template <class T, typename Traits>
+size_t const StaticTree<T, Traits>::kNodeCapacity;
+}  // namespace m4
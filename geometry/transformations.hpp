@@ -53,4 +53,22 @@ namespace math
   {
     return Scale(m, pt.x, pt.y);
   }
+
+  /// Writes p * m for each point p of [begin, end) to out.
+  /// Coefficients are copied to locals, so they aren't reloaded after each point is
+  /// stored through the output iterator, and the loop can be vectorized.
+  template <typename T, typename TInIter, typename TOutIter>
+  TOutIter TransformPoints(Matrix<T, 3, 3> const & m, TInIter begin, TInIter end, TOutIter out)
+  {
+    T const m00 = m(0, 0), m01 = m(0, 1);
+    T const m10 = m(1, 0), m11 = m(1, 1);
+    T const m20 = m(2, 0), m21 = m(2, 1);
+    for (; begin != end; ++begin, ++out)
+    {
+      T const x = begin->x;
+      T const y = begin->y;
+      *out = m2::Point<T>(x * m00 + y * m10 + m20, x * m01 + y * m11 + m21);
+    }
+    return out;
+  }
 }
@@ -245,6 +245,9 @@ namespace m4
 
     void Clear() { m_tree.clear(); }
 
+    /// Rebalances the tree, it's worth to be called after a lot of Add() calls.
+    void Optimize() { m_tree.optimize(); }
+
     string DebugPrint() const
     {
       ostringstream out;
@@ -15,5 +15,6 @@ win32*: LIBS *= -lopengl32
 
 SOURCES += \
     ../../testing/testingmain.cpp \
+    overlay_test.cpp \
     screenglglobal_test.cpp \
     shape_renderer_test.cpp \
@@ -0,0 +1,107 @@
+#include "testing/testing.hpp"
+
+#include "graphics/overlay.hpp"
+#include "graphics/overlay_element.hpp"
+
+#include "geometry/transformations.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/shared_ptr.hpp"
+
+using namespace graphics;
+
+namespace
+{
+  /// Square of the 10 pixels size centered at the transformed pivot.
+  class TestElement : public OverlayElement
+  {
+    m2::PointD m_initPivot;
+
+  public:
+    TestElement(m2::PointD const & pivot, double depth)
+      : OverlayElement(MakeParams(pivot, depth)), m_initPivot(pivot)
+    {
+    }
+
+    m2::RectD GetBoundRect() const override
+    {
+      return m2::RectD(pivot() - m2::PointD(5, 5), pivot() + m2::PointD(5, 5));
+    }
+
+    void draw(OverlayRenderer *, math::Matrix<double, 3, 3> const &) const override {}
+
+    void setTransformation(math::Matrix<double, 3, 3> const & m) override
+    {
+      setPivot(m_initPivot * m);
+      OverlayElement::setTransformation(m);
+    }
+
+  private:
+    static Params MakeParams(m2::PointD const & pivot, double depth)
+    {
+      Params p;
+      p.m_pivot = pivot;
+      p.m_depth = depth;
+      return p;
+    }
+  };
+
+  math::Matrix<double, 3, 3> Shift(double dx, double dy)
+  {
+    return math::Shift(math::Identity<double, 3>(), dx, dy);
+  }
+
+  vector<m2::PointD> GetPivots(Overlay & overlay)
+  {
+    vector<m2::PointD> pivots;
+    overlay.forEach([&pivots](shared_ptr<OverlayElement> const & e)
+    {
+      pivots.push_back(e->pivot());
+    });
+    sort(pivots.begin(), pivots.end());
+    return pivots;
+  }
+}
+
+UNIT_TEST(Overlay_MergeMoveMerge)
+{
+  // The second element is hidden by the first one with the higher priority.
+  shared_ptr<OverlayStorage> tile1 = make_shared<OverlayStorage>();
+  tile1->AddElement(make_shared<TestElement>(m2::PointD(0, 0), 2));
+  tile1->AddElement(make_shared<TestElement>(m2::PointD(4, 0), 1));
+  tile1->AddElement(make_shared<TestElement>(m2::PointD(50, 0), 1));
+
+  shared_ptr<OverlayStorage> tile2 = make_shared<OverlayStorage>();
+  tile2->AddElement(make_shared<TestElement>(m2::PointD(0, 100), 1));
+
+  Overlay overlay;
+  overlay.merge(tile1, Shift(0, 0));
+  vector<m2::PointD> expected = { m2::PointD(0, 0), m2::PointD(50, 0) };
+  TEST_EQUAL(GetPivots(overlay), expected, ());
+
+  // Moved elements keep the merge result, the hidden element stays hidden.
+  Overlay::LayersT layers;
+  layers.emplace_back(tile1, Shift(10, 20));
+  overlay.move(layers);
+  expected = { m2::PointD(10, 20), m2::PointD(60, 20) };
+  TEST_EQUAL(GetPivots(overlay), expected, ());
+
+  // The next tile is merged on top of the moved elements.
+  overlay.merge(tile2, Shift(10, 20));
+  expected = { m2::PointD(10, 20), m2::PointD(10, 120), m2::PointD(60, 20) };
+  TEST_EQUAL(GetPivots(overlay), expected, ());
+
+  // Both tiles are moved back.
+  layers.emplace_back(tile2, Shift(10, 20));
+  for (auto & layer : layers)
+    layer.second = Shift(0, 0);
+  overlay.move(layers);
+  expected = { m2::PointD(0, 0), m2::PointD(0, 100), m2::PointD(50, 0) };
+  TEST_EQUAL(GetPivots(overlay), expected, ());
+
+  // Merging from scratch gives the same result.
+  Overlay scratch;
+  scratch.merge(tile1, Shift(0, 0));
+  scratch.merge(tile2, Shift(0, 0));
+  TEST_EQUAL(GetPivots(scratch), expected, ());
+}
@@ -5,6 +5,7 @@
 #include "base/stl_add.hpp"
 
 #include "std/bind.hpp"
+#include "std/unordered_set.hpp"
 #include "std/vector.hpp"
 
 
@@ -230,6 +231,29 @@ void Overlay::merge(shared_ptr<OverlayStorage> const & infoLayer)
   });
 }
 
+void Overlay::move(LayersT const & layers)
+{
+  unordered_set<OverlayElement const *> merged;
+  m_tree.ForEach([&merged](shared_ptr<OverlayElement> const & e)
+  {
+    merged.insert(e.get());
+  });
+  m_tree.Clear();
+
+  for (auto const & layer : layers)
+  {
+    layer.first->ForEach([&](shared_ptr<OverlayElement> const & e)
+    {
+      if (merged.erase(e.get()) == 0)
+        return;
+
+      e->setTransformation(layer.second);
+      if (e->isValid())
+        m_tree.Add(e);
+    });
+  }
+}
+
 void Overlay::clip(m2::RectI const & r)
 {
   vector<shared_ptr<OverlayElement> > v;
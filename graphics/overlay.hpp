@@ -11,6 +11,8 @@
 
 #include "std/list.hpp"
 #include "std/shared_ptr.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
 
 
 namespace graphics
@@ -72,6 +74,11 @@ namespace graphics
     void merge(shared_ptr<OverlayStorage> const & infoLayer, math::Matrix<double, 3, 3> const & m);
     void merge(shared_ptr<OverlayStorage> const & infoLayer);
 
+    typedef vector<pair<shared_ptr<OverlayStorage>, math::Matrix<double, 3, 3> > > LayersT;
+    /// Transforms the elements, which were merged from the layers before, by the new layer matrices.
+    /// Elements aren't sorted and collisions aren't checked, so the hidden elements stay hidden.
+    void move(LayersT const & layers);
+
     void clip(m2::RectI const & r);
 
     template <typename Fn>
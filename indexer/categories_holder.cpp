@@ -9,6 +9,8 @@
 #include "base/logging.hpp"
 #include "base/stl_add.hpp"
 
+#include "std/algorithm.hpp"
+
 
 namespace
 {
@@ -29,7 +31,8 @@ CategoriesHolder::CategoriesHolder(Reader * reader)
   LoadFromStream(s);
 }
 
-void CategoriesHolder::AddCategory(Category & cat, vector<uint32_t> & types)
+void CategoriesHolder::AddCategory(Category & cat, vector<uint32_t> & types,
+                                   TokenTypesT & tokenTypes)
 {
   if (!cat.m_synonyms.empty() && !types.empty())
   {
@@ -51,7 +54,7 @@ void CategoriesHolder::AddCategory(Category & cat, vector<uint32_t> & types)
       for (size_t j = 0; j < tokens.size(); ++j)
         for (size_t k = 0; k < types.size(); ++k)
           if (ValidKeyToken(tokens[j]))
-            m_name2type.insert(make_pair(make_pair(p->m_synonyms[i].m_locale, tokens[j]), types[k]));
+            tokenTypes.push_back(make_pair(make_pair(p->m_synonyms[i].m_locale, tokens[j]), types[k]));
     }
   }
 
@@ -59,6 +62,57 @@ void CategoriesHolder::AddCategory(Category & cat, vector<uint32_t> & types)
   types.clear();
 }
 
+void CategoriesHolder::BuildNameIndex(TokenTypesT & tokenTypes)
+{
+  sort(tokenTypes.begin(), tokenTypes.end());
+  tokenTypes.erase(unique(tokenTypes.begin(), tokenTypes.end()), tokenTypes.end());
+
+  m_tokens.clear();
+  m_name2type.clear();
+  m_name2type.reserve(tokenTypes.size());
+
+  // The same token in different locales is stored once.
+  map<StringT, uint32_t> offsets;
+  for (auto const & tokenType : tokenTypes)
+  {
+    StringT const & token = tokenType.first.second;
+    auto const res = offsets.insert(make_pair(token, static_cast<uint32_t>(m_tokens.size())));
+    if (res.second)
+      m_tokens.insert(m_tokens.end(), token.begin(), token.end());
+
+    uint32_t const begin = res.first->second;
+    m_name2type.push_back({begin, static_cast<uint32_t>(begin + token.size()), tokenType.second,
+                           tokenType.first.first});
+  }
+
+  Name2CatContT(m_name2type).swap(m_name2type);
+  vector<strings::UniChar>(m_tokens).swap(m_tokens);
+}
+
+pair<CategoriesHolder::Name2CatContT::const_iterator, CategoriesHolder::Name2CatContT::const_iterator>
+CategoriesHolder::GetTypesByName(int8_t locale, StringT const & name) const
+{
+  // Types of a token are after each other, as m_name2type is sorted by the token first.
+  auto const less = [this](TokenType const & tt, pair<int8_t, StringT const *> const & key)
+  {
+    if (tt.m_locale != key.first)
+      return tt.m_locale < key.first;
+    return lexicographical_compare(m_tokens.begin() + tt.m_begin, m_tokens.begin() + tt.m_end,
+                                   key.second->begin(), key.second->end());
+  };
+  auto const greater = [this](pair<int8_t, StringT const *> const & key, TokenType const & tt)
+  {
+    if (tt.m_locale != key.first)
+      return key.first < tt.m_locale;
+    return lexicographical_compare(key.second->begin(), key.second->end(),
+                                   m_tokens.begin() + tt.m_begin, m_tokens.begin() + tt.m_end);
+  };
+
+  auto const key = make_pair(locale, &name);
+  auto const first = lower_bound(m_name2type.begin(), m_name2type.end(), key, less);
+  return make_pair(first, upper_bound(first, m_name2type.end(), key, greater));
+}
+
 bool CategoriesHolder::ValidKeyToken(StringT const & s)
 {
   if (s.size() > 2)
@@ -75,8 +129,8 @@ bool CategoriesHolder::ValidKeyToken(StringT const & s)
 void CategoriesHolder::LoadFromStream(istream & s)
 {
   m_type2cat.clear();
-  m_name2type.clear();
 
+  TokenTypesT tokenTypes;
   State state = EParseTypes;
   string line;
 
@@ -96,7 +150,7 @@ void CategoriesHolder::LoadFromStream(istream & s)
     {
     case EParseTypes:
       {
-        AddCategory(cat, types);
+        AddCategory(cat, types, tokenTypes);
 
         while (iter)
         {
@@ -172,7 +226,9 @@ void CategoriesHolder::LoadFromStream(istream & s)
   }
 
   // add last category
-  AddCategory(cat, types);
+  AddCategory(cat, types, tokenTypes);
+
+  BuildNameIndex(tokenTypes);
 }
 
 bool CategoriesHolder::GetNameByType(uint32_t type, int8_t locale, string & name) const
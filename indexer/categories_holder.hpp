@@ -37,10 +37,22 @@ public:
 private:
   typedef strings::UniString StringT;
   typedef multimap<uint32_t, shared_ptr<Category> > Type2CategoryContT;
-  typedef multimap<pair<int8_t, StringT>, uint32_t> Name2CatContT;
   typedef Type2CategoryContT::const_iterator IteratorT;
 
+  /// Type of a name token in a locale. The token is m_tokens[m_begin, m_end).
+  struct TokenType
+  {
+    uint32_t m_begin;
+    uint32_t m_end;
+    uint32_t m_type;
+    int8_t m_locale;
+  };
+  typedef vector<TokenType> Name2CatContT;
+
   Type2CategoryContT m_type2cat;
+  /// Characters of all the distinct tokens, one after another.
+  vector<strings::UniChar> m_tokens;
+  /// Sorted by locale, token and type, without duplicates.
   Name2CatContT m_name2type;
 
 public:
@@ -68,12 +80,11 @@ public:
   template <class ToDo>
   void ForEachTypeByName(int8_t locale, StringT const & name, ToDo toDo) const
   {
-    typedef typename Name2CatContT::const_iterator IterT;
-
-    pair<IterT, IterT> range = m_name2type.equal_range(make_pair(locale, name));
+    pair<Name2CatContT::const_iterator, Name2CatContT::const_iterator> range =
+        GetTypesByName(locale, name);
     while (range.first != range.second)
     {
-      toDo(range.first->second);
+      toDo(range.first->m_type);
       ++range.first;
     }
   }
@@ -88,6 +99,7 @@ public:
   inline void Swap(CategoriesHolder & r)
   {
     m_type2cat.swap(r.m_type2cat);
+    m_tokens.swap(r.m_tokens);
     m_name2type.swap(r.m_name2type);
   }
 
@@ -96,7 +108,13 @@ public:
   static int8_t const UNSUPPORTED_LOCALE_CODE = -1;
 
 private:
-  void AddCategory(Category & cat, vector<uint32_t> & types);
+  typedef vector<pair<pair<int8_t, StringT>, uint32_t> > TokenTypesT;
+
+  void AddCategory(Category & cat, vector<uint32_t> & types, TokenTypesT & tokenTypes);
+  /// Packs the tokens to m_tokens and m_name2type.
+  void BuildNameIndex(TokenTypesT & tokenTypes);
+  pair<Name2CatContT::const_iterator, Name2CatContT::const_iterator> GetTypesByName(
+      int8_t locale, StringT const & name) const;
   static bool ValidKeyToken(StringT const & s);
 };
 
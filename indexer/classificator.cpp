@@ -1,4 +1,5 @@
 #include "indexer/classificator.hpp"
+#include "indexer/feature_visibility.hpp"
 #include "indexer/tree_structure.hpp"
 
 #include "base/macros.hpp"
@@ -413,6 +414,7 @@ void Classificator::Clear()
 {
   ClassifObject("world").Swap(m_root);
   m_mapping.Clear();
+  feature::ClearCompiledDrawRules();
 }
 
 string Classificator::GetReadableObjectName(uint32_t type) const
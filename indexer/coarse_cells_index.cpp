@@ -0,0 +1,148 @@
+#include "indexer/coarse_cells_index.hpp"
+
+#include "indexer/feature_covering.hpp"
+#include "indexer/scale_index.hpp"
+
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+
+namespace covering
+{
+// static
+uint32_t const CoarseCellsIndex::kVersion;
+// static
+int const CoarseCellsIndex::kLevel;
+// static
+uint32_t const CoarseCellsIndex::kMaxScale;
+// static
+uint32_t const CoarseCellsIndex::kCellsPerSide;
+
+// static
+void CoarseCellsIndex::Build(ScaleIndex<ModelReaderPtr> const & index, int lastScale,
+                             Writer & writer)
+{
+  int const cellDepth = GetCodingDepth(lastScale);
+  CHECK_LESS(kLevel, cellDepth, ());
+  uint32_t const bucketsCount = min(kMaxScale, static_cast<uint32_t>(lastScale)) + 1;
+
+  vector<uint32_t> offsets;
+  vector<uint32_t> features;
+  offsets.reserve(kCellsPerSide * kCellsPerSide * bucketsCount + 1);
+  offsets.push_back(0);
+
+  vector<uint32_t> cellFeatures;
+  for (uint32_t y = 0; y < kCellsPerSide; ++y)
+  {
+    for (uint32_t x = 0; x < kCellsPerSide; ++x)
+    {
+      int const shift = RectId::DEPTH_LEVELS - kLevel;
+      RectId const id = RectId::FromXY(x << shift, y << shift, kLevel);
+      IntervalsT intervals;
+      AppendLowerLevels(id, cellDepth, intervals);
+      intervals = SortAndMergeIntervals(intervals);
+
+      for (uint32_t bucket = 0; bucket < bucketsCount; ++bucket)
+      {
+        cellFeatures.clear();
+        for (auto const & i : intervals)
+        {
+          index.ForEachInIntervalAndBucket([&cellFeatures](uint32_t feature)
+          {
+            cellFeatures.push_back(feature);
+          }, i.first, i.second, bucket);
+        }
+        sort(cellFeatures.begin(), cellFeatures.end());
+        cellFeatures.erase(unique(cellFeatures.begin(), cellFeatures.end()), cellFeatures.end());
+
+        features.insert(features.end(), cellFeatures.begin(), cellFeatures.end());
+        offsets.push_back(static_cast<uint32_t>(features.size()));
+      }
+    }
+  }
+
+  WriteToSink(writer, kVersion);
+  WriteToSink(writer, bucketsCount);
+  WriteToSink(writer, static_cast<uint32_t>(features.size()));
+  for (uint32_t const offset : offsets)
+    WriteToSink(writer, offset);
+  for (uint32_t const feature : features)
+    WriteToSink(writer, feature);
+  LOG(LINFO, ("Coarse cells index of", features.size(), "features in", bucketsCount, "buckets."));
+}
+
+void CoarseCellsIndex::Clear()
+{
+  m_bucketsCount = 0;
+  m_offsets.clear();
+  m_features.clear();
+}
+
+// static
+void CoarseCellsIndex::GetCellsRange(m2::RectD const & rect, uint32_t & minX, uint32_t & minY,
+                                     uint32_t & maxX, uint32_t & maxY)
+{
+  using TConverter = CellIdConverter<MercatorBounds, RectId>;
+  auto const toCell = [](double v)
+  {
+    double const maxCoord = RectId::MAX_COORD - 1;
+    return static_cast<uint32_t>(my::clamp(v, 0.0, maxCoord)) >> (RectId::DEPTH_LEVELS - kLevel);
+  };
+  minX = toCell(TConverter::XToCellIdX(rect.minX()));
+  minY = toCell(TConverter::YToCellIdY(rect.minY()));
+  maxX = toCell(TConverter::XToCellIdX(rect.maxX()));
+  maxY = toCell(TConverter::YToCellIdY(rect.maxY()));
+}
+
+bool CoarseCellsIndex::Deserialize(MemReader const & reader)
+{
+  Clear();
+
+  uint64_t const kHeaderSize = 3 * sizeof(uint32_t);
+  if (reader.Size() < kHeaderSize)
+  {
+    LOG(LWARNING, ("Malformed coarse cells index header."));
+    return false;
+  }
+
+  ReaderSource<MemReader> src(reader);
+  uint32_t const version = ReadPrimitiveFromSource<uint32_t>(src);
+  if (version != kVersion)
+  {
+    LOG(LWARNING, ("Unknown coarse cells index version:", version));
+    return false;
+  }
+
+  uint32_t const bucketsCount = ReadPrimitiveFromSource<uint32_t>(src);
+  uint32_t const featuresCount = ReadPrimitiveFromSource<uint32_t>(src);
+  uint64_t const listsCount = uint64_t(kCellsPerSide) * kCellsPerSide * bucketsCount;
+  if (bucketsCount == 0 || bucketsCount > kMaxScale + 1 ||
+      reader.Size() != kHeaderSize + (listsCount + 1 + featuresCount) * sizeof(uint32_t))
+  {
+    LOG(LWARNING, ("Malformed coarse cells index header."));
+    return false;
+  }
+
+  m_offsets.resize(listsCount + 1);
+  for (uint32_t & offset : m_offsets)
+    offset = ReadPrimitiveFromSource<uint32_t>(src);
+  m_features.resize(featuresCount);
+  for (uint32_t & feature : m_features)
+    feature = ReadPrimitiveFromSource<uint32_t>(src);
+
+  if (m_offsets.front() != 0 || m_offsets.back() != featuresCount ||
+      !is_sorted(m_offsets.begin(), m_offsets.end()))
+  {
+    LOG(LWARNING, ("Malformed coarse cells index."));
+    Clear();
+    return false;
+  }
+
+  m_bucketsCount = bucketsCount;
+  return true;
+}
+}  // namespace covering
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "indexer/cell_id.hpp"
+
+#include "coding/reader.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+class ModelReaderPtr;
+class Writer;
+template <class ReaderT> class ScaleIndex;
+
+namespace covering
+{
+/// Features of the coarse cells of the world mwms for the low scales, where the viewport covering
+/// gives a lot of intervals of the scale index. The world is a grid of 2^kLevel x 2^kLevel cells,
+/// and the features of each cell and bucket of the scale index are stored as a sorted list, so
+/// the low scale viewport is read by a few lists instead of the interval index walks.
+/// Features of the cell are the ones which are found for the cell by the viewport covering, so
+/// the features of the cells which intersect the viewport include the ones of the viewport.
+class CoarseCellsIndex
+{
+public:
+  static uint32_t const kVersion = 0;
+  static int const kLevel = 6;
+  /// Index has the buckets up to this scale.
+  static uint32_t const kMaxScale = 6;
+
+  /// Builds the index by the scale index of the mwm.
+  /// @param lastScale Last scale of the mwm, it's used for the covering like in Index.
+  static void Build(ScaleIndex<ModelReaderPtr> const & index, int lastScale, Writer & writer);
+
+  /// @return False when the data are malformed or of an unknown version.
+  template <typename TReader>
+  bool Load(TReader const & reader)
+  {
+    vector<char> data(static_cast<size_t>(reader.Size()));
+    reader.Read(0, data.data(), data.size());
+    return Deserialize(MemReader(data.data(), data.size()));
+  }
+  void Clear();
+
+  inline bool IsEmpty() const { return m_offsets.empty(); }
+  /// @return The last scale which the index can be used for.
+  inline uint32_t GetMaxScale() const { return m_bucketsCount - 1; }
+
+  /// Calls toDo(featureIndex) for the features of the buckets up to scale of the cells which
+  /// intersect the rect. Features of the neighbouring cells may be repeated.
+  template <typename ToDo>
+  void ForEachInRect(m2::RectD const & rect, uint32_t scale, ToDo && toDo) const
+  {
+    ASSERT_LESS_OR_EQUAL(scale, GetMaxScale(), ());
+    uint32_t minX, minY, maxX, maxY;
+    GetCellsRange(rect, minX, minY, maxX, maxY);
+    for (uint32_t y = minY; y <= maxY; ++y)
+    {
+      for (uint32_t x = minX; x <= maxX; ++x)
+      {
+        for (uint32_t bucket = 0; bucket <= scale; ++bucket)
+        {
+          size_t const list = GetListIndex(x, y, bucket);
+          for (uint32_t i = m_offsets[list]; i < m_offsets[list + 1]; ++i)
+            toDo(m_features[i]);
+        }
+      }
+    }
+  }
+
+private:
+  static uint32_t const kCellsPerSide = 1 << kLevel;
+
+  static void GetCellsRange(m2::RectD const & rect, uint32_t & minX, uint32_t & minY,
+                            uint32_t & maxX, uint32_t & maxY);
+
+  inline size_t GetListIndex(uint32_t x, uint32_t y, uint32_t bucket) const
+  {
+    return (static_cast<size_t>(y) * kCellsPerSide + x) * m_bucketsCount + bucket;
+  }
+
+  bool Deserialize(MemReader const & reader);
+
+  uint32_t m_bucketsCount = 0;
+  // Features of the list i are m_features[m_offsets[i], m_offsets[i + 1]).
+  vector<uint32_t> m_offsets;
+  vector<uint32_t> m_features;
+};
+}  // namespace covering
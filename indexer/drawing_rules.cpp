@@ -1,6 +1,7 @@
 #include "indexer/drawing_rules.hpp"
 #include "indexer/classificator.hpp"
 #include "indexer/drules_include.hpp"
+#include "indexer/feature_visibility.hpp"
 #include "indexer/map_style_reader.hpp"
 #include "indexer/scales.hpp"
 
@@ -119,7 +120,9 @@ void BaseRule::SetSelector(unique_ptr<ISelector> && selector)
 RulesHolder::RulesHolder()
   : m_bgColors(scales::UPPER_STYLE_SCALE+1, DEFAULT_BG_COLOR)
   , m_cityRankTable(GetConstRankCityRankTable())
-{}
+{
+  m_rulesByScale.fill(nullptr);
+}
 
 RulesHolder::~RulesHolder()
 {
@@ -137,6 +140,7 @@ void RulesHolder::Clean()
   }
 
   m_rules.clear();
+  m_rulesByScale.fill(nullptr);
 }
 
 Key RulesHolder::AddRule(int scale, rule_type_t type, BaseRule * p)
@@ -146,7 +150,10 @@ Key RulesHolder::AddRule(int scale, rule_type_t type, BaseRule * p)
 
   m_container[type].push_back(p);
 
-  vector<uint32_t> & v = m_rules[scale][type];
+  auto & scaleRules = m_rules[scale];
+  m_rulesByScale[scale] = &scaleRules;
+
+  vector<uint32_t> & v = scaleRules[type];
   v.push_back(static_cast<uint32_t>(m_container[type].size()-1));
 
   int const ret = static_cast<int>(v.size() - 1);
@@ -157,10 +164,13 @@ Key RulesHolder::AddRule(int scale, rule_type_t type, BaseRule * p)
 
 BaseRule const * RulesHolder::Find(Key const & k) const
 {
-  rules_map_t::const_iterator i = m_rules.find(k.m_scale);
-  if (i == m_rules.end()) return 0;
+  if (k.m_scale < 0 || k.m_scale >= static_cast<int>(m_rulesByScale.size()))
+    return 0;
+  auto const * scaleRules = m_rulesByScale[k.m_scale];
+  if (scaleRules == nullptr)
+    return 0;
 
-  vector<uint32_t> const & v = (i->second)[k.m_type];
+  vector<uint32_t> const & v = (*scaleRules)[k.m_type];
 
   ASSERT ( k.m_index >= 0, (k.m_index) );
   if (static_cast<size_t>(k.m_index) < v.size())
@@ -208,14 +218,14 @@ namespace
     {
       LineDefProto m_line;
     public:
-      Line(LineRuleProto const & r)
+      Line(LineRuleProto & r)
       {
         m_line.set_color(r.color());
         m_line.set_width(r.width());
         if (r.has_dashdot())
-          *(m_line.mutable_dashdot()) = r.dashdot();
+          m_line.mutable_dashdot()->Swap(r.mutable_dashdot());
         if (r.has_pathsym())
-          *(m_line.mutable_pathsym()) = r.pathsym();
+          m_line.mutable_pathsym()->Swap(r.mutable_pathsym());
         if (r.has_join())
           m_line.set_join(r.join());
         if (r.has_cap())
@@ -229,7 +239,7 @@ namespace
     {
       AreaRuleProto m_area;
     public:
-      Area(AreaRuleProto const & r) : m_area(r) {}
+      Area(AreaRuleProto & r) { m_area.Swap(&r); }
 
       virtual AreaRuleProto const * GetArea() const { return &m_area; }
     };
@@ -238,10 +248,11 @@ namespace
     {
       SymbolRuleProto m_symbol;
     public:
-      Symbol(SymbolRuleProto const & r) : m_symbol(r)
+      Symbol(SymbolRuleProto & r)
       {
-        if (r.has_apply_for_type())
-          SetType(r.apply_for_type());
+        m_symbol.Swap(&r);
+        if (m_symbol.has_apply_for_type())
+          SetType(m_symbol.apply_for_type());
       }
 
       virtual SymbolRuleProto const * GetSymbol() const { return &m_symbol; }
@@ -255,10 +266,11 @@ namespace
       text_type_t m_textTypeSecondary;
 
     public:
-      CaptionT(T const & r) : m_caption(r)
-        , m_textTypePrimary(text_type_name)
+      CaptionT(T & r)
+        : m_textTypePrimary(text_type_name)
         , m_textTypeSecondary(text_type_name)
       {
+        m_caption.Swap(&r);
         if (m_caption.primary().has_text())
           m_textTypePrimary = GetTextType(m_caption.primary().text());
 
@@ -299,7 +311,7 @@ namespace
     {
       CircleRuleProto m_circle;
     public:
-      Circle(CircleRuleProto const & r) : m_circle(r) {}
+      Circle(CircleRuleProto & r) { m_circle.Swap(&r); }
 
       virtual CircleRuleProto const * GetCircle() const { return &m_circle; }
     };
@@ -308,7 +320,7 @@ namespace
     {
       ShieldRuleProto m_shield;
     public:
-      Shield(ShieldRuleProto const & r) : m_shield(r) {}
+      Shield(ShieldRuleProto & r) { m_shield.Swap(&r); }
 
       virtual ShieldRuleProto const * GetShield() const { return &m_shield; }
     };
@@ -379,8 +391,9 @@ namespace
 
     RulesHolder & m_holder;
 
+    /// Rule's proto is moved out of the container, the container isn't used after the loading.
     template <class TRule, class TProtoRule>
-    void AddRule(ClassifObject * p, int scale, rule_type_t type, TProtoRule const & rule,
+    void AddRule(ClassifObject * p, int scale, rule_type_t type, TProtoRule & rule,
                  vector<string> const & apply_if)
     {
       unique_ptr<ISelector> selector;
@@ -394,11 +407,12 @@ namespace
         }
       }
 
+      int const priority = rule.priority();
       BaseRule * obj = new TRule(rule);
       obj->SetSelector(move(selector));
       Key k = m_holder.AddRule(scale, type, obj);
       p->SetVisibilityOnScale(true, scale);
-      k.SetPriority(rule.priority());
+      k.SetPriority(priority);
       p->AddDrawRule(k);
     }
 
@@ -423,35 +437,35 @@ namespace
       {
         vector<string> apply_if;
 
-        ClassifElementProto const & ce = m_cont.cont(i);
+        ClassifElementProto & ce = *m_cont.mutable_cont(i);
         for (int j = 0; j < ce.element_size(); ++j)
         {
-          DrawElementProto const & de = ce.element(j);
+          DrawElementProto & de = *ce.mutable_element(j);
 
           using namespace proto_rules;
 
           DrawElementGetApplyIf(de, apply_if);
 
           for (int k = 0; k < de.lines_size(); ++k)
-            AddRule<Line>(p, de.scale(), line, de.lines(k), apply_if);
+            AddRule<Line>(p, de.scale(), line, *de.mutable_lines(k), apply_if);
 
           if (de.has_area())
-            AddRule<Area>(p, de.scale(), area, de.area(), apply_if);
+            AddRule<Area>(p, de.scale(), area, *de.mutable_area(), apply_if);
 
           if (de.has_symbol())
-            AddRule<Symbol>(p, de.scale(), symbol, de.symbol(), apply_if);
+            AddRule<Symbol>(p, de.scale(), symbol, *de.mutable_symbol(), apply_if);
 
           if (de.has_caption())
-            AddRule<Caption>(p, de.scale(), caption, de.caption(), apply_if);
+            AddRule<Caption>(p, de.scale(), caption, *de.mutable_caption(), apply_if);
 
           if (de.has_circle())
-            AddRule<Circle>(p, de.scale(), circle, de.circle(), apply_if);
+            AddRule<Circle>(p, de.scale(), circle, *de.mutable_circle(), apply_if);
 
           if (de.has_path_text())
-            AddRule<PathText>(p, de.scale(), pathtext, de.path_text(), apply_if);
+            AddRule<PathText>(p, de.scale(), pathtext, *de.mutable_path_text(), apply_if);
 
           if (de.has_shield())
-            AddRule<Shield>(p, de.scale(), shield, de.shield(), apply_if);
+            AddRule<Shield>(p, de.scale(), shield, *de.mutable_shield(), apply_if);
         }
       }
 
@@ -521,9 +535,11 @@ void RulesHolder::LoadFromBinaryProto(string const & s)
 
   CHECK ( doSet.m_cont.ParseFromString(s), ("Error in proto loading!") );
 
-  classif().GetMutableRoot()->ForEachObject(ref(doSet));
-
+  // Background colors are taken before the rules are moved out of the container.
   InitBackgroundColors(doSet.m_cont);
+
+  classif().GetMutableRoot()->ForEachObject(ref(doSet));
+  feature::CompileDrawRules();
 }
 
 void RulesHolder::LoadCityRankTableFromString(string & s)
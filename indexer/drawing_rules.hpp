@@ -3,6 +3,7 @@
 #include "indexer/drawing_rule_def.hpp"
 #include "indexer/drules_city_rank_table.hpp"
 #include "indexer/drules_selector.hpp"
+#include "indexer/scales.hpp"
 
 #include "base/base.hpp"
 #include "base/buffer_vector.hpp"
@@ -76,6 +77,8 @@ namespace drule
     /// scale -> array of rules by type -> index of rule in m_container
     typedef map<int32_t, array<vector<uint32_t>, count_of_rules> > rules_map_t;
     rules_map_t m_rules;
+    /// scale -> rules of m_rules, so Find doesn't look up the map.
+    array<rules_map_t::mapped_type const *, scales::UPPER_STYLE_SCALE + 1> m_rulesByScale;
 
     /// background color for scales in range [0...scales::UPPER_STYLE_SCALE]
     vector<uint32_t> m_bgColors;
@@ -23,27 +23,27 @@ void FeatureBase::Deserialize(feature::LoaderBase * pLoader, TBuffer buffer)
   m_pLoader->Init(buffer);
 
   m_limitRect = m2::RectD::GetEmptyRect();
-  m_bTypesParsed = m_bCommonParsed = false;
+  m_parsed = 0;
   m_header = m_pLoader->GetHeader();
 }
 
 void FeatureBase::ParseTypes() const
 {
-  if (!m_bTypesParsed)
+  if (!IsParsed(FIELD_TYPES))
   {
     m_pLoader->ParseTypes();
-    m_bTypesParsed = true;
+    SetParsed(FIELD_TYPES);
   }
 }
 
 void FeatureBase::ParseCommon() const
 {
-  if (!m_bCommonParsed)
+  if (!IsParsed(FIELD_COMMON))
   {
     ParseTypes();
 
     m_pLoader->ParseCommon();
-    m_bCommonParsed = true;
+    SetParsed(FIELD_COMMON);
   }
 }
 
@@ -59,7 +59,7 @@ feature::EGeomType FeatureBase::GetFeatureType() const
 
 string FeatureBase::DebugString() const
 {
-  ASSERT(m_bCommonParsed, ());
+  ASSERT(IsParsed(FIELD_COMMON), ());
 
   Classificator const & c = classif();
 
@@ -82,19 +82,17 @@ void FeatureType::Deserialize(feature::LoaderBase * pLoader, TBuffer buffer)
 
   m_pLoader->InitFeature(this);
 
-  m_bHeader2Parsed = m_bPointsParsed = m_bTrianglesParsed = m_bMetadataParsed = false;
-
   m_innerStats.MakeZero();
 }
 
 void FeatureType::ParseHeader2() const
 {
-  if (!m_bHeader2Parsed)
+  if (!IsParsed(FIELD_HEADER2))
   {
     ParseCommon();
 
     m_pLoader->ParseHeader2();
-    m_bHeader2Parsed = true;
+    SetParsed(FIELD_HEADER2);
   }
 }
 
@@ -106,7 +104,7 @@ void FeatureType::ResetGeometry() const
   if (GetFeatureType() != GEOM_POINT)
     m_limitRect = m2::RectD();
 
-  m_bHeader2Parsed = m_bPointsParsed = m_bTrianglesParsed = false;
+  ResetParsed(FIELD_HEADER2 | FIELD_GEOMETRY);
 
   m_pLoader->ResetGeometry();
 }
@@ -114,12 +112,17 @@ void FeatureType::ResetGeometry() const
 uint32_t FeatureType::ParseGeometry(int scale) const
 {
   uint32_t sz = 0;
-  if (!m_bPointsParsed)
+  if (!IsParsed(FIELD_POINTS))
   {
-    ParseHeader2();
-
-    sz = m_pLoader->ParseGeometry(scale);
-    m_bPointsParsed = true;
+    // Point features have no geometry sections, the center is in the common part.
+    if (GetFeatureType() == GEOM_POINT)
+      ParseCommon();
+    else
+    {
+      ParseHeader2();
+      sz = m_pLoader->ParseGeometry(scale);
+    }
+    SetParsed(FIELD_POINTS);
   }
   return sz;
 }
@@ -127,26 +130,58 @@ uint32_t FeatureType::ParseGeometry(int scale) const
 uint32_t FeatureType::ParseTriangles(int scale) const
 {
   uint32_t sz = 0;
-  if (!m_bTrianglesParsed)
+  if (!IsParsed(FIELD_TRIANGLES))
   {
-    ParseHeader2();
-
-    sz = m_pLoader->ParseTriangles(scale);
-    m_bTrianglesParsed = true;
+    if (GetFeatureType() == GEOM_AREA)
+    {
+      ParseHeader2();
+      sz = m_pLoader->ParseTriangles(scale);
+    }
+    SetParsed(FIELD_TRIANGLES);
   }
   return sz;
 }
 
 void FeatureType::ParseMetadata() const
 {
-  if (m_bMetadataParsed) return;
+  if (IsParsed(FIELD_METADATA)) return;
 
   m_pLoader->ParseMetadata();
 
   if (HasInternet())
     m_metadata.Add(Metadata::FMD_INTERNET, "wlan");
 
-  m_bMetadataParsed = true;
+  SetParsed(FIELD_METADATA);
+}
+
+string FeatureType::GetMetadataField(Metadata::EType type) const
+{
+  if (IsParsed(FIELD_METADATA))
+    return m_metadata.Get(type);
+
+  string value;
+  (void)m_pLoader->ParseMetadataField(type, value);
+
+  // Keep in sync with ParseMetadata().
+  if (type == Metadata::FMD_INTERNET && HasInternet())
+    value = value.empty() ? "wlan" : value + ", wlan";
+  return value;
+}
+
+void FeatureType::Load(uint8_t fields, int scale) const
+{
+  if (fields & FIELD_TYPES)
+    ParseTypes();
+  if (fields & FIELD_COMMON)
+    ParseCommon();
+  if (fields & FIELD_HEADER2)
+    ParseHeader2();
+  if (fields & FIELD_POINTS)
+    ParseGeometry(scale);
+  if (fields & FIELD_TRIANGLES)
+    ParseTriangles(scale);
+  if (fields & FIELD_METADATA)
+    ParseMetadata();
 }
 
 
@@ -452,12 +487,12 @@ double FeatureType::GetDistance(m2::PointD const & pt, int scale) const
 
 void FeatureType::SwapGeometry(FeatureType & r)
 {
-  ASSERT_EQUAL(m_bPointsParsed, r.m_bPointsParsed, ());
-  ASSERT_EQUAL(m_bTrianglesParsed, r.m_bTrianglesParsed, ());
+  ASSERT_EQUAL(IsParsed(FIELD_POINTS), r.IsParsed(FIELD_POINTS), ());
+  ASSERT_EQUAL(IsParsed(FIELD_TRIANGLES), r.IsParsed(FIELD_TRIANGLES), ());
 
-  if (m_bPointsParsed)
+  if (IsParsed(FIELD_POINTS))
     m_points.swap(r.m_points);
 
-  if (m_bTrianglesParsed)
+  if (IsParsed(FIELD_TRIANGLES))
     m_triangles.swap(r.m_triangles);
 }
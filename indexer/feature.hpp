@@ -21,6 +21,26 @@ namespace old_101 { namespace feature
   class LoaderImpl;
 }}
 
+namespace feature
+{
+  /// Sections of the serialized feature, which are decoded lazily and independently.
+  /// Bits are combined into a mask for FeatureType::Load and FeatureBase::IsParsed.
+  enum FeatureFields : uint8_t
+  {
+    FIELD_TYPES = 1 << 0,
+    /// Names, layer, rank, road and house numbers, center of the point feature.
+    FIELD_COMMON = 1 << 1,
+    /// Inner geometry and offsets of the outer geometry for lines and areas.
+    FIELD_HEADER2 = 1 << 2,
+    FIELD_POINTS = 1 << 3,
+    FIELD_TRIANGLES = 1 << 4,
+    FIELD_METADATA = 1 << 5,
+
+    FIELD_GEOMETRY = FIELD_POINTS | FIELD_TRIANGLES,
+    FIELD_ALL = FIELD_TYPES | FIELD_COMMON | FIELD_HEADER2 | FIELD_GEOMETRY | FIELD_METADATA
+  };
+}
+
 
 /// Base feature class for storing common data (without geometry).
 class FeatureBase
@@ -39,6 +59,9 @@ public:
   void ParseCommon() const;
   //@}
 
+  /// @return true if all sections from feature::FeatureFields mask are already decoded.
+  inline bool IsParsed(uint8_t fields) const { return (m_parsed & fields) == fields; }
+
   feature::EGeomType GetFeatureType() const;
 
   inline uint8_t GetTypesCount() const
@@ -124,6 +147,9 @@ protected:
 
   inline uint8_t Header() const { return m_header; }
 
+  inline void SetParsed(uint8_t fields) const { m_parsed |= fields; }
+  inline void ResetParsed(uint8_t fields) const { m_parsed &= ~fields; }
+
 protected:
   feature::LoaderBase * m_pLoader;
 
@@ -137,7 +163,8 @@ protected:
 
   mutable m2::RectD m_limitRect;
 
-  mutable bool m_bTypesParsed, m_bCommonParsed;
+  /// Mask of already decoded feature::FeatureFields.
+  mutable uint8_t m_parsed;
 
   friend class feature::LoaderCurrent;
   friend class old_101::feature::LoaderImpl;
@@ -165,6 +192,12 @@ public:
   uint32_t ParseTriangles(int scale) const;
 
   void ParseMetadata() const;
+
+  /// Decode only the sections from feature::FeatureFields mask (with their dependencies).
+  /// Geometry sections are decoded for the passed scale.
+  /// Names and the center of point features need FIELD_COMMON only,
+  /// so they never touch the geometry offsets.
+  void Load(uint8_t fields, int scale = BEST_GEOMETRY) const;
   //@}
 
   /// @name Geometry.
@@ -196,13 +229,13 @@ public:
 
   inline size_t GetPointsCount() const
   {
-    ASSERT(m_bPointsParsed, ());
+    ASSERT(IsParsed(feature::FIELD_POINTS), ());
     return m_points.size();
   }
   inline m2::PointD const & GetPoint(size_t i) const
   {
     ASSERT_LESS(i, m_points.size(), ());
-    ASSERT(m_bPointsParsed, ());
+    ASSERT(IsParsed(feature::FIELD_POINTS), ());
     return m_points[i];
   }
 
@@ -266,6 +299,10 @@ public:
   inline feature::Metadata const & GetMetadata() const { return m_metadata; }
   inline feature::Metadata & GetMetadata() { return m_metadata; }
 
+  /// Decodes the only metadata field, it's the same as ParseMetadata() and
+  /// GetMetadata().Get(type), but the other fields aren't decoded.
+  string GetMetadataField(feature::Metadata::EType type) const;
+
   double GetDistance(m2::PointD const & pt, int scale) const;
 
   /// @name Statistic functions.
@@ -307,7 +344,7 @@ public:
 
   inline void SwapPoints(buffer_vector<m2::PointD, 32> & points) const
   {
-    ASSERT(m_bPointsParsed, ());
+    ASSERT(IsParsed(feature::FIELD_POINTS), ());
     return m_points.swap(points);
   }
 
@@ -322,8 +359,6 @@ private:
   mutable points_t m_points, m_triangles;
   mutable feature::Metadata m_metadata;
 
-  mutable bool m_bHeader2Parsed, m_bPointsParsed, m_bTrianglesParsed, m_bMetadataParsed;
-
   mutable inner_geom_stat_t m_innerStats;
 
   friend class feature::LoaderCurrent;
@@ -0,0 +1,142 @@
+#include "indexer/feature_attributes_table.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/endianness.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/logging.hpp"
+
+#include "std/limits.hpp"
+
+namespace feature
+{
+namespace
+{
+template <typename T>
+void WriteColumn(vector<T> const & column, Writer & writer)
+{
+  for (T const v : column)
+    WriteToSink(writer, v);
+}
+
+template <typename T, typename TSource>
+void ReadColumn(TSource & src, vector<T> & column)
+{
+  src.Read(column.data(), column.size() * sizeof(T));
+  for (T & v : column)
+    v = SwapIfBigEndian(v);
+}
+}  // namespace
+
+// static
+uint32_t const AttributesTable::kVersion;
+
+// static
+void AttributesTable::Serialize(vector<Attributes> const & attributes, Writer & writer)
+{
+  vector<uint32_t> centers;
+  vector<uint8_t> ranks;
+  vector<uint32_t> typeOffsets;
+  vector<uint16_t> typeIndices;
+  centers.reserve(attributes.size() * 2);
+  ranks.reserve(attributes.size());
+  typeOffsets.reserve(attributes.size() + 1);
+
+  typeOffsets.push_back(0);
+  for (Attributes const & a : attributes)
+  {
+    m2::PointU const center = PointD2PointU(a.m_center, POINT_COORD_BITS);
+    centers.push_back(center.x);
+    centers.push_back(center.y);
+    ranks.push_back(a.m_rank);
+    for (uint32_t const index : a.m_typeIndices)
+    {
+      CHECK_LESS_OR_EQUAL(index, numeric_limits<uint16_t>::max(), ());
+      typeIndices.push_back(static_cast<uint16_t>(index));
+    }
+    typeOffsets.push_back(static_cast<uint32_t>(typeIndices.size()));
+  }
+
+  WriteToSink(writer, kVersion);
+  WriteToSink(writer, static_cast<uint32_t>(attributes.size()));
+  WriteToSink(writer, static_cast<uint32_t>(typeIndices.size()));
+  WriteColumn(centers, writer);
+  WriteColumn(typeOffsets, writer);
+  WriteColumn(typeIndices, writer);
+  writer.Write(ranks.data(), ranks.size());
+}
+
+bool AttributesTable::Deserialize(MemReader const & reader)
+{
+  Clear();
+
+  uint64_t const kHeaderSize = 3 * sizeof(uint32_t);
+  if (reader.Size() < kHeaderSize)
+  {
+    LOG(LWARNING, ("Malformed feature attributes header."));
+    return false;
+  }
+
+  ReaderSource<MemReader> src(reader);
+  uint32_t const version = ReadPrimitiveFromSource<uint32_t>(src);
+  if (version != kVersion)
+  {
+    LOG(LWARNING, ("Unknown feature attributes version:", version));
+    return false;
+  }
+
+  uint32_t const count = ReadPrimitiveFromSource<uint32_t>(src);
+  uint32_t const typesCount = ReadPrimitiveFromSource<uint32_t>(src);
+  uint64_t const size = kHeaderSize + uint64_t(count) * 2 * sizeof(uint32_t) +
+                        (uint64_t(count) + 1) * sizeof(uint32_t) +
+                        uint64_t(typesCount) * sizeof(uint16_t) + count;
+  if (reader.Size() != size)
+  {
+    LOG(LWARNING, ("Malformed feature attributes header."));
+    return false;
+  }
+
+  m_centers.resize(count * 2);
+  m_typeOffsets.resize(count + 1);
+  m_typeIndices.resize(typesCount);
+  m_ranks.resize(count);
+  ReadColumn(src, m_centers);
+  ReadColumn(src, m_typeOffsets);
+  ReadColumn(src, m_typeIndices);
+  src.Read(m_ranks.data(), m_ranks.size());
+
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    if (m_typeOffsets[i] > m_typeOffsets[i + 1])
+    {
+      LOG(LWARNING, ("Malformed feature attributes types."));
+      Clear();
+      return false;
+    }
+  }
+  if (m_typeOffsets.front() != 0 || m_typeOffsets.back() != typesCount)
+  {
+    LOG(LWARNING, ("Malformed feature attributes types."));
+    Clear();
+    return false;
+  }
+  return true;
+}
+
+void AttributesTable::Clear()
+{
+  m_centers.clear();
+  m_ranks.clear();
+  m_typeOffsets.clear();
+  m_typeIndices.clear();
+}
+
+m2::PointD AttributesTable::GetCenter(uint32_t featureIndex) const
+{
+  ASSERT_LESS(featureIndex, GetCount(), ());
+  return PointU2PointD(m2::PointU(m_centers[2 * featureIndex], m_centers[2 * featureIndex + 1]),
+                       POINT_COORD_BITS);
+}
+}  // namespace feature
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "coding/reader.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+namespace feature
+{
+/// Columns of the attributes of the features of the mwm which are used by the candidates
+/// filtering of search: centers, ranks and types. Each column is a contiguous array by the
+/// feature indices, so the attributes are taken without the decoding of the feature records.
+class AttributesTable
+{
+public:
+  struct Attributes
+  {
+    Attributes() : m_rank(0) {}
+
+    m2::PointD m_center;
+    uint8_t m_rank;
+    /// Classificator indices of the types, see Classificator::GetIndexForType().
+    vector<uint32_t> m_typeIndices;
+  };
+
+  static uint32_t const kVersion = 0;
+
+  /// @param attributes Attributes of all the features in the order of their indices.
+  static void Serialize(vector<Attributes> const & attributes, Writer & writer);
+
+  /// @return False when the data are malformed or of an unknown version.
+  template <typename TReader>
+  bool Load(TReader const & reader)
+  {
+    vector<char> data(static_cast<size_t>(reader.Size()));
+    reader.Read(0, data.data(), data.size());
+    return Deserialize(MemReader(data.data(), data.size()));
+  }
+  void Clear();
+
+  inline bool IsEmpty() const { return m_ranks.empty(); }
+  inline size_t GetCount() const { return m_ranks.size(); }
+
+  /// @name Column access, featureIndex should be less than GetCount().
+  //@{
+  m2::PointD GetCenter(uint32_t featureIndex) const;
+  inline uint8_t GetRank(uint32_t featureIndex) const
+  {
+    ASSERT_LESS(featureIndex, GetCount(), ());
+    return m_ranks[featureIndex];
+  }
+
+  template <typename ToDo>
+  void ForEachTypeIndex(uint32_t featureIndex, ToDo && toDo) const
+  {
+    ASSERT_LESS(featureIndex, GetCount(), ());
+    for (uint32_t i = m_typeOffsets[featureIndex]; i < m_typeOffsets[featureIndex + 1]; ++i)
+      toDo(static_cast<uint32_t>(m_typeIndices[i]));
+  }
+  //@}
+
+private:
+  bool Deserialize(MemReader const & reader);
+
+  // Centers are quantized by POINT_COORD_BITS, x and y of each feature go one after another.
+  vector<uint32_t> m_centers;
+  vector<uint8_t> m_ranks;
+  // Types of the feature i are m_typeIndices[m_typeOffsets[i], m_typeOffsets[i + 1]).
+  vector<uint32_t> m_typeOffsets;
+  vector<uint16_t> m_typeIndices;
+};
+}  // namespace feature
@@ -150,6 +150,34 @@ vector<int64_t> CoverFeature(FeatureType const & f, int cellDepth, uint64_t cell
   return res;
 }
 
+m2::RectD GetCellsRect(vector<int64_t> const & cells, int cellDepth)
+{
+  m2::RectD rect;
+  for (int64_t const cell : cells)
+  {
+    double minX, minY, maxX, maxY;
+    CellIdConverter<MercatorBounds, RectId>::GetCellBounds(RectId::FromInt64(cell, cellDepth),
+                                                           minX, minY, maxX, maxY);
+    rect.Add(m2::RectD(minX, minY, maxX, maxY));
+  }
+  return rect;
+}
+
+m2::RectD GetViewportCellsRect(m2::RectD const & r, int cellDepth)
+{
+  vector<RectId> ids;
+  CoverRect<MercatorBounds, RectId>(r.minX(), r.minY(), r.maxX(), r.maxY(), 8, cellDepth, ids);
+
+  m2::RectD rect;
+  for (RectId const & id : ids)
+  {
+    double minX, minY, maxX, maxY;
+    CellIdConverter<MercatorBounds, RectId>::GetCellBounds(id, minX, minY, maxX, maxY);
+    rect.Add(m2::RectD(minX, minY, maxX, maxY));
+  }
+  return rect;
+}
+
 void SortAndMergeIntervals(IntervalsT v, IntervalsT & res)
 {
 #ifdef DEBUG
@@ -177,6 +205,30 @@ IntervalsT SortAndMergeIntervals(IntervalsT const & v)
   return res;
 }
 
+IntervalsT SubtractIntervals(IntervalsT const & a, IntervalsT const & b)
+{
+  IntervalsT res;
+  size_t j = 0;
+  for (auto const & i : a)
+  {
+    int64_t beg = i.first;
+    // Skip the intervals of b which end before the current one.
+    while (j < b.size() && b[j].second <= beg)
+      ++j;
+
+    for (size_t k = j; k < b.size() && b[k].first < i.second; ++k)
+    {
+      if (beg < b[k].first)
+        res.push_back(make_pair(beg, b[k].first));
+      beg = max(beg, b[k].second);
+    }
+
+    if (beg < i.second)
+      res.push_back(make_pair(beg, i.second));
+  }
+  return res;
+}
+
 void AppendLowerLevels(RectId id, int cellDepth, IntervalsT & intervals)
 {
   int64_t idInt64 = id.ToInt64(cellDepth);
@@ -24,9 +24,19 @@ namespace covering
   void CoverViewportAndAppendLowerLevels(m2::RectD const & rect, int cellDepth,
                                          IntervalsT & intervals);
 
+  // Bounding rect of the cells of CoverFeature().
+  m2::RectD GetCellsRect(vector<int64_t> const & cells, int cellDepth);
+
+  // Bounding rect of the cells which CoverViewportAndAppendLowerLevels() covers viewport with.
+  // Features found by the intervals of the viewport intersect this rect by their cells.
+  m2::RectD GetViewportCellsRect(m2::RectD const & rect, int cellDepth);
+
   // Given a vector of intervals [a, b), sort them and merge overlapping intervals.
   IntervalsT SortAndMergeIntervals(IntervalsT const & intervals);
 
+  // Given sorted and merged vectors of intervals [a, b), return the parts of a not covered by b.
+  IntervalsT SubtractIntervals(IntervalsT const & a, IntervalsT const & b);
+
   RectId GetRectIdAsIs(m2::RectD const & r);
 
   // Calculate cell coding depth according to max visual scale for mwm.
@@ -50,5 +60,8 @@ namespace covering
     CoveringGetter(m2::RectD const & r, CoveringMode mode) : m_rect(r), m_mode(mode) {}
 
     IntervalsT const & Get(int scale);
+
+    inline m2::RectD const & GetRect() const { return m_rect; }
+    inline CoveringMode GetMode() const { return m_mode; }
   };
 }
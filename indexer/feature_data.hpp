@@ -135,13 +135,20 @@ struct FeatureParamsBase
 
   string DebugString() const;
 
+  /// @param namesCoder Code of the names of the mwm, nullptr when they aren't compressed.
   template <class TSink>
-  void Write(TSink & sink, uint8_t header) const
+  void Write(TSink & sink, uint8_t header,
+             coding::ByteHuffmanCoder const * namesCoder = nullptr) const
   {
     using namespace feature;
 
     if (header & HEADER_HAS_NAME)
-      name.Write(sink);
+    {
+      if (namesCoder)
+        name.Write(sink, *namesCoder);
+      else
+        name.Write(sink);
+    }
 
     if (header & HEADER_HAS_LAYER)
       WriteToSink(sink, layer);
@@ -165,12 +172,17 @@ struct FeatureParamsBase
   }
 
   template <class TSrc>
-  void Read(TSrc & src, uint8_t header)
+  void Read(TSrc & src, uint8_t header, coding::ByteHuffmanCoder const * namesCoder = nullptr)
   {
     using namespace feature;
 
     if (header & HEADER_HAS_NAME)
-      name.Read(src);
+    {
+      if (namesCoder)
+        name.Read(src, *namesCoder);
+      else
+        name.Read(src);
+    }
 
     if (header & HEADER_HAS_LAYER)
       layer = ReadPrimitiveFromSource<int8_t>(src);
@@ -267,7 +279,8 @@ public:
   feature::Metadata const & GetMetadata() const { return m_metadata; }
   feature::Metadata & GetMetadata() { return m_metadata; }
 
-  template <class SinkT> void Write(SinkT & sink, bool needStoreMetadata = true) const
+  template <class SinkT> void Write(SinkT & sink, bool needStoreMetadata = true,
+                                    coding::ByteHuffmanCoder const * namesCoder = nullptr) const
   {
     uint8_t const header = GetHeader();
 
@@ -279,7 +292,7 @@ public:
     if (needStoreMetadata)
       m_metadata.Serialize(sink);
 
-    BaseT::Write(sink, header);
+    BaseT::Write(sink, header, namesCoder);
   }
 
   template <class SrcT> void Read(SrcT & src, bool needReadMetadata = true)
@@ -0,0 +1,141 @@
+#include "indexer/feature_geometry_cache.hpp"
+
+#include "base/assert.hpp"
+
+namespace feature
+{
+// static
+size_t const GeometryCache::kDefaultMaxBytes;
+// static
+size_t const GeometryCache::kShardsCount;
+
+GeometryCache::GeometryCache(size_t maxBytes) : m_maxShardBytes(maxBytes / kShardsCount)
+{
+  m_governorId = CacheGovernor::Instance().Register("FeatureGeometry", CacheGovernor::LOW,
+                                                    [this]() { return GetBytes(); },
+                                                    [this](double share) { Trim(share); });
+}
+
+GeometryCache::~GeometryCache()
+{
+  CacheGovernor::Instance().Unregister(m_governorId);
+}
+
+// static
+GeometryCache & GeometryCache::Instance()
+{
+  static GeometryCache cache(kDefaultMaxBytes);
+  return cache;
+}
+
+bool GeometryCache::Find(FeatureID const & id, int scaleIndex, TPoints & points)
+{
+  Key const key(id, scaleIndex);
+  Shard & shard = GetShard(key);
+  lock_guard<mutex> lock(shard.m_mutex);
+
+  auto const it = shard.m_index.find(key);
+  if (it == shard.m_index.end())
+  {
+    ++shard.m_misses;
+    return false;
+  }
+
+  ++shard.m_hits;
+  shard.m_entries.splice(shard.m_entries.begin(), shard.m_entries, it->second);
+  vector<m2::PointD> const & cached = it->second->m_points;
+  points.assign(cached.begin(), cached.end());
+  return true;
+}
+
+void GeometryCache::Add(FeatureID const & id, int scaleIndex, TPoints const & points)
+{
+  size_t const maxBytes = m_maxShardBytes.load(memory_order_relaxed);
+  size_t const bytes = GetEntryBytes(points.size());
+  if (bytes > maxBytes)
+    return;
+
+  Key const key(id, scaleIndex);
+  Shard & shard = GetShard(key);
+  lock_guard<mutex> lock(shard.m_mutex);
+
+  // Another thread could decode the same feature at the same time.
+  if (shard.m_index.count(key) != 0)
+    return;
+
+  Shrink(shard, maxBytes - bytes);
+  shard.m_entries.emplace_front(key, points);
+  shard.m_index.emplace(key, shard.m_entries.begin());
+  shard.m_bytes += bytes;
+}
+
+void GeometryCache::SetMaxBytes(size_t maxBytes)
+{
+  size_t const maxShardBytes = maxBytes / kShardsCount;
+  m_maxShardBytes.store(maxShardBytes, memory_order_relaxed);
+  for (Shard & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard.m_mutex);
+    Shrink(shard, maxShardBytes);
+  }
+}
+
+void GeometryCache::Trim(double share)
+{
+  ASSERT_GREATER_OR_EQUAL(share, 0.0, ());
+  ASSERT_LESS_OR_EQUAL(share, 1.0, ());
+  for (Shard & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard.m_mutex);
+    Shrink(shard, static_cast<size_t>(shard.m_bytes * (1.0 - share)));
+  }
+}
+
+size_t GeometryCache::GetBytes() const
+{
+  size_t bytes = 0;
+  for (Shard const & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard.m_mutex);
+    bytes += shard.m_bytes;
+  }
+  return bytes;
+}
+
+GeometryCache::Stats GeometryCache::GetStats() const
+{
+  Stats stats;
+  for (Shard const & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard.m_mutex);
+    stats.m_hits += shard.m_hits;
+    stats.m_misses += shard.m_misses;
+  }
+  return stats;
+}
+
+// static
+size_t GeometryCache::GetEntryBytes(size_t pointsCount)
+{
+  // Points and approximate overhead of the list node and the index node.
+  return pointsCount * sizeof(m2::PointD) + sizeof(Entry) + 4 * sizeof(void *);
+}
+
+GeometryCache::Shard & GeometryCache::GetShard(Key const & key)
+{
+  return m_shards[KeyHash()(key) % kShardsCount];
+}
+
+// static
+void GeometryCache::Shrink(Shard & shard, size_t maxBytes)
+{
+  while (shard.m_bytes > maxBytes)
+  {
+    ASSERT(!shard.m_entries.empty(), ());
+    Entry const & entry = shard.m_entries.back();
+    shard.m_bytes -= GetEntryBytes(entry.m_points.size());
+    shard.m_index.erase(entry.m_key);
+    shard.m_entries.pop_back();
+  }
+}
+}  // namespace feature
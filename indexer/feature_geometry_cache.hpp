@@ -0,0 +1,116 @@
+#pragma once
+
+#include "indexer/feature_decl.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/buffer_vector.hpp"
+#include "base/cache_governor.hpp"
+#include "base/macros.hpp"
+
+#include "std/atomic.hpp"
+#include "std/list.hpp"
+#include "std/mutex.hpp"
+#include "std/unordered_map.hpp"
+#include "std/vector.hpp"
+
+namespace feature
+{
+/// Decoded outer geometry of the line features. Rendering, routing and search ask for the same
+/// roads, so with the cache a feature geometry is decoded from the mwm once for all of them.
+/// The cache is bounded by memory and split into shards with own locks, so the concurrent
+/// readers seldom wait for each other.
+class GeometryCache
+{
+public:
+  /// The same as FeatureType::points_t.
+  typedef buffer_vector<m2::PointD, 32> TPoints;
+
+  static size_t const kDefaultMaxBytes = 8 * 1024 * 1024;
+
+  struct Stats
+  {
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+  };
+
+  explicit GeometryCache(size_t maxBytes);
+  ~GeometryCache();
+
+  /// Cache shared by all the indices, it's registered in CacheGovernor.
+  static GeometryCache & Instance();
+
+  /// @param scaleIndex Index of the geometry section the points are decoded from.
+  /// @return False when there are no points in the cache.
+  bool Find(FeatureID const & id, int scaleIndex, TPoints & points);
+  void Add(FeatureID const & id, int scaleIndex, TPoints const & points);
+
+  /// The cache is disabled when maxBytes is 0.
+  void SetMaxBytes(size_t maxBytes);
+  bool IsEnabled() const { return m_maxShardBytes.load(memory_order_relaxed) != 0; }
+
+  /// Frees the share of the cached points, from 0 to 1.
+  void Trim(double share);
+  void Clear() { Trim(1.0); }
+
+  size_t GetBytes() const;
+  Stats GetStats() const;
+
+private:
+  DISALLOW_COPY_AND_MOVE(GeometryCache);
+
+  static size_t const kShardsCount = 16;
+
+  struct Key
+  {
+    Key(FeatureID const & id, int scaleIndex) : m_id(id), m_scaleIndex(scaleIndex) {}
+
+    inline bool operator==(Key const & rhs) const
+    {
+      return m_id == rhs.m_id && m_scaleIndex == rhs.m_scaleIndex;
+    }
+
+    FeatureID m_id;
+    int m_scaleIndex;
+  };
+
+  struct KeyHash
+  {
+    size_t operator()(Key const & key) const
+    {
+      return hash<MwmInfo const *>()(key.m_id.m_mwmId.GetInfo().get()) ^
+             (static_cast<size_t>(key.m_id.m_index) * 4 + key.m_scaleIndex);
+    }
+  };
+
+  struct Entry
+  {
+    Entry(Key const & key, TPoints const & points) : m_key(key), m_points(points.begin(), points.end()) {}
+
+    Key m_key;
+    vector<m2::PointD> m_points;
+  };
+
+  typedef list<Entry> TEntries;
+
+  struct Shard
+  {
+    mutable mutex m_mutex;
+    /// The most recently used entry is the first one.
+    TEntries m_entries;
+    unordered_map<Key, TEntries::iterator, KeyHash> m_index;
+    size_t m_bytes = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+  };
+
+  static size_t GetEntryBytes(size_t pointsCount);
+  Shard & GetShard(Key const & key);
+  /// Frees the least recently used entries until the shard takes not more than maxBytes.
+  static void Shrink(Shard & shard, size_t maxBytes);
+
+  Shard m_shards[kShardsCount];
+  atomic<size_t> m_maxShardBytes;
+  CacheGovernor::TCacheId m_governorId = CacheGovernor::kInvalidId;
+};
+}  // namespace feature
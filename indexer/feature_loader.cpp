@@ -2,6 +2,7 @@
 
 #include "indexer/feature_loader.hpp"
 #include "indexer/feature.hpp"
+#include "indexer/feature_geometry_cache.hpp"
 #include "indexer/scales.hpp"
 #include "indexer/geometry_serialization.hpp"
 #include "indexer/classificator.hpp"
@@ -40,7 +41,7 @@ void LoaderCurrent::ParseCommon()
   ArrayByteSource source(DataPtr() + m_CommonOffset);
 
   uint8_t const h = Header();
-  m_pF->m_params.Read(source, h);
+  m_pF->m_params.Read(source, h, m_Info.GetNamesCoder());
 
   if (m_pF->GetFeatureType() == GEOM_POINT)
   {
@@ -190,14 +191,32 @@ uint32_t LoaderCurrent::ParseGeometry(int scale)
       int const ind = GetScaleIndex(scale, m_ptsOffsets);
       if (ind != -1)
       {
-        ReaderSource<FilesContainerR::ReaderT> src(m_Info.GetGeometryReader(ind));
-        src.Skip(m_ptsOffsets[ind]);
-
-        serial::CodingParams cp = GetCodingParams(ind);
-        cp.SetBasePoint(m_pF->m_points[0]);
-        serial::LoadOuterPath(src, cp, m_pF->m_points);
-
-        sz = static_cast<uint32_t>(src.Pos() - m_ptsOffsets[ind]);
+        // Features which are read without an index have no id, they aren't cached.
+        GeometryCache & cache = GeometryCache::Instance();
+        bool const isCacheable = m_pF->m_id.IsValid() && cache.IsEnabled();
+        if (!isCacheable || !cache.Find(m_pF->m_id, ind, m_pF->m_points))
+        {
+          serial::CodingParams cp = GetCodingParams(ind);
+          cp.SetBasePoint(m_pF->m_points[0]);
+
+          MappedSection const & section = m_Info.GetGeometrySection(ind);
+          if (section.IsMapped())
+          {
+            ArrayByteSource src = section.GetSource(m_ptsOffsets[ind]);
+            serial::LoadOuterPath(src, cp, m_pF->m_points);
+            sz = static_cast<uint32_t>(src.PtrUC() - section.Data() - m_ptsOffsets[ind]);
+          }
+          else
+          {
+            ReaderSource<FilesContainerR::ReaderT> src(m_Info.GetGeometryReader(ind));
+            src.Skip(m_ptsOffsets[ind]);
+            serial::LoadOuterPath(src, cp, m_pF->m_points);
+            sz = static_cast<uint32_t>(src.Pos() - m_ptsOffsets[ind]);
+          }
+
+          if (isCacheable)
+            cache.Add(m_pF->m_id, ind, m_pF->m_points);
+        }
       }
     }
     else
@@ -238,11 +257,20 @@ uint32_t LoaderCurrent::ParseTriangles(int scale)
       uint32_t const ind = GetScaleIndex(scale, m_trgOffsets);
       if (ind != -1)
       {
-        ReaderSource<FilesContainerR::ReaderT> src(m_Info.GetTrianglesReader(ind));
-        src.Skip(m_trgOffsets[ind]);
-        serial::LoadOuterTriangles(src, GetCodingParams(ind), m_pF->m_triangles);
-
-        sz = static_cast<uint32_t>(src.Pos() - m_trgOffsets[ind]);
+        MappedSection const & section = m_Info.GetTrianglesSection(ind);
+        if (section.IsMapped())
+        {
+          ArrayByteSource src = section.GetSource(m_trgOffsets[ind]);
+          serial::LoadOuterTriangles(src, GetCodingParams(ind), m_pF->m_triangles);
+          sz = static_cast<uint32_t>(src.PtrUC() - section.Data() - m_trgOffsets[ind]);
+        }
+        else
+        {
+          ReaderSource<FilesContainerR::ReaderT> src(m_Info.GetTrianglesReader(ind));
+          src.Skip(m_trgOffsets[ind]);
+          serial::LoadOuterTriangles(src, GetCodingParams(ind), m_pF->m_triangles);
+          sz = static_cast<uint32_t>(src.Pos() - m_trgOffsets[ind]);
+        }
       }
     }
 
@@ -252,29 +280,101 @@ uint32_t LoaderCurrent::ParseTriangles(int scale)
   return sz;
 }
 
-void LoaderCurrent::ParseMetadata()
+template <typename ToDo>
+bool LoaderCurrent::ForMetadataRecord(ToDo && toDo)
 {
   try
   {
-    typedef pair<uint32_t, uint32_t> IdxElementT;
-    DDVector<IdxElementT, FilesContainerR::ReaderT> idx(m_Info.GetMetadataIndexReader());
-    
-    auto it = lower_bound(idx.begin(), idx.end()
-                          , make_pair(uint32_t(m_pF->m_id.m_index), uint32_t(0))
-                          , [](IdxElementT const & v1, IdxElementT const & v2) { return v1.first < v2.first; }
-                          );
-
-    if (it != idx.end() && m_pF->m_id.m_index == it->first)
+    uint32_t offset = 0;
+    MetadataIndex const & index = m_Info.GetMetadataIndex();
+    if (index.IsLoaded())
+    {
+      if (!index.Get(m_pF->m_id.m_index, offset))
+        return false;
+    }
+    else
+    {
+      typedef pair<uint32_t, uint32_t> IdxElementT;
+      DDVector<IdxElementT, FilesContainerR::ReaderT> idx(m_Info.GetMetadataIndexReader());
+
+      auto it = lower_bound(idx.begin(), idx.end()
+                            , make_pair(uint32_t(m_pF->m_id.m_index), uint32_t(0))
+                            , [](IdxElementT const & v1, IdxElementT const & v2) { return v1.first < v2.first; }
+                            );
+      if (it == idx.end() || m_pF->m_id.m_index != it->first)
+        return false;
+      offset = it->second;
+    }
+
+    MappedSection const & section = m_Info.GetMetadataSection();
+    if (section.IsMapped())
+    {
+      ArrayByteSource src = section.GetSource(offset);
+      toDo(src);
+    }
+    else
     {
       ReaderSource<FilesContainerR::ReaderT> reader(m_Info.GetMetadataReader());
-      reader.Skip(it->second);
-      m_pF->GetMetadata().DeserializeFromMWM(reader);
+      reader.Skip(offset);
+      toDo(reader);
     }
+    return true;
   }
   catch (Reader::OpenException const &)
   {
     // now ignore exception because not all mwm have needed sections
+    return false;
+  }
+}
+
+namespace
+{
+class MetadataDeserializer
+{
+public:
+  explicit MetadataDeserializer(Metadata & metadata) : m_metadata(metadata) {}
+
+  template <typename TSource>
+  void operator()(TSource & src) const
+  {
+    m_metadata.DeserializeFromMWM(src);
+  }
+
+private:
+  Metadata & m_metadata;
+};
+
+class MetadataFieldFinder
+{
+public:
+  MetadataFieldFinder(Metadata::EType type, string & value, bool & found)
+    : m_type(type), m_value(value), m_found(found)
+  {
+  }
+
+  template <typename TSource>
+  void operator()(TSource & src) const
+  {
+    m_found = Metadata::FindInMWM(src, m_type, m_value);
   }
+
+private:
+  Metadata::EType const m_type;
+  string & m_value;
+  bool & m_found;
+};
+}  // namespace
+
+void LoaderCurrent::ParseMetadata()
+{
+  ForMetadataRecord(MetadataDeserializer(m_pF->GetMetadata()));
+}
+
+bool LoaderCurrent::ParseMetadataField(Metadata::EType type, string & value)
+{
+  bool found = false;
+  ForMetadataRecord(MetadataFieldFinder(type, value, found));
+  return found;
 }
 
 int LoaderCurrent::GetScaleIndex(int scale) const
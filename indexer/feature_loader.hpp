@@ -18,6 +18,11 @@ namespace feature
     int GetScaleIndex(int scale, offsets_t const & offsets) const;
     //@}
 
+    /// Calls toDo(source) for the source at the beginning of the metadata record of the feature.
+    /// @return False when the feature has no metadata.
+    template <typename ToDo>
+    bool ForMetadataRecord(ToDo && toDo);
+
   public:
     LoaderCurrent(SharedLoadInfo const & info) : BaseT(info) {}
 
@@ -29,5 +34,6 @@ namespace feature
     virtual uint32_t ParseGeometry(int scale);
     virtual uint32_t ParseTriangles(int scale);
     virtual void ParseMetadata();
+    virtual bool ParseMetadataField(Metadata::EType type, string & value);
   };
 }
@@ -6,9 +6,14 @@
 
 #include "indexer/old/feature_loader_101.hpp"
 
+#include "platform/mwm_version.hpp"
+
 #include "defines.hpp"
 
 #include "coding/byte_stream.hpp"
+#include "coding/reader.hpp"
+
+#include "base/logging.hpp"
 
 
 namespace feature
@@ -18,15 +23,43 @@ namespace feature
 // SharedLoadInfo implementation.
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-SharedLoadInfo::SharedLoadInfo(FilesContainerR const & cont, DataHeader const & header)
-  : m_cont(cont), m_header(header)
+namespace
 {
-  CreateLoader();
+MappedSection MapSection(FilesContainerR const & cont, string const & tag)
+{
+  return cont.IsExist(tag) ? MappedSection(cont.GetReader(tag)) : MappedSection();
 }
+}  // namespace
 
-SharedLoadInfo::~SharedLoadInfo()
+SharedLoadInfo::SharedLoadInfo(FilesContainerR const & cont, DataHeader const & header)
+  : m_cont(cont), m_header(header), m_dataSection(MapSection(cont, DATA_FILE_TAG))
+  , m_hasNamesCoder(false)
 {
-  delete m_pLoader;
+  if (header.GetFormat() >= version::v6 && cont.IsExist(NAMES_CODE_FILE_TAG))
+  {
+    ReaderSource<ReaderT> src(cont.GetReader(NAMES_CODE_FILE_TAG));
+    m_hasNamesCoder = m_namesCoder.Read(src);
+    if (!m_hasNamesCoder)
+      LOG(LERROR, ("Invalid code of the feature names."));
+  }
+
+  if (cont.IsExist(METADATA_FILE_TAG))
+  {
+    m_metadataIndex.Load(cont);
+    m_metadataSection = MapSection(cont, METADATA_FILE_TAG);
+  }
+
+  if (!m_dataSection.IsMapped())
+    return;
+
+  int const count = GetScalesCount();
+  m_geometrySections.reserve(count);
+  m_trianglesSections.reserve(count);
+  for (int i = 0; i < count; ++i)
+  {
+    m_geometrySections.push_back(MapSection(cont, GetTagForIndex(GEOMETRY_FILE_TAG, i)));
+    m_trianglesSections.push_back(MapSection(cont, GetTagForIndex(TRIANGLE_FILE_TAG, i)));
+  }
 }
 
 SharedLoadInfo::ReaderT SharedLoadInfo::GetDataReader() const
@@ -54,12 +87,23 @@ SharedLoadInfo::ReaderT SharedLoadInfo::GetTrianglesReader(int ind) const
   return m_cont.GetReader(GetTagForIndex(TRIANGLE_FILE_TAG, ind));
 }
 
-void SharedLoadInfo::CreateLoader()
+MappedSection const & SharedLoadInfo::GetGeometrySection(int ind) const
+{
+  static MappedSection const kEmpty;
+  return static_cast<size_t>(ind) < m_geometrySections.size() ? m_geometrySections[ind] : kEmpty;
+}
+
+MappedSection const & SharedLoadInfo::GetTrianglesSection(int ind) const
+{
+  static MappedSection const kEmpty;
+  return static_cast<size_t>(ind) < m_trianglesSections.size() ? m_trianglesSections[ind] : kEmpty;
+}
+
+unique_ptr<LoaderBase> SharedLoadInfo::CreateLoader() const
 {
   if (m_header.GetFormat() == version::v1)
-    m_pLoader = new old_101::feature::LoaderImpl(*this);
-  else
-    m_pLoader = new LoaderCurrent(*this);
+    return make_unique<old_101::feature::LoaderImpl>(*this);
+  return make_unique<LoaderCurrent>(*this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -1,10 +1,16 @@
 #pragma once
 #include "indexer/coding_params.hpp"
 #include "indexer/data_header.hpp"
+#include "indexer/feature_meta.hpp"
+#include "indexer/feature_meta_index.hpp"
 
+#include "coding/byte_huffman.hpp"
 #include "coding/file_container.hpp"
+#include "coding/mapped_section.hpp"
 
 #include "std/noncopyable.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
 
 
 class FeatureType;
@@ -14,20 +20,26 @@ namespace feature
 {
   class LoaderBase;
 
-  /// This info is created once.
+  /// This info is created once and is immutable, so it can be shared between threads.
   class SharedLoadInfo : private noncopyable
   {
     FilesContainerR const & m_cont;
     DataHeader const & m_header;
 
-    typedef FilesContainerR::ReaderT ReaderT;
+    // Sections are mapped once when the container is memory mapped, they are empty otherwise.
+    MappedSection m_dataSection;
+    vector<MappedSection> m_geometrySections;
+    vector<MappedSection> m_trianglesSections;
+    MappedSection m_metadataSection;
+    MetadataIndex m_metadataIndex;
+
+    coding::ByteHuffmanCoder m_namesCoder;
+    bool m_hasNamesCoder;
 
-    LoaderBase * m_pLoader;
-    void CreateLoader();
+    typedef FilesContainerR::ReaderT ReaderT;
 
   public:
     SharedLoadInfo(FilesContainerR const & cont, DataHeader const & header);
-    ~SharedLoadInfo();
 
     ReaderT GetDataReader() const;
     ReaderT GetMetadataReader() const;
@@ -35,7 +47,28 @@ namespace feature
     ReaderT GetGeometryReader(int ind) const;
     ReaderT GetTrianglesReader(int ind) const;
 
-    LoaderBase * GetLoader() const { return m_pLoader; }
+    /// @name Sections for the in place decoding, they aren't mapped when the container
+    /// isn't memory mapped.
+    //@{
+    inline MappedSection const & GetDataSection() const { return m_dataSection; }
+    MappedSection const & GetGeometrySection(int ind) const;
+    MappedSection const & GetTrianglesSection(int ind) const;
+    inline MappedSection const & GetMetadataSection() const { return m_metadataSection; }
+    //@}
+
+    /// Index of the metadata records, it isn't loaded for the mwms which have METADATA_INDEX_FILE_TAG
+    /// section only.
+    inline MetadataIndex const & GetMetadataIndex() const { return m_metadataIndex; }
+
+    /// @return Code of the feature names or nullptr when the names aren't compressed.
+    inline coding::ByteHuffmanCoder const * GetNamesCoder() const
+    {
+      return m_hasNamesCoder ? &m_namesCoder : nullptr;
+    }
+
+    /// Loader holds the state of the feature being decoded, so it should
+    /// be created for every thread (see FeaturesVector::Cursor).
+    unique_ptr<LoaderBase> CreateLoader() const;
 
     inline serial::CodingParams const & GetDefCodingParams() const
     {
@@ -76,6 +109,8 @@ namespace feature
     virtual uint32_t ParseGeometry(int scale) = 0;
     virtual uint32_t ParseTriangles(int scale) = 0;
     virtual void ParseMetadata() = 0;
+    /// @return False when the feature has no such metadata field.
+    virtual bool ParseMetadataField(Metadata::EType type, string & value) = 0;
 
     inline uint32_t GetTypesSize() const { return m_CommonOffset - m_TypesOffset; }
 
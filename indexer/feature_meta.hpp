@@ -100,6 +100,26 @@ namespace feature
       } while (!(header[0] & 0x80));
     }
 
+    /// Looks for the only field in the record of SerializeToMWM(), other fields are skipped
+    /// without the decoding.
+    /// @return False when the record has no such field.
+    template <class ArchiveT> static bool FindInMWM(ArchiveT & ar, EType type, string & value)
+    {
+      uint8_t header[2] = {0};
+      char buffer[kMaxStringLength] = {0};
+      do
+      {
+        ar.Read(header, sizeof(header));
+        ar.Read(buffer, header[1]);
+        if ((header[0] & 0x7F) == type)
+        {
+          value.assign(buffer, header[1]);
+          return true;
+        }
+      } while (!(header[0] & 0x80));
+      return false;
+    }
+
     template <class ArchiveT> void Serialize(ArchiveT & ar) const
     {
       uint8_t const sz = m_metadata.size();
@@ -0,0 +1,79 @@
+#include "indexer/feature_meta_index.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "base/assert.hpp"
+
+#include "defines.hpp"
+
+#include "3party/succinct/mapper.hpp"
+
+namespace feature
+{
+void MetadataIndex::Builder::Add(uint32_t featureIndex, uint32_t offset)
+{
+  ASSERT(m_features.empty() || m_features.back() < featureIndex, (featureIndex));
+  ASSERT(m_offsets.empty() || m_offsets.back() < offset, (offset));
+  m_features.push_back(featureIndex);
+  m_offsets.push_back(offset);
+}
+
+void MetadataIndex::Builder::Save(string const & filePath, uint32_t featuresCount) const
+{
+  vector<bool> bits(featuresCount, false);
+  for (uint32_t const featureIndex : m_features)
+  {
+    ASSERT_LESS(featureIndex, featuresCount, ());
+    bits[featureIndex] = true;
+  }
+
+  uint32_t const maxOffset = m_offsets.empty() ? 0 : m_offsets.back();
+  succinct::elias_fano::elias_fano_builder offsetsBuilder(maxOffset, m_offsets.size());
+  for (uint32_t const offset : m_offsets)
+    offsetsBuilder.push_back(offset);
+
+  Data data;
+  succinct::rs_bit_vector(bits).swap(data.m_features);
+  succinct::elias_fano(&offsetsBuilder).swap(data.m_offsets);
+
+  string const tmpPath = filePath + EXTENSION_TMP;
+  succinct::mapper::freeze(data, tmpPath.c_str());
+  my::RenameFileX(tmpPath, filePath);
+}
+
+bool MetadataIndex::Load(FilesContainerR const & cont)
+{
+  if (!cont.IsExist(METADATA_OFFSETS_FILE_TAG))
+    return false;
+
+  FilesContainerR::ReaderT reader = cont.GetReader(METADATA_OFFSETS_FILE_TAG);
+  m_section = MappedSection(reader);
+  char const * data = nullptr;
+  if (m_section.IsMapped())
+  {
+    // Sections are aligned by FilesContainerW::kSectionAlignment, so the words are read in place.
+    ASSERT_EQUAL(reinterpret_cast<uintptr_t>(m_section.Data()) % sizeof(uint64_t), 0, ());
+    data = reinterpret_cast<char const *>(m_section.Data());
+  }
+  else
+  {
+    m_buffer.resize((reader.Size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    reader.Read(0, m_buffer.data(), reader.Size());
+    data = reinterpret_cast<char const *>(m_buffer.data());
+  }
+
+  succinct::mapper::map(m_data, data);
+  m_isLoaded = true;
+  return true;
+}
+
+bool MetadataIndex::Get(uint32_t featureIndex, uint32_t & offset) const
+{
+  ASSERT(m_isLoaded, ());
+  if (featureIndex >= m_data.m_features.size() || !m_data.m_features[featureIndex])
+    return false;
+  offset = static_cast<uint32_t>(m_data.m_offsets.select(m_data.m_features.rank(featureIndex)));
+  return true;
+}
+}  // namespace feature
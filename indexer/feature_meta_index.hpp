@@ -0,0 +1,68 @@
+#pragma once
+
+#include "coding/mapped_section.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+#include "3party/succinct/elias_fano.hpp"
+#include "3party/succinct/rs_bit_vector.hpp"
+
+class FilesContainerR;
+
+namespace feature
+{
+/// Index of the metadata records of the features, it's stored in the METADATA_OFFSETS_FILE_TAG
+/// section. The bit of each feature tells whether the feature has a record, and the offsets of
+/// the records go in the order of the features, so the record is found by a rank of the bit
+/// and a select of the offset, both are O(1). The index is used in place when the container is
+/// memory mapped.
+class MetadataIndex
+{
+public:
+  class Builder
+  {
+  public:
+    /// Features should be added in the increasing order of their indices and offsets.
+    void Add(uint32_t featureIndex, uint32_t offset);
+
+    /// Writes the index of featuresCount features to the file.
+    void Save(string const & filePath, uint32_t featuresCount) const;
+
+  private:
+    vector<uint32_t> m_features;
+    vector<uint32_t> m_offsets;
+  };
+
+  /// @return False when there is no index in the container.
+  bool Load(FilesContainerR const & cont);
+
+  inline bool IsLoaded() const { return m_isLoaded; }
+
+  /// @return False when the feature has no metadata.
+  bool Get(uint32_t featureIndex, uint32_t & offset) const;
+
+private:
+  struct Data
+  {
+    template <typename TVisitor>
+    void map(TVisitor & visit)
+    {
+      visit(m_features, "m_features")(m_offsets, "m_offsets");
+    }
+
+    succinct::rs_bit_vector m_features;
+    succinct::elias_fano m_offsets;
+  };
+
+  Data m_data;
+  bool m_isLoaded = false;
+
+  /// Storage of the mapped index, the buffer is used when the container isn't memory mapped.
+  //@{
+  MappedSection m_section;
+  vector<uint64_t> m_buffer;
+  //@}
+};
+}  // namespace feature
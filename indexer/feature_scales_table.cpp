@@ -0,0 +1,104 @@
+#include "indexer/feature_scales_table.hpp"
+
+#include "indexer/scales.hpp"
+
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+namespace feature
+{
+namespace
+{
+uint8_t PackScale(int scale, uint8_t noScale)
+{
+  if (scale < 0)
+    return noScale;
+  ASSERT_LESS(scale, noScale, ());
+  return static_cast<uint8_t>(scale);
+}
+
+int UnpackScale(uint8_t scale, uint8_t noScale) { return scale == noScale ? -1 : scale; }
+}  // namespace
+
+// static
+uint32_t const ScalesTable::kVersion;
+// static
+size_t const ScalesTable::kScalesPerFeature;
+// static
+uint8_t const ScalesTable::kNoScale;
+
+// static
+void ScalesTable::Serialize(vector<Ranges> const & ranges, Writer & writer)
+{
+  WriteToSink(writer, kVersion);
+  WriteToSink(writer, static_cast<uint32_t>(ranges.size()));
+
+  vector<uint8_t> scales;
+  scales.reserve(ranges.size() * kScalesPerFeature);
+  for (Ranges const & r : ranges)
+  {
+    scales.push_back(PackScale(r.m_drawable.first, kNoScale));
+    scales.push_back(PackScale(r.m_drawable.second, kNoScale));
+    scales.push_back(PackScale(r.m_labels.first, kNoScale));
+    scales.push_back(PackScale(r.m_labels.second, kNoScale));
+  }
+  writer.Write(scales.data(), scales.size());
+}
+
+bool ScalesTable::Deserialize(MemReader const & reader)
+{
+  Clear();
+
+  uint64_t const kHeaderSize = 2 * sizeof(uint32_t);
+  if (reader.Size() < kHeaderSize)
+  {
+    LOG(LWARNING, ("Malformed feature scales header."));
+    return false;
+  }
+
+  ReaderSource<MemReader> src(reader);
+  uint32_t const version = ReadPrimitiveFromSource<uint32_t>(src);
+  if (version != kVersion)
+  {
+    LOG(LWARNING, ("Unknown feature scales version:", version));
+    return false;
+  }
+
+  uint32_t const count = ReadPrimitiveFromSource<uint32_t>(src);
+  if (reader.Size() != kHeaderSize + uint64_t(count) * kScalesPerFeature)
+  {
+    LOG(LWARNING, ("Malformed feature scales header."));
+    return false;
+  }
+
+  m_scales.resize(count * kScalesPerFeature);
+  src.Read(m_scales.data(), m_scales.size());
+
+  for (uint8_t const scale : m_scales)
+  {
+    if (scale != kNoScale && scale > scales::GetUpperStyleScale())
+    {
+      LOG(LWARNING, ("Malformed feature scales."));
+      Clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+void ScalesTable::Clear() { m_scales.clear(); }
+
+bool ScalesTable::Get(uint32_t featureIndex, Ranges & ranges) const
+{
+  if (featureIndex >= GetCount())
+    return false;
+
+  uint8_t const * scales = &m_scales[featureIndex * kScalesPerFeature];
+  ranges.m_drawable = make_pair(UnpackScale(scales[0], kNoScale), UnpackScale(scales[1], kNoScale));
+  ranges.m_labels = make_pair(UnpackScale(scales[2], kNoScale), UnpackScale(scales[3], kNoScale));
+  return true;
+}
+}  // namespace feature
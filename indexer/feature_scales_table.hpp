@@ -0,0 +1,63 @@
+#pragma once
+
+#include "coding/reader.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+namespace feature
+{
+/// Scale ranges of the features of the mwm by their indices, they are computed by the generator
+/// with GetDrawableScaleRange(), so the features are filtered by the array lookup instead of
+/// the classificator walk over their types. Ranges are [-1, -1] for the not drawable features.
+class ScalesTable
+{
+public:
+  struct Ranges
+  {
+    Ranges() : m_drawable(-1, -1), m_labels(-1, -1) {}
+    Ranges(pair<int, int> const & drawable, pair<int, int> const & labels)
+      : m_drawable(drawable), m_labels(labels)
+    {
+    }
+
+    /// Scales of the feature itself.
+    pair<int, int> m_drawable;
+    /// Scales of its texts or symbols, see GetDrawableScaleRangeForRules(RULE_ANY_TEXT | RULE_SYMBOL).
+    pair<int, int> m_labels;
+  };
+
+  static uint32_t const kVersion = 0;
+
+  /// @param ranges Ranges of all the features in the order of their indices.
+  static void Serialize(vector<Ranges> const & ranges, Writer & writer);
+
+  /// @return False when the data are malformed or of an unknown version.
+  template <typename TReader>
+  bool Load(TReader const & reader)
+  {
+    vector<char> data(static_cast<size_t>(reader.Size()));
+    reader.Read(0, data.data(), data.size());
+    return Deserialize(MemReader(data.data(), data.size()));
+  }
+  void Clear();
+
+  inline bool IsEmpty() const { return m_scales.empty(); }
+  inline size_t GetCount() const { return m_scales.size() / kScalesPerFeature; }
+
+  /// @return False when the feature isn't in the table.
+  bool Get(uint32_t featureIndex, Ranges & ranges) const;
+
+private:
+  // Min and max of the feature and of its labels.
+  static size_t const kScalesPerFeature = 4;
+  static uint8_t const kNoScale = 0xFF;
+
+  bool Deserialize(MemReader const & reader);
+
+  vector<uint8_t> m_scales;
+};
+}  // namespace feature
@@ -6,6 +6,7 @@
 #include "base/assert.hpp"
 
 #include "std/array.hpp"
+#include "std/unordered_map.hpp"
 
 
 namespace
@@ -123,6 +124,117 @@ namespace
   };
 }
 
+namespace
+{
+  /// Draw rules of each classificator type for each style scale and geometry type.
+  /// Keys of the cell (row, scale, geometry type) are m_keys[m_offsets[i], m_offsets[i + 1]),
+  /// where i = row * kCellsCount + scale * kGeomTypesCount + geometry type.
+  class DrawRulesTable
+  {
+  public:
+    void Build(Classificator const & c)
+    {
+      Clear();
+
+      // Row 0 is shared by the types without the rules.
+      m_offsets.assign(kCellsCount + 1, 0);
+
+      drule::KeysT keys;
+      vector<uint32_t> offsets;
+      auto const addType = [&](ClassifObject const * p, uint32_t type)
+      {
+        // Most of the types have no rules at all, they share the empty row.
+        if (!p->IsDrawableAny())
+        {
+          m_rows[type] = 0;
+          return;
+        }
+
+        // Only the type's own object is asked for the rules, see NeedProcessParent(), so
+        // it's asked directly instead of walking the path from the root for every cell.
+        keys.clear();
+        offsets.clear();
+        for (int scale = 0; scale < kScalesCount; ++scale)
+        {
+          for (int ft = 0; ft < kGeomTypesCount; ++ft)
+          {
+            p->GetSuitable(min(scale, scales::GetUpperStyleScale()), EGeomType(ft), keys);
+            offsets.push_back(static_cast<uint32_t>(m_keys.size() + keys.size()));
+          }
+        }
+
+        if (keys.empty())
+        {
+          m_rows[type] = 0;
+          return;
+        }
+
+        m_rows[type] = static_cast<uint32_t>((m_offsets.size() - 1) / kCellsCount);
+        m_offsets.insert(m_offsets.end(), offsets.begin(), offsets.end());
+        m_keys.insert(m_keys.end(), keys.begin(), keys.end());
+      };
+      c.ForEachTree(addType);
+    }
+
+    void Clear()
+    {
+      m_rows.clear();
+      m_offsets.clear();
+      m_keys.clear();
+    }
+
+    /// @return False when the type isn't compiled.
+    bool Get(uint32_t type, int scale, EGeomType ft, drule::KeysT & keys) const
+    {
+      if (ft < 0 || ft >= kGeomTypesCount)
+        return false;
+      auto const it = m_rows.find(type);
+      if (it == m_rows.end())
+        return false;
+
+      ASSERT_GREATER_OR_EQUAL(scale, 0, ());
+      size_t const i = it->second * kCellsCount + min(scale, kScalesCount - 1) * kGeomTypesCount + ft;
+      keys.append(m_keys.begin() + m_offsets[i], m_keys.begin() + m_offsets[i + 1]);
+      return true;
+    }
+
+  private:
+    static int const kScalesCount = scales::UPPER_STYLE_SCALE + 1;
+    static int const kGeomTypesCount = 3;
+    static int const kCellsCount = kScalesCount * kGeomTypesCount;
+
+    unordered_map<uint32_t, uint32_t> m_rows;
+    vector<uint32_t> m_offsets;
+    vector<drule::Key> m_keys;
+  };
+
+  DrawRulesTable & GetDrawRulesTable()
+  {
+    static DrawRulesTable table;
+    return table;
+  }
+
+  void GetDrawRuleImpl(Classificator const & c, uint32_t type, int level, EGeomType ft,
+                       drule::KeysT & keys)
+  {
+    if (GetDrawRulesTable().Get(type, level, ft, keys))
+      return;
+
+    DrawRuleGetter doRules(level, ft, keys);
+    (void)c.ProcessObjects(type, doRules);
+  }
+}
+
+void CompileDrawRules()
+{
+  GetDrawRulesTable().Build(classif());
+}
+
+void ClearCompiledDrawRules()
+{
+  GetDrawRulesTable().Clear();
+}
+
 pair<int, bool> GetDrawRule(FeatureBase const & f, int level,
                             drule::KeysT & keys)
 {
@@ -131,9 +243,8 @@ pair<int, bool> GetDrawRule(FeatureBase const & f, int level,
   ASSERT ( keys.empty(), () );
   Classificator const & c = classif();
 
-  DrawRuleGetter doRules(level, types.GetGeoType(), keys);
   for (uint32_t t : types)
-    (void)c.ProcessObjects(t, doRules);
+    GetDrawRuleImpl(c, t, level, types.GetGeoType(), keys);
 
   return make_pair(types.GetGeoType(), types.Has(c.GetCoastType()));
 }
@@ -145,10 +256,8 @@ void GetDrawRule(vector<uint32_t> const & types, int level, int geoType,
   ASSERT ( keys.empty(), () );
   Classificator const & c = classif();
 
-  DrawRuleGetter doRules(level, EGeomType(geoType), keys);
-
   for (size_t i = 0; i < types.size(); ++i)
-    (void)c.ProcessObjects(types[i], doRules);
+    GetDrawRuleImpl(c, types[i], level, EGeomType(geoType), keys);
 }
 
 namespace
@@ -61,6 +61,11 @@ namespace feature
   void GetDrawRule(vector<uint32_t> const & types, int level, int geoType,
                    drule::KeysT & keys);
 
+  /// Compiles the draw rules of each classificator type for each scale, so GetDrawRule
+  /// doesn't walk the classificator tree. It's called when the drawing rules are loaded.
+  void CompileDrawRules();
+  void ClearCompiledDrawRules();
+
   /// Used to check whether user types belong to particular classificator set.
   class TypeSetChecker
   {
@@ -35,6 +35,18 @@ namespace feature
     succinct::mapper::map(m_table, reinterpret_cast<char const *>(m_pReader->Data()));
   }
 
+  FeaturesOffsetsTable::FeaturesOffsetsTable(MappedSection const & section) : m_section(section)
+  {
+    // Sections are aligned by FilesContainerW::kSectionAlignment, so the words are read in place.
+    ASSERT_EQUAL(reinterpret_cast<uintptr_t>(m_section.Data()) % sizeof(uint64_t), 0, ());
+    succinct::mapper::map(m_table, reinterpret_cast<char const *>(m_section.Data()));
+  }
+
+  FeaturesOffsetsTable::FeaturesOffsetsTable(vector<uint64_t> && buffer) : m_buffer(move(buffer))
+  {
+    succinct::mapper::map(m_table, reinterpret_cast<char const *>(m_buffer.data()));
+  }
+
   // static
   unique_ptr<FeaturesOffsetsTable> FeaturesOffsetsTable::Build(Builder & builder)
   {
@@ -64,6 +76,39 @@ namespace feature
     return LoadImpl(filePath);
   }
 
+  // static
+  unique_ptr<FeaturesOffsetsTable> FeaturesOffsetsTable::Load(FilesContainerR const & cont)
+  {
+    if (!cont.IsExist(FEATURES_OFFSETS_FILE_TAG))
+      return unique_ptr<FeaturesOffsetsTable>();
+
+    FilesContainerR::ReaderT reader = cont.GetReader(FEATURES_OFFSETS_FILE_TAG);
+    MappedSection section(reader);
+    if (section.IsMapped())
+      return unique_ptr<FeaturesOffsetsTable>(new FeaturesOffsetsTable(section));
+
+    vector<uint64_t> buffer((reader.Size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    reader.Read(0, buffer.data(), reader.Size());
+    return unique_ptr<FeaturesOffsetsTable>(new FeaturesOffsetsTable(move(buffer)));
+  }
+
+  // static
+  void FeaturesOffsetsTable::BuildSection(string const & mwmFilePath)
+  {
+    Builder builder;
+    FeaturesVector::ForEachOffset(FilesContainerR(mwmFilePath).GetReader(DATA_FILE_TAG),
+                                  [&builder](uint32_t offset)
+    {
+      builder.PushOffset(offset);
+    });
+
+    string const tmpFile = mwmFilePath + "." FEATURES_OFFSETS_FILE_TAG EXTENSION_TMP;
+    Build(builder)->Save(tmpFile);
+    FilesContainerW(mwmFilePath, FileWriter::OP_WRITE_EXISTING).Write(tmpFile, FEATURES_OFFSETS_FILE_TAG);
+    FileWriter::DeleteFileX(tmpFile);
+    LOG(LINFO, ("Features offsets table of", builder.size(), "features is written to", mwmFilePath));
+  }
+
   // static
   unique_ptr<FeaturesOffsetsTable> FeaturesOffsetsTable::CreateImpl(
       platform::LocalCountryFile const & localFile,
@@ -88,6 +133,10 @@ namespace feature
   unique_ptr<FeaturesOffsetsTable> FeaturesOffsetsTable::CreateIfNotExistsAndLoad(
       LocalCountryFile const & localFile, FilesContainerR const & cont)
   {
+    unique_ptr<FeaturesOffsetsTable> table = Load(cont);
+    if (table)
+      return table;
+
     string const offsetsFilePath = CountryIndexes::GetPath(localFile, CountryIndexes::Index::Offsets);
 
     if (Platform::IsFileExistsByFullPath(offsetsFilePath))
@@ -100,12 +149,7 @@ namespace feature
   unique_ptr<FeaturesOffsetsTable> FeaturesOffsetsTable::CreateIfNotExistsAndLoad(
       LocalCountryFile const & localFile)
   {
-    string const offsetsFilePath = CountryIndexes::GetPath(localFile, CountryIndexes::Index::Offsets);
-
-    if (Platform::IsFileExistsByFullPath(offsetsFilePath))
-      return LoadImpl(offsetsFilePath);
-
-    return CreateImpl(localFile, FilesContainerR(localFile.GetPath(MapOptions::Map)), offsetsFilePath);
+    return CreateIfNotExistsAndLoad(localFile, FilesContainerR(localFile.GetPath(MapOptions::Map)));
   }
 
   // static
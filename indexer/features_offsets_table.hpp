@@ -1,5 +1,6 @@
 #pragma once
 
+#include "coding/mapped_section.hpp"
 #include "coding/mmap_reader.hpp"
 
 #include "defines.hpp"
@@ -57,7 +58,18 @@ namespace feature
     /// Load table by full path to the table file.
     static unique_ptr<FeaturesOffsetsTable> Load(string const & filePath);
 
+    /// Loads table from the FEATURES_OFFSETS_FILE_TAG section of the container. The table is
+    /// decoded in place when the container is memory mapped.
+    /// \return nullptr when there is no such section in the container.
+    static unique_ptr<FeaturesOffsetsTable> Load(FilesContainerR const & cont);
+
+    /// Builds table of the features of the MWM and writes it to the
+    /// FEATURES_OFFSETS_FILE_TAG section, so the table isn't built at runtime.
+    static void BuildSection(string const & mwmFilePath);
+
     /// Get table for the MWM map, represented by localFile and cont.
+    /// The table is loaded from the section of the MWM when it has one, otherwise
+    /// it is built and stored to the separate file near the MWM.
     static unique_ptr<FeaturesOffsetsTable> CreateIfNotExistsAndLoad(
         platform::LocalCountryFile const & localFile, FilesContainerR const & cont);
 
@@ -94,6 +106,8 @@ namespace feature
   private:
     FeaturesOffsetsTable(succinct::elias_fano::elias_fano_builder & builder);
     FeaturesOffsetsTable(string const & filePath);
+    FeaturesOffsetsTable(MappedSection const & section);
+    FeaturesOffsetsTable(vector<uint64_t> && buffer);
 
     static unique_ptr<FeaturesOffsetsTable> LoadImpl(string const & filePath);
     static unique_ptr<FeaturesOffsetsTable> CreateImpl(platform::LocalCountryFile const & localFile,
@@ -102,6 +116,11 @@ namespace feature
 
     succinct::elias_fano m_table;
 
+    /// Storage of the mapped table, only one of them is used.
+    //@{
     unique_ptr<MmapReader> m_pReader;
+    MappedSection m_section;
+    vector<uint64_t> m_buffer;
+    //@}
   };
 }  // namespace feature
@@ -5,15 +5,117 @@
 #include "platform/constants.hpp"
 #include "platform/mwm_version.hpp"
 
+#include "coding/varint.hpp"
 
-void FeaturesVector::GetByIndex(uint32_t index, FeatureType & ft) const
+namespace
 {
+// Records are read by one call when the gap between them is not greater than this size.
+uint64_t const kMaxGapSize = 1024;
+// Size limit for the records read by one call.
+uint64_t const kMaxBatchSize = 64 * 1024;
+}  // namespace
+
+
+FeaturesVector::Cursor::Cursor(FeaturesVector const & vector)
+  : m_vector(&vector), m_loader(vector.m_LoadInfo.CreateLoader())
+{
+}
+
+void FeaturesVector::Cursor::GetByIndex(uint32_t index, FeatureType & ft)
+{
+  if (m_vector->m_LoadInfo.GetDataSection().IsMapped())
+  {
+    ft.Deserialize(m_loader.get(), GetMappedRecord(index));
+    return;
+  }
+
   uint32_t offset = 0, size = 0;
-  auto const ftOffset = m_table ? m_table->GetFeatureOffset(index) : index;
-  m_RecordReader.ReadRecord(ftOffset, m_buffer, offset, size);
-  ft.Deserialize(m_LoadInfo.GetLoader(), &m_buffer[offset]);
+  auto const ftOffset = m_vector->m_table ? m_vector->m_table->GetFeatureOffset(index) : index;
+  m_vector->m_RecordReader.ReadRecord(ftOffset, m_buffer, offset, size);
+  ft.Deserialize(m_loader.get(), &m_buffer[offset]);
+}
+
+char const * FeaturesVector::Cursor::GetMappedRecord(uint32_t index) const
+{
+  auto const ftOffset = m_vector->m_table ? m_vector->m_table->GetFeatureOffset(index) : index;
+  ArrayByteSource source = m_vector->m_LoadInfo.GetDataSection().GetSource(ftOffset);
+  UNUSED_VALUE(ReadVarUint<uint32_t>(source));
+  return source.PtrC();
+}
+
+pair<size_t, pair<uint64_t, uint64_t>> FeaturesVector::Cursor::GetBatch(
+    vector<uint32_t> const & indices, size_t begin) const
+{
+  ASSERT_LESS(begin, indices.size(), ());
+  auto const * table = m_vector->m_table;
+  if (!table)
+  {
+    // Record sizes are unknown without the offsets table.
+    return make_pair(begin + 1, make_pair(uint64_t(0), uint64_t(0)));
+  }
+
+  uint64_t const dataSize = m_vector->m_RecordReader.Size();
+  auto const recordEnd = [&](uint32_t index) -> uint64_t
+  {
+    return index + 1 < table->size() ? table->GetFeatureOffset(index + 1) : dataSize;
+  };
+
+  uint64_t const start = table->GetFeatureOffset(indices[begin]);
+  uint64_t finish = recordEnd(indices[begin]);
+  size_t end = begin + 1;
+  for (; end < indices.size(); ++end)
+  {
+    uint64_t const offset = table->GetFeatureOffset(indices[end]);
+    uint64_t const next = recordEnd(indices[end]);
+    if (offset - finish > kMaxGapSize || next - start > kMaxBatchSize)
+      break;
+    finish = next;
+  }
+  return make_pair(end, make_pair(start, finish));
+}
+
+void FeaturesVector::Cursor::PrefetchBatch(vector<uint32_t> const & indices, size_t begin) const
+{
+  if (begin >= indices.size() || !m_vector->m_table)
+    return;
+
+  auto const range = GetBatch(indices, begin).second;
+  MappedSection const & section = m_vector->m_LoadInfo.GetDataSection();
+  if (section.IsMapped())
+    section.Prefetch(range.first, range.second - range.first);
+  else
+    m_vector->m_RecordReader.Prefetch(range.first, range.second - range.first);
 }
 
+size_t FeaturesVector::Cursor::ReadRecords(vector<uint32_t> const & indices, size_t begin)
+{
+  ASSERT_LESS(begin, indices.size(), ());
+  auto const & reader = m_vector->m_RecordReader;
+  m_recordOffsets.clear();
+
+  auto const * table = m_vector->m_table;
+  if (!table)
+  {
+    uint32_t offset = 0, size = 0;
+    reader.ReadRecord(indices[begin], m_buffer, offset, size);
+    m_recordOffsets.push_back(offset);
+    return begin + 1;
+  }
+
+  auto const batch = GetBatch(indices, begin);
+  size_t const end = batch.first;
+  uint64_t const start = batch.second.first;
+  m_buffer.resize(batch.second.second - start);
+  reader.ReadRaw(start, &m_buffer[0], m_buffer.size());
+
+  for (size_t i = begin; i < end; ++i)
+  {
+    ArrayByteSource source(&m_buffer[table->GetFeatureOffset(indices[i]) - start]);
+    UNUSED_VALUE(ReadVarUint<uint32_t>(source));
+    m_recordOffsets.push_back(static_cast<uint32_t>(source.PtrC() - &m_buffer[0]));
+  }
+  return end;
+}
 
 FeaturesVectorTest::FeaturesVectorTest(string const & filePath)
   : FeaturesVectorTest((FilesContainerR(filePath, READER_CHUNK_LOG_SIZE, READER_CHUNK_LOG_COUNT)))
@@ -2,13 +2,22 @@
 #include "feature.hpp"
 #include "feature_loader_base.hpp"
 
+#include "coding/byte_stream.hpp"
 #include "coding/var_record_reader.hpp"
+#include "coding/varint.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
 
 
 namespace feature { class FeaturesOffsetsTable; }
 
-/// Note! This class is NOT Thread-Safe.
-/// You should have separate instance of Vector for every thread.
+/// Immutable part of the features storage: container readers, offsets table and load info.
+/// All const methods are thread-safe as long as readers of the container are thread-safe
+/// (for example, memory mapped ones). Records of the memory mapped container are decoded in place. The mutable decoding state lives in Cursor,
+/// so every thread should use its own cursor over a shared vector.
 class FeaturesVector
 {
   DISALLOW_COPY(FeaturesVector);
@@ -20,15 +29,97 @@ public:
   {
   }
 
-  void GetByIndex(uint32_t index, FeatureType & ft) const;
+  /// Lightweight reader of features from the vector. Owns a decoding buffer and
+  /// a feature loader, so it is NOT Thread-Safe. Note that a feature refers to
+  /// the cursor's buffer and is valid until the next GetByIndex call.
+  class Cursor
+  {
+    DISALLOW_COPY(Cursor);
+
+  public:
+    explicit Cursor(FeaturesVector const & vector);
+    Cursor(Cursor && cursor) = default;
+
+    void GetByIndex(uint32_t index, FeatureType & ft);
+
+    /// Reads features with given indices in storage order. Records which are close
+    /// to each other are fetched by a single read, so it's much faster than
+    /// GetByIndex calls for big batches. Indices are sorted and made unique in place.
+    template <class ToDo> void ForEachByIndex(vector<uint32_t> & indices, ToDo && toDo)
+    {
+      sort(indices.begin(), indices.end());
+      indices.erase(unique(indices.begin(), indices.end()), indices.end());
+
+      // Records are decoded in place when the data is memory mapped. The next batch is
+      // prefetched, so the reading overlaps with the decoding of the current one.
+      bool const mapped = m_vector->m_LoadInfo.GetDataSection().IsMapped();
+      for (size_t i = 0; i < indices.size();)
+      {
+        size_t const end = mapped ? GetBatch(indices, i).first : ReadRecords(indices, i);
+        PrefetchBatch(indices, end);
+        for (size_t j = i; j < end; ++j)
+        {
+          FeatureType ft;
+          if (mapped)
+            ft.Deserialize(m_loader.get(), GetMappedRecord(indices[j]));
+          else
+            ft.Deserialize(m_loader.get(), &m_buffer[m_recordOffsets[j - i]]);
+          toDo(ft, indices[j]);
+        }
+        i = end;
+      }
+    }
+
+  private:
+    /// @return Pointer to the data of the record in the memory mapped section.
+    char const * GetMappedRecord(uint32_t index) const;
+
+    /// Finds the batch of the records which are read by one call.
+    /// @return End of the range of indices and [start, finish) range of the batch data,
+    /// the data range is empty when the records sizes are unknown.
+    pair<size_t, pair<uint64_t, uint64_t>> GetBatch(vector<uint32_t> const & indices,
+                                                    size_t begin) const;
+
+    /// Prefetches the data of the batch starting from indices[begin].
+    void PrefetchBatch(vector<uint32_t> const & indices, size_t begin) const;
+
+    /// Reads records starting from indices[begin] into the buffer and fills
+    /// offsets of their data in m_recordOffsets.
+    /// @return End of the range of read indices.
+    size_t ReadRecords(vector<uint32_t> const & indices, size_t begin);
+
+    FeaturesVector const * m_vector;
+    unique_ptr<feature::LoaderBase> m_loader;
+    vector<char> m_buffer;
+    vector<uint32_t> m_recordOffsets;
+  };
 
   template <class ToDo> void ForEach(ToDo && toDo) const
   {
     uint32_t index = 0;
+    unique_ptr<feature::LoaderBase> const loader = m_LoadInfo.CreateLoader();
+
+    MappedSection const & section = m_LoadInfo.GetDataSection();
+    if (section.IsMapped())
+    {
+      uint64_t pos = 0;
+      while (pos < section.Size())
+      {
+        ArrayByteSource src = section.GetSource(pos);
+        uint32_t const size = ReadVarUint<uint32_t>(src);
+        FeatureType ft;
+        ft.Deserialize(loader.get(), src.PtrC());
+        toDo(ft, m_table ? index++ : static_cast<uint32_t>(pos));
+        pos = src.PtrUC() + size - section.Data();
+      }
+      ASSERT_EQUAL(pos, section.Size(), ());
+      return;
+    }
+
     m_RecordReader.ForEachRecord([&] (uint32_t pos, char const * data, uint32_t /*size*/)
     {
       FeatureType ft;
-      ft.Deserialize(m_LoadInfo.GetLoader(), data);
+      ft.Deserialize(loader.get(), data);
       toDo(ft, m_table ? index++ : pos);
     });
   }
@@ -47,7 +138,6 @@ private:
 
   feature::SharedLoadInfo m_LoadInfo;
   VarRecordReader<FilesContainerR::ReaderT, &VarRecordSizeReaderVarint> m_RecordReader;
-  mutable vector<char> m_buffer;
   feature::FeaturesOffsetsTable const * m_table;
 };
 
@@ -66,4 +156,7 @@ public:
 
   feature::DataHeader const & GetHeader() const { return m_header; }
   FeaturesVector const & GetVector() const { return m_vector; }
+  /// @return Offsets table or nullptr for the old formats.
+  feature::FeaturesOffsetsTable const * GetTable() const { return m_vector.m_table; }
+  FilesContainerR const & GetContainer() const { return m_cont; }
 };
@@ -10,6 +10,33 @@
 namespace ftypes
 {
 
+// static
+size_t const CheckerTypes::kBitsCount;
+
+void CheckerTypes::push_back(uint32_t type)
+{
+  m_types.push_back(type);
+  if (type < kBitsCount)
+    m_bits.set(type);
+}
+
+bool CheckerTypes::Has(uint32_t type) const
+{
+  if (type < kBitsCount)
+    return m_bits.test(type);
+  return find(m_types.begin(), m_types.end(), type) != m_types.end();
+}
+
+CheckerTypes & CheckerTypes::operator|=(CheckerTypes const & types)
+{
+  for (uint32_t type : types.m_types)
+  {
+    if (!Has(type))
+      push_back(type);
+  }
+  return *this;
+}
+
 uint32_t BaseChecker::PrepareToMatch(uint32_t type, uint8_t level)
 {
   ftype::TruncValue(type, level);
@@ -18,7 +45,7 @@ uint32_t BaseChecker::PrepareToMatch(uint32_t type, uint8_t level)
 
 bool BaseChecker::IsMatched(uint32_t type) const
 {
-  return (find(m_types.begin(), m_types.end(), PrepareToMatch(type, m_level)) != m_types.end());
+  return m_types.Has(PrepareToMatch(type, m_level));
 }
 
 bool BaseChecker::operator() (feature::TypesHolder const & types) const
@@ -2,6 +2,7 @@
 
 #include "base/base.hpp"
 
+#include "std/bitset.hpp"
 #include "std/vector.hpp"
 #include "std/string.hpp"
 
@@ -11,13 +12,39 @@ class FeatureType;
 namespace ftypes
 {
 
+/// Types of a checker. Types of two levels at most are less than 2^13, so they are kept
+/// in the bitset indexed by the type value and are matched by a single bit test.
+class CheckerTypes
+{
+public:
+  using const_iterator = vector<uint32_t>::const_iterator;
+
+  void push_back(uint32_t type);
+  bool Has(uint32_t type) const;
+
+  /// Adds the types of the other set.
+  CheckerTypes & operator|=(CheckerTypes const & types);
+
+  size_t size() const { return m_types.size(); }
+  bool empty() const { return m_types.empty(); }
+  uint32_t operator[](size_t i) const { return m_types[i]; }
+  const_iterator begin() const { return m_types.begin(); }
+  const_iterator end() const { return m_types.end(); }
+
+private:
+  static size_t const kBitsCount = 1 << 13;
+
+  vector<uint32_t> m_types;
+  bitset<kBitsCount> m_bits;
+};
+
 class BaseChecker
 {
   size_t const m_level;
   virtual bool IsMatched(uint32_t type) const;
 
 protected:
-  vector<uint32_t> m_types;
+  CheckerTypes m_types;
 
 public:
   BaseChecker(size_t level = 2) : m_level(level) {}
@@ -1,11 +1,17 @@
 #include "indexer/geometry_coding.hpp"
 
 #include "base/assert.hpp"
+#include "base/buffer_vector.hpp"
 #include "base/stl_add.hpp"
 
 #include "std/complex.hpp"
 #include "std/vector.hpp"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#define GEOMETRY_CODING_SSE2
+#include <emmintrin.h>
+#endif
+
 
 namespace
 {
@@ -67,6 +73,96 @@ m2::PointU PredictPointInTriangle(m2::PointU const & maxPoint,
 
 namespace geo_coding
 {
+void DecodeDeltasScalar(uint64_t const * deltas, size_t count, int32_t * diffs)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    uint32_t x, y;
+    bits::BitwiseSplit(deltas[i], x, y);
+    diffs[2 * i] = bits::ZigZagDecode(x);
+    diffs[2 * i + 1] = bits::ZigZagDecode(y);
+  }
+}
+
+#ifdef GEOMETRY_CODING_SSE2
+namespace
+{
+  /// Vectorized bits::PerfectUnshuffle for 4 lanes.
+  inline __m128i PerfectUnshuffle(__m128i x)
+  {
+    __m128i const m1 = _mm_set1_epi32(0x22222222), k1 = _mm_set1_epi32(0x99999999);
+    __m128i const m2 = _mm_set1_epi32(0x0C0C0C0C), k2 = _mm_set1_epi32(0xC3C3C3C3);
+    __m128i const m4 = _mm_set1_epi32(0x00F000F0), k4 = _mm_set1_epi32(0xF00FF00F);
+    __m128i const m8 = _mm_set1_epi32(0x0000FF00), k8 = _mm_set1_epi32(0xFF0000FF);
+
+    x = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(x, m1), 1),
+                                  _mm_and_si128(_mm_srli_epi32(x, 1), m1)), _mm_and_si128(x, k1));
+    x = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(x, m2), 2),
+                                  _mm_and_si128(_mm_srli_epi32(x, 2), m2)), _mm_and_si128(x, k2));
+    x = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(x, m4), 4),
+                                  _mm_and_si128(_mm_srli_epi32(x, 4), m4)), _mm_and_si128(x, k4));
+    x = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(x, m8), 8),
+                                  _mm_and_si128(_mm_srli_epi32(x, 8), m8)), _mm_and_si128(x, k8));
+    return x;
+  }
+}
+
+void DecodeDeltas(uint64_t const * deltas, size_t count, int32_t * diffs)
+{
+  // Each 64-bit lane (hi:lo) after unshuffle gives:
+  // x = (hi & 0xFFFF) << 16 | (lo & 0xFFFF), y = (hi & 0xFFFF0000) | (lo >> 16).
+  // Lanes are arranged as [x0, y0, x1, y1] with 64-bit shifts by 16 and per-lane masks.
+  __m128i const maskSelf = _mm_set_epi32(0xFFFF0000, 0x0000FFFF, 0xFFFF0000, 0x0000FFFF);
+  __m128i const maskRight = _mm_set_epi32(0, 0xFFFF0000, 0, 0xFFFF0000);
+  __m128i const maskLeft = _mm_set_epi32(0x0000FFFF, 0, 0x0000FFFF, 0);
+  __m128i const one = _mm_set1_epi32(1);
+  __m128i const zero = _mm_setzero_si128();
+
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2)
+  {
+    __m128i const v = PerfectUnshuffle(
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(deltas + i)));
+
+    __m128i const xy = _mm_or_si128(_mm_and_si128(v, maskSelf),
+                                    _mm_or_si128(_mm_and_si128(_mm_srli_epi64(v, 16), maskRight),
+                                                 _mm_and_si128(_mm_slli_epi64(v, 16), maskLeft)));
+
+    // ZigZagDecode: (x >> 1) ^ -(x & 1).
+    __m128i const res = _mm_xor_si128(_mm_srli_epi32(xy, 1),
+                                      _mm_sub_epi32(zero, _mm_and_si128(xy, one)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(diffs + 2 * i), res);
+  }
+
+  DecodeDeltasScalar(deltas + i, count - i, diffs + 2 * i);
+}
+#else
+void DecodeDeltas(uint64_t const * deltas, size_t count, int32_t * diffs)
+{
+  DecodeDeltasScalar(deltas, count, diffs);
+}
+#endif
+
+namespace
+{
+  /// Zig-zag decoded (dx, dy) pairs for all deltas of one polyline or triangle strip.
+  class DeltaDiffs
+  {
+    buffer_vector<int32_t, 64> m_diffs;
+
+  public:
+    explicit DeltaDiffs(InDeltasT const & deltas)
+    {
+      size_t const count = deltas.size();
+      m_diffs.resize(2 * count);
+      if (count > 0)
+        DecodeDeltas(&deltas[0], count, &m_diffs[0]);
+    }
+
+    int32_t const * operator[](size_t i) const { return &m_diffs[2 * i]; }
+  };
+}
+
   bool TestDecoding(InPointsT const & points,
                     m2::PointU const & basePoint,
                     m2::PointU const & maxPoint,
@@ -113,9 +209,10 @@ void DecodePolylinePrev1(InDeltasT const & deltas,
   size_t const count = deltas.size();
   if (count > 0)
   {
-    points.push_back(DecodeDelta(deltas[0], basePoint));
+    DeltaDiffs const diffs(deltas);
+    points.push_back(ApplyDelta(diffs[0], basePoint));
     for (size_t i = 1; i < count; ++i)
-      points.push_back(DecodeDelta(deltas[i], points.back()));
+      points.push_back(ApplyDelta(diffs[i], points.back()));
   }
 }
 
@@ -148,15 +245,16 @@ void DecodePolylinePrev2(InDeltasT const & deltas,
   size_t const count = deltas.size();
   if (count > 0)
   {
-    points.push_back(DecodeDelta(deltas[0], basePoint));
+    DeltaDiffs const diffs(deltas);
+    points.push_back(ApplyDelta(diffs[0], basePoint));
     if (count > 1)
     {
-      points.push_back(DecodeDelta(deltas[1], points.back()));
+      points.push_back(ApplyDelta(diffs[1], points.back()));
       for (size_t i = 2; i < count; ++i)
       {
         size_t const n = points.size();
-        points.push_back(DecodeDelta(deltas[i],
-                                     PredictPointInPolyline(maxPoint, points[n-1], points[n-2])));
+        points.push_back(ApplyDelta(diffs[i],
+                                    PredictPointInPolyline(maxPoint, points[n-1], points[n-2])));
       }
     }
   }
@@ -203,23 +301,24 @@ void DecodePolylinePrev3(InDeltasT const & deltas,
   ASSERT_LESS_OR_EQUAL(basePoint.y, maxPoint.y, (basePoint, maxPoint));
 
   size_t const count = deltas.size();
-  if (count> 0)
+  if (count > 0)
   {
-    points.push_back(DecodeDelta(deltas[0], basePoint));
+    DeltaDiffs const diffs(deltas);
+    points.push_back(ApplyDelta(diffs[0], basePoint));
     if (count > 1)
     {
       m2::PointU const pt0 = points.back();
-      points.push_back(DecodeDelta(deltas[1], pt0));
+      points.push_back(ApplyDelta(diffs[1], pt0));
       if (count > 2)
       {
-        points.push_back(DecodeDelta(deltas[2],
-                                     PredictPointInPolyline(maxPoint, points.back(), pt0)));
+        points.push_back(ApplyDelta(diffs[2],
+                                    PredictPointInPolyline(maxPoint, points.back(), pt0)));
         for (size_t i = 3; i < count; ++i)
         {
           size_t const n = points.size();
           m2::PointU const prediction =
               PredictPointInPolyline(maxPoint, points[n-1], points[n-2], points[n-3]);
-          points.push_back(DecodeDelta(deltas[i], prediction));
+          points.push_back(ApplyDelta(diffs[i], prediction));
         }
       }
     }
@@ -259,16 +358,17 @@ void DecodeTriangleStrip(InDeltasT const & deltas,
   {
     ASSERT_GREATER(count, 2, ());
 
-    points.push_back(DecodeDelta(deltas[0], basePoint));
-    points.push_back(DecodeDelta(deltas[1], points.back()));
-    points.push_back(DecodeDelta(deltas[2], points.back()));
+    DeltaDiffs const diffs(deltas);
+    points.push_back(ApplyDelta(diffs[0], basePoint));
+    points.push_back(ApplyDelta(diffs[1], points.back()));
+    points.push_back(ApplyDelta(diffs[2], points.back()));
 
     for (size_t i = 3; i < count; ++i)
     {
       size_t const n = points.size();
       m2::PointU const prediction =
           PredictPointInTriangle(maxPoint, points[n-1], points[n-2], points[n-3]);
-      points.push_back(DecodeDelta(deltas[i], prediction));
+      points.push_back(ApplyDelta(diffs[i], prediction));
     }
   }
 }
@@ -22,6 +22,13 @@ inline m2::PointU DecodeDelta(uint64_t delta, m2::PointU const & prediction)
   bits::BitwiseSplit(delta, x, y);
   return m2::PointU(prediction.x + bits::ZigZagDecode(x), prediction.y + bits::ZigZagDecode(y));
 }
+
+/// Apply (dx, dy) pair, produced by geo_coding::DecodeDeltas, to the prediction.
+/// ApplyDelta(diff, prediction) is equal to DecodeDelta(delta, prediction).
+inline m2::PointU ApplyDelta(int32_t const * diff, m2::PointU const & prediction)
+{
+  return m2::PointU(prediction.x + diff[0], prediction.y + diff[1]);
+}
 //@}
 
 
@@ -52,6 +59,14 @@ namespace geo_coding
   typedef array_read<uint64_t> InDeltasT;
   typedef array_write<uint64_t> OutDeltasT;
 
+/// @name Batch split of the deltas into zig-zag decoded coordinate differences.
+/// diffs[2*i] and diffs[2*i+1] are the x and y differences of deltas[i].
+//@{
+/// Vectorized (SSE2) when it's available, the result is always equal to DecodeDeltasScalar.
+void DecodeDeltas(uint64_t const * deltas, size_t count, int32_t * diffs);
+void DecodeDeltasScalar(uint64_t const * deltas, size_t count, int32_t * diffs);
+//@}
+
 void EncodePolylinePrev1(InPointsT const & points,
                          m2::PointU const & basePoint,
                          m2::PointU const & maxPoint,
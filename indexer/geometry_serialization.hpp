@@ -7,6 +7,7 @@
 
 #include "geometry/point2d.hpp"
 
+#include "coding/byte_stream.hpp"
 #include "coding/reader.hpp"
 #include "coding/writer.hpp"
 #include "coding/varint.hpp"
@@ -99,18 +100,35 @@ namespace serial
   void const * LoadInner(DecodeFunT fn, void const * pBeg, size_t count,
                          CodingParams const & params, OutPointsT & points);
 
+  /// @return Pointer to the next count bytes of the source, they are copied to the buffer
+  /// unless the source is in memory.
+  template <class TSource>
+  char const * GetBytes(TSource & src, size_t count, vector<char> & buffer)
+  {
+    buffer.resize(count);
+    src.Read(buffer.data(), count);
+    return buffer.data();
+  }
+  inline char const * GetBytes(ArrayByteSource & src, size_t count, vector<char> & /* buffer */)
+  {
+    char const * p = src.PtrC();
+    src.Advance(count);
+    return p;
+  }
+
   template <class TSource, class TPoints>
   void LoadOuter(DecodeFunT fn, TSource & src, CodingParams const & params,
                  TPoints & points, size_t reserveF = 1)
   {
     uint32_t const count = ReadVarUint<uint32_t>(src);
-    vector<char> buffer(count);
-    char * p = &buffer[0];
-    src.Read(p, count);
+    vector<char> buffer;
+    char const * p = GetBytes(src, count, buffer);
 
+    // There are not more deltas than bytes.
     DeltasT deltas;
-    deltas.reserve(count / 2);
-    ReadVarUint64Array(p, p + count, MakeBackInsertFunctor(deltas));
+    deltas.resize_no_init(count);
+    uint8_t const * pBeg = reinterpret_cast<uint8_t const *>(p);
+    deltas.resize_no_init(DecodeVarUint64Array(pBeg, pBeg + count, deltas.data()));
 
     Decode(fn, deltas, params, points, reserveF);
   }
@@ -0,0 +1,281 @@
+#include "indexer/houses_index.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/endianness.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/utility.hpp"
+
+namespace indexer
+{
+namespace
+{
+uint32_t const kHeaderSize = 4 * sizeof(uint32_t);
+uint32_t const kStreetEntrySize = 2 * sizeof(uint32_t);
+
+/// Splits the normalized number to its leading integer without the leading zeros and the rest.
+void SplitNumber(string const & number, string & integer, string & rest)
+{
+  size_t start = 0;
+  while (start < number.size() && number[start] == '0')
+    ++start;
+  size_t end = start;
+  while (end < number.size() && number[end] >= '0' && number[end] <= '9')
+    ++end;
+  // "0" is the integer too.
+  if (end == start && start != 0)
+    --start;
+  integer = number.substr(start, end - start);
+  rest = number.substr(end);
+}
+
+/// Compares the leading integers, the numbers without them go after the ones with them.
+int CompareIntegers(string const & i1, string const & i2)
+{
+  if (i1.empty() != i2.empty())
+    return i1.empty() ? 1 : -1;
+  if (i1.size() != i2.size())
+    return i1.size() < i2.size() ? -1 : 1;
+  return i1.compare(i2);
+}
+
+struct NumberKey
+{
+  explicit NumberKey(string const & normalized)
+  {
+    SplitNumber(normalized, m_integer, m_rest);
+  }
+
+  bool operator<(NumberKey const & rhs) const
+  {
+    int const cmp = CompareIntegers(m_integer, rhs.m_integer);
+    if (cmp != 0)
+      return cmp < 0;
+    return m_rest < rhs.m_rest;
+  }
+
+  string m_integer;
+  string m_rest;
+};
+
+struct LessInteger
+{
+  bool operator()(NumberKey const & k1, NumberKey const & k2) const
+  {
+    return CompareIntegers(k1.m_integer, k2.m_integer) < 0;
+  }
+};
+}  // namespace
+
+string NormalizeHouseNumber(string const & number)
+{
+  string res = strings::MakeLowerCase(number);
+  res.erase(remove_if(res.begin(), res.end(), [](char c)
+            {
+              return c == ' ' || c == '\t';
+            }),
+            res.end());
+  return res;
+}
+
+bool LessHouseNumber(string const & n1, string const & n2)
+{
+  return NumberKey(n1) < NumberKey(n2);
+}
+
+bool EqualHouseNumberInteger(string const & n1, string const & n2)
+{
+  NumberKey const k1(n1);
+  NumberKey const k2(n2);
+  return !k1.m_integer.empty() && k1.m_integer == k2.m_integer;
+}
+
+// static
+uint32_t const HousesIndex::kVersion;
+
+// static
+void HousesIndex::Serialize(vector<Street> const & streets, uint32_t coordBits, Writer & writer)
+{
+  vector<Street const *> sorted;
+  for (Street const & street : streets)
+  {
+    if (!street.m_houses.empty())
+      sorted.push_back(&street);
+  }
+  sort(sorted.begin(), sorted.end(), [](Street const * s1, Street const * s2)
+  {
+    return s1->m_featureId < s2->m_featureId;
+  });
+
+  vector<pair<uint32_t, uint32_t>> entries;
+  vector<char> blocks;
+  MemWriter<vector<char>> blocksWriter(blocks);
+  for (Street const * street : sorted)
+  {
+    CHECK(entries.empty() || entries.back().first < street->m_featureId,
+          ("Duplicate street", street->m_featureId));
+    entries.emplace_back(street->m_featureId, static_cast<uint32_t>(blocks.size()));
+
+    vector<pair<NumberKey, House const *>> houses;
+    for (House const & house : street->m_houses)
+      houses.emplace_back(NumberKey(NormalizeHouseNumber(house.m_number)), &house);
+    stable_sort(houses.begin(), houses.end(),
+                [](pair<NumberKey, House const *> const & h1, pair<NumberKey, House const *> const & h2)
+                {
+                  return h1.first < h2.first;
+                });
+
+    WriteVarUint(blocksWriter, static_cast<uint32_t>(houses.size()));
+    for (auto const & house : houses)
+    {
+      m2::PointU const pu = PointD2PointU(house.second->m_point, coordBits);
+      rw::Write(blocksWriter, house.second->m_number);
+      WriteVarUint(blocksWriter, house.second->m_featureId);
+      WriteVarUint(blocksWriter, pu.x);
+      WriteVarUint(blocksWriter, pu.y);
+    }
+  }
+
+  WriteToSink(writer, kVersion);
+  WriteToSink(writer, coordBits);
+  WriteToSink(writer, static_cast<uint32_t>(entries.size()));
+  WriteToSink(writer, static_cast<uint32_t>(blocks.size()));
+  for (auto const & entry : entries)
+  {
+    WriteToSink(writer, entry.first);
+    WriteToSink(writer, entry.second);
+  }
+  writer.Write(blocks.data(), blocks.size());
+}
+
+bool HousesIndex::Load(ModelReaderPtr const & reader)
+{
+  m_reader = ReaderPtr<ModelReader>();
+  m_streetsCount = 0;
+
+  if (reader.Size() < kHeaderSize)
+  {
+    LOG(LWARNING, ("Malformed houses index header."));
+    return false;
+  }
+
+  ReaderSource<ModelReaderPtr> src(reader);
+  uint32_t const version = ReadPrimitiveFromSource<uint32_t>(src);
+  if (version != kVersion)
+  {
+    LOG(LWARNING, ("Unknown houses index version:", version));
+    return false;
+  }
+
+  uint32_t const coordBits = ReadPrimitiveFromSource<uint32_t>(src);
+  uint32_t const streetsCount = ReadPrimitiveFromSource<uint32_t>(src);
+  uint32_t const blocksSize = ReadPrimitiveFromSource<uint32_t>(src);
+  if (coordBits == 0 || coordBits > 32 ||
+      reader.Size() != kHeaderSize + uint64_t(streetsCount) * kStreetEntrySize + blocksSize)
+  {
+    LOG(LWARNING, ("Malformed houses index header."));
+    return false;
+  }
+
+  m_reader = reader;
+  m_coordBits = coordBits;
+  m_streetsCount = streetsCount;
+  m_blocksSize = blocksSize;
+  return true;
+}
+
+bool HousesIndex::GetHouses(uint32_t streetFeatureId, string const & number,
+                            vector<House> & houses) const
+{
+  vector<House> street;
+  if (!GetStreetHouses(streetFeatureId, street))
+    return false;
+
+  vector<NumberKey> keys;
+  keys.reserve(street.size());
+  for (House const & house : street)
+    keys.emplace_back(NormalizeHouseNumber(house.m_number));
+
+  NumberKey const key(NormalizeHouseNumber(number));
+  auto range = equal_range(keys.begin(), keys.end(), key);
+  if (range.first == range.second && !key.m_integer.empty())
+    range = equal_range(keys.begin(), keys.end(), key, LessInteger());
+
+  for (auto it = range.first; it != range.second; ++it)
+    houses.push_back(street[distance(keys.begin(), it)]);
+  return true;
+}
+
+bool HousesIndex::GetStreetHouses(uint32_t streetFeatureId, vector<House> & houses) const
+{
+  // Binary search of the street in the table.
+  uint32_t lo = 0;
+  uint32_t hi = m_streetsCount;
+  uint32_t featureId = 0;
+  uint32_t offset = 0;
+  while (lo < hi)
+  {
+    uint32_t const mid = lo + (hi - lo) / 2;
+    ReadStreetEntry(mid, featureId, offset);
+    if (featureId < streetFeatureId)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo == m_streetsCount)
+    return false;
+  ReadStreetEntry(lo, featureId, offset);
+  if (featureId != streetFeatureId)
+    return false;
+
+  uint32_t end = m_blocksSize;
+  if (lo + 1 < m_streetsCount)
+  {
+    uint32_t nextFeatureId;
+    ReadStreetEntry(lo + 1, nextFeatureId, end);
+  }
+  if (offset >= end || end > m_blocksSize)
+  {
+    LOG(LWARNING, ("Malformed houses index street", streetFeatureId));
+    return false;
+  }
+
+  vector<char> block(end - offset);
+  m_reader.Read(kHeaderSize + uint64_t(m_streetsCount) * kStreetEntrySize + offset, block.data(),
+                block.size());
+  MemReader blockReader(block.data(), block.size());
+  ReaderSource<MemReader> src(blockReader);
+
+  uint32_t const count = ReadVarUint<uint32_t>(src);
+  houses.reserve(houses.size() + count);
+  for (uint32_t i = 0; i < count && src.Size() > 0; ++i)
+  {
+    House house;
+    rw::Read(src, house.m_number);
+    house.m_featureId = ReadVarUint<uint32_t>(src);
+    m2::PointU pu;
+    pu.x = ReadVarUint<uint32_t>(src);
+    pu.y = ReadVarUint<uint32_t>(src);
+    house.m_point = PointU2PointD(pu, m_coordBits);
+    houses.push_back(move(house));
+  }
+  return true;
+}
+
+void HousesIndex::ReadStreetEntry(uint32_t i, uint32_t & featureId, uint32_t & offset) const
+{
+  uint32_t entry[2];
+  m_reader.Read(kHeaderSize + uint64_t(i) * kStreetEntrySize, entry, sizeof(entry));
+  featureId = SwapIfBigEndian(entry[0]);
+  offset = SwapIfBigEndian(entry[1]);
+}
+}  // namespace indexer
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "coding/reader.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+namespace indexer
+{
+/// @return House number in lower case without spaces, e.g. "12 A" -> "12a".
+string NormalizeHouseNumber(string const & number);
+
+/// Compares the normalized house numbers by their leading integers, then by the rest of them,
+/// so "9" < "10" < "10a" < "10b" < "11".
+bool LessHouseNumber(string const & n1, string const & n2);
+
+/// @return true if the normalized numbers have the same leading integer, e.g. "10" and "10a".
+bool EqualHouseNumberInteger(string const & n1, string const & n2);
+
+/// Houses of the streets, which are attributed by the generator, so the address search looks
+/// the houses of a street up instead of projecting the nearby buildings to the street. The streets
+/// are sorted by the feature ids and the houses of a street by the normalized numbers, the
+/// section is read lazily, a lookup reads a few entries of the streets table and the houses of
+/// the street.
+class HousesIndex
+{
+public:
+  struct House
+  {
+    House() : m_featureId(0) {}
+    House(string const & number, uint32_t featureId, m2::PointD const & point)
+      : m_number(number), m_featureId(featureId), m_point(point)
+    {
+    }
+
+    /// Number as it's in the feature.
+    string m_number;
+    uint32_t m_featureId;
+    m2::PointD m_point;
+  };
+
+  struct Street
+  {
+    uint32_t m_featureId = 0;
+    vector<House> m_houses;
+  };
+
+  static uint32_t const kVersion = 0;
+
+  /// Writes the index, points are quantized with |coordBits| as feature points are.
+  static void Serialize(vector<Street> const & streets, uint32_t coordBits, Writer & writer);
+
+  /// Reads the header of the section, the reader is kept by the index.
+  /// @return False when the data are malformed or of an unknown version.
+  bool Load(ModelReaderPtr const & reader);
+
+  inline bool IsEmpty() const { return m_streetsCount == 0; }
+  inline uint32_t GetStreetsCount() const { return m_streetsCount; }
+
+  /// Adds the houses of the street with the number to |houses|: the ones with the same
+  /// normalized number or, if there are none, with the same leading integer.
+  /// @return False if the street is not in the index.
+  bool GetHouses(uint32_t streetFeatureId, string const & number, vector<House> & houses) const;
+
+  /// Reads all the houses of the street in the order of their numbers.
+  bool GetStreetHouses(uint32_t streetFeatureId, vector<House> & houses) const;
+
+private:
+  void ReadStreetEntry(uint32_t i, uint32_t & featureId, uint32_t & offset) const;
+
+  ReaderPtr<ModelReader> m_reader;
+  uint32_t m_coordBits = 0;
+  uint32_t m_streetsCount = 0;
+  uint32_t m_blocksSize = 0;
+};
+}  // namespace indexer
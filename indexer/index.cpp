@@ -4,6 +4,8 @@
 
 #include "coding/file_name_utils.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/mapped_section.hpp"
+#include "coding/mmap_policy.hpp"
 
 #include "base/logging.hpp"
 
@@ -17,19 +19,58 @@ using platform::LocalCountryFile;
 MwmValue::MwmValue(LocalCountryFile const & localFile)
     : m_cont(platform::GetCountryReader(localFile, MapOptions::Map)),
       m_file(localFile),
-      m_table(0)
+      m_table(0),
+      m_scalesTable(nullptr),
+      m_attributesTable(nullptr),
+      m_coarseCellsIndex(nullptr)
 {
   m_factory.Load(m_cont);
+
+  // The search trie is read at random, so the readahead only fills the page cache with
+  // the nodes which aren't needed.
+  if (m_cont.IsExist(SEARCH_INDEX_FILE_TAG))
+  {
+    MappedSection(m_cont.GetReader(SEARCH_INDEX_FILE_TAG))
+        .Advise(mmap_policy::Get(SEARCH_INDEX_FILE_TAG, mmap_policy::Random));
+  }
 }
 
 void MwmValue::SetTable(MwmInfoEx & info)
 {
-  if (GetHeader().GetFormat() < version::v5)
-    return;
-
-  if (!info.m_table)
-    info.m_table = feature::FeaturesOffsetsTable::CreateIfNotExistsAndLoad(m_file, m_cont);
-  m_table = info.m_table.get();
+  lock_guard<mutex> lock(info.m_tablesMutex);
+  if (GetHeader().GetFormat() >= version::v5)
+  {
+    if (!info.m_table)
+      info.m_table = feature::FeaturesOffsetsTable::CreateIfNotExistsAndLoad(m_file, m_cont);
+    m_table = info.m_table.get();
+  }
+
+  if (!info.m_scalesTable && m_cont.IsExist(FEATURE_SCALES_FILE_TAG))
+  {
+    auto table = make_unique<feature::ScalesTable>();
+    if (table->Load(m_cont.GetReader(FEATURE_SCALES_FILE_TAG)))
+      info.m_scalesTable = move(table);
+  }
+  m_scalesTable = info.m_scalesTable.get();
+
+  if (!info.m_attributesTable && m_cont.IsExist(FEATURE_ATTRIBUTES_FILE_TAG))
+  {
+    auto table = make_unique<feature::AttributesTable>();
+    if (table->Load(m_cont.GetReader(FEATURE_ATTRIBUTES_FILE_TAG)))
+      info.m_attributesTable = move(table);
+  }
+  m_attributesTable = info.m_attributesTable.get();
+
+  if (!info.m_coarseCellsIndex && m_cont.IsExist(COARSE_CELLS_INDEX_FILE_TAG))
+  {
+    auto index = make_unique<covering::CoarseCellsIndex>();
+    if (index->Load(m_cont.GetReader(COARSE_CELLS_INDEX_FILE_TAG)))
+      info.m_coarseCellsIndex = move(index);
+  }
+  m_coarseCellsIndex = info.m_coarseCellsIndex.get();
+
+  m_features = make_unique<FeaturesVector>(m_cont, GetHeader(), m_table);
+  m_scaleIndex = make_unique<ScaleIndex<ModelReaderPtr>>(m_cont.GetReader(INDEX_FILE_TAG), m_factory);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -38,6 +79,17 @@ void MwmValue::SetTable(MwmInfoEx & info)
 
 unique_ptr<MwmInfo> Index::CreateInfo(platform::LocalCountryFile const & localFile) const
 {
+  MwmInfoCache::Entry entry;
+  if (m_infoCache && m_infoCache->Find(localFile, entry))
+  {
+    unique_ptr<MwmInfoEx> info(new MwmInfoEx());
+    info->m_limitRect = entry.m_limitRect;
+    info->m_minScale = entry.m_minScale;
+    info->m_maxScale = entry.m_maxScale;
+    info->m_version = entry.m_version;
+    return unique_ptr<MwmInfo>(move(info));
+  }
+
   MwmValue value(localFile);
 
   feature::DataHeader const & h = value.GetHeader();
@@ -52,6 +104,15 @@ unique_ptr<MwmInfo> Index::CreateInfo(platform::LocalCountryFile const & localFi
   info->m_maxScale = static_cast<uint8_t>(scaleR.second);
   info->m_version = value.GetMwmVersion();
 
+  if (m_infoCache)
+  {
+    entry.m_limitRect = info->m_limitRect;
+    entry.m_minScale = info->m_minScale;
+    entry.m_maxScale = info->m_maxScale;
+    entry.m_version = info->m_version;
+    m_infoCache->Add(localFile, entry);
+  }
+
   return unique_ptr<MwmInfo>(move(info));
 }
 
@@ -73,6 +134,15 @@ pair<MwmSet::MwmId, MwmSet::RegResult> Index::RegisterMap(LocalCountryFile const
 
 bool Index::DeregisterMap(CountryFile const & countryFile) { return Deregister(countryFile); }
 
+void Index::SaveInfoCache()
+{
+  if (!m_infoCache)
+    return;
+  LOG(LINFO, ("Mwm info cache hits:", m_infoCache->GetHitsCount(), "misses:",
+              m_infoCache->GetMissesCount()));
+  m_infoCache->Save();
+}
+
 bool Index::AddObserver(Observer & observer) { return m_observers.Add(observer); }
 
 bool Index::RemoveObserver(Observer const & observer) { return m_observers.Remove(observer); }
@@ -82,6 +152,68 @@ void Index::OnMwmDeregistered(LocalCountryFile const & localFile)
   m_observers.ForEach(&Observer::OnMapDeregistered, localFile);
 }
 
+void Index::SetQueryThreadsCount(size_t count)
+{
+  m_queryPool.reset();
+  if (count != 0)
+  {
+    m_queryPool.reset(new threads::TaskScheduler(count));
+  }
+}
+
+void Index::GetMwmsInRect(m2::RectD const & rect, uint32_t scale, vector<MwmId> & ids) const
+{
+  vector<shared_ptr<MwmInfo>> mwms;
+  GetMwmsInfo(mwms);
+
+  MwmId worldID[2];
+
+  for (shared_ptr<MwmInfo> const & info : mwms)
+  {
+    if (info->m_minScale <= scale && scale <= info->m_maxScale &&
+        rect.IsIntersect(info->m_limitRect))
+    {
+      MwmId id(info);
+      switch (info->GetType())
+      {
+        case MwmInfo::COUNTRY:
+          ids.push_back(id);
+          break;
+
+        case MwmInfo::COASTS:
+          worldID[0] = id;
+          break;
+
+        case MwmInfo::WORLD:
+          worldID[1] = id;
+          break;
+      }
+    }
+  }
+
+  for (MwmId const & id : worldID)
+  {
+    if (id.IsAlive())
+      ids.push_back(id);
+  }
+}
+
+void Index::RunQueryTasks(vector<function<void()>> const & tasks) const
+{
+  if (!m_queryPool || tasks.size() < 2)
+  {
+    for (auto const & task : tasks)
+      task();
+    return;
+  }
+
+  // The calling thread runs the tasks too while it waits for them.
+  threads::TaskGroup group(*m_queryPool);
+  for (auto const & task : tasks)
+    group.Run([&task]() { task(); });
+  group.Wait();
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 // Index::FeaturesLoaderGuard implementation
 //////////////////////////////////////////////////////////////////////////////////
@@ -89,9 +221,7 @@ void Index::OnMwmDeregistered(LocalCountryFile const & localFile)
 Index::FeaturesLoaderGuard::FeaturesLoaderGuard(Index const & parent, MwmId id)
     : m_handle(parent.GetMwmHandleById(id)),
       /// @note This guard is suitable when mwm is loaded
-      m_vector(m_handle.GetValue<MwmValue>()->m_cont,
-               m_handle.GetValue<MwmValue>()->GetHeader(),
-               m_handle.GetValue<MwmValue>()->m_table)
+      m_cursor(m_handle.GetValue<MwmValue>()->GetFeatures())
 {
 }
 
@@ -109,6 +239,6 @@ bool Index::FeaturesLoaderGuard::IsWorld() const
 
 void Index::FeaturesLoaderGuard::GetFeatureByIndex(uint32_t index, FeatureType & ft)
 {
-  m_vector.GetByIndex(index, ft);
+  m_cursor.GetByIndex(index, ft);
   ft.SetID(FeatureID(m_handle.GetId(), index));
 }
@@ -1,9 +1,13 @@
 #pragma once
 #include "indexer/cell_id.hpp"
+#include "indexer/coarse_cells_index.hpp"
 #include "indexer/data_factory.hpp"
+#include "indexer/feature_attributes_table.hpp"
 #include "indexer/feature_covering.hpp"
+#include "indexer/feature_scales_table.hpp"
 #include "indexer/features_offsets_table.hpp"
 #include "indexer/features_vector.hpp"
+#include "indexer/mwm_info_cache.hpp"
 #include "indexer/mwm_set.hpp"
 #include "indexer/scale_index.hpp"
 #include "indexer/unique_index.hpp"
@@ -14,9 +18,13 @@
 
 #include "base/macros.hpp"
 #include "base/observer_list.hpp"
+#include "base/task_scheduler.hpp"
 
 #include "std/algorithm.hpp"
+#include "std/function.hpp"
 #include "std/limits.hpp"
+#include "std/mutex.hpp"
+#include "std/unique_ptr.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
 
@@ -24,7 +32,13 @@
 class MwmInfoEx : public MwmInfo
 {
 public:
+  /// Values of the mwm are created out of the MwmSet lock, several threads may open the mwm
+  /// at once, so the tables below are loaded under this mutex.
+  mutex m_tablesMutex;
   unique_ptr<feature::FeaturesOffsetsTable> m_table;
+  unique_ptr<feature::ScalesTable> m_scalesTable;
+  unique_ptr<feature::AttributesTable> m_attributesTable;
+  unique_ptr<covering::CoarseCellsIndex> m_coarseCellsIndex;
 };
 
 class MwmValue : public MwmSet::MwmValueBase
@@ -34,13 +48,38 @@ public:
   IndexFactory m_factory;
   platform::LocalCountryFile const m_file;
   feature::FeaturesOffsetsTable const * m_table;
+  /// Scale ranges of the features, nullptr when the mwm has no such section.
+  feature::ScalesTable const * m_scalesTable;
+  /// Columns of the search attributes of the features, nullptr when the mwm has no such section.
+  feature::AttributesTable const * m_attributesTable;
+  /// Features of the coarse cells for the low scales, it's built for the world mwms only.
+  covering::CoarseCellsIndex const * m_coarseCellsIndex;
 
   explicit MwmValue(platform::LocalCountryFile const & localFile);
   void SetTable(MwmInfoEx & info);
 
+  /// Features of the mwm, shared by all readers of this value.
+  /// Use FeaturesVector::Cursor to read them.
+  inline FeaturesVector const & GetFeatures() const
+  {
+    ASSERT(m_features, ("SetTable should be called first."));
+    return *m_features;
+  }
+
+  /// Geometry index of the mwm. It's loaded once and shared by all queries to this value.
+  inline ScaleIndex<ModelReaderPtr> const & GetScaleIndex() const
+  {
+    ASSERT(m_scaleIndex, ("SetTable should be called first."));
+    return *m_scaleIndex;
+  }
+
   inline feature::DataHeader const & GetHeader() const { return m_factory.GetHeader(); }
   inline version::MwmVersion const & GetMwmVersion() const { return m_factory.GetMwmVersion(); }
   inline string const & GetCountryFileName() const { return m_file.GetCountryFile().GetNameWithoutExt(); }
+
+private:
+  unique_ptr<FeaturesVector> m_features;
+  unique_ptr<ScaleIndex<ModelReaderPtr>> m_scaleIndex;
 };
 
 class Index : public MwmSet
@@ -83,6 +122,10 @@ public:
   ///         now, returns false.
   bool DeregisterMap(platform::CountryFile const & countryFile);
 
+  /// Registration takes the mwm info from the cache, when it's there, without opening the file.
+  void SetInfoCache(unique_ptr<MwmInfoCache> && cache) { m_infoCache = move(cache); }
+  void SaveInfoCache();
+
   bool AddObserver(Observer & observer);
 
   bool RemoveObserver(Observer const & observer);
@@ -108,33 +151,40 @@ private:
         // In case of WorldCoasts we should pass correct scale in ForEachInIntervalAndScale.
         if (scale > lastScale) scale = lastScale;
 
-        // Use last coding scale for covering (see index_builder.cpp).
-        covering::IntervalsT const & interval = cov.Get(lastScale);
-
         // prepare features reading
-        FeaturesVector fv(pValue->m_cont, header, pValue->m_table);
-        ScaleIndex<ModelReaderPtr> index(pValue->m_cont.GetReader(INDEX_FILE_TAG),
-                                         pValue->m_factory);
-
-        // iterate through intervals
+        FeaturesVector::Cursor fv(pValue->GetFeatures());
         CheckUniqueIndexes checkUnique(header.GetFormat() >= version::v5);
         MwmId const mwmID = handle.GetId();
 
-        for (auto const & i : interval)
+        auto const readFeature = [&](uint32_t index)
         {
-          index.ForEachInIntervalAndScale([&] (uint32_t index)
+          if (checkUnique(index))
           {
-            if (checkUnique(index))
-            {
-              FeatureType feature;
+            FeatureType feature;
 
-              fv.GetByIndex(index, feature);
-              feature.SetID(FeatureID(mwmID, index));
+            fv.GetByIndex(index, feature);
+            feature.SetID(FeatureID(mwmID, index));
 
-              m_f(feature);
-            }
-          }, i.first, i.second, scale);
+            m_f(feature);
+          }
+        };
+
+        // Low scale viewports are read by the precomputed cells instead of the detailed covering.
+        covering::CoarseCellsIndex const * coarse = pValue->m_coarseCellsIndex;
+        if (coarse && cov.GetMode() == covering::ViewportWithLowLevels &&
+            scale <= coarse->GetMaxScale())
+        {
+          coarse->ForEachInRect(cov.GetRect(), scale, readFeature);
+          return;
         }
+
+        // Use last coding scale for covering (see index_builder.cpp).
+        covering::IntervalsT const & interval = cov.Get(lastScale);
+        ScaleIndex<ModelReaderPtr> const & index = pValue->GetScaleIndex();
+
+        // iterate through intervals
+        for (auto const & i : interval)
+          index.ForEachInIntervalAndScale(readFeature, i.first, i.second, scale);
       }
     }
   };
@@ -160,8 +210,7 @@ private:
 
         // Use last coding scale for covering (see index_builder.cpp).
         covering::IntervalsT const & interval = cov.Get(lastScale);
-        ScaleIndex<ModelReaderPtr> index(pValue->m_cont.GetReader(INDEX_FILE_TAG),
-                                         pValue->m_factory);
+        ScaleIndex<ModelReaderPtr> const & index = pValue->GetScaleIndex();
 
         // iterate through intervals
         CheckUniqueIndexes checkUnique(header.GetFormat() >= version::v5);
@@ -202,6 +251,62 @@ public:
     ForEachInIntervals(implFunctor, covering::LowLevelsOnly, rect, scale);
   }
 
+  /// @name Parallel queries.
+  //@{
+  /// Creates a task scheduler of |count| workers for ForEachInRectParallel and RunQueryTasks.
+  /// Zero count destroys the pool, so queries run on the calling thread.
+  void SetQueryThreadsCount(size_t count);
+
+  /// Runs tasks on the query thread pool (or on the calling thread, if there is no pool)
+  /// and waits for all of them. The first exception thrown by a task is rethrown.
+  void RunQueryTasks(vector<function<void()>> const & tasks) const;
+
+  /// The same as ForEachInRect, but mwms are read concurrently on the query thread pool.
+  /// |makeSink| is called on the calling thread once per mwm and returns a functor, which
+  /// gets features of that mwm on a worker thread. Every sink is used by one thread only.
+  /// @return Sinks in the ForEachInRect order (countries, then coasts and world),
+  /// so the caller can merge them deterministically.
+  template <typename TMakeSink>
+  auto ForEachInRectParallel(TMakeSink && makeSink, m2::RectD const & rect, uint32_t scale) const
+      -> vector<decltype(makeSink())>
+  {
+    using TSink = decltype(makeSink());
+
+    vector<MwmId> ids;
+    GetMwmsInRect(rect, scale, ids);
+
+    covering::CoveringGetter cov(rect, covering::ViewportWithLowLevels);
+    vector<MwmHandle> handles;
+    handles.reserve(ids.size());
+    vector<TSink> sinks;
+    sinks.reserve(ids.size());
+    for (MwmId const & id : ids)
+    {
+      handles.push_back(GetMwmHandleById(id));
+      sinks.push_back(makeSink());
+
+      // CoveringGetter caches intervals lazily, so fill the cache
+      // here and give every task its own copy.
+      MwmValue const * pValue = handles.back().GetValue<MwmValue>();
+      if (pValue)
+        cov.Get(pValue->GetHeader().GetLastScale());
+    }
+
+    vector<function<void()>> tasks;
+    tasks.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      tasks.emplace_back([&, i, cov]() mutable
+      {
+        ReadMWMFunctor<TSink> fn(sinks[i]);
+        fn(handles[i], cov, scale);
+      });
+    }
+    RunQueryTasks(tasks);
+    return sinks;
+  }
+  //@}
+
   template <typename F>
   void ForEachInScale(F & f, uint32_t scale) const
   {
@@ -218,6 +323,24 @@ public:
       currentIndex = ReadFeatureRange(f, features, currentIndex);
   }
 
+  /// Reads features of a single mwm in storage order (see FeaturesVector::Cursor::ForEachByIndex),
+  /// so it is much faster than reading of the features one by one for big batches.
+  template <typename F>
+  void ReadFeatures(MwmId const & id, vector<uint32_t> ids, F && f) const
+  {
+    MwmHandle const handle = GetMwmHandleById(id);
+    MwmValue const * pValue = handle.GetValue<MwmValue>();
+    if (!pValue)
+      return;
+
+    FeaturesVector::Cursor cursor(pValue->GetFeatures());
+    cursor.ForEachByIndex(ids, [&](FeatureType & ft, uint32_t index)
+    {
+      ft.SetID(FeatureID(id, index));
+      f(ft);
+    });
+  }
+
   /// Guard for loading features from particular MWM by demand.
   class FeaturesLoaderGuard
   {
@@ -229,9 +352,19 @@ public:
     bool IsWorld() const;
     void GetFeatureByIndex(uint32_t index, FeatureType & ft);
 
+    /// Reads features in storage order, see Index::ReadFeatures.
+    template <typename F> void ReadFeatures(vector<uint32_t> & indices, F && f)
+    {
+      m_cursor.ForEachByIndex(indices, [&](FeatureType & ft, uint32_t index)
+      {
+        ft.SetID(FeatureID(m_handle.GetId(), index));
+        f(ft);
+      });
+    }
+
   private:
     MwmHandle m_handle;
-    FeaturesVector m_vector;
+    FeaturesVector::Cursor m_cursor;
   };
 
   template <typename F>
@@ -259,18 +392,16 @@ private:
     MwmValue const * pValue = handle.GetValue<MwmValue>();
     if (pValue)
     {
-      FeaturesVector featureReader(pValue->m_cont, pValue->GetHeader(), pValue->m_table);
+      vector<uint32_t> indices;
       while (result < features.size() && id == features[result].m_mwmId)
-      {
-        FeatureID const & featureId = features[result];
-        FeatureType featureType;
-
-        featureReader.GetByIndex(featureId.m_index, featureType);
-        featureType.SetID(featureId);
+        indices.push_back(features[result++].m_index);
 
+      FeaturesVector::Cursor featureReader(pValue->GetFeatures());
+      featureReader.ForEachByIndex(indices, [&](FeatureType & featureType, uint32_t index)
+      {
+        featureType.SetID(FeatureID(id, index));
         f(featureType);
-        ++result;
-      }
+      });
     }
     else
     {
@@ -285,55 +416,26 @@ private:
     return result;
   }
 
+  /// Collects mwms, which should be visited by a query in |rect| at |scale|:
+  /// countries go first, then coasts and world.
+  void GetMwmsInRect(m2::RectD const & rect, uint32_t scale, vector<MwmId> & ids) const;
+
   template <typename F>
   void ForEachInIntervals(F & f, covering::CoveringMode mode, m2::RectD const & rect,
                           uint32_t scale) const
   {
-    vector<shared_ptr<MwmInfo>> mwms;
-    GetMwmsInfo(mwms);
+    vector<MwmId> ids;
+    GetMwmsInRect(rect, scale, ids);
 
     covering::CoveringGetter cov(rect, mode);
-
-    MwmId worldID[2];
-
-    for (shared_ptr<MwmInfo> const & info : mwms)
-    {
-      if (info->m_minScale <= scale && scale <= info->m_maxScale &&
-          rect.IsIntersect(info->m_limitRect))
-      {
-        MwmId id(info);
-        switch (info->GetType())
-        {
-          case MwmInfo::COUNTRY:
-          {
-            MwmHandle const handle = GetMwmHandleById(id);
-            f(handle, cov, scale);
-          }
-          break;
-
-          case MwmInfo::COASTS:
-            worldID[0] = id;
-            break;
-
-          case MwmInfo::WORLD:
-            worldID[1] = id;
-            break;
-        }
-      }
-    }
-
-    if (worldID[0].IsAlive())
-    {
-      MwmHandle const handle = GetMwmHandleById(worldID[0]);
-      f(handle, cov, scale);
-    }
-
-    if (worldID[1].IsAlive())
+    for (MwmId const & id : ids)
     {
-      MwmHandle const handle = GetMwmHandleById(worldID[1]);
+      MwmHandle const handle = GetMwmHandleById(id);
       f(handle, cov, scale);
     }
   }
 
   my::ObserverList<Observer> m_observers;
+  unique_ptr<threads::TaskScheduler> m_queryPool;
+  unique_ptr<MwmInfoCache> m_infoCache;
 };
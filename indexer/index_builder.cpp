@@ -1,5 +1,9 @@
 #include "indexer/index_builder.hpp"
+#include "indexer/coarse_cells_index.hpp"
+#include "indexer/data_factory.hpp"
+#include "indexer/features_offsets_table.hpp"
 #include "indexer/features_vector.hpp"
+#include "indexer/scale_index.hpp"
 
 #include "defines.hpp"
 
@@ -8,20 +12,38 @@
 
 namespace indexer
 {
-  bool BuildIndexFromDatFile(string const & datFile, string const & tmpFile)
+  bool BuildIndexFromDatFile(string const & datFile, string const & tmpFile, size_t threadsCount)
   {
     try
     {
+      // Offsets go first, so the features below are read by the table from the section.
+      feature::FeaturesOffsetsTable::BuildSection(datFile);
+
       string const idxFileName(tmpFile + GEOM_INDEX_TMP_EXT);
+      feature::DataHeader header;
       {
         FeaturesVectorTest features(datFile);
         FileWriter writer(idxFileName);
 
-        BuildIndex(features.GetHeader(), features.GetVector(), writer, tmpFile);
+        header = features.GetHeader();
+        BuildIndex(header, features.GetVector(), writer, tmpFile, threadsCount);
       }
 
       FilesContainerW(datFile, FileWriter::OP_WRITE_EXISTING).Write(idxFileName, INDEX_FILE_TAG);
       FileWriter::DeleteFileX(idxFileName);
+
+      // World mwms are read at the low scales, where the viewport covering is too detailed.
+      if (header.GetType() != feature::DataHeader::country)
+      {
+        FilesContainerR cont(datFile);
+        IndexFactory factory;
+        factory.Load(cont);
+        ScaleIndex<ModelReaderPtr> const index(cont.GetReader(INDEX_FILE_TAG), factory);
+
+        FilesContainerW writer(datFile, FileWriter::OP_WRITE_EXISTING);
+        FileWriter w = writer.GetWriter(COARSE_CELLS_INDEX_FILE_TAG);
+        covering::CoarseCellsIndex::Build(index, header.GetLastScale(), w);
+      }
     }
     catch (Reader::Exception const & e)
     {
@@ -5,20 +5,22 @@
 
 namespace indexer
 {
+/// @param threadsCount Number of threads to build the index, it doesn't change the index.
 template <class TFeaturesVector, typename TWriter>
 void BuildIndex(feature::DataHeader const & header, TFeaturesVector const & features,
-                TWriter & writer, string const & tmpFilePrefix)
+                TWriter & writer, string const & tmpFilePrefix, size_t threadsCount = 1)
   {
     LOG(LINFO, ("Building scale index."));
     uint64_t indexSize;
     {
       SubWriter<TWriter> subWriter(writer);
-      covering::IndexScales(header, features, subWriter, tmpFilePrefix);
+      covering::IndexScales(header, features, subWriter, tmpFilePrefix, threadsCount);
       indexSize = subWriter.Size();
     }
     LOG(LINFO, ("Built scale index. Size =", indexSize));
   }
 
   // doesn't throw exceptions
-  bool BuildIndexFromDatFile(string const & datFile, string const & tmpFile);
+  bool BuildIndexFromDatFile(string const & datFile, string const & tmpFile,
+                             size_t threadsCount = 1);
 }
@@ -13,6 +13,7 @@ SOURCES += \
     categories_holder.cpp \
     classificator.cpp \
     classificator_loader.cpp \
+    coarse_cells_index.cpp \
     coding_params.cpp \
     data_factory.cpp \
     data_header.cpp \
@@ -23,12 +24,16 @@ SOURCES += \
     drules_selector_parser.cpp \
     feature.cpp \
     feature_algo.cpp \
+    feature_attributes_table.cpp \
     feature_covering.cpp \
     feature_data.cpp \
     feature_decl.cpp \
+    feature_geometry_cache.cpp \
     feature_impl.cpp \
     feature_loader.cpp \
     feature_loader_base.cpp \
+    feature_meta_index.cpp \
+    feature_scales_table.cpp \
     feature_utils.cpp \
     feature_visibility.cpp \
     features_offsets_table.cpp \
@@ -36,10 +41,13 @@ SOURCES += \
     ftypes_matcher.cpp \
     geometry_coding.cpp \
     geometry_serialization.cpp \
+    houses_index.cpp \
     index.cpp \
     index_builder.cpp \
+    locality_index.cpp \
     map_style_reader.cpp \
     mercator.cpp \
+    mwm_info_cache.cpp \
     mwm_set.cpp \
     old/feature_loader_101.cpp \
     point_to_int64.cpp \
@@ -55,6 +63,7 @@ HEADERS += \
     cell_id.hpp \
     classificator.hpp \
     classificator_loader.hpp \
+    coarse_cells_index.hpp \
     coding_params.hpp \
     data_factory.hpp \
     data_header.hpp \
@@ -66,14 +75,18 @@ HEADERS += \
     drules_selector_parser.cpp \
     feature.hpp \
     feature_algo.hpp \
+    feature_attributes_table.hpp \
     feature_covering.hpp \
     feature_data.hpp \
     feature_decl.hpp \
+    feature_geometry_cache.hpp \
     feature_impl.hpp \
     feature_loader.hpp \
     feature_loader_base.hpp \
     feature_meta.hpp \
+    feature_meta_index.hpp \
     feature_processor.hpp \
+    feature_scales_table.hpp \
     feature_utils.hpp \
     feature_visibility.hpp \
     features_offsets_table.hpp \
@@ -81,14 +94,17 @@ HEADERS += \
     ftypes_matcher.hpp \
     geometry_coding.hpp \
     geometry_serialization.hpp \
+    houses_index.hpp \
     index.hpp \
     index_builder.hpp \
     interval_index.hpp \
     interval_index_builder.hpp \
     interval_index_iface.hpp \
+    locality_index.hpp \
     map_style.hpp \
     map_style_reader.hpp \
     mercator.hpp \
+    mwm_info_cache.hpp \
     mwm_set.hpp \
     old/feature_loader_101.hpp \
     old/interval_index_101.hpp \
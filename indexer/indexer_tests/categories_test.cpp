@@ -96,3 +96,41 @@ UNIT_TEST(LoadCategories)
   h.ForEachCategory(f);
   TEST_EQUAL(count, 3, ());
 }
+
+UNIT_TEST(CategoriesTypesByName)
+{
+  classificator::Load();
+
+  CategoriesHolder h;
+  istringstream buffer(TEST_STRING);
+  h.LoadFromStream(buffer);
+
+  auto const getTypes = [&h](char const * locale, char const * name)
+  {
+    vector<uint32_t> types;
+    h.ForEachTypeByName(CategoriesHolder::MapLocaleToInteger(locale), strings::MakeUniString(name),
+                        MakeBackInsertFunctor(types));
+    return types;
+  };
+
+  Classificator const & c = classif();
+  uint32_t const bench = c.GetTypeByPath({"amenity", "bench"});
+  uint32_t const village = c.GetTypeByPath({"place", "village"});
+  uint32_t const hamlet = c.GetTypeByPath({"place", "hamlet"});
+
+  TEST_EQUAL(getTypes("en", "bench"), vector<uint32_t>({bench}), ());
+  // "sit" is in two synonyms, the type is reported once.
+  TEST_EQUAL(getTypes("en", "sit"), vector<uint32_t>({bench}), ());
+  TEST_EQUAL(getTypes("de", "bank"), vector<uint32_t>({bench}), ());
+  TEST_EQUAL(getTypes("de", "strafbank"), vector<uint32_t>({bench}), ());
+
+  vector<uint32_t> places = {village, hamlet};
+  sort(places.begin(), places.end());
+  TEST_EQUAL(getTypes("en", "village"), places, ());
+  TEST_EQUAL(getTypes("de", "weiler"), places, ());
+
+  TEST(getTypes("de", "village").empty(), ());
+  TEST(getTypes("en", "bank").empty(), ());
+  TEST(getTypes("en", "villag").empty(), ());
+  TEST(getTypes("en", "villages").empty(), ());
+}
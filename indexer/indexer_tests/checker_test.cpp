@@ -142,3 +142,28 @@ UNIT_TEST(GetHighwayClassTest)
   types3(c.GetTypeByPath({"highway"}));
   TEST_EQUAL(ftypes::GetHighwayClass(types3), ftypes::HighwayClass::Error, ());
 }
+
+UNIT_TEST(CheckerTypes)
+{
+  Classificator const & c = classif();
+
+  uint32_t const building = c.GetTypeByPath({"building"});
+  uint32_t const trunk = c.GetTypeByPath({"highway", "trunk"});
+  uint32_t const bridge = c.GetTypeByPath({"highway", "trunk", "bridge"});
+  uint32_t const primary = c.GetTypeByPath({"highway", "primary"});
+
+  ftypes::CheckerTypes types;
+  types.push_back(building);
+  types.push_back(bridge);
+  TEST(types.Has(building), ());
+  TEST(types.Has(bridge), ());
+  TEST(!types.Has(trunk), ());
+
+  ftypes::CheckerTypes other;
+  other.push_back(trunk);
+  other.push_back(building);
+  types |= other;
+  TEST_EQUAL(types.size(), 3, ());
+  TEST(types.Has(trunk), ());
+  TEST(!types.Has(primary), ());
+}
@@ -0,0 +1,90 @@
+#include "testing/testing.hpp"
+
+#include "indexer/coarse_cells_index.hpp"
+#include "indexer/data_factory.hpp"
+#include "indexer/data_header.hpp"
+#include "indexer/feature_covering.hpp"
+#include "indexer/mercator.hpp"
+#include "indexer/scale_index.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "defines.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/vector.hpp"
+
+using covering::CoarseCellsIndex;
+
+namespace
+{
+vector<uint32_t> GetSortedUnique(vector<uint32_t> v)
+{
+  sort(v.begin(), v.end());
+  v.erase(unique(v.begin(), v.end()), v.end());
+  return v;
+}
+}  // namespace
+
+UNIT_TEST(CoarseCellsIndex_Smoke)
+{
+  FilesContainerR cont(GetPlatform().GetReader(WORLD_FILE_NAME DATA_FILE_EXTENSION));
+  IndexFactory factory;
+  factory.Load(cont);
+  ScaleIndex<ModelReaderPtr> const index(cont.GetReader(INDEX_FILE_TAG), factory);
+  int const lastScale = factory.GetHeader().GetLastScale();
+
+  vector<char> buffer;
+  {
+    MemWriter<vector<char>> writer(buffer);
+    CoarseCellsIndex::Build(index, lastScale, writer);
+  }
+
+  CoarseCellsIndex coarse;
+  TEST(coarse.Load(MemReader(buffer.data(), buffer.size())), ());
+  TEST_EQUAL(coarse.GetMaxScale(), CoarseCellsIndex::kMaxScale, ());
+
+  // Features of the cells include the features of the viewport covering.
+  m2::RectD const rects[] = {MercatorBounds::FullRect(),
+                             MercatorBounds::RectByCenterXYAndSizeInMeters(m2::PointD(27.56, 64.23), 20000.0),
+                             m2::RectD(27.0, 60.0, 28.0, 70.0)};
+  for (m2::RectD const & rect : rects)
+  {
+    covering::CoveringGetter cov(rect, covering::ViewportWithLowLevels);
+    for (uint32_t scale = 0; scale <= coarse.GetMaxScale(); ++scale)
+    {
+      vector<uint32_t> expected;
+      for (auto const & i : cov.Get(lastScale))
+      {
+        index.ForEachInIntervalAndScale([&expected](uint32_t feature)
+        {
+          expected.push_back(feature);
+        }, i.first, i.second, scale);
+      }
+      expected = GetSortedUnique(expected);
+
+      vector<uint32_t> actual;
+      coarse.ForEachInRect(rect, scale, [&actual](uint32_t feature) { actual.push_back(feature); });
+      actual = GetSortedUnique(actual);
+
+      if (scale == coarse.GetMaxScale())
+      {
+        TEST(!expected.empty(), (rect));
+      }
+      TEST(includes(actual.begin(), actual.end(), expected.begin(), expected.end()), (rect, scale));
+      if (rect == MercatorBounds::FullRect())
+      {
+        TEST_EQUAL(actual, expected, (scale));
+      }
+    }
+  }
+
+  // Malformed data aren't loaded.
+  buffer.pop_back();
+  TEST(!coarse.Load(MemReader(buffer.data(), buffer.size())), ());
+  TEST(coarse.IsEmpty(), ());
+}
@@ -0,0 +1,50 @@
+#include "testing/testing.hpp"
+
+#include "indexer/feature_attributes_table.hpp"
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "std/vector.hpp"
+
+using feature::AttributesTable;
+
+UNIT_TEST(AttributesTable_Smoke)
+{
+  vector<AttributesTable::Attributes> attributes(3);
+  attributes[0].m_center = m2::PointD(10.5, -20.25);
+  attributes[0].m_rank = 7;
+  attributes[0].m_typeIndices = {1, 42, 65535};
+  attributes[1].m_center = m2::PointD(-179.0, 179.0);
+  attributes[2].m_center = m2::PointD(0.0, 0.0);
+  attributes[2].m_rank = 255;
+  attributes[2].m_typeIndices = {3};
+
+  vector<char> buffer;
+  {
+    MemWriter<vector<char>> writer(buffer);
+    AttributesTable::Serialize(attributes, writer);
+  }
+
+  AttributesTable table;
+  TEST(table.Load(MemReader(buffer.data(), buffer.size())), ());
+  TEST_EQUAL(table.GetCount(), attributes.size(), ());
+  for (uint32_t i = 0; i < attributes.size(); ++i)
+  {
+    m2::PointD const expected =
+        PointU2PointD(PointD2PointU(attributes[i].m_center, POINT_COORD_BITS), POINT_COORD_BITS);
+    TEST_EQUAL(table.GetCenter(i), expected, (i));
+    TEST(table.GetCenter(i).EqualDxDy(attributes[i].m_center, 1e-5), (i));
+    TEST_EQUAL(table.GetRank(i), attributes[i].m_rank, (i));
+
+    vector<uint32_t> typeIndices;
+    table.ForEachTypeIndex(i, [&typeIndices](uint32_t index) { typeIndices.push_back(index); });
+    TEST_EQUAL(typeIndices, attributes[i].m_typeIndices, (i));
+  }
+
+  // Malformed data aren't loaded.
+  buffer.pop_back();
+  TEST(!table.Load(MemReader(buffer.data(), buffer.size())), ());
+  TEST(table.IsEmpty(), ());
+}
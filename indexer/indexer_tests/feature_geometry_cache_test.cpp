@@ -0,0 +1,68 @@
+#include "testing/testing.hpp"
+
+#include "indexer/feature_geometry_cache.hpp"
+
+#include "std/shared_ptr.hpp"
+
+using feature::GeometryCache;
+
+namespace
+{
+GeometryCache::TPoints MakePoints(size_t count)
+{
+  GeometryCache::TPoints points;
+  for (size_t i = 0; i < count; ++i)
+    points.push_back(m2::PointD(i, 2 * i));
+  return points;
+}
+}  // namespace
+
+UNIT_TEST(GeometryCache_FindAdd)
+{
+  GeometryCache cache(GeometryCache::kDefaultMaxBytes);
+  MwmSet::MwmId const mwmId(make_shared<MwmInfo>());
+  FeatureID const id(mwmId, 7);
+
+  GeometryCache::TPoints points;
+  TEST(!cache.Find(id, 0, points), ());
+
+  cache.Add(id, 0, MakePoints(10));
+  TEST(cache.Find(id, 0, points), ());
+  TEST_EQUAL(points, MakePoints(10), ());
+
+  // Geometries of other scales and other features are kept apart.
+  TEST(!cache.Find(id, 1, points), ());
+  TEST(!cache.Find(FeatureID(mwmId, 8), 0, points), ());
+  TEST(!cache.Find(FeatureID(MwmSet::MwmId(make_shared<MwmInfo>()), 7), 0, points), ());
+
+  GeometryCache::Stats const stats = cache.GetStats();
+  TEST_EQUAL(stats.m_hits, 1, ());
+  TEST_EQUAL(stats.m_misses, 4, ());
+
+  cache.Clear();
+  TEST_EQUAL(cache.GetBytes(), 0, ());
+  TEST(!cache.Find(id, 0, points), ());
+}
+
+UNIT_TEST(GeometryCache_Limit)
+{
+  GeometryCache cache(GeometryCache::kDefaultMaxBytes);
+  MwmSet::MwmId const mwmId(make_shared<MwmInfo>());
+
+  for (uint32_t i = 0; i < 10000; ++i)
+    cache.Add(FeatureID(mwmId, i), 0, MakePoints(100));
+  TEST_LESS_OR_EQUAL(cache.GetBytes(), GeometryCache::kDefaultMaxBytes, ());
+
+  // The most recent features are kept.
+  GeometryCache::TPoints points;
+  TEST(cache.Find(FeatureID(mwmId, 9999), 0, points), ());
+  TEST(!cache.Find(FeatureID(mwmId, 0), 0, points), ());
+
+  size_t const bytes = cache.GetBytes();
+  cache.Trim(0.5);
+  TEST_LESS_OR_EQUAL(cache.GetBytes(), bytes / 2, ());
+
+  cache.SetMaxBytes(0);
+  TEST(!cache.IsEnabled(), ());
+  TEST_EQUAL(cache.GetBytes(), 0, ());
+}
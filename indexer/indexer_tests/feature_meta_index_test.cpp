@@ -0,0 +1,93 @@
+#include "testing/testing.hpp"
+
+#include "indexer/feature_meta.hpp"
+#include "indexer/feature_meta_index.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/mmap_reader.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/scope_guard.hpp"
+
+#include "defines.hpp"
+
+#include "std/bind.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+using feature::Metadata;
+using feature::MetadataIndex;
+
+UNIT_TEST(MetadataIndex_Smoke)
+{
+  Platform & pl = GetPlatform();
+  string const testFile = pl.WritablePathForFile("metadata_index_test" DATA_FILE_EXTENSION);
+  string const indexFile = testFile + METADATA_OFFSETS_FILE_TAG;
+  MY_SCOPE_GUARD(deleteTestFileGuard, bind(&FileWriter::DeleteFileX, cref(testFile)));
+
+  // Features 0, 3, 4 and 99 of 100 have metadata.
+  vector<pair<uint32_t, uint32_t>> const records = {{0, 0}, {3, 10}, {4, 17}, {99, 1000}};
+  {
+    MetadataIndex::Builder builder;
+    for (auto const & r : records)
+      builder.Add(r.first, r.second);
+    builder.Save(indexFile, 100 /* featuresCount */);
+
+    FilesContainerW container(testFile);
+    container.Write(indexFile, METADATA_OFFSETS_FILE_TAG);
+    container.Finish();
+    FileWriter::DeleteFileX(indexFile);
+  }
+
+  // Index is read from the file and is used in place in the memory mapped file.
+  for (FilesContainerR::ReaderT const & reader :
+       {FilesContainerR::ReaderT(new FileReader(testFile)),
+        FilesContainerR::ReaderT(new MmapReader(testFile))})
+  {
+    MetadataIndex index;
+    TEST(index.Load(FilesContainerR(reader)), ());
+    TEST(index.IsLoaded(), ());
+
+    size_t next = 0;
+    for (uint32_t i = 0; i < 110; ++i)
+    {
+      uint32_t offset = 0;
+      bool const hasRecord = next < records.size() && records[next].first == i;
+      TEST_EQUAL(index.Get(i, offset), hasRecord, (i));
+      if (hasRecord)
+      {
+        TEST_EQUAL(offset, records[next].second, (i));
+        ++next;
+      }
+    }
+  }
+}
+
+UNIT_TEST(Metadata_FindInMWM)
+{
+  Metadata metadata;
+  metadata.Add(Metadata::FMD_CUISINE, "pizza");
+  metadata.Add(Metadata::FMD_OPEN_HOURS, "Mo-Fr 09:00-18:00");
+  metadata.Add(Metadata::FMD_STARS, "4");
+
+  vector<char> buffer;
+  {
+    MemWriter<vector<char>> writer(buffer);
+    metadata.SerializeToMWM(writer);
+  }
+
+  for (Metadata::EType const type : {Metadata::FMD_CUISINE, Metadata::FMD_OPEN_HOURS,
+                                     Metadata::FMD_STARS, Metadata::FMD_PHONE_NUMBER})
+  {
+    MemReader reader(buffer.data(), buffer.size());
+    ReaderSource<MemReader> src(reader);
+    string value;
+    bool const found = Metadata::FindInMWM(src, type, value);
+    TEST_EQUAL(found, !metadata.Get(type).empty(), (type));
+    TEST_EQUAL(value, metadata.Get(type), (type));
+  }
+}
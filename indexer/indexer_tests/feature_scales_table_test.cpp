@@ -0,0 +1,43 @@
+#include "testing/testing.hpp"
+
+#include "indexer/feature_scales_table.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "std/vector.hpp"
+
+using feature::ScalesTable;
+
+UNIT_TEST(ScalesTable_Smoke)
+{
+  vector<ScalesTable::Ranges> ranges;
+  ranges.emplace_back(make_pair(10, 17), make_pair(15, 19));
+  ranges.emplace_back();
+  ranges.emplace_back(make_pair(0, 19), make_pair(-1, -1));
+
+  vector<char> buffer;
+  {
+    MemWriter<vector<char>> writer(buffer);
+    ScalesTable::Serialize(ranges, writer);
+  }
+
+  ScalesTable table;
+  TEST(table.Load(MemReader(buffer.data(), buffer.size())), ());
+  TEST_EQUAL(table.GetCount(), ranges.size(), ());
+  for (uint32_t i = 0; i < ranges.size(); ++i)
+  {
+    ScalesTable::Ranges r;
+    TEST(table.Get(i, r), (i));
+    TEST_EQUAL(r.m_drawable, ranges[i].m_drawable, (i));
+    TEST_EQUAL(r.m_labels, ranges[i].m_labels, (i));
+  }
+
+  ScalesTable::Ranges r;
+  TEST(!table.Get(static_cast<uint32_t>(ranges.size()), r), ());
+
+  // Malformed data aren't loaded.
+  buffer.pop_back();
+  TEST(!table.Load(MemReader(buffer.data(), buffer.size())), ());
+  TEST(table.IsEmpty(), ());
+}
@@ -8,6 +8,8 @@
 #include "platform/platform.hpp"
 
 #include "coding/file_container.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/mmap_reader.hpp"
 
 #include "base/scope_guard.hpp"
 
@@ -140,4 +142,45 @@ namespace feature
         TEST_EQUAL(table->GetFeatureOffset(i), loadedTable->GetFeatureOffset(i), ());
     }
   }
+
+  UNIT_TEST(FeaturesOffsetsTable_Section)
+  {
+    Platform & pl = GetPlatform();
+    string const testFile = pl.WritablePathForFile("offsets_section_test" DATA_FILE_EXTENSION);
+    MY_SCOPE_GUARD(deleteTestFileGuard, bind(&FileWriter::DeleteFileX, cref(testFile)));
+
+    FilesContainerR baseContainer(pl.GetReader("minsk-pass" DATA_FILE_EXTENSION));
+    {
+      FilesContainerW testContainer(testFile);
+      baseContainer.ForEachTag([&baseContainer, &testContainer](string const & tag)
+      {
+        if (tag != FEATURES_OFFSETS_FILE_TAG)
+          testContainer.Write(baseContainer.GetReader(tag), tag);
+      });
+      testContainer.Finish();
+    }
+    TEST(!FeaturesOffsetsTable::Load(FilesContainerR(testFile)), ());
+
+    FeaturesOffsetsTable::BuildSection(testFile);
+
+    FeaturesOffsetsTable::Builder builder;
+    FeaturesVector::ForEachOffset(baseContainer.GetReader(DATA_FILE_TAG), [&builder](uint32_t offset)
+    {
+      builder.PushOffset(offset);
+    });
+    unique_ptr<FeaturesOffsetsTable> const table(FeaturesOffsetsTable::Build(builder));
+
+    // Table is read from the file and decoded in place from the memory mapped file.
+    for (FilesContainerR::ReaderT const & reader :
+         {FilesContainerR::ReaderT(new FileReader(testFile)),
+          FilesContainerR::ReaderT(new MmapReader(testFile))})
+    {
+      unique_ptr<FeaturesOffsetsTable> const loadedTable(
+          FeaturesOffsetsTable::Load(FilesContainerR(reader)));
+      TEST(loadedTable.get(), ());
+      TEST_EQUAL(table->size(), loadedTable->size(), ());
+      for (uint64_t i = 0; i < table->size(); ++i)
+        TEST_EQUAL(table->GetFeatureOffset(i), loadedTable->GetFeatureOffset(i), ());
+    }
+  }
 }  // namespace feature
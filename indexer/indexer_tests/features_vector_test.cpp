@@ -0,0 +1,196 @@
+#include "testing/testing.hpp"
+
+#include "indexer/data_header.hpp"
+#include "indexer/features_offsets_table.hpp"
+#include "indexer/features_vector.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/mapped_section.hpp"
+#include "coding/mmap_reader.hpp"
+
+#include "defines.hpp"
+
+#include "std/bind.hpp"
+#include "std/thread.hpp"
+#include "std/vector.hpp"
+
+
+namespace
+{
+size_t const kNumThreads = 4;
+
+uint32_t GetSignature(FeatureType const & ft)
+{
+  uint32_t signature = ft.HasName() ? 1 : 0;
+  ft.ForEachType([&signature](uint32_t type)
+  {
+    signature = signature * 31 + type;
+  });
+  return signature;
+}
+
+// Collects the limit rect and the size of the outer geometry of the feature.
+void GetGeometry(FeatureType const & ft, int scale, vector<m2::RectD> & rects,
+                 vector<uint32_t> & sizes)
+{
+  sizes.push_back(ft.ParseGeometry(scale) + ft.ParseTriangles(scale));
+  rects.push_back(ft.GetLimitRect(scale));
+}
+
+void ReadAllFeatures(FeaturesVector const & features, size_t count, vector<uint32_t> & types)
+{
+  FeaturesVector::Cursor cursor(features);
+  types.clear();
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    FeatureType ft;
+    cursor.GetByIndex(i, ft);
+    types.push_back(GetSignature(ft));
+  }
+}
+}  // namespace
+
+UNIT_TEST(FeaturesVector_SharedBetweenThreads)
+{
+  string const path = GetPlatform().WritablePathForFile("minsk-pass" DATA_FILE_EXTENSION);
+  FilesContainerR const cont(ModelReaderPtr(new MmapReader(path)));
+  feature::DataHeader const header(cont);
+  unique_ptr<feature::FeaturesOffsetsTable> const table =
+      feature::FeaturesOffsetsTable::CreateIfNotExistsAndLoad(cont);
+  TEST(table, ());
+  FeaturesVector const features(cont, header, table.get());
+
+  // Expected values are collected by the sequential reader.
+  vector<uint32_t> expected;
+  features.ForEach([&expected](FeatureType const & ft, uint32_t index)
+  {
+    TEST_EQUAL(index, expected.size(), ());
+    expected.push_back(GetSignature(ft));
+  });
+  TEST(!expected.empty(), ());
+
+  vector<vector<uint32_t>> results(kNumThreads);
+  vector<thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i)
+    threads.emplace_back(&ReadAllFeatures, cref(features), expected.size(), ref(results[i]));
+  for (auto & t : threads)
+    t.join();
+
+  for (auto const & result : results)
+    TEST_EQUAL(expected, result, ());
+}
+
+UNIT_TEST(FeaturesVector_ForEachByIndex)
+{
+  FeaturesVectorTest test(GetPlatform().WritablePathForFile("minsk-pass" DATA_FILE_EXTENSION));
+  FeaturesVector const & features = test.GetVector();
+
+  vector<uint32_t> expected;
+  features.ForEach([&expected](FeatureType const & ft, uint32_t /* index */)
+  {
+    expected.push_back(GetSignature(ft));
+  });
+
+  // Sparse and dense, unsorted and duplicated indices.
+  vector<uint32_t> indices;
+  for (uint32_t i = 0; i < expected.size(); i += 37)
+    indices.push_back(i);
+  for (uint32_t i = 0; i < expected.size() && i < 1000; ++i)
+    indices.push_back(static_cast<uint32_t>(expected.size()) - 1 - i);
+  indices.push_back(0);
+
+  FeaturesVector::Cursor cursor(features);
+  uint32_t previous = 0;
+  size_t count = 0;
+  cursor.ForEachByIndex(indices, [&](FeatureType const & ft, uint32_t index)
+  {
+    if (count != 0)
+      TEST_LESS(previous, index, ());
+    previous = index;
+    ++count;
+    TEST_EQUAL(expected[index], GetSignature(ft), (index));
+  });
+  TEST_EQUAL(count, indices.size(), ());
+}
+
+UNIT_TEST(FeatureType_LoadFields)
+{
+  using namespace feature;
+
+  FeaturesVectorTest test(GetPlatform().WritablePathForFile("minsk-pass" DATA_FILE_EXTENSION));
+  size_t points = 0;
+  test.GetVector().ForEach([&points](FeatureType const & ft, uint32_t /* index */)
+  {
+    TEST(!ft.IsParsed(FIELD_TYPES), ());
+
+    ft.Load(FIELD_COMMON);
+    TEST(ft.IsParsed(FIELD_TYPES | FIELD_COMMON), ());
+    TEST(!ft.IsParsed(FIELD_HEADER2), ());
+    TEST(!ft.IsParsed(FIELD_METADATA), ());
+
+    switch (ft.GetFeatureType())
+    {
+    case GEOM_POINT:
+      ++points;
+      // Center and limit rect of the point feature don't need the geometry offsets.
+      TEST(ft.GetLimitRect(FeatureType::WORST_GEOMETRY).IsPointInside(ft.GetCenter()), ());
+      TEST(!ft.IsParsed(FIELD_HEADER2), ());
+      break;
+    case GEOM_LINE:
+      ft.Load(FIELD_POINTS);
+      TEST(ft.IsParsed(FIELD_HEADER2 | FIELD_POINTS), ());
+      TEST(!ft.IsParsed(FIELD_TRIANGLES), ());
+      TEST_GREATER_OR_EQUAL(ft.GetPointsCount(), 2, ());
+      break;
+    default:
+      ft.Load(FIELD_TRIANGLES);
+      TEST(ft.IsParsed(FIELD_HEADER2 | FIELD_TRIANGLES), ());
+      TEST(!ft.IsParsed(FIELD_POINTS), ());
+      break;
+    }
+  });
+  TEST_GREATER(points, 0, ());
+}
+
+UNIT_TEST(FeaturesVector_MappedSections)
+{
+  string const path = GetPlatform().WritablePathForFile("minsk-pass" DATA_FILE_EXTENSION);
+  FilesContainerR const fileCont(path);
+  FilesContainerR const mappedCont(ModelReaderPtr(new MmapReader(path)));
+  TEST(!MappedSection(fileCont.GetReader(DATA_FILE_TAG)).IsMapped(), ());
+  TEST(MappedSection(mappedCont.GetReader(DATA_FILE_TAG)).IsMapped(), ());
+
+  FeaturesVectorTest fileTest(fileCont);
+  FeaturesVectorTest mappedTest(mappedCont);
+
+  for (int scale : {int(FeatureType::BEST_GEOMETRY), int(FeatureType::WORST_GEOMETRY)})
+  {
+    vector<m2::RectD> expectedRects, rects;
+    vector<uint32_t> expectedSizes, sizes;
+    fileTest.GetVector().ForEach([&](FeatureType const & ft, uint32_t /* index */)
+    {
+      GetGeometry(ft, scale, expectedRects, expectedSizes);
+    });
+    mappedTest.GetVector().ForEach([&](FeatureType const & ft, uint32_t /* index */)
+    {
+      GetGeometry(ft, scale, rects, sizes);
+    });
+    TEST(!expectedRects.empty(), ());
+    TEST_EQUAL(expectedRects, rects, ());
+    TEST_EQUAL(expectedSizes, sizes, ());
+
+    rects.clear();
+    sizes.clear();
+    FeaturesVector::Cursor cursor(mappedTest.GetVector());
+    for (uint32_t i = 0; i < expectedRects.size(); ++i)
+    {
+      FeatureType ft;
+      cursor.GetByIndex(i, ft);
+      GetGeometry(ft, scale, rects, sizes);
+    }
+    TEST_EQUAL(expectedRects, rects, ());
+    TEST_EQUAL(expectedSizes, sizes, ());
+  }
+}
@@ -17,6 +17,8 @@
 
 #include "base/logging.hpp"
 
+#include "std/random.hpp"
+
 
 typedef m2::PointU PU;
 
@@ -40,6 +42,28 @@ UNIT_TEST(EncodeDelta)
   }
 }
 
+UNIT_TEST(DecodeDeltas_EqualToScalar)
+{
+  mt19937 rng(0);
+  vector<uint64_t> deltas = {0, 1, 2, 3, 0xFFFFFFFFFFFFFFFFULL, 0x5555555555555555ULL,
+                             0xAAAAAAAAAAAAAAAAULL, 0x8000000000000000ULL};
+  for (size_t i = 0; i < 1001; ++i)
+    deltas.push_back((static_cast<uint64_t>(rng()) << 32) | rng());
+
+  // Odd count to check the scalar tail of the vectorized version too.
+  size_t const count = deltas.size();
+  TEST_EQUAL(count % 2, 1, ());
+
+  vector<int32_t> expected(2 * count), actual(2 * count);
+  geo_coding::DecodeDeltasScalar(&deltas[0], count, &expected[0]);
+  geo_coding::DecodeDeltas(&deltas[0], count, &actual[0]);
+  TEST_EQUAL(expected, actual, ());
+
+  PU const pred(0x12345678, 0x87654321);
+  for (size_t i = 0; i < count; ++i)
+    TEST_EQUAL(DecodeDelta(deltas[i], pred), ApplyDelta(&actual[2 * i], pred), (deltas[i]));
+}
+
 UNIT_TEST(PredictPointsInPolyline2)
 {
   // Ci = Ci-1 + (Ci-1 + Ci-2) / 2
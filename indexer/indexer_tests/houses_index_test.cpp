@@ -0,0 +1,104 @@
+#include "testing/testing.hpp"
+
+#include "indexer/houses_index.hpp"
+#include "indexer/point_to_int64.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+using indexer::HousesIndex;
+
+namespace
+{
+uint32_t const kCoordBits = 30;
+
+vector<string> GetNumbers(vector<HousesIndex::House> const & houses)
+{
+  vector<string> numbers;
+  for (auto const & house : houses)
+    numbers.push_back(house.m_number);
+  return numbers;
+}
+}  // namespace
+
+UNIT_TEST(HousesIndex_Numbers)
+{
+  TEST_EQUAL(indexer::NormalizeHouseNumber("12 A"), "12a", ());
+  TEST_EQUAL(indexer::NormalizeHouseNumber("5K2"), "5k2", ());
+
+  TEST(indexer::LessHouseNumber("9", "10"), ());
+  TEST(indexer::LessHouseNumber("10", "10a"), ());
+  TEST(indexer::LessHouseNumber("10a", "10b"), ());
+  TEST(indexer::LessHouseNumber("10b", "11"), ());
+  TEST(indexer::LessHouseNumber("012", "13"), ());
+  TEST(!indexer::LessHouseNumber("012", "12"), ());
+  TEST(!indexer::LessHouseNumber("12", "012"), ());
+  // Numbers without the leading integer go after the others.
+  TEST(indexer::LessHouseNumber("99", "a"), ());
+
+  TEST(indexer::EqualHouseNumberInteger("10", "10a"), ());
+  TEST(indexer::EqualHouseNumberInteger("010k2", "10"), ());
+  TEST(!indexer::EqualHouseNumberInteger("10", "1"), ());
+  TEST(!indexer::EqualHouseNumberInteger("a", "a"), ());
+}
+
+UNIT_TEST(HousesIndex_Smoke)
+{
+  vector<HousesIndex::Street> streets(3);
+  streets[0].m_featureId = 20;
+  streets[0].m_houses = {{"11", 1, m2::PointD(1.0, 1.0)},
+                         {"10 B", 2, m2::PointD(1.0, 2.0)},
+                         {"9", 3, m2::PointD(1.0, 3.0)},
+                         {"10", 4, m2::PointD(1.0, 4.0)},
+                         {"10a", 5, m2::PointD(1.0, 5.0)}};
+  streets[1].m_featureId = 7;
+  streets[1].m_houses = {{"1", 6, m2::PointD(-1.0, -1.0)}};
+  // Streets without the houses are not written.
+  streets[2].m_featureId = 30;
+
+  string const path = GetPlatform().WritablePathForFile("houses_index_test.bin");
+  {
+    FileWriter writer(path);
+    HousesIndex::Serialize(streets, kCoordBits, writer);
+  }
+
+  HousesIndex index;
+  TEST(index.Load(ModelReaderPtr(new FileReader(path))), ());
+  TEST_EQUAL(index.GetStreetsCount(), 2, ());
+
+  vector<HousesIndex::House> houses;
+  TEST(index.GetStreetHouses(20, houses), ());
+  TEST_EQUAL(GetNumbers(houses), vector<string>({"9", "10", "10a", "10 B", "11"}), ());
+  TEST_EQUAL(houses[0].m_featureId, 3, ());
+  TEST_EQUAL(houses[0].m_point,
+             PointU2PointD(PointD2PointU(m2::PointD(1.0, 3.0), kCoordBits), kCoordBits), ());
+
+  houses.clear();
+  TEST(index.GetHouses(20, "10b", houses), ());
+  TEST_EQUAL(GetNumbers(houses), vector<string>({"10 B"}), ());
+
+  // There is no exact number, the houses with the same integer are found.
+  houses.clear();
+  TEST(index.GetHouses(20, "10c", houses), ());
+  TEST_EQUAL(GetNumbers(houses), vector<string>({"10", "10a", "10 B"}), ());
+
+  houses.clear();
+  TEST(index.GetHouses(20, "12", houses), ());
+  TEST(houses.empty(), ());
+
+  houses.clear();
+  TEST(index.GetHouses(7, "1", houses), ());
+  TEST_EQUAL(GetNumbers(houses), vector<string>({"1"}), ());
+
+  TEST(!index.GetHouses(30, "1", houses), ());
+  TEST(!index.GetHouses(8, "1", houses), ());
+  TEST(!index.GetHouses(100, "1", houses), ());
+
+  my::DeleteFileX(path);
+}
@@ -63,3 +63,28 @@ UNIT_TEST(BuildIndexTest)
   // Clean after the test.
   FileWriter::DeleteFileX(filePath);
 }
+
+UNIT_TEST(BuildIndexTest_Threads)
+{
+  Platform & p = GetPlatform();
+  classificator::Load();
+
+  FilesContainerR container(p.GetReader("minsk-pass" DATA_FILE_EXTENSION));
+  FeaturesVectorTest features(container);
+
+  vector<char> expected;
+  {
+    MemWriter<vector<char>> writer(expected);
+    indexer::BuildIndex(features.GetHeader(), features.GetVector(), writer, "build_index_test");
+  }
+
+  // The index built by several threads is the same.
+  for (size_t threadsCount : {2, 4})
+  {
+    vector<char> serialIndex;
+    MemWriter<vector<char>> writer(serialIndex);
+    indexer::BuildIndex(features.GetHeader(), features.GetVector(), writer, "build_index_test",
+                        threadsCount);
+    TEST(serialIndex == expected, (threadsCount));
+  }
+}
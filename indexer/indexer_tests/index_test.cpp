@@ -2,6 +2,7 @@
 
 #include "indexer/data_header.hpp"
 #include "indexer/index.hpp"
+#include "indexer/mercator.hpp"
 
 #include "coding/file_name_utils.hpp"
 #include "coding/internal/file_data.hpp"
@@ -17,6 +18,7 @@
 
 #include "std/bind.hpp"
 #include "std/string.hpp"
+#include "std/vector.hpp"
 
 using platform::CountryFile;
 using platform::LocalCountryFile;
@@ -153,3 +155,43 @@ UNIT_TEST(Index_MwmStatusNotifications)
   observer.CheckExpectations();
   index.RemoveObserver(observer);
 }
+
+UNIT_TEST(Index_ForEachInRectParallel)
+{
+  Index index;
+  for (char const * name : {"minsk-pass", "WorldCoasts", "World"})
+  {
+    auto const p = index.RegisterMap(LocalCountryFile::MakeForTesting(name));
+    TEST_EQUAL(MwmSet::RegResult::Success, p.second, (name));
+  }
+  index.SetQueryThreadsCount(3);
+
+  struct CollectIds
+  {
+    vector<FeatureID> & m_ids;
+    void operator()(FeatureType const & ft) { m_ids.push_back(ft.GetID()); }
+  };
+
+  m2::RectD const rect = MercatorBounds::FullRect();
+  for (uint32_t scale : {5, 9, 12})
+  {
+    vector<FeatureID> expected;
+    CollectIds collector{expected};
+    index.ForEachInRect(collector, rect, scale);
+    TEST(!expected.empty(), (scale));
+
+    vector<vector<FeatureID>> results(3);
+    size_t sinksCount = 0;
+    auto const sinks = index.ForEachInRectParallel([&]()
+    {
+      TEST_LESS(sinksCount, results.size(), ());
+      return CollectIds{results[sinksCount++]};
+    }, rect, scale);
+    TEST_EQUAL(sinks.size(), sinksCount, ());
+
+    vector<FeatureID> actual;
+    for (auto const & ids : results)
+      actual.insert(actual.end(), ids.begin(), ids.end());
+    TEST_EQUAL(expected, actual, (scale));
+  }
+}
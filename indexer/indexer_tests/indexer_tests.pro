@@ -26,21 +26,32 @@ SOURCES += \
     categories_test.cpp \
     cell_coverer_test.cpp \
     cell_id_test.cpp \
+    coarse_cells_index_test.cpp \
     checker_test.cpp \
     city_rank_table_test.cpp \
     drules_selector_parser_test.cpp \
+    feature_attributes_table_test.cpp \
+    feature_geometry_cache_test.cpp \
+    feature_meta_index_test.cpp \
+    feature_scales_table_test.cpp \
     features_offsets_table_test.cpp \
+    features_vector_test.cpp \
     geometry_coding_test.cpp \
     geometry_serialization_test.cpp \
+    houses_index_test.cpp \
     index_builder_test.cpp \
     index_test.cpp \
     interval_index_test.cpp \
+    locality_index_test.cpp \
     mercator_test.cpp \
+    mwm_info_cache_test.cpp \
     mwm_set_test.cpp \
     point_to_int64_test.cpp \
     scales_test.cpp \
     search_string_utils_test.cpp \
+    search_trie_test.cpp \
     sort_and_merge_intervals_test.cpp \
+    string_file_test.cpp \
     test_polylines.cpp \
     test_type.cpp \
     visibility_test.cpp \
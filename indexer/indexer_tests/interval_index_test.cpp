@@ -1,10 +1,17 @@
 #include "testing/testing.hpp"
 #include "indexer/interval_index.hpp"
 #include "indexer/interval_index_builder.hpp"
+#include "platform/platform.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/mmap_reader.hpp"
 #include "coding/reader.hpp"
 #include "coding/writer.hpp"
 #include "base/macros.hpp"
+#include "base/scope_guard.hpp"
 #include "base/stl_add.hpp"
+#include "std/algorithm.hpp"
+#include "std/bind.hpp"
+#include "std/random.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
 
@@ -18,6 +25,36 @@ struct CellIdFeaturePairForTest
   uint64_t m_Cell;
   uint32_t m_Feature;
 };
+
+struct ReadRanges
+{
+  vector<pair<uint64_t, uint64_t>> m_prefetched;
+  vector<pair<uint64_t, uint64_t>> m_read;
+};
+
+// Records the prefetched and the read ranges.
+class RecordingReader : public MemReader
+{
+public:
+  RecordingReader(void const * p, size_t size, ReadRanges & ranges)
+    : MemReader(p, size), m_ranges(&ranges)
+  {
+  }
+
+  void Read(uint64_t pos, void * p, size_t size) const
+  {
+    m_ranges->m_read.emplace_back(pos, pos + size);
+    MemReader::Read(pos, p, size);
+  }
+
+  void Prefetch(uint64_t pos, uint64_t size) const override
+  {
+    m_ranges->m_prefetched.emplace_back(pos, pos + size);
+  }
+
+private:
+  ReadRanges * m_ranges;
+};
 }
 
 UNIT_TEST(IntervalIndex_LevelCount)
@@ -276,3 +313,93 @@ UNIT_TEST(IntervalIndex_Simple5)
   }
 }
 
+
+UNIT_TEST(IntervalIndex_MmapReader)
+{
+  mt19937 rng(0);
+  vector<CellIdFeaturePairForTest> data;
+  for (uint32_t i = 0; i < 10000; ++i)
+    data.push_back(CellIdFeaturePairForTest(((static_cast<uint64_t>(rng()) << 32) | rng()) >> 24, i));
+  sort(data.begin(), data.end(), [](CellIdFeaturePairForTest const & l, CellIdFeaturePairForTest const & r)
+  {
+    return l.GetCell() < r.GetCell();
+  });
+
+  vector<char> serialIndex;
+  MemWriter<vector<char> > writer(serialIndex);
+  BuildIntervalIndex(data.begin(), data.end(), writer, 40);
+
+  // Put the index after some prefix to read it with a sub-reader.
+  string const fileName = GetPlatform().WritablePathForFile("interval_index_mmap_test.bin");
+  MY_SCOPE_GUARD(deleteFileGuard, bind(&FileWriter::DeleteFileX, cref(fileName)));
+  uint32_t const prefixSize = 13;
+  {
+    FileWriter fileWriter(fileName);
+    vector<char> const prefix(prefixSize, 0);
+    fileWriter.Write(&prefix[0], prefix.size());
+    fileWriter.Write(&serialIndex[0], serialIndex.size());
+  }
+
+  ModelReaderPtr const fileReader(new MmapReader(fileName));
+  IntervalIndex<ModelReaderPtr> mmapIndex(fileReader.SubReader(prefixSize, serialIndex.size()));
+  TEST(mmapIndex.IsDirectAccess(), ());
+
+  MemReader reader(&serialIndex[0], serialIndex.size());
+  IntervalIndex<MemReader> index(reader);
+  TEST(!index.IsDirectAccess(), ());
+
+  size_t nonEmpty = 0;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    uint64_t beg = ((static_cast<uint64_t>(rng()) << 32) | rng()) % index.KeyEnd();
+    uint64_t end = ((static_cast<uint64_t>(rng()) << 32) | rng()) % index.KeyEnd();
+    if (beg > end)
+      swap(beg, end);
+    if (i == 0)
+    {
+      beg = 0;
+      end = index.KeyEnd();
+    }
+
+    vector<uint32_t> expected, values;
+    index.ForEach(MakeBackInsertFunctor(expected), beg, end);
+    mmapIndex.ForEach(MakeBackInsertFunctor(values), beg, end);
+    TEST_EQUAL(values, expected, (beg, end));
+    nonEmpty += values.empty() ? 0 : 1;
+    if (i == 0)
+      TEST_EQUAL(values.size(), data.size(), ());
+  }
+  TEST_GREATER(nonEmpty, 50, ());
+}
+
+UNIT_TEST(IntervalIndex_PrefetchChildren)
+{
+  vector<CellIdFeaturePairForTest> data;
+  for (uint32_t i = 0; i < 1000; ++i)
+    data.push_back(CellIdFeaturePairForTest((static_cast<uint64_t>(i) << 24) + i, i));
+  vector<char> serialIndex;
+  MemWriter<vector<char> > writer(serialIndex);
+  BuildIntervalIndex(data.begin(), data.end(), writer, 40);
+
+  ReadRanges ranges;
+  RecordingReader reader(&serialIndex[0], serialIndex.size(), ranges);
+  IntervalIndex<RecordingReader> index(reader);
+  ranges.m_read.clear();
+
+  vector<uint32_t> values;
+  index.ForEach(MakeBackInsertFunctor(values), 100ULL << 24, 200ULL << 24);
+  TEST_EQUAL(values.size(), 100, ());
+  TEST(!ranges.m_prefetched.empty(), ());
+  TEST(!ranges.m_read.empty(), ());
+
+  // Every node is prefetched before it's read.
+  for (auto const & read : ranges.m_read)
+  {
+    bool const prefetched = any_of(ranges.m_prefetched.begin(), ranges.m_prefetched.end(),
+                                   [&read](pair<uint64_t, uint64_t> const & prefetch)
+    {
+      return prefetch.first <= read.first && read.second <= prefetch.second;
+    });
+    TEST(prefetched, (read));
+  }
+}
@@ -0,0 +1,112 @@
+#include "testing/testing.hpp"
+
+#include "indexer/locality_index.hpp"
+#include "indexer/mercator.hpp"
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+using indexer::LocalityIndex;
+
+namespace
+{
+uint32_t const kCoordBits = 30;
+
+vector<LocalityIndex::Locality> MakeLocalities(size_t count)
+{
+  mt19937 rng(0);
+  uniform_real_distribution<double> coord(-10.0, 10.0);
+  uniform_int_distribution<uint32_t> population(1000, 3000000);
+
+  vector<LocalityIndex::Locality> localities;
+  for (uint32_t i = 0; i < count; ++i)
+    localities.emplace_back(i * 3, population(rng), m2::PointD(coord(rng), coord(rng)));
+
+  // Locality at the world edge.
+  localities.emplace_back(7, 500000, m2::PointD(MercatorBounds::maxX, MercatorBounds::minY));
+  return localities;
+}
+}  // namespace
+
+UNIT_TEST(LocalityIndex_Smoke)
+{
+  vector<LocalityIndex::Locality> const localities = MakeLocalities(300);
+
+  vector<char> buffer;
+  MemWriter<vector<char>> writer(buffer);
+  LocalityIndex::Serialize(localities, kCoordBits, writer);
+
+  LocalityIndex index;
+  TEST(index.Load(MemReader(buffer.data(), buffer.size())), ());
+  TEST_EQUAL(index.GetCount(), localities.size(), ());
+
+  vector<m2::RectD> rects;
+  for (size_t i = 0; i < localities.size(); ++i)
+  {
+    TEST_EQUAL(index.Get(i).m_featureId, localities[i].m_featureId, ());
+    TEST_EQUAL(index.Get(i).m_population, localities[i].m_population, ());
+    m2::PointD const center =
+        PointU2PointD(PointD2PointU(localities[i].m_center, kCoordBits), kCoordBits);
+    TEST_EQUAL(index.Get(i).m_center, center, ());
+    rects.push_back(LocalityIndex::GetLocalityRect(center, localities[i].m_population));
+  }
+
+  mt19937 rng(1);
+  uniform_real_distribution<double> coord(-11.0, 11.0);
+  vector<m2::PointD> points;
+  for (size_t i = 0; i < 5000; ++i)
+    points.emplace_back(coord(rng), coord(rng));
+  points.emplace_back(MercatorBounds::maxX, MercatorBounds::minY);
+  points.emplace_back(MercatorBounds::minX, MercatorBounds::maxY);
+
+  size_t found = 0;
+  for (m2::PointD const & pt : points)
+  {
+    vector<uint32_t> expected;
+    for (uint32_t i = 0; i < rects.size(); ++i)
+    {
+      if (rects[i].IsPointInside(pt))
+        expected.push_back(i);
+    }
+
+    vector<uint32_t> actual;
+    index.ForEachAtPoint(pt, [&](uint32_t i) { actual.push_back(i); });
+    sort(actual.begin(), actual.end());
+    TEST_EQUAL(actual, expected, (pt));
+    found += actual.size();
+  }
+  TEST_GREATER(found, 0, ());
+}
+
+UNIT_TEST(LocalityIndex_Malformed)
+{
+  vector<char> buffer;
+  MemWriter<vector<char>> writer(buffer);
+  LocalityIndex::Serialize(MakeLocalities(10), kCoordBits, writer);
+
+  LocalityIndex index;
+  TEST(!index.Load(MemReader(buffer.data(), buffer.size() / 2)), ());
+  TEST(index.IsEmpty(), ());
+
+  // Unknown version.
+  buffer[0] = 1;
+  TEST(!index.Load(MemReader(buffer.data(), buffer.size())), ());
+  TEST(index.IsEmpty(), ());
+}
+
+UNIT_TEST(LocalityIndex_Empty)
+{
+  vector<char> buffer;
+  MemWriter<vector<char>> writer(buffer);
+  LocalityIndex::Serialize(vector<LocalityIndex::Locality>(), kCoordBits, writer);
+
+  LocalityIndex index;
+  TEST(index.Load(MemReader(buffer.data(), buffer.size())), ());
+  TEST(index.IsEmpty(), ());
+  index.ForEachAtPoint(m2::PointD(0, 0), [](uint32_t) { TEST(false, ()); });
+}
@@ -8,6 +8,8 @@
 #include "base/macros.hpp"
 #include "base/logging.hpp"
 
+#include "std/vector.hpp"
+
 
 UNIT_TEST(Mercator_Grid)
 {
@@ -83,3 +85,75 @@ UNIT_TEST(Mercator_Sample1)
   LOG(LINFO, (MercatorBounds::XToLon(27.531491200000001385),
               MercatorBounds::YToLat(64.392864299248202542)));
 }
+
+UNIT_TEST(Mercator_Arrays)
+{
+  vector<m2::PointD> points;
+  for (int i = 0; i < 100; ++i)
+    points.emplace_back(-179.0 + 3.5 * i, 170.0 - 3.3 * i);
+
+  vector<ms::LatLon> latLons(points.size(), ms::LatLon(0.0, 0.0));
+  MercatorBounds::ToLatLon(points.data(), points.size(), latLons.data());
+  vector<m2::PointD> back(points.size());
+  MercatorBounds::FromLatLon(latLons.data(), latLons.size(), back.data());
+
+  vector<double> distances(points.size() - 1);
+  MercatorBounds::SegmentsOnEarth(points.data(), points.size(), distances.data());
+
+  double length = 0.0;
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    ms::LatLon const ll = MercatorBounds::ToLatLon(points[i]);
+    TEST_EQUAL(latLons[i].lat, ll.lat, ());
+    TEST_EQUAL(latLons[i].lon, ll.lon, ());
+    TEST_EQUAL(back[i], MercatorBounds::FromLatLon(ll), ());
+
+    if (i != 0)
+    {
+      double const dist = MercatorBounds::DistanceOnEarth(points[i - 1], points[i]);
+      TEST_EQUAL(distances[i - 1], dist, (i));
+      length += dist;
+    }
+  }
+  TEST_EQUAL(MercatorBounds::LengthOnEarth(points.data(), points.size()), length, ());
+  TEST_EQUAL(MercatorBounds::LengthOnEarth(points.data(), 1), 0.0, ());
+}
+
+UNIT_TEST(Mercator_DistanceOnEarthFrom)
+{
+  m2::PointD const origin = MercatorBounds::FromLatLon(55.75, 37.62);
+  DistanceOnEarthFrom const distanceFrom(origin);
+
+  vector<m2::PointD> points;
+  for (int i = 0; i < 100; ++i)
+    points.emplace_back(-179.0 + 3.5 * i, 170.0 - 3.3 * i);
+  vector<double> distances(points.size());
+  distanceFrom(points.data(), points.size(), distances.data());
+
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    double const dist = MercatorBounds::DistanceOnEarth(origin, points[i]);
+    TEST_EQUAL(distanceFrom(points[i]), dist, (i));
+    TEST_EQUAL(distances[i], dist, (i));
+  }
+}
+
+UNIT_TEST(Mercator_ShortDistanceOnEarth)
+{
+  for (double lat = -80.0; lat <= 80.0; lat += 10.0)
+  {
+    m2::PointD const p1 = MercatorBounds::FromLatLon(lat, 27.5);
+    for (double meters : {1.0, 100.0, 1000.0, 10000.0})
+    {
+      for (int angle = 0; angle < 360; angle += 30)
+      {
+        double const rad = my::DegToRad(static_cast<double>(angle));
+        m2::PointD const p2 = MercatorBounds::GetSmPoint(p1, meters * cos(rad), meters * sin(rad));
+        double const dist = MercatorBounds::DistanceOnEarth(p1, p2);
+        TEST_LESS(fabs(MercatorBounds::ShortDistanceOnEarth(p1, p2) - dist), 1e-5 * dist,
+                  (lat, meters, angle));
+      }
+    }
+  }
+  TEST_EQUAL(MercatorBounds::ShortDistanceOnEarth(m2::PointD(1, 1), m2::PointD(1, 1)), 0.0, ());
+}
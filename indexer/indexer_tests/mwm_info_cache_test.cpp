@@ -0,0 +1,85 @@
+#include "testing/testing.hpp"
+
+#include "indexer/mwm_info_cache.hpp"
+
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+
+#include "platform/country_file.hpp"
+#include "platform/local_country_file.hpp"
+#include "platform/platform.hpp"
+
+#include "base/scope_guard.hpp"
+
+#include "std/bind.hpp"
+
+using platform::CountryFile;
+using platform::LocalCountryFile;
+
+namespace
+{
+void WriteFile(string const & path, size_t size)
+{
+  FileWriter writer(path);
+  writer.Write(string(size, 'm').data(), size);
+}
+}  // namespace
+
+UNIT_TEST(MwmInfoCache_Smoke)
+{
+  Platform & platform = GetPlatform();
+  string const cachePath = platform.WritablePathForFile("mwm_info_cache_test.bin");
+  LocalCountryFile localFile(platform.WritableDir(), CountryFile("MwmInfoCacheTest"), 0);
+  string const mwmPath = localFile.GetPath(MapOptions::Map);
+  MY_SCOPE_GUARD(deleteCache, bind(&my::DeleteFileX, cref(cachePath)));
+  MY_SCOPE_GUARD(deleteMwm, bind(&my::DeleteFileX, cref(mwmPath)));
+
+  WriteFile(mwmPath, 100);
+  localFile.SyncWithDisk();
+
+  MwmInfoCache::Entry entry;
+  entry.m_limitRect = m2::RectD(-1.5, 2.0, 3.0, 4.25);
+  entry.m_minScale = 10;
+  entry.m_maxScale = 17;
+  entry.m_version.format = version::v5;
+  entry.m_version.timestamp = 150912;
+
+  {
+    MwmInfoCache cache(cachePath);
+    MwmInfoCache::Entry found;
+    TEST(!cache.Find(localFile, found), ());
+    cache.Add(localFile, entry);
+    cache.Save();
+  }
+
+  {
+    MwmInfoCache cache(cachePath);
+    MwmInfoCache::Entry found;
+    TEST(cache.Find(localFile, found), ());
+    TEST_EQUAL(found.m_limitRect, entry.m_limitRect, ());
+    TEST_EQUAL(found.m_minScale, entry.m_minScale, ());
+    TEST_EQUAL(found.m_maxScale, entry.m_maxScale, ());
+    TEST_EQUAL(found.m_version.format, entry.m_version.format, ());
+    TEST_EQUAL(found.m_version.timestamp, entry.m_version.timestamp, ());
+    TEST_EQUAL(cache.GetHitsCount(), 1, ());
+  }
+
+  // The replaced file isn't found.
+  WriteFile(mwmPath, 200);
+  localFile.SyncWithDisk();
+  {
+    MwmInfoCache cache(cachePath);
+    MwmInfoCache::Entry found;
+    TEST(!cache.Find(localFile, found), ());
+    // The entry isn't used, so it's dropped.
+    cache.Save();
+  }
+
+  WriteFile(mwmPath, 100);
+  localFile.SyncWithDisk();
+  {
+    MwmInfoCache cache(cachePath);
+    MwmInfoCache::Entry found;
+    TEST(!cache.Find(localFile, found), ());
+  }
+}
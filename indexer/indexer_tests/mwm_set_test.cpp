@@ -4,10 +4,15 @@
 
 #include "indexer/mwm_set.hpp"
 
+#include "platform/platform.hpp"
+
 #include "base/macros.hpp"
+#include "base/string_utils.hpp"
 
 #include "std/initializer_list.hpp"
+#include "std/thread.hpp"
 #include "std/unordered_map.hpp"
+#include "std/vector.hpp"
 
 using platform::CountryFile;
 using platform::LocalCountryFile;
@@ -157,3 +162,91 @@ UNIT_TEST(MwmSetLockAndIdTest)
   TEST(!handle.GetId().IsAlive(), ());
   TEST(!handle.GetId().GetInfo().get(), ());
 }
+
+UNIT_TEST(MwmSetConcurrentHandlesTest)
+{
+  TestMwmSet mwmSet;
+  for (char const * name : {"0", "1", "2", "3", "4", "5", "6", "7"})
+    TEST_EQUAL(MwmSet::RegResult::Success, mwmSet.Register(LocalCountryFile::MakeForTesting(name)).second, ());
+
+  size_t const kNumThreads = 8;
+  size_t const kNumIterations = 1000;
+
+  vector<thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i)
+  {
+    threads.emplace_back([&mwmSet, i, kNumIterations]()
+    {
+      for (size_t j = 0; j < kNumIterations; ++j)
+      {
+        CountryFile const countryFile(strings::to_string((i + j) % 8));
+        MwmSet::MwmHandle const handle1 = mwmSet.GetMwmHandleByCountryFile(countryFile);
+        MwmSet::MwmHandle const handle2 = mwmSet.GetMwmHandleById(handle1.GetId());
+        TEST(handle1.IsAlive(), ());
+        TEST(handle2.IsAlive(), ());
+        TEST_GREATER_OR_EQUAL(handle1.GetInfo()->GetNumRefs(), 2, ());
+      }
+    });
+  }
+  for (auto & t : threads)
+    t.join();
+
+  vector<shared_ptr<MwmInfo>> infos;
+  mwmSet.GetMwmsInfo(infos);
+  TEST_EQUAL(8, infos.size(), ());
+  for (auto const & info : infos)
+    TEST_EQUAL(0, info->GetNumRefs(), (info->GetCountryName()));
+
+  MwmSet::LockStats const stats = mwmSet.GetRegistryLockStats();
+  TEST_GREATER_OR_EQUAL(stats.m_acquisitions, 2 * kNumThreads * kNumIterations, ());
+  TEST_LESS_OR_EQUAL(stats.m_contentions, stats.m_acquisitions, ());
+
+  // Cached values must be dropped after deregistration.
+  TEST(mwmSet.Deregister(CountryFile("3")), ());
+  TEST(!mwmSet.GetMwmHandleByCountryFile(CountryFile("3")).IsAlive(), ());
+}
+
+UNIT_TEST(MwmSetUpdateWithHandlesTest)
+{
+  TestMwmSet mwmSet;
+  CountryFile const countryFile("1");
+  LocalCountryFile const localFileV1(GetPlatform().WritableDir(), countryFile, 1 /* version */);
+  LocalCountryFile const localFileV2(GetPlatform().WritableDir(), countryFile, 2 /* version */);
+
+  uint64_t const epoch0 = mwmSet.GetEpoch();
+  auto const p1 = mwmSet.Register(localFileV1);
+  TEST_EQUAL(MwmSet::RegResult::Success, p1.second, ());
+  TEST_GREATER(mwmSet.GetEpoch(), epoch0, ());
+
+  uint64_t epoch2;
+  {
+    MwmSet::MwmHandle const handleV1 = mwmSet.GetMwmHandleByCountryFile(countryFile);
+    TEST(handleV1.IsAlive(), ());
+
+    uint64_t const epoch1 = mwmSet.GetEpoch();
+    auto const p2 = mwmSet.Register(localFileV2);
+    TEST_EQUAL(MwmSet::RegResult::Success, p2.second, ());
+    epoch2 = mwmSet.GetEpoch();
+    TEST_GREATER(epoch2, epoch1, ());
+
+    // New requests get the new version at once, the reader of the old one keeps using it.
+    TEST_EQUAL(p2.first, mwmSet.GetMwmIdByCountryFile(countryFile), ());
+    MwmSet::MwmHandle const handleV2 = mwmSet.GetMwmHandleByCountryFile(countryFile);
+    TEST(handleV2.IsAlive(), ());
+    TEST_EQUAL(2, handleV2.GetInfo()->GetVersion(), ());
+
+    TEST(handleV1.IsAlive(), ());
+    TEST_EQUAL(1, handleV1.GetInfo()->GetVersion(), ());
+    TEST_EQUAL(MwmInfo::STATUS_MARKED_TO_DEREGISTER, handleV1.GetInfo()->GetStatus(), ());
+
+    TMwmsInfo mwmsInfo;
+    GetMwmsInfo(mwmSet, mwmsInfo);
+    TestFilesPresence(mwmsInfo, {"1"});
+    TEST_EQUAL(p2.first.GetInfo(), mwmsInfo["1"], ());
+  }
+
+  // The old version is removed with its last handle, it doesn't change the registered mwms.
+  TEST_EQUAL(MwmInfo::STATUS_DEREGISTERED, p1.first.GetInfo()->GetStatus(), ());
+  TEST_EQUAL(epoch2, mwmSet.GetEpoch(), ());
+  TEST(mwmSet.GetMwmHandleByCountryFile(countryFile).IsAlive(), ());
+}
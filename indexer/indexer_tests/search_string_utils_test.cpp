@@ -38,3 +38,26 @@ UNIT_TEST(NormalizeAndSimplifyStringWithOurTambourines)
   for (size_t i = 0; i < ARRAY_SIZE(arr); i += 2)
     TEST_EQUAL(arr[i + 1], strings::ToUtf8(search::NormalizeAndSimplifyString(arr[i])), (i));
 }
+
+UNIT_TEST(NormalizeAndSimplifyString_Table)
+{
+  // Chars of the lookup table and of the slow path should be normalized like the decoded string.
+  strings::UniString result;
+  for (strings::UniChar c = 1; c < 0x3000; ++c)
+  {
+    strings::UniString expected(1, c);
+    search::NormalizeAndSimplifyUniString(expected);
+    search::NormalizeAndSimplifyString(strings::ToUtf8(strings::UniString(1, c)), result);
+    TEST_EQUAL(expected, result, (c));
+  }
+
+  string const arr[] = {"Main Street 12", "Œuvre Straße", "ÆØÅ İstanbul バス", ""};
+  for (string const & s : arr)
+  {
+    strings::UniString expected = strings::MakeUniString(s);
+    search::NormalizeAndSimplifyUniString(expected);
+    search::NormalizeAndSimplifyString(s, result);
+    TEST_EQUAL(expected, result, (s));
+    TEST_EQUAL(expected, search::NormalizeAndSimplifyString(s), (s));
+  }
+}
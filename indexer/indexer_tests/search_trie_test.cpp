@@ -0,0 +1,56 @@
+#include "testing/testing.hpp"
+
+#include "indexer/data_header.hpp"
+#include "indexer/search_trie.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/mmap_reader.hpp"
+
+#include "defines.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+typedef vector<pair<vector<trie::TrieChar>, uint32_t>> TEntries;
+
+struct EntriesCollector
+{
+  void operator()(vector<trie::TrieChar> const & key, trie::ValueReader::ValueType const & value)
+  {
+    m_entries.emplace_back(key, value.m_featureId);
+  }
+
+  TEntries m_entries;
+};
+
+TEntries ReadEntries(FilesContainerR const & cont, bool expectMapped)
+{
+  feature::DataHeader const header(cont);
+  serial::CodingParams const cp(trie::GetCodingParams(header.GetDefCodingParams()));
+  ModelReaderPtr const reader = cont.GetReader(SEARCH_INDEX_FILE_TAG);
+  TEST_EQUAL(MappedSection::GetData(reader) != nullptr, expectMapped, ());
+
+  unique_ptr<trie::DefaultIterator> const root(
+      trie::ReadSearchTrie(reader, cp, header.GetFormat()));
+  EntriesCollector collector;
+  trie::ForEachRef(*root, collector, vector<trie::TrieChar>());
+  sort(collector.m_entries.begin(), collector.m_entries.end());
+  return collector.m_entries;
+}
+}  // namespace
+
+UNIT_TEST(SearchTrie_MappedAndReadAreEqual)
+{
+  string const path = GetPlatform().WritablePathForFile("minsk-pass" DATA_FILE_EXTENSION);
+  TEntries const read = ReadEntries(FilesContainerR(path), false /* expectMapped */);
+  TEntries const mapped =
+      ReadEntries(FilesContainerR(ModelReaderPtr(new MmapReader(path))), true /* expectMapped */);
+  TEST(!read.empty(), ());
+  TEST(read == mapped, (read.size(), mapped.size()));
+}
@@ -60,3 +60,33 @@ UNIT_TEST(SortAndMergeIntervals_ContainAndTouchBorder)
 
 
 
+
+UNIT_TEST(SubtractIntervals_Smoke)
+{
+  vector<pair<int64_t, int64_t> > a;
+  a.push_back(make_pair(1ULL, 5ULL));
+  a.push_back(make_pair(7ULL, 9ULL));
+  a.push_back(make_pair(10ULL, 20ULL));
+
+  vector<pair<int64_t, int64_t> > b;
+  b.push_back(make_pair(0ULL, 2ULL));
+  b.push_back(make_pair(3ULL, 4ULL));
+  b.push_back(make_pair(7ULL, 9ULL));
+  b.push_back(make_pair(12ULL, 13ULL));
+  b.push_back(make_pair(15ULL, 25ULL));
+
+  vector<pair<int64_t, int64_t> > e;
+  e.push_back(make_pair(2ULL, 3ULL));
+  e.push_back(make_pair(4ULL, 5ULL));
+  e.push_back(make_pair(10ULL, 12ULL));
+  e.push_back(make_pair(13ULL, 15ULL));
+  TEST_EQUAL(covering::SubtractIntervals(a, b), e, ());
+
+  e.clear();
+  e.push_back(make_pair(0ULL, 1ULL));
+  e.push_back(make_pair(20ULL, 25ULL));
+  TEST_EQUAL(covering::SubtractIntervals(b, a), e, ());
+
+  TEST(covering::SubtractIntervals(a, a).empty(), ());
+  TEST_EQUAL(covering::SubtractIntervals(a, covering::IntervalsT()), a, ());
+}
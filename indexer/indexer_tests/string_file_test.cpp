@@ -0,0 +1,66 @@
+#include "testing/testing.hpp"
+
+#include "indexer/string_file.hpp"
+#include "indexer/string_file_values.hpp"
+
+#include "platform/platform.hpp"
+
+#include "base/scope_guard.hpp"
+#include "base/string_utils.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/bind.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+using TStringsFile = StringsFile<FeatureIndexValue>;
+
+void TestStringsFile(size_t threadsCount, uint64_t maxMemoryBytes, size_t minGroupsCount)
+{
+  string const path = GetPlatform().WritablePathForFile("string_file_test.tmp");
+  MY_SCOPE_GUARD(fileGuard, bind(&FileWriter::DeleteFileX, path));
+
+  vector<TStringsFile::TString> expected;
+  for (uint32_t i = 0; i < 1000; ++i)
+  {
+    FeatureIndexValue value;
+    value.m_value = i;
+    // Names are repeated, so the groups are merged by the names and by the values.
+    expected.emplace_back(strings::MakeUniString(strings::to_string((i * 7919) % 97)),
+                          0 /* lang */, value);
+  }
+
+  vector<TStringsFile::TString> actual;
+  {
+    TStringsFile names(path, threadsCount, maxMemoryBytes);
+    for (auto const & s : expected)
+      names.AddString(s);
+    names.EndAdding();
+    TEST_EQUAL(names.GetStringsCount(), expected.size(), ());
+    TEST_GREATER_OR_EQUAL(names.GetGroupsCount(), minGroupsCount, ());
+
+    names.OpenForRead();
+    for (auto it = names.Begin(); it != names.End(); ++it)
+      actual.push_back(*it);
+  }
+
+  sort(expected.begin(), expected.end());
+  TEST_EQUAL(actual.size(), expected.size(), ());
+  TEST(actual == expected, ());
+}
+}  // namespace
+
+UNIT_TEST(StringsFile_OneGroup)
+{
+  TestStringsFile(1 /* threadsCount */, 1024 * 1024 * 1024 /* maxMemoryBytes */,
+                  1 /* minGroupsCount */);
+}
+
+UNIT_TEST(StringsFile_SpillsGroupsAboveMemoryCap)
+{
+  // A group takes about a kilobyte, so there are tens of them.
+  TestStringsFile(1 /* threadsCount */, 4 * 1024 /* maxMemoryBytes */, 20 /* minGroupsCount */);
+  TestStringsFile(3 /* threadsCount */, 6 * 1024 /* maxMemoryBytes */, 20 /* minGroupsCount */);
+}
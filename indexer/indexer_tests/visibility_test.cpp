@@ -89,3 +89,45 @@ UNIT_TEST(VisibleScales_Highway)
 
   doGet.Print();
 }
+
+UNIT_TEST(VisibleScales_CompiledDrawRules)
+{
+  classificator::Load();
+  Classificator const & c = classif();
+
+  vector<uint32_t> types;
+  auto const addType = [&types](ClassifObject const *, uint32_t type) { types.push_back(type); };
+  c.ForEachTree(addType);
+  TEST(!types.empty(), ());
+
+  auto const getRules = [&types]()
+  {
+    vector<drule::KeysT> rules;
+    for (uint32_t type : types)
+    {
+      for (int scale = 0; scale <= scales::GetUpperScale(); ++scale)
+      {
+        for (int ft = feature::GEOM_POINT; ft <= feature::GEOM_AREA; ++ft)
+        {
+          rules.emplace_back();
+          feature::GetDrawRule({type}, scale, ft, rules.back());
+        }
+      }
+    }
+    return rules;
+  };
+
+  // The compiled rules are the same as the ones from the classificator tree.
+  vector<drule::KeysT> const compiled = getRules();
+  feature::ClearCompiledDrawRules();
+  vector<drule::KeysT> const rules = getRules();
+  feature::CompileDrawRules();
+
+  TEST_EQUAL(compiled.size(), rules.size(), ());
+  for (size_t i = 0; i < rules.size(); ++i)
+  {
+    TEST_EQUAL(compiled[i].size(), rules[i].size(), (i));
+    for (size_t j = 0; j < rules[i].size(); ++j)
+      TEST(compiled[i][j] == rules[i][j], (i, j));
+  }
+}
@@ -3,12 +3,15 @@
 
 #include "coding/endianness.hpp"
 #include "coding/byte_stream.hpp"
+#include "coding/mapped_section.hpp"
 #include "coding/reader.hpp"
 #include "coding/varint.hpp"
 
 #include "base/assert.hpp"
 #include "base/buffer_vector.hpp"
 
+#include "std/vector.hpp"
+
 
 class IntervalIndexBase : public IntervalIndexIFace
 {
@@ -31,6 +34,18 @@ public:
   }
 
   enum { kVersion = 1 };
+
+  /// Root nodes not greater than this size are kept in memory by IntervalIndex.
+  static uint32_t const kMaxCachedRootSize = 4096;
+
+protected:
+  /// @return Pointer to the reader's data when it's memory mapped, nullptr otherwise.
+  template <class ReaderT>
+  static uint8_t const * GetDirectData(ReaderT const &) { return nullptr; }
+  static uint8_t const * GetDirectData(ModelReaderPtr const & reader)
+  {
+    return MappedSection::GetData(reader);
+  }
 };
 
 template <class ReaderT>
@@ -39,16 +54,32 @@ class IntervalIndex : public IntervalIndexBase
   typedef IntervalIndexBase base_t;
 public:
 
-  explicit IntervalIndex(ReaderT const & reader) : m_Reader(reader)
+  /// Nodes are accessed directly without copying when the reader is memory mapped.
+  /// Otherwise the root node (if it's small enough) is cached, and other nodes are read on demand.
+  explicit IntervalIndex(ReaderT const & reader)
+    : m_Reader(reader), m_pData(GetDirectData(reader))
   {
     ReaderSource<ReaderT> src(reader);
     src.Read(&m_Header, sizeof(Header));
     CHECK_EQUAL(m_Header.m_Version, static_cast<uint8_t>(kVersion), ());
     if (m_Header.m_Levels != 0)
+    {
       for (int i = 0; i <= m_Header.m_Levels + 1; ++i)
         m_LevelOffsets.push_back(ReadPrimitiveFromSource<uint32_t>(src));
+
+      uint32_t const rootSize = GetRootSize();
+      if (m_pData == nullptr && rootSize <= kMaxCachedRootSize)
+      {
+        m_root.resize(rootSize);
+        if (rootSize != 0)
+          m_Reader.Read(m_LevelOffsets[m_Header.m_Levels], &m_root[0], rootSize);
+      }
+    }
   }
 
+  /// @return true if the index nodes are accessed without copying.
+  bool IsDirectAccess() const { return (m_pData != nullptr); }
+
   uint64_t KeyEnd() const
   {
     return 1ULL << (m_Header.m_Levels * m_Header.m_BitsPerLevel + m_Header.m_LeafBytes * 8);
@@ -66,8 +97,7 @@ public:
       if (end > KeyEnd())
         end = KeyEnd();
       --end;  // end is inclusive in ForEachImpl().
-      ForEachNode(f, beg, end, m_Header.m_Levels, 0,
-                  m_LevelOffsets[m_Header.m_Levels + 1] - m_LevelOffsets[m_Header.m_Levels]);
+      ForEachNode(f, beg, end, m_Header.m_Levels, 0, GetRootSize());
     }
   }
 
@@ -77,18 +107,38 @@ public:
   }
 
 private:
+  inline uint32_t GetRootSize() const
+  {
+    return m_LevelOffsets[m_Header.m_Levels + 1] - m_LevelOffsets[m_Header.m_Levels];
+  }
+
+  /// @return Pointer to the node data: mapped memory, cached root or data copied into buffer.
+  template <class TBuffer>
+  uint8_t const * GetNodeData(int level, uint32_t offset, uint32_t size, TBuffer & buffer) const
+  {
+    if (m_pData)
+      return m_pData + offset;
+
+    if (level == m_Header.m_Levels && !m_root.empty())
+    {
+      ASSERT_EQUAL(size, m_root.size(), ());
+      return &m_root[0];
+    }
+
+    buffer.resize_no_init(size);
+    m_Reader.Read(offset, &buffer[0], size);
+    return &buffer[0];
+  }
 
   template <typename F>
   void ForEachLeaf(F const & f, uint64_t const beg, uint64_t const end,
                    uint32_t const offset, uint32_t const size) const
   {
-    buffer_vector<uint8_t, 1024> data;
-    data.resize_no_init(size);
-
-    m_Reader.Read(offset, &data[0], size);
-    ArrayByteSource src(&data[0]);
+    buffer_vector<uint8_t, 1024> buffer;
+    uint8_t const * data = GetNodeData(0, offset, size, buffer);
+    ArrayByteSource src(data);
 
-    void const * pEnd = &data[0] + size;
+    void const * pEnd = data + size;
     uint32_t value = 0;
     while (src.Ptr() < pEnd)
     {
@@ -123,12 +173,13 @@ private:
     uint32_t const end0 = static_cast<uint32_t>(end >> skipBits);
     ASSERT_LESS(end0, (1U << m_Header.m_BitsPerLevel), (beg, end, skipBits));
 
-    buffer_vector<uint8_t, 576> data;
-    data.resize_no_init(size);
-
-    m_Reader.Read(offset, &data[0], size);
-    ArrayByteSource src(&data[0]);
+    buffer_vector<uint8_t, 576> buffer;
+    uint8_t const * data = GetNodeData(level, offset, size, buffer);
+    ArrayByteSource src(data);
 
+    // Children in [beg0, end0] are collected first, so their data is prefetched at once
+    // and the reading overlaps with the traversal of the first children.
+    buffer_vector<Child, 64> children;
     uint32_t const offsetAndFlag = ReadVarUint<uint32_t>(src);
     uint32_t childOffset = offsetAndFlag >> 1;
     if (offsetAndFlag & 1)
@@ -142,21 +193,17 @@ private:
         {
           uint32_t childSize = ReadVarUint<uint32_t>(src);
           if (i >= beg0)
-          {
-            uint64_t const beg1 = (i == beg0) ? (beg & levelBytesFF) : 0;
-            uint64_t const end1 = (i == end0) ? (end & levelBytesFF) : levelBytesFF;
-            ForEachNode(f, beg1, end1, level - 1, childOffset, childSize);
-          }
+            children.push_back({i, childOffset, childSize});
           childOffset += childSize;
         }
       }
       ASSERT(end0 != (1 << m_Header.m_BitsPerLevel) - 1 ||
-             static_cast<uint8_t const *>(src.Ptr()) - &data[0] == size,
-             (beg, end, beg0, end0, offset, size, src.Ptr(), &data[0]));
+             static_cast<uint8_t const *>(src.Ptr()) - data == size,
+             (beg, end, beg0, end0, offset, size, src.Ptr(), data));
     }
     else
     {
-      void const * pEnd = &data[0] + size;
+      void const * pEnd = data + size;
       while (src.Ptr() < pEnd)
       {
         uint8_t const i = src.ReadByte();
@@ -164,17 +211,39 @@ private:
           break;
         uint32_t childSize = ReadVarUint<uint32_t>(src);
         if (i >= beg0)
-        {
-          uint64_t const beg1 = (i == beg0) ? (beg & levelBytesFF) : 0;
-          uint64_t const end1 = (i == end0) ? (end & levelBytesFF) : levelBytesFF;
-          ForEachNode(f, beg1, end1, level - 1, childOffset, childSize);
-        }
+          children.push_back({i, childOffset, childSize});
         childOffset += childSize;
       }
     }
+
+    if (children.empty())
+      return;
+
+    uint32_t const levelOffset = m_LevelOffsets[level - 1];
+    uint32_t const childrenBegin = children.front().m_offset;
+    uint32_t const childrenEnd = children.back().m_offset + children.back().m_size;
+    m_Reader.Prefetch(levelOffset + childrenBegin, childrenEnd - childrenBegin);
+
+    for (Child const & child : children)
+    {
+      uint64_t const beg1 = (child.m_index == beg0) ? (beg & levelBytesFF) : 0;
+      uint64_t const end1 = (child.m_index == end0) ? (end & levelBytesFF) : levelBytesFF;
+      ForEachNode(f, beg1, end1, level - 1, child.m_offset, child.m_size);
+    }
   }
 
+  struct Child
+  {
+    uint32_t m_index;
+    uint32_t m_offset;
+    uint32_t m_size;
+  };
+
   ReaderT m_Reader;
+  /// Not null when the reader is memory mapped.
+  uint8_t const * m_pData;
   Header m_Header;
   buffer_vector<uint32_t, 7> m_LevelOffsets;
+  /// Copy of the root node, which is visited by every query.
+  vector<uint8_t> m_root;
 };
@@ -0,0 +1,221 @@
+#include "indexer/locality_index.hpp"
+
+#include "indexer/ftypes_matcher.hpp"
+#include "indexer/mercator.hpp"
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/utility.hpp"
+
+namespace indexer
+{
+namespace
+{
+uint32_t const kMaxGridBits = 16;
+
+uint32_t CoordToCell(double coord, double minCoord, double maxCoord, uint32_t gridBits)
+{
+  uint32_t const cellsCount = 1U << gridBits;
+  double const cell = (coord - minCoord) / (maxCoord - minCoord) * cellsCount;
+  if (cell <= 0.0)
+    return 0;
+  if (cell >= cellsCount - 1)
+    return cellsCount - 1;
+  return static_cast<uint32_t>(cell);
+}
+
+uint32_t CellX(double x, uint32_t gridBits)
+{
+  return CoordToCell(x, MercatorBounds::minX, MercatorBounds::maxX, gridBits);
+}
+
+uint32_t CellY(double y, uint32_t gridBits)
+{
+  return CoordToCell(y, MercatorBounds::minY, MercatorBounds::maxY, gridBits);
+}
+
+uint32_t CellKey(uint32_t x, uint32_t y, uint32_t gridBits) { return (y << gridBits) | x; }
+
+template <typename TSource>
+void ReadArray(TSource & src, uint32_t count, vector<uint32_t> & v)
+{
+  v.resize(count);
+  for (uint32_t & value : v)
+    value = ReadPrimitiveFromSource<uint32_t>(src);
+}
+
+template <typename TSink>
+void WriteArray(TSink & sink, vector<uint32_t> const & v)
+{
+  for (uint32_t const value : v)
+    WriteToSink(sink, value);
+}
+}  // namespace
+
+// static
+uint32_t const LocalityIndex::kVersion;
+// static
+uint32_t const LocalityIndex::kDefaultGridBits;
+
+// static
+m2::RectD LocalityIndex::GetLocalityRect(m2::PointD const & center, uint32_t population)
+{
+  return MercatorBounds::RectByCenterXYAndSizeInMeters(center,
+                                                       ftypes::GetRadiusByPopulation(population));
+}
+
+// static
+void LocalityIndex::Serialize(vector<Locality> const & localities, uint32_t coordBits,
+                              Writer & writer, uint32_t gridBits)
+{
+  CHECK_LESS_OR_EQUAL(gridBits, kMaxGridBits, ());
+
+  // Pairs of (cell key, locality).
+  vector<pair<uint32_t, uint32_t>> cells;
+  for (size_t i = 0; i < localities.size(); ++i)
+  {
+    m2::PointD const center = PointU2PointD(PointD2PointU(localities[i].m_center, coordBits), coordBits);
+    m2::RectD const rect = GetLocalityRect(center, localities[i].m_population);
+
+    uint32_t const minX = CellX(rect.minX(), gridBits);
+    uint32_t const maxX = CellX(rect.maxX(), gridBits);
+    uint32_t const minY = CellY(rect.minY(), gridBits);
+    uint32_t const maxY = CellY(rect.maxY(), gridBits);
+    for (uint32_t y = minY; y <= maxY; ++y)
+    {
+      for (uint32_t x = minX; x <= maxX; ++x)
+        cells.emplace_back(CellKey(x, y, gridBits), static_cast<uint32_t>(i));
+    }
+  }
+  sort(cells.begin(), cells.end());
+
+  vector<uint32_t> cellKeys;
+  vector<uint32_t> cellOffsets;
+  vector<uint32_t> candidates;
+  candidates.reserve(cells.size());
+  for (auto const & cell : cells)
+  {
+    if (cellKeys.empty() || cellKeys.back() != cell.first)
+    {
+      cellKeys.push_back(cell.first);
+      cellOffsets.push_back(static_cast<uint32_t>(candidates.size()));
+    }
+    candidates.push_back(cell.second);
+  }
+  cellOffsets.push_back(static_cast<uint32_t>(candidates.size()));
+
+  WriteToSink(writer, kVersion);
+  WriteToSink(writer, coordBits);
+  WriteToSink(writer, gridBits);
+  WriteToSink(writer, static_cast<uint32_t>(localities.size()));
+  WriteToSink(writer, static_cast<uint32_t>(cellKeys.size()));
+  WriteToSink(writer, static_cast<uint32_t>(candidates.size()));
+
+  for (Locality const & locality : localities)
+  {
+    m2::PointU const pu = PointD2PointU(locality.m_center, coordBits);
+    WriteToSink(writer, locality.m_featureId);
+    WriteToSink(writer, locality.m_population);
+    WriteToSink(writer, pu.x);
+    WriteToSink(writer, pu.y);
+  }
+  WriteArray(writer, cellKeys);
+  WriteArray(writer, cellOffsets);
+  WriteArray(writer, candidates);
+}
+
+bool LocalityIndex::Deserialize(MemReader const & reader)
+{
+  Clear();
+
+  uint64_t const kHeaderSize = 6 * sizeof(uint32_t);
+  if (reader.Size() < kHeaderSize)
+  {
+    LOG(LWARNING, ("Malformed locality index header."));
+    return false;
+  }
+
+  ReaderSource<MemReader> src(reader);
+  uint32_t const version = ReadPrimitiveFromSource<uint32_t>(src);
+  if (version != kVersion)
+  {
+    LOG(LWARNING, ("Unknown locality index version:", version));
+    return false;
+  }
+
+  uint32_t const coordBits = ReadPrimitiveFromSource<uint32_t>(src);
+  uint32_t const gridBits = ReadPrimitiveFromSource<uint32_t>(src);
+  uint32_t const localitiesCount = ReadPrimitiveFromSource<uint32_t>(src);
+  uint32_t const cellsCount = ReadPrimitiveFromSource<uint32_t>(src);
+  uint32_t const candidatesCount = ReadPrimitiveFromSource<uint32_t>(src);
+
+  uint64_t const size = kHeaderSize + uint64_t(localitiesCount) * 4 * sizeof(uint32_t) +
+                        (2 * uint64_t(cellsCount) + 1 + candidatesCount) * sizeof(uint32_t);
+  if (gridBits > kMaxGridBits || coordBits == 0 || coordBits > 32 || reader.Size() != size)
+  {
+    LOG(LWARNING, ("Malformed locality index header."));
+    return false;
+  }
+
+  m_gridBits = gridBits;
+  m_localities.resize(localitiesCount);
+  m_rects.reserve(localitiesCount);
+  for (Locality & locality : m_localities)
+  {
+    locality.m_featureId = ReadPrimitiveFromSource<uint32_t>(src);
+    locality.m_population = ReadPrimitiveFromSource<uint32_t>(src);
+    m2::PointU pu;
+    pu.x = ReadPrimitiveFromSource<uint32_t>(src);
+    pu.y = ReadPrimitiveFromSource<uint32_t>(src);
+    locality.m_center = PointU2PointD(pu, coordBits);
+    m_rects.push_back(GetLocalityRect(locality.m_center, locality.m_population));
+  }
+
+  ReadArray(src, cellsCount, m_cellKeys);
+  ReadArray(src, cellsCount + 1, m_cellOffsets);
+  ReadArray(src, candidatesCount, m_candidates);
+
+  // Check the data, so lookups don't go out of the arrays.
+  for (size_t i = 0; i + 1 < m_cellOffsets.size(); ++i)
+  {
+    if (m_cellOffsets[i] > m_cellOffsets[i + 1] || (i > 0 && m_cellKeys[i - 1] >= m_cellKeys[i]))
+    {
+      LOG(LWARNING, ("Malformed locality index cells."));
+      Clear();
+      return false;
+    }
+  }
+  bool isValid = m_cellOffsets.front() == 0 && m_cellOffsets.back() == m_candidates.size();
+  for (uint32_t const locality : m_candidates)
+    isValid = isValid && locality < m_localities.size();
+  if (!isValid)
+  {
+    LOG(LWARNING, ("Malformed locality index candidates."));
+    Clear();
+    return false;
+  }
+
+  return true;
+}
+
+void LocalityIndex::Clear()
+{
+  m_gridBits = kDefaultGridBits;
+  m_localities.clear();
+  m_rects.clear();
+  m_cellKeys.clear();
+  m_cellOffsets.clear();
+  m_candidates.clear();
+}
+
+uint32_t LocalityIndex::GetCellKey(m2::PointD const & pt) const
+{
+  return CellKey(CellX(pt.x, m_gridBits), CellY(pt.y, m_gridBits), m_gridBits);
+}
+}  // namespace indexer
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "coding/reader.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+namespace indexer
+{
+/// Attribution of the world points to the cities and towns, which may enclose them.
+/// The world is split to a uniform grid in mercator, and every non-empty cell keeps
+/// the localities whose areas (see GetLocalityRect()) intersect the cell, so a point
+/// is checked against the few candidates of its cell instead of a spatial query
+/// over the world features. It's written by the generator to the world mwm.
+class LocalityIndex
+{
+public:
+  struct Locality
+  {
+    Locality() : m_featureId(0), m_population(0) {}
+    Locality(uint32_t featureId, uint32_t population, m2::PointD const & center)
+      : m_featureId(featureId), m_population(population), m_center(center)
+    {
+    }
+
+    uint32_t m_featureId;
+    uint32_t m_population;
+    m2::PointD m_center;
+  };
+
+  static uint32_t const kVersion = 0;
+  /// Cells are about 40 km at the equator.
+  static uint32_t const kDefaultGridBits = 10;
+
+  /// Area of the locality, it's the same as search::LocalityFinder uses.
+  static m2::RectD GetLocalityRect(m2::PointD const & center, uint32_t population);
+
+  /// Writes the index, centers are quantized with |coordBits| as feature points are.
+  static void Serialize(vector<Locality> const & localities, uint32_t coordBits, Writer & writer,
+                        uint32_t gridBits = kDefaultGridBits);
+
+  /// @return False when the data are malformed or of an unknown version.
+  template <typename TReader>
+  bool Load(TReader const & reader)
+  {
+    vector<char> data(static_cast<size_t>(reader.Size()));
+    reader.Read(0, data.data(), data.size());
+    return Deserialize(MemReader(data.data(), data.size()));
+  }
+  void Clear();
+
+  inline bool IsEmpty() const { return m_localities.empty(); }
+  inline size_t GetCount() const { return m_localities.size(); }
+  inline Locality const & Get(size_t i) const { return m_localities[i]; }
+  inline m2::RectD const & GetRect(size_t i) const { return m_rects[i]; }
+
+  /// Calls fn(i) for every locality whose area contains the point.
+  template <typename TFn>
+  void ForEachAtPoint(m2::PointD const & pt, TFn && fn) const
+  {
+    uint32_t const key = GetCellKey(pt);
+    auto const it = lower_bound(m_cellKeys.begin(), m_cellKeys.end(), key);
+    if (it == m_cellKeys.end() || *it != key)
+      return;
+
+    size_t const cell = distance(m_cellKeys.begin(), it);
+    for (uint32_t i = m_cellOffsets[cell]; i < m_cellOffsets[cell + 1]; ++i)
+    {
+      uint32_t const locality = m_candidates[i];
+      if (m_rects[locality].IsPointInside(pt))
+        fn(locality);
+    }
+  }
+
+private:
+  bool Deserialize(MemReader const & reader);
+  uint32_t GetCellKey(m2::PointD const & pt) const;
+
+  uint32_t m_gridBits = kDefaultGridBits;
+
+  vector<Locality> m_localities;
+  vector<m2::RectD> m_rects;
+  // Sorted keys of non-empty cells.
+  vector<uint32_t> m_cellKeys;
+  // Localities of the i-th cell are [m_cellOffsets[i], m_cellOffsets[i + 1]) in m_candidates.
+  vector<uint32_t> m_cellOffsets;
+  vector<uint32_t> m_candidates;
+};
+}  // namespace indexer
@@ -2,6 +2,41 @@
 
 #include "geometry/distance_on_sphere.hpp"
 
+#include "std/algorithm.hpp"
+
+namespace
+{
+/// Point on sphere with the values which are reused by the both adjacent segments.
+struct SpherePoint
+{
+  explicit SpherePoint(m2::PointD const & pt)
+    : m_lat(my::DegToRad(MercatorBounds::YToLat(pt.y)))
+    , m_lon(my::DegToRad(MercatorBounds::XToLon(pt.x)))
+    , m_cosLat(cos(m_lat))
+  {
+  }
+
+  double m_lat;
+  double m_lon;
+  double m_cosLat;
+};
+
+/// The same arithmetic as ms::DistanceOnEarth.
+inline double DistanceOnEarth(double lat1, double lon1, double cosLat1, double lat2, double lon2,
+                              double cosLat2)
+{
+  double const dlat = sin((lat2 - lat1) * 0.5);
+  double const dlon = sin((lon2 - lon1) * 0.5);
+  double const y = dlat * dlat + dlon * dlon * cosLat1 * cosLat2;
+  return ms::EarthRadiusMeters() * (2.0 * atan2(sqrt(y), sqrt(max(0.0, 1.0 - y))));
+}
+
+inline double DistanceOnEarth(SpherePoint const & p1, SpherePoint const & p2)
+{
+  return DistanceOnEarth(p1.m_lat, p1.m_lon, p1.m_cosLat, p2.m_lat, p2.m_lon, p2.m_cosLat);
+}
+}  // namespace
+
 double MercatorBounds::minX = -180;
 double MercatorBounds::maxX = 180;
 double MercatorBounds::minY = -180;
@@ -41,12 +76,79 @@ m2::PointD MercatorBounds::GetSmPoint(m2::PointD const & pt, double lonMetresR,
   return FromLatLon(newLat, newLon);
 }
 
+// static
+void MercatorBounds::ToLatLon(m2::PointD const * points, size_t count, ms::LatLon * result)
+{
+  for (size_t i = 0; i < count; ++i)
+    result[i] = ToLatLon(points[i]);
+}
+
+// static
+void MercatorBounds::FromLatLon(ms::LatLon const * points, size_t count, m2::PointD * result)
+{
+  for (size_t i = 0; i < count; ++i)
+    result[i] = FromLatLon(points[i]);
+}
+
 double MercatorBounds::DistanceOnEarth(m2::PointD const & p1, m2::PointD const & p2)
 {
   return ms::DistanceOnEarth(ToLatLon(p1), ToLatLon(p2));
 }
 
+// static
+void MercatorBounds::SegmentsOnEarth(m2::PointD const * points, size_t count, double * distances)
+{
+  if (count < 2)
+    return;
+
+  SpherePoint prev(points[0]);
+  for (size_t i = 1; i < count; ++i)
+  {
+    SpherePoint const curr(points[i]);
+    distances[i - 1] = ::DistanceOnEarth(prev, curr);
+    prev = curr;
+  }
+}
+
+// static
+double MercatorBounds::LengthOnEarth(m2::PointD const * points, size_t count)
+{
+  if (count < 2)
+    return 0.0;
+
+  double length = 0.0;
+  SpherePoint prev(points[0]);
+  for (size_t i = 1; i < count; ++i)
+  {
+    SpherePoint const curr(points[i]);
+    length += ::DistanceOnEarth(prev, curr);
+    prev = curr;
+  }
+  return length;
+}
+
 double MercatorBounds::AreaOnEarth(m2::PointD const & p1, m2::PointD const & p2, m2::PointD const & p3)
 {
   return ms::AreaOnEarth(ToLatLon(p1), ToLatLon(p2), ToLatLon(p3));
 }
+
+DistanceOnEarthFrom::DistanceOnEarthFrom(m2::PointD const & origin)
+{
+  SpherePoint const p(origin);
+  m_lat = p.m_lat;
+  m_lon = p.m_lon;
+  m_cosLat = p.m_cosLat;
+}
+
+double DistanceOnEarthFrom::operator()(m2::PointD const & pt) const
+{
+  SpherePoint const p(pt);
+  return ::DistanceOnEarth(m_lat, m_lon, m_cosLat, p.m_lat, p.m_lon, p.m_cosLat);
+}
+
+void DistanceOnEarthFrom::operator()(m2::PointD const * points, size_t count,
+                                     double * distances) const
+{
+  for (size_t i = 0; i < count; ++i)
+    distances[i] = (*this)(points[i]);
+}
@@ -6,6 +6,7 @@
 // I sugest considering moving this compiation unit to another place. Probably to geometry.
 
 #pragma once
+#include "geometry/distance_on_sphere.hpp"
 #include "geometry/latlon.hpp"
 #include "geometry/point2d.hpp"
 #include "geometry/rect2d.hpp"
@@ -125,9 +126,55 @@ struct MercatorBounds
                      FromLatLon(latLonRect.maxY(), latLonRect.maxX()));
   }
 
+  /// @name Array versions of the conversions, results are exactly the same as the point ones.
+  //@{
+  static void ToLatLon(m2::PointD const * points, size_t count, ms::LatLon * result);
+  static void FromLatLon(ms::LatLon const * points, size_t count, m2::PointD * result);
+  //@}
+
   /// Calculates distance on Earth by two points in mercator
   static double DistanceOnEarth(m2::PointD const & p1, m2::PointD const & p2);
 
+  /// Calculates distances on Earth between the consecutive points of the polyline, each point
+  /// is converted once. distances[i] is the same as DistanceOnEarth(points[i], points[i + 1]).
+  /// @param distances has count - 1 elements.
+  static void SegmentsOnEarth(m2::PointD const * points, size_t count, double * distances);
+
+  /// Calculates length of the polyline on Earth, it's the sum of SegmentsOnEarth from the first one.
+  static double LengthOnEarth(m2::PointD const * points, size_t count);
+
+  /// Calculates distance on Earth by the planar approximation, which needs no trigonometry
+  /// but one cosh: mercator distance is scaled by the cosine of the middle latitude.
+  /// Relative error is less than 1e-5 for the distances up to 10 km below 80 degrees
+  /// of latitude, so it's for the thresholds and the estimates of short distances, but not
+  /// for the weights of routes, they must be consistent with DistanceOnEarth.
+  inline static double ShortDistanceOnEarth(m2::PointD const & p1, m2::PointD const & p2)
+  {
+    // cos(lat) == 1 / cosh(y) in radians for the mercator projection.
+    return ms::EarthRadiusMeters() * my::DegToRad(p1.Length(p2)) /
+           cosh(my::DegToRad(0.5 * (p1.y + p2.y)));
+  }
+
   /// Calculates area of a triangle on Earth in m² by three points
   static double AreaOnEarth(m2::PointD const & p1, m2::PointD const & p2, m2::PointD const & p3);
 };
+
+/// Calculates distances on Earth from a fixed origin, the origin is converted once, so it's
+/// cheaper than DistanceOnEarth() when many points are measured against the same one,
+/// e.g. by the heuristics of A* or by the outgoing edges of a junction.
+/// The results are exactly the same as MercatorBounds::DistanceOnEarth(origin, pt).
+class DistanceOnEarthFrom
+{
+public:
+  explicit DistanceOnEarthFrom(m2::PointD const & origin);
+
+  double operator()(m2::PointD const & pt) const;
+
+  /// distances[i] is the distance to points[i].
+  void operator()(m2::PointD const * points, size_t count, double * distances) const;
+
+private:
+  double m_lat;
+  double m_lon;
+  double m_cosLat;
+};
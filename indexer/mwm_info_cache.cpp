@@ -0,0 +1,160 @@
+#include "indexer/mwm_info_cache.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "defines.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+
+namespace
+{
+uint8_t const kCacheVersion = 1;
+
+void WriteDouble(Writer & writer, double d)
+{
+  writer.Write(&d, sizeof(d));
+}
+
+template <class TSource>
+double ReadDouble(TSource & src)
+{
+  double d;
+  src.Read(&d, sizeof(d));
+  return d;
+}
+}  // namespace
+
+MwmInfoCache::Entry::Entry() : m_minScale(0), m_maxScale(0) {}
+
+MwmInfoCache::MwmInfoCache(string const & path)
+  : m_path(path), m_isChanged(false), m_hitsCount(0), m_missesCount(0)
+{
+  Load();
+}
+
+// static
+string MwmInfoCache::GetKey(platform::LocalCountryFile const & localFile)
+{
+  uint32_t const size = localFile.GetSize(MapOptions::Map);
+  if (size == 0)
+    return string();
+  return localFile.GetPath(MapOptions::Map) + ':' + strings::to_string(size);
+}
+
+bool MwmInfoCache::Find(platform::LocalCountryFile const & localFile, Entry & entry)
+{
+  string const key = GetKey(localFile);
+  lock_guard<mutex> lock(m_mutex);
+
+  auto const it = key.empty() ? m_entries.end() : m_entries.find(key);
+  if (it == m_entries.end())
+  {
+    ++m_missesCount;
+    return false;
+  }
+
+  ++m_hitsCount;
+  m_used.insert(key);
+  entry = it->second;
+  return true;
+}
+
+void MwmInfoCache::Add(platform::LocalCountryFile const & localFile, Entry const & entry)
+{
+  string const key = GetKey(localFile);
+  if (key.empty())
+    return;
+
+  lock_guard<mutex> lock(m_mutex);
+  m_entries[key] = entry;
+  m_used.insert(key);
+  m_isChanged = true;
+}
+
+void MwmInfoCache::Load()
+{
+  try
+  {
+    FileReader reader(m_path);
+    ReaderSource<FileReader> src(reader);
+    if (ReadPrimitiveFromSource<uint8_t>(src) != kCacheVersion)
+      return;
+
+    uint32_t const count = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      string key;
+      rw::Read(src, key);
+
+      Entry entry;
+      double const minX = ReadDouble(src);
+      double const minY = ReadDouble(src);
+      double const maxX = ReadDouble(src);
+      double const maxY = ReadDouble(src);
+      entry.m_limitRect = m2::RectD(minX, minY, maxX, maxY);
+      entry.m_minScale = ReadPrimitiveFromSource<uint8_t>(src);
+      entry.m_maxScale = ReadPrimitiveFromSource<uint8_t>(src);
+      entry.m_version.format = static_cast<version::Format>(ReadVarInt<int32_t>(src));
+      entry.m_version.timestamp = ReadVarUint<uint32_t>(src);
+      m_entries[key] = entry;
+    }
+  }
+  catch (Reader::Exception const & ex)
+  {
+    LOG(LDEBUG, ("Mwm info cache isn't loaded:", ex.Msg()));
+    m_entries.clear();
+  }
+}
+
+void MwmInfoCache::Save()
+{
+  lock_guard<mutex> lock(m_mutex);
+  if (!m_isChanged && m_used.size() == m_entries.size())
+    return;
+
+  map<string, Entry> used;
+  for (string const & key : m_used)
+    used[key] = m_entries[key];
+  m_entries.swap(used);
+
+  string const tmpPath = m_path + EXTENSION_TMP;
+  try
+  {
+    FileWriter writer(tmpPath);
+    WriteToSink(writer, kCacheVersion);
+    WriteVarUint(writer, static_cast<uint32_t>(m_entries.size()));
+    for (auto const & p : m_entries)
+    {
+      Entry const & entry = p.second;
+      rw::Write(writer, p.first);
+      WriteDouble(writer, entry.m_limitRect.minX());
+      WriteDouble(writer, entry.m_limitRect.minY());
+      WriteDouble(writer, entry.m_limitRect.maxX());
+      WriteDouble(writer, entry.m_limitRect.maxY());
+      WriteToSink(writer, entry.m_minScale);
+      WriteToSink(writer, entry.m_maxScale);
+      WriteVarInt(writer, static_cast<int32_t>(entry.m_version.format));
+      WriteVarUint(writer, entry.m_version.timestamp);
+    }
+  }
+  catch (Writer::Exception const & ex)
+  {
+    LOG(LWARNING, ("Can't write mwm info cache", tmpPath, ex.Msg()));
+    (void)my::DeleteFileX(tmpPath);
+    return;
+  }
+
+  if (!my::RenameFileX(tmpPath, m_path))
+  {
+    (void)my::DeleteFileX(tmpPath);
+    return;
+  }
+  m_isChanged = false;
+}
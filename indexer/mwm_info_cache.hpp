@@ -0,0 +1,56 @@
+#pragma once
+
+#include "platform/local_country_file.hpp"
+#include "platform/mwm_version.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include "std/map.hpp"
+#include "std/mutex.hpp"
+#include "std/set.hpp"
+#include "std/string.hpp"
+
+/// Persistent cache of the mwm data, which is needed to register the mwm: limit rect,
+/// scale range and version. Registration of the cached mwm doesn't open the file, so
+/// the startup with lots of maps isn't slowed down by reading their headers.
+/// An entry is found by the file path and size, the replaced file isn't found.
+class MwmInfoCache
+{
+public:
+  struct Entry
+  {
+    Entry();
+
+    m2::RectD m_limitRect;
+    uint8_t m_minScale;
+    uint8_t m_maxScale;
+    version::MwmVersion m_version;
+  };
+
+  /// Loads the cache from the file, the cache is empty when it can't be loaded.
+  explicit MwmInfoCache(string const & path);
+
+  bool Find(platform::LocalCountryFile const & localFile, Entry & entry);
+  void Add(platform::LocalCountryFile const & localFile, Entry const & entry);
+
+  /// Writes the cache when it's changed. Entries which were neither found nor added
+  /// since the loading are dropped, so the cache doesn't grow with the removed maps.
+  void Save();
+
+  size_t GetHitsCount() const { return m_hitsCount; }
+  size_t GetMissesCount() const { return m_missesCount; }
+
+private:
+  /// Returns the empty key for the files which aren't synced with disk.
+  static string GetKey(platform::LocalCountryFile const & localFile);
+
+  void Load();
+
+  string const m_path;
+  map<string, Entry> m_entries;
+  set<string> m_used;
+  bool m_isChanged;
+  size_t m_hitsCount;
+  size_t m_missesCount;
+  mutex m_mutex;
+};
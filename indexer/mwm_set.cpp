@@ -9,6 +9,7 @@
 #include "base/stl_add.hpp"
 
 #include "std/algorithm.hpp"
+#include "std/chrono.hpp"
 #include "std/sstream.hpp"
 
 
@@ -27,6 +28,27 @@ MwmInfo::MwmTypeT MwmInfo::GetType() const
   return COASTS;
 }
 
+void MwmSet::ProfiledMutex::lock()
+{
+  ++m_acquisitions;
+  if (m_mutex.try_lock())
+    return;
+
+  auto const start = steady_clock::now();
+  m_mutex.lock();
+  ++m_contentions;
+  m_waitTimeNs += duration_cast<nanoseconds>(steady_clock::now() - start).count();
+}
+
+MwmSet::LockStats MwmSet::ProfiledMutex::GetStats() const
+{
+  LockStats stats;
+  stats.m_acquisitions = m_acquisitions;
+  stats.m_contentions = m_contentions;
+  stats.m_waitTimeNs = m_waitTimeNs;
+  return stats;
+}
+
 string DebugPrint(MwmSet::MwmId const & id)
 {
   ostringstream ss;
@@ -86,27 +108,71 @@ MwmSet::MwmId MwmSet::GetMwmIdByCountryFileImpl(CountryFile const & countryFile)
 
 pair<MwmSet::MwmId, MwmSet::RegResult> MwmSet::Register(LocalCountryFile const & localFile)
 {
-  lock_guard<mutex> lock(m_lock);
-
   CountryFile const & countryFile = localFile.GetCountryFile();
-  MwmId const id = GetMwmIdByCountryFileImpl(countryFile);
-  if (!id.IsAlive())
-    return RegisterImpl(localFile);
+  {
+    lock_guard<ProfiledMutex> lock(m_lock);
+    MwmId const id = GetMwmIdByCountryFileImpl(countryFile);
+    if (id.IsAlive() && id.GetInfo()->GetVersion() >= localFile.GetVersion())
+      return RegisterRegisteredImpl(id, localFile);
+  }
 
-  shared_ptr<MwmInfo> info = id.GetInfo();
+  // The file is opened without the registry lock, so the readers of the registered
+  // mwms don't wait for it. This function can throw an exception for a bad mwm file.
+  shared_ptr<MwmInfo> info(CreateInfo(localFile));
+  if (!info)
+    return make_pair(MwmId(), RegResult::UnsupportedFileFormat);
 
-  // Deregister old mwm for the country.
-  if (info->GetVersion() < localFile.GetVersion())
+  pair<MwmId, RegResult> result;
+  vector<unique_ptr<MwmValueBase>> values;
+  vector<LocalCountryFile> deregistered;
   {
-    DeregisterImpl(id);
-    return RegisterImpl(localFile);
+    lock_guard<ProfiledMutex> lock(m_lock);
+    MwmId const id = GetMwmIdByCountryFileImpl(countryFile);
+    if (id.IsAlive() && id.GetInfo()->GetVersion() >= localFile.GetVersion())
+    {
+      // The same or a newer version is registered by another thread meanwhile.
+      result = RegisterRegisteredImpl(id, localFile);
+    }
+    else
+    {
+      result = RegisterImpl(info, localFile);
+      if (id.IsAlive())
+      {
+        // The old mwm is replaced, it lives while its handles are held.
+        DeregisterImpl(id);
+        ExtractFromCache(id, values);
+      }
+    }
+    TakeDeregistered(deregistered);
   }
 
-  string const name = countryFile.GetNameWithoutExt();
+  NotifyDeregistered(deregistered);
+  return result;
+}
+
+pair<MwmSet::MwmId, MwmSet::RegResult> MwmSet::RegisterImpl(shared_ptr<MwmInfo> const & info,
+                                                            LocalCountryFile const & localFile)
+{
+  info->m_file = localFile;
+  info->SetStatus(MwmInfo::STATUS_REGISTERED);
+  m_info[localFile.GetCountryName()].push_back(info);
+  ++m_epoch;
+
+  return make_pair(MwmId(info), RegResult::Success);
+}
+
+pair<MwmSet::MwmId, MwmSet::RegResult> MwmSet::RegisterRegisteredImpl(
+    MwmId const & id, LocalCountryFile const & localFile)
+{
+  shared_ptr<MwmInfo> const & info = id.GetInfo();
+  string const & name = localFile.GetCountryName();
+
   // Update the status of the mwm with the same version.
   if (info->GetVersion() == localFile.GetVersion())
   {
     LOG(LINFO, ("Updating already registered mwm:", name));
+    if (!info->IsRegistered())
+      ++m_epoch;
     info->SetStatus(MwmInfo::STATUS_REGISTERED);
     info->m_file = localFile;
     return make_pair(id, RegResult::VersionAlreadyExists);
@@ -117,32 +183,20 @@ pair<MwmSet::MwmId, MwmSet::RegResult> MwmSet::Register(LocalCountryFile const &
   return make_pair(MwmId(), RegResult::VersionTooOld);
 }
 
-pair<MwmSet::MwmId, MwmSet::RegResult> MwmSet::RegisterImpl(LocalCountryFile const & localFile)
-{
-  // This function can throw an exception for a bad mwm file.
-  shared_ptr<MwmInfo> info(CreateInfo(localFile));
-  if (!info)
-    return make_pair(MwmId(), RegResult::UnsupportedFileFormat);
-
-  info->m_file = localFile;
-  info->SetStatus(MwmInfo::STATUS_REGISTERED);
-  m_info[localFile.GetCountryName()].push_back(info);
-
-  return make_pair(MwmId(info), RegResult::Success);
-}
-
 bool MwmSet::DeregisterImpl(MwmId const & id)
 {
   if (!id.IsAlive())
     return false;
 
   shared_ptr<MwmInfo> const & info = id.GetInfo();
+  if (info->IsRegistered())
+    ++m_epoch;
   if (info->m_numRefs == 0)
   {
     info->SetStatus(MwmInfo::STATUS_DEREGISTERED);
     vector<shared_ptr<MwmInfo>> & infos = m_info[info->GetCountryName()];
     infos.erase(remove(infos.begin(), infos.end(), info), infos.end());
-    OnMwmDeregistered(info->GetLocalFile());
+    m_deregistered.push_back(info->GetLocalFile());
     return true;
   }
 
@@ -152,8 +206,15 @@ bool MwmSet::DeregisterImpl(MwmId const & id)
 
 bool MwmSet::Deregister(CountryFile const & countryFile)
 {
-  lock_guard<mutex> lock(m_lock);
-  return DeregisterImpl(countryFile);
+  bool deregistered;
+  vector<LocalCountryFile> files;
+  {
+    lock_guard<ProfiledMutex> lock(m_lock);
+    deregistered = DeregisterImpl(countryFile);
+    TakeDeregistered(files);
+  }
+  NotifyDeregistered(files);
+  return deregistered;
 }
 
 bool MwmSet::DeregisterImpl(CountryFile const & countryFile)
@@ -168,7 +229,7 @@ bool MwmSet::DeregisterImpl(CountryFile const & countryFile)
 
 bool MwmSet::IsLoaded(CountryFile const & countryFile) const
 {
-  lock_guard<mutex> lock(m_lock);
+  lock_guard<ProfiledMutex> lock(m_lock);
 
   MwmId const id = GetMwmIdByCountryFileImpl(countryFile);
   return id.IsAlive() && id.GetInfo()->IsRegistered();
@@ -176,7 +237,7 @@ bool MwmSet::IsLoaded(CountryFile const & countryFile) const
 
 void MwmSet::GetMwmsInfo(vector<shared_ptr<MwmInfo>> & info) const
 {
-  lock_guard<mutex> lock(m_lock);
+  lock_guard<ProfiledMutex> lock(m_lock);
   info.clear();
   info.reserve(m_info.size());
   for (auto const & p : m_info)
@@ -188,8 +249,22 @@ void MwmSet::GetMwmsInfo(vector<shared_ptr<MwmInfo>> & info) const
 
 unique_ptr<MwmSet::MwmValueBase> MwmSet::LockValue(MwmId const & id)
 {
-  lock_guard<mutex> lock(m_lock);
-  return LockValueImpl(id);
+  {
+    lock_guard<ProfiledMutex> lock(m_lock);
+    if (!id.IsAlive())
+      return nullptr;
+
+    // It's better to return valid "value pointer" even for "out-of-date" files,
+    // because they can be locked for a long time by other algos.
+    ++id.GetInfo()->m_numRefs;
+  }
+
+  // The mwm can't be deregistered while it's referenced, so the value
+  // can be taken from the cache or created without the registry lock.
+  unique_ptr<MwmValueBase> value = TakeFromCache(id);
+  if (value)
+    return value;
+  return CreateValueForLockedMwm(id);
 }
 
 unique_ptr<MwmSet::MwmValueBase> MwmSet::LockValueImpl(MwmId const & id)
@@ -197,23 +272,11 @@ unique_ptr<MwmSet::MwmValueBase> MwmSet::LockValueImpl(MwmId const & id)
   CHECK(id.IsAlive(), (id));
   shared_ptr<MwmInfo> info = id.GetInfo();
 
-  // It's better to return valid "value pointer" even for "out-of-date" files,
-  // because they can be locked for a long time by other algos.
-  //if (!info->IsUpToDate())
-  //  return TMwmValueBasePtr();
-
   ++info->m_numRefs;
 
-  // Search in cache.
-  for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
-  {
-    if (it->first == id)
-    {
-      unique_ptr<MwmValueBase> result = move(it->second);
-      m_cache.erase(it);
-      return result;
-    }
-  }
+  unique_ptr<MwmValueBase> value = TakeFromCache(id);
+  if (value)
+    return value;
 
   try
   {
@@ -229,17 +292,51 @@ unique_ptr<MwmSet::MwmValueBase> MwmSet::LockValueImpl(MwmId const & id)
   }
 }
 
+unique_ptr<MwmSet::MwmValueBase> MwmSet::CreateValueForLockedMwm(MwmId const & id)
+{
+  shared_ptr<MwmInfo> const & info = id.GetInfo();
+  try
+  {
+    return CreateValue(*info);
+  }
+  catch (exception const & ex)
+  {
+    LOG(LERROR, ("Can't create MWMValue for", info->GetCountryName(), "Reason", ex.what()));
+
+    vector<LocalCountryFile> files;
+    {
+      lock_guard<ProfiledMutex> lock(m_lock);
+      --info->m_numRefs;
+      DeregisterImpl(id);
+      TakeDeregistered(files);
+    }
+    NotifyDeregistered(files);
+    return nullptr;
+  }
+}
+
 void MwmSet::UnlockValue(MwmId const & id, unique_ptr<MwmValueBase> && p)
 {
-  lock_guard<mutex> lock(m_lock);
-  UnlockValueImpl(id, move(p));
+  bool cacheValue;
+  vector<LocalCountryFile> files;
+  {
+    lock_guard<ProfiledMutex> lock(m_lock);
+    cacheValue = UnlockValueImpl(id);
+    TakeDeregistered(files);
+  }
+  NotifyDeregistered(files);
+
+  // Both caching and destruction of the value are done without the
+  // registry lock.
+  if (cacheValue)
+    PutToCache(id, move(p));
 }
 
-void MwmSet::UnlockValueImpl(MwmId const & id, unique_ptr<MwmValueBase> && p)
+bool MwmSet::UnlockValueImpl(MwmId const & id)
 {
-  ASSERT(id.IsAlive() && p, (id));
-  if (!id.IsAlive() || !p)
-    return;
+  ASSERT(id.IsAlive(), (id));
+  if (!id.IsAlive())
+    return false;
 
   shared_ptr<MwmInfo> const & info = id.GetInfo();
   ASSERT_GREATER(info->m_numRefs, 0, ());
@@ -247,71 +344,148 @@ void MwmSet::UnlockValueImpl(MwmId const & id, unique_ptr<MwmValueBase> && p)
   if (info->m_numRefs == 0 && info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
     VERIFY(DeregisterImpl(id), ());
 
-  if (info->IsUpToDate())
+  return info->IsUpToDate();
+}
+
+unique_ptr<MwmSet::MwmValueBase> MwmSet::TakeFromCache(MwmId const & id)
+{
+  lock_guard<ProfiledMutex> lock(m_cacheLock);
+
+  auto const it = m_cacheIndex.find(id.GetInfo().get());
+  if (it == m_cacheIndex.end())
+    return nullptr;
+
+  // Take the most recently used value of the mwm.
+  auto & entries = it->second;
+  ASSERT(!entries.empty(), ());
+  TCacheList::iterator const entry = entries.back();
+  entries.pop_back();
+  if (entries.empty())
+    m_cacheIndex.erase(it);
+
+  unique_ptr<MwmValueBase> result = move(entry->second);
+  m_cache.erase(entry);
+  return result;
+}
+
+void MwmSet::PutToCache(MwmId const & id, unique_ptr<MwmValueBase> && p)
+{
+  unique_ptr<MwmValueBase> evicted;
   {
-    /// @todo Probably, it's better to store only "unique by id" free caches here.
-    /// But it's no obvious if we have many threads working with the single mwm.
+    lock_guard<ProfiledMutex> lock(m_cacheLock);
 
-    m_cache.push_back(make_pair(id, move(p)));
-    if (m_cache.size() > m_cacheSize)
+    // Status must be checked under the cache lock, because the mwm
+    // could be deregistered (and its values removed from the cache)
+    // after the reference was released.
+    if (!id.GetInfo()->IsUpToDate())
+    {
+      evicted = move(p);
+    }
+    else
     {
-      ASSERT_EQUAL(m_cache.size(), m_cacheSize + 1, ());
-      m_cache.pop_front();
+      /// @todo Probably, it's better to store only "unique by id" free caches here.
+      /// But it's no obvious if we have many threads working with the single mwm.
+      m_cache.emplace_front(id, move(p));
+      m_cacheIndex[id.GetInfo().get()].push_back(m_cache.begin());
+
+      if (m_cache.size() > m_cacheSize)
+      {
+        ASSERT_EQUAL(m_cache.size(), m_cacheSize + 1, ());
+
+        // The least recently used value is the oldest value of its mwm.
+        TCacheList::iterator const last = prev(m_cache.end());
+        auto const it = m_cacheIndex.find(last->first.GetInfo().get());
+        ASSERT(it != m_cacheIndex.end() && it->second.front() == last, ());
+        it->second.pop_front();
+        if (it->second.empty())
+          m_cacheIndex.erase(it);
+
+        evicted = move(last->second);
+        m_cache.erase(last);
+      }
     }
   }
 }
 
+void MwmSet::ExtractFromCache(MwmId const & id, vector<unique_ptr<MwmValueBase>> & values)
+{
+  lock_guard<ProfiledMutex> lock(m_cacheLock);
+
+  if (!id.GetInfo())
+  {
+    for (auto & entry : m_cache)
+      values.push_back(move(entry.second));
+    m_cache.clear();
+    m_cacheIndex.clear();
+    return;
+  }
+
+  auto const it = m_cacheIndex.find(id.GetInfo().get());
+  if (it == m_cacheIndex.end())
+    return;
+  for (TCacheList::iterator const entry : it->second)
+  {
+    values.push_back(move(entry->second));
+    m_cache.erase(entry);
+  }
+  m_cacheIndex.erase(it);
+}
+
 void MwmSet::Clear()
 {
-  lock_guard<mutex> lock(m_lock);
-  ClearCacheImpl(m_cache.begin(), m_cache.end());
+  vector<unique_ptr<MwmValueBase>> values;
+  lock_guard<ProfiledMutex> lock(m_lock);
+  ExtractFromCache(MwmId(), values);
   m_info.clear();
 }
 
 void MwmSet::ClearCache()
 {
-  lock_guard<mutex> lock(m_lock);
-  ClearCacheImpl(m_cache.begin(), m_cache.end());
+  vector<unique_ptr<MwmValueBase>> values;
+  ExtractFromCache(MwmId(), values);
 }
 
 MwmSet::MwmId MwmSet::GetMwmIdByCountryFile(CountryFile const & countryFile) const
 {
-  lock_guard<mutex> lock(m_lock);
+  lock_guard<ProfiledMutex> lock(m_lock);
   return GetMwmIdByCountryFileImpl(countryFile);
 }
 
 MwmSet::MwmHandle MwmSet::GetMwmHandleByCountryFile(CountryFile const & countryFile)
 {
-  lock_guard<mutex> lock(m_lock);
-  return GetMwmHandleByIdImpl(GetMwmIdByCountryFileImpl(countryFile));
+  return GetMwmHandleById(GetMwmIdByCountryFile(countryFile));
 }
 
 MwmSet::MwmHandle MwmSet::GetMwmHandleById(MwmId const & id)
 {
-  lock_guard<mutex> lock(m_lock);
-  return GetMwmHandleByIdImpl(id);
+  return MwmHandle(*this, id, LockValue(id));
 }
 
-MwmSet::MwmHandle MwmSet::GetMwmHandleByIdImpl(MwmId const & id)
+void MwmSet::ClearCache(MwmId const & id)
 {
-  unique_ptr<MwmValueBase> value;
-  if (id.IsAlive())
-    value = LockValueImpl(id);
-  return MwmHandle(*this, id, move(value));
+  vector<unique_ptr<MwmValueBase>> values;
+  ExtractFromCache(id, values);
 }
 
-void MwmSet::ClearCacheImpl(CacheType::iterator beg, CacheType::iterator end)
+void MwmSet::TakeDeregistered(vector<LocalCountryFile> & files)
 {
-  m_cache.erase(beg, end);
+  if (!m_deregistered.empty())
+    files.swap(m_deregistered);
 }
 
-void MwmSet::ClearCache(MwmId const & id)
+void MwmSet::NotifyDeregistered(vector<LocalCountryFile> const & files)
 {
-  auto sameId = [&id](pair<MwmSet::MwmId, unique_ptr<MwmSet::MwmValueBase>> const & p)
-  {
-    return (p.first == id);
-  };
-  ClearCacheImpl(RemoveIfKeepValid(m_cache.begin(), m_cache.end(), sameId), m_cache.end());
+  for (LocalCountryFile const & file : files)
+    OnMwmDeregistered(file);
+}
+
+string DebugPrint(MwmSet::LockStats const & stats)
+{
+  ostringstream ss;
+  ss << "LockStats [ acquisitions: " << stats.m_acquisitions
+     << ", contentions: " << stats.m_contentions
+     << ", wait time: " << stats.m_waitTimeNs / 1000000.0 << " ms ]";
+  return ss.str();
 }
 
 string DebugPrint(MwmSet::RegResult result)
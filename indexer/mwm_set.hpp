@@ -8,12 +8,15 @@
 
 #include "base/macros.hpp"
 
+#include "std/atomic.hpp"
 #include "std/deque.hpp"
+#include "std/list.hpp"
 #include "std/map.hpp"
 #include "std/mutex.hpp"
 #include "std/shared_ptr.hpp"
 #include "std/string.hpp"
 #include "std/unique_ptr.hpp"
+#include "std/unordered_map.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
 
@@ -65,14 +68,14 @@ public:
   MwmTypeT GetType() const;
 
   /// Returns the lock counter value for test needs.
-  uint8_t GetNumRefs() const { return m_numRefs; }
+  uint32_t GetNumRefs() const { return m_numRefs; }
 
 private:
   inline void SetStatus(Status status) { m_status = status; }
 
   platform::LocalCountryFile m_file;  ///< Path to the mwm file.
-  Status m_status;                    ///< Current country status.
-  uint8_t m_numRefs;                  ///< Number of active handles.
+  atomic<Status> m_status;            ///< Current country status.
+  atomic<uint32_t> m_numRefs;         ///< Number of active handles.
 };
 
 class MwmSet
@@ -104,7 +107,17 @@ public:
   };
 
 public:
-  explicit MwmSet(size_t cacheSize = 5) : m_cacheSize(cacheSize) {}
+  /// Acquisition statistics of the MwmSet locks, for profiling purposes.
+  struct LockStats
+  {
+    LockStats() : m_acquisitions(0), m_contentions(0), m_waitTimeNs(0) {}
+
+    uint64_t m_acquisitions;  ///< Total number of lock acquisitions.
+    uint64_t m_contentions;   ///< Number of acquisitions which had to wait.
+    uint64_t m_waitTimeNs;    ///< Total time spent in waiting, in nanoseconds.
+  };
+
+  explicit MwmSet(size_t cacheSize = 5) : m_cacheSize(cacheSize), m_epoch(0) {}
   virtual ~MwmSet() = default;
 
   class MwmValueBase
@@ -163,8 +176,21 @@ public:
   /// registered file) or when all registered corresponding mwm files
   /// are older than the localFile (in this case mwm handle will point
   /// to just-registered file).
+  ///
+  /// A newer version replaces the registered one at once: the new file is opened
+  /// without the registry lock, the new requests get the new mwm, and the readers
+  /// which hold the handles of the old one keep using it. The old mwm is deregistered
+  /// when its last handle is released, only its own cached values are dropped.
 protected:
-  pair<MwmId, RegResult> RegisterImpl(platform::LocalCountryFile const & localFile);
+  /// Adds the info which is created by CreateInfo() to the registry.
+  /// @precondition This function is always called under mutex m_lock.
+  pair<MwmId, RegResult> RegisterImpl(shared_ptr<MwmInfo> const & info,
+                                      platform::LocalCountryFile const & localFile);
+
+  /// Registers the same or an older version of the registered mwm.
+  /// @precondition This function is always called under mutex m_lock.
+  pair<MwmId, RegResult> RegisterRegisteredImpl(MwmId const & id,
+                                                platform::LocalCountryFile const & localFile);
 
 public:
   pair<MwmId, RegResult> Register(platform::LocalCountryFile const & localFile);
@@ -187,6 +213,11 @@ public:
   bool Deregister(platform::CountryFile const & countryFile);
   //@}
 
+  /// Returns the number of the changes of the registered mwms: registrations, updates and
+  /// deregistrations. Caches which depend on the set of the mwms compare it with the epoch
+  /// they were filled at, instead of being cleared by the callbacks of the changes.
+  uint64_t GetEpoch() const { return m_epoch; }
+
   /// Returns true when country is registered and can be used.
   bool IsLoaded(platform::CountryFile const & countryFile) const;
 
@@ -213,29 +244,76 @@ public:
     return const_cast<MwmSet *>(this)->GetMwmHandleById(id);
   }
 
+  /// @name Lock statistics.
+  //@{
+  /// Returns statistics of the mwm registry lock.
+  LockStats GetRegistryLockStats() const { return m_lock.GetStats(); }
+  /// Returns statistics of the free values cache lock.
+  LockStats GetCacheLockStats() const { return m_cacheLock.GetStats(); }
+  //@}
+
 protected:
   /// @return True when file format version was successfully read to MwmInfo.
   virtual unique_ptr<MwmInfo> CreateInfo(platform::LocalCountryFile const & localFile) const = 0;
   virtual unique_ptr<MwmValueBase> CreateValue(MwmInfo & info) const = 0;
 
-private:
-  typedef deque<pair<MwmId, unique_ptr<MwmValueBase>>> CacheType;
+  /// Mutex which collects contention statistics. Uncontended
+  /// acquisitions cost one try_lock() and one atomic increment.
+  class ProfiledMutex
+  {
+  public:
+    ProfiledMutex() : m_acquisitions(0), m_contentions(0), m_waitTimeNs(0) {}
 
-  /// @precondition This function is always called under mutex m_lock.
-  MwmHandle GetMwmHandleByIdImpl(MwmId const & id);
+    void lock();
+    void unlock() { m_mutex.unlock(); }
+
+    LockStats GetStats() const;
+
+  private:
+    mutex m_mutex;
+    atomic<uint64_t> m_acquisitions;
+    atomic<uint64_t> m_contentions;
+    atomic<uint64_t> m_waitTimeNs;
+
+    DISALLOW_COPY_AND_MOVE(ProfiledMutex);
+  };
+
+private:
+  using TCacheEntry = pair<MwmId, unique_ptr<MwmValueBase>>;
+  using TCacheList = list<TCacheEntry>;
 
   unique_ptr<MwmValueBase> LockValue(MwmId const & id);
   unique_ptr<MwmValueBase> LockValueImpl(MwmId const & id);
   void UnlockValue(MwmId const & id, unique_ptr<MwmValueBase> && p);
-  void UnlockValueImpl(MwmId const & id, unique_ptr<MwmValueBase> && p);
 
-  /// Do the cleaning for [beg, end) without acquiring the mutex.
+  /// Decrements number of references to the mwm.
+  /// @return True if the value can be returned into the cache.
   /// @precondition This function is always called under mutex m_lock.
-  void ClearCacheImpl(CacheType::iterator beg, CacheType::iterator end);
+  bool UnlockValueImpl(MwmId const & id);
+
+  /// Creates a value for an already locked mwm. Must be called
+  /// without m_lock, as value creation involves file operations.
+  unique_ptr<MwmValueBase> CreateValueForLockedMwm(MwmId const & id);
+
+  /// @name Free values cache.
+  /// The cache is a LRU list of free values (the most recently used
+  /// are at the front) with an index by mwm, so lookup, insertion and
+  /// eviction are O(1). Values are destroyed outside of the cache lock.
+  //@{
+  unique_ptr<MwmValueBase> TakeFromCache(MwmId const & id);
+  void PutToCache(MwmId const & id, unique_ptr<MwmValueBase> && p);
+  /// Moves out all cached values (of all mwms when id is not valid).
+  void ExtractFromCache(MwmId const & id, vector<unique_ptr<MwmValueBase>> & values);
+  //@}
 
-  CacheType m_cache;
+  TCacheList m_cache;
+  unordered_map<MwmInfo const *, deque<TCacheList::iterator>> m_cacheIndex;
   size_t const m_cacheSize;
 
+  /// Guards m_cache and m_cacheIndex. When both locks are needed,
+  /// m_lock is always acquired first.
+  mutable ProfiledMutex m_cacheLock;
+
 protected:
   /// @precondition This function is always called under mutex m_lock.
   void ClearCache(MwmId const & id);
@@ -250,13 +328,31 @@ protected:
     return MwmHandle(*this, id, LockValueImpl(id));
   }
 
-  // This method is called under m_lock when mwm is removed from a
-  // registry.
+  // This method is called when mwm is removed from a registry, without
+  // m_lock, so it may use the MwmSet.
   virtual void OnMwmDeregistered(platform::LocalCountryFile const & localFile) {}
 
+  /// @name Deregistration notifications.
+  /// Mwms are removed under m_lock, their files are collected and
+  /// OnMwmDeregistered() is called for them after m_lock is released.
+  //@{
+  /// @precondition This function is always called under mutex m_lock.
+  void TakeDeregistered(vector<platform::LocalCountryFile> & files);
+  void NotifyDeregistered(vector<platform::LocalCountryFile> const & files);
+  //@}
+
   map<string, vector<shared_ptr<MwmInfo>>> m_info;
 
-  mutable mutex m_lock;
+  /// Files of the removed mwms which aren't notified yet.
+  vector<platform::LocalCountryFile> m_deregistered;
+
+  atomic<uint64_t> m_epoch;
+
+  /// Guards the registry: m_info, statuses of mwms and number of
+  /// references to mwms.
+  mutable ProfiledMutex m_lock;
 };
 
+string DebugPrint(MwmSet::LockStats const & stats);
+
 string DebugPrint(MwmSet::RegResult result);
@@ -37,6 +37,7 @@ namespace old_101 { namespace feature
     virtual uint32_t ParseGeometry(int scale);
     virtual uint32_t ParseTriangles(int scale);
     virtual void ParseMetadata() {} /// not supported in this version
+    virtual bool ParseMetadataField(::feature::Metadata::EType, string &) { return false; }
 
   };
 }
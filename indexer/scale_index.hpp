@@ -69,6 +69,17 @@ public:
     }
   }
 
+  /// Unlike ForEachInIntervalAndScale, calls f for the features of the only bucket.
+  template <typename F>
+  void ForEachInIntervalAndBucket(F const & f, uint64_t beg, uint64_t end, uint32_t bucket) const
+  {
+    if (bucket < m_IndexForScale.size())
+    {
+      IntervalIndexIFace::FunctionT f1(cref(f));
+      m_IndexForScale[bucket]->DoForEach(f1, beg, end);
+    }
+  }
+
 private:
   vector<IntervalIndexIFace *> m_IndexForScale;
 };
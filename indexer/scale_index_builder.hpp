@@ -10,6 +10,7 @@
 
 #include "coding/dd_vector.hpp"
 #include "coding/file_sort.hpp"
+#include "coding/read_write_utils.hpp"
 #include "coding/var_serial_vector.hpp"
 #include "coding/writer.hpp"
 
@@ -17,8 +18,15 @@
 #include "base/logging.hpp"
 #include "base/macros.hpp"
 #include "base/scope_guard.hpp"
+#include "base/string_utils.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+#include "std/exception.hpp"
+#include "std/functional.hpp"
+#include "std/mutex.hpp"
 #include "std/string.hpp"
+#include "std/thread.hpp"
 #include "std/type_traits.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
@@ -192,13 +200,133 @@ private:
   SinkT & m_Sink;
 };
 
+/// Passes the cells of a worker thread to the shared sorter by batches, so the threads seldom
+/// wait for each other.
+template <class TSorter>
+class SorterBatch
+{
+public:
+  SorterBatch(TSorter & sorter, mutex & sorterMutex) : m_sorter(sorter), m_sorterMutex(sorterMutex)
+  {
+    m_batch.reserve(kBatchSize);
+  }
+
+  void Add(CellFeatureBucketTuple const & tuple)
+  {
+    m_batch.push_back(tuple);
+    if (m_batch.size() == kBatchSize)
+      Flush();
+  }
+
+  void Flush()
+  {
+    lock_guard<mutex> lock(m_sorterMutex);
+    for (CellFeatureBucketTuple const & tuple : m_batch)
+      m_sorter.Add(tuple);
+    m_batch.clear();
+  }
+
+private:
+  static size_t constexpr kBatchSize = 64 * 1024;
+
+  TSorter & m_sorter;
+  mutex & m_sorterMutex;
+  vector<CellFeatureBucketTuple> m_batch;
+};
+
+/// Runs fn(i) for i in [0, threadsCount) on threadsCount threads and rethrows the first exception.
+template <class TFn>
+void RunOnThreads(size_t threadsCount, TFn && fn)
+{
+  vector<exception_ptr> exceptions(threadsCount);
+  vector<thread> threads;
+  for (size_t i = 0; i < threadsCount; ++i)
+  {
+    threads.emplace_back([&fn, &exceptions, i]()
+    {
+      try
+      {
+        fn(i);
+      }
+      catch (...)
+      {
+        exceptions[i] = current_exception();
+      }
+    });
+  }
+  for (thread & t : threads)
+    t.join();
+  for (exception_ptr const & e : exceptions)
+  {
+    if (e)
+      rethrow_exception(e);
+  }
+}
+
+/// Covers the features by threadsCount threads, every thread covers every threadsCount-th block
+/// of the features. The sorter orders the cells completely, so it gets the same cells in any order.
+/// @note features.ForEach() is called by all the threads at once, the readers of the features
+///       must be thread-safe.
+template <class TFeaturesVector, class TSorter>
+void CoverFeatures(feature::DataHeader const & header, TFeaturesVector const & features,
+                   TSorter & sorter, size_t threadsCount, vector<uint32_t> & featuresInBucket,
+                   vector<uint32_t> & cellsInBucket)
+{
+  if (threadsCount <= 1)
+  {
+    features.ForEach(FeatureCoverer<TSorter>(header, sorter, featuresInBucket, cellsInBucket));
+    return;
+  }
+
+  // Number of features in a block.
+  size_t const kBlockSize = 1024;
+
+  using TBatch = SorterBatch<TSorter>;
+  mutex sorterMutex;
+  vector<vector<uint32_t>> features2(threadsCount);
+  vector<vector<uint32_t>> cells2(threadsCount);
+  RunOnThreads(threadsCount, [&](size_t index)
+  {
+    TBatch batch(sorter, sorterMutex);
+    FeatureCoverer<TBatch> coverer(header, batch, features2[index], cells2[index]);
+    size_t count = 0;
+    features.ForEach([&](FeatureType const & ft, uint32_t id)
+    {
+      if ((count++ / kBlockSize) % threadsCount == index)
+        coverer(ft, id);
+    });
+    batch.Flush();
+  });
+
+  for (size_t i = 0; i < threadsCount; ++i)
+  {
+    for (size_t bucket = 0; bucket < featuresInBucket.size(); ++bucket)
+    {
+      featuresInBucket[bucket] += features2[i][bucket];
+      cellsInBucket[bucket] += cells2[i][bucket];
+    }
+  }
+}
+
+template <class TWriter>
+void BuildBucketIndex(string const & cellsToFeatureFile, TWriter & writer)
+{
+  FileReader reader(cellsToFeatureFile);
+  DDVector<CellFeaturePair, FileReader, uint64_t> cellsToFeatures(reader);
+  BuildIntervalIndex(cellsToFeatures.begin(), cellsToFeatures.end(), writer,
+                     RectId::DEPTH_LEVELS * 2 + 1);
+}
+
+/// @param threadsCount Number of threads to cover the features, to sort the cells and to build
+///                     the interval indices of the buckets. The index doesn't depend on it.
 template <class TFeaturesVector, class TWriter>
 void IndexScales(feature::DataHeader const & header, TFeaturesVector const & features,
-                 TWriter & writer, string const & tmpFilePrefix)
+                 TWriter & writer, string const & tmpFilePrefix, size_t threadsCount = 1)
 {
   // TODO: Make scale bucketing dynamic.
 
   uint32_t const bucketsCount = header.GetLastScale() + 1;
+  threadsCount = max(threadsCount, size_t(1));
 
   string const cellsToFeatureAllBucketsFile =
       tmpFilePrefix + CELL2FEATURE_SORTED_EXT + ".allbuckets";
@@ -209,10 +337,11 @@ void IndexScales(feature::DataHeader const & header, TFeaturesVector const & fea
 
     using TSorter = FileSorter<CellFeatureBucketTuple, WriterFunctor<FileWriter>>;
     WriterFunctor<FileWriter> out(cellsToFeaturesAllBucketsWriter);
-    TSorter sorter(1024 * 1024 /* bufferBytes */, tmpFilePrefix + CELL2FEATURE_TMP_EXT, out);
+    TSorter sorter(1024 * 1024 /* bufferBytes */, tmpFilePrefix + CELL2FEATURE_TMP_EXT, out,
+                   less<CellFeatureBucketTuple>(), threadsCount);
     vector<uint32_t> featuresInBucket(bucketsCount);
     vector<uint32_t> cellsInBucket(bucketsCount);
-    features.ForEach(FeatureCoverer<TSorter>(header, sorter, featuresInBucket, cellsInBucket));
+    CoverFeatures(header, features, sorter, threadsCount, featuresInBucket, cellsInBucket);
     sorter.SortAndFinish();
 
     for (uint32_t bucket = 0; bucket < bucketsCount; ++bucket)
@@ -232,12 +361,53 @@ void IndexScales(feature::DataHeader const & header, TFeaturesVector const & fea
   VarSerialVectorWriter<TWriter> recordWriter(writer, bucketsCount);
   auto it = cellsToFeaturesAllBuckets.begin();
 
-  for (uint32_t bucket = 0; bucket < bucketsCount; ++bucket)
+  if (threadsCount == 1)
+  {
+    for (uint32_t bucket = 0; bucket < bucketsCount; ++bucket)
+    {
+      string const cellsToFeatureFile = tmpFilePrefix + CELL2FEATURE_SORTED_EXT;
+      MY_SCOPE_GUARD(cellsToFeatureFileGuard, bind(&FileWriter::DeleteFileX, cellsToFeatureFile));
+      {
+        FileWriter cellsToFeaturesWriter(cellsToFeatureFile);
+        WriterFunctor<FileWriter> out(cellsToFeaturesWriter);
+        while (it < cellsToFeaturesAllBuckets.end() && it->GetBucket() == bucket)
+        {
+          out(it->GetCellFeaturePair());
+          ++it;
+        }
+      }
+
+      {
+        SubWriter<TWriter> subWriter(writer);
+        LOG(LINFO, ("Building interval index for bucket:", bucket));
+        BuildBucketIndex(cellsToFeatureFile, subWriter);
+      }
+      recordWriter.FinishRecord();
+    }
+  }
+  else
   {
-    string const cellsToFeatureFile = tmpFilePrefix + CELL2FEATURE_SORTED_EXT;
-    MY_SCOPE_GUARD(cellsToFeatureFileGuard, bind(&FileWriter::DeleteFileX, cellsToFeatureFile));
+    // Cells of the buckets and interval indices of the buckets go to their own files, so
+    // the indices are built at once and are copied to the writer in the order of the buckets.
+    // Interval index offsets are relative to its start, so the copies are the same as the
+    // indices built in place.
+    vector<string> cellsFiles(bucketsCount);
+    vector<string> indexFiles(bucketsCount);
+    MY_SCOPE_GUARD(bucketFilesGuard, [&]()
     {
-      FileWriter cellsToFeaturesWriter(cellsToFeatureFile);
+      for (uint32_t bucket = 0; bucket < bucketsCount; ++bucket)
+      {
+        FileWriter::DeleteFileX(cellsFiles[bucket]);
+        FileWriter::DeleteFileX(indexFiles[bucket]);
+      }
+    });
+    for (uint32_t bucket = 0; bucket < bucketsCount; ++bucket)
+    {
+      string const suffix = "." + strings::to_string(bucket);
+      cellsFiles[bucket] = tmpFilePrefix + CELL2FEATURE_SORTED_EXT + suffix;
+      indexFiles[bucket] = tmpFilePrefix + CELL2FEATURE_SORTED_EXT + ".index" + suffix;
+
+      FileWriter cellsToFeaturesWriter(cellsFiles[bucket]);
       WriterFunctor<FileWriter> out(cellsToFeaturesWriter);
       while (it < cellsToFeaturesAllBuckets.end() && it->GetBucket() == bucket)
       {
@@ -246,15 +416,24 @@ void IndexScales(feature::DataHeader const & header, TFeaturesVector const & fea
       }
     }
 
+    atomic<uint32_t> next(0);
+    RunOnThreads(min(threadsCount, static_cast<size_t>(bucketsCount)), [&](size_t /* index */)
+    {
+      for (uint32_t bucket = next++; bucket < bucketsCount; bucket = next++)
+      {
+        LOG(LINFO, ("Building interval index for bucket:", bucket));
+        FileWriter indexWriter(indexFiles[bucket]);
+        BuildBucketIndex(cellsFiles[bucket], indexWriter);
+      }
+    });
+
+    for (uint32_t bucket = 0; bucket < bucketsCount; ++bucket)
     {
-      FileReader reader(cellsToFeatureFile);
-      DDVector<CellFeaturePair, FileReader, uint64_t> cellsToFeatures(reader);
-      SubWriter<TWriter> subWriter(writer);
-      LOG(LINFO, ("Building interval index for bucket:", bucket));
-      BuildIntervalIndex(cellsToFeatures.begin(), cellsToFeatures.end(), subWriter,
-                         RectId::DEPTH_LEVELS * 2 + 1);
+      FileReader indexReader(indexFiles[bucket]);
+      ReaderSource<FileReader> src(indexReader);
+      rw::ReadAndWrite(src, writer, 64 * 1024);
+      recordWriter.FinishRecord();
     }
-    recordWriter.FinishRecord();
   }
 
   // todo(@pimenov). There was an old todo here that said there were
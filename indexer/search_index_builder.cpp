@@ -3,8 +3,10 @@
 #include "indexer/categories_holder.hpp"
 #include "indexer/classificator.hpp"
 #include "indexer/feature_algo.hpp"
+#include "indexer/feature_covering.hpp"
 #include "indexer/feature_utils.hpp"
 #include "indexer/feature_visibility.hpp"
+#include "indexer/features_offsets_table.hpp"
 #include "indexer/features_vector.hpp"
 #include "indexer/search_delimiters.hpp"
 #include "indexer/search_string_utils.hpp"
@@ -18,21 +20,31 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/byte_stream.hpp"
 #include "coding/reader_writer_ops.hpp"
 #include "coding/trie_builder.hpp"
 #include "coding/writer.hpp"
 
 #include "base/assert.hpp"
 #include "base/logging.hpp"
+#include "base/macros.hpp"
 #include "base/scope_guard.hpp"
 #include "base/stl_add.hpp"
 #include "base/string_utils.hpp"
 #include "base/timer.hpp"
 
 #include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+#include "std/bind.hpp"
+#include "std/condition_variable.hpp"
+#include "std/deque.hpp"
+#include "std/exception.hpp"
 #include "std/fstream.hpp"
 #include "std/initializer_list.hpp"
 #include "std/limits.hpp"
+#include "std/mutex.hpp"
+#include "std/thread.hpp"
+#include "std/unique_ptr.hpp"
 #include "std/unordered_map.hpp"
 #include "std/vector.hpp"
 
@@ -159,7 +171,20 @@ struct ValueBuilder<SerializedFeatureInfoValue>
   using TSaver = trie::ValueReader;
   TSaver m_valueSaver;
 
-  ValueBuilder(serial::CodingParams const & cp) : m_valueSaver(cp) {}
+  /// Cells masks of the features by their indices, they are not made when it's nullptr.
+  /// Features are processed concurrently, but each one writes its own element only.
+  vector<trie::TCellsMask> * m_cellsMasks;
+  trie::CellsGrid m_grid;
+  int m_codingDepth;
+
+  ValueBuilder(serial::CodingParams const & cp, feature::DataHeader const & header,
+               vector<trie::TCellsMask> * cellsMasks)
+    : m_valueSaver(cp)
+    , m_cellsMasks(cellsMasks)
+    , m_grid(header.GetBounds())
+    , m_codingDepth(covering::GetCodingDepth(header.GetLastScale()))
+  {
+  }
 
   void MakeValue(FeatureType const & ft, feature::TypesHolder const & types, uint32_t index,
                  SerializedFeatureInfoValue & value) const
@@ -174,7 +199,53 @@ struct ValueBuilder<SerializedFeatureInfoValue>
     // write to buffer
     PushBackByteSink<SerializedFeatureInfoValue::ValueT> sink(value.m_value);
     m_valueSaver.Save(sink, v);
+
+    if (m_cellsMasks)
+    {
+      // Cells are the same as the ones of the scale index, see ScaleIndexBuilder.
+      vector<int64_t> const cells = covering::CoverFeature(ft, m_codingDepth, 250);
+      ASSERT_LESS(index, m_cellsMasks->size(), ());
+      (*m_cellsMasks)[index] = m_grid.GetMask(covering::GetCellsRect(cells, m_codingDepth));
+    }
+  }
+};
+
+/// Makes the cells masks of the subtrees of the search index from the masks of their features.
+class CellsMaskEdgeBuilder
+{
+public:
+  CellsMaskEdgeBuilder() : m_cp(nullptr), m_cellsMasks(nullptr), m_mask(0) {}
+
+  CellsMaskEdgeBuilder(serial::CodingParams const & cp,
+                       vector<trie::TCellsMask> const & cellsMasks)
+    : m_cp(&cp), m_cellsMasks(&cellsMasks), m_mask(0)
+  {
+  }
+
+  void AddValue(void const * p, uint32_t size)
+  {
+    ArrayByteSource src(p);
+    trie::ValueReader::ValueType value;
+    trie::ValueReader const reader(*m_cp);
+    reader(src, value);
+    ASSERT_EQUAL(src.PtrUC(), static_cast<uint8_t const *>(p) + size, ());
+    UNUSED_VALUE(size);
+    ASSERT_LESS(value.m_featureId, m_cellsMasks->size(), ());
+    m_mask |= (*m_cellsMasks)[value.m_featureId];
   }
+
+  void AddEdge(CellsMaskEdgeBuilder & edgeBuilder) { m_mask |= edgeBuilder.m_mask; }
+
+  template <typename TSink>
+  void StoreValue(TSink & sink) const
+  {
+    WriteToSink(sink, m_mask);
+  }
+
+private:
+  serial::CodingParams const * m_cp;
+  vector<trie::TCellsMask> const * m_cellsMasks;
+  trie::TCellsMask m_mask;
 };
 
 template <>
@@ -367,48 +438,235 @@ public:
   }
 };
 
-void AddFeatureNameIndexPairs(FilesContainerR const & container,
-                              CategoriesHolder & categoriesHolder,
-                              StringsFile<FeatureIndexValue> & stringsFile)
+/// Collects the strings of a block of features on a worker thread of FeatureStringsPipeline.
+template <typename TValue>
+struct StringsBlock
+{
+  using ValueT = TValue;
+  using TString = typename StringsFile<TValue>::TString;
+
+  void AddString(TString const & s) { m_strings.push_back(s); }
+
+  typename StringsFile<TValue>::StringsListT m_strings;
+};
+
+/// Makes the strings of the features on several threads. Every thread reads its own copy of
+/// the container and indexes every threadsCount-th block of features. Blocks are added to
+/// the strings file in the order of the features, so the file gets exactly the same strings
+/// as with a single thread.
+template <typename TValue>
+class FeatureStringsPipeline
+{
+public:
+  using TStringsList = typename StringsFile<TValue>::StringsListT;
+
+  FeatureStringsPipeline(string const & fileName, size_t threadsCount, SynonymsHolder * synonyms,
+                         CategoriesHolder const & catHolder,
+                         ValueBuilder<TValue> const & valueBuilder)
+    : m_fileName(fileName)
+    , m_synonyms(synonyms)
+    , m_catHolder(catHolder)
+    , m_valueBuilder(valueBuilder)
+    , m_cancelled(false)
+  {
+    ASSERT_GREATER(threadsCount, 0, ());
+    for (size_t i = 0; i < threadsCount; ++i)
+      m_workers.emplace_back(new Worker());
+  }
+
+  void Run(StringsFile<TValue> & names)
+  {
+    for (size_t i = 0; i < m_workers.size(); ++i)
+      m_workers[i]->m_thread = thread(&FeatureStringsPipeline::Work, this, i);
+
+    MY_SCOPE_GUARD(stopGuard, bind(&FeatureStringsPipeline::Stop, this));
+
+    TStringsList block;
+    for (size_t i = 0; Pop(*m_workers[i % m_workers.size()], block); ++i)
+    {
+      for (auto const & s : block)
+        names.AddString(s);
+    }
+
+    Stop();
+    for (auto const & worker : m_workers)
+    {
+      if (worker->m_exception)
+        rethrow_exception(worker->m_exception);
+    }
+  }
+
+private:
+  // Number of features in a block.
+  static size_t constexpr kBlockSize = 1024;
+  // Number of blocks a worker may make in advance.
+  static size_t constexpr kMaxReadyBlocks = 4;
+
+  struct Worker
+  {
+    mutex m_mutex;
+    condition_variable m_cv;
+    deque<TStringsList> m_blocks;
+    bool m_done = false;
+    exception_ptr m_exception;
+    thread m_thread;
+  };
+
+  void Work(size_t index)
+  {
+    Worker & worker = *m_workers[index];
+    size_t const workersCount = m_workers.size();
+    try
+    {
+      FeaturesVectorTest features(m_fileName);
+      StringsBlock<TValue> block;
+      FeatureInserter<StringsBlock<TValue>> inserter(m_synonyms, block, m_catHolder,
+                                                     features.GetHeader().GetScaleRange(),
+                                                     m_valueBuilder);
+      size_t count = 0;
+      features.GetVector().ForEach([&](FeatureType const & ft, uint32_t id)
+      {
+        size_t const blockIndex = count++ / kBlockSize;
+        if (blockIndex % workersCount != index || m_cancelled)
+          return;
+        inserter(ft, id);
+        if (count % kBlockSize == 0)
+          Push(worker, block.m_strings);
+      });
+
+      // The last block is incomplete.
+      if (count % kBlockSize != 0 && (count / kBlockSize) % workersCount == index)
+        Push(worker, block.m_strings);
+    }
+    catch (...)
+    {
+      worker.m_exception = current_exception();
+    }
+
+    lock_guard<mutex> lock(worker.m_mutex);
+    worker.m_done = true;
+    worker.m_cv.notify_all();
+  }
+
+  void Push(Worker & worker, TStringsList & strings)
+  {
+    unique_lock<mutex> lock(worker.m_mutex);
+    worker.m_cv.wait(lock, [&]() { return worker.m_blocks.size() < kMaxReadyBlocks || m_cancelled; });
+    worker.m_blocks.emplace_back();
+    worker.m_blocks.back().swap(strings);
+    worker.m_cv.notify_all();
+  }
+
+  /// @return False when the worker has no more blocks.
+  bool Pop(Worker & worker, TStringsList & strings)
+  {
+    unique_lock<mutex> lock(worker.m_mutex);
+    worker.m_cv.wait(lock, [&]() { return !worker.m_blocks.empty() || worker.m_done; });
+    if (worker.m_blocks.empty())
+      return false;
+    strings.swap(worker.m_blocks.front());
+    worker.m_blocks.pop_front();
+    worker.m_cv.notify_all();
+    return true;
+  }
+
+  void Stop()
+  {
+    m_cancelled = true;
+    for (auto const & worker : m_workers)
+    {
+      {
+        lock_guard<mutex> lock(worker->m_mutex);
+        worker->m_cv.notify_all();
+      }
+      if (worker->m_thread.joinable())
+        worker->m_thread.join();
+    }
+  }
+
+  string const m_fileName;
+  SynonymsHolder * m_synonyms;
+  CategoriesHolder const & m_catHolder;
+  ValueBuilder<TValue> const & m_valueBuilder;
+  atomic<bool> m_cancelled;
+  vector<unique_ptr<Worker>> m_workers;
+};
+
+/// Adds names and categories of the features to the strings file.
+/// @param threadsCount Number of threads to make the strings, the container is opened
+///                     by its file name on every thread when it's greater than one.
+template <typename TValue>
+void AddFeatureStrings(FilesContainerR const & container, CategoriesHolder const & catHolder,
+                       ValueBuilder<TValue> const & valueBuilder, size_t threadsCount,
+                       StringsFile<TValue> & names)
 {
   FeaturesVectorTest features(container);
   feature::DataHeader const & header = features.GetHeader();
 
-  ValueBuilder<FeatureIndexValue> valueBuilder;
-
   unique_ptr<SynonymsHolder> synonyms;
   if (header.GetType() == feature::DataHeader::world)
     synonyms.reset(new SynonymsHolder(GetPlatform().WritablePathForFile(SYNONYMS_FILE)));
 
-  features.GetVector().ForEach(FeatureInserter<StringsFile<FeatureIndexValue>>(
-      synonyms.get(), stringsFile, categoriesHolder, header.GetScaleRange(), valueBuilder));
+  if (threadsCount <= 1)
+  {
+    features.GetVector().ForEach(FeatureInserter<StringsFile<TValue>>(
+        synonyms.get(), names, catHolder, header.GetScaleRange(), valueBuilder));
+    return;
+  }
+
+  FeatureStringsPipeline<TValue> pipeline(container.GetFileName(), threadsCount, synonyms.get(),
+                                          catHolder, valueBuilder);
+  pipeline.Run(names);
+}
+
+void AddFeatureNameIndexPairs(FilesContainerR const & container,
+                              CategoriesHolder & categoriesHolder,
+                              StringsFile<FeatureIndexValue> & stringsFile)
+{
+  ValueBuilder<FeatureIndexValue> valueBuilder;
+  AddFeatureStrings(container, categoriesHolder, valueBuilder, 1 /* threadsCount */, stringsFile);
 }
 
 void BuildSearchIndex(FilesContainerR const & cont, CategoriesHolder const & catHolder,
-                      Writer & writer, string const & tmpFilePath)
+                      Writer & writer, string const & tmpFilePath, size_t threadsCount,
+                      uint64_t maxMemoryBytes, indexer::SearchIndexStats & stats)
 {
   {
-    FeaturesVectorTest features(cont);
-    feature::DataHeader const & header = features.GetHeader();
+    feature::DataHeader header;
+    header.Load(cont);
 
     serial::CodingParams cp(trie::GetCodingParams(header.GetDefCodingParams()));
-    ValueBuilder<SerializedFeatureInfoValue> valueBuilder(cp);
-
-    unique_ptr<SynonymsHolder> synonyms;
-    if (header.GetType() == feature::DataHeader::world)
-      synonyms.reset(new SynonymsHolder(GetPlatform().WritablePathForFile(SYNONYMS_FILE)));
 
-    StringsFile<SerializedFeatureInfoValue> names(tmpFilePath);
+    bool const hasCellsMasks = trie::EdgeValueReader::HasCellsMasks(header.GetFormat());
+    vector<trie::TCellsMask> cellsMasks;
+    if (hasCellsMasks)
+    {
+      FeaturesVectorTest features(cont);
+      CHECK(features.GetTable(), ("Cells masks need the features indices."));
+      cellsMasks.assign(features.GetTable()->size(), 0);
+    }
+    ValueBuilder<SerializedFeatureInfoValue> valueBuilder(cp, header,
+                                                          hasCellsMasks ? &cellsMasks : nullptr);
 
-    features.GetVector().ForEach(FeatureInserter<StringsFile<SerializedFeatureInfoValue>>(
-        synonyms.get(), names, catHolder, header.GetScaleRange(), valueBuilder));
+    StringsFile<SerializedFeatureInfoValue> names(tmpFilePath, threadsCount, maxMemoryBytes);
+    AddFeatureStrings(cont, catHolder, valueBuilder, threadsCount, names);
 
     names.EndAdding();
+    stats.m_pairsCount = names.GetStringsCount();
+    stats.m_groupsCount = names.GetGroupsCount();
     names.OpenForRead();
-    
-    trie::Build<Writer, typename StringsFile<SerializedFeatureInfoValue>::IteratorT,
-                trie::EmptyEdgeBuilder, ValueList<SerializedFeatureInfoValue>>(
-        writer, names.Begin(), names.End(), trie::EmptyEdgeBuilder());
+
+    using TIter = typename StringsFile<SerializedFeatureInfoValue>::IteratorT;
+    if (hasCellsMasks)
+    {
+      trie::Build<Writer, TIter, CellsMaskEdgeBuilder, ValueList<SerializedFeatureInfoValue>>(
+          writer, names.Begin(), names.End(), CellsMaskEdgeBuilder(cp, cellsMasks));
+    }
+    else
+    {
+      trie::Build<Writer, TIter, trie::EmptyEdgeBuilder, ValueList<SerializedFeatureInfoValue>>(
+          writer, names.Begin(), names.End(), trie::EmptyEdgeBuilder());
+    }
 
     // at this point all readers of StringsFile should be dead
   }
@@ -418,9 +676,13 @@ void BuildSearchIndex(FilesContainerR const & cont, CategoriesHolder const & cat
 }  // namespace
 
 namespace indexer {
-bool BuildSearchIndexFromDatFile(string const & datFile, bool forceRebuild)
+bool BuildSearchIndexFromDatFile(string const & datFile, bool forceRebuild, size_t threadsCount,
+                                 uint64_t maxMemoryBytes, SearchIndexStats * stats)
 {
   LOG(LINFO, ("Start building search index. Bits = ", search::kPointCodingBits));
+  my::Timer timer;
+  SearchIndexStats localStats;
+  SearchIndexStats & st = stats ? *stats : localStats;
 
   try
   {
@@ -438,9 +700,12 @@ bool BuildSearchIndexFromDatFile(string const & datFile, bool forceRebuild)
 
       CategoriesHolder catHolder(pl.GetReader(SEARCH_CATEGORIES_FILE_NAME));
 
-      BuildSearchIndex(readCont, catHolder, writer, tmpFile1);
+      BuildSearchIndex(readCont, catHolder, writer, tmpFile1, threadsCount, maxMemoryBytes, st);
 
-      LOG(LINFO, ("Search index size = ", writer.Size()));
+      double const seconds = timer.ElapsedSeconds();
+      LOG(LINFO, ("Search index size = ", writer.Size(), "pairs = ", st.m_pairsCount,
+                  "pairs per second = ", seconds > 0.0 ? st.m_pairsCount / seconds : 0.0,
+                  "sorted groups = ", st.m_groupsCount));
     }
 
     {
@@ -512,7 +777,8 @@ void BuildCompressedSearchIndex(FilesContainerR & container, Writer & indexWrite
   my::Timer timer;
 
   string stringsFilePath = platform.WritablePathForFile("strings.tmp");
-  StringsFile<FeatureIndexValue> stringsFile(stringsFilePath);
+  StringsFile<FeatureIndexValue> stringsFile(stringsFilePath, 1 /* threadsCount */,
+                                             kSearchIndexMaxMemoryBytes);
   MY_SCOPE_GUARD(stringsFileGuard, bind(&FileWriter::DeleteFileX, stringsFilePath));
 
   CategoriesHolder categoriesHolder(platform.GetReader(SEARCH_CATEGORIES_FILE_NAME));
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "std/cstdint.hpp"
 #include "std/string.hpp"
 
 class FilesContainerR;
@@ -7,7 +8,25 @@ class Writer;
 
 namespace indexer
 {
-bool BuildSearchIndexFromDatFile(string const & fName, bool forceRebuild = false);
+/// Default cap of the memory taken by the search tokens which are not spilled to disk yet.
+uint64_t constexpr kSearchIndexMaxMemoryBytes = 512 * 1024 * 1024;
+
+struct SearchIndexStats
+{
+  // Number of the (token, feature) pairs.
+  uint64_t m_pairsCount = 0;
+  // Number of the sorted groups of pairs spilled to disk and merged into the index.
+  uint64_t m_groupsCount = 0;
+};
+
+/// @param threadsCount Number of threads to make and sort the search tokens of the features.
+/// @param maxMemoryBytes Approximate cap of the memory taken by the tokens, they are sorted and
+///                       spilled to disk by groups, which are merged right into the index.
+/// @param stats Statistics of the building, it may be nullptr.
+bool BuildSearchIndexFromDatFile(string const & fName, bool forceRebuild = false,
+                                 size_t threadsCount = 1,
+                                 uint64_t maxMemoryBytes = kSearchIndexMaxMemoryBytes,
+                                 SearchIndexStats * stats = nullptr);
 
 bool AddCompresedSearchIndexSection(string const & fName, bool forceRebuild);
 
@@ -2,6 +2,171 @@
 
 #include "base/macros.hpp"
 
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+using namespace strings;
+
+namespace
+{
+/// Results of the normalization of the chars below kTableSize, which are the Latin, Greek,
+/// Cyrillic and Armenian ones. Each char is normalized independently from the others, so the
+/// fused case folding, decomposition and our hacks of such chars cost one lookup.
+class NormalizationTable
+{
+public:
+  static UniChar const kTableSize = 0x590;
+
+  NormalizationTable()
+  {
+    // Zero char is kept as is, the case folding doesn't accept it.
+    m_offsets[0] = 0;
+    m_chars.push_back(0);
+    for (UniChar c = 1; c < kTableSize; ++c)
+    {
+      m_offsets[c] = static_cast<uint16_t>(m_chars.size());
+      UniString s(1, c);
+      search::NormalizeAndSimplifyUniString(s);
+      m_chars.insert(m_chars.end(), s.begin(), s.end());
+    }
+    m_offsets[kTableSize] = static_cast<uint16_t>(m_chars.size());
+  }
+
+  inline void Append(UniChar c, UniString & result) const
+  {
+    ASSERT_LESS(c, kTableSize, ());
+    for (uint16_t i = m_offsets[c]; i < m_offsets[c + 1]; ++i)
+      result.push_back(m_chars[i]);
+  }
+
+private:
+  vector<UniChar> m_chars;
+  uint16_t m_offsets[kTableSize + 1];
+};
+
+// static
+UniChar const NormalizationTable::kTableSize;
+
+NormalizationTable const & GetNormalizationTable()
+{
+  static NormalizationTable const table;
+  return table;
+}
+}  // namespace
+
+void search::NormalizeAndSimplifyString(string const & s, UniString & result)
+{
+  result.clear();
+  result.reserve(s.size());
+
+  // ASCII chars are only lower cased.
+  if (IsASCIIString(s))
+  {
+    for (char const c : s)
+      result.push_back(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    return;
+  }
+
+  NormalizationTable const & table = GetNormalizationTable();
+  // Runs of the chars out of the table are normalized in place at the tail of the result.
+  size_t otherBegin = result.size();
+  auto const flushOther = [&]()
+  {
+    if (otherBegin == result.size())
+      return;
+    UniString other(result.begin() + otherBegin, result.end());
+    NormalizeAndSimplifyUniString(other);
+    result.resize(otherBegin);
+    result.append(other.begin(), other.end());
+  };
+
+  for (auto it = s.begin(); it != s.end();)
+  {
+    UniChar const c = utf8::unchecked::next(it);
+    if (c < NormalizationTable::kTableSize)
+    {
+      flushOther();
+      table.Append(c, result);
+      otherBegin = result.size();
+    }
+    else
+    {
+      result.push_back(c);
+    }
+  }
+  flushOther();
+}
+
+void search::NormalizeAndSimplifyUniString(UniString & uniString)
+{
+  for (size_t i = 0; i < uniString.size(); ++i)
+  {
+    UniChar & c = uniString[i];
+    switch (c)
+    {
+    // Replace "d with stroke" to simple d letter. Used in Vietnamese.
+    // (unicode-compliant implementation leaves it unchanged)
+    case 0x0110:
+    case 0x0111: c = 'd'; break;
+    // Replace small turkish dotless 'ı' with dotted 'i'.
+    // Our own invented hack to avoid well-known Turkish I-letter bug.
+    case 0x0131: c = 'i'; break;
+    // Replace capital turkish dotted 'İ' with dotted lowercased 'i'.
+    // Here we need to handle this case manually too, because default unicode-compliant implementation
+    // of MakeLowerCase converts 'İ' to 'i' + 0x0307.
+    case 0x0130: c = 'i'; break;
+    // Some Danish-specific hacks.
+    case 0x00d8:                    // Ø
+    case 0x00f8: c = 'o'; break;    // ø
+    case 0x0152:                    // Œ
+    case 0x0153:                    // œ
+      c = 'o';
+      uniString.insert(uniString.begin() + (i++) + 1, 'e');
+      break;
+    case 0x00c6:                    // Æ
+    case 0x00e6:                    // æ
+      c = 'a';
+      uniString.insert(uniString.begin() + (i++) + 1, 'e');
+      break;
+    }
+  }
+
+  MakeLowerCaseInplace(uniString);
+  NormalizeInplace(uniString);
+
+  // Remove accents that can appear after NFKD normalization.
+  uniString.erase_if([](UniChar const & c)
+  {
+    // ̀  COMBINING GRAVE ACCENT
+    // ́  COMBINING ACUTE ACCENT
+    return (c == 0x0300 || c == 0x0301);
+  });
+
+  /// @todo Restore this logic to distinguish и-й in future.
+  /*
+  // Just after lower casing is a correct place to avoid normalization for specific chars.
+  static auto const isSpecificChar = [](UniChar c) -> bool
+  {
+    return c == 0x0439; // й
+  };
+  UniString result;
+  result.reserve(uniString.size());
+  for (auto i = uniString.begin(), end = uniString.end(); i != end;)
+  {
+    auto j = find_if(i, end, isSpecificChar);
+    // We don't check if (j != i) because UniString and Normalize handle it correctly.
+    UniString normString(i, j);
+    NormalizeInplace(normString);
+    result.insert(result.end(), normString.begin(), normString.end());
+    if (j == end)
+      break;
+    result.push_back(*j);
+    i = j + 1;
+  }
+  uniString.swap(result);
+  */
+}
+
 strings::UniString search::FeatureTypeToString(uint32_t type)
 {
   string const s = "!type:" + strings::to_string(type);
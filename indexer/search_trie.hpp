@@ -2,10 +2,18 @@
 
 #include "indexer/geometry_serialization.hpp"
 
+#include "platform/mwm_version.hpp"
+
+#include "coding/mapped_section.hpp"
 #include "coding/reader.hpp"
+#include "coding/reader_wrapper.hpp"
 #include "coding/trie.hpp"
 #include "coding/trie_reader.hpp"
 
+#include "base/math.hpp"
+
+#include "std/cmath.hpp"
+
 
 namespace search
 {
@@ -48,7 +56,72 @@ public:
   }
 };
 
-using TEdgeValueReader = EmptyValueReader;
+/// Mask of the cells of CellsGrid, the bit of the cell (x, y) is y * kGridSize + x.
+using TCellsMask = uint16_t;
+static TCellsMask const kAllCells = 0xFFFF;
+
+/// Grid of kGridSize x kGridSize cells over the bounds of the mwm. The rects out of the
+/// bounds are clamped to the border cells.
+class CellsGrid
+{
+public:
+  static int const kGridSize = 4;
+
+  explicit CellsGrid(m2::RectD const & bounds) : m_bounds(bounds) {}
+
+  /// @return Mask of the cells which intersect the rect, including the touching ones.
+  TCellsMask GetMask(m2::RectD const & rect) const
+  {
+    if (!m_bounds.IsValid() || m_bounds.IsEmptyInterior() || !rect.IsValid())
+      return kAllCells;
+
+    int const minX = ToCell(rect.minX(), m_bounds.minX(), m_bounds.SizeX());
+    int const maxX = ToCell(rect.maxX(), m_bounds.minX(), m_bounds.SizeX());
+    int const minY = ToCell(rect.minY(), m_bounds.minY(), m_bounds.SizeY());
+    int const maxY = ToCell(rect.maxY(), m_bounds.minY(), m_bounds.SizeY());
+
+    TCellsMask mask = 0;
+    for (int y = minY; y <= maxY; ++y)
+    {
+      for (int x = minX; x <= maxX; ++x)
+        mask |= TCellsMask(1) << (y * kGridSize + x);
+    }
+    return mask;
+  }
+
+private:
+  static int ToCell(double v, double min, double size)
+  {
+    return my::clamp(static_cast<int>(floor((v - min) / size * kGridSize)), 0, kGridSize - 1);
+  }
+
+  m2::RectD m_bounds;
+};
+
+/// Search index keeps the cells mask of each subtree in the value of its edge since
+/// version::v7. The subtree has the features whose index cells intersect the cells of the mask,
+/// so the viewport search skips the subtrees out of the viewport. Edges of the old indices
+/// have the values of all the cells.
+class EdgeValueReader
+{
+public:
+  using ValueType = TCellsMask;
+
+  explicit EdgeValueReader(version::Format format) : m_hasCellsMasks(HasCellsMasks(format)) {}
+
+  static bool HasCellsMasks(version::Format format) { return format >= version::v7; }
+
+  template <typename TSource>
+  void operator()(TSource & src, ValueType & v) const
+  {
+    v = m_hasCellsMasks ? ReadPrimitiveFromSource<ValueType>(src) : kAllCells;
+  }
+
+private:
+  bool m_hasCellsMasks;
+};
+
+using TEdgeValueReader = EdgeValueReader;
 using DefaultIterator =
     trie::Iterator<trie::ValueReader::ValueType, trie::TEdgeValueReader::ValueType>;
 
@@ -58,4 +131,20 @@ inline serial::CodingParams GetCodingParams(serial::CodingParams const & orig)
                               PointU2PointD(orig.GetBasePoint(), orig.GetCoordBits()));
 }
 
+/// Reads the search trie from the mapped memory when the reader is memory mapped, then the nodes
+/// are parsed by MemReader which reads are inlined, instead of a virtual Reader::Read call
+/// for each byte of the varints. reader and cp must outlive the trie.
+inline DefaultIterator * ReadSearchTrie(ModelReaderPtr const & reader,
+                                        serial::CodingParams const & cp, version::Format format)
+{
+  uint8_t const * data = MappedSection::GetData(reader);
+  if (data)
+  {
+    return ReadTrie(MemReader(data, static_cast<size_t>(reader.Size())), ValueReader(cp),
+                    TEdgeValueReader(format));
+  }
+  return ReadTrie(SubReaderWrapper<Reader>(reader.GetPtr()), ValueReader(cp),
+                  TEdgeValueReader(format));
+}
+
 }  // namespace trie
@@ -6,12 +6,14 @@
 #include "base/macros.hpp"
 #include "base/mem_trie.hpp"
 #include "base/string_utils.hpp"
-#include "base/worker_thread.hpp"
+#include "base/work_stealing_pool.hpp"
 
 #include "coding/read_write_utils.hpp"
+#include "std/algorithm.hpp"
 #include "std/iterator_facade.hpp"
 #include "std/queue.hpp"
 #include "std/functional.hpp"
+#include "std/mutex.hpp"
 #include "std/unique_ptr.hpp"
 
 template <typename TValue>
@@ -81,6 +83,12 @@ public:
 
     inline size_t value_size() const { return m_val.size(); }
 
+    /// @return Approximate number of bytes the string takes in memory.
+    inline size_t GetMemorySize() const
+    {
+      return sizeof(TString) + m_name.size() * sizeof(strings::UniChar) + m_val.size();
+    }
+
     void Swap(TString & r)
     {
       m_name.swap(r.m_name);
@@ -105,10 +113,12 @@ public:
     ///                groups of sorted strings in a file.  When strings will be
     ///                sorted and dumped on a disk, a pair of offsets will be added
     ///                to the list.
+    /// \param writeMutex A mutex guarding writer and offsets, as several tasks may run at once.
     /// \param strings Vector of strings that should be sorted. Internal data is moved out from
     ///                strings, so it'll become empty after ctor.
-    SortAndDumpStringsTask(FileWriter & writer, OffsetsListT & offsets, StringsListT & strings)
-        : m_writer(writer), m_offsets(offsets)
+    SortAndDumpStringsTask(FileWriter & writer, OffsetsListT & offsets, mutex & writeMutex,
+                           StringsListT & strings)
+        : m_writer(writer), m_offsets(offsets), m_mutex(writeMutex)
     {
       strings.swap(m_strings);
     }
@@ -129,6 +139,7 @@ public:
                      });
       }
 
+      lock_guard<mutex> lock(m_mutex);
       uint64_t const spos = m_writer.Pos();
       m_writer.Write(memBuffer.data(), memBuffer.size());
       uint64_t const epos = m_writer.Pos();
@@ -139,6 +150,7 @@ public:
   private:
     FileWriter & m_writer;
     OffsetsListT & m_offsets;
+    mutex & m_mutex;
     StringsListT m_strings;
 
     DISALLOW_COPY_AND_MOVE(SortAndDumpStringsTask);
@@ -165,7 +177,11 @@ public:
     void increment();
   };
 
-  StringsFile(string const & fPath);
+  /// \param threadsCount Number of threads to sort groups of strings.
+  /// \param maxMemoryBytes Approximate cap of the memory taken by the strings which are not
+  ///                       written yet. The strings are accumulated in groups, a group is sorted
+  ///                       and spilled to disk when its share of the cap is reached.
+  StringsFile(string const & fPath, size_t threadsCount, uint64_t maxMemoryBytes);
 
   void EndAdding();
   void OpenForRead();
@@ -176,6 +192,13 @@ public:
   IteratorT Begin() { return IteratorT(*this, false); }
   IteratorT End() { return IteratorT(*this, true); }
 
+  /// @return Number of the added strings.
+  uint64_t GetStringsCount() const { return m_stringsCount; }
+
+  /// @return Number of the sorted groups of strings on disk.
+  /// @precondition Should be called after EndAdding().
+  size_t GetGroupsCount() const { return m_offsets.size(); }
+
 private:
   unique_ptr<FileWriter> m_writer;
   unique_ptr<FileReader> m_reader;
@@ -186,11 +209,19 @@ private:
   StringsListT m_strings;
   OffsetsListT m_offsets;
 
-  // A worker thread that sorts and writes groups of strings.  The
+  // Cap and current size of m_strings in bytes.
+  uint64_t m_maxGroupBytes;
+  uint64_t m_groupBytes = 0;
+  uint64_t m_stringsCount = 0;
+
+  // Guards the writer and the offsets while groups are written.
+  mutex m_writeMutex;
+
+  // Worker threads that sort and write groups of strings.  The
   // whole process looks like a pipeline, i.e. main thread accumulates
-  // strings while worker thread sequentially sorts and stores groups
-  // of strings on a disk.
-  my::WorkerThread<SortAndDumpStringsTask> m_workerThread;
+  // strings while worker threads sort and store groups of strings on
+  // a disk.  Groups are written in any order, the merge doesn't depend on it.
+  threads::WorkStealingPool m_workerThreads;
 
   struct QValue
   {
@@ -208,12 +239,13 @@ private:
 template <typename ValueT>
 void StringsFile<ValueT>::AddString(TString const & s)
 {
-  size_t const kMaxSize = 1000000;
-
-  if (m_strings.size() >= kMaxSize)
+  size_t const size = s.GetMemorySize();
+  if (!m_strings.empty() && m_groupBytes + size > m_maxGroupBytes)
     Flush();
 
   m_strings.push_back(s);
+  m_groupBytes += size;
+  ++m_stringsCount;
 }
 
 template <typename ValueT>
@@ -242,9 +274,13 @@ void StringsFile<ValueT>::IteratorT::increment()
 }
 
 template <typename ValueT>
-StringsFile<ValueT>::StringsFile(string const & fPath)
-    : m_workerThread(1 /* maxTasks */)
+StringsFile<ValueT>::StringsFile(string const & fPath, size_t threadsCount, uint64_t maxMemoryBytes)
+    : m_workerThreads(max(threadsCount, static_cast<size_t>(1)),
+                      max(threadsCount, static_cast<size_t>(1)) + 1 /* maxPendingTasks */)
 {
+  // Besides the accumulated group, the pool keeps up to maxPendingTasks queued or running groups
+  // and one more group waits in the blocked Push().
+  m_maxGroupBytes = maxMemoryBytes / (max(threadsCount, static_cast<size_t>(1)) + 3);
   m_writer.reset(new FileWriter(fPath));
 }
 
@@ -252,8 +288,9 @@ template <typename ValueT>
 void StringsFile<ValueT>::Flush()
 {
   shared_ptr<SortAndDumpStringsTask> task(
-      new SortAndDumpStringsTask(*m_writer, m_offsets, m_strings));
-  m_workerThread.Push(task);
+      new SortAndDumpStringsTask(*m_writer, m_offsets, m_writeMutex, m_strings));
+  m_groupBytes = 0;
+  m_workerThreads.Push([task]() { (*task)(); });
 }
 
 template <typename ValueT>
@@ -284,7 +321,7 @@ void StringsFile<ValueT>::EndAdding()
 {
   Flush();
 
-  m_workerThread.RunUntilIdleAndStop();
+  m_workerThreads.WaitForDone();
 
   m_writer->Flush();
 }
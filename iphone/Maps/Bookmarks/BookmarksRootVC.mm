@@ -90,7 +90,7 @@
     bool visible = !cat->IsVisible();
     cell.imageView.image = [UIImage imageNamed:(visible ? @"eye" : @"empty")];
     cat->SetVisible(visible);
-    cat->SaveToKMLFile();
+    cat->SaveToFile();
   }
 }
 
@@ -160,7 +160,7 @@
         if (cat)
         {
           cat->SetName([txt UTF8String]);
-          cat->SaveToKMLFile();
+          cat->SaveToFile();
         }
       }
       [f removeFromSuperview];
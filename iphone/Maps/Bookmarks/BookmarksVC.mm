@@ -12,6 +12,7 @@
 #include "Framework.h"
 
 #include "platform/measurement_utils.hpp"
+#include "platform/platform.hpp"
 
 #include "geometry/distance_on_sphere.hpp"
 
@@ -78,7 +79,7 @@ extern NSString * const kBookmarksChangedNotification = @"BookmarksChangedNotifi
 {
   BookmarkCategory * cat = GetFramework().GetBmCategory(m_categoryIndex);
   cat->SetVisible(sender.on);
-  cat->SaveToKMLFile();
+  cat->SaveToFile();
 }
 
 - (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section
@@ -270,7 +271,12 @@ extern NSString * const kBookmarksChangedNotification = @"BookmarksChangedNotifi
       if (![catName length])
         [catName setString:@"MapsMe"];
 
-      NSString * filePath = @(cat->GetFileName().c_str());
+      // Categories are stored in the binary format, so KML is exported for sharing.
+      string const kmlPath = GetPlatform().TmpPathForFile(BookmarkCategory::RemoveInvalidSymbols(cat->GetName()) + BOOKMARKS_FILE_EXTENSION);
+      if (!cat->ExportToKMLFile(kmlPath))
+        return;
+
+      NSString * filePath = @(kmlPath.c_str());
       NSMutableString * kmzFile = [NSMutableString stringWithString:filePath];
       [kmzFile replaceCharactersInRange:NSMakeRange([filePath length] - 1, 1) withString:@"z"];
 
@@ -280,6 +286,7 @@ extern NSString * const kBookmarksChangedNotification = @"BookmarksChangedNotifi
         [self sendBookmarksWithExtension:@".kml" andType:@"application/vnd.google-earth.kml+xml" andFile:filePath andCategory:catName];
 
       (void)my::DeleteFileX([kmzFile UTF8String]);
+      (void)my::DeleteFileX(kmlPath);
     }
   }
 }
@@ -321,7 +328,7 @@ extern NSString * const kBookmarksChangedNotification = @"BookmarksChangedNotifi
                                                           userInfo:nil];
         }
       }
-      cat->SaveToKMLFile();
+      cat->SaveToFile();
       size_t previousNumberOfSections  = m_numberOfSections;
       [self calculateSections];
       //We can delete the row with animation, if number of sections stay the same.
@@ -399,7 +406,7 @@ extern NSString * const kBookmarksChangedNotification = @"BookmarksChangedNotifi
   if (cat->GetName() != newCharName)
   {
     cat->SetName(newCharName);
-    cat->SaveToKMLFile();
+    cat->SaveToFile();
     self.navigationController.title = newName;
   }
 }
@@ -39,7 +39,7 @@
   self.isVisible = !self.isVisible;
   BookmarkCategory * cat = GetFramework().GetBmCategory(self.index);
   cat->SetVisible(self.isVisible);
-  cat->SaveToKMLFile();
+  cat->SaveToFile();
 }
 
 - (IBAction)openBookmarks
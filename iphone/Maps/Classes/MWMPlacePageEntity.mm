@@ -328,24 +328,25 @@ using feature::Metadata;
   if (!category)
     return;
 
-  Bookmark * bookmark = category->GetBookmark(self.bac.second);
+  Bookmark const * bookmark = category->GetBookmark(self.bac.second);
   if (!bookmark)
     return;
-  
+
+  BookmarkData data = bookmark->GetData();
   if (self.bookmarkColor)
-    bookmark->SetType(self.bookmarkColor.UTF8String);
+    data.SetType(self.bookmarkColor.UTF8String);
 
   if (self.bookmarkDescription)
   {
     string const description(self.bookmarkDescription.UTF8String);
     _isHTMLDescription = strings::IsHTML(description);
-    bookmark->SetDescription(description);
+    data.SetDescription(description);
   }
 
   if (self.bookmarkTitle)
-    bookmark->SetName(self.bookmarkTitle.UTF8String);
+    data.SetName(self.bookmarkTitle.UTF8String);
 
-  category->SaveToKMLFile();
+  f.ReplaceBookmark(self.bac.first, self.bac.second, data);
 }
 
 #pragma mark - Open hours string formatter
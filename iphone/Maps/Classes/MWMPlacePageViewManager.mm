@@ -238,7 +238,7 @@ typedef NS_ENUM(NSUInteger, MWMPlacePageManagerState)
   if (bookmarkCategory)
   {
     bookmarkCategory->DeleteBookmark(bookmarkAndCategory.second);
-    bookmarkCategory->SaveToKMLFile();
+    bookmarkCategory->SaveToFile();
   }
   f.Invalidate();
   [NSNotificationCenter.defaultCenter postNotificationName:kBookmarksChangedNotification
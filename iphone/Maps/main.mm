@@ -8,7 +8,7 @@
 int main(int argc, char * argv[])
 {
 #ifdef MWM_LOG_TO_FILE
-  my::SetLogMessageFn(LogMessageFile);
+  my::SetLogMessageFn(LogMessageFileAsync);
 #endif
   LOG(LINFO, ("maps.me started, detected CPU cores:", GetPlatform().CpuCores()));
 
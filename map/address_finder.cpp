@@ -178,6 +178,29 @@ void Framework::GetFeatureTypes(m2::PointD const & pxPoint, vector<string> & typ
 
 namespace
 {
+  void GetReadableTypes(search::Engine const * eng, int8_t locale,
+                        feature::TypesHolder & types,
+                        search::AddressInfo & info)
+  {
+    types.SortBySpec();
+
+    // Try to add types from categories.
+    for (uint32_t t : types)
+    {
+      string s;
+      if (eng->GetNameByType(t, locale, s))
+        info.m_types.push_back(s);
+    }
+
+    // If nothing added - return raw classificator types.
+    if (info.m_types.empty())
+    {
+      Classificator const & c = classif();
+      for (uint32_t t : types)
+        info.m_types.push_back(c.GetReadableObjectName(t));
+    }
+  }
+
   class DoGetAddressBase : public DoGetFeatureInfoBase
   {
   public:
@@ -321,29 +344,6 @@ namespace
         return true;
     }
 
-    static void GetReadableTypes(search::Engine const * eng, int8_t locale,
-                                 feature::TypesHolder & types,
-                                 search::AddressInfo & info)
-    {
-      types.SortBySpec();
-
-      // Try to add types from categories.
-      for (uint32_t t : types)
-      {
-        string s;
-        if (eng->GetNameByType(t, locale, s))
-          info.m_types.push_back(s);
-      }
-
-      // If nothing added - return raw classificator types.
-      if (info.m_types.empty())
-      {
-        Classificator const & c = classif();
-        for (uint32_t t : types)
-          info.m_types.push_back(c.GetReadableObjectName(t));
-      }
-    }
-
   public:
     DoGetAddressInfo(m2::PointD const & pt, int scale, TypeChecker const & checker,
                      double const (&arrRadius) [3])
@@ -471,21 +471,17 @@ void Framework::GetAddressInfoForGlobalPoint(m2::PointD const & pt, search::Addr
     return;
   }
 
-  // use upper scale to get address by point (buildings, streets and POIs are visible).
-  int const scale = scales::GetUpperScale();
-
-  double const addressR[] = {
-    15.0,   // radius to search point POI's
-    100.0,  // radius to search street names
-    5.0     // radius to search building numbers (POI's)
-  };
-
-  // pass maximum value for all addressR
-  m2::RectD const rect = MercatorBounds::RectByCenterXYAndSizeInMeters(pt, addressR[1]);
-  DoGetAddressInfo getAddress(pt, scale, GetChecker(), addressR);
+  search::ReverseGeocoder::Address address;
+  m_reverseGeocoder.ReverseGeocode(pt, address);
 
-  m_model.ForEachFeature(rect, getAddress, scale);
-  getAddress.FillAddress(GetSearchEngine(), info);
+  info.m_street = address.m_street;
+  info.m_house = address.m_house;
+  info.m_name = address.m_name;
+  if (!address.m_types.Empty())
+  {
+    int8_t const locale = CategoriesHolder::MapLocaleToInteger(languages::GetCurrentOrig());
+    GetReadableTypes(GetSearchEngine(), locale, address.m_types, info);
+  }
 
   // @todo Temporarily commented - it's slow and not used in UI
   //GetLocality(pt, info);
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "search/query_trace.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include "std/map.hpp"
 #include "std/vector.hpp"
 #include "std/string.hpp"
 #include "std/utility.hpp"
@@ -28,19 +33,82 @@ namespace bench
     void CalcMetrics();
   };
 
+  /// Reading of the rects of a scale.
+  struct ScaleResult
+  {
+    double m_all = 0.0;
+    size_t m_rects = 0;
+    size_t m_features = 0;
+  };
+
   class AllResult
   {
   public:
     Result m_reading;
     double m_all;
+    map<int, ScaleResult> m_scales;
 
   public:
     AllResult() : m_all(0.0) {}
 
-    void Add(double t) { m_all += t; }
+    void Add(int scale, double t, size_t features)
+    {
+      m_all += t;
+      ScaleResult & r = m_scales[scale];
+      r.m_all += t;
+      ++r.m_rects;
+      r.m_features += features;
+    }
+    void Print();
+  };
+
+  /// Preparing of the drape tiles without GL, the stage times are summed over the tiles.
+  struct DrapeResult
+  {
+    /// Lookup of the feature ids in the spatial index.
+    double m_index = 0.0;
+    /// Decoding of the features except their styling.
+    double m_read = 0.0;
+    /// Styling of the features by the RuleDrawer, it includes the lazy geometry decoding.
+    double m_style = 0.0;
+    /// Preparing and serializing the shapes, the part of the batching which doesn't need GL.
+    double m_prepare = 0.0;
+    size_t m_features = 0;
+    size_t m_shapes = 0;
+    size_t m_shapesSize = 0;
+    /// Whole preparing times of the tiles.
+    Result m_tiles;
+  };
+
+  struct SearchResult
+  {
+    vector<search::QueryTrace> m_traces;
+
+    /// Prints the latencies percentiles, the average phases times and the slowest queries.
     void Print();
   };
 
   /// @param[in] count number of times to run benchmark
   void RunFeaturesLoadingBenchmark(string const & file, pair<int, int> scaleR, AllResult & res);
+
+  /// Renders the tiles of the "zoom x y" lines of tilesFile by the RasterTileRenderer.
+  /// @param[in] outputDir where the PNG tiles are written to, nothing is written when it's empty
+  /// @param[out] res rendering times of the tiles
+  void RunTilesRenderingBenchmark(string const & file, string const & tilesFile, size_t threadsCount,
+                                  string const & outputDir, Result & res);
+
+  /// Prepares the drape tiles of the "zoom x y" lines of tilesFile as the drape frontend reads them,
+  /// but the shapes are collected instead of being sent to the batchers. The lines are the same
+  /// as for RunTilesRenderingBenchmark, x and y go from the left top corner of the world.
+  void RunDrapePreparingBenchmark(string const & file, string const & tilesFile, DrapeResult & res);
+
+  /// Runs the benchmarks of the JSON scenario and makes their JSON report, see scenario.cpp.
+  /// @return false if the scenario can't be read
+  bool RunScenario(string const & scenarioFile, string & report);
+
+  /// Runs the "locale<tab>query" lines of queriesFile one by one in all the local maps.
+  /// @param[in] queriesFile the queries saved by search::QuerySaver are run when it's empty
+  /// @param[out] res traces of the finished queries
+  void RunSearchReplayBenchmark(string const & queriesFile, m2::RectD const & viewport,
+                                SearchResult & res);
 }
@@ -6,7 +6,12 @@ CONFIG -= app_bundle
 TEMPLATE = app
 
 ROOT_DIR = ../..
-DEPENDENCIES = map indexer platform geometry coding base gflags protobuf tomcrypt
+DEPENDENCIES = map render gui routing search storage graphics indexer platform anim geometry coding base \
+               gflags freetype fribidi expat protobuf tomcrypt jansson osrm stats_client minizip succinct
+
+drape {
+  DEPENDENCIES *= drape_frontend drape
+}
 
 include($$ROOT_DIR/common.pri)
 
@@ -16,8 +21,15 @@ QT *= core
 
 SOURCES += \
     features_loading.cpp \
+    tiles_rendering.cpp \
     main.cpp \
     api.cpp \
+    search_replay.cpp \
+    scenario.cpp \
+
+drape {
+  SOURCES += drape_preparing.cpp
+}
 
 HEADERS += \
     api.hpp \
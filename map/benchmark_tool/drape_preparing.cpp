@@ -0,0 +1,135 @@
+#include "map/benchmark_tool/api.hpp"
+
+#include "map/feature_vec_model.hpp"
+
+#include "drape_frontend/engine_context.hpp"
+#include "drape_frontend/map_shape.hpp"
+#include "drape_frontend/rule_drawer.hpp"
+#include "drape_frontend/stylist.hpp"
+#include "drape_frontend/tile_key.hpp"
+#include "drape_frontend/visual_params.hpp"
+
+#include "coding/file_name_utils.hpp"
+#include "coding/writer.hpp"
+
+#include "base/arena.hpp"
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include "std/bind.hpp"
+#include "std/fstream.hpp"
+#include "std/unique_ptr.hpp"
+
+
+namespace bench
+{
+
+namespace
+{
+  /// Keeps the shapes of the tile instead of posting them to the frontend.
+  class ShapesCollector : public df::EngineContext
+  {
+  public:
+    ShapesCollector() : df::EngineContext(dp::RefPointer<df::ThreadsCommutator>()) {}
+
+    virtual void InsertShape(df::TileKey const & key, dp::TransferPointer<df::MapShape> shape)
+    {
+      dp::MasterPointer<df::MapShape> master(shape);
+      m_shapes.emplace_back(master.Release());
+    }
+
+    vector<unique_ptr<df::MapShape>> m_shapes;
+  };
+
+  /// Drape tiles go from the center of the world up, the lines go from its left top corner
+  /// as the raster tiles do, so there is no drape tile of the zero zoom.
+  bool ReadTiles(string const & tilesFile, vector<df::TileKey> & tiles)
+  {
+    ifstream input(tilesFile);
+    if (!input)
+      return false;
+
+    int zoom, x, y;
+    while (input >> zoom >> x >> y)
+    {
+      if (zoom < 1)
+      {
+        LOG(LWARNING, ("Drape has no tile", zoom, x, y));
+        continue;
+      }
+      int const half = 1 << (zoom - 1);
+      tiles.emplace_back(x - half, half - y - 1, zoom);
+    }
+    return true;
+  }
+}
+
+void RunDrapePreparingBenchmark(string const & file, string const & tilesFile, DrapeResult & res)
+{
+  vector<df::TileKey> tiles;
+  if (!ReadTiles(tilesFile, tiles))
+  {
+    LOG(LERROR, ("Can't read tiles from", tilesFile));
+    return;
+  }
+
+  string fileName = file;
+  my::GetNameFromFullPath(fileName);
+  my::GetNameWithoutExt(fileName);
+
+  model::FeaturesFetcher src;
+  auto const r = src.RegisterMap(platform::LocalCountryFile::MakeForTesting(fileName));
+  if (r.second != MwmSet::RegResult::Success)
+    return;
+
+  df::VisualParams::Init(1.0, 256);
+
+  ShapesCollector context;
+  my::Arena arena;
+  string shapesData;
+  for (df::TileKey const & key : tiles)
+  {
+    my::Timer tileTimer;
+
+    my::Timer timer;
+    vector<FeatureID> ids;
+    auto addId = [&ids](FeatureID const & id) { ids.push_back(id); };
+    src.ForEachFeatureID(key.GetGlobalRect(), addId, key.m_zoomLevel);
+    res.m_index += timer.ElapsedSeconds();
+
+    {
+      df::RuleDrawer drawer(bind(&df::InitStylist, _1, key.m_zoomLevel, _2), key, context, arena);
+      double style = 0.0;
+      auto drawFeature = [&drawer, &style](FeatureType const & ft)
+      {
+        my::Timer styleTimer;
+        drawer(ft);
+        style += styleTimer.ElapsedSeconds();
+      };
+
+      timer.Reset();
+      src.ReadFeatures(drawFeature, ids);
+      res.m_read += timer.ElapsedSeconds() - style;
+      res.m_style += style;
+    }
+    arena.Clear();
+
+    timer.Reset();
+    for (auto const & shape : context.m_shapes)
+    {
+      shape->Prepare();
+      shapesData.clear();
+      MemWriter<string> writer(shapesData);
+      shape->Serialize(writer);
+      res.m_shapesSize += shapesData.size();
+    }
+    res.m_prepare += timer.ElapsedSeconds();
+
+    res.m_tiles.Add(tileTimer.ElapsedSeconds());
+    res.m_features += ids.size();
+    res.m_shapes += context.m_shapes.size();
+    context.m_shapes.clear();
+  }
+}
+
+}
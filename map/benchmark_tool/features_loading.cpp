@@ -37,6 +37,7 @@ namespace
     }
 
     bool IsEmpty() const { return m_count == 0; }
+    size_t GetCount() const { return m_count; }
 
     void operator() (FeatureType const & ft)
     {
@@ -80,7 +81,7 @@ namespace
 
         my::Timer timer;
         src.ForEachFeature(r, acc, scale);
-        res.Add(timer.ElapsedSeconds());
+        res.Add(scale, timer.ElapsedSeconds(), acc.GetCount());
 
         doDivide = !acc.IsEmpty();
       }
@@ -2,7 +2,11 @@
 
 #include "indexer/classificator_loader.hpp"
 #include "indexer/data_header.hpp"
+#include "indexer/mercator.hpp"
 
+#include "coding/file_writer.hpp"
+
+#include "std/algorithm.hpp"
 #include "std/iostream.hpp"
 
 #include "3party/gflags/src/gflags/gflags.h"
@@ -12,6 +16,16 @@ DEFINE_string(input, "", "MWM file name in the data directory");
 DEFINE_int32(lowS, 10, "Low processing scale");
 DEFINE_int32(highS, 17, "High processing scale");
 DEFINE_bool(print_scales, false, "Print geometry scales for MWM and exit");
+DEFINE_string(render_tiles, "", "File with \"zoom x y\" lines of the tiles to render from MWM");
+DEFINE_int32(threads, 1, "Number of threads to render tiles");
+DEFINE_string(tiles_output, "", "Directory to write the rendered tiles to");
+DEFINE_bool(search, false, "Replay the search queries in all the local maps and print latencies");
+DEFINE_string(search_queries, "", "File with \"locale<tab>query\" lines, saved queries if it's empty");
+DEFINE_double(search_lat, 0.0, "Latitude of the search viewport center");
+DEFINE_double(search_lon, 0.0, "Longitude of the search viewport center");
+DEFINE_double(search_viewport_km, 0.0, "Size of the search viewport, the whole world if it's 0");
+DEFINE_string(scenario, "", "JSON scenario of the benchmarks to run, see scenario.cpp");
+DEFINE_string(json, "", "File to write the JSON report of the scenario to, it's printed when empty");
 
 
 int main(int argc, char ** argv)
@@ -37,6 +51,72 @@ int main(int argc, char ** argv)
     return 0;
   }
 
+  if (!FLAGS_scenario.empty())
+  {
+    string report;
+    if (!bench::RunScenario(FLAGS_scenario, report))
+      return 1;
+
+    if (FLAGS_json.empty())
+    {
+      cout << report << endl;
+      return 0;
+    }
+
+    try
+    {
+      FileWriter writer(FLAGS_json);
+      writer.Write(report.data(), report.size());
+    }
+    catch (Writer::Exception const & ex)
+    {
+      cerr << "Can't write the report to " << FLAGS_json << ": " << ex.Msg() << endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  if (FLAGS_search)
+  {
+    using namespace bench;
+
+    m2::RectD viewport = MercatorBounds::FullRect();
+    if (FLAGS_search_viewport_km > 0.0)
+    {
+      viewport = MercatorBounds::RectByCenterXYAndSizeInMeters(
+          MercatorBounds::FromLatLon(FLAGS_search_lat, FLAGS_search_lon),
+          FLAGS_search_viewport_km * 1000.0);
+    }
+
+    SearchResult res;
+    RunSearchReplayBenchmark(FLAGS_search_queries, viewport, res);
+    res.Print();
+    return 0;
+  }
+
+  if (!FLAGS_input.empty() && !FLAGS_render_tiles.empty())
+  {
+    using namespace bench;
+
+    Result res;
+    RunTilesRenderingBenchmark(FLAGS_input, FLAGS_render_tiles, max(FLAGS_threads, 1), FLAGS_tiles_output, res);
+
+    res.CalcMetrics();
+    if (res.m_all < 0.0)
+    {
+      cout << "No tiles" << endl;
+    }
+    else
+    {
+      size_t const count = 1000;
+      cout << "TILE*1000[ median:" << res.m_med * count <<
+              " avg:" << res.m_avg * count <<
+              " max:" << res.m_max * count << " ] " <<
+              "TOTAL[ summ:" << res.m_all << " ]" << endl;
+    }
+    return 0;
+  }
+
   if (!FLAGS_input.empty())
   {
     using namespace bench;
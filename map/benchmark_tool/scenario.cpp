@@ -0,0 +1,245 @@
+#include "map/benchmark_tool/api.hpp"
+
+#include "coding/file_name_utils.hpp"
+
+#include "base/logging.hpp"
+#include "base/stats.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstdlib.hpp"
+#include "std/fstream.hpp"
+#include "std/limits.hpp"
+#include "std/sstream.hpp"
+
+#include "3party/jansson/myjansson.hpp"
+
+/// Scenario is a JSON object like this one, all the benchmarks but "maps" are optional:
+/// {
+///   "maps": ["Minsk", "Belarus"],
+///   "repeats": 3,
+///   "features": { "low_scale": 10, "high_scale": 17 },
+///   "tiles": "minsk_tiles.txt",
+///   "drape": true,
+///   "render": { "threads": 1 }
+/// }
+/// Each benchmark is run "repeats" times in a row and its fastest run is reported, the other ones
+/// only warm up the caches. The tiles are "zoom x y" lines of the raster tiles, the path is relative
+/// to the scenario. "drape" prepares the drape tiles of them without GL and "render" renders them
+/// by the RasterTileRenderer, so they are run by the drape and the non-drape builds respectively.
+
+namespace bench
+{
+
+namespace
+{
+  json_t * MakeTimes(vector<double> times)
+  {
+    sort(times.begin(), times.end());
+    json_t * res = json_object();
+    json_object_set_new(res, "count", json_integer(times.size()));
+    if (!times.empty())
+    {
+      json_object_set_new(res, "p50", json_real(my::GetPercentile(times, 0.5)));
+      json_object_set_new(res, "p90", json_real(my::GetPercentile(times, 0.9)));
+      json_object_set_new(res, "max", json_real(times.back()));
+    }
+    return res;
+  }
+
+  int GetInteger(json_t * obj, char const * key, int defaultValue)
+  {
+    json_t * value = json_object_get(obj, key);
+    return json_is_integer(value) ? static_cast<int>(json_integer_value(value)) : defaultValue;
+  }
+
+  double GetTotal(vector<double> const & times)
+  {
+    double res = 0.0;
+    for (double t : times)
+      res += t;
+    return res;
+  }
+
+  json_t * RunFeatures(string const & map, json_t * params, int repeats)
+  {
+    pair<int, int> const scales(GetInteger(params, "low_scale", 10),
+                                GetInteger(params, "high_scale", 17));
+
+    AllResult best;
+    best.m_all = numeric_limits<double>::max();
+    for (int i = 0; i < repeats; ++i)
+    {
+      AllResult res;
+      RunFeaturesLoadingBenchmark(map, scales, res);
+      if (res.m_all < best.m_all)
+        best = move(res);
+    }
+
+    json_t * report = json_object();
+    json_object_set_new(report, "seconds", json_real(best.m_all));
+    json_object_set_new(report, "decoding_seconds", json_real(GetTotal(best.m_reading.m_time)));
+    json_object_set_new(report, "feature_seconds", MakeTimes(best.m_reading.m_time));
+
+    json_t * jScales = json_array();
+    for (auto const & scale : best.m_scales)
+    {
+      json_t * jScale = json_object();
+      json_object_set_new(jScale, "scale", json_integer(scale.first));
+      json_object_set_new(jScale, "rects", json_integer(scale.second.m_rects));
+      json_object_set_new(jScale, "features", json_integer(scale.second.m_features));
+      json_object_set_new(jScale, "seconds", json_real(scale.second.m_all));
+      json_array_append_new(jScales, jScale);
+    }
+    json_object_set_new(report, "scales", jScales);
+    json_object_set_new(report, "peak_rss_bytes", json_integer(my::GetPeakRssBytes()));
+    return report;
+  }
+
+#ifdef USE_DRAPE
+  json_t * RunDrape(string const & map, string const & tilesFile, int repeats)
+  {
+    DrapeResult best;
+    double bestTotal = numeric_limits<double>::max();
+    for (int i = 0; i < repeats; ++i)
+    {
+      DrapeResult res;
+      RunDrapePreparingBenchmark(map, tilesFile, res);
+      double const total = GetTotal(res.m_tiles.m_time);
+      if (total < bestTotal)
+      {
+        best = move(res);
+        bestTotal = total;
+      }
+    }
+
+    json_t * report = json_object();
+    json_object_set_new(report, "seconds", json_real(GetTotal(best.m_tiles.m_time)));
+    json_object_set_new(report, "index_seconds", json_real(best.m_index));
+    json_object_set_new(report, "read_seconds", json_real(best.m_read));
+    json_object_set_new(report, "style_seconds", json_real(best.m_style));
+    json_object_set_new(report, "prepare_seconds", json_real(best.m_prepare));
+    json_object_set_new(report, "features", json_integer(best.m_features));
+    json_object_set_new(report, "shapes", json_integer(best.m_shapes));
+    json_object_set_new(report, "shapes_bytes", json_integer(best.m_shapesSize));
+    json_object_set_new(report, "tile_seconds", MakeTimes(best.m_tiles.m_time));
+    json_object_set_new(report, "peak_rss_bytes", json_integer(my::GetPeakRssBytes()));
+    return report;
+  }
+#else
+  json_t * RunRender(string const & map, string const & tilesFile, json_t * params, int repeats)
+  {
+    size_t const threads = max(GetInteger(params, "threads", 1), 1);
+
+    Result best;
+    double bestTotal = numeric_limits<double>::max();
+    for (int i = 0; i < repeats; ++i)
+    {
+      Result res;
+      RunTilesRenderingBenchmark(map, tilesFile, threads, string(), res);
+      double const total = GetTotal(res.m_time);
+      if (total < bestTotal)
+      {
+        best = move(res);
+        bestTotal = total;
+      }
+    }
+
+    json_t * report = json_object();
+    json_object_set_new(report, "threads", json_integer(threads));
+    json_object_set_new(report, "seconds", json_real(GetTotal(best.m_time)));
+    json_object_set_new(report, "tile_seconds", MakeTimes(best.m_time));
+    json_object_set_new(report, "peak_rss_bytes", json_integer(my::GetPeakRssBytes()));
+    return report;
+  }
+#endif
+}
+
+bool RunScenario(string const & scenarioFile, string & report)
+{
+  ifstream input(scenarioFile);
+  if (!input)
+  {
+    LOG(LERROR, ("Can't read the scenario", scenarioFile));
+    return false;
+  }
+  ostringstream text;
+  text << input.rdbuf();
+
+  try
+  {
+    my::Json scenario(text.str().c_str());
+    json_t * maps = json_object_get(scenario.get(), "maps");
+    if (!json_is_array(maps))
+    {
+      LOG(LERROR, ("No maps in the scenario", scenarioFile));
+      return false;
+    }
+
+    int const repeats = max(GetInteger(scenario.get(), "repeats", 1), 1);
+    json_t * features = json_object_get(scenario.get(), "features");
+    json_t * render = json_object_get(scenario.get(), "render");
+    bool const drape = json_is_true(json_object_get(scenario.get(), "drape"));
+
+    string tilesFile;
+    json_t * tiles = json_object_get(scenario.get(), "tiles");
+    if (json_is_string(tiles))
+    {
+      tilesFile = json_string_value(tiles);
+      if (!tilesFile.empty() && tilesFile[0] != '/')
+        tilesFile = my::JoinFoldersToPath(my::GetDirectory(scenarioFile), tilesFile);
+    }
+
+    my::JsonHandle root;
+    root.AttachNew(json_object());
+    json_object_set_new(root.get(), "repeats", json_integer(repeats));
+
+    json_t * reports = json_array();
+    for (size_t i = 0; i < json_array_size(maps); ++i)
+    {
+      json_t * map = json_array_get(maps, i);
+      if (!json_is_string(map))
+        continue;
+      string const name = json_string_value(map);
+      LOG(LINFO, ("Running the scenario for", name));
+
+      json_t * jMap = json_object();
+      json_object_set_new(jMap, "map", json_string(name.c_str()));
+      if (json_is_object(features))
+        json_object_set_new(jMap, "features", RunFeatures(name, features, repeats));
+
+      if (drape && !tilesFile.empty())
+      {
+#ifdef USE_DRAPE
+        json_object_set_new(jMap, "drape", RunDrape(name, tilesFile, repeats));
+#else
+        LOG(LWARNING, ("The tool is built without drape, drape benchmark is skipped."));
+#endif
+      }
+
+      if (json_is_object(render) && !tilesFile.empty())
+      {
+#ifndef USE_DRAPE
+        json_object_set_new(jMap, "render", RunRender(name, tilesFile, render, repeats));
+#else
+        LOG(LWARNING, ("The tool is built with drape, render benchmark is skipped."));
+#endif
+      }
+
+      json_array_append_new(reports, jMap);
+    }
+    json_object_set_new(root.get(), "maps", reports);
+    json_object_set_new(root.get(), "peak_rss_bytes", json_integer(my::GetPeakRssBytes()));
+
+    char * res = json_dumps(root.get(), JSON_PRESERVE_ORDER | JSON_INDENT(2));
+    report = res;
+    free(res);
+  }
+  catch (my::Json::Exception const & ex)
+  {
+    LOG(LERROR, ("Malformed scenario", scenarioFile, ex.Msg()));
+    return false;
+  }
+  return true;
+}
+
+}
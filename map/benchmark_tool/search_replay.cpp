@@ -0,0 +1,169 @@
+#include "map/benchmark_tool/api.hpp"
+
+#include "map/feature_vec_model.hpp"
+
+#include "search/params.hpp"
+#include "search/query_saver.hpp"
+#include "search/result.hpp"
+#include "search/search_engine.hpp"
+#include "search/search_query_factory.hpp"
+
+#include "platform/local_country_file_utils.hpp"
+#include "platform/platform.hpp"
+#include "platform/preferred_languages.hpp"
+
+#include "base/logging.hpp"
+#include "base/stats.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/condition_variable.hpp"
+#include "std/fstream.hpp"
+#include "std/iomanip.hpp"
+#include "std/iostream.hpp"
+#include "std/mutex.hpp"
+#include "std/unique_ptr.hpp"
+
+namespace bench
+{
+namespace
+{
+/// Runs the query by the engine and waits for the end marker.
+class SyncSearch
+{
+public:
+  bool Run(search::Engine & engine, search::QuerySaver::TSearchRequest const & request,
+           m2::RectD const & viewport, search::QueryTrace & trace)
+  {
+    m_done = false;
+
+    search::SearchParams params;
+    params.m_inputLocale = request.first;
+    params.m_query = request.second;
+    params.SetForceSearch(true);
+    params.m_callback = [this](search::Results const & results)
+    {
+      if (!results.IsEndMarker())
+        return;
+      lock_guard<mutex> lock(m_mutex);
+      m_done = true;
+      m_cv.notify_one();
+    };
+    params.m_traceCallback = [&trace](search::QueryTrace const & t) { trace = t; };
+
+    if (!engine.Search(params, viewport))
+      return false;
+
+    unique_lock<mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_done; });
+    return true;
+  }
+
+private:
+  mutex m_mutex;
+  condition_variable m_cv;
+  bool m_done;
+};
+
+/// Reads "locale<tab>query" lines, the locale is optional.
+void ReadQueries(string const & queriesFile, vector<search::QuerySaver::TSearchRequest> & queries)
+{
+  if (queriesFile.empty())
+  {
+    search::QuerySaver const saver;
+    queries.assign(saver.Get().begin(), saver.Get().end());
+    return;
+  }
+
+  ifstream stream(queriesFile);
+  string line;
+  while (getline(stream, line))
+  {
+    if (line.empty())
+      continue;
+    size_t const tab = line.find('\t');
+    if (tab == string::npos)
+      queries.emplace_back("en", line);
+    else
+      queries.emplace_back(line.substr(0, tab), line.substr(tab + 1));
+  }
+}
+}  // namespace
+
+void SearchResult::Print()
+{
+  if (m_traces.empty())
+  {
+    cout << "No queries" << endl;
+    return;
+  }
+
+  vector<double> times;
+  double phases[search::QueryTrace::PHASES_COUNT] = {};
+  for (search::QueryTrace const & trace : m_traces)
+  {
+    times.push_back(trace.m_totalSeconds);
+    for (size_t i = 0; i < search::QueryTrace::PHASES_COUNT; ++i)
+      phases[i] += trace.m_phaseSeconds[i];
+  }
+  sort(times.begin(), times.end());
+
+  size_t const count = 1000;
+  cout << fixed << setprecision(3);
+  cout << "QUERY*1000[ p50:" << my::GetPercentile(times, 0.5) * count
+       << " p95:" << my::GetPercentile(times, 0.95) * count
+       << " p99:" << my::GetPercentile(times, 0.99) * count
+       << " max:" << times.back() * count << " ] QUERIES[ " << times.size() << " ]" << endl;
+
+  cout << "PHASE*1000[";
+  for (size_t i = 0; i < search::QueryTrace::PHASES_COUNT; ++i)
+  {
+    cout << " " << search::QueryTrace::GetPhaseName(static_cast<search::QueryTrace::Phase>(i))
+         << ":" << phases[i] * count / m_traces.size();
+  }
+  cout << " ] average" << endl;
+
+  // The slowest queries are the first to look at.
+  vector<search::QueryTrace const *> slowest;
+  for (search::QueryTrace const & trace : m_traces)
+    slowest.push_back(&trace);
+  sort(slowest.begin(), slowest.end(), [](search::QueryTrace const * a, search::QueryTrace const * b)
+  {
+    return a->m_totalSeconds > b->m_totalSeconds;
+  });
+  for (size_t i = 0; i < min(slowest.size(), size_t(5)); ++i)
+    cout << DebugPrint(*slowest[i]) << endl;
+}
+
+void RunSearchReplayBenchmark(string const & queriesFile, m2::RectD const & viewport,
+                              SearchResult & res)
+{
+  vector<search::QuerySaver::TSearchRequest> queries;
+  ReadQueries(queriesFile, queries);
+  if (queries.empty())
+    return;
+
+  model::FeaturesFetcher src;
+  vector<platform::LocalCountryFile> localFiles;
+  platform::FindAllLocalMaps(localFiles);
+  for (platform::LocalCountryFile & localFile : localFiles)
+  {
+    localFile.SyncWithDisk();
+    auto const r = src.RegisterMap(localFile);
+    if (r.second != MwmSet::RegResult::Success)
+      LOG(LWARNING, ("Can't register", localFile));
+  }
+
+  Platform & pl = GetPlatform();
+  search::Engine engine(&src.GetIndex(), pl.GetReader(SEARCH_CATEGORIES_FILE_NAME),
+                        pl.GetReader(PACKED_POLYGONS_FILE), pl.GetReader(COUNTRIES_FILE),
+                        languages::GetCurrentOrig(), make_unique<search::SearchQueryFactory>());
+
+  SyncSearch search;
+  for (auto const & query : queries)
+  {
+    search::QueryTrace trace;
+    if (search.Run(engine, query, viewport, trace))
+      res.m_traces.push_back(trace);
+  }
+}
+}  // namespace bench
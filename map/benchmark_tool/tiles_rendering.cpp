@@ -0,0 +1,104 @@
+#include "map/benchmark_tool/api.hpp"
+
+#include "map/feature_vec_model.hpp"
+#include "map/raster_tile_renderer.hpp"
+
+#include "render/frame_image.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_name_utils.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/mutex.hpp"
+#include "base/thread.hpp"
+#include "base/timer.hpp"
+
+#include "std/atomic.hpp"
+#include "std/fstream.hpp"
+#include "std/sstream.hpp"
+
+
+namespace bench
+{
+
+namespace
+{
+  bool ReadTiles(string const & tilesFile, vector<RasterTileKey> & tiles)
+  {
+    ifstream input(tilesFile);
+    if (!input)
+      return false;
+
+    RasterTileKey key;
+    while (input >> key.m_zoom >> key.m_x >> key.m_y)
+      tiles.push_back(key);
+    return true;
+  }
+
+  string GetTileFileName(string const & outputDir, RasterTileKey const & key)
+  {
+    ostringstream name;
+    name << key.m_zoom << "-" << key.m_x << "-" << key.m_y << ".png";
+    return my::JoinFoldersToPath(outputDir, name.str());
+  }
+}
+
+void RunTilesRenderingBenchmark(string const & file, string const & tilesFile, size_t threadsCount,
+                                string const & outputDir, Result & res)
+{
+  vector<RasterTileKey> tiles;
+  if (!ReadTiles(tilesFile, tiles))
+  {
+    LOG(LERROR, ("Can't read tiles from", tilesFile));
+    return;
+  }
+
+  string fileName = file;
+  my::GetNameFromFullPath(fileName);
+  my::GetNameWithoutExt(fileName);
+
+  model::FeaturesFetcher src;
+  auto const r = src.RegisterMap(platform::LocalCountryFile::MakeForTesting(fileName));
+  if (r.second != MwmSet::RegResult::Success)
+    return;
+
+  // Drawers load their skins and fonts in the constructor, so it isn't measured.
+  RasterTileRenderer renderer(src, graphics::EDensityMDPI, threadsCount);
+
+  atomic<size_t> next(0);
+  threads::Mutex resultMutex;
+  auto const renderTiles = [&]()
+  {
+    Result threadResult;
+    FrameImage image;
+    for (size_t i = next++; i < tiles.size(); i = next++)
+    {
+      my::Timer timer;
+      renderer.RenderTile(tiles[i], image);
+      threadResult.Add(timer.ElapsedSeconds());
+
+      if (!outputDir.empty())
+      {
+        FileWriter writer(GetTileFileName(outputDir, tiles[i]));
+        writer.Write(image.m_data.data(), image.m_data.size());
+      }
+    }
+
+    threads::MutexGuard guard(resultMutex);
+    UNUSED_VALUE(guard);
+    res.Add(threadResult);
+  };
+
+  my::Timer timer;
+  vector<threads::SimpleThread> threads;
+  for (size_t i = 0; i < threadsCount; ++i)
+    threads.emplace_back(renderTiles);
+  for (threads::SimpleThread & thread : threads)
+    thread.join();
+
+  LOG(LINFO, ("Rendered", tiles.size(), "tiles by", threadsCount, "threads in", timer.ElapsedSeconds(), "seconds"));
+}
+
+}
@@ -1,4 +1,5 @@
 #include "map/bookmark.hpp"
+#include "map/bookmark_binary.hpp"
 #include "map/track.hpp"
 #include "map/anim_phase_chain.hpp"
 
@@ -12,7 +13,9 @@
 
 #include "indexer/mercator.hpp"
 
+#include "coding/file_name_utils.hpp"
 #include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
 #include "../coding/parse_xml.hpp"  // LoadFromKML
 #include "coding/internal/file_data.hpp"
 #include "coding/hex.hpp"
@@ -79,6 +82,7 @@ Bookmark * BookmarkCategory::AddBookmark(m2::PointD const & ptOrg, BookmarkData
 
 void BookmarkCategory::ReplaceBookmark(size_t index, BookmarkData const & bm)
 {
+  m_needsRewrite = true;
   Controller & c = base_t::GetController();
   ASSERT_LESS (index, c.GetUserMarkCount(), ());
   if (index < c.GetUserMarkCount())
@@ -92,6 +96,12 @@ BookmarkCategory::BookmarkCategory(const string & name, Framework & framework)
   : base_t(graphics::bookmarkDepth, framework)
   , m_name(name)
   , m_blockAnimation(false)
+  , m_savedVisible(false)
+  , m_savedBookmarksCount(0)
+  , m_savedTracksCount(0)
+  , m_savedRecordsCount(0)
+  , m_savedFileSize(0)
+  , m_needsRewrite(false)
 {
 }
 
@@ -103,11 +113,13 @@ BookmarkCategory::~BookmarkCategory()
 
 void BookmarkCategory::ClearBookmarks()
 {
+  m_needsRewrite = true;
   base_t::Clear();
 }
 
 void BookmarkCategory::ClearTracks()
 {
+  m_needsRewrite = true;
   for_each(m_tracks.begin(), m_tracks.end(), DeleteFunctor());
   m_tracks.clear();
 }
@@ -132,6 +144,7 @@ template <class T> void DeleteItem(vector<T> & v, size_t i)
 
 void BookmarkCategory::DeleteBookmark(size_t index)
 {
+  m_needsRewrite = true;
   base_t::Controller & c = base_t::GetController();
   ASSERT_LESS(index, c.GetUserMarkCount(), ());
   UserMark const * markForDelete = c.GetUserMark(index);
@@ -156,6 +169,7 @@ void BookmarkCategory::DeleteBookmark(size_t index)
 
 void BookmarkCategory::DeleteTrack(size_t index)
 {
+  m_needsRewrite = true;
   DeleteItem(m_tracks, index);
 }
 
@@ -605,12 +619,129 @@ bool BookmarkCategory::LoadFromKML(ReaderPtr<Reader> const & reader)
   }
 }
 
-BookmarkCategory * BookmarkCategory::CreateFromKMLFile(string const & file, Framework & framework)
+namespace
+{
+  /// Binary file is a snapshot of the header, bookmarks and tracks records.
+  size_t const kSnapshotRecordsCount = 3;
+  /// File is compacted when there are too many appended records.
+  size_t const kMaxRecordsCount = 64;
+
+  class CategoryBuilder : public bookmark_binary::ICategoryBuilder
+  {
+  public:
+    CategoryBuilder(BookmarkCategory & category) : m_category(category) {}
+
+    // bookmark_binary::ICategoryBuilder overrides:
+    void SetHeader(string const & name, bool isVisible) override
+    {
+      m_category.SetName(name);
+      m_category.SetVisible(isVisible);
+    }
+
+    void AddBookmark(bookmark_binary::BookmarkRecord const & bm) override
+    {
+      m_category.AddBookmark(bm.m_org, BookmarkData(bm.m_name, bm.m_type, bm.m_description,
+                                                    bm.m_scale, bm.m_timeStamp));
+    }
+
+    void AddTrack(bookmark_binary::TrackRecord && record) override
+    {
+      if (record.m_points.size() < 2)
+      {
+        LOG(LWARNING, ("Track", record.m_name, "without points is skipped"));
+        return;
+      }
+
+      Track track(Track::PolylineD(record.m_points));
+      track.SetName(record.m_name);
+
+      Track::TrackOutline trackOutline { record.m_width, graphics::Color::fromARGB(record.m_color) };
+      track.AddOutline(&trackOutline, 1);
+
+      m_category.AddTrack(track);
+    }
+
+  private:
+    BookmarkCategory & m_category;
+  };
+
+  /// Writes first |count| bookmarks in reverse order, see SaveToKML().
+  void WriteBookmarks(Writer & writer, BookmarkCategory const & category, size_t count)
+  {
+    vector<bookmark_binary::BookmarkRecord> bookmarks(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      Bookmark const * bm = category.GetBookmark(count - i - 1);
+      bookmark_binary::BookmarkRecord & record = bookmarks[i];
+      record.m_org = bm->GetOrg();
+      record.m_name = bm->GetName();
+      record.m_description = bm->GetDescription();
+      record.m_type = bm->GetType();
+      record.m_scale = bm->GetScale();
+      record.m_timeStamp = bm->GetTimeStamp();
+    }
+    bookmark_binary::WriteBookmarks(writer, bookmarks);
+  }
+
+  /// Writes tracks starting from |first|.
+  void WriteTracks(Writer & writer, BookmarkCategory const & category, size_t first)
+  {
+    vector<bookmark_binary::TrackRecord> tracks;
+    for (size_t i = first; i < category.GetTracksCount(); ++i)
+    {
+      Track const * track = category.GetTrack(i);
+      graphics::Color const & color = track->GetMainColor();
+
+      tracks.emplace_back();
+      bookmark_binary::TrackRecord & record = tracks.back();
+      record.m_name = track->GetName();
+      record.m_color = (uint32_t(color.a) << 24) | (uint32_t(color.r) << 16) |
+                       (uint32_t(color.g) << 8) | uint32_t(color.b);
+      record.m_width = track->GetMainWidth();
+      record.m_points.assign(track->GetPolyline().Begin(), track->GetPolyline().End());
+    }
+    bookmark_binary::WriteTracks(writer, tracks);
+  }
+}
+
+bool BookmarkCategory::LoadFromBinary(void const * data, size_t size)
+{
+  AnimBlockGuard g(m_blockAnimation);
+
+  CategoryBuilder builder(*this);
+  size_t recordsCount, readSize;
+  if (!bookmark_binary::ReadCategory(data, size, builder, recordsCount, readSize))
+    return false;
+
+  // A truncated record is overwritten on the next save, see CanAppendToFile().
+  SetSaved(recordsCount, readSize);
+  return true;
+}
+
+void BookmarkCategory::SaveToBinary(Writer & writer) const
+{
+  bookmark_binary::WriteFileHeader(writer);
+  bookmark_binary::WriteHeader(writer, m_name, IsVisible());
+  WriteBookmarks(writer, *this, GetBookmarksCount());
+  WriteTracks(writer, *this, 0);
+}
+
+BookmarkCategory * BookmarkCategory::CreateFromFile(string const & file, Framework & framework)
 {
   auto_ptr<BookmarkCategory> cat(new BookmarkCategory("", framework));
   try
   {
-    if (cat->LoadFromKML(new FileReader(file)))
+    bool isLoaded;
+    if (my::GetFileExtension(file) == BOOKMARKS_BINARY_FILE_EXTENSION)
+    {
+      string data;
+      FileReader(file).ReadAsString(data);
+      isLoaded = cat->LoadFromBinary(data.data(), data.size());
+    }
+    else
+      isLoaded = cat->LoadFromKML(new FileReader(file));
+
+    if (isLoaded)
       cat->m_file = file;
     else
       cat.reset();
@@ -705,7 +836,7 @@ namespace
   }
 }
 
-void BookmarkCategory::SaveToKML(ostream & s)
+void BookmarkCategory::SaveToKML(ostream & s) const
 {
   s << kmlHeader;
 
@@ -829,26 +960,24 @@ string BookmarkCategory::RemoveInvalidSymbols(string const & name)
   return (uniName.empty() ? "Bookmarks" : strings::ToUtf8(uniName));
 }
 
-string BookmarkCategory::GenerateUniqueFileName(const string & path, string name)
+string BookmarkCategory::GenerateUniqueFileName(const string & path, string name, string const & ext)
 {
-  string const kmlExt(BOOKMARKS_FILE_EXTENSION);
-
-  // check if file name already contains .kml extension
-  size_t const extPos = name.rfind(kmlExt);
+  // check if file name already contains the extension
+  size_t const extPos = name.rfind(ext);
   if (extPos != string::npos)
   {
     // remove extension
-    ASSERT_GREATER_OR_EQUAL(name.size(), kmlExt.size(), ());
-    size_t const expectedPos = name.size() - kmlExt.size();
+    ASSERT_GREATER_OR_EQUAL(name.size(), ext.size(), ());
+    size_t const expectedPos = name.size() - ext.size();
     if (extPos == expectedPos)
       name.resize(expectedPos);
   }
 
   size_t counter = 1;
   string suffix;
-  while (Platform::IsFileExistsByFullPath(path + name + suffix + kmlExt))
+  while (Platform::IsFileExistsByFullPath(path + name + suffix + ext))
     suffix = strings::to_string(counter++);
-  return (path + name + suffix + kmlExt);
+  return (path + name + suffix + ext);
 }
 
 void BookmarkCategory::ReleaseAnimations()
@@ -880,12 +1009,13 @@ UserMark * BookmarkCategory::AllocateUserMark(m2::PointD const & ptOrg)
   return b;
 }
 
-bool BookmarkCategory::SaveToKMLFile()
+bool BookmarkCategory::SaveToFile()
 {
   string oldFile;
 
   // Get valid file name from category name
   string const name = RemoveInvalidSymbols(m_name);
+  string const ext(BOOKMARKS_BINARY_FILE_EXTENSION);
 
   if (!m_file.empty())
   {
@@ -898,51 +1028,142 @@ bool BookmarkCategory::SaveToKMLFile()
     else
       ++i1;
 
-    // If m_file doesn't match name, assign new m_file for this category and save old file name.
-    if (m_file.substr(i1, i2 - i1).find(name) != 0)
+    // If m_file doesn't match name or it's a KML file, assign new m_file
+    // for this category and save old file name.
+    if (m_file.substr(i1, i2 - i1).find(name) != 0 || m_file.substr(i2) != ext)
     {
-      oldFile = GenerateUniqueFileName(GetPlatform().SettingsDir(), name);
+      oldFile = GenerateUniqueFileName(GetPlatform().SettingsDir(), name, ext);
       m_file.swap(oldFile);
     }
   }
   else
-    m_file = GenerateUniqueFileName(GetPlatform().SettingsDir(), name);
+    m_file = GenerateUniqueFileName(GetPlatform().SettingsDir(), name, ext);
 
-  string const fileTmp = m_file + ".tmp";
+  // Failed append is recovered by the rewrite.
+  if (oldFile.empty() && CanAppendToFile() && AppendToFile())
+    return true;
+  if (RewriteFile(oldFile))
+    return true;
+
+  LOG(LWARNING, ("Can't save bookmarks category", m_name, "to file", m_file));
+
+  // return old file name in case of error
+  if (!oldFile.empty())
+    m_file.swap(oldFile);
+
+  return false;
+}
 
+bool BookmarkCategory::ExportToKMLFile(string const & file) const
+{
   try
   {
-    // First, we save to the temporary file
     /// @todo On Windows UTF-8 file names are not supported.
-    ofstream of(fileTmp.c_str(), std::ios_base::out | std::ios_base::trunc);
+    ofstream of(file.c_str(), std::ios_base::out | std::ios_base::trunc);
     SaveToKML(of);
     of.flush();
 
     if (!of.fail())
+      return true;
+  }
+  catch (std::exception const & e)
+  {
+    LOG(LWARNING, ("Exception while exporting bookmarks:", e.what()));
+  }
+
+  LOG(LWARNING, ("Can't export bookmarks category", m_name, "to file", file));
+  my::DeleteFileX(file);
+  return false;
+}
+
+bool BookmarkCategory::CanAppendToFile() const
+{
+  if (m_needsRewrite || m_savedRecordsCount == 0 || m_savedRecordsCount >= kMaxRecordsCount)
+    return false;
+  if (GetBookmarksCount() < m_savedBookmarksCount || GetTracksCount() < m_savedTracksCount)
+    return false;
+
+  // The file may be changed or truncated since the last save.
+  uint64_t size;
+  return my::GetFileSize(m_file, size) && size == m_savedFileSize;
+}
+
+bool BookmarkCategory::AppendToFile()
+{
+  size_t recordsCount = m_savedRecordsCount;
+  try
+  {
+    FileWriter writer(m_file, FileWriter::OP_APPEND);
+    if (m_name != m_savedName || IsVisible() != m_savedVisible)
+    {
+      bookmark_binary::WriteHeader(writer, m_name, IsVisible());
+      ++recordsCount;
+    }
+    if (GetBookmarksCount() > m_savedBookmarksCount)
     {
-      // Only after successfull save we replace original file
-      my::DeleteFileX(m_file);
-      VERIFY(my::RenameFileX(fileTmp, m_file), (fileTmp, m_file));
-      // delete old file
-      if (!oldFile.empty())
-        VERIFY(my::DeleteFileX(oldFile), (oldFile, m_file));
+      WriteBookmarks(writer, *this, GetBookmarksCount() - m_savedBookmarksCount);
+      ++recordsCount;
+    }
+    if (GetTracksCount() > m_savedTracksCount)
+    {
+      WriteTracks(writer, *this, m_savedTracksCount);
+      ++recordsCount;
+    }
+  }
+  catch (std::exception const & e)
+  {
+    LOG(LWARNING, ("Exception while appending bookmarks:", e.what()));
+    return false;
+  }
 
-      return true;
+  uint64_t size;
+  if (!my::GetFileSize(m_file, size))
+    return false;
+  SetSaved(recordsCount, size);
+  return true;
+}
+
+bool BookmarkCategory::RewriteFile(string const & oldFile)
+{
+  string const fileTmp = m_file + ".tmp";
+
+  try
+  {
+    // First, we save to the temporary file
+    uint64_t size;
+    {
+      FileWriter writer(fileTmp);
+      SaveToBinary(writer);
+      size = writer.Size();
     }
+
+    // Only after successfull save we replace original file
+    my::DeleteFileX(m_file);
+    VERIFY(my::RenameFileX(fileTmp, m_file), (fileTmp, m_file));
+    // delete old file
+    if (!oldFile.empty())
+      VERIFY(my::DeleteFileX(oldFile), (oldFile, m_file));
+
+    SetSaved(kSnapshotRecordsCount, size);
+    return true;
   }
   catch (std::exception const & e)
   {
     LOG(LWARNING, ("Exception while saving bookmarks:", e.what()));
   }
 
-  LOG(LWARNING, ("Can't save bookmarks category", m_name, "to file", m_file));
-
   // remove possibly left tmp file
   my::DeleteFileX(fileTmp);
-
-  // return old file name in case of error
-  if (!oldFile.empty())
-    m_file.swap(oldFile);
-
   return false;
 }
+
+void BookmarkCategory::SetSaved(size_t recordsCount, uint64_t fileSize)
+{
+  m_savedName = m_name;
+  m_savedVisible = IsVisible();
+  m_savedBookmarksCount = GetBookmarksCount();
+  m_savedTracksCount = GetTracksCount();
+  m_savedRecordsCount = recordsCount;
+  m_savedFileSize = fileSize;
+  m_needsRewrite = false;
+}
@@ -10,11 +10,15 @@
 
 #include "base/timer.hpp"
 
+#include "defines.hpp"
+
 #include "std/string.hpp"
 #include "std/noncopyable.hpp"
 #include "std/iostream.hpp"
 #include "std/shared_ptr.hpp"
 
+class Writer;
+
 namespace anim
 {
   class Task;
@@ -174,19 +178,30 @@ public:
   /// You don't need to call them from client code.
   //@{
   bool LoadFromKML(ReaderPtr<Reader> const & reader);
-  void SaveToKML(ostream & s);
+  void SaveToKML(ostream & s) const;
+
+  /// Reads the file data in place, see bookmark_binary.hpp.
+  bool LoadFromBinary(void const * data, size_t size);
+  /// Writes the whole category as a new binary file.
+  void SaveToBinary(Writer & writer) const;
 
   /// Uses the same file name from which was loaded, or
   /// creates unique file name on first save and uses it every time.
-  bool SaveToKMLFile();
+  /// Categories are stored in the binary format: new bookmarks and tracks are appended
+  /// to the file, and other changes rewrite it. KML file is converted on the first save.
+  bool SaveToFile();
+  /// Writes a KML file for sharing, the category file isn't changed.
+  bool ExportToKMLFile(string const & file) const;
 
+  /// Loads a binary or KML file depending on its extension.
   /// @return 0 in the case of error
-  static BookmarkCategory * CreateFromKMLFile(string const & file, Framework & framework);
+  static BookmarkCategory * CreateFromFile(string const & file, Framework & framework);
 
   /// Get valid file name from input (remove illegal symbols).
   static string RemoveInvalidSymbols(string const & name);
   /// Get unique bookmark file name from path and valid file name.
-  static string GenerateUniqueFileName(const string & path, string name);
+  static string GenerateUniqueFileName(const string & path, string name,
+                                       string const & ext = BOOKMARKS_FILE_EXTENSION);
   //@}
 
 protected:
@@ -196,11 +211,34 @@ protected:
 
 private:
   void ReleaseAnimations();
-  
+
+  /// @name Saving of the binary file.
+  //@{
+  bool CanAppendToFile() const;
+  bool AppendToFile();
+  bool RewriteFile(string const & oldFile);
+  /// Remembers what is in the file after a successful load or save.
+  void SetSaved(size_t recordsCount, uint64_t fileSize);
+  //@}
+
 private:
   bool m_blockAnimation;
   typedef pair<UserMark *, shared_ptr<anim::Task> > anim_node_t;
   vector<anim_node_t> m_anims;
+
+  /// @name State of the binary file.
+  //@{
+  string m_savedName;
+  bool m_savedVisible;
+  /// New bookmarks are at the beginning of the list and new tracks are at the end.
+  size_t m_savedBookmarksCount;
+  size_t m_savedTracksCount;
+  /// Records in the file, 0 when it must be written from scratch.
+  size_t m_savedRecordsCount;
+  uint64_t m_savedFileSize;
+  /// Bookmarks or tracks were changed or deleted after the last save.
+  bool m_needsRewrite;
+  //@}
 };
 
 /// <category index, bookmark index>
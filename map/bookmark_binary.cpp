@@ -0,0 +1,323 @@
+#include "map/bookmark_binary.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/read_write_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/logging.hpp"
+
+#include "std/cstring.hpp"
+#include "std/map.hpp"
+
+namespace bookmark_binary
+{
+namespace
+{
+char const kMagic[] = "MWMB";
+size_t const kMagicSize = 4;
+uint8_t const kVersion = 0;
+
+enum RecordType : uint8_t
+{
+  RECORD_HEADER = 0,
+  RECORD_BOOKMARKS = 1,
+  RECORD_TRACKS = 2
+};
+
+uint8_t const kHasScale = 1;
+uint8_t const kHasTimeStamp = 2;
+
+using TBuffer = vector<char>;
+using TSource = ReaderSource<MemReader>;
+
+void WriteRecord(Writer & writer, RecordType type, TBuffer const & payload)
+{
+  TBuffer record;
+  MemWriter<TBuffer> sink(record);
+  WriteToSink(sink, static_cast<uint8_t>(type));
+  WriteVarUint(sink, static_cast<uint64_t>(payload.size()));
+  sink.Write(payload.data(), payload.size());
+  // One write call, so an interrupted append leaves at most one truncated record.
+  writer.Write(record.data(), record.size());
+}
+
+template <typename TSink>
+void WriteDouble(TSink & sink, double d)
+{
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(bits));
+  WriteToSink(sink, bits);
+}
+
+double ReadDouble(TSource & src)
+{
+  uint64_t const bits = ReadPrimitiveFromSource<uint64_t>(src);
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+/// Writes points as varint deltas of quantized coordinates from the previous point.
+class PointsWriter
+{
+public:
+  template <typename TSink>
+  void Write(TSink & sink, m2::PointD const & pt)
+  {
+    m2::PointU const pu = PointD2PointU(pt, kCoordBits);
+    WriteVarInt(sink, static_cast<int64_t>(pu.x) - static_cast<int64_t>(m_last.x));
+    WriteVarInt(sink, static_cast<int64_t>(pu.y) - static_cast<int64_t>(m_last.y));
+    m_last = pu;
+  }
+
+private:
+  m2::PointU m_last = m2::PointU(0, 0);
+};
+
+class PointsReader
+{
+public:
+  m2::PointD Read(TSource & src)
+  {
+    m_last.x = static_cast<uint32_t>(m_last.x + ReadVarInt<int64_t>(src));
+    m_last.y = static_cast<uint32_t>(m_last.y + ReadVarInt<int64_t>(src));
+    return PointU2PointD(m_last, kCoordBits);
+  }
+
+private:
+  m2::PointU m_last = m2::PointU(0, 0);
+};
+
+class StringsTable
+{
+public:
+  uint32_t Add(string const & s)
+  {
+    auto const res = m_indices.insert(make_pair(s, static_cast<uint32_t>(m_strings.size())));
+    if (res.second)
+      m_strings.push_back(s);
+    return res.first->second;
+  }
+
+  vector<string> const & GetStrings() const { return m_strings; }
+
+private:
+  map<string, uint32_t> m_indices;
+  vector<string> m_strings;
+};
+
+string const & GetString(vector<string> const & strings, uint32_t index)
+{
+  if (index >= strings.size())
+    MYTHROW(Reader::ReadException, ("Bad string index", index));
+  return strings[index];
+}
+
+void ReadBookmarks(TSource & src, ICategoryBuilder & builder)
+{
+  vector<string> strings(ReadVarUint<uint32_t>(src));
+  for (string & s : strings)
+    rw::Read(src, s);
+
+  uint32_t const count = ReadVarUint<uint32_t>(src);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    BookmarkRecord bm;
+    bm.m_org.x = ReadDouble(src);
+    bm.m_org.y = ReadDouble(src);
+    bm.m_name = GetString(strings, ReadVarUint<uint32_t>(src));
+    bm.m_description = GetString(strings, ReadVarUint<uint32_t>(src));
+    bm.m_type = GetString(strings, ReadVarUint<uint32_t>(src));
+    uint8_t const flags = ReadPrimitiveFromSource<uint8_t>(src);
+    if (flags & kHasScale)
+      bm.m_scale = ReadDouble(src);
+    if (flags & kHasTimeStamp)
+      bm.m_timeStamp = static_cast<time_t>(ReadVarInt<int64_t>(src));
+    builder.AddBookmark(bm);
+  }
+}
+
+void ReadTracks(TSource & src, ICategoryBuilder & builder)
+{
+  uint32_t const count = ReadVarUint<uint32_t>(src);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    TrackRecord track;
+    rw::Read(src, track.m_name);
+    track.m_color = ReadPrimitiveFromSource<uint32_t>(src);
+    uint32_t const width = ReadPrimitiveFromSource<uint32_t>(src);
+    memcpy(&track.m_width, &width, sizeof(track.m_width));
+
+    track.m_points.resize(ReadVarUint<uint32_t>(src));
+    PointsReader points;
+    for (m2::PointD & pt : track.m_points)
+      pt = points.Read(src);
+    builder.AddTrack(move(track));
+  }
+}
+
+/// @return False when the varint doesn't fit into [p, end).
+bool ReadRecordSize(uint8_t const *& p, uint8_t const * end, uint64_t & size)
+{
+  size = 0;
+  for (uint32_t shift = 0; p != end && shift < 64; shift += 7)
+  {
+    uint8_t const byte = *p++;
+    size |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+}  // namespace
+
+void WriteFileHeader(Writer & writer)
+{
+  writer.Write(kMagic, kMagicSize);
+  WriteToSink(writer, kVersion);
+}
+
+void WriteHeader(Writer & writer, string const & name, bool isVisible)
+{
+  TBuffer payload;
+  MemWriter<TBuffer> sink(payload);
+  rw::Write(sink, name);
+  WriteToSink(sink, static_cast<uint8_t>(isVisible ? 1 : 0));
+  WriteRecord(writer, RECORD_HEADER, payload);
+}
+
+void WriteBookmarks(Writer & writer, vector<BookmarkRecord> const & bookmarks)
+{
+  StringsTable strings;
+  vector<uint32_t> indices;
+  indices.reserve(3 * bookmarks.size());
+  for (BookmarkRecord const & bm : bookmarks)
+  {
+    indices.push_back(strings.Add(bm.m_name));
+    indices.push_back(strings.Add(bm.m_description));
+    indices.push_back(strings.Add(bm.m_type));
+  }
+
+  TBuffer payload;
+  MemWriter<TBuffer> sink(payload);
+  WriteVarUint(sink, static_cast<uint32_t>(strings.GetStrings().size()));
+  for (string const & s : strings.GetStrings())
+    rw::Write(sink, s);
+
+  WriteVarUint(sink, static_cast<uint32_t>(bookmarks.size()));
+  for (size_t i = 0; i < bookmarks.size(); ++i)
+  {
+    BookmarkRecord const & bm = bookmarks[i];
+    WriteDouble(sink, bm.m_org.x);
+    WriteDouble(sink, bm.m_org.y);
+    for (size_t j = 3 * i; j < 3 * i + 3; ++j)
+      WriteVarUint(sink, indices[j]);
+
+    uint8_t flags = 0;
+    if (bm.m_scale != -1.0)
+      flags |= kHasScale;
+    if (bm.m_timeStamp != -1)
+      flags |= kHasTimeStamp;
+    WriteToSink(sink, flags);
+    if (flags & kHasScale)
+      WriteDouble(sink, bm.m_scale);
+    if (flags & kHasTimeStamp)
+      WriteVarInt(sink, static_cast<int64_t>(bm.m_timeStamp));
+  }
+  WriteRecord(writer, RECORD_BOOKMARKS, payload);
+}
+
+void WriteTracks(Writer & writer, vector<TrackRecord> const & tracks)
+{
+  TBuffer payload;
+  MemWriter<TBuffer> sink(payload);
+  WriteVarUint(sink, static_cast<uint32_t>(tracks.size()));
+  for (TrackRecord const & track : tracks)
+  {
+    rw::Write(sink, track.m_name);
+    WriteToSink(sink, track.m_color);
+    uint32_t width;
+    memcpy(&width, &track.m_width, sizeof(width));
+    WriteToSink(sink, width);
+
+    WriteVarUint(sink, static_cast<uint32_t>(track.m_points.size()));
+    PointsWriter points;
+    for (m2::PointD const & pt : track.m_points)
+      points.Write(sink, pt);
+  }
+  WriteRecord(writer, RECORD_TRACKS, payload);
+}
+
+bool ReadCategory(void const * data, size_t size, ICategoryBuilder & builder,
+                  size_t & recordsCount, size_t & readSize)
+{
+  recordsCount = 0;
+  readSize = 0;
+
+  uint8_t const * p = static_cast<uint8_t const *>(data);
+  uint8_t const * const end = p + size;
+  if (size < kMagicSize + 1 || memcmp(p, kMagic, kMagicSize) != 0)
+  {
+    LOG(LWARNING, ("Not a bookmarks binary file."));
+    return false;
+  }
+  p += kMagicSize;
+  if (*p != kVersion)
+  {
+    LOG(LWARNING, ("Unknown bookmarks binary file version:", *p));
+    return false;
+  }
+  ++p;
+  readSize = kMagicSize + 1;
+
+  try
+  {
+    while (p != end)
+    {
+      uint8_t const type = *p++;
+      uint64_t payloadSize;
+      if (!ReadRecordSize(p, end, payloadSize) || payloadSize > static_cast<uint64_t>(end - p))
+      {
+        LOG(LWARNING, ("Truncated bookmarks record is skipped."));
+        break;
+      }
+
+      MemReader reader(p, static_cast<size_t>(payloadSize));
+      TSource src(reader);
+      switch (type)
+      {
+      case RECORD_HEADER:
+      {
+        string name;
+        rw::Read(src, name);
+        builder.SetHeader(name, ReadPrimitiveFromSource<uint8_t>(src) != 0);
+        break;
+      }
+      case RECORD_BOOKMARKS: ReadBookmarks(src, builder); break;
+      case RECORD_TRACKS: ReadTracks(src, builder); break;
+      default: LOG(LWARNING, ("Unknown bookmarks record type:", type)); break;
+      }
+
+      p += payloadSize;
+      ++recordsCount;
+      readSize = static_cast<size_t>(p - static_cast<uint8_t const *>(data));
+    }
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LWARNING, ("Malformed bookmarks binary file:", e.Msg()));
+    return false;
+  }
+
+  return true;
+}
+
+m2::PointD QuantizePoint(m2::PointD const & pt)
+{
+  return PointU2PointD(PointD2PointU(pt, kCoordBits), kCoordBits);
+}
+}  // namespace bookmark_binary
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "geometry/point2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/ctime.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+/// Binary storage of a bookmarks category, KML is used for import and export only.
+///
+/// The file is a log of records, so new bookmarks and tracks are saved by appending
+/// a record, and other edits rewrite the whole file. A record is a type byte,
+/// a varint payload size and the payload:
+/// - header: category name and visibility, the last one wins;
+/// - bookmarks: a table of the batch strings, then bookmarks with exact coordinates
+///   and indices of their strings;
+/// - tracks: names, styles and varint deltas of quantized points.
+/// A truncated record at the end (e.g. interrupted append) is skipped when the file is read.
+namespace bookmark_binary
+{
+struct BookmarkRecord
+{
+  BookmarkRecord() : m_scale(-1.0), m_timeStamp(-1) {}
+
+  m2::PointD m_org;
+  string m_name;
+  string m_description;
+  string m_type;
+  double m_scale;
+  time_t m_timeStamp;
+};
+
+struct TrackRecord
+{
+  TrackRecord() : m_color(0), m_width(0.0f) {}
+
+  string m_name;
+  /// ARGB.
+  uint32_t m_color;
+  float m_width;
+  vector<m2::PointD> m_points;
+};
+
+/// Gets the records of a file in the order they were written.
+class ICategoryBuilder
+{
+public:
+  virtual ~ICategoryBuilder() = default;
+
+  virtual void SetHeader(string const & name, bool isVisible) = 0;
+  virtual void AddBookmark(BookmarkRecord const & bookmark) = 0;
+  virtual void AddTrack(TrackRecord && track) = 0;
+};
+
+/// Quantization of the track points, it's about 4 cm at the equator.
+uint32_t const kCoordBits = 30;
+
+/// Must be written once at the beginning of the file.
+void WriteFileHeader(Writer & writer);
+void WriteHeader(Writer & writer, string const & name, bool isVisible);
+/// Bookmarks are added by the reader in the order of the vector.
+void WriteBookmarks(Writer & writer, vector<BookmarkRecord> const & bookmarks);
+void WriteTracks(Writer & writer, vector<TrackRecord> const & tracks);
+
+/// Reads the file data in place, e.g. the whole file read to memory.
+/// @param[out] recordsCount  Number of records in the file.
+/// @param[out] readSize      Size of the read records, it's less than |size|
+///                           when the last record is truncated.
+/// @return False when the file isn't a bookmarks binary file or it's malformed.
+bool ReadCategory(void const * data, size_t size, ICategoryBuilder & builder,
+                  size_t & recordsCount, size_t & readSize);
+
+/// Track point as it is after the writing and reading.
+m2::PointD QuantizePoint(m2::PointD const & pt);
+}  // namespace bookmark_binary
@@ -9,6 +9,8 @@
 #include "platform/platform.hpp"
 #include "platform/settings.hpp"
 
+#include "coding/file_name_utils.hpp"
+
 #include "indexer/scales.hpp"
 
 #include "geometry/transformations.hpp"
@@ -175,6 +177,12 @@ void BookmarkManager::LoadBookmarks()
   string const dir = GetPlatform().SettingsDir();
 
   Platform::FilesList files;
+  Platform::GetFilesByExt(dir, BOOKMARKS_BINARY_FILE_EXTENSION, files);
+  for (size_t i = 0; i < files.size(); ++i)
+    LoadBookmark(dir + files[i]);
+
+  // KML files are left by the older versions, they are converted on load.
+  files.clear();
   Platform::GetFilesByExt(dir, BOOKMARKS_FILE_EXTENSION, files);
   for (size_t i = 0; i < files.size(); ++i)
     LoadBookmark(dir + files[i]);
@@ -184,9 +192,14 @@ void BookmarkManager::LoadBookmarks()
 
 void BookmarkManager::LoadBookmark(string const & filePath)
 {
-  BookmarkCategory * cat = BookmarkCategory::CreateFromKMLFile(filePath, m_framework);
+  BookmarkCategory * cat = BookmarkCategory::CreateFromFile(filePath, m_framework);
   if (cat)
+  {
+    // Saving replaces an imported KML file with the binary one.
+    if (my::GetFileExtension(filePath) != BOOKMARKS_BINARY_FILE_EXTENSION)
+      cat->SaveToFile();
     m_categories.push_back(cat);
+  }
 }
 
 size_t BookmarkManager::AddBookmark(size_t categoryIndex, const m2::PointD & ptOrg, BookmarkData & bm)
@@ -197,7 +210,7 @@ size_t BookmarkManager::AddBookmark(size_t categoryIndex, const m2::PointD & ptO
   BookmarkCategory * pCat = m_categories[categoryIndex];
   Bookmark * bookmark = pCat->AddBookmark(ptOrg, bm);
   pCat->SetVisible(true);
-  pCat->SaveToKMLFile();
+  pCat->SaveToFile();
 
   m_lastCategoryUrl = pCat->GetFileName();
   m_lastType = bm.GetType();
@@ -210,12 +223,12 @@ size_t BookmarkManager::MoveBookmark(size_t bmIndex, size_t curCatIndex, size_t
 {
   BookmarkCategory * cat = m_framework.GetBmCategory(curCatIndex);
 
-  Bookmark * bm = cat->GetBookmark(bmIndex);
+  Bookmark const * bm = cat->GetBookmark(bmIndex);
   BookmarkData data = bm->GetData();
   m2::PointD ptOrg = bm->GetOrg();
 
   cat->DeleteBookmark(bmIndex);
-  cat->SaveToKMLFile();
+  cat->SaveToFile();
 
   return m_framework.AddBookmark(newCatIndex, ptOrg, data);
 }
@@ -224,7 +237,7 @@ void BookmarkManager::ReplaceBookmark(size_t catIndex, size_t bmIndex, BookmarkD
 {
   BookmarkCategory * pCat = m_categories[catIndex];
   pCat->ReplaceBookmark(bmIndex, bm);
-  pCat->SaveToKMLFile();
+  pCat->SaveToFile();
 
   m_lastType = bm.GetType();
   SaveState();
@@ -279,7 +292,7 @@ void BookmarkManager::DrawItems(Drawer * drawer) const
   {
     ASSERT(track, ());
     if (limitRect.IsIntersect(track->GetLimitRect()))
-      track->CreateDisplayList(m_bmScreen, matrix.GetScaleG2P(), matrix.IsScaleChanged(), drawScale, visualScale, matchingInfo);
+      track->CreateDisplayList(m_bmScreen, matrix.GetScaleG2P(), matrix.IsScaleChanged(), drawScale, visualScale, matchingInfo, limitRect);
     else
       track->CleanUp();
   };
@@ -40,6 +40,13 @@ class FeaturesFetcher : public Index::Observer
 
     void InitClassificator();
 
+    inline void SetInfoCache(unique_ptr<MwmInfoCache> && cache)
+    {
+      m_multiIndex.SetInfoCache(move(cache));
+    }
+
+    inline void SaveInfoCache() { m_multiIndex.SaveInfoCache(); }
+
     inline void SetOnMapDeregisteredCallback(TMapDeregisteredCallback const & callback)
     {
       m_onMapDeregistered = callback;
@@ -52,6 +52,8 @@
 #include "platform/preferred_languages.hpp"
 #include "platform/settings.hpp"
 
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
 #include "coding/internal/file_data.hpp"
 #include "coding/zip_reader.hpp"
 #include "coding/url_encode.hpp"
@@ -66,8 +68,10 @@
 #include "base/math.hpp"
 #include "base/timer.hpp"
 #include "base/scope_guard.hpp"
+#include "base/shared_buffer_manager.hpp"
 
 #include "std/algorithm.hpp"
+#include "std/sstream.hpp"
 #include "std/target_os.hpp"
 #include "std/vector.hpp"
 
@@ -100,6 +104,13 @@ namespace
   static const int BM_TOUCH_PIXEL_INCREASE = 20;
   static const int kKeepPedestrianDistanceMeters = 10000;
   char const kRouterTypeKey[] = "router";
+  // When it's set, search viewport caches are built in background for the restored viewport.
+  char const kWarmUpSearchKey[] = "WarmUpSearch";
+#ifdef OMIM_OS_ANDROID
+  // Routing data of the resident mwms are limited on Android, where the devices with 1 GB
+  // of memory are common.
+  uint64_t const kRoutingMemoryBudget = 256 * 1024 * 1024;
+#endif
 }
 
 pair<MwmSet::MwmId, MwmSet::RegResult> Framework::RegisterMap(
@@ -187,7 +198,8 @@ m2::PointD Framework::GetWidgetSize(InformationDisplay::WidgetType widget) const
 }
 
 Framework::Framework()
-  : m_navigator(m_scales),
+  : m_reverseGeocoder(m_model.GetIndex()),
+    m_navigator(m_scales),
     m_animator(this),
     m_queryMaxScaleMode(false),
     m_width(0),
@@ -243,20 +255,32 @@ Framework::Framework()
   m_informationDisplay.enableDebugPoints(true);
 #endif
 
+  // Durations of the startup phases, they are logged when the framework is created.
+  my::Timer phaseTimer;
+  ostringstream startupPhases;
+  auto const finishPhase = [&phaseTimer, &startupPhases](char const * phase)
+  {
+    startupPhases << ' ' << phase << ": " << phaseTimer.ElapsedSeconds();
+    phaseTimer.Reset();
+  };
+
   m_model.InitClassificator();
   m_model.SetOnMapDeregisteredCallback(bind(&Framework::OnMapDeregistered, this, _1));
-  LOG(LDEBUG, ("Classificator initialized"));
+  finishPhase("classificator");
 
   // To avoid possible races - init search engine once in constructor.
   (void)GetSearchEngine();
-  LOG(LDEBUG, ("Search engine initialized"));
+  finishPhase("search engine");
+
+  RegisterCaches();
 
+  m_model.SetInfoCache(make_unique<MwmInfoCache>(GetPlatform().WritablePathForFile(MWM_INFO_CACHE_FILE)));
   RegisterAllMaps();
-  LOG(LDEBUG, ("Maps initialized"));
+  finishPhase("maps");
 
   // Init storage with needed callback.
   m_storage.Init(bind(&Framework::UpdateLatestCountryFile, this, _1));
-  LOG(LDEBUG, ("Storage initialized"));
+  finishPhase("storage");
 
   auto const routingStatisticsFn = [](map<string, string> const & statistics)
   {
@@ -277,16 +301,22 @@ Framework::Framework()
   m_routingSession.Init(routingStatisticsFn, routingVisualizerFn);
 
   SetRouterImpl(RouterType::Vehicle);
+  finishPhase("routing");
 
-  LOG(LDEBUG, ("Routing engine initialized"));
+  LOG(LINFO, ("Startup phases, seconds:", startupPhases.str()));
 
   LOG(LINFO, ("System languages:", languages::GetPreferred()));
 }
 
 Framework::~Framework()
 {
+  for (CacheGovernor::TCacheId const id : m_governedCaches)
+    CacheGovernor::Instance().Unregister(id);
+
   delete m_benchmarkEngine;
   m_model.SetOnMapDeregisteredCallback(nullptr);
+
+  Settings::Flush();
 }
 
 void Framework::DrawSingleFrame(m2::PointD const & center, int zoomModifier,
@@ -447,12 +477,13 @@ void Framework::UpdateLatestCountryFile(LocalCountryFile const & localFile)
     return;
 
   // Add downloaded map.
+  // The old version of the map is used by the readers which hold its handles, and the search
+  // and the reverse geocoder caches see the new one by the epoch of the index, so nothing
+  // waits for them here.
   auto p = m_model.RegisterMap(localFile);
   MwmSet::MwmId const & id = p.first;
   if (id.IsAlive())
     InvalidateRect(id.GetInfo()->m_limitRect, true /* doForceUpdate */);
-
-  GetSearchEngine()->ClearViewportsCache();
 }
 
 void Framework::OnMapDeregistered(platform::LocalCountryFile const & localFile)
@@ -484,6 +515,7 @@ void Framework::RegisterAllMaps()
     minFormat = min(minFormat, static_cast<int>(id.GetInfo()->m_version.format));
   }
 
+  m_model.SaveInfoCache();
   m_countryTree.Init(maps);
 
   GetSearchEngine()->SupportOldFormat(minFormat < version::v3);
@@ -726,6 +758,16 @@ bool Framework::LoadState()
   if (!m_drapeEngine.IsNull())
     m_drapeEngine->UpdateCoverage(m_navigator.Screen());
 #endif
+
+  // The first search after the start mostly goes in the last viewport,
+  // so its features and localities are collected before the search is opened.
+  bool warmUpSearch = false;
+  if (Settings::Get(kWarmUpSearchKey, warmUpSearch) && warmUpSearch)
+  {
+    search::Engine * engine = GetSearchEngine();
+    if (engine)
+      engine->PrepareSearch(r);
+  }
   return true;
 }
 //@}
@@ -1003,12 +1045,46 @@ void Framework::ClearAllCaches()
 {
   m_model.ClearCaches();
   GetSearchEngine()->ClearAllCaches();
+  m_reverseGeocoder.ClearCache();
 }
 
-void Framework::MemoryWarning()
+void Framework::RegisterCaches()
 {
-  LOG(LINFO, ("MemoryWarning"));
-  ClearAllCaches();
+  CacheGovernor & governor = CacheGovernor::Instance();
+  // These caches can't be trimmed partially, so they are cleared on the big enough share.
+  m_governedCaches.push_back(governor.Register("MwmSet", CacheGovernor::NORMAL, nullptr,
+      [this](double share)
+      {
+        if (share >= 0.5)
+          m_model.ClearCaches();
+      }));
+  m_governedCaches.push_back(governor.Register("Search", CacheGovernor::NORMAL, nullptr,
+      [this](double share)
+      {
+        if (share >= 0.5 && m_pSearchEngine)
+          m_pSearchEngine->ClearAllCaches();
+      }));
+  m_governedCaches.push_back(governor.Register("ReverseGeocoder", CacheGovernor::LOW, nullptr,
+      [this](double share)
+      {
+        if (share >= 0.5)
+          m_reverseGeocoder.ClearCache();
+      }));
+  m_governedCaches.push_back(governor.Register("SharedBuffers", CacheGovernor::LOW,
+      []() { return SharedBufferManager::instance().GetStats().m_cachedSize; },
+      [](double share)
+      {
+        if (share >= 0.5)
+          SharedBufferManager::instance().ReleaseCached();
+      }));
+}
+
+void Framework::MemoryWarning(double share)
+{
+  CacheGovernor & governor = CacheGovernor::Instance();
+  LOG(LINFO, ("MemoryWarning", share, governor.GetReport()));
+  governor.Trim(share);
+  LOG(LINFO, ("Caches after trimming, bytes:", governor.GetTotalBytes()));
 }
 
 void Framework::EnterBackground()
@@ -1024,6 +1100,9 @@ void Framework::EnterBackground()
 #ifndef OMIM_OS_ANDROID
   ClearAllCaches();
 #endif
+
+  // The app may be killed in background.
+  Settings::Flush();
 }
 
 void Framework::EnterForeground()
@@ -1273,17 +1352,30 @@ void Framework::PrepareSearch()
 
 bool Framework::Search(search::SearchParams const & params)
 {
-#ifdef FIXED_LOCATION
   search::SearchParams rParams(params);
+#ifdef FIXED_LOCATION
   if (params.IsValidPosition())
   {
     m_fixedPos.GetLat(rParams.m_lat);
     m_fixedPos.GetLon(rParams.m_lon);
   }
-#else
-  search::SearchParams const & rParams = params;
 #endif
 
+  // Metadata is loaded on the search thread for every portion of the results, so UI
+  // gets it with the results instead of reading features one by one. Results of the
+  // previous portions are taken from the cache of the query.
+  if (params.m_callback)
+  {
+    search::SearchCallbackT const callback = params.m_callback;
+    auto const cache = make_shared<TSearchMetadataCache>();
+    rParams.m_callback = [this, callback, cache](search::Results const & results)
+    {
+      search::Results loaded(results);
+      LoadSearchResultsMetadata(loaded, *cache);
+      callback(loaded);
+    };
+  }
+
   return GetSearchEngine()->Search(rParams, GetCurrentViewport());
 }
 
@@ -1320,6 +1412,45 @@ void Framework::LoadSearchResultMetadata(search::Result & res) const
   res.m_metadata.m_isInitialized = true;
 }
 
+void Framework::LoadSearchResultsMetadata(search::Results & results,
+                                          TSearchMetadataCache & cache) const
+{
+  map<MwmSet::MwmId, vector<uint32_t>> toRead;
+  for (size_t i = 0; i < results.GetCount(); ++i)
+  {
+    search::Result const & res = results.GetResult(i);
+    if (res.m_metadata.m_isInitialized || res.GetResultType() != search::Result::RESULT_FEATURE)
+      continue;
+
+    FeatureID const id = res.GetFeatureID();
+    if (id.IsValid() && cache.count(id) == 0)
+      toRead[id.m_mwmId].push_back(id.m_index);
+  }
+
+  for (auto & mwm : toRead)
+  {
+    m_model.GetIndex().ReadFeatures(mwm.first, mwm.second, [&cache](FeatureType & ft)
+    {
+      search::Result::Metadata & meta = cache[ft.GetID()];
+      search::ProcessMetadata(ft, meta);
+      meta.m_isInitialized = true;
+    });
+  }
+
+  for (size_t i = 0; i < results.GetCount(); ++i)
+  {
+    search::Result & res = results.GetResult(i);
+    if (res.m_metadata.m_isInitialized || res.GetResultType() != search::Result::RESULT_FEATURE)
+      continue;
+
+    auto const it = cache.find(res.GetFeatureID());
+    if (it != cache.end())
+      res.m_metadata = it->second;
+    // Features of the deregistered mwms are left empty, as LoadSearchResultMetadata() does.
+    res.m_metadata.m_isInitialized = true;
+  }
+}
+
 void Framework::ShowSearchResult(search::Result const & res)
 {
   UserMarkContainer::Type const type = UserMarkContainer::SEARCH_MARK;
@@ -2127,6 +2258,7 @@ void Framework::BuildRoute(m2::PointD const & start, m2::PointD const & finish,
     if (code == IRouter::NoError)
     {
       InsertRoute(route);
+      SaveRoute(route);
       GetLocationState()->RouteBuilded();
       ShowRectExVisibleScale(route.GetPoly().GetLimitRect());
     }
@@ -2193,8 +2325,20 @@ void Framework::SetRouterImpl(RouterType type)
       return m_storage.GetLatestLocalFile(CountryFile(countryFile));
     };
 
-    router.reset(new OsrmRouter(&m_model.GetIndex(), countryFileGetter));
-    fetcher.reset(new OnlineAbsentCountriesFetcher(countryFileGetter, localFileGetter));
+    unique_ptr<OsrmRouter> osrmRouter(new OsrmRouter(&m_model.GetIndex(), countryFileGetter));
+    osrmRouter->SetRouteCacheFile(GetPlatform().WritablePathForFile(ROUTE_CACHE_FILE));
+#ifdef OMIM_OS_ANDROID
+    osrmRouter->SetMemoryBudget(kRoutingMemoryBudget);
+#endif
+    // The router and the fetcher are replaced together and are used on the same thread.
+    OsrmRouter * const osrm = osrmRouter.get();
+    auto estimateFn = [osrm](string const & startCountry, string const & finalCountry,
+                             vector<string> & countries)
+    {
+      return osrm->EstimateCrossMwmCountries(startCountry, finalCountry, countries);
+    };
+    router = move(osrmRouter);
+    fetcher.reset(new OnlineAbsentCountriesFetcher(countryFileGetter, localFileGetter, estimateFn));
     m_routingSession.SetRoutingSettings(routing::GetCarRoutingSettings());
   }
 
@@ -2228,6 +2372,67 @@ void Framework::CloseRouting()
   m_routingSession.Reset();
   RemoveRoute();
   Invalidate();
+
+  string const path = GetPlatform().WritablePathForFile(LAST_ROUTE_FILE);
+  if (Platform::IsFileExistsByFullPath(path))
+    my::DeleteFileX(path);
+}
+
+bool Framework::RestoreRoute()
+{
+  ASSERT_THREAD_CHECKER(m_threadChecker, ("RestoreRoute"));
+
+  if (IsRoutingActive())
+    return false;
+
+  string const path = GetPlatform().WritablePathForFile(LAST_ROUTE_FILE);
+  if (!Platform::IsFileExistsByFullPath(path))
+    return false;
+
+  vector<uint8_t> data;
+  try
+  {
+    FileReader reader(path);
+    data.resize(static_cast<size_t>(reader.Size()));
+    reader.Read(0, data.data(), data.size());
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LWARNING, ("Can't read the route:", e.Msg()));
+    return false;
+  }
+
+  Route route("");
+  if (!route.Deserialize(data) || !route.IsValid())
+    return false;
+
+  // The route is saved when it's built, so it's of the last used router.
+  string routerType;
+  Settings::Get(kRouterTypeKey, routerType);
+  SetRouter(routerType == routing::ToString(RouterType::Pedestrian) ? RouterType::Pedestrian
+                                                                     : RouterType::Vehicle);
+
+  // The copy shares the geometry and the turns with the route which goes to the session.
+  InsertRoute(route);
+  m2::RectD const rect = route.GetPoly().GetLimitRect();
+  m_routingSession.RestoreRoute(route);
+  GetLocationState()->RouteBuilded();
+  ShowRectExVisibleScale(rect);
+  CallRouteBuilded(IRouter::NoError, {}, {});
+  return true;
+}
+
+void Framework::SaveRoute(Route const & route)
+{
+  try
+  {
+    FileWriter writer(GetPlatform().WritablePathForFile(LAST_ROUTE_FILE));
+    route.Serialize(writer);
+  }
+  catch (Writer::Exception const & e)
+  {
+    LOG(LWARNING, ("Can't save the route:", e.Msg()));
+  }
 }
 
 void Framework::InsertRoute(Route const & route)
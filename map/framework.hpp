@@ -31,6 +31,7 @@
 #include "indexer/map_style.hpp"
 
 #include "search/query_saver.hpp"
+#include "search/reverse_geocoder.hpp"
 #include "search/search_engine.hpp"
 
 #include "storage/storage.hpp"
@@ -47,11 +48,13 @@
 #include "geometry/rect2d.hpp"
 #include "geometry/screenbase.hpp"
 
+#include "base/cache_governor.hpp"
 #include "base/macros.hpp"
 #include "base/strings_bundle.hpp"
 #include "base/thread_checker.hpp"
 
 #include "std/list.hpp"
+#include "std/map.hpp"
 #include "std/shared_ptr.hpp"
 #include "std/target_os.hpp"
 #include "std/unique_ptr.hpp"
@@ -109,6 +112,8 @@ protected:
   search::QuerySaver m_searchQuerySaver;
 
   model::FeaturesFetcher m_model;
+  /// Address lookup of the taps, it's only used on the UI thread.
+  mutable search::ReverseGeocoder m_reverseGeocoder;
   ScalesProcessor m_scales;
   Navigator m_navigator;
   Animator m_animator;
@@ -167,6 +172,10 @@ protected:
 
   void ClearAllCaches();
 
+  /// Caches which are trimmed by CacheGovernor on the memory warnings.
+  vector<CacheGovernor::TCacheId> m_governedCaches;
+  void RegisterCaches();
+
 public:
   Framework();
   virtual ~Framework();
@@ -340,6 +349,12 @@ public:
   bool GetCurrentPosition(double & lat, double & lon) const;
 
   void LoadSearchResultMetadata(search::Result & res) const;
+
+  /// Metadata of the already loaded results of a search query.
+  using TSearchMetadataCache = map<FeatureID, search::Result::Metadata>;
+  /// Loads metadata of all results at once: features of every mwm are read in the storage
+  /// order, and the results which are in |cache| aren't read again.
+  void LoadSearchResultsMetadata(search::Results & results, TSearchMetadataCache & cache) const;
   void ShowSearchResult(search::Result const & res);
 
   size_t ShowAllSearchResults(search::Results const & results);
@@ -462,7 +477,8 @@ public:
   /// - Check minimal visible scale according to downloaded countries.
   void ShowRectExVisibleScale(m2::RectD rect, int maxScale = -1);
 
-  void MemoryWarning();
+  /// @param share Part of the caches memory to free, from 0 to 1.
+  void MemoryWarning(double share = 1.0);
   void EnterBackground();
   void EnterForeground();
 
@@ -585,6 +601,11 @@ public:
   void SetRouteProgressListener(TRouteProgressCallback const & progressCallback) { m_progressCallback = progressCallback; }
   void FollowRoute();
   void CloseRouting();
+  /// Restores the route which was built before the restart of the app, it's dropped by
+  /// CloseRouting(). It's called instead of BuildRoute(), the route building listener is called
+  /// as for the built route.
+  /// @return False when there is no route to restore or the routing is active.
+  bool RestoreRoute();
   void GetRouteFollowingInfo(location::FollowingInfo & info) const { m_routingSession.GetRouteFollowingInfo(info); }
   m2::PointD GetRouteEndPoint() const { return m_routingSession.GetEndPoint(); }
   void SetLastUsedRouter(routing::RouterType type);
@@ -608,6 +629,7 @@ private:
   void SetRouterImpl(routing::RouterType type);
   void RemoveRoute();
   void InsertRoute(routing::Route const & route);
+  void SaveRoute(routing::Route const & route);
   void CheckLocationForRouting(location::GpsInfo const & info);
   void MatchLocationToRoute(location::GpsInfo & info, location::RouteMatchingInfo & routeMatchingInfo,
                             bool & hasDistanceFromBegin, double & distanceFromBegin) const;
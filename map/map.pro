@@ -20,6 +20,7 @@ HEADERS += \
     benchmark_engine.hpp \
     ruler.hpp \
     bookmark.hpp \
+    bookmark_binary.hpp \
     geourl_process.hpp \
     country_status_display.hpp \
     rotate_screen_task.hpp \
@@ -40,6 +41,8 @@ HEADERS += \
     country_tree.hpp \
     active_maps_layout.hpp \
     navigator_utils.hpp \
+    raster_tile_renderer.hpp \
+    marks_clusterer.hpp \
 
 SOURCES += \
     feature_vec_model.cpp \
@@ -53,6 +56,7 @@ SOURCES += \
     address_finder.cpp \
     geourl_process.cpp \
     bookmark.cpp \
+    bookmark_binary.cpp \
     country_status_display.cpp \
     rotate_screen_task.cpp \
     compass_arrow.cpp \
@@ -72,6 +76,8 @@ SOURCES += \
     country_tree.cpp \
     active_maps_layout.cpp \
     navigator_utils.cpp \
+    raster_tile_renderer.cpp \
+    marks_clusterer.cpp \
 
 !iphone*:!tizen*:!android* {
   HEADERS += qgl_render_context.hpp
@@ -0,0 +1,149 @@
+#include "testing/testing.hpp"
+
+#include "map/bookmark_binary.hpp"
+
+#include "coding/writer.hpp"
+
+#include "std/vector.hpp"
+
+using namespace bookmark_binary;
+
+namespace
+{
+class TestBuilder : public ICategoryBuilder
+{
+public:
+  // ICategoryBuilder overrides:
+  void SetHeader(string const & name, bool isVisible) override
+  {
+    m_name = name;
+    m_isVisible = isVisible;
+  }
+  void AddBookmark(BookmarkRecord const & bookmark) override { m_bookmarks.push_back(bookmark); }
+  void AddTrack(TrackRecord && track) override { m_tracks.push_back(move(track)); }
+
+  string m_name;
+  bool m_isVisible = false;
+  vector<BookmarkRecord> m_bookmarks;
+  vector<TrackRecord> m_tracks;
+};
+
+BookmarkRecord MakeBookmark(m2::PointD const & org, string const & name, string const & type)
+{
+  BookmarkRecord bm;
+  bm.m_org = org;
+  bm.m_name = name;
+  bm.m_type = type;
+  return bm;
+}
+
+void TestEqual(BookmarkRecord const & bm1, BookmarkRecord const & bm2)
+{
+  TEST_EQUAL(bm1.m_org, bm2.m_org, ());
+  TEST_EQUAL(bm1.m_name, bm2.m_name, ());
+  TEST_EQUAL(bm1.m_description, bm2.m_description, ());
+  TEST_EQUAL(bm1.m_type, bm2.m_type, ());
+  TEST_EQUAL(bm1.m_scale, bm2.m_scale, ());
+  TEST_EQUAL(bm1.m_timeStamp, bm2.m_timeStamp, ());
+}
+
+vector<char> MakeFile(vector<BookmarkRecord> const & bookmarks, vector<TrackRecord> const & tracks)
+{
+  vector<char> buffer;
+  MemWriter<vector<char>> writer(buffer);
+  WriteFileHeader(writer);
+  WriteHeader(writer, "Category", true);
+  WriteBookmarks(writer, bookmarks);
+  WriteTracks(writer, tracks);
+  return buffer;
+}
+}  // namespace
+
+UNIT_TEST(BookmarkBinary_Smoke)
+{
+  vector<BookmarkRecord> bookmarks;
+  bookmarks.push_back(MakeBookmark(m2::PointD(27.5, 64.1), "Home", "placemark-red"));
+  bookmarks.push_back(MakeBookmark(m2::PointD(-179.9, 0.123456789), "Work", "placemark-red"));
+  bookmarks.back().m_description = "<b>Office</b>";
+  bookmarks.back().m_scale = 17.5;
+  bookmarks.back().m_timeStamp = 1440000000;
+  bookmarks.push_back(MakeBookmark(m2::PointD(180, -180), "", "placemark-blue"));
+
+  vector<TrackRecord> tracks(1);
+  tracks[0].m_name = "Track";
+  tracks[0].m_color = 0xFF33CCFF;
+  tracks[0].m_width = 5.0f;
+  tracks[0].m_points = { m2::PointD(1, 2), m2::PointD(1.000001, 2.000001), m2::PointD(-100, 50) };
+
+  vector<char> const buffer = MakeFile(bookmarks, tracks);
+
+  TestBuilder builder;
+  size_t recordsCount, readSize;
+  TEST(ReadCategory(buffer.data(), buffer.size(), builder, recordsCount, readSize), ());
+  TEST_EQUAL(recordsCount, 3, ());
+  TEST_EQUAL(readSize, buffer.size(), ());
+  TEST_EQUAL(builder.m_name, "Category", ());
+  TEST(builder.m_isVisible, ());
+
+  TEST_EQUAL(builder.m_bookmarks.size(), bookmarks.size(), ());
+  for (size_t i = 0; i < bookmarks.size(); ++i)
+    TestEqual(builder.m_bookmarks[i], bookmarks[i]);
+
+  TEST_EQUAL(builder.m_tracks.size(), 1, ());
+  TrackRecord const & track = builder.m_tracks[0];
+  TEST_EQUAL(track.m_name, "Track", ());
+  TEST_EQUAL(track.m_color, 0xFF33CCFF, ());
+  TEST_EQUAL(track.m_width, 5.0f, ());
+  TEST_EQUAL(track.m_points.size(), tracks[0].m_points.size(), ());
+  for (size_t i = 0; i < track.m_points.size(); ++i)
+    TEST_EQUAL(track.m_points[i], QuantizePoint(tracks[0].m_points[i]), ());
+}
+
+UNIT_TEST(BookmarkBinary_Append)
+{
+  vector<char> buffer = MakeFile({ MakeBookmark(m2::PointD(1, 1), "First", "placemark-red") }, {});
+  {
+    MemWriter<vector<char>> writer(buffer);
+    writer.Seek(buffer.size());
+    WriteBookmarks(writer, { MakeBookmark(m2::PointD(2, 2), "Second", "placemark-red") });
+    WriteHeader(writer, "Renamed", false);
+  }
+
+  TestBuilder builder;
+  size_t recordsCount, readSize;
+  TEST(ReadCategory(buffer.data(), buffer.size(), builder, recordsCount, readSize), ());
+  TEST_EQUAL(recordsCount, 5, ());
+  TEST_EQUAL(builder.m_name, "Renamed", ());
+  TEST(!builder.m_isVisible, ());
+  TEST_EQUAL(builder.m_bookmarks.size(), 2, ());
+  TEST_EQUAL(builder.m_bookmarks[0].m_name, "First", ());
+  TEST_EQUAL(builder.m_bookmarks[1].m_name, "Second", ());
+}
+
+UNIT_TEST(BookmarkBinary_Truncated)
+{
+  vector<char> buffer = MakeFile({ MakeBookmark(m2::PointD(1, 1), "First", "placemark-red") }, {});
+  size_t const size = buffer.size();
+  {
+    MemWriter<vector<char>> writer(buffer);
+    writer.Seek(size);
+    WriteBookmarks(writer, { MakeBookmark(m2::PointD(2, 2), "Second", "placemark-red") });
+  }
+
+  // Interrupted append.
+  for (size_t i = size + 1; i < buffer.size(); ++i)
+  {
+    TestBuilder builder;
+    size_t recordsCount, readSize;
+    TEST(ReadCategory(buffer.data(), i, builder, recordsCount, readSize), (i));
+    TEST_EQUAL(recordsCount, 3, ());
+    TEST_EQUAL(readSize, size, ());
+    TEST_EQUAL(builder.m_bookmarks.size(), 1, ());
+  }
+
+  TestBuilder builder;
+  size_t recordsCount, readSize;
+  TEST(!ReadCategory(buffer.data(), 3, builder, recordsCount, readSize), ());
+  buffer[0] = 'X';
+  TEST(!ReadCategory(buffer.data(), buffer.size(), builder, recordsCount, readSize), ());
+}
@@ -11,6 +11,7 @@
 
 #include "graphics/color.hpp"
 
+#include "coding/file_name_utils.hpp"
 #include "coding/internal/file_data.hpp"
 
 #include "std/fstream.hpp"
@@ -192,17 +193,17 @@ UNIT_TEST(Bookmarks_ExportKML)
   CheckBookmarks(cat);
   TEST_EQUAL(cat.IsVisible(), true, ());
 
-  unique_ptr<BookmarkCategory> cat2(BookmarkCategory::CreateFromKMLFile(BOOKMARKS_FILE_NAME, framework));
+  unique_ptr<BookmarkCategory> cat2(BookmarkCategory::CreateFromFile(BOOKMARKS_FILE_NAME, framework));
   CheckBookmarks(*cat2);
 
-  TEST(cat2->SaveToKMLFile(), ());
+  TEST(cat2->SaveToFile(), ());
   // old file should be deleted if we save bookmarks with new category name
   uint64_t dummy;
   TEST(!my::GetFileSize(BOOKMARKS_FILE_NAME, dummy), ());
 
   // MapName is the <name> tag in test kml data.
-  string const catFileName = GetPlatform().SettingsDir() + "MapName.kml";
-  cat2.reset(BookmarkCategory::CreateFromKMLFile(catFileName, framework));
+  string const catFileName = GetPlatform().SettingsDir() + "MapName" BOOKMARKS_BINARY_FILE_EXTENSION;
+  cat2.reset(BookmarkCategory::CreateFromFile(catFileName, framework));
   CheckBookmarks(*cat2);
   TEST(my::DeleteFileX(catFileName), ());
 }
@@ -213,7 +214,7 @@ namespace
   {
     string const path = GetPlatform().SettingsDir();
     for (size_t i = 0; i < N; ++i)
-      FileWriter::DeleteFileX(path + arrFiles[i] + BOOKMARKS_FILE_EXTENSION);
+      FileWriter::DeleteFileX(path + arrFiles[i] + BOOKMARKS_BINARY_FILE_EXTENSION);
   }
 
   UserMark const * GetMark(Framework & fm, m2::PointD const & pt)
@@ -560,10 +561,10 @@ UNIT_TEST(BookmarkCategory_EmptyName)
   Framework framework;
   unique_ptr<BookmarkCategory> pCat(new BookmarkCategory("", framework));
   TEST(pCat->AddBookmark(m2::PointD(0, 0), BookmarkData("", "placemark-red")), ());
-  TEST(pCat->SaveToKMLFile(), ());
+  TEST(pCat->SaveToFile(), ());
 
   pCat->SetName("xxx");
-  TEST(pCat->SaveToKMLFile(), ());
+  TEST(pCat->SaveToFile(), ());
 
   char const * arrFiles[] = { "Bookmarks", "xxx" };
   DeleteCategoryFiles(arrFiles);
@@ -612,9 +613,9 @@ UNIT_TEST(Bookmarks_SpecialXMLNames)
   TEST(cat1.LoadFromKML(new MemReader(kmlString3, strlen(kmlString3))), ());
 
   TEST_EQUAL(cat1.GetBookmarksCount(), 1, ());
-  TEST(cat1.SaveToKMLFile(), ());
+  TEST(cat1.SaveToFile(), ());
 
-  unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromKMLFile(cat1.GetFileName(), framework));
+  unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromFile(cat1.GetFileName(), framework));
   TEST(cat2.get(), ());
   TEST_EQUAL(cat2->GetBookmarksCount(), 1, ());
 
@@ -631,7 +632,7 @@ UNIT_TEST(TrackParsingTest_1)
 {
   Framework framework;
   string const kmlFile = GetPlatform().TestsDataPathForFile("kml-with-track-kml.test");
-  BookmarkCategory * cat = BookmarkCategory::CreateFromKMLFile(kmlFile, framework);
+  BookmarkCategory * cat = BookmarkCategory::CreateFromFile(kmlFile, framework);
   TEST(cat, ("Category can't be created"));
 
   TEST_EQUAL(cat->GetTracksCount(), 4, ());
@@ -656,7 +657,7 @@ UNIT_TEST(TrackParsingTest_2)
 {
   Framework framework;
   string const kmlFile = GetPlatform().TestsDataPathForFile("kml-with-track-from-google-earth.test");
-  BookmarkCategory * cat = BookmarkCategory::CreateFromKMLFile(kmlFile, framework);
+  BookmarkCategory * cat = BookmarkCategory::CreateFromFile(kmlFile, framework);
   TEST(cat, ("Category can't be created"));
 
   TEST_EQUAL(cat->GetTracksCount(), 1, ());
@@ -665,3 +666,93 @@ UNIT_TEST(TrackParsingTest_2)
   TEST_EQUAL(track->GetMainColor(), graphics::Color(57, 255, 32, 255), ());
 }
 
+
+UNIT_TEST(Bookmarks_BinaryFile)
+{
+  Framework framework;
+  BookmarkCategory cat("Binary Bookmarks Test", framework);
+  cat.AddBookmark(m2::PointD(10, 20), BookmarkData("first", "placemark-red", "desc", 15.0, 888888888));
+  TEST(cat.SaveToFile(), ());
+
+  string const file = cat.GetFileName();
+  TEST_EQUAL(my::GetFileExtension(file), BOOKMARKS_BINARY_FILE_EXTENSION, ());
+  uint64_t size1;
+  TEST(my::GetFileSize(file, size1), ());
+
+  // New bookmarks and tracks are appended to the file.
+  cat.AddBookmark(m2::PointD(30, 40), BookmarkData("second", "placemark-blue"));
+  vector<m2::PointD> const points = { m2::PointD(0, 0), m2::PointD(1.5, 2.5), m2::PointD(-3, 4) };
+  Track track((Track::PolylineD(points)));
+  track.SetName("track");
+  Track::TrackOutline outline { 5.0f, graphics::Color(10, 20, 30, 255) };
+  track.AddOutline(&outline, 1);
+  cat.AddTrack(track);
+  cat.SetVisible(false);
+  TEST(cat.SaveToFile(), ());
+
+  uint64_t size2;
+  TEST(my::GetFileSize(file, size2), ());
+  TEST_GREATER(size2, size1, ());
+
+  {
+    unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromFile(file, framework));
+    TEST(cat2.get(), ());
+    TEST_EQUAL(cat2->GetName(), cat.GetName(), ());
+    TEST(!cat2->IsVisible(), ());
+    TEST_EQUAL(cat2->GetBookmarksCount(), 2, ());
+    TEST(EqualBookmarks(*cat2->GetBookmark(0), *cat.GetBookmark(0)), ());
+    TEST(EqualBookmarks(*cat2->GetBookmark(1), *cat.GetBookmark(1)), ());
+    TEST_EQUAL(cat2->GetBookmark(1)->GetTimeStamp(), 888888888, ());
+    TEST_EQUAL(cat2->GetBookmark(0)->GetTimeStamp(), my::INVALID_TIME_STAMP, ());
+
+    TEST_EQUAL(cat2->GetTracksCount(), 1, ());
+    Track const * track2 = cat2->GetTrack(0);
+    TEST_EQUAL(track2->GetName(), "track", ());
+    TEST_EQUAL(track2->GetMainColor(), graphics::Color(10, 20, 30, 255), ());
+    TEST_EQUAL(track2->GetMainWidth(), 5.0f, ());
+    TEST_EQUAL(track2->GetPolyline().GetSize(), points.size(), ());
+  }
+
+  // Reading doesn't change the file.
+  TEST(cat.GetBookmark(0), ());
+  TEST(cat.SaveToFile(), ());
+  uint64_t size3;
+  TEST(my::GetFileSize(file, size3), ());
+  TEST_EQUAL(size3, size2, ());
+
+  // Edits rewrite the file.
+  BookmarkData data = cat.GetBookmark(1)->GetData();
+  data.SetName("renamed");
+  cat.ReplaceBookmark(1, data);
+  TEST(cat.SaveToFile(), ());
+  {
+    unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromFile(file, framework));
+    TEST(cat2.get(), ());
+    TEST_EQUAL(cat2->GetBookmarksCount(), 2, ());
+    TEST_EQUAL(cat2->GetBookmark(1)->GetName(), "renamed", ());
+  }
+
+  // Deletion rewrites the file.
+  cat.DeleteBookmark(0);
+  TEST(cat.SaveToFile(), ());
+  {
+    unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromFile(file, framework));
+    TEST(cat2.get(), ());
+    TEST_EQUAL(cat2->GetBookmarksCount(), 1, ());
+    TEST_EQUAL(cat2->GetBookmark(0)->GetName(), "first", ());
+    TEST_EQUAL(cat2->GetTracksCount(), 1, ());
+  }
+
+  // Sharing uses KML.
+  string const kmlFile = GetPlatform().WritableDir() + "BinaryBookmarksTest" BOOKMARKS_FILE_EXTENSION;
+  TEST(cat.ExportToKMLFile(kmlFile), ());
+  {
+    unique_ptr<BookmarkCategory> const cat2(BookmarkCategory::CreateFromFile(kmlFile, framework));
+    TEST(cat2.get(), ());
+    TEST_EQUAL(cat2->GetBookmarksCount(), 1, ());
+    TEST_EQUAL(cat2->GetTracksCount(), 1, ());
+  }
+
+  TEST(my::DeleteFileX(kmlFile), ());
+  TEST(my::DeleteFileX(file), ());
+}
@@ -30,10 +30,12 @@ macx-*: LIBS *= "-framework IOKit" "-framework SystemConfiguration"
 
 SOURCES += \
   ../../testing/testingmain.cpp \
+  bookmark_binary_test.cpp \
   bookmarks_test.cpp \
   ge0_parser_tests.cpp  \
   geourl_test.cpp \
   kmz_unarchive_test.cpp \
+  marks_clusterer_test.cpp \
   mwm_url_tests.cpp \
   navigator_test.cpp \
   mwm_set_test.cpp \
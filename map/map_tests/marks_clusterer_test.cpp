@@ -0,0 +1,102 @@
+#include "testing/testing.hpp"
+
+#include "map/marks_clusterer.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "std/chrono.hpp"
+#include "std/condition_variable.hpp"
+#include "std/mutex.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+double const kCellSizePx = 32.0;
+int const kUpperScale = 15;
+
+vector<MarksClusters::Cluster> GetClusters(MarksClusters const & clusters, int scale,
+                                           m2::RectD const & rect)
+{
+  vector<MarksClusters::Cluster> res;
+  clusters.ForEachInRect(scale, rect, [&res](MarksClusters::Cluster const & c)
+  {
+    res.push_back(c);
+  });
+  return res;
+}
+}  // namespace
+
+UNIT_TEST(MarksClusters_Levels)
+{
+  // Cell is 32 / 256 of the world width on the scale 0 and is halved on each next scale.
+  double const cell = (MercatorBounds::maxX - MercatorBounds::minX) / 8.0 / (1 << kUpperScale);
+
+  vector<m2::PointD> points;
+  // Two groups of points which are in the different cells on the upper scale.
+  for (size_t i = 0; i < 10; ++i)
+    points.emplace_back(0.1 * cell + i * 0.01 * cell, 0.5 * cell);
+  for (size_t i = 0; i < 5; ++i)
+    points.emplace_back(1.5 * cell, 0.5 * cell + i * 0.01 * cell);
+
+  MarksClusters const clusters(points, kCellSizePx, kUpperScale);
+  TEST_EQUAL(clusters.GetUpperScale(), kUpperScale, ());
+  TEST_EQUAL(clusters.GetPointsCount(), points.size(), ());
+
+  TEST_EQUAL(clusters.GetClustersCount(kUpperScale), 2, ());
+  TEST_EQUAL(clusters.GetClustersCount(kUpperScale - 1), 1, ());
+  TEST_EQUAL(clusters.GetClustersCount(0), 1, ());
+
+  m2::RectD const all(-cell, -cell, 2 * cell, 2 * cell);
+  vector<MarksClusters::Cluster> upper = GetClusters(clusters, kUpperScale, all);
+  TEST_EQUAL(upper.size(), 2, ());
+  uint32_t count = 0;
+  for (auto const & c : upper)
+  {
+    // The first point of a cell is its representative.
+    TEST(c.m_index == 0 || c.m_index == 10, (c.m_index));
+    TEST_EQUAL(c.m_org, points[c.m_index], ());
+    TEST_EQUAL(c.m_count, c.m_index == 0 ? 10 : 5, ());
+    count += c.m_count;
+  }
+  TEST_EQUAL(count, points.size(), ());
+
+  vector<MarksClusters::Cluster> const lower = GetClusters(clusters, 0, all);
+  TEST_EQUAL(lower.size(), 1, ());
+  TEST_EQUAL(lower[0].m_index, 0, ());
+  TEST_EQUAL(lower[0].m_count, points.size(), ());
+
+  // The clusters out of the rect are skipped.
+  TEST_EQUAL(GetClusters(clusters, kUpperScale, m2::RectD(cell, 0, 2 * cell, cell)).size(), 1, ());
+  TEST(GetClusters(clusters, kUpperScale, m2::RectD(5 * cell, 5 * cell, 6 * cell, 6 * cell)).empty(),
+       ());
+}
+
+UNIT_TEST(MarksClusterer_Update)
+{
+  MarksClusterer clusterer(kUpperScale);
+  TEST(!clusterer.GetClusters(), ());
+
+  mutex mu;
+  condition_variable cv;
+  bool ready = false;
+  clusterer.Update({m2::PointD(0, 0), m2::PointD(10, 10)}, kCellSizePx, [&]()
+  {
+    lock_guard<mutex> lock(mu);
+    ready = true;
+    cv.notify_all();
+  });
+  {
+    unique_lock<mutex> lock(mu);
+    TEST(cv.wait_for(lock, seconds(10), [&ready]() { return ready; }), ());
+  }
+
+  auto clusters = clusterer.GetClusters();
+  TEST(clusters, ());
+  TEST_EQUAL(clusters->GetPointsCount(), 2, ());
+  TEST_EQUAL(clusters->GetClustersCount(kUpperScale), 2, ());
+
+  clusterer.Reset();
+  TEST(!clusterer.GetClusters(), ());
+  // The reset doesn't affect the clusters which are in use.
+  TEST_EQUAL(clusters->GetPointsCount(), 2, ());
+}
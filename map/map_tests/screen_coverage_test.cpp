@@ -155,7 +155,7 @@ void ScreenCoverageTestImpl(int executorsNum)
   erasedRects.push_back(Tiler::RectInfo(8, 8, 9, 42));
 
   for (unsigned i = 0; i < erasedRects.size(); ++i)
-    CHECK(tileCache->lockCount(erasedRects[i]) == 0, ());
+    CHECK(tileCache->PinCount(erasedRects[i]) == 0, ());
 
   /// checking, that tiles in coverage are present and locked
 
@@ -166,7 +166,7 @@ void ScreenCoverageTestImpl(int executorsNum)
   coveredRects.push_back(Tiler::RectInfo(8, 8, 10, 42));
 
   for (unsigned i = 0; i < coveredRects.size(); ++i)
-    CHECK(tileCache->lockCount(coveredRects[i]) > 0, (coveredRects[i].m_x, coveredRects[i].m_y, coveredRects[i].m_tileScale, coveredRects[i].m_drawScale, coveredRects[i].toUInt64Cell()));
+    CHECK(tileCache->PinCount(coveredRects[i]) > 0, (coveredRects[i].m_x, coveredRects[i].m_y, coveredRects[i].m_tileScale, coveredRects[i].m_drawScale, coveredRects[i].toUInt64Cell()));
 
   gen.AddCoverScreenTask(screen2);
   gen.WaitForEmptyAndFinished();
@@ -174,7 +174,7 @@ void ScreenCoverageTestImpl(int executorsNum)
   gen.WaitForEmptyAndFinished();
 
   for (unsigned i = 0; i < coveredRects.size(); ++i)
-    CHECK(tileCache->lockCount(coveredRects[i]) == 0, (coveredRects[i].m_x, coveredRects[i].m_y, coveredRects[i].m_tileScale, coveredRects[i].m_drawScale, coveredRects[i].toUInt64Cell()));
+    CHECK(tileCache->PinCount(coveredRects[i]) == 0, (coveredRects[i].m_x, coveredRects[i].m_y, coveredRects[i].m_tileScale, coveredRects[i].m_drawScale, coveredRects[i].toUInt64Cell()));
 
   coveredRects.clear();
 
@@ -183,7 +183,7 @@ void ScreenCoverageTestImpl(int executorsNum)
   coveredRects.push_back(Tiler::RectInfo(8, 8, 11, 42));
 
   for (unsigned i = 0; i < coveredRects.size(); ++i)
-    CHECK(tileCache->lockCount(coveredRects[i]) == 0, (coveredRects[i].m_x, coveredRects[i].m_y, coveredRects[i].m_tileScale, coveredRects[i].m_drawScale, coveredRects[i].toUInt64Cell()));
+    CHECK(tileCache->PinCount(coveredRects[i]) == 0, (coveredRects[i].m_x, coveredRects[i].m_y, coveredRects[i].m_tileScale, coveredRects[i].m_drawScale, coveredRects[i].toUInt64Cell()));
 
   gen.AddCoverScreenTask(screen3);
   gen.WaitForEmptyAndFinished();
@@ -0,0 +1,126 @@
+#include "map/marks_clusterer.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "platform/platform.hpp"
+
+#include "base/logging.hpp"
+
+#include "std/cmath.hpp"
+#include "std/unordered_map.hpp"
+#include "std/utility.hpp"
+
+namespace
+{
+// Tile size the draw scales are counted in, see scales::GetEpsilonForLevel.
+double constexpr kTileSizePx = 256.0;
+
+int64_t GetCellKey(m2::PointD const & pt, double cellSize)
+{
+  int64_t const x = static_cast<int64_t>(floor((pt.x - MercatorBounds::minX) / cellSize));
+  int64_t const y = static_cast<int64_t>(floor((pt.y - MercatorBounds::minY) / cellSize));
+  return (y << 32) | (x & 0xFFFFFFFF);
+}
+}  // namespace
+
+MarksClusters::MarksClusters(vector<m2::PointD> const & points, double cellSizePx, int upperScale)
+  : m_levels(upperScale + 1), m_pointsCount(points.size())
+{
+  ASSERT_GREATER_OR_EQUAL(upperScale, 0, ());
+
+  vector<Cluster> next;
+  next.reserve(points.size());
+  for (uint32_t i = 0; i < points.size(); ++i)
+    next.push_back({points[i], i, 1});
+
+  for (int scale = upperScale; scale >= 0; --scale)
+  {
+    double const cellSize = (MercatorBounds::maxX - MercatorBounds::minX) * cellSizePx /
+                            (kTileSizePx * pow(2.0, scale));
+
+    // The clusters of the next scale go in the order of their representatives, so the
+    // representative of a cell is the first point in it.
+    Level & level = m_levels[scale];
+    unordered_map<int64_t, uint32_t> cells;
+    for (Cluster const & c : next)
+    {
+      auto const res = cells.emplace(GetCellKey(c.m_org, cellSize),
+                                     static_cast<uint32_t>(level.m_clusters.size()));
+      if (res.second)
+        level.m_clusters.push_back(c);
+      else
+        level.m_clusters[res.first->second].m_count += c.m_count;
+    }
+
+    for (uint32_t i = 0; i < level.m_clusters.size(); ++i)
+    {
+      m2::PointD const & org = level.m_clusters[i].m_org;
+      level.m_tree.Add(i, m2::RectD(org, org));
+    }
+    level.m_tree.Optimize();
+
+    next = level.m_clusters;
+  }
+}
+
+size_t MarksClusters::GetClustersCount(int scale) const
+{
+  return m_levels[scale].m_clusters.size();
+}
+
+MarksClusterer::MarksClusterer(int upperScale)
+  : m_upperScale(upperScale), m_state(make_shared<State>())
+{
+}
+
+MarksClusterer::~MarksClusterer()
+{
+  // The building task keeps the state alive and discards its result.
+  Reset();
+}
+
+void MarksClusterer::Update(vector<m2::PointD> && points, double cellSizePx,
+                            function<void()> const & onReady)
+{
+  uint64_t generation;
+  {
+    lock_guard<mutex> lock(m_state->m_mutex);
+    generation = ++m_state->m_generation;
+  }
+
+  shared_ptr<State> state = m_state;
+  int const upperScale = m_upperScale;
+  auto const pointsPtr = make_shared<vector<m2::PointD>>(move(points));
+  GetPlatform().RunAsync([state, generation, cellSizePx, upperScale, pointsPtr, onReady]()
+  {
+    {
+      lock_guard<mutex> lock(state->m_mutex);
+      if (state->m_generation != generation)
+        return;
+    }
+
+    auto clusters = make_shared<MarksClusters const>(*pointsPtr, cellSizePx, upperScale);
+
+    {
+      lock_guard<mutex> lock(state->m_mutex);
+      if (state->m_generation != generation)
+        return;
+      state->m_clusters = clusters;
+    }
+    if (onReady)
+      onReady();
+  }, Platform::EPriorityBackground);
+}
+
+void MarksClusterer::Reset()
+{
+  lock_guard<mutex> lock(m_state->m_mutex);
+  ++m_state->m_generation;
+  m_state->m_clusters.reset();
+}
+
+shared_ptr<MarksClusters const> MarksClusterer::GetClusters() const
+{
+  lock_guard<mutex> lock(m_state->m_mutex);
+  return m_state->m_clusters;
+}
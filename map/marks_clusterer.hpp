@@ -0,0 +1,95 @@
+#pragma once
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "base/macros.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/function.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/vector.hpp"
+
+/// Grid clusters of the points for the draw scales [0, upperScale]. The grid of a scale is fixed
+/// in the mercator coordinates, so panning doesn't change the clusters, and the clusters of a scale
+/// are built from the clusters of the next scale, so zooming only switches the levels.
+class MarksClusters
+{
+public:
+  struct Cluster
+  {
+    m2::PointD m_org;
+    /// Index of the representative point, it's the first point of the cluster.
+    uint32_t m_index;
+    uint32_t m_count;
+  };
+
+  /// @param cellSizePx Size of the grid cell in pixels on the screen.
+  MarksClusters(vector<m2::PointD> const & points, double cellSizePx, int upperScale);
+
+  /// On the scales above the upper one all the points are drawn.
+  inline int GetUpperScale() const { return static_cast<int>(m_levels.size()) - 1; }
+  inline size_t GetPointsCount() const { return m_pointsCount; }
+
+  size_t GetClustersCount(int scale) const;
+
+  template <class ToDo>
+  void ForEachInRect(int scale, m2::RectD const & rect, ToDo && toDo) const
+  {
+    Level const & level = m_levels[scale];
+    level.m_tree.ForEachInRect(rect, [&](uint32_t i)
+    {
+      Cluster const & cluster = level.m_clusters[i];
+      // Tree checks strict intersection, so clusters on the border are checked here.
+      if (rect.IsPointInside(cluster.m_org))
+        toDo(cluster);
+    });
+  }
+
+private:
+  struct Level
+  {
+    vector<Cluster> m_clusters;
+    m4::Tree<uint32_t> m_tree;
+  };
+
+  vector<Level> m_levels;
+  size_t m_pointsCount;
+
+  DISALLOW_COPY_AND_MOVE(MarksClusters);
+};
+
+/// Builds MarksClusters of the marks on a background thread. The clusters of the previous marks
+/// are kept until the new ones are ready, unless they are reset.
+class MarksClusterer
+{
+public:
+  explicit MarksClusterer(int upperScale);
+  ~MarksClusterer();
+
+  /// Starts building the clusters of the points, onReady is called on the building thread
+  /// when they replace the current ones. Results of the previous calls are discarded.
+  /// @param cellSizePx See MarksClusters.
+  void Update(vector<m2::PointD> && points, double cellSizePx, function<void()> const & onReady);
+
+  /// Drops the current clusters, e.g. when the marks they refer to are deleted.
+  void Reset();
+
+  /// @return Clusters, or nullptr if they are not built yet.
+  shared_ptr<MarksClusters const> GetClusters() const;
+
+private:
+  struct State
+  {
+    mutex m_mutex;
+    uint64_t m_generation = 0;
+    shared_ptr<MarksClusters const> m_clusters;
+  };
+
+  int const m_upperScale;
+  shared_ptr<State> m_state;
+
+  DISALLOW_COPY_AND_MOVE(MarksClusterer);
+};
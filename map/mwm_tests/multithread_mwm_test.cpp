@@ -4,6 +4,7 @@
 
 #include "indexer/scales.hpp"
 
+#include "base/logging.hpp"
 #include "base/macros.hpp"
 #include "base/thread.hpp"
 
@@ -83,6 +84,9 @@ namespace
       pool.Add(make_unique<FeaturesLoader>(src));
 
     pool.Join();
+
+    LOG(LINFO, ("Registry lock:", src.GetIndex().GetRegistryLockStats()));
+    LOG(LINFO, ("Cache lock:", src.GetIndex().GetCacheLockStats()));
   }
 }
 
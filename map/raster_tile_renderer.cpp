@@ -0,0 +1,123 @@
+#include "map/raster_tile_renderer.hpp"
+
+#ifndef USE_DRAPE
+#include "map/feature_vec_model.hpp"
+
+#include "render/cpu_drawer.hpp"
+#include "render/events.hpp"
+#include "render/feature_processor.hpp"
+#include "render/proto_to_styles.hpp"
+#include "render/render_policy.hpp"
+
+#include "indexer/drawing_rules.hpp"
+#include "indexer/mercator.hpp"
+#include "indexer/scales.hpp"
+
+#include "geometry/any_rect2d.hpp"
+#include "geometry/screenbase.hpp"
+
+#include "base/assert.hpp"
+#include "base/math.hpp"
+
+#include "std/shared_ptr.hpp"
+#include "std/sstream.hpp"
+
+namespace
+{
+
+// Size of the tile on the density with the visual scale 1.
+uint32_t const kBaseTileSize = 256;
+
+} // namespace
+
+string DebugPrint(RasterTileKey const & key)
+{
+  ostringstream out;
+  out << "RasterTileKey [ " << key.m_zoom << ", " << key.m_x << ", " << key.m_y << " ]";
+  return out.str();
+}
+
+RasterTileRenderer::RasterTileRenderer(model::FeaturesFetcher const & model, graphics::EDensity density,
+                                       size_t drawersCount)
+  : m_model(model)
+{
+  ASSERT_GREATER(drawersCount, 0, ());
+  double const visualScale = graphics::visualScale(density);
+  m_tileSize = static_cast<uint32_t>(my::rounds(kBaseTileSize * visualScale));
+  m_scales.SetParams(visualScale, m_tileSize);
+
+  for (size_t i = 0; i < drawersCount; ++i)
+  {
+    CPUDrawer::Params params(GetGlyphCacheParams(density));
+    params.m_visualScale = visualScale;
+    params.m_density = density;
+    m_drawers.emplace_back(new CPUDrawer(params));
+    m_freeDrawers.push_back(m_drawers.back().get());
+  }
+}
+
+RasterTileRenderer::~RasterTileRenderer()
+{
+  threads::ConditionGuard guard(m_drawersCondition);
+  ASSERT_EQUAL(m_freeDrawers.size(), m_drawers.size(), ("Tiles are rendered yet"));
+}
+
+// static
+m2::RectD RasterTileRenderer::GetTileRect(RasterTileKey const & key)
+{
+  ASSERT_GREATER_OR_EQUAL(key.m_zoom, 0, ());
+  double const size = (MercatorBounds::maxX - MercatorBounds::minX) / (1 << key.m_zoom);
+  double const minX = MercatorBounds::minX + key.m_x * size;
+  double const maxY = MercatorBounds::maxY - key.m_y * size;
+  return m2::RectD(minX, maxY - size, minX + size, maxY);
+}
+
+void RasterTileRenderer::RenderTile(RasterTileKey const & key, FrameImage & image)
+{
+  m2::RectD const tileRect = GetTileRect(key);
+  ScreenBase screen;
+  screen.OnSize(0, 0, m_tileSize, m_tileSize);
+  screen.SetFromRect(m2::AnyRectD(tileRect));
+
+  // The same way as Framework::DrawModel draws a tile.
+  m2::RectD const renderRect(0, 0, m_tileSize, m_tileSize);
+  double const inflationSize = m_scales.GetClipRectInflation();
+  m2::RectD clipRect;
+  screen.PtoG(m2::Inflate(renderRect, inflationSize, inflationSize), clipRect);
+
+  int const drawScale = m_scales.GetDrawTileScale(tileRect);
+  int const upperScale = scales::GetUpperScale();
+
+  CPUDrawer * drawer = TakeDrawer();
+  drawer->BeginFrame(m_tileSize, m_tileSize, ConvertColor(drule::rules().GetBgColor(min(drawScale, upperScale))));
+
+  shared_ptr<PaintEvent> event = make_shared<PaintEvent>(drawer);
+  fwork::FeatureProcessor doDraw(clipRect, screen, event, drawScale);
+  if (drawScale <= upperScale)
+    m_model.ForEachFeature_TileDrawing(tileRect, doDraw, drawScale);
+  else
+    m_model.ForEachFeature(tileRect, doDraw, upperScale);
+
+  drawer->Flush();
+  drawer->EndFrame(image);
+  ReturnDrawer(drawer);
+}
+
+CPUDrawer * RasterTileRenderer::TakeDrawer()
+{
+  threads::ConditionGuard guard(m_drawersCondition);
+  while (m_freeDrawers.empty())
+    guard.Wait();
+
+  CPUDrawer * drawer = m_freeDrawers.back();
+  m_freeDrawers.pop_back();
+  return drawer;
+}
+
+void RasterTileRenderer::ReturnDrawer(CPUDrawer * drawer)
+{
+  threads::ConditionGuard guard(m_drawersCondition);
+  m_freeDrawers.push_back(drawer);
+  guard.Signal();
+}
+#endif // USE_DRAPE
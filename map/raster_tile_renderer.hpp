@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef USE_DRAPE
+#include "render/frame_image.hpp"
+#include "render/scales_processor.hpp"
+
+#include "graphics/defines.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include "base/condition.hpp"
+
+#include "std/noncopyable.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+class CPUDrawer;
+
+namespace model
+{
+class FeaturesFetcher;
+}
+
+/// Tile of the z-x-y scheme, y goes from the north.
+struct RasterTileKey
+{
+  RasterTileKey() = default;
+  RasterTileKey(int zoom, int x, int y) : m_zoom(zoom), m_x(x), m_y(y) {}
+
+  int m_zoom = 0;
+  int m_x = 0;
+  int m_y = 0;
+};
+
+string DebugPrint(RasterTileKey const & key);
+
+/// Renders raster tiles of the map data into PNG without GL, e.g. to serve them.
+/// There is a pool of CPU drawers, each one has its own software renderer and glyph cache,
+/// so as many tiles as drawers are rendered at once. RenderTile can be called on any thread.
+class RasterTileRenderer : private noncopyable
+{
+public:
+  RasterTileRenderer(model::FeaturesFetcher const & model, graphics::EDensity density,
+                     size_t drawersCount);
+  ~RasterTileRenderer();
+
+  static m2::RectD GetTileRect(RasterTileKey const & key);
+  uint32_t GetTileSize() const { return m_tileSize; }
+
+  /// Waits for a free drawer when all of them are busy.
+  void RenderTile(RasterTileKey const & key, FrameImage & image);
+
+private:
+  CPUDrawer * TakeDrawer();
+  void ReturnDrawer(CPUDrawer * drawer);
+
+  model::FeaturesFetcher const & m_model;
+  uint32_t m_tileSize;
+  ScalesProcessor m_scales;
+
+  vector<unique_ptr<CPUDrawer>> m_drawers;
+  vector<CPUDrawer *> m_freeDrawers;
+  threads::Condition m_drawersCondition;
+};
+#endif // USE_DRAPE
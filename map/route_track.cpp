@@ -7,6 +7,8 @@
 
 #include "indexer/scales.hpp"
 
+#include "geometry/transformations.hpp"
+
 #include "std/array.hpp"
 
 namespace
@@ -199,7 +201,7 @@ void RouteTrack::CreateDisplayListArrows(graphics::Screen * dlScreen, MatrixT co
     ptsTurn.clear();
     if (t->m_points.empty())
       continue;
-    transform(t->m_points.begin(), t->m_points.end(), back_inserter(ptsTurn), DoLeftProduct<MatrixT>(matrix));
+    math::TransformPoints(matrix, t->m_points.begin(), t->m_points.end(), back_inserter(ptsTurn));
 
     if (!ClipArrowBodyAndGetArrowDirection(ptsTurn, arrowDirection, t->m_turnIndex, beforeTurn, afterTurn, arrowLength))
       continue;
@@ -224,7 +226,8 @@ void RouteTrack::CreateDisplayListArrows(graphics::Screen * dlScreen, MatrixT co
 ///
 void RouteTrack::CreateDisplayList(graphics::Screen * dlScreen, MatrixT const & matrix, bool isScaleChanged,
                                    int drawScale, double visualScale,
-                                   location::RouteMatchingInfo const & matchingInfo) const
+                                   location::RouteMatchingInfo const & matchingInfo,
+                                   m2::RectD const &) const
 {
   if (HasDisplayLists() && !isScaleChanged &&
       m_relevantMatchedInfo.GetPosition() == matchingInfo.GetPosition())
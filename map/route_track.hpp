@@ -15,8 +15,9 @@ public:
   explicit RouteTrack(PolylineD const & polyline) : Track(polyline) {}
   virtual ~RouteTrack();
   virtual void CreateDisplayList(graphics::Screen * dlScreen, MatrixT const & matrix, bool isScaleChanged,
-                                int drawScale, double visualScale, 
-                                location::RouteMatchingInfo const & matchingInfo) const;
+                                int drawScale, double visualScale,
+                                location::RouteMatchingInfo const & matchingInfo,
+                                m2::RectD const &) const;
   virtual void Draw(graphics::Screen * pScreen, MatrixT const & matrix) const;
   virtual RouteTrack * CreatePersistent();
   virtual void CleanUp() const;
@@ -11,12 +11,35 @@
 #include "geometry/distance.hpp"
 #include "geometry/simplification.hpp"
 #include "geometry/distance_on_sphere.hpp"
+#include "geometry/transformations.hpp"
 
 #include "base/timer.hpp"
 #include "base/logging.hpp"
 
 #include "platform/location.hpp"
 
+namespace
+{
+/// Tolerance of the first simplification level, it's about 1 m.
+double const kFirstLevelTolerance = 1.0E-5;
+/// Tolerance grows in this factor from level to level.
+double const kLevelToleranceFactor = 4.0;
+/// Polylines which are smaller aren't simplified further.
+size_t const kMinLevelSize = 64;
+/// Display list covers a rect which is bigger than the viewport in this factor,
+/// so it isn't recreated on every pan.
+double const kClipRectScale = 3.0;
+
+template <typename TIter>
+void TransformAndSimplify(TIter begin, TIter end, MatrixT const & matrix, double width,
+                          PointContainerT & pts)
+{
+  PointContainerT pts1(distance(begin, end));
+  math::TransformPoints(matrix, begin, end, pts1.begin());
+  SimplifyDP(pts1.begin(), pts1.end(), width,
+             m2::DistanceToLineSquare<m2::PointD>(), MakeBackInsertFunctor(pts));
+}
+}  // namespace
 
 Track::~Track()
 {
@@ -76,9 +99,10 @@ void Track::CreateDisplayListPolyline(graphics::Screen * dlScreen, PointContaine
 }
 
 void Track::CreateDisplayList(graphics::Screen * dlScreen, MatrixT const & matrix, bool isScaleChanged,
-                              int, double, location::RouteMatchingInfo const &) const
+                              int, double, location::RouteMatchingInfo const &,
+                              m2::RectD const & clipRect) const
 {
-  if (HasDisplayLists() && !isScaleChanged)
+  if (HasDisplayLists() && !isScaleChanged && m_dListRect.IsRectInside(clipRect))
     return;
 
   DeleteDisplayList();
@@ -87,32 +111,84 @@ void Track::CreateDisplayList(graphics::Screen * dlScreen, MatrixT const & matri
   dlScreen->beginFrame();
   dlScreen->setDisplayList(m_dList);
 
+  // Points are simplified with squared pixel distance of the main width (see
+  // TransformAndSymplifyPolyline()), so the pyramid level within the half of it
+  // doesn't change the picture and is much smaller for long tracks.
+  double const pixelTolerance = sqrt(GetMainWidth());
+  double const pixelsInMercator = fabs(matrix(0, 0));
+  vector<m2::PointD> const & points =
+      GetSimplifiedPoints(pixelsInMercator > 0.0 ? 0.5 * pixelTolerance / pixelsInMercator : 0.0);
+
+  m2::RectD rect = clipRect;
+  rect.Scale(kClipRectScale);
+  if (rect.IsRectInside(m_rect))
+    rect = m_rect;
+  m_dListRect = rect;
+
+  // Draw the runs of segments which intersect the rect.
   PointContainerT pts;
-  pts.reserve(m_polyline.GetSize());
-  TransformAndSymplifyPolyline(m_polyline, matrix, GetMainWidth(), pts);
-  CreateDisplayListPolyline(dlScreen, pts);
+  size_t runBegin = 0;
+  for (size_t i = 0; i + 1 < points.size(); ++i)
+  {
+    bool const isVisible = rect.IsIntersect(m2::RectD(points[i], points[i + 1]));
+    bool const isLast = (i + 2 == points.size());
+    if (isVisible && !isLast)
+      continue;
+
+    size_t const runEnd = isVisible ? i + 2 : i + 1;
+    if (runEnd - runBegin > 1)
+    {
+      pts.clear();
+      TransformAndSimplify(points.begin() + runBegin, points.begin() + runEnd, matrix,
+                           GetMainWidth(), pts);
+      CreateDisplayListPolyline(dlScreen, pts);
+    }
+    runBegin = i + 1;
+  }
 
   dlScreen->setDisplayList(0);
   dlScreen->endFrame();
 }
 
-double Track::GetLengthMeters() const
+vector<m2::PointD> const & Track::GetSimplifiedPoints(double tolerance) const
 {
-  double res = 0.0;
+  if (m_levels.empty())
+    BuildSimplificationLevels();
+
+  for (auto it = m_levels.rbegin(); it != m_levels.rend(); ++it)
+  {
+    if (it->m_error <= tolerance)
+      return it->m_points;
+  }
+  return m_polyline.GetPoints();
+}
 
-  PolylineD::TIter i = m_polyline.Begin();
-  double lat1 = MercatorBounds::YToLat(i->y);
-  double lon1 = MercatorBounds::XToLon(i->x);
-  for (++i; i != m_polyline.End(); ++i)
+void Track::BuildSimplificationLevels() const
+{
+  vector<m2::PointD> const * points = &m_polyline.GetPoints();
+  double tolerance = kFirstLevelTolerance;
+  double error = 0.0;
+  // Every level is simplified from the previous one, so errors of the levels are summed.
+  while (points->size() > kMinLevelSize)
   {
-    double const lat2 = MercatorBounds::YToLat(i->y);
-    double const lon2 = MercatorBounds::XToLon(i->x);
-    res += ms::DistanceOnEarth(lat1, lon1, lat2, lon2);
-    lat1 = lat2;
-    lon1 = lon2;
+    SimplificationLevel level;
+    SimplifyDP(points->begin(), points->end(), tolerance * tolerance,
+               m2::DistanceToLineSquare<m2::PointD>(), MakeBackInsertFunctor(level.m_points));
+    error += tolerance;
+    level.m_error = error;
+    tolerance *= kLevelToleranceFactor;
+
+    if (level.m_points.size() == points->size())
+      continue;
+    m_levels.push_back(move(level));
+    points = &m_levels.back().m_points;
   }
+}
 
-  return res;
+double Track::GetLengthMeters() const
+{
+  vector<m2::PointD> const & points = m_polyline.GetPoints();
+  return MercatorBounds::LengthOnEarth(points.data(), points.size());
 }
 
 void Track::Swap(Track & rhs)
@@ -121,6 +197,8 @@ void Track::Swap(Track & rhs)
   swap(m_outlines, rhs.m_outlines);
   m_name.swap(rhs.m_name);
   m_polyline.Swap(rhs.m_polyline);
+  m_levels.clear();
+  rhs.m_levels.clear();
 
   DeleteDisplayList();
   rhs.DeleteDisplayList();
@@ -139,15 +217,12 @@ bool Track::HasDisplayLists() const
 void TransformPolyline(Track::PolylineD const & polyline, MatrixT const & matrix, PointContainerT & pts)
 {
   pts.resize(polyline.GetSize());
-  transform(polyline.Begin(), polyline.End(), pts.begin(), DoLeftProduct<MatrixT>(matrix));
+  math::TransformPoints(matrix, polyline.Begin(), polyline.End(), pts.begin());
 }
 
 void TransformAndSymplifyPolyline(Track::PolylineD const & polyline, MatrixT const & matrix, double width, PointContainerT & pts)
 {
-  PointContainerT pts1(polyline.GetSize());
-  TransformPolyline(polyline, matrix, pts1);
-  SimplifyDP(pts1.begin(), pts1.end(), width,
-             m2::DistanceToLineSquare<m2::PointD>(), MakeBackInsertFunctor(pts));
+  TransformAndSimplify(polyline.Begin(), polyline.End(), matrix, width, pts);
 }
 
 
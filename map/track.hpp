@@ -22,14 +22,6 @@ namespace location
   class RouteMatchingInfo;
 }
 
-template <class T> class DoLeftProduct
-{
-  T const & m_t;
-public:
-  DoLeftProduct(T const & t) : m_t(t) {}
-  template <class X> X operator() (X const & x) const { return x * m_t; }
-};
-
 typedef math::Matrix<double, 3, 3> MatrixT;
 typedef buffer_vector<m2::PointD, 32> PointContainerT;
 
@@ -55,8 +47,11 @@ public:
   graphics::Color const & GetMainColor() const;
 
   virtual void Draw(graphics::Screen * pScreen, MatrixT const & matrix) const;
+  /// @param clipRect  Viewport rect, segments far from it are not drawn and the display
+  ///                   list is recreated when the viewport leaves the drawn region.
   virtual void CreateDisplayList(graphics::Screen * dlScreen, MatrixT const & matrix, bool isScaleChanged,
-                         int, double, location::RouteMatchingInfo const &) const;
+                         int, double, location::RouteMatchingInfo const &,
+                         m2::RectD const & clipRect) const;
   virtual void CleanUp() const;
   virtual bool HasDisplayLists() const;
 
@@ -79,6 +74,10 @@ public:
   //@}
   double GetLengthMeters() const;
 
+  /// @return The coarsest level of the simplification pyramid, which is within
+  /// |tolerance| mercator units from the polyline.
+  vector<m2::PointD> const & GetSimplifiedPoints(double tolerance) const;
+
 protected:
   graphics::DisplayList * GetDisplayList() const { return m_dList; }
   void SetDisplayList(graphics::DisplayList * dl) const { m_dList = dl; }
@@ -87,13 +86,27 @@ protected:
   void DeleteDisplayList() const;
 
 private:
+  void BuildSimplificationLevels() const;
+
   string m_name;
 
   vector<TrackOutline> m_outlines;
   PolylineD m_polyline;
   m2::RectD m_rect;
 
+  struct SimplificationLevel
+  {
+    /// Max distance from the polyline in mercator.
+    double m_error;
+    vector<m2::PointD> m_points;
+  };
+  /// Douglas-Peucker simplifications of m_polyline with growing tolerance,
+  /// they are built on the first drawing.
+  mutable vector<SimplificationLevel> m_levels;
+
   mutable graphics::DisplayList * m_dList = nullptr;
+  /// Region which is drawn to m_dList.
+  mutable m2::RectD m_dListRect;
 };
 
 void TransformPolyline(Track::PolylineD const & polyline, MatrixT const & matrix, PointContainerT & pts);
@@ -8,6 +8,8 @@
 #include "graphics/screen.hpp"
 #include "graphics/depth_constants.hpp"
 
+#include "indexer/scales.hpp"
+
 #include "geometry/transformations.hpp"
 
 #include "anim/task.hpp"
@@ -18,6 +20,12 @@
 
 #include "std/algorithm.hpp"
 
+namespace
+{
+  // Size of the cluster cell in pixels on the screen without the visual scale.
+  double const kClusterCellSizePx = 48.0;
+}
+
 ////////////////////////////////////////////////////////////////////////
 
 namespace
@@ -124,6 +132,8 @@ UserMarkContainer::UserMarkContainer(double layerDepth, Framework & fm)
   , m_isVisible(true)
   , m_isDrawable(true)
   , m_layerDepth(layerDepth)
+  , m_marksTreeOptimizedSize(0)
+  , m_clustersDirty(false)
 {
 }
 
@@ -135,9 +145,81 @@ UserMarkContainer::~UserMarkContainer()
 template <class ToDo>
 void UserMarkContainer::ForEachInRect(m2::RectD const & rect, ToDo toDo) const
 {
-  for (size_t i = 0; i < m_userMarks.size(); ++i)
-    if (rect.IsPointInside(m_userMarks[i]->GetOrg()))
-      toDo(m_userMarks[i].get());
+  m_marksTree.ForEachInRect(rect, [&rect, &toDo](UserMark * mark)
+  {
+    // Tree checks strict intersection, so marks on the border are checked here.
+    if (rect.IsPointInside(mark->GetOrg()))
+      toDo(mark);
+  });
+}
+
+template <class ToDo>
+bool UserMarkContainer::ForEachClusterInRect(m2::RectD const & rect, ToDo toDo) const
+{
+  if (!m_clusterer)
+    return false;
+
+  if (m_clustersDirty)
+  {
+    m_clustersDirty = false;
+    m_clusteredMarks.clear();
+    m_clusteredMarks.reserve(m_userMarks.size());
+    vector<m2::PointD> points;
+    points.reserve(m_userMarks.size());
+    // Recently added marks are in the head of the list.
+    for (auto it = m_userMarks.rbegin(); it != m_userMarks.rend(); ++it)
+    {
+      m_clusteredMarks.push_back(it->get());
+      points.push_back((*it)->GetOrg());
+    }
+    // The framework outlives the containers, so the callback doesn't refer to this one.
+    Framework & framework = m_framework;
+    m_clusterer->Update(move(points), kClusterCellSizePx * m_framework.GetVisualScale(),
+                        [&framework]() { framework.Invalidate(); });
+  }
+
+  shared_ptr<MarksClusters const> const clusters = m_clusterer->GetClusters();
+  int const scale = m_framework.GetDrawScale();
+  if (!clusters || scale > clusters->GetUpperScale())
+    return false;
+
+  clusters->ForEachInRect(scale, rect, [this, &toDo](MarksClusters::Cluster const & cluster)
+  {
+    if (cluster.m_index < m_clusteredMarks.size())
+      toDo(m_clusteredMarks[cluster.m_index]);
+  });
+  return true;
+}
+
+void UserMarkContainer::EnableClustering()
+{
+  m_clusterer.reset(new MarksClusterer(scales::GetUpperComfortScale()));
+  m_clustersDirty = true;
+}
+
+void UserMarkContainer::InvalidateClusters(bool marksDeleted)
+{
+  if (!m_clusterer)
+    return;
+
+  m_clustersDirty = true;
+  if (marksDeleted)
+  {
+    m_clusterer->Reset();
+    m_clusteredMarks.clear();
+  }
+}
+
+void UserMarkContainer::AddToIndex(UserMark * mark)
+{
+  m_marksTree.Add(mark);
+
+  // The tree isn't rebalanced on insertion, so it's rebuilt when it's doubled.
+  if (m_marksTree.GetSize() >= 2 * m_marksTreeOptimizedSize)
+  {
+    m_marksTree.Optimize();
+    m_marksTreeOptimizedSize = m_marksTree.GetSize();
+  }
 }
 
 UserMark const * UserMarkContainer::FindMarkInRect(m2::AnyRectD const & rect, double & d) const
@@ -146,7 +228,8 @@ UserMark const * UserMarkContainer::FindMarkInRect(m2::AnyRectD const & rect, do
   if (IsVisible())
   {
     FindMarkFunctor f(&mark, d, rect);
-    ForEachInRect(rect.GetGlobalRect(), f);
+    if (!ForEachClusterInRect(rect.GetGlobalRect(), ref(f)))
+      ForEachInRect(rect.GetGlobalRect(), ref(f));
   }
   return mark;
 }
@@ -157,8 +240,10 @@ void UserMarkContainer::Draw(PaintOverlayEvent const & e, UserMarkDLCache * cach
   if (IsVisible() && IsDrawable())
   {
     UserMarkDLCache::Key defaultKey(GetTypeName(), graphics::EPosCenter, m_layerDepth);
-    ForEachInRect(e.GetClipRect(), bind(&DrawUserMark, 1.0, m_framework.GetVisualScale(),
-                                        e, cache, defaultKey, _1));
+    auto const drawMark = bind(&DrawUserMark, 1.0, m_framework.GetVisualScale(),
+                               e, cache, defaultKey, _1);
+    if (!ForEachClusterInRect(e.GetClipRect(), drawMark))
+      ForEachInRect(e.GetClipRect(), drawMark);
   }
 #endif // USE_DRAPE
 }
@@ -168,7 +253,21 @@ void UserMarkContainer::Clear(size_t skipCount/* = 0*/)
   // Recently added marks stored in the head of list
   // (@see CreateUserMark). Leave tail here.
   if (skipCount < m_userMarks.size())
-    m_userMarks.erase(m_userMarks.begin(), m_userMarks.end() - skipCount);
+  {
+    auto const end = m_userMarks.end() - skipCount;
+    if (skipCount == 0)
+    {
+      m_marksTree.Clear();
+      m_marksTreeOptimizedSize = 0;
+    }
+    else
+    {
+      for (auto it = m_userMarks.begin(); it != end; ++it)
+        m_marksTree.Erase(it->get());
+    }
+    m_userMarks.erase(m_userMarks.begin(), end);
+    InvalidateClusters(true /* marksDeleted */);
+  }
 }
 
 namespace
@@ -202,6 +301,8 @@ UserMark * UserMarkContainer::CreateUserMark(m2::PointD const & ptOrg)
 {
   // Push new marks to the head of list.
   m_userMarks.push_front(unique_ptr<UserMark>(AllocateUserMark(ptOrg)));
+  AddToIndex(m_userMarks.front().get());
+  InvalidateClusters(false /* marksDeleted */);
   return m_userMarks.front().get();
 }
 
@@ -226,7 +327,11 @@ void UserMarkContainer::DeleteUserMark(size_t index)
 {
   ASSERT_LESS(index, m_userMarks.size(), ());
   if (index < m_userMarks.size())
+  {
+    m_marksTree.Erase(m_userMarks[index].get());
     m_userMarks.erase(m_userMarks.begin() + index);
+    InvalidateClusters(true /* marksDeleted */);
+  }
   else
     LOG(LWARNING, ("Trying to delete non-existing item at index", index));
 }
@@ -250,6 +355,7 @@ size_t UserMarkContainer::FindUserMark(UserMark const * mark)
 SearchUserMarkContainer::SearchUserMarkContainer(double layerDepth, Framework & framework)
   : UserMarkContainer(layerDepth, framework)
 {
+  EnableClustering();
 }
 
 string SearchUserMarkContainer::GetTypeName() const
@@ -270,6 +376,7 @@ UserMark * SearchUserMarkContainer::AllocateUserMark(const m2::PointD & ptOrg)
 ApiUserMarkContainer::ApiUserMarkContainer(double layerDepth, Framework & framework)
   : UserMarkContainer(layerDepth, framework)
 {
+  EnableClustering();
 }
 
 string ApiUserMarkContainer::GetTypeName() const
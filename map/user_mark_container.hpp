@@ -1,5 +1,6 @@
 #pragma once
 
+#include "marks_clusterer.hpp"
 #include "user_mark.hpp"
 #include "user_mark_dl_cache.hpp"
 
@@ -7,6 +8,7 @@
 
 #include "geometry/point2d.hpp"
 #include "geometry/rect2d.hpp"
+#include "geometry/tree4d.hpp"
 
 #include "std/deque.hpp"
 #include "std/noncopyable.hpp"
@@ -97,6 +99,10 @@ protected:
   virtual string GetTypeName() const = 0;
   virtual UserMark * AllocateUserMark(m2::PointD const & ptOrg) = 0;
 
+  /// Only the representatives of the grid clusters of the marks are drawn and hit-tested
+  /// on the scales up to the comfort one, for the containers with a lot of marks.
+  void EnableClustering();
+
 private:
   friend class Controller;
   UserMark * CreateUserMark(m2::PointD const & ptOrg);
@@ -108,6 +114,20 @@ private:
   size_t FindUserMark(UserMark const * mark);
 
   template <class ToDo> void ForEachInRect(m2::RectD const & rect, ToDo toDo) const;
+  /// Calls toDo for the representatives of the clusters in the rect.
+  /// @return False if the marks are not clustered on the current scale.
+  template <class ToDo> bool ForEachClusterInRect(m2::RectD const & rect, ToDo toDo) const;
+  void InvalidateClusters(bool marksDeleted);
+
+  void AddToIndex(UserMark * mark);
+
+  struct MarkTraits
+  {
+    m2::RectD const LimitRect(UserMark const * mark) const
+    {
+      return m2::RectD(mark->GetOrg(), mark->GetOrg());
+    }
+  };
 
 protected:
   Framework & m_framework;
@@ -118,6 +138,19 @@ private:
   bool m_isDrawable;
   double m_layerDepth;
   UserMarksListT m_userMarks;
+  /// Spatial index of m_userMarks for drawing and hit-testing, so they don't
+  /// iterate over all marks. Positions of the marks in containers are constant.
+  m4::Tree<UserMark *, MarkTraits> m_marksTree;
+  /// Size of the tree after the last rebalancing.
+  size_t m_marksTreeOptimizedSize;
+
+  /// Clusters are rebuilt on drawing after the marks are changed.
+  mutable unique_ptr<MarksClusterer> m_clusterer;
+  mutable bool m_clustersDirty;
+  /// Marks in the order they are added, indices of the clusters refer to them. The old marks
+  /// keep their indices when the marks are added, so the old clusters are valid until
+  /// the new ones are built.
+  mutable vector<UserMark *> m_clusteredMarks;
 };
 
 class SearchUserMarkContainer : public UserMarkContainer
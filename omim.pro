@@ -87,7 +87,11 @@ CONFIG(desktop) {
     SUBDIRS += graphics/graphics_tests
     SUBDIRS += gui/gui_tests
     SUBDIRS += pedestrian_routing_benchmarks
+    SUBDIRS += routing/routing_benchmark
     SUBDIRS += search/search_integration_tests
+    SUBDIRS += search/search_benchmark
+    SUBDIRS += search/reverse_geocoder_benchmark
+    SUBDIRS += tile_exporter
 
     CONFIG(drape) {
       SUBDIRS += drape/drape_tests
@@ -5,6 +5,7 @@
 
 #include "routing/features_road_graph.hpp"
 #include "routing/road_graph_router.hpp"
+#include "routing/routing_algorithm.hpp"
 #include "routing/route.hpp"
 #include "routing/pedestrian_model.hpp"
 #include "routing/router_delegate.hpp"
@@ -58,22 +59,31 @@ private:
   shared_ptr<routing::IVehicleModel> const m_model;
 };
 
-unique_ptr<routing::IRouter> CreatePedestrianAStarTestRouter(Index & index)
+template <typename TAlgorithm>
+unique_ptr<routing::IRouter> CreatePedestrianTestRouter(Index & index, string const & name, bool useLandmarks,
+                                                        routing::AStarRoutingAlgorithmBase const *& algorithm)
 {
   auto UKGetter = [](m2::PointD const & /* point */){return "UK_England";};
   unique_ptr<routing::IVehicleModelFactory> vehicleModelFactory(new SimplifiedPedestrianModelFactory());
-  unique_ptr<routing::IRoutingAlgorithm> algorithm(new routing::AStarRoutingAlgorithm());
-  unique_ptr<routing::IRouter> router(new routing::RoadGraphRouter("test-astar-pedestrian", index, UKGetter, move(vehicleModelFactory), move(algorithm), nullptr));
+  unique_ptr<routing::IRoadGraph> roadGraph(new routing::FeaturesRoadGraph(index, move(vehicleModelFactory)));
+  unique_ptr<TAlgorithm> impl(new TAlgorithm(useLandmarks));
+  algorithm = impl.get();
+  unique_ptr<routing::IRouter> router(new routing::RoadGraphRouter(name, index, UKGetter, move(roadGraph), move(impl), nullptr));
   return router;
 }
 
-unique_ptr<routing::IRouter> CreatePedestrianAStarBidirectionalTestRouter(Index & index)
+unique_ptr<routing::IRouter> CreatePedestrianAStarTestRouter(Index & index, bool useLandmarks,
+                                                             routing::AStarRoutingAlgorithmBase const *& algorithm)
 {
-  auto UKGetter = [](m2::PointD const & /* point */){return "UK_England";};
-  unique_ptr<routing::IVehicleModelFactory> vehicleModelFactory(new SimplifiedPedestrianModelFactory());
-  unique_ptr<routing::IRoutingAlgorithm> algorithm(new routing::AStarBidirectionalRoutingAlgorithm());
-  unique_ptr<routing::IRouter> router(new routing::RoadGraphRouter("test-astar-bidirectional-pedestrian", index, UKGetter, move(vehicleModelFactory), move(algorithm), nullptr));
-  return router;
+  return CreatePedestrianTestRouter<routing::AStarRoutingAlgorithm>(
+      index, "test-astar-pedestrian", useLandmarks, algorithm);
+}
+
+unique_ptr<routing::IRouter> CreatePedestrianAStarBidirectionalTestRouter(Index & index, bool useLandmarks,
+                                                                          routing::AStarRoutingAlgorithmBase const *& algorithm)
+{
+  return CreatePedestrianTestRouter<routing::AStarBidirectionalRoutingAlgorithm>(
+      index, "test-astar-bidirectional-pedestrian", useLandmarks, algorithm);
 }
 
 m2::PointD GetPointOnEdge(routing::Edge & e, double posAlong)
@@ -94,10 +104,11 @@ void GetNearestPedestrianEdges(Index & index, m2::PointD const & pt, vector<pair
   roadGraph.FindClosestEdges(pt, 1 /*count*/, edges);
 }
 
-void TestRouter(routing::IRouter & router, m2::PointD const & startPos, m2::PointD const & finalPos, routing::Route & foundRoute)
+void TestRouter(routing::IRouter & router, routing::AStarRoutingAlgorithmBase const & algorithm,
+                m2::PointD const & startPos, m2::PointD const & finalPos, routing::Route & foundRoute)
 {
   routing::RouterDelegate delegate;
-  LOG(LINFO, ("Calculating routing ...", router.GetName()));
+  LOG(LINFO, ("Calculating routing ...", router.GetName(), "landmarks:", algorithm.GetUseLandmarks()));
   routing::Route route("");
   my::Timer timer;
   routing::IRouter::ResultCode const resultCode = router.CalculateRoute(
@@ -106,26 +117,48 @@ void TestRouter(routing::IRouter & router, m2::PointD const & startPos, m2::Poin
   TEST_EQUAL(routing::IRouter::NoError, resultCode, ());
   LOG(LINFO, ("Route polyline size:", route.GetPoly().GetSize()));
   LOG(LINFO, ("Route distance, meters:", route.GetTotalDistanceMeters()));
+  LOG(LINFO, ("Settled vertices:", algorithm.GetSettledVerticesCount()));
   LOG(LINFO, ("Elapsed, seconds:", elapsedSec));
   foundRoute.Swap(route);
 }
 
 void TestRouters(Index & index, m2::PointD const & startPos, m2::PointD const & finalPos)
 {
+  double constexpr kEpsilon = 1e-6;
+  routing::AStarRoutingAlgorithmBase const * algorithm = nullptr;
+
   // find route by A*-bidirectional algorithm
   routing::Route routeFoundByAstarBidirectional("");
-  unique_ptr<routing::IRouter> router = CreatePedestrianAStarBidirectionalTestRouter(index);
-  TestRouter(*router, startPos, finalPos, routeFoundByAstarBidirectional);
+  unique_ptr<routing::IRouter> router =
+      CreatePedestrianAStarBidirectionalTestRouter(index, false /* useLandmarks */, algorithm);
+  TestRouter(*router, *algorithm, startPos, finalPos, routeFoundByAstarBidirectional);
+  uint64_t const settledBidirectional = algorithm->GetSettledVerticesCount();
 
   // find route by A* algorithm
   routing::Route routeFoundByAstar("");
-  router = CreatePedestrianAStarTestRouter(index);
+  router = CreatePedestrianAStarTestRouter(index, false /* useLandmarks */, algorithm);
+  TestRouter(*router, *algorithm, startPos, finalPos, routeFoundByAstar);
+  uint64_t const settled = algorithm->GetSettledVerticesCount();
 
-  TestRouter(*router, startPos, finalPos, routeFoundByAstar);
-
-  double constexpr kEpsilon = 1e-6;
   TEST(my::AlmostEqualAbs(routeFoundByAstar.GetTotalDistanceMeters(),
                           routeFoundByAstarBidirectional.GetTotalDistanceMeters(), kEpsilon), ());
+
+  // find routes with landmarks, they are used only when the mwm has landmarks section
+  routing::Route routeFoundByAltBidirectional("");
+  router = CreatePedestrianAStarBidirectionalTestRouter(index, true /* useLandmarks */, algorithm);
+  TestRouter(*router, *algorithm, startPos, finalPos, routeFoundByAltBidirectional);
+  LOG(LINFO, ("A*-bidirectional settled vertices before/after landmarks:", settledBidirectional,
+              algorithm->GetSettledVerticesCount()));
+
+  routing::Route routeFoundByAlt("");
+  router = CreatePedestrianAStarTestRouter(index, true /* useLandmarks */, algorithm);
+  TestRouter(*router, *algorithm, startPos, finalPos, routeFoundByAlt);
+  LOG(LINFO, ("A* settled vertices before/after landmarks:", settled, algorithm->GetSettledVerticesCount()));
+
+  TEST(my::AlmostEqualAbs(routeFoundByAstar.GetTotalDistanceMeters(),
+                          routeFoundByAlt.GetTotalDistanceMeters(), kEpsilon), ());
+  TEST(my::AlmostEqualAbs(routeFoundByAstar.GetTotalDistanceMeters(),
+                          routeFoundByAltBidirectional.GetTotalDistanceMeters(), kEpsilon), ());
 }
 
 void TestTwoPointsOnFeature(m2::PointD const & startPos, m2::PointD const & finalPos)
@@ -12,6 +12,17 @@
 namespace downloader
 {
 
+namespace
+{
+
+// Duration of the range request which the joined chunks are aimed to.
+double const kRequestSeconds = 2.0;
+// Shorter requests are dominated by the latency, so they aren't measured.
+double const kMinMeasuredSeconds = 0.1;
+int const kMaxChunksPerRequest = 32;
+
+} // namespace
+
 ChunksDownloadStrategy::ChunksDownloadStrategy(vector<string> const & urls)
 {
   // init servers list
@@ -26,7 +37,8 @@ ChunksDownloadStrategy::GetChunk(RangeT const & range)
 
   if (i != m_chunks.end() && i->m_pos == range.first)
   {
-    ASSERT_EQUAL ( (i+1)->m_pos, range.second + 1, () );
+    // The range can consist of several chunks.
+    ASSERT ( binary_search(i + 1, m_chunks.end(), range.second + 1, LessChunks()), (range) );
     return pair<ChunkT *, int>(&(*i), distance(m_chunks.begin(), i));
   }
   else
@@ -138,22 +150,35 @@ void ChunksDownloadStrategy::ChunkFinished(bool success, RangeT const & range)
   {
     for (size_t s = 0; s < m_servers.size(); ++s)
     {
-      if (m_servers[s].m_chunkIndex == res.second)
+      ServerT & server = m_servers[s];
+      if (server.m_chunkIndex == res.second)
       {
+        ASSERT_GREATER(server.m_chunksCount, 0, ());
+        ChunkStatusT const status = success ? CHUNK_COMPLETE : CHUNK_FREE;
+        for (int i = 0; i < server.m_chunksCount; ++i)
+          (res.first + i)->m_status = status;
+
         if (success)
         {
-          // mark server as free and chunk as ready
-          m_servers[s].m_chunkIndex = SERVER_READY;
-          res.first->m_status = CHUNK_COMPLETE;
+          double const seconds = server.m_timer.ElapsedSeconds();
+          if (seconds >= kMinMeasuredSeconds)
+          {
+            double const bytesPerSecond = (range.second - range.first + 1) / seconds;
+            server.m_bytesPerSecond = (server.m_bytesPerSecond == 0.0)
+                ? bytesPerSecond : (server.m_bytesPerSecond + bytesPerSecond) / 2.0;
+          }
+
+          // mark server as free
+          server.m_chunkIndex = SERVER_READY;
+          server.m_chunksCount = 0;
         }
         else
         {
-          LOG(LINFO, ("Thread for url", m_servers[s].m_url,
-                      "failed to download chunk number", m_servers[s].m_chunkIndex));
+          LOG(LINFO, ("Thread for url", server.m_url,
+                      "failed to download chunk number", server.m_chunkIndex));
 
-          // remove failed server and mark chunk as free
+          // remove failed server, its chunks are free already
           m_servers.erase(m_servers.begin() + s);
-          res.first->m_status = CHUNK_FREE;
         }
         break;
       }
@@ -189,14 +214,20 @@ ChunksDownloadStrategy::NextChunk(string & outUrl, RangeT & range)
     switch (m_chunks[i].m_status)
     {
     case CHUNK_FREE:
+    {
+      int const count = GetChunksCountForServer(*server, i);
       server->m_chunkIndex = static_cast<int>(i);
+      server->m_chunksCount = count;
+      server->m_timer.Reset();
       outUrl = server->m_url;
 
       range.first = m_chunks[i].m_pos;
-      range.second = m_chunks[i+1].m_pos - 1;
+      range.second = m_chunks[i + count].m_pos - 1;
 
-      m_chunks[i].m_status = CHUNK_DOWNLOADING;
+      for (int j = 0; j < count; ++j)
+        m_chunks[i + j].m_status = CHUNK_DOWNLOADING;
       return ENextChunk;
+    }
 
     case CHUNK_DOWNLOADING:
       allChunksDownloaded = false;
@@ -207,4 +238,20 @@ ChunksDownloadStrategy::NextChunk(string & outUrl, RangeT & range)
   return (allChunksDownloaded ? EDownloadSucceeded : ENoFreeServers);
 }
 
+int ChunksDownloadStrategy::GetChunksCountForServer(ServerT const & server, size_t index) const
+{
+  ASSERT_EQUAL(m_chunks[index].m_status, CHUNK_FREE, ());
+  double const requestBytes = server.m_bytesPerSecond * kRequestSeconds;
+
+  int count = 1;
+  // The last chunk is auxiliary, it only keeps the end of the file.
+  while (count < kMaxChunksPerRequest && index + count + 1 < m_chunks.size() &&
+         m_chunks[index + count].m_status == CHUNK_FREE &&
+         m_chunks[index + count + 1].m_pos - m_chunks[index].m_pos <= requestBytes)
+  {
+    ++count;
+  }
+  return count;
+}
+
 } // namespace downloader
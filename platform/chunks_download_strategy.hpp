@@ -1,5 +1,7 @@
 #pragma once
 
+#include "base/timer.hpp"
+
 #include "std/string.hpp"
 #include "std/vector.hpp"
 #include "std/utility.hpp"
@@ -10,6 +12,9 @@ namespace downloader
 {
 
 /// Single-threaded code
+/// A free server gets the first free chunk. When the server throughput is known, the next
+/// free chunks are joined into one range request, so a fast server gets requests of a couple
+/// of seconds and doesn't waste time on the requests latency.
 class ChunksDownloadStrategy
 {
 public:
@@ -38,9 +43,17 @@ private:
   struct ServerT
   {
     string m_url;
+    /// first chunk of the range being downloaded
     int m_chunkIndex;
-
-    ServerT(string const & url, int ind) : m_url(url), m_chunkIndex(ind) {}
+    /// number of chunks in the range being downloaded
+    int m_chunksCount;
+    /// measured throughput, 0 when it's unknown yet
+    double m_bytesPerSecond;
+    /// started with the range downloading
+    my::Timer m_timer;
+
+    ServerT(string const & url, int ind)
+      : m_url(url), m_chunkIndex(ind), m_chunksCount(0), m_bytesPerSecond(0.0) {}
   };
 
   vector<ServerT> m_servers;
@@ -54,8 +67,10 @@ private:
 
   typedef pair<int64_t, int64_t> RangeT;
 
-  /// @return Chunk pointer and it's index for given file offsets range.
+  /// @return First chunk pointer and it's index for given file offsets range.
   pair<ChunkT *, int> GetChunk(RangeT const & range);
+  /// @return Number of the free chunks from the index to download with one request.
+  int GetChunksCountForServer(ServerT const & server, size_t index) const;
 
 public:
   ChunksDownloadStrategy(vector<string> const & urls);
@@ -0,0 +1,141 @@
+#include "platform/chunks_hash_tree.hpp"
+
+#include "coding/file_reader.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/macros.hpp"
+
+#include "std/algorithm.hpp"
+
+namespace downloader
+{
+
+ChunksHashTree::ChunksHashTree(int64_t fileSize, int64_t chunkSize)
+  : m_fileSize(fileSize), m_chunkSize(chunkSize)
+{
+  ASSERT_GREATER(chunkSize, 0, ());
+  ASSERT_GREATER_OR_EQUAL(fileSize, 0, ());
+  m_digests.resize((fileSize + chunkSize - 1) / chunkSize);
+}
+
+int64_t ChunksHashTree::GetChunkEnd(size_t chunk) const
+{
+  return min(m_fileSize, static_cast<int64_t>(chunk + 1) * m_chunkSize);
+}
+
+void ChunksHashTree::OnWrite(int64_t offset, void const * data, size_t size)
+{
+  threads::MutexGuard guard(m_mutex);
+  UNUSED_VALUE(guard);
+
+  char const * p = static_cast<char const *>(data);
+  int64_t const end = min(m_fileSize, offset + static_cast<int64_t>(size));
+  while (offset < end)
+  {
+    size_t const chunk = static_cast<size_t>(offset / m_chunkSize);
+    int64_t const chunkEnd = GetChunkEnd(chunk);
+    size_t const partSize = static_cast<size_t>(min(end, chunkEnd) - offset);
+
+    auto it = m_pending.find(chunk);
+    if (offset == static_cast<int64_t>(chunk) * m_chunkSize)
+    {
+      // The chunk is (re)started.
+      m_digests[chunk].clear();
+      PendingChunk & pending = m_pending[chunk];
+      pending.m_next = offset;
+      pending.m_hasher.reset(new sha2::Hasher256());
+      it = m_pending.find(chunk);
+    }
+
+    if (it != m_pending.end() && it->second.m_next == offset)
+    {
+      it->second.m_hasher->Update(p, partSize);
+      it->second.m_next += partSize;
+      if (it->second.m_next == chunkEnd)
+      {
+        m_digests[chunk] = it->second.m_hasher->Digest(false);
+        m_pending.erase(it);
+      }
+    }
+    else if (it != m_pending.end())
+    {
+      // The chunk isn't written sequentially, it's read from the file at the end.
+      m_pending.erase(it);
+    }
+
+    offset += partSize;
+    p += partSize;
+  }
+}
+
+bool ChunksHashTree::HashMissingChunks(string const & filePath)
+{
+  threads::MutexGuard guard(m_mutex);
+  UNUSED_VALUE(guard);
+
+  m_pending.clear();
+  try
+  {
+    unique_ptr<FileReader> reader;
+    vector<char> buffer;
+    for (size_t chunk = 0; chunk < m_digests.size(); ++chunk)
+    {
+      if (!m_digests[chunk].empty())
+        continue;
+
+      if (!reader)
+        reader.reset(new FileReader(filePath));
+      int64_t const begin = static_cast<int64_t>(chunk) * m_chunkSize;
+      buffer.resize(static_cast<size_t>(GetChunkEnd(chunk) - begin));
+      reader->Read(begin, buffer.data(), buffer.size());
+
+      sha2::Hasher256 hasher;
+      hasher.Update(buffer.data(), buffer.size());
+      m_digests[chunk] = hasher.Digest(false);
+    }
+  }
+  catch (Reader::Exception const & ex)
+  {
+    LOG(LWARNING, ("Can't hash chunks of", filePath, ex.Msg()));
+    return false;
+  }
+  return true;
+}
+
+string ChunksHashTree::GetRootDigest() const
+{
+  threads::MutexGuard guard(m_mutex);
+  UNUSED_VALUE(guard);
+
+  sha2::Hasher256 hasher;
+  for (string const & digest : m_digests)
+  {
+    if (digest.empty())
+      return string();
+    hasher.Update(digest.data(), digest.size());
+  }
+  return hasher.Digest(true);
+}
+
+// static
+string ChunksHashTree::GetFileRootDigest(string const & filePath, int64_t chunkSize)
+{
+  uint64_t fileSize;
+  try
+  {
+    fileSize = FileReader(filePath).Size();
+  }
+  catch (Reader::Exception const & ex)
+  {
+    LOG(LWARNING, ("Can't open", filePath, ex.Msg()));
+    return string();
+  }
+
+  ChunksHashTree tree(fileSize, chunkSize);
+  if (!tree.HashMissingChunks(filePath))
+    return string();
+  return tree.GetRootDigest();
+}
+
+} // namespace downloader
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "coding/sha2.hpp"
+
+#include "base/mutex.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/map.hpp"
+#include "std/string.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+namespace downloader
+{
+
+/// Two level hash tree of a file: sha256 of each chunk and sha256 of the concatenated
+/// chunk digests as the root. The chunks are hashed while they are written, in any order,
+/// so the downloaded file isn't read again to be verified. Only the chunks which weren't
+/// written from the beginning (i.e. were downloaded before the resume) are read back.
+class ChunksHashTree
+{
+public:
+  /// Chunk size of the digests published for the downloaded files.
+  static int64_t const kDefaultChunkSize = 512 * 1024;
+
+  ChunksHashTree(int64_t fileSize, int64_t chunkSize);
+
+  /// Writes of a chunk must go one after another from the chunk beginning,
+  /// a chunk which is written again from the beginning is hashed again.
+  void OnWrite(int64_t offset, void const * data, size_t size);
+  /// Hashes the chunks, which weren't written completely, from the file.
+  /// @return false when the file can't be read.
+  bool HashMissingChunks(string const & filePath);
+  /// @return Hex root digest, the empty string when some chunks aren't hashed yet.
+  string GetRootDigest() const;
+
+  /// The root digest of the existing file, as it's served.
+  static string GetFileRootDigest(string const & filePath, int64_t chunkSize);
+
+private:
+  struct PendingChunk
+  {
+    int64_t m_next;
+    unique_ptr<sha2::Hasher256> m_hasher;
+  };
+
+  int64_t GetChunkEnd(size_t chunk) const;
+
+  int64_t m_fileSize;
+  int64_t m_chunkSize;
+  /// Binary digests, empty for the chunks which aren't hashed.
+  vector<string> m_digests;
+  map<size_t, PendingChunk> m_pending;
+  mutable threads::Mutex m_mutex;
+};
+
+} // namespace downloader
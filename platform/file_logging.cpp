@@ -1,11 +1,18 @@
 #include "platform/file_logging.hpp"
 
+#include "std/condition_variable.hpp"
 #include "std/mutex.hpp"
+#include "std/sstream.hpp"
+#include "std/thread.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
 
 #include "coding/file_writer.hpp"
 
 #include "platform/platform.hpp"
 
+#include "base/string_utils.hpp"
+
 namespace
 {
   tm * GetLocalTime()
@@ -16,40 +23,162 @@ namespace
     assert(localTime);
     return localTime;
   }
-}
-
-void LogMessageFile(my::LogLevel level, my::SrcPoint const & srcPoint, string const & msg)
-{
-  static mutex mtx;
-  static unique_ptr<FileWriter> file;
 
-  string recordType;
-  switch (level)
+  string MakeRecord(my::LogLevel level, my::SrcPoint const & srcPoint, string const & msg)
   {
-  case LINFO: recordType.assign("INFO "); break;
-  case LDEBUG: recordType.assign("DEBUG "); break;
-  case LWARNING: recordType.assign("WARN "); break;
-  case LERROR: recordType.assign("ERROR "); break;
-  case LCRITICAL: recordType.assign("FATAL "); break;
+    string recordType;
+    switch (level)
+    {
+    case LINFO: recordType.assign("INFO "); break;
+    case LDEBUG: recordType.assign("DEBUG "); break;
+    case LWARNING: recordType.assign("WARN "); break;
+    case LERROR: recordType.assign("ERROR "); break;
+    case LCRITICAL: recordType.assign("FATAL "); break;
+    }
+    return recordType + DebugPrint(srcPoint) + " " + msg + "\n";
   }
 
-  lock_guard<mutex> lock(mtx);
+  /// Log file of the process, the synchronous and the asynchronous records go to the same file
+  /// in the order they are logged.
+  class LogFile
+  {
+  public:
+    /// Number of the records which wait for the writing thread.
+    static size_t const kRingSize = 1024;
+
+    LogFile() : m_ring(kRingSize), m_head(0), m_count(0), m_dropped(0), m_stop(false) {}
+
+    ~LogFile()
+    {
+      {
+        lock_guard<mutex> lock(m_ringMutex);
+        m_stop = true;
+      }
+      m_cv.notify_one();
+      if (m_thread.joinable())
+        m_thread.join();
+    }
+
+    void Write(string const & record)
+    {
+      lock_guard<mutex> lock(m_fileMutex);
+      WriteRing();
+      WriteRecord(record);
+      if (m_file)
+        m_file->Flush();
+    }
+
+    /// Never waits for the file, the record is dropped when the ring is full.
+    void Push(string && record)
+    {
+      {
+        lock_guard<mutex> lock(m_ringMutex);
+        if (!m_thread.joinable())
+          m_thread = thread(&LogFile::ThreadMain, this);
+
+        if (m_count == kRingSize)
+        {
+          ++m_dropped;
+          return;
+        }
+        m_ring[(m_head + m_count) % kRingSize].swap(record);
+        ++m_count;
+      }
+      m_cv.notify_one();
+    }
+
+  private:
+    void ThreadMain()
+    {
+      while (true)
+      {
+        {
+          unique_lock<mutex> lock(m_ringMutex);
+          m_cv.wait(lock, [this]() { return m_stop || m_count != 0; });
+          if (m_stop && m_count == 0)
+            return;
+        }
 
-  if (file == nullptr)
+        lock_guard<mutex> lock(m_fileMutex);
+        WriteRing();
+        if (m_file)
+          m_file->Flush();
+      }
+    }
+
+    /// Writes the records of the ring, m_fileMutex must be locked.
+    void WriteRing()
+    {
+      vector<string> records;
+      size_t dropped;
+      {
+        lock_guard<mutex> lock(m_ringMutex);
+        records.resize(m_count);
+        for (string & record : records)
+        {
+          record.swap(m_ring[m_head]);
+          m_head = (m_head + 1) % kRingSize;
+        }
+        m_count = 0;
+        dropped = m_dropped;
+        m_dropped = 0;
+      }
+
+      for (string const & record : records)
+        WriteRecord(record);
+      if (dropped != 0)
+        WriteRecord(MakeRecord(LWARNING, my::SrcPoint(),
+                               "Log records are dropped: " + strings::to_string(dropped)));
+    }
+
+    /// m_fileMutex must be locked.
+    void WriteRecord(string const & record)
+    {
+      if (!m_file)
+      {
+        if (GetPlatform().WritableDir().empty())
+          return;
+        tm * curTimeTM = GetLocalTime();
+        stringstream fileName;
+        fileName << "logging_" << curTimeTM->tm_year + 1900 << "_" << curTimeTM->tm_mon + 1 << "_" << curTimeTM->tm_mday << "_"
+          << curTimeTM->tm_hour << "_" << curTimeTM->tm_min << "_" << curTimeTM->tm_sec << ".log";
+        m_file.reset(new FileWriter(GetPlatform().WritablePathForFile(fileName.str())));
+      }
+      m_file->Write(record.c_str(), record.size());
+    }
+
+    mutex m_fileMutex;
+    unique_ptr<FileWriter> m_file;
+
+    mutex m_ringMutex;
+    condition_variable m_cv;
+    vector<string> m_ring;
+    size_t m_head;
+    size_t m_count;
+    size_t m_dropped;
+    bool m_stop;
+    thread m_thread;
+  };
+
+  LogFile & GetLogFile()
   {
-    if (GetPlatform().WritableDir().empty())
-      return;
-    tm * curTimeTM = GetLocalTime();
-    stringstream fileName;
-    fileName << "logging_" << curTimeTM->tm_year + 1900 << "_" << curTimeTM->tm_mon + 1 << "_" << curTimeTM->tm_mday << "_"
-      << curTimeTM->tm_hour << "_" << curTimeTM->tm_min << "_" << curTimeTM->tm_sec << ".log";
-    file.reset(new FileWriter(GetPlatform().WritablePathForFile(fileName.str())));
+    static LogFile file;
+    return file;
   }
+}
 
-  string srcString = recordType + DebugPrint(srcPoint) + " " + msg + "\n";
+void LogMessageFile(my::LogLevel level, my::SrcPoint const & srcPoint, string const & msg)
+{
+  GetLogFile().Write(MakeRecord(level, srcPoint, msg));
+}
 
-  file->Write(srcString.c_str(), srcString.size());
-  file->Flush();
+void LogMessageFileAsync(my::LogLevel level, my::SrcPoint const & srcPoint, string const & msg)
+{
+  // The process may be aborted after the serious messages, so they are written at once.
+  if (level >= my::g_LogAbortLevel)
+    LogMessageFile(level, srcPoint, msg);
+  else
+    GetLogFile().Push(MakeRecord(level, srcPoint, msg));
 }
 
 void LogMemoryInfo()
@@ -17,7 +17,12 @@
 // # define OMIM_ENABLE_LOG_MEMORY_INFO
 // #endif
 
+/// Writes and flushes the record before returning.
 void LogMessageFile(my::LogLevel level, my::SrcPoint const & srcPoint, string const & msg);
+/// Puts the record to a ring buffer which is written to the same file by a background thread,
+/// so the caller never waits for the file. Records which don't fit into the full buffer are
+/// dropped and their count is logged. Messages of g_LogAbortLevel and above are written at once.
+void LogMessageFileAsync(my::LogLevel level, my::SrcPoint const & srcPoint, string const & msg);
 void LogMemoryInfo();
 
 #ifdef OMIM_ENABLE_LOG_MEMORY_INFO
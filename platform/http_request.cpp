@@ -1,5 +1,6 @@
 #include "platform/http_request.hpp"
 #include "platform/chunks_download_strategy.hpp"
+#include "platform/chunks_hash_tree.hpp"
 #include "platform/http_thread_callback.hpp"
 
 #include "defines.hpp"
@@ -146,6 +147,9 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
   string m_filePath;
   unique_ptr<FileWriter> m_writer;
 
+  string m_expectedDigest;
+  unique_ptr<ChunksHashTree> m_hashTree;
+
   size_t m_goodChunksCount;
   bool m_doCleanProgressFiles;
 
@@ -199,6 +203,8 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     {
       m_writer->Seek(offset);
       m_writer->Write(buffer, size);
+      if (m_hashTree)
+        m_hashTree->OnWrite(offset, buffer, size);
       return true;
     }
     catch (Writer::Exception const & e)
@@ -271,6 +277,14 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
       // 2. Free file handle.
       CloseWriter();
 
+      // 2.1. Check the digest, only the chunks downloaded before resume are read back.
+      if (m_status == ECompleted && !IsDigestValid())
+      {
+        m_status = EFailed;
+        (void)my::DeleteFileX(m_filePath + DOWNLOADING_FILE_EXTENSION);
+        (void)my::DeleteFileX(m_filePath + RESUME_FILE_EXTENSION);
+      }
+
       // 3. Clean up resume file with chunks range on success
       if (m_status == ECompleted)
       {
@@ -288,6 +302,24 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     }
   }
 
+  bool IsDigestValid()
+  {
+    if (!m_hashTree)
+      return true;
+
+    string const downloadingPath = m_filePath + DOWNLOADING_FILE_EXTENSION;
+    if (!m_hashTree->HashMissingChunks(downloadingPath))
+      return false;
+
+    string const digest = m_hashTree->GetRootDigest();
+    if (digest != m_expectedDigest)
+    {
+      LOG(LWARNING, (m_filePath, "is corrupted, digest:", digest, "expected:", m_expectedDigest));
+      return false;
+    }
+    return true;
+  }
+
   void CloseWriter()
   {
     try
@@ -305,12 +337,16 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
 public:
   FileHttpRequest(vector<string> const & urls, string const & filePath, int64_t fileSize,
                   CallbackT const & onFinish, CallbackT const & onProgress,
-                  int64_t chunkSize, bool doCleanProgressFiles)
+                  int64_t chunkSize, bool doCleanProgressFiles, string const & expectedDigest)
     : HttpRequest(onFinish, onProgress), m_strategy(urls), m_filePath(filePath),
-      m_goodChunksCount(0), m_doCleanProgressFiles(doCleanProgressFiles)
+      m_expectedDigest(expectedDigest), m_goodChunksCount(0),
+      m_doCleanProgressFiles(doCleanProgressFiles)
   {
     ASSERT ( !urls.empty(), () );
 
+    if (!m_expectedDigest.empty())
+      m_hashTree.reset(new ChunksHashTree(fileSize, ChunksHashTree::kDefaultChunkSize));
+
     // Load resume downloading information.
     m_progress.first = m_strategy.LoadOrInitChunks(m_filePath + RESUME_FILE_EXTENSION,
                                                    fileSize, chunkSize);
@@ -413,11 +449,13 @@ namespace
 HttpRequest * HttpRequest::GetFile(vector<string> const & urls,
                                    string const & filePath, int64_t fileSize,
                                    CallbackT const & onFinish, CallbackT const & onProgress,
-                                   int64_t chunkSize, bool doCleanOnCancel)
+                                   int64_t chunkSize, bool doCleanOnCancel,
+                                   string const & expectedDigest)
 {
   try
   {
-    return new FileHttpRequest(urls, filePath, fileSize, onFinish, onProgress, chunkSize, doCleanOnCancel);
+    return new FileHttpRequest(urls, filePath, fileSize, onFinish, onProgress, chunkSize,
+                               doCleanOnCancel, expectedDigest);
   }
   catch (FileWriter::Exception const & e)
   {
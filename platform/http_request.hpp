@@ -52,12 +52,16 @@ public:
 
   /// Download file to filePath.
   /// @param[in]  fileSize  Correct file size (needed for resuming and reserving).
+  /// @param[in]  expectedDigest  ChunksHashTree root digest of the file, if it isn't empty
+  ///                             the file is hashed while it's written and the download
+  ///                             fails on mismatch.
   static HttpRequest * GetFile(vector<string> const & urls,
                                string const & filePath, int64_t fileSize,
                                CallbackT const & onFinish,
                                CallbackT const & onProgress = CallbackT(),
                                int64_t chunkSize = 512 * 1024,
-                               bool doCleanOnCancel = true);
+                               bool doCleanOnCancel = true,
+                               string const & expectedDigest = string());
 };
 
 } // namespace downloader
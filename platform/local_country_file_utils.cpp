@@ -4,6 +4,7 @@
 
 #include "coding/file_name_utils.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/mmap_reader.hpp"
 #include "coding/reader.hpp"
 
 #include "base/string_utils.hpp"
@@ -12,6 +13,7 @@
 #include "std/algorithm.hpp"
 #include "std/cctype.hpp"
 #include "std/sstream.hpp"
+#include "std/target_os.hpp"
 #include "std/unique_ptr.hpp"
 
 
@@ -235,7 +237,24 @@ ModelReader * GetCountryReader(platform::LocalCountryFile const & file, MapOptio
   // See LocalCountryFile comment for explanation.
   if (file.GetDirectory().empty())
     return platform.GetReader(file.GetCountryName() + DATA_FILE_EXTENSION, GetSpecialFilesSearchScope());
-  return platform.GetReader(file.GetPath(options), "f");
+
+  string const path = file.GetPath(options);
+#ifndef OMIM_OS_WINDOWS
+  // Files on disk are memory mapped when the address space is big enough, so the sections
+  // are decoded in place (see MappedSection).
+  if (sizeof(void *) >= 8)
+  {
+    try
+    {
+      return new MmapReader(path);
+    }
+    catch (Reader::OpenException const & e)
+    {
+      LOG(LWARNING, ("Can't map", path, e.Msg()));
+    }
+  }
+#endif
+  return platform.GetReader(path, "f");
 }
 
 // static
@@ -63,6 +63,7 @@ macx-*|iphone* {
 
 HEADERS += \
     chunks_download_strategy.hpp \
+    chunks_hash_tree.hpp \
     constants.hpp \
     country_defines.hpp \
     country_file.hpp \
@@ -83,6 +84,7 @@ HEADERS += \
 
 SOURCES += \
     chunks_download_strategy.cpp \
+    chunks_hash_tree.cpp \
     country_defines.cpp \
     country_file.cpp \
     file_logging.cpp \
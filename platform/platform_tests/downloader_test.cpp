@@ -2,6 +2,7 @@
 
 #include "platform/http_request.hpp"
 #include "platform/chunks_download_strategy.hpp"
+#include "platform/chunks_hash_tree.hpp"
 #include "platform/platform.hpp"
 
 #include "defines.hpp"
@@ -12,7 +13,9 @@
 #include "coding/internal/file_data.hpp"
 
 #include "base/logging.hpp"
+#include "base/scope_guard.hpp"
 #include "base/std_serialization.hpp"
+#include "base/thread.hpp"
 
 #include "std/bind.hpp"
 #include "std/unique_ptr.hpp"
@@ -328,6 +331,84 @@ UNIT_TEST(ChunksDownloadStrategyFAIL)
   TEST_EQUAL(strategy.NextChunk(s2, r2), ChunksDownloadStrategy::EDownloadFailed, ());
 }
 
+UNIT_TEST(ChunksDownloadStrategyJoinsChunks)
+{
+  typedef pair<int64_t, int64_t> RangeT;
+
+  vector<string> servers;
+  servers.push_back("UrlOfServer1");
+
+  int64_t const FILE_SIZE = 100 * 1024 * 1024;
+  int64_t const CHUNK_SIZE = 1024 * 1024;
+  ChunksDownloadStrategy strategy(servers);
+  strategy.InitChunks(FILE_SIZE, CHUNK_SIZE);
+
+  // Throughput is unknown, so a single chunk is requested.
+  string s;
+  RangeT r;
+  TEST_EQUAL(strategy.NextChunk(s, r), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(r, RangeT(0, CHUNK_SIZE - 1), ());
+
+  // Some MB per second is measured.
+  threads::Sleep(200);
+  strategy.ChunkFinished(true, r);
+
+  TEST_EQUAL(strategy.NextChunk(s, r), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(r.first, CHUNK_SIZE, ());
+  TEST_GREATER(r.second - r.first + 1, CHUNK_SIZE, ());
+  TEST_LESS(r.second, FILE_SIZE, ());
+  TEST_EQUAL((r.second + 1) % CHUNK_SIZE, 0, ());
+
+  int64_t downloaded = CHUNK_SIZE + r.second - r.first + 1;
+  strategy.ChunkFinished(true, r);
+  ChunksDownloadStrategy::ResultT result;
+  while ((result = strategy.NextChunk(s, r)) == ChunksDownloadStrategy::ENextChunk)
+  {
+    TEST_EQUAL(r.first, downloaded, ());
+    downloaded += r.second - r.first + 1;
+    strategy.ChunkFinished(true, r);
+  }
+  TEST_EQUAL(result, ChunksDownloadStrategy::EDownloadSucceeded, ());
+  TEST_EQUAL(downloaded, FILE_SIZE, ());
+}
+
+UNIT_TEST(ChunksHashTreeOutOfOrder)
+{
+  string const fileName = "chunks_hash_tree.tmp";
+  int64_t const kChunkSize = 1000;
+  string data;
+  for (int i = 0; i < 3500; ++i)
+    data.push_back(static_cast<char>(i * 7));
+  {
+    FileWriter writer(fileName);
+    writer.Write(data.data(), data.size());
+  }
+  MY_SCOPE_GUARD(deleteFile, bind(&my::DeleteFileX, cref(fileName)));
+
+  string const expected = ChunksHashTree::GetFileRootDigest(fileName, kChunkSize);
+  TEST(!expected.empty(), ());
+
+  ChunksHashTree tree(data.size(), kChunkSize);
+  // The second range goes first, it's written by parts across a chunk boundary.
+  tree.OnWrite(2000, &data[2000], 700);
+  tree.OnWrite(2700, &data[2700], 800);
+  // The first chunk is failed at the middle and downloaded again.
+  tree.OnWrite(0, &data[0], 300);
+  tree.OnWrite(0, &data[0], 1000);
+  TEST(tree.GetRootDigest().empty(), ("Chunk 1 isn't written"));
+
+  // Chunk 1 is resumed from the middle, so it's read from the file.
+  tree.OnWrite(1500, &data[1500], 500);
+  TEST(tree.HashMissingChunks(fileName), ());
+  TEST_EQUAL(tree.GetRootDigest(), expected, ());
+
+  ChunksHashTree corrupted(data.size(), kChunkSize);
+  string wrong = data;
+  wrong[2500] ^= 1;
+  corrupted.OnWrite(0, wrong.data(), wrong.size());
+  TEST_NOT_EQUAL(corrupted.GetRootDigest(), expected, ());
+}
+
 namespace
 {
   string ReadFileAsString(string const & file)
@@ -34,4 +34,5 @@ SOURCES += \
     location_test.cpp \
     measurement_tests.cpp \
     platform_test.cpp \
+    settings_test.cpp \
     video_timer_test.cpp \
@@ -0,0 +1,40 @@
+#include "testing/testing.hpp"
+
+#include "platform/platform.hpp"
+#include "platform/settings.hpp"
+
+#include "coding/file_reader.hpp"
+
+#include "defines.hpp"
+
+#include "std/string.hpp"
+
+namespace
+{
+string ReadSettingsFile()
+{
+  string contents;
+  FileReader(GetPlatform().SettingsPathForFile(SETTINGS_FILE_NAME)).ReadAsString(contents);
+  return contents;
+}
+}  // namespace
+
+UNIT_TEST(Settings_Flush)
+{
+  string const kKey = "SettingsFlushTestKey";
+
+  Settings::Set(kKey, string("first"));
+  Settings::Set(kKey, string("second"));
+  Settings::Flush();
+  TEST(ReadSettingsFile().find(kKey + "=second\n") != string::npos, ());
+
+  string value;
+  TEST(Settings::Get(kKey, value), ());
+  TEST_EQUAL(value, "second", ());
+
+  Settings::Delete(kKey);
+  Settings::Flush();
+  TEST(ReadSettingsFile().find(kKey) == string::npos, ());
+  TEST(!GetPlatform().IsFileExistsByFullPath(
+           GetPlatform().SettingsPathForFile(SETTINGS_FILE_NAME) + ".tmp"), ());
+}
@@ -6,12 +6,14 @@
 #include "coding/reader_streambuf.hpp"
 #include "coding/file_writer.hpp"
 #include "coding/file_reader.hpp"
+#include "coding/internal/file_data.hpp"
 
 #include "geometry/rect2d.hpp"
 #include "geometry/any_rect2d.hpp"
 
 #include "base/logging.hpp"
 
+#include "std/chrono.hpp"
 #include "std/cmath.hpp"
 #include "std/iostream.hpp"
 #include "std/sstream.hpp"
@@ -21,9 +23,15 @@
 
 static char const DELIM_CHAR = '=';
 
+namespace
+{
+// Changes which come during this time after the first one are saved together.
+auto const kSaveDelay = seconds(2);
+}  // namespace
+
 namespace Settings
 {
-  StringStorage::StringStorage()
+  StringStorage::StringStorage() : m_isDirty(false), m_isStopped(false)
   {
     lock_guard<mutex> guard(m_mutex);
 
@@ -53,20 +61,77 @@ namespace Settings
     {
       LOG(LWARNING, (ex.Msg()));
     }
+
+    m_saver = thread(&StringStorage::SaveLoop, this);
+  }
+
+  StringStorage::~StringStorage()
+  {
+    {
+      lock_guard<mutex> guard(m_mutex);
+      m_isStopped = true;
+    }
+    m_cv.notify_one();
+    m_saver.join();
+
+    SaveIfDirty();
+  }
+
+  void StringStorage::SaveLoop()
+  {
+    unique_lock<mutex> lock(m_mutex);
+    while (true)
+    {
+      m_cv.wait(lock, [this]() { return m_isDirty || m_isStopped; });
+      m_cv.wait_for(lock, kSaveDelay, [this]() { return m_isStopped; });
+      if (m_isStopped)
+        return;
+
+      lock.unlock();
+      SaveIfDirty();
+      lock.lock();
+    }
   }
 
-  void StringStorage::Save() const
+  void StringStorage::SaveIfDirty()
   {
+    lock_guard<mutex> saveGuard(m_saveMutex);
+
+    ContainerT values;
+    {
+      lock_guard<mutex> guard(m_mutex);
+      if (!m_isDirty)
+        return;
+      values = m_values;
+      m_isDirty = false;
+    }
+    Save(values);
+  }
+
+  // static
+  void StringStorage::Save(ContainerT const & values)
+  {
+    string const path = GetPlatform().SettingsPathForFile(SETTINGS_FILE_NAME);
+    string const tmpPath = path + ".tmp";
     try
     {
-      FileWriter file(GetPlatform().SettingsPathForFile(SETTINGS_FILE_NAME));
-      for (auto const & value : m_values)
       {
-        string line(value.first);
-        line += DELIM_CHAR;
-        line += value.second;
-        line += "\n";
-        file.Write(line.data(), line.size());
+        FileWriter file(tmpPath);
+        for (auto const & value : values)
+        {
+          string line(value.first);
+          line += DELIM_CHAR;
+          line += value.second;
+          line += "\n";
+          file.Write(line.data(), line.size());
+        }
+      }
+
+      // Rename doesn't replace the existing file on Windows.
+      if (!my::RenameFileX(tmpPath, path) &&
+          !(my::DeleteFileX(path) && my::RenameFileX(tmpPath, path)))
+      {
+        LOG(LWARNING, ("Can't rename", tmpPath, "to", path));
       }
     }
     catch (RootException const & ex)
@@ -99,7 +164,8 @@ namespace Settings
     lock_guard<mutex> guard(m_mutex);
 
     m_values[key] = move(value);
-    Save();
+    m_isDirty = true;
+    m_cv.notify_one();
   }
 
   void StringStorage::DeleteKeyAndValue(string const & key)
@@ -110,10 +176,16 @@ namespace Settings
     if (found != m_values.end())
     {
       m_values.erase(found);
-      Save();
+      m_isDirty = true;
+      m_cv.notify_one();
     }
   }
 
+  void StringStorage::Flush()
+  {
+    SaveIfDirty();
+  }
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 
   template <> string ToString<string>(string const & str)
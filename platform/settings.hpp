@@ -1,23 +1,40 @@
 #pragma once
 
-#include "std/string.hpp"
+#include "std/condition_variable.hpp"
 #include "std/map.hpp"
 #include "std/mutex.hpp"
+#include "std/string.hpp"
+#include "std/thread.hpp"
 
 namespace Settings
 {
   template <class T> bool FromString(string const & str, T & outValue);
   template <class T> string ToString(T const & value);
 
+  /// Values are kept in memory and saved in the background some time after a change,
+  /// so the frequent changes are written to the file at once.
   class StringStorage
   {
     typedef map<string, string> ContainerT;
     ContainerT m_values;
+    /// Values are changed since the last saving.
+    bool m_isDirty;
+    bool m_isStopped;
 
     mutable mutex m_mutex;
+    condition_variable m_cv;
+    /// Serializes the file writes, so the last values are written last.
+    mutex m_saveMutex;
+    thread m_saver;
 
     StringStorage();
-    void Save() const;
+    ~StringStorage();
+
+    void SaveLoop();
+    void SaveIfDirty();
+    /// Writes the values to a temporary file which replaces the settings file,
+    /// so the settings file is never written partially.
+    static void Save(ContainerT const & values);
 
   public:
     static StringStorage & Instance();
@@ -25,6 +42,8 @@ namespace Settings
     bool GetValue(string const & key, string & outValue) const;
     void SetValue(string const & key, string && value);
     void DeleteKeyAndValue(string const & key);
+    /// Saves the changed values now.
+    void Flush();
   };
 
   /// Retrieve setting
@@ -35,7 +54,7 @@ namespace Settings
     return StringStorage::Instance().GetValue(key, strVal)
         && FromString(strVal, outValue);
   }
-  /// Automatically saves setting to external file
+  /// Setting is saved to external file in the background
   template <class ValueT> void Set(string const & key, ValueT const & value)
   {
     StringStorage::Instance().SetValue(key, ToString(value));
@@ -46,6 +65,13 @@ namespace Settings
     StringStorage::Instance().DeleteKeyAndValue(key);
   }
 
+  /// Saves the changed settings synchronously. Call it when the app may be killed,
+  /// e.g. on going to background, the changes are lost otherwise.
+  inline void Flush()
+  {
+    StringStorage::Instance().Flush();
+  }
+
   // @TODO(vbykoianko) For the time being two enums which are reflected length units are used.
   // This enum should be replaced with enum class LengthUnits.
   enum Units { Metric = 0, Foot };
@@ -16,6 +16,9 @@
 #include "platform/settings.hpp"
 #include "platform/platform.hpp"
 
+#include "base/logging.hpp"
+#include "base/tracing.hpp"
+
 #include "std/bind.hpp"
 
 #include <QtGui/QCloseEvent>
@@ -23,12 +26,14 @@
 #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
   #include <QtGui/QAction>
   #include <QtGui/QDockWidget>
+  #include <QtGui/QFileDialog>
   #include <QtGui/QMenu>
   #include <QtGui/QMenuBar>
   #include <QtGui/QToolBar>
 #else
   #include <QtWidgets/QAction>
   #include <QtWidgets/QDockWidget>
+  #include <QtWidgets/QFileDialog>
   #include <QtWidgets/QMenu>
   #include <QtWidgets/QMenuBar>
   #include <QtWidgets/QToolBar>
@@ -84,6 +89,7 @@ MainWindow::MainWindow() : m_locationService(CreateDesktopLocationService(*this)
   menuBar()->addMenu(helpMenu);
   helpMenu->addAction(tr("About"), this, SLOT(OnAbout()));
   helpMenu->addAction(tr("Preferences"), this, SLOT(OnPreferences()));
+  m_pTracingAction = helpMenu->addAction(tr("Start tracing"), this, SLOT(OnTracing()));
 #else
   {
     // create items in the system menu
@@ -387,6 +393,24 @@ void MainWindow::OnPreferences()
   m_pDrawWidget->GetFramework().SetupMeasurementSystem();
 }
 
+void MainWindow::OnTracing()
+{
+  if (!my::tracing::IsStarted())
+  {
+    my::tracing::Start();
+    m_pTracingAction->setText(tr("Stop tracing and save..."));
+    return;
+  }
+
+  my::tracing::Stop();
+  m_pTracingAction->setText(tr("Start tracing"));
+
+  QString const path = QFileDialog::getSaveFileName(this, tr("Save trace"), "trace.json",
+                                                    tr("Chrome trace (*.json)"));
+  if (!path.isEmpty() && !my::tracing::WriteChromeTrace(path.toStdString()))
+    LOG(LWARNING, ("Can't write the trace to", path.toStdString()));
+}
+
 #ifndef NO_DOWNLOADER
 void MainWindow::ShowUpdateDialog()
 {
@@ -30,6 +30,7 @@ namespace qt
   {
     QAction * m_pMyPositionAction;
     QAction * m_pSearchAction;
+    QAction * m_pTracingAction;
 #ifndef USE_DRAPE
     DrawWidget * m_pDrawWidget;
 #else
@@ -76,6 +77,8 @@ namespace qt
 
     void OnPreferences();
     void OnAbout();
+    /// Starts tracing, or stops it and saves the Chrome trace of the threads.
+    void OnTracing();
     void OnMyPosition();
     void OnSearchButtonClicked();
   };
@@ -64,7 +64,7 @@ macx-* {
 
 OTHER_RES.path = $$DATADIR
 OTHER_RES.files = ../data/copyright.html ../data/eula.html ../data/welcome.html \
-                  ../data/countries.txt \
+                  ../data/countries.txt ../data/countries.bin \
                   ../data/languages.txt ../data/categories.txt \
                   ../data/packed_polygons.bin res/logo.png
 CLASSIFICATOR_RES.path = $$DATADIR
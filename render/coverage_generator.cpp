@@ -263,11 +263,16 @@ void CoverageGenerator::MergeTileImpl(core::CommandsQueue::Environment const & e
 void CoverageGenerator::InvalidateTilesImpl(m2::AnyRectD const & r, int startScale)
 {
   TileCache & tileCache = m_coverageInfo.m_tileRenderer->GetTileCache();
-  tileCache.Lock();
 
   {
     threads::MutexGuard g(m_stateInfo.m_mutex);
 
+    /// removed tiles are deleted before merging, so the overlay is merged from scratch
+    m_coverageInfo.m_overlay->lock();
+    m_coverageInfo.m_overlay->clear();
+    m_coverageInfo.m_overlay->unlock();
+    m_coverageInfo.m_mergedTiles.clear();
+
     typedef buffer_vector<Tile const *, 8> vector8_t;
     vector8_t toRemove;
 
@@ -280,7 +285,7 @@ void CoverageGenerator::InvalidateTilesImpl(m2::AnyRectD const & r, int startSca
       if (r.IsIntersect(m2::AnyRectD(ri.m_rect)) && (ri.m_tileScale >= startScale))
       {
         toRemove.push_back(*it);
-        tileCache.UnlockTile(ri);
+        tileCache.UnpinTile(ri);
       }
     }
 
@@ -292,20 +297,10 @@ void CoverageGenerator::InvalidateTilesImpl(m2::AnyRectD const & r, int startSca
     }
   }
 
-  /// here we should copy elements as we've delete some of them later
-  set<Tiler::RectInfo> k = tileCache.Keys();
-
-  for (set<Tiler::RectInfo>::const_iterator it = k.begin(); it != k.end(); ++it)
+  tileCache.RemoveTiles([&r, startScale](Tiler::RectInfo const & ri)
   {
-    Tiler::RectInfo const & ri = *it;
-    if ((ri.m_tileScale >= startScale) && r.IsIntersect(m2::AnyRectD(ri.m_rect)))
-    {
-      ASSERT(tileCache.LockCount(ri) == 0, ());
-      tileCache.Remove(ri);
-    }
-  }
-
-  tileCache.Unlock();
+    return (ri.m_tileScale >= startScale) && r.IsIntersect(m2::AnyRectD(ri.m_rect));
+  });
 
   MergeOverlay();
 }
@@ -324,7 +319,6 @@ void CoverageGenerator::ComputeCoverTasks()
   m_coverageInfo.m_tiler.tiles(allRects, GetPlatform().PreCachingDepth());
 
   TileCache & tileCache = m_coverageInfo.m_tileRenderer->GetTileCache();
-  tileCache.Lock();
 
   int const step = GetPlatform().PreCachingDepth() - 1;
 
@@ -340,10 +334,11 @@ void CoverageGenerator::ComputeCoverTasks()
       continue;
     }
 
-    if (tileCache.HasTile(ri))
+    /// tiles of the new coverage are pinned while they are taken,
+    /// so they can't be evicted by the tile renderers in the meantime
+    Tile const * tile = tileCache.PinTile(ri);
+    if (tile != nullptr)
     {
-      tileCache.TouchTile(ri);
-      Tile const * tile = &tileCache.GetTile(ri);
       ASSERT(tiles.find(tile) == tiles.end(), ());
 
       if (m_coverageInfo.m_tiler.isLeaf(ri))
@@ -361,45 +356,19 @@ void CoverageGenerator::ComputeCoverTasks()
 
   m_backCoverage->m_isEmptyDrawing = isEmptyDrawingBuf;
 
-  /// computing difference between current and previous coverage
-  /// tiles, that aren't in current coverage are unlocked to allow their deletion from TileCache
-  /// tiles, that are new to the current coverage are added into m_tiles and locked in TileCache
-
-  size_t firstTileForAdd = 0;
-  buffer_vector<const Tile *, 64> diff_tiles;
-  diff_tiles.reserve(m_coverageInfo.m_tiles.size() + tiles.size());
-#ifdef _MSC_VER
-    vs_bug::
-#endif
-  set_difference(m_coverageInfo.m_tiles.begin(), m_coverageInfo.m_tiles.end(),
-                 tiles.begin(), tiles.end(),
-                 back_inserter(diff_tiles), tiles.key_comp());
-
-  firstTileForAdd = diff_tiles.size();
-#ifdef _MSC_VER
-    vs_bug::
-#endif
-  set_difference(tiles.begin(), tiles.end(),
-                 m_coverageInfo.m_tiles.begin(), m_coverageInfo.m_tiles.end(),
-                 back_inserter(diff_tiles), tiles.key_comp());
-
-  for (size_t i = 0; i < firstTileForAdd; ++i)
-    tileCache.UnlockTile(diff_tiles[i]->m_rectInfo);
-
-  for (size_t i = firstTileForAdd; i < diff_tiles.size(); ++i)
-    tileCache.LockTile(diff_tiles[i]->m_rectInfo);
-
-  tileCache.Unlock();
-
-  m_coverageInfo.m_tiles = tiles;
+  m_coverageInfo.m_tiles.swap(tiles);
   MergeOverlay();
 
+  /// tiles of the previous coverage are unpinned to allow their deletion from TileCache,
+  /// the ones of the current coverage stay pinned. It's done after merging, as the merged
+  /// overlay refers to the previous tiles.
+  for (Tile const * tile : tiles)
+    tileCache.UnpinTile(tile->m_rectInfo);
+
   /// clearing all old commands
   m_coverageInfo.m_tileRenderer->ClearCommands();
-  /// setting new sequenceID
+  /// setting new sequenceID, it cancels the tiles of the previous sequences being rendered
   m_coverageInfo.m_tileRenderer->SetSequenceID(m_stateInfo.m_sequenceID);
-  /// @todo After ClearCommands i think we have no commands to cancel.
-  m_coverageInfo.m_tileRenderer->CancelCommands();
 
   m_benchmarkInfo.m_tilesCount = newRects.size();
   m_benchmarkInfo.m_benchmarkSequenceID = m_stateInfo.m_sequenceID;
@@ -413,39 +382,74 @@ void CoverageGenerator::ComputeCoverTasks()
     chain.addCommand(bind(&CoverageGenerator::MergeTile,
                           this, ri, m_stateInfo.m_sequenceID));
 
-    m_coverageInfo.m_tileRenderer->AddCommand(ri, m_stateInfo.m_sequenceID, chain);
+    /// leaf tiles are on the screen, the others are prefetched
+    core::CommandsQueue::EPriority const priority = m_coverageInfo.m_tiler.isLeaf(ri)
+        ? core::CommandsQueue::EHighPriority : core::CommandsQueue::ELowPriority;
+    m_coverageInfo.m_tileRenderer->AddCommand(ri, m_stateInfo.m_sequenceID, chain, priority);
   }
 }
 
 void CoverageGenerator::MergeOverlay()
 {
-  m_coverageInfo.m_overlay->lock();
-  m_coverageInfo.m_overlay->clear();
+  ScreenBase const & screen = m_stateInfo.m_currentScreen;
 
+  CoverageInfo::TTileSet leafTiles;
   for (Tile const * tile : m_coverageInfo.m_tiles)
   {
-    Tiler::RectInfo const & ri = tile->m_rectInfo;
-    if (m_coverageInfo.m_tiler.isLeaf(ri))
+    if (m_coverageInfo.m_tiler.isLeaf(tile->m_rectInfo))
+      leafTiles.insert(tile);
+  }
+
+  /// elements of the removed tiles could hide the ones of the other tiles,
+  /// and the elements collide in the other way when the screen is scaled or rotated
+  ScreenBase const & merged = m_coverageInfo.m_mergedScreen;
+  bool canReuse = merged.GetScale() == screen.GetScale() && merged.GetAngle() == screen.GetAngle() &&
+                  merged.PixelRect() == screen.PixelRect();
+  for (auto it = m_coverageInfo.m_mergedTiles.begin(); canReuse && it != m_coverageInfo.m_mergedTiles.end(); ++it)
+    canReuse = (leafTiles.count(*it) != 0);
+
+  m_coverageInfo.m_overlay->lock();
+
+  if (!canReuse)
+  {
+    m_coverageInfo.m_overlay->clear();
+    m_coverageInfo.m_mergedTiles.clear();
+  }
+  else if (!(merged == screen))
+  {
+    MoveMergedOverlay(screen);
+  }
+
+  for (Tile const * tile : leafTiles)
+  {
+    if (m_coverageInfo.m_mergedTiles.count(tile) == 0)
       m_coverageInfo.m_overlay->merge(tile->m_overlay,
-                                      tile->m_tileScreen.PtoGMatrix() * m_stateInfo.m_currentScreen.GtoPMatrix());
+                                      tile->m_tileScreen.PtoGMatrix() * screen.GtoPMatrix());
   }
 
   m_coverageInfo.m_overlay->unlock();
+
+  m_coverageInfo.m_mergedTiles.swap(leafTiles);
+  m_coverageInfo.m_mergedScreen = screen;
+}
+
+void CoverageGenerator::MoveMergedOverlay(ScreenBase const & screen)
+{
+  graphics::Overlay::LayersT layers;
+  layers.reserve(m_coverageInfo.m_mergedTiles.size());
+  for (Tile const * tile : m_coverageInfo.m_mergedTiles)
+    layers.emplace_back(tile->m_overlay, tile->m_tileScreen.PtoGMatrix() * screen.GtoPMatrix());
+
+  /// the elements are moved all together, so the ones which are hidden stay hidden
+  m_coverageInfo.m_overlay->move(layers);
 }
 
 void CoverageGenerator::MergeSingleTile(Tiler::RectInfo const & rectInfo)
 {
   m_coverageInfo.m_tileRenderer->CacheActiveTile(rectInfo);
   TileCache & tileCache = m_coverageInfo.m_tileRenderer->GetTileCache();
-  tileCache.Lock();
-
-  Tile const * tile = NULL;
-  if (tileCache.HasTile(rectInfo))
-  {
-    tileCache.LockTile(rectInfo);
-    tile = &tileCache.GetTile(rectInfo);
-  }
 
+  Tile const * tile = tileCache.PinTile(rectInfo);
   if (tile != NULL)
   {
     m_coverageInfo.m_tiles.insert(tile);
@@ -457,15 +461,8 @@ void CoverageGenerator::MergeSingleTile(Tiler::RectInfo const & rectInfo)
     }
   }
 
-  tileCache.Unlock();
-
   if (tile != NULL && m_coverageInfo.m_tiler.isLeaf(rectInfo))
-  {
-    m_coverageInfo.m_overlay->lock();
-    m_coverageInfo.m_overlay->merge(tile->m_overlay,
-                                    tile->m_tileScreen.PtoGMatrix() * m_stateInfo.m_currentScreen.GtoPMatrix());
-    m_coverageInfo.m_overlay->unlock();
-  }
+    MergeOverlay();
 }
 
 namespace
@@ -570,19 +567,16 @@ void CoverageGenerator::ClearCoverage()
 
   TileCache & tileCache = m_coverageInfo.m_tileRenderer->GetTileCache();
 
-  tileCache.Lock();
-
   for (CoverageInfo::TTileSet::const_iterator it = m_coverageInfo.m_tiles.begin();
        it != m_coverageInfo.m_tiles.end();
        ++it)
   {
     Tiler::RectInfo const & ri = (*it)->m_rectInfo;
-    tileCache.UnlockTile(ri);
+    tileCache.UnpinTile(ri);
   }
 
-  tileCache.Unlock();
-
   m_coverageInfo.m_tiles.clear();
+  m_coverageInfo.m_mergedTiles.clear();
 
   delete m_currentCoverage;
   m_currentCoverage = 0;
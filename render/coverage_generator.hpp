@@ -103,7 +103,11 @@ private:
 private:
   void FinishSequenceIfNeeded();
   void ComputeCoverTasks();
+  /// Brings m_coverageInfo.m_overlay to the leaf tiles of m_coverageInfo.m_tiles and
+  /// the current screen. Only the added tiles are merged while the tiles aren't removed and
+  /// the screen is moved only, otherwise the overlay is merged from scratch.
   void MergeOverlay();
+  void MoveMergedOverlay(ScreenBase const & screen);
   void MergeSingleTile(Tiler::RectInfo const & rectInfo);
   bool CacheCoverage(core::CommandsQueue::Environment const & env);
 
@@ -159,6 +163,10 @@ private:
     TTileSet m_tiles;
 
     graphics::Overlay * m_overlay;
+    /// Leaf tiles which are merged into m_overlay, they are pinned as the ones of m_tiles,
+    /// and the screen the overlay is transformed to.
+    TTileSet m_mergedTiles;
+    ScreenBase m_mergedScreen;
   } m_coverageInfo;
 
   struct CachedCoverageInfo
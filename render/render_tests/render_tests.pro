@@ -5,7 +5,7 @@ TEMPLATE = app
 
 ROOT_DIR = ../..
 
-DEPENDENCIES = render indexer platform geometry coding base
+DEPENDENCIES = render graphics indexer platform geometry coding base
 
 
 include($$ROOT_DIR/common.pri)
@@ -14,3 +14,4 @@ include($$ROOT_DIR/common.pri)
 SOURCES += \
     ../../testing/testingmain.cpp \
     feature_processor_test.cpp \
+    tile_cache_test.cpp \
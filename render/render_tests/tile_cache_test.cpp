@@ -0,0 +1,84 @@
+#include "testing/testing.hpp"
+
+#include "render/tile_cache.hpp"
+
+#include "base/thread.hpp"
+
+#include "std/vector.hpp"
+
+namespace
+{
+TileCache::Entry MakeEntry(Tiler::RectInfo const & key)
+{
+  Tile tile;
+  tile.m_rectInfo = key;
+  return TileCache::Entry(tile, shared_ptr<graphics::ResourceManager>());
+}
+}  // namespace
+
+UNIT_TEST(TileCache_EvictsUnpinned)
+{
+  TileCache cache;
+  cache.Resize(2);
+
+  Tiler::RectInfo const a(10, 1, 1);
+  Tiler::RectInfo const b(10, 1, 2);
+  Tiler::RectInfo const c(10, 1, 3);
+
+  cache.AddTile(a, MakeEntry(a));
+  cache.AddTile(b, MakeEntry(b));
+  TEST_EQUAL(cache.UnpinnedWeight(), 2, ());
+
+  Tile const * tile = cache.PinTile(a);
+  TEST(tile != nullptr, ());
+  TEST(tile->m_rectInfo == a, ());
+  TEST_EQUAL(cache.PinCount(a), 1, ());
+  TEST_EQUAL(cache.PinnedWeight(), 1, ());
+  TEST_EQUAL(cache.CanFit(), 1, ());
+
+  // The pinned tile isn't evicted.
+  cache.AddTile(c, MakeEntry(c));
+  TEST(cache.HasTile(a), ());
+  TEST(!cache.HasTile(b), ());
+  TEST(cache.HasTile(c), ());
+  TEST(cache.PinTile(b) == nullptr, ());
+
+  cache.UnpinTile(a);
+  TEST_EQUAL(cache.PinCount(a), 0, ());
+  TEST_EQUAL(cache.PinnedWeight(), 0, ());
+
+  cache.Resize(1);
+  TEST_EQUAL(cache.UnpinnedWeight(), 1, ());
+
+  cache.RemoveTiles([](Tiler::RectInfo const &) { return true; });
+  TEST_EQUAL(cache.UnpinnedWeight(), 0, ());
+}
+
+UNIT_TEST(TileCache_ConcurrentAccess)
+{
+  int const kTilesCount = 64;
+  int const kThreadsCount = 4;
+
+  TileCache cache;
+  cache.Resize(kTilesCount / 2);
+
+  vector<threads::SimpleThread> threads;
+  for (int t = 0; t < kThreadsCount; ++t)
+  {
+    threads.emplace_back([&cache, t]()
+    {
+      for (int i = 0; i < kTilesCount; ++i)
+      {
+        Tiler::RectInfo const key(12, t, i);
+        cache.AddTile(key, MakeEntry(key));
+        if (cache.PinTile(key) != nullptr)
+          cache.UnpinTile(key);
+      }
+    });
+  }
+  for (threads::SimpleThread & thread : threads)
+    thread.join();
+
+  TEST_EQUAL(cache.PinnedWeight(), 0, ());
+  TEST_EQUAL(cache.UnpinnedWeight(), kTilesCount / 2, ());
+}
@@ -34,6 +34,10 @@ uint8_t const kAlphaValue[] =
 
 int const kArrowAppearingZoomLevel = 14;
 
+// Arrows whose turns are farther from the screen than this number of arrow half lengths
+// aren't calculated.
+double const kCullingMarginFactor = 8.0;
+
 enum SegmentStatus
 {
   OK = -1,
@@ -163,11 +167,53 @@ vector<m2::PointD> AddPoints(double offset, vector<m2::PointD> const & points, b
   return result;
 }
 
-vector<m2::PointD> CalculatePoints(m2::PolylineD const & polyline, double start, double end,
-                                   double headSize, double tailSize)
+// Cumulative distances of the polyline points, the degenerate segments are skipped.
+void CalculateDistances(m2::PolylineD const & polyline, vector<double> & distances)
+{
+  vector<m2::PointD> const & path = polyline.GetPoints();
+  distances.clear();
+  distances.reserve(path.size());
+  double len = 0;
+  for (size_t i = 0; i < path.size(); i++)
+  {
+    distances.push_back(len);
+    if (i + 1 < path.size())
+    {
+      double const dist = (path[i + 1] - path[i]).Length();
+      if (fabs(dist) >= 1e-5)
+        len += dist;
+    }
+  }
+}
+
+// Index of the first polyline segment which ends at the distance or after it.
+size_t FindSegment(vector<double> const & distances, double distance)
+{
+  if (distances.size() < 2)
+    return 0;
+  auto const it = lower_bound(distances.begin() + 1, distances.end(), distance);
+  return static_cast<size_t>(it - distances.begin()) - 1;
+}
+
+m2::PointD GetPointByDistance(m2::PolylineD const & polyline, vector<double> const & distances,
+                              double distance)
+{
+  vector<m2::PointD> const & path = polyline.GetPoints();
+  size_t const i = FindSegment(distances, distance);
+  if (i + 1 >= path.size())
+    return path.back();
+
+  double const dist = distances[i + 1] - distances[i];
+  if (dist <= 0.0)
+    return path[i];
+  double const k = my::clamp((distance - distances[i]) / dist, 0.0, 1.0);
+  return path[i] + (path[i + 1] - path[i]) * k;
+}
+
+vector<m2::PointD> CalculatePoints(m2::PolylineD const & polyline, vector<double> const & distances,
+                                   double start, double end, double headSize, double tailSize)
 {
   vector<m2::PointD> result;
-  result.reserve(polyline.GetSize() / 4);
 
   auto addIfNotExist = [&result](m2::PointD const & pnt)
   {
@@ -176,9 +222,11 @@ vector<m2::PointD> CalculatePoints(m2::PolylineD const & polyline, double start,
   };
 
   vector<m2::PointD> const & path = polyline.GetPoints();
-  double len = 0;
+  // Arrows take a small part of the route, so the walk starts from the segment of start.
+  size_t const first = FindSegment(distances, start);
+  double len = distances[first];
   bool started = false;
-  for (size_t i = 0; i + 1 < path.size(); i++)
+  for (size_t i = first; i + 1 < path.size(); i++)
   {
     double dist = (path[i + 1] - path[i]).Length();
     if (fabs(dist) < 1e-5)
@@ -230,6 +278,7 @@ RouteRenderer::RouteRenderer()
   : m_endOfRouteDisplayList(nullptr)
   , m_arrowDisplayList(nullptr)
   , m_distanceFromBegin(0.0)
+  , m_routeSegmentsScalar(0.0)
   , m_needClearGraphics(false)
   , m_needClearData(false)
   , m_waitForConstruction(false)
@@ -254,6 +303,8 @@ void RouteRenderer::Setup(m2::PolylineD const & routePolyline, vector<double> co
   m_endOfRoutePoint = routePolyline.Back();
   m_distanceFromBegin = 0.0;
   m_polyline = routePolyline;
+  CalculateDistances(m_polyline, m_polylineDistances);
+  m_routeSegments.clear();
 
   m_waitForConstruction = true;
 }
@@ -532,24 +583,9 @@ void RouteRenderer::UpdateDistanceFromBegin(double distanceFromBegin)
 void RouteRenderer::ApplyJoinsBounds(double joinsBoundsScalar, double glbHeadLength,
                                      vector<ArrowBorders> & arrowBorders)
 {
-  m_routeSegments.clear();
-  m_routeSegments.reserve(2 * m_routeData.m_joinsBounds.size() + 1);
-
-  // construct route's segments
-  m_routeSegments.emplace_back(0.0, 0.0, true /* m_isAvailable */);
-  for (size_t i = 0; i < m_routeData.m_joinsBounds.size(); i++)
-  {
-    double const start = m_routeData.m_joinsBounds[i].m_offset +
-                         m_routeData.m_joinsBounds[i].m_start * joinsBoundsScalar;
-    double const end = m_routeData.m_joinsBounds[i].m_offset +
-                       m_routeData.m_joinsBounds[i].m_end * joinsBoundsScalar;
-
-    m_routeSegments.back().m_end = start;
-    m_routeSegments.emplace_back(start, end, false /* m_isAvailable */);
-
-    m_routeSegments.emplace_back(end, 0.0, true /* m_isAvailable */);
-  }
-  m_routeSegments.back().m_end = m_routeData.m_length;
+  // construct route's segments, they depend on the zoom only
+  if (m_routeSegments.empty() || m_routeSegmentsScalar != joinsBoundsScalar)
+    BuildRouteSegments(joinsBoundsScalar);
 
   // shift head of arrow if necessary
   bool needMerge = false;
@@ -581,6 +617,28 @@ void RouteRenderer::ApplyJoinsBounds(double joinsBoundsScalar, double glbHeadLen
     MergeAndClipBorders(arrowBorders);
 }
 
+void RouteRenderer::BuildRouteSegments(double joinsBoundsScalar)
+{
+  m_routeSegments.clear();
+  m_routeSegments.reserve(2 * m_routeData.m_joinsBounds.size() + 1);
+  m_routeSegmentsScalar = joinsBoundsScalar;
+
+  m_routeSegments.emplace_back(0.0, 0.0, true /* m_isAvailable */);
+  for (size_t i = 0; i < m_routeData.m_joinsBounds.size(); i++)
+  {
+    double const start = m_routeData.m_joinsBounds[i].m_offset +
+                         m_routeData.m_joinsBounds[i].m_start * joinsBoundsScalar;
+    double const end = m_routeData.m_joinsBounds[i].m_offset +
+                       m_routeData.m_joinsBounds[i].m_end * joinsBoundsScalar;
+
+    m_routeSegments.back().m_end = start;
+    m_routeSegments.emplace_back(start, end, false /* m_isAvailable */);
+
+    m_routeSegments.emplace_back(end, 0.0, true /* m_isAvailable */);
+  }
+  m_routeSegments.back().m_end = m_routeData.m_length;
+}
+
 void RouteRenderer::CalculateArrowBorders(m2::RectD const & clipRect, double arrowLength, double scale,
                                           double arrowTextureWidth, double joinsBoundsScalar,
                                           vector<ArrowBorders> & arrowBorders)
@@ -597,6 +655,11 @@ void RouteRenderer::CalculateArrowBorders(m2::RectD const & clipRect, double arr
   if (halfLen < halfTextureWidth)
     halfLen = halfTextureWidth;
 
+  // Arrows far from the screen are skipped, so the long routes don't cost more than the short ones.
+  // The margin keeps the arrows which may be merged with the visible ones.
+  m2::RectD cullingRect = clipRect;
+  cullingRect.Inflate(kCullingMarginFactor * halfLen, kCullingMarginFactor * halfLen);
+
   // initial filling
   for (size_t i = 0; i < m_turns.size(); i++)
   {
@@ -610,6 +673,9 @@ void RouteRenderer::CalculateArrowBorders(m2::RectD const & clipRect, double arr
     if (borders.m_startDistance < m_distanceFromBegin)
       continue;
 
+    if (!cullingRect.IsPointInside(GetPointByDistance(m_polyline, m_polylineDistances, m_turns[i])))
+      continue;
+
     arrowBorders.push_back(borders);
   }
 
@@ -622,7 +688,7 @@ void RouteRenderer::CalculateArrowBorders(m2::RectD const & clipRect, double arr
   // check if arrow is outside clip rect
   for (size_t i = 0; i < arrowBorders.size(); i++)
   {
-    arrowBorders[i].m_points = CalculatePoints(m_polyline,
+    arrowBorders[i].m_points = CalculatePoints(m_polyline, m_polylineDistances,
                                                arrowBorders[i].m_startDistance,
                                                arrowBorders[i].m_endDistance,
                                                arrowBorders[i].m_headSize,
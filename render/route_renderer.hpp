@@ -81,6 +81,7 @@ private:
                              vector<ArrowBorders> & arrowBorders);
   void ApplyJoinsBounds(double joinsBoundsScalar, double glbHeadLength,
                         vector<ArrowBorders> & arrowBorders);
+  void BuildRouteSegments(double joinsBoundsScalar);
   void RenderArrow(graphics::Screen * dlScreen, float halfWidth, ScreenBase const & screen);
   bool RecacheArrows();
   void DestroyDisplayLists();
@@ -114,10 +115,14 @@ private:
   m2::PointD m_endOfRoutePoint;
 
   m2::PolylineD m_polyline;
+  /// Distances from the beginning of the route to the polyline points.
+  vector<double> m_polylineDistances;
   ArrowsBuffer m_arrowBuffer;
 
   vector<ArrowBorders> m_arrowBorders;
+  /// Segments of the route with and without joins for the scalar of the current zoom.
   vector<RouteSegment> m_routeSegments;
+  double m_routeSegmentsScalar;
 
   bool m_needClearGraphics;
   bool m_needClearData;
@@ -1,10 +1,7 @@
 #include "tile_cache.hpp"
 
-void TileCache::EntryValueTraits::Evict(Entry &val)
-{
-  if (val.m_rm)
-    val.m_rm->texturePool(graphics::ERenderTargetTexture)->Free(val.m_tile.m_renderTarget);
-}
+#include "base/assert.hpp"
+#include "base/macros.hpp"
 
 TileCache::Entry::Entry()
 {}
@@ -13,115 +10,195 @@ TileCache::Entry::Entry(Tile const & tile, shared_ptr<graphics::ResourceManager>
   : m_tile(tile), m_rm(rm)
 {}
 
-TileCache::TileCache() : m_isLocked(false)
+TileCache::Node::Node()
+  : m_weight(0), m_pinCount(0)
 {}
 
-void TileCache::AddTile(Tiler::RectInfo const & key, Entry const & entry)
+TileCache::TileCache()
+  : m_maxWeight(0), m_weight(0), m_pinnedWeight(0)
+{}
+
+TileCache::Shard & TileCache::GetShard(Tiler::RectInfo const & key)
 {
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  m_cache.Add(key, entry, 1);
+  return m_shards[GetShardIndex(key)];
 }
 
-void TileCache::Lock()
+// static
+size_t TileCache::GetShardIndex(Tiler::RectInfo const & key)
 {
-  m_lock.Lock();
-  m_isLocked = true;
+  // Neighbour tiles go to the different shards.
+  size_t const hash = static_cast<size_t>(key.m_x) * 31 + static_cast<size_t>(key.m_y) * 17 + key.m_tileScale;
+  return hash % kShardsCount;
 }
 
-void TileCache::Unlock()
+void TileCache::Erase(Shard & shard, map<Tiler::RectInfo, Node>::iterator it)
 {
-  m_isLocked = false;
-  m_lock.Unlock();
+  Node & node = it->second;
+  ASSERT_EQUAL(node.m_pinCount, 0, ());
+
+  if (node.m_entry.m_rm)
+    node.m_entry.m_rm->texturePool(graphics::ERenderTargetTexture)->Free(node.m_entry.m_tile.m_renderTarget);
+
+  m_weight -= node.m_weight;
+  shard.m_list.erase(node.m_it);
+  shard.m_nodes.erase(it);
 }
 
-set<Tiler::RectInfo> const & TileCache::Keys() const
+void TileCache::EvictFromShard(Shard & shard, int weight)
 {
-  return m_cache.Keys();
-/*  set<uint64_t> keys = m_cache.Keys();
-  set<Tiler::RectInfo> rects;
+  threads::MutexGuard guard(shard.m_mutex);
+  UNUSED_VALUE(guard);
 
-  for (set<uint64_t>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+  auto it = shard.m_list.end();
+  while (it != shard.m_list.begin() && m_weight + weight > m_maxWeight)
   {
-    Tiler::RectInfo v;
-    v.fromUInt64Cell(*it);
-    rects.insert(v);
+    --it;
+    auto const nodeIt = shard.m_nodes.find(*it);
+    ASSERT(nodeIt != shard.m_nodes.end(), ());
+    if (nodeIt->second.m_pinCount != 0)
+      continue;
+
+    // Erasing invalidates the iterator, so the next one is kept.
+    ++it;
+    Erase(shard, nodeIt);
   }
-
-  return rects;*/
 }
 
-bool TileCache::HasTile(Tiler::RectInfo const & key)
+void TileCache::AddTile(Tiler::RectInfo const & key, Entry const & entry)
 {
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  return m_cache.HasElem(key);
-}
+  int const weight = 1;
+  Shard & shard = GetShard(key);
 
-void TileCache::LockTile(Tiler::RectInfo const & key)
-{
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  m_cache.LockElem(key);
-}
+  {
+    threads::MutexGuard guard(shard.m_mutex);
+    UNUSED_VALUE(guard);
+
+    auto const it = shard.m_nodes.find(key);
+    if (it != shard.m_nodes.end())
+    {
+      ASSERT_EQUAL(it->second.m_pinCount, 0, ("replacing pinned tile"));
+      if (it->second.m_pinCount != 0)
+        return;
+      Erase(shard, it);
+    }
+  }
 
-size_t TileCache::LockCount(Tiler::RectInfo const & key)
-{
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  return m_cache.LockCount(key);
+  FreeRoom(weight, GetShardIndex(key));
+
+  threads::MutexGuard guard(shard.m_mutex);
+  UNUSED_VALUE(guard);
+
+  // Another thread could add the same tile while the room was freed.
+  if (shard.m_nodes.find(key) != shard.m_nodes.end())
+  {
+    if (entry.m_rm)
+      entry.m_rm->texturePool(graphics::ERenderTargetTexture)->Free(entry.m_tile.m_renderTarget);
+    return;
+  }
+
+  shard.m_list.push_front(key);
+  Node & node = shard.m_nodes[key];
+  node.m_entry = entry;
+  node.m_weight = weight;
+  node.m_it = shard.m_list.begin();
+  m_weight += weight;
 }
 
-void TileCache::UnlockTile(Tiler::RectInfo const & key)
+bool TileCache::HasTile(Tiler::RectInfo const & key)
 {
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  m_cache.UnlockElem(key);
+  Shard & shard = GetShard(key);
+  threads::MutexGuard guard(shard.m_mutex);
+  UNUSED_VALUE(guard);
+
+  return shard.m_nodes.find(key) != shard.m_nodes.end();
 }
 
-void TileCache::TouchTile(Tiler::RectInfo const & key)
+Tile const * TileCache::PinTile(Tiler::RectInfo const & key)
 {
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  m_cache.Touch(key);
+  Shard & shard = GetShard(key);
+  threads::MutexGuard guard(shard.m_mutex);
+  UNUSED_VALUE(guard);
+
+  auto const it = shard.m_nodes.find(key);
+  if (it == shard.m_nodes.end())
+    return nullptr;
+
+  Node & node = it->second;
+  if (node.m_pinCount++ == 0)
+    m_pinnedWeight += node.m_weight;
+
+  shard.m_list.splice(shard.m_list.begin(), shard.m_list, node.m_it);
+  return &node.m_entry.m_tile;
 }
 
-Tile const & TileCache::GetTile(Tiler::RectInfo const & key)
+void TileCache::UnpinTile(Tiler::RectInfo const & key)
 {
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  return m_cache.Find(key).m_tile;
+  Shard & shard = GetShard(key);
+  threads::MutexGuard guard(shard.m_mutex);
+  UNUSED_VALUE(guard);
+
+  auto const it = shard.m_nodes.find(key);
+  ASSERT(it != shard.m_nodes.end(), ());
+  if (it == shard.m_nodes.end())
+    return;
+
+  Node & node = it->second;
+  ASSERT_GREATER(node.m_pinCount, 0, ());
+  if (--node.m_pinCount == 0)
+    m_pinnedWeight -= node.m_weight;
 }
 
-void TileCache::Remove(Tiler::RectInfo const & key)
+size_t TileCache::PinCount(Tiler::RectInfo const & key)
 {
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  m_cache.Remove(key);
+  Shard & shard = GetShard(key);
+  threads::MutexGuard guard(shard.m_mutex);
+  UNUSED_VALUE(guard);
+
+  auto const it = shard.m_nodes.find(key);
+  return it != shard.m_nodes.end() ? it->second.m_pinCount : 0;
 }
 
 int TileCache::CanFit() const
 {
-  return m_cache.CanFit();
+  return m_maxWeight - m_pinnedWeight;
 }
 
-int TileCache::UnlockedWeight() const
+int TileCache::UnpinnedWeight() const
 {
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  return m_cache.UnlockedWeight();
+  return m_weight - m_pinnedWeight;
 }
 
-int TileCache::LockedWeight() const
+int TileCache::PinnedWeight() const
 {
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  return m_cache.LockedWeight();
+  return m_pinnedWeight;
 }
 
 int TileCache::CacheSize() const
 {
-  return m_cache.MaxWeight();
+  return m_maxWeight;
 }
 
 void TileCache::Resize(int maxWeight)
 {
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  m_cache.Resize(maxWeight);
+  m_maxWeight = maxWeight;
+  // in case of making cache smaller this
+  // function pops out some unpinned elements
+  FreeRoom(0);
 }
 
 void TileCache::FreeRoom(int weight)
 {
-  ASSERT(m_isLocked, ("TileCache need to be locked on modify"));
-  m_cache.FreeRoom(weight);
+  FreeRoom(weight, 0);
+}
+
+void TileCache::FreeRoom(int weight, size_t firstShard)
+{
+  // MRU order is kept per shard only, so the tiles of the first shard are evicted first.
+  // Shards are locked one by one, never two at once.
+  for (size_t i = 0; i < kShardsCount; ++i)
+  {
+    if (m_weight + weight <= m_maxWeight)
+      return;
+    EvictFromShard(m_shards[(firstShard + i) % kShardsCount], weight);
+  }
 }
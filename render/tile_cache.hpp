@@ -5,16 +5,25 @@
 
 #include "graphics/resource_manager.hpp"
 
-#include "base/mru_cache.hpp"
+#include "base/macros.hpp"
 #include "base/mutex.hpp"
 
-#include "std/bind.hpp"
+#include "std/atomic.hpp"
+#include "std/list.hpp"
+#include "std/map.hpp"
 
 namespace graphics
 {
   class ResourceManager;
 }
 
+/// MRU cache of the rendered tiles, which is accessed by the tile renderers and the coverage
+/// generator at once. Tiles are split into shards by the key, each shard has its own mutex
+/// and MRU list, so the threads wait each other only when they access the same shard.
+/// Weights are atomic and they are read without locking.
+///
+/// A tile is pinned while it's in the coverage, pinned tiles aren't evicted and
+/// the pointers to them are valid till the tiles are unpinned.
 class TileCache
 {
 public:
@@ -27,55 +36,91 @@ public:
     Entry(Tile const & tile, shared_ptr<graphics::ResourceManager> const & rm);
   };
 
-  struct EntryValueTraits
-  {
-    static void Evict(Entry & val);
-  };
-
-private:
-
-  my::MRUCache<Tiler::RectInfo, Entry, EntryValueTraits> m_cache;
-  threads::Mutex m_lock;
-  bool m_isLocked;
-
-  TileCache(TileCache const & src);
-  TileCache const & operator=(TileCache const & src);
-
-public:
-
   TileCache();
-  /// lock for multithreaded access
-  void Lock();
-  /// unlock for multithreaded access
-  void Unlock();
-  /// get keys of values in cache
-  set<Tiler::RectInfo> const & Keys() const;
-  /// add tile to cache
+
+  /// add the unpinned tile to the cache, the least recently used unpinned tiles are evicted
+  /// when there is no room for it
   void AddTile(Tiler::RectInfo const & key, Entry const & entry);
   /// check, whether we have some tile in the cache
   bool HasTile(Tiler::RectInfo const & key);
-  /// lock tile
-  void LockTile(Tiler::RectInfo const & key);
-  /// unlock tile
-  void UnlockTile(Tiler::RectInfo const & key);
-  /// lock count
-  size_t LockCount(Tiler::RectInfo const & key);
-  /// touch tile
-  void TouchTile(Tiler::RectInfo const & key);
-  /// get tile from the cache
-  Tile const & GetTile(Tiler::RectInfo const & key);
-  /// remove the specified tile from the cache
-  void Remove(Tiler::RectInfo const & key);
+  /// pin the tile and make it the most recently used one
+  /// @return nullptr when there is no such tile
+  Tile const * PinTile(Tiler::RectInfo const & key);
+  /// unpin the tile pinned by PinTile
+  void UnpinTile(Tiler::RectInfo const & key);
+  /// pin count
+  size_t PinCount(Tiler::RectInfo const & key);
+  /// remove the tiles for which fn(key) is true, they must be unpinned
+  template <typename TFn> void RemoveTiles(TFn const & fn);
   /// how much elements can fit in the tileCache
   int CanFit() const;
-  /// how many unlocked elements do we have in tileCache
-  int UnlockedWeight() const;
-  /// how many locked elements do we have in tileCache
-  int LockedWeight() const;
+  /// how many unpinned elements do we have in tileCache
+  int UnpinnedWeight() const;
+  /// how many pinned elements do we have in tileCache
+  int PinnedWeight() const;
   /// the size of the cache
   int CacheSize() const;
   /// resize the cache
   void Resize(int maxWeight);
-  /// free up to weight spaces evicting unlocked elements from cache
+  /// free up to weight spaces evicting unpinned elements from cache
   void FreeRoom(int weight);
+
+private:
+
+  struct Node
+  {
+    Node();
+
+    Entry m_entry;
+    int m_weight;
+    size_t m_pinCount;
+    list<Tiler::RectInfo>::iterator m_it;
+  };
+
+  struct Shard
+  {
+    threads::Mutex m_mutex;
+    map<Tiler::RectInfo, Node> m_nodes;
+    /// the most recently used tiles go first
+    list<Tiler::RectInfo> m_list;
+  };
+
+  static size_t const kShardsCount = 8;
+
+  static size_t GetShardIndex(Tiler::RectInfo const & key);
+  Shard & GetShard(Tiler::RectInfo const & key);
+  /// the shard must be locked
+  void Erase(Shard & shard, map<Tiler::RectInfo, Node>::iterator it);
+  /// evict the least recently used unpinned tiles of the shard till the weight fits
+  void EvictFromShard(Shard & shard, int weight);
+  void FreeRoom(int weight, size_t firstShard);
+
+  Shard m_shards[kShardsCount];
+  atomic<int> m_maxWeight;
+  atomic<int> m_weight;
+  atomic<int> m_pinnedWeight;
+
+  TileCache(TileCache const & src);
+  TileCache const & operator=(TileCache const & src);
 };
+
+template <typename TFn>
+void TileCache::RemoveTiles(TFn const & fn)
+{
+  for (Shard & shard : m_shards)
+  {
+    threads::MutexGuard guard(shard.m_mutex);
+    UNUSED_VALUE(guard);
+
+    for (auto it = shard.m_nodes.begin(); it != shard.m_nodes.end();)
+    {
+      auto const curr = it++;
+      if (fn(curr->first))
+      {
+        ASSERT_EQUAL(curr->second.m_pinCount, 0, ("removing pinned tile"));
+        if (curr->second.m_pinCount == 0)
+          Erase(shard, curr);
+      }
+    }
+  }
+}
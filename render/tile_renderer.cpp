@@ -19,24 +19,23 @@
 
 namespace
 {
-  class TileStructuresLockGuard
+  /// TileCache is concurrent itself, the tile set lock keeps a tile from being
+  /// in the tile set and in the cache at the same time
+  class TileSetLockGuard
   {
   public:
-    TileStructuresLockGuard(TileCache & tileCache, TileSet & tileSet)
-      : m_tileCache(tileCache), m_tileSet(tileSet)
+    TileSetLockGuard(TileSet & tileSet)
+      : m_tileSet(tileSet)
     {
       m_tileSet.Lock();
-      m_tileCache.Lock();
     }
 
-    ~TileStructuresLockGuard()
+    ~TileSetLockGuard()
     {
-      m_tileCache.Unlock();
       m_tileSet.Unlock();
     }
 
   private:
-    TileCache & m_tileCache;
     TileSet & m_tileSet;
   };
 }
@@ -104,6 +103,9 @@ TileRenderer::TileRenderer(
 
 TileRenderer::~TileRenderer()
 {
+  core::CommandsQueue::Stats const stats = m_queue.GetStats();
+  LOG(LDEBUG, ("Tile commands executed:", stats.m_executedCount, "dropped:", stats.m_droppedCount,
+               "queue latency avg:", stats.m_avgLatency, "max:", stats.m_maxLatency));
 }
 
 void TileRenderer::Shutdown()
@@ -233,7 +235,8 @@ void TileRenderer::DrawTile(core::CommandsQueue::Environment const & env,
 #endif //USE_DRAPE
 }
 
-void TileRenderer::AddCommand(Tiler::RectInfo const & rectInfo, int sequenceID, core::CommandsQueue::Chain const & afterTileFns)
+void TileRenderer::AddCommand(Tiler::RectInfo const & rectInfo, int sequenceID, core::CommandsQueue::Chain const & afterTileFns,
+                              core::CommandsQueue::EPriority priority)
 {
   SetSequenceID(sequenceID);
 
@@ -241,7 +244,7 @@ void TileRenderer::AddCommand(Tiler::RectInfo const & rectInfo, int sequenceID,
   chain.addCommand(bind(&TileRenderer::DrawTile, this, _1, rectInfo, sequenceID));
   chain.addCommand(afterTileFns);
 
-  m_queue.AddCommand(chain);
+  m_queue.AddCommand(chain, priority, sequenceID);
 }
 
 void TileRenderer::CancelCommands()
@@ -257,6 +260,7 @@ void TileRenderer::ClearCommands()
 void TileRenderer::SetSequenceID(int sequenceID)
 {
   m_sequenceID = sequenceID;
+  m_queue.SetSequenceID(sequenceID);
 }
 
 TileCache & TileRenderer::GetTileCache()
@@ -266,7 +270,7 @@ TileCache & TileRenderer::GetTileCache()
 
 void TileRenderer::CacheActiveTile(Tiler::RectInfo const & rectInfo)
 {
-  TileStructuresLockGuard guard(m_tileCache, m_tileSet);
+  TileSetLockGuard guard(m_tileSet);
   if (m_tileSet.HasTile(rectInfo))
   {
     ASSERT(!m_tileCache.HasTile(rectInfo), (""));
@@ -285,7 +289,7 @@ void TileRenderer::CacheActiveTile(Tiler::RectInfo const & rectInfo)
 
 bool TileRenderer::HasTile(Tiler::RectInfo const & rectInfo)
 {
-  TileStructuresLockGuard guard(m_tileCache, m_tileSet);
+  TileSetLockGuard guard(m_tileSet);
 
   if (m_tileSet.HasTile(rectInfo))
   {
@@ -306,7 +310,7 @@ void TileRenderer::SetIsPaused(bool flag)
 
 void TileRenderer::AddActiveTile(Tile const & tile)
 {
-  TileStructuresLockGuard lock(m_tileCache, m_tileSet);
+  TileSetLockGuard lock(m_tileSet);
 
   Tiler::RectInfo const & key = tile.m_rectInfo;
 
@@ -318,7 +322,7 @@ void TileRenderer::AddActiveTile(Tile const & tile)
 
 void TileRenderer::RemoveActiveTile(Tiler::RectInfo const & rectInfo, int sequenceID)
 {
-  TileStructuresLockGuard lock(m_tileCache, m_tileSet);
+  TileSetLockGuard lock(m_tileSet);
 
   if (m_tileSet.HasTile(rectInfo) && m_tileSet.GetTileSequenceID(rectInfo) <= sequenceID)
   {
@@ -93,14 +93,17 @@ public:
   virtual ~TileRenderer();
   void Shutdown();
   /// add command to the commands queue.
+  /// tiles of the screen should go with the high priority, the prefetched ones with the low one.
   void AddCommand(Tiler::RectInfo const & rectInfo,
                   int sequenceID,
-                  core::CommandsQueue::Chain const & afterTileFns = core::CommandsQueue::Chain());
+                  core::CommandsQueue::Chain const & afterTileFns = core::CommandsQueue::Chain(),
+                  core::CommandsQueue::EPriority priority = core::CommandsQueue::EHighPriority);
   /// get tile cache.
   TileCache & GetTileCache();
   /// Move active tile to cache if tile alrady rendered
   void CacheActiveTile(Tiler::RectInfo const & rectInfo);
 
+  /// commands of the older sequences are dropped from the queue or cancelled.
   void SetSequenceID(int sequenceID);
 
   void CancelCommands();
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "coding/writer.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+namespace routing
+{
+/// Alignment of the arrays of the sections which are used in place, being mapped to memory.
+size_t constexpr kSectionArrayAlignment = 8;
+
+/// Writes the arrays of a section, each array is padded to kSectionArrayAlignment.
+class AlignedWriter
+{
+public:
+  explicit AlignedWriter(Writer & writer) : m_writer(writer), m_start(writer.Pos()) {}
+
+  template <typename T>
+  void WriteArray(vector<T> const & values)
+  {
+    if (!values.empty())
+      m_writer.Write(values.data(), values.size() * sizeof(T));
+
+    static uint8_t const kZeroes[kSectionArrayAlignment] = {};
+    size_t const size = static_cast<size_t>(m_writer.Pos() - m_start);
+    size_t const padding = (kSectionArrayAlignment - size % kSectionArrayAlignment) %
+                           kSectionArrayAlignment;
+    if (padding != 0)
+      m_writer.Write(kZeroes, padding);
+  }
+
+private:
+  Writer & m_writer;
+  int64_t const m_start;
+};
+
+/// Reads the arrays written by AlignedWriter in place.
+class AlignedReader
+{
+public:
+  AlignedReader(char const * data, uint64_t size) : m_data(data), m_size(size) {}
+
+  template <typename T>
+  bool ReadArray(uint64_t count, T const *& values)
+  {
+    uint64_t const bytes = count * sizeof(T);
+    if (bytes > m_size - m_pos)
+      return false;
+    values = reinterpret_cast<T const *>(m_data + m_pos);
+    m_pos += (bytes + kSectionArrayAlignment - 1) / kSectionArrayAlignment * kSectionArrayAlignment;
+    m_pos = min(m_pos, m_size);
+    return true;
+  }
+
+  inline bool IsEnd() const { return m_pos == m_size; }
+
+private:
+  char const * const m_data;
+  uint64_t const m_size;
+  uint64_t m_pos = 0;
+};
+}  // namespace routing
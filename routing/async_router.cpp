@@ -6,6 +6,7 @@
 #include "base/macros.hpp"
 #include "base/string_utils.hpp"
 #include "base/timer.hpp"
+#include "base/tracing.hpp"
 
 #include "indexer/mercator.hpp"
 
@@ -128,6 +129,7 @@ AsyncRouter::~AsyncRouter()
     unique_lock<mutex> ul(m_guard);
 
     ResetDelegate();
+    ResetBackgroundDelegates();
 
     m_threadExit = true;
     m_threadCondVar.notify_one();
@@ -141,6 +143,7 @@ void AsyncRouter::SetRouter(unique_ptr<IRouter> && router, unique_ptr<IOnlineFet
   unique_lock<mutex> ul(m_guard);
 
   ResetDelegate();
+  ResetBackgroundDelegates();
 
   m_router = move(router);
   m_absentFetcher = move(fetcher);
@@ -161,10 +164,33 @@ void AsyncRouter::CalculateRoute(m2::PointD const & startPoint, m2::PointD const
 
   m_delegate = make_shared<RouterDelegateProxy>(readyCallback, m_pointCheckCallback, progressCallback, timeoutSec);
 
+  // The running background route yields to the request and stays in the queue.
+  if (m_backgroundDelegate)
+    m_backgroundDelegate->Cancel();
+
   m_hasRequest = true;
   m_threadCondVar.notify_one();
 }
 
+void AsyncRouter::CalculateBackgroundRoute(m2::PointD const & startPoint,
+                                           m2::PointD const & direction,
+                                           m2::PointD const & finalPoint,
+                                           TReadyCallback const & readyCallback,
+                                           uint32_t timeoutSec)
+{
+  unique_lock<mutex> ul(m_guard);
+
+  m_backgroundRequests.push_back({startPoint, direction, finalPoint, readyCallback, timeoutSec});
+  m_threadCondVar.notify_one();
+}
+
+void AsyncRouter::CancelBackgroundRoutes()
+{
+  unique_lock<mutex> ul(m_guard);
+
+  ResetBackgroundDelegates();
+}
+
 void AsyncRouter::ClearState()
 {
   unique_lock<mutex> ul(m_guard);
@@ -173,6 +199,7 @@ void AsyncRouter::ClearState()
   m_threadCondVar.notify_one();
 
   ResetDelegate();
+  ResetBackgroundDelegates();
 }
 
 void AsyncRouter::LogCode(IRouter::ResultCode code, double const elapsedSec)
@@ -228,13 +255,28 @@ void AsyncRouter::ResetDelegate()
   }
 }
 
+void AsyncRouter::ResetBackgroundDelegates()
+{
+  if (m_backgroundDelegate)
+  {
+    m_backgroundDelegate->Cancel();
+    m_backgroundDelegate.reset();
+  }
+  m_backgroundRequests.clear();
+}
+
 void AsyncRouter::ThreadFunc()
 {
+  my::tracing::SetThreadName("AsyncRouter");
   while (true)
   {
     {
       unique_lock<mutex> ul(m_guard);
-      m_threadCondVar.wait(ul, [this](){ return m_threadExit || m_hasRequest || m_clearState; });
+      m_threadCondVar.wait(ul, [this]()
+      {
+        return m_threadExit || m_hasRequest || m_clearState ||
+               (m_router && !m_backgroundRequests.empty());
+      });
 
       if (m_clearState && m_router)
       {
@@ -246,7 +288,11 @@ void AsyncRouter::ThreadFunc()
         break;
 
       if (!m_hasRequest)
+      {
+        ul.unlock();
+        CalculateBackgroundRoute();
         continue;
+      }
     }
 
     CalculateRoute();
@@ -255,6 +301,7 @@ void AsyncRouter::ThreadFunc()
 
 void AsyncRouter::CalculateRoute()
 {
+  TRACE_SCOPE("routing", "AsyncRouter::CalculateRoute");
   shared_ptr<RouterDelegateProxy> delegate;
   m2::PointD startPoint, finalPoint, startDirection;
   shared_ptr<IOnlineFetcher> absentFetcher;
@@ -336,6 +383,60 @@ void AsyncRouter::CalculateRoute()
     delegate->OnReady(route, code);
 }
 
+void AsyncRouter::CalculateBackgroundRoute()
+{
+  TRACE_SCOPE("routing", "AsyncRouter::CalculateBackgroundRoute");
+  shared_ptr<RouterDelegateProxy> delegate;
+  BackgroundRequest request;
+  shared_ptr<IRouter> router;
+
+  {
+    unique_lock<mutex> ul(m_guard);
+
+    if (m_hasRequest || m_backgroundRequests.empty() || !m_router)
+      return;
+
+    request = m_backgroundRequests.front();
+    m_backgroundDelegate = make_shared<RouterDelegateProxy>(
+        request.m_onReady, nullptr /* onPointCheck */, nullptr /* onProgress */, request.m_timeoutSec);
+    delegate = m_backgroundDelegate;
+    router = m_router;
+  }
+
+  Route route(router->GetName());
+  IRouter::ResultCode code;
+
+  my::Timer timer;
+  try
+  {
+    code = router->CalculateRoute(request.m_startPoint, request.m_startDirection,
+                                  request.m_finalPoint, delegate->GetDelegate(), route);
+  }
+  catch (RootException const & e)
+  {
+    code = IRouter::InternalError;
+    LOG(LERROR, ("Exception happened while calculating background route:", e.Msg()));
+  }
+
+  {
+    unique_lock<mutex> ul(m_guard);
+
+    // The queue was dropped while the route was calculated.
+    if (m_backgroundDelegate != delegate)
+      return;
+    m_backgroundDelegate.reset();
+
+    // The route was interrupted by a request of CalculateRoute(), so it's calculated again later.
+    if (code == IRouter::Cancelled && m_hasRequest)
+      return;
+    m_backgroundRequests.pop_front();
+  }
+
+  LOG(LDEBUG, ("Background route from", request.m_startPoint, "to", request.m_finalPoint,
+               "result:", ToString(code), "elapsed seconds:", timer.ElapsedSeconds()));
+  delegate->OnReady(route, code);
+}
+
 void AsyncRouter::SendStatistics(m2::PointD const & startPoint, m2::PointD const & startDirection,
                                  m2::PointD const & finalPoint,
                                  IRouter::ResultCode resultCode,
@@ -8,6 +8,7 @@
 #include "base/thread.hpp"
 
 #include "std/condition_variable.hpp"
+#include "std/deque.hpp"
 #include "std/map.hpp"
 #include "std/mutex.hpp"
 #include "std/shared_ptr.hpp"
@@ -51,6 +52,21 @@ public:
                       RouterDelegate::TProgressCallback const & progressCallback,
                       uint32_t timeoutSec);
 
+  /// Queues a low-priority route calculation, e.g. a speculative one. Background routes are
+  /// calculated one by one when there is no request of CalculateRoute(): a new request
+  /// interrupts the running background route, which is calculated again after the request.
+  /// Statistics aren't sent and absent maps aren't fetched for background routes.
+  ///
+  /// @param readyCallback function to return routing result, it's called on the worker thread
+  ///        and isn't called for the cancelled routes
+  /// @param timeoutSec timeout to cancel routing. 0 is infinity.
+  void CalculateBackgroundRoute(m2::PointD const & startPoint, m2::PointD const & direction,
+                                m2::PointD const & finalPoint, TReadyCallback const & readyCallback,
+                                uint32_t timeoutSec);
+
+  /// Cancels the running background route and drops the queued ones.
+  void CancelBackgroundRoutes();
+
   /// Interrupt routing and clear buffers
   void ClearState();
 
@@ -61,7 +77,11 @@ private:
   /// This function is called in worker thread
   void CalculateRoute();
 
+  /// Calculates the first queued background route, it's called in worker thread.
+  void CalculateBackgroundRoute();
+
   void ResetDelegate();
+  void ResetBackgroundDelegates();
 
   /// These functions are called to send statistics about the routing
   void SendStatistics(m2::PointD const & startPoint, m2::PointD const & startDirection,
@@ -100,6 +120,15 @@ private:
     RouterDelegate m_delegate;
   };
 
+  struct BackgroundRequest
+  {
+    m2::PointD m_startPoint;
+    m2::PointD m_startDirection;
+    m2::PointD m_finalPoint;
+    TReadyCallback m_onReady;
+    uint32_t m_timeoutSec;
+  };
+
 private:
   mutex m_guard;
 
@@ -118,6 +147,11 @@ private:
   shared_ptr<IOnlineFetcher> m_absentFetcher;
   shared_ptr<IRouter> m_router;
 
+  /// Background requests, the running one is in m_backgroundRequests.front() while
+  /// m_backgroundDelegate is set.
+  deque<BackgroundRequest> m_backgroundRequests;
+  shared_ptr<RouterDelegateProxy> m_backgroundDelegate;
+
   TRoutingStatisticsCallback const m_routingStatisticsCallback;
   RouterDelegate::TPointCheckCallback const m_pointCheckCallback;
 };
@@ -1,17 +1,20 @@
 #pragma once
 
+#include "routing/base/astar_containers.hpp"
+
 #include "base/assert.hpp"
 #include "base/cancellable.hpp"
 #include "std/algorithm.hpp"
 #include "std/functional.hpp"
 #include "std/iostream.hpp"
-#include "std/map.hpp"
-#include "std/queue.hpp"
+#include "std/limits.hpp"
 #include "std/vector.hpp"
 
 namespace routing
 {
 
+/// The algorithm keeps its state in arrays indexed by dense vertex ids (see VertexIndex),
+/// so std::hash must be defined for TGraph::TVertexType.
 template <typename TGraph>
 class AStarAlgorithm
 {
@@ -71,35 +74,46 @@ private:
   // Precision of comparison weights.
   static double constexpr kEpsilon = 1e-6;
 
-  // State is what is going to be put in the priority queue. See the
+  static double constexpr kInfiniteDistance = numeric_limits<double>::infinity();
+
+  using TVertexIndex = VertexIndex<TVertexType>;
+  static uint32_t constexpr kNoParent = TVertexIndex::kInvalidId;
+
+  // SearchState keeps distances and parents of vertices reached by a search,
+  // indexed by vertex ids. The queue keys are reduced distances, see the
   // comment for FindPath for more information.
-  struct State
+  struct SearchState
   {
-    State(TVertexType const & vertex, double distance) : vertex(vertex), distance(distance) {}
+    // Makes room for all vertices of the index.
+    void Resize(size_t size)
+    {
+      bestDistance.resize(size, kInfiniteDistance);
+      parent.resize(size, kNoParent);
+    }
 
-    inline bool operator>(State const & rhs) const { return distance > rhs.distance; }
+    inline bool IsReached(uint32_t id) const { return bestDistance[id] != kInfiniteDistance; }
 
-    TVertexType vertex;
-    double distance;
+    IndexedFourAryHeap queue;
+    vector<double> bestDistance;
+    vector<uint32_t> parent;
   };
 
   // BidirectionalStepContext keeps all the information that is needed to
   // search starting from one of the two directions. Its main
   // purpose is to make the code that changes directions more readable.
-  struct BidirectionalStepContext
+  struct BidirectionalStepContext : public SearchState
   {
     BidirectionalStepContext(bool forward, TVertexType const & startVertex,
                              TVertexType const & finalVertex, TGraphType const & graph)
         : forward(forward), startVertex(startVertex), finalVertex(finalVertex), graph(graph)
     {
-      bestVertex = forward ? startVertex : finalVertex;
-      pS = ConsistentHeuristic(bestVertex);
+      pS = ConsistentHeuristic(forward ? startVertex : finalVertex);
     }
 
     double TopDistance() const
     {
-      ASSERT(!queue.empty(), ());
-      return bestDistance.at(queue.top().vertex);
+      ASSERT(!this->queue.Empty(), ());
+      return this->queue.TopKey();
     }
 
     // p_f(v) = 0.5*(π_f(v) - π_r(v)) + 0.5*π_r(t)
@@ -138,20 +152,16 @@ private:
     TVertexType const & finalVertex;
     TGraph const & graph;
 
-    priority_queue<State, vector<State>, greater<State>> queue;
-    map<TVertexType, double> bestDistance;
-    map<TVertexType, TVertexType> parent;
-    TVertexType bestVertex;
+    uint32_t bestVertex = kNoParent;
 
     double pS;
   };
 
-  static void ReconstructPath(TVertexType const & v, map<TVertexType, TVertexType> const & parent,
+  static void ReconstructPath(uint32_t v, vector<uint32_t> const & parent, TVertexIndex const & index,
                               vector<TVertexType> & path);
-  static void ReconstructPathBidirectional(TVertexType const & v, TVertexType const & w,
-                                           map<TVertexType, TVertexType> const & parentV,
-                                           map<TVertexType, TVertexType> const & parentW,
-                                           vector<TVertexType> & path);
+  static void ReconstructPathBidirectional(uint32_t v, uint32_t w, vector<uint32_t> const & parentV,
+                                           vector<uint32_t> const & parentW,
+                                           TVertexIndex const & index, vector<TVertexType> & path);
 };
 
 // This implementation is based on the view that the A* algorithm
@@ -165,6 +175,14 @@ private:
 // http://research.microsoft.com/pubs/154937/soda05.pdf
 // http://www.cs.princeton.edu/courses/archive/spr06/cos423/Handouts/EPP%20shortest%20path%20algorithms.pdf
 
+// static
+template <typename TGraph>
+double constexpr AStarAlgorithm<TGraph>::kInfiniteDistance;
+
+// static
+template <typename TGraph>
+uint32_t constexpr AStarAlgorithm<TGraph>::kNoParent;
+
 template <typename TGraph>
 typename AStarAlgorithm<TGraph>::Result AStarAlgorithm<TGraph>::FindPath(
     TGraphType const & graph,
@@ -176,61 +194,63 @@ typename AStarAlgorithm<TGraph>::Result AStarAlgorithm<TGraph>::FindPath(
   if (nullptr == onVisitedVertexCallback)
     onVisitedVertexCallback = [](TVertexType const &, TVertexType const &){};
 
-  map<TVertexType, double> bestDistance;
-  priority_queue<State, vector<State>, greater<State>> queue;
-  map<TVertexType, TVertexType> parent;
+  TVertexIndex index;
+  SearchState state;
 
-  bestDistance[startVertex] = 0.0;
-  queue.push(State(startVertex, 0.0));
+  uint32_t const startId = index.Insert(startVertex);
+  state.Resize(index.GetSize());
+  state.bestDistance[startId] = 0.0;
+  state.queue.PushOrDecrease(startId, 0.0);
 
   vector<TEdgeType> adj;
 
   uint32_t steps = 0;
-  while (!queue.empty())
+  while (!state.queue.Empty())
   {
     ++steps;
 
     if (steps % kCancelledPollPeriod == 0 && cancellable.IsCancelled())
       return Result::Cancelled;
 
-    State const stateV = queue.top();
-    queue.pop();
+    uint32_t const v = state.queue.Top();
+    double const distanceV = state.queue.TopKey();
+    state.queue.Pop();
 
-    if (stateV.distance > bestDistance[stateV.vertex])
-      continue;
+    // The index may grow below, so the vertex is copied.
+    TVertexType const vertexV = index.GetVertex(v);
 
     if (steps % kVisitedVerticesPeriod == 0)
-      onVisitedVertexCallback(stateV.vertex, finalVertex);
+      onVisitedVertexCallback(vertexV, finalVertex);
 
-    if (stateV.vertex == finalVertex)
+    if (vertexV == finalVertex)
     {
-      ReconstructPath(stateV.vertex, parent, path);
+      ReconstructPath(v, state.parent, index, path);
       return Result::OK;
     }
 
-    graph.GetOutgoingEdgesList(stateV.vertex, adj);
+    graph.GetOutgoingEdgesList(vertexV, adj);
+    double const piV = graph.HeuristicCostEstimate(vertexV, finalVertex);
     for (auto const & edge : adj)
     {
-      State stateW(edge.GetTarget(), 0.0);
-      if (stateV.vertex == stateW.vertex)
+      TVertexType const & vertexW = edge.GetTarget();
+      if (vertexV == vertexW)
         continue;
 
       double const len = edge.GetWeight();
-      double const piV = graph.HeuristicCostEstimate(stateV.vertex, finalVertex);
-      double const piW = graph.HeuristicCostEstimate(stateW.vertex, finalVertex);
+      double const piW = graph.HeuristicCostEstimate(vertexW, finalVertex);
       double const reducedLen = len + piW - piV;
 
       CHECK(reducedLen >= -kEpsilon, ("Invariant violated:", reducedLen, "<", -kEpsilon));
-      double const newReducedDist = stateV.distance + max(reducedLen, 0.0);
+      double const newReducedDist = distanceV + max(reducedLen, 0.0);
 
-      auto const t = bestDistance.find(stateW.vertex);
-      if (t != bestDistance.end() && newReducedDist >= t->second - kEpsilon)
+      uint32_t const w = index.Insert(vertexW);
+      state.Resize(index.GetSize());
+      if (newReducedDist >= state.bestDistance[w] - kEpsilon)
         continue;
 
-      stateW.distance = newReducedDist;
-      bestDistance[stateW.vertex] = newReducedDist;
-      parent[stateW.vertex] = stateV.vertex;
-      queue.push(stateW);
+      state.bestDistance[w] = newReducedDist;
+      state.parent[w] = v;
+      state.queue.PushOrDecrease(w, newReducedDist);
     }
   }
 
@@ -251,14 +271,29 @@ typename AStarAlgorithm<TGraph>::Result AStarAlgorithm<TGraph>::FindPathBidirect
   BidirectionalStepContext forward(true /* forward */, startVertex, finalVertex, graph);
   BidirectionalStepContext backward(false /* forward */, startVertex, finalVertex, graph);
 
+  // Both directions share vertex ids, so a vertex reached by one of them
+  // is checked in the other one with an array lookup.
+  TVertexIndex index;
+  auto const insertVertex = [&](TVertexType const & vertex)
+  {
+    uint32_t const id = index.Insert(vertex);
+    forward.Resize(index.GetSize());
+    backward.Resize(index.GetSize());
+    return id;
+  };
+
   bool foundAnyPath = false;
   double bestPathReducedLength = 0.0;
 
-  forward.bestDistance[startVertex] = 0.0;
-  forward.queue.push(State(startVertex, 0.0 /* distance */));
+  uint32_t const startId = insertVertex(startVertex);
+  forward.bestVertex = startId;
+  forward.bestDistance[startId] = 0.0;
+  forward.queue.PushOrDecrease(startId, 0.0 /* distance */);
 
-  backward.bestDistance[finalVertex] = 0.0;
-  backward.queue.push(State(finalVertex, 0.0 /* distance */));
+  uint32_t const finalId = insertVertex(finalVertex);
+  backward.bestVertex = finalId;
+  backward.bestDistance[finalId] = 0.0;
+  backward.queue.PushOrDecrease(finalId, 0.0 /* distance */);
 
   // To use the search code both for backward and forward directions
   // we keep the pointers to everything related to the search in the
@@ -273,7 +308,7 @@ typename AStarAlgorithm<TGraph>::Result AStarAlgorithm<TGraph>::FindPathBidirect
   // because if we have not found a path by the time one of the
   // queues is exhausted, we never will.
   uint32_t steps = 0;
-  while (!cur->queue.empty() && !nxt->queue.empty())
+  while (!cur->queue.Empty() && !nxt->queue.Empty())
   {
     ++steps;
 
@@ -302,7 +337,7 @@ typename AStarAlgorithm<TGraph>::Result AStarAlgorithm<TGraph>::FindPathBidirect
       if (curTop + nxtTop >= bestPathReducedLength - kEpsilon)
       {
         ReconstructPathBidirectional(cur->bestVertex, nxt->bestVertex, cur->parent, nxt->parent,
-                                     path);
+                                     index, path);
         CHECK(!path.empty(), ());
         if (!cur->forward)
           reverse(path.begin(), path.end());
@@ -310,38 +345,38 @@ typename AStarAlgorithm<TGraph>::Result AStarAlgorithm<TGraph>::FindPathBidirect
       }
     }
 
-    State const stateV = cur->queue.top();
-    cur->queue.pop();
+    uint32_t const v = cur->queue.Top();
+    double const distanceV = cur->queue.TopKey();
+    cur->queue.Pop();
 
-    if (stateV.distance > cur->bestDistance[stateV.vertex])
-      continue;
+    // The index may grow below, so the vertex is copied.
+    TVertexType const vertexV = index.GetVertex(v);
 
     if (steps % kVisitedVerticesPeriod == 0)
-      onVisitedVertexCallback(stateV.vertex, cur->forward ? cur->finalVertex : cur->startVertex);
+      onVisitedVertexCallback(vertexV, cur->forward ? cur->finalVertex : cur->startVertex);
 
-    cur->GetAdjacencyList(stateV.vertex, adj);
+    cur->GetAdjacencyList(vertexV, adj);
+    double const pV = cur->ConsistentHeuristic(vertexV);
     for (auto const & edge : adj)
     {
-      State stateW(edge.GetTarget(), 0.0);
-      if (stateV.vertex == stateW.vertex)
+      TVertexType const & vertexW = edge.GetTarget();
+      if (vertexV == vertexW)
         continue;
 
       double const len = edge.GetWeight();
-      double const pV = cur->ConsistentHeuristic(stateV.vertex);
-      double const pW = cur->ConsistentHeuristic(stateW.vertex);
+      double const pW = cur->ConsistentHeuristic(vertexW);
       double const reducedLen = len + pW - pV;
 
       CHECK(reducedLen >= -kEpsilon, ("Invariant violated:", reducedLen, "<", -kEpsilon));
-      double const newReducedDist = stateV.distance + max(reducedLen, 0.0);
+      double const newReducedDist = distanceV + max(reducedLen, 0.0);
 
-      auto const itCur = cur->bestDistance.find(stateW.vertex);
-      if (itCur != cur->bestDistance.end() && newReducedDist >= itCur->second - kEpsilon)
+      uint32_t const w = insertVertex(vertexW);
+      if (newReducedDist >= cur->bestDistance[w] - kEpsilon)
         continue;
 
-      auto const itNxt = nxt->bestDistance.find(stateW.vertex);
-      if (itNxt != nxt->bestDistance.end())
+      if (nxt->IsReached(w))
       {
-        double const distW = itNxt->second;
+        double const distW = nxt->bestDistance[w];
         // Reduced length that the path we've just found has in the original graph:
         // find the reduced length of the path's parts in the reduced forward and backward graphs.
         double const curPathReducedLength = newReducedDist + distW;
@@ -350,15 +385,14 @@ typename AStarAlgorithm<TGraph>::Result AStarAlgorithm<TGraph>::FindPathBidirect
         {
           bestPathReducedLength = curPathReducedLength;
           foundAnyPath = true;
-          cur->bestVertex = stateV.vertex;
-          nxt->bestVertex = stateW.vertex;
+          cur->bestVertex = v;
+          nxt->bestVertex = w;
         }
       }
 
-      stateW.distance = newReducedDist;
-      cur->bestDistance[stateW.vertex] = newReducedDist;
-      cur->parent[stateW.vertex] = stateV.vertex;
-      cur->queue.push(stateW);
+      cur->bestDistance[w] = newReducedDist;
+      cur->parent[w] = v;
+      cur->queue.PushOrDecrease(w, newReducedDist);
     }
   }
 
@@ -367,33 +401,25 @@ typename AStarAlgorithm<TGraph>::Result AStarAlgorithm<TGraph>::FindPathBidirect
 
 // static
 template <typename TGraph>
-void AStarAlgorithm<TGraph>::ReconstructPath(TVertexType const & v,
-                                             map<TVertexType, TVertexType> const & parent,
-                                             vector<TVertexType> & path)
+void AStarAlgorithm<TGraph>::ReconstructPath(uint32_t v, vector<uint32_t> const & parent,
+                                             TVertexIndex const & index, vector<TVertexType> & path)
 {
   path.clear();
-  TVertexType cur = v;
-  while (true)
-  {
-    path.push_back(cur);
-    auto it = parent.find(cur);
-    if (it == parent.end())
-      break;
-    cur = it->second;
-  }
+  for (uint32_t cur = v; cur != kNoParent; cur = parent[cur])
+    path.push_back(index.GetVertex(cur));
   reverse(path.begin(), path.end());
 }
 
 // static
 template <typename TGraph>
 void AStarAlgorithm<TGraph>::ReconstructPathBidirectional(
-    TVertexType const & v, TVertexType const & w, map<TVertexType, TVertexType> const & parentV,
-    map<TVertexType, TVertexType> const & parentW, vector<TVertexType> & path)
+    uint32_t v, uint32_t w, vector<uint32_t> const & parentV, vector<uint32_t> const & parentW,
+    TVertexIndex const & index, vector<TVertexType> & path)
 {
   vector<TVertexType> pathV;
-  ReconstructPath(v, parentV, pathV);
+  ReconstructPath(v, parentV, index, pathV);
   vector<TVertexType> pathW;
-  ReconstructPath(w, parentW, pathW);
+  ReconstructPath(w, parentW, index, pathW);
   path.clear();
   path.reserve(pathV.size() + pathW.size());
   path.insert(path.end(), pathV.begin(), pathV.end());
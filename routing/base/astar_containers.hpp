@@ -0,0 +1,173 @@
+#pragma once
+
+#include "base/assert.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/functional.hpp"
+#include "std/limits.hpp"
+#include "std/unordered_map.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace routing
+{
+
+/// VertexIndex assigns dense integer ids to graph vertices in order of their discovery,
+/// so per-vertex search state may be kept in contiguous arrays.
+/// std::hash must be defined for TVertex.
+template <typename TVertex>
+class VertexIndex
+{
+public:
+  static uint32_t constexpr kInvalidId = numeric_limits<uint32_t>::max();
+
+  /// @return Id of the vertex, a new id is assigned when the vertex is met for the first time.
+  uint32_t Insert(TVertex const & vertex)
+  {
+    auto const res = m_ids.emplace(vertex, static_cast<uint32_t>(m_vertices.size()));
+    if (res.second)
+      m_vertices.push_back(vertex);
+    return res.first->second;
+  }
+
+  /// @return Id of the vertex or kInvalidId when the vertex has not been inserted.
+  uint32_t Find(TVertex const & vertex) const
+  {
+    auto const it = m_ids.find(vertex);
+    return it == m_ids.end() ? kInvalidId : it->second;
+  }
+
+  inline TVertex const & GetVertex(uint32_t id) const
+  {
+    ASSERT_LESS(id, m_vertices.size(), ());
+    return m_vertices[id];
+  }
+
+  inline size_t GetSize() const { return m_vertices.size(); }
+
+private:
+  unordered_map<TVertex, uint32_t> m_ids;
+  vector<TVertex> m_vertices;
+};
+
+// static
+template <typename TVertex>
+uint32_t constexpr VertexIndex<TVertex>::kInvalidId;
+
+/// Min-heap of integer ids with double keys, which supports decrease-key operation.
+/// The heap is 4-ary: it's shallower than a binary one and children of a node
+/// are adjacent in memory, which makes sift-downs cheaper.
+class IndexedFourAryHeap
+{
+public:
+  inline bool Empty() const { return m_heap.empty(); }
+
+  inline uint32_t Top() const
+  {
+    ASSERT(!Empty(), ());
+    return m_heap.front().second;
+  }
+
+  inline double TopKey() const
+  {
+    ASSERT(!Empty(), ());
+    return m_heap.front().first;
+  }
+
+  inline bool Contains(uint32_t id) const
+  {
+    return id < m_positions.size() && m_positions[id] != kNotInHeap;
+  }
+
+  void Pop()
+  {
+    ASSERT(!Empty(), ());
+    m_positions[m_heap.front().second] = kNotInHeap;
+    if (m_heap.size() > 1)
+    {
+      m_heap.front() = m_heap.back();
+      m_positions[m_heap.front().second] = 0;
+    }
+    m_heap.pop_back();
+    if (!m_heap.empty())
+      SiftDown(0);
+  }
+
+  /// Inserts the id, or decreases its key when the id is already in the heap.
+  void PushOrDecrease(uint32_t id, double key)
+  {
+    if (id >= m_positions.size())
+      m_positions.resize(id + 1, static_cast<uint32_t>(kNotInHeap));
+
+    size_t pos = m_positions[id];
+    if (pos == kNotInHeap)
+    {
+      pos = m_heap.size();
+      m_heap.emplace_back(key, id);
+      m_positions[id] = static_cast<uint32_t>(pos);
+    }
+    else
+    {
+      ASSERT_LESS_OR_EQUAL(key, m_heap[pos].first, ());
+      m_heap[pos].first = key;
+    }
+    SiftUp(pos);
+  }
+
+private:
+  static uint32_t constexpr kNotInHeap = numeric_limits<uint32_t>::max();
+  static size_t constexpr kArity = 4;
+
+  using TItem = pair<double, uint32_t>;
+
+  void SiftUp(size_t pos)
+  {
+    TItem const item = m_heap[pos];
+    while (pos > 0)
+    {
+      size_t const parent = (pos - 1) / kArity;
+      if (m_heap[parent].first <= item.first)
+        break;
+      Place(pos, m_heap[parent]);
+      pos = parent;
+    }
+    Place(pos, item);
+  }
+
+  void SiftDown(size_t pos)
+  {
+    TItem const item = m_heap[pos];
+    size_t const size = m_heap.size();
+    while (true)
+    {
+      size_t const first = pos * kArity + 1;
+      if (first >= size)
+        break;
+
+      size_t best = first;
+      size_t const last = first + kArity < size ? first + kArity : size;
+      for (size_t child = first + 1; child < last; ++child)
+      {
+        if (m_heap[child].first < m_heap[best].first)
+          best = child;
+      }
+      if (item.first <= m_heap[best].first)
+        break;
+      Place(pos, m_heap[best]);
+      pos = best;
+    }
+    Place(pos, item);
+  }
+
+  inline void Place(size_t pos, TItem const & item)
+  {
+    m_heap[pos] = item;
+    m_positions[item.second] = static_cast<uint32_t>(pos);
+  }
+
+  vector<TItem> m_heap;
+  // Positions of ids in m_heap.
+  vector<uint32_t> m_positions;
+};
+
+}  // namespace routing
@@ -1,28 +1,40 @@
 #include "followed_polyline.hpp"
 
+#include "base/buffer_vector.hpp"
+
+#include "std/algorithm.hpp"
+
 namespace routing
 {
+namespace
+{
+// Segments are scanned linearly for shorter polylines.
+size_t constexpr kMinIndexedSegmentsCount = 64;
+// Rects of segments are inflated, because the index doesn't report rects which only touch
+// the query rect, and rects of vertical and horizontal segments are degenerate.
+double constexpr kSegRectEps = 1e-9;
+}  // namespace
 
 using Iter = routing::FollowedPolyline::Iter;
 
 Iter FollowedPolyline::Begin() const
 {
   ASSERT(IsValid(), ());
-  return Iter(m_poly.Front(), 0);
+  return Iter(GetPolyline().Front(), 0);
 }
 
 Iter FollowedPolyline::End() const
 {
   ASSERT(IsValid(), ());
-  return Iter(m_poly.Back(), m_poly.GetSize() - 1);
+  return Iter(GetPolyline().Back(), GetPolyline().GetSize() - 1);
 }
 
 Iter FollowedPolyline::GetIterToIndex(size_t index) const
 {
   ASSERT(IsValid(), ());
-  ASSERT_LESS(index, m_poly.GetSize(), ());
+  ASSERT_LESS(index, GetPolyline().GetSize(), ());
 
-  return Iter(m_poly.GetPoint(index), index);
+  return Iter(GetPolyline().GetPoint(index), index);
 }
 
 double FollowedPolyline::GetDistanceM(Iter const & it1, Iter const & it2) const
@@ -30,21 +42,21 @@ double FollowedPolyline::GetDistanceM(Iter const & it1, Iter const & it2) const
   ASSERT(IsValid(), ());
   ASSERT(it1.IsValid() && it2.IsValid(), ());
   ASSERT_LESS_OR_EQUAL(it1.m_ind, it2.m_ind, ());
-  ASSERT_LESS(it1.m_ind, m_poly.GetSize(), ());
-  ASSERT_LESS(it2.m_ind, m_poly.GetSize(), ());
+  ASSERT_LESS(it1.m_ind, GetPolyline().GetSize(), ());
+  ASSERT_LESS(it2.m_ind, GetPolyline().GetSize(), ());
 
   if (it1.m_ind == it2.m_ind)
     return MercatorBounds::DistanceOnEarth(it1.m_pt, it2.m_pt);
 
-  return (MercatorBounds::DistanceOnEarth(it1.m_pt, m_poly.GetPoint(it1.m_ind + 1)) +
-          m_segDistance[it2.m_ind - 1] - m_segDistance[it1.m_ind] +
-          MercatorBounds::DistanceOnEarth(m_poly.GetPoint(it2.m_ind), it2.m_pt));
+  return (MercatorBounds::DistanceOnEarth(it1.m_pt, GetPolyline().GetPoint(it1.m_ind + 1)) +
+          m_geometry->m_segDistance[it2.m_ind - 1] - m_geometry->m_segDistance[it1.m_ind] +
+          MercatorBounds::DistanceOnEarth(GetPolyline().GetPoint(it2.m_ind), it2.m_pt));
 }
 
 double FollowedPolyline::GetTotalDistanceM() const
 {
   ASSERT(IsValid(), ());
-  return m_segDistance.back();
+  return m_geometry->m_segDistance.back();
 }
 
 double FollowedPolyline::GetDistanceFromBeginM() const
@@ -52,8 +64,8 @@ double FollowedPolyline::GetDistanceFromBeginM() const
   ASSERT(IsValid(), ());
   ASSERT(m_current.IsValid(), ());
 
-  return (m_current.m_ind > 0 ? m_segDistance[m_current.m_ind - 1] : 0.0) +
-         MercatorBounds::DistanceOnEarth(m_current.m_pt, m_poly.GetPoint(m_current.m_ind));
+  return (m_current.m_ind > 0 ? m_geometry->m_segDistance[m_current.m_ind - 1] : 0.0) +
+         MercatorBounds::DistanceOnEarth(m_current.m_pt, GetPolyline().GetPoint(m_current.m_ind));
 }
 
 double FollowedPolyline::GetDistanceToEndM() const
@@ -63,34 +75,53 @@ double FollowedPolyline::GetDistanceToEndM() const
 
 void FollowedPolyline::Swap(FollowedPolyline & rhs)
 {
-  m_poly.Swap(rhs.m_poly);
-  m_segDistance.swap(rhs.m_segDistance);
-  m_segProj.swap(rhs.m_segProj);
+  m_geometry.swap(rhs.m_geometry);
   swap(m_current, rhs.m_current);
 }
 
-void FollowedPolyline::Update()
+m2::PolylineD const & FollowedPolyline::GetPolyline() const
 {
-  size_t n = m_poly.GetSize();
+  static m2::PolylineD const kEmptyPolyline;
+  return m_geometry ? m_geometry->m_poly : kEmptyPolyline;
+}
+
+void FollowedPolyline::Update(m2::PolylineD && poly)
+{
+  auto geometry = make_shared<Geometry>();
+  geometry->m_poly.Swap(poly);
+  m2::PolylineD const & p = geometry->m_poly;
+  size_t n = p.GetSize();
   ASSERT_GREATER(n, 1, ());
   --n;
 
-  m_segDistance.resize(n);
-  m_segProj.resize(n);
+  vector<double> & segDistance = geometry->m_segDistance;
+  vector<m2::ProjectionToSection<m2::PointD>> & segProj = geometry->m_segProj;
+  segDistance.resize(n);
+  segProj.resize(n);
 
-  double dist = 0.0;
+  // Segments lengths are accumulated in place.
+  MercatorBounds::SegmentsOnEarth(p.GetPoints().data(), n + 1, segDistance.data());
   for (size_t i = 0; i < n; ++i)
   {
-    m2::PointD const & p1 = m_poly.GetPoint(i);
-    m2::PointD const & p2 = m_poly.GetPoint(i + 1);
-
-    dist += MercatorBounds::DistanceOnEarth(p1, p2);
+    if (i != 0)
+      segDistance[i] += segDistance[i - 1];
+    segProj[i].SetBounds(p.GetPoint(i), p.GetPoint(i + 1));
+  }
 
-    m_segDistance[i] = dist;
-    m_segProj[i].SetBounds(p1, p2);
+  if (n >= kMinIndexedSegmentsCount)
+  {
+    geometry->m_segIndex.reset(new m4::Tree<size_t>());
+    for (size_t i = 0; i < n; ++i)
+    {
+      m2::RectD rect(p.GetPoint(i), p.GetPoint(i + 1));
+      rect.Inflate(kSegRectEps, kSegRectEps);
+      geometry->m_segIndex->Add(i, rect);
+    }
+    geometry->m_segIndex->Optimize();
   }
 
-  m_current = Iter(m_poly.Front(), 0);
+  m_current = Iter(p.Front(), 0);
+  m_geometry = move(geometry);
 }
 
 template <class DistanceFn>
@@ -101,13 +132,12 @@ Iter FollowedPolyline::GetClosestProjection(m2::RectD const & posRect,
   double minDist = numeric_limits<double>::max();
 
   m2::PointD const currPos = posRect.Center();
-  size_t const count = m_poly.GetSize() - 1;
-  for (size_t i = m_current.m_ind; i < count; ++i)
+  auto const checkSegment = [&](size_t i)
   {
-    m2::PointD const pt = m_segProj[i](currPos);
+    m2::PointD const pt = m_geometry->m_segProj[i](currPos);
 
     if (!posRect.IsPointInside(pt))
-      continue;
+      return;
 
     Iter it(pt, i);
     double const dp = distFn(it);
@@ -116,8 +146,29 @@ Iter FollowedPolyline::GetClosestProjection(m2::RectD const & posRect,
       res = it;
       minDist = dp;
     }
+  };
+
+  if (m_geometry->m_segIndex)
+  {
+    // Projection of a point to a segment lies in the segment's rect, so only segments
+    // whose rects intersect posRect are checked. They are checked in the polyline order
+    // as it's done by the linear scan to get the same projection among equidistant ones.
+    buffer_vector<size_t, 32> segments;
+    m_geometry->m_segIndex->ForEachInRect(posRect, [&](size_t i)
+    {
+      if (i >= m_current.m_ind)
+        segments.push_back(i);
+    });
+    sort(segments.begin(), segments.end());
+    for (size_t const i : segments)
+      checkSegment(i);
+    return res;
   }
 
+  size_t const count = GetPolyline().GetSize() - 1;
+  for (size_t i = m_current.m_ind; i < count; ++i)
+    checkSegment(i);
+
   return res;
 }
 
@@ -125,7 +176,7 @@ Iter FollowedPolyline::UpdateProjectionByPrediction(m2::RectD const & posRect,
                                                     double predictDistance) const
 {
   ASSERT(m_current.IsValid(), ());
-  ASSERT_LESS(m_current.m_ind, m_poly.GetSize() - 1, ());
+  ASSERT_LESS(m_current.m_ind, GetPolyline().GetSize() - 1, ());
 
   if (predictDistance <= 0.0)
     return UpdateProjection(posRect);
@@ -144,7 +195,7 @@ Iter FollowedPolyline::UpdateProjectionByPrediction(m2::RectD const & posRect,
 Iter FollowedPolyline::UpdateProjection(m2::RectD const & posRect) const
 {
   ASSERT(m_current.IsValid(), ());
-  ASSERT_LESS(m_current.m_ind, m_poly.GetSize() - 1, ());
+  ASSERT_LESS(m_current.m_ind, GetPolyline().GetSize() - 1, ());
 
   Iter res;
   m2::PointD const currPos = posRect.Center();
@@ -164,9 +215,9 @@ double FollowedPolyline::GetMercatorDistanceFromBegin() const
   if (m_current.IsValid())
   {
     for (size_t i = 1; i <= m_current.m_ind; i++)
-      distance += m_poly.GetPoint(i).Length(m_poly.GetPoint(i - 1));
+      distance += GetPolyline().GetPoint(i).Length(GetPolyline().GetPoint(i - 1));
 
-    distance += m_poly.GetPoint(m_current.m_ind).Length(m_current.m_pt);
+    distance += GetPolyline().GetPoint(m_current.m_ind).Length(m_current.m_pt);
   }
 
   return distance;
@@ -175,9 +226,9 @@ double FollowedPolyline::GetMercatorDistanceFromBegin() const
 void FollowedPolyline::GetCurrentDirectionPoint(m2::PointD & pt, double toleranceM) const
 {
   ASSERT(IsValid(), ());
-  size_t currentIndex = min(m_current.m_ind + 1, m_poly.GetSize() - 1);
-  m2::PointD point = m_poly.GetPoint(currentIndex);
-  for (; currentIndex < m_poly.GetSize() - 1; point = m_poly.GetPoint(++currentIndex))
+  size_t currentIndex = min(m_current.m_ind + 1, GetPolyline().GetSize() - 1);
+  m2::PointD point = GetPolyline().GetPoint(currentIndex);
+  for (; currentIndex < GetPolyline().GetSize() - 1; point = GetPolyline().GetPoint(++currentIndex))
   {
     if (MercatorBounds::DistanceOnEarth(point, m_current.m_pt) > toleranceM)
       break;
@@ -4,6 +4,11 @@
 
 #include "geometry/point2d.hpp"
 #include "geometry/polyline2d.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "std/shared_ptr.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
 
 namespace routing
 {
@@ -13,16 +18,15 @@ public:
   FollowedPolyline() = default;
   template <class TIter>
   FollowedPolyline(TIter begin, TIter end)
-    : m_poly(begin, end)
   {
-    Update();
+    Update(m2::PolylineD(begin, end));
   }
 
   void Swap(FollowedPolyline & rhs);
 
-  bool IsValid() const { return (m_current.IsValid() && m_poly.GetSize() > 1); }
+  bool IsValid() const { return (m_current.IsValid() && GetPolyline().GetSize() > 1); }
 
-  m2::PolylineD const & GetPolyline() const { return m_poly; }
+  m2::PolylineD const & GetPolyline() const;
 
   double GetTotalDistanceM() const;
   double GetDistanceFromBeginM() const;
@@ -61,16 +65,26 @@ private:
   template <class DistanceFn>
   Iter GetClosestProjection(m2::RectD const & posRect, DistanceFn const & distFn) const;
 
-  void Update();
+  /// Polyline with the precalculated info. It's immutable after Update(), so it's shared between
+  /// copies and a copy of the polyline is a copy of the pointer and the current position.
+  struct Geometry
+  {
+    m2::PolylineD m_poly;
+    /// Precalculated info for fast projection finding.
+    vector<m2::ProjectionToSection<m2::PointD>> m_segProj;
+    /// Accumulated cache of segments length in meters.
+    vector<double> m_segDistance;
+    /// Index of segments by their rects. It's built for long polylines only, so finding
+    /// of the projection doesn't depend on the number of segments ahead of the current position.
+    unique_ptr<m4::Tree<size_t>> m_segIndex;
+  };
 
-  m2::PolylineD m_poly;
+  void Update(m2::PolylineD && poly);
 
+  /// It's null for the default constructed polyline only.
+  shared_ptr<Geometry const> m_geometry;
   /// Iterator with the current position. Position sets with UpdateProjection methods.
   mutable Iter m_current;
-  /// Precalculated info for fast projection finding.
-  vector<m2::ProjectionToSection<m2::PointD>> m_segProj;
-  /// Accumulated cache of segments length in meters.
-  vector<double> m_segDistance;
 };
 
 }  // namespace routing
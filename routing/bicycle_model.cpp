@@ -0,0 +1,159 @@
+#include "bicycle_model.hpp"
+
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+#include "base/logging.hpp"
+
+#include "indexer/classificator.hpp"
+#include "indexer/feature.hpp"
+
+namespace
+{
+
+// See road types here:
+//   http://wiki.openstreetmap.org/wiki/Key:highway
+// Motorways and motorway links are not allowed for bicycles, steps are not listed as well.
+
+// Heuristics:
+// Like in the pedestrian model, the roads which are more convenient for bicycles have greater
+// speeds, so the heavy traffic roads are avoided when there are cycleways and quiet streets
+// nearby. Footways and pedestrian streets have the speed of walking, a bicycle is pushed there.
+
+double constexpr kSpeedTrunkKMpH = 3.0;
+double constexpr kSpeedTrunkLinkKMpH = 3.0;
+double constexpr kSpeedPrimaryKMpH = 5.0;
+double constexpr kSpeedPrimaryLinkKMpH = 5.0;
+double constexpr kSpeedSecondaryKMpH = 15.0;
+double constexpr kSpeedSecondaryLinkKMpH = 15.0;
+double constexpr kSpeedTertiaryKMpH = 15.0;
+double constexpr kSpeedTertiaryLinkKMpH = 15.0;
+double constexpr kSpeedServiceKMpH = 12.0;
+double constexpr kSpeedUnclassifiedKMpH = 12.0;
+double constexpr kSpeedRoadKMpH = 10.0;
+double constexpr kSpeedTrackKMpH = 8.0;
+double constexpr kSpeedPathKMpH = 6.0;
+double constexpr kSpeedBridlewayKMpH = 4.0;
+double constexpr kSpeedCyclewayKMpH = 20.0;
+double constexpr kSpeedResidentialKMpH = 15.0;
+double constexpr kSpeedLivingStreetKMpH = 8.0;
+double constexpr kSpeedPedestrianKMpH = 5.0;
+double constexpr kSpeedFootwayKMpH = 5.0;
+double constexpr kSpeedPlatformKMpH = 3.0;
+
+// Default
+routing::VehicleModel::InitListT const s_bicycleLimits_Default =
+{
+  { {"highway", "trunk"},          kSpeedTrunkKMpH },
+  { {"highway", "trunk_link"},     kSpeedTrunkLinkKMpH },
+  { {"highway", "primary"},        kSpeedPrimaryKMpH },
+  { {"highway", "primary_link"},   kSpeedPrimaryLinkKMpH },
+  { {"highway", "secondary"},      kSpeedSecondaryKMpH },
+  { {"highway", "secondary_link"}, kSpeedSecondaryLinkKMpH },
+  { {"highway", "tertiary"},       kSpeedTertiaryKMpH },
+  { {"highway", "tertiary_link"},  kSpeedTertiaryLinkKMpH },
+  { {"highway", "service"},        kSpeedServiceKMpH },
+  { {"highway", "unclassified"},   kSpeedUnclassifiedKMpH },
+  { {"highway", "road"},           kSpeedRoadKMpH },
+  { {"highway", "track"},          kSpeedTrackKMpH },
+  { {"highway", "path"},           kSpeedPathKMpH },
+  { {"highway", "bridleway"},      kSpeedBridlewayKMpH },
+  { {"highway", "cycleway"},       kSpeedCyclewayKMpH },
+  { {"highway", "residential"},    kSpeedResidentialKMpH },
+  { {"highway", "living_street"},  kSpeedLivingStreetKMpH },
+  { {"highway", "pedestrian"},     kSpeedPedestrianKMpH },
+  { {"highway", "footway"},        kSpeedFootwayKMpH },
+  { {"highway", "platform"},       kSpeedPlatformKMpH },
+};
+
+// Bicycles are not allowed on trunks in these countries, see
+//   http://wiki.openstreetmap.org/wiki/OSM_tags_for_routing/Access-Restrictions
+routing::VehicleModel::InitListT const s_bicycleLimits_NoTrunk =
+{
+  { {"highway", "primary"},        kSpeedPrimaryKMpH },
+  { {"highway", "primary_link"},   kSpeedPrimaryLinkKMpH },
+  { {"highway", "secondary"},      kSpeedSecondaryKMpH },
+  { {"highway", "secondary_link"}, kSpeedSecondaryLinkKMpH },
+  { {"highway", "tertiary"},       kSpeedTertiaryKMpH },
+  { {"highway", "tertiary_link"},  kSpeedTertiaryLinkKMpH },
+  { {"highway", "service"},        kSpeedServiceKMpH },
+  { {"highway", "unclassified"},   kSpeedUnclassifiedKMpH },
+  { {"highway", "road"},           kSpeedRoadKMpH },
+  { {"highway", "track"},          kSpeedTrackKMpH },
+  { {"highway", "path"},           kSpeedPathKMpH },
+  { {"highway", "cycleway"},       kSpeedCyclewayKMpH },
+  { {"highway", "residential"},    kSpeedResidentialKMpH },
+  { {"highway", "living_street"},  kSpeedLivingStreetKMpH },
+  { {"highway", "pedestrian"},     kSpeedPedestrianKMpH },
+  { {"highway", "footway"},        kSpeedFootwayKMpH },
+  { {"highway", "platform"},       kSpeedPlatformKMpH },
+};
+
+}  // namespace
+
+namespace routing
+{
+
+BicycleModel::BicycleModel()
+  : VehicleModel(classif(), s_bicycleLimits_Default)
+{
+  Init();
+}
+
+BicycleModel::BicycleModel(VehicleModel::InitListT const & speedLimits)
+  : VehicleModel(classif(), speedLimits)
+{
+  Init();
+}
+
+void BicycleModel::Init()
+{
+  initializer_list<char const *> arr[] =
+  {
+    { "route", "ferry" },
+    { "man_made", "pier" },
+  };
+
+  SetAdditionalRoadTypes(classif(), arr, ARRAY_SIZE(arr));
+}
+
+double BicycleModel::GetSpeed(FeatureType const & f) const
+{
+  feature::TypesHolder types(f);
+
+  if (IsRoad(types))
+    return VehicleModel::GetSpeed(types);
+
+  return 0.0;
+}
+
+
+BicycleModelFactory::BicycleModelFactory()
+{
+  m_models[string()] = make_shared<BicycleModel>();
+  m_models["Austria"] = make_shared<BicycleModel>(s_bicycleLimits_NoTrunk);
+  m_models["Belgium"] = make_shared<BicycleModel>(s_bicycleLimits_NoTrunk);
+  m_models["Germany"] = make_shared<BicycleModel>(s_bicycleLimits_NoTrunk);
+  m_models["Netherlands"] = make_shared<BicycleModel>(s_bicycleLimits_NoTrunk);
+  m_models["Switzerland"] = make_shared<BicycleModel>(s_bicycleLimits_NoTrunk);
+}
+
+shared_ptr<IVehicleModel> BicycleModelFactory::GetVehicleModel() const
+{
+  auto const itr = m_models.find(string());
+  ASSERT(itr != m_models.end(), ());
+  return itr->second;
+}
+
+shared_ptr<IVehicleModel> BicycleModelFactory::GetVehicleModelForCountry(string const & country) const
+{
+  auto const itr = m_models.find(country);
+  if (itr != m_models.end())
+  {
+    LOG(LDEBUG, ("Bicycle model was found:", country));
+    return itr->second;
+  }
+  LOG(LDEBUG, ("Bicycle model wasn't found, default model is used instead:", country));
+  return BicycleModelFactory::GetVehicleModel();
+}
+
+}  // routing
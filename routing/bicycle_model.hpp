@@ -0,0 +1,41 @@
+#pragma once
+
+#include "std/shared_ptr.hpp"
+#include "std/unordered_map.hpp"
+
+#include "vehicle_model.hpp"
+
+namespace routing
+{
+
+class BicycleModel : public VehicleModel
+{
+public:
+  BicycleModel();
+  BicycleModel(VehicleModel::InitListT const & speedLimits);
+
+  /// @name Overrides from VehicleModel.
+  //@{
+  double GetSpeed(FeatureType const & f) const override;
+  //@}
+
+private:
+  void Init();
+};
+
+class BicycleModelFactory : public IVehicleModelFactory
+{
+public:
+  BicycleModelFactory();
+
+  /// @name Overrides from IVehicleModelFactory.
+  //@{
+  shared_ptr<IVehicleModel> GetVehicleModel() const override;
+  shared_ptr<IVehicleModel> GetVehicleModelForCountry(string const & country) const override;
+  //@}
+
+private:
+  unordered_map<string, shared_ptr<IVehicleModel>> m_models;
+};
+
+}  // namespace routing
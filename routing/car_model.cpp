@@ -4,6 +4,8 @@
 
 #include "indexer/classificator.hpp"
 
+#include "std/shared_ptr.hpp"
+
 namespace
 {
 
@@ -52,4 +54,6 @@ CarModel::CarModel()
   SetAdditionalRoadTypes(classif(), arr, ARRAY_SIZE(arr));
 }
 
+CarModelFactory::CarModelFactory() : m_model(make_shared<CarModel>()) {}
+
 }  // namespace routing
@@ -11,4 +11,23 @@ public:
   CarModel();
 };
 
+/// The same car model is used in all the countries.
+class CarModelFactory : public IVehicleModelFactory
+{
+public:
+  CarModelFactory();
+
+  /// @name Overrides from IVehicleModelFactory.
+  //@{
+  shared_ptr<IVehicleModel> GetVehicleModel() const override { return m_model; }
+  shared_ptr<IVehicleModel> GetVehicleModelForCountry(string const & /* country */) const override
+  {
+    return m_model;
+  }
+  //@}
+
+private:
+  shared_ptr<IVehicleModel> const m_model;
+};
+
 }  // namespace routing
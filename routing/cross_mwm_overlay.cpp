@@ -0,0 +1,237 @@
+#include "routing/cross_mwm_overlay.hpp"
+
+#include "geometry/distance_on_sphere.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/functional.hpp"
+#include "std/queue.hpp"
+
+namespace routing
+{
+// static
+uint32_t constexpr CrossMwmOverlay::kInvalidIndex;
+
+void CrossMwmOverlay::AddMwm(string const & name, uint32_t timestamp,
+                             CrossRoutingContextReader const & context)
+{
+  ASSERT(m_mwmIndices.find(name) == m_mwmIndices.end(), ("Mwm is added twice:", name));
+
+  Mwm mwm;
+  mwm.m_name = name;
+  mwm.m_timestamp = timestamp;
+  mwm.m_firstVertex = static_cast<uint32_t>(m_vertexNodes.size());
+  mwm.m_firstOutgoing = static_cast<uint32_t>(m_outgoingNodes.size());
+  m_mwmIndices[name] = static_cast<uint32_t>(m_mwms.size());
+  m_mwms.push_back(mwm);
+
+  if (m_edgeOffsets.empty())
+    m_edgeOffsets.push_back(0);
+
+  auto const outRange = context.GetOutgoingIterators();
+  for (auto outIt = outRange.first; outIt != outRange.second; ++outIt)
+  {
+    m_outgoingNodes.push_back(outIt->m_nodeId);
+    m_outgoingMwms.push_back(context.GetOutgoingMwmName(*outIt));
+    m_outgoingPoints.push_back(outIt->m_point);
+  }
+
+  auto const inRange = context.GetIngoingIterators();
+  for (auto inIt = inRange.first; inIt != inRange.second; ++inIt)
+  {
+    m_vertexNodes.push_back(inIt->m_nodeId);
+    m_vertexPoints.push_back(inIt->m_point);
+    for (auto outIt = outRange.first; outIt != outRange.second; ++outIt)
+    {
+      // The same edges are skipped by CrossMwmGraph.
+      WritedEdgeWeightT const weight = context.GetAdjacencyCost(inIt, outIt);
+      if (weight == INVALID_CONTEXT_EDGE_WEIGHT || weight == 0)
+        continue;
+      uint32_t const outgoing =
+          mwm.m_firstOutgoing + static_cast<uint32_t>(distance(outRange.first, outIt));
+      m_edges.emplace_back(outgoing, weight);
+    }
+    m_edgeOffsets.push_back(static_cast<uint32_t>(m_edges.size()));
+  }
+}
+
+void CrossMwmOverlay::Link()
+{
+  ASSERT_EQUAL(m_outgoingMwms.size(), m_outgoingNodes.size(), ());
+  BuildLookups();
+
+  m_outgoingTargets.assign(m_outgoingNodes.size(), kInvalidIndex);
+  size_t linkedCount = 0;
+  for (size_t o = 0; o < m_outgoingNodes.size(); ++o)
+  {
+    uint32_t const mwm = FindMwm(m_outgoingMwms[o]);
+    if (mwm == kInvalidIndex)
+      continue;
+
+    // The first matching node is taken as CrossMwmGraph does.
+    m2::PointD const & point = m_outgoingPoints[o];
+    for (uint32_t v = m_mwms[mwm].m_firstVertex; v < GetVertexEnd(mwm); ++v)
+    {
+      m2::PointD const & target = m_vertexPoints[v];
+      if (ms::DistanceOnEarth(point.y, point.x, target.y, target.x) <
+          kCrossNodesEqualityRadiusMeters)
+      {
+        m_outgoingTargets[o] = v;
+        ++linkedCount;
+        break;
+      }
+    }
+  }
+
+  LOG(LINFO, ("Cross mwm overlay has", m_mwms.size(), "mwms,", m_vertexNodes.size(), "ingoing and",
+              m_outgoingNodes.size(), "outgoing nodes,", linkedCount, "outgoing nodes are linked."));
+
+  m_outgoingMwms.clear();
+  m_outgoingPoints.clear();
+}
+
+uint32_t CrossMwmOverlay::FindMwm(string const & name) const
+{
+  auto const it = m_mwmIndices.find(name);
+  return it == m_mwmIndices.end() ? kInvalidIndex : it->second;
+}
+
+uint32_t CrossMwmOverlay::FindVertex(uint32_t mwm, WritedNodeID node) const
+{
+  ASSERT_LESS(mwm, m_mwms.size(), ());
+  auto const begin = m_sortedVertices.begin() + m_mwms[mwm].m_firstVertex;
+  auto const end = m_sortedVertices.begin() + GetVertexEnd(mwm);
+  auto const it = lower_bound(begin, end, node, [this](uint32_t vertex, WritedNodeID node)
+                              {
+                                return m_vertexNodes[vertex] < node;
+                              });
+  if (it == end || m_vertexNodes[*it] != node)
+    return kInvalidIndex;
+  return *it;
+}
+
+uint32_t CrossMwmOverlay::GetVertexMwm(uint32_t vertex) const
+{
+  ASSERT_LESS(vertex, m_vertexNodes.size(), ());
+  auto const it = upper_bound(m_mwms.begin(), m_mwms.end(), vertex, [](uint32_t vertex, Mwm const & mwm)
+                              {
+                                return vertex < mwm.m_firstVertex;
+                              });
+  ASSERT(it != m_mwms.begin(), ());
+  return static_cast<uint32_t>(distance(m_mwms.begin(), it) - 1);
+}
+
+bool CrossMwmOverlay::FindMwmsPath(uint32_t startMwm, uint32_t finalMwm,
+                                   vector<uint32_t> & mwms) const
+{
+  ASSERT_LESS(startMwm, m_mwms.size(), ());
+  ASSERT_LESS(finalMwm, m_mwms.size(), ());
+  mwms.clear();
+  if (startMwm == finalMwm)
+  {
+    mwms.push_back(startMwm);
+    return true;
+  }
+
+  // Dijkstra over the vertices, the parent of a vertex is the vertex the path comes from,
+  // it's kInvalidIndex for the vertices linked with the start mwm.
+  using TQueueEntry = pair<uint64_t, uint32_t>;
+  uint64_t const kInfinity = numeric_limits<uint64_t>::max();
+  vector<uint64_t> distances(m_vertexNodes.size(), kInfinity);
+  vector<uint32_t> parents(m_vertexNodes.size(), kInvalidIndex);
+  priority_queue<TQueueEntry, vector<TQueueEntry>, greater<TQueueEntry>> queue;
+  for (uint32_t o = m_mwms[startMwm].m_firstOutgoing; o < GetOutgoingEnd(startMwm); ++o)
+  {
+    uint32_t const target = m_outgoingTargets[o];
+    if (target == kInvalidIndex || distances[target] == 0)
+      continue;
+    distances[target] = 0;
+    queue.emplace(0, target);
+  }
+
+  uint32_t finalVertex = kInvalidIndex;
+  while (!queue.empty())
+  {
+    TQueueEntry const top = queue.top();
+    queue.pop();
+    uint32_t const vertex = top.second;
+    if (top.first != distances[vertex])
+      continue;
+    uint32_t const mwm = GetVertexMwm(vertex);
+    if (mwm == finalMwm)
+    {
+      finalVertex = vertex;
+      break;
+    }
+
+    ForEachEdge(vertex, [&](uint32_t outgoing, WritedEdgeWeightT weight)
+    {
+      uint32_t const target = m_outgoingTargets[outgoing];
+      if (target == kInvalidIndex)
+        return;
+      uint64_t const distance = top.first + weight;
+      if (distance >= distances[target])
+        return;
+      distances[target] = distance;
+      parents[target] = vertex;
+      queue.emplace(distance, target);
+    });
+  }
+
+  if (finalVertex == kInvalidIndex)
+    return false;
+
+  for (uint32_t vertex = finalVertex; vertex != kInvalidIndex; vertex = parents[vertex])
+  {
+    uint32_t const mwm = GetVertexMwm(vertex);
+    if (mwms.empty() || mwms.back() != mwm)
+      mwms.push_back(mwm);
+  }
+  mwms.push_back(startMwm);
+  reverse(mwms.begin(), mwms.end());
+  return true;
+}
+
+void CrossMwmOverlay::Clear()
+{
+  CrossMwmOverlay().Swap(*this);
+}
+
+void CrossMwmOverlay::Swap(CrossMwmOverlay & rhs)
+{
+  m_mwms.swap(rhs.m_mwms);
+  m_mwmIndices.swap(rhs.m_mwmIndices);
+  m_vertexNodes.swap(rhs.m_vertexNodes);
+  m_vertexPoints.swap(rhs.m_vertexPoints);
+  m_sortedVertices.swap(rhs.m_sortedVertices);
+  m_edgeOffsets.swap(rhs.m_edgeOffsets);
+  m_edges.swap(rhs.m_edges);
+  m_outgoingNodes.swap(rhs.m_outgoingNodes);
+  m_outgoingTargets.swap(rhs.m_outgoingTargets);
+  m_outgoingMwms.swap(rhs.m_outgoingMwms);
+  m_outgoingPoints.swap(rhs.m_outgoingPoints);
+}
+
+void CrossMwmOverlay::BuildLookups()
+{
+  m_mwmIndices.clear();
+  m_sortedVertices.resize(m_vertexNodes.size());
+  for (uint32_t mwm = 0; mwm < m_mwms.size(); ++mwm)
+  {
+    m_mwmIndices[m_mwms[mwm].m_name] = mwm;
+
+    auto const begin = m_sortedVertices.begin() + m_mwms[mwm].m_firstVertex;
+    auto const end = m_sortedVertices.begin() + GetVertexEnd(mwm);
+    uint32_t vertex = m_mwms[mwm].m_firstVertex;
+    for (auto it = begin; it != end; ++it)
+      *it = vertex++;
+    sort(begin, end, [this](uint32_t v1, uint32_t v2)
+         {
+           return m_vertexNodes[v1] < m_vertexNodes[v2];
+         });
+  }
+}
+
+}  // namespace routing
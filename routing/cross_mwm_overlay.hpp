@@ -0,0 +1,214 @@
+#pragma once
+
+#include "routing/cross_routing_context.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/varint.hpp"
+#include "coding/read_write_utils.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/limits.hpp"
+#include "std/map.hpp"
+#include "std/string.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace routing
+{
+
+/// CrossMwmOverlay is a precomputed graph of border crossings of a set of mwms.
+/// Its vertices are ingoing cross nodes of the mwms. Edges of a vertex are the weights
+/// from the cross context adjacency matrix to outgoing nodes of the same mwm, and each outgoing
+/// node is linked with the matching ingoing node of the neighbouring mwm. So the cross mwm
+/// search over the overlay neither loads cross contexts nor matches border nodes at query time.
+///
+/// The overlay is valid for an mwm while the timestamp of its routing file is the same
+/// as the one the overlay was built for.
+class CrossMwmOverlay
+{
+public:
+  static uint32_t constexpr kInvalidIndex = numeric_limits<uint32_t>::max();
+
+  /// Adds the cross context of the mwm. Link() must be called after all the mwms are added.
+  void AddMwm(string const & name, uint32_t timestamp, CrossRoutingContextReader const & context);
+
+  /// Links outgoing nodes to ingoing nodes of the neighbouring mwms. Nodes are linked when
+  /// the distance between them is less than kCrossNodesEqualityRadiusMeters.
+  void Link();
+
+  inline uint32_t GetMwmsCount() const { return static_cast<uint32_t>(m_mwms.size()); }
+  inline string const & GetMwmName(uint32_t mwm) const { return m_mwms[mwm].m_name; }
+  inline uint32_t GetTimestamp(uint32_t mwm) const { return m_mwms[mwm].m_timestamp; }
+
+  /// @return Index of the mwm or kInvalidIndex.
+  uint32_t FindMwm(string const & name) const;
+
+  /// @return Vertex of the ingoing node of the mwm or kInvalidIndex.
+  uint32_t FindVertex(uint32_t mwm, WritedNodeID node) const;
+
+  /// @return Index of the mwm the vertex belongs to.
+  uint32_t GetVertexMwm(uint32_t vertex) const;
+  inline WritedNodeID GetVertexNode(uint32_t vertex) const { return m_vertexNodes[vertex]; }
+  /// @return Point of the ingoing node in lon/lat as it's kept by the cross context.
+  inline m2::PointD const & GetVertexPoint(uint32_t vertex) const { return m_vertexPoints[vertex]; }
+
+  /// @return Overlay index of the outgoing node, index is the position of the node
+  ///         in the cross context of the mwm.
+  inline uint32_t GetOutgoing(uint32_t mwm, size_t index) const
+  {
+    ASSERT_LESS(m_mwms[mwm].m_firstOutgoing + index, GetOutgoingEnd(mwm), ());
+    return m_mwms[mwm].m_firstOutgoing + static_cast<uint32_t>(index);
+  }
+  inline WritedNodeID GetOutgoingNode(uint32_t outgoing) const { return m_outgoingNodes[outgoing]; }
+  /// @return Vertex of the neighbouring mwm linked with the outgoing node or kInvalidIndex.
+  inline uint32_t GetOutgoingTarget(uint32_t outgoing) const { return m_outgoingTargets[outgoing]; }
+
+  /// Calls fn(outgoing, weight) for each outgoing node reachable from the vertex.
+  template <typename TFn>
+  void ForEachEdge(uint32_t vertex, TFn && fn) const
+  {
+    for (uint32_t i = m_edgeOffsets[vertex]; i < m_edgeOffsets[vertex + 1]; ++i)
+      fn(m_edges[i].first, m_edges[i].second);
+  }
+
+  /// Finds the mwms of the shortest path over the overlay from the start mwm to the final one.
+  /// Weights inside the start and the final mwms are unknown, so the path starts at any outgoing
+  /// node of the start mwm and ends at any ingoing node of the final mwm.
+  /// @return False when the final mwm isn't reachable, mwms are in order of the path otherwise.
+  bool FindMwmsPath(uint32_t startMwm, uint32_t finalMwm, vector<uint32_t> & mwms) const;
+
+  template <class TSink>
+  void Serialize(TSink & sink) const
+  {
+    ASSERT(m_outgoingMwms.empty(), ("The overlay must be linked."));
+
+    WriteVarUint(sink, static_cast<uint32_t>(m_mwms.size()));
+    for (size_t mwm = 0; mwm < m_mwms.size(); ++mwm)
+    {
+      rw::Write(sink, m_mwms[mwm].m_name);
+      WriteVarUint(sink, m_mwms[mwm].m_timestamp);
+      WriteVarUint(sink, GetVertexEnd(mwm) - m_mwms[mwm].m_firstVertex);
+      WriteVarUint(sink, GetOutgoingEnd(mwm) - m_mwms[mwm].m_firstOutgoing);
+    }
+
+    for (size_t v = 0; v < m_vertexNodes.size(); ++v)
+    {
+      WriteVarUint(sink, m_vertexNodes[v]);
+      WriteVarUint(sink, static_cast<uint64_t>(PointToInt64(m_vertexPoints[v], POINT_COORD_BITS)));
+      WriteVarUint(sink, m_edgeOffsets[v + 1] - m_edgeOffsets[v]);
+      for (uint32_t i = m_edgeOffsets[v]; i < m_edgeOffsets[v + 1]; ++i)
+      {
+        WriteVarUint(sink, m_edges[i].first);
+        WriteVarUint(sink, m_edges[i].second);
+      }
+    }
+
+    // Targets are shifted by one, zero is written for the outgoing nodes which are not linked.
+    for (size_t o = 0; o < m_outgoingNodes.size(); ++o)
+    {
+      WriteVarUint(sink, m_outgoingNodes[o]);
+      WriteVarUint(sink, m_outgoingTargets[o] == kInvalidIndex ? 0 : m_outgoingTargets[o] + 1);
+    }
+  }
+
+  template <class TSource>
+  void Deserialize(TSource & src)
+  {
+    Clear();
+
+    uint32_t const mwmsCount = ReadVarUint<uint32_t>(src);
+    m_mwms.resize(mwmsCount);
+    uint32_t verticesCount = 0;
+    uint32_t outgoingCount = 0;
+    for (Mwm & mwm : m_mwms)
+    {
+      rw::Read(src, mwm.m_name);
+      mwm.m_timestamp = ReadVarUint<uint32_t>(src);
+      mwm.m_firstVertex = verticesCount;
+      mwm.m_firstOutgoing = outgoingCount;
+      verticesCount += ReadVarUint<uint32_t>(src);
+      outgoingCount += ReadVarUint<uint32_t>(src);
+    }
+
+    m_vertexNodes.resize(verticesCount);
+    m_vertexPoints.resize(verticesCount);
+    m_edgeOffsets.assign(1, 0);
+    m_edgeOffsets.reserve(verticesCount + 1);
+    for (uint32_t v = 0; v < verticesCount; ++v)
+    {
+      m_vertexNodes[v] = ReadVarUint<WritedNodeID>(src);
+      m_vertexPoints[v] =
+          Int64ToPoint(static_cast<int64_t>(ReadVarUint<uint64_t>(src)), POINT_COORD_BITS);
+      uint32_t const edgesCount = ReadVarUint<uint32_t>(src);
+      for (uint32_t i = 0; i < edgesCount; ++i)
+      {
+        uint32_t const outgoing = ReadVarUint<uint32_t>(src);
+        m_edges.emplace_back(outgoing, ReadVarUint<WritedEdgeWeightT>(src));
+      }
+      m_edgeOffsets.push_back(static_cast<uint32_t>(m_edges.size()));
+    }
+
+    m_outgoingNodes.resize(outgoingCount);
+    m_outgoingTargets.resize(outgoingCount);
+    for (uint32_t o = 0; o < outgoingCount; ++o)
+    {
+      m_outgoingNodes[o] = ReadVarUint<WritedNodeID>(src);
+      uint32_t const target = ReadVarUint<uint32_t>(src);
+      m_outgoingTargets[o] = (target == 0 ? kInvalidIndex : target - 1);
+    }
+
+    BuildLookups();
+  }
+
+  void Clear();
+  void Swap(CrossMwmOverlay & rhs);
+
+private:
+  struct Mwm
+  {
+    string m_name;
+    uint32_t m_timestamp = 0;
+    uint32_t m_firstVertex = 0;
+    uint32_t m_firstOutgoing = 0;
+  };
+
+  inline uint32_t GetVertexEnd(size_t mwm) const
+  {
+    return mwm + 1 < m_mwms.size() ? m_mwms[mwm + 1].m_firstVertex
+                                   : static_cast<uint32_t>(m_vertexNodes.size());
+  }
+
+  inline uint32_t GetOutgoingEnd(size_t mwm) const
+  {
+    return mwm + 1 < m_mwms.size() ? m_mwms[mwm + 1].m_firstOutgoing
+                                   : static_cast<uint32_t>(m_outgoingNodes.size());
+  }
+
+  void BuildLookups();
+
+  vector<Mwm> m_mwms;
+  map<string, uint32_t> m_mwmIndices;
+
+  // Ingoing nodes, the vertices of each mwm are contiguous and keep the cross context order.
+  vector<WritedNodeID> m_vertexNodes;
+  vector<m2::PointD> m_vertexPoints;
+  // Vertices of each mwm sorted by node ids.
+  vector<uint32_t> m_sortedVertices;
+
+  // Edges of the i-th vertex are [m_edgeOffsets[i], m_edgeOffsets[i + 1]).
+  // An edge is a pair of an outgoing node and a weight.
+  vector<uint32_t> m_edgeOffsets;
+  vector<pair<uint32_t, WritedEdgeWeightT>> m_edges;
+
+  // Outgoing nodes, the nodes of each mwm are contiguous and keep the cross context order.
+  vector<WritedNodeID> m_outgoingNodes;
+  vector<uint32_t> m_outgoingTargets;
+  // Names and points of the neighbouring mwms of the outgoing nodes, they are used before Link() only.
+  vector<string> m_outgoingMwms;
+  vector<m2::PointD> m_outgoingPoints;
+};
+
+}  // namespace routing
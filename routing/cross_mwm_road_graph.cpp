@@ -6,8 +6,6 @@
 namespace
 {
 inline bool IsValidEdgeWeight(EdgeWeight const & w) { return w != INVALID_EDGE_WEIGHT; }
-
-double constexpr kMwmCrossingNodeEqualityRadiusMeters = 5.0;
 }
 
 namespace routing
@@ -17,8 +15,8 @@ IRouter::ResultCode CrossMwmGraph::SetStartNode(CrossNode const & startNode)
   ASSERT(!startNode.mwmName.empty(), ());
   // TODO (ldragunov) make cancellation if necessary
   TRoutingMappingPtr startMapping = m_indexManager.GetMappingByName(startNode.mwmName);
-  MappingGuard startMappingGuard(startMapping);
-  UNUSED_VALUE(startMappingGuard);
+  FacadeGuard startFacadeGuard(startMapping);
+  UNUSED_VALUE(startFacadeGuard);
   startMapping->LoadCrossContext();
 
   // Load source data.
@@ -45,7 +43,7 @@ IRouter::ResultCode CrossMwmGraph::SetStartNode(CrossNode const & startNode)
   {
     if (IsValidEdgeWeight(weights[i]))
     {
-      BorderCross nextNode = FindNextMwmNode(*(mwmOutsIter.first + i), startMapping);
+      BorderCross nextNode = FindNextMwmNode(mwmOutsIter.first + i, startMapping);
       if (nextNode.toNode.IsValid())
         dummyEdges.emplace_back(nextNode, weights[i]);
     }
@@ -69,8 +67,8 @@ IRouter::ResultCode CrossMwmGraph::SetFinalNode(CrossNode const & finalNode)
 {
   ASSERT(finalNode.mwmName.length(), ());
   TRoutingMappingPtr finalMapping = m_indexManager.GetMappingByName(finalNode.mwmName);
-  MappingGuard finalMappingGuard(finalMapping);
-  UNUSED_VALUE(finalMappingGuard);
+  FacadeGuard finalFacadeGuard(finalMapping);
+  UNUSED_VALUE(finalFacadeGuard);
   finalMapping->LoadCrossContext();
 
   // Load source data.
@@ -111,10 +109,10 @@ IRouter::ResultCode CrossMwmGraph::SetFinalNode(CrossNode const & finalNode)
   return IRouter::NoError;
 }
 
-BorderCross CrossMwmGraph::FindNextMwmNode(OutgoingCrossNode const & startNode,
+BorderCross CrossMwmGraph::FindNextMwmNode(OutgoingEdgeIteratorT startNode,
                                            TRoutingMappingPtr const & currentMapping) const
 {
-  m2::PointD const & startPoint = startNode.m_point;
+  m2::PointD const & startPoint = startNode->m_point;
 
   // Check cached crosses.
   auto const it = m_cachedNextNodes.find(startPoint);
@@ -123,7 +121,22 @@ BorderCross CrossMwmGraph::FindNextMwmNode(OutgoingCrossNode const & startNode,
     return it->second;
   }
 
-  string const & nextMwm = currentMapping->m_crossContext.GetOutgoingMwmName(startNode);
+  if (m_overlay)
+  {
+    uint32_t const mwm = m_overlay->FindMwm(currentMapping->GetCountryName());
+    if (GetOverlayStatus(mwm) == OverlayStatus::UpToDate)
+    {
+      auto const outIters = currentMapping->m_crossContext.GetOutgoingIterators();
+      BorderCross cross;
+      if (MakeOverlayCross(mwm, m_overlay->GetOutgoing(mwm, distance(outIters.first, startNode)),
+                           cross))
+      {
+        return cross;
+      }
+    }
+  }
+
+  string const & nextMwm = currentMapping->m_crossContext.GetOutgoingMwmName(*startNode);
   TRoutingMappingPtr nextMapping;
   nextMapping = m_indexManager.GetMappingByName(nextMwm);
   // If we haven't this routing file, we skip this path.
@@ -136,10 +149,10 @@ BorderCross CrossMwmGraph::FindNextMwmNode(OutgoingCrossNode const & startNode,
   {
     m2::PointD const & targetPoint = i->m_point;
     if (ms::DistanceOnEarth(startPoint.y, startPoint.x, targetPoint.y, targetPoint.x) <
-        kMwmCrossingNodeEqualityRadiusMeters)
+        kCrossNodesEqualityRadiusMeters)
     {
       BorderCross const cross(
-          CrossNode(startNode.m_nodeId, currentMapping->GetCountryName(),
+          CrossNode(startNode->m_nodeId, currentMapping->GetCountryName(),
                     MercatorBounds::FromLatLon(targetPoint.y, targetPoint.x)),
           CrossNode(i->m_nodeId, nextMwm,
                     MercatorBounds::FromLatLon(targetPoint.y, targetPoint.x)));
@@ -186,13 +199,98 @@ void CrossMwmGraph::GetOutgoingEdgesList(BorderCross const & v,
     EdgeWeight const outWeight = currentContext.GetAdjacencyCost(inIt, outIt);
     if (outWeight != INVALID_CONTEXT_EDGE_WEIGHT && outWeight != 0)
     {
-      BorderCross target = FindNextMwmNode(*outIt, currentMapping);
+      BorderCross target = FindNextMwmNode(outIt, currentMapping);
       if (target.toNode.IsValid())
         adj.emplace_back(target, outWeight);
     }
   }
 }
 
+CrossMwmGraph::OverlayStatus CrossMwmGraph::GetOverlayStatus(uint32_t mwm) const
+{
+  ASSERT(m_overlay, ());
+  if (mwm == CrossMwmOverlay::kInvalidIndex)
+    return OverlayStatus::Outdated;
+
+  if (m_overlayStatuses.empty())
+    m_overlayStatuses.resize(m_overlay->GetMwmsCount(), OverlayStatus::Unknown);
+
+  OverlayStatus & status = m_overlayStatuses[mwm];
+  if (status == OverlayStatus::Unknown)
+  {
+    TRoutingMappingPtr mapping = m_indexManager.GetMappingByName(m_overlay->GetMwmName(mwm));
+    if (!mapping->IsValid())
+      status = OverlayStatus::Absent;
+    else if (mapping->GetTimestamp() != m_overlay->GetTimestamp(mwm))
+      status = OverlayStatus::Outdated;
+    else
+      status = OverlayStatus::UpToDate;
+  }
+  return status;
+}
+
+bool CrossMwmGraph::MakeOverlayCross(uint32_t mwm, uint32_t outgoing, BorderCross & cross) const
+{
+  // Outgoing nodes which are not linked lead to mwms without routing data.
+  uint32_t const target = m_overlay->GetOutgoingTarget(outgoing);
+  if (target == CrossMwmOverlay::kInvalidIndex)
+  {
+    cross = BorderCross();
+    return true;
+  }
+
+  uint32_t const nextMwm = m_overlay->GetVertexMwm(target);
+  switch (GetOverlayStatus(nextMwm))
+  {
+    case OverlayStatus::Absent:
+      cross = BorderCross();
+      return true;
+    case OverlayStatus::UpToDate:
+      break;
+    default:
+      return false;
+  }
+
+  m2::PointD const & point = m_overlay->GetVertexPoint(target);
+  m2::PointD const crossPoint = MercatorBounds::FromLatLon(point.y, point.x);
+  cross = BorderCross(
+      CrossNode(m_overlay->GetOutgoingNode(outgoing), m_overlay->GetMwmName(mwm), crossPoint),
+      CrossNode(m_overlay->GetVertexNode(target), m_overlay->GetMwmName(nextMwm), crossPoint));
+  return true;
+}
+
+bool CrossMwmGraph::GetOverlayEdgesList(BorderCross const & v,
+                                        vector<CrossWeightedEdge> & adj) const
+{
+  if (!m_overlay)
+    return false;
+
+  uint32_t const mwm = m_overlay->FindMwm(v.toNode.mwmName);
+  if (GetOverlayStatus(mwm) != OverlayStatus::UpToDate)
+    return false;
+
+  uint32_t const vertex = m_overlay->FindVertex(mwm, v.toNode.node);
+  if (vertex == CrossMwmOverlay::kInvalidIndex)
+    return false;
+
+  bool upToDate = true;
+  m_overlay->ForEachEdge(vertex, [&](uint32_t outgoing, WritedEdgeWeightT weight)
+  {
+    BorderCross target;
+    if (!upToDate || !MakeOverlayCross(mwm, outgoing, target))
+    {
+      upToDate = false;
+      return;
+    }
+    if (target.toNode.IsValid())
+      adj.emplace_back(target, weight);
+  });
+
+  if (!upToDate)
+    adj.clear();
+  return upToDate;
+}
+
 double CrossMwmGraph::HeuristicCostEstimate(BorderCross const & v, BorderCross const & w) const
 {
   // Simple travel time heuristic works worse than simple Dijkstra's algorithm, represented by
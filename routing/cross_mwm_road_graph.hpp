@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cross_mwm_overlay.hpp"
 #include "osrm_engine.hpp"
 #include "osrm_router.hpp"
 #include "router.hpp"
@@ -9,7 +10,9 @@
 #include "geometry/point2d.hpp"
 
 #include "base/macros.hpp"
+#include "base/math.hpp"
 
+#include "std/functional.hpp"
 #include "std/unordered_map.hpp"
 
 namespace routing
@@ -102,7 +105,13 @@ public:
   using TVertexType = BorderCross;
   using TEdgeType = CrossWeightedEdge;
 
-  explicit CrossMwmGraph(RoutingIndexManager & indexManager) : m_indexManager(indexManager) {}
+  /// When the overlay is given it's used for the mwms it's up to date with,
+  /// the overlay must outlive the graph.
+  explicit CrossMwmGraph(RoutingIndexManager & indexManager,
+                         CrossMwmOverlay const * overlay = nullptr)
+    : m_indexManager(indexManager), m_overlay(overlay)
+  {
+  }
 
   void GetOutgoingEdgesList(BorderCross const & v, vector<CrossWeightedEdge> & adj) const;
   void GetIngoingEdgesList(BorderCross const & /* v */,
@@ -117,8 +126,29 @@ public:
   IRouter::ResultCode SetFinalNode(CrossNode const & finalNode);
 
 private:
-  BorderCross FindNextMwmNode(OutgoingCrossNode const & startNode,
+  enum class OverlayStatus : uint8_t
+  {
+    Unknown,
+    Absent,    /// Routing data of the mwm are absent.
+    Outdated,  /// The overlay was built for another version of the mwm.
+    UpToDate
+  };
+
+  BorderCross FindNextMwmNode(OutgoingEdgeIteratorT startNode,
                               TRoutingMappingPtr const & currentMapping) const;
+
+  /// @return Status of the overlay for the overlay mwm. Mwms which are absent
+  ///         in the overlay (kInvalidIndex) are outdated.
+  OverlayStatus GetOverlayStatus(uint32_t mwm) const;
+
+  /// Makes the cross through the outgoing node of the overlay mwm. The cross is invalid
+  /// when there is no crossing.
+  /// @return False when the next mwm is outdated and the cross must be found by cross contexts.
+  bool MakeOverlayCross(uint32_t mwm, uint32_t outgoing, BorderCross & cross) const;
+
+  /// Fills adjacency list of the vertex by the overlay.
+  /// @return False when the overlay can't be used for the vertex.
+  bool GetOverlayEdgesList(BorderCross const & v, vector<CrossWeightedEdge> & adj) const;
   /*!
    * Adds a virtual edge to the graph so that it is possible to represent
    * the final segment of the path that leads from the map's border
@@ -129,8 +159,11 @@ private:
                       EdgeWeight weight);
 
   map<CrossNode, vector<CrossWeightedEdge> > m_virtualEdges;
-  mutable RoutingIndexManager m_indexManager;
+  RoutingIndexManager & m_indexManager;
   mutable unordered_map<m2::PointD, BorderCross, m2::PointD::Hash> m_cachedNextNodes;
+
+  CrossMwmOverlay const * m_overlay;
+  mutable vector<OverlayStatus> m_overlayStatuses;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -147,3 +180,17 @@ void ConvertToSingleRouterTasks(vector<BorderCross> const & graphCrosses,
                                 FeatureGraphNode const & finalGraphNode, TCheckedPath & route);
 
 }  // namespace routing
+
+namespace std
+{
+// Consistent with BorderCross::operator==, which compares toNode only.
+template <>
+struct hash<routing::BorderCross>
+{
+  size_t operator()(routing::BorderCross const & cross) const
+  {
+    routing::CrossNode const & node = cross.toNode;
+    return my::Hash(my::Hash(node.node, node.isVirtual), hash<string>()(node.mwmName));
+  }
+};
+}  // namespace std
@@ -43,9 +43,10 @@ IRouter::ResultCode CalculateRoute(BorderCross const & startPos, BorderCross con
 IRouter::ResultCode CalculateCrossMwmPath(TRoutingNodes const & startGraphNodes,
                                           TRoutingNodes const & finalGraphNodes,
                                           RoutingIndexManager & indexManager,
-                                          RouterDelegate const & delegate, TCheckedPath & route)
+                                          RouterDelegate const & delegate, TCheckedPath & route,
+                                          CrossMwmOverlay const * overlay)
 {
-  CrossMwmGraph roadGraph(indexManager);
+  CrossMwmGraph roadGraph(indexManager, overlay);
   FeatureGraphNode startGraphNode, finalGraphNode;
   CrossNode startNode, finalNode;
 
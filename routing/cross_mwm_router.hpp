@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cross_mwm_overlay.hpp"
 #include "osrm_engine.hpp"
 #include "router.hpp"
 #include "routing_mapping.hpp"
@@ -33,10 +34,12 @@ using TCheckedPath = vector<RoutePathCross>;
  * \param route Storage for the result records about crossing maps.
  * \param indexManager Manager for getting indexes of new countries.
  * \param RoutingVisualizerFn Debug visualization function.
+ * \param overlay Precomputed cross mwm graph, may be nullptr.
  * \return NoError if the path exists, error code otherwise.
  */
 IRouter::ResultCode CalculateCrossMwmPath(TRoutingNodes const & startGraphNodes,
                                           TRoutingNodes const & finalGraphNodes,
                                           RoutingIndexManager & indexManager,
-                                          RouterDelegate const & delegate, TCheckedPath & route);
+                                          RouterDelegate const & delegate, TCheckedPath & route,
+                                          CrossMwmOverlay const * overlay = nullptr);
 }  // namespace routing
@@ -14,6 +14,10 @@ using WritedEdgeWeightT = uint32_t;
 static WritedEdgeWeightT const INVALID_CONTEXT_EDGE_WEIGHT = std::numeric_limits<WritedEdgeWeightT>::max();
 static WritedEdgeWeightT const INVALID_CONTEXT_EDGE_NODE_ID = std::numeric_limits<uint32_t>::max();
 
+/// An outgoing node and an ingoing node of the neighbouring mwm which are closer
+/// than the radius represent the same border crossing.
+double constexpr kCrossNodesEqualityRadiusMeters = 5.0;
+
 struct IngoingCrossNode
 {
   m2::PointD m_point;
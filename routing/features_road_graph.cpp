@@ -10,6 +10,10 @@
 
 #include "geometry/distance_on_sphere.hpp"
 
+#include "coding/reader.hpp"
+
+#include "defines.hpp"
+
 #include "base/logging.hpp"
 #include "base/macros.hpp"
 
@@ -18,8 +22,6 @@ namespace routing
 
 namespace
 {
-uint32_t constexpr kPowOfTwoForFeatureCacheSize = 10; // cache contains 2 ^ kPowOfTwoForFeatureCacheSize elements
-
 double constexpr kMwmRoadCrossingRadiusMeters = 2.0;
 
 double constexpr kMwmCrossingNodeEqualityRadiusMeters = 100.0;
@@ -39,8 +41,8 @@ string GetFeatureCountryName(FeatureID const featureId)
 
 inline bool PointsAlmostEqualAbs(const m2::PointD & pt1, const m2::PointD & pt2)
 {
-  double constexpr kEpsilon = 1e-6;
-  return my::AlmostEqualAbs(pt1.x, pt2.x, kEpsilon) && my::AlmostEqualAbs(pt1.y, pt2.y, kEpsilon);
+  return my::AlmostEqualAbs(pt1.x, pt2.x, kPointsEqualEpsilon) &&
+         my::AlmostEqualAbs(pt1.y, pt2.y, kPointsEqualEpsilon);
 }
 }  // namespace
 
@@ -88,22 +90,10 @@ void FeaturesRoadGraph::CrossCountryVehicleModel::Clear()
 }
 
 
-IRoadGraph::RoadInfo & FeaturesRoadGraph::RoadInfoCache::Find(FeatureID const & featureId, bool & found)
-{
-  auto res = m_cache.insert(make_pair(featureId.m_mwmId, TMwmFeatureCache()));
-  if (res.second)
-    res.first->second.Init(kPowOfTwoForFeatureCacheSize);
-  return res.first->second.Find(featureId.m_index, found);
-}
-
-void FeaturesRoadGraph::RoadInfoCache::Clear()
-{
-  m_cache.clear();
-}
-
-
-FeaturesRoadGraph::FeaturesRoadGraph(Index & index, unique_ptr<IVehicleModelFactory> && vehicleModelFactory)
+FeaturesRoadGraph::FeaturesRoadGraph(Index & index, unique_ptr<IVehicleModelFactory> && vehicleModelFactory,
+                                     shared_ptr<RoadInfoCache> const & cache)
     : m_index(index),
+      m_cache(cache ? cache : make_shared<RoadInfoCache>()),
       m_vehicleModel(move(vehicleModelFactory))
 {
 }
@@ -129,9 +119,9 @@ public:
 
     FeatureID const featureId = ft.GetID();
 
-    IRoadGraph::RoadInfo const & roadInfo = m_graph.GetCachedRoadInfo(featureId, ft, speedKMPH);
+    FeaturesRoadGraph::TRoadInfoPtr const roadInfo = m_graph.GetCachedRoadInfo(featureId, ft, speedKMPH);
 
-    m_edgesLoader(featureId, roadInfo);
+    m_edgesLoader(featureId, *roadInfo);
   }
 
 private:
@@ -141,14 +131,14 @@ private:
 
 IRoadGraph::RoadInfo FeaturesRoadGraph::GetRoadInfo(FeatureID const & featureId) const
 {
-  RoadInfo const & ri = GetCachedRoadInfo(featureId);
-  ASSERT_GREATER(ri.m_speedKMPH, 0.0, ());
-  return ri;
+  TRoadInfoPtr const ri = GetCachedRoadInfo(featureId);
+  ASSERT_GREATER(ri->m_speedKMPH, 0.0, ());
+  return *ri;
 }
 
 double FeaturesRoadGraph::GetSpeedKMPH(FeatureID const & featureId) const
 {
-  double const speedKMPH = GetCachedRoadInfo(featureId).m_speedKMPH;
+  double const speedKMPH = GetCachedRoadInfo(featureId)->m_speedKMPH;
   ASSERT_GREATER(speedKMPH, 0.0, ());
   return speedKMPH;
 }
@@ -166,6 +156,15 @@ void FeaturesRoadGraph::ForEachFeatureClosestToCross(m2::PointD const & cross,
   m_index.ForEachInRect(featuresLoader, rect, GetStreetReadScale());
 }
 
+void FeaturesRoadGraph::ForEachFeatureClosestToCross(m2::PointD const & cross,
+                                                     MwmSet::MwmId const & mwmId,
+                                                     CrossEdgesLoader & edgesLoader) const
+{
+  CrossFeaturesLoader featuresLoader(*this, edgesLoader);
+  m2::RectD const rect = MercatorBounds::RectByCenterXYAndSizeInMeters(cross, kMwmRoadCrossingRadiusMeters);
+  m_index.ForEachInRectForMWM(featuresLoader, rect, GetStreetReadScale(), mwmId);
+}
+
 void FeaturesRoadGraph::FindClosestEdges(m2::PointD const & point, uint32_t count,
                                          vector<pair<Edge, m2::PointD>> & vicinities) const
 {
@@ -182,9 +181,9 @@ void FeaturesRoadGraph::FindClosestEdges(m2::PointD const & point, uint32_t coun
 
     FeatureID const featureId = ft.GetID();
 
-    IRoadGraph::RoadInfo const & roadInfo = GetCachedRoadInfo(featureId, ft, speedKMPH);
+    TRoadInfoPtr const roadInfo = GetCachedRoadInfo(featureId, ft, speedKMPH);
 
-    finder.AddInformationSource(featureId, roadInfo);
+    finder.AddInformationSource(featureId, *roadInfo);
   };
 
   m_index.ForEachInRect(
@@ -230,9 +229,47 @@ void FeaturesRoadGraph::GetJunctionTypes(Junction const & junction, feature::Typ
   m_index.ForEachInRect(f, rect, GetStreetReadScale());
 }
 
+LandmarksTable const * FeaturesRoadGraph::GetLandmarks(FeatureID const & featureId) const
+{
+  auto it = m_landmarks.find(featureId.m_mwmId);
+  if (it != m_landmarks.end())
+    return it->second.get();
+
+  // Drops tables of deregistered mwms.
+  for (auto i = m_landmarks.begin(); i != m_landmarks.end();)
+  {
+    if (i->first.IsAlive())
+      ++i;
+    else
+      i = m_landmarks.erase(i);
+  }
+
+  unique_ptr<LandmarksTable> table;
+  MwmSet::MwmHandle const handle = m_index.GetMwmHandleById(featureId.m_mwmId);
+  MwmValue const * value = handle.GetValue<MwmValue>();
+  if (value && value->m_cont.IsExist(PEDESTRIAN_LANDMARKS_FILE_TAG))
+  {
+    table.reset(new LandmarksTable());
+    try
+    {
+      ReaderSource<FilesContainerR::ReaderT> src(value->m_cont.GetReader(PEDESTRIAN_LANDMARKS_FILE_TAG));
+      table->Deserialize(src);
+      LOG(LINFO, ("Loaded landmarks for", featureId.m_mwmId, "vertices:", table->GetVerticesCount(),
+                  "landmarks:", table->GetLandmarksCount()));
+    }
+    catch (Reader::Exception const & e)
+    {
+      LOG(LERROR, ("Can't load landmarks for", featureId.m_mwmId, e.Msg()));
+      table.reset();
+    }
+  }
+
+  return m_landmarks.emplace(featureId.m_mwmId, move(table)).first->second.get();
+}
+
 void FeaturesRoadGraph::ClearState()
 {
-  m_cache.Clear();
+  LOG(LDEBUG, ("Road info cache:", m_cache->GetStats()));
   m_vehicleModel.Clear();
   m_mwmLocks.clear();
 }
@@ -247,13 +284,11 @@ double FeaturesRoadGraph::GetSpeedKMPHFromFt(FeatureType const & ft) const
   return m_vehicleModel.GetSpeed(ft);
 }
 
-IRoadGraph::RoadInfo const & FeaturesRoadGraph::GetCachedRoadInfo(FeatureID const & featureId) const
+FeaturesRoadGraph::TRoadInfoPtr FeaturesRoadGraph::GetCachedRoadInfo(FeatureID const & featureId) const
 {
-  bool found = false;
-  RoadInfo & ri = m_cache.Find(featureId, found);
-
-  if (found)
-    return ri;
+  TRoadInfoPtr cached = m_cache->Find(featureId);
+  if (cached)
+    return cached;
 
   FeatureType ft;
   Index::FeaturesLoaderGuard loader(m_index, featureId.m_mwmId);
@@ -262,33 +297,35 @@ IRoadGraph::RoadInfo const & FeaturesRoadGraph::GetCachedRoadInfo(FeatureID cons
 
   ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
 
-  ri.m_bidirectional = !IsOneWay(ft);
-  ri.m_speedKMPH = GetSpeedKMPHFromFt(ft);
-  ft.SwapPoints(ri.m_points);
+  auto ri = make_shared<RoadInfo>();
+  ri->m_bidirectional = !IsOneWay(ft);
+  ri->m_speedKMPH = GetSpeedKMPHFromFt(ft);
+  ft.SwapPoints(ri->m_points);
+  m_cache->Insert(featureId, ri);
 
   LockFeatureMwm(featureId);
 
   return ri;
 }
 
-IRoadGraph::RoadInfo const & FeaturesRoadGraph::GetCachedRoadInfo(FeatureID const & featureId,
-                                                                  FeatureType & ft,
-                                                                  double speedKMPH) const
+FeaturesRoadGraph::TRoadInfoPtr FeaturesRoadGraph::GetCachedRoadInfo(FeatureID const & featureId,
+                                                                     FeatureType & ft,
+                                                                     double speedKMPH) const
 {
-  bool found = false;
-  RoadInfo & ri = m_cache.Find(featureId, found);
-
-  if (found)
-    return ri;
+  TRoadInfoPtr cached = m_cache->Find(featureId);
+  if (cached)
+    return cached;
 
   // ft must be set
   ASSERT_EQUAL(featureId, ft.GetID(), ());
 
   ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
 
-  ri.m_bidirectional = !IsOneWay(ft);
-  ri.m_speedKMPH = speedKMPH;
-  ft.SwapPoints(ri.m_points);
+  auto ri = make_shared<RoadInfo>();
+  ri->m_bidirectional = !IsOneWay(ft);
+  ri->m_speedKMPH = speedKMPH;
+  ft.SwapPoints(ri->m_points);
+  m_cache->Insert(featureId, ri);
 
   LockFeatureMwm(featureId);
 
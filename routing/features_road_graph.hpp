@@ -1,5 +1,7 @@
 #pragma once
+#include "routing/landmarks.hpp"
 #include "routing/road_graph.hpp"
+#include "routing/road_info_cache.hpp"
 #include "routing/vehicle_model.hpp"
 
 #include "indexer/feature_data.hpp"
@@ -7,9 +9,8 @@
 
 #include "geometry/point2d.hpp"
 
-#include "base/cache.hpp"
-
 #include "std/map.hpp"
+#include "std/shared_ptr.hpp"
 #include "std/unique_ptr.hpp"
 #include "std/vector.hpp"
 
@@ -43,20 +44,13 @@ private:
     mutable map<MwmSet::MwmId, shared_ptr<IVehicleModel>> m_cache;
   };
 
-  class RoadInfoCache
-  {
-  public:
-    RoadInfo & Find(FeatureID const & featureId, bool & found);
-
-    void Clear();
-
-  private:
-    using TMwmFeatureCache = my::Cache<uint32_t, RoadInfo>;
-    map<MwmSet::MwmId, TMwmFeatureCache> m_cache;
-  };
-
 public:
-  FeaturesRoadGraph(Index & index, unique_ptr<IVehicleModelFactory> && vehicleModelFactory);
+  using TRoadInfoPtr = RoadInfoCache::TRoadInfoPtr;
+
+  /// @param cache Cache of decoded roads, which may be shared by graphs with the same vehicle model.
+  ///              A private cache is created when it's nullptr.
+  FeaturesRoadGraph(Index & index, unique_ptr<IVehicleModelFactory> && vehicleModelFactory,
+                    shared_ptr<RoadInfoCache> const & cache = nullptr);
 
   static uint32_t GetStreetReadScale();
 
@@ -70,8 +64,16 @@ public:
                         vector<pair<Edge, m2::PointD>> & vicinities) const override;
   void GetFeatureTypes(FeatureID const & featureId, feature::TypesHolder & types) const override;
   void GetJunctionTypes(Junction const & junction, feature::TypesHolder & types) const override;
+  LandmarksTable const * GetLandmarks(FeatureID const & featureId) const override;
   void ClearState() override;
 
+protected:
+  /// Calls edgesLoader on each feature of the mwm which is close to cross.
+  void ForEachFeatureClosestToCross(m2::PointD const & cross, MwmSet::MwmId const & mwmId,
+                                    CrossEdgesLoader & edgesLoader) const;
+
+  inline Index & GetIndex() const { return m_index; }
+
 private:
   friend class CrossFeaturesLoader;
 
@@ -80,19 +82,23 @@ private:
 
   // Searches a feature RoadInfo in the cache, and if does not find then
   // loads feature from the index and takes speed for the feature from the vehicle model.
-  RoadInfo const & GetCachedRoadInfo(FeatureID const & featureId) const;
+  TRoadInfoPtr GetCachedRoadInfo(FeatureID const & featureId) const;
   // Searches a feature RoadInfo in the cache, and if does not find then takes passed feature and speed.
   // This version is used to prevent redundant feature loading when feature speed is known.
-  RoadInfo const & GetCachedRoadInfo(FeatureID const & featureId,
-                                     FeatureType & ft,
-                                     double speedKMPH) const;
+  TRoadInfoPtr GetCachedRoadInfo(FeatureID const & featureId, FeatureType & ft,
+                                 double speedKMPH) const;
 
   void LockFeatureMwm(FeatureID const & featureId) const;
 
   Index & m_index;
-  mutable RoadInfoCache m_cache;
+  // Road infos are not cleared by ClearState(), they're bounded by the cache limit.
+  shared_ptr<RoadInfoCache> const m_cache;
   mutable CrossCountryVehicleModel m_vehicleModel;
   mutable map<MwmSet::MwmId, MwmSet::MwmHandle> m_mwmLocks;
+
+  // Landmarks tables are not cleared by ClearState() because they are immutable
+  // and expensive to load. nullptr means an mwm has no landmarks section.
+  mutable map<MwmSet::MwmId, unique_ptr<LandmarksTable>> m_landmarks;
 };
 
 }  // namespace routing
@@ -0,0 +1,231 @@
+#include "routing/isochrone.hpp"
+
+#include "routing/router_delegate.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/functional.hpp"
+#include "std/queue.hpp"
+#include "std/unordered_set.hpp"
+#include "std/utility.hpp"
+
+namespace routing
+{
+namespace
+{
+double constexpr KMPH2MPS = 1000.0 / (60 * 60);
+
+// Cancellation is checked once per this number of the settled junctions.
+uint32_t constexpr kCancelCheckPeriod = 1024;
+
+inline uint64_t CellToKey(int64_t x, int64_t y)
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+/// Side of a cell on the outline, it goes from (m_x, m_y) in m_direction: 0 is +x, 1 is +y,
+/// 2 is -x and 3 is -y, so the turn to the left is the next direction.
+struct OutlineSide
+{
+  int32_t m_x;
+  int32_t m_y;
+  int32_t m_direction;
+};
+
+int32_t constexpr kDx[] = {1, 0, -1, 0};
+int32_t constexpr kDy[] = {0, 1, 0, -1};
+}  // namespace
+
+// static
+size_t constexpr IsochroneFinder::kMaxCachedJunctions;
+
+IRoutingAlgorithm::Result IsochroneFinder::FindReachable(IRoadGraph const & graph,
+                                                         Junction const & origin,
+                                                         double maxSeconds,
+                                                         RouterDelegate const & delegate,
+                                                         vector<ReachableEdge> & edges)
+{
+  edges.clear();
+  if (m_outgoing.size() > kMaxCachedJunctions)
+    m_outgoing.clear();
+
+  using TQueueItem = pair<double, Junction>;
+  priority_queue<TQueueItem, vector<TQueueItem>, greater<TQueueItem>> queue;
+  unordered_map<Junction, double> bestSeconds;
+  bestSeconds[origin] = 0.0;
+  queue.emplace(0.0, origin);
+
+  vector<WeightedEdge> buffer;
+  uint32_t settledCount = 0;
+  while (!queue.empty())
+  {
+    if (++settledCount % kCancelCheckPeriod == 0 && delegate.IsCancelled())
+      return IRoutingAlgorithm::Result::Cancelled;
+
+    TQueueItem const item = queue.top();
+    queue.pop();
+    if (item.first > bestSeconds[item.second])
+      continue;
+
+    for (WeightedEdge const & e : GetOutgoingEdges(graph, item.second, buffer))
+    {
+      double const seconds = item.first + e.m_seconds;
+      edges.push_back({e.m_edge, item.first, seconds});
+      if (seconds > maxSeconds)
+        continue;
+
+      Junction const & target = e.m_edge.GetEndJunction();
+      auto const it = bestSeconds.emplace(target, seconds);
+      if (!it.second)
+      {
+        if (it.first->second <= seconds)
+          continue;
+        it.first->second = seconds;
+      }
+      queue.emplace(seconds, target);
+    }
+  }
+
+  return edges.empty() ? IRoutingAlgorithm::Result::NoPath : IRoutingAlgorithm::Result::OK;
+}
+
+vector<IsochroneFinder::WeightedEdge> const & IsochroneFinder::GetOutgoingEdges(
+    IRoadGraph const & graph, Junction const & junction, vector<WeightedEdge> & buffer)
+{
+  auto const it = m_outgoing.find(junction);
+  if (it != m_outgoing.end())
+    return it->second;
+
+  IRoadGraph::TEdgeVector edges;
+  graph.GetOutgoingEdges(junction, edges);
+
+  buffer.clear();
+  buffer.reserve(edges.size());
+  DistanceOnEarthFrom const distanceFrom(junction.GetPoint());
+  bool hasFakes = false;
+  for (Edge const & e : edges)
+  {
+    hasFakes = hasFakes || e.IsFake();
+    double const speedMPS = graph.GetSpeedKMPH(e) * KMPH2MPS;
+    buffer.push_back({e, distanceFrom(e.GetEndJunction().GetPoint()) / speedMPS});
+  }
+
+  // Fake edges are made for the current origin only.
+  if (hasFakes)
+    return buffer;
+  return m_outgoing.emplace(junction, move(buffer)).first->second;
+}
+
+void BuildIsochronePolygons(vector<ReachableEdge> const & edges, double maxSeconds,
+                            double cellMeters, vector<vector<m2::PointD>> & polygons)
+{
+  polygons.clear();
+  if (edges.empty())
+    return;
+
+  ASSERT_GREATER(cellMeters, 0.0, ());
+  m2::PointD const origin = edges.front().m_edge.GetStartJunction().GetPoint();
+  m2::RectD const cellRect =
+      MercatorBounds::RectByCenterXYAndSizeInMeters(origin, 0.5 * cellMeters);
+  double const cellX = cellRect.SizeX();
+  double const cellY = cellRect.SizeY();
+  double const step = 0.5 * min(cellX, cellY);
+
+  // Cells are marked by the points of the reached parts of the edges, which are taken
+  // more often than the cells, so the lines don't skip the cells.
+  unordered_set<uint64_t> cells;
+  auto const markCell = [&](m2::PointD const & pt)
+  {
+    cells.insert(CellToKey(static_cast<int64_t>(floor((pt.x - origin.x) / cellX)),
+                           static_cast<int64_t>(floor((pt.y - origin.y) / cellY))));
+  };
+  for (ReachableEdge const & re : edges)
+  {
+    if (re.m_startSeconds > maxSeconds)
+      continue;
+    m2::PointD const & start = re.m_edge.GetStartJunction().GetPoint();
+    m2::PointD const & end = re.m_edge.GetEndJunction().GetPoint();
+    double const duration = re.m_endSeconds - re.m_startSeconds;
+    double const fraction =
+        duration <= maxSeconds - re.m_startSeconds ? 1.0 : (maxSeconds - re.m_startSeconds) / duration;
+    m2::PointD const last = start + (end - start) * fraction;
+    size_t const count = static_cast<size_t>(ceil(start.Length(last) / step));
+    for (size_t i = 0; i <= count; ++i)
+      markCell(count == 0 ? start : start + (last - start) * (static_cast<double>(i) / count));
+  }
+
+  auto const isMarked = [&cells](int32_t x, int32_t y)
+  {
+    return cells.find(CellToKey(x, y)) != cells.end();
+  };
+
+  // Sides of the marked cells which have no marked neighbours.
+  vector<OutlineSide> sides;
+  unordered_map<uint64_t, vector<size_t>> sidesByStart;
+  auto const addSide = [&](int32_t x, int32_t y, int32_t direction)
+  {
+    sidesByStart[CellToKey(x, y)].push_back(sides.size());
+    sides.push_back({x, y, direction});
+  };
+  for (uint64_t const key : cells)
+  {
+    int32_t const x = static_cast<int32_t>(key >> 32);
+    int32_t const y = static_cast<int32_t>(key & 0xFFFFFFFF);
+    if (!isMarked(x, y - 1))
+      addSide(x, y, 0);
+    if (!isMarked(x + 1, y))
+      addSide(x + 1, y, 1);
+    if (!isMarked(x, y + 1))
+      addSide(x + 1, y + 1, 2);
+    if (!isMarked(x - 1, y))
+      addSide(x, y + 1, 3);
+  }
+
+  // Two outlines touch at a vertex only by the corners of the diagonal cells, the left turn
+  // there keeps them apart. So every side has a single next one and the outlines are cycles.
+  auto const getNext = [&](OutlineSide const & side)
+  {
+    int32_t const x = side.m_x + kDx[side.m_direction];
+    int32_t const y = side.m_y + kDy[side.m_direction];
+    vector<size_t> const & candidates = sidesByStart[CellToKey(x, y)];
+    ASSERT(!candidates.empty(), ());
+    for (int32_t turn : {1, 0, 3})
+    {
+      int32_t const direction = (side.m_direction + turn) % 4;
+      for (size_t const candidate : candidates)
+      {
+        if (sides[candidate].m_direction == direction)
+          return candidate;
+      }
+    }
+    ASSERT(false, ("Outline is broken at", x, y));
+    return candidates.front();
+  };
+
+  vector<bool> used(sides.size(), false);
+  for (size_t first = 0; first < sides.size(); ++first)
+  {
+    if (used[first])
+      continue;
+
+    vector<m2::PointD> polygon;
+    size_t current = first;
+    do
+    {
+      used[current] = true;
+      size_t const next = getNext(sides[current]);
+      OutlineSide const & side = sides[next];
+      // Only the corners of the outline are kept.
+      if (side.m_direction != sides[current].m_direction)
+        polygon.emplace_back(origin.x + side.m_x * cellX, origin.y + side.m_y * cellY);
+      current = next;
+    } while (current != first);
+    polygons.push_back(move(polygon));
+  }
+}
+}  // namespace routing
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "routing/road_graph.hpp"
+#include "routing/routing_algorithm.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/unordered_map.hpp"
+#include "std/vector.hpp"
+
+namespace routing
+{
+class RouterDelegate;
+
+/// Edge of a road graph which is reached from the origin of an isochrone.
+struct ReachableEdge
+{
+  Edge m_edge;
+  /// Arrival times at the start and the end junctions of the edge in seconds.
+  /// The edge is reached partially when m_endSeconds exceeds the time limit.
+  double m_startSeconds;
+  double m_endSeconds;
+};
+
+/// IsochroneFinder finds the edges of a road graph which are reached from an origin within
+/// a time limit, by a bounded one-to-all Dijkstra search with the weights of the A* routers.
+///
+/// Outgoing edges of the regular junctions are kept between the searches, so the search from
+/// a nearby origin, e.g. when the user moves, mostly doesn't load the roads again.
+/// The cache must be cleared when the graph or its traffic are changed.
+class IsochroneFinder
+{
+public:
+  /// Max number of the junctions which outgoing edges are kept between the searches.
+  static size_t constexpr kMaxCachedJunctions = 200000;
+
+  /// Finds all the edges which start at the junctions reached within maxSeconds.
+  /// @return NoPath when the origin has no outgoing edges.
+  IRoutingAlgorithm::Result FindReachable(IRoadGraph const & graph, Junction const & origin,
+                                          double maxSeconds, RouterDelegate const & delegate,
+                                          vector<ReachableEdge> & edges);
+
+  void ClearCache() { m_outgoing.clear(); }
+
+  inline size_t GetCachedJunctionsCount() const { return m_outgoing.size(); }
+
+private:
+  struct WeightedEdge
+  {
+    Edge m_edge;
+    double m_seconds;
+  };
+
+  /// @return Outgoing edges of the junction with their times.
+  vector<WeightedEdge> const & GetOutgoingEdges(IRoadGraph const & graph,
+                                                Junction const & junction,
+                                                vector<WeightedEdge> & buffer);
+
+  unordered_map<Junction, vector<WeightedEdge>> m_outgoing;
+};
+
+/// Builds the outlines of the area which is covered by the reached parts of the edges.
+/// The edges are rasterized into the square cells of cellMeters, so their outlines are
+/// the polygons made of the cell sides, with the interior on the left: outer rings are
+/// counterclockwise and holes are clockwise. The cells touching by corners only are outlined
+/// apart.
+void BuildIsochronePolygons(vector<ReachableEdge> const & edges, double maxSeconds,
+                            double cellMeters, vector<vector<m2::PointD>> & polygons);
+}  // namespace routing
@@ -0,0 +1,429 @@
+#include "routing/landmarks.hpp"
+
+#include "indexer/mercator.hpp"
+#include "indexer/point_to_int64.hpp"
+
+#include "base/assert.hpp"
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/numeric.hpp"
+#include "std/queue.hpp"
+#include "std/unordered_map.hpp"
+#include "std/utility.hpp"
+
+namespace routing
+{
+namespace
+{
+// Max number of junctions visited to bind an absent junction to the table.
+size_t constexpr kMaxBoundsSearchVertices = 64;
+
+double constexpr kInfinityBound = numeric_limits<double>::infinity();
+
+using TAdjacency = vector<vector<pair<uint32_t, uint32_t>>>;
+
+uint64_t GetPointKey(m2::PointD const & point)
+{
+  m2::PointU const pu = PointD2PointU(point, POINT_COORD_BITS);
+  return (static_cast<uint64_t>(pu.x) << 32) | pu.y;
+}
+
+uint64_t GetCellKey(int64_t x, int64_t y)
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+int64_t GetCellCoord(double c) { return static_cast<int64_t>(floor(c / kPointsEqualEpsilon)); }
+
+class DisjointSets
+{
+public:
+  explicit DisjointSets(size_t size) : m_parent(size), m_size(size, 1)
+  {
+    iota(m_parent.begin(), m_parent.end(), 0);
+  }
+
+  uint32_t Find(uint32_t v)
+  {
+    while (m_parent[v] != v)
+    {
+      m_parent[v] = m_parent[m_parent[v]];
+      v = m_parent[v];
+    }
+    return v;
+  }
+
+  void Union(uint32_t u, uint32_t v)
+  {
+    u = Find(u);
+    v = Find(v);
+    if (u == v)
+      return;
+    if (m_size[u] < m_size[v])
+      swap(u, v);
+    m_parent[v] = u;
+    m_size[u] += m_size[v];
+  }
+
+  uint32_t GetSize(uint32_t v) { return m_size[Find(v)]; }
+
+private:
+  vector<uint32_t> m_parent;
+  vector<uint32_t> m_size;
+};
+
+void FindDistances(TAdjacency const & graph, uint32_t source, vector<uint32_t> & distances)
+{
+  using TState = pair<uint32_t, uint32_t>;
+
+  distances.assign(graph.size(), LandmarksTable::kInfinity);
+  priority_queue<TState, vector<TState>, greater<TState>> queue;
+
+  distances[source] = 0;
+  queue.emplace(0, source);
+  while (!queue.empty())
+  {
+    TState const state = queue.top();
+    queue.pop();
+
+    uint32_t const v = state.second;
+    if (state.first > distances[v])
+      continue;
+
+    for (auto const & edge : graph[v])
+    {
+      uint32_t const d = state.first + edge.second;
+      if (d < distances[edge.first])
+      {
+        distances[edge.first] = d;
+        queue.emplace(d, edge.first);
+      }
+    }
+  }
+}
+}  // namespace
+
+// LandmarksTable ----------------------------------------------------------------------------------
+
+// static
+uint32_t constexpr LandmarksTable::kInfinity;
+uint32_t constexpr LandmarksTable::kDefaultLandmarksCount;
+
+void LandmarksTable::Build(vector<TRoad> const & roads, uint32_t landmarksCount)
+{
+  m_keys.clear();
+  m_distances.clear();
+  m_landmarksCount = 0;
+
+  vector<pair<uint64_t, m2::PointD>> points;
+  for (auto const & road : roads)
+  {
+    for (auto const & point : road)
+      points.emplace_back(GetPointKey(point), point);
+  }
+  sort(points.begin(), points.end());
+  points.erase(unique(points.begin(), points.end(),
+                      [](pair<uint64_t, m2::PointD> const & lhs, pair<uint64_t, m2::PointD> const & rhs)
+                      {
+                        return lhs.first == rhs.first;
+                      }),
+               points.end());
+  if (points.empty() || landmarksCount == 0)
+    return;
+
+  size_t const numPoints = points.size();
+  m_keys.reserve(numPoints);
+  for (auto const & point : points)
+    m_keys.push_back(point.first);
+
+  // Merges points which are considered by IRoadGraph as the same junction.
+  DisjointSets junctions(numPoints);
+  unordered_map<uint64_t, vector<uint32_t>> cells;
+  for (uint32_t i = 0; i < numPoints; ++i)
+  {
+    m2::PointD const & p = points[i].second;
+    cells[GetCellKey(GetCellCoord(p.x), GetCellCoord(p.y))].push_back(i);
+  }
+  for (uint32_t i = 0; i < numPoints; ++i)
+  {
+    m2::PointD const & p = points[i].second;
+    int64_t const x = GetCellCoord(p.x);
+    int64_t const y = GetCellCoord(p.y);
+    for (int64_t dx = -1; dx <= 1; ++dx)
+    {
+      for (int64_t dy = -1; dy <= 1; ++dy)
+      {
+        auto const it = cells.find(GetCellKey(x + dx, y + dy));
+        if (it == cells.end())
+          continue;
+        for (uint32_t const j : it->second)
+        {
+          m2::PointD const & q = points[j].second;
+          if (j > i && my::AlmostEqualAbs(p.x, q.x, kPointsEqualEpsilon) &&
+              my::AlmostEqualAbs(p.y, q.y, kPointsEqualEpsilon))
+          {
+            junctions.Union(i, j);
+          }
+        }
+      }
+    }
+  }
+
+  // Numbers graph vertices.
+  vector<uint32_t> pointToVertex(numPoints);
+  uint32_t numVertices = 0;
+  {
+    unordered_map<uint32_t, uint32_t> rootToVertex;
+    for (uint32_t i = 0; i < numPoints; ++i)
+    {
+      auto const res = rootToVertex.emplace(junctions.Find(i), numVertices);
+      if (res.second)
+        ++numVertices;
+      pointToVertex[i] = res.first->second;
+    }
+  }
+
+  auto const getVertex = [&](m2::PointD const & point)
+  {
+    auto const it = lower_bound(m_keys.begin(), m_keys.end(), GetPointKey(point));
+    ASSERT(it != m_keys.end() && *it == GetPointKey(point), ());
+    return pointToVertex[distance(m_keys.begin(), it)];
+  };
+
+  TAdjacency graph(numVertices);
+  DisjointSets components(numVertices);
+  for (auto const & road : roads)
+  {
+    for (size_t i = 1; i < road.size(); ++i)
+    {
+      uint32_t const u = getVertex(road[i - 1]);
+      uint32_t const v = getVertex(road[i]);
+      if (u == v)
+        continue;
+      uint32_t const length = static_cast<uint32_t>(GetEdgeLength(road[i - 1], road[i]));
+      graph[u].emplace_back(v, length);
+      graph[v].emplace_back(u, length);
+      components.Union(u, v);
+    }
+  }
+
+  // Chooses landmarks in the largest connected component, each next landmark
+  // is the farthest vertex from the already chosen ones.
+  uint32_t start = 0;
+  for (uint32_t v = 1; v < numVertices; ++v)
+  {
+    if (components.GetSize(v) > components.GetSize(start))
+      start = v;
+  }
+
+  auto const findFarthest = [&](vector<uint32_t> const & distances)
+  {
+    uint32_t farthest = start;
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+      if (distances[v] != kInfinity && distances[v] > distances[farthest])
+        farthest = v;
+    }
+    return farthest;
+  };
+
+  vector<uint32_t> distances;
+  FindDistances(graph, start, distances);
+  uint32_t landmark = findFarthest(distances);
+
+  vector<vector<uint32_t>> landmarksDistances;
+  vector<uint32_t> minDistances(numVertices, kInfinity);
+  while (landmarksDistances.size() < landmarksCount)
+  {
+    FindDistances(graph, landmark, distances);
+    for (uint32_t v = 0; v < numVertices; ++v)
+      minDistances[v] = min(minDistances[v], distances[v]);
+    landmarksDistances.push_back(move(distances));
+
+    landmark = findFarthest(minDistances);
+    if (minDistances[landmark] == 0)
+      break;
+  }
+
+  m_landmarksCount = static_cast<uint32_t>(landmarksDistances.size());
+  m_distances.resize(numPoints * m_landmarksCount);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    for (size_t j = 0; j < m_landmarksCount; ++j)
+      m_distances[i * m_landmarksCount + j] = landmarksDistances[j][pointToVertex[i]];
+  }
+}
+
+// static
+double LandmarksTable::GetEdgeLength(m2::PointD const & p1, m2::PointD const & p2)
+{
+  return MercatorBounds::DistanceOnEarth(p1, p2) * 10.0;
+}
+
+uint32_t const * LandmarksTable::GetDistances(m2::PointD const & point) const
+{
+  uint64_t const key = GetPointKey(point);
+  auto const it = lower_bound(m_keys.begin(), m_keys.end(), key);
+  if (it == m_keys.end() || *it != key)
+    return nullptr;
+  return &m_distances[distance(m_keys.begin(), it) * m_landmarksCount];
+}
+
+void LandmarksTable::Swap(LandmarksTable & rhs)
+{
+  m_keys.swap(rhs.m_keys);
+  m_distances.swap(rhs.m_distances);
+  swap(m_landmarksCount, rhs.m_landmarksCount);
+}
+
+// LandmarksEstimator ------------------------------------------------------------------------------
+
+LandmarksEstimator::LandmarksEstimator(IRoadGraph const & graph, LandmarksTable const & table,
+                                       Junction const & startPos, Junction const & finalPos)
+  : m_graph(graph), m_table(table), m_startPos(startPos), m_finalPos(finalPos)
+{
+}
+
+bool LandmarksEstimator::IsKnown(Junction const & junction) const
+{
+  return GetBounds(junction).m_known;
+}
+
+double LandmarksEstimator::GetLowerBoundMeters(Junction const & from, Junction const & to) const
+{
+  Bounds const & fromBounds = GetBounds(from);
+  Bounds const & toBounds = GetBounds(to);
+  if (!fromBounds.m_known || !toBounds.m_known)
+    return 0.0;
+
+  double bound = 0.0;
+  for (size_t i = 0; i < m_table.GetLandmarksCount(); ++i)
+  {
+    if (fromBounds.m_upper[i] == kInfinityBound || toBounds.m_upper[i] == kInfinityBound)
+      continue;
+    bound = max(bound, toBounds.m_lower[i] - fromBounds.m_upper[i]);
+    bound = max(bound, fromBounds.m_lower[i] - toBounds.m_upper[i]);
+  }
+  return bound / 10.0;
+}
+
+LandmarksEstimator::Bounds const & LandmarksEstimator::GetBounds(Junction const & junction) const
+{
+  auto const res = m_bounds.emplace(junction, Bounds());
+  if (res.second)
+    CalcBounds(junction, res.first->second);
+  return res.first->second;
+}
+
+void LandmarksEstimator::CalcBounds(Junction const & junction, Bounds & bounds) const
+{
+  uint32_t const count = m_table.GetLandmarksCount();
+  bounds.m_lower.assign(count, -kInfinityBound);
+  bounds.m_upper.assign(count, kInfinityBound);
+
+  auto const addAnchor = [&](uint32_t const * distances, double length)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (distances[i] == LandmarksTable::kInfinity)
+        continue;
+      bounds.m_lower[i] = max(bounds.m_lower[i], distances[i] - length);
+      bounds.m_upper[i] = min(bounds.m_upper[i], distances[i] + length);
+    }
+    bounds.m_known = true;
+  };
+
+  if (uint32_t const * distances = m_table.GetDistances(junction.GetPoint()))
+  {
+    addAnchor(distances, 0.0);
+    return;
+  }
+
+  if (IsRouteEnd(junction))
+  {
+    CalcRouteEndBounds(junction, bounds);
+    return;
+  }
+
+  // Binds the junction to the closest table junctions: a distance from a landmark to
+  // the junction differs from the distance to an anchor by no more than the path between them.
+  using TState = pair<double, Junction>;
+  priority_queue<TState, vector<TState>, greater<TState>> queue;
+  map<Junction, double> lengths;
+  size_t visited = 0;
+
+  lengths[junction] = 0.0;
+  queue.emplace(0.0, junction);
+  IRoadGraph::TEdgeVector edges;
+  while (!queue.empty() && visited < kMaxBoundsSearchVertices)
+  {
+    TState const state = queue.top();
+    queue.pop();
+
+    Junction const & v = state.second;
+    if (state.first > lengths[v])
+      continue;
+    ++visited;
+
+    if (!(v == junction))
+    {
+      if (uint32_t const * distances = m_table.GetDistances(v.GetPoint()))
+      {
+        addAnchor(distances, state.first);
+        continue;
+      }
+    }
+
+    m_graph.GetOutgoingEdges(v, edges);
+    for (auto const & e : edges)
+    {
+      if (IsRouteEnd(e.GetEndJunction()))
+        continue;
+      double const length = state.first + LandmarksTable::GetEdgeLength(e.GetStartJunction().GetPoint(),
+                                                                        e.GetEndJunction().GetPoint());
+      auto const it = lengths.find(e.GetEndJunction());
+      if (it == lengths.end() || length < it->second)
+      {
+        lengths[e.GetEndJunction()] = length;
+        queue.emplace(length, e.GetEndJunction());
+      }
+    }
+  }
+}
+
+void LandmarksEstimator::CalcRouteEndBounds(Junction const & junction, Bounds & bounds) const
+{
+  // Bounds of the route end are the union of its neighbours' bounds widened by edge lengths,
+  // so the estimates are consistent on edges between the route end and its neighbours.
+  uint32_t const count = m_table.GetLandmarksCount();
+  bounds.m_lower.assign(count, kInfinityBound);
+  bounds.m_upper.assign(count, -kInfinityBound);
+
+  IRoadGraph::TEdgeVector edges;
+  m_graph.GetOutgoingEdges(junction, edges);
+  for (auto const & e : edges)
+  {
+    if (IsRouteEnd(e.GetEndJunction()))
+      continue;
+
+    Bounds const & neighbour = GetBounds(e.GetEndJunction());
+    if (!neighbour.m_known)
+    {
+      bounds.m_known = false;
+      return;
+    }
+
+    double const length = LandmarksTable::GetEdgeLength(e.GetStartJunction().GetPoint(),
+                                                        e.GetEndJunction().GetPoint());
+    for (size_t i = 0; i < count; ++i)
+    {
+      bounds.m_lower[i] = min(bounds.m_lower[i], neighbour.m_lower[i] - length);
+      bounds.m_upper[i] = max(bounds.m_upper[i], neighbour.m_upper[i] + length);
+    }
+    bounds.m_known = true;
+  }
+}
+
+}  // namespace routing
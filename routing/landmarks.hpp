@@ -0,0 +1,139 @@
+#pragma once
+
+#include "routing/road_graph.hpp"
+
+#include "coding/varint.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/limits.hpp"
+#include "std/map.hpp"
+#include "std/vector.hpp"
+
+namespace routing
+{
+
+/// LandmarksTable keeps precomputed shortest distances from a few landmark vertices
+/// to every vertex of the pedestrian road graph of a single mwm. The graph is treated
+/// as undirected, distances are stored in decimetres. The table is used to estimate
+/// lower bounds of distances between junctions by the triangle inequality (ALT,
+/// see A. Goldberg, C. Harrelson, "Computing the Shortest Path: A* Search Meets Graph Theory").
+class LandmarksTable
+{
+public:
+  using TRoad = vector<m2::PointD>;
+
+  /// Distance to a vertex which is unreachable from a landmark.
+  static uint32_t constexpr kInfinity = numeric_limits<uint32_t>::max();
+  static uint32_t constexpr kDefaultLandmarksCount = 8;
+
+  /// Builds the table for a graph formed by bidirectional roads.
+  /// Points which are closer than IRoadGraph's junction epsilon are merged into one vertex.
+  void Build(vector<TRoad> const & roads, uint32_t landmarksCount);
+
+  /// @return Distance in decimetres used as an edge length by the table.
+  static double GetEdgeLength(m2::PointD const & p1, m2::PointD const & p2);
+
+  inline uint32_t GetLandmarksCount() const { return m_landmarksCount; }
+  inline size_t GetVerticesCount() const { return m_keys.size(); }
+  inline bool IsEmpty() const { return m_keys.empty(); }
+
+  /// @return Pointer to GetLandmarksCount() distances from landmarks to the point,
+  ///         or nullptr when the point is not a vertex of the graph.
+  uint32_t const * GetDistances(m2::PointD const & point) const;
+
+  template <class TSink>
+  void Serialize(TSink & sink) const
+  {
+    WriteVarUint(sink, m_landmarksCount);
+    WriteVarUint(sink, static_cast<uint64_t>(m_keys.size()));
+
+    uint64_t prevKey = 0;
+    for (uint64_t const key : m_keys)
+    {
+      WriteVarUint(sink, key - prevKey);
+      prevKey = key;
+    }
+
+    // Infinity is written as zero, all other distances are shifted by one.
+    for (uint32_t const d : m_distances)
+      WriteVarUint(sink, d == kInfinity ? 0 : d + 1);
+  }
+
+  template <class TSource>
+  void Deserialize(TSource & src)
+  {
+    m_landmarksCount = ReadVarUint<uint32_t>(src);
+    uint64_t const verticesCount = ReadVarUint<uint64_t>(src);
+
+    m_keys.resize(verticesCount);
+    uint64_t key = 0;
+    for (uint64_t & k : m_keys)
+    {
+      key += ReadVarUint<uint64_t>(src);
+      k = key;
+    }
+
+    m_distances.resize(verticesCount * m_landmarksCount);
+    for (uint32_t & d : m_distances)
+    {
+      uint32_t const value = ReadVarUint<uint32_t>(src);
+      d = (value == 0 ? kInfinity : value - 1);
+    }
+  }
+
+  void Swap(LandmarksTable & rhs);
+
+private:
+  /// Sorted keys of vertices' points.
+  vector<uint64_t> m_keys;
+  /// m_landmarksCount distances for each vertex in m_keys.
+  vector<uint32_t> m_distances;
+  uint32_t m_landmarksCount = 0;
+};
+
+/// LandmarksEstimator computes lower bounds of distances between junctions of a road
+/// graph by a LandmarksTable. Junctions which are absent in the table (e.g. fake junctions
+/// at the route ends) are bound to the table by a small search to their closest table junctions.
+class LandmarksEstimator
+{
+public:
+  /// Route ends are connected to the graph by fake edges, which may be shortcuts
+  /// between roads, so they are never used to bind other junctions to the table.
+  /// Bounds of the route ends are derived from bounds of their neighbours instead.
+  LandmarksEstimator(IRoadGraph const & graph, LandmarksTable const & table,
+                     Junction const & startPos, Junction const & finalPos);
+
+  /// @return True when lower bounds for the junction can be computed.
+  bool IsKnown(Junction const & junction) const;
+
+  /// @return Lower bound of distance between junctions in meters.
+  double GetLowerBoundMeters(Junction const & from, Junction const & to) const;
+
+private:
+  /// Bounds of distances from landmarks to a junction in decimetres.
+  struct Bounds
+  {
+    vector<double> m_lower;
+    vector<double> m_upper;
+    bool m_known = false;
+  };
+
+  inline bool IsRouteEnd(Junction const & junction) const
+  {
+    return junction == m_startPos || junction == m_finalPos;
+  }
+
+  Bounds const & GetBounds(Junction const & junction) const;
+  void CalcBounds(Junction const & junction, Bounds & bounds) const;
+  void CalcRouteEndBounds(Junction const & junction, Bounds & bounds) const;
+
+  IRoadGraph const & m_graph;
+  LandmarksTable const & m_table;
+  Junction const m_startPos;
+  Junction const m_finalPos;
+  mutable map<Junction, Bounds> m_bounds;
+};
+
+}  // namespace routing
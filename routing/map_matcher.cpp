@@ -0,0 +1,266 @@
+#include "routing/map_matcher.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "base/assert.hpp"
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+#include "std/cmath.hpp"
+#include "std/functional.hpp"
+#include "std/limits.hpp"
+#include "std/mutex.hpp"
+#include "std/queue.hpp"
+#include "std/thread.hpp"
+
+namespace routing
+{
+namespace
+{
+double constexpr kInf = numeric_limits<double>::infinity();
+}  // namespace
+
+// static
+size_t constexpr MapMatcher::kMaxCachedJunctions;
+
+MapMatcher::MapMatcher(IRoadGraph const & graph, Params const & params)
+  : m_graph(graph), m_params(params)
+{
+  ASSERT_GREATER(m_params.m_gpsSigmaMeters, 0.0, ());
+  ASSERT_GREATER(m_params.m_transitionBetaMeters, 0.0, ());
+}
+
+void MapMatcher::Match(vector<m2::PointD> const & trace, vector<MatchedPoint> & result)
+{
+  result.assign(trace.size(), MatchedPoint());
+  m_stats.m_pointsCount += trace.size();
+  if (m_outgoing.size() > kMaxCachedJunctions)
+    m_outgoing.clear();
+
+  // Candidates of the points of the current chain with the log-probabilities of the most likely
+  // sequences which end at them and the indices of the previous candidates of these sequences.
+  vector<vector<Candidate>> candidates;
+  vector<vector<double>> scores;
+  vector<vector<size_t>> parents;
+  size_t chainStart = 0;
+
+  auto const finishChain = [&]()
+  {
+    if (candidates.empty())
+      return;
+
+    vector<double> const & last = scores.back();
+    size_t best = distance(last.begin(), max_element(last.begin(), last.end()));
+    for (size_t i = candidates.size(); i > 0; --i)
+    {
+      Candidate const & candidate = candidates[i - 1][best];
+      MatchedPoint & point = result[chainStart + i - 1];
+      point.m_edge = candidate.m_edge;
+      point.m_projection = candidate.m_projection;
+      point.m_isMatched = true;
+      best = parents[i - 1][best];
+    }
+
+    ++m_stats.m_chainsCount;
+    m_stats.m_matchedCount += candidates.size();
+    candidates.clear();
+    scores.clear();
+    parents.clear();
+  };
+
+  vector<Candidate> current;
+  vector<double> lengths;
+  for (size_t i = 0; i < trace.size(); ++i)
+  {
+    FindCandidates(trace[i], current);
+    if (current.empty())
+    {
+      finishChain();
+      chainStart = i + 1;
+      continue;
+    }
+
+    vector<double> score(current.size(), -kInf);
+    vector<size_t> parent(current.size(), 0);
+    if (!candidates.empty())
+    {
+      vector<Candidate> const & prev = candidates.back();
+      vector<double> const & prevScore = scores.back();
+      double const straightMeters = MercatorBounds::DistanceOnEarth(trace[i - 1], trace[i]);
+      double const maxMeters =
+          straightMeters * m_params.m_maxRouteFactor + 2 * m_params.m_maxSnapMeters;
+      for (size_t j = 0; j < prev.size(); ++j)
+      {
+        FindRouteLengths(prev[j], current, maxMeters, lengths);
+        for (size_t k = 0; k < current.size(); ++k)
+        {
+          if (lengths[k] == kInf)
+            continue;
+          double const s = prevScore[j] + current[k].m_emission -
+                           fabs(lengths[k] - straightMeters) / m_params.m_transitionBetaMeters;
+          if (s > score[k])
+          {
+            score[k] = s;
+            parent[k] = j;
+          }
+        }
+      }
+
+      // None of the candidates is reached, the point starts a new chain.
+      if (*max_element(score.begin(), score.end()) == -kInf)
+      {
+        finishChain();
+        chainStart = i;
+      }
+    }
+
+    if (candidates.empty())
+    {
+      for (size_t k = 0; k < current.size(); ++k)
+        score[k] = current[k].m_emission;
+    }
+
+    candidates.push_back(move(current));
+    scores.push_back(move(score));
+    parents.push_back(move(parent));
+    current.clear();
+  }
+  finishChain();
+}
+
+void MapMatcher::FindCandidates(m2::PointD const & point, vector<Candidate> & candidates)
+{
+  candidates.clear();
+
+  vector<pair<Edge, m2::PointD>> vicinities;
+  m_graph.FindClosestEdges(point, m_params.m_candidatesCount, vicinities);
+
+  DistanceOnEarthFrom const distanceFrom(point);
+  for (auto const & v : vicinities)
+  {
+    Edge const & edge = v.first;
+    m2::PointD const & projection = v.second;
+    double const meters = distanceFrom(projection);
+    if (meters > m_params.m_maxSnapMeters)
+      continue;
+
+    double const emission = -0.5 * my::sq(meters / m_params.m_gpsSigmaMeters);
+    double const fromStart =
+        MercatorBounds::DistanceOnEarth(edge.GetStartJunction().GetPoint(), projection);
+    double const toEnd =
+        MercatorBounds::DistanceOnEarth(projection, edge.GetEndJunction().GetPoint());
+    candidates.push_back({edge, projection, emission, fromStart, toEnd});
+
+    // The nearest edges are along the roads, the movement back is possible on the two-way roads.
+    if (m_graph.GetRoadInfo(edge.GetFeatureId()).m_bidirectional)
+      candidates.push_back({edge.GetReverseEdge(), projection, emission, toEnd, fromStart});
+  }
+}
+
+void MapMatcher::FindRouteLengths(Candidate const & from, vector<Candidate> const & targets,
+                                  double maxMeters, vector<double> & lengths)
+{
+  lengths.assign(targets.size(), kInf);
+
+  // Targets by the start junctions of their edges, the route to a target goes through it
+  // unless the target is further on the same edge.
+  unordered_map<Junction, vector<size_t>> targetsByStart;
+  for (size_t i = 0; i < targets.size(); ++i)
+  {
+    Candidate const & target = targets[i];
+    if (target.m_edge == from.m_edge && target.m_fromStartMeters >= from.m_fromStartMeters)
+      lengths[i] = target.m_fromStartMeters - from.m_fromStartMeters;
+    targetsByStart[target.m_edge.GetStartJunction()].push_back(i);
+  }
+
+  using TQueueItem = pair<double, Junction>;
+  priority_queue<TQueueItem, vector<TQueueItem>, greater<TQueueItem>> queue;
+  unordered_map<Junction, double> bestMeters;
+  Junction const & origin = from.m_edge.GetEndJunction();
+  bestMeters[origin] = from.m_toEndMeters;
+  queue.emplace(from.m_toEndMeters, origin);
+
+  size_t reachedCount = 0;
+  while (!queue.empty() && reachedCount < targetsByStart.size())
+  {
+    TQueueItem const item = queue.top();
+    queue.pop();
+    if (item.first > bestMeters[item.second])
+      continue;
+
+    auto const it = targetsByStart.find(item.second);
+    if (it != targetsByStart.end())
+    {
+      ++reachedCount;
+      for (size_t i : it->second)
+        lengths[i] = min(lengths[i], item.first + targets[i].m_fromStartMeters);
+    }
+
+    for (auto const & e : GetOutgoingEdges(item.second))
+    {
+      double const meters = item.first + e.second;
+      if (meters > maxMeters)
+        continue;
+      auto const res = bestMeters.emplace(e.first, meters);
+      if (!res.second)
+      {
+        if (res.first->second <= meters)
+          continue;
+        res.first->second = meters;
+      }
+      queue.emplace(meters, e.first);
+    }
+  }
+}
+
+MapMatcher::TWeightedEdges const & MapMatcher::GetOutgoingEdges(Junction const & junction)
+{
+  auto const it = m_outgoing.find(junction);
+  if (it != m_outgoing.end())
+    return it->second;
+
+  IRoadGraph::TEdgeVector edges;
+  m_graph.GetOutgoingEdges(junction, edges);
+
+  TWeightedEdges weighted;
+  weighted.reserve(edges.size());
+  DistanceOnEarthFrom const distanceFrom(junction.GetPoint());
+  for (Edge const & e : edges)
+    weighted.emplace_back(e.GetEndJunction(), distanceFrom(e.GetEndJunction().GetPoint()));
+  return m_outgoing.emplace(junction, move(weighted)).first->second;
+}
+
+MapMatcher::Stats MatchTraces(TRoadGraphFactory const & graphFactory,
+                              MapMatcher::Params const & params,
+                              vector<vector<m2::PointD>> const & traces,
+                              vector<vector<MatchedPoint>> & results, size_t threadsCount)
+{
+  results.assign(traces.size(), vector<MatchedPoint>());
+
+  MapMatcher::Stats total;
+  mutex totalMutex;
+  atomic<size_t> next(0);
+  auto const worker = [&]()
+  {
+    unique_ptr<IRoadGraph> const graph = graphFactory();
+    MapMatcher matcher(*graph, params);
+    for (size_t i = next++; i < traces.size(); i = next++)
+      matcher.Match(traces[i], results[i]);
+
+    MapMatcher::Stats const & stats = matcher.GetStats();
+    lock_guard<mutex> lock(totalMutex);
+    total.m_pointsCount += stats.m_pointsCount;
+    total.m_matchedCount += stats.m_matchedCount;
+    total.m_chainsCount += stats.m_chainsCount;
+  };
+
+  vector<thread> threads;
+  for (size_t i = 1; i < threadsCount; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (thread & t : threads)
+    t.join();
+  return total;
+}
+}  // namespace routing
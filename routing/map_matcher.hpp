@@ -0,0 +1,123 @@
+#pragma once
+
+#include "routing/road_graph.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/function.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/unordered_map.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace routing
+{
+/// Point of a GPS trace which is snapped to a road.
+struct MatchedPoint
+{
+  MatchedPoint() : m_edge(Edge::MakeFake(Junction(), Junction())) {}
+
+  /// Edge of the road in the direction of the movement.
+  Edge m_edge;
+  /// Projection of the trace point to the edge.
+  m2::PointD m_projection = m2::PointD::Zero();
+  /// False when there are no roads near the point, the rest fields are invalid then.
+  bool m_isMatched = false;
+};
+
+/// MapMatcher snaps the raw GPS traces to the roads of a road graph by the hidden Markov model:
+/// the nearest edges of each point are its candidate states, the candidate emission is
+/// the less likely the further it's from the point, and the transition between the candidates
+/// of the neighbour points is the less likely the more the route between them differs from
+/// the straight line. The most likely sequence of the candidates is found by Viterbi algorithm.
+///
+/// The trace is split into the parts which are matched apart when a point has no candidates or
+/// none of its candidates is reached from the previous ones.
+///
+/// Outgoing edges of the junctions are kept between the traces, so the points of the same area
+/// don't load the roads again. A matcher isn't thread-safe, use MatchTraces() to match
+/// the traces by several threads.
+class MapMatcher
+{
+public:
+  struct Params
+  {
+    /// Max number of the candidate edges of a point.
+    uint32_t m_candidatesCount = 4;
+    /// Edges which are further from a point aren't its candidates.
+    double m_maxSnapMeters = 50.0;
+    /// Standard deviation of the GPS errors.
+    double m_gpsSigmaMeters = 10.0;
+    /// Scale of the difference between the route and the straight distance of the neighbour
+    /// points, the greater it is the more the detours are allowed.
+    double m_transitionBetaMeters = 30.0;
+    /// Routes between the candidates which are longer than the straight distance times
+    /// this factor plus two snap distances aren't searched.
+    double m_maxRouteFactor = 3.0;
+  };
+
+  struct Stats
+  {
+    uint64_t m_pointsCount = 0;
+    uint64_t m_matchedCount = 0;
+    /// Number of the parts the traces are split into.
+    uint64_t m_chainsCount = 0;
+  };
+
+  /// Max number of the junctions which outgoing edges are kept between the traces.
+  static size_t constexpr kMaxCachedJunctions = 200000;
+
+  /// Doesn't take ownership of graph.
+  MapMatcher(IRoadGraph const & graph, Params const & params);
+
+  /// Matches the points of the trace, result has a point for each one of the trace.
+  void Match(vector<m2::PointD> const & trace, vector<MatchedPoint> & result);
+
+  void ClearCache() { m_outgoing.clear(); }
+
+  Stats const & GetStats() const { return m_stats; }
+
+private:
+  struct Candidate
+  {
+    Edge m_edge;
+    m2::PointD m_projection;
+    /// Log-probability of the point to be at the candidate.
+    double m_emission;
+    /// Distances from the start of the edge to the projection and from the projection
+    /// to the end of the edge.
+    double m_fromStartMeters;
+    double m_toEndMeters;
+  };
+
+  typedef vector<pair<Junction, double>> TWeightedEdges;
+
+  void FindCandidates(m2::PointD const & point, vector<Candidate> & candidates);
+
+  /// Finds the route lengths from the candidate to each one of targets, they are infinite
+  /// for the targets which aren't reached within maxMeters.
+  void FindRouteLengths(Candidate const & from, vector<Candidate> const & targets,
+                        double maxMeters, vector<double> & lengths);
+
+  /// @return End junctions of the outgoing edges of the junction with the edge lengths.
+  TWeightedEdges const & GetOutgoingEdges(Junction const & junction);
+
+  IRoadGraph const & m_graph;
+  Params const m_params;
+  Stats m_stats;
+
+  unordered_map<Junction, TWeightedEdges> m_outgoing;
+};
+
+typedef function<unique_ptr<IRoadGraph>()> TRoadGraphFactory;
+
+/// Matches the traces by threadsCount threads, each one with its own graph which is made
+/// by graphFactory. The traces are taken by the threads one by one, so the long traces
+/// don't stall the rest of them.
+/// @return Total stats of all the threads.
+MapMatcher::Stats MatchTraces(TRoadGraphFactory const & graphFactory,
+                              MapMatcher::Params const & params,
+                              vector<vector<m2::PointD>> const & traces,
+                              vector<vector<MatchedPoint>> & results, size_t threadsCount);
+}  // namespace routing
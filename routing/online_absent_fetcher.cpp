@@ -5,6 +5,8 @@
 #include "platform/country_file.hpp"
 #include "platform/local_country_file.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
 #include "std/vector.hpp"
 
 #include "private.h"
@@ -14,37 +16,174 @@ using platform::LocalCountryFile;
 
 namespace routing
 {
+// static
+double constexpr OnlineAbsentCountriesFetcher::kCacheCellSize;
+// static
+size_t constexpr OnlineAbsentCountriesFetcher::kCacheSize;
+// static
+size_t constexpr OnlineAbsentCountriesFetcher::kMaxRequestsInFlight;
+
 void OnlineAbsentCountriesFetcher::GenerateRequest(const m2::PointD & startPoint,
                                                    const m2::PointD & finalPoint)
 {
+  CollectFinishedRequests();
+  m_hasRoute = false;
+
   // Single mwm case.
-  if (m_countryFileFn(startPoint) == m_countryFileFn(finalPoint) ||
-      GetPlatform().ConnectionStatus() == Platform::EConnectionType::CONNECTION_NONE)
+  m_startCountry = m_countryFileFn(startPoint);
+  m_finalCountry = m_countryFileFn(finalPoint);
+  if (m_startCountry == m_finalCountry)
+    return;
+  m_hasRoute = true;
+  m_key = MakeKey(startPoint, finalPoint);
+
+  // The cached answer and the request in flight for the same cells are used for the route.
+  if (FindInCache(m_key) != nullptr)
     return;
+  if (any_of(m_requests.begin(), m_requests.end(), [this](Request const & request)
+             {
+               return request.m_key == m_key;
+             }))
+  {
+    return;
+  }
+  if (GetPlatform().ConnectionStatus() == Platform::EConnectionType::CONNECTION_NONE)
+    return;
+
+  // Requests of the previous routes are left running for the cache, the oldest one is dropped
+  // when there are too many of them. Its thread is detached and deletes the fetcher.
+  if (m_requests.size() == kMaxRequestsInFlight)
+    m_requests.pop_front();
+
   unique_ptr<OnlineCrossFetcher> fetcher =
       make_unique<OnlineCrossFetcher>(OSRM_ONLINE_SERVER_URL, MercatorBounds::ToLatLon(startPoint),
                                       MercatorBounds::ToLatLon(finalPoint));
+  Request request;
+  request.m_key = m_key;
+  request.m_fetcher = fetcher.get();
   // iOS can't reuse threads. So we need to recreate the thread.
-  m_fetcherThread.reset(new threads::Thread());
-  m_fetcherThread->Create(move(fetcher));
+  request.m_thread.reset(new threads::Thread());
+  request.m_thread->Create(move(fetcher));
+  m_requests.push_back(move(request));
 }
 
 void OnlineAbsentCountriesFetcher::GetAbsentCountries(vector<string> & countries)
 {
-  // Check whether a request was scheduled to be run on the thread.
-  if (!m_fetcherThread)
+  if (!m_hasRoute)
     return;
-  m_fetcherThread->Join();
-  for (auto const & point : m_fetcherThread->GetRoutineAs<OnlineCrossFetcher>()->GetMwmPoints())
+  CollectFinishedRequests();
+
+  vector<m2::PointD> const * mwmPoints = FindInCache(m_key);
+  if (mwmPoints == nullptr)
   {
-    string name = m_countryFileFn(point);
-    auto localFile = m_countryLocalFileFn(name);
-    if (localFile && HasOptions(localFile->GetFiles(), MapOptions::MapWithCarRouting))
-      continue;
+    vector<string> estimate;
+    if (m_estimateFn && m_estimateFn(m_startCountry, m_finalCountry, estimate))
+    {
+      // The request keeps running, its answer is taken from the cache by the next routes.
+      for (string const & name : estimate)
+        AddAbsentCountry(name, countries);
+      m_hasRoute = false;
+      return;
+    }
 
-    LOG(LINFO, ("Needs: ", name));
-    countries.emplace_back(move(name));
+    WaitForRequest(m_key);
+    mwmPoints = FindInCache(m_key);
   }
-  m_fetcherThread.reset();
+
+  if (mwmPoints != nullptr)
+  {
+    for (auto const & point : *mwmPoints)
+      AddAbsentCountry(m_countryFileFn(point), countries);
+  }
+  m_hasRoute = false;
+}
+
+void OnlineAbsentCountriesFetcher::CacheAnswer(m2::PointD const & startPoint,
+                                               m2::PointD const & finalPoint,
+                                               vector<m2::PointD> const & mwmPoints)
+{
+  PutToCache(MakeKey(startPoint, finalPoint), mwmPoints);
+}
+
+// static
+OnlineAbsentCountriesFetcher::TKey OnlineAbsentCountriesFetcher::MakeKey(
+    m2::PointD const & startPoint, m2::PointD const & finalPoint)
+{
+  auto const cell = [](double coord)
+  {
+    return static_cast<int32_t>(floor(coord / kCacheCellSize));
+  };
+  return TKey(cell(startPoint.x), cell(startPoint.y), cell(finalPoint.x), cell(finalPoint.y));
+}
+
+vector<m2::PointD> const * OnlineAbsentCountriesFetcher::FindInCache(TKey const & key)
+{
+  auto const it = find_if(m_cache.begin(), m_cache.end(),
+                          [&key](pair<TKey, vector<m2::PointD>> const & entry)
+                          {
+                            return entry.first == key;
+                          });
+  if (it == m_cache.end())
+    return nullptr;
+  m_cache.splice(m_cache.begin(), m_cache, it);
+  return &m_cache.front().second;
+}
+
+void OnlineAbsentCountriesFetcher::PutToCache(TKey const & key,
+                                              vector<m2::PointD> const & mwmPoints)
+{
+  // Failed requests aren't cached, they're made again by the next routes.
+  if (mwmPoints.empty())
+    return;
+
+  if (FindInCache(key) != nullptr)
+  {
+    m_cache.front().second = mwmPoints;
+    return;
+  }
+  m_cache.emplace_front(key, mwmPoints);
+  if (m_cache.size() > kCacheSize)
+    m_cache.pop_back();
+}
+
+void OnlineAbsentCountriesFetcher::CollectFinishedRequests()
+{
+  for (auto it = m_requests.begin(); it != m_requests.end();)
+  {
+    if (!it->m_fetcher->IsDone())
+    {
+      ++it;
+      continue;
+    }
+    it->m_thread->Join();
+    PutToCache(it->m_key, it->m_fetcher->GetMwmPoints());
+    it = m_requests.erase(it);
+  }
+}
+
+void OnlineAbsentCountriesFetcher::WaitForRequest(TKey const & key)
+{
+  auto const it = find_if(m_requests.begin(), m_requests.end(), [&key](Request const & request)
+                          {
+                            return request.m_key == key;
+                          });
+  if (it == m_requests.end())
+    return;
+  it->m_thread->Join();
+  PutToCache(it->m_key, it->m_fetcher->GetMwmPoints());
+  m_requests.erase(it);
+}
+
+void OnlineAbsentCountriesFetcher::AddAbsentCountry(string const & name,
+                                                    vector<string> & countries) const
+{
+  auto localFile = m_countryLocalFileFn(name);
+  if (localFile && HasOptions(localFile->GetFiles(), MapOptions::MapWithCarRouting))
+    return;
+  if (find(countries.begin(), countries.end(), name) != countries.end())
+    return;
+
+  LOG(LINFO, ("Needs: ", name));
+  countries.push_back(name);
 }
 }  // namespace routing
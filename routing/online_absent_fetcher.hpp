@@ -6,7 +6,10 @@
 
 #include "base/thread.hpp"
 
+#include "std/cstdint.hpp"
+#include "std/list.hpp"
 #include "std/string.hpp"
+#include "std/tuple.hpp"
 #include "std/unique_ptr.hpp"
 
 
@@ -14,6 +17,14 @@ namespace routing
 {
 using TCountryLocalFileFn = function<shared_ptr<platform::LocalCountryFile>(string const &)>;
 
+/// Estimates the countries of the route from the start country to the final one without
+/// the network. @return False when the countries can't be estimated.
+using TCountriesEstimateFn =
+    function<bool(string const & startCountry, string const & finalCountry,
+                  vector<string> & countries)>;
+
+class OnlineCrossFetcher;
+
 class IOnlineFetcher
 {
 public:
@@ -25,13 +36,27 @@ public:
 /*!
  * \brief The OnlineAbsentCountriesFetcher class incapsulates async fetching the map
  * names from online OSRM server routines.
+ *
+ * Answers of the server are cached by the coarse cells of the start and the final points,
+ * so the routes near the previous ones don't make requests. A request for the same cells
+ * which is still in flight is reused instead of a new one. When the countries are estimated
+ * offline, the absent countries are taken from the estimate without waiting for the server,
+ * and the online answer only confirms the estimate for the next routes through the cache.
  */
 class OnlineAbsentCountriesFetcher : public IOnlineFetcher
 {
 public:
+  /// Side of the cells of the cache in mercator units, it's about 5 km on the equator.
+  static double constexpr kCacheCellSize = 0.05;
+  static size_t constexpr kCacheSize = 32;
+  static size_t constexpr kMaxRequestsInFlight = 4;
+
   OnlineAbsentCountriesFetcher(TCountryFileFn const & countryFileFn,
-                               TCountryLocalFileFn const & countryLocalFileFn)
-    : m_countryFileFn(countryFileFn), m_countryLocalFileFn(countryLocalFileFn)
+                               TCountryLocalFileFn const & countryLocalFileFn,
+                               TCountriesEstimateFn const & estimateFn = nullptr)
+    : m_countryFileFn(countryFileFn),
+      m_countryLocalFileFn(countryLocalFileFn),
+      m_estimateFn(estimateFn)
   {
   }
 
@@ -39,9 +64,48 @@ public:
   void GenerateRequest(m2::PointD const & startPoint, m2::PointD const & finalPoint) override;
   void GetAbsentCountries(vector<string> & countries) override;
 
+  /// Puts the online answer for the points to the cache, as the server has sent it.
+  void CacheAnswer(m2::PointD const & startPoint, m2::PointD const & finalPoint,
+                   vector<m2::PointD> const & mwmPoints);
+
+  inline size_t GetRequestsInFlight() const { return m_requests.size(); }
+
 private:
+  /// Coarse cells of the start and the final points.
+  using TKey = tuple<int32_t, int32_t, int32_t, int32_t>;
+
+  struct Request
+  {
+    TKey m_key;
+    unique_ptr<threads::Thread> m_thread;
+    OnlineCrossFetcher * m_fetcher = nullptr;
+  };
+
+  static TKey MakeKey(m2::PointD const & startPoint, m2::PointD const & finalPoint);
+
+  /// @return Cached mwm points of the key or nullptr, the entry becomes the most recent one.
+  vector<m2::PointD> const * FindInCache(TKey const & key);
+  void PutToCache(TKey const & key, vector<m2::PointD> const & mwmPoints);
+
+  /// Moves the answers of the finished requests to the cache.
+  void CollectFinishedRequests();
+  /// Waits for the request of the key, its answer goes to the cache.
+  void WaitForRequest(TKey const & key);
+
+  void AddAbsentCountry(string const & name, vector<string> & countries) const;
+
   TCountryFileFn const m_countryFileFn;
   TCountryLocalFileFn const m_countryLocalFileFn;
-  unique_ptr<threads::Thread> m_fetcherThread;
+  TCountriesEstimateFn const m_estimateFn;
+
+  // The current route, it's set by GenerateRequest().
+  bool m_hasRoute = false;
+  TKey m_key;
+  string m_startCountry;
+  string m_finalCountry;
+
+  // The most recent answer is the first.
+  list<pair<TKey, vector<m2::PointD>>> m_cache;
+  list<Request> m_requests;
 };
 }  // namespace routing
@@ -54,7 +54,7 @@ string GenerateOnlineRequest(string const & serverURL, ms::LatLon const & startP
 
 OnlineCrossFetcher::OnlineCrossFetcher(string const & serverURL, ms::LatLon const & startPoint,
                                        ms::LatLon const & finalPoint)
-    : m_request(GenerateOnlineRequest(serverURL, startPoint, finalPoint))
+    : m_request(GenerateOnlineRequest(serverURL, startPoint, finalPoint)), m_done(false)
 {
   LOG(LINFO, ("Check mwms by URL: ", GenerateOnlineRequest(serverURL, startPoint, finalPoint)));
 }
@@ -66,5 +66,6 @@ void OnlineCrossFetcher::Do()
     ParseResponse(m_request.server_response(), m_mwmPoints);
   else
     LOG(LWARNING, ("Can't get OSRM server response. Code: ", m_request.error_code()));
+  m_done = true;
 }
 }  // namespace routing
@@ -7,6 +7,7 @@
 
 #include "base/thread.hpp"
 
+#include "std/atomic.hpp"
 #include "std/string.hpp"
 #include "std/vector.hpp"
 
@@ -46,8 +47,12 @@ public:
   /// \return Mwm points to build route from startPt to finishPt. Empty list if there were errors.
   vector<m2::PointD> const & GetMwmPoints() { return m_mwmPoints; }
 
+  /// \return True when Do() has finished, the mwm points can be taken after the thread is joined.
+  bool IsDone() const { return m_done; }
+
 private:
   alohalytics::HTTPClientPlatformWrapper m_request;
   vector<m2::PointD> m_mwmPoints;
+  atomic<bool> m_done;
 };
 }
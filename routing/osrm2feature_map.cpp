@@ -135,7 +135,8 @@ void OsrmFtSegMapping::Load(FilesMappingContainer & cont, platform::LocalCountry
 
 void OsrmFtSegMapping::Map(FilesMappingContainer & cont)
 {
-  m_handle.Assign(cont.Map(ROUTING_FTSEG_FILE_TAG));
+  m_handle.Assign(cont.Map(ROUTING_FTSEG_FILE_TAG,
+                           mmap_policy::Get(ROUTING_FTSEG_FILE_TAG, mmap_policy::Random)));
   ASSERT(m_handle.IsValid(), ());
   succinct::mapper::map(m_segments, m_handle.GetData<char>());
 }
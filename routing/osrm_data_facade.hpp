@@ -9,7 +9,11 @@
 
 #include "base/bits.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/limits.hpp"
 #include "std/string.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
 
 #include "3party/succinct/elias_fano.hpp"
 #include "3party/succinct/elias_fano_compressed_list.hpp"
@@ -39,6 +43,89 @@ protected:
 
   uint32_t m_numberOfNodes = 0;
 
+  /// Decoded edge of the adjacency cache.
+  struct CachedEdge
+  {
+    NodeID m_target;
+    uint32_t m_distance;
+    /// Middle node of the shortcut, zero for the other edges.
+    NodeID m_id;
+    bool m_shortcut;
+    bool m_backward;
+  };
+
+  /// Nodes of the adjacency cache, sorted. Edges of the node m_cachedNodes[i] are
+  /// [m_cachedBegins[i], m_cachedBegins[i] + m_cachedOffsets[i + 1] - m_cachedOffsets[i]),
+  /// they are decoded to m_cachedEdges[m_cachedOffsets[i], m_cachedOffsets[i + 1]).
+  vector<NodeID> m_cachedNodes;
+  vector<EdgeID> m_cachedBegins;
+  vector<uint32_t> m_cachedOffsets;
+  vector<CachedEdge> m_cachedEdges;
+  /// Index of the first cached node whose edges don't end before the block of edges, or
+  /// kNoCachedNode if no edges of the block are cached. The edges which aren't cached are
+  /// told by one lookup, without the search in m_cachedBegins.
+  vector<uint32_t> m_cachedBlocks;
+
+  static uint32_t const kEdgesBlockBits = 6;
+  static uint32_t const kNoCachedNode = numeric_limits<uint32_t>::max();
+
+  /// @return Index of the node in m_cachedNodes or m_cachedNodes.size().
+  size_t FindCachedNode(NodeID n) const
+  {
+    auto const it = lower_bound(m_cachedNodes.begin(), m_cachedNodes.end(), n);
+    if (it == m_cachedNodes.end() || *it != n)
+      return m_cachedNodes.size();
+    return static_cast<size_t>(distance(m_cachedNodes.begin(), it));
+  }
+
+  EdgeID GetCachedEnd(size_t i) const
+  {
+    return m_cachedBegins[i] + (m_cachedOffsets[i + 1] - m_cachedOffsets[i]);
+  }
+
+  CachedEdge const * FindCachedEdge(EdgeID e) const
+  {
+    size_t const block = e >> kEdgesBlockBits;
+    if (block >= m_cachedBlocks.size() || m_cachedBlocks[block] == kNoCachedNode)
+      return nullptr;
+    size_t i = m_cachedBlocks[block];
+    while (i < m_cachedNodes.size() && GetCachedEnd(i) <= e)
+      ++i;
+    if (i == m_cachedNodes.size() || m_cachedBegins[i] > e)
+      return nullptr;
+    return &m_cachedEdges[m_cachedOffsets[i] + (e - m_cachedBegins[i])];
+  }
+
+  NodeID DecodeTarget(EdgeID e) const
+  {
+    return (m_matrix.select(e) / 2) % GetNumberOfNodes();
+  }
+
+  EdgeDataT DecodeEdgeData(EdgeID e, NodeID node) const
+  {
+    EdgeDataT res;
+
+    res.shortcut = m_shortcuts[e];
+    res.id = res.shortcut ? (node - static_cast<NodeID>(bits::ZigZagDecode(m_edgeId[m_shortcuts.rank(e)]))) : 0;
+    res.backward = (m_matrix.select(e) % 2 == 1);
+    res.forward = !res.backward;
+    res.distance = static_cast<int>(m_edgeData[e]);
+
+    return res;
+  }
+
+  EdgeID DecodeBeginEdges(NodeID n) const
+  {
+    uint64_t idx = 2 * n * (uint64_t)GetNumberOfNodes();
+    return n == 0 ? 0 : static_cast<EdgeID>(m_matrix.rank(min(idx, m_matrix.size())));
+  }
+
+  EdgeID DecodeEndEdges(NodeID n) const
+  {
+    uint64_t const idx = 2 * (n + 1) * (uint64_t)GetNumberOfNodes();
+    return static_cast<EdgeID>(m_matrix.rank(min(idx, m_matrix.size())));
+  }
+
 public:
   //OsrmRawDataFacade(): m_numberOfNodes(0) {}
 
@@ -62,12 +149,114 @@ public:
 
   void ClearRawData()
   {
+    ClearAdjacencyCache();
     ClearContainer(m_edgeData);
     ClearContainer(m_edgeId);
     ClearContainer(m_shortcuts);
     ClearContainer(m_matrix);
   }
 
+  /// Decodes the edges of the nodes with the most edges to the flat arrays, which take about
+  /// maxBytes. The nodes of the high levels of the contraction hierarchy have the most
+  /// shortcuts, and they are relaxed by nearly every query, so their edges are read from the
+  /// cache instead of the succinct structures. Zero maxBytes clears the cache.
+  void BuildAdjacencyCache(size_t maxBytes)
+  {
+    ClearAdjacencyCache();
+    if (maxBytes == 0 || GetNumberOfNodes() == 0)
+      return;
+
+    size_t const nodeBytes = sizeof(NodeID) + sizeof(EdgeID) + sizeof(uint32_t);
+    vector<pair<uint32_t, NodeID>> degrees;
+    degrees.reserve(GetNumberOfNodes());
+    EdgeID begin = 0;
+    for (NodeID n = 0; n < GetNumberOfNodes(); ++n)
+    {
+      EdgeID const end = DecodeEndEdges(n);
+      if (end > begin)
+        degrees.emplace_back(end - begin, n);
+      begin = end;
+    }
+    sort(degrees.begin(), degrees.end(), [](pair<uint32_t, NodeID> const & lhs,
+                                            pair<uint32_t, NodeID> const & rhs)
+    {
+      return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+    });
+
+    vector<NodeID> nodes;
+    size_t const blocksCount = (GetNumberOfEdges() >> kEdgesBlockBits) + 1;
+    size_t bytes = sizeof(uint32_t) + blocksCount * sizeof(uint32_t);
+    for (auto const & degree : degrees)
+    {
+      size_t const nodeSize = nodeBytes + degree.first * sizeof(CachedEdge);
+      if (bytes + nodeSize > maxBytes)
+        break;
+      bytes += nodeSize;
+      nodes.push_back(degree.second);
+    }
+    if (nodes.empty())
+      return;
+    sort(nodes.begin(), nodes.end());
+
+    vector<EdgeID> begins;
+    vector<uint32_t> offsets;
+    vector<CachedEdge> edges;
+    begins.reserve(nodes.size());
+    offsets.reserve(nodes.size() + 1);
+    offsets.push_back(0);
+    for (NodeID const n : nodes)
+    {
+      EdgeID const end = DecodeEndEdges(n);
+      begins.push_back(DecodeBeginEdges(n));
+      for (EdgeID e = begins.back(); e < end; ++e)
+      {
+        EdgeDataT const data = DecodeEdgeData(e, n);
+        edges.push_back({DecodeTarget(e), static_cast<uint32_t>(data.distance), data.id,
+                         static_cast<bool>(data.shortcut), static_cast<bool>(data.backward)});
+      }
+      offsets.push_back(static_cast<uint32_t>(edges.size()));
+    }
+
+    vector<uint32_t> blocks(blocksCount, kNoCachedNode);
+    for (size_t i = nodes.size(); i > 0; --i)
+    {
+      EdgeID const end = begins[i - 1] + (offsets[i] - offsets[i - 1]);
+      for (size_t block = begins[i - 1] >> kEdgesBlockBits;
+           block <= ((end - 1) >> kEdgesBlockBits); ++block)
+      {
+        blocks[block] = static_cast<uint32_t>(i - 1);
+      }
+    }
+
+    m_cachedNodes.swap(nodes);
+    m_cachedBegins.swap(begins);
+    m_cachedOffsets.swap(offsets);
+    m_cachedEdges.swap(edges);
+    m_cachedBlocks.swap(blocks);
+  }
+
+  void ClearAdjacencyCache()
+  {
+    ClearContainer(m_cachedNodes);
+    ClearContainer(m_cachedBegins);
+    ClearContainer(m_cachedOffsets);
+    ClearContainer(m_cachedEdges);
+    ClearContainer(m_cachedBlocks);
+  }
+
+  /// @return Count of the nodes of the adjacency cache.
+  size_t GetCachedNodesCount() const { return m_cachedNodes.size(); }
+
+  /// @return Heap memory of the adjacency cache.
+  size_t GetAdjacencyCacheBytes() const
+  {
+    return m_cachedNodes.capacity() * sizeof(NodeID) +
+           m_cachedBegins.capacity() * sizeof(EdgeID) +
+           m_cachedOffsets.capacity() * sizeof(uint32_t) +
+           m_cachedEdges.capacity() * sizeof(CachedEdge) +
+           m_cachedBlocks.capacity() * sizeof(uint32_t);
+  }
+
   unsigned GetNumberOfNodes() const override
   {
     return m_numberOfNodes;
@@ -85,19 +274,22 @@ public:
 
   NodeID GetTarget(const EdgeID e) const override
   {
-    return (m_matrix.select(e) / 2) % GetNumberOfNodes();
+    CachedEdge const * cached = FindCachedEdge(e);
+    return cached ? cached->m_target : DecodeTarget(e);
   }
 
   EdgeDataT GetEdgeData(const EdgeID e, NodeID node) const override
   {
-    EdgeDataT res;
+    CachedEdge const * cached = FindCachedEdge(e);
+    if (!cached)
+      return DecodeEdgeData(e, node);
 
-    res.shortcut = m_shortcuts[e];
-    res.id = res.shortcut ? (node - static_cast<NodeID>(bits::ZigZagDecode(m_edgeId[m_shortcuts.rank(e)]))) : 0;
-    res.backward = (m_matrix.select(e) % 2 == 1);
+    EdgeDataT res;
+    res.shortcut = cached->m_shortcut;
+    res.id = cached->m_id;
+    res.backward = cached->m_backward;
     res.forward = !res.backward;
-    res.distance = static_cast<int>(m_edgeData[e]);
-
+    res.distance = static_cast<int>(cached->m_distance);
     return res;
   }
 
@@ -116,14 +308,14 @@ public:
 
   EdgeID BeginEdges(const NodeID n) const override
   {
-    uint64_t idx = 2 * n * (uint64_t)GetNumberOfNodes();
-    return n == 0 ? 0 : static_cast<EdgeID>(m_matrix.rank(min(idx, m_matrix.size())));
+    size_t const i = FindCachedNode(n);
+    return i < m_cachedNodes.size() ? m_cachedBegins[i] : DecodeBeginEdges(n);
   }
 
   EdgeID EndEdges(const NodeID n) const override
   {
-    uint64_t const idx = 2 * (n + 1) * (uint64_t)GetNumberOfNodes();
-    return static_cast<EdgeID>(m_matrix.rank(min(idx, m_matrix.size())));
+    size_t const i = FindCachedNode(n);
+    return i < m_cachedNodes.size() ? GetCachedEnd(i) : DecodeEndEdges(n);
   }
 
   EdgeRange GetAdjacentEdgeRange(const NodeID node) const override
@@ -253,6 +445,13 @@ public:
 };
 
 
+// static
+template <class EdgeDataT>
+uint32_t const OsrmRawDataFacade<EdgeDataT>::kEdgesBlockBits;
+// static
+template <class EdgeDataT>
+uint32_t const OsrmRawDataFacade<EdgeDataT>::kNoCachedNode;
+
 template <class EdgeDataT> class OsrmDataFacade : public OsrmRawDataFacade<EdgeDataT>
 {
   typedef OsrmRawDataFacade<EdgeDataT> super;
@@ -272,22 +471,37 @@ public:
   {
     Clear();
 
-    m_handleEdgeData.Assign(container.Map(ROUTING_EDGEDATA_FILE_TAG));
+    // The succinct structures are read at random by the route search, the readahead only
+    // evicts the useful pages.
+    auto const map = [&container](string const & tag)
+    {
+      return container.Map(tag, mmap_policy::Get(tag, mmap_policy::Random));
+    };
+
+    m_handleEdgeData.Assign(map(ROUTING_EDGEDATA_FILE_TAG));
     ASSERT(m_handleEdgeData.IsValid(), ());
 
-    m_handleEdgeId.Assign(container.Map(ROUTING_EDGEID_FILE_TAG));
+    m_handleEdgeId.Assign(map(ROUTING_EDGEID_FILE_TAG));
     ASSERT(m_handleEdgeId.IsValid(), ());
 
-    m_handleShortcuts.Assign(container.Map(ROUTING_SHORTCUTS_FILE_TAG));
+    m_handleShortcuts.Assign(map(ROUTING_SHORTCUTS_FILE_TAG));
     ASSERT(m_handleShortcuts.IsValid(), ());
 
-    m_handleFanoMatrix.Assign(container.Map(ROUTING_MATRIX_FILE_TAG));
+    m_handleFanoMatrix.Assign(map(ROUTING_MATRIX_FILE_TAG));
     ASSERT(m_handleFanoMatrix.IsValid(), ());
 
     LoadRawData(m_handleEdgeData.GetData<char>(), m_handleEdgeId.GetData<char>(), m_handleShortcuts.GetData<char>(), m_handleFanoMatrix.GetData<char>());
 
   }
 
+  /// @return Size of the mapped sections and of the adjacency cache. The sections are
+  /// mapped in place, so it's the upper bound of the resident memory of the facade.
+  uint64_t GetMemorySize() const
+  {
+    return m_handleEdgeData.GetSize() + m_handleEdgeId.GetSize() + m_handleShortcuts.GetSize() +
+           m_handleFanoMatrix.GetSize() + super::GetAdjacencyCacheBytes();
+  }
+
   void Clear()
   {
     ClearRawData();
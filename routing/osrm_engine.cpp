@@ -2,8 +2,12 @@
 #include "osrm2feature_map.hpp"
 
 #include "base/logging.hpp"
+#include "base/task_scheduler.hpp"
 #include "base/timer.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+
 #include "3party/osrm/osrm-backend/data_structures/internal_route_result.hpp"
 #include "3party/osrm/osrm-backend/data_structures/search_engine_data.hpp"
 #include "3party/osrm/osrm-backend/routing_algorithms/n_to_m_many_to_many.hpp"
@@ -50,12 +54,151 @@ void FindWeightsMatrix(TRoutingNodes const & sources, TRoutingNodes const & targ
   result.swap(*resultTable);
 }
 
+namespace
+{
+/// Finds the shortest path of one leg as ShortestPathRouting does, but the searches to the
+/// forward and the reverse node of the target run concurrently. They use the different heaps
+/// of SearchEngineData and share the weight of the best path found by any of them.
+template <class DataFacadeT>
+class ParallelShortestPathRouting final
+    : public BasicRoutingInterface<DataFacadeT, ParallelShortestPathRouting<DataFacadeT>>
+{
+  using TBase = BasicRoutingInterface<DataFacadeT, ParallelShortestPathRouting<DataFacadeT>>;
+  using TQueryHeap = SearchEngineData::QueryHeap;
+
+public:
+  ParallelShortestPathRouting(DataFacadeT * facade, SearchEngineData & engineData)
+    : TBase(facade), m_engineData(engineData)
+  {
+  }
+
+  void operator()(PhantomNodes const & nodes, InternalRouteResult & result) const
+  {
+    unsigned const nodesCount = TBase::facade->GetNumberOfNodes();
+    m_engineData.InitializeOrClearFirstThreadLocalStorage(nodesCount);
+    m_engineData.InitializeOrClearSecondThreadLocalStorage(nodesCount);
+
+    Search searches[2] = {{*m_engineData.forward_heap_1, *m_engineData.reverse_heap_1},
+                          {*m_engineData.forward_heap_2, *m_engineData.reverse_heap_2}};
+    PhantomNode const & source = nodes.source_phantom;
+    PhantomNode const & target = nodes.target_phantom;
+    for (Search & search : searches)
+    {
+      if (source.forward_node_id != SPECIAL_NODEID)
+      {
+        search.m_forward.Insert(source.forward_node_id, -source.GetForwardWeightPlusOffset(),
+                                source.forward_node_id);
+      }
+      if (source.reverse_node_id != SPECIAL_NODEID)
+      {
+        search.m_forward.Insert(source.reverse_node_id, -source.GetReverseWeightPlusOffset(),
+                                source.reverse_node_id);
+      }
+    }
+    if (target.forward_node_id != SPECIAL_NODEID)
+    {
+      searches[0].m_reverse.Insert(target.forward_node_id, target.GetForwardWeightPlusOffset(),
+                                   target.forward_node_id);
+    }
+    if (target.reverse_node_id != SPECIAL_NODEID)
+    {
+      searches[1].m_reverse.Insert(target.reverse_node_id, target.GetReverseWeightPlusOffset(),
+                                   target.reverse_node_id);
+    }
+
+    int const minEdgeOffset =
+        min(source.GetForwardWeightPlusOffset(), source.GetReverseWeightPlusOffset());
+    atomic<int> bestWeight(INVALID_EDGE_WEIGHT);
+    {
+      threads::TaskGroup group;
+      if (!searches[1].m_reverse.Empty())
+      {
+        group.Run([&]() { Run(searches[1], minEdgeOffset, bestWeight); });
+      }
+      Run(searches[0], minEdgeOffset, bestWeight);
+      group.Wait();
+    }
+
+    // Each search keeps only the paths which beat the shared weight, so the lighter one of them
+    // is the shortest path.
+    Search const & best = searches[1].m_weight < searches[0].m_weight ? searches[1] : searches[0];
+    if (best.m_weight == INVALID_EDGE_WEIGHT)
+    {
+      result.shortest_path_length = INVALID_EDGE_WEIGHT;
+      result.alternative_path_length = INVALID_EDGE_WEIGHT;
+      return;
+    }
+
+    vector<NodeID> packedPath;
+    TBase::RetrievePackedPathFromHeap(best.m_forward, best.m_reverse, best.m_middle, packedPath);
+    result.unpacked_path_segments.resize(1);
+    TBase::UnpackPath(packedPath, nodes, result.unpacked_path_segments.front());
+    result.source_traversed_in_reverse.push_back(packedPath.front() != source.forward_node_id);
+    result.target_traversed_in_reverse.push_back(packedPath.back() != target.forward_node_id);
+    result.shortest_path_length = best.m_weight;
+  }
+
+private:
+  struct Search
+  {
+    Search(TQueryHeap & forward, TQueryHeap & reverse)
+      : m_forward(forward), m_reverse(reverse), m_middle(SPECIAL_NODEID),
+        m_weight(INVALID_EDGE_WEIGHT)
+    {
+    }
+
+    TQueryHeap & m_forward;
+    TQueryHeap & m_reverse;
+    NodeID m_middle;
+    /// Weight of the path through m_middle, it's found only when it beats the shared weight.
+    int m_weight;
+  };
+
+  void Run(Search & search, int minEdgeOffset, atomic<int> & bestWeight) const
+  {
+    while (0 < search.m_forward.Size() + search.m_reverse.Size())
+    {
+      if (!search.m_forward.Empty())
+        Step(search, search.m_forward, search.m_reverse, true, minEdgeOffset, bestWeight);
+      if (!search.m_reverse.Empty())
+        Step(search, search.m_reverse, search.m_forward, false, minEdgeOffset, bestWeight);
+    }
+  }
+
+  void Step(Search & search, TQueryHeap & heap, TQueryHeap & otherHeap, bool forward,
+            int minEdgeOffset, atomic<int> & bestWeight) const
+  {
+    // RoutingStep updates the middle node only with the weight below the bound.
+    int const bound = min(search.m_weight, bestWeight.load(memory_order_relaxed));
+    int weight = bound;
+    TBase::RoutingStep(heap, otherHeap, &search.m_middle, &weight, minEdgeOffset, forward);
+    if (weight >= bound)
+      return;
+
+    search.m_weight = weight;
+    int shared = bestWeight.load(memory_order_relaxed);
+    while (weight < shared && !bestWeight.compare_exchange_weak(shared, weight))
+    {
+    }
+  }
+
+  SearchEngineData & m_engineData;
+};
+}  // namespace
+
+SingleRouteSearchMode GetDefaultSingleRouteSearchMode()
+{
+  return threads::TaskScheduler::Instance().GetThreadsCount() > 1
+             ? SingleRouteSearchMode::Parallel
+             : SingleRouteSearchMode::Sequential;
+}
+
 bool FindSingleRoute(FeatureGraphNode const & source, FeatureGraphNode const & target,
-                     TRawDataFacade & facade, RawRoutingResult & rawRoutingResult)
+                     TRawDataFacade & facade, RawRoutingResult & rawRoutingResult,
+                     SingleRouteSearchMode mode)
 {
   SearchEngineData engineData;
   InternalRouteResult result;
-  ShortestPathRouting<TRawDataFacade> pathFinder(&facade, engineData);
   PhantomNodes nodes;
   nodes.source_phantom = source.node;
   nodes.target_phantom = target.node;
@@ -66,7 +209,16 @@ bool FindSingleRoute(FeatureGraphNode const & source, FeatureGraphNode const & t
        nodes.target_phantom.reverse_node_id != INVALID_NODE_ID))
   {
     result.segment_end_coordinates.push_back(nodes);
-    pathFinder({nodes}, {}, result);
+    if (mode == SingleRouteSearchMode::Parallel)
+    {
+      ParallelShortestPathRouting<TRawDataFacade> pathFinder(&facade, engineData);
+      pathFinder(nodes, result);
+    }
+    else
+    {
+      ShortestPathRouting<TRawDataFacade> pathFinder(&facade, engineData);
+      pathFinder({nodes}, {}, result);
+    }
   }
 
   if (IsRouteExist(result))
@@ -86,14 +86,30 @@ using TRawDataFacade = OsrmRawDataFacade<QueryEdge::EdgeData>;
 void FindWeightsMatrix(TRoutingNodes const & sources, TRoutingNodes const & targets,
                        TRawDataFacade & facade, vector<EdgeWeight> & result);
 
+/// Modes of the search of FindSingleRoute(). The route to the target node is searched for
+/// both directions of the target road, by a bidirectional CH search for each direction.
+enum class SingleRouteSearchMode
+{
+  /// The searches run one after another on the calling thread.
+  Sequential,
+  /// The searches run concurrently on the calling thread and on the task scheduler, they share
+  /// the weight of the best route found, so each search stops as soon as it can't beat it.
+  Parallel
+};
+
+/// @return Parallel when the task scheduler has more than one worker, Sequential otherwise.
+SingleRouteSearchMode GetDefaultSingleRouteSearchMode();
+
 /*! Find single shortest path in a single MWM between 2 OSRM nodes
    * \param source Source OSRM graph node to make path.
    * \param taget Target OSRM graph node to make path.
    * \param facade OSRM routing data facade to recover graph information.
    * \param rawRoutingResult Routing result structure.
+   * \param mode Mode of the search, both modes find the same weight of the route.
    * \return true when path exists, false otherwise.
    */
 bool FindSingleRoute(FeatureGraphNode const & source, FeatureGraphNode const & target,
-                     TRawDataFacade & facade, RawRoutingResult & rawRoutingResult);
+                     TRawDataFacade & facade, RawRoutingResult & rawRoutingResult,
+                     SingleRouteSearchMode mode = SingleRouteSearchMode::Sequential);
 
 }  // namespace routing
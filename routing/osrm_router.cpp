@@ -3,6 +3,7 @@
 #include "online_cross_fetcher.hpp"
 #include "osrm2feature_map.hpp"
 #include "osrm_router.hpp"
+#include "road_segments_index.hpp"
 #include "turns_generator.hpp"
 
 #include "platform/country_file.hpp"
@@ -23,10 +24,16 @@
 #include "base/math.hpp"
 #include "base/scope_guard.hpp"
 #include "base/timer.hpp"
+#include "base/tracing.hpp"
 
 #include "std/algorithm.hpp"
+#include "std/function.hpp"
 #include "std/limits.hpp"
+#include "std/map.hpp"
 #include "std/string.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
 
 #include "3party/osrm/osrm-backend/data_structures/query_edge.hpp"
 #include "3party/osrm/osrm-backend/data_structures/internal_route_result.hpp"
@@ -50,6 +57,9 @@ double constexpr kMwmLoadedProgress = 10.0f;
 double constexpr kPointsFoundProgress = 15.0f;
 double constexpr kCrossPathFoundProgress = 50.0f;
 double constexpr kPathFoundProgress = 70.0f;
+double constexpr kSecondsPerNano = 1e-9;
+// Number of route nodes annotated by one task of the index query pool.
+size_t constexpr kAnnotationChunkSize = 64;
 } //  namespace
 // TODO (ldragunov) Switch all RawRouteData and incapsulate to own omim types.
 using RawRouteData = InternalRouteResult;
@@ -73,8 +83,19 @@ public:
     uint32_t m_segIdx;
     uint32_t m_fid;
     m2::PointD m_point;
-
-    Candidate() : m_dist(numeric_limits<double>::max()), m_fid(kInvalidFid) {}
+    /// Vector from the first point of the segment to the second one.
+    m2::PointD m_segmentDirection;
+    /// Nodes are known for the candidates of the road segments index only.
+    TOsrmNodeId m_forwardNodeId;
+    TOsrmNodeId m_reverseNodeId;
+
+    Candidate()
+      : m_dist(numeric_limits<double>::max()),
+        m_fid(kInvalidFid),
+        m_forwardNodeId(INVALID_NODE_ID),
+        m_reverseNodeId(INVALID_NODE_ID)
+    {
+    }
   };
 
   static void FindNearestSegment(FeatureType const & ft, m2::PointD const & point, Candidate & res)
@@ -97,6 +118,7 @@ public:
         res.m_fid = featureId;
         res.m_segIdx = static_cast<uint32_t>(i - 1);
         res.m_point = pt;
+        res.m_segmentDirection = ft.GetPoint(i) - ft.GetPoint(i - 1);
       }
     }
   }
@@ -129,6 +151,31 @@ public:
       m_candidates.push_back(res);
   }
 
+  /// Takes the candidates from the road segments index of the mwm instead of the features,
+  /// their nodes are taken from the index too.
+  void FindCandidates(RoadSegmentsIndex const & index, MwmSet::MwmId const & mwmId,
+                      double maxDistance, size_t maxCount)
+  {
+    m_mwmId = mwmId;
+    m_nodesFromIndex = true;
+
+    vector<RoadSegmentsIndex::Projection> projections;
+    index.FindNearest(m_point, maxDistance, maxCount, projections);
+    for (RoadSegmentsIndex::Projection const & projection : projections)
+    {
+      RoadSegmentsIndex::Segment const & segment = projection.m_segment;
+      Candidate res;
+      res.m_dist = projection.m_squaredDistance;
+      res.m_fid = segment.m_seg.m_fid;
+      res.m_segIdx = segment.m_seg.m_pointStart;
+      res.m_point = projection.m_point;
+      res.m_segmentDirection = segment.m_p2 - segment.m_p1;
+      res.m_forwardNodeId = segment.m_forwardNodeId;
+      res.m_reverseNodeId = segment.m_reverseNodeId;
+      m_candidates.push_back(res);
+    }
+  }
+
   double CalculateDistance(OsrmMappingTypes::FtSeg const & s) const
   {
     ASSERT_NOT_EQUAL(s.m_pointStart, s.m_pointEnd, ());
@@ -295,7 +342,18 @@ public:
     }
 
     OsrmFtSegMapping::OsrmNodesT nodes;
-    m_mapping.GetOsrmNodes(segmentSet, nodes);
+    if (m_nodesFromIndex)
+    {
+      for (size_t j = 0; j < n; ++j)
+      {
+        Candidate const & c = m_candidates[j];
+        nodes.insert({segments[j].Store(), {c.m_forwardNodeId, c.m_reverseNodeId}});
+      }
+    }
+    else
+    {
+      m_mapping.GetOsrmNodes(segmentSet, nodes);
+    }
 
     res.clear();
     res.resize(maxCount);
@@ -316,12 +374,7 @@ public:
       if (!m_direction.IsAlmostZero())
       {
         // Filter income nodes by direction mode
-        OsrmMappingTypes::FtSeg const & node_seg = segments[idx];
-        FeatureType feature;
-        Index::FeaturesLoaderGuard loader(*m_pIndex, m_mwmId);
-        loader.GetFeatureByIndex(node_seg.m_fid, feature);
-        feature.ParseGeometry(FeatureType::BEST_GEOMETRY);
-        m2::PointD const featureDirection = feature.GetPoint(node_seg.m_pointEnd) - feature.GetPoint(node_seg.m_pointStart);
+        m2::PointD const & featureDirection = m_candidates[j].m_segmentDirection;
         bool const sameDirection = (m2::DotProduct(featureDirection, m_direction) / (featureDirection.Length() * m_direction.Length()) > 0);
         if (sameDirection)
         {
@@ -361,9 +414,146 @@ private:
   MwmSet::MwmId m_mwmId;
   Index const * m_pIndex;
   TDataFacade const & m_dataFacade;
+  bool m_nodesFromIndex = false;
 
   DISALLOW_COPY(Point2PhantomNode);
 };
+/// Turn and geometry of a single node of the route. Annotations of the nodes don't depend on
+/// each other, so they're made concurrently and are stitched in the route order afterwards.
+struct NodeAnnotation
+{
+  /// Turn from the previous node of the path segment, it isn't made for the first node.
+  turns::TurnItem m_turn;
+  /// Geometry of the node, it's empty when the node geometry isn't put out.
+  vector<m2::PointD> m_points;
+  /// Time to pass the geometry, it's calculated for the first and the last nodes only.
+  double m_time = 0.0;
+  /// Ratio of the time to pass the node with the traffic to the time without it.
+  double m_trafficFactor = 1.0;
+};
+
+void MakeNodeAnnotation(Index const & index, RoutingMapping & mapping,
+                        RawRoutingResult const & routingResult,
+                        vector<RawPathData> const & pathSegments, size_t segmentIndex,
+                        CarModel const & carModel, TrafficInfo const * traffic,
+                        Index::FeaturesLoaderGuard & loader, NodeAnnotation & annotation)
+{
+  typedef OsrmMappingTypes::FtSeg TSeg;
+  TSeg const & segBegin = routingResult.sourceEdge.segment;
+  TSeg const & segEnd = routingResult.targetEdge.segment;
+
+  size_t const numSegments = pathSegments.size();
+  RawPathData const & pathData = pathSegments[segmentIndex];
+
+  if (segmentIndex > 0)
+  {
+    turns::TurnInfo turnInfo(mapping, pathSegments[segmentIndex - 1].node, pathData.node);
+    turns::GetTurnDirection(index, turnInfo, annotation.m_turn);
+
+    //  Lane information.
+    if (annotation.m_turn.m_turn != turns::TurnDirection::NoTurn)
+    {
+      annotation.m_turn.m_lanes =
+          turns::GetIngoingLanesInfo(pathSegments[segmentIndex - 1].node, mapping, index);
+    }
+  }
+
+  buffer_vector<TSeg, 8> buffer;
+  mapping.m_segMapping.ForEachFtSeg(pathData.node, MakeBackInsertFunctor(buffer));
+
+  auto FindIntersectingSeg = [&buffer] (TSeg const & seg) -> size_t
+  {
+    ASSERT(seg.IsValid(), ());
+    auto const it = find_if(buffer.begin(), buffer.end(), [&seg] (OsrmMappingTypes::FtSeg const & s)
+    {
+      return s.IsIntersect(seg);
+    });
+
+    ASSERT(it != buffer.end(), ());
+    return distance(buffer.begin(), it);
+  };
+
+  //Do not put out node geometry (we do not have it)!
+  size_t startK = 0, endK = buffer.size();
+  if (segmentIndex == 0)
+  {
+    if (!segBegin.IsValid())
+      return;
+    startK = FindIntersectingSeg(segBegin);
+  }
+  if (segmentIndex + 1 == numSegments)
+  {
+    if (!segEnd.IsValid())
+      return;
+    endK = FindIntersectingSeg(segEnd) + 1;
+  }
+
+  vector<m2::PointD> & points = annotation.m_points;
+  double & estimatedTime = annotation.m_time;
+  // Lengths of the geometry without and with the traffic, which divides lengths by the factors.
+  double length = 0.0;
+  double trafficLength = 0.0;
+  for (size_t k = startK; k < endK; ++k)
+  {
+    TSeg const & seg = buffer[k];
+
+    FeatureType ft;
+    loader.GetFeatureByIndex(seg.m_fid, ft);
+    ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+
+    auto startIdx = seg.m_pointStart;
+    auto endIdx = seg.m_pointEnd;
+    bool const needTime = (segmentIndex == 0) || (segmentIndex == numSegments - 1);
+
+    if (segmentIndex == 0 && k == startK && segBegin.IsValid())
+      startIdx = (seg.m_pointEnd > seg.m_pointStart) ? segBegin.m_pointStart : segBegin.m_pointEnd;
+    if (segmentIndex == numSegments - 1 && k == endK - 1 && segEnd.IsValid())
+      endIdx = (seg.m_pointEnd > seg.m_pointStart) ? segEnd.m_pointEnd : segEnd.m_pointStart;
+
+    // Slowness of the segment from the point idx - 1 to the point idx.
+    auto const getTrafficFactor = [&](size_t idx, bool forward) -> double
+    {
+      if (!traffic)
+        return 1.0;
+      return 1.0 / traffic->GetSpeedFactor(TrafficInfo::RoadSegmentId(
+                       seg.m_fid, static_cast<uint32_t>(idx - 1), forward));
+    };
+    auto const addTime = [&](size_t idx, bool forward)
+    {
+      if (!needTime && !traffic)
+        return;
+      double const distance =
+          MercatorBounds::DistanceOnEarth(ft.GetPoint(idx - 1), ft.GetPoint(idx));
+      double const factor = getTrafficFactor(idx, forward);
+      if (needTime)
+        estimatedTime += distance * factor / carModel.GetSpeed(ft);
+      length += distance;
+      trafficLength += distance * factor;
+    };
+
+    if (seg.m_pointEnd > seg.m_pointStart)
+    {
+      for (auto idx = startIdx; idx <= endIdx; ++idx)
+      {
+        points.push_back(ft.GetPoint(idx));
+        if (idx > startIdx)
+          addTime(idx, true /* forward */);
+      }
+    }
+    else
+    {
+      for (auto idx = startIdx; idx > endIdx; --idx)
+      {
+        addTime(idx, false /* forward */);
+        points.push_back(ft.GetPoint(idx));
+      }
+      points.push_back(ft.GetPoint(endIdx));
+    }
+  }
+
+  if (length > 0.0)
+    annotation.m_trafficFactor = trafficLength / length;
+}
 } // namespace
 
 // static
@@ -380,6 +570,49 @@ OsrmRouter::OsrmRouter(Index * index, TCountryFileFn const & countryFileFn)
 {
 }
 
+OsrmRouter::~OsrmRouter()
+{
+  if (!m_routeCacheFile.empty())
+    m_routeCache.SaveToFile(m_routeCacheFile);
+}
+
+void OsrmRouter::SetRouteCacheFile(string const & path)
+{
+  m_routeCacheFile = path;
+  if (!path.empty() && m_routeCache.LoadFromFile(path))
+    LOG(LINFO, ("Route cache is loaded,", m_routeCache.GetSize(), "routes."));
+}
+
+int64_t OsrmRouter::GetMwmVersion(string const & name) const
+{
+  MwmSet::MwmId const id = m_pIndex->GetMwmIdByCountryFile(platform::CountryFile(name));
+  if (!id.IsAlive())
+    return RouteCache::kInvalidVersion;
+  return id.GetInfo()->GetVersion();
+}
+
+RouteCache::Key OsrmRouter::MakeRouteCacheKey(TRoutingMappingPtr const & startMapping,
+                                              TRoutingMappingPtr const & targetMapping,
+                                              TFeatureGraphNodeVec const & source,
+                                              TFeatureGraphNodeVec const & target) const
+{
+  RouteCache::Key key;
+  for (auto const & mapping : {startMapping, targetMapping})
+    key.m_mwms.emplace_back(mapping->GetCountryName(), GetMwmVersion(mapping->GetCountryName()));
+
+  for (auto const * nodes : {&source, &target})
+  {
+    key.m_nodes.push_back(nodes->size());
+    for (FeatureGraphNode const & node : *nodes)
+    {
+      key.m_nodes.push_back(node.node.forward_node_id);
+      key.m_nodes.push_back(node.node.reverse_node_id);
+      key.m_nodes.push_back(node.segment.Store());
+    }
+  }
+  return key;
+}
+
 string OsrmRouter::GetName() const
 {
   return "vehicle";
@@ -387,6 +620,11 @@ string OsrmRouter::GetName() const
 
 void OsrmRouter::ClearState()
 {
+  for (auto const & loadTimes : m_indexManager.GetLoadTimes())
+    LOG(LDEBUG, ("Routing facade load times of", loadTimes.first, DebugPrint(loadTimes.second)));
+  for (auto const & usage : m_indexManager.GetMemoryUsage())
+    LOG(LDEBUG, ("Routing facade memory of", usage.first, usage.second));
+
   m_cachedTargets.clear();
   m_cachedTargetPoint = m2::PointD::Zero();
   m_indexManager.Clear();
@@ -394,12 +632,12 @@ void OsrmRouter::ClearState()
 
 bool OsrmRouter::FindRouteFromCases(TFeatureGraphNodeVec const & source,
                                     TFeatureGraphNodeVec const & target, TDataFacade & facade,
-                                    RawRoutingResult & rawRoutingResult)
+                                    RawRoutingResult & rawRoutingResult) const
 {
   /// @todo (ldargunov) make more complex nearest edge turnaround
   for (auto const & targetEdge : target)
     for (auto const & sourceEdge : source)
-      if (FindSingleRoute(sourceEdge, targetEdge, facade, rawRoutingResult))
+      if (FindSingleRoute(sourceEdge, targetEdge, facade, rawRoutingResult, m_searchMode))
         return true;
   return false;
 }
@@ -508,12 +746,16 @@ OsrmRouter::ResultCode OsrmRouter::MakeRouteFromCrossesPath(TCheckedPath const &
     RawRoutingResult routingResult;
     TRoutingMappingPtr mwmMapping = m_indexManager.GetMappingByName(cross.startNode.mwmName);
     ASSERT(mwmMapping->IsValid(), ());
+    m_indexManager.Pin(mwmMapping);
     MappingGuard mwmMappingGuard(mwmMapping);
     UNUSED_VALUE(mwmMappingGuard);
     CalculatePhantomNodeForCross(mwmMapping, cross.startNode, m_pIndex, true /* forward */);
     CalculatePhantomNodeForCross(mwmMapping, cross.finalNode, m_pIndex, false /* forward */);
-    if (!FindSingleRoute(cross.startNode, cross.finalNode, mwmMapping->m_dataFacade, routingResult))
+    if (!FindSingleRoute(cross.startNode, cross.finalNode, mwmMapping->m_dataFacade, routingResult,
+                         m_searchMode))
+    {
       return OsrmRouter::RouteNotFound;
+    }
 
     if (!Points.empty())
     {
@@ -562,8 +804,10 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
                                                   m2::PointD const & finalPoint,
                                                   RouterDelegate const & delegate, Route & route)
 {
+  TRACE_SCOPE("routing", "OsrmRouter::CalculateRoute");
   my::HighResTimer timer(true);
-  m_indexManager.Clear();  // TODO (Dragunov) make proper index manager cleaning
+  m_lastTimings = RouteTimings();
+  m_indexManager.ReleaseUnused();
 
   TRoutingMappingPtr startMapping = m_indexManager.GetMappingByPoint(startPoint);
   TRoutingMappingPtr targetMapping = m_indexManager.GetMappingByPoint(finalPoint);
@@ -589,11 +833,14 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
     return IRouter::EndPointNotFound;
   }
 
+  m_indexManager.Pin(startMapping);
+  m_indexManager.Pin(targetMapping);
   MappingGuard startMappingGuard(startMapping);
   MappingGuard finalMappingGuard(targetMapping);
   UNUSED_VALUE(startMappingGuard);
   UNUSED_VALUE(finalMappingGuard);
   LOG(LINFO, ("Duration of the MWM loading", timer.ElapsedNano()));
+  m_lastTimings.m_dataLoadSec = timer.ElapsedNano() * kSecondsPerNano;
   timer.Reset();
 
   delegate.OnProgress(kMwmLoadedProgress);
@@ -621,9 +868,21 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
   INTERRUPT_WHEN_CANCELLED(delegate);
 
   LOG(LINFO, ("Duration of the start/stop points lookup", timer.ElapsedNano()));
+  m_lastTimings.m_pointsLookupSec = timer.ElapsedNano() * kSecondsPerNano;
   timer.Reset();
   delegate.OnProgress(kPointsFoundProgress);
 
+  RouteCache::Key const cacheKey =
+      MakeRouteCacheKey(startMapping, targetMapping, startTask, m_cachedTargets);
+  auto const versionFn = [this](string const & name) { return GetMwmVersion(name); };
+  // Times of the routes with the traffic expire with the traffic, so they aren't cached.
+  bool const useRouteCache = (m_traffic == nullptr);
+  if (useRouteCache && m_routeCache.Get(cacheKey, versionFn, route))
+  {
+    LOG(LINFO, ("Route is taken from the cache", timer.ElapsedNano()));
+    return NoError;
+  }
+
   // 4. Find route.
   RawRoutingResult routingResult;
 
@@ -640,6 +899,8 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
     {
       return RouteNotFound;
     }
+    m_lastTimings.m_searchSec = timer.ElapsedNano() * kSecondsPerNano;
+    timer.Reset();
     INTERRUPT_WHEN_CANCELLED(delegate);
     delegate.OnProgress(kPathFoundProgress);
 
@@ -654,7 +915,10 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
     route.SetGeometry(points.begin(), points.end());
     route.SetTurnInstructions(turnsDir);
     route.SetSectionTimes(times);
+    m_lastTimings.m_postProcessingSec = timer.ElapsedNano() * kSecondsPerNano;
 
+    if (useRouteCache)
+      m_routeCache.Put(cacheKey, {cacheKey.m_mwms.front()}, route);
     return NoError;
   }
   else //4.2 Multiple mwm case
@@ -662,7 +926,8 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
     LOG(LINFO, ("Multiple mwm routing case"));
     TCheckedPath finalPath;
     ResultCode code = CalculateCrossMwmPath(startTask, m_cachedTargets, m_indexManager, delegate,
-                                            finalPath);
+                                            finalPath, GetCrossMwmOverlay());
+    m_lastTimings.m_searchSec = timer.ElapsedNano() * kSecondsPerNano;
     timer.Reset();
     INTERRUPT_WHEN_CANCELLED(delegate);
     delegate.OnProgress(kCrossPathFoundProgress);
@@ -677,13 +942,209 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
                                       indexPair.second->FreeCrossContext();
                                     });
       LOG(LINFO, ("Make final route", timer.ElapsedNano()));
+      m_lastTimings.m_postProcessingSec = timer.ElapsedNano() * kSecondsPerNano;
       timer.Reset();
+
+      if (code == NoError && useRouteCache)
+      {
+        RouteCache::TMwmVersions mwms;
+        for (RoutePathCross const & cross : finalPath)
+        {
+          string const & name = cross.startNode.mwmName;
+          if (mwms.empty() || mwms.back().first != name)
+            mwms.emplace_back(name, GetMwmVersion(name));
+        }
+        m_routeCache.Put(cacheKey, mwms, route);
+      }
       return code;
     }
     return OsrmRouter::RouteNotFound;
   }
 }
 
+OsrmRouter::ResultCode OsrmRouter::CalculateWeightsMatrix(vector<m2::PointD> const & sources,
+                                                          vector<m2::PointD> const & targets,
+                                                          RouterDelegate const & delegate,
+                                                          vector<double> & weights)
+{
+  my::HighResTimer timer(true);
+  m_indexManager.ReleaseUnused();
+  weights.assign(sources.size() * targets.size(), kInvalidWeight);
+
+  // Points which can't be snapped to roads have empty nodes and no routes.
+  struct SnappedPoint
+  {
+    TRoutingMappingPtr m_mapping;
+    TFeatureGraphNodeVec m_nodes;
+  };
+
+  vector<unique_ptr<MappingGuard>> guards;
+  auto const snapPoints = [&](vector<m2::PointD> const & points, vector<SnappedPoint> & snapped)
+  {
+    snapped.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      TRoutingMappingPtr mapping = m_indexManager.GetMappingByPoint(points[i]);
+      if (!mapping->IsValid())
+        continue;
+      m_indexManager.Pin(mapping);
+      // Every guard holds the mapping for the whole table calculation.
+      guards.emplace_back(new MappingGuard(mapping));
+      if (FindPhantomNodes(points[i], m2::PointD::Zero(), snapped[i].m_nodes,
+                           kMaxNodeCandidatesCount, mapping) == NoError)
+      {
+        snapped[i].m_mapping = mapping;
+      }
+    }
+  };
+
+  vector<SnappedPoint> snappedSources;
+  vector<SnappedPoint> snappedTargets;
+  snapPoints(sources, snappedSources);
+  snapPoints(targets, snappedTargets);
+  INTERRUPT_WHEN_CANCELLED(delegate);
+  LOG(LINFO, ("Duration of the matrix points lookup", timer.ElapsedNano()));
+  timer.Reset();
+
+  // Indices of the snapped sources and targets of every mwm.
+  map<string, pair<vector<size_t>, vector<size_t>>> mwmPoints;
+  for (size_t i = 0; i < snappedSources.size(); ++i)
+  {
+    if (snappedSources[i].m_mapping)
+      mwmPoints[snappedSources[i].m_mapping->GetCountryName()].first.push_back(i);
+  }
+  for (size_t j = 0; j < snappedTargets.size(); ++j)
+  {
+    if (snappedTargets[j].m_mapping)
+      mwmPoints[snappedTargets[j].m_mapping->GetCountryName()].second.push_back(j);
+  }
+
+  // Pairs of points in a single mwm.
+  for (auto const & mwm : mwmPoints)
+  {
+    vector<size_t> const & sourceIds = mwm.second.first;
+    vector<size_t> const & targetIds = mwm.second.second;
+    if (sourceIds.empty() || targetIds.empty())
+      continue;
+
+    TRoutingNodes sourceNodes;
+    TRoutingNodes targetNodes;
+    for (size_t const i : sourceIds)
+      sourceNodes.push_back(snappedSources[i].m_nodes.front());
+    for (size_t const j : targetIds)
+      targetNodes.push_back(snappedTargets[j].m_nodes.front());
+
+    vector<EdgeWeight> table;
+    FindWeightsMatrix(sourceNodes, targetNodes,
+                      snappedSources[sourceIds.front()].m_mapping->m_dataFacade, table);
+    for (size_t i = 0; i < sourceIds.size(); ++i)
+    {
+      for (size_t j = 0; j < targetIds.size(); ++j)
+      {
+        EdgeWeight const weight = table[i * targetIds.size() + j];
+        if (weight != INVALID_EDGE_WEIGHT)
+          weights[sourceIds[i] * targets.size() + targetIds[j]] = weight / 10.0;
+      }
+    }
+    INTERRUPT_WHEN_CANCELLED(delegate);
+  }
+  LOG(LINFO, ("Duration of the single mwm matrix calculation", timer.ElapsedNano()));
+  timer.Reset();
+
+  // Pairs of points in different mwms.
+  for (size_t i = 0; i < snappedSources.size(); ++i)
+  {
+    SnappedPoint const & source = snappedSources[i];
+    if (!source.m_mapping)
+      continue;
+    for (size_t j = 0; j < snappedTargets.size(); ++j)
+    {
+      SnappedPoint const & target = snappedTargets[j];
+      if (!target.m_mapping || target.m_mapping->GetMwmId() == source.m_mapping->GetMwmId())
+        continue;
+
+      TCheckedPath path;
+      ResultCode const code =
+          CalculateCrossMwmPath(source.m_nodes, target.m_nodes, m_indexManager, delegate, path,
+                                GetCrossMwmOverlay());
+      INTERRUPT_WHEN_CANCELLED(delegate);
+      if (code != NoError)
+        continue;
+
+      EdgeWeight weight = 0;
+      for (RoutePathCross const & cross : path)
+      {
+        TRoutingMappingPtr mwmMapping = m_indexManager.GetMappingByName(cross.startNode.mwmName);
+        ASSERT(mwmMapping->IsValid(), ());
+        // Only the weight is needed, so the route isn't unpacked to the features.
+        FacadeGuard mwmFacadeGuard(mwmMapping);
+        UNUSED_VALUE(mwmFacadeGuard);
+
+        RawRoutingResult routingResult;
+        if (!FindSingleRoute(cross.startNode, cross.finalNode, mwmMapping->m_dataFacade,
+                             routingResult, m_searchMode))
+        {
+          weight = INVALID_EDGE_WEIGHT;
+          break;
+        }
+        weight += routingResult.shortestPathLength;
+      }
+      if (weight != INVALID_EDGE_WEIGHT)
+        weights[i * targets.size() + j] = weight / 10.0;
+    }
+  }
+  m_indexManager.ForEachMapping([](pair<string, TRoutingMappingPtr> const & indexPair)
+                                {
+                                  indexPair.second->FreeCrossContext();
+                                });
+  LOG(LINFO, ("Duration of the cross mwm matrix calculation", timer.ElapsedNano()));
+
+  return NoError;
+}
+
+bool OsrmRouter::EstimateCrossMwmCountries(string const & startCountry,
+                                           string const & finalCountry, vector<string> & countries)
+{
+  countries.clear();
+  CrossMwmOverlay const * overlay = GetCrossMwmOverlay();
+  if (!overlay)
+    return false;
+
+  uint32_t const startMwm = overlay->FindMwm(startCountry);
+  uint32_t const finalMwm = overlay->FindMwm(finalCountry);
+  vector<uint32_t> mwms;
+  if (startMwm == CrossMwmOverlay::kInvalidIndex || finalMwm == CrossMwmOverlay::kInvalidIndex ||
+      !overlay->FindMwmsPath(startMwm, finalMwm, mwms))
+  {
+    return false;
+  }
+
+  for (uint32_t const mwm : mwms)
+    countries.push_back(overlay->GetMwmName(mwm));
+  return true;
+}
+
+CrossMwmOverlay const * OsrmRouter::GetCrossMwmOverlay()
+{
+  if (m_overlayLoaded)
+    return m_overlay.get();
+  m_overlayLoaded = true;
+
+  try
+  {
+    ReaderSource<ModelReaderPtr> src(GetPlatform().GetReader(CROSS_MWM_OVERLAY_FILE));
+    m_overlay.reset(new CrossMwmOverlay());
+    m_overlay->Deserialize(src);
+    LOG(LINFO, ("Cross mwm overlay is loaded for", m_overlay->GetMwmsCount(), "mwms"));
+  }
+  catch (RootException const & e)
+  {
+    m_overlay.reset();
+    LOG(LINFO, ("Cross mwm routing works without overlay:", e.Msg()));
+  }
+  return m_overlay.get();
+}
+
 IRouter::ResultCode OsrmRouter::FindPhantomNodes(m2::PointD const & point,
                                                  m2::PointD const & direction,
                                                  TFeatureGraphNodeVec & res, size_t maxCount,
@@ -693,9 +1154,18 @@ IRouter::ResultCode OsrmRouter::FindPhantomNodes(m2::PointD const & point,
   Point2PhantomNode getter(mapping->m_segMapping, m_pIndex, direction, mapping->m_dataFacade);
   getter.SetPoint(point);
 
-  m_pIndex->ForEachInRectForMWM(getter, MercatorBounds::RectByCenterXYAndSizeInMeters(
-                                            point, kFeatureFindingRectSideRadiusMeters),
-                                scales::GetUpperScale(), mapping->GetMwmId());
+  m2::RectD const rect =
+      MercatorBounds::RectByCenterXYAndSizeInMeters(point, kFeatureFindingRectSideRadiusMeters);
+  if (!mapping->m_segmentsIndex.IsEmpty())
+  {
+    double const maxDistance = max(rect.SizeX(), rect.SizeY()) / 2;
+    getter.FindCandidates(mapping->m_segmentsIndex, mapping->GetMwmId(), maxDistance, maxCount);
+  }
+  else
+  {
+    // Old routing files have no road segments index, all the roads around the point are decoded.
+    m_pIndex->ForEachInRectForMWM(getter, rect, scales::GetUpperScale(), mapping->GetMwmId());
+  }
 
   if (!getter.HasCandidates())
     return RouteNotFound;
@@ -717,134 +1187,85 @@ OsrmRouter::ResultCode OsrmRouter::MakeTurnAnnotation(
 {
   ASSERT(mapping, ());
 
-  typedef OsrmMappingTypes::FtSeg TSeg;
-  TSeg const & segBegin = routingResult.sourceEdge.segment;
-  TSeg const & segEnd = routingResult.targetEdge.segment;
-
   double estimatedTime = 0;
 
   LOG(LDEBUG, ("Shortest path length:", routingResult.shortestPathLength));
 
+  // Nodes are annotated by chunks on the index query pool, each chunk loads features
+  // by its own loader. Chunks are stitched in the route order.
+  vector<pair<size_t, size_t>> nodes;
+  for (size_t i = 0; i < routingResult.unpackedPathSegments.size(); ++i)
+  {
+    for (size_t j = 0; j < routingResult.unpackedPathSegments[i].size(); ++j)
+      nodes.emplace_back(i, j);
+  }
+
   //! @todo: Improve last segment time calculation
-  CarModel carModel;
+  CarModel const carModel;
+  // OSRM weights of the nodes are re-weighted by the traffic of their geometry.
+  shared_ptr<TrafficCache::TSnapshot const> const snapshot =
+      m_traffic ? m_traffic->GetSnapshot() : nullptr;
+  TrafficInfo const * traffic = nullptr;
+  if (snapshot)
+  {
+    auto const it = snapshot->find(mapping->GetMwmId());
+    if (it != snapshot->end())
+      traffic = it->second.get();
+  }
+  vector<NodeAnnotation> annotations(nodes.size());
+  vector<function<void()>> tasks;
+  for (size_t begin = 0; begin < nodes.size(); begin += kAnnotationChunkSize)
+  {
+    size_t const end = min(begin + kAnnotationChunkSize, nodes.size());
+    tasks.push_back([&, begin, end]()
+    {
+      Index::FeaturesLoaderGuard loader(*m_pIndex, mapping->GetMwmId());
+      for (size_t i = begin; i < end && !delegate.IsCancelled(); ++i)
+      {
+        MakeNodeAnnotation(*m_pIndex, *mapping, routingResult,
+                           routingResult.unpackedPathSegments[nodes[i].first], nodes[i].second,
+                           carModel, traffic, loader, annotations[i]);
+      }
+    });
+  }
+  m_pIndex->RunQueryTasks(tasks);
+  INTERRUPT_WHEN_CANCELLED(delegate);
+
 #ifdef DEBUG
   size_t lastIdx = 0;
 #endif
 
-  for (auto const & pathSegments : routingResult.unpackedPathSegments)
+  for (size_t i = 0; i < nodes.size(); ++i)
   {
-    INTERRUPT_WHEN_CANCELLED(delegate);
-
-    // Get all computed route coordinates.
-    size_t const numSegments = pathSegments.size();
-    for (size_t segmentIndex = 0; segmentIndex < numSegments; ++segmentIndex)
+    NodeAnnotation & annotation = annotations[i];
+    if (nodes[i].second > 0 && !points.empty())
     {
-      RawPathData const & pathData = pathSegments[segmentIndex];
+      turns::TurnItem & turnItem = annotation.m_turn;
+      turnItem.m_index = static_cast<uint32_t>(points.size() - 1);
 
-      if (segmentIndex > 0 && !points.empty())
-      {
-        turns::TurnItem turnItem;
-        turnItem.m_index = static_cast<uint32_t>(points.size() - 1);
-
-        turns::TurnInfo turnInfo(*mapping, pathSegments[segmentIndex - 1].node, pathSegments[segmentIndex].node);
-        turns::GetTurnDirection(*m_pIndex, turnInfo, turnItem);
-
-        // ETA information.
-        // Osrm multiples seconds to 10, so we need to divide it back.
-        double const nodeTimeSeconds = pathData.segmentWeight / 10.0;
+      // ETA information.
+      // Osrm multiples seconds to 10, so we need to divide it back.
+      RawPathData const & pathData = routingResult.unpackedPathSegments[nodes[i].first][nodes[i].second];
+      double const nodeTimeSeconds = pathData.segmentWeight / 10.0 * annotation.m_trafficFactor;
 
 #ifdef DEBUG
-        double distMeters = 0.0;
-        for (size_t k = lastIdx + 1; k < points.size(); ++k)
-          distMeters += MercatorBounds::DistanceOnEarth(points[k - 1], points[k]);
-        LOG(LDEBUG, ("Speed:", 3.6 * distMeters / nodeTimeSeconds, "kmph; Dist:", distMeters, "Time:",
-                     nodeTimeSeconds, "s", lastIdx, "e", points.size(), "source:", turnItem.m_sourceName,
-                     "target:", turnItem.m_targetName));
-        lastIdx = points.size();
+      double distMeters = 0.0;
+      for (size_t k = lastIdx + 1; k < points.size(); ++k)
+        distMeters += MercatorBounds::DistanceOnEarth(points[k - 1], points[k]);
+      LOG(LDEBUG, ("Speed:", 3.6 * distMeters / nodeTimeSeconds, "kmph; Dist:", distMeters, "Time:",
+                   nodeTimeSeconds, "s", lastIdx, "e", points.size(), "source:", turnItem.m_sourceName,
+                   "target:", turnItem.m_targetName));
+      lastIdx = points.size();
 #endif
-        estimatedTime += nodeTimeSeconds;
-        times.push_back(Route::TTimeItem(points.size(), estimatedTime));
-
-        //  Lane information.
-        if (turnItem.m_turn != turns::TurnDirection::NoTurn)
-        {
-          turnItem.m_lanes = turns::GetLanesInfo(pathSegments[segmentIndex - 1].node,
-                                          *mapping, turns::GetLastSegmentPointIndex, *m_pIndex);
-          turnsDir.push_back(move(turnItem));
-        }
-      }
+      estimatedTime += nodeTimeSeconds;
+      times.push_back(Route::TTimeItem(points.size(), estimatedTime));
 
-      buffer_vector<TSeg, 8> buffer;
-      mapping->m_segMapping.ForEachFtSeg(pathData.node, MakeBackInsertFunctor(buffer));
-
-      auto FindIntersectingSeg = [&buffer] (TSeg const & seg) -> size_t
-      {
-        ASSERT(seg.IsValid(), ());
-        auto const it = find_if(buffer.begin(), buffer.end(), [&seg] (OsrmMappingTypes::FtSeg const & s)
-        {
-          return s.IsIntersect(seg);
-        });
-
-        ASSERT(it != buffer.end(), ());
-        return distance(buffer.begin(), it);
-      };
-
-      //m_mapping.DumpSegmentByNode(path_data.node);
-
-      //Do not put out node geometry (we do not have it)!
-      size_t startK = 0, endK = buffer.size();
-      if (segmentIndex == 0)
-      {
-        if (!segBegin.IsValid())
-          continue;
-        startK = FindIntersectingSeg(segBegin);
-      }
-      if (segmentIndex + 1 == numSegments)
-      {
-        if (!segEnd.IsValid())
-          continue;
-        endK = FindIntersectingSeg(segEnd) + 1;
-      }
-
-      for (size_t k = startK; k < endK; ++k)
-      {
-        TSeg const & seg = buffer[k];
-
-        FeatureType ft;
-        Index::FeaturesLoaderGuard loader(*m_pIndex, mapping->GetMwmId());
-        loader.GetFeatureByIndex(seg.m_fid, ft);
-        ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
-
-        auto startIdx = seg.m_pointStart;
-        auto endIdx = seg.m_pointEnd;
-        bool const needTime = (segmentIndex == 0) || (segmentIndex == numSegments - 1);
-
-        if (segmentIndex == 0 && k == startK && segBegin.IsValid())
-          startIdx = (seg.m_pointEnd > seg.m_pointStart) ? segBegin.m_pointStart : segBegin.m_pointEnd;
-        if (segmentIndex == numSegments - 1 && k == endK - 1 && segEnd.IsValid())
-          endIdx = (seg.m_pointEnd > seg.m_pointStart) ? segEnd.m_pointEnd : segEnd.m_pointStart;
-
-        if (seg.m_pointEnd > seg.m_pointStart)
-        {
-          for (auto idx = startIdx; idx <= endIdx; ++idx)
-          {
-            points.push_back(ft.GetPoint(idx));
-            if (needTime && idx > startIdx)
-              estimatedTime += MercatorBounds::DistanceOnEarth(ft.GetPoint(idx - 1), ft.GetPoint(idx)) / carModel.GetSpeed(ft);
-          }
-        }
-        else
-        {
-          for (auto idx = startIdx; idx > endIdx; --idx)
-          {
-            if (needTime)
-              estimatedTime += MercatorBounds::DistanceOnEarth(ft.GetPoint(idx - 1), ft.GetPoint(idx)) / carModel.GetSpeed(ft);
-            points.push_back(ft.GetPoint(idx));
-          }
-          points.push_back(ft.GetPoint(endIdx));
-        }
-      }
+      if (turnItem.m_turn != turns::TurnDirection::NoTurn)
+        turnsDir.push_back(move(turnItem));
     }
+
+    points.insert(points.end(), annotation.m_points.begin(), annotation.m_points.end());
+    estimatedTime += annotation.m_time;
   }
 
   if (points.size() < 2)
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "routing/cross_mwm_overlay.hpp"
 #include "routing/osrm_data_facade.hpp"
 #include "routing/osrm_engine.hpp"
 #include "routing/route.hpp"
+#include "routing/route_cache.hpp"
 #include "routing/router.hpp"
 #include "routing/routing_mapping.hpp"
+#include "routing/traffic_info.hpp"
 
 
 namespace feature { class TypesHolder; }
@@ -28,6 +31,7 @@ public:
   typedef vector<double> GeomTurnCandidateT;
 
   OsrmRouter(Index * index, TCountryFileFn const & countryFileFn);
+  ~OsrmRouter() override;
 
   virtual string GetName() const override;
 
@@ -35,8 +39,53 @@ public:
                             m2::PointD const & finalPoint, RouterDelegate const & delegate,
                             Route & route) override;
 
+  /// Snaps every point once and keeps the routing data of each mwm loaded for the whole table.
+  /// Weights between points of the same mwm are found by one many-to-many search,
+  /// pairs of points in different mwms are routed through the cross mwm graph.
+  ResultCode CalculateWeightsMatrix(vector<m2::PointD> const & sources,
+                                    vector<m2::PointD> const & targets,
+                                    RouterDelegate const & delegate,
+                                    vector<double> & weights) override;
+
   virtual void ClearState() override;
 
+  RouteTimings GetLastRouteTimings() const override { return m_lastTimings; }
+
+  /// Sets the count of mwms whose routing data stay loaded between requests.
+  void SetResidentMappingsCount(size_t count) { m_indexManager.SetResidentMappingsCount(count); }
+
+  /// Sets the memory which the routing data of the resident mwms may take up to, the least
+  /// recently used ones are freed beyond it. Zero disables the limit.
+  void SetMemoryBudget(uint64_t bytes) { m_indexManager.SetMemoryBudget(bytes); }
+
+  /// @return Memory of the loaded routing data by country names.
+  map<string, uint64_t> GetMemoryUsage() const { return m_indexManager.GetMemoryUsage(); }
+
+  /// Sets the memory of the decoded adjacency cache of each mwm, zero disables the cache.
+  void SetAdjacencyCacheSize(size_t bytes) { m_indexManager.SetAdjacencyCacheSize(bytes); }
+
+  /// Sets the mode of the searches of the routes within one mwm, the default one depends on
+  /// the number of cores, see GetDefaultSingleRouteSearchMode().
+  void SetSingleRouteSearchMode(SingleRouteSearchMode mode) { m_searchMode = mode; }
+
+  /// Sets the live traffic which re-weights the times of the next routes, nullptr disables it.
+  /// Routes with the traffic aren't cached. The cache must outlive the router.
+  void SetTrafficCache(TrafficCache const * traffic) { m_traffic = traffic; }
+
+  /// Routes calculated for the same snapped endpoints are taken from the cache.
+  RouteCache & GetRouteCache() { return m_routeCache; }
+
+  /// Loads the route cache from the file, the cache is saved back to the file on destruction.
+  /// Empty path disables persistence.
+  void SetRouteCacheFile(string const & path);
+
+  /// Estimates the countries of the route between the countries by the cross mwm overlay,
+  /// neither the routing files nor the network are used. It must be called on the thread
+  /// of the routing.
+  /// @return False when there is no overlay or it doesn't link the countries.
+  bool EstimateCrossMwmCountries(string const & startCountry, string const & finalCountry,
+                                 vector<string> & countries);
+
   /*! Find single shortest path in a single MWM between 2 sets of edges
      * \param source: vector of source edges to make path
      * \param taget: vector of target edges to make path
@@ -44,9 +93,9 @@ public:
      * \param rawRoutingResult: routing result store
      * \return true when path exists, false otherwise.
      */
-  static bool FindRouteFromCases(TFeatureGraphNodeVec const & source,
-                                 TFeatureGraphNodeVec const & target, TDataFacade & facade,
-                                 RawRoutingResult & rawRoutingResult);
+  bool FindRouteFromCases(TFeatureGraphNodeVec const & source,
+                          TFeatureGraphNodeVec const & target, TDataFacade & facade,
+                          RawRoutingResult & rawRoutingResult) const;
 
   /*! Fast checking ability of route construction
    *  @param startPoint starting road point
@@ -100,11 +149,33 @@ private:
   ResultCode MakeRouteFromCrossesPath(TCheckedPath const & path, RouterDelegate const & delegate,
                                       Route & route);
 
+  /// @return The cross mwm overlay which is loaded on the first call, or nullptr
+  ///         when there is no overlay file.
+  CrossMwmOverlay const * GetCrossMwmOverlay();
+
+  /// @return Version of the mwm registered in the index or RouteCache::kInvalidVersion.
+  int64_t GetMwmVersion(string const & name) const;
+
+  RouteCache::Key MakeRouteCacheKey(TRoutingMappingPtr const & startMapping,
+                                    TRoutingMappingPtr const & targetMapping,
+                                    TFeatureGraphNodeVec const & source,
+                                    TFeatureGraphNodeVec const & target) const;
+
   Index const * m_pIndex;
 
   TFeatureGraphNodeVec m_cachedTargets;
   m2::PointD m_cachedTargetPoint;
 
   RoutingIndexManager m_indexManager;
+
+  unique_ptr<CrossMwmOverlay> m_overlay;
+  bool m_overlayLoaded = false;
+
+  RouteCache m_routeCache;
+  string m_routeCacheFile;
+
+  SingleRouteSearchMode m_searchMode = GetDefaultSingleRouteSearchMode();
+  TrafficCache const * m_traffic = nullptr;
+  RouteTimings m_lastTimings;
 };
 }  // namespace routing
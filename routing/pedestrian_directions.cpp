@@ -106,17 +106,18 @@ void PedestrianDirectionsEngine::CalculateTimes(IRoadGraph const & graph, vector
   double trackTimeSec = 0.0;
   times.emplace_back(0, trackTimeSec);
 
-  m2::PointD prev = path[0].GetPoint();
+  // Each point is converted once by the batched calculation.
+  vector<m2::PointD> points;
+  points.reserve(path.size());
+  for (Junction const & junction : path)
+    points.push_back(junction.GetPoint());
+  vector<double> lengthsM(points.size() - 1);
+  MercatorBounds::SegmentsOnEarth(points.data(), points.size(), lengthsM.data());
+
   for (size_t i = 1; i < path.size(); ++i)
   {
-    m2::PointD const & curr = path[i].GetPoint();
-
-    double const lengthM = MercatorBounds::DistanceOnEarth(prev, curr);
-    trackTimeSec += lengthM / speedMPS;
-
+    trackTimeSec += lengthsM[i - 1] / speedMPS;
     times.emplace_back(i, trackTimeSec);
-
-    prev = curr;
   }
 }
 
@@ -21,8 +21,8 @@ namespace
 
 inline bool PointsAlmostEqualAbs(const m2::PointD & pt1, const m2::PointD & pt2)
 {
-  double constexpr kEpsilon = 1e-6;
-  return my::AlmostEqualAbs(pt1.x, pt2.x, kEpsilon) && my::AlmostEqualAbs(pt1.y, pt2.y, kEpsilon);
+  return my::AlmostEqualAbs(pt1.x, pt2.x, kPointsEqualEpsilon) &&
+         my::AlmostEqualAbs(pt1.y, pt2.y, kPointsEqualEpsilon);
 }
 
 vector<Edge>::const_iterator FindEdgeContainingPoint(vector<Edge> const & edges, m2::PointD const & pt)
@@ -194,16 +194,15 @@ void IRoadGraph::CrossEdgesLoader::operator()(FeatureID const & featureId, RoadI
 
 void IRoadGraph::GetOutgoingEdges(Junction const & junction, TEdgeVector & edges) const
 {
-  auto const itr = m_outgoingEdges.find(junction);
-  if (itr != m_outgoingEdges.end())
+  JunctionEdges & cached = m_junctionEdges[GetJunctionId(junction)];
+  if (!cached.m_hasFake && !cached.m_regularLoaded)
   {
-    edges.reserve(edges.size() + itr->second.size());
-    edges.insert(edges.end(), itr->second.begin(), itr->second.end());
-  }
-  else
-  {
-    GetRegularOutgoingEdges(junction, edges);
+    GetRegularOutgoingEdges(junction, cached.m_regular);
+    cached.m_regularLoaded = true;
   }
+
+  TEdgeVector const & outgoing = cached.m_hasFake ? cached.m_fake : cached.m_regular;
+  edges.insert(edges.end(), outgoing.begin(), outgoing.end());
 }
 
 void IRoadGraph::GetIngoingEdges(Junction const & junction, TEdgeVector & edges) const
@@ -226,7 +225,39 @@ void IRoadGraph::GetRegularOutgoingEdges(Junction const & junction, TEdgeVector
 
 void IRoadGraph::ResetFakes()
 {
-  m_outgoingEdges.clear();
+  // Capacities are kept for the next query.
+  m_junctionIds.clear();
+  m_junctionEdges.clear();
+  m_fakeIds.clear();
+}
+
+uint32_t IRoadGraph::GetJunctionId(Junction const & junction) const
+{
+  auto const res = m_junctionIds.emplace(junction, static_cast<uint32_t>(m_junctionEdges.size()));
+  if (res.second)
+    m_junctionEdges.emplace_back();
+  return res.first->second;
+}
+
+IRoadGraph::TEdgeVector & IRoadGraph::GetFakeEdges(Junction const & junction)
+{
+  uint32_t const id = GetJunctionId(junction);
+  JunctionEdges & cached = m_junctionEdges[id];
+  if (!cached.m_hasFake)
+  {
+    cached.m_hasFake = true;
+    m_fakeIds.push_back(id);
+  }
+  return cached.m_fake;
+}
+
+IRoadGraph::TEdgeVector const * IRoadGraph::FindFakeEdges(Junction const & junction) const
+{
+  auto const it = m_junctionIds.find(junction);
+  if (it == m_junctionIds.end())
+    return nullptr;
+  JunctionEdges const & cached = m_junctionEdges[it->second];
+  return cached.m_hasFake ? &cached.m_fake : nullptr;
 }
 
 void IRoadGraph::AddFakeEdges(Junction const & junction, vector<pair<Edge, m2::PointD>> const & vicinity)
@@ -248,11 +279,10 @@ void IRoadGraph::AddFakeEdges(Junction const & junction, vector<pair<Edge, m2::P
       // P is the closest junction of the feature to the junction M.
 
       // Add outgoing edges for M.
-      TEdgeVector & edgesM = m_outgoingEdges[junction];
-      edgesM.push_back(Edge::MakeFake(junction, p));
+      GetFakeEdges(junction).push_back(Edge::MakeFake(junction, p));
 
       // Add outgoing edges for P.
-      TEdgeVector & edgesP = m_outgoingEdges[p];
+      TEdgeVector & edgesP = GetFakeEdges(p);
       GetRegularOutgoingEdges(p, edgesP);
       edgesP.push_back(Edge::MakeFake(p, junction));
     }
@@ -281,11 +311,11 @@ void IRoadGraph::AddFakeEdges(Junction const & junction, vector<pair<Edge, m2::P
       {
         // The point P is mapped in the middle of the feature AB
 
-        TEdgeVector & edgesA = m_outgoingEdges[edgeToSplit.GetStartJunction()];
+        TEdgeVector & edgesA = GetFakeEdges(edgeToSplit.GetStartJunction());
         if (edgesA.empty())
           GetRegularOutgoingEdges(edgeToSplit.GetStartJunction(), edgesA);
 
-        TEdgeVector & edgesB = m_outgoingEdges[edgeToSplit.GetEndJunction()];
+        TEdgeVector & edgesB = GetFakeEdges(edgeToSplit.GetEndJunction());
         if (edgesB.empty())
           GetRegularOutgoingEdges(edgeToSplit.GetEndJunction(), edgesB);
       }
@@ -309,32 +339,32 @@ void IRoadGraph::AddFakeEdges(Junction const & junction, vector<pair<Edge, m2::P
       Edge const pm = Edge::MakeFake(p, junction);
 
       // Add outgoing edges to point P.
-      TEdgeVector & edgesP = m_outgoingEdges[p];
+      TEdgeVector & edgesP = GetFakeEdges(p);
       edgesP.push_back(pa);
       edgesP.push_back(pb);
       edgesP.push_back(pm);
 
       // Add outgoing edges for point M.
-      m_outgoingEdges[junction].push_back(pm.GetReverseEdge());
+      GetFakeEdges(junction).push_back(pm.GetReverseEdge());
 
       // Replace AB edge with AP edge.
-      TEdgeVector & edgesA = m_outgoingEdges[pa.GetEndJunction()];
+      TEdgeVector & edgesA = GetFakeEdges(pa.GetEndJunction());
       Edge const ap = pa.GetReverseEdge();
       edgesA.erase(remove_if(edgesA.begin(), edgesA.end(), [&](Edge const & e) { return e.SameRoadSegmentAndDirection(ap); }), edgesA.end());
       edgesA.push_back(ap);
 
       // Replace BA edge with BP edge.
-      TEdgeVector & edgesB = m_outgoingEdges[pb.GetEndJunction()];
+      TEdgeVector & edgesB = GetFakeEdges(pb.GetEndJunction());
       Edge const bp = pb.GetReverseEdge();
       edgesB.erase(remove_if(edgesB.begin(), edgesB.end(), [&](Edge const & e) { return e.SameRoadSegmentAndDirection(bp); }), edgesB.end());
       edgesB.push_back(bp);
     }
   }
 
-  // m_outgoingEdges may contain duplicates. Remove them.
-  for (auto & m : m_outgoingEdges)
+  // Fake edges may contain duplicates. Remove them.
+  for (uint32_t const id : m_fakeIds)
   {
-    TEdgeVector & edges = m.second;
+    TEdgeVector & edges = m_junctionEdges[id].m_fake;
     sort(edges.begin(), edges.end());
     edges.erase(unique(edges.begin(), edges.end()), edges.end());
   }
@@ -344,18 +374,16 @@ bool IRoadGraph::HasBeenSplitToFakes(Edge const & edge, vector<Edge> & fakeEdges
 {
   vector<Edge> tmp;
 
-  if (m_outgoingEdges.find(edge.GetStartJunction()) == m_outgoingEdges.end() ||
-      m_outgoingEdges.find(edge.GetEndJunction()) == m_outgoingEdges.end())
+  if (FindFakeEdges(edge.GetStartJunction()) == nullptr ||
+      FindFakeEdges(edge.GetEndJunction()) == nullptr)
     return false;
 
-  auto i = m_outgoingEdges.end();
+  TEdgeVector const * edges = nullptr;
   Junction junction = edge.GetStartJunction();
-  while (m_outgoingEdges.end() != (i = m_outgoingEdges.find(junction)))
+  while ((edges = FindFakeEdges(junction)) != nullptr)
   {
-    auto const & edges = i->second;
-
-    auto const j = find_if(edges.begin(), edges.end(), [&edge](Edge const & e) { return e.SameRoadSegmentAndDirection(edge); });
-    if (j == edges.end())
+    auto const j = find_if(edges->begin(), edges->end(), [&edge](Edge const & e) { return e.SameRoadSegmentAndDirection(edge); });
+    if (j == edges->end())
     {
       ASSERT(fakeEdges.empty(), ());
       return false;
@@ -367,7 +395,7 @@ bool IRoadGraph::HasBeenSplitToFakes(Edge const & edge, vector<Edge> & fakeEdges
     if (junction == edge.GetEndJunction())
       break;
   }
-  if (i == m_outgoingEdges.end())
+  if (edges == nullptr)
     return false;
 
   if (tmp.empty())
@@ -379,7 +407,12 @@ bool IRoadGraph::HasBeenSplitToFakes(Edge const & edge, vector<Edge> & fakeEdges
 
 double IRoadGraph::GetSpeedKMPH(Edge const & edge) const
 {
-  double const speedKMPH = (edge.IsFake() ? GetMaxSpeedKMPH() : GetSpeedKMPH(edge.GetFeatureId()));
+  if (edge.IsFake())
+    return GetMaxSpeedKMPH();
+
+  double speedKMPH = GetSpeedKMPH(edge.GetFeatureId());
+  if (m_traffic)
+    speedKMPH *= GetSpeedFactor(*m_traffic, edge.GetFeatureId(), edge.GetSegId(), edge.IsForward());
   ASSERT(speedKMPH <= GetMaxSpeedKMPH(), ());
   return speedKMPH;
 }
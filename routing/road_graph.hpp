@@ -1,18 +1,28 @@
 #pragma once
 
+#include "routing/traffic_info.hpp"
+
 #include "geometry/point2d.hpp"
 
 #include "base/string_utils.hpp"
 
 #include "indexer/feature_data.hpp"
 
+#include "std/functional.hpp"
 #include "std/initializer_list.hpp"
 #include "std/map.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/unordered_map.hpp"
 #include "std/vector.hpp"
 
 namespace routing
 {
 
+/// Points closer than it in the mercator coordinates are the same junction of the road graph.
+double constexpr kPointsEqualEpsilon = 1e-6;
+
+class LandmarksTable;
+
 /// The Junction class represents a node description on a road network graph
 class Junction
 {
@@ -34,6 +44,23 @@ private:
   m2::PointD m_point;
 };
 
+}  // namespace routing
+
+namespace std
+{
+template <>
+struct hash<routing::Junction>
+{
+  size_t operator()(routing::Junction const & junction) const
+  {
+    return m2::PointD::Hash()(junction.GetPoint());
+  }
+};
+}  // namespace std
+
+namespace routing
+{
+
 /// The Edge class represents an edge description on a road network graph
 class Edge
 {
@@ -120,7 +147,8 @@ public:
   /// Finds all nearest ingoing edges, that route to the junction.
   void GetIngoingEdges(Junction const & junction, TEdgeVector & edges) const;
 
-  /// Removes all fake turns and vertices from the graph.
+  /// Removes all fake turns and vertices from the graph and drops the cached outgoing edges,
+  /// it's called on the start and on the end of each routing query.
   void ResetFakes();
 
   /// Adds fake edges from fake position rp to real vicinity
@@ -133,9 +161,12 @@ public:
   /// Returns speed in KM/H for a road corresponding to featureId.
   virtual double GetSpeedKMPH(FeatureID const & featureId) const = 0;
 
-  /// Returns speed in KM/H for a road corresponding to edge.
+  /// Returns speed in KM/H for a road corresponding to edge, it's slowed down by the traffic.
   double GetSpeedKMPH(Edge const & edge) const;
 
+  /// Sets the snapshot of the live traffic which slows down the edges, nullptr disables it.
+  void SetTraffic(shared_ptr<TrafficCache::TSnapshot const> const & traffic) { m_traffic = traffic; }
+
   /// Returns max speed in KM/H
   virtual double GetMaxSpeedKMPH() const = 0;
 
@@ -158,18 +189,49 @@ public:
   /// @return Types for specified junction
   virtual void GetJunctionTypes(Junction const & junction, feature::TypesHolder & types) const = 0;
 
+  /// @return Landmarks table of the mwm which contains the feature, or nullptr
+  /// when the graph has no landmarks for it.
+  virtual LandmarksTable const * GetLandmarks(FeatureID const & /* featureId */) const { return nullptr; }
+
   /// Clear all temporary buffers.
   virtual void ClearState() {}
 
 private:
+  /// Outgoing edges of a junction which has been visited since the last ResetFakes().
+  struct JunctionEdges
+  {
+    // Regular edges, they're loaded on the first visit of the junction.
+    TEdgeVector m_regular;
+    bool m_regularLoaded = false;
+    // Fake edges and the regular edges they are added to, if any, replace the regular ones.
+    TEdgeVector m_fake;
+    bool m_hasFake = false;
+  };
+
   /// Finds all outgoing regular (non-fake) edges for junction.
   void GetRegularOutgoingEdges(Junction const & junction, TEdgeVector & edges) const;
 
   /// Determines if the edge has been split by fake edges and if yes returns these fake edges.
   bool HasBeenSplitToFakes(Edge const & edge, vector<Edge> & fakeEdges) const;
 
-  // Map of outgoing edges for junction
-  map<Junction, TEdgeVector> m_outgoingEdges;
+  /// @return Dense id of the junction, a new one if the junction hasn't been visited yet.
+  uint32_t GetJunctionId(Junction const & junction) const;
+
+  /// @return Fake edges of the junction to add to, the reference is valid until the next
+  /// junction is visited.
+  TEdgeVector & GetFakeEdges(Junction const & junction);
+
+  /// @return Fake edges of the junction, or nullptr if it has no fake edges.
+  TEdgeVector const * FindFakeEdges(Junction const & junction) const;
+
+  // Dense ids of the visited junctions, they index m_junctionEdges. So the A* inner loop makes
+  // one hash lookup per expansion instead of the spatial queries of the features on revisits.
+  mutable unordered_map<Junction, uint32_t> m_junctionIds;
+  mutable vector<JunctionEdges> m_junctionEdges;
+  // Ids of the junctions with fake edges, there are few of them.
+  buffer_vector<uint32_t, 16> m_fakeIds;
+
+  shared_ptr<TrafficCache::TSnapshot const> m_traffic;
 };
 
 }  // namespace routing
@@ -0,0 +1,182 @@
+#include "routing/road_graph_cross_context.hpp"
+
+#include "routing/aligned_section.hpp"
+#include "routing/road_graph.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+
+namespace routing
+{
+namespace
+{
+inline uint64_t PointUToKey(m2::PointU const & pu)
+{
+  return (static_cast<uint64_t>(pu.x) << 32) | pu.y;
+}
+
+inline m2::PointU KeyToPointU(uint64_t key)
+{
+  return m2::PointU(static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key));
+}
+}  // namespace
+
+// static
+uint32_t constexpr RoadGraphCrossContext::kVersion;
+// static
+uint32_t constexpr RoadGraphCrossContext::kInvalidBorder;
+// static
+double constexpr RoadGraphCrossContext::kMaxWeightSeconds;
+// static
+double constexpr RoadGraphCrossContext::kWeightsPerSecond;
+
+// static
+void RoadGraphCrossContext::Serialize(vector<m2::PointD> const & borders, TWeights const & weights,
+                                      uint32_t coordBits, Writer & writer)
+{
+  ASSERT_EQUAL(borders.size(), weights.size(), ());
+
+  // Border vertices are sorted by their keys, so they're renumbered.
+  vector<pair<uint64_t, uint32_t>> keys;
+  keys.reserve(borders.size());
+  for (size_t i = 0; i < borders.size(); ++i)
+    keys.emplace_back(PointUToKey(PointD2PointU(borders[i], coordBits)), static_cast<uint32_t>(i));
+  sort(keys.begin(), keys.end());
+  for (size_t i = 1; i < keys.size(); ++i)
+    CHECK_NOT_EQUAL(keys[i - 1].first, keys[i].first, ("Border vertices must be unique."));
+
+  vector<uint32_t> newIds(borders.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+    newIds[keys[i].second] = static_cast<uint32_t>(i);
+
+  vector<uint64_t> sortedKeys;
+  vector<uint32_t> weightOffsets = {0};
+  vector<uint32_t> targets;
+  vector<uint32_t> values;
+  sortedKeys.reserve(keys.size());
+  for (auto const & key : keys)
+  {
+    sortedKeys.push_back(key.first);
+    vector<pair<uint32_t, uint32_t>> routes;
+    for (auto const & weight : weights[key.second])
+    {
+      ASSERT_LESS(weight.first, borders.size(), ());
+      ASSERT_GREATER_OR_EQUAL(weight.second, 0.0, ());
+      routes.emplace_back(newIds[weight.first],
+                          static_cast<uint32_t>(my::rounds(weight.second * kWeightsPerSecond)));
+    }
+    sort(routes.begin(), routes.end());
+    for (auto const & route : routes)
+    {
+      targets.push_back(route.first);
+      values.push_back(route.second);
+    }
+    weightOffsets.push_back(static_cast<uint32_t>(targets.size()));
+  }
+
+  Header header;
+  header.m_version = kVersion;
+  header.m_coordBits = coordBits;
+  header.m_bordersCount = static_cast<uint32_t>(sortedKeys.size());
+  header.m_weightsCount = static_cast<uint32_t>(targets.size());
+
+  AlignedWriter aligned(writer);
+  aligned.WriteArray(vector<Header>{header});
+  aligned.WriteArray(sortedKeys);
+  aligned.WriteArray(weightOffsets);
+  aligned.WriteArray(targets);
+  aligned.WriteArray(values);
+}
+
+bool RoadGraphCrossContext::Map(FilesMappingContainer const & cont, string const & tag)
+{
+  if (!cont.IsExist(tag))
+    return false;
+
+  // Border vertices are small and are all read at the start of a route.
+  m_handle.Assign(cont.Map(tag, mmap_policy::Get(tag, mmap_policy::Populate)));
+  if (Attach(m_handle.GetData<char>(), m_handle.GetSize()))
+    return true;
+
+  m_handle.Unmap();
+  return false;
+}
+
+bool RoadGraphCrossContext::Attach(char const * data, uint64_t size)
+{
+  m_header = nullptr;
+  if (reinterpret_cast<uintptr_t>(data) % kSectionArrayAlignment != 0)
+  {
+    LOG(LWARNING, ("Road graph cross context is not aligned."));
+    return false;
+  }
+
+  AlignedReader reader(data, size);
+  Header const * header = nullptr;
+  if (!reader.ReadArray(1, header))
+    return false;
+  if (header->m_version != kVersion)
+  {
+    LOG(LWARNING, ("Unsupported road graph cross context version:", header->m_version));
+    return false;
+  }
+
+  bool const ok = reader.ReadArray(header->m_bordersCount, m_keys) &&
+                  reader.ReadArray(static_cast<uint64_t>(header->m_bordersCount) + 1, m_weightOffsets) &&
+                  reader.ReadArray(header->m_weightsCount, m_targets) &&
+                  reader.ReadArray(header->m_weightsCount, m_weights) && reader.IsEnd() &&
+                  m_weightOffsets[header->m_bordersCount] == header->m_weightsCount;
+  if (!ok)
+  {
+    LOG(LWARNING, ("Road graph cross context is malformed."));
+    return false;
+  }
+
+  for (uint32_t i = 0; i < header->m_weightsCount; ++i)
+  {
+    if (m_targets[i] >= header->m_bordersCount)
+    {
+      LOG(LWARNING, ("Road graph cross context is malformed, bad border vertex:", m_targets[i]));
+      return false;
+    }
+  }
+
+  m_header = header;
+  return true;
+}
+
+m2::PointD RoadGraphCrossContext::GetPoint(uint32_t border) const
+{
+  ASSERT_LESS(border, GetBordersCount(), ());
+  return PointU2PointD(KeyToPointU(m_keys[border]), m_header->m_coordBits);
+}
+
+uint32_t RoadGraphCrossContext::FindBorder(m2::PointD const & point) const
+{
+  if (IsEmpty())
+    return kInvalidBorder;
+
+  // Quantization is monotonic, so all the vertices which are equal to the point
+  // with the epsilon are in the box of quantized corners.
+  m2::PointD const eps(kPointsEqualEpsilon, kPointsEqualEpsilon);
+  m2::PointU const lo = PointD2PointU(point - eps, m_header->m_coordBits);
+  m2::PointU const hi = PointD2PointU(point + eps, m_header->m_coordBits);
+
+  uint64_t const * keysEnd = m_keys + m_header->m_bordersCount;
+  for (uint64_t x = lo.x; x <= hi.x; ++x)
+  {
+    uint64_t const * it = lower_bound(m_keys, keysEnd, PointUToKey(m2::PointU(x, lo.y)));
+    if (it != keysEnd && *it <= PointUToKey(m2::PointU(x, hi.y)))
+      return static_cast<uint32_t>(it - m_keys);
+  }
+  return kInvalidBorder;
+}
+
+}  // namespace routing
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "coding/file_container.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/limits.hpp"
+#include "std/string.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+namespace routing
+{
+
+/// RoadGraphCrossContext keeps border vertices of the road graph of a single mwm and the times
+/// of the routes between them within the mwm, as CrossRoutingContext does for the car routing.
+/// Roads crossing the mwm border are kept by the mwms on both sides, so the ends of their
+/// segments crossing the border are border vertices of both mwms, and the cross mwm routes
+/// pass from one mwm to another through the same points.
+///
+/// Times are computed by the generator up to kMaxWeightSeconds, the longer routes within
+/// the mwm have no weights. All data are fixed-width arrays aligned by 8 bytes, so the section
+/// is used in place, being mapped to memory from the mwm.
+class RoadGraphCrossContext
+{
+public:
+  /// Target border vertex and the time of the route to it in seconds.
+  using TWeights = vector<vector<pair<uint32_t, double>>>;
+
+  static uint32_t constexpr kVersion = 0;
+  static uint32_t constexpr kInvalidBorder = numeric_limits<uint32_t>::max();
+  static double constexpr kMaxWeightSeconds = 4 * 60 * 60;
+
+  /// Writes the section. weights[i] are the routes from the i-th border vertex.
+  static void Serialize(vector<m2::PointD> const & borders, TWeights const & weights,
+                        uint32_t coordBits, Writer & writer);
+
+  /// Maps the section of the container to memory.
+  /// @return False when the section is absent or malformed.
+  bool Map(FilesMappingContainer const & cont, string const & tag);
+
+  /// Uses the section data kept by the caller. The data must be aligned by 8 bytes
+  /// and must outlive the section.
+  /// @return False when the data are malformed.
+  bool Attach(char const * data, uint64_t size);
+
+  inline bool IsEmpty() const { return m_header == nullptr || m_header->m_bordersCount == 0; }
+  inline uint32_t GetBordersCount() const { return m_header ? m_header->m_bordersCount : 0; }
+
+  m2::PointD GetPoint(uint32_t border) const;
+
+  /// @return Border vertex which is equal to the point with IRoadGraph's junction epsilon,
+  /// or kInvalidBorder.
+  uint32_t FindBorder(m2::PointD const & point) const;
+
+  /// Calls fn(target, seconds) for the routes from the border vertex.
+  template <typename TFn>
+  void ForEachWeight(uint32_t border, TFn && fn) const
+  {
+    for (uint32_t i = m_weightOffsets[border]; i < m_weightOffsets[border + 1]; ++i)
+      fn(m_targets[i], m_weights[i] / kWeightsPerSecond);
+  }
+
+private:
+  struct Header
+  {
+    uint32_t m_version;
+    uint32_t m_coordBits;
+    uint32_t m_bordersCount;
+    uint32_t m_weightsCount;
+  };
+
+  // Weights are kept in tenths of a second.
+  static double constexpr kWeightsPerSecond = 10.0;
+
+  FilesMappingContainer::Handle m_handle;
+
+  Header const * m_header = nullptr;
+  // Sorted keys of quantized points of the border vertices.
+  uint64_t const * m_keys = nullptr;
+  // Routes from the i-th border vertex are [m_weightOffsets[i], m_weightOffsets[i + 1]).
+  uint32_t const * m_weightOffsets = nullptr;
+  uint32_t const * m_targets = nullptr;
+  uint32_t const * m_weights = nullptr;
+};
+
+}  // namespace routing
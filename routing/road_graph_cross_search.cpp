@@ -0,0 +1,394 @@
+#include "routing/road_graph_cross_search.hpp"
+
+#include "routing/router_delegate.hpp"
+
+#include "indexer/index.hpp"
+#include "indexer/mercator.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "coding/file_container.hpp"
+
+#include "base/logging.hpp"
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/queue.hpp"
+#include "std/set.hpp"
+
+namespace routing
+{
+namespace
+{
+double constexpr KMPH2MPS = 1000.0 / (60 * 60);
+
+// Cancellation is checked once per this number of the settled states.
+uint32_t constexpr kCancelCheckPeriod = 1024;
+
+inline bool PointsAlmostEqualAbs(m2::PointD const & p1, m2::PointD const & p2)
+{
+  return my::AlmostEqualAbs(p1.x, p2.x, kPointsEqualEpsilon) &&
+         my::AlmostEqualAbs(p1.y, p2.y, kPointsEqualEpsilon);
+}
+
+inline double TimeBetweenSec(m2::PointD const & p1, m2::PointD const & p2, double speedMPS)
+{
+  ASSERT(speedMPS > 0.0, ());
+  return MercatorBounds::DistanceOnEarth(p1, p2) / speedMPS;
+}
+
+/// Calls fn(edge, seconds) for the outgoing edges of the junction which are the roads
+/// of the mwm or the fake edges.
+template <typename TFn>
+void ForEachEdgeInMwm(IRoadGraph const & graph, MwmSet::MwmId const & mwmId,
+                      Junction const & junction, IRoadGraph::TEdgeVector & edges, TFn && fn)
+{
+  edges.clear();
+  graph.GetOutgoingEdges(junction, edges);
+  for (Edge const & e : edges)
+  {
+    if (!e.IsFake() && e.GetFeatureId().m_mwmId != mwmId)
+      continue;
+    double const speedMPS = graph.GetSpeedKMPH(e) * KMPH2MPS;
+    fn(e, TimeBetweenSec(e.GetStartJunction().GetPoint(), e.GetEndJunction().GetPoint(), speedMPS));
+  }
+}
+}  // namespace
+
+/// States of the search. The start and the final mwms are searched by their junctions,
+/// the other mwms are passed through by their border vertices.
+struct RoadGraphCrossSearch::State
+{
+  enum class Kind : uint8_t
+  {
+    Start,
+    Border,
+    Final
+  };
+
+  State() = default;
+  State(Kind kind, size_t mwm, uint32_t border, Junction const & junction)
+    : m_kind(kind), m_mwm(static_cast<uint32_t>(mwm)), m_border(border), m_junction(junction)
+  {
+  }
+
+  bool operator<(State const & rhs) const
+  {
+    if (m_kind != rhs.m_kind)
+      return m_kind < rhs.m_kind;
+    if (m_mwm != rhs.m_mwm)
+      return m_mwm < rhs.m_mwm;
+    if (m_border != rhs.m_border)
+      return m_border < rhs.m_border;
+    return m_junction < rhs.m_junction;
+  }
+
+  Kind m_kind = Kind::Start;
+  // Index of the mwm in m_mwms.
+  uint32_t m_mwm = 0;
+  // Border vertex of the border states.
+  uint32_t m_border = RoadGraphCrossContext::kInvalidBorder;
+  // Junction of the start and the final states.
+  Junction m_junction;
+};
+
+struct RoadGraphCrossSearch::Label
+{
+  double m_seconds = 0.0;
+  State m_parent;
+  bool m_hasParent = false;
+};
+
+RoadGraphCrossSearch::RoadGraphCrossSearch(Index & index, string const & contextTag)
+  : m_index(index), m_contextTag(contextTag)
+{
+}
+
+bool RoadGraphCrossSearch::IsAvailable(MwmSet::MwmId const & startMwm,
+                                       MwmSet::MwmId const & finalMwm)
+{
+  return GetContext(startMwm) != nullptr && GetContext(finalMwm) != nullptr;
+}
+
+IRoutingAlgorithm::Result RoadGraphCrossSearch::CalculateRoute(
+    IRoadGraph const & graph, Junction const & startPos, MwmSet::MwmId const & startMwm,
+    Junction const & finalPos, MwmSet::MwmId const & finalMwm, RouterDelegate const & delegate,
+    vector<Junction> & path)
+{
+  using TKind = State::Kind;
+
+  path.clear();
+  m_searchedMwmsCount = 0;
+  UpdateMwms();
+
+  auto const findMwm = [this](MwmSet::MwmId const & mwmId)
+  {
+    auto const it = find_if(m_mwms.begin(), m_mwms.end(), [&mwmId](MwmBounds const & mwm)
+                            {
+                              return mwm.m_mwmId == mwmId;
+                            });
+    return static_cast<size_t>(distance(m_mwms.begin(), it));
+  };
+  size_t const startIndex = findMwm(startMwm);
+  size_t const finalIndex = findMwm(finalMwm);
+  RoadGraphCrossContext const * startContext = GetContext(startMwm);
+  if (startIndex == m_mwms.size() || finalIndex == m_mwms.size() || startContext == nullptr ||
+      GetContext(finalMwm) == nullptr)
+  {
+    return IRoutingAlgorithm::Result::NoPath;
+  }
+
+  // Times of the contexts are made of the speeds of the roads, so the straight line time
+  // by the max speed is a lower bound of them as well.
+  double const maxSpeedMPS = graph.GetMaxSpeedKMPH() * KMPH2MPS;
+  auto const getPoint = [this](State const & state)
+  {
+    if (state.m_kind != TKind::Border)
+      return state.m_junction.GetPoint();
+    return m_contexts[m_mwms[state.m_mwm].m_mwmId]->GetPoint(state.m_border);
+  };
+
+  struct QueueItem
+  {
+    bool operator>(QueueItem const & rhs) const { return m_estimate > rhs.m_estimate; }
+
+    double m_estimate;
+    double m_seconds;
+    State m_state;
+  };
+  priority_queue<QueueItem, vector<QueueItem>, greater<QueueItem>> queue;
+  map<State, Label> labels;
+
+  auto const push = [&](State const & state, double seconds, State const * parent)
+  {
+    auto const it = labels.find(state);
+    if (it != labels.end() && it->second.m_seconds <= seconds)
+      return;
+    Label & label = labels[state];
+    label.m_seconds = seconds;
+    label.m_hasParent = parent != nullptr;
+    if (parent)
+      label.m_parent = *parent;
+    double const estimate =
+        seconds + TimeBetweenSec(getPoint(state), finalPos.GetPoint(), maxSpeedMPS);
+    queue.push({estimate, seconds, state});
+  };
+
+  push(State(TKind::Start, startIndex, RoadGraphCrossContext::kInvalidBorder, startPos),
+       0.0 /* seconds */, nullptr /* parent */);
+
+  IRoadGraph::TEdgeVector edges;
+  uint32_t settledCount = 0;
+  while (!queue.empty())
+  {
+    if (++settledCount % kCancelCheckPeriod == 0 && delegate.IsCancelled())
+      return IRoutingAlgorithm::Result::Cancelled;
+
+    QueueItem const item = queue.top();
+    queue.pop();
+    State const & state = item.m_state;
+    if (item.m_seconds > labels[state].m_seconds)
+      continue;
+
+    if (state.m_kind != TKind::Border && state.m_junction == finalPos)
+    {
+      vector<State> states = {state};
+      for (Label const * label = &labels[state]; label->m_hasParent;
+           label = &labels[label->m_parent])
+      {
+        states.push_back(label->m_parent);
+      }
+      reverse(states.begin(), states.end());
+
+      // Junctions of the route must be the ends of the edges of the graph, so the legs
+      // start at the last junction instead of the points of the border vertices.
+      set<size_t> searchedMwms = {startIndex, finalIndex};
+      for (size_t i = 0; i < states.size(); ++i)
+      {
+        State const & s = states[i];
+        bool const afterBorder = i > 0 && states[i - 1].m_kind == TKind::Border;
+        if (s.m_kind != TKind::Border)
+        {
+          if (!afterBorder)
+            path.push_back(s.m_junction);
+          continue;
+        }
+        if (!afterBorder || states[i - 1].m_mwm != s.m_mwm)
+          continue;
+
+        vector<Junction> leg;
+        if (!FindLeg(graph, m_mwms[s.m_mwm].m_mwmId, path.back(), getPoint(s), leg))
+        {
+          LOG(LWARNING, ("Can't find the leg of the cross mwm route in", m_mwms[s.m_mwm].m_mwmId));
+          path.clear();
+          return IRoutingAlgorithm::Result::NoPath;
+        }
+        path.insert(path.end(), leg.begin() + 1, leg.end());
+        searchedMwms.insert(s.m_mwm);
+      }
+      m_searchedMwmsCount = searchedMwms.size();
+      return IRoutingAlgorithm::Result::OK;
+    }
+
+    switch (state.m_kind)
+    {
+    case TKind::Start:
+    case TKind::Final:
+    {
+      ForEachEdgeInMwm(graph, m_mwms[state.m_mwm].m_mwmId, state.m_junction, edges,
+                       [&](Edge const & e, double seconds)
+      {
+        push(State(state.m_kind, state.m_mwm, RoadGraphCrossContext::kInvalidBorder,
+                   e.GetEndJunction()),
+             item.m_seconds + seconds, &state);
+      });
+      if (state.m_kind == TKind::Start)
+      {
+        uint32_t const border = startContext->FindBorder(state.m_junction.GetPoint());
+        if (border != RoadGraphCrossContext::kInvalidBorder)
+          push(State(TKind::Border, state.m_mwm, border, Junction()), item.m_seconds, &state);
+      }
+      break;
+    }
+    case TKind::Border:
+    {
+      m2::PointD const point = getPoint(state);
+      m_contexts[m_mwms[state.m_mwm].m_mwmId]->ForEachWeight(
+          state.m_border, [&](uint32_t target, double seconds)
+      {
+        push(State(TKind::Border, state.m_mwm, target, Junction()), item.m_seconds + seconds,
+             &state);
+      });
+      ForEachCrossing(state.m_mwm, point, [&](size_t mwm, uint32_t border)
+      {
+        push(State(TKind::Border, mwm, border, Junction()), item.m_seconds, &state);
+      });
+      if (state.m_mwm == finalIndex)
+      {
+        push(State(TKind::Final, finalIndex, RoadGraphCrossContext::kInvalidBorder, Junction(point)),
+             item.m_seconds, &state);
+      }
+      break;
+    }
+    }
+  }
+  return IRoutingAlgorithm::Result::NoPath;
+}
+
+RoadGraphCrossContext const * RoadGraphCrossSearch::GetContext(MwmSet::MwmId const & mwmId)
+{
+  auto it = m_contexts.find(mwmId);
+  if (it != m_contexts.end())
+    return it->second.get();
+
+  unique_ptr<RoadGraphCrossContext> context;
+  shared_ptr<MwmInfo> const & info = mwmId.GetInfo();
+  if (info && info->GetType() == MwmInfo::COUNTRY)
+  {
+    try
+    {
+      FilesMappingContainer const cont(info->GetLocalFile().GetPath(MapOptions::Map));
+      context.reset(new RoadGraphCrossContext());
+      if (context->Map(cont, m_contextTag))
+        LOG(LINFO, ("Mapped cross context for", mwmId, "borders:", context->GetBordersCount()));
+      else
+        context.reset();
+    }
+    catch (Reader::Exception const & e)
+    {
+      LOG(LERROR, ("Can't map cross context for", mwmId, e.Msg()));
+      context.reset();
+    }
+  }
+
+  return m_contexts.emplace(mwmId, move(context)).first->second.get();
+}
+
+void RoadGraphCrossSearch::UpdateMwms()
+{
+  // Drops contexts of deregistered mwms.
+  for (auto i = m_contexts.begin(); i != m_contexts.end();)
+  {
+    if (i->first.IsAlive())
+      ++i;
+    else
+      i = m_contexts.erase(i);
+  }
+
+  vector<shared_ptr<MwmInfo>> infos;
+  m_index.GetMwmsInfo(infos);
+
+  m_mwms.clear();
+  for (shared_ptr<MwmInfo> const & info : infos)
+  {
+    MwmSet::MwmId const mwmId(info);
+    if (info->GetType() != MwmInfo::COUNTRY || !mwmId.IsAlive())
+      continue;
+    m_mwms.push_back({mwmId, info->m_limitRect});
+  }
+}
+
+template <typename TFn>
+void RoadGraphCrossSearch::ForEachCrossing(size_t mwm, m2::PointD const & point, TFn && fn)
+{
+  m2::RectD rect(point, point);
+  rect.Inflate(kPointsEqualEpsilon, kPointsEqualEpsilon);
+  for (size_t i = 0; i < m_mwms.size(); ++i)
+  {
+    if (i == mwm || !m_mwms[i].m_limitRect.IsIntersect(rect))
+      continue;
+    RoadGraphCrossContext const * context = GetContext(m_mwms[i].m_mwmId);
+    if (context == nullptr)
+      continue;
+    uint32_t const border = context->FindBorder(point);
+    if (border != RoadGraphCrossContext::kInvalidBorder)
+      fn(i, border);
+  }
+}
+
+bool RoadGraphCrossSearch::FindLeg(IRoadGraph const & graph, MwmSet::MwmId const & mwmId,
+                                   Junction const & from, m2::PointD const & to,
+                                   vector<Junction> & path) const
+{
+  double const maxSpeedMPS = graph.GetMaxSpeedKMPH() * KMPH2MPS;
+  using TQueueItem = pair<double, Junction>;
+  priority_queue<TQueueItem, vector<TQueueItem>, greater<TQueueItem>> queue;
+  map<Junction, pair<double, Junction>> labels;
+  labels[from] = make_pair(0.0, from);
+  queue.emplace(TimeBetweenSec(from.GetPoint(), to, maxSpeedMPS), from);
+
+  IRoadGraph::TEdgeVector edges;
+  while (!queue.empty())
+  {
+    Junction const junction = queue.top().second;
+    queue.pop();
+    double const seconds = labels[junction].first;
+
+    if (PointsAlmostEqualAbs(junction.GetPoint(), to))
+    {
+      path.clear();
+      for (Junction j = junction; !(j == from); j = labels[j].second)
+        path.push_back(j);
+      path.push_back(from);
+      reverse(path.begin(), path.end());
+      return true;
+    }
+
+    ForEachEdgeInMwm(graph, mwmId, junction, edges, [&](Edge const & e, double edgeSeconds)
+    {
+      Junction const & target = e.GetEndJunction();
+      double const targetSeconds = seconds + edgeSeconds;
+      auto const it = labels.find(target);
+      if (it != labels.end() && it->second.first <= targetSeconds)
+        return;
+      labels[target] = make_pair(targetSeconds, junction);
+      queue.emplace(targetSeconds + TimeBetweenSec(target.GetPoint(), to, maxSpeedMPS), target);
+    });
+
+    // Legs are the routes of the contexts, so they're not longer than the longest one.
+    if (seconds > RoadGraphCrossContext::kMaxWeightSeconds)
+      return false;
+  }
+  return false;
+}
+}  // namespace routing
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "routing/road_graph.hpp"
+#include "routing/road_graph_cross_context.hpp"
+#include "routing/routing_algorithm.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include "std/map.hpp"
+#include "std/string.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+class Index;
+
+namespace routing
+{
+class RouterDelegate;
+
+/// RoadGraphCrossSearch finds the routes between mwms by the border vertices of the mwms
+/// and the precomputed times of the routes between them (see RoadGraphCrossContext).
+/// The road graph is searched in the start and the final mwms only, the intermediate mwms
+/// are passed through by the overlay of their border vertices, and only the legs
+/// of the found route are searched in their road graphs.
+class RoadGraphCrossSearch
+{
+public:
+  RoadGraphCrossSearch(Index & index, string const & contextTag);
+
+  /// @return True when both mwms have the contexts, so the route may be searched by them.
+  bool IsAvailable(MwmSet::MwmId const & startMwm, MwmSet::MwmId const & finalMwm);
+
+  /// Searches the route from startPos, which is connected to the roads of startMwm by the fake
+  /// edges of the graph, to finalPos, which is connected to the roads of finalMwm.
+  /// @return NoPath when the route isn't found by the overlay, the route may still exist
+  /// because the contexts don't keep the routes which are longer than kMaxWeightSeconds.
+  IRoutingAlgorithm::Result CalculateRoute(IRoadGraph const & graph, Junction const & startPos,
+                                           MwmSet::MwmId const & startMwm,
+                                           Junction const & finalPos,
+                                           MwmSet::MwmId const & finalMwm,
+                                           RouterDelegate const & delegate,
+                                           vector<Junction> & path);
+
+  /// @return Number of the mwms which road graphs were searched by the last route.
+  inline size_t GetSearchedMwmsCount() const { return m_searchedMwmsCount; }
+
+private:
+  struct MwmBounds
+  {
+    MwmSet::MwmId m_mwmId;
+    m2::RectD m_limitRect;
+  };
+
+  struct State;
+  struct Label;
+
+  RoadGraphCrossContext const * GetContext(MwmSet::MwmId const & mwmId);
+
+  /// Takes the country mwms which are registered now.
+  void UpdateMwms();
+
+  /// Calls fn(mwm, border) for the border vertices of the other mwms at the point.
+  template <typename TFn>
+  void ForEachCrossing(size_t mwm, m2::PointD const & point, TFn && fn);
+
+  /// Searches the leg of the route between two border vertices in the road graph of the mwm.
+  bool FindLeg(IRoadGraph const & graph, MwmSet::MwmId const & mwmId, Junction const & from,
+               m2::PointD const & to, vector<Junction> & path) const;
+
+  Index & m_index;
+  string const m_contextTag;
+
+  // Contexts are not unmapped between the routes because they are immutable.
+  // nullptr means an mwm has no context.
+  map<MwmSet::MwmId, unique_ptr<RoadGraphCrossContext>> m_contexts;
+  vector<MwmBounds> m_mwms;
+  size_t m_searchedMwmsCount = 0;
+};
+}  // namespace routing
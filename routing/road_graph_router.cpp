@@ -1,9 +1,11 @@
-#include "routing/features_road_graph.hpp"
+#include "routing/bicycle_model.hpp"
 #include "routing/nearest_edge_finder.hpp"
 #include "routing/pedestrian_directions.hpp"
 #include "routing/pedestrian_model.hpp"
+#include "routing/road_info_cache.hpp"
 #include "routing/road_graph_router.hpp"
 #include "routing/route.hpp"
+#include "routing/section_road_graph.hpp"
 
 #include "coding/reader_wrapper.hpp"
 
@@ -17,10 +19,14 @@
 
 #include "geometry/distance.hpp"
 
+#include "defines.hpp"
+
 #include "std/queue.hpp"
 #include "std/set.hpp"
 
 #include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/timer.hpp"
 
 using platform::CountryFile;
 using platform::LocalCountryFile;
@@ -36,6 +42,20 @@ size_t constexpr kTestConnectivityVisitJunctionsLimit = 25;
 
 uint64_t constexpr kMinPedestrianMwmVersion = 150713;
 
+// Decoded roads are shared by all pedestrian routers, so they survive route rebuilds.
+shared_ptr<RoadInfoCache> GetPedestrianRoadInfoCache()
+{
+  static shared_ptr<RoadInfoCache> const cache = make_shared<RoadInfoCache>();
+  return cache;
+}
+
+// Roads of the bicycle routers have their own speeds, so they're cached apart.
+shared_ptr<RoadInfoCache> GetBicycleRoadInfoCache()
+{
+  static shared_ptr<RoadInfoCache> const cache = make_shared<RoadInfoCache>();
+  return cache;
+}
+
 IRouter::ResultCode Convert(IRoutingAlgorithm::Result value)
 {
   switch (value)
@@ -138,21 +158,24 @@ RoadGraphRouter::~RoadGraphRouter() {}
 
 RoadGraphRouter::RoadGraphRouter(string const & name, Index & index,
                                  TCountryFileFn const & countryFileFn,
-                                 unique_ptr<IVehicleModelFactory> && vehicleModelFactory,
+                                 unique_ptr<IRoadGraph> && roadGraph,
                                  unique_ptr<IRoutingAlgorithm> && algorithm,
-                                 unique_ptr<IDirectionsEngine> && directionsEngine)
+                                 unique_ptr<IDirectionsEngine> && directionsEngine,
+                                 unique_ptr<RoadGraphCrossSearch> && crossSearch)
     : m_name(name)
     , m_countryFileFn(countryFileFn)
     , m_index(index)
     , m_algorithm(move(algorithm))
-    , m_roadGraph(make_unique<FeaturesRoadGraph>(index, move(vehicleModelFactory)))
+    , m_roadGraph(move(roadGraph))
     , m_directionsEngine(move(directionsEngine))
+    , m_crossSearch(move(crossSearch))
 {
 }
 
 void RoadGraphRouter::ClearState()
 {
   m_roadGraph->ClearState();
+  m_isochroneFinder.ClearCache();
 }
 
 bool RoadGraphRouter::CheckMapExistence(m2::PointD const & point, Route & route) const
@@ -171,10 +194,15 @@ IRouter::ResultCode RoadGraphRouter::CalculateRoute(m2::PointD const & startPoin
                                                     m2::PointD const & finalPoint,
                                                     RouterDelegate const & delegate, Route & route)
 {
+  m_lastTimings = RouteTimings();
+  my::Timer timer;
 
   if (!CheckMapExistence(startPoint, route) || !CheckMapExistence(finalPoint, route))
     return RouteFileNotExist;
 
+  // The whole route is made with the same traffic, the next downloads go to the next routes.
+  m_roadGraph->SetTraffic(m_traffic ? m_traffic->GetSnapshot() : nullptr);
+
   vector<pair<Edge, m2::PointD>> finalVicinity;
   FindClosestEdges(*m_roadGraph, finalPoint, finalVicinity);
   
@@ -211,17 +239,32 @@ IRouter::ResultCode RoadGraphRouter::CalculateRoute(m2::PointD const & startPoin
   m_roadGraph->ResetFakes();
   m_roadGraph->AddFakeEdges(startPos, startVicinity);
   m_roadGraph->AddFakeEdges(finalPos, finalVicinity);
+  m_lastTimings.m_pointsLookupSec = timer.ElapsedSeconds();
 
+  timer.Reset();
   vector<Junction> path;
-  IRoutingAlgorithm::Result const resultCode =
-      m_algorithm->CalculateRoute(*m_roadGraph, startPos, finalPos, delegate, path);
+  IRoutingAlgorithm::Result resultCode = IRoutingAlgorithm::Result::NoPath;
+  MwmSet::MwmId const & startMwm = startVicinity.front().first.GetFeatureId().m_mwmId;
+  MwmSet::MwmId const & finalMwm = finalVicinity.front().first.GetFeatureId().m_mwmId;
+  if (m_crossSearch && startMwm != finalMwm && m_crossSearch->IsAvailable(startMwm, finalMwm))
+  {
+    resultCode = m_crossSearch->CalculateRoute(*m_roadGraph, startPos, startMwm, finalPos,
+                                               finalMwm, delegate, path);
+    LOG(LINFO, ("Cross mwm search:", resultCode, "searched mwms:",
+                m_crossSearch->GetSearchedMwmsCount()));
+  }
+  if (resultCode == IRoutingAlgorithm::Result::NoPath)
+    resultCode = m_algorithm->CalculateRoute(*m_roadGraph, startPos, finalPos, delegate, path);
+  m_lastTimings.m_searchSec = timer.ElapsedSeconds();
 
   if (resultCode == IRoutingAlgorithm::Result::OK)
   {
     ASSERT(!path.empty(), ());
     ASSERT_EQUAL(path.front(), startPos, ());
     ASSERT_EQUAL(path.back(), finalPos, ());
+    timer.Reset();
     ReconstructRoute(move(path), route, delegate);
+    m_lastTimings.m_postProcessingSec = timer.ElapsedSeconds();
   }
 
   m_roadGraph->ResetFakes();
@@ -232,6 +275,48 @@ IRouter::ResultCode RoadGraphRouter::CalculateRoute(m2::PointD const & startPoin
   return Convert(resultCode);
 }
 
+IRouter::ResultCode RoadGraphRouter::CalculateIsochrone(m2::PointD const & point,
+                                                        double maxSeconds, double cellMeters,
+                                                        RouterDelegate const & delegate,
+                                                        vector<vector<m2::PointD>> & polygons)
+{
+  polygons.clear();
+
+  Route route(GetName());
+  if (!CheckMapExistence(point, route))
+    return RouteFileNotExist;
+
+  // Times of the kept edges are made with the traffic, so they're dropped as it's changed.
+  shared_ptr<TrafficCache::TSnapshot const> traffic = m_traffic ? m_traffic->GetSnapshot() : nullptr;
+  if (traffic != m_isochroneTraffic)
+  {
+    m_isochroneFinder.ClearCache();
+    m_isochroneTraffic = traffic;
+  }
+  m_roadGraph->SetTraffic(traffic);
+
+  vector<pair<Edge, m2::PointD>> vicinity;
+  FindClosestEdges(*m_roadGraph, point, vicinity);
+  if (vicinity.empty())
+    return StartPointNotFound;
+
+  Junction const pos(point);
+  m_roadGraph->ResetFakes();
+  m_roadGraph->AddFakeEdges(pos, vicinity);
+
+  vector<ReachableEdge> edges;
+  IRoutingAlgorithm::Result const resultCode =
+      m_isochroneFinder.FindReachable(*m_roadGraph, pos, maxSeconds, delegate, edges);
+  m_roadGraph->ResetFakes();
+
+  if (resultCode == IRoutingAlgorithm::Result::OK)
+    BuildIsochronePolygons(edges, maxSeconds, cellMeters, polygons);
+
+  if (delegate.IsCancelled())
+    return IRouter::Cancelled;
+  return Convert(resultCode);
+}
+
 void RoadGraphRouter::ReconstructRoute(vector<Junction> && path, Route & route,
                                        my::Cancellable const & cancellable) const
 {
@@ -261,18 +346,39 @@ void RoadGraphRouter::ReconstructRoute(vector<Junction> && path, Route & route,
 unique_ptr<IRouter> CreatePedestrianAStarRouter(Index & index, TCountryFileFn const & countryFileFn)
 {
   unique_ptr<IVehicleModelFactory> vehicleModelFactory(new PedestrianModelFactory());
+  unique_ptr<IRoadGraph> roadGraph(new SectionRoadGraph(index, move(vehicleModelFactory), PEDESTRIAN_ROAD_GRAPH_FILE_TAG,
+                                                      GetPedestrianRoadInfoCache()));
   unique_ptr<IRoutingAlgorithm> algorithm(new AStarRoutingAlgorithm());
   unique_ptr<IDirectionsEngine> directionsEngine(new PedestrianDirectionsEngine());
-  unique_ptr<IRouter> router(new RoadGraphRouter("astar-pedestrian", index, countryFileFn, move(vehicleModelFactory), move(algorithm), move(directionsEngine)));
+  unique_ptr<RoadGraphCrossSearch> crossSearch(new RoadGraphCrossSearch(index, PEDESTRIAN_CROSS_CONTEXT_FILE_TAG));
+  unique_ptr<IRouter> router(new RoadGraphRouter("astar-pedestrian", index, countryFileFn, move(roadGraph), move(algorithm), move(directionsEngine),
+                                                 move(crossSearch)));
   return router;
 }
 
 unique_ptr<IRouter> CreatePedestrianAStarBidirectionalRouter(Index & index, TCountryFileFn const & countryFileFn)
 {
   unique_ptr<IVehicleModelFactory> vehicleModelFactory(new PedestrianModelFactory());
+  unique_ptr<IRoadGraph> roadGraph(new SectionRoadGraph(index, move(vehicleModelFactory), PEDESTRIAN_ROAD_GRAPH_FILE_TAG,
+                                                      GetPedestrianRoadInfoCache()));
+  unique_ptr<IRoutingAlgorithm> algorithm(new AStarBidirectionalRoutingAlgorithm());
+  unique_ptr<IDirectionsEngine> directionsEngine(new PedestrianDirectionsEngine());
+  unique_ptr<RoadGraphCrossSearch> crossSearch(new RoadGraphCrossSearch(index, PEDESTRIAN_CROSS_CONTEXT_FILE_TAG));
+  unique_ptr<IRouter> router(new RoadGraphRouter("astar-bidirectional-pedestrian", index, countryFileFn, move(roadGraph), move(algorithm), move(directionsEngine),
+                                                 move(crossSearch)));
+  return router;
+}
+
+unique_ptr<IRouter> CreateBicycleAStarBidirectionalRouter(Index & index, TCountryFileFn const & countryFileFn)
+{
+  unique_ptr<IVehicleModelFactory> vehicleModelFactory(new BicycleModelFactory());
+  unique_ptr<IRoadGraph> roadGraph(new SectionRoadGraph(index, move(vehicleModelFactory), BICYCLE_ROAD_GRAPH_FILE_TAG,
+                                                      GetBicycleRoadInfoCache()));
   unique_ptr<IRoutingAlgorithm> algorithm(new AStarBidirectionalRoutingAlgorithm());
+  // Times and turns of the pedestrian engine are made of the road speeds and directions only,
+  // so they suit bicycle routes as well.
   unique_ptr<IDirectionsEngine> directionsEngine(new PedestrianDirectionsEngine());
-  unique_ptr<IRouter> router(new RoadGraphRouter("astar-bidirectional-pedestrian", index, countryFileFn, move(vehicleModelFactory), move(algorithm), move(directionsEngine)));
+  unique_ptr<IRouter> router(new RoadGraphRouter("astar-bidirectional-bicycle", index, countryFileFn, move(roadGraph), move(algorithm), move(directionsEngine)));
   return router;
 }
 
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "routing/directions_engine.hpp"
+#include "routing/isochrone.hpp"
 #include "routing/road_graph.hpp"
+#include "routing/road_graph_cross_search.hpp"
 #include "routing/router.hpp"
 #include "routing/routing_algorithm.hpp"
-#include "routing/vehicle_model.hpp"
 
 #include "indexer/mwm_set.hpp"
 
@@ -23,11 +24,14 @@ namespace routing
 class RoadGraphRouter : public IRouter
 {
 public:
+  /// @param crossSearch When not null, the routes between mwms are searched by the border
+  /// vertices of the mwms first, and by the algorithm when it finds no route.
   RoadGraphRouter(string const & name, Index & index,
                   TCountryFileFn const & countryFileFn,
-                  unique_ptr<IVehicleModelFactory> && vehicleModelFactory,
+                  unique_ptr<IRoadGraph> && roadGraph,
                   unique_ptr<IRoutingAlgorithm> && algorithm,
-                  unique_ptr<IDirectionsEngine> && directionsEngine);
+                  unique_ptr<IDirectionsEngine> && directionsEngine,
+                  unique_ptr<RoadGraphCrossSearch> && crossSearch = nullptr);
   ~RoadGraphRouter() override;
 
   // IRouter overrides:
@@ -36,6 +40,19 @@ public:
   ResultCode CalculateRoute(m2::PointD const & startPoint, m2::PointD const & startDirection,
                             m2::PointD const & finalPoint, RouterDelegate const & delegate,
                             Route & route) override;
+  RouteTimings GetLastRouteTimings() const override { return m_lastTimings; }
+
+  /// Finds the area which is reached from the point within maxSeconds, see IsochroneFinder.
+  /// The roads loaded by the search are kept for the next one, so it's cheap to recompute
+  /// the area as the point moves.
+  /// @param polygons Outlines of the area, see BuildIsochronePolygons().
+  ResultCode CalculateIsochrone(m2::PointD const & point, double maxSeconds, double cellMeters,
+                                RouterDelegate const & delegate,
+                                vector<vector<m2::PointD>> & polygons);
+
+  /// Sets the live traffic which is taken by the next routes, nullptr disables it.
+  /// The cache must outlive the router.
+  void SetTrafficCache(TrafficCache const * traffic) { m_traffic = traffic; }
 
 private:
   void ReconstructRoute(vector<Junction> && junctions, Route & route,
@@ -51,9 +68,22 @@ private:
   unique_ptr<IRoutingAlgorithm> const m_algorithm;
   unique_ptr<IRoadGraph> const m_roadGraph;
   unique_ptr<IDirectionsEngine> const m_directionsEngine;
+  unique_ptr<RoadGraphCrossSearch> const m_crossSearch;
+  TrafficCache const * m_traffic = nullptr;
+  RouteTimings m_lastTimings;
+
+  IsochroneFinder m_isochroneFinder;
+  // Traffic of the edges kept by m_isochroneFinder.
+  shared_ptr<TrafficCache::TSnapshot const> m_isochroneTraffic;
 };
 
+/// Pedestrian routes between mwms are searched by the pedestrian cross contexts of the mwms,
+/// see BuildPedestrianCrossContext().
 unique_ptr<IRouter> CreatePedestrianAStarRouter(Index & index, TCountryFileFn const & countryFileFn);
 
 unique_ptr<IRouter> CreatePedestrianAStarBidirectionalRouter(Index & index, TCountryFileFn const & countryFileFn);
+
+/// Bicycle routes are found in the bicycle road graph sections of mwms, see
+/// BuildBicycleRoadGraph(). Mwms without the section are routed through their features.
+unique_ptr<IRouter> CreateBicycleAStarBidirectionalRouter(Index & index, TCountryFileFn const & countryFileFn);
 }  // namespace routing
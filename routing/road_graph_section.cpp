@@ -0,0 +1,232 @@
+#include "routing/road_graph_section.hpp"
+
+#include "routing/aligned_section.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/algorithm.hpp"
+
+namespace routing
+{
+namespace
+{
+uint8_t constexpr kOneWayBit = 0x80;
+uint8_t constexpr kSpeedClassMask = 0x7F;
+
+inline uint64_t PointUToKey(m2::PointU const & pu)
+{
+  return (static_cast<uint64_t>(pu.x) << 32) | pu.y;
+}
+}  // namespace
+
+// static
+uint32_t constexpr RoadGraphSection::kVersion;
+// static
+uint32_t constexpr RoadGraphSection::kInvalidRoad;
+
+// static
+void RoadGraphSection::Serialize(TRoads const & roads, uint32_t coordBits, Writer & writer)
+{
+  vector<double> speeds;
+  for (auto const & road : roads)
+  {
+    ASSERT_GREATER(road.second.m_speedKMPH, 0.0, ());
+    speeds.push_back(road.second.m_speedKMPH);
+  }
+  sort(speeds.begin(), speeds.end());
+  speeds.erase(unique(speeds.begin(), speeds.end()), speeds.end());
+  CHECK_LESS_OR_EQUAL(speeds.size(), kSpeedClassMask + 1, ("Too many speed classes."));
+
+  vector<uint32_t> featureIds;
+  vector<uint32_t> pointOffsets = {0};
+  vector<uint8_t> roadFlags;
+  vector<uint32_t> points;
+  vector<pair<uint64_t, uint32_t>> incidences;
+  featureIds.reserve(roads.size());
+  roadFlags.reserve(roads.size());
+  for (auto const & road : roads)
+  {
+    IRoadGraph::RoadInfo const & ri = road.second;
+    ASSERT(featureIds.empty() || featureIds.back() < road.first, ("Roads must be sorted."));
+
+    uint32_t const roadIndex = static_cast<uint32_t>(featureIds.size());
+    featureIds.push_back(road.first);
+
+    auto const speedClass = lower_bound(speeds.begin(), speeds.end(), ri.m_speedKMPH) - speeds.begin();
+    roadFlags.push_back(static_cast<uint8_t>(speedClass) | (ri.m_bidirectional ? 0 : kOneWayBit));
+
+    for (m2::PointD const & point : ri.m_points)
+    {
+      m2::PointU const pu = PointD2PointU(point, coordBits);
+      points.push_back(pu.x);
+      points.push_back(pu.y);
+      incidences.emplace_back(PointUToKey(pu), roadIndex);
+    }
+    pointOffsets.push_back(static_cast<uint32_t>(points.size() / 2));
+  }
+
+  // Closed roads pass their first point twice.
+  sort(incidences.begin(), incidences.end());
+  incidences.erase(unique(incidences.begin(), incidences.end()), incidences.end());
+
+  vector<uint64_t> vertexKeys;
+  vector<uint32_t> incidenceOffsets;
+  vector<uint32_t> incidenceRoads;
+  incidenceRoads.reserve(incidences.size());
+  for (auto const & incidence : incidences)
+  {
+    if (vertexKeys.empty() || vertexKeys.back() != incidence.first)
+    {
+      vertexKeys.push_back(incidence.first);
+      incidenceOffsets.push_back(static_cast<uint32_t>(incidenceRoads.size()));
+    }
+    incidenceRoads.push_back(incidence.second);
+  }
+  incidenceOffsets.push_back(static_cast<uint32_t>(incidenceRoads.size()));
+
+  Header header;
+  header.m_version = kVersion;
+  header.m_coordBits = coordBits;
+  header.m_speedsCount = static_cast<uint32_t>(speeds.size());
+  header.m_roadsCount = static_cast<uint32_t>(featureIds.size());
+  header.m_pointsCount = static_cast<uint32_t>(points.size() / 2);
+  header.m_verticesCount = static_cast<uint32_t>(vertexKeys.size());
+  header.m_incidencesCount = static_cast<uint32_t>(incidenceRoads.size());
+  header.m_reserved = 0;
+
+  AlignedWriter aligned(writer);
+  aligned.WriteArray(vector<Header>{header});
+  aligned.WriteArray(speeds);
+  aligned.WriteArray(featureIds);
+  aligned.WriteArray(pointOffsets);
+  aligned.WriteArray(roadFlags);
+  aligned.WriteArray(points);
+  aligned.WriteArray(vertexKeys);
+  aligned.WriteArray(incidenceOffsets);
+  aligned.WriteArray(incidenceRoads);
+}
+
+bool RoadGraphSection::Map(FilesMappingContainer const & cont, string const & tag)
+{
+  if (!cont.IsExist(tag))
+    return false;
+
+  // Roads of a route search are spread over the whole section.
+  m_handle.Assign(cont.Map(tag, mmap_policy::Get(tag, mmap_policy::Random)));
+  if (Attach(m_handle.GetData<char>(), m_handle.GetSize()))
+    return true;
+
+  m_handle.Unmap();
+  return false;
+}
+
+bool RoadGraphSection::Attach(char const * data, uint64_t size)
+{
+  m_header = nullptr;
+  if (reinterpret_cast<uintptr_t>(data) % kSectionArrayAlignment != 0)
+  {
+    LOG(LWARNING, ("Road graph section is not aligned."));
+    return false;
+  }
+
+  AlignedReader reader(data, size);
+  Header const * header = nullptr;
+  if (!reader.ReadArray(1, header))
+    return false;
+  if (header->m_version != kVersion)
+  {
+    LOG(LWARNING, ("Unsupported road graph section version:", header->m_version));
+    return false;
+  }
+
+  bool const ok = reader.ReadArray(header->m_speedsCount, m_speeds) &&
+                  reader.ReadArray(header->m_roadsCount, m_featureIds) &&
+                  reader.ReadArray(static_cast<uint64_t>(header->m_roadsCount) + 1, m_pointOffsets) &&
+                  reader.ReadArray(header->m_roadsCount, m_roadFlags) &&
+                  reader.ReadArray(2 * static_cast<uint64_t>(header->m_pointsCount), m_points) &&
+                  reader.ReadArray(header->m_verticesCount, m_vertexKeys) &&
+                  reader.ReadArray(static_cast<uint64_t>(header->m_verticesCount) + 1, m_incidenceOffsets) &&
+                  reader.ReadArray(header->m_incidencesCount, m_incidences) && reader.IsEnd();
+  if (!ok)
+  {
+    LOG(LWARNING, ("Road graph section is malformed."));
+    return false;
+  }
+
+  m_header = header;
+  return true;
+}
+
+uint32_t RoadGraphSection::FindRoad(uint32_t featureId) const
+{
+  uint32_t const * end = m_featureIds + GetRoadsCount();
+  uint32_t const * it = lower_bound(m_featureIds, end, featureId);
+  if (it == end || *it != featureId)
+    return kInvalidRoad;
+  return static_cast<uint32_t>(it - m_featureIds);
+}
+
+double RoadGraphSection::GetSpeedKMPH(uint32_t road) const
+{
+  ASSERT_LESS(road, GetRoadsCount(), ());
+  uint8_t const speedClass = m_roadFlags[road] & kSpeedClassMask;
+  ASSERT_LESS(speedClass, m_header->m_speedsCount, ());
+  return m_speeds[speedClass];
+}
+
+void RoadGraphSection::GetRoadInfo(uint32_t road, IRoadGraph::RoadInfo & ri) const
+{
+  ASSERT_LESS(road, GetRoadsCount(), ());
+  ri.m_speedKMPH = GetSpeedKMPH(road);
+  ri.m_bidirectional = (m_roadFlags[road] & kOneWayBit) == 0;
+
+  uint32_t const begin = m_pointOffsets[road];
+  uint32_t const end = m_pointOffsets[road + 1];
+  ri.m_points.clear();
+  ri.m_points.reserve(end - begin);
+  for (uint32_t i = begin; i < end; ++i)
+  {
+    m2::PointU const pu(m_points[2 * i], m_points[2 * i + 1]);
+    ri.m_points.push_back(PointU2PointD(pu, m_header->m_coordBits));
+  }
+}
+
+void RoadGraphSection::CollectRoadsAtPoint(m2::PointD const & point,
+                                           buffer_vector<uint32_t, 8> & roads) const
+{
+  roads.clear();
+  if (IsEmpty())
+    return;
+
+  // Quantization is monotonic, so all the vertices which are equal to the point
+  // with the epsilon are in the box of quantized corners.
+  m2::PointD const eps(kPointsEqualEpsilon, kPointsEqualEpsilon);
+  m2::PointU const lo = PointD2PointU(point - eps, m_header->m_coordBits);
+  m2::PointU const hi = PointD2PointU(point + eps, m_header->m_coordBits);
+
+  uint64_t const * keysEnd = m_vertexKeys + m_header->m_verticesCount;
+  for (uint64_t x = lo.x; x <= hi.x; ++x)
+  {
+    uint64_t const * it = lower_bound(m_vertexKeys, keysEnd, PointUToKey(m2::PointU(x, lo.y)));
+    uint64_t const last = PointUToKey(m2::PointU(x, hi.y));
+    for (; it != keysEnd && *it <= last; ++it)
+    {
+      size_t const vertex = it - m_vertexKeys;
+      for (uint32_t i = m_incidenceOffsets[vertex]; i < m_incidenceOffsets[vertex + 1]; ++i)
+        roads.push_back(m_incidences[i]);
+    }
+  }
+
+  if (roads.size() > 1)
+  {
+    sort(roads.begin(), roads.end());
+    roads.resize(distance(roads.begin(), unique(roads.begin(), roads.end())));
+  }
+}
+
+}  // namespace routing
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "routing/road_graph.hpp"
+
+#include "coding/file_container.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/buffer_vector.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/limits.hpp"
+#include "std/string.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+namespace routing
+{
+
+/// RoadGraphSection is a precomputed adjacency of the roads of a single mwm for some
+/// vehicle model. It keeps quantized road geometry, speed classes and oneway bits
+/// of the roads, and a CSR index from the road vertices to the roads passing through them,
+/// so loading outgoing edges of a junction doesn't need a spatial query and feature decoding.
+///
+/// All data are fixed-width arrays aligned by 8 bytes, so the section is used in place,
+/// being mapped to memory from the mwm.
+class RoadGraphSection
+{
+public:
+  /// First value is the index of the feature in the mwm.
+  using TRoads = vector<pair<uint32_t, IRoadGraph::RoadInfo>>;
+
+  static uint32_t constexpr kVersion = 0;
+  static uint32_t constexpr kInvalidRoad = numeric_limits<uint32_t>::max();
+
+  /// Writes the section for roads with positive speeds.
+  /// Roads must be sorted by feature indices.
+  static void Serialize(TRoads const & roads, uint32_t coordBits, Writer & writer);
+
+  /// Maps the section of the container to memory.
+  /// @return False when the section is absent or malformed.
+  bool Map(FilesMappingContainer const & cont, string const & tag);
+
+  /// Uses the section data kept by the caller. The data must be aligned by 8 bytes
+  /// and must outlive the section.
+  /// @return False when the data are malformed.
+  bool Attach(char const * data, uint64_t size);
+
+  inline bool IsEmpty() const { return m_header == nullptr || m_header->m_roadsCount == 0; }
+  inline uint32_t GetRoadsCount() const { return m_header ? m_header->m_roadsCount : 0; }
+  inline uint32_t GetFeatureId(uint32_t road) const { return m_featureIds[road]; }
+
+  /// @return Index of the road of the feature, or kInvalidRoad when the feature isn't a road.
+  uint32_t FindRoad(uint32_t featureId) const;
+
+  double GetSpeedKMPH(uint32_t road) const;
+  void GetRoadInfo(uint32_t road, IRoadGraph::RoadInfo & ri) const;
+
+  /// Calls fn(road) once for each road having a point which is equal to the point
+  /// with IRoadGraph's junction epsilon.
+  template <typename TFn>
+  void ForEachRoadAtPoint(m2::PointD const & point, TFn && fn) const
+  {
+    buffer_vector<uint32_t, 8> roads;
+    CollectRoadsAtPoint(point, roads);
+    for (uint32_t const road : roads)
+      fn(road);
+  }
+
+private:
+  struct Header
+  {
+    uint32_t m_version;
+    uint32_t m_coordBits;
+    uint32_t m_speedsCount;
+    uint32_t m_roadsCount;
+    uint32_t m_pointsCount;
+    uint32_t m_verticesCount;
+    uint32_t m_incidencesCount;
+    uint32_t m_reserved;
+  };
+
+  void CollectRoadsAtPoint(m2::PointD const & point, buffer_vector<uint32_t, 8> & roads) const;
+
+  FilesMappingContainer::Handle m_handle;
+
+  Header const * m_header = nullptr;
+  // Speeds of speed classes in KM/H.
+  double const * m_speeds = nullptr;
+  // Sorted feature indices of the roads.
+  uint32_t const * m_featureIds = nullptr;
+  // Points of the i-th road are [m_pointOffsets[i], m_pointOffsets[i + 1]).
+  uint32_t const * m_pointOffsets = nullptr;
+  // Speed class of a road in low 7 bits, the high bit is set for oneway roads.
+  uint8_t const * m_roadFlags = nullptr;
+  // Quantized points, x and y are interleaved.
+  uint32_t const * m_points = nullptr;
+  // Sorted keys of quantized vertices' points, see PointUToKey().
+  uint64_t const * m_vertexKeys = nullptr;
+  // Roads passing through the i-th vertex are [m_incidenceOffsets[i], m_incidenceOffsets[i + 1]).
+  uint32_t const * m_incidenceOffsets = nullptr;
+  uint32_t const * m_incidences = nullptr;
+};
+
+}  // namespace routing
@@ -0,0 +1,99 @@
+#include "routing/road_info_cache.hpp"
+
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/sstream.hpp"
+
+namespace routing
+{
+namespace
+{
+// Approximate memory of an entry in the cache arrays.
+size_t constexpr kEntryOverheadBytes = 64;
+
+// Capacity of the static buffer of IRoadGraph::RoadInfo::m_points.
+size_t constexpr kStaticPointsCount = 32;
+}  // namespace
+
+// static
+size_t constexpr RoadInfoCache::kDefaultMaxBytes;
+// static
+size_t constexpr RoadInfoCache::kShardsCount;
+
+size_t RoadInfoCache::FeatureIDHash::operator()(FeatureID const & featureId) const
+{
+  return my::Hash(featureId.m_mwmId.GetInfo().get(), featureId.m_index);
+}
+
+RoadInfoCache::RoadInfoCache(size_t maxBytes) : m_maxBytes(maxBytes)
+{
+  // Each shard keeps as many roads as fit the limit when the roads are the smallest ones.
+  size_t const minRoadBytes = sizeof(IRoadGraph::RoadInfo) + kEntryOverheadBytes;
+  size_t const count = max(GetShardMaxBytes() / minRoadBytes, size_t(1));
+  for (auto & shard : m_shards)
+    shard.reset(new TShard(count, GetShardMaxBytes()));
+}
+
+RoadInfoCache::TRoadInfoPtr RoadInfoCache::Find(FeatureID const & featureId)
+{
+  TRoadInfoPtr roadInfo;
+  GetShard(featureId).Find(featureId, roadInfo);
+  return roadInfo;
+}
+
+void RoadInfoCache::Insert(FeatureID const & featureId, TRoadInfoPtr const & roadInfo)
+{
+  ASSERT(roadInfo, ());
+  // The road may be decoded by another thread meanwhile, then it's replaced.
+  GetShard(featureId).Insert(featureId, roadInfo);
+}
+
+void RoadInfoCache::SetMaxBytes(size_t maxBytes)
+{
+  m_maxBytes = maxBytes;
+  for (auto & shard : m_shards)
+    shard->SetMaxWeight(GetShardMaxBytes());
+}
+
+void RoadInfoCache::Clear()
+{
+  for (auto & shard : m_shards)
+    shard->Clear();
+}
+
+RoadInfoCache::Stats RoadInfoCache::GetStats() const
+{
+  Stats stats;
+  for (auto const & shard : m_shards)
+  {
+    my::cache::Stats const shardStats = shard->GetStats();
+    stats.m_hits += shardStats.m_hits;
+    stats.m_misses += shardStats.m_misses;
+    stats.m_evictions += shardStats.m_evictions;
+    stats.m_roadsCount += shardStats.m_count;
+    stats.m_bytes += shardStats.m_weight;
+  }
+  return stats;
+}
+
+// static
+size_t RoadInfoCache::GetRoadInfoBytes(IRoadGraph::RoadInfo const & roadInfo)
+{
+  size_t bytes = sizeof(IRoadGraph::RoadInfo) + kEntryOverheadBytes;
+  // Points which don't fit the static buffer are kept in the heap.
+  if (roadInfo.m_points.size() > kStaticPointsCount)
+    bytes += roadInfo.m_points.size() * sizeof(m2::PointD);
+  return bytes;
+}
+
+string DebugPrint(RoadInfoCache::Stats const & stats)
+{
+  ostringstream out;
+  out << "RoadInfoCache::Stats [ hits: " << stats.m_hits << ", misses: " << stats.m_misses
+      << ", evictions: " << stats.m_evictions << ", roads: " << stats.m_roadsCount
+      << ", bytes: " << stats.m_bytes << " ]";
+  return out.str();
+}
+
+}  // namespace routing
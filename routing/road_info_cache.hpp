@@ -0,0 +1,93 @@
+#pragma once
+
+#include "routing/road_graph.hpp"
+
+#include "indexer/feature_decl.hpp"
+
+#include "base/cache.hpp"
+
+#include "std/array.hpp"
+#include "std/atomic.hpp"
+#include "std/cstdint.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/string.hpp"
+#include "std/unique_ptr.hpp"
+
+namespace routing
+{
+
+/// RoadInfoCache keeps decoded roads of features, so they are reused by route rebuilds
+/// and by all road graphs which share the cache. The cache is thread-safe and bounded
+/// by an approximate size of kept roads in bytes; roads are evicted by CLOCK, so the roads
+/// which are found since the last pass of the clock hand are kept.
+/// @note Roads depend on a vehicle model, so a cache may be shared by graphs
+///       with the same vehicle model only.
+class RoadInfoCache
+{
+public:
+  using TRoadInfoPtr = shared_ptr<IRoadGraph::RoadInfo const>;
+
+  struct Stats
+  {
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+    size_t m_roadsCount = 0;
+    size_t m_bytes = 0;
+  };
+
+  static size_t constexpr kDefaultMaxBytes = 16 * 1024 * 1024;
+
+  explicit RoadInfoCache(size_t maxBytes = kDefaultMaxBytes);
+
+  /// @return Cached road of the feature or nullptr.
+  TRoadInfoPtr Find(FeatureID const & featureId);
+
+  /// Puts the road into the cache and evicts other roads when the size of the cache
+  /// exceeds the limit.
+  void Insert(FeatureID const & featureId, TRoadInfoPtr const & roadInfo);
+
+  /// Changes the limit, roads are evicted when they don't fit it. The number of the roads
+  /// is bounded by the limit which is passed to the constructor too.
+  void SetMaxBytes(size_t maxBytes);
+  inline size_t GetMaxBytes() const { return m_maxBytes; }
+
+  void Clear();
+
+  Stats GetStats() const;
+
+  /// @return Approximate memory used by the road in the cache.
+  static size_t GetRoadInfoBytes(IRoadGraph::RoadInfo const & roadInfo);
+
+private:
+  struct FeatureIDHash
+  {
+    size_t operator()(FeatureID const & featureId) const;
+  };
+
+  struct RoadInfoBytes
+  {
+    size_t operator()(TRoadInfoPtr const & roadInfo) const { return GetRoadInfoBytes(*roadInfo); }
+  };
+
+  // Roads are distributed between independently locked shards to reduce contention.
+  using TShard =
+      my::SetAssociativeCache<FeatureID, TRoadInfoPtr, FeatureIDHash, RoadInfoBytes, mutex>;
+
+  static size_t constexpr kShardsCount = 8;
+
+  inline TShard & GetShard(FeatureID const & featureId)
+  {
+    return *m_shards[FeatureIDHash()(featureId) % kShardsCount];
+  }
+
+  inline size_t GetShardMaxBytes() const { return m_maxBytes / kShardsCount; }
+
+  array<unique_ptr<TShard>, kShardsCount> m_shards;
+  atomic<size_t> m_maxBytes;
+};
+
+string DebugPrint(RoadInfoCache::Stats const & stats);
+
+}  // namespace routing
@@ -0,0 +1,375 @@
+#include "routing/road_segments_index.hpp"
+
+#include "routing/aligned_section.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "geometry/distance.hpp"
+
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/numeric.hpp"
+#include "std/queue.hpp"
+
+namespace routing
+{
+namespace
+{
+struct Box
+{
+  Box() = default;
+  Box(m2::PointU const & p1, m2::PointU const & p2)
+    : m_minX(min(p1.x, p2.x)), m_minY(min(p1.y, p2.y)), m_maxX(max(p1.x, p2.x)),
+      m_maxY(max(p1.y, p2.y))
+  {
+  }
+
+  void Add(Box const & box)
+  {
+    m_minX = min(m_minX, box.m_minX);
+    m_minY = min(m_minY, box.m_minY);
+    m_maxX = max(m_maxX, box.m_maxX);
+    m_maxY = max(m_maxY, box.m_maxY);
+  }
+
+  // Doubled coordinates of the center.
+  inline uint64_t GetCenterX() const { return static_cast<uint64_t>(m_minX) + m_maxX; }
+  inline uint64_t GetCenterY() const { return static_cast<uint64_t>(m_minY) + m_maxY; }
+
+  uint32_t m_minX = 0, m_minY = 0, m_maxX = 0, m_maxY = 0;
+};
+
+/// @return Order of the boxes by Sort-Tile-Recursive: the boxes are sorted by x of the centers
+/// and are cut to the vertical slices, which are sorted by y, so each run of the capacity
+/// consecutive boxes is compact.
+vector<uint32_t> SortTileRecursive(vector<Box> const & boxes)
+{
+  size_t const capacity = RoadSegmentsIndex::kNodeCapacity;
+  vector<uint32_t> order(boxes.size());
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(), [&boxes](uint32_t lhs, uint32_t rhs)
+  {
+    return boxes[lhs].GetCenterX() < boxes[rhs].GetCenterX();
+  });
+
+  size_t const nodesCount = (boxes.size() + capacity - 1) / capacity;
+  size_t const slicesCount = static_cast<size_t>(ceil(sqrt(static_cast<double>(nodesCount))));
+  if (slicesCount == 0)
+    return order;
+
+  size_t const sliceSize = (nodesCount + slicesCount - 1) / slicesCount * capacity;
+  for (size_t begin = 0; begin < order.size(); begin += sliceSize)
+  {
+    size_t const end = min(order.size(), begin + sliceSize);
+    sort(order.begin() + begin, order.begin() + end, [&boxes](uint32_t lhs, uint32_t rhs)
+    {
+      return boxes[lhs].GetCenterY() < boxes[rhs].GetCenterY();
+    });
+  }
+  return order;
+}
+
+template <typename T>
+void Permute(vector<uint32_t> const & order, vector<T> & values)
+{
+  vector<T> permuted;
+  permuted.reserve(values.size());
+  for (uint32_t const i : order)
+    permuted.push_back(values[i]);
+  values.swap(permuted);
+}
+
+struct Level
+{
+  vector<Box> m_boxes;
+  // Children ranges in the lower level, or in the segments for the leaves.
+  vector<pair<uint32_t, uint32_t>> m_children;
+};
+
+/// Entry of the k-NN query: a node with the distance to its box, or a segment with
+/// the distance to it.
+struct QueueEntry
+{
+  QueueEntry(double squaredDistance, uint32_t index, bool isSegment)
+    : m_squaredDistance(squaredDistance), m_index(index), m_isSegment(isSegment)
+  {
+  }
+
+  // The nearest entry is on the top of priority_queue.
+  bool operator<(QueueEntry const & rhs) const
+  {
+    return m_squaredDistance > rhs.m_squaredDistance;
+  }
+
+  double m_squaredDistance;
+  uint32_t m_index;
+  bool m_isSegment;
+};
+
+m2::PointD Project(RoadSegmentsIndex::Segment const & segment, m2::PointD const & point)
+{
+  m2::ProjectionToSection<m2::PointD> proj;
+  proj.SetBounds(segment.m_p1, segment.m_p2);
+  return proj(point);
+}
+}  // namespace
+
+// static
+uint32_t constexpr RoadSegmentsIndex::kVersion;
+// static
+uint32_t constexpr RoadSegmentsIndex::kNodeCapacity;
+
+RoadSegmentsIndex::Segment::Segment(uint32_t fid, uint32_t segIdx, m2::PointD const & p1,
+                                    m2::PointD const & p2)
+  : m_p1(p1), m_p2(p2)
+{
+  m_seg.m_fid = fid;
+  m_seg.m_pointStart = static_cast<uint16_t>(segIdx);
+  m_seg.m_pointEnd = static_cast<uint16_t>(segIdx + 1);
+}
+
+// static
+void RoadSegmentsIndex::Serialize(vector<Segment> const & segments, uint32_t coordBits,
+                                  Writer & writer)
+{
+  vector<Box> boxes;
+  vector<OsrmMappingTypes::FtSeg> segs;
+  vector<uint32_t> points;
+  vector<TOsrmNodeId> nodeIds;
+  boxes.reserve(segments.size());
+  segs.reserve(segments.size());
+  for (Segment const & segment : segments)
+  {
+    m2::PointU const p1 = PointD2PointU(segment.m_p1, coordBits);
+    m2::PointU const p2 = PointD2PointU(segment.m_p2, coordBits);
+    boxes.emplace_back(p1, p2);
+    segs.push_back(segment.m_seg);
+  }
+
+  vector<uint32_t> order = SortTileRecursive(boxes);
+  Permute(order, boxes);
+  Permute(order, segs);
+  points.reserve(4 * order.size());
+  nodeIds.reserve(2 * order.size());
+  for (uint32_t const i : order)
+  {
+    m2::PointU const p1 = PointD2PointU(segments[i].m_p1, coordBits);
+    m2::PointU const p2 = PointD2PointU(segments[i].m_p2, coordBits);
+    points.insert(points.end(), {p1.x, p1.y, p2.x, p2.y});
+    nodeIds.push_back(segments[i].m_forwardNodeId);
+    nodeIds.push_back(segments[i].m_reverseNodeId);
+  }
+
+  // Levels are built from the leaves up to the root.
+  vector<Level> levels;
+  vector<Box> const * lower = &boxes;
+  while (!lower->empty() && (levels.empty() || lower->size() > 1))
+  {
+    Level level;
+    for (size_t begin = 0; begin < lower->size(); begin += kNodeCapacity)
+    {
+      size_t const end = min(lower->size(), begin + kNodeCapacity);
+      Box box = (*lower)[begin];
+      for (size_t i = begin + 1; i < end; ++i)
+        box.Add((*lower)[i]);
+      level.m_boxes.push_back(box);
+      level.m_children.emplace_back(static_cast<uint32_t>(begin), static_cast<uint32_t>(end));
+    }
+    if (level.m_boxes.size() > 1)
+    {
+      order = SortTileRecursive(level.m_boxes);
+      Permute(order, level.m_boxes);
+      Permute(order, level.m_children);
+    }
+    levels.push_back(move(level));
+    lower = &levels.back().m_boxes;
+  }
+
+  // Nodes are written from the root down to the leaves.
+  vector<uint32_t> nodeBoxes;
+  vector<uint32_t> children;
+  uint32_t nodesCount = 0;
+  for (auto it = levels.rbegin(); it != levels.rend(); ++it)
+  {
+    // Children of the inner nodes are the nodes of the next level.
+    uint32_t const childrenOffset =
+        (it + 1 == levels.rend()) ? 0 : nodesCount + static_cast<uint32_t>(it->m_boxes.size());
+    for (size_t i = 0; i < it->m_boxes.size(); ++i)
+    {
+      Box const & box = it->m_boxes[i];
+      nodeBoxes.insert(nodeBoxes.end(), {box.m_minX, box.m_minY, box.m_maxX, box.m_maxY});
+      children.push_back(childrenOffset + it->m_children[i].first);
+      children.push_back(childrenOffset + it->m_children[i].second);
+    }
+    nodesCount += static_cast<uint32_t>(it->m_boxes.size());
+  }
+
+  Header header;
+  header.m_version = kVersion;
+  header.m_coordBits = coordBits;
+  header.m_segmentsCount = static_cast<uint32_t>(segs.size());
+  header.m_nodesCount = nodesCount;
+  header.m_leavesBegin =
+      levels.empty() ? 0 : nodesCount - static_cast<uint32_t>(levels.front().m_boxes.size());
+  header.m_reserved = 0;
+
+  AlignedWriter aligned(writer);
+  aligned.WriteArray(vector<Header>{header});
+  aligned.WriteArray(nodeBoxes);
+  aligned.WriteArray(children);
+  aligned.WriteArray(segs);
+  aligned.WriteArray(points);
+  aligned.WriteArray(nodeIds);
+}
+
+bool RoadSegmentsIndex::Map(FilesMappingContainer const & cont, string const & tag)
+{
+  if (!cont.IsExist(tag))
+    return false;
+
+  // Tree nodes are looked up at random.
+  m_handle.Assign(cont.Map(tag, mmap_policy::Get(tag, mmap_policy::Random)));
+  if (Attach(m_handle.GetData<char>(), m_handle.GetSize()))
+    return true;
+
+  Unmap();
+  return false;
+}
+
+void RoadSegmentsIndex::Unmap()
+{
+  m_header = nullptr;
+  if (m_handle.IsValid())
+    m_handle.Unmap();
+}
+
+bool RoadSegmentsIndex::Attach(char const * data, uint64_t size)
+{
+  m_header = nullptr;
+  if (reinterpret_cast<uintptr_t>(data) % kSectionArrayAlignment != 0)
+  {
+    LOG(LWARNING, ("Road segments index is not aligned."));
+    return false;
+  }
+
+  AlignedReader reader(data, size);
+  Header const * header = nullptr;
+  if (!reader.ReadArray(1, header))
+    return false;
+  if (header->m_version != kVersion)
+  {
+    LOG(LWARNING, ("Unsupported road segments index version:", header->m_version));
+    return false;
+  }
+
+  uint64_t const nodesCount = header->m_nodesCount;
+  uint64_t const segmentsCount = header->m_segmentsCount;
+  bool const ok = header->m_leavesBegin <= header->m_nodesCount &&
+                  (nodesCount != 0 || segmentsCount == 0) &&
+                  reader.ReadArray(4 * nodesCount, m_boxes) &&
+                  reader.ReadArray(2 * nodesCount, m_children) &&
+                  reader.ReadArray(segmentsCount, m_segs) &&
+                  reader.ReadArray(4 * segmentsCount, m_points) &&
+                  reader.ReadArray(2 * segmentsCount, m_nodeIds) && reader.IsEnd();
+  if (!ok)
+  {
+    LOG(LWARNING, ("Road segments index is malformed."));
+    return false;
+  }
+
+  m_header = header;
+  return true;
+}
+
+void RoadSegmentsIndex::FindNearest(m2::PointD const & point, double maxDistance,
+                                    size_t maxCount, vector<Projection> & res) const
+{
+  res.clear();
+  if (IsEmpty() || maxCount == 0)
+    return;
+
+  double const maxSquaredDistance = maxDistance * maxDistance;
+  // Distances to the boxes are the lower bounds of the distances to their segments,
+  // so the segments are taken from the queue in the order of their distances.
+  priority_queue<QueueEntry> queue;
+  queue.emplace(GetSquaredDistanceToNode(point, 0), 0, false /* isSegment */);
+  vector<uint32_t> features;
+  while (!queue.empty())
+  {
+    QueueEntry const entry = queue.top();
+    queue.pop();
+    if (entry.m_squaredDistance > maxSquaredDistance)
+      break;
+
+    if (entry.m_isSegment)
+    {
+      Segment const segment = GetSegment(entry.m_index);
+      uint32_t const fid = segment.m_seg.m_fid;
+      if (find(features.begin(), features.end(), fid) != features.end())
+        continue;
+      features.push_back(fid);
+
+      Projection projection;
+      projection.m_segment = segment;
+      projection.m_point = Project(segment, point);
+      projection.m_squaredDistance = entry.m_squaredDistance;
+      res.push_back(projection);
+      if (res.size() == maxCount)
+        break;
+      continue;
+    }
+
+    uint32_t const node = entry.m_index;
+    uint32_t const begin = m_children[2 * node];
+    uint32_t const end = m_children[2 * node + 1];
+    if (node >= m_header->m_leavesBegin)
+    {
+      for (uint32_t i = begin; i < end; ++i)
+      {
+        double const d = point.SquareLength(Project(GetSegment(i), point));
+        if (d <= maxSquaredDistance)
+          queue.emplace(d, i, true /* isSegment */);
+      }
+    }
+    else
+    {
+      for (uint32_t i = begin; i < end; ++i)
+      {
+        double const d = GetSquaredDistanceToNode(point, i);
+        if (d <= maxSquaredDistance)
+          queue.emplace(d, i, false /* isSegment */);
+      }
+    }
+  }
+}
+
+RoadSegmentsIndex::Segment RoadSegmentsIndex::GetSegment(uint32_t segment) const
+{
+  ASSERT_LESS(segment, GetSegmentsCount(), ());
+  uint32_t const * p = m_points + 4 * segment;
+  Segment res;
+  res.m_seg = m_segs[segment];
+  res.m_p1 = PointU2PointD(m2::PointU(p[0], p[1]), m_header->m_coordBits);
+  res.m_p2 = PointU2PointD(m2::PointU(p[2], p[3]), m_header->m_coordBits);
+  res.m_forwardNodeId = m_nodeIds[2 * segment];
+  res.m_reverseNodeId = m_nodeIds[2 * segment + 1];
+  return res;
+}
+
+double RoadSegmentsIndex::GetSquaredDistanceToNode(m2::PointD const & point, uint32_t node) const
+{
+  ASSERT_LESS(node, m_header->m_nodesCount, ());
+  uint32_t const * box = m_boxes + 4 * node;
+  m2::PointD const lo = PointU2PointD(m2::PointU(box[0], box[1]), m_header->m_coordBits);
+  m2::PointD const hi = PointU2PointD(m2::PointU(box[2], box[3]), m_header->m_coordBits);
+  double const dx = max(0.0, max(lo.x - point.x, point.x - hi.x));
+  double const dy = max(0.0, max(lo.y - point.y, point.y - hi.y));
+  return dx * dx + dy * dy;
+}
+
+}  // namespace routing
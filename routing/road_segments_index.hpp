@@ -0,0 +1,108 @@
+#pragma once
+
+#include "routing/osrm2feature_map.hpp"
+
+#include "coding/file_container.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+namespace routing
+{
+
+/// RoadSegmentsIndex is a packed R-tree of the road segments of the OSRM nodes of a single mwm.
+/// Each segment is a pair of consecutive feature points, it's kept with its FtSeg and the ids
+/// of the forward and reverse nodes passing through it. Points are quantized as the feature
+/// geometry, so the nearest roads of a point, their projections and nodes are found by a k-NN
+/// query without the feature decoding and the lookups of OsrmFtSegMapping.
+///
+/// The tree is packed by Sort-Tile-Recursive: each leaf keeps up to kNodeCapacity segments
+/// close to each other, and the upper levels are built from the lower ones the same way.
+/// As in RoadGraphSection, all data are fixed-width arrays aligned by 8 bytes, so the section
+/// is used in place, being mapped to memory from the routing file.
+class RoadSegmentsIndex
+{
+public:
+  struct Segment
+  {
+    Segment() = default;
+    Segment(uint32_t fid, uint32_t segIdx, m2::PointD const & p1, m2::PointD const & p2);
+
+    /// Segment is from the point m_pointStart to the point m_pointEnd == m_pointStart + 1.
+    OsrmMappingTypes::FtSeg m_seg;
+    m2::PointD m_p1, m_p2;
+    /// Nodes whose segments go from m_p1 to m_p2 and back, INVALID_NODE_ID when absent.
+    TOsrmNodeId m_forwardNodeId = INVALID_NODE_ID;
+    TOsrmNodeId m_reverseNodeId = INVALID_NODE_ID;
+  };
+
+  struct Projection
+  {
+    Segment m_segment;
+    /// Nearest point of the segment.
+    m2::PointD m_point;
+    double m_squaredDistance = 0.0;
+  };
+
+  static uint32_t constexpr kVersion = 0;
+  static uint32_t constexpr kNodeCapacity = 16;
+
+  /// Writes the section, segments must have unique FtSegs.
+  static void Serialize(vector<Segment> const & segments, uint32_t coordBits, Writer & writer);
+
+  /// Maps the section of the container to memory.
+  /// @return False when the section is absent or malformed.
+  bool Map(FilesMappingContainer const & cont, string const & tag);
+  void Unmap();
+
+  /// Uses the section data kept by the caller. The data must be aligned by 8 bytes
+  /// and must outlive the index.
+  /// @return False when the data are malformed.
+  bool Attach(char const * data, uint64_t size);
+
+  inline bool IsEmpty() const { return m_header == nullptr || m_header->m_segmentsCount == 0; }
+  inline uint32_t GetSegmentsCount() const { return m_header ? m_header->m_segmentsCount : 0; }
+
+  /// Finds the nearest segments of at most maxCount features which are not farther than
+  /// maxDistance from the point, one segment per feature, as Index::ForEachInRect and the
+  /// projection to every road did. Projections are sorted by the distances.
+  void FindNearest(m2::PointD const & point, double maxDistance, size_t maxCount,
+                   vector<Projection> & res) const;
+
+private:
+  struct Header
+  {
+    uint32_t m_version;
+    uint32_t m_coordBits;
+    uint32_t m_segmentsCount;
+    uint32_t m_nodesCount;
+    // Nodes [m_leavesBegin, m_nodesCount) are the leaves, the root is the first node.
+    uint32_t m_leavesBegin;
+    uint32_t m_reserved;
+  };
+
+  Segment GetSegment(uint32_t segment) const;
+  double GetSquaredDistanceToNode(m2::PointD const & point, uint32_t node) const;
+
+  FilesMappingContainer::Handle m_handle;
+
+  Header const * m_header = nullptr;
+  // Quantized boxes of the nodes, min x, min y, max x and max y are interleaved.
+  uint32_t const * m_boxes = nullptr;
+  // Children of the i-th node are [m_children[2 * i], m_children[2 * i + 1]), they're nodes
+  // for the inner nodes and segments for the leaves.
+  uint32_t const * m_children = nullptr;
+  OsrmMappingTypes::FtSeg const * m_segs = nullptr;
+  // Quantized points of the segments, x1, y1, x2 and y2 are interleaved.
+  uint32_t const * m_points = nullptr;
+  // Forward and reverse nodes of the segments are interleaved.
+  TOsrmNodeId const * m_nodeIds = nullptr;
+};
+
+}  // namespace routing
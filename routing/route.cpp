@@ -2,6 +2,7 @@
 #include "turns_generator.hpp"
 
 #include "indexer/mercator.hpp"
+#include "indexer/point_to_int64.hpp"
 
 #include "platform/location.hpp"
 
@@ -9,11 +10,19 @@
 #include "geometry/point2d.hpp"
 #include "geometry/simplification.hpp"
 
+#include "coding/reader.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/varint.hpp"
+#include "coding/writer.hpp"
+
 #include "base/logging.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/cstring.hpp"
+#include "std/map.hpp"
 #include "std/numeric.hpp"
 #include "std/utility.hpp"
-#include "std/algorithm.hpp"
 
 
 namespace routing
@@ -23,6 +32,68 @@ namespace
 double constexpr kLocationTimeThreshold = 60.0 * 1.0;
 double constexpr kOnEndToleranceM = 10.0;
 
+uint32_t constexpr kSerializationVersion = 0;
+// Times are written in milliseconds.
+double constexpr kTimeUnitsPerSecond = 1000.0;
+
+/// Source over the restored data, it throws on the reads past the end instead of the asserts
+/// of MemReader, so the malformed data are rejected in all builds.
+class CheckedSource
+{
+public:
+  explicit CheckedSource(vector<uint8_t> const & data)
+    : m_pos(data.data()), m_end(data.data() + data.size())
+  {
+  }
+
+  void Read(void * p, size_t size)
+  {
+    if (size > Size())
+      MYTHROW(Reader::SizeException, (size, Size()));
+    memcpy(p, m_pos, size);
+    m_pos += size;
+  }
+
+  inline size_t Size() const { return static_cast<size_t>(m_end - m_pos); }
+
+private:
+  uint8_t const * m_pos;
+  uint8_t const * const m_end;
+};
+
+/// @return Count of the elements, each of them takes a byte at least, so the count of
+/// the malformed data doesn't make huge allocations.
+uint32_t ReadCount(CheckedSource & src)
+{
+  uint32_t const count = ReadVarUint<uint32_t>(src);
+  if (count > src.Size())
+    MYTHROW(Reader::SizeException, (count, src.Size()));
+  return count;
+}
+
+template <class TEnum>
+void WriteEnum(Writer & writer, TEnum value)
+{
+  WriteToSink(writer, static_cast<uint8_t>(value));
+}
+
+template <class TEnum>
+TEnum ReadEnum(CheckedSource & src)
+{
+  uint8_t const value = ReadPrimitiveFromSource<uint8_t>(src);
+  if (value >= static_cast<uint8_t>(TEnum::Count))
+    MYTHROW(Reader::ReadException, ("Unknown value", value));
+  return static_cast<TEnum>(value);
+}
+
+/// Index of the point of the turn or of the time, they go in the order of the points.
+uint32_t ReadPointIndex(CheckedSource & src, uint32_t prev, uint32_t pointsCount)
+{
+  uint32_t const delta = ReadVarUint<uint32_t>(src);
+  if (delta >= pointsCount - prev)
+    MYTHROW(Reader::ReadException, ("Point index is out of range", prev, delta, pointsCount));
+  return prev + delta;
+}
 }  //  namespace
 
 Route::Route(string const & router, vector<m2::PointD> const & points, string const & name)
@@ -60,14 +131,14 @@ void Route::GetTurnsDistances(vector<double> & distances) const
   double mercatorDistance = 0;
   distances.clear();
   auto const & polyline = m_poly.GetPolyline();
-  for (auto currentTurn = m_turns.begin(); currentTurn != m_turns.end(); ++currentTurn)
+  for (auto currentTurn = m_turns->begin(); currentTurn != m_turns->end(); ++currentTurn)
   {
     // Skip turns at side points of the polyline geometry. We can't display them properly.
     if (currentTurn->m_index == 0 || currentTurn->m_index == (polyline.GetSize() - 1))
       continue;
 
     uint32_t formerTurnIndex = 0;
-    if (currentTurn != m_turns.begin())
+    if (currentTurn != m_turns->begin())
       formerTurnIndex = (currentTurn - 1)->m_index;
 
     //TODO (ldragunov) Extract CalculateMercatorDistance higher to avoid including turns generator.
@@ -92,41 +163,41 @@ double Route::GetMercatorDistanceFromBegin() const
 
 uint32_t Route::GetTotalTimeSec() const
 {
-  return m_times.empty() ? 0 : m_times.back().second;
+  return m_times->empty() ? 0 : m_times->back().second;
 }
 
 uint32_t Route::GetCurrentTimeToEndSec() const
 {
   size_t const polySz = m_poly.GetPolyline().GetSize();
-  if (m_times.empty() || polySz == 0)
+  if (m_times->empty() || polySz == 0)
   {
-    ASSERT(!m_times.empty(), ());
+    ASSERT(!m_times->empty(), ());
     ASSERT(polySz != 0, ());
     return 0;
   }
 
-  TTimes::const_iterator it = upper_bound(m_times.begin(), m_times.end(), m_poly.GetCurrentIter().m_ind,
+  TTimes::const_iterator it = upper_bound(m_times->begin(), m_times->end(), m_poly.GetCurrentIter().m_ind,
                                          [](size_t v, Route::TTimeItem const & item) { return v < item.first; });
 
-  if (it == m_times.end())
+  if (it == m_times->end())
     return 0;
 
-  size_t idx = distance(m_times.begin(), it);
+  size_t idx = distance(m_times->begin(), it);
   double time = (*it).second;
   if (idx > 0)
-    time -= m_times[idx - 1].second;
+    time -= (*m_times)[idx - 1].second;
 
   auto distFn = [&](size_t start, size_t end)
   {
     return m_poly.GetDistanceM(m_poly.GetIterToIndex(start), m_poly.GetIterToIndex(end));
   };
 
-  ASSERT_LESS(m_times[idx].first, polySz, ());
-  double const dist = distFn(idx > 0 ? m_times[idx - 1].first : 0, m_times[idx].first);
+  ASSERT_LESS((*m_times)[idx].first, polySz, ());
+  double const dist = distFn(idx > 0 ? (*m_times)[idx - 1].first : 0, (*m_times)[idx].first);
 
   if (!my::AlmostEqualULPs(dist, 0.))
   {
-    double const distRemain = distFn(m_poly.GetCurrentIter().m_ind, m_times[idx].first) -
+    double const distRemain = distFn(m_poly.GetCurrentIter().m_ind, (*m_times)[idx].first) -
                                      MercatorBounds::DistanceOnEarth(m_poly.GetCurrentIter().m_pt,
                                      m_poly.GetPolyline().GetPoint(m_poly.GetCurrentIter().m_ind));
     return (uint32_t)((GetTotalTimeSec() - (*it).second) + (double)time * (distRemain / dist));
@@ -137,11 +208,11 @@ uint32_t Route::GetCurrentTimeToEndSec() const
 
 Route::TTurns::const_iterator Route::GetCurrentTurn() const
 {
-  ASSERT(!m_turns.empty(), ());
+  ASSERT(!m_turns->empty(), ());
 
   turns::TurnItem t;
   t.m_index = static_cast<uint32_t>(m_poly.GetCurrentIter().m_ind);
-  return upper_bound(m_turns.cbegin(), m_turns.cend(), t,
+  return upper_bound(m_turns->cbegin(), m_turns->cend(), t,
          [](turns::TurnItem const & lhs, turns::TurnItem const & rhs)
          {
            return lhs.m_index < rhs.m_index;
@@ -149,26 +220,31 @@ Route::TTurns::const_iterator Route::GetCurrentTurn() const
 }
 
 void Route::GetCurrentTurn(double & distanceToTurnMeters, turns::TurnItem & turn) const
+{
+  turns::TurnItem const * current = GetCurrentTurn(distanceToTurnMeters);
+  turn = current != nullptr ? *current : turns::TurnItem();
+}
+
+turns::TurnItem const * Route::GetCurrentTurn(double & distanceToTurnMeters) const
 {
   auto it = GetCurrentTurn();
-  if (it == m_turns.end())
+  if (it == m_turns->end())
   {
-    ASSERT(it != m_turns.end(), ());
+    ASSERT(it != m_turns->end(), ());
     distanceToTurnMeters = 0;
-    turn = turns::TurnItem();
-    return;
+    return nullptr;
   }
 
   size_t const segIdx = (*it).m_index;
-  turn = (*it);
   distanceToTurnMeters = m_poly.GetDistanceM(m_poly.GetCurrentIter(),
                                              m_poly.GetIterToIndex(segIdx));
+  return &(*it);
 }
 
 bool Route::GetNextTurn(double & distanceToTurnMeters, turns::TurnItem & turn) const
 {
   auto it = GetCurrentTurn();
-  auto const turnsEnd = m_turns.end();
+  auto const turnsEnd = m_turns->end();
   ASSERT(it != turnsEnd, ());
 
   if (it == turnsEnd || (it + 1) == turnsEnd)
@@ -286,6 +362,187 @@ void Route::Update()
   m_currentTime = 0.0;
 }
 
+void Route::Serialize(Writer & writer) const
+{
+  WriteVarUint(writer, kSerializationVersion);
+  rw::Write(writer, m_router);
+  rw::Write(writer, m_name);
+
+  vector<m2::PointD> const & points = m_poly.GetPolyline().GetPoints();
+  WriteVarUint(writer, static_cast<uint32_t>(points.size()));
+  m2::PointU prev(0, 0);
+  for (m2::PointD const & point : points)
+  {
+    m2::PointU const curr = PointD2PointU(point, POINT_COORD_BITS);
+    WriteVarInt(writer, static_cast<int64_t>(curr.x) - static_cast<int64_t>(prev.x));
+    WriteVarInt(writer, static_cast<int64_t>(curr.y) - static_cast<int64_t>(prev.y));
+    prev = curr;
+  }
+
+  // Street names repeat in the turns, so the turns refer to the names by their indices.
+  vector<string> names;
+  map<string, uint32_t> nameIds;
+  auto const getNameId = [&names, &nameIds](string const & name)
+  {
+    auto const res = nameIds.emplace(name, static_cast<uint32_t>(names.size()));
+    if (res.second)
+      names.push_back(name);
+    return res.first->second;
+  };
+  vector<pair<uint32_t, uint32_t>> turnNames;
+  for (turns::TurnItem const & turn : *m_turns)
+    turnNames.emplace_back(getNameId(turn.m_sourceName), getNameId(turn.m_targetName));
+
+  WriteVarUint(writer, static_cast<uint32_t>(names.size()));
+  for (string const & name : names)
+    rw::Write(writer, name);
+
+  WriteVarUint(writer, static_cast<uint32_t>(m_turns->size()));
+  uint32_t prevIndex = 0;
+  for (size_t i = 0; i < m_turns->size(); ++i)
+  {
+    turns::TurnItem const & turn = (*m_turns)[i];
+    ASSERT_LESS_OR_EQUAL(prevIndex, turn.m_index, ("Turns must be sorted by the points."));
+    WriteVarUint(writer, turn.m_index - prevIndex);
+    prevIndex = turn.m_index;
+    WriteEnum(writer, turn.m_turn);
+    WriteEnum(writer, turn.m_pedestrianTurn);
+    WriteVarUint(writer, turn.m_exitNum);
+    WriteToSink(writer, static_cast<uint8_t>(turn.m_keepAnyway ? 1 : 0));
+    WriteVarUint(writer, turnNames[i].first);
+    WriteVarUint(writer, turnNames[i].second);
+
+    WriteVarUint(writer, static_cast<uint32_t>(turn.m_lanes.size()));
+    for (turns::SingleLaneInfo const & lane : turn.m_lanes)
+    {
+      WriteToSink(writer, static_cast<uint8_t>(lane.m_isRecommended ? 1 : 0));
+      WriteVarUint(writer, static_cast<uint32_t>(lane.m_lane.size()));
+      for (turns::LaneWay const way : lane.m_lane)
+        WriteEnum(writer, way);
+    }
+  }
+
+  WriteVarUint(writer, static_cast<uint32_t>(m_times->size()));
+  prevIndex = 0;
+  int64_t prevTime = 0;
+  for (TTimeItem const & item : *m_times)
+  {
+    ASSERT_LESS_OR_EQUAL(prevIndex, item.first, ("Times must be sorted by the points."));
+    WriteVarUint(writer, item.first - prevIndex);
+    prevIndex = item.first;
+    // Times are accumulated, so they're rounded without accumulation of the errors.
+    int64_t const time = llround(item.second * kTimeUnitsPerSecond);
+    WriteVarInt(writer, time - prevTime);
+    prevTime = time;
+  }
+}
+
+bool Route::Deserialize(vector<uint8_t> const & data)
+{
+  Route route(m_router);
+  vector<m2::PointD> points;
+  TTurns turns;
+  TTimes times;
+  try
+  {
+    CheckedSource src(data);
+    uint32_t const version = ReadVarUint<uint32_t>(src);
+    if (version != kSerializationVersion)
+    {
+      LOG(LWARNING, ("Unsupported route version:", version));
+      return false;
+    }
+    rw::Read(src, route.m_router);
+    rw::Read(src, route.m_name);
+
+    // Polyline of a single point isn't a valid route.
+    uint32_t const pointsCount = ReadCount(src);
+    if (pointsCount == 1)
+    {
+      LOG(LWARNING, ("Route is malformed, it has a single point."));
+      return false;
+    }
+    points.reserve(pointsCount);
+    int64_t x = 0;
+    int64_t y = 0;
+    int64_t const maxCoord = (static_cast<int64_t>(1) << POINT_COORD_BITS) - 1;
+    for (uint32_t i = 0; i < pointsCount; ++i)
+    {
+      x += ReadVarInt<int64_t>(src);
+      y += ReadVarInt<int64_t>(src);
+      if (x < 0 || x > maxCoord || y < 0 || y > maxCoord)
+        MYTHROW(Reader::ReadException, ("Point is out of range", x, y));
+      points.push_back(PointU2PointD(m2::PointU(static_cast<uint32_t>(x), static_cast<uint32_t>(y)),
+                                     POINT_COORD_BITS));
+    }
+
+    vector<string> names(ReadCount(src));
+    for (string & name : names)
+      rw::Read(src, name);
+    auto const readName = [&src, &names]()
+    {
+      uint32_t const id = ReadVarUint<uint32_t>(src);
+      if (id >= names.size())
+        MYTHROW(Reader::ReadException, ("Name is out of range", id, names.size()));
+      return names[id];
+    };
+
+    turns.resize(ReadCount(src));
+    uint32_t prevIndex = 0;
+    for (turns::TurnItem & turn : turns)
+    {
+      turn.m_index = ReadPointIndex(src, prevIndex, pointsCount);
+      prevIndex = turn.m_index;
+      turn.m_turn = ReadEnum<turns::TurnDirection>(src);
+      turn.m_pedestrianTurn = ReadEnum<turns::PedestrianDirection>(src);
+      turn.m_exitNum = ReadVarUint<uint32_t>(src);
+      turn.m_keepAnyway = ReadPrimitiveFromSource<uint8_t>(src) != 0;
+      turn.m_sourceName = readName();
+      turn.m_targetName = readName();
+
+      turn.m_lanes.resize(ReadCount(src));
+      for (turns::SingleLaneInfo & lane : turn.m_lanes)
+      {
+        lane.m_isRecommended = ReadPrimitiveFromSource<uint8_t>(src) != 0;
+        lane.m_lane.resize(ReadCount(src));
+        for (turns::LaneWay & way : lane.m_lane)
+          way = ReadEnum<turns::LaneWay>(src);
+      }
+    }
+
+    times.resize(ReadCount(src));
+    prevIndex = 0;
+    int64_t time = 0;
+    for (TTimeItem & item : times)
+    {
+      item.first = ReadPointIndex(src, prevIndex, pointsCount);
+      prevIndex = item.first;
+      time += ReadVarInt<int64_t>(src);
+      item.second = time / kTimeUnitsPerSecond;
+    }
+
+    if (src.Size() != 0)
+    {
+      LOG(LWARNING, ("Route is malformed, unexpected bytes:", src.Size()));
+      return false;
+    }
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LWARNING, ("Route is malformed:", e.Msg()));
+    return false;
+  }
+
+  if (!points.empty())
+    FollowedPolyline(points.begin(), points.end()).Swap(route.m_poly);
+  route.SetTurnInstructions(turns);
+  route.SetSectionTimes(times);
+  route.m_routingSettings = m_routingSettings;
+  route.Update();
+  Swap(route);
+  return true;
+}
+
 string DebugPrint(Route const & r)
 {
   return DebugPrint(r.m_poly.GetPolyline());
@@ -6,10 +6,13 @@
 
 #include "geometry/polyline2d.hpp"
 
-#include "std/vector.hpp"
 #include "std/set.hpp"
+#include "std/shared_ptr.hpp"
 #include "std/string.hpp"
+#include "std/vector.hpp"
+
 
+class Writer;
 
 namespace location
 {
@@ -49,12 +52,16 @@ public:
 
   inline void SetTurnInstructions(TTurns & v)
   {
-    swap(m_turns, v);
+    auto turns = make_shared<TTurns>();
+    turns->swap(v);
+    m_turns = move(turns);
   }
 
   inline void SetSectionTimes(TTimes & v)
   {
-    swap(m_times, v);
+    auto times = make_shared<TTimes>();
+    times->swap(v);
+    m_times = move(times);
   }
 
   uint32_t GetTotalTimeSec() const;
@@ -62,7 +69,8 @@ public:
 
   string const & GetRouterId() const { return m_router; }
   m2::PolylineD const & GetPoly() const { return m_poly.GetPolyline(); }
-  TTurns const & GetTurns() const { return m_turns; }
+  TTurns const & GetTurns() const { return *m_turns; }
+  TTimes const & GetSectionTimes() const { return *m_times; }
   void GetTurnsDistances(vector<double> & distances) const;
   string const & GetName() const { return m_name; }
   bool IsValid() const { return (m_poly.GetPolyline().GetSize() > 1); }
@@ -73,6 +81,9 @@ public:
   double GetMercatorDistanceFromBegin() const;
 
   void GetCurrentTurn(double & distanceToTurnMeters, turns::TurnItem & turn) const;
+  /// The same as GetCurrentTurn() but the turn isn't copied, it's called on every location update.
+  /// @return Nullptr if there is no current turn, otherwise the turn which lives with the route.
+  turns::TurnItem const * GetCurrentTurn(double & distanceToTurnMeters) const;
   /// @return true if GetNextTurn() returns a valid result in parameters, false otherwise.
   /// \param distanceToTurnMeters is a distance from current possition to the second turn.
   /// \param turn is information about the second turn.
@@ -102,6 +113,16 @@ public:
     Update();
   }
 
+  /// Writes the route in the compact format, so the route is restored after the restart of
+  /// the app: the points are quantized and delta-coded, the turns and the times are delta-coded
+  /// by the points and the street names are written once. The position on the route,
+  /// the routing settings and the absent countries aren't written.
+  void Serialize(Writer & writer) const;
+
+  /// Restores the route which is written by Serialize(), the route is at its start.
+  /// @return False when the data are malformed or of another version, the route is unchanged.
+  bool Deserialize(vector<uint8_t> const & data);
+
 private:
   /// Call this fucnction when geometry have changed.
   void Update();
@@ -120,8 +141,10 @@ private:
 
   set<string> m_absentCountries;
 
-  TTurns m_turns;
-  TTimes m_times;
+  // Geometry, turns and times are immutable after they're set and shared between copies,
+  // so the route is copied and passed between the threads without copying of them.
+  shared_ptr<TTurns const> m_turns = make_shared<TTurns>();
+  shared_ptr<TTimes const> m_times = make_shared<TTimes>();
 
   mutable double m_currentTime;
 };
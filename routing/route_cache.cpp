@@ -0,0 +1,319 @@
+#include "routing/route_cache.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/varint.hpp"
+
+#include "platform/platform.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/tuple.hpp"
+
+namespace routing
+{
+namespace
+{
+uint32_t constexpr kFileVersion = 0;
+
+template <class TSink>
+void WriteMwms(TSink & sink, RouteCache::TMwmVersions const & mwms)
+{
+  WriteVarUint(sink, static_cast<uint32_t>(mwms.size()));
+  for (auto const & mwm : mwms)
+  {
+    rw::Write(sink, mwm.first);
+    WriteVarInt(sink, mwm.second);
+  }
+}
+
+template <class TSource>
+void ReadMwms(TSource & src, RouteCache::TMwmVersions & mwms)
+{
+  mwms.resize(ReadVarUint<uint32_t>(src));
+  for (auto & mwm : mwms)
+  {
+    rw::Read(src, mwm.first);
+    mwm.second = ReadVarInt<int64_t>(src);
+  }
+}
+
+template <class TSink>
+void WriteRoute(TSink & sink, Route const & route)
+{
+  rw::Write(sink, route.GetRouterId());
+  rw::Write(sink, route.GetName());
+
+  auto const & poly = route.GetPoly();
+  WriteVarUint(sink, static_cast<uint32_t>(poly.GetSize()));
+  for (size_t i = 0; i < poly.GetSize(); ++i)
+    WriteVarUint(sink, static_cast<uint64_t>(PointToInt64(poly.GetPoint(i), POINT_COORD_BITS)));
+
+  Route::TTurns const & turns = route.GetTurns();
+  WriteVarUint(sink, static_cast<uint32_t>(turns.size()));
+  for (turns::TurnItem const & turn : turns)
+  {
+    WriteVarUint(sink, turn.m_index);
+    WriteVarUint(sink, static_cast<uint32_t>(turn.m_turn));
+    WriteVarUint(sink, static_cast<uint32_t>(turn.m_lanes.size()));
+    for (turns::SingleLaneInfo const & lane : turn.m_lanes)
+    {
+      WriteVarUint(sink, static_cast<uint32_t>(lane.m_lane.size()));
+      for (turns::LaneWay const way : lane.m_lane)
+        WriteVarUint(sink, static_cast<uint32_t>(way));
+      WriteVarUint(sink, static_cast<uint32_t>(lane.m_isRecommended ? 1 : 0));
+    }
+    WriteVarUint(sink, turn.m_exitNum);
+    rw::Write(sink, turn.m_sourceName);
+    rw::Write(sink, turn.m_targetName);
+    WriteVarUint(sink, static_cast<uint32_t>(turn.m_keepAnyway ? 1 : 0));
+    WriteVarUint(sink, static_cast<uint32_t>(turn.m_pedestrianTurn));
+  }
+
+  // Times are kept in milliseconds.
+  Route::TTimes const & times = route.GetSectionTimes();
+  WriteVarUint(sink, static_cast<uint32_t>(times.size()));
+  for (Route::TTimeItem const & time : times)
+  {
+    WriteVarUint(sink, time.first);
+    WriteVarUint(sink, static_cast<uint64_t>(llround(time.second * 1000.0)));
+  }
+
+  set<string> const & absent = route.GetAbsentCountries();
+  WriteVarUint(sink, static_cast<uint32_t>(absent.size()));
+  for (string const & country : absent)
+    rw::Write(sink, country);
+}
+
+template <class TSource>
+void ReadRoute(TSource & src, Route & route)
+{
+  string router, name;
+  rw::Read(src, router);
+  rw::Read(src, name);
+
+  vector<m2::PointD> points(ReadVarUint<uint32_t>(src));
+  for (auto & point : points)
+    point = Int64ToPoint(static_cast<int64_t>(ReadVarUint<uint64_t>(src)), POINT_COORD_BITS);
+
+  Route::TTurns turns(ReadVarUint<uint32_t>(src));
+  for (turns::TurnItem & turn : turns)
+  {
+    turn.m_index = ReadVarUint<uint32_t>(src);
+    turn.m_turn = static_cast<turns::TurnDirection>(ReadVarUint<uint32_t>(src));
+    turn.m_lanes.resize(ReadVarUint<uint32_t>(src));
+    for (turns::SingleLaneInfo & lane : turn.m_lanes)
+    {
+      lane.m_lane.resize(ReadVarUint<uint32_t>(src));
+      for (turns::LaneWay & way : lane.m_lane)
+        way = static_cast<turns::LaneWay>(ReadVarUint<uint32_t>(src));
+      lane.m_isRecommended = ReadVarUint<uint32_t>(src) != 0;
+    }
+    turn.m_exitNum = ReadVarUint<uint32_t>(src);
+    rw::Read(src, turn.m_sourceName);
+    rw::Read(src, turn.m_targetName);
+    turn.m_keepAnyway = ReadVarUint<uint32_t>(src) != 0;
+    turn.m_pedestrianTurn = static_cast<turns::PedestrianDirection>(ReadVarUint<uint32_t>(src));
+  }
+
+  Route::TTimes times(ReadVarUint<uint32_t>(src));
+  for (Route::TTimeItem & time : times)
+  {
+    time.first = ReadVarUint<uint32_t>(src);
+    time.second = ReadVarUint<uint64_t>(src) / 1000.0;
+  }
+
+  Route result(router, points, name);
+  result.SetTurnInstructions(turns);
+  result.SetSectionTimes(times);
+  uint32_t const absentCount = ReadVarUint<uint32_t>(src);
+  for (uint32_t i = 0; i < absentCount; ++i)
+  {
+    string country;
+    rw::Read(src, country);
+    result.AddAbsentCountry(country);
+  }
+  route.Swap(result);
+}
+}  // namespace
+
+// static
+int64_t constexpr RouteCache::kInvalidVersion;
+// static
+size_t constexpr RouteCache::kDefaultMaxPointsCount;
+
+bool RouteCache::Key::operator<(Key const & rhs) const
+{
+  return tie(m_mwms, m_nodes) < tie(rhs.m_mwms, rhs.m_nodes);
+}
+
+bool RouteCache::Key::operator==(Key const & rhs) const
+{
+  return m_mwms == rhs.m_mwms && m_nodes == rhs.m_nodes;
+}
+
+RouteCache::Entry::Entry(Key const & key, TMwmVersions const & mwms, Route const & route)
+  : m_key(key), m_mwms(mwms), m_route(route), m_pointsCount(route.GetPoly().GetSize())
+{
+}
+
+RouteCache::RouteCache(size_t maxPointsCount) : m_maxPointsCount(maxPointsCount) {}
+
+bool RouteCache::Get(Key const & key, TVersionFn const & versionFn, Route & route)
+{
+  auto const it = m_index.find(key);
+  if (it == m_index.end())
+    return false;
+
+  for (auto const & mwm : it->second->m_mwms)
+  {
+    if (versionFn(mwm.first) != mwm.second)
+    {
+      LOG(LDEBUG, ("Cached route is outdated, mwm", mwm.first, "has changed."));
+      Erase(it->second);
+      return false;
+    }
+  }
+
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  route = m_entries.front().m_route;
+  return true;
+}
+
+void RouteCache::Put(Key const & key, TMwmVersions const & mwms, Route const & route)
+{
+  auto const it = m_index.find(key);
+  if (it != m_index.end())
+    Erase(it->second);
+
+  // Routes which weren't made completely aren't cached.
+  if (!route.IsValid() || route.GetPoly().GetSize() > m_maxPointsCount)
+    return;
+
+  m_entries.emplace_front(key, mwms, route);
+  m_index[key] = m_entries.begin();
+  m_pointsCount += m_entries.front().m_pointsCount;
+  Shrink();
+}
+
+void RouteCache::Invalidate(string const & mwm)
+{
+  for (auto it = m_entries.begin(); it != m_entries.end();)
+  {
+    auto const & mwms = it->m_mwms;
+    bool const passes = find_if(mwms.begin(), mwms.end(), [&mwm](pair<string, int64_t> const & v)
+                                {
+                                  return v.first == mwm;
+                                }) != mwms.end();
+    auto const current = it++;
+    if (passes)
+      Erase(current);
+  }
+}
+
+void RouteCache::Clear()
+{
+  m_entries.clear();
+  m_index.clear();
+  m_pointsCount = 0;
+}
+
+void RouteCache::SetMaxPointsCount(size_t maxPointsCount)
+{
+  m_maxPointsCount = maxPointsCount;
+  Shrink();
+}
+
+void RouteCache::SaveToFile(string const & path) const
+{
+  try
+  {
+    FileWriter writer(path);
+    WriteVarUint(writer, kFileVersion);
+    WriteVarUint(writer, static_cast<uint32_t>(m_entries.size()));
+    for (Entry const & entry : m_entries)
+    {
+      WriteMwms(writer, entry.m_key.m_mwms);
+      WriteVarUint(writer, static_cast<uint32_t>(entry.m_key.m_nodes.size()));
+      for (uint64_t const node : entry.m_key.m_nodes)
+        WriteVarUint(writer, node);
+      WriteMwms(writer, entry.m_mwms);
+      WriteRoute(writer, entry.m_route);
+    }
+  }
+  catch (Writer::Exception const & e)
+  {
+    LOG(LWARNING, ("Can't save the route cache to", path, e.Msg()));
+  }
+}
+
+bool RouteCache::LoadFromFile(string const & path)
+{
+  Clear();
+  if (!Platform::IsFileExistsByFullPath(path))
+    return false;
+
+  try
+  {
+    FileReader reader(path);
+    ReaderSource<FileReader> src(reader);
+    uint32_t const version = ReadVarUint<uint32_t>(src);
+    if (version != kFileVersion)
+    {
+      LOG(LWARNING, ("Unsupported route cache version:", version));
+      return false;
+    }
+
+    uint32_t const count = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      Key key;
+      ReadMwms(src, key.m_mwms);
+      key.m_nodes.resize(ReadVarUint<uint32_t>(src));
+      for (uint64_t & node : key.m_nodes)
+        node = ReadVarUint<uint64_t>(src);
+      TMwmVersions mwms;
+      ReadMwms(src, mwms);
+      Route route("");
+      ReadRoute(src, route);
+
+      // Routes are written from the most recently used, so they're appended.
+      if (m_index.count(key) != 0)
+        continue;
+      m_entries.emplace_back(key, mwms, route);
+      m_index[key] = --m_entries.end();
+      m_pointsCount += m_entries.back().m_pointsCount;
+    }
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LWARNING, ("Can't load the route cache from", path, e.Msg()));
+    Clear();
+    return false;
+  }
+
+  Shrink();
+  return true;
+}
+
+void RouteCache::Erase(TEntries::iterator it)
+{
+  ASSERT_GREATER_OR_EQUAL(m_pointsCount, it->m_pointsCount, ());
+  m_pointsCount -= it->m_pointsCount;
+  m_index.erase(it->m_key);
+  m_entries.erase(it);
+}
+
+void RouteCache::Shrink()
+{
+  while (m_pointsCount > m_maxPointsCount && !m_entries.empty())
+    Erase(--m_entries.end());
+}
+
+}  // namespace routing
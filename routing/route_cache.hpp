@@ -0,0 +1,96 @@
+#pragma once
+
+#include "routing/route.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/function.hpp"
+#include "std/list.hpp"
+#include "std/map.hpp"
+#include "std/string.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace routing
+{
+
+/// RouteCache keeps recently calculated routes by the snapped endpoints they were calculated for.
+/// A route is valid while all the mwms it passes through have the same versions as when
+/// the route was put, so an entry is dropped on a hit after Storage updates one of its countries.
+/// The cache is bounded by the total number of route points, least recently used routes
+/// are evicted first. The cache isn't thread-safe.
+class RouteCache
+{
+public:
+  /// Names and versions of mwms.
+  using TMwmVersions = vector<pair<string, int64_t>>;
+  /// @return Current version of the mwm or kInvalidVersion when the mwm is absent.
+  using TVersionFn = function<int64_t(string const &)>;
+
+  static int64_t constexpr kInvalidVersion = -1;
+  static size_t constexpr kDefaultMaxPointsCount = 200000;
+
+  /// Key of a route is made by a router. The mwms are the ones the snapped nodes belong to,
+  /// the nodes are any values which identify the snapped endpoints within the mwms.
+  struct Key
+  {
+    TMwmVersions m_mwms;
+    vector<uint64_t> m_nodes;
+
+    bool operator<(Key const & rhs) const;
+    bool operator==(Key const & rhs) const;
+  };
+
+  explicit RouteCache(size_t maxPointsCount = kDefaultMaxPointsCount);
+
+  /// Copies the cached route to |route| when there is a route for the key and all the mwms
+  /// of the route have the same versions as returned by |versionFn|.
+  /// @return False when there is no valid route for the key.
+  bool Get(Key const & key, TVersionFn const & versionFn, Route & route);
+
+  /// Puts the route which passes through the |mwms|, the route for the same key is replaced.
+  /// Invalid routes and routes longer than the cache bound aren't put.
+  void Put(Key const & key, TMwmVersions const & mwms, Route const & route);
+
+  /// Drops all the routes which pass through the mwm.
+  void Invalidate(string const & mwm);
+
+  void Clear();
+
+  inline size_t GetSize() const { return m_entries.size(); }
+  inline size_t GetPointsCount() const { return m_pointsCount; }
+
+  void SetMaxPointsCount(size_t maxPointsCount);
+  inline size_t GetMaxPointsCount() const { return m_maxPointsCount; }
+
+  /// Writes routes from the most to the least recently used.
+  void SaveToFile(string const & path) const;
+
+  /// Replaces the routes in the cache with the ones read from the file.
+  /// @return False when the file is absent or malformed, the cache is empty in this case.
+  bool LoadFromFile(string const & path);
+
+private:
+  struct Entry
+  {
+    Entry(Key const & key, TMwmVersions const & mwms, Route const & route);
+
+    Key m_key;
+    TMwmVersions m_mwms;
+    Route m_route;
+    size_t m_pointsCount;
+  };
+
+  using TEntries = list<Entry>;
+
+  void Erase(TEntries::iterator it);
+  void Shrink();
+
+  size_t m_maxPointsCount;
+  size_t m_pointsCount = 0;
+
+  // The most recently used entries are in the front.
+  TEntries m_entries;
+  map<Key, TEntries::iterator> m_index;
+};
+
+}  // namespace routing
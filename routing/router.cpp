@@ -1,4 +1,5 @@
 #include "router.hpp"
+#include "route.hpp"
 
 namespace routing
 {
@@ -14,4 +15,29 @@ string ToString(RouterType type)
   return "Error";
 }
 
+// static
+double constexpr IRouter::kInvalidWeight;
+
+IRouter::ResultCode IRouter::CalculateWeightsMatrix(vector<m2::PointD> const & sources,
+                                                    vector<m2::PointD> const & targets,
+                                                    RouterDelegate const & delegate,
+                                                    vector<double> & weights)
+{
+  weights.assign(sources.size() * targets.size(), kInvalidWeight);
+  for (size_t i = 0; i < sources.size(); ++i)
+  {
+    for (size_t j = 0; j < targets.size(); ++j)
+    {
+      Route route(GetName());
+      ResultCode const code =
+          CalculateRoute(sources[i], m2::PointD::Zero(), targets[j], delegate, route);
+      if (code == Cancelled || delegate.IsCancelled())
+        return Cancelled;
+      if (code == NoError)
+        weights[i * targets.size() + j] = route.GetTotalTimeSec();
+    }
+  }
+  return NoError;
+}
+
 } //  namespace routing
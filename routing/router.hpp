@@ -7,7 +7,9 @@
 #include "base/cancellable.hpp"
 
 #include "std/function.hpp"
+#include "std/limits.hpp"
 #include "std/string.hpp"
+#include "std/vector.hpp"
 
 namespace routing
 {
@@ -25,6 +27,19 @@ enum class RouterType
 
 string ToString(RouterType type);
 
+/// Durations of the stages of a route calculation in seconds.
+struct RouteTimings
+{
+  /// Loading of the routing data of the mwms.
+  double m_dataLoadSec = 0.0;
+  /// Snapping of the endpoints to the roads.
+  double m_pointsLookupSec = 0.0;
+  /// Search of the path.
+  double m_searchSec = 0.0;
+  /// Geometry, turns and times of the found path.
+  double m_postProcessingSec = 0.0;
+};
+
 class IRouter
 {
 public:
@@ -47,6 +62,9 @@ public:
     FileTooOld = 11
   };
 
+  /// Weight of a pair of points which are not connected by a route.
+  static double constexpr kInvalidWeight = numeric_limits<double>::infinity();
+
   virtual ~IRouter() {}
 
   /// Return unique name of a router implementation.
@@ -70,6 +88,25 @@ public:
                                     m2::PointD const & startDirection,
                                     m2::PointD const & finalPoint, RouterDelegate const & delegate,
                                     Route & route) = 0;
+
+  /// @return Durations of the stages of the last CalculateRoute() call, they are zero
+  /// for the stages which the router doesn't measure.
+  virtual RouteTimings GetLastRouteTimings() const { return RouteTimings(); }
+
+  /// Calculates estimated times of routes from each of the sources to each of the targets.
+  /// The default implementation builds a route for every pair of points, so routers which
+  /// are able to search many routes at once should override it.
+  ///
+  /// @param sources start points of routes
+  /// @param targets final points of routes
+  /// @param delegate callback functions and cancellation flag
+  /// @param weights result table with sources as rows: weights[i * targets.size() + j] is
+  ///        a time in seconds from sources[i] to targets[j], or kInvalidWeight
+  /// @return ResultCode error code or NoError if the table was filled
+  virtual ResultCode CalculateWeightsMatrix(vector<m2::PointD> const & sources,
+                                            vector<m2::PointD> const & targets,
+                                            RouterDelegate const & delegate,
+                                            vector<double> & weights);
 };
 
 }  // namespace routing
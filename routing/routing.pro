@@ -15,11 +15,16 @@ INCLUDEPATH += $$ROOT_DIR/3party/jansson/src \
 SOURCES += \
     async_router.cpp \
     base/followed_polyline.cpp \
+    bicycle_model.cpp \
     car_model.cpp \
+    cross_mwm_overlay.cpp \
     cross_mwm_road_graph.cpp \
     cross_mwm_router.cpp \
     cross_routing_context.cpp \
     features_road_graph.cpp \
+    isochrone.cpp \
+    landmarks.cpp \
+    map_matcher.cpp \
     nearest_edge_finder.cpp \
     online_absent_fetcher.cpp \
     online_cross_fetcher.cpp \
@@ -29,30 +34,46 @@ SOURCES += \
     pedestrian_directions.cpp \
     pedestrian_model.cpp \
     road_graph.cpp \
+    road_graph_cross_context.cpp \
+    road_graph_cross_search.cpp \
     road_graph_router.cpp \
+    road_graph_section.cpp \
+    road_info_cache.cpp \
+    road_segments_index.cpp \
     route.cpp \
+    route_cache.cpp \
     router.cpp \
     router_delegate.cpp \
     routing_algorithm.cpp \
     routing_mapping.cpp \
     routing_session.cpp \
+    section_road_graph.cpp \
+    traffic_info.cpp \
     turns.cpp \
     turns_generator.cpp \
+    turns_info.cpp \
     turns_sound.cpp \
     turns_sound_settings.cpp \
     turns_tts_text.cpp \
     vehicle_model.cpp \
 
 HEADERS += \
+    aligned_section.hpp \
     async_router.hpp \
     base/astar_algorithm.hpp \
+    base/astar_containers.hpp \
     base/followed_polyline.hpp \
+    bicycle_model.hpp \
     car_model.hpp \
+    cross_mwm_overlay.hpp \
     cross_mwm_road_graph.hpp \
     cross_mwm_router.hpp \
     cross_routing_context.hpp \
     directions_engine.hpp \
     features_road_graph.hpp \
+    isochrone.hpp \
+    landmarks.hpp \
+    map_matcher.hpp \
     nearest_edge_finder.hpp \
     online_absent_fetcher.hpp \
     online_cross_fetcher.hpp \
@@ -63,16 +84,25 @@ HEADERS += \
     pedestrian_directions.hpp \
     pedestrian_model.hpp \
     road_graph.hpp \
+    road_graph_cross_context.hpp \
+    road_graph_cross_search.hpp \
     road_graph_router.hpp \
+    road_graph_section.hpp \
+    road_info_cache.hpp \
+    road_segments_index.hpp \
     route.hpp \
+    route_cache.hpp \
     router.hpp \
     router_delegate.hpp \
     routing_algorithm.hpp \
     routing_mapping.hpp \
     routing_session.hpp \
     routing_settings.hpp \
+    section_road_graph.hpp \
+    traffic_info.hpp \
     turns.hpp \
     turns_generator.hpp \
+    turns_info.hpp \
     turns_sound.hpp \
     turns_sound_settings.hpp \
     turns_tts_text.hpp \
@@ -4,6 +4,7 @@
 #include "routing/base/astar_progress.hpp"
 
 #include "base/assert.hpp"
+#include "base/logging.hpp"
 
 #include "indexer/mercator.hpp"
 
@@ -16,6 +17,9 @@ float constexpr kProgressInterval = 2;
 
 double constexpr KMPH2MPS = 1000.0 / (60 * 60);
 
+// Must be less than the reduced length tolerance of AStarAlgorithm.
+double constexpr kLandmarksConsistencyEpsilon = 1e-7;
+
 inline double TimeBetweenSec(Junction const & j1, Junction const & j2, double speedMPS)
 {
   ASSERT(speedMPS > 0.0, ());
@@ -44,53 +48,136 @@ public:
   using TVertexType = Junction;
   using TEdgeType = WeightedEdge;
 
-  RoadGraph(IRoadGraph const & roadGraph)
+  /// @param landmarks When not null, landmarks lower bounds are used by the heuristic.
+  /// In this case edges which lead to the start or from the final junction are skipped,
+  /// they are never a part of the optimal route but landmarks bounds are not consistent on them.
+  RoadGraph(IRoadGraph const & roadGraph, LandmarksEstimator const * landmarks,
+            Junction const & startPos, Junction const & finalPos, uint64_t & settledVerticesCount)
     : m_roadGraph(roadGraph)
     , m_maxSpeedMPS(roadGraph.GetMaxSpeedKMPH() * KMPH2MPS)
+    , m_landmarks(landmarks)
+    , m_startPos(startPos)
+    , m_finalPos(finalPos)
+    , m_distanceFromStart(startPos.GetPoint())
+    , m_distanceFromFinal(finalPos.GetPoint())
+    , m_settledVerticesCount(settledVerticesCount)
+    , m_landmarksFailed(false)
   {}
 
   void GetOutgoingEdgesList(Junction const & v, vector<WeightedEdge> & adj) const
   {
+    ++m_settledVerticesCount;
+    adj.clear();
+    if (m_landmarksFailed)
+      return;
+
     IRoadGraph::TEdgeVector edges;
     m_roadGraph.GetOutgoingEdges(v, edges);
 
-    adj.clear();
     adj.reserve(edges.size());
 
+    // All the edges share the junction, so it's converted once.
+    DistanceOnEarthFrom const distanceFrom(v.GetPoint());
     for (auto const & e : edges)
     {
       ASSERT_EQUAL(v, e.GetStartJunction(), ());
+      if (m_landmarks && (v == m_finalPos || e.GetEndJunction() == m_startPos))
+        continue;
 
       double const speedMPS = m_roadGraph.GetSpeedKMPH(e) * KMPH2MPS;
-      adj.emplace_back(e.GetEndJunction(), TimeBetweenSec(e.GetStartJunction(), e.GetEndJunction(), speedMPS));
+      adj.emplace_back(e.GetEndJunction(), distanceFrom(e.GetEndJunction().GetPoint()) / speedMPS);
     }
+
+    CheckLandmarks(v, adj, true /* outgoing */);
   }
 
   void GetIngoingEdgesList(Junction const & v, vector<WeightedEdge> & adj) const
   {
+    ++m_settledVerticesCount;
+    adj.clear();
+    if (m_landmarksFailed)
+      return;
+
     IRoadGraph::TEdgeVector edges;
     m_roadGraph.GetIngoingEdges(v, edges);
 
-    adj.clear();
     adj.reserve(edges.size());
 
+    DistanceOnEarthFrom const distanceFrom(v.GetPoint());
     for (auto const & e : edges)
     {
       ASSERT_EQUAL(v, e.GetEndJunction(), ());
+      if (m_landmarks && (v == m_startPos || e.GetStartJunction() == m_finalPos))
+        continue;
 
       double const speedMPS = m_roadGraph.GetSpeedKMPH(e) * KMPH2MPS;
-      adj.emplace_back(e.GetStartJunction(), TimeBetweenSec(e.GetStartJunction(), e.GetEndJunction(), speedMPS));
+      adj.emplace_back(e.GetStartJunction(), distanceFrom(e.GetStartJunction().GetPoint()) / speedMPS);
     }
+
+    CheckLandmarks(v, adj, false /* outgoing */);
   }
 
   double HeuristicCostEstimate(Junction const & v, Junction const & w) const
   {
-    return TimeBetweenSec(v, w, m_maxSpeedMPS);
+    // Estimates are taken to the route ends, so the ends are converted once.
+    double estimate;
+    if (w == m_finalPos)
+      estimate = m_distanceFromFinal(v.GetPoint()) / m_maxSpeedMPS;
+    else if (w == m_startPos)
+      estimate = m_distanceFromStart(v.GetPoint()) / m_maxSpeedMPS;
+    else
+      estimate = TimeBetweenSec(v, w, m_maxSpeedMPS);
+    if (!m_landmarks)
+      return estimate;
+    return max(estimate, m_landmarks->GetLowerBoundMeters(v, w) / m_maxSpeedMPS);
   }
 
+  /// @return True when the search has been stopped because landmarks bounds
+  /// turned out to be inconsistent, so the found path may be not optimal.
+  bool LandmarksFailed() const { return m_landmarksFailed; }
+
 private:
+  /// Landmarks bounds are consistent only if the graph is the one the table was built for.
+  /// It's not true for edges of other mwms or changed roads, so it's checked for every
+  /// relaxed edge, and on the first violation the search is stopped by returning no edges.
+  /// @param outgoing True when adj contains edges from v, false when edges to v.
+  void CheckLandmarks(Junction const & v, vector<WeightedEdge> & adj, bool outgoing) const
+  {
+    if (!m_landmarks)
+      return;
+
+    for (auto const & e : adj)
+    {
+      Junction const & w = e.GetTarget();
+      if (!m_landmarks->IsKnown(w) ||
+          !(outgoing ? IsConsistent(v, w, e.GetWeight()) : IsConsistent(w, v, e.GetWeight())))
+      {
+        m_landmarksFailed = true;
+        adj.clear();
+        return;
+      }
+    }
+  }
+
+  /// @return True when reduced length of the edge from u to v is non-negative for both
+  /// forward (to the final junction) and backward (to the start junction) heuristics.
+  bool IsConsistent(Junction const & u, Junction const & v, double weight) const
+  {
+    return HeuristicCostEstimate(u, m_finalPos) - HeuristicCostEstimate(v, m_finalPos) <=
+               weight + kLandmarksConsistencyEpsilon &&
+           HeuristicCostEstimate(v, m_startPos) - HeuristicCostEstimate(u, m_startPos) <=
+               weight + kLandmarksConsistencyEpsilon;
+  }
+
   IRoadGraph const & m_roadGraph;
   double const m_maxSpeedMPS;
+  LandmarksEstimator const * const m_landmarks;
+  Junction const m_startPos;
+  Junction const m_finalPos;
+  DistanceOnEarthFrom const m_distanceFromStart;
+  DistanceOnEarthFrom const m_distanceFromFinal;
+  uint64_t & m_settledVerticesCount;
+  mutable bool m_landmarksFailed;
 };
 
 typedef AStarAlgorithm<RoadGraph> TAlgorithmImpl;
@@ -106,6 +193,37 @@ IRoutingAlgorithm::Result Convert(TAlgorithmImpl::Result value)
   ASSERT(false, ("Unexpected TAlgorithmImpl::Result value:", value));
   return IRoutingAlgorithm::Result::NoPath;
 }
+
+LandmarksTable const * FindLandmarks(IRoadGraph const & graph, Junction const & junction)
+{
+  auto const findInEdges = [&graph](IRoadGraph::TEdgeVector const & edges) -> LandmarksTable const *
+  {
+    for (auto const & e : edges)
+    {
+      if (e.IsFake())
+        continue;
+      LandmarksTable const * table = graph.GetLandmarks(e.GetFeatureId());
+      if (table && !table->IsEmpty())
+        return table;
+    }
+    return nullptr;
+  };
+
+  IRoadGraph::TEdgeVector edges;
+  graph.GetOutgoingEdges(junction, edges);
+  if (LandmarksTable const * table = findInEdges(edges))
+    return table;
+
+  // A route usually starts at a fake junction, which is connected to roads by fake edges.
+  IRoadGraph::TEdgeVector nextEdges;
+  for (auto const & e : edges)
+  {
+    graph.GetOutgoingEdges(e.GetEndJunction(), nextEdges);
+    if (LandmarksTable const * table = findInEdges(nextEdges))
+      return table;
+  }
+  return nullptr;
+}
 }  // namespace
 
 string DebugPrint(IRoutingAlgorithm::Result const & value)
@@ -122,6 +240,32 @@ string DebugPrint(IRoutingAlgorithm::Result const & value)
   return string();
 }
 
+// *************************** AStar routing algorithm base ***********************************************
+
+IRoutingAlgorithm::Result AStarRoutingAlgorithmBase::CalculateRouteImpl(IRoadGraph const & graph,
+                                                                        Junction const & startPos,
+                                                                        Junction const & finalPos,
+                                                                        TFindPathFn const & findPath)
+{
+  m_settledVerticesCount = 0;
+  bool landmarksFailed = false;
+
+  LandmarksTable const * table = m_useLandmarks ? FindLandmarks(graph, startPos) : nullptr;
+  if (table)
+  {
+    LandmarksEstimator const landmarks(graph, *table, startPos, finalPos);
+    if (landmarks.IsKnown(startPos) && landmarks.IsKnown(finalPos))
+    {
+      Result const result = findPath(graph, &landmarks, m_settledVerticesCount, landmarksFailed);
+      if (!landmarksFailed)
+        return result;
+      LOG(LINFO, ("Landmarks are inconsistent for the route, falling back to AStar without landmarks."));
+    }
+  }
+
+  return findPath(graph, nullptr /* landmarks */, m_settledVerticesCount, landmarksFailed);
+}
+
 // *************************** AStar routing algorithm implementation *************************************
 
 IRoutingAlgorithm::Result AStarRoutingAlgorithm::CalculateRoute(IRoadGraph const & graph,
@@ -144,10 +288,17 @@ IRoutingAlgorithm::Result AStarRoutingAlgorithm::CalculateRoute(IRoadGraph const
   };
 
   my::Cancellable const & cancellable = delegate;
-  progress.Initialize(startPos.GetPoint(), finalPos.GetPoint());
-  TAlgorithmImpl::Result const res = TAlgorithmImpl().FindPath(
-      RoadGraph(graph), startPos, finalPos, path, cancellable, onVisitJunctionFn);
-  return Convert(res);
+  auto const findPath = [&](IRoadGraph const & roadGraph, LandmarksEstimator const * landmarks,
+                            uint64_t & settledVerticesCount, bool & landmarksFailed)
+  {
+    progress.Initialize(startPos.GetPoint(), finalPos.GetPoint());
+    RoadGraph const wrapper(roadGraph, landmarks, startPos, finalPos, settledVerticesCount);
+    TAlgorithmImpl::Result const res = TAlgorithmImpl().FindPath(
+        wrapper, startPos, finalPos, path, cancellable, onVisitJunctionFn);
+    landmarksFailed = wrapper.LandmarksFailed();
+    return Convert(res);
+  };
+  return CalculateRouteImpl(graph, startPos, finalPos, findPath);
 }
 
 // *************************** AStar-bidirectional routing algorithm implementation ***********************
@@ -170,10 +321,17 @@ IRoutingAlgorithm::Result AStarBidirectionalRoutingAlgorithm::CalculateRoute(
   };
 
   my::Cancellable const & cancellable = delegate;
-  progress.Initialize(startPos.GetPoint(), finalPos.GetPoint());
-  TAlgorithmImpl::Result const res = TAlgorithmImpl().FindPathBidirectional(
-      RoadGraph(graph), startPos, finalPos, path, cancellable, onVisitJunctionFn);
-  return Convert(res);
+  auto const findPath = [&](IRoadGraph const & roadGraph, LandmarksEstimator const * landmarks,
+                            uint64_t & settledVerticesCount, bool & landmarksFailed)
+  {
+    progress.Initialize(startPos.GetPoint(), finalPos.GetPoint());
+    RoadGraph const wrapper(roadGraph, landmarks, startPos, finalPos, settledVerticesCount);
+    TAlgorithmImpl::Result const res = TAlgorithmImpl().FindPathBidirectional(
+        wrapper, startPos, finalPos, path, cancellable, onVisitJunctionFn);
+    landmarksFailed = wrapper.LandmarksFailed();
+    return Convert(res);
+  };
+  return CalculateRouteImpl(graph, startPos, finalPos, findPath);
 }
 
 }  // namespace routing
@@ -2,9 +2,11 @@
 
 #include "base/cancellable.hpp"
 
+#include "routing/landmarks.hpp"
 #include "routing/road_graph.hpp"
 #include "routing/router.hpp"
 
+#include "std/cstdint.hpp"
 #include "std/functional.hpp"
 #include "std/string.hpp"
 #include "std/vector.hpp"
@@ -31,10 +33,40 @@ public:
 
 string DebugPrint(IRoutingAlgorithm::Result const & result);
 
+// Base class for AStar routing algorithms. When the road graph provides a landmarks table
+// for the route start, the algorithms use landmarks lower bounds (ALT) as a heuristic.
+class AStarRoutingAlgorithmBase : public IRoutingAlgorithm
+{
+public:
+  explicit AStarRoutingAlgorithmBase(bool useLandmarks) : m_useLandmarks(useLandmarks) {}
+
+  inline void SetUseLandmarks(bool useLandmarks) { m_useLandmarks = useLandmarks; }
+  inline bool GetUseLandmarks() const { return m_useLandmarks; }
+
+  // Returns number of vertices settled by the last CalculateRoute() call,
+  // including vertices settled by a plain AStar fallback.
+  inline uint64_t GetSettledVerticesCount() const { return m_settledVerticesCount; }
+
+protected:
+  using TFindPathFn = function<Result(IRoadGraph const & graph, LandmarksEstimator const * landmarks,
+                                      uint64_t & settledVerticesCount, bool & landmarksFailed)>;
+
+  // Runs findPath with landmarks, and reruns it without landmarks when landmarks
+  // can't guarantee an optimal route for the query.
+  Result CalculateRouteImpl(IRoadGraph const & graph, Junction const & startPos,
+                            Junction const & finalPos, TFindPathFn const & findPath);
+
+private:
+  bool m_useLandmarks;
+  uint64_t m_settledVerticesCount = 0;
+};
+
 // AStar routing algorithm implementation
-class AStarRoutingAlgorithm : public IRoutingAlgorithm
+class AStarRoutingAlgorithm : public AStarRoutingAlgorithmBase
 {
 public:
+  explicit AStarRoutingAlgorithm(bool useLandmarks = true) : AStarRoutingAlgorithmBase(useLandmarks) {}
+
   // IRoutingAlgorithm overrides:
   Result CalculateRoute(IRoadGraph const & graph, Junction const & startPos,
                         Junction const & finalPos, RouterDelegate const & delegate,
@@ -42,9 +74,14 @@ public:
 };
 
 // AStar-bidirectional routing algorithm implementation
-class AStarBidirectionalRoutingAlgorithm : public IRoutingAlgorithm
+class AStarBidirectionalRoutingAlgorithm : public AStarRoutingAlgorithmBase
 {
 public:
+  explicit AStarBidirectionalRoutingAlgorithm(bool useLandmarks = true)
+    : AStarRoutingAlgorithmBase(useLandmarks)
+  {
+  }
+
   // IRoutingAlgorithm overrides:
   Result CalculateRoute(IRoadGraph const & graph, Junction const & startPos,
                         Junction const & finalPos, RouterDelegate const & delegate,
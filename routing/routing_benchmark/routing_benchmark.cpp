@@ -0,0 +1,450 @@
+// Calculates the routes of the CSV file by the car, the pedestrian and the bicycle routers in
+// the local maps and reports the latency percentiles, the durations of the route stages,
+// the settled vertices of the A* routers and the peak memory as JSON, which is tracked by CI.
+// The bicycle routes are calculated twice: over the bicycle road graph sections and over
+// the features of the maps, so the sections are compared to the on-the-fly road graph.
+//
+// Routes file has "startLat,startLon,finalLat,finalLon" lines. Each of --threads threads has its
+// own routers over the shared index of the maps, so the latency under the concurrent requests of
+// the server is measured as well.
+//
+// With --traces the map matcher is benchmarked instead: traces file has a GPS trace
+// "lat,lon,lat,lon,..." per line, they are matched to the car roads by --threads threads
+// and the throughput in points per second is reported.
+
+#include "routing/bicycle_model.hpp"
+#include "routing/car_model.hpp"
+#include "routing/features_road_graph.hpp"
+#include "routing/map_matcher.hpp"
+#include "routing/osrm_router.hpp"
+#include "routing/pedestrian_directions.hpp"
+#include "routing/pedestrian_model.hpp"
+#include "routing/road_graph_router.hpp"
+#include "routing/route.hpp"
+#include "routing/router_delegate.hpp"
+#include "routing/routing_algorithm.hpp"
+#include "routing/section_road_graph.hpp"
+
+#include "storage/country_info.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/index.hpp"
+#include "indexer/mercator.hpp"
+
+#include "platform/local_country_file_utils.hpp"
+#include "platform/platform.hpp"
+
+#include "coding/file_writer.hpp"
+#include "coding/mmap_policy.hpp"
+
+#include "base/logging.hpp"
+#include "base/stats.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+#include "std/cstdlib.hpp"
+#include "std/fstream.hpp"
+#include "std/iostream.hpp"
+#include "std/map.hpp"
+#include "std/set.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/thread.hpp"
+#include "std/vector.hpp"
+
+#include "defines.hpp"
+
+#include "3party/gflags/src/gflags/gflags.h"
+#include "3party/jansson/myjansson.hpp"
+
+DEFINE_string(routes, "", "File with \"startLat,startLon,finalLat,finalLon\" lines");
+DEFINE_string(maps, "", "Comma separated names of the maps to load, all local maps when empty");
+DEFINE_string(router, "all", "Routers to run: car, pedestrian, bicycle or all");
+DEFINE_int32(threads, 1, "Number of the threads which calculate the routes");
+DEFINE_string(traces, "", "File with \"lat,lon,lat,lon,...\" GPS traces to match to the roads");
+DEFINE_string(json, "", "File to write the JSON report to, it's printed when empty");
+DEFINE_string(mmap_policies, "",
+              "Policies of the mapped sections instead of the default ones, like "
+              "\"sdx=random+hugepages,mercedes=populate\"");
+
+using namespace routing;
+
+namespace
+{
+struct RouteRequest
+{
+  m2::PointD m_start;
+  m2::PointD m_final;
+};
+
+struct RouteSample
+{
+  IRouter::ResultCode m_code = IRouter::NoError;
+  double m_seconds = 0.0;
+  RouteTimings m_timings;
+  // Zero for the routers which don't report the settled vertices.
+  uint64_t m_settledVertices = 0;
+};
+
+/// Router of a single thread, algorithm is set for the routers with the A* algorithms.
+struct BenchmarkRouter
+{
+  unique_ptr<IRouter> m_router;
+  AStarRoutingAlgorithmBase const * m_algorithm = nullptr;
+};
+
+using TRouterFactory =
+    function<BenchmarkRouter(Index & index, TCountryFileFn const & countryFileFn)>;
+
+BenchmarkRouter CreateCarRouter(Index & index, TCountryFileFn const & countryFileFn)
+{
+  BenchmarkRouter res;
+  res.m_router.reset(new OsrmRouter(&index, countryFileFn));
+  return res;
+}
+
+/// Makes the same router as Create*AStarBidirectionalRouter() do, the benchmark keeps
+/// the algorithm for its settled vertices.
+BenchmarkRouter CreateAStarRouter(string const & name, Index & index,
+                                  TCountryFileFn const & countryFileFn,
+                                  unique_ptr<IRoadGraph> && roadGraph)
+{
+  unique_ptr<AStarBidirectionalRoutingAlgorithm> algorithm(
+      new AStarBidirectionalRoutingAlgorithm());
+  unique_ptr<IDirectionsEngine> directionsEngine(new PedestrianDirectionsEngine());
+
+  BenchmarkRouter res;
+  res.m_algorithm = algorithm.get();
+  res.m_router.reset(new RoadGraphRouter(name, index, countryFileFn, move(roadGraph),
+                                         move(algorithm), move(directionsEngine)));
+  return res;
+}
+
+BenchmarkRouter CreatePedestrianRouter(Index & index, TCountryFileFn const & countryFileFn)
+{
+  unique_ptr<IVehicleModelFactory> vehicleModelFactory(new PedestrianModelFactory());
+  unique_ptr<IRoadGraph> roadGraph(
+      new SectionRoadGraph(index, move(vehicleModelFactory), PEDESTRIAN_ROAD_GRAPH_FILE_TAG));
+  return CreateAStarRouter("benchmark-astar-bidirectional-pedestrian", index, countryFileFn,
+                           move(roadGraph));
+}
+
+BenchmarkRouter CreateBicycleRouter(Index & index, TCountryFileFn const & countryFileFn)
+{
+  unique_ptr<IVehicleModelFactory> vehicleModelFactory(new BicycleModelFactory());
+  unique_ptr<IRoadGraph> roadGraph(
+      new SectionRoadGraph(index, move(vehicleModelFactory), BICYCLE_ROAD_GRAPH_FILE_TAG));
+  return CreateAStarRouter("benchmark-astar-bidirectional-bicycle", index, countryFileFn,
+                           move(roadGraph));
+}
+
+/// Bicycle router which expands the road graph from the features, as for the maps without
+/// the bicycle road graph sections.
+BenchmarkRouter CreateBicycleFeaturesRouter(Index & index, TCountryFileFn const & countryFileFn)
+{
+  unique_ptr<IVehicleModelFactory> vehicleModelFactory(new BicycleModelFactory());
+  unique_ptr<IRoadGraph> roadGraph(new FeaturesRoadGraph(index, move(vehicleModelFactory)));
+  return CreateAStarRouter("benchmark-astar-bidirectional-bicycle-features", index,
+                           countryFileFn, move(roadGraph));
+}
+
+bool ReadRoutes(string const & path, vector<RouteRequest> & routes)
+{
+  ifstream stream(path);
+  if (!stream)
+    return false;
+
+  string line;
+  while (getline(stream, line))
+  {
+    vector<string> tokens;
+    strings::Tokenize(line, ",", MakeBackInsertFunctor(tokens));
+    double coords[4];
+    bool ok = tokens.size() == ARRAY_SIZE(coords);
+    for (size_t i = 0; ok && i < ARRAY_SIZE(coords); ++i)
+      ok = strings::to_double(tokens[i], coords[i]);
+    if (!ok)
+    {
+      LOG(LWARNING, ("Bad route", line));
+      continue;
+    }
+    routes.push_back({MercatorBounds::FromLatLon(coords[0], coords[1]),
+                      MercatorBounds::FromLatLon(coords[2], coords[3])});
+  }
+  return true;
+}
+
+bool ReadTraces(string const & path, vector<vector<m2::PointD>> & traces)
+{
+  ifstream stream(path);
+  if (!stream)
+    return false;
+
+  string line;
+  while (getline(stream, line))
+  {
+    vector<string> tokens;
+    strings::Tokenize(line, ",", MakeBackInsertFunctor(tokens));
+    vector<m2::PointD> trace;
+    bool ok = tokens.size() % 2 == 0;
+    for (size_t i = 0; ok && i < tokens.size(); i += 2)
+    {
+      double lat, lon;
+      ok = strings::to_double(tokens[i], lat) && strings::to_double(tokens[i + 1], lon);
+      trace.push_back(MercatorBounds::FromLatLon(lat, lon));
+    }
+    if (!ok || trace.empty())
+    {
+      LOG(LWARNING, ("Bad trace", line));
+      continue;
+    }
+    traces.push_back(move(trace));
+  }
+  return true;
+}
+
+/// Report of the map matcher, the threads share the cache of the decoded roads as the routers do.
+json_t * RunTraces(Index & index, vector<vector<m2::PointD>> const & traces, size_t threadsCount)
+{
+  shared_ptr<RoadInfoCache> const cache = make_shared<RoadInfoCache>();
+  TRoadGraphFactory const graphFactory = [&index, &cache]()
+  {
+    return unique_ptr<IRoadGraph>(
+        new FeaturesRoadGraph(index, make_unique<CarModelFactory>(), cache));
+  };
+
+  vector<vector<MatchedPoint>> results;
+  my::Timer timer;
+  MapMatcher::Stats const stats =
+      MatchTraces(graphFactory, MapMatcher::Params(), traces, results, threadsCount);
+  double const seconds = timer.ElapsedSeconds();
+
+  json_t * report = json_object();
+  json_object_set_new(report, "traces", json_integer(traces.size()));
+  json_object_set_new(report, "points", json_integer(stats.m_pointsCount));
+  json_object_set_new(report, "matched_points", json_integer(stats.m_matchedCount));
+  json_object_set_new(report, "chains", json_integer(stats.m_chainsCount));
+  json_object_set_new(report, "seconds", json_real(seconds));
+  json_object_set_new(report, "points_per_second",
+                      json_real(seconds > 0.0 ? stats.m_pointsCount / seconds : 0.0));
+  return report;
+}
+
+/// Calculates each route once, the routes are taken by the threads one by one,
+/// so the slow routes don't stall the rest of them.
+vector<RouteSample> RunRoutes(TRouterFactory const & factory, Index & index,
+                              TCountryFileFn const & countryFileFn,
+                              vector<RouteRequest> const & routes, size_t threadsCount)
+{
+  vector<RouteSample> samples(routes.size());
+  atomic<size_t> next(0);
+  auto const worker = [&]()
+  {
+    BenchmarkRouter router = factory(index, countryFileFn);
+    RouterDelegate delegate;
+    for (size_t i = next++; i < routes.size(); i = next++)
+    {
+      Route route(router.m_router->GetName());
+      my::Timer timer;
+      RouteSample & sample = samples[i];
+      sample.m_code = router.m_router->CalculateRoute(
+          routes[i].m_start, m2::PointD::Zero() /* startDirection */, routes[i].m_final, delegate,
+          route);
+      sample.m_seconds = timer.ElapsedSeconds();
+      sample.m_timings = router.m_router->GetLastRouteTimings();
+      if (router.m_algorithm)
+        sample.m_settledVertices = router.m_algorithm->GetSettledVerticesCount();
+    }
+  };
+
+  vector<thread> threads;
+  for (size_t i = 1; i < threadsCount; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (thread & t : threads)
+    t.join();
+  return samples;
+}
+
+/// Report of the router: the latency of the found routes and the means of their stages,
+/// the failed routes are counted by their result codes only.
+json_t * MakeReport(string const & name, vector<RouteSample> const & samples, double seconds)
+{
+  vector<double> latencies;
+  RouteTimings total;
+  uint64_t settledVertices = 0;
+  // Result codes are reported by their values in IRouter::ResultCode.
+  map<int, size_t> codes;
+  for (RouteSample const & sample : samples)
+  {
+    ++codes[static_cast<int>(sample.m_code)];
+    if (sample.m_code != IRouter::NoError)
+      continue;
+    latencies.push_back(sample.m_seconds);
+    total.m_dataLoadSec += sample.m_timings.m_dataLoadSec;
+    total.m_pointsLookupSec += sample.m_timings.m_pointsLookupSec;
+    total.m_searchSec += sample.m_timings.m_searchSec;
+    total.m_postProcessingSec += sample.m_timings.m_postProcessingSec;
+    settledVertices += sample.m_settledVertices;
+  }
+  sort(latencies.begin(), latencies.end());
+
+  json_t * report = json_object();
+  json_object_set_new(report, "router", json_string(name.c_str()));
+  json_object_set_new(report, "routes", json_integer(samples.size()));
+  json_object_set_new(report, "found", json_integer(latencies.size()));
+  json_object_set_new(report, "seconds", json_real(seconds));
+  json_object_set_new(report, "routes_per_second",
+                      json_real(seconds > 0.0 ? samples.size() / seconds : 0.0));
+
+  json_t * jCodes = json_object();
+  for (auto const & code : codes)
+  {
+    json_object_set_new(jCodes, strings::to_string(code.first).c_str(),
+                        json_integer(code.second));
+  }
+  json_object_set_new(report, "result_codes", jCodes);
+
+  if (!latencies.empty())
+  {
+    double const count = latencies.size();
+    json_t * latency = json_object();
+    json_object_set_new(latency, "p50", json_real(my::GetPercentile(latencies, 0.5)));
+    json_object_set_new(latency, "p90", json_real(my::GetPercentile(latencies, 0.9)));
+    json_object_set_new(latency, "p99", json_real(my::GetPercentile(latencies, 0.99)));
+    json_object_set_new(latency, "max", json_real(latencies.back()));
+    json_object_set_new(report, "latency_seconds", latency);
+
+    json_t * stages = json_object();
+    json_object_set_new(stages, "data_load", json_real(total.m_dataLoadSec / count));
+    json_object_set_new(stages, "points_lookup", json_real(total.m_pointsLookupSec / count));
+    json_object_set_new(stages, "search", json_real(total.m_searchSec / count));
+    json_object_set_new(stages, "post_processing", json_real(total.m_postProcessingSec / count));
+    json_object_set_new(report, "mean_stage_seconds", stages);
+
+    if (settledVertices != 0)
+      json_object_set_new(report, "mean_settled_vertices", json_real(settledVertices / count));
+  }
+  return report;
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  google::SetUsageMessage(
+      "Routing latency benchmark of the car, pedestrian and bicycle routers and of the map matcher");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (!mmap_policy::SetOverrides(FLAGS_mmap_policies))
+  {
+    cerr << "Bad --mmap_policies \"" << FLAGS_mmap_policies << "\"" << endl;
+    return 1;
+  }
+
+  vector<vector<m2::PointD>> traces;
+  vector<RouteRequest> routes;
+  if (!FLAGS_traces.empty())
+  {
+    if (!ReadTraces(FLAGS_traces, traces) || traces.empty())
+    {
+      cerr << "No traces in \"" << FLAGS_traces << "\"" << endl;
+      return 1;
+    }
+  }
+  else if (FLAGS_routes.empty() || !ReadRoutes(FLAGS_routes, routes) || routes.empty())
+  {
+    cerr << "No routes in \"" << FLAGS_routes << "\"" << endl;
+    return 1;
+  }
+
+  map<string, TRouterFactory> routers;
+  if (FLAGS_router == "car" || FLAGS_router == "all")
+    routers["car"] = &CreateCarRouter;
+  if (FLAGS_router == "pedestrian" || FLAGS_router == "all")
+    routers["pedestrian"] = &CreatePedestrianRouter;
+  if (FLAGS_router == "bicycle" || FLAGS_router == "all")
+  {
+    routers["bicycle"] = &CreateBicycleRouter;
+    routers["bicycle_features"] = &CreateBicycleFeaturesRouter;
+  }
+  if (routers.empty())
+  {
+    cerr << "Unknown router \"" << FLAGS_router << "\"" << endl;
+    return 1;
+  }
+
+  classificator::Load();
+
+  set<string> maps;
+  strings::Tokenize(FLAGS_maps, ",", MakeInsertFunctor(maps));
+
+  Index index;
+  vector<platform::LocalCountryFile> localFiles;
+  platform::FindAllLocalMaps(localFiles);
+  for (platform::LocalCountryFile & localFile : localFiles)
+  {
+    if (!maps.empty() && maps.count(localFile.GetCountryName()) == 0)
+      continue;
+    localFile.SyncWithDisk();
+    if (index.RegisterMap(localFile).second != MwmSet::RegResult::Success)
+      LOG(LWARNING, ("Can't register", localFile));
+  }
+
+  Platform & platform = GetPlatform();
+  storage::CountryInfoGetter const countryInfo(platform.GetReader(PACKED_POLYGONS_FILE),
+                                               platform.GetReader(COUNTRIES_FILE));
+  TCountryFileFn const countryFileFn = [&countryInfo](m2::PointD const & pt)
+  {
+    return countryInfo.GetRegionFile(pt);
+  };
+
+  size_t const threadsCount = static_cast<size_t>(max(FLAGS_threads, 1));
+  my::JsonHandle root;
+  root.AttachNew(json_object());
+  json_object_set_new(root.get(), "threads", json_integer(threadsCount));
+
+  if (!traces.empty())
+  {
+    json_object_set_new(root.get(), "map_matcher", RunTraces(index, traces, threadsCount));
+  }
+  else
+  {
+    my::JsonHandle reports;
+    reports.AttachNew(json_array());
+    for (auto const & router : routers)
+    {
+      my::Timer timer;
+      vector<RouteSample> const samples =
+          RunRoutes(router.second, index, countryFileFn, routes, threadsCount);
+      json_t * report = MakeReport(router.first, samples, timer.ElapsedSeconds());
+      // The routers run one by one, so the peak is of the routers which have run by now.
+      json_object_set_new(report, "peak_rss_bytes", json_integer(my::GetPeakRssBytes()));
+      json_array_append_new(reports.get(), report);
+    }
+    json_object_set(root.get(), "routers", reports.get());
+  }
+  json_object_set_new(root.get(), "peak_rss_bytes", json_integer(my::GetPeakRssBytes()));
+
+  char * res = json_dumps(root.get(), JSON_PRESERVE_ORDER | JSON_INDENT(2));
+  string const json = res;
+  free(res);
+
+  if (FLAGS_json.empty())
+  {
+    cout << json << endl;
+    return 0;
+  }
+
+  try
+  {
+    FileWriter writer(FLAGS_json);
+    writer.Write(json.data(), json.size());
+  }
+  catch (Writer::Exception const & ex)
+  {
+    cerr << "Can't write the report to " << FLAGS_json << ": " << ex.Msg() << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,22 @@
+# Latency benchmark of the car, pedestrian and bicycle routers over the routes of a CSV file.
+# With --traces it benchmarks the map matcher over GPS traces.
+
+TARGET = routing_benchmark
+CONFIG += console warn_on
+CONFIG -= app_bundle
+TEMPLATE = app
+
+ROOT_DIR = ../..
+DEPENDENCIES = routing storage indexer platform geometry coding base \
+               osrm gflags jansson protobuf tomcrypt succinct stats_client
+
+include($$ROOT_DIR/common.pri)
+
+INCLUDEPATH *= $$ROOT_DIR/3party/gflags/src
+
+QT *= core
+
+macx-*: LIBS *= "-framework IOKit"
+
+SOURCES += \
+    routing_benchmark.cpp \
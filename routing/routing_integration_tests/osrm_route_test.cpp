@@ -234,4 +234,11 @@ namespace
 
     integration::TestRouteTime(route, 910.);
   }
+
+  UNIT_TEST(RussiaMoscowSmolenskWeightsMatrixTest)
+  {
+    integration::CalculateWeightsMatrixAndTestRouteTimes(
+        integration::GetOsrmComponents(), {{37.53804, 67.53647}, {32.05489, 65.78463}},
+        {{37.40990, 67.64474}, {37.60169, 67.45807}}, 0.05);
+  }
 }  // namespace
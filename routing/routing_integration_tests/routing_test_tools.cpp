@@ -210,6 +210,36 @@ namespace integration
     return TRouteResult(route, result);
   }
 
+  void CalculateWeightsMatrixAndTestRouteTimes(IRouterComponents const & routerComponents,
+                                               vector<m2::PointD> const & sources,
+                                               vector<m2::PointD> const & targets,
+                                               double relativeError)
+  {
+    RouterDelegate delegate;
+    IRouter * router = routerComponents.GetRouter();
+    ASSERT(router, ());
+    vector<double> weights;
+    TEST_EQUAL(router->CalculateWeightsMatrix(sources, targets, delegate, weights),
+               IRouter::NoError, ());
+    TEST_EQUAL(weights.size(), sources.size() * targets.size(), ());
+
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+      for (size_t j = 0; j < targets.size(); ++j)
+      {
+        double const weight = weights[i * targets.size() + j];
+        TRouteResult const routeResult =
+            CalculateRoute(routerComponents, sources[i], m2::PointD::Zero(), targets[j]);
+        if (routeResult.second != IRouter::NoError)
+        {
+          TEST_EQUAL(weight, IRouter::kInvalidWeight, (i, j));
+          continue;
+        }
+        TestRouteTime(*routeResult.first, weight, relativeError);
+      }
+    }
+  }
+
   void TestTurnCount(routing::Route const & route, uint32_t expectedTurnCount)
   {
     // We use -1 for ignoring the "ReachedYourDestination" turn record.
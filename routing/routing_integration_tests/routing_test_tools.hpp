@@ -62,6 +62,13 @@ namespace integration
 
   void TestTurnCount(Route const & route, uint32_t expectedTurnCount);
 
+  /// Testing weights matrix.
+  /// Each weight of the matrix is checked against time of the route between the same points.
+  void CalculateWeightsMatrixAndTestRouteTimes(IRouterComponents const & routerComponents,
+                                               vector<m2::PointD> const & sources,
+                                               vector<m2::PointD> const & targets,
+                                               double relativeError = 0.01);
+
   /// Testing route length.
   /// It is used for checking if routes have expected(sample) length.
   /// A created route will pass the test iff
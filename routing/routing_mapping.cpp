@@ -12,6 +12,9 @@
 #include "coding/reader_wrapper.hpp"
 
 #include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include "std/sstream.hpp"
 
 
 using platform::CountryFile;
@@ -22,10 +25,11 @@ namespace
 /*!
  * \brief CheckMwmConsistency checks versions of mwm and routing files.
  * \param localFile reference to country file we need to check.
+ * \param routingTimestamp timestamp of the routing file.
  * \return true if files has same versions.
  * \warning Function assumes that the file lock was already taken.
  */
-bool CheckMwmConsistency(LocalCountryFile const & localFile)
+bool CheckMwmConsistency(LocalCountryFile const & localFile, uint32_t & routingTimestamp)
 {
   ModelReaderPtr r1 = FilesContainerR(localFile.GetPath(MapOptions::CarRouting))
       .GetReader(VERSION_FILE_TAG);
@@ -40,17 +44,43 @@ bool CheckMwmConsistency(LocalCountryFile const & localFile)
   version::MwmVersion version2;
   version::ReadVersion(src2, version2);
 
+  routingTimestamp = version1.timestamp;
   return version1.timestamp == version2.timestamp;
 }
 } //  namespace
 
 namespace routing
 {
+// static
+size_t constexpr LoadTimeHistogram::kBucketsCount;
+
+void LoadTimeHistogram::Add(uint64_t durationNs)
+{
+  uint64_t const durationMs = durationNs / 1000000;
+  size_t bucket = 0;
+  while (bucket + 1 < kBucketsCount && (durationMs >> bucket) != 0)
+    ++bucket;
+  ++m_buckets[bucket];
+  ++m_loadsCount;
+  m_totalNs += durationNs;
+}
+
+string DebugPrint(LoadTimeHistogram const & histogram)
+{
+  ostringstream out;
+  out << "LoadTimeHistogram [ loads: " << histogram.GetLoadsCount()
+      << ", total ms: " << histogram.GetTotalNs() / 1000000 << ", buckets:";
+  for (size_t i = 0; i < LoadTimeHistogram::kBucketsCount; ++i)
+    out << " " << histogram.GetBucket(i);
+  out << " ]";
+  return out.str();
+}
 
 RoutingMapping::RoutingMapping(string const & countryFile, MwmSet * pIndex)
     : m_mapCounter(0),
       m_facadeCounter(0),
       m_crossContextLoaded(0),
+      m_timestamp(0),
       m_countryFile(countryFile),
       m_error(IRouter::ResultCode::RouteFileNotExist)
 {
@@ -67,7 +97,7 @@ RoutingMapping::RoutingMapping(string const & countryFile, MwmSet * pIndex)
   }
 
   m_container.Open(localFile.GetPath(MapOptions::CarRouting));
-  if (!CheckMwmConsistency(localFile))
+  if (!CheckMwmConsistency(localFile, m_timestamp))
   {
     m_error = IRouter::ResultCode::InconsistentMWMandRoute;
     m_container.Close();
@@ -83,6 +113,8 @@ RoutingMapping::~RoutingMapping()
   // Clear data while m_container is valid.
   m_dataFacade.Clear();
   m_segMapping.Clear();
+  m_segmentsIndex.Unmap();
+  m_turnsInfo.Unmap();
   m_container.Close();
 }
 
@@ -93,6 +125,8 @@ void RoutingMapping::Map()
   {
     m_segMapping.Load(m_container, m_handle.GetInfo()->GetLocalFile());
     m_segMapping.Map(m_container);
+    m_segmentsIndex.Map(m_container, ROUTING_SEGMENTS_INDEX_FILE_TAG);
+    m_turnsInfo.Map(m_container, ROUTING_TURNS_INFO_FILE_TAG);
   }
 }
 
@@ -100,14 +134,22 @@ void RoutingMapping::Unmap()
 {
   --m_mapCounter;
   if (m_mapCounter < 1 && m_segMapping.IsMapped())
+  {
+    m_segmentsIndex.Unmap();
+    m_turnsInfo.Unmap();
     m_segMapping.Unmap();
+  }
 }
 
 void RoutingMapping::LoadFacade()
 {
   if (!m_facadeCounter)
   {
+    my::HighResTimer timer(true);
     m_dataFacade.Load(m_container);
+    m_dataFacade.BuildAdjacencyCache(m_adjacencyCacheBytes);
+    if (m_loadTimes)
+      m_loadTimes->Add(timer.ElapsedNano());
   }
   ++m_facadeCounter;
 }
@@ -155,8 +197,139 @@ TRoutingMappingPtr RoutingIndexManager::GetMappingByName(string const & mapName)
 
   // Or load and check file.
   TRoutingMappingPtr newMapping(new RoutingMapping(mapName, m_index));
+  newMapping->SetLoadTimeHistogram(&m_loadTimes[mapName]);
+  newMapping->SetAdjacencyCacheSize(m_adjacencyCacheBytes);
   m_mapping[mapName] = newMapping;
   return newMapping;
 }
 
+// static
+size_t constexpr RoutingIndexManager::kDefaultResidentMappingsCount;
+
+void RoutingIndexManager::Pin(TRoutingMappingPtr const & mapping)
+{
+  if (!mapping->IsValid())
+    return;
+
+  auto const it = find(m_resident.begin(), m_resident.end(), mapping);
+  if (it != m_resident.end())
+  {
+    m_resident.splice(m_resident.begin(), m_resident, it);
+    return;
+  }
+
+  if (m_residentCount == 0)
+    return;
+
+  mapping->Map();
+  mapping->LoadFacade();
+  m_resident.push_front(mapping);
+  ShrinkResident();
+}
+
+void RoutingIndexManager::SetResidentMappingsCount(size_t count)
+{
+  m_residentCount = count;
+  ShrinkResident();
+}
+
+void RoutingIndexManager::SetMemoryBudget(uint64_t bytes)
+{
+  m_memoryBudget = bytes;
+  ShrinkResident();
+}
+
+map<string, uint64_t> RoutingIndexManager::GetMemoryUsage() const
+{
+  map<string, uint64_t> usage;
+  for (auto const & mapping : m_mapping)
+  {
+    uint64_t const size = mapping.second->GetFacadeMemorySize();
+    if (size != 0)
+      usage[mapping.first] = size;
+  }
+  return usage;
+}
+
+uint64_t RoutingIndexManager::GetTotalMemoryUsage() const
+{
+  uint64_t total = 0;
+  for (auto const & mapping : m_mapping)
+    total += mapping.second->GetFacadeMemorySize();
+  return total;
+}
+
+void RoutingIndexManager::SetAdjacencyCacheSize(size_t bytes)
+{
+  m_adjacencyCacheBytes = bytes;
+  for (auto const & mapping : m_mapping)
+    mapping.second->SetAdjacencyCacheSize(bytes);
+}
+
+void RoutingIndexManager::ReleaseUnused()
+{
+  for (auto it = m_resident.begin(); it != m_resident.end();)
+  {
+    if ((*it)->IsUpToDate())
+    {
+      ++it;
+      continue;
+    }
+    Unpin(*it);
+    it = m_resident.erase(it);
+  }
+
+  for (auto it = m_mapping.begin(); it != m_mapping.end();)
+  {
+    if (find(m_resident.begin(), m_resident.end(), it->second) == m_resident.end())
+      it = m_mapping.erase(it);
+    else
+      ++it;
+  }
+}
+
+void RoutingIndexManager::Clear()
+{
+  for (TRoutingMappingPtr const & mapping : m_resident)
+    Unpin(mapping);
+  m_resident.clear();
+  m_mapping.clear();
+}
+
+void RoutingIndexManager::ShrinkResident()
+{
+  while (m_resident.size() > m_residentCount)
+  {
+    Unpin(m_resident.back());
+    m_resident.pop_back();
+  }
+
+  if (m_memoryBudget == 0 || m_resident.empty())
+    return;
+
+  // The most recently pinned mapping is kept, it's pinned to be used right now. Facades which
+  // are loaded by the current request too aren't freed by the unpinning, so they're kept.
+  uint64_t total = GetTotalMemoryUsage();
+  auto it = m_resident.end();
+  while (total > m_memoryBudget && --it != m_resident.begin())
+  {
+    TRoutingMappingPtr const mapping = *it;
+    if (mapping->GetFacadeLoadsCount() > 1)
+      continue;
+
+    uint64_t const size = mapping->GetFacadeMemorySize();
+    LOG(LDEBUG, ("Routing facade of", mapping->GetCountryName(), "is freed, memory:", total,
+                 "budget:", m_memoryBudget));
+    Unpin(mapping);
+    it = m_resident.erase(it);
+    total -= size;
+  }
+}
+
+void RoutingIndexManager::Unpin(TRoutingMappingPtr const & mapping)
+{
+  mapping->Unmap();
+  mapping->FreeFacade();
+}
+
 }  // namespace routing
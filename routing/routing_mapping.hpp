@@ -2,13 +2,18 @@
 
 #include "osrm2feature_map.hpp"
 #include "osrm_data_facade.hpp"
+#include "road_segments_index.hpp"
 #include "router.hpp"
+#include "turns_info.hpp"
 
 #include "indexer/index.hpp"
 
 #include "3party/osrm/osrm-backend/data_structures/query_edge.hpp"
 
 #include "std/algorithm.hpp"
+#include "std/array.hpp"
+#include "std/list.hpp"
+#include "std/map.hpp"
 #include "std/unordered_map.hpp"
 
 
@@ -16,11 +21,37 @@ namespace routing
 {
 using TDataFacade = OsrmDataFacade<QueryEdge::EdgeData>;
 
+/// Histogram of durations of routing facade loads.
+/// The i-th bucket counts loads which took less than 2^i milliseconds and not less than
+/// 2^(i-1) milliseconds, the last bucket counts all the longer loads too.
+class LoadTimeHistogram
+{
+public:
+  static size_t constexpr kBucketsCount = 12;
+
+  void Add(uint64_t durationNs);
+
+  inline uint32_t GetBucket(size_t i) const { return m_buckets[i]; }
+  inline uint32_t GetLoadsCount() const { return m_loadsCount; }
+  inline uint64_t GetTotalNs() const { return m_totalNs; }
+
+private:
+  array<uint32_t, kBucketsCount> m_buckets = {};
+  uint32_t m_loadsCount = 0;
+  uint64_t m_totalNs = 0;
+};
+
+string DebugPrint(LoadTimeHistogram const & histogram);
+
 /// Datamapping and facade for single MWM and MWM.routing file
 struct RoutingMapping
 {
   TDataFacade m_dataFacade;
   OsrmFtSegMapping m_segMapping;
+  /// Mapped with m_segMapping, it's empty for the routing files without the index.
+  RoadSegmentsIndex m_segmentsIndex;
+  /// Mapped with m_segMapping, it's empty for the routing files without the section.
+  turns::TurnsInfoSection m_turnsInfo;
   CrossRoutingContextReader m_crossContext;
 
   /// Default constructor to create invalid instance for existing client code.
@@ -36,11 +67,31 @@ struct RoutingMapping
   void LoadFacade();
   void FreeFacade();
 
+  /// @return Count of the LoadFacade() calls which are not freed yet.
+  size_t GetFacadeLoadsCount() const { return m_facadeCounter; }
+
+  /// @return Memory of the loaded facade, zero when it's not loaded, see
+  /// OsrmDataFacade::GetMemorySize().
+  uint64_t GetFacadeMemorySize() const
+  {
+    return m_facadeCounter ? m_dataFacade.GetMemorySize() : 0;
+  }
+
   void LoadCrossContext();
   void FreeCrossContext();
 
   bool IsValid() const { return m_handle.IsAlive() && m_error == IRouter::ResultCode::NoError; }
 
+  /// @return True when the mapping is valid and the mwm has not been replaced by a newer one.
+  bool IsUpToDate() const { return IsValid() && m_handle.GetInfo()->IsUpToDate(); }
+
+  /// Durations of facade loads are added to the histogram, which must outlive the mapping.
+  void SetLoadTimeHistogram(LoadTimeHistogram * histogram) { m_loadTimes = histogram; }
+
+  /// Sets the memory of the adjacency cache which is built on the facade loads, see
+  /// OsrmRawDataFacade::BuildAdjacencyCache(). Zero disables the cache.
+  void SetAdjacencyCacheSize(size_t bytes) { m_adjacencyCacheBytes = bytes; }
+
   IRouter::ResultCode GetError() const { return m_error; }
 
   /*!
@@ -51,14 +102,20 @@ struct RoutingMapping
 
   Index::MwmId const & GetMwmId() const { return m_handle.GetId(); }
 
+  /// @return Version timestamp of the routing file.
+  uint32_t GetTimestamp() const { return m_timestamp; }
+
 private:
   size_t m_mapCounter;
   size_t m_facadeCounter;
   bool m_crossContextLoaded;
+  uint32_t m_timestamp;
   string m_countryFile;
   FilesMappingContainer m_container;
   IRouter::ResultCode m_error;
   MwmSet::MwmHandle m_handle;
+  LoadTimeHistogram * m_loadTimes = nullptr;
+  size_t m_adjacencyCacheBytes = 0;
 };
 
 typedef shared_ptr<RoutingMapping> TRoutingMappingPtr;
@@ -82,18 +139,39 @@ public:
   }
 };
 
+//! \brief The FacadeGuard class. Loads only the facade of the mapping, it's enough for the
+//! searches which don't unpack the routes to the features, the feature segments mapping isn't
+//! read for them.
+class FacadeGuard
+{
+  TRoutingMappingPtr const m_mapping;
+
+public:
+  FacadeGuard(TRoutingMappingPtr const mapping) : m_mapping(mapping) { m_mapping->LoadFacade(); }
+  ~FacadeGuard() { m_mapping->FreeFacade(); }
+};
+
 /*! Manager for loading, cashing and building routing indexes.
  * Builds and shares special routing contexts.
+ * A few most recently pinned mappings are resident: their data stay loaded between
+ * routing requests, so routes through the same countries don't map and load them again.
+ * Facades of the resident mappings are also limited by the memory budget: the least recently
+ * pinned ones are freed when the loaded facades take more memory, even in the middle of
+ * a route through many countries.
 */
 class RoutingIndexManager
 {
 public:
+  static size_t constexpr kDefaultResidentMappingsCount = 4;
+
   RoutingIndexManager(TCountryFileFn const & countryFileFn, MwmSet * index)
       : m_countryFileFn(countryFileFn), m_index(index)
   {
     ASSERT(index, ());
   }
 
+  ~RoutingIndexManager() { Clear(); }
+
   TRoutingMappingPtr GetMappingByPoint(m2::PointD const & point);
 
   TRoutingMappingPtr GetMappingByName(string const & mapName);
@@ -104,12 +182,51 @@ public:
     for_each(m_mapping.begin(), m_mapping.end(), toDo);
   }
 
-  void Clear() { m_mapping.clear(); }
+  /// Marks the mapping as the most recently used one. Data of the mapping stay loaded
+  /// while it's among the resident mappings.
+  void Pin(TRoutingMappingPtr const & mapping);
+
+  /// Sets the count of resident mappings, zero disables keeping data between requests.
+  void SetResidentMappingsCount(size_t count);
+  size_t GetResidentMappingsCount() const { return m_residentCount; }
+
+  /// Sets the memory of the loaded facades which the resident mappings may take up to,
+  /// zero disables the limit. Facades which are used by the current request are never freed.
+  void SetMemoryBudget(uint64_t bytes);
+  uint64_t GetMemoryBudget() const { return m_memoryBudget; }
+
+  /// @return Memory of the loaded facades by country names, see
+  /// RoutingMapping::GetFacadeMemorySize().
+  map<string, uint64_t> GetMemoryUsage() const;
+  uint64_t GetTotalMemoryUsage() const;
+
+  /// Sets the memory of the adjacency cache of each mapping, zero disables the cache.
+  /// It's applied by the next facade loads of the mappings.
+  void SetAdjacencyCacheSize(size_t bytes);
+
+  /// Frees all the mappings except the resident ones which are up to date.
+  void ReleaseUnused();
+
+  /// Frees all the mappings.
+  void Clear();
+
+  /// @return Histograms of facade load times by country names.
+  map<string, LoadTimeHistogram> const & GetLoadTimes() const { return m_loadTimes; }
 
 private:
+  void ShrinkResident();
+  void Unpin(TRoutingMappingPtr const & mapping);
+
   TCountryFileFn m_countryFileFn;
   unordered_map<string, TRoutingMappingPtr> m_mapping;
   MwmSet * m_index;
+
+  // Resident mappings, the most recently pinned one is the first.
+  list<TRoutingMappingPtr> m_resident;
+  size_t m_residentCount = kDefaultResidentMappingsCount;
+  size_t m_adjacencyCacheBytes = 0;
+  uint64_t m_memoryBudget = 0;
+  map<string, LoadTimeHistogram> m_loadTimes;
 };
 
 }  // namespace routing
@@ -8,6 +8,8 @@
 
 #include "coding/internal/file_data.hpp"
 
+#include "std/limits.hpp"
+
 #include "3party/Alohalytics/src/alohalytics.h"
 
 using namespace location;
@@ -31,6 +33,23 @@ double constexpr kMaxTurnDistM = 400.;
 // @todo(kshalnev) The distance may depend on the current speed.
 double constexpr kShowPedestrianTurnInMeters = 5.;
 
+// The position is matched to the detours after this number of the positions which move away
+// from the route, so the detours aren't taken because of a GPS jitter.
+int constexpr kSpeculativeMissedCount = 2;
+// Detours start this distance after the turn points, so they begin on the roads which go
+// straight through the junctions instead of the roads of the route.
+double constexpr kSpeculativeStartOffsetM = 20.;
+// Detours are calculated beforehand, so the timeout is longer than the interactive one.
+uint32_t constexpr kSpeculativeRouteTimeoutSec = 30;
+uint32_t constexpr kNoSpeculativeMatch = numeric_limits<uint32_t>::max();
+
+bool IsSpeculativeTurn(routing::turns::TurnItem const & turn)
+{
+  using routing::turns::TurnDirection;
+  return routing::turns::IsLeftOrRightTurn(turn.m_turn) || turn.m_turn == TurnDirection::UTurn ||
+         turn.m_turn == TurnDirection::TakeTheExit;
+}
+
 }  // namespace
 
 namespace routing
@@ -41,7 +60,9 @@ RoutingSession::RoutingSession()
       m_route(string()),
       m_state(RoutingNotActive),
       m_endPoint(m2::PointD::Zero()),
-      m_passedDistanceOnRouteMeters(0.0)
+      m_passedDistanceOnRouteMeters(0.0),
+      m_speculativeMatch(kNoSpeculativeMatch),
+      m_speculativeGeneration(0)
 {
 }
 
@@ -64,12 +85,49 @@ void RoutingSession::BuildRoute(m2::PointD const & startPoint, m2::PointD const
   RebuildRoute(startPoint, readyCallback, progressCallback, timeoutSec);
 }
 
+void RoutingSession::RestoreRoute(Route & route)
+{
+  ASSERT(m_router != nullptr, ());
+  ASSERT(route.IsValid(), ());
+
+  threads::MutexGuard guard(m_routeSessionMutex);
+  UNUSED_VALUE(guard);
+
+  m2::PolylineD const & poly = route.GetPoly();
+  m_lastGoodPosition = poly.Front();
+  m_endPoint = poly.Back();
+  m_router->ClearState();
+  AssignRoute(route, IRouter::NoError);
+}
+
 void RoutingSession::RebuildRoute(m2::PointD const & startPoint,
     TReadyCallback const & readyCallback,
     TProgressCallback const & progressCallback, uint32_t timeoutSec)
 {
   ASSERT(m_router != nullptr, ());
   ASSERT_NOT_EQUAL(m_endPoint, m2::PointD::Zero(), ("End point was not set"));
+
+  // The detour which is matched to the position is assigned without waiting for the router.
+  Route detour(m_route.GetRouterId());
+  {
+    threads::MutexGuard guard(m_routeSessionMutex);
+    UNUSED_VALUE(guard);
+    auto const it = m_speculativeRoutes.find(m_speculativeMatch);
+    if (it != m_speculativeRoutes.end() && it->second)
+    {
+      detour.Swap(*it->second);
+      m_lastDistance = 0.0;
+      m_moveAwayCounter = 0;
+    }
+  }
+  if (detour.IsValid())
+  {
+    LOG(LINFO, ("The route is rebuilt by the detour of the turn", m_speculativeMatch));
+    m_lastGoodPosition = startPoint;
+    DoReadyCallback(*this, readyCallback, m_routeSessionMutex)(detour, IRouter::NoError);
+    return;
+  }
+
   RemoveRoute();
   m_state = RouteBuilding;
 
@@ -90,6 +148,22 @@ void RoutingSession::DoReadyCallback::operator()(Route & route, IRouter::ResultC
   m_callback(m_rs.m_route, e);
 }
 
+void RoutingSession::DoSpeculativeReadyCallback::operator()(Route & route, IRouter::ResultCode e)
+{
+  threads::MutexGuard guard(m_routeSessionMutexInner);
+  UNUSED_VALUE(guard);
+
+  if (e != IRouter::NoError || !route.IsValid() || m_generation != m_rs.m_speculativeGeneration)
+    return;
+  auto const it = m_rs.m_speculativeRoutes.find(m_turnIndex);
+  if (it == m_rs.m_speculativeRoutes.end())
+    return;
+
+  route.SetRoutingSettings(m_rs.m_routingSettings);
+  it->second.reset(new Route(string()));
+  it->second->Swap(route);
+}
+
 void RoutingSession::RemoveRouteImpl()
 {
   m_state = RoutingNotActive;
@@ -97,6 +171,8 @@ void RoutingSession::RemoveRouteImpl()
   m_moveAwayCounter = 0;
 
   Route(string()).Swap(m_route);
+  ResetSpeculativeRoutes();
+  UpdateFollowingInfo();
 }
 
 void RoutingSession::RemoveRoute()
@@ -144,6 +220,7 @@ RoutingSession::State RoutingSession::OnLocationPositionChanged(m2::PointD const
 
   m_turnsSound.SetSpeedMetersPerSecond(info.m_speed);
 
+  State const prevState = m_state;
   if (m_route.MoveIterator(info))
   {
     m_moveAwayCounter = 0;
@@ -159,7 +236,10 @@ RoutingSession::State RoutingSession::OnLocationPositionChanged(m2::PointD const
       alohalytics::LogEvent("RouteTracking_ReachedDestination", params);
     }
     else
+    {
       m_state = OnRoute;
+      RequestSpeculativeRoutes();
+    }
     m_lastGoodPosition = position;
   }
   else
@@ -178,17 +258,26 @@ RoutingSession::State RoutingSession::OnLocationPositionChanged(m2::PointD const
       m_lastDistance = 0.0;
     }
 
-    if (m_moveAwayCounter > kOnRouteMissedCount)
+    // A detour which goes through the position replaces the route without waiting for
+    // kOnRouteMissedCount positions.
+    bool const onDetour =
+        m_moveAwayCounter >= kSpeculativeMissedCount && MatchSpeculativeRoute(info);
+    if (onDetour || m_moveAwayCounter > kOnRouteMissedCount)
     {
       m_passedDistanceOnRouteMeters += m_route.GetCurrentDistanceFromBeginMeters();
       m_state = RouteNeedRebuild;
     }
+
+    // The position on the route isn't changed.
+    if (m_state == prevState)
+      return m_state;
   }
 
+  UpdateFollowingInfo();
   return m_state;
 }
 
-void RoutingSession::GetRouteFollowingInfo(FollowingInfo & info) const
+void RoutingSession::UpdateFollowingInfo()
 {
   auto formatDistFn = [](double dist, string & value, string & suffix)
   {
@@ -201,11 +290,13 @@ void RoutingSession::GetRouteFollowingInfo(FollowingInfo & info) const
     value.erase(delim);
   };
 
-  threads::MutexGuard guard(m_routeSessionMutex);
-  UNUSED_VALUE(guard);
-
+  // Nothing should be displayed on the screen about turns when the route isn't navigable,
+  // then the snapshot is nullptr.
+  shared_ptr<FollowingInfo> snapshot;
   if (m_route.IsValid() && IsNavigable())
   {
+    snapshot = make_shared<FollowingInfo>();
+    FollowingInfo & info = *snapshot;
     formatDistFn(m_route.GetCurrentDistanceToEndMeters(), info.m_distToTarget, info.m_targetUnitsSuffix);
 
     double distanceToTurnMeters = 0., distanceToNextTurnMeters = 0.;
@@ -266,11 +357,34 @@ void RoutingSession::GetRouteFollowingInfo(FollowingInfo & info) const
     info.m_pedestrianTurn =
         (distanceToTurnMeters < kShowPedestrianTurnInMeters) ? turn.m_pedestrianTurn : turns::PedestrianDirection::None;
   }
-  else
+
+  threads::MutexGuard guard(m_followingInfoMutex);
+  UNUSED_VALUE(guard);
+  m_followingInfo = move(snapshot);
+}
+
+void RoutingSession::GetRouteFollowingInfo(FollowingInfo & info) const
+{
+  // The info is built once per matched position, the readers only copy it and don't wait for
+  // the location thread.
+  shared_ptr<FollowingInfo const> snapshot;
+  {
+    threads::MutexGuard guard(m_followingInfoMutex);
+    UNUSED_VALUE(guard);
+    snapshot = m_followingInfo;
+  }
+
+  if (!snapshot)
   {
-    // nothing should be displayed on the screen about turns if these lines are executed
     info = FollowingInfo();
+    return;
   }
+
+  // Turn notifications aren't a part of the snapshot, they are generated by GenerateTurnSound().
+  vector<string> turnNotifications;
+  turnNotifications.swap(info.m_turnNotifications);
+  info = *snapshot;
+  info.m_turnNotifications.swap(turnNotifications);
 }
 
 void RoutingSession::GenerateTurnSound(vector<string> & turnNotifications)
@@ -279,18 +393,20 @@ void RoutingSession::GenerateTurnSound(vector<string> & turnNotifications)
 
   threads::MutexGuard guard(m_routeSessionMutex);
   UNUSED_VALUE(guard);
-  // Voice turn notifications.
-  if (!m_routingSettings.m_soundDirection)
+  // Voice turn notifications. Most of the updates produce no notification, so the turn isn't
+  // copied and nothing is looked up when voice is off.
+  if (!m_routingSettings.m_soundDirection || !m_turnsSound.IsEnabled())
     return;
 
   if (!m_route.IsValid() || !IsNavigable())
     return;
 
   double distanceToTurnMeters = 0.;
-  turns::TurnItem turn;
-  m_route.GetCurrentTurn(distanceToTurnMeters, turn);
+  turns::TurnItem const * turn = m_route.GetCurrentTurn(distanceToTurnMeters);
+  if (turn == nullptr)
+    return;
 
-  m_turnsSound.GenerateTurnSound(turn, distanceToTurnMeters, turnNotifications);
+  m_turnsSound.GenerateTurnSound(*turn, distanceToTurnMeters, turnNotifications);
 }
 
 void RoutingSession::AssignRoute(Route & route, IRouter::ResultCode e)
@@ -310,6 +426,75 @@ void RoutingSession::AssignRoute(Route & route, IRouter::ResultCode e)
 
   route.SetRoutingSettings(m_routingSettings);
   m_route.Swap(route);
+  ResetSpeculativeRoutes();
+  if (e == IRouter::NoError)
+    RequestSpeculativeRoutes();
+  UpdateFollowingInfo();
+}
+
+void RoutingSession::RequestSpeculativeRoutes()
+{
+  if (m_routingSettings.m_speculativeRoutesCount == 0 || !m_route.IsValid())
+    return;
+
+  double distanceToTurnMeters = 0.;
+  turns::TurnItem const * current = m_route.GetCurrentTurn(distanceToTurnMeters);
+  if (current == nullptr)
+    return;
+
+  // Detours of the passed turns aren't needed.
+  while (!m_speculativeRoutes.empty() && m_speculativeRoutes.begin()->first < current->m_index)
+    m_speculativeRoutes.erase(m_speculativeRoutes.begin());
+
+  m2::PolylineD const & poly = m_route.GetPoly();
+  Route::TTurns const & turns = m_route.GetTurns();
+  size_t requested = 0;
+  for (auto it = turns.begin() + distance(turns.data(), current);
+       it != turns.end() && requested < m_routingSettings.m_speculativeRoutesCount; ++it)
+  {
+    if (!IsSpeculativeTurn(*it) || it->m_index == 0 || it->m_index + 1 >= poly.GetSize())
+      continue;
+    m2::PointD const & turnPoint = poly.GetPoint(it->m_index);
+    m2::PointD const & prevPoint = poly.GetPoint(it->m_index - 1);
+    if (turnPoint == prevPoint)
+      continue;
+    ++requested;
+    if (m_speculativeRoutes.count(it->m_index) != 0)
+      continue;
+    m_speculativeRoutes[it->m_index] = nullptr;
+
+    m2::PointD const direction = (turnPoint - prevPoint).Normalize();
+    m2::PointD const startPoint = MercatorBounds::GetSmPoint(
+        turnPoint, direction.x * kSpeculativeStartOffsetM, direction.y * kSpeculativeStartOffsetM);
+    m_router->CalculateBackgroundRoute(
+        startPoint, direction, m_endPoint,
+        DoSpeculativeReadyCallback(*this, m_speculativeGeneration, it->m_index,
+                                   m_routeSessionMutex),
+        kSpeculativeRouteTimeoutSec);
+  }
+}
+
+void RoutingSession::ResetSpeculativeRoutes()
+{
+  ++m_speculativeGeneration;
+  m_speculativeMatch = kNoSpeculativeMatch;
+  if (m_speculativeRoutes.empty())
+    return;
+  m_speculativeRoutes.clear();
+  m_router->CancelBackgroundRoutes();
+}
+
+bool RoutingSession::MatchSpeculativeRoute(GpsInfo const & info)
+{
+  for (auto const & detour : m_speculativeRoutes)
+  {
+    if (detour.second && detour.second->MoveIterator(info))
+    {
+      m_speculativeMatch = detour.first;
+      return true;
+    }
+  }
+  return false;
 }
 
 void RoutingSession::SetRouter(unique_ptr<IRouter> && router,
@@ -351,6 +536,7 @@ void RoutingSession::SetRoutingSettings(RoutingSettings const & routingSettings)
   threads::MutexGuard guard(m_routeSessionMutex);
   UNUSED_VALUE(guard);
   m_routingSettings = routingSettings;
+  UpdateFollowingInfo();
 }
 
 void RoutingSession::EnableTurnNotifications(bool enable)
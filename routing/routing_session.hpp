@@ -14,6 +14,8 @@
 #include "base/deferred_task.hpp"
 #include "base/mutex.hpp"
 
+#include "std/map.hpp"
+#include "std/shared_ptr.hpp"
 #include "std/unique_ptr.hpp"
 
 namespace location
@@ -66,6 +68,9 @@ public:
   void BuildRoute(m2::PointD const & startPoint, m2::PointD const & endPoint,
                   TReadyCallback const & readyCallback,
                   TProgressCallback const & progressCallback, uint32_t timeoutSec);
+  /// Assigns the route which was built before the restart of the app, it's followed from its
+  /// start point to its end point as the built route.
+  void RestoreRoute(Route & route);
   void RebuildRoute(m2::PointD const & startPoint, TReadyCallback const & readyCallback,
                     TProgressCallback const & progressCallback, uint32_t timeoutSec);
 
@@ -113,12 +118,42 @@ private:
     void operator()(Route & route, IRouter::ResultCode e);
   };
 
+  struct DoSpeculativeReadyCallback
+  {
+    RoutingSession & m_rs;
+    uint64_t m_generation;
+    uint32_t m_turnIndex;
+    threads::Mutex & m_routeSessionMutexInner;
+
+    DoSpeculativeReadyCallback(RoutingSession & rs, uint64_t generation, uint32_t turnIndex,
+                               threads::Mutex & routeSessionMutex)
+      : m_rs(rs), m_generation(generation), m_turnIndex(turnIndex),
+        m_routeSessionMutexInner(routeSessionMutex)
+    {
+    }
+
+    void operator()(Route & route, IRouter::ResultCode e);
+  };
+
   void AssignRoute(Route & route, IRouter::ResultCode e);
 
+  /// Requests the detours of the upcoming turns of m_route which have no detours yet and drops
+  /// the detours of the passed turns. It's called under m_routeSessionMutex.
+  void RequestSpeculativeRoutes();
+  /// Drops the detours and cancels their calculation. It's called under m_routeSessionMutex.
+  void ResetSpeculativeRoutes();
+  /// @return True if the position is on one of the calculated detours, it's kept
+  /// in m_speculativeMatch then. It's called under m_routeSessionMutex.
+  bool MatchSpeculativeRoute(location::GpsInfo const & info);
+
   /// RemoveRoute removes m_route and resets route attributes (m_state, m_lastDistance, m_moveAwayCounter).
   void RemoveRoute();
   void RemoveRouteImpl();
 
+  /// Rebuilds the following info for the current position on the route.
+  /// It's called under m_routeSessionMutex whenever the position or the route is changed.
+  void UpdateFollowingInfo();
+
 private:
   unique_ptr<AsyncRouter> m_router;
   Route m_route;
@@ -139,5 +174,19 @@ private:
 
   // Passed distance on route including reroutes
   double m_passedDistanceOnRouteMeters;
+
+  /// Detours of the upcoming turns of m_route, they start just after the turn points in the
+  /// direction of the route before the turns. The keys are the indices of the turn points,
+  /// the values are nullptr until the detours are calculated.
+  map<uint32_t, unique_ptr<Route>> m_speculativeRoutes;
+  /// Key of the detour which is matched to the position, it's used by RebuildRoute().
+  uint32_t m_speculativeMatch;
+  /// It's changed with m_route, so the detours of the previous routes are dropped.
+  uint64_t m_speculativeGeneration;
+
+  /// Following info of the current position, nullptr when the route isn't navigable.
+  /// The snapshot is immutable, m_followingInfoMutex guards the pointer only.
+  shared_ptr<location::FollowingInfo const> m_followingInfo;
+  mutable threads::Mutex m_followingInfoMutex;
 };
 }  // namespace routing
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "std/cstdint.hpp"
 #include "std/utility.hpp"
 
 namespace routing
@@ -32,19 +33,24 @@ struct RoutingSettings
   /// \brief if m_showTurnAfterNext is equal to true end users see a notification
   /// about the turn after the next in some cases.
   bool m_showTurnAfterNext;
+
+  /// \brief m_speculativeRoutesCount is a number of the upcoming turns of the route which
+  /// have the detours calculated beforehand, so an end user who misses one of the turns
+  /// gets the detour at once. Zero means that the routes are rebuilt from scratch only.
+  uint32_t m_speculativeRoutesCount;
 };
 
 inline RoutingSettings GetPedestrianRoutingSettings()
 {
   return RoutingSettings({ false /* m_matchRoute */, false /* m_soundDirection */,
                            20. /* m_matchingThresholdM */, true /* m_keepPedestrianInfo */,
-                           false /* m_showTurnAfterNext */});
+                           false /* m_showTurnAfterNext */, 0 /* m_speculativeRoutesCount */});
 }
 
 inline RoutingSettings GetCarRoutingSettings()
 {
   return RoutingSettings({ true /* m_matchRoute */, true /* m_soundDirection */,
                            50. /* m_matchingThresholdM */, false /* m_keepPedestrianInfo */,
-                           true /* m_showTurnAfterNext */});
+                           true /* m_showTurnAfterNext */, 3 /* m_speculativeRoutesCount */});
 }
 }  // namespace routing
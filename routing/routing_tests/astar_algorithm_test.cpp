@@ -1,6 +1,8 @@
 #include "testing/testing.hpp"
 
 #include "routing/base/astar_algorithm.hpp"
+#include "routing/base/astar_containers.hpp"
+
 #include "std/map.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
@@ -88,4 +90,42 @@ UNIT_TEST(AStarAlgorithm_Sample)
   TestAStar(graph, expectedRoute);
 }
 
+UNIT_TEST(AStarAlgorithm_VertexIndex)
+{
+  VertexIndex<unsigned> index;
+  TEST_EQUAL(0, index.Insert(10), ());
+  TEST_EQUAL(1, index.Insert(5), ());
+  TEST_EQUAL(0, index.Insert(10), ());
+  TEST_EQUAL(2, index.GetSize(), ());
+  TEST_EQUAL(5, index.GetVertex(1), ());
+  TEST_EQUAL(1, index.Find(5), ());
+  TEST_EQUAL(VertexIndex<unsigned>::kInvalidId, index.Find(7), ());
+}
+
+UNIT_TEST(AStarAlgorithm_IndexedFourAryHeap)
+{
+  IndexedFourAryHeap heap;
+  vector<double> const keys = {7.0, 3.0, 9.0, 1.0, 8.0, 4.0, 6.0, 2.0, 5.0, 0.5};
+  for (uint32_t id = 0; id < keys.size(); ++id)
+    heap.PushOrDecrease(id, keys[id]);
+
+  // Decrease-key moves the ids up.
+  heap.PushOrDecrease(2, 0.1);
+  heap.PushOrDecrease(4, 2.5);
+  TEST(heap.Contains(4), ());
+
+  vector<uint32_t> const expectedOrder = {2, 9, 3, 7, 4, 1, 5, 8, 6, 0};
+  vector<uint32_t> actualOrder;
+  double prevKey = 0.0;
+  while (!heap.Empty())
+  {
+    TEST_LESS_OR_EQUAL(prevKey, heap.TopKey(), ());
+    prevKey = heap.TopKey();
+    actualOrder.push_back(heap.Top());
+    heap.Pop();
+  }
+  TEST_EQUAL(expectedOrder, actualOrder, ());
+  TEST(!heap.Contains(4), ());
+}
+
 }  // namespace routing_test
@@ -8,6 +8,7 @@
 
 #include "base/timer.hpp"
 
+#include "std/chrono.hpp"
 #include "std/condition_variable.hpp"
 #include "std/mutex.hpp"
 #include "std/string.hpp"
@@ -55,6 +56,58 @@ public:
   void GetAbsentCountries(vector<string> & countries) override { countries = m_absent; }
 };
 
+/// Routes which start at x < 0 are blocked until they are released or cancelled.
+class BlockingRouter : public IRouter
+{
+public:
+  // IRouter overrides:
+  string GetName() const override { return "Blocking"; }
+  ResultCode CalculateRoute(m2::PointD const & startPoint, m2::PointD const & startDirection,
+                            m2::PointD const & finalPoint, RouterDelegate const & delegate,
+                            Route & route) override
+  {
+    {
+      unique_lock<mutex> lock(m_lock);
+      m_starts.push_back(startPoint);
+      m_cv.notify_all();
+      if (startPoint.x < 0)
+      {
+        while (!m_released && !delegate.IsCancelled())
+          m_cv.wait_for(lock, milliseconds(1));
+        if (!m_released)
+          return ResultCode::Cancelled;
+      }
+    }
+    vector<m2::PointD> points({startPoint, finalPoint});
+    route = Route("blocking", points.begin(), points.end());
+    return ResultCode::NoError;
+  }
+
+  void WaitStarts(size_t count)
+  {
+    unique_lock<mutex> lock(m_lock);
+    m_cv.wait(lock, [&] { return m_starts.size() >= count; });
+  }
+
+  void Release()
+  {
+    lock_guard<mutex> lock(m_lock);
+    m_released = true;
+  }
+
+  vector<m2::PointD> GetStarts()
+  {
+    lock_guard<mutex> lock(m_lock);
+    return m_starts;
+  }
+
+private:
+  mutex m_lock;
+  condition_variable m_cv;
+  vector<m2::PointD> m_starts;
+  bool m_released = false;
+};
+
 void DummyStatisticsCallback(map<string, string> const &) {}
 
 struct DummyResultCallback
@@ -128,4 +181,57 @@ UNIT_TEST(StandartAsyncFogTest)
   TEST_EQUAL(resultCallback.m_absent.size(), 1, ());
   TEST(resultCallback.m_absent[0].empty(), ());
 }
+
+UNIT_TEST(BackgroundRouteYieldsTest)
+{
+  BlockingRouter * blocking = new BlockingRouter();
+  DummyResultCallback foregroundCallback(1 /* expectedCalls */);
+  DummyResultCallback backgroundCallback(2 /* expectedCalls */);
+  AsyncRouter async(DummyStatisticsCallback, nullptr /* pointCheckCallback */);
+  async.SetRouter(unique_ptr<IRouter>(blocking), unique_ptr<IOnlineFetcher>());
+
+  async.CalculateBackgroundRoute({-1, 0}, {1, 0}, {5, 6}, bind(ref(backgroundCallback), _1, _2),
+                                 0 /* timeoutSec */);
+  async.CalculateBackgroundRoute({2, 0}, {1, 0}, {5, 6}, bind(ref(backgroundCallback), _1, _2),
+                                 0 /* timeoutSec */);
+  blocking->WaitStarts(1);
+
+  // The request interrupts the blocked background route, which is calculated again after it.
+  async.CalculateRoute({1, 0}, {1, 0}, {5, 6}, bind(ref(foregroundCallback), _1, _2),
+                       nullptr /* progressCallback */, 0 /* timeoutSec */);
+  foregroundCallback.WaitFinish();
+  blocking->WaitStarts(3);
+  blocking->Release();
+  backgroundCallback.WaitFinish();
+
+  vector<m2::PointD> const starts = blocking->GetStarts();
+  TEST_EQUAL(starts, vector<m2::PointD>({{-1, 0}, {1, 0}, {-1, 0}, {2, 0}}), ());
+  TEST_EQUAL(foregroundCallback.m_codes, vector<ResultCode>({ResultCode::NoError}), ());
+  TEST_EQUAL(backgroundCallback.m_codes,
+             vector<ResultCode>({ResultCode::NoError, ResultCode::NoError}), ());
+}
+
+UNIT_TEST(CancelBackgroundRoutesTest)
+{
+  BlockingRouter * blocking = new BlockingRouter();
+  DummyResultCallback cancelledCallback(0 /* expectedCalls */);
+  DummyResultCallback backgroundCallback(1 /* expectedCalls */);
+  AsyncRouter async(DummyStatisticsCallback, nullptr /* pointCheckCallback */);
+  async.SetRouter(unique_ptr<IRouter>(blocking), unique_ptr<IOnlineFetcher>());
+
+  async.CalculateBackgroundRoute({-1, 0}, {1, 0}, {5, 6}, bind(ref(cancelledCallback), _1, _2),
+                                 0 /* timeoutSec */);
+  async.CalculateBackgroundRoute({2, 0}, {1, 0}, {5, 6}, bind(ref(cancelledCallback), _1, _2),
+                                 0 /* timeoutSec */);
+  blocking->WaitStarts(1);
+  async.CancelBackgroundRoutes();
+
+  async.CalculateBackgroundRoute({3, 0}, {1, 0}, {5, 6}, bind(ref(backgroundCallback), _1, _2),
+                                 0 /* timeoutSec */);
+  backgroundCallback.WaitFinish();
+
+  TEST_EQUAL(blocking->GetStarts(), vector<m2::PointD>({{-1, 0}, {3, 0}}), ());
+  TEST(cancelledCallback.m_codes.empty(), ());
+  TEST_EQUAL(backgroundCallback.m_codes, vector<ResultCode>({ResultCode::NoError}), ());
+}
 }  //  namespace
@@ -0,0 +1,51 @@
+#include "testing/testing.hpp"
+
+#include "routing/bicycle_model.hpp"
+
+#include "indexer/classificator.hpp"
+#include "indexer/classificator_loader.hpp"
+#include "indexer/feature.hpp"
+
+using namespace routing;
+
+namespace
+{
+double GetSpeed(IVehicleModel const & model, vector<string> const & path)
+{
+  feature::TypesHolder h;
+  h(classif().GetTypeByPath(path));
+  return static_cast<VehicleModel const &>(model).GetSpeed(h);
+}
+}  // namespace
+
+UNIT_TEST(BicycleModel_Speed)
+{
+  classificator::Load();
+
+  BicycleModel const model;
+  TEST_EQUAL(model.GetMaxSpeed(), 20.0, ());
+  TEST_EQUAL(GetSpeed(model, {"highway", "cycleway"}), 20.0, ());
+  TEST_EQUAL(GetSpeed(model, {"highway", "cycleway", "bridge"}), 20.0, ());
+  TEST_EQUAL(GetSpeed(model, {"highway", "footway"}), 5.0, ());
+  TEST_EQUAL(GetSpeed(model, {"highway", "trunk"}), 3.0, ());
+
+  // Bicycles are not allowed there.
+  TEST_EQUAL(GetSpeed(model, {"highway", "motorway"}), 0.0, ());
+  TEST_EQUAL(GetSpeed(model, {"highway", "motorway_link"}), 0.0, ());
+  TEST_EQUAL(GetSpeed(model, {"highway", "steps"}), 0.0, ());
+}
+
+UNIT_TEST(BicycleModelFactory_Countries)
+{
+  classificator::Load();
+
+  BicycleModelFactory const factory;
+  TEST_EQUAL(GetSpeed(*factory.GetVehicleModel(), {"highway", "trunk"}), 3.0, ());
+  TEST_EQUAL(GetSpeed(*factory.GetVehicleModelForCountry("Germany"), {"highway", "trunk"}), 0.0,
+             ());
+  TEST_EQUAL(GetSpeed(*factory.GetVehicleModelForCountry("Germany"), {"highway", "cycleway"}),
+             20.0, ());
+  // The default model is used for the countries without their own models.
+  TEST_EQUAL(factory.GetVehicleModelForCountry("Unknown").get(), factory.GetVehicleModel().get(),
+             ());
+}
@@ -1,5 +1,6 @@
 #include "testing/testing.hpp"
 
+#include "routing/cross_mwm_overlay.hpp"
 #include "routing/cross_mwm_road_graph.hpp"
 #include "routing/cross_mwm_router.hpp"
 #include "routing/cross_routing_context.hpp"
@@ -11,6 +12,15 @@ using namespace routing;
 
 namespace
 {
+void SaveAndLoadContext(CrossRoutingContextWriter const & context, vector<char> & buffer,
+                        CrossRoutingContextReader & newContext)
+{
+  MemWriter<vector<char>> writer(buffer);
+  context.Save(writer);
+  MemReader reader(buffer.data(), buffer.size());
+  newContext.Load(reader);
+}
+
 // Graph to convertions.
 UNIT_TEST(TestCrossRouteConverter)
 {
@@ -102,4 +112,152 @@ UNIT_TEST(TestAdjacencyMatrix)
              routing::INVALID_CONTEXT_EDGE_WEIGHT, ("Default cost"));
 }
 
+UNIT_TEST(TestCrossMwmOverlay)
+{
+  CrossRoutingContextWriter aContext;
+  aContext.AddIngoingNode(1, {0., 0.});
+  aContext.AddOutgoingNode(2, "bMap", {1., 1.});
+  aContext.AddOutgoingNode(3, "cMap", {2., 2.});
+  aContext.ReserveAdjacencyMatrix();
+  {
+    auto ins = aContext.GetIngoingIterators();
+    auto outs = aContext.GetOutgoingIterators();
+    aContext.SetAdjacencyCost(ins.first, outs.first, 7);
+    aContext.SetAdjacencyCost(ins.first, outs.first + 1, 4);
+  }
+
+  CrossRoutingContextWriter bContext;
+  bContext.AddIngoingNode(11, {5., 5.});
+  // The border crossing point differs by a meter in the neighbouring mwms.
+  bContext.AddIngoingNode(10, {1.00001, 1.});
+  bContext.AddOutgoingNode(12, "aMap", {0., 0.00001});
+  bContext.ReserveAdjacencyMatrix();
+  {
+    auto ins = bContext.GetIngoingIterators();
+    auto outs = bContext.GetOutgoingIterators();
+    bContext.SetAdjacencyCost(ins.first, outs.first, 0);
+    bContext.SetAdjacencyCost(ins.first + 1, outs.first, 3);
+  }
+
+  vector<char> aBuffer, bBuffer;
+  CrossRoutingContextReader aReader, bReader;
+  SaveAndLoadContext(aContext, aBuffer, aReader);
+  SaveAndLoadContext(bContext, bBuffer, bReader);
+
+  CrossMwmOverlay builtOverlay;
+  builtOverlay.AddMwm("bMap", 20, bReader);
+  builtOverlay.AddMwm("aMap", 10, aReader);
+  builtOverlay.Link();
+
+  vector<char> buffer;
+  MemWriter<vector<char>> writer(buffer);
+  builtOverlay.Serialize(writer);
+  CrossMwmOverlay overlay;
+  MemReader reader(buffer.data(), buffer.size());
+  ReaderSource<MemReader> src(reader);
+  overlay.Deserialize(src);
+
+  TEST_EQUAL(overlay.GetMwmsCount(), 2, ());
+  uint32_t const aMwm = overlay.FindMwm("aMap");
+  uint32_t const bMwm = overlay.FindMwm("bMap");
+  TEST_NOT_EQUAL(aMwm, CrossMwmOverlay::kInvalidIndex, ());
+  TEST_NOT_EQUAL(bMwm, CrossMwmOverlay::kInvalidIndex, ());
+  TEST_EQUAL(overlay.FindMwm("cMap"), CrossMwmOverlay::kInvalidIndex, ());
+  TEST_EQUAL(overlay.GetTimestamp(aMwm), 10, ());
+  TEST_EQUAL(overlay.GetTimestamp(bMwm), 20, ());
+
+  uint32_t const a1 = overlay.FindVertex(aMwm, 1);
+  uint32_t const b10 = overlay.FindVertex(bMwm, 10);
+  uint32_t const b11 = overlay.FindVertex(bMwm, 11);
+  TEST_NOT_EQUAL(a1, CrossMwmOverlay::kInvalidIndex, ());
+  TEST_NOT_EQUAL(b10, CrossMwmOverlay::kInvalidIndex, ());
+  TEST_NOT_EQUAL(b11, CrossMwmOverlay::kInvalidIndex, ());
+  TEST_EQUAL(overlay.FindVertex(aMwm, 2), CrossMwmOverlay::kInvalidIndex, ());
+  TEST_EQUAL(overlay.FindVertex(aMwm, 10), CrossMwmOverlay::kInvalidIndex, ());
+  TEST_EQUAL(overlay.GetVertexMwm(a1), aMwm, ());
+  TEST_EQUAL(overlay.GetVertexMwm(b10), bMwm, ());
+  TEST_EQUAL(overlay.GetVertexNode(b10), 10, ());
+  TEST_LESS(overlay.GetVertexPoint(b10).Length(m2::PointD(1.00001, 1.)), 1e-6, ());
+
+  using TEdges = vector<pair<uint32_t, WritedEdgeWeightT>>;
+  auto const getEdges = [&overlay](uint32_t vertex)
+  {
+    TEdges edges;
+    overlay.ForEachEdge(vertex, [&edges](uint32_t outgoing, WritedEdgeWeightT weight)
+    {
+      edges.emplace_back(outgoing, weight);
+    });
+    return edges;
+  };
+
+  uint32_t const aToB = overlay.GetOutgoing(aMwm, 0);
+  uint32_t const aToC = overlay.GetOutgoing(aMwm, 1);
+  uint32_t const bToA = overlay.GetOutgoing(bMwm, 0);
+  TEST_EQUAL(getEdges(a1), TEdges({{aToB, 7}, {aToC, 4}}), ());
+  TEST_EQUAL(getEdges(b10), TEdges({{bToA, 3}}), ());
+  TEST_EQUAL(getEdges(b11), TEdges(), ("Edges of zero weight are skipped."));
+
+  TEST_EQUAL(overlay.GetOutgoingNode(aToB), 2, ());
+  TEST_EQUAL(overlay.GetOutgoingTarget(aToB), b10, ());
+  TEST_EQUAL(overlay.GetOutgoingTarget(aToC), CrossMwmOverlay::kInvalidIndex, ());
+  TEST_EQUAL(overlay.GetOutgoingNode(bToA), 12, ());
+  TEST_EQUAL(overlay.GetOutgoingTarget(bToA), a1, ());
+
+  vector<uint32_t> mwms;
+  TEST(overlay.FindMwmsPath(aMwm, bMwm, mwms), ());
+  TEST_EQUAL(mwms, vector<uint32_t>({aMwm, bMwm}), ());
+  TEST(overlay.FindMwmsPath(bMwm, aMwm, mwms), ());
+  TEST_EQUAL(mwms, vector<uint32_t>({bMwm, aMwm}), ());
+  TEST(overlay.FindMwmsPath(aMwm, aMwm, mwms), ());
+  TEST_EQUAL(mwms, vector<uint32_t>({aMwm}), ());
+}
+
+UNIT_TEST(TestCrossMwmOverlayMwmsPath)
+{
+  // Mwms are a chain a - b - c, the route from a to c passes b.
+  auto const makeContext = [](vector<pair<string, m2::PointD>> const & outgoing,
+                              vector<m2::PointD> const & ingoing, CrossRoutingContextWriter & context)
+  {
+    WritedNodeID node = 0;
+    for (m2::PointD const & point : ingoing)
+      context.AddIngoingNode(node++, point);
+    for (auto const & out : outgoing)
+      context.AddOutgoingNode(node++, out.first, out.second);
+    context.ReserveAdjacencyMatrix();
+    auto ins = context.GetIngoingIterators();
+    auto outs = context.GetOutgoingIterators();
+    for (auto in = ins.first; in != ins.second; ++in)
+    {
+      for (auto out = outs.first; out != outs.second; ++out)
+        context.SetAdjacencyCost(in, out, 5);
+    }
+  };
+
+  CrossRoutingContextWriter aContext, bContext, cContext;
+  makeContext({{"bMap", {1., 0.}}}, {}, aContext);
+  makeContext({{"cMap", {2., 0.}}}, {{1., 0.}}, bContext);
+  makeContext({}, {{2., 0.}}, cContext);
+
+  vector<char> aBuffer, bBuffer, cBuffer;
+  CrossRoutingContextReader aReader, bReader, cReader;
+  SaveAndLoadContext(aContext, aBuffer, aReader);
+  SaveAndLoadContext(bContext, bBuffer, bReader);
+  SaveAndLoadContext(cContext, cBuffer, cReader);
+
+  CrossMwmOverlay overlay;
+  overlay.AddMwm("aMap", 1, aReader);
+  overlay.AddMwm("bMap", 1, bReader);
+  overlay.AddMwm("cMap", 1, cReader);
+  overlay.Link();
+
+  uint32_t const aMwm = overlay.FindMwm("aMap");
+  uint32_t const bMwm = overlay.FindMwm("bMap");
+  uint32_t const cMwm = overlay.FindMwm("cMap");
+  vector<uint32_t> mwms;
+  TEST(overlay.FindMwmsPath(aMwm, cMwm, mwms), ());
+  TEST_EQUAL(mwms, vector<uint32_t>({aMwm, bMwm, cMwm}), ());
+  // There are no ways back from c.
+  TEST(!overlay.FindMwmsPath(cMwm, aMwm, mwms), ());
+  TEST(!overlay.FindMwmsPath(bMwm, aMwm, mwms), ());
+}
 }
@@ -116,4 +116,40 @@ UNIT_TEST(FollowedPolylineGetDistanceFromBeginM)
                                                           point);
   TEST_ALMOST_EQUAL_ULPS(distance, masterDistance, ());
 }
+
+UNIT_TEST(FollowedPolylineLongPolylineFollowingTest)
+{
+  // The polyline goes to the east and comes back along the same way 10 meters to the north.
+  vector<m2::PointD> points;
+  for (size_t i = 0; i <= 100; ++i)
+    points.emplace_back(i * 0.001, 0.0);
+  for (size_t i = 0; i <= 100; ++i)
+    points.emplace_back((100 - i) * 0.001, 0.0001);
+  FollowedPolyline polyline(points.begin(), points.end());
+
+  // Both ways are in the rect, the nearest segment ahead is taken.
+  polyline.UpdateProjection(MercatorBounds::RectByCenterXYAndSizeInMeters({0.0305, 0.0}, 100));
+  TEST_EQUAL(polyline.GetCurrentIter().m_ind, 30, ());
+  TEST_EQUAL(polyline.GetCurrentIter().m_pt, m2::PointD(0.0305, 0.0), ());
+
+  polyline.UpdateProjection(MercatorBounds::RectByCenterXYAndSizeInMeters({0.0991, 0.0}, 10));
+  TEST_EQUAL(polyline.GetCurrentIter().m_ind, 99, ());
+
+  // Segments behind the current position are skipped.
+  polyline.UpdateProjection(MercatorBounds::RectByCenterXYAndSizeInMeters({0.0305, 0.0}, 100));
+  TEST_EQUAL(polyline.GetCurrentIter().m_ind, 170, ());
+  TEST_EQUAL(polyline.GetCurrentIter().m_pt, m2::PointD(0.0305, 0.0001), ());
+
+  // Nothing is found far from the polyline.
+  auto const iter =
+      polyline.UpdateProjection(MercatorBounds::RectByCenterXYAndSizeInMeters({0.05, 0.01}, 10));
+  TEST(!iter.IsValid(), ());
+  TEST_EQUAL(polyline.GetCurrentIter().m_ind, 170, ());
+
+  // Copies follow the route independently.
+  FollowedPolyline copy = polyline;
+  copy.UpdateProjection(MercatorBounds::RectByCenterXYAndSizeInMeters({0.0005, 0.0001}, 10));
+  TEST_EQUAL(copy.GetCurrentIter().m_ind, 200, ());
+  TEST_EQUAL(polyline.GetCurrentIter().m_ind, 170, ());
+}
 }  // namespace routing_test
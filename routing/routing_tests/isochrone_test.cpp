@@ -0,0 +1,167 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/road_graph_builder.hpp"
+
+#include "routing/isochrone.hpp"
+#include "routing/router_delegate.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/map.hpp"
+
+using namespace routing;
+using namespace routing_test;
+
+namespace
+{
+double constexpr KMPH2MPS = 1000.0 / (60 * 60);
+
+double SignedArea(vector<m2::PointD> const & polygon)
+{
+  double area = 0.0;
+  for (size_t i = 0; i < polygon.size(); ++i)
+  {
+    m2::PointD const & p1 = polygon[i];
+    m2::PointD const & p2 = polygon[(i + 1) % polygon.size()];
+    area += p1.x * p2.y - p2.x * p1.y;
+  }
+  return 0.5 * area;
+}
+
+m2::PointD GetCellSize(double cellMeters)
+{
+  m2::RectD const rect =
+      MercatorBounds::RectByCenterXYAndSizeInMeters(m2::PointD(0, 0), 0.5 * cellMeters);
+  return m2::PointD(rect.SizeX(), rect.SizeY());
+}
+
+/// Reached points, which mark the cells of the grid of the cellMeters with the corner
+/// at (0, 0) by their centers.
+vector<ReachableEdge> MakeCells(vector<pair<int, int>> const & cells, double cellMeters,
+                                m2::PointD & cellSize)
+{
+  cellSize = GetCellSize(cellMeters);
+  // The first point is the origin of the grid.
+  vector<ReachableEdge> edges = {{Edge::MakeFake(m2::PointD(0, 0), m2::PointD(0, 0)), 1.0, 1.0}};
+  for (auto const & cell : cells)
+  {
+    Junction const center(
+        m2::PointD((cell.first + 0.5) * cellSize.x, (cell.second + 0.5) * cellSize.y));
+    edges.push_back({Edge::MakeFake(center, center), 1.0, 1.0});
+  }
+  return edges;
+}
+}  // namespace
+
+UNIT_TEST(IsochroneFinder_Smoke)
+{
+  // Roads 0 and 1 go from the origin, road 2 continues road 1 and it's slow.
+  RoadGraphMockSource graph;
+  double const speedKMPH = graph.GetMaxSpeedKMPH();
+  graph.AddRoad(IRoadGraph::RoadInfo(true /* bidirectional */, speedKMPH,
+                                     {m2::PointD(0, 0), m2::PointD(0.001, 0)}));
+  graph.AddRoad(IRoadGraph::RoadInfo(true /* bidirectional */, speedKMPH,
+                                     {m2::PointD(0, 0), m2::PointD(0, 0.001)}));
+  graph.AddRoad(IRoadGraph::RoadInfo(true /* bidirectional */, speedKMPH / 10,
+                                     {m2::PointD(0, 0.001), m2::PointD(0, 0.002)}));
+
+  double const segmentSeconds =
+      MercatorBounds::DistanceOnEarth(m2::PointD(0, 0), m2::PointD(0.001, 0)) /
+      (speedKMPH * KMPH2MPS);
+
+  RouterDelegate delegate;
+  IsochroneFinder finder;
+  vector<ReachableEdge> edges;
+  TEST_EQUAL(IRoutingAlgorithm::Result::OK,
+             finder.FindReachable(graph, m2::PointD(0, 0), 5 * segmentSeconds, delegate, edges), ());
+
+  // Arrival times at the ends of the edges which start from the junctions.
+  map<pair<m2::PointD, m2::PointD>, pair<double, double>> times;
+  for (auto const & e : edges)
+  {
+    times[make_pair(e.m_edge.GetStartJunction().GetPoint(), e.m_edge.GetEndJunction().GetPoint())] =
+        make_pair(e.m_startSeconds, e.m_endSeconds);
+  }
+  TEST_EQUAL(times.size(), 5, ());
+
+  auto const getTimes = [&](m2::PointD const & start, m2::PointD const & end)
+  {
+    auto const it = times.find(make_pair(start, end));
+    TEST(it != times.end(), (start, end));
+    return it->second;
+  };
+  TEST_ALMOST_EQUAL_ULPS(getTimes(m2::PointD(0, 0), m2::PointD(0.001, 0)).second, segmentSeconds, ());
+  TEST_ALMOST_EQUAL_ULPS(getTimes(m2::PointD(0.001, 0), m2::PointD(0, 0)).second,
+                         2 * segmentSeconds, ());
+  // The slow road is reached partially.
+  auto const slow = getTimes(m2::PointD(0, 0.001), m2::PointD(0, 0.002));
+  TEST(my::AlmostEqualAbs(slow.first, segmentSeconds, 1e-6), (slow.first, segmentSeconds));
+  TEST_GREATER(slow.second, 5 * segmentSeconds, ());
+
+  // Roads are kept for the next search, which finds the same edges.
+  TEST_EQUAL(finder.GetCachedJunctionsCount(), 3, ());
+  vector<ReachableEdge> again;
+  TEST_EQUAL(IRoutingAlgorithm::Result::OK,
+             finder.FindReachable(graph, m2::PointD(0, 0), 5 * segmentSeconds, delegate, again), ());
+  TEST_EQUAL(edges.size(), again.size(), ());
+
+  TEST_EQUAL(IRoutingAlgorithm::Result::NoPath,
+             finder.FindReachable(graph, m2::PointD(1, 1), 5 * segmentSeconds, delegate, edges), ());
+}
+
+UNIT_TEST(IsochronePolygons_Cells)
+{
+  m2::PointD cellSize;
+  vector<vector<m2::PointD>> polygons;
+
+  // Single cell of the origin.
+  BuildIsochronePolygons(MakeCells({}, 100.0, cellSize), 10.0, 100.0, polygons);
+  TEST_EQUAL(polygons.size(), 1, ());
+  TEST_EQUAL(polygons[0].size(), 4, ());
+  TEST(my::AlmostEqualAbs(SignedArea(polygons[0]), cellSize.x * cellSize.y, 1e-12), ());
+
+  // The cells touching by the corners are outlined apart.
+  BuildIsochronePolygons(MakeCells({{1, 1}}, 100.0, cellSize), 10.0, 100.0, polygons);
+  TEST_EQUAL(polygons.size(), 2, ());
+  for (auto const & polygon : polygons)
+    TEST_EQUAL(polygon.size(), 4, ());
+
+  // Ring of cells around the empty one has a hole.
+  BuildIsochronePolygons(
+      MakeCells({{1, 0}, {2, 0}, {0, 1}, {2, 1}, {0, 2}, {1, 2}, {2, 2}}, 100.0, cellSize), 10.0,
+      100.0, polygons);
+  TEST_EQUAL(polygons.size(), 2, ());
+  sort(polygons.begin(), polygons.end(),
+       [](vector<m2::PointD> const & lhs, vector<m2::PointD> const & rhs)
+       {
+         return SignedArea(lhs) > SignedArea(rhs);
+       });
+  TEST(my::AlmostEqualAbs(SignedArea(polygons[0]), 9 * cellSize.x * cellSize.y, 1e-12), ());
+  TEST(my::AlmostEqualAbs(SignedArea(polygons[1]), -cellSize.x * cellSize.y, 1e-12), ());
+
+  // Edges which start after the limit are not reached.
+  vector<ReachableEdge> edges = MakeCells({{5, 5}}, 100.0, cellSize);
+  edges.back().m_startSeconds = 20.0;
+  BuildIsochronePolygons(edges, 10.0, 100.0, polygons);
+  TEST_EQUAL(polygons.size(), 1, ());
+}
+
+UNIT_TEST(IsochronePolygons_PartialEdge)
+{
+  double const cellMeters = 100.0;
+  m2::PointD const cellSize = GetCellSize(cellMeters);
+
+  // The edge of ten cells is reached by 4.5 cells of it.
+  vector<ReachableEdge> edges = {
+      {Edge::MakeFake(m2::PointD(0.5 * cellSize.x, 0.5 * cellSize.y),
+                      m2::PointD(10.5 * cellSize.x, 0.5 * cellSize.y)),
+       0.0, 100.0}};
+  vector<vector<m2::PointD>> polygons;
+  BuildIsochronePolygons(edges, 45.0, cellMeters, polygons);
+  TEST_EQUAL(polygons.size(), 1, ());
+  TEST_EQUAL(polygons[0].size(), 4, ());
+  TEST(my::AlmostEqualAbs(SignedArea(polygons[0]), 5 * cellSize.x * cellSize.y, 1e-12), ());
+}
@@ -0,0 +1,183 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/road_graph_builder.hpp"
+
+#include "routing/landmarks.hpp"
+#include "routing/routing_algorithm.hpp"
+#include "routing/router_delegate.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/mercator.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "std/vector.hpp"
+
+using namespace routing;
+using namespace routing_test;
+
+namespace
+{
+class LandmarksRoadGraphMock : public RoadGraphMockSource
+{
+public:
+  void AddRoad(LandmarksTable::TRoad const & road)
+  {
+    IRoadGraph::RoadInfo ri;
+    ri.m_bidirectional = true;
+    ri.m_speedKMPH = GetMaxSpeedKMPH();
+    ri.m_points.assign(road.begin(), road.end());
+    RoadGraphMockSource::AddRoad(move(ri));
+  }
+
+  LandmarksTable & GetTable() { return m_table; }
+
+  // routing::IRoadGraph overrides:
+  LandmarksTable const * GetLandmarks(FeatureID const & /* featureId */) const override
+  {
+    return &m_table;
+  }
+
+private:
+  LandmarksTable m_table;
+};
+
+// Returns rows and columns of a size x size grid with unit step.
+vector<LandmarksTable::TRoad> MakeGrid(size_t size)
+{
+  vector<LandmarksTable::TRoad> roads;
+  for (size_t i = 0; i < size; ++i)
+  {
+    LandmarksTable::TRoad row, column;
+    for (size_t j = 0; j < size; ++j)
+    {
+      row.emplace_back(j, i);
+      column.emplace_back(i, j);
+    }
+    roads.push_back(row);
+    roads.push_back(column);
+  }
+  return roads;
+}
+
+double GetPathLength(vector<Junction> const & path)
+{
+  double length = 0.0;
+  for (size_t i = 1; i < path.size(); ++i)
+    length += MercatorBounds::DistanceOnEarth(path[i - 1].GetPoint(), path[i].GetPoint());
+  return length;
+}
+
+template <typename TAlgorithm>
+void TestLandmarksRoute(IRoadGraph const & graph, Junction const & startPos, Junction const & finalPos,
+                        bool expectFewerSettled)
+{
+  RouterDelegate delegate;
+
+  TAlgorithm plain(false /* useLandmarks */);
+  vector<Junction> plainPath;
+  TEST_EQUAL(IRoutingAlgorithm::Result::OK,
+             plain.CalculateRoute(graph, startPos, finalPos, delegate, plainPath), ());
+
+  TAlgorithm alt(true /* useLandmarks */);
+  vector<Junction> altPath;
+  TEST_EQUAL(IRoutingAlgorithm::Result::OK,
+             alt.CalculateRoute(graph, startPos, finalPos, delegate, altPath), ());
+
+  TEST(my::AlmostEqualAbs(GetPathLength(plainPath), GetPathLength(altPath), 1e-6), ());
+  TEST_EQUAL(startPos, altPath.front(), ());
+  TEST_EQUAL(finalPos, altPath.back(), ());
+  if (expectFewerSettled)
+  {
+    TEST_LESS(alt.GetSettledVerticesCount(), plain.GetSettledVerticesCount(), ());
+  }
+}
+}  // namespace
+
+UNIT_TEST(LandmarksTable_Line)
+{
+  LandmarksTable table;
+  table.Build({{m2::PointD(0, 0), m2::PointD(0, 1), m2::PointD(0, 3)}}, 2 /* landmarksCount */);
+
+  TEST_EQUAL(3, table.GetVerticesCount(), ());
+  TEST_EQUAL(2, table.GetLandmarksCount(), ());
+  TEST(table.GetDistances(m2::PointD(1, 1)) == nullptr, ());
+
+  double const length01 = LandmarksTable::GetEdgeLength(m2::PointD(0, 0), m2::PointD(0, 1));
+  double const length13 = LandmarksTable::GetEdgeLength(m2::PointD(0, 1), m2::PointD(0, 3));
+  uint32_t const * middle = table.GetDistances(m2::PointD(0, 1));
+  TEST(middle != nullptr, ());
+  // Landmarks are the ends of the line.
+  TEST_EQUAL(static_cast<uint32_t>(length01) + static_cast<uint32_t>(length13),
+             middle[0] + middle[1], ());
+}
+
+UNIT_TEST(LandmarksTable_Serialization)
+{
+  // The last road is a separate component, unreachable from the landmarks.
+  vector<LandmarksTable::TRoad> roads = MakeGrid(5);
+  roads.push_back({m2::PointD(10, 10), m2::PointD(11, 11)});
+
+  LandmarksTable table;
+  table.Build(roads, LandmarksTable::kDefaultLandmarksCount);
+
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  table.Serialize(writer);
+
+  LandmarksTable deserialized;
+  MemReader reader(buffer.data(), buffer.size());
+  ReaderSource<MemReader> src(reader);
+  deserialized.Deserialize(src);
+
+  TEST_EQUAL(table.GetVerticesCount(), deserialized.GetVerticesCount(), ());
+  TEST_EQUAL(table.GetLandmarksCount(), deserialized.GetLandmarksCount(), ());
+  for (auto const & road : roads)
+  {
+    for (auto const & point : road)
+    {
+      uint32_t const * expected = table.GetDistances(point);
+      uint32_t const * actual = deserialized.GetDistances(point);
+      TEST(expected != nullptr && actual != nullptr, ());
+      for (size_t i = 0; i < table.GetLandmarksCount(); ++i)
+        TEST_EQUAL(expected[i], actual[i], ());
+    }
+  }
+  TEST_EQUAL(LandmarksTable::kInfinity, deserialized.GetDistances(m2::PointD(10, 10))[0], ());
+}
+
+UNIT_TEST(LandmarksAStarRouter_Grid)
+{
+  classificator::Load();
+
+  LandmarksRoadGraphMock graph;
+  vector<LandmarksTable::TRoad> const roads = MakeGrid(15);
+  for (auto const & road : roads)
+    graph.AddRoad(road);
+  graph.GetTable().Build(roads, LandmarksTable::kDefaultLandmarksCount);
+
+  TestLandmarksRoute<AStarRoutingAlgorithm>(graph, m2::PointD(2, 3), m2::PointD(12, 11),
+                                            true /* expectFewerSettled */);
+  TestLandmarksRoute<AStarBidirectionalRoutingAlgorithm>(graph, m2::PointD(2, 3), m2::PointD(12, 11),
+                                                         true /* expectFewerSettled */);
+}
+
+UNIT_TEST(LandmarksAStarRouter_OutdatedTable)
+{
+  classificator::Load();
+
+  // The table doesn't know about the diagonal road, so its bounds are wrong
+  // and routers must fall back to plain AStar.
+  LandmarksRoadGraphMock graph;
+  vector<LandmarksTable::TRoad> const roads = MakeGrid(15);
+  graph.GetTable().Build(roads, LandmarksTable::kDefaultLandmarksCount);
+  for (auto const & road : roads)
+    graph.AddRoad(road);
+  graph.AddRoad({m2::PointD(0, 0), m2::PointD(14, 14)});
+
+  TestLandmarksRoute<AStarRoutingAlgorithm>(graph, m2::PointD(0, 0), m2::PointD(14, 14),
+                                            false /* expectFewerSettled */);
+  TestLandmarksRoute<AStarBidirectionalRoutingAlgorithm>(graph, m2::PointD(0, 0), m2::PointD(14, 14),
+                                                         false /* expectFewerSettled */);
+}
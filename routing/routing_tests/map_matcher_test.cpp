@@ -0,0 +1,154 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/road_graph_builder.hpp"
+
+#include "routing/map_matcher.hpp"
+#include "routing/nearest_edge_finder.hpp"
+
+using namespace routing;
+using namespace routing_test;
+
+namespace
+{
+/// Mock graph which finds the nearest edges over all its roads.
+class NearestRoadsGraph : public RoadGraphMockSource
+{
+public:
+  // routing::IRoadGraph overrides:
+  void FindClosestEdges(m2::PointD const & point, uint32_t count,
+                        vector<pair<Edge, m2::PointD>> & vicinities) const override
+  {
+    NearestEdgeFinder finder(point);
+    for (size_t i = 0; i < GetRoadCount(); ++i)
+    {
+      FeatureID const featureId = MakeTestFeatureID(i);
+      finder.AddInformationSource(featureId, GetRoadInfo(featureId));
+    }
+    finder.MakeResult(vicinities, count);
+  }
+};
+
+// Distances are about 111 meters per 0.001 near (0, 0).
+//
+//  1 o-------------------------------o
+//                                    | 2
+//  0 o-------------------------------o
+//    0                             0.005
+//
+// The roads 0 and 1 are 33 meters apart and are joined by the road 2 at their ends only.
+unique_ptr<IRoadGraph> MakeParallelRoadsGraph()
+{
+  unique_ptr<NearestRoadsGraph> graph(new NearestRoadsGraph());
+  graph->AddRoad(IRoadGraph::RoadInfo(
+      true /* bidirectional */, 5.0 /* speedKMPH */,
+      {m2::PointD(0, 0), m2::PointD(0.001, 0), m2::PointD(0.002, 0), m2::PointD(0.003, 0),
+       m2::PointD(0.004, 0), m2::PointD(0.005, 0)}));
+  graph->AddRoad(IRoadGraph::RoadInfo(
+      true /* bidirectional */, 5.0 /* speedKMPH */,
+      {m2::PointD(0, 0.0003), m2::PointD(0.001, 0.0003), m2::PointD(0.002, 0.0003),
+       m2::PointD(0.003, 0.0003), m2::PointD(0.004, 0.0003), m2::PointD(0.005, 0.0003)}));
+  graph->AddRoad(IRoadGraph::RoadInfo(true /* bidirectional */, 5.0 /* speedKMPH */,
+                                      {m2::PointD(0.005, 0), m2::PointD(0.005, 0.0003)}));
+  return graph;
+}
+}  // namespace
+
+UNIT_TEST(MapMatcher_KeepsRoadDespiteNoise)
+{
+  unique_ptr<IRoadGraph> const graph = MakeParallelRoadsGraph();
+  MapMatcher matcher(*graph, MapMatcher::Params());
+
+  // The third point is closer to the road 1, but the road 0 is reached without a detour.
+  vector<m2::PointD> const trace = {m2::PointD(0.0005, 0.00005), m2::PointD(0.0015, 0.00005),
+                                    m2::PointD(0.0025, 0.0002), m2::PointD(0.0035, 0.00005)};
+  vector<MatchedPoint> result;
+  matcher.Match(trace, result);
+
+  TEST_EQUAL(result.size(), trace.size(), ());
+  for (size_t i = 0; i < result.size(); ++i)
+  {
+    TEST(result[i].m_isMatched, (i));
+    TEST_EQUAL(result[i].m_edge.GetFeatureId(), MakeTestFeatureID(0), (i));
+    // The trace goes along the road.
+    TEST(result[i].m_edge.IsForward(), (i));
+    TEST_EQUAL(result[i].m_projection, m2::PointD(trace[i].x, 0), (i));
+  }
+
+  MapMatcher::Stats const & stats = matcher.GetStats();
+  TEST_EQUAL(stats.m_pointsCount, 4, ());
+  TEST_EQUAL(stats.m_matchedCount, 4, ());
+  TEST_EQUAL(stats.m_chainsCount, 1, ());
+}
+
+UNIT_TEST(MapMatcher_Backward)
+{
+  unique_ptr<IRoadGraph> const graph = MakeParallelRoadsGraph();
+  MapMatcher matcher(*graph, MapMatcher::Params());
+
+  vector<m2::PointD> const trace = {m2::PointD(0.0035, 0.00005), m2::PointD(0.0025, 0.00005),
+                                    m2::PointD(0.0015, 0.00005)};
+  vector<MatchedPoint> result;
+  matcher.Match(trace, result);
+
+  TEST_EQUAL(result.size(), trace.size(), ());
+  for (size_t i = 0; i < result.size(); ++i)
+  {
+    TEST(result[i].m_isMatched, (i));
+    TEST_EQUAL(result[i].m_edge.GetFeatureId(), MakeTestFeatureID(0), (i));
+    TEST(!result[i].m_edge.IsForward(), (i));
+  }
+}
+
+UNIT_TEST(MapMatcher_SplitsTrace)
+{
+  unique_ptr<IRoadGraph> const graph = MakeParallelRoadsGraph();
+  MapMatcher matcher(*graph, MapMatcher::Params());
+
+  // The second point is a kilometer away from the roads.
+  vector<m2::PointD> const trace = {m2::PointD(0.0005, 0.00005), m2::PointD(0.001, 0.01),
+                                    m2::PointD(0.0015, 0.00005), m2::PointD(0.0025, 0.00005)};
+  vector<MatchedPoint> result;
+  matcher.Match(trace, result);
+
+  TEST_EQUAL(result.size(), trace.size(), ());
+  TEST(result[0].m_isMatched, ());
+  TEST(!result[1].m_isMatched, ());
+  TEST(result[2].m_isMatched, ());
+  TEST(result[3].m_isMatched, ());
+
+  MapMatcher::Stats const & stats = matcher.GetStats();
+  TEST_EQUAL(stats.m_matchedCount, 3, ());
+  TEST_EQUAL(stats.m_chainsCount, 2, ());
+}
+
+UNIT_TEST(MapMatcher_MatchTraces)
+{
+  vector<vector<m2::PointD>> traces;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    double const y = 0.00001 * (i % 5);
+    traces.push_back({m2::PointD(0.0005, y), m2::PointD(0.0015, y), m2::PointD(0.0025, y)});
+  }
+
+  unique_ptr<IRoadGraph> const graph = MakeParallelRoadsGraph();
+  MapMatcher matcher(*graph, MapMatcher::Params());
+  vector<vector<MatchedPoint>> expected(traces.size());
+  for (size_t i = 0; i < traces.size(); ++i)
+    matcher.Match(traces[i], expected[i]);
+
+  vector<vector<MatchedPoint>> results;
+  MapMatcher::Stats const stats = MatchTraces(&MakeParallelRoadsGraph, MapMatcher::Params(),
+                                              traces, results, 4 /* threadsCount */);
+  TEST_EQUAL(stats.m_pointsCount, 60, ());
+  TEST_EQUAL(stats.m_matchedCount, 60, ());
+  TEST_EQUAL(results.size(), traces.size(), ());
+  for (size_t i = 0; i < traces.size(); ++i)
+  {
+    TEST_EQUAL(results[i].size(), expected[i].size(), ());
+    for (size_t j = 0; j < results[i].size(); ++j)
+    {
+      TEST_EQUAL(results[i][j].m_edge, expected[i][j].m_edge, (i, j));
+      TEST_EQUAL(results[i][j].m_projection, expected[i][j].m_projection, (i, j));
+    }
+  }
+}
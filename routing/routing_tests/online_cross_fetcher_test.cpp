@@ -58,4 +58,67 @@ UNIT_TEST(OnlineAbsentFetcherSingleMwmTest)
   TEST(countries.empty(), ());
 }
 
+UNIT_TEST(OnlineAbsentFetcherCacheTest)
+{
+  // Countries are the stripes of the unit width, none of them is downloaded.
+  auto const countryFileFn = [](m2::PointD const & p)
+  {
+    return string(1, static_cast<char>('A' + static_cast<int>(p.x)));
+  };
+  auto const localFileFn = [](string const &)
+  {
+    return nullptr;
+  };
+
+  OnlineAbsentCountriesFetcher fetcher(countryFileFn, localFileFn);
+  fetcher.CacheAnswer({0.5, 0.5}, {3.5, 0.5}, {{0.5, 0.5}, {2.5, 0.5}, {3.5, 0.5}});
+
+  // The route from the same cells takes the cached answer without a request.
+  vector<string> countries;
+  fetcher.GenerateRequest({0.51, 0.5}, {3.5, 0.51});
+  fetcher.GetAbsentCountries(countries);
+  TEST_EQUAL(countries, vector<string>({"A", "C", "D"}), ());
+  TEST_EQUAL(fetcher.GetRequestsInFlight(), 0, ());
+
+  // There's neither network nor estimate for the other cells.
+  countries.clear();
+  fetcher.GenerateRequest({0.5, 0.5}, {3.5, 0.9});
+  fetcher.GetAbsentCountries(countries);
+  TEST(countries.empty(), (countries));
+}
+
+UNIT_TEST(OnlineAbsentFetcherEstimateTest)
+{
+  auto const countryFileFn = [](m2::PointD const & p)
+  {
+    return string(1, static_cast<char>('A' + static_cast<int>(p.x)));
+  };
+  vector<pair<string, string>> estimates;
+  auto const estimateFn = [&estimates](string const & startCountry, string const & finalCountry,
+                                       vector<string> & countries)
+  {
+    estimates.emplace_back(startCountry, finalCountry);
+    countries = {startCountry, "X", finalCountry};
+    return true;
+  };
+
+  OnlineAbsentCountriesFetcher fetcher(countryFileFn, [](string const &)
+                                       {
+                                         return nullptr;
+                                       },
+                                       estimateFn);
+  vector<string> countries;
+  fetcher.GenerateRequest({0.5, 0.5}, {2.5, 0.5});
+  fetcher.GetAbsentCountries(countries);
+  TEST_EQUAL(countries, vector<string>({"A", "X", "C"}), ());
+  TEST_EQUAL(estimates, (vector<pair<string, string>>{{"A", "C"}}), ());
+
+  // The online answer wins over the estimate when it's cached.
+  fetcher.CacheAnswer({0.5, 0.5}, {2.5, 0.5}, {{0.5, 0.5}, {2.5, 0.5}});
+  countries.clear();
+  fetcher.GenerateRequest({0.5, 0.5}, {2.5, 0.5});
+  fetcher.GetAbsentCountries(countries);
+  TEST_EQUAL(countries, vector<string>({"A", "C"}), ());
+  TEST_EQUAL(estimates.size(), 1, ());
+}
 }
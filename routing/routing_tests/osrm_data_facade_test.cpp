@@ -0,0 +1,207 @@
+#include "testing/testing.hpp"
+
+#include "routing/osrm_data_facade.hpp"
+#include "routing/osrm_engine.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_name_utils.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/matrix_traversal.hpp"
+
+#include "base/bits.hpp"
+
+#include "std/cstring.hpp"
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+
+namespace
+{
+using TFacade = OsrmRawDataFacade<QueryEdge::EdgeData>;
+
+/// Freezes the succinct structure and reads it back to the buffer.
+template <typename T>
+void Freeze(T & value, vector<char> & buffer)
+{
+  string const path = my::JoinFoldersToPath(GetPlatform().TmpDir(), "osrm_facade_test.tmp");
+  succinct::mapper::freeze(value, path.c_str());
+  {
+    FileReader reader(path);
+    size_t const offset = buffer.size();
+    buffer.resize(offset + static_cast<size_t>(reader.Size()));
+    reader.Read(0, buffer.data() + offset, buffer.size() - offset);
+  }
+  TEST(my::DeleteFileX(path), ());
+}
+
+struct Edge
+{
+  uint32_t m_node;
+  uint32_t m_target;
+  uint32_t m_distance;
+  bool m_shortcut;
+  uint32_t m_id;
+  /// Bit 1 is the edge from m_node to m_target, bit 2 is the opposite one.
+  uint32_t m_directions;
+};
+
+/// Edges of the random graph, sorted by the nodes and the targets.
+vector<Edge> MakeRandomEdges(uint32_t nodesCount)
+{
+  mt19937 rng(0);
+  vector<Edge> edges;
+  for (uint32_t node = 0; node < nodesCount; ++node)
+  {
+    // Every tenth node has many edges, as the nodes of the high levels of the hierarchy.
+    uint32_t const step = (node % 10 == 0) ? 2 : 9;
+    for (uint32_t target = rng() % step; target < nodesCount; target += 1 + rng() % step)
+    {
+      bool const shortcut = rng() % 2 == 0;
+      uint32_t const id = rng() % nodesCount;
+      uint32_t const distance = 1 + rng() % 1000;
+      uint32_t const directions = static_cast<uint32_t>(1 + rng() % 3);
+      edges.push_back({node, target, distance, shortcut, id, directions});
+    }
+  }
+  return edges;
+}
+
+/// Raw sections of the graph in the format of the routing generator.
+class RawGraph
+{
+public:
+  RawGraph(uint32_t nodesCount, vector<Edge> const & edges)
+  {
+    vector<uint64_t> matrix;
+    vector<uint64_t> distances;
+    vector<bool> shortcuts;
+    vector<uint64_t> edgeIds;
+    for (Edge const & edge : edges)
+    {
+      for (bool const backward : {false, true})
+      {
+        if ((edge.m_directions & (backward ? 2 : 1)) == 0)
+          continue;
+        matrix.push_back(
+            TraverseMatrixInRowOrder<uint64_t>(nodesCount, edge.m_node, edge.m_target, backward));
+        distances.push_back(edge.m_distance);
+        shortcuts.push_back(edge.m_shortcut);
+        if (edge.m_shortcut)
+          edgeIds.push_back(bits::ZigZagEncode(int64_t(edge.m_node) - int64_t(edge.m_id)));
+      }
+    }
+
+    succinct::elias_fano_compressed_list distancesList(distances);
+    Freeze(distancesList, m_edgeData);
+    succinct::elias_fano_compressed_list edgeIdsList(edgeIds);
+    Freeze(edgeIdsList, m_edgeIds);
+    succinct::rs_bit_vector shortcutsVector(shortcuts);
+    Freeze(shortcutsVector, m_shortcuts);
+
+    succinct::elias_fano::elias_fano_builder builder(matrix.back(), matrix.size());
+    for (uint64_t const e : matrix)
+      builder.push_back(e);
+    succinct::elias_fano matrixVector(&builder);
+    m_matrix.resize(sizeof(nodesCount));
+    memcpy(m_matrix.data(), &nodesCount, sizeof(nodesCount));
+    Freeze(matrixVector, m_matrix);
+  }
+
+  void Load(TFacade & facade) const
+  {
+    facade.LoadRawData(m_edgeData.data(), m_edgeIds.data(), m_shortcuts.data(), m_matrix.data());
+  }
+
+private:
+  vector<char> m_edgeData, m_edgeIds, m_shortcuts, m_matrix;
+};
+
+void TestSameEdges(TFacade const & expected, TFacade const & actual)
+{
+  TEST_EQUAL(expected.GetNumberOfNodes(), actual.GetNumberOfNodes(), ());
+  for (NodeID node = 0; node < expected.GetNumberOfNodes(); ++node)
+  {
+    TEST_EQUAL(expected.BeginEdges(node), actual.BeginEdges(node), (node));
+    TEST_EQUAL(expected.EndEdges(node), actual.EndEdges(node), (node));
+    for (EdgeID e = expected.BeginEdges(node); e < expected.EndEdges(node); ++e)
+    {
+      TEST_EQUAL(expected.GetTarget(e), actual.GetTarget(e), (node, e));
+      QueryEdge::EdgeData const lhs = expected.GetEdgeData(e, node);
+      QueryEdge::EdgeData const rhs = actual.GetEdgeData(e, node);
+      TEST_EQUAL(lhs.distance, rhs.distance, (node, e));
+      TEST_EQUAL(lhs.id, rhs.id, (node, e));
+      TEST_EQUAL(lhs.shortcut, rhs.shortcut, (node, e));
+      TEST_EQUAL(lhs.forward, rhs.forward, (node, e));
+      TEST_EQUAL(lhs.backward, rhs.backward, (node, e));
+    }
+  }
+}
+}  // namespace
+
+UNIT_TEST(OsrmRawDataFacade_AdjacencyCache)
+{
+  uint32_t const kNodesCount = 200;
+  RawGraph const graph(kNodesCount, MakeRandomEdges(kNodesCount));
+
+  TFacade decoded;
+  graph.Load(decoded);
+  TFacade cached;
+  graph.Load(cached);
+
+  // Only the nodes with the most edges get to the small cache.
+  cached.BuildAdjacencyCache(16 * 1024);
+  TEST_GREATER(cached.GetCachedNodesCount(), 0, ());
+  TEST_LESS(cached.GetCachedNodesCount(), kNodesCount, ());
+  TestSameEdges(decoded, cached);
+
+  cached.BuildAdjacencyCache(16 * 1024 * 1024);
+  TEST_EQUAL(cached.GetCachedNodesCount(), kNodesCount, ());
+  TestSameEdges(decoded, cached);
+
+  cached.BuildAdjacencyCache(0);
+  TEST_EQUAL(cached.GetCachedNodesCount(), 0, ());
+  TestSameEdges(decoded, cached);
+}
+
+UNIT_TEST(FindSingleRoute_ParallelSearch)
+{
+  // The tree is a contraction hierarchy without shortcuts when the parents have the higher
+  // ranks: each node is contracted after its children, when its only neighbour is the parent.
+  uint32_t const kNodesCount = 300;
+  mt19937 rng(1);
+  vector<Edge> edges;
+  for (uint32_t node = 1; node < kNodesCount; ++node)
+    edges.push_back({node, static_cast<uint32_t>(rng() % node),
+                     static_cast<uint32_t>(1 + rng() % 1000), false, 0, 3});
+  RawGraph const graph(kNodesCount, edges);
+  TFacade facade;
+  graph.Load(facade);
+
+  for (size_t i = 0; i < 100; ++i)
+  {
+    FeatureGraphNode const source(rng() % kNodesCount, rng() % kNodesCount,
+                                  true /* isStartNode */, "Tree");
+    FeatureGraphNode const target(rng() % kNodesCount, rng() % kNodesCount,
+                                  false /* isStartNode */, "Tree");
+
+    RawRoutingResult sequential;
+    TEST(FindSingleRoute(source, target, facade, sequential, SingleRouteSearchMode::Sequential),
+         (i));
+    RawRoutingResult parallel;
+    TEST(FindSingleRoute(source, target, facade, parallel, SingleRouteSearchMode::Parallel), (i));
+
+    TEST_EQUAL(sequential.shortestPathLength, parallel.shortestPathLength, (i));
+    TEST_EQUAL(sequential.unpackedPathSegments.size(), parallel.unpackedPathSegments.size(), (i));
+    for (size_t j = 0; j < sequential.unpackedPathSegments.size(); ++j)
+    {
+      vector<RawPathData> const & lhs = sequential.unpackedPathSegments[j];
+      vector<RawPathData> const & rhs = parallel.unpackedPathSegments[j];
+      TEST_EQUAL(lhs.size(), rhs.size(), (i));
+      for (size_t k = 0; k < lhs.size(); ++k)
+        TEST_EQUAL(lhs[k].node, rhs[k].node, (i, k));
+    }
+  }
+}
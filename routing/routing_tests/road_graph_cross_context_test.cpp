@@ -0,0 +1,83 @@
+#include "testing/testing.hpp"
+
+#include "routing/road_graph_cross_context.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/writer.hpp"
+
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+
+namespace
+{
+m2::PointD Quantize(m2::PointD const & point)
+{
+  return PointU2PointD(PointD2PointU(point, POINT_COORD_BITS), POINT_COORD_BITS);
+}
+
+vector<pair<uint32_t, double>> GetWeights(RoadGraphCrossContext const & context, uint32_t border)
+{
+  vector<pair<uint32_t, double>> weights;
+  context.ForEachWeight(border, [&](uint32_t target, double seconds)
+  {
+    weights.emplace_back(target, seconds);
+  });
+  return weights;
+}
+
+vector<uint8_t> Serialize(vector<m2::PointD> const & borders,
+                          RoadGraphCrossContext::TWeights const & weights)
+{
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  RoadGraphCrossContext::Serialize(borders, weights, POINT_COORD_BITS, writer);
+  return buffer;
+}
+}  // namespace
+
+UNIT_TEST(RoadGraphCrossContext_Smoke)
+{
+  // Borders are renumbered by their points, (1, 0) becomes the last one.
+  vector<m2::PointD> const borders = {m2::PointD(1, 0), m2::PointD(0, 1), m2::PointD(0, 2)};
+  RoadGraphCrossContext::TWeights const weights = {
+      {{2, 12.34}, {1, 5.0}}, {{0, 5.0}}, {}};
+  vector<uint8_t> const buffer = Serialize(borders, weights);
+
+  RoadGraphCrossContext context;
+  TEST(context.Attach(reinterpret_cast<char const *>(buffer.data()), buffer.size()), ());
+  TEST(!context.IsEmpty(), ());
+  TEST_EQUAL(context.GetBordersCount(), 3, ());
+
+  uint32_t const b0 = context.FindBorder(m2::PointD(1, 0));
+  uint32_t const b1 = context.FindBorder(m2::PointD(0, 1));
+  uint32_t const b2 = context.FindBorder(m2::PointD(0, 2));
+  TEST_EQUAL(b0, 2, ());
+  TEST_EQUAL(b1, 0, ());
+  TEST_EQUAL(b2, 1, ());
+  TEST_EQUAL(context.GetPoint(b0), Quantize(m2::PointD(1, 0)), ());
+  TEST_EQUAL(context.FindBorder(m2::PointD(1, 5e-7)), b0, ());
+  TEST_EQUAL(context.FindBorder(m2::PointD(1, 1)), RoadGraphCrossContext::kInvalidBorder, ());
+
+  // Weights are kept in tenths of a second, and are sorted by the targets.
+  TEST_EQUAL(GetWeights(context, b0),
+             (vector<pair<uint32_t, double>>{{b1, 5.0}, {b2, 12.3}}), ());
+  TEST_EQUAL(GetWeights(context, b1), (vector<pair<uint32_t, double>>{{b0, 5.0}}), ());
+  TEST(GetWeights(context, b2).empty(), ());
+}
+
+UNIT_TEST(RoadGraphCrossContext_Malformed)
+{
+  vector<uint8_t> const empty = Serialize({}, {});
+  RoadGraphCrossContext context;
+  TEST(context.Attach(reinterpret_cast<char const *>(empty.data()), empty.size()), ());
+  TEST(context.IsEmpty(), ());
+  TEST_EQUAL(context.FindBorder(m2::PointD(0, 0)), RoadGraphCrossContext::kInvalidBorder, ());
+
+  vector<uint8_t> const buffer =
+      Serialize({m2::PointD(0, 0), m2::PointD(1, 1)}, {{{1, 1.0}}, {{0, 2.0}}});
+  TEST(!context.Attach(reinterpret_cast<char const *>(buffer.data()), buffer.size() - 8), ());
+  TEST(context.IsEmpty(), ());
+}
@@ -87,4 +87,57 @@ UNIT_TEST(RoadGraph_NearestEdges)
   TEST_EQUAL(expectedIngoing, actualIngoing, ());
 }
 
+UNIT_TEST(RoadGraph_CachesOutgoingEdges)
+{
+  class CountingGraph : public RoadGraphMockSource
+  {
+  public:
+    void ForEachFeatureClosestToCross(m2::PointD const & cross,
+                                      CrossEdgesLoader & edgesLoader) const override
+    {
+      ++m_lookups;
+      RoadGraphMockSource::ForEachFeatureClosestToCross(cross, edgesLoader);
+    }
+
+    mutable size_t m_lookups = 0;
+  };
+
+  //  o--------o--------o
+  // (0, 0)  (1, 0)  (2, 0)
+  CountingGraph graph;
+  graph.AddRoad(IRoadGraph::RoadInfo(true /* bidirectional */, 5.0 /* speedKMPH */,
+                                     {m2::PointD(0, 0), m2::PointD(1, 0), m2::PointD(2, 0)}));
+
+  Junction const middle(m2::PointD(1, 0));
+  IRoadGraph::TEdgeVector first;
+  graph.GetOutgoingEdges(middle, first);
+  TEST_EQUAL(first.size(), 2, ());
+  TEST_EQUAL(graph.m_lookups, 1, ());
+
+  // Revisits of the junction and its ingoing edges don't query the features again.
+  IRoadGraph::TEdgeVector second;
+  graph.GetOutgoingEdges(middle, second);
+  graph.GetIngoingEdges(middle, second);
+  TEST_EQUAL(graph.m_lookups, 1, ());
+  TEST_EQUAL(second.size(), 4, ());
+  TEST_EQUAL(IRoadGraph::TEdgeVector(second.begin(), second.begin() + 2), first, ());
+
+  // Fake edges replace the cached regular ones.
+  Junction const start(m2::PointD(1, 1));
+  vector<pair<Edge, m2::PointD>> const vicinity = {make_pair(first.front(), middle.GetPoint())};
+  graph.AddFakeEdges(start, vicinity);
+  IRoadGraph::TEdgeVector withFake;
+  graph.GetOutgoingEdges(middle, withFake);
+  TEST_EQUAL(withFake.size(), 3, ());
+  TEST(find(withFake.begin(), withFake.end(), Edge::MakeFake(middle, start)) != withFake.end(), ());
+
+  // The cache is dropped with the fakes when the next query starts.
+  graph.ResetFakes();
+  size_t const lookups = graph.m_lookups;
+  IRoadGraph::TEdgeVector afterReset;
+  graph.GetOutgoingEdges(middle, afterReset);
+  TEST_EQUAL(afterReset, first, ());
+  TEST_EQUAL(graph.m_lookups, lookups + 1, ());
+}
+
 }  // namespace routing_test
@@ -0,0 +1,106 @@
+#include "testing/testing.hpp"
+
+#include "routing/road_graph.hpp"
+#include "routing/road_graph_section.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/writer.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+
+namespace
+{
+m2::PointD Quantize(m2::PointD const & point)
+{
+  return PointU2PointD(PointD2PointU(point, POINT_COORD_BITS), POINT_COORD_BITS);
+}
+
+RoadGraphSection::TRoads MakeRoads()
+{
+  // Roads 2 and 5 cross road 3 at (1, 1), road 7 is a closed oneway road.
+  RoadGraphSection::TRoads roads;
+  roads.emplace_back(2, IRoadGraph::RoadInfo(true /* bidirectional */, 5.0 /* speedKMPH */,
+                                             {m2::PointD(0, 0), m2::PointD(1, 1), m2::PointD(2, 2)}));
+  roads.emplace_back(3, IRoadGraph::RoadInfo(true /* bidirectional */, 3.0 /* speedKMPH */,
+                                             {m2::PointD(1, 1), m2::PointD(1, 2)}));
+  roads.emplace_back(5, IRoadGraph::RoadInfo(true /* bidirectional */, 5.0 /* speedKMPH */,
+                                             {m2::PointD(1, 0), m2::PointD(1, 1)}));
+  roads.emplace_back(7, IRoadGraph::RoadInfo(false /* bidirectional */, 1.0 /* speedKMPH */,
+                                             {m2::PointD(2, 2), m2::PointD(3, 2), m2::PointD(2, 2)}));
+  return roads;
+}
+
+vector<uint32_t> GetRoadsAtPoint(RoadGraphSection const & section, m2::PointD const & point)
+{
+  vector<uint32_t> features;
+  section.ForEachRoadAtPoint(point, [&](uint32_t road)
+  {
+    features.push_back(section.GetFeatureId(road));
+  });
+  sort(features.begin(), features.end());
+  return features;
+}
+}  // namespace
+
+UNIT_TEST(RoadGraphSection_Smoke)
+{
+  RoadGraphSection::TRoads const roads = MakeRoads();
+
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  RoadGraphSection::Serialize(roads, POINT_COORD_BITS, writer);
+
+  RoadGraphSection section;
+  TEST(section.Attach(reinterpret_cast<char const *>(buffer.data()), buffer.size()), ());
+  TEST_EQUAL(roads.size(), section.GetRoadsCount(), ());
+  TEST_EQUAL(RoadGraphSection::kInvalidRoad, section.FindRoad(4), ());
+
+  for (auto const & road : roads)
+  {
+    uint32_t const index = section.FindRoad(road.first);
+    TEST_NOT_EQUAL(RoadGraphSection::kInvalidRoad, index, ());
+    TEST_EQUAL(road.first, section.GetFeatureId(index), ());
+
+    IRoadGraph::RoadInfo ri;
+    section.GetRoadInfo(index, ri);
+    TEST_EQUAL(road.second.m_speedKMPH, ri.m_speedKMPH, ());
+    TEST_EQUAL(road.second.m_speedKMPH, section.GetSpeedKMPH(index), ());
+    TEST_EQUAL(road.second.m_bidirectional, ri.m_bidirectional, ());
+    TEST_EQUAL(road.second.m_points.size(), ri.m_points.size(), ());
+    for (size_t i = 0; i < ri.m_points.size(); ++i)
+      TEST_EQUAL(Quantize(road.second.m_points[i]), ri.m_points[i], ());
+  }
+
+  TEST_EQUAL(vector<uint32_t>({2, 3, 5}), GetRoadsAtPoint(section, m2::PointD(1, 1)), ());
+  TEST_EQUAL(vector<uint32_t>({2, 7}), GetRoadsAtPoint(section, m2::PointD(2, 2)), ());
+  TEST_EQUAL(vector<uint32_t>({7}), GetRoadsAtPoint(section, m2::PointD(3, 2)), ());
+  TEST(GetRoadsAtPoint(section, m2::PointD(0.5, 0.5)).empty(), ());
+
+  // Points are equal with IRoadGraph's junction epsilon (1e-6).
+  TEST_EQUAL(vector<uint32_t>({2, 3, 5}), GetRoadsAtPoint(section, m2::PointD(1 + 5e-7, 1 - 5e-7)), ());
+  TEST(GetRoadsAtPoint(section, m2::PointD(1 + 5e-6, 1)).empty(), ());
+}
+
+UNIT_TEST(RoadGraphSection_Malformed)
+{
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  RoadGraphSection::Serialize(MakeRoads(), POINT_COORD_BITS, writer);
+
+  RoadGraphSection section;
+  TEST(!section.Attach(reinterpret_cast<char const *>(buffer.data()), buffer.size() - 8), ());
+  TEST(section.IsEmpty(), ());
+  TEST(!section.Attach(reinterpret_cast<char const *>(buffer.data()), 4), ());
+
+  RoadGraphSection::TRoads const empty;
+  vector<uint8_t> emptyBuffer;
+  MemWriter<vector<uint8_t>> emptyWriter(emptyBuffer);
+  RoadGraphSection::Serialize(empty, POINT_COORD_BITS, emptyWriter);
+  TEST(section.Attach(reinterpret_cast<char const *>(emptyBuffer.data()), emptyBuffer.size()), ());
+  TEST(section.IsEmpty(), ());
+  TEST(GetRoadsAtPoint(section, m2::PointD(1, 1)).empty(), ());
+}
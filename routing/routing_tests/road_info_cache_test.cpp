@@ -0,0 +1,91 @@
+#include "testing/testing.hpp"
+
+#include "routing/road_info_cache.hpp"
+
+#include "std/bind.hpp"
+#include "std/thread.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+
+namespace
+{
+RoadInfoCache::TRoadInfoPtr MakeRoad(double speedKMPH)
+{
+  return make_shared<IRoadGraph::RoadInfo>(true /* bidirectional */, speedKMPH,
+                                           initializer_list<m2::PointD>{m2::PointD(0, 0), m2::PointD(1, 1)});
+}
+
+void FindOrInsert(RoadInfoCache & cache, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    FeatureID const featureId(MwmSet::MwmId(), i % 100);
+    if (!cache.Find(featureId))
+      cache.Insert(featureId, MakeRoad(i % 100));
+  }
+}
+}  // namespace
+
+UNIT_TEST(RoadInfoCache_Smoke)
+{
+  RoadInfoCache cache;
+  FeatureID const featureId(MwmSet::MwmId(), 1);
+  TEST(!cache.Find(featureId), ());
+
+  cache.Insert(featureId, MakeRoad(5.0));
+  RoadInfoCache::TRoadInfoPtr const road = cache.Find(featureId);
+  TEST(road, ());
+  TEST_EQUAL(5.0, road->m_speedKMPH, ());
+
+  // Reinsertion replaces the road.
+  cache.Insert(featureId, MakeRoad(3.0));
+  TEST_EQUAL(3.0, cache.Find(featureId)->m_speedKMPH, ());
+
+  RoadInfoCache::Stats const stats = cache.GetStats();
+  TEST_EQUAL(2, stats.m_hits, ());
+  TEST_EQUAL(1, stats.m_misses, ());
+  TEST_EQUAL(0, stats.m_evictions, ());
+  TEST_EQUAL(1, stats.m_roadsCount, ());
+  TEST_EQUAL(RoadInfoCache::GetRoadInfoBytes(*road), stats.m_bytes, ());
+
+  cache.Clear();
+  TEST(!cache.Find(featureId), ());
+  TEST_EQUAL(0, cache.GetStats().m_bytes, ());
+}
+
+UNIT_TEST(RoadInfoCache_Limit)
+{
+  size_t const roadBytes = RoadInfoCache::GetRoadInfoBytes(*MakeRoad(5.0));
+  RoadInfoCache cache(100 * roadBytes);
+  for (uint32_t i = 0; i < 1000; ++i)
+    cache.Insert(FeatureID(MwmSet::MwmId(), i), MakeRoad(5.0));
+
+  RoadInfoCache::Stats stats = cache.GetStats();
+  TEST_LESS_OR_EQUAL(stats.m_bytes, cache.GetMaxBytes(), ());
+  TEST_EQUAL(1000, stats.m_roadsCount + stats.m_evictions, ());
+  // The most recently used road is kept.
+  TEST(cache.Find(FeatureID(MwmSet::MwmId(), 999)), ());
+  TEST(!cache.Find(FeatureID(MwmSet::MwmId(), 0)), ());
+
+  cache.SetMaxBytes(0);
+  stats = cache.GetStats();
+  TEST_EQUAL(0, stats.m_roadsCount, ());
+  TEST_EQUAL(0, stats.m_bytes, ());
+}
+
+UNIT_TEST(RoadInfoCache_Concurrency)
+{
+  RoadInfoCache cache;
+  vector<thread> threads;
+  for (size_t i = 0; i < 4; ++i)
+    threads.emplace_back(bind(&FindOrInsert, ref(cache), 10000));
+  for (auto & t : threads)
+    t.join();
+
+  RoadInfoCache::Stats const stats = cache.GetStats();
+  TEST_EQUAL(100, stats.m_roadsCount, ());
+  TEST_EQUAL(40000, stats.m_hits + stats.m_misses, ());
+  for (uint32_t i = 0; i < 100; ++i)
+    TEST_EQUAL(i, cache.Find(FeatureID(MwmSet::MwmId(), i))->m_speedKMPH, ());
+}
@@ -0,0 +1,202 @@
+#include "testing/testing.hpp"
+
+#include "routing/road_segments_index.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "geometry/distance.hpp"
+
+#include "coding/writer.hpp"
+
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+
+namespace
+{
+using TSegments = vector<RoadSegmentsIndex::Segment>;
+
+m2::PointD Quantize(m2::PointD const & point)
+{
+  return PointU2PointD(PointD2PointU(point, POINT_COORD_BITS), POINT_COORD_BITS);
+}
+
+/// Polylines of the random features, the segments of each feature have the forward
+/// and the reverse nodes.
+TSegments MakeRandomSegments(uint32_t featuresCount)
+{
+  mt19937 rng(0);
+  uniform_real_distribution<double> coord(0.0, 1.0);
+  uniform_real_distribution<double> step(-0.01, 0.01);
+  TSegments segments;
+  TOsrmNodeId nodeId = 0;
+  for (uint32_t fid = 0; fid < featuresCount; ++fid)
+  {
+    m2::PointD p(coord(rng), coord(rng));
+    uint32_t const pointsCount = 2 + rng() % 10;
+    for (uint32_t i = 0; i + 1 < pointsCount; ++i)
+    {
+      m2::PointD const next = p + m2::PointD(step(rng), step(rng));
+      segments.emplace_back(fid, i, p, next);
+      segments.back().m_forwardNodeId = nodeId++;
+      if (fid % 3 != 0)
+        segments.back().m_reverseNodeId = nodeId++;
+      p = next;
+    }
+  }
+  return segments;
+}
+
+/// The nearest segments of the features by the projections to all the quantized segments.
+vector<RoadSegmentsIndex::Projection> FindNearestBruteForce(TSegments const & segments,
+                                                            m2::PointD const & point,
+                                                            double maxDistance, size_t maxCount)
+{
+  vector<RoadSegmentsIndex::Projection> res;
+  for (RoadSegmentsIndex::Segment segment : segments)
+  {
+    segment.m_p1 = Quantize(segment.m_p1);
+    segment.m_p2 = Quantize(segment.m_p2);
+    m2::ProjectionToSection<m2::PointD> proj;
+    proj.SetBounds(segment.m_p1, segment.m_p2);
+
+    RoadSegmentsIndex::Projection projection;
+    projection.m_segment = segment;
+    projection.m_point = proj(point);
+    projection.m_squaredDistance = point.SquareLength(projection.m_point);
+    if (projection.m_squaredDistance > maxDistance * maxDistance)
+      continue;
+
+    auto it = find_if(res.begin(), res.end(), [&](RoadSegmentsIndex::Projection const & p)
+    {
+      return p.m_segment.m_seg.m_fid == segment.m_seg.m_fid;
+    });
+    if (it == res.end())
+      res.push_back(projection);
+    else if (projection.m_squaredDistance < it->m_squaredDistance)
+      *it = projection;
+  }
+  sort(res.begin(), res.end(), [](RoadSegmentsIndex::Projection const & lhs,
+                                  RoadSegmentsIndex::Projection const & rhs)
+  {
+    return lhs.m_squaredDistance < rhs.m_squaredDistance;
+  });
+  if (res.size() > maxCount)
+    res.resize(maxCount);
+  return res;
+}
+
+/// Segments of the same feature are equally near when the projection is their common point,
+/// so the found segments are compared to the source ones by their FtSegs.
+void TestSameProjections(TSegments const & segments,
+                         vector<RoadSegmentsIndex::Projection> const & expected,
+                         vector<RoadSegmentsIndex::Projection> const & actual)
+{
+  TEST_EQUAL(expected.size(), actual.size(), ());
+  for (size_t i = 0; i < expected.size(); ++i)
+  {
+    RoadSegmentsIndex::Segment const & segment = actual[i].m_segment;
+    TEST_EQUAL(expected[i].m_segment.m_seg.m_fid, segment.m_seg.m_fid, (i));
+    TEST(expected[i].m_point.EqualDxDy(actual[i].m_point, 1e-12), (i));
+    TEST(my::AlmostEqualAbs(expected[i].m_squaredDistance, actual[i].m_squaredDistance, 1e-15),
+         (i));
+
+    auto const it = find_if(segments.begin(), segments.end(),
+                            [&segment](RoadSegmentsIndex::Segment const & s)
+    {
+      return s.m_seg == segment.m_seg;
+    });
+    TEST(it != segments.end(), (i, segment.m_seg));
+    TEST_EQUAL(it->m_forwardNodeId, segment.m_forwardNodeId, (i));
+    TEST_EQUAL(it->m_reverseNodeId, segment.m_reverseNodeId, (i));
+    TEST_EQUAL(Quantize(it->m_p1), segment.m_p1, (i));
+    TEST_EQUAL(Quantize(it->m_p2), segment.m_p2, (i));
+  }
+}
+}  // namespace
+
+UNIT_TEST(RoadSegmentsIndex_Smoke)
+{
+  // Feature 1 is the nearest to (0, 0), feature 2 goes through the point.
+  TSegments segments;
+  segments.emplace_back(1, 0, m2::PointD(0, 1), m2::PointD(1, 1));
+  segments.emplace_back(1, 1, m2::PointD(1, 1), m2::PointD(1, -1));
+  segments.emplace_back(2, 0, m2::PointD(-5, 0), m2::PointD(-1, 0));
+  segments.emplace_back(2, 1, m2::PointD(-1, 0), m2::PointD(5, 0));
+  segments.emplace_back(3, 0, m2::PointD(3, 3), m2::PointD(4, 3));
+  segments[3].m_forwardNodeId = 7;
+
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  RoadSegmentsIndex::Serialize(segments, POINT_COORD_BITS, writer);
+
+  RoadSegmentsIndex index;
+  TEST(index.Attach(reinterpret_cast<char const *>(buffer.data()), buffer.size()), ());
+  TEST_EQUAL(index.GetSegmentsCount(), segments.size(), ());
+
+  vector<RoadSegmentsIndex::Projection> res;
+  index.FindNearest(m2::PointD(0.5, 0.1), 2.0 /* maxDistance */, 10 /* maxCount */, res);
+  TEST_EQUAL(res.size(), 2, ());
+  TEST_EQUAL(res[0].m_segment.m_seg.m_fid, 2, ());
+  TEST_EQUAL(res[0].m_segment.m_seg.m_pointStart, 1, ());
+  TEST_EQUAL(res[0].m_segment.m_seg.m_pointEnd, 2, ());
+  TEST_EQUAL(res[0].m_segment.m_forwardNodeId, 7, ());
+  TEST_EQUAL(res[0].m_segment.m_reverseNodeId, INVALID_NODE_ID, ());
+  TEST(res[0].m_point.EqualDxDy(m2::PointD(0.5, 0), 1e-6), (res[0].m_point));
+  // Only the nearest segment of feature 1 is found.
+  TEST_EQUAL(res[1].m_segment.m_seg.m_fid, 1, ());
+  TEST_EQUAL(res[1].m_segment.m_seg.m_pointStart, 1, ());
+
+  index.FindNearest(m2::PointD(0.5, 0.1), 2.0 /* maxDistance */, 1 /* maxCount */, res);
+  TEST_EQUAL(res.size(), 1, ());
+  TEST_EQUAL(res[0].m_segment.m_seg.m_fid, 2, ());
+
+  index.FindNearest(m2::PointD(10, 10), 2.0 /* maxDistance */, 10 /* maxCount */, res);
+  TEST(res.empty(), ());
+}
+
+UNIT_TEST(RoadSegmentsIndex_Empty)
+{
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  RoadSegmentsIndex::Serialize(TSegments(), POINT_COORD_BITS, writer);
+
+  RoadSegmentsIndex index;
+  TEST(index.Attach(reinterpret_cast<char const *>(buffer.data()), buffer.size()), ());
+  TEST(index.IsEmpty(), ());
+
+  vector<RoadSegmentsIndex::Projection> res;
+  index.FindNearest(m2::PointD(0, 0), 1.0 /* maxDistance */, 10 /* maxCount */, res);
+  TEST(res.empty(), ());
+
+  // Truncated data are rejected.
+  TEST(!index.Attach(reinterpret_cast<char const *>(buffer.data()), buffer.size() / 2), ());
+}
+
+UNIT_TEST(RoadSegmentsIndex_BruteForce)
+{
+  TSegments const segments = MakeRandomSegments(2000);
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  RoadSegmentsIndex::Serialize(segments, POINT_COORD_BITS, writer);
+
+  RoadSegmentsIndex index;
+  TEST(index.Attach(reinterpret_cast<char const *>(buffer.data()), buffer.size()), ());
+  TEST_EQUAL(index.GetSegmentsCount(), segments.size(), ());
+
+  mt19937 rng(1);
+  uniform_real_distribution<double> coord(-0.1, 1.1);
+  vector<RoadSegmentsIndex::Projection> res;
+  for (size_t i = 0; i < 200; ++i)
+  {
+    m2::PointD const point(coord(rng), coord(rng));
+    double const maxDistance = (i % 2 == 0) ? 0.05 : 1.0;
+    size_t const maxCount = 1 + i % 12;
+    index.FindNearest(point, maxDistance, maxCount, res);
+    TestSameProjections(segments, FindNearestBruteForce(segments, point, maxDistance, maxCount), res);
+  }
+}
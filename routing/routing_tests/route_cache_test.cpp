@@ -0,0 +1,159 @@
+#include "testing/testing.hpp"
+
+#include "routing/route_cache.hpp"
+
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "std/map.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+using platform::tests_support::ScopedFile;
+
+namespace
+{
+RouteCache::Key MakeKey(string const & mwm, uint64_t node)
+{
+  RouteCache::Key key;
+  key.m_mwms.emplace_back(mwm, 1);
+  key.m_nodes = {node, node + 1};
+  return key;
+}
+
+Route MakeRoute(size_t pointsCount)
+{
+  vector<m2::PointD> points;
+  for (size_t i = 0; i < pointsCount; ++i)
+    points.emplace_back(i * 0.001, 0.0);
+  return Route("vehicle", points);
+}
+
+class Versions
+{
+public:
+  RouteCache::TVersionFn GetFn() const
+  {
+    return [this](string const & mwm)
+    {
+      auto const it = m_versions.find(mwm);
+      return it == m_versions.end() ? RouteCache::kInvalidVersion : it->second;
+    };
+  }
+
+  map<string, int64_t> m_versions = {{"A", 1}, {"B", 1}};
+};
+}  // namespace
+
+UNIT_TEST(RouteCache_Smoke)
+{
+  Versions versions;
+  RouteCache cache;
+  Route route("vehicle");
+  TEST(!cache.Get(MakeKey("A", 1), versions.GetFn(), route), ());
+
+  cache.Put(MakeKey("A", 1), {{"A", 1}}, MakeRoute(10));
+  TEST_EQUAL(cache.GetSize(), 1, ());
+  TEST_EQUAL(cache.GetPointsCount(), 10, ());
+  TEST(cache.Get(MakeKey("A", 1), versions.GetFn(), route), ());
+  TEST_EQUAL(route.GetPoly().GetSize(), 10, ());
+  TEST(!cache.Get(MakeKey("A", 2), versions.GetFn(), route), ());
+  TEST(!cache.Get(MakeKey("B", 1), versions.GetFn(), route), ());
+
+  // Invalid routes aren't cached.
+  cache.Put(MakeKey("A", 2), {{"A", 1}}, Route("vehicle"));
+  TEST_EQUAL(cache.GetSize(), 1, ());
+}
+
+UNIT_TEST(RouteCache_Eviction)
+{
+  Versions versions;
+  RouteCache cache(25 /* maxPointsCount */);
+  Route route("vehicle");
+  cache.Put(MakeKey("A", 1), {{"A", 1}}, MakeRoute(10));
+  cache.Put(MakeKey("A", 2), {{"A", 1}}, MakeRoute(10));
+  TEST(cache.Get(MakeKey("A", 1), versions.GetFn(), route), ());
+
+  // The least recently used route is evicted.
+  cache.Put(MakeKey("A", 3), {{"A", 1}}, MakeRoute(10));
+  TEST_EQUAL(cache.GetSize(), 2, ());
+  TEST_EQUAL(cache.GetPointsCount(), 20, ());
+  TEST(cache.Get(MakeKey("A", 1), versions.GetFn(), route), ());
+  TEST(!cache.Get(MakeKey("A", 2), versions.GetFn(), route), ());
+  TEST(cache.Get(MakeKey("A", 3), versions.GetFn(), route), ());
+
+  // Routes longer than the bound aren't cached.
+  cache.Put(MakeKey("A", 4), {{"A", 1}}, MakeRoute(30));
+  TEST_EQUAL(cache.GetSize(), 2, ());
+
+  cache.SetMaxPointsCount(10);
+  TEST_EQUAL(cache.GetSize(), 1, ());
+  TEST(cache.Get(MakeKey("A", 3), versions.GetFn(), route), ());
+}
+
+UNIT_TEST(RouteCache_Invalidation)
+{
+  Versions versions;
+  RouteCache cache;
+  Route route("vehicle");
+  cache.Put(MakeKey("A", 1), {{"A", 1}}, MakeRoute(10));
+  cache.Put(MakeKey("A", 2), {{"A", 1}, {"B", 1}}, MakeRoute(10));
+  cache.Put(MakeKey("B", 3), {{"B", 1}}, MakeRoute(10));
+
+  // The route is dropped when an mwm it passes through is updated.
+  versions.m_versions["B"] = 2;
+  TEST(!cache.Get(MakeKey("A", 2), versions.GetFn(), route), ());
+  TEST_EQUAL(cache.GetSize(), 2, ());
+  TEST(cache.Get(MakeKey("A", 1), versions.GetFn(), route), ());
+
+  cache.Invalidate("A");
+  TEST_EQUAL(cache.GetSize(), 1, ());
+  TEST(!cache.Get(MakeKey("A", 1), versions.GetFn(), route), ());
+  TEST_EQUAL(cache.GetPointsCount(), 10, ());
+}
+
+UNIT_TEST(RouteCache_SaveLoad)
+{
+  ScopedFile file("route_cache_test.bin", "");
+
+  Route::TTurns turns;
+  turns::TurnItem turn(3, turns::TurnDirection::TurnRight);
+  turn.m_lanes.push_back(turns::SingleLaneInfo({turns::LaneWay::Through, turns::LaneWay::Right}));
+  turn.m_lanes.back().m_isRecommended = true;
+  turn.m_sourceName = "Source";
+  turn.m_targetName = "Target";
+  turns.push_back(turn);
+  turns.emplace_back(9, turns::TurnDirection::ReachedYourDestination);
+  Route::TTimes times = {{3, 10.5}, {9, 20.25}};
+
+  Route route = MakeRoute(10);
+  route.SetTurnInstructions(turns);
+  route.SetSectionTimes(times);
+  route.AddAbsentCountry("C");
+
+  {
+    RouteCache cache;
+    cache.Put(MakeKey("A", 1), {{"A", 1}}, route);
+    cache.Put(MakeKey("B", 2), {{"B", 1}}, MakeRoute(5));
+    cache.SaveToFile(file.GetFullPath());
+  }
+
+  Versions versions;
+  RouteCache cache;
+  TEST(cache.LoadFromFile(file.GetFullPath()), ());
+  TEST_EQUAL(cache.GetSize(), 2, ());
+  TEST_EQUAL(cache.GetPointsCount(), 15, ());
+
+  Route loaded("vehicle");
+  TEST(cache.Get(MakeKey("A", 1), versions.GetFn(), loaded), ());
+  TEST_EQUAL(loaded.GetRouterId(), "vehicle", ());
+  TEST_EQUAL(loaded.GetPoly().GetSize(), 10, ());
+  for (size_t i = 0; i < 10; ++i)
+    TEST_LESS(loaded.GetPoly().GetPoint(i).Length(route.GetPoly().GetPoint(i)), 1e-6, ());
+  TEST_EQUAL(loaded.GetTurns(), route.GetTurns(), ());
+  TEST_EQUAL(loaded.GetSectionTimes(), route.GetSectionTimes(), ());
+  TEST_EQUAL(loaded.GetAbsentCountries(), route.GetAbsentCountries(), ());
+  TEST(cache.Get(MakeKey("B", 2), versions.GetFn(), loaded), ());
+
+  TEST(!cache.LoadFromFile(file.GetFullPath() + ".absent"), ());
+  TEST_EQUAL(cache.GetSize(), 0, ());
+}
@@ -5,6 +5,8 @@
 
 #include "platform/location.hpp"
 
+#include "coding/writer.hpp"
+
 #include "geometry/point2d.hpp"
 
 #include "std/string.hpp"
@@ -107,3 +109,67 @@ UNIT_TEST(NextTurnTest)
   TEST_EQUAL(turn, kTestTurns[2], ());
   TEST_EQUAL(nextTurn, turns::TurnItem(), ());
 }
+
+UNIT_TEST(RouteCopyTest)
+{
+  Route route("TestRouter");
+  route.SetGeometry(kTestGeometry.begin(), kTestGeometry.end());
+  vector<turns::TurnItem> turns(kTestTurns);
+  route.SetTurnInstructions(turns);
+
+  // The copy shares the geometry and the turns, but it has its own position.
+  Route copy(route);
+  TEST_EQUAL(&copy.GetPoly(), &route.GetPoly(), ());
+  TEST_EQUAL(&copy.GetTurns(), &route.GetTurns(), ());
+
+  copy.MoveIterator(GetGps(1, 1.5));
+  double distance;
+  turns::TurnItem turn;
+  copy.GetCurrentTurn(distance, turn);
+  TEST_EQUAL(turn, kTestTurns[2], ());
+  route.GetCurrentTurn(distance, turn);
+  TEST_EQUAL(turn, kTestTurns[0], ());
+}
+
+UNIT_TEST(RouteSerializationTest)
+{
+  Route route("TestRouter");
+  route.SetGeometry(kTestGeometry.begin(), kTestGeometry.end());
+  vector<turns::TurnItem> turns(kTestTurns);
+  turns[0].m_sourceName = "Main street";
+  turns[0].m_targetName = "Second street";
+  turns[1].m_sourceName = "Second street";
+  turns[1].m_exitNum = 3;
+  turns[1].m_lanes = {{turns::LaneWay::Left}, {turns::LaneWay::Through, turns::LaneWay::Right}};
+  turns[1].m_lanes[1].m_isRecommended = true;
+  turns[2].m_keepAnyway = true;
+  route.SetTurnInstructions(turns);
+  Route::TTimes times = {{1, 10.5}, {2, 20.25}, {4, 30.125}};
+  route.SetSectionTimes(times);
+
+  vector<uint8_t> data;
+  {
+    MemWriter<vector<uint8_t>> writer(data);
+    route.Serialize(writer);
+  }
+
+  Route restored("");
+  TEST(restored.Deserialize(data), ());
+  TEST_EQUAL(restored.GetRouterId(), route.GetRouterId(), ());
+  TEST_EQUAL(restored.GetPoly().GetSize(), kTestGeometry.size(), ());
+  for (size_t i = 0; i < kTestGeometry.size(); ++i)
+    TEST(restored.GetPoly().GetPoint(i).EqualDxDy(kTestGeometry[i], 1e-6), (i));
+  TEST_EQUAL(restored.GetTurns(), route.GetTurns(), ());
+  TEST_EQUAL(restored.GetSectionTimes(), route.GetSectionTimes(), ());
+  TEST_EQUAL(restored.GetTotalTimeSec(), route.GetTotalTimeSec(), ());
+
+  // Malformed data leave the route unchanged.
+  for (size_t size : {size_t(0), size_t(1), data.size() / 2, data.size() - 1})
+  {
+    TEST(!restored.Deserialize(vector<uint8_t>(data.begin(), data.begin() + size)), (size));
+    TEST_EQUAL(restored.GetTurns(), route.GetTurns(), (size));
+  }
+  data.push_back(0);
+  TEST(!restored.Deserialize(data), ());
+  TEST_EQUAL(restored.GetPoly().GetSize(), kTestGeometry.size(), ());
+}
@@ -96,4 +96,61 @@ UNIT_TEST(IndexManagerLockManagementTest)
   manager.Clear();
   TEST_EQUAL(generator.GetNumRefs(), 0, ());
 }
+
+UNIT_TEST(IndexManagerReleaseUnusedTest)
+{
+  string const fileName("1TestCountry");
+  LocalFileGenerator generator(fileName);
+  RoutingIndexManager manager([&fileName](m2::PointD const & q) { return fileName; },
+                              &generator.GetMwmSet());
+  manager.SetResidentMappingsCount(0);
+  {
+    auto testMapping = manager.GetMappingByName(fileName);
+    TEST(testMapping->IsUpToDate(), ());
+    // Nothing is loaded when there are no resident mappings.
+    manager.Pin(testMapping);
+    TEST_EQUAL(generator.GetNumRefs(), 1, ());
+  }
+
+  // Mappings which are not resident are freed.
+  manager.ReleaseUnused();
+  TEST_EQUAL(generator.GetNumRefs(), 0, ());
+}
+
+UNIT_TEST(IndexManagerMemoryUsageTest)
+{
+  string const fileName("1TestCountry");
+  LocalFileGenerator generator(fileName);
+  RoutingIndexManager manager([&fileName](m2::PointD const & q) { return fileName; },
+                              &generator.GetMwmSet());
+  manager.SetResidentMappingsCount(0);
+  manager.SetMemoryBudget(1024);
+  TEST_EQUAL(manager.GetMemoryBudget(), 1024, ());
+
+  auto testMapping = manager.GetMappingByName(fileName);
+  TEST(testMapping->IsValid(), ());
+  manager.Pin(testMapping);
+  // Mappings whose facades are not loaded take no memory.
+  TEST_EQUAL(testMapping->GetFacadeLoadsCount(), 0, ());
+  TEST_EQUAL(testMapping->GetFacadeMemorySize(), 0, ());
+  TEST(manager.GetMemoryUsage().empty(), ());
+  TEST_EQUAL(manager.GetTotalMemoryUsage(), 0, ());
+}
+
+UNIT_TEST(LoadTimeHistogramTest)
+{
+  LoadTimeHistogram histogram;
+  histogram.Add(500000 /* 0.5 ms */);
+  histogram.Add(1000000 /* 1 ms */);
+  histogram.Add(3000000 /* 3 ms */);
+  histogram.Add(3999999 /* 3.99 ms */);
+  histogram.Add(1000000000000 /* 1000 s */);
+
+  TEST_EQUAL(histogram.GetLoadsCount(), 5, ());
+  TEST_EQUAL(histogram.GetTotalNs(), 1000008499999, ());
+  TEST_EQUAL(histogram.GetBucket(0), 1, ());
+  TEST_EQUAL(histogram.GetBucket(1), 1, ());
+  TEST_EQUAL(histogram.GetBucket(2), 2, ());
+  TEST_EQUAL(histogram.GetBucket(LoadTimeHistogram::kBucketsCount - 1), 1, ());
+}
 }  // namespace
@@ -25,16 +25,28 @@ SOURCES += \
   astar_progress_test.cpp \
   astar_router_test.cpp \
   async_router_test.cpp \
+  bicycle_model_test.cpp \
   cross_routing_tests.cpp \
   followed_polyline_test.cpp \
+  isochrone_test.cpp \
+  landmarks_test.cpp \
+  map_matcher_test.cpp \
   nearest_edge_finder_tests.cpp \
   online_cross_fetcher_test.cpp \
+  osrm_data_facade_test.cpp \
   osrm_router_test.cpp \
   road_graph_builder.cpp \
+  road_graph_cross_context_test.cpp \
   road_graph_nearest_edges_test.cpp \
+  road_graph_section_test.cpp \
+  road_info_cache_test.cpp \
+  road_segments_index_test.cpp \
+  route_cache_test.cpp \
   route_tests.cpp \
   routing_mapping_test.cpp \
+  traffic_info_test.cpp \
   turns_generator_test.cpp \
+  turns_info_test.cpp \
   turns_sound_test.cpp \
   turns_tts_text_tests.cpp \
   vehicle_model_test.cpp \
@@ -0,0 +1,145 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/road_graph_builder.hpp"
+
+#include "routing/road_graph.hpp"
+#include "routing/router_delegate.hpp"
+#include "routing/routing_algorithm.hpp"
+#include "routing/traffic_info.hpp"
+
+#include "coding/writer.hpp"
+
+#include "std/vector.hpp"
+
+using namespace routing;
+using namespace routing_test;
+
+namespace
+{
+using TSegment = TrafficInfo::RoadSegmentId;
+
+vector<uint8_t> Serialize(TrafficInfo::TSpeeds const & speeds)
+{
+  vector<uint8_t> data;
+  MemWriter<vector<uint8_t>> writer(data);
+  TrafficInfo::Serialize(speeds, writer);
+  return data;
+}
+}  // namespace
+
+UNIT_TEST(TrafficInfo_LoadAndUpdate)
+{
+  TrafficInfo info;
+  TEST(info.Load(Serialize({{TSegment(7, 2, true /* forward */), 50},
+                            {TSegment(1, 0, false /* forward */), 10},
+                            {TSegment(7, 2, false /* forward */), 100},
+                            {TSegment(9, 0, true /* forward */), TrafficInfo::kNoSpeed}})),
+       ());
+  TEST_EQUAL(info.GetSegmentsCount(), 3, ());
+  TEST_ALMOST_EQUAL_ULPS(info.GetSpeedFactor(TSegment(7, 2, true)), 0.5, ());
+  TEST_ALMOST_EQUAL_ULPS(info.GetSpeedFactor(TSegment(7, 2, false)), 1.0, ());
+  TEST_ALMOST_EQUAL_ULPS(info.GetSpeedFactor(TSegment(1, 0, false)), 0.1, ());
+  TEST_ALMOST_EQUAL_ULPS(info.GetSpeedFactor(TSegment(1, 0, true)), 1.0, ());
+  TEST_ALMOST_EQUAL_ULPS(info.GetSpeedFactor(TSegment(9, 0, true)), 1.0, ());
+
+  // The update changes segment (7, 2), removes segment (1, 0) and adds segment (3, 5).
+  TEST(info.Update(Serialize({{TSegment(7, 2, true), 20},
+                              {TSegment(1, 0, false), TrafficInfo::kNoSpeed},
+                              {TSegment(3, 5, true), 90}})),
+       ());
+  TEST_EQUAL(info.GetSegmentsCount(), 3, ());
+  TEST_ALMOST_EQUAL_ULPS(info.GetSpeedFactor(TSegment(7, 2, true)), 0.2, ());
+  TEST_ALMOST_EQUAL_ULPS(info.GetSpeedFactor(TSegment(7, 2, false)), 1.0, ());
+  TEST_ALMOST_EQUAL_ULPS(info.GetSpeedFactor(TSegment(1, 0, false)), 1.0, ());
+  TEST_ALMOST_EQUAL_ULPS(info.GetSpeedFactor(TSegment(3, 5, true)), 0.9, ());
+
+  // Malformed data leave the table unchanged.
+  vector<uint8_t> data = Serialize({{TSegment(7, 2, true), 40}, {TSegment(8, 0, true), 30}});
+  data.pop_back();
+  TEST(!info.Update(data), ());
+  data.push_back(TrafficInfo::kMaxSpeed + 1);
+  TEST(!info.Load(data), ());
+  TEST(!info.Load({}), ());
+  TEST_EQUAL(info.GetSegmentsCount(), 3, ());
+  TEST_ALMOST_EQUAL_ULPS(info.GetSpeedFactor(TSegment(7, 2, true)), 0.2, ());
+}
+
+UNIT_TEST(TrafficCache_Snapshots)
+{
+  MwmSet::MwmId const mwmId = MakeTestFeatureID(0).m_mwmId;
+  TrafficCache cache;
+  TEST(cache.GetSnapshot()->empty(), ());
+
+  TEST(cache.Update(mwmId, Serialize({{TSegment(0, 1, true), 50}})), ());
+  auto const first = cache.GetSnapshot();
+  TEST_ALMOST_EQUAL_ULPS(GetSpeedFactor(*first, MakeTestFeatureID(0), 1, true), 0.5, ());
+
+  // Snapshots which are taken by the routes aren't changed by the next downloads.
+  TEST(cache.Update(mwmId, Serialize({{TSegment(0, 1, true), 25}})), ());
+  TEST_ALMOST_EQUAL_ULPS(GetSpeedFactor(*first, MakeTestFeatureID(0), 1, true), 0.5, ());
+  TEST_ALMOST_EQUAL_ULPS(GetSpeedFactor(*cache.GetSnapshot(), MakeTestFeatureID(0), 1, true),
+                         0.25, ());
+
+  TEST(!cache.Set(mwmId, {}), ());
+  TEST(cache.Set(mwmId, Serialize({{TSegment(0, 2, true), 75}})), ());
+  TEST_ALMOST_EQUAL_ULPS(GetSpeedFactor(*cache.GetSnapshot(), MakeTestFeatureID(0), 1, true),
+                         1.0, ());
+  TEST_ALMOST_EQUAL_ULPS(GetSpeedFactor(*cache.GetSnapshot(), MakeTestFeatureID(0), 2, true),
+                         0.75, ());
+
+  cache.Remove(mwmId);
+  TEST(cache.GetSnapshot()->empty(), ());
+  TEST_ALMOST_EQUAL_ULPS(GetSpeedFactor(*first, MakeTestFeatureID(0), 1, true), 0.5, ());
+}
+
+UNIT_TEST(TrafficInfo_RoadGraphRoute)
+{
+  // Road 0 is the direct one, road 1 is the detour which is twice as long.
+  RoadGraphMockSource graph;
+  double const speedKMPH = graph.GetMaxSpeedKMPH();
+  graph.AddRoad(IRoadGraph::RoadInfo(true /* bidirectional */, speedKMPH,
+                                     {m2::PointD(0, 0), m2::PointD(5, 0), m2::PointD(10, 0)}));
+  graph.AddRoad(IRoadGraph::RoadInfo(true /* bidirectional */, speedKMPH,
+                                     {m2::PointD(0, 0), m2::PointD(0, 5), m2::PointD(10, 5),
+                                      m2::PointD(10, 0)}));
+
+  Junction const start(m2::PointD(0, 0));
+  Junction const finish(m2::PointD(10, 0));
+  vector<Junction> const direct = {start, m2::PointD(5, 0), finish};
+  vector<Junction> const detour = {start, m2::PointD(0, 5), m2::PointD(10, 5), finish};
+
+  RouterDelegate delegate;
+  AStarRoutingAlgorithm algorithm;
+  vector<Junction> path;
+  TEST_EQUAL(IRoutingAlgorithm::Result::OK,
+             algorithm.CalculateRoute(graph, start, finish, delegate, path), ());
+  TEST_EQUAL(path, direct, ());
+
+  // The traffic jam on the direct road in the direction of the route only.
+  TrafficCache cache;
+  TEST(cache.Set(MakeTestFeatureID(0).m_mwmId,
+                 Serialize({{TSegment(0, 1, true /* forward */), 10}})),
+       ());
+  graph.SetTraffic(cache.GetSnapshot());
+
+  IRoadGraph const & roadGraph = graph;
+  IRoadGraph::TEdgeVector edges;
+  roadGraph.GetOutgoingEdges(Junction(m2::PointD(5, 0)), edges);
+  for (Edge const & edge : edges)
+  {
+    double const expected = (edge.GetSegId() == 1 && edge.IsForward()) ? speedKMPH / 10 : speedKMPH;
+    TEST_ALMOST_EQUAL_ULPS(roadGraph.GetSpeedKMPH(edge), expected, (edge));
+  }
+
+  TEST_EQUAL(IRoutingAlgorithm::Result::OK,
+             algorithm.CalculateRoute(graph, start, finish, delegate, path), ());
+  TEST_EQUAL(path, detour, ());
+  TEST_EQUAL(IRoutingAlgorithm::Result::OK,
+             algorithm.CalculateRoute(graph, finish, start, delegate, path), ());
+  TEST_EQUAL(path, vector<Junction>(direct.rbegin(), direct.rend()), ());
+
+  graph.SetTraffic(nullptr);
+  TEST_EQUAL(IRoutingAlgorithm::Result::OK,
+             algorithm.CalculateRoute(graph, start, finish, delegate, path), ());
+  TEST_EQUAL(path, direct, ());
+}
@@ -0,0 +1,115 @@
+#include "testing/testing.hpp"
+
+#include "routing/turns_info.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/writer.hpp"
+
+#include "base/string_utils.hpp"
+
+#include "std/vector.hpp"
+
+using namespace routing;
+using namespace routing::turns;
+
+namespace
+{
+m2::PointD Quantize(m2::PointD const & point)
+{
+  return PointU2PointD(PointD2PointU(point, POINT_COORD_BITS), POINT_COORD_BITS);
+}
+
+EdgeTurnInfo MakeEdge(ftypes::HighwayClass highwayClass, bool isRoundabout, bool isLink,
+                      string const & name)
+{
+  EdgeTurnInfo edge;
+  edge.m_highwayClass = highwayClass;
+  edge.m_isRoundabout = isRoundabout;
+  edge.m_isLink = isLink;
+  edge.m_name = name;
+  return edge;
+}
+
+/// Infos of the nodes, the points are quantized as the ones of the section.
+vector<NodeTurnInfo> MakeInfos(size_t count)
+{
+  vector<NodeTurnInfo> infos(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    NodeTurnInfo & info = infos[i];
+    // Every fifth node has no last segment and every seventh node has no first one.
+    info.m_hasFirst = i % 7 != 3;
+    info.m_hasLast = i % 5 != 2;
+    double const x = 0.001 * i;
+    if (info.m_hasFirst)
+    {
+      info.m_first = MakeEdge(ftypes::HighwayClass::Primary, i % 2 == 0 /* isRoundabout */,
+                              false /* isLink */, "Street " + strings::to_string(i % 4));
+      info.m_outgoingPoint = Quantize(m2::PointD(x + 0.0003, 0.5));
+    }
+    if (info.m_hasLast)
+    {
+      info.m_last = MakeEdge(ftypes::HighwayClass::Service, false /* isRoundabout */,
+                             i % 3 == 0 /* isLink */, i % 6 == 0 ? "" : "Avenue");
+      info.m_junctionPoint = Quantize(m2::PointD(x, 0.5));
+      info.m_ingoingPoint = Quantize(m2::PointD(x - 0.0003, 0.4999));
+      info.m_ingoingPointOneSegment = Quantize(m2::PointD(x - 0.0001, 0.4999));
+      info.m_notSoClosePoint = Quantize(m2::PointD(x - 0.0002, 0.5001));
+      info.m_junctionSegmentsCount = static_cast<uint32_t>(2 + i % 4);
+      for (size_t j = 0; j < i % 4; ++j)
+        info.m_possibleTurns.push_back(static_cast<TOsrmNodeId>((i + 3 * j + 1) % count));
+      if (i % 4 == 1)
+        info.m_lanes = {{LaneWay::Left, LaneWay::Through}, {LaneWay::Right}};
+    }
+  }
+  return infos;
+}
+
+vector<uint8_t> Serialize(vector<NodeTurnInfo> const & infos)
+{
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  TurnsInfoSection::Serialize(infos, writer);
+  return buffer;
+}
+}  // namespace
+
+UNIT_TEST(TurnsInfoSection_Smoke)
+{
+  vector<NodeTurnInfo> const infos = MakeInfos(100);
+  vector<uint8_t> const buffer = Serialize(infos);
+
+  TurnsInfoSection section;
+  TEST(section.Attach(reinterpret_cast<char const *>(buffer.data()), buffer.size()), ());
+  TEST_EQUAL(section.GetNodesCount(), infos.size(), ());
+
+  NodeTurnInfo info;
+  for (size_t i = 0; i < infos.size(); ++i)
+  {
+    TOsrmNodeId const node = static_cast<TOsrmNodeId>(i);
+    TEST(section.GetInfo(node, info), (i));
+    TEST_EQUAL(info, infos[i], (i));
+    TEST_EQUAL(section.GetOutgoingHighwayClass(node), infos[i].m_hasFirst
+                                                          ? ftypes::HighwayClass::Primary
+                                                          : ftypes::HighwayClass::Error,
+               (i));
+  }
+
+  TEST(!section.GetInfo(static_cast<TOsrmNodeId>(infos.size()), info), ());
+  TEST_EQUAL(section.GetOutgoingHighwayClass(INVALID_NODE_ID), ftypes::HighwayClass::Error, ());
+}
+
+UNIT_TEST(TurnsInfoSection_Malformed)
+{
+  vector<uint8_t> const empty = Serialize({});
+  TurnsInfoSection section;
+  TEST(section.Attach(reinterpret_cast<char const *>(empty.data()), empty.size()), ());
+  TEST(section.IsEmpty(), ());
+  NodeTurnInfo info;
+  TEST(!section.GetInfo(0, info), ());
+
+  vector<uint8_t> const buffer = Serialize(MakeInfos(40));
+  TEST(!section.Attach(reinterpret_cast<char const *>(buffer.data()), buffer.size() / 2), ());
+  TEST(section.IsEmpty(), ());
+}
@@ -96,6 +96,13 @@ UNIT_TEST(GetTtsTextTest)
   TEST_EQUAL(getTtsText(notifiation2), "Через 300 метров. Поворот налево.", ());
   TEST_EQUAL(getTtsText(notifiation3), "Вы достигли конца маршрута.", ());
   TEST_EQUAL(getTtsText(notifiation4), "Затем. Поворот налево.", ());
+
+  // Texts are cached per locale, so the repeated notifications and the locale switch
+  // give the same results.
+  TEST_EQUAL(getTtsText(notifiation1), "Через 500 метров. Поворот направо.", ());
+  getTtsText.ForTestingSetLocaleWithJson(engShortJson);
+  TEST_EQUAL(getTtsText(notifiation1), "In 500 meters. Make a right turn.", ());
+  TEST_EQUAL(getTtsText(notifiation4), "Then. Make a left turn.", ());
 }
 
 UNIT_TEST(GetAllSoundedDistMetersTest)
@@ -0,0 +1,138 @@
+#include "routing/section_road_graph.hpp"
+
+#include "indexer/index.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "coding/file_container.hpp"
+
+#include "base/logging.hpp"
+
+namespace routing
+{
+SectionRoadGraph::SectionRoadGraph(Index & index,
+                                   unique_ptr<IVehicleModelFactory> && vehicleModelFactory,
+                                   string const & sectionTag,
+                                   shared_ptr<RoadInfoCache> const & cache)
+  : FeaturesRoadGraph(index, move(vehicleModelFactory), cache), m_sectionTag(sectionTag)
+{
+}
+
+IRoadGraph::RoadInfo SectionRoadGraph::GetRoadInfo(FeatureID const & featureId) const
+{
+  RoadGraphSection const * section = GetSection(featureId.m_mwmId);
+  uint32_t const road = section ? section->FindRoad(featureId.m_index) : RoadGraphSection::kInvalidRoad;
+  if (road == RoadGraphSection::kInvalidRoad)
+    return FeaturesRoadGraph::GetRoadInfo(featureId);
+
+  RoadInfo ri;
+  section->GetRoadInfo(road, ri);
+  return ri;
+}
+
+double SectionRoadGraph::GetSpeedKMPH(FeatureID const & featureId) const
+{
+  RoadGraphSection const * section = GetSection(featureId.m_mwmId);
+  uint32_t const road = section ? section->FindRoad(featureId.m_index) : RoadGraphSection::kInvalidRoad;
+  if (road == RoadGraphSection::kInvalidRoad)
+    return FeaturesRoadGraph::GetSpeedKMPH(featureId);
+  return section->GetSpeedKMPH(road);
+}
+
+void SectionRoadGraph::ForEachFeatureClosestToCross(m2::PointD const & cross,
+                                                    CrossEdgesLoader & edgesLoader) const
+{
+  if (m_mwms.empty())
+    UpdateMwms();
+
+  m2::RectD rect(cross, cross);
+  rect.Inflate(kPointsEqualEpsilon, kPointsEqualEpsilon);
+
+  RoadInfo ri;
+  for (MwmBounds const & mwm : m_mwms)
+  {
+    if (!mwm.m_limitRect.IsIntersect(rect))
+      continue;
+
+    RoadGraphSection const * section = GetSection(mwm.m_mwmId);
+    if (section == nullptr)
+    {
+      FeaturesRoadGraph::ForEachFeatureClosestToCross(cross, mwm.m_mwmId, edgesLoader);
+      continue;
+    }
+
+    section->ForEachRoadAtPoint(cross, [&](uint32_t road)
+    {
+      section->GetRoadInfo(road, ri);
+      edgesLoader(FeatureID(mwm.m_mwmId, section->GetFeatureId(road)), ri);
+    });
+  }
+}
+
+void SectionRoadGraph::FindClosestEdges(m2::PointD const & point, uint32_t count,
+                                        vector<pair<Edge, m2::PointD>> & vicinities) const
+{
+  UpdateMwms();
+  FeaturesRoadGraph::FindClosestEdges(point, count, vicinities);
+}
+
+void SectionRoadGraph::ClearState()
+{
+  FeaturesRoadGraph::ClearState();
+  m_mwms.clear();
+}
+
+RoadGraphSection const * SectionRoadGraph::GetSection(MwmSet::MwmId const & mwmId) const
+{
+  auto it = m_sections.find(mwmId);
+  if (it != m_sections.end())
+    return it->second.get();
+
+  unique_ptr<RoadGraphSection> section;
+  shared_ptr<MwmInfo> const & info = mwmId.GetInfo();
+  if (info && info->GetType() == MwmInfo::COUNTRY)
+  {
+    try
+    {
+      FilesMappingContainer const cont(info->GetLocalFile().GetPath(MapOptions::Map));
+      section.reset(new RoadGraphSection());
+      if (section->Map(cont, m_sectionTag))
+        LOG(LINFO, ("Mapped road graph for", mwmId, "roads:", section->GetRoadsCount()));
+      else
+        section.reset();
+    }
+    catch (Reader::Exception const & e)
+    {
+      LOG(LERROR, ("Can't map road graph for", mwmId, e.Msg()));
+      section.reset();
+    }
+  }
+
+  return m_sections.emplace(mwmId, move(section)).first->second.get();
+}
+
+void SectionRoadGraph::UpdateMwms() const
+{
+  // Drops sections of deregistered mwms.
+  for (auto i = m_sections.begin(); i != m_sections.end();)
+  {
+    if (i->first.IsAlive())
+      ++i;
+    else
+      i = m_sections.erase(i);
+  }
+
+  vector<shared_ptr<MwmInfo>> infos;
+  GetIndex().GetMwmsInfo(infos);
+
+  m_mwms.clear();
+  for (shared_ptr<MwmInfo> const & info : infos)
+  {
+    MwmSet::MwmId const mwmId(info);
+    if (info->GetType() != MwmInfo::COUNTRY || !mwmId.IsAlive())
+      continue;
+    m_mwms.push_back({mwmId, info->m_limitRect});
+  }
+}
+
+}  // namespace routing
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "routing/features_road_graph.hpp"
+#include "routing/road_graph_section.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include "std/map.hpp"
+#include "std/string.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+namespace routing
+{
+
+/// SectionRoadGraph loads roads and outgoing edges of junctions from road graph sections
+/// of mwms (see RoadGraphSection) instead of spatial queries and feature decoding.
+/// Mwms without the section are handled as by FeaturesRoadGraph.
+class SectionRoadGraph : public FeaturesRoadGraph
+{
+public:
+  SectionRoadGraph(Index & index, unique_ptr<IVehicleModelFactory> && vehicleModelFactory,
+                   string const & sectionTag, shared_ptr<RoadInfoCache> const & cache = nullptr);
+
+  // IRoadGraph overrides:
+  RoadInfo GetRoadInfo(FeatureID const & featureId) const override;
+  double GetSpeedKMPH(FeatureID const & featureId) const override;
+  void ForEachFeatureClosestToCross(m2::PointD const & cross,
+                                    CrossEdgesLoader & edgesLoader) const override;
+  void FindClosestEdges(m2::PointD const & point, uint32_t count,
+                        vector<pair<Edge, m2::PointD>> & vicinities) const override;
+  void ClearState() override;
+
+private:
+  struct MwmBounds
+  {
+    MwmSet::MwmId m_mwmId;
+    m2::RectD m_limitRect;
+  };
+
+  RoadGraphSection const * GetSection(MwmSet::MwmId const & mwmId) const;
+
+  /// Takes the country mwms which are registered now.
+  void UpdateMwms() const;
+
+  string const m_sectionTag;
+
+  // Sections are not unmapped by ClearState() because they are immutable.
+  // nullptr means an mwm has no section.
+  mutable map<MwmSet::MwmId, unique_ptr<RoadGraphSection>> m_sections;
+
+  // Country mwms, which are looked up for junctions. They are updated
+  // by FindClosestEdges() as it's called at the beginning of every route.
+  mutable vector<MwmBounds> m_mwms;
+};
+
+}  // namespace routing
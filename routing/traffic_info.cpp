@@ -0,0 +1,242 @@
+#include "routing/traffic_info.hpp"
+
+#include "coding/varint.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/macros.hpp"
+
+#include "std/algorithm.hpp"
+
+namespace routing
+{
+// static
+uint32_t constexpr TrafficInfo::kVersion;
+// static
+uint8_t constexpr TrafficInfo::kNoSpeed;
+// static
+uint8_t constexpr TrafficInfo::kMaxSpeed;
+
+// static
+void TrafficInfo::Serialize(TSpeeds const & speeds, Writer & writer)
+{
+  vector<pair<uint64_t, uint8_t>> entries;
+  entries.reserve(speeds.size());
+  for (auto const & speed : speeds)
+  {
+    ASSERT_LESS_OR_EQUAL(speed.second, kMaxSpeed, ());
+    entries.emplace_back(speed.first.GetKey(), speed.second);
+  }
+  sort(entries.begin(), entries.end());
+
+  WriteVarUint(writer, kVersion);
+  WriteVarUint(writer, static_cast<uint32_t>(entries.size()));
+  uint64_t prev = 0;
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    ASSERT(i == 0 || entries[i - 1].first < entries[i].first, ("Segments must be unique."));
+    WriteVarUint(writer, entries[i].first - prev);
+    prev = entries[i].first;
+  }
+  for (auto const & entry : entries)
+    writer.Write(&entry.second, sizeof(entry.second));
+}
+
+bool TrafficInfo::Load(vector<uint8_t> const & data)
+{
+  vector<uint64_t> keys;
+  vector<uint8_t> speeds;
+  if (!Deserialize(data, keys, speeds))
+    return false;
+
+  // Removals have no meaning in the whole table.
+  size_t count = 0;
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    if (speeds[i] == kNoSpeed)
+      continue;
+    keys[count] = keys[i];
+    speeds[count] = speeds[i];
+    ++count;
+  }
+  keys.resize(count);
+  speeds.resize(count);
+
+  m_keys.swap(keys);
+  m_speeds.swap(speeds);
+  return true;
+}
+
+bool TrafficInfo::Update(vector<uint8_t> const & data)
+{
+  vector<uint64_t> keys;
+  vector<uint8_t> speeds;
+  if (!Deserialize(data, keys, speeds))
+    return false;
+
+  // Both tables are sorted, so they're merged in one pass, the update wins on equal keys.
+  vector<uint64_t> mergedKeys;
+  vector<uint8_t> mergedSpeeds;
+  mergedKeys.reserve(m_keys.size() + keys.size());
+  mergedSpeeds.reserve(m_keys.size() + keys.size());
+  size_t i = 0;
+  size_t j = 0;
+  while (i < m_keys.size() || j < keys.size())
+  {
+    if (j == keys.size() || (i < m_keys.size() && m_keys[i] < keys[j]))
+    {
+      mergedKeys.push_back(m_keys[i]);
+      mergedSpeeds.push_back(m_speeds[i]);
+      ++i;
+      continue;
+    }
+
+    if (i < m_keys.size() && m_keys[i] == keys[j])
+      ++i;
+    if (speeds[j] != kNoSpeed)
+    {
+      mergedKeys.push_back(keys[j]);
+      mergedSpeeds.push_back(speeds[j]);
+    }
+    ++j;
+  }
+
+  m_keys.swap(mergedKeys);
+  m_speeds.swap(mergedSpeeds);
+  return true;
+}
+
+double TrafficInfo::GetSpeedFactor(RoadSegmentId const & id) const
+{
+  auto const it = lower_bound(m_keys.begin(), m_keys.end(), id.GetKey());
+  if (it == m_keys.end() || *it != id.GetKey())
+    return 1.0;
+  return static_cast<double>(m_speeds[distance(m_keys.begin(), it)]) / kMaxSpeed;
+}
+
+// static
+bool TrafficInfo::Deserialize(vector<uint8_t> const & data, vector<uint64_t> & keys,
+                              vector<uint8_t> & speeds)
+{
+  // The data are downloaded, so they're decoded by the bounded decoders, which throw on
+  // the truncated values instead of reading past the buffer.
+  uint8_t const * const beg = data.data();
+  uint8_t const * const end = beg + data.size();
+  try
+  {
+    uint32_t header[2];
+    uint8_t const * const keysBeg = DecodeVarUint32Array(beg, end, ARRAY_SIZE(header), header);
+    uint32_t const version = header[0];
+    if (version != kVersion)
+    {
+      LOG(LWARNING, ("Unsupported traffic version:", version));
+      return false;
+    }
+
+    // Each segment takes two bytes at least, the last count bytes are the speeds.
+    size_t const count = header[1];
+    if (count > static_cast<size_t>(end - keysBeg) / 2)
+    {
+      LOG(LWARNING, ("Traffic is malformed, segments:", count, "bytes:", data.size()));
+      return false;
+    }
+    uint8_t const * const keysEnd = end - count;
+
+    keys.resize(static_cast<size_t>(keysEnd - keysBeg));
+    if (!keys.empty() && DecodeVarUint64Array(keysBeg, keysEnd, keys.data()) != count)
+    {
+      LOG(LWARNING, ("Traffic is malformed, segments:", count, "bytes:", data.size()));
+      return false;
+    }
+    keys.resize(count);
+  }
+  catch (ReadVarIntException const & e)
+  {
+    LOG(LWARNING, ("Traffic is malformed:", e.Msg()));
+    return false;
+  }
+
+  for (size_t i = 1; i < keys.size(); ++i)
+  {
+    if (keys[i] == 0)
+    {
+      LOG(LWARNING, ("Traffic segments are not unique."));
+      return false;
+    }
+    keys[i] += keys[i - 1];
+  }
+
+  speeds.assign(end - keys.size(), end);
+  if (any_of(speeds.begin(), speeds.end(), [](uint8_t speed)
+             {
+               return speed > kMaxSpeed;
+             }))
+  {
+    LOG(LWARNING, ("Traffic is malformed, the speed is out of range."));
+    return false;
+  }
+  return true;
+}
+
+bool TrafficCache::Set(MwmSet::MwmId const & mwmId, vector<uint8_t> const & data)
+{
+  auto info = make_shared<TrafficInfo>();
+  if (!info->Load(data))
+    return false;
+
+  lock_guard<mutex> guard(m_updateMutex);
+  Publish(mwmId, info);
+  return true;
+}
+
+bool TrafficCache::Update(MwmSet::MwmId const & mwmId, vector<uint8_t> const & data)
+{
+  // Updates of the same mwm are applied one by one, the readers aren't blocked meanwhile.
+  lock_guard<mutex> guard(m_updateMutex);
+  shared_ptr<TSnapshot const> const snapshot = GetSnapshot();
+  auto const it = snapshot->find(mwmId);
+  auto info = it == snapshot->end() ? make_shared<TrafficInfo>()
+                                    : make_shared<TrafficInfo>(*it->second);
+  if (!info->Update(data))
+    return false;
+
+  Publish(mwmId, info);
+  return true;
+}
+
+void TrafficCache::Remove(MwmSet::MwmId const & mwmId)
+{
+  lock_guard<mutex> guard(m_updateMutex);
+  Publish(mwmId, nullptr);
+}
+
+shared_ptr<TrafficCache::TSnapshot const> TrafficCache::GetSnapshot() const
+{
+  lock_guard<mutex> guard(m_mutex);
+  return m_snapshot;
+}
+
+void TrafficCache::Publish(MwmSet::MwmId const & mwmId, shared_ptr<TrafficInfo const> const & info)
+{
+  auto snapshot = make_shared<TSnapshot>(*GetSnapshot());
+  if (info && !info->IsEmpty())
+    (*snapshot)[mwmId] = info;
+  else
+    snapshot->erase(mwmId);
+
+  lock_guard<mutex> guard(m_mutex);
+  m_snapshot = snapshot;
+}
+
+double GetSpeedFactor(TrafficCache::TSnapshot const & snapshot, FeatureID const & featureId,
+                      uint32_t segIdx, bool forward)
+{
+  auto const it = snapshot.find(featureId.m_mwmId);
+  if (it == snapshot.end())
+    return 1.0;
+  return it->second->GetSpeedFactor(
+      TrafficInfo::RoadSegmentId(featureId.m_index, segIdx, forward));
+}
+
+}  // namespace routing
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "indexer/feature_decl.hpp"
+#include "indexer/mwm_set.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/map.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+namespace routing
+{
+
+/// TrafficInfo is a table of the live speeds of the road segments of a single mwm.
+/// A road segment is a pair of consecutive points of a feature which is passed in one direction,
+/// as an FtSeg of one point or an Edge of IRoadGraph. Speeds are kept in percents of the speeds
+/// of the vehicle model, which the OSRM weights and the road graph weights are made of, so
+/// the weights are re-weighted by the factors without any preprocessing. Segments which are
+/// not in the table move with the speeds of the vehicle model.
+///
+/// The table is downloaded as a whole or as an update of the previous one, both of them have
+/// the same format: the sorted keys of the segments, delta-coded by varints, and a byte
+/// of the speed for each key.
+class TrafficInfo
+{
+public:
+  struct RoadSegmentId
+  {
+    RoadSegmentId(uint32_t fid, uint32_t segIdx, bool forward)
+      : m_fid(fid), m_segIdx(segIdx), m_forward(forward)
+    {
+    }
+
+    inline uint64_t GetKey() const
+    {
+      return (static_cast<uint64_t>(m_fid) << 32) | (static_cast<uint64_t>(m_segIdx) << 1) |
+             (m_forward ? 0 : 1);
+    }
+
+    uint32_t m_fid;
+    /// Segment is from the point m_segIdx to the point m_segIdx + 1 of the feature.
+    uint32_t m_segIdx;
+    bool m_forward;
+  };
+
+  /// Speeds of the segments in percents, from 1 to kMaxSpeed. The updates remove the segments
+  /// with kNoSpeed, so they move with the speeds of the vehicle model again.
+  using TSpeeds = vector<pair<RoadSegmentId, uint8_t>>;
+
+  static uint32_t constexpr kVersion = 0;
+  static uint8_t constexpr kNoSpeed = 0;
+  static uint8_t constexpr kMaxSpeed = 100;
+
+  /// Writes the table or the update of it.
+  static void Serialize(TSpeeds const & speeds, Writer & writer);
+
+  /// Replaces the table by the downloaded one.
+  /// @return False when the data are malformed, the table is left unchanged.
+  bool Load(vector<uint8_t> const & data);
+
+  /// Applies the downloaded update to the table.
+  /// @return False when the data are malformed, the table is left unchanged.
+  bool Update(vector<uint8_t> const & data);
+
+  /// @return Factor of the speed of the vehicle model for the segment, it's in (0, 1].
+  double GetSpeedFactor(RoadSegmentId const & id) const;
+
+  inline size_t GetSegmentsCount() const { return m_keys.size(); }
+  inline bool IsEmpty() const { return m_keys.empty(); }
+
+private:
+  static bool Deserialize(vector<uint8_t> const & data, vector<uint64_t> & keys,
+                          vector<uint8_t> & speeds);
+
+  // Sorted keys of the segments, see RoadSegmentId::GetKey().
+  vector<uint64_t> m_keys;
+  vector<uint8_t> m_speeds;
+};
+
+/// Traffic of the mwms with live speeds, it's shared by the downloads and the routers.
+/// Tables are never changed in place: each download makes a new snapshot, so the routers take
+/// the current snapshot at the start of a route and use it without locks, while the next
+/// downloads are applied.
+class TrafficCache
+{
+public:
+  using TSnapshot = map<MwmSet::MwmId, shared_ptr<TrafficInfo const>>;
+
+  /// Replaces the traffic of the mwm by the downloaded table.
+  /// @return False when the data are malformed.
+  bool Set(MwmSet::MwmId const & mwmId, vector<uint8_t> const & data);
+
+  /// Applies the downloaded update to the traffic of the mwm.
+  /// @return False when the data are malformed.
+  bool Update(MwmSet::MwmId const & mwmId, vector<uint8_t> const & data);
+
+  /// Removes the traffic of the mwm, it's used when the mwm is deregistered or the traffic of
+  /// the mwm has expired.
+  void Remove(MwmSet::MwmId const & mwmId);
+
+  shared_ptr<TSnapshot const> GetSnapshot() const;
+
+private:
+  /// Makes the new snapshot with the traffic of the mwm, it's called under m_updateMutex.
+  void Publish(MwmSet::MwmId const & mwmId, shared_ptr<TrafficInfo const> const & info);
+
+  // Guards the snapshot pointer only, the downloads are serialized by m_updateMutex.
+  mutable mutex m_mutex;
+  mutex m_updateMutex;
+  shared_ptr<TSnapshot const> m_snapshot = make_shared<TSnapshot>();
+};
+
+/// @return Traffic factor of the speed of the segment of the feature, 1 when the snapshot
+/// has no traffic for the mwm of the feature or for the segment.
+double GetSpeedFactor(TrafficCache::TSnapshot const & snapshot, FeatureID const & featureId,
+                      uint32_t segIdx, bool forward);
+
+}  // namespace routing
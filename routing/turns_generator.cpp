@@ -29,6 +29,12 @@ double constexpr kNotSoCloseMinDistMeters = 30.;
 
 typedef vector<double> TGeomTurnCandidate;
 
+/// Sources of the data of a junction which are computed only when they're needed, they're either
+/// the table lookups or the queries of the features near the junction.
+using TPossibleTurnsGetter = function<void(vector<NodeID> & nodes)>;
+using THighwayClassGetter = function<ftypes::HighwayClass(NodeID node)>;
+using TSegmentsCountGetter = function<size_t()>;
+
 double PiMinusTwoVectorsAngle(m2::PointD const & p, m2::PointD const & p1, m2::PointD const & p2)
 {
   return math::pi - ang::TwoVectorsAngle(p, p1, p2);
@@ -84,7 +90,7 @@ public:
     // it's enough just to check the start and the finish of the feature.
     for (size_t i = 0; i < count; ++i)
     {
-      if (MercatorBounds::DistanceOnEarth(m_junctionPoint, ft.GetPoint(i)) <
+      if (MercatorBounds::ShortDistanceOnEarth(m_junctionPoint, ft.GetPoint(i)) <
           kFeaturesNearTurnMeters)
       {
         if (i > 0)
@@ -155,8 +161,8 @@ ftypes::HighwayClass GetOutgoingHighwayClass(NodeID outgoingNode,
  * - and the other possible turns lead to small roads;
  * - and the turn is GoStraight or TurnSlight*.
  */
-bool KeepTurnByHighwayClass(TurnDirection turn, TTurnCandidates const & possibleTurns,
-                            TurnInfo const & turnInfo, Index const & index)
+bool KeepTurnByHighwayClass(TurnDirection turn, vector<NodeID> const & possibleTurns,
+                            TurnInfo const & turnInfo, THighwayClassGetter const & getHighwayClass)
 {
   if (!IsGoStraightOrSlightTurn(turn))
     return true;  // The road significantly changes its direction here. So this turn shall be kept.
@@ -166,12 +172,11 @@ bool KeepTurnByHighwayClass(TurnDirection turn, TTurnCandidates const & possible
     return true;
 
   ftypes::HighwayClass maxClassForPossibleTurns = ftypes::HighwayClass::Error;
-  for (auto const & t : possibleTurns)
+  for (NodeID const node : possibleTurns)
   {
-    if (t.node == turnInfo.m_outgoingNodeID)
+    if (node == turnInfo.m_outgoingNodeID)
       continue;
-    ftypes::HighwayClass const highwayClass =
-        GetOutgoingHighwayClass(t.node, turnInfo.m_routeMapping, index);
+    ftypes::HighwayClass const highwayClass = getHighwayClass(node);
     if (static_cast<int>(highwayClass) > static_cast<int>(maxClassForPossibleTurns))
       maxClassForPossibleTurns = highwayClass;
   }
@@ -253,7 +258,7 @@ size_t NumberOfIngoingAndOutgoingSegments(m2::PointD const & junctionPoint,
 bool KeepTurnByIngoingEdges(m2::PointD const & junctionPoint,
                             m2::PointD const & ingoingPointOneSegment,
                             m2::PointD const & outgoingPoint, bool hasMultiTurns,
-                            RoutingMapping const & routingMapping, Index const & index)
+                            TSegmentsCountGetter const & getSegmentsCount)
 {
   double const turnAngle =
     my::RadToDeg(PiMinusTwoVectorsAngle(junctionPoint, ingoingPointOneSegment, outgoingPoint));
@@ -262,9 +267,7 @@ bool KeepTurnByIngoingEdges(m2::PointD const & junctionPoint,
   // The code below is resposible for cases when there is only one way to leave the junction.
   // Such junction has to be kept as a turn when it's not a slight turn and it has ingoing edges
   // (one or more);
-  return hasMultiTurns || (!isGoStraightOrSlightTurn &&
-                           NumberOfIngoingAndOutgoingSegments(junctionPoint, ingoingPointOneSegment,
-                                                              routingMapping, index) > 2);
+  return hasMultiTurns || (!isGoStraightOrSlightTurn && getSegmentsCount() > 2);
 }
 
 bool FixupLaneSet(TurnDirection turn, vector<SingleLaneInfo> & lanes,
@@ -361,7 +364,8 @@ m2::PointD GetPointForTurn(OsrmMappingTypes::FtSeg const & segment, FeatureType
   for (size_t i = 1; i <= usedFtPntNum; ++i)
   {
     nextPoint = ft.GetPoint(GetPointIndex(segment.m_pointStart, segment.m_pointEnd, i));
-    curDistanceMeters += MercatorBounds::DistanceOnEarth(point, nextPoint);
+    // Points are taken a few meters from the junction, so the planar distance is enough.
+    curDistanceMeters += MercatorBounds::ShortDistanceOnEarth(point, nextPoint);
     if (curDistanceMeters > minDistMeters)
       return nextPoint;
     point = nextPoint;
@@ -454,6 +458,139 @@ size_t GetOutgoingPointIndex(const size_t start, const size_t end, const size_t
 {
   return end > start ? start + i : start - i;
 }
+
+void FillEdgeTurnInfo(FeatureType const & ft, EdgeTurnInfo & edge)
+{
+  edge.m_highwayClass = ftypes::GetHighwayClass(ft);
+  edge.m_isRoundabout = ftypes::IsRoundAboutChecker::Instance()(ft);
+  edge.m_isLink = ftypes::IsLinkChecker::Instance()(ft);
+  ft.GetName(FeatureType::DEFAULT_LANG, edge.m_name);
+}
+
+/// Fills the fields of the last segment of the node but the ones which need the queries
+/// of the features near the junction. The geometry of ft must be parsed.
+void FillIngoingTurnInfo(OsrmMappingTypes::FtSeg const & segment, FeatureType const & ft,
+                         NodeTurnInfo & info)
+{
+  info.m_hasLast = true;
+  FillEdgeTurnInfo(ft, info.m_last);
+  info.m_junctionPoint = ft.GetPoint(segment.m_pointEnd);
+  info.m_ingoingPoint = GetPointForTurn(segment, ft, info.m_junctionPoint, kMaxPointsCount,
+                                        kMinDistMeters, GetIngoingPointIndex);
+  info.m_ingoingPointOneSegment = ft.GetPoint(segment.m_pointStart < segment.m_pointEnd
+                                                  ? segment.m_pointEnd - 1
+                                                  : segment.m_pointEnd + 1);
+  info.m_notSoClosePoint = GetPointForTurn(segment, ft, info.m_junctionPoint,
+                                           kNotSoCloseMaxPointsCount, kNotSoCloseMinDistMeters,
+                                           GetIngoingPointIndex);
+}
+
+/// Fills the fields of the first segment of the node, the outgoing point is taken along
+/// the node from junctionPoint. The geometry of ft must be parsed.
+void FillOutgoingTurnInfo(OsrmMappingTypes::FtSeg const & segment, FeatureType const & ft,
+                          m2::PointD const & junctionPoint, NodeTurnInfo & info)
+{
+  info.m_hasFirst = true;
+  FillEdgeTurnInfo(ft, info.m_first);
+  info.m_outgoingPoint = GetPointForTurn(segment, ft, junctionPoint, kMaxPointsCount,
+                                         kMinDistMeters, GetOutgoingPointIndex);
+}
+
+void GetPossibleTurnNodes(Index const & index, NodeID node, NodeTurnInfo const & ingoing,
+                          RoutingMapping & routingMapping, vector<NodeID> & nodes)
+{
+  TTurnCandidates candidates;
+  GetPossibleTurns(index, node, ingoing.m_ingoingPointOneSegment, ingoing.m_junctionPoint,
+                   routingMapping, candidates);
+  nodes.clear();
+  nodes.reserve(candidates.size());
+  for (TurnCandidate const & candidate : candidates)
+    nodes.push_back(candidate.node);
+}
+
+/// Makes the turn of the route from the last segment of ingoing to the first segment
+/// of outgoing. The geometry of the turn is taken from the infos, the rest of the junction
+/// data are taken from the getters.
+void MakeTurn(NodeTurnInfo const & ingoing, NodeTurnInfo const & outgoing,
+              TPossibleTurnsGetter const & getPossibleTurns,
+              THighwayClassGetter const & getHighwayClass,
+              TSegmentsCountGetter const & getSegmentsCount, TurnInfo & turnInfo, TurnItem & turn)
+{
+  m2::PointD const & junctionPoint = ingoing.m_junctionPoint;
+  double const turnAngle = my::RadToDeg(
+      PiMinusTwoVectorsAngle(junctionPoint, ingoing.m_ingoingPoint, outgoing.m_outgoingPoint));
+  TurnDirection const intermediateDirection = IntermediateDirection(turnAngle);
+
+  // Getting all the information about ingoing and outgoing edges.
+  turnInfo.m_isIngoingEdgeRoundabout = ingoing.m_last.m_isRoundabout;
+  turnInfo.m_isOutgoingEdgeRoundabout = outgoing.m_first.m_isRoundabout;
+
+  turn.m_keepAnyway = (!ingoing.m_last.m_isLink && outgoing.m_first.m_isLink);
+
+  turnInfo.m_ingoingHighwayClass = ingoing.m_last.m_highwayClass;
+  turnInfo.m_outgoingHighwayClass = outgoing.m_first.m_highwayClass;
+
+  turn.m_sourceName = ingoing.m_last.m_name;
+  turn.m_targetName = outgoing.m_first.m_name;
+
+  turn.m_turn = TurnDirection::NoTurn;
+  // Early filtering based only on the information about ingoing and outgoing edges.
+  if (DiscardTurnByIngoingAndOutgoingEdges(intermediateDirection, turnInfo, turn))
+    return;
+
+  vector<NodeID> nodes;
+  getPossibleTurns(nodes);
+
+  size_t const numNodes = nodes.size();
+  bool const hasMultiTurns = numNodes > 1;
+
+  if (numNodes == 0)
+    return;
+
+  if (!hasMultiTurns)
+  {
+    turn.m_turn = intermediateDirection;
+  }
+  else
+  {
+    if (nodes.front() == turnInfo.m_outgoingNodeID)
+      turn.m_turn = LeftmostDirection(turnAngle);
+    else if (nodes.back() == turnInfo.m_outgoingNodeID)
+      turn.m_turn = RightmostDirection(turnAngle);
+    else
+      turn.m_turn = intermediateDirection;
+  }
+
+  bool const keepTurnByHighwayClass =
+      KeepTurnByHighwayClass(turn.m_turn, nodes, turnInfo, getHighwayClass);
+  if (turnInfo.m_isIngoingEdgeRoundabout || turnInfo.m_isOutgoingEdgeRoundabout)
+  {
+    turn.m_turn = GetRoundaboutDirection(turnInfo.m_isIngoingEdgeRoundabout,
+                                         turnInfo.m_isOutgoingEdgeRoundabout, hasMultiTurns,
+                                         keepTurnByHighwayClass);
+    return;
+  }
+
+  if (!turn.m_keepAnyway && !keepTurnByHighwayClass)
+  {
+    turn.m_turn = TurnDirection::NoTurn;
+    return;
+  }
+
+  if (!KeepTurnByIngoingEdges(junctionPoint, ingoing.m_notSoClosePoint, outgoing.m_outgoingPoint,
+                              hasMultiTurns, getSegmentsCount))
+  {
+    turn.m_turn = TurnDirection::NoTurn;
+    return;
+  }
+
+  if (turn.m_turn == TurnDirection::GoStraight)
+  {
+    if (!hasMultiTurns)
+      turn.m_turn = TurnDirection::NoTurn;
+    return;
+  }
+}
 }  // namespace
 
 namespace routing
@@ -501,24 +638,22 @@ vector<SingleLaneInfo> GetLanesInfo(NodeID node, RoutingMapping const & routingM
     Index::FeaturesLoaderGuard loader1(index, routingMapping.GetMwmId());
     loader1.GetFeatureByIndex(seg1.m_fid, ft1);
 
+    // Only one of the lanes fields is needed, so the others aren't decoded.
     using feature::Metadata;
-    ft1.ParseMetadata();
-    Metadata const & md = ft1.GetMetadata();
-
     if (ftypes::IsOneWayChecker::Instance()(ft1))
     {
-      ParseLanes(md.Get(Metadata::FMD_TURN_LANES), lanes);
+      ParseLanes(ft1.GetMetadataField(Metadata::FMD_TURN_LANES), lanes);
       return lanes;
     }
     // two way roads
     if (seg1.m_pointStart < seg1.m_pointEnd)
     {
       // forward direction
-      ParseLanes(md.Get(Metadata::FMD_TURN_LANES_FORWARD), lanes);
+      ParseLanes(ft1.GetMetadataField(Metadata::FMD_TURN_LANES_FORWARD), lanes);
       return lanes;
     }
     // backward direction
-    ParseLanes(md.Get(Metadata::FMD_TURN_LANES_BACKWARD), lanes);
+    ParseLanes(ft1.GetMetadataField(Metadata::FMD_TURN_LANES_BACKWARD), lanes);
     return lanes;
   }
   return lanes;
@@ -551,10 +686,9 @@ void FixupTurns(vector<m2::PointD> const & points, Route::TTurns & turnsDir)
 
   auto routeDistanceMeters = [&points](uint32_t start, uint32_t end)
   {
-    double res = 0.0;
-    for (uint32_t i = start + 1; i < end; ++i)
-      res += MercatorBounds::DistanceOnEarth(points[i - 1], points[i]);
-    return res;
+    if (start >= end)
+      return 0.0;
+    return MercatorBounds::LengthOnEarth(points.data() + start, end - start);
   };
 
   for (size_t idx = 0; idx < turnsDir.size(); )
@@ -726,10 +860,33 @@ void GetTurnDirection(Index const & index, TurnInfo & turnInfo, TurnItem & turn)
   if (!turnInfo.IsSegmentsValid())
     return;
 
+  RoutingMapping & mapping = turnInfo.m_routeMapping;
+  TurnsInfoSection const & section = mapping.m_turnsInfo;
+  NodeTurnInfo ingoing, outgoing;
+  if (section.GetInfo(turnInfo.m_ingoingNodeID, ingoing) &&
+      section.GetInfo(turnInfo.m_outgoingNodeID, outgoing) && ingoing.m_hasLast &&
+      outgoing.m_hasFirst)
+  {
+    MakeTurn(ingoing, outgoing, [&ingoing](vector<NodeID> & nodes)
+             {
+               nodes = ingoing.m_possibleTurns;
+             },
+             [&section](NodeID node)
+             {
+               return section.GetOutgoingHighwayClass(node);
+             },
+             [&ingoing]()
+             {
+               return static_cast<size_t>(ingoing.m_junctionSegmentsCount);
+             },
+             turnInfo, turn);
+    return;
+  }
+
   // ingoingFeature and outgoingFeature can be used only within the scope.
   FeatureType ingoingFeature, outgoingFeature;
-  Index::FeaturesLoaderGuard ingoingLoader(index, turnInfo.m_routeMapping.GetMwmId());
-  Index::FeaturesLoaderGuard outgoingLoader(index, turnInfo.m_routeMapping.GetMwmId());
+  Index::FeaturesLoaderGuard ingoingLoader(index, mapping.GetMwmId());
+  Index::FeaturesLoaderGuard outgoingLoader(index, mapping.GetMwmId());
   ingoingLoader.GetFeatureByIndex(turnInfo.m_ingoingSegment.m_fid, ingoingFeature);
   outgoingLoader.GetFeatureByIndex(turnInfo.m_outgoingSegment.m_fid, outgoingFeature);
 
@@ -741,92 +898,65 @@ void GetTurnDirection(Index const & index, TurnInfo & turnInfo, TurnItem & turn)
                   outgoingFeature.GetPoint(turnInfo.m_outgoingSegment.m_pointStart)),
               kFeaturesNearTurnMeters, ());
 
-  m2::PointD const junctionPoint = ingoingFeature.GetPoint(turnInfo.m_ingoingSegment.m_pointEnd);
-  m2::PointD const ingoingPoint = GetPointForTurn(turnInfo.m_ingoingSegment, ingoingFeature,
-                                                  junctionPoint, kMaxPointsCount, kMinDistMeters, GetIngoingPointIndex);
-  m2::PointD const outgoingPoint = GetPointForTurn(turnInfo.m_outgoingSegment, outgoingFeature,
-                                                   junctionPoint, kMaxPointsCount, kMinDistMeters, GetOutgoingPointIndex);
-
-  double const turnAngle = my::RadToDeg(PiMinusTwoVectorsAngle(junctionPoint, ingoingPoint, outgoingPoint));
-  TurnDirection const intermediateDirection = IntermediateDirection(turnAngle);
-
-  // Getting all the information about ingoing and outgoing edges.
-  turnInfo.m_isIngoingEdgeRoundabout = ftypes::IsRoundAboutChecker::Instance()(ingoingFeature);
-  turnInfo.m_isOutgoingEdgeRoundabout = ftypes::IsRoundAboutChecker::Instance()(outgoingFeature);
-
-  turn.m_keepAnyway = (!ftypes::IsLinkChecker::Instance()(ingoingFeature) &&
-                       ftypes::IsLinkChecker::Instance()(outgoingFeature));
-
-  turnInfo.m_ingoingHighwayClass = ftypes::GetHighwayClass(ingoingFeature);
-  turnInfo.m_outgoingHighwayClass = ftypes::GetHighwayClass(outgoingFeature);
-
-  ingoingFeature.GetName(FeatureType::DEFAULT_LANG, turn.m_sourceName);
-  outgoingFeature.GetName(FeatureType::DEFAULT_LANG, turn.m_targetName);
-
-  turn.m_turn = TurnDirection::NoTurn;
-  // Early filtering based only on the information about ingoing and outgoing edges.
-  if (DiscardTurnByIngoingAndOutgoingEdges(intermediateDirection, turnInfo, turn))
-    return;
-
-  m2::PointD const ingoingPointOneSegment = ingoingFeature.GetPoint(
-      turnInfo.m_ingoingSegment.m_pointStart < turnInfo.m_ingoingSegment.m_pointEnd
-          ? turnInfo.m_ingoingSegment.m_pointEnd - 1
-          : turnInfo.m_ingoingSegment.m_pointEnd + 1);
-  TTurnCandidates nodes;
-  GetPossibleTurns(index, turnInfo.m_ingoingNodeID, ingoingPointOneSegment, junctionPoint,
-                   turnInfo.m_routeMapping, nodes);
-
-  size_t const numNodes = nodes.size();
-  bool const hasMultiTurns = numNodes > 1;
-
-  if (numNodes == 0)
-    return;
-
-  if (!hasMultiTurns)
-  {
-    turn.m_turn = intermediateDirection;
-  }
-  else
-  {
-    if (nodes.front().node == turnInfo.m_outgoingNodeID)
-      turn.m_turn = LeftmostDirection(turnAngle);
-    else if (nodes.back().node == turnInfo.m_outgoingNodeID)
-      turn.m_turn = RightmostDirection(turnAngle);
-    else
-      turn.m_turn = intermediateDirection;
-  }
+  ingoing = NodeTurnInfo();
+  outgoing = NodeTurnInfo();
+  FillIngoingTurnInfo(turnInfo.m_ingoingSegment, ingoingFeature, ingoing);
+  FillOutgoingTurnInfo(turnInfo.m_outgoingSegment, outgoingFeature, ingoing.m_junctionPoint,
+                       outgoing);
+
+  MakeTurn(ingoing, outgoing, [&](vector<NodeID> & nodes)
+           {
+             GetPossibleTurnNodes(index, turnInfo.m_ingoingNodeID, ingoing, mapping, nodes);
+           },
+           [&](NodeID node)
+           {
+             return GetOutgoingHighwayClass(node, mapping, index);
+           },
+           [&]()
+           {
+             return NumberOfIngoingAndOutgoingSegments(
+                 ingoing.m_junctionPoint, ingoing.m_notSoClosePoint, mapping, index);
+           },
+           turnInfo, turn);
+}
 
-  bool const keepTurnByHighwayClass = KeepTurnByHighwayClass(turn.m_turn, nodes, turnInfo, index);
-  if (turnInfo.m_isIngoingEdgeRoundabout || turnInfo.m_isOutgoingEdgeRoundabout)
-  {
-    turn.m_turn = GetRoundaboutDirection(turnInfo.m_isIngoingEdgeRoundabout,
-                                         turnInfo.m_isOutgoingEdgeRoundabout, hasMultiTurns,
-                                         keepTurnByHighwayClass);
-    return;
-  }
+void CalculateNodeTurnInfo(Index const & index, RoutingMapping & routingMapping, NodeID node,
+                           NodeTurnInfo & info)
+{
+  info = NodeTurnInfo();
+  Index::FeaturesLoaderGuard loader(index, routingMapping.GetMwmId());
 
-  if (!turn.m_keepAnyway && !keepTurnByHighwayClass)
+  OsrmMappingTypes::FtSeg const first = GetSegment(node, routingMapping, GetFirstSegmentPointIndex);
+  if (first.IsValid())
   {
-    turn.m_turn = TurnDirection::NoTurn;
-    return;
+    FeatureType ft;
+    loader.GetFeatureByIndex(first.m_fid, ft);
+    ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+    // The junction before the node is its first point, the ingoing nodes end near it.
+    FillOutgoingTurnInfo(first, ft, ft.GetPoint(first.m_pointStart), info);
   }
 
-  auto const notSoCloseToTheTurnPoint = GetPointForTurn(turnInfo.m_ingoingSegment, ingoingFeature, junctionPoint,
-                                                        kNotSoCloseMaxPointsCount, kNotSoCloseMinDistMeters, GetIngoingPointIndex);
-
-  if (!KeepTurnByIngoingEdges(junctionPoint, notSoCloseToTheTurnPoint, outgoingPoint, hasMultiTurns,
-                              turnInfo.m_routeMapping, index))
+  OsrmMappingTypes::FtSeg const last = GetSegment(node, routingMapping, GetLastSegmentPointIndex);
+  if (last.IsValid())
   {
-    turn.m_turn = TurnDirection::NoTurn;
-    return;
+    FeatureType ft;
+    loader.GetFeatureByIndex(last.m_fid, ft);
+    ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+    FillIngoingTurnInfo(last, ft, info);
+    GetPossibleTurnNodes(index, node, info, routingMapping, info.m_possibleTurns);
+    info.m_junctionSegmentsCount = static_cast<uint32_t>(NumberOfIngoingAndOutgoingSegments(
+        info.m_junctionPoint, info.m_notSoClosePoint, routingMapping, index));
+    info.m_lanes = GetLanesInfo(node, routingMapping, GetLastSegmentPointIndex, index);
   }
+}
 
-  if (turn.m_turn == TurnDirection::GoStraight)
-  {
-    if (!hasMultiTurns)
-      turn.m_turn = TurnDirection::NoTurn;
-    return;
-  }
+vector<SingleLaneInfo> GetIngoingLanesInfo(NodeID node, RoutingMapping const & routingMapping,
+                                           Index const & index)
+{
+  NodeTurnInfo info;
+  if (routingMapping.m_turnsInfo.GetInfo(node, info) && info.m_hasLast)
+    return info.m_lanes;
+  return GetLanesInfo(node, routingMapping, GetLastSegmentPointIndex, index);
 }
 }  // namespace turns
 }  // namespace routing
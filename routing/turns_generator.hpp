@@ -4,6 +4,7 @@
 #include "routing/osrm_engine.hpp"
 #include "routing/route.hpp"
 #include "routing/turns.hpp"
+#include "routing/turns_info.hpp"
 
 #include "std/function.hpp"
 #include "std/utility.hpp"
@@ -59,6 +60,13 @@ size_t GetLastSegmentPointIndex(pair<size_t, size_t> const & p);
 vector<SingleLaneInfo> GetLanesInfo(NodeID node, RoutingMapping const & routingMapping,
                                     TGetIndexFunction GetIndex, Index const & index);
 
+/*!
+ * \brief Returns lanes of the last segment of the node, they're taken from the turns info
+ * section when the routing file has it.
+ */
+vector<SingleLaneInfo> GetIngoingLanesInfo(NodeID node, RoutingMapping const & routingMapping,
+                                           Index const & index);
+
 // Returns the distance in meractor units for the path of points for the range [startPointIndex, endPointIndex].
 double CalculateMercatorDistanceAlongPath(uint32_t startPointIndex, uint32_t endPointIndex,
                                           vector<m2::PointD> const & points);
@@ -119,10 +127,20 @@ TurnDirection GetRoundaboutDirection(bool isIngoingEdgeRoundabout, bool isOutgoi
 
 /*!
  * \brief GetTurnDirection makes a primary decision about turns on the route.
+ * The junction data are taken from the turns info section of the routing file when it has one,
+ * and from the features near the junction otherwise.
  * \param turnInfo is used for cashing some information while turn calculation.
  * \param turn is used for keeping the result of turn calculation.
  */
 void GetTurnDirection(Index const & index, turns::TurnInfo & turnInfo, TurnItem & turn);
 
+/*!
+ * \brief Calculates the junction descriptors of the node from the features for the turns info
+ * section. The facade and the segments mapping of routingMapping must be loaded.
+ * \warning It's a time-consuming function, it's used by the generator.
+ */
+void CalculateNodeTurnInfo(Index const & index, RoutingMapping & routingMapping, NodeID node,
+                           NodeTurnInfo & info);
+
 }  // namespace routing
 }  // namespace turns
@@ -0,0 +1,366 @@
+#include "routing/turns_info.hpp"
+
+#include "routing/aligned_section.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/map.hpp"
+#include "std/sstream.hpp"
+
+namespace routing
+{
+namespace turns
+{
+namespace
+{
+uint8_t constexpr kHasFirstFlag = 1 << 0;
+uint8_t constexpr kHasLastFlag = 1 << 1;
+
+// An edge byte keeps the highway class in the low bits and the flags of the feature.
+uint8_t constexpr kHighwayClassMask = 0x0F;
+uint8_t constexpr kRoundaboutFlag = 1 << 4;
+uint8_t constexpr kLinkFlag = 1 << 5;
+
+static_assert(static_cast<uint8_t>(ftypes::HighwayClass::Count) <= kHighwayClassMask + 1,
+              "Highway classes don't fit the edge byte.");
+static_assert(static_cast<uint8_t>(LaneWay::Count) <= 0xFF, "Lane ways don't fit a byte.");
+
+uint8_t EncodeEdge(EdgeTurnInfo const & edge)
+{
+  return static_cast<uint8_t>(edge.m_highwayClass) | (edge.m_isRoundabout ? kRoundaboutFlag : 0) |
+         (edge.m_isLink ? kLinkFlag : 0);
+}
+
+void DecodeEdge(uint8_t edgeByte, EdgeTurnInfo & edge)
+{
+  edge.m_highwayClass = static_cast<ftypes::HighwayClass>(edgeByte & kHighwayClassMask);
+  edge.m_isRoundabout = (edgeByte & kRoundaboutFlag) != 0;
+  edge.m_isLink = (edgeByte & kLinkFlag) != 0;
+}
+
+template <typename TSink>
+void WritePointDelta(TSink & sink, m2::PointU const & base, m2::PointD const & point)
+{
+  m2::PointU const p = PointD2PointU(point, POINT_COORD_BITS);
+  WriteVarInt(sink, static_cast<int64_t>(p.x) - static_cast<int64_t>(base.x));
+  WriteVarInt(sink, static_cast<int64_t>(p.y) - static_cast<int64_t>(base.y));
+}
+
+m2::PointD ReadPointDelta(ArrayByteSource & src, m2::PointU const & base)
+{
+  int64_t const dx = ReadVarInt<int64_t>(src);
+  int64_t const dy = ReadVarInt<int64_t>(src);
+  m2::PointU const p(static_cast<uint32_t>(static_cast<int64_t>(base.x) + dx),
+                     static_cast<uint32_t>(static_cast<int64_t>(base.y) + dy));
+  return PointU2PointD(p, POINT_COORD_BITS);
+}
+
+/// Writes the record of the node without its length.
+void WriteRecord(TOsrmNodeId node, NodeTurnInfo const & info, map<string, uint32_t> const & names,
+                 vector<uint8_t> & record)
+{
+  PushBackByteSink<vector<uint8_t>> sink(record);
+  uint8_t const flags = (info.m_hasFirst ? kHasFirstFlag : 0) | (info.m_hasLast ? kHasLastFlag : 0);
+  WriteToSink(sink, flags);
+  if (info.m_hasFirst)
+  {
+    WriteToSink(sink, EncodeEdge(info.m_first));
+    WriteVarUint(sink, names.at(info.m_first.m_name));
+  }
+
+  // Points are the deltas from the junction, the outgoing point of a node without the last
+  // segment is the delta from zero.
+  m2::PointU base(0, 0);
+  if (info.m_hasLast)
+  {
+    WriteToSink(sink, EncodeEdge(info.m_last));
+    WriteVarUint(sink, names.at(info.m_last.m_name));
+    base = PointD2PointU(info.m_junctionPoint, POINT_COORD_BITS);
+    WriteVarUint(sink, base.x);
+    WriteVarUint(sink, base.y);
+    WritePointDelta(sink, base, info.m_ingoingPoint);
+    WritePointDelta(sink, base, info.m_ingoingPointOneSegment);
+    WritePointDelta(sink, base, info.m_notSoClosePoint);
+    WriteVarUint(sink, info.m_junctionSegmentsCount);
+
+    WriteVarUint(sink, static_cast<uint32_t>(info.m_possibleTurns.size()));
+    for (TOsrmNodeId const turn : info.m_possibleTurns)
+      WriteVarInt(sink, static_cast<int64_t>(turn) - static_cast<int64_t>(node));
+
+    WriteVarUint(sink, static_cast<uint32_t>(info.m_lanes.size()));
+    for (SingleLaneInfo const & lane : info.m_lanes)
+    {
+      WriteVarUint(sink, static_cast<uint32_t>(lane.m_lane.size()));
+      for (LaneWay const way : lane.m_lane)
+        WriteToSink(sink, static_cast<uint8_t>(way));
+    }
+  }
+
+  if (info.m_hasFirst)
+    WritePointDelta(sink, base, info.m_outgoingPoint);
+}
+}  // namespace
+
+bool EdgeTurnInfo::operator==(EdgeTurnInfo const & rhs) const
+{
+  return m_highwayClass == rhs.m_highwayClass && m_isRoundabout == rhs.m_isRoundabout &&
+         m_isLink == rhs.m_isLink && m_name == rhs.m_name;
+}
+
+string DebugPrint(EdgeTurnInfo const & info)
+{
+  ostringstream out;
+  out << "EdgeTurnInfo [ " << DebugPrint(info.m_highwayClass)
+      << ", roundabout: " << info.m_isRoundabout << ", link: " << info.m_isLink
+      << ", name: " << info.m_name << " ]";
+  return out.str();
+}
+
+bool NodeTurnInfo::operator==(NodeTurnInfo const & rhs) const
+{
+  if (m_hasFirst != rhs.m_hasFirst || m_hasLast != rhs.m_hasLast)
+    return false;
+  if (m_hasFirst && !(m_first == rhs.m_first && m_outgoingPoint == rhs.m_outgoingPoint))
+    return false;
+  if (!m_hasLast)
+    return true;
+  return m_last == rhs.m_last && m_junctionPoint == rhs.m_junctionPoint &&
+         m_ingoingPoint == rhs.m_ingoingPoint &&
+         m_ingoingPointOneSegment == rhs.m_ingoingPointOneSegment &&
+         m_notSoClosePoint == rhs.m_notSoClosePoint &&
+         m_junctionSegmentsCount == rhs.m_junctionSegmentsCount &&
+         m_possibleTurns == rhs.m_possibleTurns && m_lanes == rhs.m_lanes;
+}
+
+string DebugPrint(NodeTurnInfo const & info)
+{
+  ostringstream out;
+  out << "NodeTurnInfo [ ";
+  if (info.m_hasFirst)
+  {
+    out << "first: " << DebugPrint(info.m_first)
+        << ", outgoing: " << DebugPrint(info.m_outgoingPoint);
+  }
+  if (info.m_hasFirst && info.m_hasLast)
+    out << ", ";
+  if (info.m_hasLast)
+  {
+    out << "last: " << DebugPrint(info.m_last) << ", junction: " << DebugPrint(info.m_junctionPoint)
+        << ", segments: " << info.m_junctionSegmentsCount
+        << ", possible turns: " << ::DebugPrint(info.m_possibleTurns)
+        << ", lanes: " << ::DebugPrint(info.m_lanes);
+  }
+  out << " ]";
+  return out.str();
+}
+
+// static
+uint32_t constexpr TurnsInfoSection::kVersion;
+// static
+uint32_t constexpr TurnsInfoSection::kBlockSize;
+
+// static
+void TurnsInfoSection::Serialize(vector<NodeTurnInfo> const & infos, Writer & writer)
+{
+  // Names are sorted, so the section doesn't depend on the order of the nodes.
+  map<string, uint32_t> names;
+  for (NodeTurnInfo const & info : infos)
+  {
+    if (info.m_hasFirst)
+      names.emplace(info.m_first.m_name, 0);
+    if (info.m_hasLast)
+      names.emplace(info.m_last.m_name, 0);
+  }
+  vector<uint32_t> nameOffsets;
+  vector<char> namesData;
+  nameOffsets.reserve(names.size() + 1);
+  for (auto & name : names)
+  {
+    name.second = static_cast<uint32_t>(nameOffsets.size());
+    nameOffsets.push_back(static_cast<uint32_t>(namesData.size()));
+    namesData.insert(namesData.end(), name.first.begin(), name.first.end());
+  }
+  nameOffsets.push_back(static_cast<uint32_t>(namesData.size()));
+
+  // Each record is prefixed by its length, so the records of a block before the node
+  // are skipped without decoding.
+  vector<uint64_t> blockOffsets;
+  vector<uint8_t> records;
+  vector<uint8_t> record;
+  blockOffsets.reserve((infos.size() + kBlockSize - 1) / kBlockSize + 1);
+  for (size_t i = 0; i < infos.size(); ++i)
+  {
+    if (i % kBlockSize == 0)
+      blockOffsets.push_back(records.size());
+    record.clear();
+    WriteRecord(static_cast<TOsrmNodeId>(i), infos[i], names, record);
+    PushBackByteSink<vector<uint8_t>> sink(records);
+    WriteVarUint(sink, static_cast<uint32_t>(record.size()));
+    records.insert(records.end(), record.begin(), record.end());
+  }
+  blockOffsets.push_back(records.size());
+
+  Header header;
+  header.m_version = kVersion;
+  header.m_nodesCount = static_cast<uint32_t>(infos.size());
+  header.m_namesCount = static_cast<uint32_t>(names.size());
+  header.m_namesSize = static_cast<uint32_t>(namesData.size());
+  header.m_recordsSize = records.size();
+
+  AlignedWriter aligned(writer);
+  aligned.WriteArray(vector<Header>{header});
+  aligned.WriteArray(nameOffsets);
+  aligned.WriteArray(namesData);
+  aligned.WriteArray(blockOffsets);
+  aligned.WriteArray(records);
+}
+
+bool TurnsInfoSection::Map(FilesMappingContainer const & cont, string const & tag)
+{
+  if (!cont.IsExist(tag))
+    return false;
+
+  // Junctions of a route are spread over the whole section.
+  m_handle.Assign(cont.Map(tag, mmap_policy::Get(tag, mmap_policy::Random)));
+  if (Attach(m_handle.GetData<char>(), m_handle.GetSize()))
+    return true;
+
+  Unmap();
+  return false;
+}
+
+void TurnsInfoSection::Unmap()
+{
+  m_header = nullptr;
+  if (m_handle.IsValid())
+    m_handle.Unmap();
+}
+
+bool TurnsInfoSection::Attach(char const * data, uint64_t size)
+{
+  m_header = nullptr;
+  if (reinterpret_cast<uintptr_t>(data) % kSectionArrayAlignment != 0)
+  {
+    LOG(LWARNING, ("Turns info section is not aligned."));
+    return false;
+  }
+
+  AlignedReader reader(data, size);
+  Header const * header = nullptr;
+  if (!reader.ReadArray(1, header))
+    return false;
+  if (header->m_version != kVersion)
+  {
+    LOG(LWARNING, ("Unsupported turns info section version:", header->m_version));
+    return false;
+  }
+
+  uint64_t const blocksCount = (static_cast<uint64_t>(header->m_nodesCount) + kBlockSize - 1) /
+                               kBlockSize;
+  bool ok = reader.ReadArray(header->m_namesCount + 1, m_nameOffsets) &&
+            reader.ReadArray(header->m_namesSize, m_names) &&
+            reader.ReadArray(blocksCount + 1, m_blockOffsets) &&
+            reader.ReadArray(header->m_recordsSize, m_records) && reader.IsEnd();
+  // Offsets are checked once here, so the lookups don't read past the arrays.
+  ok = ok && m_nameOffsets[header->m_namesCount] == header->m_namesSize &&
+       is_sorted(m_nameOffsets, m_nameOffsets + header->m_namesCount + 1) &&
+       m_blockOffsets[blocksCount] == header->m_recordsSize &&
+       is_sorted(m_blockOffsets, m_blockOffsets + blocksCount + 1);
+  if (!ok)
+  {
+    LOG(LWARNING, ("Turns info section is malformed."));
+    return false;
+  }
+
+  m_header = header;
+  return true;
+}
+
+bool TurnsInfoSection::GetInfo(TOsrmNodeId node, NodeTurnInfo & info) const
+{
+  uint8_t const * record = FindRecord(node);
+  if (record == nullptr)
+    return false;
+
+  info = NodeTurnInfo();
+  ArrayByteSource src(record);
+  uint8_t const flags = ReadPrimitiveFromSource<uint8_t>(src);
+  info.m_hasFirst = (flags & kHasFirstFlag) != 0;
+  info.m_hasLast = (flags & kHasLastFlag) != 0;
+  if (info.m_hasFirst)
+  {
+    DecodeEdge(ReadPrimitiveFromSource<uint8_t>(src), info.m_first);
+    info.m_first.m_name = GetName(ReadVarUint<uint32_t>(src));
+  }
+
+  m2::PointU base(0, 0);
+  if (info.m_hasLast)
+  {
+    DecodeEdge(ReadPrimitiveFromSource<uint8_t>(src), info.m_last);
+    info.m_last.m_name = GetName(ReadVarUint<uint32_t>(src));
+    base.x = ReadVarUint<uint32_t>(src);
+    base.y = ReadVarUint<uint32_t>(src);
+    info.m_junctionPoint = PointU2PointD(base, POINT_COORD_BITS);
+    info.m_ingoingPoint = ReadPointDelta(src, base);
+    info.m_ingoingPointOneSegment = ReadPointDelta(src, base);
+    info.m_notSoClosePoint = ReadPointDelta(src, base);
+    info.m_junctionSegmentsCount = ReadVarUint<uint32_t>(src);
+
+    info.m_possibleTurns.resize(ReadVarUint<uint32_t>(src));
+    for (TOsrmNodeId & turn : info.m_possibleTurns)
+      turn = static_cast<TOsrmNodeId>(static_cast<int64_t>(node) + ReadVarInt<int64_t>(src));
+
+    info.m_lanes.resize(ReadVarUint<uint32_t>(src));
+    for (SingleLaneInfo & lane : info.m_lanes)
+    {
+      lane.m_lane.resize(ReadVarUint<uint32_t>(src));
+      for (LaneWay & way : lane.m_lane)
+        way = static_cast<LaneWay>(ReadPrimitiveFromSource<uint8_t>(src));
+    }
+  }
+
+  if (info.m_hasFirst)
+    info.m_outgoingPoint = ReadPointDelta(src, base);
+  return true;
+}
+
+ftypes::HighwayClass TurnsInfoSection::GetOutgoingHighwayClass(TOsrmNodeId node) const
+{
+  uint8_t const * record = FindRecord(node);
+  if (record == nullptr || (record[0] & kHasFirstFlag) == 0)
+    return ftypes::HighwayClass::Error;
+
+  EdgeTurnInfo edge;
+  DecodeEdge(record[1], edge);
+  return edge.m_highwayClass;
+}
+
+uint8_t const * TurnsInfoSection::FindRecord(TOsrmNodeId node) const
+{
+  if (node >= GetNodesCount())
+    return nullptr;
+
+  ArrayByteSource src(m_records + m_blockOffsets[node / kBlockSize]);
+  for (uint32_t i = node % kBlockSize; i != 0; --i)
+    src.Advance(ReadVarUint<uint32_t>(src));
+  ReadVarUint<uint32_t>(src);
+  return src.PtrUC();
+}
+
+string TurnsInfoSection::GetName(uint32_t nameId) const
+{
+  ASSERT_LESS(nameId, m_header->m_namesCount, ());
+  return string(m_names + m_nameOffsets[nameId], m_names + m_nameOffsets[nameId + 1]);
+}
+}  // namespace turns
+}  // namespace routing
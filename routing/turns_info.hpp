@@ -0,0 +1,128 @@
+#pragma once
+
+#include "routing/osrm2feature_map.hpp"
+#include "routing/turns.hpp"
+
+#include "indexer/ftypes_matcher.hpp"
+
+#include "coding/file_container.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+namespace routing
+{
+namespace turns
+{
+/// Properties of the feature of an end segment of an OSRM node which the turns depend on.
+struct EdgeTurnInfo
+{
+  bool operator==(EdgeTurnInfo const & rhs) const;
+
+  ftypes::HighwayClass m_highwayClass = ftypes::HighwayClass::Undefined;
+  bool m_isRoundabout = false;
+  bool m_isLink = false;
+  string m_name;
+};
+
+string DebugPrint(EdgeTurnInfo const & info);
+
+/// Junction descriptors of an OSRM node, they're all GetTurnDirection() takes from the features.
+/// The first segment of the node describes the node as the outgoing edge of the junction
+/// before it, and the last segment describes the node as the ingoing edge of the junction
+/// after it. All the points are taken along the node from the junction.
+struct NodeTurnInfo
+{
+  bool operator==(NodeTurnInfo const & rhs) const;
+
+  /// False when the first or the last segment of the node has no geometry.
+  bool m_hasFirst = false;
+  bool m_hasLast = false;
+
+  /// The first segment, the node leaves the junction before it.
+  EdgeTurnInfo m_first;
+  m2::PointD m_outgoingPoint;
+
+  /// The last segment, the node comes to the junction after it.
+  EdgeTurnInfo m_last;
+  m2::PointD m_junctionPoint;
+  m2::PointD m_ingoingPoint;
+  m2::PointD m_ingoingPointOneSegment;
+  m2::PointD m_notSoClosePoint;
+  /// Count of all the road segments which join the junction.
+  uint32_t m_junctionSegmentsCount = 0;
+  /// Nodes which the route may follow after the node, sorted by the turn angles.
+  vector<TOsrmNodeId> m_possibleTurns;
+  /// Lanes of the last segment, none of them is recommended.
+  vector<SingleLaneInfo> m_lanes;
+};
+
+string DebugPrint(NodeTurnInfo const & info);
+
+/// TurnsInfoSection keeps NodeTurnInfo of all the OSRM nodes of a single mwm, it's computed
+/// by the generator, so the turns of the routes are made of the table lookups instead of
+/// the feature decoding and the geometry queries near the junctions.
+///
+/// Nodes are kept as varint records, which are grouped by kBlockSize nodes, the offsets of
+/// the blocks and the names table are fixed-width arrays aligned by 8 bytes. Points are
+/// quantized by POINT_COORD_BITS. The section is used in place, being mapped to memory from
+/// the routing file.
+class TurnsInfoSection
+{
+public:
+  static uint32_t constexpr kVersion = 0;
+  static uint32_t constexpr kBlockSize = 16;
+
+  /// Writes the section, the i-th info is the info of the i-th node.
+  static void Serialize(vector<NodeTurnInfo> const & infos, Writer & writer);
+
+  /// Maps the section of the container to memory.
+  /// @return False when the section is absent or malformed.
+  bool Map(FilesMappingContainer const & cont, string const & tag);
+  void Unmap();
+
+  /// Uses the section data kept by the caller. The data must be aligned by 8 bytes
+  /// and must outlive the section.
+  /// @return False when the data are malformed.
+  bool Attach(char const * data, uint64_t size);
+
+  inline bool IsEmpty() const { return m_header == nullptr || m_header->m_nodesCount == 0; }
+  inline uint32_t GetNodesCount() const { return m_header ? m_header->m_nodesCount : 0; }
+
+  /// @return False when the node is out of the section.
+  bool GetInfo(TOsrmNodeId node, NodeTurnInfo & info) const;
+
+  /// @return Highway class of the first segment of the node, it's the only field
+  /// of the candidate turns which the turn generation needs.
+  ftypes::HighwayClass GetOutgoingHighwayClass(TOsrmNodeId node) const;
+
+private:
+  struct Header
+  {
+    uint32_t m_version;
+    uint32_t m_nodesCount;
+    uint32_t m_namesCount;
+    uint32_t m_namesSize;
+    uint64_t m_recordsSize;
+  };
+
+  /// @return Pointer to the record of the node.
+  uint8_t const * FindRecord(TOsrmNodeId node) const;
+  string GetName(uint32_t nameId) const;
+
+  FilesMappingContainer::Handle m_handle;
+  Header const * m_header = nullptr;
+  // Names of the i-th name id are [m_nameOffsets[i], m_nameOffsets[i + 1]) of m_names.
+  uint32_t const * m_nameOffsets = nullptr;
+  char const * m_names = nullptr;
+  // Records of the i-th block start at m_blockOffsets[i] of m_records.
+  uint64_t const * m_blockOffsets = nullptr;
+  uint8_t const * m_records = nullptr;
+};
+}  // namespace turns
+}  // namespace routing
@@ -34,6 +34,7 @@ namespace sound
 {
 void GetTtsText::SetLocale(string const & locale)
 {
+  ClearCache();
   m_locale = locale;
   m_getCurLang.reset(new platform::GetTextById(platform::TextSource::TtsSound, locale));
   /// @todo Factor out file check from constructor and do not create m_getCurLang object in case of error.
@@ -42,6 +43,7 @@ void GetTtsText::SetLocale(string const & locale)
 
 void GetTtsText::ForTestingSetLocaleWithJson(string const & jsonBuffer)
 {
+  ClearCache();
   m_getCurLang.reset(new platform::GetTextById(jsonBuffer));
   ASSERT(m_getCurLang && m_getCurLang->IsValid(), ());
 }
@@ -49,15 +51,48 @@ void GetTtsText::ForTestingSetLocaleWithJson(string const & jsonBuffer)
 string GetTtsText::operator()(Notification const & notification) const
 {
   if (notification.m_distanceUnits == 0 && !notification.m_useThenInsteadOfDistance)
-    return GetTextById(GetDirectionTextId(notification));
+    return GetDirectionText(notification);
 
-  string const distStr = GetTextById(GetDistanceTextId(notification));
-  string const dirStr = GetTextById(GetDirectionTextId(notification));
+  string const & distStr = GetDistanceText(notification);
+  string const & dirStr = GetDirectionText(notification);
   if (distStr.empty() && dirStr.empty())
     return "";
   return distStr + " " + dirStr;
 }
 
+string const & GetTtsText::GetDirectionText(Notification const & notification) const
+{
+  size_t const index = static_cast<size_t>(notification.m_turnDir);
+  if (m_directionTexts.empty())
+    m_directionTexts.resize(static_cast<size_t>(TurnDirection::Count));
+  ASSERT_LESS(index, m_directionTexts.size(), ());
+
+  pair<bool, string> & text = m_directionTexts[index];
+  if (!text.first)
+  {
+    text.second = GetTextById(GetDirectionTextId(notification));
+    text.first = true;
+  }
+  return text.second;
+}
+
+string const & GetTtsText::GetDistanceText(Notification const & notification) const
+{
+  // "then" doesn't depend on the distance.
+  uint32_t const distance = notification.m_useThenInsteadOfDistance ? 0 : notification.m_distanceUnits;
+  auto const key = make_pair(static_cast<int>(notification.m_lengthUnits), distance);
+  auto it = m_distanceTexts.find(key);
+  if (it == m_distanceTexts.end())
+    it = m_distanceTexts.emplace(key, GetTextById(GetDistanceTextId(notification))).first;
+  return it->second;
+}
+
+void GetTtsText::ClearCache()
+{
+  m_directionTexts.clear();
+  m_distanceTexts.clear();
+}
+
 string GetTtsText::GetTextById(string const & textId) const
 {
   ASSERT(!textId.empty(), ());
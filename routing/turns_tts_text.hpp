@@ -2,9 +2,11 @@
 
 #include "platform/get_text_by_id.hpp"
 
+#include "std/map.hpp"
 #include "std/string.hpp"
 #include "std/unique_ptr.hpp"
-
+#include "std/utility.hpp"
+#include "std/vector.hpp"
 
 namespace routing
 {
@@ -18,6 +20,8 @@ struct Notification;
 /// by notification. To get this message use operator().
 /// If the message is not available for specified locale GetTtsText tries to find it in
 /// English locale.
+/// Texts are looked up once per locale and cached, so generating a notification for a route
+/// turn costs only a concatenation of the cached texts.
 class GetTtsText
 {
 public:
@@ -29,9 +33,16 @@ public:
 
 private:
   string GetTextById(string const & textId) const;
+  string const & GetDirectionText(Notification const & notification) const;
+  string const & GetDistanceText(Notification const & notification) const;
+  void ClearCache();
 
   unique_ptr<platform::GetTextById> m_getCurLang;
   string m_locale;
+
+  /// Texts of the current locale by turn direction and by sounded distance.
+  mutable vector<pair<bool, string>> m_directionTexts;
+  mutable map<pair<int, uint32_t>, string> m_distanceTexts;
 };
 
 /// Generates text message id about the distance of the notification. For example: In 300 meters.
@@ -10,39 +10,41 @@ namespace search
 
 using strings::UniChar;
 
+uint32_t const DefaultMatchCost::kEditCost;
+
 uint32_t DefaultMatchCost::Cost10(UniChar) const
 {
-  return 256;
+  return kEditCost;
 }
 
 uint32_t DefaultMatchCost::Cost01(UniChar) const
 {
-  return 256;
+  return kEditCost;
 }
 
 uint32_t DefaultMatchCost::Cost11(UniChar, UniChar) const
 {
-  return 256;
+  return kEditCost;
 }
 
 uint32_t DefaultMatchCost::Cost12(UniChar, UniChar const *) const
 {
-  return 512;
+  return 2 * kEditCost;
 }
 
 uint32_t DefaultMatchCost::Cost21(UniChar const *, UniChar) const
 {
-  return 512;
+  return 2 * kEditCost;
 }
 
 uint32_t DefaultMatchCost::Cost22(UniChar const *, UniChar const *) const
 {
-  return 512;
+  return 2 * kEditCost;
 }
 
 uint32_t DefaultMatchCost::SwapCost(UniChar, UniChar) const
 {
-  return 256;
+  return kEditCost;
 }
 
 }  // namespace search
@@ -1,7 +1,9 @@
 #pragma once
 #include "indexer/search_string_utils.hpp"
+#include "base/assert.hpp"
 #include "base/base.hpp"
 #include "base/buffer_vector.hpp"
+#include "std/algorithm.hpp"
 #include "std/queue.hpp"
 
 namespace search
@@ -36,6 +38,9 @@ void PushMatchCost(PriorityQueyeT & q, uint32_t maxCost, uint32_t a, uint32_t b,
 class DefaultMatchCost
 {
 public:
+  /// Cost of a single insertion, deletion, substitution or swap of adjacent chars.
+  static uint32_t const kEditCost = 256;
+
   uint32_t Cost10(strings::UniChar a) const;
   uint32_t Cost01(strings::UniChar b) const;
   uint32_t Cost11(strings::UniChar a, strings::UniChar b) const;
@@ -45,11 +50,14 @@ public:
   uint32_t SwapCost(strings::UniChar a1, strings::UniChar a2) const;
 };
 
+namespace impl
+{
+
+/// Finds the cheapest way to transform sA to sB (or to a prefix of sB
+/// when bPrefixMatch is true) with Dijkstra's search on edit operations.
 template <typename CharT, typename CostF>
-uint32_t StringMatchCost(CharT const * sA, uint32_t sizeA,
-                         CharT const * sB, uint32_t sizeB,
-                         CostF const & costF, uint32_t maxCost,
-                         bool bPrefixMatch = false)
+uint32_t QueueMatchCost(CharT const * sA, uint32_t sizeA, CharT const * sB, uint32_t sizeB,
+                        CostF const & costF, uint32_t maxCost, bool bPrefixMatch)
 {
   priority_queue<impl::MatchCostData, buffer_vector<impl::MatchCostData, 256> > q;
   q.push(impl::MatchCostData(0, 0, 0));
@@ -85,4 +93,91 @@ uint32_t StringMatchCost(CharT const * sA, uint32_t sizeA,
   return maxCost + 1;
 }
 
+/// Max length of sA for BitParallelMatchCost.
+uint32_t const kMaxBitParallelSize = 64;
+
+/// Computes StringMatchCost for DefaultMatchCost, i.e. the edit distance with
+/// swaps of adjacent chars, by Hyyro's bit-parallel version of Myers' algorithm.
+/// Doesn't allocate memory, sizeA should be in (0, kMaxBitParallelSize].
+template <typename CharT>
+uint32_t BitParallelMatchCost(CharT const * sA, uint32_t sizeA, CharT const * sB, uint32_t sizeB,
+                              uint32_t maxCost, bool bPrefixMatch)
+{
+  ASSERT_GREATER(sizeA, 0, ());
+  ASSERT_LESS_OR_EQUAL(sizeA, kMaxBitParallelSize, ());
+
+  // Open addressing table of chars from sA and their positions masks.
+  uint32_t const kTableSize = 2 * kMaxBitParallelSize;
+  CharT chars[kTableSize];
+  uint64_t masks[kTableSize] = {};
+  auto const findSlot = [&](CharT c) -> uint32_t
+  {
+    uint32_t i = static_cast<uint32_t>(c) % kTableSize;
+    while (masks[i] != 0 && chars[i] != c)
+      i = (i + 1) % kTableSize;
+    return i;
+  };
+  for (uint32_t i = 0; i < sizeA; ++i)
+  {
+    uint32_t const slot = findSlot(sA[i]);
+    chars[slot] = sA[i];
+    masks[slot] |= uint64_t(1) << i;
+  }
+
+  uint64_t const lastBit = uint64_t(1) << (sizeA - 1);
+  uint64_t vp = ~uint64_t(0);
+  uint64_t vn = 0;
+  uint64_t d0 = 0;
+  uint64_t pmPrev = 0;
+
+  // Distance between sA and the current prefix of sB.
+  uint32_t dist = sizeA;
+  uint32_t minDist = dist;
+  for (uint32_t j = 0; j < sizeB; ++j)
+  {
+    uint64_t const pm = masks[findSlot(sB[j])];
+    uint64_t const tr = (((~d0) & pm) << 1) & pmPrev;
+    d0 = (((pm & vp) + vp) ^ vp) | pm | vn | tr;
+    uint64_t const hp = vn | ~(d0 | vp);
+    uint64_t const hn = vp & d0;
+    if (hp & lastBit)
+      ++dist;
+    else if (hn & lastBit)
+      --dist;
+    minDist = min(minDist, dist);
+
+    uint64_t const x = (hp << 1) | 1;
+    vn = x & d0;
+    vp = (hn << 1) | ~(x | d0);
+    pmPrev = pm;
+  }
+
+  uint64_t const cost =
+      static_cast<uint64_t>(bPrefixMatch ? minDist : dist) * DefaultMatchCost::kEditCost;
+  return cost <= maxCost ? static_cast<uint32_t>(cost) : maxCost + 1;
+}
+
+}  // namespace search::impl
+
+template <typename CharT, typename CostF>
+uint32_t StringMatchCost(CharT const * sA, uint32_t sizeA,
+                         CharT const * sB, uint32_t sizeB,
+                         CostF const & costF, uint32_t maxCost,
+                         bool bPrefixMatch = false)
+{
+  return impl::QueueMatchCost(sA, sizeA, sB, sizeB, costF, maxCost, bPrefixMatch);
+}
+
+/// Short strings are matched with bit-parallel algorithm for default costs.
+template <typename CharT>
+uint32_t StringMatchCost(CharT const * sA, uint32_t sizeA,
+                         CharT const * sB, uint32_t sizeB,
+                         DefaultMatchCost const & costF, uint32_t maxCost,
+                         bool bPrefixMatch = false)
+{
+  if (sizeA == 0 || sizeA > impl::kMaxBitParallelSize)
+    return impl::QueueMatchCost(sA, sizeA, sB, sizeB, costF, maxCost, bPrefixMatch);
+  return impl::BitParallelMatchCost(sA, sizeA, sB, sizeB, maxCost, bPrefixMatch);
+}
+
 }  // namespace search
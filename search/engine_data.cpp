@@ -0,0 +1,51 @@
+#include "search/engine_data.hpp"
+
+#include "indexer/search_string_utils.hpp"
+
+#include "std/bind.hpp"
+#include "std/map.hpp"
+#include "std/vector.hpp"
+
+namespace search
+{
+namespace
+{
+
+class InitSuggestions
+{
+  using TSuggestMap = map<pair<strings::UniString, int8_t>, uint8_t>;
+  TSuggestMap m_suggests;
+
+public:
+  void operator() (CategoriesHolder::Category::Name const & name)
+  {
+    if (name.m_prefixLengthToSuggest != CategoriesHolder::Category::EMPTY_PREFIX_LENGTH)
+    {
+      strings::UniString const uniName = NormalizeAndSimplifyString(name.m_name);
+
+      uint8_t & score = m_suggests[make_pair(uniName, name.m_locale)];
+      if (score == 0 || score > name.m_prefixLengthToSuggest)
+        score = name.m_prefixLengthToSuggest;
+    }
+  }
+
+  void GetSuggests(vector<SuggestsIndex::Suggest> & cont) const
+  {
+    cont.reserve(m_suggests.size());
+    for (TSuggestMap::const_iterator i = m_suggests.begin(); i != m_suggests.end(); ++i)
+      cont.push_back(SuggestsIndex::Suggest(i->first.first, i->second, i->first.second));
+  }
+};
+
+}
+
+EngineData::EngineData(Reader * pCategoriesR, ModelReaderPtr polyR, ModelReaderPtr countryR)
+  : m_categories(pCategoriesR), m_infoGetter(polyR, countryR)
+{
+  InitSuggestions doInit;
+  m_categories.ForEachName(bind<void>(ref(doInit), _1));
+  vector<SuggestsIndex::Suggest> suggests;
+  doInit.GetSuggests(suggests);
+  m_suggests = SuggestsIndex(move(suggests));
+}
+}  // namespace search
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "search/suggests_index.hpp"
+
+#include "storage/country_info.hpp"
+
+#include "indexer/categories_holder.hpp"
+
+#include "coding/reader.hpp"
+
+namespace search
+{
+/// Read-only data of the search queries. It's safe to share it by the queries of several threads.
+class EngineData
+{
+public:
+  /// Takes ownership of pCategoriesR.
+  EngineData(Reader * pCategoriesR, ModelReaderPtr polyR, ModelReaderPtr countryR);
+
+  CategoriesHolder m_categories;
+  SuggestsIndex m_suggests;
+  storage::CountryInfoGetter m_infoGetter;
+};
+}  // namespace search
@@ -31,10 +31,12 @@ size_t CalcEqualLength(TSrcIter b, TSrcIter e, TCompIter bC, TCompIter eC)
   return count;
 }
 
+/// @param cellsMask The walk stops at the edges of the subtrees which are out of these cells.
 inline trie::DefaultIterator * MoveTrieIteratorToString(trie::DefaultIterator const & trieRoot,
                                                         strings::UniString const & queryS,
                                                         size_t & symbolsMatched,
-                                                        bool & bFullEdgeMatched)
+                                                        bool & bFullEdgeMatched,
+                                                        trie::TCellsMask cellsMask)
 {
   symbolsMatched = 0;
   bFullEdgeMatched = false;
@@ -62,6 +64,9 @@ inline trie::DefaultIterator * MoveTrieIteratorToString(trie::DefaultIterator co
 
       if ((count > 0) && (count == szEdge || szQuery == count + symbolsMatched))
       {
+        if ((pIter->m_edge[i].m_value & cellsMask) == 0)
+          return NULL;
+
         pIter.reset(pIter->GoToEdge(i));
 
         bFullEdgeMatched = (count == szEdge);
@@ -98,7 +103,8 @@ namespace
 
 template <typename F>
 void FullMatchInTrie(trie::DefaultIterator const & trieRoot, strings::UniChar const * rootPrefix,
-                     size_t rootPrefixSize, strings::UniString s, F & f)
+                     size_t rootPrefixSize, strings::UniString s, trie::TCellsMask cellsMask,
+                     F & f)
 {
   if (!CheckMatchString(rootPrefix, rootPrefixSize, s))
       return;
@@ -106,7 +112,7 @@ void FullMatchInTrie(trie::DefaultIterator const & trieRoot, strings::UniChar co
   size_t symbolsMatched = 0;
   bool bFullEdgeMatched;
   unique_ptr<trie::DefaultIterator> const pIter(
-      MoveTrieIteratorToString(trieRoot, s, symbolsMatched, bFullEdgeMatched));
+      MoveTrieIteratorToString(trieRoot, s, symbolsMatched, bFullEdgeMatched, cellsMask));
 
   if (!pIter || (!s.empty() && !bFullEdgeMatched) || symbolsMatched != s.size())
     return;
@@ -124,7 +130,8 @@ void FullMatchInTrie(trie::DefaultIterator const & trieRoot, strings::UniChar co
 
 template <typename F>
 void PrefixMatchInTrie(trie::DefaultIterator const & trieRoot, strings::UniChar const * rootPrefix,
-                       size_t rootPrefixSize, strings::UniString s, F & f)
+                       size_t rootPrefixSize, strings::UniString s, trie::TCellsMask cellsMask,
+                       F & f)
 {
   if (!CheckMatchString(rootPrefix, rootPrefixSize, s))
       return;
@@ -135,7 +142,7 @@ void PrefixMatchInTrie(trie::DefaultIterator const & trieRoot, strings::UniChar
     size_t symbolsMatched = 0;
     bool bFullEdgeMatched;
     trie::DefaultIterator * pRootIter =
-        MoveTrieIteratorToString(trieRoot, s, symbolsMatched, bFullEdgeMatched);
+        MoveTrieIteratorToString(trieRoot, s, symbolsMatched, bFullEdgeMatched, cellsMask);
 
     UNUSED_VALUE(symbolsMatched);
     UNUSED_VALUE(bFullEdgeMatched);
@@ -159,8 +166,12 @@ void PrefixMatchInTrie(trie::DefaultIterator const & trieRoot, strings::UniChar
     for (size_t i = 0; i < pIter->m_value.size(); ++i)
       f(pIter->m_value[i]);
 
+    // Subtrees out of the cells are not read at all.
     for (size_t i = 0; i < pIter->m_edge.size(); ++i)
-      trieQueue.push_back(pIter->GoToEdge(i));
+    {
+      if ((pIter->m_edge[i].m_value & cellsMask) != 0)
+        trieQueue.push_back(pIter->GoToEdge(i));
+    }
   }
 }
 
@@ -229,10 +240,13 @@ struct TrieRootPrefix
   trie::DefaultIterator const & m_root;
   strings::UniChar const * m_prefix;
   size_t m_prefixSize;
+  /// Only the features of the subtrees which have these cells are matched.
+  trie::TCellsMask m_cellsMask;
 
   TrieRootPrefix(trie::DefaultIterator const & root,
-                 trie::DefaultIterator::Edge::EdgeStrT const & edge)
-    : m_root(root)
+                 trie::DefaultIterator::Edge::EdgeStrT const & edge,
+                 trie::TCellsMask cellsMask = trie::kAllCells)
+    : m_root(root), m_cellsMask(cellsMask)
   {
     if (edge.size() == 1)
     {
@@ -289,7 +303,8 @@ void MatchTokenInTrie(SearchQueryParams::TSynonymsVector const & syns,
   for (auto const & syn : syns)
   {
     ASSERT(!syn.empty(), ());
-    impl::FullMatchInTrie(trieRoot.m_root, trieRoot.m_prefix, trieRoot.m_prefixSize, syn, toDo);
+    impl::FullMatchInTrie(trieRoot.m_root, trieRoot.m_prefix, trieRoot.m_prefixSize, syn,
+                          trieRoot.m_cellsMask, toDo);
   }
 }
 
@@ -303,7 +318,8 @@ void MatchTokenPrefixInTrie(SearchQueryParams::TSynonymsVector const & syns,
   for (auto const & syn : syns)
   {
     ASSERT(!syn.empty(), ());
-    impl::PrefixMatchInTrie(trieRoot.m_root, trieRoot.m_prefix, trieRoot.m_prefixSize, syn, toDo);
+    impl::PrefixMatchInTrie(trieRoot.m_root, trieRoot.m_prefix, trieRoot.m_prefixSize, syn,
+                            trieRoot.m_cellsMask, toDo);
   }
 }
 
@@ -341,7 +357,7 @@ void MatchTokensAndPrefixInTrie(vector<SearchQueryParams::TSynonymsVector> const
 // *NOTE* query prefix will be treated as a complete token in the function.
 template <typename THolder>
 bool MatchCategoriesInTrie(SearchQueryParams const & params, trie::DefaultIterator const & trieRoot,
-                           THolder && holder)
+                           trie::TCellsMask cellsMask, THolder && holder)
 {
   ASSERT_LESS(trieRoot.m_edge.size(), numeric_limits<uint32_t>::max(), ());
   uint32_t const numLangs = static_cast<uint32_t>(trieRoot.m_edge.size());
@@ -352,14 +368,15 @@ bool MatchCategoriesInTrie(SearchQueryParams const & params, trie::DefaultIterat
     if (edge[0] == search::kCategoriesLang)
     {
       unique_ptr<trie::DefaultIterator> const catRoot(trieRoot.GoToEdge(langIx));
-      MatchTokensInTrie(params.m_tokens, TrieRootPrefix(*catRoot, edge), holder);
+      TrieRootPrefix const catPrefix(*catRoot, edge, cellsMask);
+      MatchTokensInTrie(params.m_tokens, catPrefix, holder);
 
       // Last token's prefix is used as a complete token here, to
       // limit the number of features in the last bucket of a
       // holder. Probably, this is a false optimization.
       holder.Resize(params.m_tokens.size() + 1);
       holder.SwitchTo(params.m_tokens.size());
-      MatchTokenInTrie(params.m_prefixTokens, TrieRootPrefix(*catRoot, edge), holder);
+      MatchTokenInTrie(params.m_prefixTokens, catPrefix, holder);
       return true;
     }
   }
@@ -367,10 +384,10 @@ bool MatchCategoriesInTrie(SearchQueryParams const & params, trie::DefaultIterat
 }
 
 // Calls toDo with trie root prefix and language code on each language
-// allowed by params.
+// allowed by params, which has the features in the cells.
 template <typename ToDo>
 void ForEachLangPrefix(SearchQueryParams const & params, trie::DefaultIterator const & trieRoot,
-                       ToDo && toDo)
+                       ToDo && toDo, trie::TCellsMask cellsMask = trie::kAllCells)
 {
   ASSERT_LESS(trieRoot.m_edge.size(), numeric_limits<uint32_t>::max(), ());
   uint32_t const numLangs = static_cast<uint32_t>(trieRoot.m_edge.size());
@@ -379,10 +396,11 @@ void ForEachLangPrefix(SearchQueryParams const & params, trie::DefaultIterator c
     auto const & edge = trieRoot.m_edge[langIx].m_str;
     ASSERT_GREATER_OR_EQUAL(edge.size(), 1, ());
     int8_t const lang = static_cast<int8_t>(edge[0]);
-    if (edge[0] < search::kCategoriesLang && params.IsLangExist(lang))
+    if (edge[0] < search::kCategoriesLang && params.IsLangExist(lang) &&
+        (trieRoot.m_edge[langIx].m_value & cellsMask) != 0)
     {
       unique_ptr<trie::DefaultIterator> const langRoot(trieRoot.GoToEdge(langIx));
-      TrieRootPrefix langPrefix(*langRoot, edge);
+      TrieRootPrefix langPrefix(*langRoot, edge, cellsMask);
       toDo(langPrefix, lang);
     }
   }
@@ -390,12 +408,14 @@ void ForEachLangPrefix(SearchQueryParams const & params, trie::DefaultIterator c
 
 // Calls toDo for each feature whose description contains *ALL* tokens from a search query.
 // Each feature will be passed to toDo only once.
+// @param cellsMask Cells of the mwm out of which filter passes no features.
 template <typename TFilter, typename ToDo>
 void MatchFeaturesInTrie(SearchQueryParams const & params, trie::DefaultIterator const & trieRoot,
-                         TFilter const & filter, ToDo && toDo)
+                         TFilter const & filter, trie::TCellsMask cellsMask, ToDo && toDo)
 {
   TrieValuesHolder<TFilter> categoriesHolder(filter);
-  CHECK(MatchCategoriesInTrie(params, trieRoot, categoriesHolder), ("Can't find categories."));
+  CHECK(MatchCategoriesInTrie(params, trieRoot, cellsMask, categoriesHolder),
+        ("Can't find categories."));
 
   impl::OffsetIntersecter<TFilter> intersecter(filter);
   for (size_t i = 0; i < params.m_tokens.size(); ++i)
@@ -403,7 +423,7 @@ void MatchFeaturesInTrie(SearchQueryParams const & params, trie::DefaultIterator
     ForEachLangPrefix(params, trieRoot, [&](TrieRootPrefix & langRoot, int8_t lang)
     {
       MatchTokenInTrie(params.m_tokens[i], langRoot, intersecter);
-    });
+    }, cellsMask);
     categoriesHolder.ForEachValue(i, intersecter);
     intersecter.NextStep();
   }
@@ -413,7 +433,7 @@ void MatchFeaturesInTrie(SearchQueryParams const & params, trie::DefaultIterator
     ForEachLangPrefix(params, trieRoot, [&](TrieRootPrefix & langRoot, int8_t /* lang */)
     {
       MatchTokenPrefixInTrie(params.m_prefixTokens, langRoot, intersecter);
-    });
+    }, cellsMask);
     categoriesHolder.ForEachValue(params.m_tokens.size(), intersecter);
     intersecter.NextStep();
   }
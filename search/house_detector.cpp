@@ -252,7 +252,7 @@ void FeatureLoader::Free()
 }
 
 template <class ToDo>
-void FeatureLoader::ForEachInRect(m2::RectD const & rect, ToDo toDo)
+void FeatureLoader::ForEachInRect(m2::RectD const & rect, ToDo toDo) const
 {
   m_pIndex->ForEachInRect(toDo, rect, scales::GetUpperScale());
 }
@@ -311,7 +311,7 @@ void Street::SortHousesProjection()
 }
 
 HouseDetector::HouseDetector(Index const * pIndex)
-  : m_loader(pIndex), m_streetNum(0)
+  : m_loader(pIndex), m_streetNum(0), m_cacheBytes(0)
 {
   // default value for conversions
   SetMetres2Mercator(360.0 / 40.0E06);
@@ -425,9 +425,9 @@ int HouseDetector::LoadStreets(vector<FeatureID> const & ids)
 
     if (count < min(ids.size(), m_id2st.size()))
     {
-      LOG(LDEBUG, ("Clear HouseDetector cache: "
+      LOG(LDEBUG, ("Cache HouseDetector state: "
                    "Common =", count, "Cache =", m_id2st.size(), "Input =", ids.size()));
-      ClearCaches();
+      CacheState();
     }
     else if (m_id2st.size() > ids.size() * 1.2)
     {
@@ -436,21 +436,27 @@ int HouseDetector::LoadStreets(vector<FeatureID> const & ids)
     }
   }
 
+  if (m_id2st.empty() && RestoreState(ids))
+    LOG(LDEBUG, ("Restored HouseDetector state", m_id2st.size()));
+  m_ids = ids;
+
   // Load streets.
-  int count = 0;
-  for (size_t i = 0; i < ids.size(); ++i)
+  vector<FeatureID> toLoad;
+  for (FeatureID const & id : ids)
   {
-    if (m_id2st.find(ids[i]) != m_id2st.end())
-      continue;
+    if (m_id2st.find(id) == m_id2st.end())
+      toLoad.push_back(id);
+  }
 
-    FeatureType f;
-    m_loader.Load(ids[i], f);
+  int count = 0;
+  m_loader.ForEach(toLoad, [&](FeatureType const & f)
+  {
     if (f.GetFeatureType() == feature::GEOM_LINE)
     {
       // Use default name as a primary compare key for merging.
       string name;
       if (!f.GetName(FeatureType::DEFAULT_LANG, name))
-        continue;
+        return;
       ASSERT(!name.empty(), ());
 
       ++count;
@@ -467,11 +473,11 @@ int HouseDetector::LoadStreets(vector<FeatureID> const & ids)
         SetMetres2Mercator(p1.Length(p2) / GetDistanceMeters(p1, p2));
       }
 
-      m_id2st[ids[i]] = st;
+      m_id2st[f.GetID()] = st;
       m_end2st.push_back(make_pair(st->m_points.front(), st));
       m_end2st.push_back(make_pair(st->m_points.back(), st));
     }
-  }
+  });
 
   m_loader.Free();
   return count;
@@ -721,52 +727,44 @@ HouseProjection const * MergedStreet::GetHousePivot(bool isOdd, bool & sign) con
   return 0;
 }
 
-template <class ProjectionCalcT>
-void HouseDetector::ReadHouse(FeatureType const & f, Street * st, ProjectionCalcT & calc)
+void HouseDetector::ReadHouses(Street const * st, double offsetMeters,
+                               vector<HouseCandidate> & houses, double & length) const
 {
-  string const houseNumber = f.GetHouseNumber();
+  //offsetMeters = max(HN_MIN_READ_OFFSET_M, min(GetApprLengthMeters(st->m_number) / 2, offsetMeters));
 
-  /// @todo After new data generation we can skip IsHouseNumber check here.
-  if (ftypes::IsBuildingChecker::Instance()(f) && feature::IsHouseNumber(houseNumber))
+  ProjectionCalcToStreet calcker(st, offsetMeters);
+  m_loader.ForEachInRect(st->GetLimitRect(offsetMeters), [&](FeatureType const & f)
   {
-    HouseMapT::iterator const it = m_id2house.find(f.GetID());
-    bool const isNew = it == m_id2house.end();
-
-    m2::PointD const pt = isNew ? f.GetLimitRect(FeatureType::BEST_GEOMETRY).Center() : it->second->GetPosition();
+    string const houseNumber = f.GetHouseNumber();
 
-    HouseProjection pr;
-    if (calc.GetProjection(pt, pr))
+    /// @todo After new data generation we can skip IsHouseNumber check here.
+    if (ftypes::IsBuildingChecker::Instance()(f) && feature::IsHouseNumber(houseNumber))
     {
-      House * p;
-      if (isNew)
-      {
-        p = new House(houseNumber, pt);
-        m_id2house[f.GetID()] = p;
-      }
-      else
+      HouseCandidate h;
+      h.m_point = f.GetLimitRect(FeatureType::BEST_GEOMETRY).Center();
+      if (calcker.GetProjection(h.m_point, h.m_proj))
       {
-        p = it->second;
-        ASSERT(p != 0, ());
+        h.m_id = f.GetID();
+        h.m_number = houseNumber;
+        houses.push_back(h);
       }
-
-      pr.m_house = p;
-      st->m_houses.push_back(pr);
     }
-  }
+  });
+
+  length = calcker.GetLength();
 }
 
-void HouseDetector::ReadHouses(Street * st, double offsetMeters)
+void HouseDetector::AddHouses(Street * st, vector<HouseCandidate> const & houses)
 {
-  if (st->m_housesReaded)
-    return;
-
-  //offsetMeters = max(HN_MIN_READ_OFFSET_M, min(GetApprLengthMeters(st->m_number) / 2, offsetMeters));
-
-  ProjectionCalcToStreet calcker(st, offsetMeters);
-  m_loader.ForEachInRect(st->GetLimitRect(offsetMeters),
-                         bind(&HouseDetector::ReadHouse<ProjectionCalcToStreet>, this, _1, st, ref(calcker)));
+  for (HouseCandidate const & h : houses)
+  {
+    House *& p = m_id2house[h.m_id];
+    if (p == 0)
+      p = new House(h.m_number, h.m_point);
 
-  st->m_length = calcker.GetLength();
+    st->m_houses.push_back(h.m_proj);
+    st->m_houses.back().m_house = p;
+  }
   st->SortHousesProjection();
 }
 
@@ -774,8 +772,28 @@ void HouseDetector::ReadAllHouses(double offsetMeters)
 {
   m_houseOffsetM = offsetMeters;
 
+  vector<Street *> streets;
   for (StreetMapT::iterator it = m_id2st.begin(); it != m_id2st.end(); ++it)
-    ReadHouses(it->second, offsetMeters);
+  {
+    if (!it->second->m_housesReaded)
+      streets.push_back(it->second);
+  }
+
+  // Houses are projected to the streets in parallel, but they are shared by
+  // the streets, so they are added on this thread in the streets order.
+  vector<vector<HouseCandidate>> houses(streets.size());
+  vector<double> lengths(streets.size());
+  vector<function<void()>> tasks;
+  tasks.reserve(streets.size());
+  for (size_t i = 0; i < streets.size(); ++i)
+    tasks.push_back([&, i]() { ReadHouses(streets[i], offsetMeters, houses[i], lengths[i]); });
+  m_loader.RunTasks(tasks);
+
+  for (size_t i = 0; i < streets.size(); ++i)
+  {
+    streets[i]->m_length = lengths[i];
+    AddHouses(streets[i], houses[i]);
+  }
 
   for (size_t i = 0; i < m_streets.size(); ++i)
   {
@@ -784,7 +802,83 @@ void HouseDetector::ReadAllHouses(double offsetMeters)
   }
 }
 
-void HouseDetector::ClearCaches()
+HouseDetector::CachedState::~CachedState()
+{
+  for (StreetMapT::iterator it = m_id2st.begin(); it != m_id2st.end(); ++it)
+    delete it->second;
+  for (HouseMapT::iterator it = m_id2house.begin(); it != m_id2house.end(); ++it)
+    delete it->second;
+}
+
+void HouseDetector::SwapState(CachedState & state)
+{
+  m_ids.swap(state.m_ids);
+  m_id2st.swap(state.m_id2st);
+  m_id2house.swap(state.m_id2house);
+  m_end2st.swap(state.m_end2st);
+  m_streets.swap(state.m_streets);
+  std::swap(m_metres2Mercator, state.m_metres2Mercator);
+  std::swap(m_streetNum, state.m_streetNum);
+}
+
+size_t HouseDetector::GetStateBytes() const
+{
+  size_t bytes = m_ids.size() * sizeof(FeatureID) + m_end2st.size() * sizeof(m_end2st[0]) +
+                 m_streets.size() * sizeof(MergedStreet);
+  for (StreetMapT::const_iterator it = m_id2st.begin(); it != m_id2st.end(); ++it)
+  {
+    Street const * st = it->second;
+    bytes += sizeof(*it) + sizeof(Street) + st->GetName().size() + st->GetDbgName().size() +
+             st->m_points.size() * sizeof(m2::PointD) +
+             st->m_houses.size() * sizeof(HouseProjection);
+  }
+  for (HouseMapT::const_iterator it = m_id2house.begin(); it != m_id2house.end(); ++it)
+    bytes += sizeof(*it) + sizeof(House) + it->second->GetNumber().size();
+  return bytes;
+}
+
+void HouseDetector::CacheState()
+{
+  if (m_id2st.empty())
+  {
+    ClearState();
+    return;
+  }
+
+  size_t const bytes = GetStateBytes();
+  m_cache.push_front(CachedState());
+  SwapState(m_cache.front());
+  // Keep the last conversion factor for the new streets, as it was before.
+  m_metres2Mercator = m_cache.front().m_metres2Mercator;
+  m_cache.front().m_bytes = bytes;
+  m_cacheBytes += bytes;
+  ClearState();
+
+  while (m_cacheBytes > kMaxCacheBytes)
+  {
+    m_cacheBytes -= m_cache.back().m_bytes;
+    m_cache.pop_back();
+  }
+}
+
+bool HouseDetector::RestoreState(vector<FeatureID> const & ids)
+{
+  ASSERT(m_id2st.empty(), ());
+  for (list<CachedState>::iterator it = m_cache.begin(); it != m_cache.end(); ++it)
+  {
+    if (it->m_ids == ids)
+    {
+      ClearState();
+      SwapState(*it);
+      m_cacheBytes -= it->m_bytes;
+      m_cache.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+void HouseDetector::ClearState()
 {
   for (StreetMapT::iterator it = m_id2st.begin(); it != m_id2st.end(); ++it)
     delete it->second;
@@ -795,11 +889,19 @@ void HouseDetector::ClearCaches()
 
   m_streetNum = 0;
 
+  m_ids.clear();
   m_id2house.clear();
   m_end2st.clear();
   m_streets.clear();
 }
 
+void HouseDetector::ClearCaches()
+{
+  ClearState();
+  m_cache.clear();
+  m_cacheBytes = 0;
+}
+
 namespace
 {
 
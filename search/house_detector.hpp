@@ -7,6 +7,8 @@
 
 #include "geometry/point2d.hpp"
 
+#include "std/function.hpp"
+#include "std/list.hpp"
 #include "std/string.hpp"
 #include "std/queue.hpp"
 
@@ -31,7 +33,16 @@ public:
   void Load(FeatureID const & id, FeatureType & f);
   void Free();
 
-  template <class ToDo> void ForEachInRect(m2::RectD const & rect, ToDo toDo);
+  /// Reads features in storage order, ids must be sorted.
+  template <class ToDo> void ForEach(vector<FeatureID> const & ids, ToDo toDo)
+  {
+    m_pIndex->ReadFeatures(toDo, ids);
+  }
+
+  template <class ToDo> void ForEachInRect(m2::RectD const & rect, ToDo toDo) const;
+
+  /// Runs tasks on the index query threads, see Index::RunQueryTasks.
+  void RunTasks(vector<function<void()>> const & tasks) const { m_pIndex->RunQueryTasks(tasks); }
 };
 
 struct ParsedNumber
@@ -238,13 +249,55 @@ class HouseDetector
   int m_streetNum;
   double m_houseOffsetM;
 
+  /// Ids of the streets which were asked for the current state.
+  vector<FeatureID> m_ids;
+
+  /// Streets, houses and merging results for the ids of the previous queries.
+  /// They are owned by the cache and deleted, when the state is evicted.
+  struct CachedState
+  {
+    CachedState() : m_metres2Mercator(0.0), m_streetNum(0), m_bytes(0) {}
+    ~CachedState();
+
+    vector<FeatureID> m_ids;
+    StreetMapT m_id2st;
+    HouseMapT m_id2house;
+    vector<pair<m2::PointD, Street *> > m_end2st;
+    vector<MergedStreet> m_streets;
+    double m_metres2Mercator;
+    int m_streetNum;
+    /// Approximate memory used by the state.
+    size_t m_bytes;
+  };
+  /// The most recently used states go first.
+  list<CachedState> m_cache;
+  size_t m_cacheBytes;
+
+  void SwapState(CachedState & state);
+  /// Moves the current state to the cache and evicts the least recently used states
+  /// when the cache is out of memory.
+  void CacheState();
+  /// Takes the state for |ids| from the cache, the current state must be empty.
+  bool RestoreState(vector<FeatureID> const & ids);
+  size_t GetStateBytes() const;
+  void ClearState();
+
   typedef pair<Street *, bool> StreetPtr;
   StreetPtr FindConnection(Street const * st, bool beg) const;
   void MergeStreets(Street * st);
 
-  template <class ProjectionCalcT>
-  void ReadHouse(FeatureType const & f, Street * st, ProjectionCalcT & calc);
-  void ReadHouses(Street * st, double offsetMeters);
+  /// House of a street, which is found on a query thread.
+  struct HouseCandidate
+  {
+    FeatureID m_id;
+    string m_number;
+    m2::PointD m_point;
+    HouseProjection m_proj;
+  };
+  /// Is called on the query threads, so it doesn't change the detector.
+  void ReadHouses(Street const * st, double offsetMeters, vector<HouseCandidate> & houses,
+                  double & length) const;
+  void AddHouses(Street * st, vector<HouseCandidate> const & houses);
 
   void SetMetres2Mercator(double factor);
 
@@ -263,6 +316,9 @@ public:
 
   void GetHouseForName(string const & houseNumber, vector<HouseResult> & res);
 
+  /// Memory limit of the states for the previous queries.
+  static size_t const kMaxCacheBytes = 8 * 1024 * 1024;
+  /// Clears the current state and all the cached ones.
   void ClearCaches();
   void ClearUnusedStreets(vector<FeatureID> const & ids);
 };
@@ -32,20 +32,18 @@ double const DIST_SAME_STREET = 5000.0;
 
 void ProcessMetadata(FeatureType const & ft, Result::Metadata & meta)
 {
-  ft.ParseMetadata();
-  feature::Metadata const & src = ft.GetMetadata();
-
-  meta.m_cuisine = src.Get(feature::Metadata::FMD_CUISINE);
+  // Results need a few of the fields, so the whole metadata isn't decoded.
+  meta.m_cuisine = ft.GetMetadataField(feature::Metadata::FMD_CUISINE);
 
 #ifndef OMIM_OS_LINUX
   // Lib opening_hours is not built for Linux since stdlib doesn't have required functions.
-  string const openHours = src.Get(feature::Metadata::FMD_OPEN_HOURS);
+  string const openHours = ft.GetMetadataField(feature::Metadata::FMD_OPEN_HOURS);
   if (!openHours.empty())
     meta.m_isClosed = OSMTimeRange(openHours)(time(nullptr)).IsClosed();
 #endif
 
   meta.m_stars = 0;
-  (void) strings::to_int(src.Get(feature::Metadata::FMD_STARS), meta.m_stars);
+  (void) strings::to_int(ft.GetMetadataField(feature::Metadata::FMD_STARS), meta.m_stars);
   meta.m_stars = my::clamp(meta.m_stars, 0, 5);
 }
 
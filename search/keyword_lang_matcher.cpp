@@ -64,6 +64,12 @@ KeywordLangMatcher::ScoreT KeywordLangMatcher::Score(int8_t lang, string const &
   return ScoreT(m_keywordMatcher.Score(name), GetLangScore(lang));
 }
 
+KeywordLangMatcher::ScoreT KeywordLangMatcher::Score(int8_t lang, string const & name,
+                                                     StringT & buffer) const
+{
+  return ScoreT(m_keywordMatcher.Score(name, buffer), GetLangScore(lang));
+}
+
 KeywordLangMatcher::ScoreT KeywordLangMatcher::Score(int8_t lang, StringT const & name) const
 {
   return ScoreT(m_keywordMatcher.Score(name), GetLangScore(lang));
@@ -75,6 +81,27 @@ KeywordLangMatcher::ScoreT KeywordLangMatcher::Score(int8_t lang,
   return ScoreT(m_keywordMatcher.Score(tokens, count), GetLangScore(lang));
 }
 
+size_t KeywordLangMatcher::Score(int8_t const * langs, StringT const * names, size_t count,
+                                 ScoreT * scores) const
+{
+  size_t best = count;
+  // Names of a candidate are mostly in the same few languages.
+  int8_t prevLang = 0;
+  int prevLangScore = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (i == 0 || langs[i] != prevLang)
+    {
+      prevLang = langs[i];
+      prevLangScore = GetLangScore(prevLang);
+    }
+    scores[i] = ScoreT(m_keywordMatcher.Score(names[i]), prevLangScore);
+    if (best == count || scores[best] < scores[i])
+      best = i;
+  }
+  return best;
+}
+
 string DebugPrint(KeywordLangMatcher::ScoreT const & score)
 {
   ostringstream ss;
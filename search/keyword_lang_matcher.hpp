@@ -43,10 +43,15 @@ public:
   /// @return Score of the name (greater is better).
   //@{
   ScoreT Score(int8_t lang, string const & name) const;
+  ScoreT Score(int8_t lang, string const & name, StringT & buffer) const;
   ScoreT Score(int8_t lang, StringT const & name) const;
   ScoreT Score(int8_t lang, StringT const * tokens, size_t count) const;
   //@}
 
+  /// Scores the normalized names of the candidates, scores[i] is the score of names[i].
+  /// @return Index of the best name, or count when there are no names.
+  size_t Score(int8_t const * langs, StringT const * names, size_t count, ScoreT * scores) const;
+
 private:
   int GetLangScore(int8_t lang) const;
 
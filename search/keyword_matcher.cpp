@@ -10,6 +10,17 @@
 namespace search
 {
 
+namespace
+{
+uint64_t const kHashBasis = 14695981039346656037ULL;
+uint64_t const kHashPrime = 1099511628211ULL;
+
+inline uint64_t AddToHash(uint64_t hash, strings::UniChar c)
+{
+  return (hash ^ c) * kHashPrime;
+}
+}  // namespace
+
 KeywordMatcher::KeywordMatcher()
 {
   Clear();
@@ -18,26 +29,87 @@ KeywordMatcher::KeywordMatcher()
 void KeywordMatcher::Clear()
 {
   m_keywords.clear();
+  m_keywordHashes.clear();
   m_prefix.clear();
+  m_prefixHash = GetHash(nullptr, 0);
+  m_firstCharsMask = 0;
 }
 
 void KeywordMatcher::SetKeywords(StringT const * keywords, size_t count, StringT const & prefix)
 {
   m_keywords.assign(keywords, keywords + count);
   m_prefix = prefix;
+
+  m_keywordHashes.clear();
+  m_firstCharsMask = 0;
+  for (StringT const & keyword : m_keywords)
+  {
+    m_keywordHashes.push_back(GetHash(keyword.data(), keyword.size()));
+    if (!keyword.empty())
+      m_firstCharsMask |= GetCharMask(keyword[0]);
+  }
+  m_prefixHash = GetHash(m_prefix.data(), m_prefix.size());
+  if (!m_prefix.empty())
+    m_firstCharsMask |= GetCharMask(m_prefix[0]);
+}
+
+// static
+uint64_t KeywordMatcher::GetHash(strings::UniChar const * chars, size_t count)
+{
+  uint64_t hash = kHashBasis;
+  for (size_t i = 0; i < count; ++i)
+    hash = AddToHash(hash, chars[i]);
+  return hash;
 }
 
 KeywordMatcher::ScoreT KeywordMatcher::Score(string const & name) const
 {
-  return Score(NormalizeAndSimplifyString(name));
+  StringT buffer;
+  return Score(name, buffer);
+}
+
+KeywordMatcher::ScoreT KeywordMatcher::Score(string const & name, StringT & buffer) const
+{
+  NormalizeAndSimplifyString(name, buffer);
+  return Score(buffer);
 }
 
 KeywordMatcher::ScoreT KeywordMatcher::Score(StringT const & name) const
 {
-  buffer_vector<StringT, MAX_TOKENS> tokens;
-  SplitUniString(name, MakeBackInsertFunctor(tokens), Delimiters());
+  Delimiters const delimiters;
+  size_t const prefixSize = m_prefix.size();
 
   // Some names can have too many tokens. Trim them.
+  buffer_vector<Token, MAX_TOKENS> tokens;
+  size_t i = 0;
+  while (i < name.size() && tokens.size() < MAX_TOKENS)
+  {
+    if (delimiters(name[i]))
+    {
+      ++i;
+      continue;
+    }
+
+    Token token;
+    token.m_chars = name.data() + i;
+    uint64_t hash = kHashBasis;
+    uint64_t prefixHash = 0;
+    size_t const begin = i;
+    for (; i < name.size() && !delimiters(name[i]); ++i)
+    {
+      if (i - begin == prefixSize)
+        prefixHash = hash;
+      hash = AddToHash(hash, name[i]);
+    }
+    token.m_size = static_cast<uint32_t>(i - begin);
+    if (token.m_size == prefixSize)
+      prefixHash = hash;
+    token.m_hash = hash;
+    token.m_prefixMatched = prefixSize != 0 && token.m_size >= prefixSize &&
+                            prefixHash == m_prefixHash && IsPrefixMatched(token);
+    tokens.push_back(token);
+  }
+
   return Score(tokens.data(), tokens.size());
 }
 
@@ -45,17 +117,55 @@ KeywordMatcher::ScoreT KeywordMatcher::Score(StringT const * tokens, size_t coun
 {
   count = min(count, size_t(MAX_TOKENS));
 
-  vector<bool> isQueryTokenMatched(m_keywords.size());
-  vector<bool> isNameTokenMatched(count);
+  buffer_vector<Token, MAX_TOKENS> infos(count);
+  for (size_t j = 0; j < count; ++j)
+  {
+    Token & info = infos[j];
+    info.m_chars = tokens[j].data();
+    info.m_size = static_cast<uint32_t>(tokens[j].size());
+    info.m_hash = GetHash(info.m_chars, info.m_size);
+    info.m_prefixMatched = !m_prefix.empty() && IsPrefixMatched(info);
+  }
+  return Score(infos.data(), infos.size());
+}
+
+bool KeywordMatcher::IsKeywordMatched(size_t i, Token const & token) const
+{
+  StringT const & keyword = m_keywords[i];
+  return m_keywordHashes[i] == token.m_hash && keyword.size() == token.m_size &&
+         equal(keyword.begin(), keyword.end(), token.m_chars);
+}
+
+bool KeywordMatcher::IsPrefixMatched(Token const & token) const
+{
+  return m_prefix.size() <= token.m_size &&
+         equal(m_prefix.begin(), m_prefix.end(), token.m_chars);
+}
+
+KeywordMatcher::ScoreT KeywordMatcher::Score(Token const * tokens, size_t count) const
+{
+  ASSERT_LESS_OR_EQUAL(count, MAX_TOKENS, ());
+
+  buffer_vector<uint8_t, MAX_TOKENS> isQueryTokenMatched(m_keywords.size(), 0);
+  uint32_t isNameTokenMatched = 0;
   uint32_t sumTokenMatchDistance = 0;
   int8_t prevTokenMatchDistance = 0;
   bool bPrefixMatched = true;
 
+  // Tokens which start with the chars of none of the keywords and the prefix are skipped.
+  uint32_t candidates = 0;
+  for (size_t j = 0; j < count; ++j)
+  {
+    if (tokens[j].m_size != 0 && (GetCharMask(tokens[j].m_chars[0]) & m_firstCharsMask) != 0)
+      candidates |= (1U << j);
+  }
+
   for (int i = 0; i < m_keywords.size(); ++i)
     for (int j = 0; j < count && !isQueryTokenMatched[i]; ++j)
-      if (!isNameTokenMatched[j] && m_keywords[i] == tokens[j])
+      if ((candidates & ~isNameTokenMatched & (1U << j)) && IsKeywordMatched(i, tokens[j]))
       {
-        isQueryTokenMatched[i] = isNameTokenMatched[j] = true;
+        isQueryTokenMatched[i] = true;
+        isNameTokenMatched |= (1U << j);
         int8_t const tokenMatchDistance = i - j;
         sumTokenMatchDistance += abs(tokenMatchDistance - prevTokenMatchDistance);
         prevTokenMatchDistance = tokenMatchDistance;
@@ -65,10 +175,10 @@ KeywordMatcher::ScoreT KeywordMatcher::Score(StringT const * tokens, size_t coun
   {
     bPrefixMatched = false;
     for (int j = 0; j < count && !bPrefixMatched; ++j)
-      if (!isNameTokenMatched[j] &&
-          StartsWith(tokens[j].begin(), tokens[j].end(), m_prefix.begin(), m_prefix.end()))
+      if (!(isNameTokenMatched & (1U << j)) && tokens[j].m_prefixMatched)
       {
-        isNameTokenMatched[j] = bPrefixMatched = true;
+        isNameTokenMatched |= (1U << j);
+        bPrefixMatched = true;
         int8_t const tokenMatchDistance = int(m_keywords.size()) - j;
         sumTokenMatchDistance += abs(tokenMatchDistance - prevTokenMatchDistance);
       }
@@ -88,9 +198,9 @@ KeywordMatcher::ScoreT KeywordMatcher::Score(StringT const * tokens, size_t coun
   score.m_nameTokensLength = 0;
   for (size_t i = 0; i < count; ++i)
   {
-    if (isNameTokenMatched[i])
+    if (isNameTokenMatched & (1U << i))
       score.m_nameTokensMatched |= (1 << (MAX_TOKENS-1 - i));
-    score.m_nameTokensLength += tokens[i].size();
+    score.m_nameTokensLength += tokens[i].m_size;
   }
 
   score.m_sumTokenMatchDistance = sumTokenMatchDistance;
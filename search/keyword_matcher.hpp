@@ -3,6 +3,7 @@
 
 #include "base/string_utils.hpp"
 
+#include "std/cstdint.hpp"
 #include "std/string.hpp"
 #include "std/vector.hpp"
 
@@ -45,13 +46,40 @@ public:
   /// @return Score of the name (greater is better).
   //@{
   ScoreT Score(string const & name) const;
+  /// @param buffer Is used for the normalized name, so the same one may be passed for the names
+  /// of all the candidates.
+  ScoreT Score(string const & name, StringT & buffer) const;
+  /// Tokens of the name are matched in one pass over its chars, they are not copied.
   ScoreT Score(StringT const & name) const;
   ScoreT Score(StringT const * tokens, size_t count) const;
   //@}
 
+  /// Hash of the chars, which is the same for the keywords and the tokens of the names.
+  static uint64_t GetHash(strings::UniChar const * chars, size_t count);
+
 private:
+  /// Token of the name, which refers to its chars.
+  struct Token
+  {
+    strings::UniChar const * m_chars;
+    uint32_t m_size;
+    uint64_t m_hash;
+    bool m_prefixMatched;
+  };
+
+  /// Two chars which differ in the low 6 bits are different, so the tokens whose first chars
+  /// are not in m_firstCharsMask match neither the keywords nor the prefix.
+  static uint64_t GetCharMask(strings::UniChar c) { return uint64_t(1) << (c & 63); }
+
+  bool IsKeywordMatched(size_t i, Token const & token) const;
+  bool IsPrefixMatched(Token const & token) const;
+  ScoreT Score(Token const * tokens, size_t count) const;
+
   vector<StringT> m_keywords;
+  vector<uint64_t> m_keywordHashes;
   StringT m_prefix;
+  uint64_t m_prefixHash;
+  uint64_t m_firstCharsMask;
 };
 
 }  // namespace search
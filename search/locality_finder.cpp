@@ -3,6 +3,8 @@
 #include "indexer/ftypes_matcher.hpp"
 #include "indexer/features_vector.hpp"
 
+#include "defines.hpp"
+
 
 namespace search
 {
@@ -12,7 +14,7 @@ double const MAX_RADIUS_CITY = 30000.0;
 class DoLoader
 {
 public:
-  DoLoader(LocalityFinder const & finder, FeaturesVector const & loader, LocalityFinder::Cache & cache)
+  DoLoader(LocalityFinder const & finder, FeaturesVector::Cursor & loader, LocalityFinder::Cache & cache)
     : m_finder(finder), m_loader(loader), m_cache(cache)
   {
   }
@@ -60,7 +62,7 @@ public:
 
 private:
   LocalityFinder const & m_finder;
-  FeaturesVector const & m_loader;
+  FeaturesVector::Cursor & m_loader;
   LocalityFinder::Cache & m_cache;
 };
 
@@ -99,8 +101,79 @@ LocalityItem::LocalityItem(m2::RectD const & rect, uint32_t population, ID id, s
 }
 
 LocalityFinder::LocalityFinder(Index const * pIndex)
-  : m_pIndex(pIndex), m_lang(0)
+  : m_pIndex(pIndex), m_isIndexLoaded(false), m_lang(0)
+{
+}
+
+bool LocalityFinder::LoadIndex() const
+{
+  // World mwm could be deregistered or updated.
+  if (m_isIndexLoaded && (m_index.IsEmpty() || m_worldId.IsAlive()))
+    return !m_index.IsEmpty();
+
+  m_isIndexLoaded = true;
+  m_worldId.Reset();
+  m_index.Clear();
+  m_names.clear();
+
+  vector<shared_ptr<MwmInfo>> mwmsInfo;
+  m_pIndex->GetMwmsInfo(mwmsInfo);
+  for (shared_ptr<MwmInfo> & info : mwmsInfo)
+  {
+    MwmSet::MwmId mwmId(info);
+    Index::MwmHandle const mwmHandle = m_pIndex->GetMwmHandleById(mwmId);
+    MwmValue const * pMwm = mwmHandle.GetValue<MwmValue>();
+    if (pMwm && pMwm->GetHeader().GetType() == feature::DataHeader::world)
+    {
+      m_worldId = mwmId;
+      if (pMwm->m_cont.IsExist(LOCALITY_INDEX_FILE_TAG))
+        m_index.Load(pMwm->m_cont.GetReader(LOCALITY_INDEX_FILE_TAG));
+      break;
+    }
+  }
+
+  return !m_index.IsEmpty();
+}
+
+string const & LocalityFinder::GetIndexedLocalityName(uint32_t locality) const
 {
+  auto const it = m_names.find(locality);
+  if (it != m_names.end())
+    return it->second;
+
+  string & name = m_names[locality];
+  Index::MwmHandle const mwmHandle = m_pIndex->GetMwmHandleById(m_worldId);
+  MwmValue const * pMwm = mwmHandle.GetValue<MwmValue>();
+  if (pMwm)
+  {
+    FeatureType ft;
+    FeaturesVector::Cursor loader(pMwm->GetFeatures());
+    loader.GetByIndex(m_index.Get(locality).m_featureId, ft);
+    if (!ft.GetName(m_lang, name))
+      ft.GetName(0, name);
+  }
+  return name;
+}
+
+void LocalityFinder::GetLocalityFromIndex(m2::PointD const & pt, string & name) const
+{
+  // The same choice as DoSelectLocality's.
+  double bestValue = numeric_limits<double>::max();
+  m_index.ForEachAtPoint(pt, [&](uint32_t locality)
+  {
+    string const & localityName = GetIndexedLocalityName(locality);
+    if (localityName.empty())
+      return;
+
+    double const d = MercatorBounds::DistanceOnEarth(m_index.GetRect(locality).Center(), pt);
+    double const value = ftypes::GetPopulationByRadius(d) /
+                         static_cast<double>(m_index.Get(locality).m_population);
+    if (value < bestValue)
+    {
+      bestValue = value;
+      name = localityName;
+    }
+  });
 }
 
 void LocalityFinder::CorrectMinimalRect(m2::RectD & rect) const
@@ -136,9 +209,9 @@ void LocalityFinder::RecreateCache(Cache & cache, m2::RectD rect) const
       int const scale = header.GetLastScale();   // scales::GetUpperWorldScale()
       covering::IntervalsT const & interval = cov.Get(scale);
 
-      ScaleIndex<ModelReaderPtr> index(pMwm->m_cont.GetReader(INDEX_FILE_TAG), pMwm->m_factory);
+      ScaleIndex<ModelReaderPtr> const & index = pMwm->GetScaleIndex();
 
-      FeaturesVector loader(pMwm->m_cont, header, pMwm->m_table);
+      FeaturesVector::Cursor loader(pMwm->GetFeatures());
 
       cache.m_rect = rect;
       for (size_t i = 0; i < interval.size(); ++i)
@@ -153,17 +226,31 @@ void LocalityFinder::RecreateCache(Cache & cache, m2::RectD rect) const
 void LocalityFinder::SetViewportByIndex(m2::RectD const & rect, size_t idx)
 {
   ASSERT_LESS(idx, (size_t)MAX_VIEWPORT_COUNT, ());
+  if (LoadIndex())
+    return;
   RecreateCache(m_cache[idx], rect);
 }
 
 void LocalityFinder::GetLocalityInViewport(const m2::PointD & pt, string & name) const
 {
+  if (LoadIndex())
+  {
+    GetLocalityFromIndex(pt, name);
+    return;
+  }
+
   for (size_t i = 0; i < MAX_VIEWPORT_COUNT; ++i)
     m_cache[i].GetLocality(pt, name);
 }
 
 void LocalityFinder::GetLocalityCreateCache(const m2::PointD & pt, string & name) const
 {
+  if (LoadIndex())
+  {
+    GetLocalityFromIndex(pt, name);
+    return;
+  }
+
   // search in temporary caches and find most unused cache
   size_t minUsageIdx = 0;
   size_t minUsage = numeric_limits<size_t>::max();
@@ -193,6 +280,10 @@ void LocalityFinder::ClearCacheAll()
 
   for (size_t i = 0; i < MAX_CACHE_TMP_COUNT; ++i)
     m_cache_tmp[i].Clear();
+
+  m_isIndexLoaded = false;
+  m_index.Clear();
+  m_names.clear();
 }
 
 void LocalityFinder::ClearCache(size_t idx)
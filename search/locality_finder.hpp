@@ -1,11 +1,13 @@
 #pragma once
 
 #include "indexer/index.hpp"
+#include "indexer/locality_index.hpp"
 
 #include "geometry/point2d.hpp"
 #include "geometry/rect2d.hpp"
 #include "geometry/tree4d.hpp"
 
+#include "std/map.hpp"
 #include "std/set.hpp"
 
 
@@ -28,6 +30,9 @@ struct LocalityItem
   m2::RectD const & GetLimitRect() const { return m_rect; }
 };
 
+/// Finds the city or town of a point. When the world mwm has the locality index section,
+/// it's a single cell lookup. Otherwise localities are loaded from the world mwm features
+/// for the viewports, as for old mwms.
 class LocalityFinder
 {
   struct Cache
@@ -69,6 +74,12 @@ protected:
   void CorrectMinimalRect(m2::RectD & rect) const;
   void RecreateCache(Cache & cache, m2::RectD rect) const;
 
+  /// Loads the locality index of the world mwm, if it's not loaded yet.
+  /// @return False when there is no index.
+  bool LoadIndex() const;
+  void GetLocalityFromIndex(m2::PointD const & pt, string & name) const;
+  string const & GetIndexedLocalityName(uint32_t locality) const;
+
 private:
   friend class DoLoader;
 
@@ -78,6 +89,12 @@ private:
   Cache m_cache[MAX_VIEWPORT_COUNT];
   mutable Cache m_cache_tmp[MAX_CACHE_TMP_COUNT];
 
+  mutable MwmSet::MwmId m_worldId;
+  mutable indexer::LocalityIndex m_index;
+  mutable bool m_isIndexLoaded;
+  /// Names of the indexed localities in m_lang.
+  mutable map<uint32_t, string> m_names;
+
   int8_t m_lang;
 };
 
@@ -10,7 +10,9 @@
 namespace search
 {
   class Results;
+  struct QueryTrace;
   typedef function<void (Results const &)> SearchCallbackT;
+  typedef function<void (QueryTrace const &)> TraceCallbackT;
 
   class SearchParams
   {
@@ -56,6 +58,12 @@ namespace search
 
   public:
     SearchCallbackT m_callback;
+    /// Called with the query trace before the end marker of results, it's optional.
+    TraceCallbackT m_traceCallback;
+    /// Called with the first results of the viewport as soon as they are ranked, before the
+    /// slower stages of the search, it's optional. The refined results go to m_callback later
+    /// with the higher versions.
+    SearchCallbackT m_preliminaryCallback;
 
     string m_query;
     string m_inputLocale;
@@ -0,0 +1,61 @@
+#include "search/query_trace.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/sstream.hpp"
+
+namespace search
+{
+void QueryTrace::Clear()
+{
+  m_query.clear();
+  m_totalSeconds = 0.0;
+  for (double & seconds : m_phaseSeconds)
+    seconds = 0.0;
+  m_queueCandidates.clear();
+  m_featuresLoaded = 0;
+  m_mwmsSearched = 0;
+  m_resultsCount = 0;
+  m_isCancelled = false;
+}
+
+// static
+char const * QueryTrace::GetPhaseName(Phase phase)
+{
+  switch (phase)
+  {
+  case PHASE_SUGGEST_STRINGS: return "SuggestStrings";
+  case PHASE_SEARCH_ADDRESS: return "SearchAddress";
+  case PHASE_SEARCH_LOCALITY: return "SearchLocality";
+  case PHASE_SEARCH_FEATURES: return "SearchFeatures";
+  case PHASE_LOAD_FEATURES: return "LoadFeatures";
+  case PHASE_HOUSES: return "Houses";
+  case PHASE_SUGGESTIONS: return "Suggestions";
+  case PHASE_ADDITIONAL: return "Additional";
+  case PHASES_COUNT: break;
+  }
+  ASSERT(false, (static_cast<int>(phase)));
+  return "";
+}
+
+string DebugPrint(QueryTrace const & trace)
+{
+  ostringstream out;
+  out << "QueryTrace [ query: \"" << trace.m_query << "\", total: " << trace.m_totalSeconds;
+  for (size_t i = 0; i < QueryTrace::PHASES_COUNT; ++i)
+  {
+    out << ", " << QueryTrace::GetPhaseName(static_cast<QueryTrace::Phase>(i)) << ": "
+        << trace.m_phaseSeconds[i];
+  }
+  out << ", queues candidates:";
+  for (uint32_t count : trace.m_queueCandidates)
+    out << " " << count;
+  out << ", features loaded: " << trace.m_featuresLoaded
+      << ", mwms searched: " << trace.m_mwmsSearched
+      << ", results: " << trace.m_resultsCount;
+  if (trace.m_isCancelled)
+    out << ", cancelled";
+  out << " ]";
+  return out.str();
+}
+}  // namespace search
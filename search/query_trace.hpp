@@ -0,0 +1,63 @@
+#pragma once
+
+#include "base/timer.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace search
+{
+/// Timings and counters of a search query, they are collected while the query is processed.
+/// Phases are timed independently, so the address search time includes the localities one.
+struct QueryTrace
+{
+  enum Phase
+  {
+    PHASE_SUGGEST_STRINGS,
+    /// SearchAddress, the localities and the streets.
+    PHASE_SEARCH_ADDRESS,
+    PHASE_SEARCH_LOCALITY,
+    /// Features matching in the search tries.
+    PHASE_SEARCH_FEATURES,
+    /// Features loading by PreResult2Maker.
+    PHASE_LOAD_FEATURES,
+    PHASE_HOUSES,
+    PHASE_SUGGESTIONS,
+    PHASE_ADDITIONAL,
+    PHASES_COUNT
+  };
+
+  QueryTrace() { Clear(); }
+
+  void Clear();
+
+  static char const * GetPhaseName(Phase phase);
+
+  string m_query;
+  double m_totalSeconds;
+  double m_phaseSeconds[PHASES_COUNT];
+  /// Candidates which were taken from each intermediate queue.
+  vector<uint32_t> m_queueCandidates;
+  uint32_t m_featuresLoaded;
+  /// Count of the mwms which were matched, the same mwm is counted for each pass.
+  uint32_t m_mwmsSearched;
+  uint32_t m_resultsCount;
+  bool m_isCancelled;
+};
+
+string DebugPrint(QueryTrace const & trace);
+
+/// Adds the time of its life to the phase.
+class ScopedQueryPhase
+{
+public:
+  ScopedQueryPhase(QueryTrace & trace, QueryTrace::Phase phase) : m_trace(trace), m_phase(phase) {}
+  ~ScopedQueryPhase() { m_trace.m_phaseSeconds[m_phase] += m_timer.ElapsedSeconds(); }
+
+private:
+  QueryTrace & m_trace;
+  QueryTrace::Phase const m_phase;
+  my::Timer m_timer;
+};
+}  // namespace search
@@ -117,14 +117,15 @@ class Results
     ENDED             // search ended itself
   };
   StatusT m_status;
+  uint32_t m_version;
 
-  explicit Results(bool isCancelled)
+  explicit Results(bool isCancelled) : m_version(0)
   {
     m_status = (isCancelled ? ENDED_CANCELLED : ENDED);
   }
 
 public:
-  Results() : m_status(NONE) {}
+  Results() : m_status(NONE), m_version(0) {}
 
   /// @name To implement end of search notification.
   //@{
@@ -133,6 +134,14 @@ public:
   bool IsEndedNormal() const { return (m_status == ENDED); }
   //@}
 
+  /// @name Results of a query are emitted with the increasing versions, so the client may drop
+  /// the stale ones and diff the new ones against the shown. The end marker has the version of
+  /// the last emitted results.
+  //@{
+  inline void SetVersion(uint32_t version) { m_version = version; }
+  inline uint32_t GetVersion() const { return m_version; }
+  //@}
+
   bool AddResult(Result && res);
   /// Fast function that don't do any duplicates checks.
   /// Used in viewport search only.
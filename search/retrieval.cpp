@@ -7,7 +7,7 @@
 #include "indexer/index.hpp"
 #include "indexer/search_trie.hpp"
 
-#include "coding/reader_wrapper.hpp"
+#include "coding/reader.hpp"
 
 #include "base/logging.hpp"
 
@@ -23,29 +23,123 @@ namespace
 // Otherwise, slow path is used.
 uint64_t constexpr kFastPathThreshold = 100;
 
-struct EmptyFilter
+// Maximum number of entries in the retrieval's tokens cache.
+size_t constexpr kMaxCachedTokens = 256;
+
+// Returns a key of the tokens cache for |syns|. Matched features
+// depend on query languages too, so they are a part of the key.
+string GetTokenKey(SearchQueryParams const & params, SearchQueryParams::TSynonymsVector const & syns,
+                   bool isPrefix)
 {
-  inline bool operator()(uint32_t /* featureId */) const { return true; }
-};
+  vector<int8_t> langs(params.m_langs.begin(), params.m_langs.end());
+  sort(langs.begin(), langs.end());
+
+  string key(1, isPrefix ? 'p' : 't');
+  key.push_back(static_cast<char>(langs.size()));
+  key.append(langs.begin(), langs.end());
+  for (auto const & syn : syns)
+  {
+    key += strings::ToUtf8(syn);
+    key.push_back('\0');
+  }
+  return key;
+}
+
+// Retrieves from the search index all features matching at least one
+// synonym from |syns| in any of query's languages or in categories.
+// The result is sorted and does not contain duplicates.
+void RetrieveTokenFeatures(trie::DefaultIterator const & trieRoot,
+                           SearchQueryParams const & params,
+                           SearchQueryParams::TSynonymsVector const & syns, bool isPrefix,
+                           vector<uint32_t> & featureIds)
+{
+  auto collector = [&](trie::ValueReader::ValueType const & value)
+  {
+    featureIds.push_back(value.m_featureId);
+  };
+
+  ForEachLangPrefix(params, trieRoot, [&](TrieRootPrefix & langRoot, int8_t /* lang */)
+  {
+    if (isPrefix)
+      MatchTokenPrefixInTrie(syns, langRoot, collector);
+    else
+      MatchTokenInTrie(syns, langRoot, collector);
+  });
+
+  // Query prefix is treated as a complete token in categories, see
+  // MatchCategoriesInTrie().
+  ASSERT_LESS(trieRoot.m_edge.size(), numeric_limits<uint32_t>::max(), ());
+  uint32_t const numLangs = static_cast<uint32_t>(trieRoot.m_edge.size());
+  for (uint32_t langIx = 0; langIx < numLangs; ++langIx)
+  {
+    auto const & edge = trieRoot.m_edge[langIx].m_str;
+    if (edge[0] == search::kCategoriesLang)
+    {
+      unique_ptr<trie::DefaultIterator> const catRoot(trieRoot.GoToEdge(langIx));
+      MatchTokenInTrie(syns, TrieRootPrefix(*catRoot, edge), collector);
+      break;
+    }
+  }
+
+  sort(featureIds.begin(), featureIds.end());
+  featureIds.erase(unique(featureIds.begin(), featureIds.end()), featureIds.end());
+}
 
 // Retrieves from the search index corresponding to |handle| all
-// features matching to |params|.
+// features matching to |params|, i.e. features matching all query
+// tokens. Features of single tokens are taken from |cache| when
+// possible, so the search index is read only for new tokens.
 void RetrieveAddressFeatures(MwmSet::MwmHandle const & handle, SearchQueryParams const & params,
-                             vector<uint32_t> & featureIds)
+                             Retrieval::TokensCache & cache, vector<uint32_t> & featureIds)
 {
   auto * value = handle.GetValue<MwmValue>();
   ASSERT(value, ());
-  serial::CodingParams codingParams(trie::GetCodingParams(value->GetHeader().GetDefCodingParams()));
-  ModelReaderPtr searchReader = value->m_cont.GetReader(SEARCH_INDEX_FILE_TAG);
-  unique_ptr<trie::DefaultIterator> const trieRoot(
-      trie::ReadTrie(SubReaderWrapper<Reader>(searchReader.GetPtr()),
-                     trie::ValueReader(codingParams), trie::TEdgeValueReader()));
 
-  auto collector = [&](trie::ValueReader::ValueType const & value)
+  // The search index is read only on cache misses. |searchReader| and
+  // |codingParams| must outlive |trieRoot|.
+  serial::CodingParams codingParams;
+  unique_ptr<ModelReaderPtr> searchReader;
+  unique_ptr<trie::DefaultIterator> trieRoot;
+  auto retrieveToken = [&](SearchQueryParams::TSynonymsVector const & syns, bool isPrefix,
+                           CompressedBitmap & tokenFeatures)
   {
-    featureIds.push_back(value.m_featureId);
+    string const key = GetTokenKey(params, syns, isPrefix);
+    if (cache.Get(handle.GetId(), key, tokenFeatures))
+      return;
+
+    if (!trieRoot)
+    {
+      codingParams = trie::GetCodingParams(value->GetHeader().GetDefCodingParams());
+      searchReader.reset(new ModelReaderPtr(value->m_cont.GetReader(SEARCH_INDEX_FILE_TAG)));
+      trieRoot.reset(
+          trie::ReadSearchTrie(*searchReader, codingParams, value->GetHeader().GetFormat()));
+    }
+    vector<uint32_t> ids;
+    RetrieveTokenFeatures(*trieRoot, params, syns, isPrefix, ids);
+    tokenFeatures = CompressedBitmap(ids);
+    cache.Put(handle.GetId(), key, tokenFeatures);
   };
-  MatchFeaturesInTrie(params, *trieRoot, EmptyFilter(), collector);
+
+  size_t const numTokens = params.m_tokens.size() + (params.m_prefixTokens.empty() ? 0 : 1);
+  if (numTokens == 0)
+    return;
+
+  // Features are intersected as compressed bitmaps, only the result is decoded.
+  CompressedBitmap features;
+  for (size_t i = 0; i < numTokens; ++i)
+  {
+    bool const isPrefix = (i == params.m_tokens.size());
+    CompressedBitmap tokenFeatures;
+    retrieveToken(isPrefix ? params.m_prefixTokens : params.m_tokens[i], isPrefix, tokenFeatures);
+
+    if (i == 0)
+      features = move(tokenFeatures);
+    else
+      features = CompressedBitmap::And(features, tokenFeatures);
+    if (features.IsEmpty())
+      break;
+  }
+  featureIds = features.ToVector();
 }
 
 // Retrieves from the geomery index corresponding to handle all
@@ -67,7 +161,7 @@ void RetrieveGeometryFeatures(MwmSet::MwmHandle const & handle, m2::RectD viewpo
 
   covering::CoveringGetter covering(viewport, covering::ViewportWithLowLevels);
   covering::IntervalsT const & intervals = covering.Get(scale);
-  ScaleIndex<ModelReaderPtr> index(value->m_cont.GetReader(INDEX_FILE_TAG), value->m_factory);
+  ScaleIndex<ModelReaderPtr> const & index = value->GetScaleIndex();
 
   for (auto const & interval : intervals)
     index.ForEachInIntervalAndScale(toDo, interval.first, interval.second, scale);
@@ -85,9 +179,19 @@ public:
   {
     m2::PointD const center = m_viewport.Center();
 
+    // Centers are taken from the attributes column when the mwm has it, the features are loaded
+    // otherwise.
+    auto const * value = m_handle.GetValue<MwmValue>();
+    feature::AttributesTable const * attributes = value ? value->m_attributesTable : nullptr;
+
     Index::FeaturesLoaderGuard loader(index, m_handle.GetId());
     for (auto const & featureId : addressFeatures)
     {
+      if (attributes && featureId < attributes->GetCount())
+      {
+        m_features.emplace_back(featureId, attributes->GetCenter(featureId));
+        continue;
+      }
       FeatureType feature;
       loader.GetFeatureByIndex(featureId, feature);
       m_features.emplace_back(featureId, feature::GetCenter(feature, FeatureType::WORST_GEOMETRY));
@@ -264,8 +368,77 @@ Retrieval::Bucket::Bucket(MwmSet::MwmHandle && handle)
   m_bounds = header.GetBounds();
 }
 
+// Retrieval::TokensCache -------------------------------------------------------------------------
+Retrieval::TokensCache::TokensCache(size_t maxEntries)
+  : m_maxEntries(maxEntries), m_numHits(0), m_numMisses(0)
+{
+}
+
+bool Retrieval::TokensCache::Get(MwmSet::MwmId const & id, string const & key,
+                                 CompressedBitmap & features)
+{
+  auto const it = m_index.find(TKey(id, key));
+  if (it == m_index.end())
+  {
+    ++m_numMisses;
+    return false;
+  }
+  ++m_numHits;
+
+  // Move the entry to the front of the LRU list.
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+  features = it->second->m_features;
+  return true;
+}
+
+void Retrieval::TokensCache::Put(MwmSet::MwmId const & id, string const & key,
+                                 CompressedBitmap const & features)
+{
+  TKey k(id, key);
+  auto const it = m_index.find(k);
+  if (it != m_index.end())
+  {
+    m_entries.erase(it->second);
+    m_index.erase(it);
+  }
+
+  m_entries.push_front(Entry());
+  Entry & entry = m_entries.front();
+  entry.m_key = k;
+  entry.m_features = features;
+  entry.m_features.RunOptimize();
+  m_index[k] = m_entries.begin();
+
+  while (m_entries.size() > m_maxEntries)
+  {
+    m_index.erase(m_entries.back().m_key);
+    m_entries.pop_back();
+  }
+}
+
+void Retrieval::TokensCache::RemoveDeadMwms()
+{
+  for (auto it = m_entries.begin(); it != m_entries.end();)
+  {
+    if (it->m_key.first.IsAlive())
+    {
+      ++it;
+      continue;
+    }
+    m_index.erase(it->m_key);
+    it = m_entries.erase(it);
+  }
+}
+
+void Retrieval::TokensCache::Clear()
+{
+  m_entries.clear();
+  m_index.clear();
+}
+
 // Retrieval ---------------------------------------------------------------------------------------
-Retrieval::Retrieval() : m_index(nullptr), m_featuresReported(0) {}
+Retrieval::Retrieval() : m_index(nullptr), m_featuresReported(0), m_tokensCache(kMaxCachedTokens) {}
 
 void Retrieval::Init(Index & index, vector<shared_ptr<MwmInfo>> const & infos,
                      m2::RectD const & viewport, SearchQueryParams const & params,
@@ -278,6 +451,7 @@ void Retrieval::Init(Index & index, vector<shared_ptr<MwmInfo>> const & infos,
   m_featuresReported = 0;
 
   m_buckets.clear();
+  m_tokensCache.RemoveDeadMwms();
   for (auto const & info : infos)
   {
     MwmSet::MwmHandle handle = index.GetMwmHandleById(MwmSet::MwmId(info));
@@ -342,7 +516,7 @@ bool Retrieval::RetrieveForScale(double scale, Callback & callback)
       // This is the first time viewport intersects with mwm. Retrieve
       // all matching features from the search index.
       ASSERT(!bucket.m_strategy, ());
-      RetrieveAddressFeatures(bucket.m_handle, m_params, bucket.m_addressFeatures);
+      RetrieveAddressFeatures(bucket.m_handle, m_params, m_tokensCache, bucket.m_addressFeatures);
       if (IsCancelled())
         return false;
       if (bucket.m_addressFeatures.size() < kFastPathThreshold)
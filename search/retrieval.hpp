@@ -4,13 +4,19 @@
 
 #include "indexer/mwm_set.hpp"
 
+#include "coding/compressed_bitmap.hpp"
+
 #include "geometry/rect2d.hpp"
 
 #include "base/cancellable.hpp"
 #include "base/macros.hpp"
 
 #include "std/function.hpp"
+#include "std/list.hpp"
+#include "std/map.hpp"
+#include "std/string.hpp"
 #include "std/unique_ptr.hpp"
+#include "std/utility.hpp"
 #include "std/vector.hpp"
 
 class Index;
@@ -90,8 +96,52 @@ public:
     double m_prevScale;
   };
 
+  // This class caches features matching single tokens of a search
+  // query, so successive queries (e.g. while a user types) don't walk
+  // the search index for tokens they share. Features are stored as
+  // compressed bitmaps, the least recently used entries are evicted.
+  class TokensCache
+  {
+  public:
+    explicit TokensCache(size_t maxEntries);
+
+    // Fills |features| and returns true when there is an entry for
+    // |key| in the mwm |id|.
+    bool Get(MwmSet::MwmId const & id, string const & key, CompressedBitmap & features);
+
+    void Put(MwmSet::MwmId const & id, string const & key, CompressedBitmap const & features);
+
+    // Removes entries of deregistered mwms.
+    void RemoveDeadMwms();
+
+    void Clear();
+
+    inline size_t GetSize() const { return m_entries.size(); }
+    inline uint64_t GetNumHits() const { return m_numHits; }
+    inline uint64_t GetNumMisses() const { return m_numMisses; }
+
+  private:
+    using TKey = pair<MwmSet::MwmId, string>;
+
+    struct Entry
+    {
+      TKey m_key;
+      CompressedBitmap m_features;
+    };
+
+    size_t const m_maxEntries;
+    list<Entry> m_entries;
+    map<TKey, list<Entry>::iterator> m_index;
+    uint64_t m_numHits;
+    uint64_t m_numMisses;
+  };
+
   Retrieval();
 
+  // Entries of the tokens cache are shared by all queries (Init calls)
+  // of this retrieval.
+  inline TokensCache const & GetTokensCache() const { return m_tokensCache; }
+
   void Init(Index & index, vector<shared_ptr<MwmInfo>> const & infos, m2::RectD const & viewport,
             SearchQueryParams const & params, Limits const & limits);
 
@@ -145,5 +195,7 @@ private:
   uint64_t m_featuresReported;
 
   vector<Bucket> m_buckets;
+
+  TokensCache m_tokensCache;
 };
 }  // namespace search
@@ -0,0 +1,406 @@
+#include "search/reverse_geocoder.hpp"
+
+#include "indexer/classificator.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/feature_visibility.hpp"
+#include "indexer/index.hpp"
+#include "indexer/mercator.hpp"
+#include "indexer/scales.hpp"
+
+#include "geometry/distance.hpp"
+#include "geometry/robust_orientation.hpp"
+
+#include "base/assert.hpp"
+#include "base/tracing.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/limits.hpp"
+#include "std/utility.hpp"
+
+namespace search
+{
+namespace
+{
+// Radii to search POIs, street names and building numbers, they are indexed by feature::EGeomType.
+double const kRadiiMeters[] = {15.0, 100.0, 5.0};
+// The distance of a line is worse than the same distance of a point by this value,
+// and the distance of an area is worse by twice of it.
+double const kCompareEpsMeters = 5.0;
+// 64 cells are cached.
+uint32_t const kLogCellsCount = 6;
+
+double Inf() { return numeric_limits<double>::max(); }
+
+double GetSegmentDistance(m2::PointD const & p1, m2::PointD const & p2, m2::PointD const & pt)
+{
+  m2::DistanceToLineSquare<m2::PointD> calc;
+  calc.SetBounds(p1, p2);
+  return sqrt(calc(pt));
+}
+
+/// Inclusion distances of the point features, lines and areas at |pt| in mercator,
+/// meters are converted as the average of the both axes.
+void GetEpsilons(m2::PointD const & pt, double (&eps)[3])
+{
+  for (size_t i = 0; i < 3; ++i)
+  {
+    m2::RectD const r = MercatorBounds::RectByCenterXYAndSizeInMeters(pt, kRadiiMeters[i]);
+    eps[i] = (r.SizeX() + r.SizeY()) / 2.0;
+  }
+}
+
+class StreetChecker
+{
+public:
+  StreetChecker()
+  {
+    char const * arr[][2] = {{"highway", "primary"},     {"highway", "secondary"},
+                             {"highway", "residential"}, {"highway", "tertiary"},
+                             {"highway", "living_street"}, {"highway", "service"}};
+
+    Classificator const & c = classif();
+    for (auto const & path : arr)
+      m_types.push_back(c.GetTypeByPath(vector<string>(path, path + 2)));
+  }
+
+  bool IsStreet(feature::TypesHolder const & types) const
+  {
+    for (uint32_t t : types)
+    {
+      ftype::TruncValue(t, 2);
+      if (find(m_types.begin(), m_types.end(), t) != m_types.end())
+        return true;
+    }
+    return false;
+  }
+
+private:
+  vector<uint32_t> m_types;
+};
+
+StreetChecker const & GetStreetChecker()
+{
+  static StreetChecker const checker;
+  return checker;
+}
+
+/// Collects the segments of a line which are near the rect.
+class SegmentsCollector
+{
+public:
+  SegmentsCollector(m2::RectD const & rect, vector<m2::PointD> & points)
+    : m_rect(rect), m_points(points), m_hasPrev(false)
+  {
+  }
+
+  void operator()(m2::PointD const & pt)
+  {
+    if (m_hasPrev)
+    {
+      m2::RectD r(m_prev, m_prev);
+      r.Add(pt);
+      if (r.IsIntersect(m_rect))
+      {
+        m_points.push_back(m_prev);
+        m_points.push_back(pt);
+      }
+    }
+    m_hasPrev = true;
+    m_prev = pt;
+  }
+
+private:
+  m2::RectD const & m_rect;
+  vector<m2::PointD> & m_points;
+  m2::PointD m_prev;
+  bool m_hasPrev;
+};
+
+/// Collects the right-oriented triangles of an area which are near the rect.
+class TrianglesCollector
+{
+public:
+  TrianglesCollector(m2::RectD const & rect, vector<m2::PointD> & points)
+    : m_rect(rect), m_points(points)
+  {
+  }
+
+  void operator()(m2::PointD const & p1, m2::PointD const & p2, m2::PointD const & p3)
+  {
+    m2::RectD r(p1, p1);
+    r.Add(p2);
+    r.Add(p3);
+    if (!r.IsIntersect(m_rect))
+      return;
+
+    m_points.push_back(p1);
+    if (m2::robust::OrientedS(p1, p2, p3) < 0.0)
+    {
+      m_points.push_back(p3);
+      m_points.push_back(p2);
+    }
+    else
+    {
+      m_points.push_back(p2);
+      m_points.push_back(p3);
+    }
+  }
+
+private:
+  m2::RectD const & m_rect;
+  vector<m2::PointD> & m_points;
+};
+}  // namespace
+
+// static
+double const ReverseGeocoder::kCellSize = 0.005;
+
+void ReverseGeocoder::Address::Clear()
+{
+  m_street.clear();
+  m_house.clear();
+  m_name.clear();
+  m_types = feature::TypesHolder();
+}
+
+ReverseGeocoder::ReverseGeocoder(Index const & index)
+  : m_index(index), m_coastType(classif().GetCoastType()), m_cells(kLogCellsCount),
+    m_epoch(index.GetEpoch())
+{
+}
+
+void ReverseGeocoder::ReverseGeocode(m2::PointD const & pt, Address & address)
+{
+  ReverseGeocode(pt, GetCell(GetCellKey(pt)), address);
+}
+
+void ReverseGeocoder::ReverseGeocode(vector<m2::PointD> const & points, vector<Address> & addresses)
+{
+  TRACE_SCOPE("search", "ReverseGeocoder::ReverseGeocodeBatch");
+  vector<pair<uint64_t, size_t>> order;
+  order.reserve(points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+    order.emplace_back(GetCellKey(points[i]), i);
+  sort(order.begin(), order.end());
+
+  addresses.resize(points.size());
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    Cell const & cell = GetCell(order[i].first);
+    for (; i < order.size(); ++i)
+    {
+      size_t const point = order[i].second;
+      ReverseGeocode(points[point], cell, addresses[point]);
+      if (i + 1 < order.size() && order[i + 1].first != order[i].first)
+        break;
+    }
+  }
+}
+
+void ReverseGeocoder::ClearCache()
+{
+  m_cells.Reset();
+  m_cells.ForEachValue([](Cell & cell) { cell.m_candidates.clear(); });
+}
+
+// static
+uint64_t ReverseGeocoder::GetCellKey(m2::PointD const & pt)
+{
+  auto const toCell = [](double coord, double minCoord)
+  {
+    return static_cast<uint64_t>(max(0.0, floor((coord - minCoord) / kCellSize)));
+  };
+  return (toCell(pt.y, MercatorBounds::minY) << 32) | toCell(pt.x, MercatorBounds::minX);
+}
+
+ReverseGeocoder::Cell const & ReverseGeocoder::GetCell(uint64_t key)
+{
+  uint64_t const epoch = m_index.GetEpoch();
+  if (epoch != m_epoch)
+  {
+    ClearCache();
+    m_epoch = epoch;
+  }
+
+  bool found;
+  Cell & cell = m_cells.Find(key, found);
+  if (!found)
+    LoadCell(key, cell);
+  return cell;
+}
+
+void ReverseGeocoder::LoadCell(uint64_t key, Cell & cell) const
+{
+  TRACE_SCOPE("search", "ReverseGeocoder::LoadCell");
+  cell.m_candidates.clear();
+
+  double const minX = MercatorBounds::minX + (key & 0xFFFFFFFF) * kCellSize;
+  double const minY = MercatorBounds::minY + (key >> 32) * kCellSize;
+  m2::RectD rect(minX, minY, minX + kCellSize, minY + kCellSize);
+
+  // The largest inclusion distance of the cell's points is at the corner which is nearer to a pole.
+  double margin = 0.0;
+  for (m2::PointD const & corner : {rect.LeftBottom(), rect.LeftTop()})
+  {
+    double eps[3];
+    GetEpsilons(corner, eps);
+    margin = max(margin, *max_element(eps, eps + 3));
+  }
+  rect.Inflate(margin, margin);
+
+  // Features of an mwm go in a row, so its scales table is looked up once for them. The table is
+  // owned by the mwm info, which is kept by the id.
+  MwmSet::MwmId mwmId;
+  feature::ScalesTable const * scalesTable = nullptr;
+
+  Candidate candidate;
+  auto f = [&](FeatureType const & ft)
+  {
+    if (ft.GetID().m_mwmId != mwmId)
+    {
+      mwmId = ft.GetID().m_mwmId;
+      Index::MwmHandle const mwmHandle = m_index.GetMwmHandleById(mwmId);
+      MwmValue const * pMwm = mwmHandle.GetValue<MwmValue>();
+      scalesTable = pMwm ? pMwm->m_scalesTable : nullptr;
+    }
+
+    if (AddCandidate(ft, rect, scalesTable, candidate))
+    {
+      cell.m_candidates.push_back(move(candidate));
+      candidate = Candidate();
+    }
+  };
+  m_index.ForEachInRect(f, rect, scales::GetUpperScale());
+}
+
+bool ReverseGeocoder::AddCandidate(FeatureType const & ft, m2::RectD const & rect,
+                                   feature::ScalesTable const * scalesTable,
+                                   Candidate & candidate) const
+{
+  // Features with texts are needed for the address lookup.
+  feature::ScalesTable::Ranges ranges;
+  bool const hasRanges = scalesTable != nullptr && scalesTable->Get(ft.GetID().m_index, ranges);
+  if (hasRanges && !my::between_s(ranges.m_labels.first, ranges.m_labels.second, scales::GetUpperScale()))
+    return false;
+
+  candidate.m_types = feature::TypesHolder(ft);
+  if (candidate.m_types.Has(m_coastType))
+    return false;
+
+  if (!hasRanges)
+  {
+    ranges.m_labels = feature::GetDrawableScaleRangeForRules(
+        candidate.m_types, feature::RULE_ANY_TEXT | feature::RULE_SYMBOL);
+    if (!my::between_s(ranges.m_labels.first, ranges.m_labels.second, scales::GetUpperScale()))
+      return false;
+  }
+
+  ft.GetReadableName(candidate.m_name);
+  candidate.m_house = ft.GetHouseNumber();
+  candidate.m_isStreet = GetStreetChecker().IsStreet(candidate.m_types);
+
+  int const scale = scales::GetUpperScale();
+  switch (ft.GetFeatureType())
+  {
+  case feature::GEOM_POINT: candidate.m_geometry.push_back(ft.GetCenter()); break;
+  case feature::GEOM_LINE:
+  {
+    // Lines are found by their names and houses only.
+    if (candidate.m_name.empty() && candidate.m_house.empty())
+      return false;
+    SegmentsCollector collector(rect, candidate.m_geometry);
+    ft.ForEachPointRef(collector, scale);
+    break;
+  }
+  case feature::GEOM_AREA:
+  {
+    TrianglesCollector collector(rect, candidate.m_geometry);
+    ft.ForEachTriangleRef(collector, scale);
+    break;
+  }
+  default: ASSERT(false, ()); break;
+  }
+
+  return !candidate.m_geometry.empty();
+}
+
+void ReverseGeocoder::ReverseGeocode(m2::PointD const & pt, Cell const & cell,
+                                     Address & address) const
+{
+  address.Clear();
+
+  double eps[3];
+  GetEpsilons(pt, eps);
+  double const compareEps = kCompareEpsMeters * MercatorBounds::degreeInMetres;
+
+  vector<pair<double, Candidate const *>> found;
+  for (Candidate const & candidate : cell.m_candidates)
+  {
+    feature::EGeomType const type = candidate.m_types.GetGeoType();
+    double const d = candidate.GetDistance(pt);
+    if (d <= eps[type])
+      found.emplace_back(d + static_cast<int>(type) * compareEps, &candidate);
+  }
+  sort(found.begin(), found.end(),
+       [](pair<double, Candidate const *> const & lhs, pair<double, Candidate const *> const & rhs)
+       {
+         return lhs.first < rhs.first;
+       });
+
+  bool hasTypes = false;
+  for (auto const & item : found)
+  {
+    Candidate const & candidate = *item.second;
+    if (address.m_street.empty() && candidate.m_isStreet)
+      address.m_street = candidate.m_name;
+
+    if (address.m_house.empty())
+      address.m_house = candidate.m_house;
+
+    /// @todo Linear objects are skipped to get only POIs here (don't mix with streets or roads).
+    /// But there are linear types that may be interesting for POI (rivers).
+    if (address.m_name.empty() && candidate.m_types.GetGeoType() != feature::GEOM_LINE)
+    {
+      address.m_name = candidate.m_name;
+      if (!hasTypes || !candidate.m_name.empty())
+        address.m_types = candidate.m_types;
+      hasTypes = true;
+    }
+
+    if (!(address.m_street.empty() || address.m_name.empty()))
+      break;
+  }
+}
+
+double ReverseGeocoder::Candidate::GetDistance(m2::PointD const & pt) const
+{
+  double dist = Inf();
+  switch (m_types.GetGeoType())
+  {
+  case feature::GEOM_POINT: dist = pt.Length(m_geometry.front()); break;
+  case feature::GEOM_LINE:
+    for (size_t i = 0; i + 1 < m_geometry.size(); i += 2)
+      dist = min(dist, GetSegmentDistance(m_geometry[i], m_geometry[i + 1], pt));
+    break;
+  case feature::GEOM_AREA:
+    for (size_t i = 0; i + 2 < m_geometry.size(); i += 3)
+    {
+      // The distance to the edges which the point is outside of, it's zero inside the triangle.
+      double d = Inf();
+      for (size_t j = 0; j < 3; ++j)
+      {
+        m2::PointD const & p1 = m_geometry[i + j];
+        m2::PointD const & p2 = m_geometry[i + (j + 1) % 3];
+        if (m2::robust::OrientedS(p1, p2, pt) < 0.0)
+          d = min(d, GetSegmentDistance(p1, p2, pt));
+      }
+      if (d == Inf())
+        return 0.0;
+      dist = min(dist, d);
+    }
+    break;
+  default: ASSERT(false, ()); break;
+  }
+  return dist;
+}
+}  // namespace search
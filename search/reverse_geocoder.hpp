@@ -0,0 +1,92 @@
+#pragma once
+
+#include "indexer/feature_data.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include "base/cache.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+class FeatureType;
+class Index;
+
+namespace feature { class ScalesTable; }
+
+namespace search
+{
+/// Finds the street, the house number and the nearest POI or building of a point.
+///
+/// The world is split to a uniform grid in mercator, and the features which may be
+/// the address candidates of the points in a cell are loaded once per cell: names, types
+/// and only the geometry near the cell. So the taps on the map near each other and the points
+/// of GPS traces don't scan and decode the features of the map again and again.
+///
+/// Candidates and their priority are the same as the map had: streets are within about 100 m,
+/// POIs within 15 m and houses within 5 m, and points are better than lines that are better
+/// than areas on the same distance.
+class ReverseGeocoder
+{
+public:
+  struct Address
+  {
+    void Clear();
+
+    string m_street;
+    string m_house;
+    /// Name and types of the nearest not linear feature, types are empty when there is none.
+    string m_name;
+    feature::TypesHolder m_types;
+  };
+
+  /// Cells are about 550 m at the equator.
+  static double const kCellSize;
+
+  explicit ReverseGeocoder(Index const & index);
+
+  void ReverseGeocode(m2::PointD const & pt, Address & address);
+  /// Points are processed in the order of their cells, so the near points share the loaded features.
+  /// @param[out] addresses  Addresses of the points in the same order.
+  void ReverseGeocode(vector<m2::PointD> const & points, vector<Address> & addresses);
+
+  /// Must be called when the language of the names is changed. The cache is cleared
+  /// by itself when the maps are registered, deregistered or updated, see MwmSet::GetEpoch().
+  void ClearCache();
+
+private:
+  struct Candidate
+  {
+    feature::TypesHolder m_types;
+    string m_name;
+    string m_house;
+    bool m_isStreet = false;
+    /// Point of the point feature, segments of the line or triangles of the area near the cell.
+    vector<m2::PointD> m_geometry;
+
+    double GetDistance(m2::PointD const & pt) const;
+  };
+
+  struct Cell
+  {
+    vector<Candidate> m_candidates;
+  };
+
+  static uint64_t GetCellKey(m2::PointD const & pt);
+
+  Cell const & GetCell(uint64_t key);
+  void LoadCell(uint64_t key, Cell & cell) const;
+  /// @param scalesTable Scales of the features of the mwm, it may be nullptr.
+  bool AddCandidate(FeatureType const & ft, m2::RectD const & rect,
+                    feature::ScalesTable const * scalesTable, Candidate & candidate) const;
+  void ReverseGeocode(m2::PointD const & pt, Cell const & cell, Address & address) const;
+
+  Index const & m_index;
+  uint32_t m_coastType;
+  my::Cache<uint64_t, Cell> m_cells;
+  /// Epoch of the index the cells are loaded at.
+  uint64_t m_epoch;
+};
+}  // namespace search
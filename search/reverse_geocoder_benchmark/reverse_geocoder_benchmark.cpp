@@ -0,0 +1,182 @@
+// Reverse geocodes the points of GPS traces in the local maps and reports the latency of the taps
+// on the map, when the cache is cold for each point, and the throughput of the point by point
+// and the batched lookups of the traces.
+//
+// Points file has "lat,lon" lines in the order of the traces. When it isn't set, random walks
+// in the country maps are used, with about --step meters between the points.
+
+#include "search/reverse_geocoder.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/index.hpp"
+#include "indexer/mercator.hpp"
+
+#include "platform/local_country_file_utils.hpp"
+#include "platform/platform.hpp"
+
+#include "base/logging.hpp"
+#include "base/math.hpp"
+#include "base/stats.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
+#include "base/tracing.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/fstream.hpp"
+#include "std/iomanip.hpp"
+#include "std/iostream.hpp"
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+#include "3party/gflags/src/gflags/gflags.h"
+
+DEFINE_string(points, "", "File with \"lat,lon\" lines of the GPS traces");
+DEFINE_int32(random, 10000, "Number of the random points when --points isn't set");
+DEFINE_int32(trace, 500, "Number of the points of each random trace");
+DEFINE_double(step, 10.0, "Distance in meters between the points of the random traces");
+DEFINE_int32(taps, 1000, "Number of the first points which are looked up with the cold cache");
+DEFINE_string(chrome_trace, "", "File to write the Chrome trace of the lookups to");
+
+namespace
+{
+using search::ReverseGeocoder;
+
+void ReadPoints(string const & path, vector<m2::PointD> & points)
+{
+  ifstream stream(path);
+  string line;
+  while (getline(stream, line))
+  {
+    size_t const comma = line.find(',');
+    double lat, lon;
+    if (comma == string::npos || !strings::to_double(line.substr(0, comma), lat) ||
+        !strings::to_double(line.substr(comma + 1), lon))
+    {
+      LOG(LWARNING, ("Bad point", line));
+      continue;
+    }
+    points.push_back(MercatorBounds::FromLatLon(lat, lon));
+  }
+}
+
+void MakeRandomTraces(Index const & index, size_t count, vector<m2::PointD> & points)
+{
+  vector<shared_ptr<MwmInfo>> mwmsInfo;
+  index.GetMwmsInfo(mwmsInfo);
+  vector<m2::RectD> rects;
+  for (shared_ptr<MwmInfo> const & info : mwmsInfo)
+  {
+    if (info->GetType() == MwmInfo::COUNTRY)
+      rects.push_back(info->m_limitRect);
+  }
+  if (rects.empty())
+    return;
+
+  mt19937 rng(0);
+  uniform_real_distribution<double> unit(0.0, 1.0);
+  uniform_real_distribution<double> turn(-0.5, 0.5);
+  size_t const traceSize = static_cast<size_t>(max(FLAGS_trace, 1));
+  while (points.size() < count)
+  {
+    m2::RectD const & rect = rects[rng() % rects.size()];
+    m2::PointD pt(rect.minX() + unit(rng) * rect.SizeX(), rect.minY() + unit(rng) * rect.SizeY());
+    double direction = unit(rng) * 2.0 * math::pi;
+    for (size_t i = 0; i < traceSize && points.size() < count; ++i)
+    {
+      points.push_back(pt);
+      direction += turn(rng);
+      pt = MercatorBounds::GetSmPoint(pt, FLAGS_step * cos(direction), FLAGS_step * sin(direction));
+    }
+  }
+}
+
+bool IsFound(ReverseGeocoder::Address const & address)
+{
+  return !address.m_street.empty() || !address.m_name.empty() || !address.m_house.empty();
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  google::SetUsageMessage("Reverse geocoder latency and throughput benchmark");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  classificator::Load();
+
+  Index index;
+  vector<platform::LocalCountryFile> localFiles;
+  platform::FindAllLocalMaps(localFiles);
+  for (platform::LocalCountryFile & localFile : localFiles)
+  {
+    localFile.SyncWithDisk();
+    if (index.RegisterMap(localFile).second != MwmSet::RegResult::Success)
+      LOG(LWARNING, ("Can't register", localFile));
+  }
+
+  vector<m2::PointD> points;
+  if (FLAGS_points.empty())
+    MakeRandomTraces(index, static_cast<size_t>(max(FLAGS_random, 0)), points);
+  else
+    ReadPoints(FLAGS_points, points);
+  if (points.empty())
+  {
+    cout << "No points" << endl;
+    return 1;
+  }
+
+  ReverseGeocoder geocoder(index);
+  ReverseGeocoder::Address address;
+
+  // The first lookup opens the mwms, so it isn't measured.
+  geocoder.ReverseGeocode(points.front(), address);
+
+  if (!FLAGS_chrome_trace.empty())
+    my::tracing::Start();
+
+  vector<double> times;
+  size_t const tapsCount = min(points.size(), static_cast<size_t>(max(FLAGS_taps, 1)));
+  for (size_t i = 0; i < tapsCount; ++i)
+  {
+    geocoder.ClearCache();
+    my::Timer timer;
+    geocoder.ReverseGeocode(points[i], address);
+    times.push_back(timer.ElapsedSeconds());
+  }
+  sort(times.begin(), times.end());
+
+  geocoder.ClearCache();
+  size_t foundCount = 0;
+  my::Timer timer;
+  for (m2::PointD const & pt : points)
+  {
+    geocoder.ReverseGeocode(pt, address);
+    if (IsFound(address))
+      ++foundCount;
+  }
+  double const singleSeconds = timer.ElapsedSeconds();
+
+  geocoder.ClearCache();
+  vector<ReverseGeocoder::Address> addresses;
+  timer.Reset();
+  geocoder.ReverseGeocode(points, addresses);
+  double const batchSeconds = timer.ElapsedSeconds();
+
+  if (!FLAGS_chrome_trace.empty())
+  {
+    my::tracing::Stop();
+    if (!my::tracing::WriteChromeTrace(FLAGS_chrome_trace))
+      LOG(LWARNING, ("Can't write the trace to", FLAGS_chrome_trace));
+  }
+
+  size_t const count = 1000;
+  cout << fixed << setprecision(3);
+  cout << "TAP*1000[ points:" << times.size() << " p50:" << my::GetPercentile(times, 0.5) * count
+       << " p95:" << my::GetPercentile(times, 0.95) * count
+       << " p99:" << my::GetPercentile(times, 0.99) * count << " max:" << times.back() * count << " ]"
+       << endl;
+  cout << "THROUGHPUT[ points:" << points.size()
+       << " single per second:" << points.size() / singleSeconds
+       << " batch per second:" << points.size() / batchSeconds << " ]" << endl;
+  cout << "FOUND[ " << foundCount << " of " << points.size() << " ]" << endl;
+  return 0;
+}
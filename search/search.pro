@@ -11,6 +11,7 @@ include($$ROOT_DIR/common.pri)
 HEADERS += \
     algos.hpp \
     approximate_string_match.hpp \
+    engine_data.hpp \
     feature_offset_match.hpp \
     geometry_utils.hpp \
     house_detector.hpp \
@@ -22,17 +23,22 @@ HEADERS += \
     locality_finder.hpp \
     params.hpp \
     query_saver.hpp \
+    query_trace.hpp \
     result.hpp \
     retrieval.hpp \
+    reverse_geocoder.hpp \
     search_common.hpp \
     search_engine.hpp \
     search_query.hpp \
     search_query_factory.hpp \
     search_query_params.hpp \
+    search_server.hpp \
     search_string_intersection.hpp \
+    suggests_index.hpp \
 
 SOURCES += \
     approximate_string_match.cpp \
+    engine_data.cpp \
     geometry_utils.cpp \
     house_detector.cpp \
     intermediate_result.cpp \
@@ -42,8 +48,12 @@ SOURCES += \
     locality_finder.cpp \
     params.cpp \
     query_saver.cpp \
+    query_trace.cpp \
     result.cpp \
     retrieval.cpp \
+    reverse_geocoder.cpp \
     search_engine.cpp \
     search_query.cpp \
     search_query_params.cpp \
+    search_server.cpp \
+    suggests_index.cpp \
@@ -0,0 +1,393 @@
+// Replays the recorded search queries in the local maps by several search engines at once and
+// reports the latencies, the throughput, the memory and the stability of the top results.
+//
+// Queries file has "locale<tab>query[<tab>minLat,minLon,maxLat,maxLon]" lines, the whole world
+// is the viewport when it isn't set. Top results of each query are written to --output and they
+// are compared with the ones of --baseline, so the relevance changes are seen between the builds.
+//
+// --mmap_policies overrides the access hints of the mapped sections, e.g. "sdx=random+hugepages",
+// so their effect on the latencies is measured.
+
+#include "search/params.hpp"
+#include "search/result.hpp"
+#include "search/search_engine.hpp"
+#include "search/search_query_factory.hpp"
+#include "search/search_server.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/index.hpp"
+#include "indexer/mercator.hpp"
+
+#include "platform/local_country_file_utils.hpp"
+#include "platform/platform.hpp"
+
+#include "coding/mmap_policy.hpp"
+
+#include "base/logging.hpp"
+#include "base/stats.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
+#include "base/tracing.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+#include "std/condition_variable.hpp"
+#include "std/fstream.hpp"
+#include "std/iomanip.hpp"
+#include "std/iostream.hpp"
+#include "std/mutex.hpp"
+#include "std/sstream.hpp"
+#include "std/thread.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+#include "3party/gflags/src/gflags/gflags.h"
+
+DEFINE_string(queries, "", "File with \"locale<tab>query[<tab>minLat,minLon,maxLat,maxLon]\" lines");
+DEFINE_int32(threads, 1, "Number of the search engines which run the queries at once");
+DEFINE_int32(runs, 2, "How many times each query is run, the top results of the runs are compared");
+DEFINE_int32(top, 5, "Number of the top results which are compared");
+DEFINE_string(output, "", "File to write the top results of the queries to");
+DEFINE_string(baseline, "", "File with the top results written by --output of a previous run");
+DEFINE_string(chrome_trace, "", "File to write the Chrome trace of the measured queries to");
+DEFINE_bool(server, false, "Run the queries by one SearchServer with --threads workers");
+DEFINE_double(timeout, 10.0, "Deadline of a query in seconds for --server");
+DEFINE_string(mmap_policies, "",
+              "Policies of the mapped sections instead of the default ones, like "
+              "\"sdx=random+hugepages,mercedes=populate\"");
+
+namespace
+{
+struct Query
+{
+  string m_locale;
+  string m_query;
+  m2::RectD m_viewport;
+};
+
+/// Top results of a query, one string per result.
+typedef vector<string> TTopResults;
+
+struct QueryStats
+{
+  vector<double> m_seconds;
+  vector<TTopResults> m_runs;
+};
+
+/// Splits s by the delimiter, the empty parts are kept.
+void Split(string const & s, char delimiter, vector<string> & parts)
+{
+  parts.clear();
+  size_t begin = 0;
+  while (true)
+  {
+    size_t const end = s.find(delimiter, begin);
+    parts.push_back(s.substr(begin, end == string::npos ? string::npos : end - begin));
+    if (end == string::npos)
+      return;
+    begin = end + 1;
+  }
+}
+
+bool ParseViewport(string const & s, m2::RectD & viewport)
+{
+  vector<string> parts;
+  Split(s, ',', parts);
+  if (parts.size() != 4)
+    return false;
+  double coords[4];
+  for (size_t i = 0; i < 4; ++i)
+  {
+    if (!strings::to_double(parts[i], coords[i]))
+      return false;
+  }
+  viewport = MercatorBounds::FromLatLonRect(m2::RectD(coords[1], coords[0], coords[3], coords[2]));
+  return true;
+}
+
+void ReadQueries(string const & path, vector<Query> & queries)
+{
+  ifstream stream(path);
+  string line;
+  while (getline(stream, line))
+  {
+    vector<string> parts;
+    Split(line, '\t', parts);
+    if (parts.size() < 2 || parts[1].empty())
+      continue;
+
+    Query query;
+    query.m_locale = parts[0];
+    query.m_query = parts[1];
+    query.m_viewport = MercatorBounds::FullRect();
+    if (parts.size() > 2 && !ParseViewport(parts[2], query.m_viewport))
+      LOG(LWARNING, ("Bad viewport of", line));
+    queries.push_back(query);
+  }
+}
+
+string ToString(search::Result const & result)
+{
+  ostringstream out;
+  out << result.GetString() << "|" << result.GetFeatureType() << "|" << result.GetRegionString();
+  return out.str();
+}
+
+/// Runs the queries one by one and waits for each one.
+class Runner
+{
+public:
+  Runner(Index const & index)
+    : m_engine(&index, GetPlatform().GetReader(SEARCH_CATEGORIES_FILE_NAME),
+               GetPlatform().GetReader(PACKED_POLYGONS_FILE),
+               GetPlatform().GetReader(COUNTRIES_FILE), "en",
+               make_unique<search::SearchQueryFactory>())
+  {
+  }
+
+  void Run(Query const & query, size_t topCount, double & seconds, TTopResults & top)
+  {
+    m_done = false;
+    search::Results last;
+
+    search::SearchParams params;
+    params.m_query = query.m_query;
+    params.m_inputLocale = query.m_locale;
+    params.SetForceSearch(true);
+    params.m_callback = [&](search::Results const & results)
+    {
+      lock_guard<mutex> lock(m_mutex);
+      if (results.IsEndMarker())
+      {
+        m_done = true;
+        m_cv.notify_one();
+        return;
+      }
+      // Each emit has all the results which are found by now.
+      last = results;
+    };
+
+    my::Timer timer;
+    if (m_engine.Search(params, query.m_viewport))
+    {
+      unique_lock<mutex> lock(m_mutex);
+      m_cv.wait(lock, [this]() { return m_done; });
+    }
+    seconds = timer.ElapsedSeconds();
+
+    top.clear();
+    for (size_t i = 0; i < last.GetCount() && top.size() < topCount; ++i)
+      top.push_back(ToString(last.GetResult(i)));
+  }
+
+private:
+  search::Engine m_engine;
+  mutex m_mutex;
+  condition_variable m_cv;
+  bool m_done;
+};
+
+/// Runs the query by the server and waits for it.
+void RunOnServer(search::SearchServer & server, Query const & query, size_t topCount,
+                 double & seconds, TTopResults & top)
+{
+  search::SearchServer::Request request;
+  request.m_query = query.m_query;
+  request.m_locale = query.m_locale;
+  request.m_viewport = query.m_viewport;
+  request.m_timeoutSeconds = FLAGS_timeout;
+
+  my::Timer timer;
+  search::Results results;
+  if (!server.Search(request, results))
+    LOG(LWARNING, ("Query is cancelled:", query.m_query));
+  seconds = timer.ElapsedSeconds();
+
+  top.clear();
+  for (size_t i = 0; i < results.GetCount() && top.size() < topCount; ++i)
+    top.push_back(ToString(results.GetResult(i)));
+}
+
+void WriteTopResults(string const & path, vector<Query> const & queries,
+                     vector<QueryStats> const & stats)
+{
+  ofstream stream(path);
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    stream << queries[i].m_query;
+    for (string const & result : stats[i].m_runs.front())
+      stream << '\t' << result;
+    stream << '\n';
+  }
+}
+
+/// @return count of the queries which have the same top results as in the baseline.
+size_t CompareWithBaseline(string const & path, vector<Query> const & queries,
+                           vector<QueryStats> const & stats, size_t & comparedCount)
+{
+  ifstream stream(path);
+  string line;
+  size_t sameCount = 0;
+  comparedCount = 0;
+  for (size_t i = 0; i < queries.size() && getline(stream, line); ++i)
+  {
+    vector<string> parts;
+    Split(line, '\t', parts);
+    if (parts.empty() || parts[0] != queries[i].m_query)
+    {
+      LOG(LWARNING, ("Baseline doesn't match the queries at line", i + 1));
+      break;
+    }
+
+    ++comparedCount;
+    TTopResults const baseline(parts.begin() + 1, parts.end());
+    if (baseline == stats[i].m_runs.front())
+      ++sameCount;
+    else
+      LOG(LINFO, ("Top results are changed for", queries[i].m_query, baseline, stats[i].m_runs.front()));
+  }
+  return sameCount;
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  google::SetUsageMessage("Search quality and latency benchmark over the recorded queries");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (!mmap_policy::SetOverrides(FLAGS_mmap_policies))
+  {
+    cerr << "Bad --mmap_policies \"" << FLAGS_mmap_policies << "\"" << endl;
+    return 1;
+  }
+
+  vector<Query> queries;
+  ReadQueries(FLAGS_queries, queries);
+  if (queries.empty())
+  {
+    cout << "No queries" << endl;
+    return 1;
+  }
+
+  classificator::Load();
+
+  Index index;
+  vector<platform::LocalCountryFile> localFiles;
+  platform::FindAllLocalMaps(localFiles);
+  for (platform::LocalCountryFile & localFile : localFiles)
+  {
+    localFile.SyncWithDisk();
+    if (index.RegisterMap(localFile).second != MwmSet::RegResult::Success)
+      LOG(LWARNING, ("Can't register", localFile));
+  }
+
+  size_t const threadsCount = static_cast<size_t>(max(FLAGS_threads, 1));
+  size_t const runsCount = static_cast<size_t>(max(FLAGS_runs, 1));
+  size_t const topCount = static_cast<size_t>(max(FLAGS_top, 1));
+
+  // Either one server runs the queries of all the threads or each thread has its own engine.
+  unique_ptr<search::SearchServer> server;
+  vector<unique_ptr<Runner>> runners;
+  if (FLAGS_server)
+  {
+    server.reset(new search::SearchServer(index, GetPlatform().GetReader(SEARCH_CATEGORIES_FILE_NAME),
+                                          GetPlatform().GetReader(PACKED_POLYGONS_FILE),
+                                          GetPlatform().GetReader(COUNTRIES_FILE), threadsCount));
+  }
+  else
+  {
+    for (size_t i = 0; i < threadsCount; ++i)
+      runners.emplace_back(new Runner(index));
+  }
+  auto const run = [&](size_t thread, Query const & query, double & seconds, TTopResults & top)
+  {
+    if (server)
+      RunOnServer(*server, query, topCount, seconds, top);
+    else
+      runners[thread]->Run(query, topCount, seconds, top);
+  };
+
+  // Each query is run by runsCount tasks, the tasks of a run go one after another.
+  vector<QueryStats> stats(queries.size());
+  for (QueryStats & s : stats)
+  {
+    s.m_seconds.resize(runsCount);
+    s.m_runs.resize(runsCount);
+  }
+
+  // One query is run before the measured ones, it creates the offsets tables of the mwms and
+  // warms up the caches.
+  {
+    double seconds;
+    TTopResults top;
+    run(0, queries.front(), seconds, top);
+  }
+
+  if (!FLAGS_chrome_trace.empty())
+    my::tracing::Start();
+
+  atomic<size_t> next(0);
+  size_t const tasksCount = queries.size() * runsCount;
+  my::Timer timer;
+  vector<thread> threads;
+  for (size_t i = 0; i < threadsCount; ++i)
+  {
+    threads.emplace_back([&, i]()
+    {
+      my::tracing::SetThreadName("Runner " + strings::to_string(i));
+      for (size_t task = next++; task < tasksCount; task = next++)
+      {
+        size_t const query = task % queries.size();
+        size_t const runIndex = task / queries.size();
+        run(i, queries[query], stats[query].m_seconds[runIndex], stats[query].m_runs[runIndex]);
+      }
+    });
+  }
+  for (thread & t : threads)
+    t.join();
+  double const totalSeconds = timer.ElapsedSeconds();
+
+  if (!FLAGS_chrome_trace.empty())
+  {
+    my::tracing::Stop();
+    if (!my::tracing::WriteChromeTrace(FLAGS_chrome_trace))
+      LOG(LWARNING, ("Can't write the trace to", FLAGS_chrome_trace));
+  }
+
+  vector<double> times;
+  size_t stableCount = 0;
+  for (QueryStats const & s : stats)
+  {
+    times.insert(times.end(), s.m_seconds.begin(), s.m_seconds.end());
+    if (all_of(s.m_runs.begin(), s.m_runs.end(),
+               [&s](TTopResults const & top) { return top == s.m_runs.front(); }))
+    {
+      ++stableCount;
+    }
+  }
+  sort(times.begin(), times.end());
+
+  size_t const count = 1000;
+  cout << fixed << setprecision(3);
+  cout << "QUERY*1000[ p50:" << my::GetPercentile(times, 0.5) * count
+       << " p95:" << my::GetPercentile(times, 0.95) * count
+       << " p99:" << my::GetPercentile(times, 0.99) * count
+       << " max:" << times.back() * count << " ]" << endl;
+  cout << "THROUGHPUT[ queries:" << times.size() << " threads:" << threadsCount
+       << " per second:" << times.size() / totalSeconds << " ]" << endl;
+  cout << "MEMORY[ peak MB:" << my::GetPeakRssBytes() / (1024.0 * 1024.0) << " ]" << endl;
+  cout << "STABILITY[ same top " << topCount << " in " << runsCount << " runs:" << stableCount
+       << " of " << stats.size() << " ]" << endl;
+
+  if (!FLAGS_baseline.empty())
+  {
+    size_t comparedCount = 0;
+    size_t const sameCount = CompareWithBaseline(FLAGS_baseline, queries, stats, comparedCount);
+    cout << "BASELINE[ same top:" << sameCount << " of " << comparedCount << " ]" << endl;
+  }
+
+  if (!FLAGS_output.empty())
+    WriteTopResults(FLAGS_output, queries, stats);
+
+  return 0;
+}
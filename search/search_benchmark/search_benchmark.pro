@@ -0,0 +1,21 @@
+# Search quality and latency benchmark over the recorded queries.
+
+TARGET = search_benchmark
+CONFIG += console warn_on
+CONFIG -= app_bundle
+TEMPLATE = app
+
+ROOT_DIR = ../..
+DEPENDENCIES = search storage indexer platform geometry coding base \
+               gflags jansson protobuf tomcrypt stats_client
+
+include($$ROOT_DIR/common.pri)
+
+INCLUDEPATH *= $$ROOT_DIR/3party/gflags/src
+
+QT *= core
+
+macx-*: LIBS *= "-framework IOKit"
+
+SOURCES += \
+    search_benchmark.cpp \
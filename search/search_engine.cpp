@@ -1,4 +1,5 @@
 #include "search_engine.hpp"
+#include "engine_data.hpp"
 #include "search_query.hpp"
 #include "geometry_utils.hpp"
 
@@ -14,7 +15,10 @@
 
 #include "geometry/distance_on_sphere.hpp"
 
+#include "base/logging.hpp"
 #include "base/stl_add.hpp"
+#include "base/timer.hpp"
+#include "base/tracing.hpp"
 
 #include "std/map.hpp"
 #include "std/vector.hpp"
@@ -28,65 +32,16 @@ namespace search
 
 double const DIST_EQUAL_QUERY = 100.0;
 
-using TSuggestsContainer = vector<Query::TSuggest>;
-
-class EngineData
-{
-public:
-  EngineData(Reader * pCategoriesR, ModelReaderPtr polyR, ModelReaderPtr countryR)
-    : m_categories(pCategoriesR), m_infoGetter(polyR, countryR)
-  {
-  }
-
-  CategoriesHolder m_categories;
-  TSuggestsContainer m_stringsToSuggest;
-  storage::CountryInfoGetter m_infoGetter;
-};
-
-namespace
-{
-
-class InitSuggestions
-{
-  using TSuggestMap = map<pair<strings::UniString, int8_t>, uint8_t>;
-  TSuggestMap m_suggests;
-
-public:
-  void operator() (CategoriesHolder::Category::Name const & name)
-  {
-    if (name.m_prefixLengthToSuggest != CategoriesHolder::Category::EMPTY_PREFIX_LENGTH)
-    {
-      strings::UniString const uniName = NormalizeAndSimplifyString(name.m_name);
-
-      uint8_t & score = m_suggests[make_pair(uniName, name.m_locale)];
-      if (score == 0 || score > name.m_prefixLengthToSuggest)
-        score = name.m_prefixLengthToSuggest;
-    }
-  }
-
-  void GetSuggests(TSuggestsContainer & cont) const
-  {
-    cont.reserve(m_suggests.size());
-    for (TSuggestMap::const_iterator i = m_suggests.begin(); i != m_suggests.end(); ++i)
-      cont.push_back(Query::TSuggest(i->first.first, i->second, i->first.second));
-  }
-};
-
-}
-
 Engine::Engine(IndexType const * pIndex, Reader * pCategoriesR, ModelReaderPtr polyR,
                ModelReaderPtr countryR, string const & locale,
                unique_ptr<SearchQueryFactory> && factory)
-    : m_pFactory(move(factory)), m_pData(new EngineData(pCategoriesR, polyR, countryR))
+    : m_resultsVersion(0), m_pFactory(move(factory)),
+      m_pData(new EngineData(pCategoriesR, polyR, countryR))
 {
   m_isReadyThread.clear();
 
-  InitSuggestions doInit;
-  m_pData->m_categories.ForEachName(bind<void>(ref(doInit), _1));
-  doInit.GetSuggests(m_pData->m_stringsToSuggest);
-
   m_pQuery = m_pFactory->BuildSearchQuery(pIndex, &m_pData->m_categories,
-                                          &m_pData->m_stringsToSuggest, &m_pData->m_infoGetter);
+                                          &m_pData->m_suggests, &m_pData->m_infoGetter);
   m_pQuery->SetPreferredLocale(locale);
 }
 
@@ -160,6 +115,7 @@ void Engine::EmitResults(SearchParams const & params, Results & res)
   alohalytics::LogEvent("searchEmitResults",
                         alohalytics::TStringMap({{params.m_query, strings::to_string(res.GetCount())}}));
 
+  res.SetVersion(++m_resultsVersion);
   params.m_callback(res);
 }
 
@@ -181,6 +137,7 @@ void Engine::SetRankPivot(SearchParams const & params,
 
 void Engine::SearchAsync()
 {
+  TRACE_SCOPE("search", "Engine::SearchAsync");
   if (m_isReadyThread.test_and_set())
     return;
 
@@ -209,6 +166,8 @@ void Engine::SearchAsync()
 
   bool const viewportSearch = params.HasSearchMode(SearchParams::IN_VIEWPORT_ONLY);
 
+  my::Timer timer;
+
   // Initialize query.
   m_pQuery->Init(viewportSearch);
 
@@ -222,6 +181,20 @@ void Engine::SearchAsync()
   ASSERT(!params.m_query.empty(), ());
   m_pQuery->SetQuery(params.m_query);
 
+  m_resultsVersion = 0;
+  if (params.m_preliminaryCallback)
+  {
+    m_pQuery->SetPreliminaryCallback([this, &params](Results & res)
+    {
+      res.SetVersion(++m_resultsVersion);
+      params.m_preliminaryCallback(res);
+    });
+  }
+  else
+  {
+    m_pQuery->SetPreliminaryCallback(Query::TPreliminaryCallback());
+  }
+
   Results res;
 
   // Call m_pQuery->IsCanceled() everywhere it needed without storing return value.
@@ -284,8 +257,22 @@ void Engine::SearchAsync()
       EmitResults(params, res);
   }
 
+  QueryTrace & trace = m_pQuery->GetTrace();
+  trace.m_query = params.m_query;
+  trace.m_totalSeconds = timer.ElapsedSeconds();
+  trace.m_resultsCount = static_cast<uint32_t>(res.GetCount());
+  trace.m_isCancelled = m_pQuery->IsCancelled();
+  LOG(LDEBUG, (trace));
+  if (params.m_traceCallback)
+    params.m_traceCallback(trace);
+
+  // The callback captures the params of this query.
+  m_pQuery->SetPreliminaryCallback(Query::TPreliminaryCallback());
+
   // Emit finish marker to client.
-  params.m_callback(Results::GetEndMarker(m_pQuery->IsCancelled()));
+  Results endMarker = Results::GetEndMarker(m_pQuery->IsCancelled());
+  endMarker.SetVersion(m_resultsVersion);
+  params.m_callback(endMarker);
 }
 
 string Engine::GetCountryFile(m2::PointD const & pt)
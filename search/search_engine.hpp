@@ -73,6 +73,9 @@ private:
   threads::Mutex m_searchMutex, m_updateMutex;
   atomic_flag m_isReadyThread;
 
+  /// Version of the last results of the current query, it's guarded by m_searchMutex.
+  uint32_t m_resultsVersion;
+
   SearchParams m_params;
   m2::RectD m_viewport;
 
@@ -247,3 +247,86 @@ UNIT_TEST(Retrieval_3Mwms)
     TEST_EQUAL(3, callback.GetNumFeatures(), ());
   }
 }
+
+UNIT_TEST(Retrieval_TokensCache)
+{
+  classificator::Load();
+  Platform & platform = GetPlatform();
+
+  platform::LocalCountryFile file(platform.WritableDir(), platform::CountryFile("BeerTown"), 0);
+  MY_SCOPE_GUARD(deleteFile, [&]()
+  {
+    file.DeleteFromDisk(MapOptions::Map);
+  });
+
+  {
+    TestMwmBuilder builder(file);
+    for (int x = 0; x < 5; ++x)
+    {
+      builder.AddPOI(m2::PointD(x, 0), "Beer bar", "en");
+      builder.AddPOI(m2::PointD(x, 1), "Beer shop", "en");
+    }
+  }
+
+  Index index;
+  auto p = index.RegisterMap(file);
+  auto & id = p.first;
+  TEST(id.IsAlive(), ());
+
+  vector<shared_ptr<MwmInfo>> infos;
+  index.GetMwmsInfo(infos);
+
+  search::Retrieval retrieval;
+  m2::RectD const viewport(m2::PointD(0, 0), m2::PointD(1, 1));
+
+  auto retrieve = [&](string const & query, vector<uint32_t> & offsets)
+  {
+    search::SearchQueryParams params;
+    InitParams(query, params);
+
+    TestCallback callback(id);
+    retrieval.Init(index, infos, viewport, params, search::Retrieval::Limits());
+    retrieval.Go(callback);
+    offsets.swap(callback.Offsets());
+    sort(offsets.begin(), offsets.end());
+  };
+
+  auto const & cache = retrieval.GetTokensCache();
+
+  vector<uint32_t> beerBars;
+  retrieve("beer bar", beerBars);
+  TEST_EQUAL(5, beerBars.size(), ());
+  TEST_EQUAL(0, cache.GetNumHits(), ());
+  TEST_EQUAL(2, cache.GetNumMisses(), ());
+  TEST_EQUAL(2, cache.GetSize(), ());
+
+  // Both tokens must be taken from the cache.
+  {
+    vector<uint32_t> offsets;
+    retrieve("beer bar", offsets);
+    TEST_EQUAL(beerBars, offsets, ());
+    TEST_EQUAL(2, cache.GetNumHits(), ());
+    TEST_EQUAL(2, cache.GetNumMisses(), ());
+  }
+
+  // Only "shop" must be read from the search index.
+  {
+    vector<uint32_t> offsets;
+    retrieve("beer shop", offsets);
+    TEST_EQUAL(5, offsets.size(), ());
+    TEST_EQUAL(3, cache.GetNumHits(), ());
+    TEST_EQUAL(3, cache.GetNumMisses(), ());
+    TEST_EQUAL(3, cache.GetSize(), ());
+  }
+
+  // Unknown tokens are cached too.
+  {
+    vector<uint32_t> offsets;
+    retrieve("beer pub", offsets);
+    TEST(offsets.empty(), ());
+    retrieve("beer pub", offsets);
+    TEST(offsets.empty(), ());
+    TEST_EQUAL(6, cache.GetNumHits(), ());
+    TEST_EQUAL(4, cache.GetNumMisses(), ());
+  }
+}
@@ -0,0 +1,118 @@
+#include "testing/testing.hpp"
+
+#include "search/reverse_geocoder.hpp"
+#include "search/search_integration_tests/test_mwm_builder.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/index.hpp"
+#include "indexer/scales.hpp"
+
+#include "platform/country_defines.hpp"
+#include "platform/local_country_file.hpp"
+#include "platform/local_country_file_utils.hpp"
+#include "platform/platform.hpp"
+
+#include "std/vector.hpp"
+
+using search::ReverseGeocoder;
+
+namespace
+{
+class ScopedMapFile
+{
+public:
+  explicit ScopedMapFile(string const & name)
+      : m_file(GetPlatform().TmpDir(), platform::CountryFile(name), 0)
+  {
+    platform::CountryIndexes::DeleteFromDisk(m_file);
+  }
+
+  ~ScopedMapFile()
+  {
+    platform::CountryIndexes::DeleteFromDisk(m_file);
+    m_file.DeleteFromDisk(MapOptions::Map);
+  }
+
+  inline platform::LocalCountryFile & GetFile() { return m_file; }
+
+private:
+  platform::LocalCountryFile m_file;
+};
+}  // namespace
+
+UNIT_TEST(ReverseGeocoder_Smoke)
+{
+  classificator::Load();
+  ScopedMapFile scopedFile("RevGeoTown");
+  platform::LocalCountryFile & file = scopedFile.GetFile();
+
+  {
+    TestMwmBuilder builder(file);
+    // Cells borders are on the zero meridian and the equator, so the features are
+    // looked up in the cells of the neighbours too.
+    builder.AddPOI(m2::PointD(0.0, 0.0), "Central station", "en");
+    builder.AddPOI(m2::PointD(0.02, 0.02), "Far station", "en");
+    builder.AddStreet({m2::PointD(-0.001, 0.0005), m2::PointD(0.001, 0.0005)}, "Baker street",
+                      "en");
+  }
+
+  Index index;
+  auto const ret = index.RegisterMap(file);
+  TEST_EQUAL(MwmSet::RegResult::Success, ret.second, ());
+
+  {
+    // Geocoder filters the features by their scales from the mwm.
+    Index::MwmHandle const handle = index.GetMwmHandleById(ret.first);
+    MwmValue const * value = handle.GetValue<MwmValue>();
+    TEST(value != nullptr, ());
+    TEST(value->m_scalesTable != nullptr, ());
+    TEST_EQUAL(value->m_scalesTable->GetCount(), 3, ());
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+      feature::ScalesTable::Ranges ranges;
+      TEST(value->m_scalesTable->Get(i, ranges), (i));
+      TEST(my::between_s(ranges.m_labels.first, ranges.m_labels.second, scales::GetUpperScale()), (i));
+    }
+  }
+
+  ReverseGeocoder geocoder(index);
+  ReverseGeocoder::Address address;
+
+  geocoder.ReverseGeocode(m2::PointD(0.00005, 0.00005), address);
+  TEST_EQUAL(address.m_name, "Central station", ());
+  TEST_EQUAL(address.m_street, "Baker street", ());
+  TEST(!address.m_types.Empty(), ());
+
+  geocoder.ReverseGeocode(m2::PointD(-0.00005, -0.00005), address);
+  TEST_EQUAL(address.m_name, "Central station", ());
+  TEST_EQUAL(address.m_street, "Baker street", ());
+
+  // POIs are within 15 m, but streets are within 100 m.
+  geocoder.ReverseGeocode(m2::PointD(0.0, 0.0008), address);
+  TEST(address.m_name.empty(), ());
+  TEST(address.m_types.Empty(), ());
+  TEST_EQUAL(address.m_street, "Baker street", ());
+
+  geocoder.ReverseGeocode(m2::PointD(0.01, 0.01), address);
+  TEST(address.m_name.empty(), ());
+  TEST(address.m_street.empty(), ());
+
+  vector<m2::PointD> const points = {m2::PointD(0.02, 0.02), m2::PointD(0.00005, 0.00005),
+                                     m2::PointD(0.01, 0.01), m2::PointD(-0.00005, 0.0008),
+                                     m2::PointD(0.02, 0.02001)};
+  vector<ReverseGeocoder::Address> addresses;
+  geocoder.ReverseGeocode(points, addresses);
+  TEST_EQUAL(addresses.size(), points.size(), ());
+
+  geocoder.ClearCache();
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    geocoder.ReverseGeocode(points[i], address);
+    TEST_EQUAL(addresses[i].m_name, address.m_name, (points[i]));
+    TEST_EQUAL(addresses[i].m_street, address.m_street, (points[i]));
+    TEST_EQUAL(addresses[i].m_house, address.m_house, (points[i]));
+  }
+  TEST_EQUAL(addresses[0].m_name, "Far station", ());
+  TEST_EQUAL(addresses[4].m_name, "Far station", ());
+  TEST_EQUAL(addresses[3].m_street, "Baker street", ());
+}
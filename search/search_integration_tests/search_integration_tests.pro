@@ -23,6 +23,7 @@ macx-*: LIBS *= "-framework IOKit"
 SOURCES += \
     ../../testing/testingmain.cpp \
     retrieval_test.cpp \
+    reverse_geocoder_test.cpp \
     smoke_test.cpp \
     test_mwm_builder.cpp \
     test_search_engine.cpp \
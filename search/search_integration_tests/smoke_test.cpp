@@ -7,12 +7,20 @@
 #include "search/search_integration_tests/test_search_engine.hpp"
 #include "search/search_integration_tests/test_search_request.hpp"
 
+#include "search/params.hpp"
+#include "search/result.hpp"
+
 #include "platform/country_defines.hpp"
 #include "platform/country_file.hpp"
 #include "platform/local_country_file.hpp"
 #include "platform/local_country_file_utils.hpp"
 #include "platform/platform.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/condition_variable.hpp"
+#include "std/mutex.hpp"
+#include "std/vector.hpp"
+
 namespace
 {
 class ScopedMapFile
@@ -77,6 +85,14 @@ UNIT_TEST(GenerateTestMwm_Smoke)
                               m2::RectD(m2::PointD(0, 0), m2::PointD(100, 100)));
     request.Wait();
     TEST_EQUAL(1, request.Results().size(), ());
+
+    search::QueryTrace const & trace = request.Trace();
+    TEST_EQUAL(trace.m_query, "wine ", ());
+    TEST_EQUAL(trace.m_resultsCount, 1, ());
+    TEST_GREATER_OR_EQUAL(trace.m_featuresLoaded, 1, ());
+    TEST_GREATER_OR_EQUAL(trace.m_mwmsSearched, 1, ());
+    TEST_GREATER_OR_EQUAL(trace.m_totalSeconds,
+                          trace.m_phaseSeconds[search::QueryTrace::PHASE_SEARCH_FEATURES], ());
   }
 
   {
@@ -130,3 +146,134 @@ UNIT_TEST(GenerateTestMwm_NotPrefixFreeNames)
     TEST_EQUAL(3, request.Results().size(), ());
   }
 }
+
+UNIT_TEST(GenerateTestMwm_ParallelSearch)
+{
+  classificator::Load();
+  ScopedMapFile scopedFile1("BeerTown");
+  ScopedMapFile scopedFile2("CiderTown");
+  ScopedMapFile scopedFile3("MeadTown");
+
+  {
+    TestMwmBuilder builder(scopedFile1.GetFile());
+    builder.AddPOI(m2::PointD(0, 0), "Beer shop", "en");
+    builder.AddPOI(m2::PointD(0, 1), "Beer bar", "en");
+  }
+  {
+    TestMwmBuilder builder(scopedFile2.GetFile());
+    builder.AddPOI(m2::PointD(1, 0), "Cider shop", "en");
+    builder.AddPOI(m2::PointD(1, 1), "Cider bar", "en");
+  }
+  {
+    TestMwmBuilder builder(scopedFile3.GetFile());
+    builder.AddPOI(m2::PointD(2, 0), "Mead shop", "en");
+  }
+
+  TestSearchEngine engine("en" /* locale */);
+  for (ScopedMapFile * file : {&scopedFile1, &scopedFile2, &scopedFile3})
+  {
+    auto ret = engine.RegisterMap(file->GetFile());
+    TEST_EQUAL(MwmSet::RegResult::Success, ret.second, ("Can't register generated map."));
+  }
+
+  m2::RectD const viewport(m2::PointD(0, 0), m2::PointD(100, 100));
+  for (size_t threadsCount : {0, 4})
+  {
+    engine.SetQueryThreadsCount(threadsCount);
+    {
+      TestSearchRequest request(engine, "shop ", "en", viewport);
+      request.Wait();
+      TEST_EQUAL(3, request.Results().size(), (threadsCount));
+    }
+    {
+      TestSearchRequest request(engine, "bar ", "en", viewport);
+      request.Wait();
+      TEST_EQUAL(2, request.Results().size(), (threadsCount));
+    }
+  }
+}
+
+UNIT_TEST(GenerateTestMwm_ViewportCells)
+{
+  classificator::Load();
+  ScopedMapFile scopedFile("CoffeeTown");
+  platform::LocalCountryFile & file = scopedFile.GetFile();
+
+  {
+    TestMwmBuilder builder(file);
+    builder.AddPOI(m2::PointD(0, 0), "Coffee shop", "en");
+    builder.AddPOI(m2::PointD(10, 10), "Coffee bar", "en");
+    builder.AddPOI(m2::PointD(20, 20), "Coffee house", "en");
+    // The street crosses the viewport, but its points are far from it.
+    builder.AddStreet({m2::PointD(0, 20), m2::PointD(20, 0)}, "Coffee street", "en");
+  }
+
+  TestSearchEngine engine("en" /* locale */);
+  auto ret = engine.RegisterMap(file);
+  TEST_EQUAL(MwmSet::RegResult::Success, ret.second, ("Can't register generated map."));
+
+  TestSearchRequest request(engine, "coff", "en",
+                            m2::RectD(m2::PointD(9.5, 9.5), m2::PointD(10.5, 10.5)));
+  request.Wait();
+  TEST_EQUAL(2, request.Results().size(), ());
+}
+
+UNIT_TEST(GenerateTestMwm_PreliminaryResults)
+{
+  classificator::Load();
+  ScopedMapFile scopedFile("TeaTown");
+  platform::LocalCountryFile & file = scopedFile.GetFile();
+
+  {
+    TestMwmBuilder builder(file);
+    builder.AddPOI(m2::PointD(0, 0), "Tea shop", "en");
+    builder.AddPOI(m2::PointD(1, 1), "Tea house", "en");
+  }
+
+  TestSearchEngine engine("en" /* locale */);
+  auto ret = engine.RegisterMap(file);
+  TEST_EQUAL(MwmSet::RegResult::Success, ret.second, ("Can't register generated map."));
+
+  mutex mu;
+  condition_variable cv;
+  bool done = false;
+  size_t preliminaryCount = 0;
+  vector<uint32_t> versions;
+  search::Results last;
+
+  search::SearchParams params;
+  params.m_query = "tea ";
+  params.m_inputLocale = "en";
+  params.SetSearchMode(search::SearchParams::ALL);
+  params.m_preliminaryCallback = [&](search::Results const & results)
+  {
+    lock_guard<mutex> lock(mu);
+    preliminaryCount = max(preliminaryCount, results.GetCount());
+    versions.push_back(results.GetVersion());
+  };
+  params.m_callback = [&](search::Results const & results)
+  {
+    lock_guard<mutex> lock(mu);
+    if (!results.IsEndMarker())
+    {
+      versions.push_back(results.GetVersion());
+      last = results;
+      return;
+    }
+    TEST(versions.empty() || versions.back() == results.GetVersion(), ());
+    done = true;
+    cv.notify_one();
+  };
+  TEST(engine.Search(params, m2::RectD(m2::PointD(-1, -1), m2::PointD(2, 2))), ());
+
+  unique_lock<mutex> lock(mu);
+  cv.wait(lock, [&done]() { return done; });
+
+  // The results of the viewport come first, the refined ones follow with the higher versions.
+  TEST_EQUAL(2, preliminaryCount, ());
+  TEST_EQUAL(2, last.GetCount(), ());
+  TEST_GREATER(versions.size(), 1, ());
+  for (size_t i = 1; i < versions.size(); ++i)
+    TEST_LESS(versions[i - 1], versions[i], (versions));
+  TEST_EQUAL(versions.back(), last.GetVersion(), ());
+}
@@ -7,6 +7,8 @@
 
 #include "generator/feature_builder.hpp"
 #include "generator/feature_generator.hpp"
+#include "generator/feature_attributes_generator.hpp"
+#include "generator/feature_scales_generator.hpp"
 #include "generator/feature_sorter.hpp"
 
 #include "platform/local_country_file.hpp"
@@ -40,6 +42,19 @@ void TestMwmBuilder::AddPOI(m2::PointD const & p, string const & name, string co
   (*m_collector)(fb);
 }
 
+void TestMwmBuilder::AddStreet(vector<m2::PointD> const & points, string const & name,
+                               string const & lang)
+{
+  CHECK(m_collector, ("It's not possible to add features after call to Finish()."));
+  FeatureBuilder1 fb;
+  for (m2::PointD const & p : points)
+    fb.AddPoint(p);
+  fb.SetLinear();
+  fb.SetType(m_classificator.GetTypeByPath({"highway", "residential"}));
+  CHECK(fb.AddName(lang, name), ("Can't set feature name:", name, "(", lang, ")"));
+  (*m_collector)(fb);
+}
+
 void TestMwmBuilder::Finish()
 {
   CHECK(m_collector, ("Finish() already was called."));
@@ -53,6 +68,10 @@ void TestMwmBuilder::Finish()
   CHECK(indexer::BuildIndexFromDatFile(m_file.GetPath(MapOptions::Map),
                                        m_file.GetPath(MapOptions::Map)),
         ("Can't build geometry index."));
+  CHECK(feature::BuildScalesTableFromDatFile(m_file.GetPath(MapOptions::Map)),
+        ("Can't build feature scales."));
+  CHECK(feature::BuildAttributesTableFromDatFile(m_file.GetPath(MapOptions::Map)),
+        ("Can't build feature attributes."));
   CHECK(indexer::BuildSearchIndexFromDatFile(m_file.GetPath(MapOptions::Map),
                                              true /* forceRebuild */),
         ("Can't build search index."));
@@ -4,6 +4,7 @@
 
 #include "std/string.hpp"
 #include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
 
 class Classificator;
 
@@ -24,6 +25,7 @@ public:
   ~TestMwmBuilder();
 
   void AddPOI(m2::PointD const & p, string const & name, string const & lang);
+  void AddStreet(vector<m2::PointD> const & points, string const & name, string const & lang);
 
   void Finish();
 
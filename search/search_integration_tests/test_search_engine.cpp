@@ -18,9 +18,9 @@ class TestQuery : public search::Query
 {
 public:
   TestQuery(Index const * index, CategoriesHolder const * categories,
-            search::Query::TStringsToSuggestVector const * stringsToSuggest,
+            search::SuggestsIndex const * suggests,
             storage::CountryInfoGetter const * infoGetter)
-    : search::Query(index, categories, stringsToSuggest, infoGetter)
+    : search::Query(index, categories, suggests, infoGetter)
   {
   }
 
@@ -36,10 +36,10 @@ class TestSearchQueryFactory : public search::SearchQueryFactory
   // search::SearchQueryFactory overrides:
   unique_ptr<search::Query> BuildSearchQuery(
       Index const * index, CategoriesHolder const * categories,
-      search::Query::TStringsToSuggestVector const * stringsToSuggest,
+      search::SuggestsIndex const * suggests,
       storage::CountryInfoGetter const * infoGetter) override
   {
-    return make_unique<TestQuery>(index, categories, stringsToSuggest, infoGetter);
+    return make_unique<TestQuery>(index, categories, suggests, infoGetter);
   }
 };
 }  // namespace
@@ -16,6 +16,11 @@ TestSearchRequest::TestSearchRequest(TestSearchEngine & engine, string const & q
   {
     Done(results);
   };
+  params.m_traceCallback = [this](search::QueryTrace const & trace)
+  {
+    lock_guard<mutex> lock(m_mu);
+    m_trace = trace;
+  };
   params.SetSearchMode(search::SearchParams::IN_VIEWPORT_ONLY);
   CHECK(engine.Search(params, viewport), ("Can't run search."));
 }
@@ -36,6 +41,13 @@ vector<search::Result> const & TestSearchRequest::Results() const
   return m_results;
 }
 
+search::QueryTrace const & TestSearchRequest::Trace() const
+{
+  lock_guard<mutex> lock(m_mu);
+  CHECK(m_done, ("Trace can be get only when request will be completed."));
+  return m_trace;
+}
+
 void TestSearchRequest::Done(search::Results const & results)
 {
   lock_guard<mutex> lock(m_mu);
@@ -2,6 +2,7 @@
 
 #include "geometry/rect2d.hpp"
 
+#include "search/query_trace.hpp"
 #include "search/result.hpp"
 
 #include "std/condition_variable.hpp"
@@ -23,6 +24,7 @@ public:
   void Wait();
 
   vector<search::Result> const & Results() const;
+  search::QueryTrace const & Trace() const;
 
 private:
   void Done(search::Results const & results);
@@ -31,5 +33,6 @@ private:
   mutable mutex m_mu;
 
   vector<search::Result> m_results;
+  search::QueryTrace m_trace;
   bool m_done;
 };
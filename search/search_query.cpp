@@ -15,6 +15,7 @@
 #include "indexer/feature_covering.hpp"
 #include "indexer/feature_impl.hpp"
 #include "indexer/features_vector.hpp"
+#include "indexer/houses_index.hpp"
 #include "indexer/index.hpp"
 #include "indexer/scales.hpp"
 #include "indexer/search_delimiters.hpp"
@@ -23,15 +24,17 @@
 #include "platform/preferred_languages.hpp"
 
 #include "coding/multilang_utf8_string.hpp"
-#include "coding/reader_wrapper.hpp"
 
 #include "base/logging.hpp"
 #include "base/stl_add.hpp"
 #include "base/string_utils.hpp"
+#include "base/tracing.hpp"
 
 #include "std/algorithm.hpp"
 #include "std/function.hpp"
 
+#include "defines.hpp"
+
 namespace search
 {
 
@@ -69,11 +72,11 @@ TCompareFunction2 g_arrCompare2[] = {
 }
 
 Query::Query(Index const * pIndex, CategoriesHolder const * pCategories,
-             TStringsToSuggestVector const * pStringsToSuggest,
+             SuggestsIndex const * pSuggests,
              storage::CountryInfoGetter const * pInfoGetter)
   : m_pIndex(pIndex)
   , m_pCategories(pCategories)
-  , m_pStringsToSuggest(pStringsToSuggest)
+  , m_pSuggests(pSuggests)
   , m_pInfoGetter(pInfoGetter)
 #ifdef HOUSE_SEARCH_TEST
   , m_houseDetector(pIndex)
@@ -84,6 +87,7 @@ Query::Query(Index const * pIndex, CategoriesHolder const * pCategories,
   , m_worldSearch(true)
 {
   // m_viewport is initialized as empty rects
+  fill(m_viewportEpoch, m_viewportEpoch + COUNT_V, 0);
 
   ASSERT(m_pIndex, ());
 
@@ -128,21 +132,23 @@ void Query::SetViewport(m2::RectD const & viewport, bool forceUpdate)
 {
   Reset();
 
+  uint64_t const epoch = m_pIndex->GetEpoch();
   TMWMVector mwmsInfo;
   m_pIndex->GetMwmsInfo(mwmsInfo);
 
-  SetViewportByIndex(mwmsInfo, viewport, CURRENT_V, forceUpdate);
+  SetViewportByIndex(mwmsInfo, epoch, viewport, CURRENT_V, forceUpdate);
 }
 
-void Query::SetViewportByIndex(TMWMVector const & mwmsInfo, m2::RectD const & viewport, size_t idx,
-                               bool forceUpdate)
+void Query::SetViewportByIndex(TMWMVector const & mwmsInfo, uint64_t epoch,
+                               m2::RectD const & viewport, size_t idx, bool forceUpdate)
 {
   ASSERT(idx < COUNT_V, (idx));
 
   if (viewport.IsValid())
   {
-    // Check if we can skip this cache query.
-    if (m_viewport[idx].IsValid())
+    // Check if we can skip this cache query. The maps may be updated since
+    // the offsets were collected, then they're collected again.
+    if (m_viewport[idx].IsValid() && m_viewportEpoch[idx] == epoch)
     {
       // Threshold to compare for equal or inner rects.
       // It doesn't influence on result cached features because it's smaller
@@ -168,7 +174,8 @@ void Query::SetViewportByIndex(TMWMVector const & mwmsInfo, m2::RectD const & vi
     }
 
     m_viewport[idx] = viewport;
-    UpdateViewportOffsets(mwmsInfo, viewport, m_offsetsInViewport[idx]);
+    m_viewportEpoch[idx] = epoch;
+    UpdateViewportOffsets(mwmsInfo, viewport, m_offsetsInViewport[idx], m_coveringsInViewport[idx]);
 
 #ifdef FIND_LOCALITY_TEST
     m_locality.SetViewportByIndex(viewport, idx);
@@ -243,14 +250,16 @@ void Query::ClearCache(size_t ind)
   // clear cache and free memory
   TOffsetsVector emptyV;
   emptyV.swap(m_offsetsInViewport[ind]);
+  m_coveringsInViewport[ind].clear();
 
   m_viewport[ind].MakeEmpty();
 }
 
 void Query::UpdateViewportOffsets(TMWMVector const & mwmsInfo, m2::RectD const & rect,
-                                  TOffsetsVector & offsets)
+                                  TOffsetsVector & offsets, TCoveringsVector & coverings)
 {
-  offsets.clear();
+  TOffsetsVector newOffsets;
+  TCoveringsVector newCoverings;
 
   int const queryScale = GetQueryIndexScale(rect);
   covering::CoveringGetter cov(rect, covering::ViewportWithLowLevels);
@@ -272,21 +281,54 @@ void Query::UpdateViewportOffsets(TMWMVector const & mwmsInfo, m2::RectD const &
 
           covering::IntervalsT const & interval = cov.Get(header.GetLastScale());
 
-          ScaleIndex<ModelReaderPtr> index(pMwm->m_cont.GetReader(INDEX_FILE_TAG),
-                                           pMwm->m_factory);
-
-          for (size_t i = 0; i < interval.size(); ++i)
+          ScaleIndex<ModelReaderPtr> const & index = pMwm->GetScaleIndex();
+          auto const collect = [&](covering::IntervalsT const & intervals, vector<uint32_t> & res)
+          {
+            for (size_t i = 0; i < intervals.size(); ++i)
+            {
+              auto collectFn = MakeBackInsertFunctor(res);
+              index.ForEachInIntervalAndScale(collectFn, intervals[i].first, intervals[i].second,
+                                              scale);
+            }
+            sort(res.begin(), res.end());
+          };
+
+          vector<uint32_t> & mwmOffsets = newOffsets[mwmId];
+          auto const itCovering = coverings.find(mwmId);
+          auto const itOffsets = offsets.find(mwmId);
+          if (itCovering != coverings.end() && itCovering->second.first == scale &&
+              itOffsets != offsets.end())
           {
-            auto collectFn = MakeBackInsertFunctor(offsets[mwmId]);
-            index.ForEachInIntervalAndScale(collectFn, interval[i].first, interval[i].second, scale);
+            // Each index entry is in one cell, so the offsets are a multiset of the entries
+            // of the intervals: the entries of the left cells are removed, the entries of
+            // the entered cells are added.
+            covering::IntervalsT const & oldInterval = itCovering->second.second;
+            vector<uint32_t> left, entered, kept;
+            collect(covering::SubtractIntervals(oldInterval, interval), left);
+            collect(covering::SubtractIntervals(interval, oldInterval), entered);
+
+            vector<uint32_t> const & oldOffsets = itOffsets->second;
+            kept.reserve(oldOffsets.size());
+            set_difference(oldOffsets.begin(), oldOffsets.end(), left.begin(), left.end(),
+                           back_inserter(kept));
+            mwmOffsets.reserve(kept.size() + entered.size());
+            merge(kept.begin(), kept.end(), entered.begin(), entered.end(),
+                  back_inserter(mwmOffsets));
+          }
+          else
+          {
+            collect(interval, mwmOffsets);
           }
 
-          sort(offsets[mwmId].begin(), offsets[mwmId].end());
+          newCoverings[mwmId] = make_pair(scale, interval);
         }
       }
     }
   }
 
+  offsets.swap(newOffsets);
+  coverings.swap(newCoverings);
+
 #ifdef DEBUG
   size_t offsetsCached = 0;
   for (shared_ptr<MwmInfo> const & info : mwmsInfo)
@@ -315,6 +357,8 @@ void Query::Init(bool viewportSearch)
 #endif
 
   ClearQueues();
+  m_trace.Clear();
+  m_arena.Clear();
 
   if (viewportSearch)
   {
@@ -467,19 +511,28 @@ void Query::SearchCoordinates(string const & query, Results & res) const
 
 void Query::Search(Results & res, size_t resCount)
 {
+  TRACE_SCOPE("search", "Query::Search");
   if (IsCancelled())
     return;
 
   if (m_tokens.empty())
+  {
+    ScopedQueryPhase phase(m_trace, QueryTrace::PHASE_SUGGEST_STRINGS);
     SuggestStrings(res);
+  }
 
+  // Features of the viewports are searched before the address, so the first results are
+  // shown without waiting for the localities and the streets.
   if (IsCancelled())
     return;
-  SearchAddress(res);
+  SearchFeatures();
+
+  if (m_preliminaryCallback && !IsCancelled())
+    EmitPreliminaryResults(res, resCount);
 
   if (IsCancelled())
     return;
-  SearchFeatures();
+  SearchAddress(res);
 
   if (IsCancelled())
     return;
@@ -522,15 +575,14 @@ class ProxyFunctor1
   {
     using ValueT = impl::PreResult2;
 
-    /// @todo Do not use shared_ptr for optimization issues.
-    /// Need to rewrite std::unique algorithm.
-    shared_ptr<ValueT> m_val;
+    /// Value is owned by Query::m_arena.
+    ValueT const * m_val;
 
   public:
-    explicit IndexedValue(ValueT * v) : m_val(v) {}
+    explicit IndexedValue(ValueT const * v) : m_val(v) {}
 
     ValueT const & operator*() const { return *m_val; }
-    ValueT const * operator->() const { return m_val.get(); }
+    ValueT const * operator->() const { return m_val; }
 
     string DebugPrint() const
     {
@@ -612,15 +664,14 @@ namespace impl
 
     unique_ptr<Index::FeaturesLoaderGuard> m_pFV;
 
-    // For the best performance, incoming id's should be sorted by id.first (mwm file id).
-    void LoadFeature(FeatureID const & id, FeatureType & f, string & name, string & country)
+    void InitLoader(MwmSet::MwmId const & mwmId)
     {
-      if (m_pFV.get() == 0 || m_pFV->GetId() != id.m_mwmId)
-        m_pFV.reset(new Index::FeaturesLoaderGuard(*m_query.m_pIndex, id.m_mwmId));
-
-      m_pFV->GetFeatureByIndex(id.m_index, f);
-      f.SetID(id);
+      if (m_pFV.get() == 0 || m_pFV->GetId() != mwmId)
+        m_pFV.reset(new Index::FeaturesLoaderGuard(*m_query.m_pIndex, mwmId));
+    }
 
+    void GetNames(FeatureType const & f, string & name, string & country)
+    {
       m_query.GetBestMatchName(f, name);
 
       // country (region) name is a file name if feature isn't from World.mwm
@@ -630,19 +681,22 @@ namespace impl
         country = m_pFV->GetCountryFileName();
     }
 
-  public:
-    PreResult2Maker(Query & q) : m_query(q)
+    // For the best performance, incoming id's should be sorted by id.first (mwm file id).
+    void LoadFeature(FeatureID const & id, FeatureType & f, string & name, string & country)
     {
+      InitLoader(id.m_mwmId);
+
+      m_pFV->GetFeatureByIndex(id.m_index, f);
+      f.SetID(id);
+
+      GetNames(f, name, country);
     }
 
-    impl::PreResult2 * operator() (impl::PreResult1 const & res)
+    impl::PreResult2 * MakeResult(impl::PreResult1 const & res, FeatureType const & feature,
+                                  string const & name, string const & country)
     {
-      FeatureType feature;
-      string name, country;
-      LoadFeature(res.GetID(), feature, name, country);
-
       Query::ViewportID const viewportID = static_cast<Query::ViewportID>(res.GetViewportID());
-      impl::PreResult2 * res2 = new impl::PreResult2(feature, &res,
+      impl::PreResult2 * res2 = m_query.m_arena.New<impl::PreResult2>(feature, &res,
                                                      m_query.GetPosition(viewportID),
                                                      name, country);
 
@@ -676,6 +730,38 @@ namespace impl
       return res2;
     }
 
+  public:
+    PreResult2Maker(Query & q) : m_query(q)
+    {
+    }
+
+    /// Makes results for [beg, end) range of PreResult1, sorted by feature id.
+    /// Features of every mwm are read by one batch in storage order.
+    template <class TIter, class ToDo> void ForEach(TIter beg, TIter end, ToDo && toDo)
+    {
+      vector<uint32_t> indices;
+      while (beg != end)
+      {
+        MwmSet::MwmId const mwmId = beg->GetID().m_mwmId;
+        TIter groupEnd = beg;
+        indices.clear();
+        for (; groupEnd != end && groupEnd->GetID().m_mwmId == mwmId; ++groupEnd)
+          indices.push_back(groupEnd->GetID().m_index);
+
+        InitLoader(mwmId);
+        m_pFV->ReadFeatures(indices, [&](FeatureType & feature)
+        {
+          ASSERT(beg != groupEnd && beg->GetID() == feature.GetID(), ());
+          string name, country;
+          GetNames(feature, name, country);
+          toDo(MakeResult(*beg, feature, name, country));
+          ++beg;
+        });
+        ASSERT(beg == groupEnd, ());
+        beg = groupEnd;
+      }
+    }
+
     impl::PreResult2 * operator() (FeatureID const & id)
     {
       FeatureType feature;
@@ -683,86 +769,81 @@ namespace impl
       LoadFeature(id, feature, name, country);
 
       if (!name.empty() && !country.empty())
-        return new impl::PreResult2(feature, 0, m_query.GetPosition(), name, country);
+        return m_query.m_arena.New<impl::PreResult2>(feature, nullptr, m_query.GetPosition(), name,
+                                                     country);
       else
         return 0;
     }
   };
-
-  class HouseCompFactory
-  {
-    Query const & m_query;
-
-    bool LessDistance(HouseResult const & r1, HouseResult const & r2) const
-    {
-      return (PointDistance(m_query.m_pivot, r1.GetOrg()) <
-              PointDistance(m_query.m_pivot, r2.GetOrg()));
-    }
-
-  public:
-    HouseCompFactory(Query const & q) : m_query(q) {}
-
-    struct CompT
-    {
-      HouseCompFactory const * m_parent;
-
-      CompT(HouseCompFactory const * parent) : m_parent(parent) {}
-      bool operator() (HouseResult const & r1, HouseResult const & r2) const
-      {
-        return m_parent->LessDistance(r1, r2);
-      }
-    };
-
-    static size_t const SIZE = 1;
-
-    CompT Get(size_t) { return CompT(this); }
-  };
 }
 
 template <class T>
 void Query::MakePreResult2(vector<T> & cont, vector<FeatureID> & streets)
 {
   // make unique set of PreResult1
-  using TPreResultSet = set<impl::PreResult1, LessFeatureID>;
-  TPreResultSet theSet;
+  using TPreResultSet =
+      set<impl::PreResult1, LessFeatureID, my::ArenaAllocator<impl::PreResult1>>;
+  TPreResultSet theSet((LessFeatureID()), my::ArenaAllocator<impl::PreResult1>(m_arena));
 
+  m_trace.m_queueCandidates.resize(m_queuesCount, 0);
   for (size_t i = 0; i < m_queuesCount; ++i)
   {
+    m_trace.m_queueCandidates[i] += static_cast<uint32_t>(m_results[i].size());
     theSet.insert(m_results[i].begin(), m_results[i].end());
     m_results[i].clear();
   }
 
+  ScopedQueryPhase phase(m_trace, QueryTrace::PHASE_LOAD_FEATURES);
+  m_trace.m_featuresLoaded += static_cast<uint32_t>(theSet.size());
+
   // make PreResult2 vector
   impl::PreResult2Maker maker(*this);
-  for (auto const & r : theSet)
+  maker.ForEach(theSet.begin(), theSet.end(), [&](impl::PreResult2 * p)
   {
-    impl::PreResult2 * p = maker(r);
     if (p == 0)
-      continue;
+      return;
 
     if (p->IsStreet())
       streets.push_back(p->GetID());
 
-    if (IsResultExists(p, cont))
-      delete p;
-    else
+    if (!IsResultExists(p, cont))
       cont.push_back(IndexedValue(p));
-  }
+  });
 }
 
 void Query::FlushHouses(Results & res, bool allMWMs, vector<FeatureID> const & streets)
 {
   if (!m_house.empty() && !streets.empty())
   {
-    if (m_houseDetector.LoadStreets(streets) > 0)
-      m_houseDetector.MergeStreets();
+    ScopedQueryPhase phase(m_trace, QueryTrace::PHASE_HOUSES);
+    string const number = strings::ToUtf8(m_house);
 
-    m_houseDetector.ReadAllHouses();
+    vector<pair<m2::PointD, string>> houses;
+    vector<FeatureID> restStreets;
+    GetIndexedHouses(streets, number, houses, restStreets);
 
-    vector<HouseResult> houses;
-    m_houseDetector.GetHouseForName(strings::ToUtf8(m_house), houses);
+    // The houses of the mwms without the index are projected to the streets.
+    if (!restStreets.empty())
+    {
+      if (m_houseDetector.LoadStreets(restStreets) > 0)
+        m_houseDetector.MergeStreets();
 
-    SortByIndexedValue(houses, impl::HouseCompFactory(*this));
+      m_houseDetector.ReadAllHouses();
+
+      vector<HouseResult> detected;
+      m_houseDetector.GetHouseForName(number, detected);
+      for (HouseResult const & r : detected)
+      {
+        houses.emplace_back(r.m_house->GetPosition(),
+                            r.m_house->GetNumber() + ", " + r.m_street->GetName());
+      }
+    }
+
+    sort(houses.begin(), houses.end(),
+         [this](pair<m2::PointD, string> const & h1, pair<m2::PointD, string> const & h2)
+         {
+           return PointDistance(m_pivot, h1.first) < PointDistance(m_pivot, h2.first);
+         });
 
     // Limit address results when searching in first pass (position, viewport, locality).
     size_t count = houses.size();
@@ -771,16 +852,58 @@ void Query::FlushHouses(Results & res, bool allMWMs, vector<FeatureID> const & s
 
     for (size_t i = 0; i < count; ++i)
     {
-      House const * h = houses[i].m_house;
-      res.AddResult(MakeResult(impl::PreResult2(h->GetPosition(),
-                                               h->GetNumber() + ", " + houses[i].m_street->GetName(),
+      res.AddResult(MakeResult(impl::PreResult2(houses[i].first, houses[i].second,
                                                ftypes::IsBuildingChecker::Instance().GetMainType())));
     }
   }
 }
 
+void Query::GetIndexedHouses(vector<FeatureID> const & streets, string const & number,
+                             vector<pair<m2::PointD, string>> & houses,
+                             vector<FeatureID> & restStreets)
+{
+  vector<FeatureID> sorted(streets);
+  sort(sorted.begin(), sorted.end());
+
+  for (size_t i = 0; i < sorted.size();)
+  {
+    MwmSet::MwmId const mwmId = sorted[i].m_mwmId;
+    size_t end = i;
+    while (end < sorted.size() && sorted[end].m_mwmId == mwmId)
+      ++end;
+
+    indexer::HousesIndex index;
+    Index::MwmHandle const mwmHandle = m_pIndex->GetMwmHandleById(mwmId);
+    MwmValue const * pMwm = mwmHandle.GetValue<MwmValue>();
+    if (!pMwm || !pMwm->m_cont.IsExist(HOUSES_INDEX_FILE_TAG) ||
+        !index.Load(pMwm->m_cont.GetReader(HOUSES_INDEX_FILE_TAG)))
+    {
+      restStreets.insert(restStreets.end(), sorted.begin() + i, sorted.begin() + end);
+      i = end;
+      continue;
+    }
+
+    Index::FeaturesLoaderGuard loader(*m_pIndex, mwmId);
+    for (; i < end; ++i)
+    {
+      vector<indexer::HousesIndex::House> streetHouses;
+      if (!index.GetHouses(sorted[i].m_index, number, streetHouses) || streetHouses.empty())
+        continue;
+
+      FeatureType street;
+      loader.GetFeatureByIndex(sorted[i].m_index, street);
+      string name;
+      GetBestMatchName(street, name);
+
+      for (auto const & house : streetHouses)
+        houses.emplace_back(house.m_point, house.m_number + ", " + name);
+    }
+  }
+}
+
 void Query::FlushResults(Results & res, bool allMWMs, size_t resCount)
 {
+  TRACE_SCOPE("search", "Query::FlushResults");
   vector<IndexedValue> indV;
   vector<FeatureID> streets;
 
@@ -795,7 +918,10 @@ void Query::FlushResults(Results & res, bool allMWMs, size_t resCount)
 
   // Do not process suggestions in additional search.
   if (!allMWMs)
+  {
+    ScopedQueryPhase phase(m_trace, QueryTrace::PHASE_SUGGESTIONS);
     ProcessSuggestions(indV, res);
+  }
 
 #ifdef HOUSE_SEARCH_TEST
   FlushHouses(res, allMWMs, streets);
@@ -815,8 +941,41 @@ void Query::FlushResults(Results & res, bool allMWMs, size_t resCount)
   }
 }
 
+void Query::EmitPreliminaryResults(Results const & res, size_t resCount)
+{
+  TRACE_SCOPE("search", "Query::EmitPreliminaryResults");
+  TQueue queues[kQueuesCount];
+  for (size_t i = 0; i < m_queuesCount; ++i)
+    queues[i] = m_results[i];
+
+  // Suggestions and houses wait for the final results, they need the address search.
+  vector<IndexedValue> indV;
+  vector<FeatureID> streets;
+  MakePreResult2(indV, streets);
+
+  for (size_t i = 0; i < m_queuesCount; ++i)
+    m_results[i].swap(queues[i]);
+
+  RemoveDuplicatingLinear(indV);
+  SortByIndexedValue(indV, CompFactory2());
+
+  Results preliminary(res);
+  size_t count = preliminary.GetCount();
+  for (size_t i = 0; i < indV.size() && count < resCount; ++i)
+  {
+    if (IsCancelled())
+      return;
+    if (preliminary.AddResult(MakeResult(*(indV[i]))))
+      ++count;
+  }
+
+  if (count > res.GetCount())
+    m_preliminaryCallback(preliminary);
+}
+
 void Query::SearchViewportPoints(Results & res)
 {
+  TRACE_SCOPE("search", "Query::SearchViewportPoints");
   if (IsCancelled())
     return;
   SearchAddress(res);
@@ -962,6 +1121,12 @@ void Query::ProcessSuggestions(vector<T> & vec, Results & res) const
 
 void Query::AddResultFromTrie(TTrieValue const & val, MwmSet::MwmId const & mwmID,
                               ViewportID vID /*= DEFAULT_V*/)
+{
+  AddResultFromTrie(val, mwmID, vID, m_results);
+}
+
+void Query::AddResultFromTrie(TTrieValue const & val, MwmSet::MwmId const & mwmID, ViewportID vID,
+                              TQueue * results) const
 {
   // If we are in viewport search mode, check actual "point-in-viewport" criteria.
   if (m_queuesCount == 1 && !m_viewport[CURRENT_V].IsPointInside(val.m_pt))
@@ -973,8 +1138,21 @@ void Query::AddResultFromTrie(TTrieValue const & val, MwmSet::MwmId const & mwmI
   for (size_t i = 0; i < m_queuesCount; ++i)
   {
     // here can be the duplicates because of different language match (for suggest token)
-    if (m_results[i].end() == find_if(m_results[i].begin(), m_results[i].end(), EqualFeatureID(res)))
-      m_results[i].push(res);
+    if (results[i].end() == find_if(results[i].begin(), results[i].end(), EqualFeatureID(res)))
+      results[i].push(res);
+  }
+}
+
+void Query::MergeResults(TQueue * results)
+{
+  for (size_t i = 0; i < m_queuesCount; ++i)
+  {
+    for (auto const & res : results[i])
+    {
+      if (m_results[i].end() == find_if(m_results[i].begin(), m_results[i].end(), EqualFeatureID(res)))
+        m_results[i].push(res);
+    }
+    results[i].clear();
   }
 }
 
@@ -986,6 +1164,7 @@ class BestNameFinder
   KeywordLangMatcher::ScoreT m_score;
   string & m_name;
   KeywordLangMatcher const & m_keywordsScorer;
+  strings::UniString m_buffer;
 public:
   BestNameFinder(string & name, KeywordLangMatcher const & keywordsScorer)
     : m_score(), m_name(name), m_keywordsScorer(keywordsScorer)
@@ -994,7 +1173,7 @@ public:
 
   bool operator()(signed char lang, string const & name)
   {
-    KeywordLangMatcher::ScoreT const score = m_keywordsScorer.Score(lang, name);
+    KeywordLangMatcher::ScoreT const score = m_keywordsScorer.Score(lang, name, m_buffer);
     if (m_score < score)
     {
       m_score = score;
@@ -1470,7 +1649,11 @@ namespace impl
 
 void Query::SearchAddress(Results & res)
 {
+  TRACE_SCOPE("search", "Query::SearchAddress");
+  ScopedQueryPhase phase(m_trace, QueryTrace::PHASE_SEARCH_ADDRESS);
+
   // Find World.mwm and do special search there.
+  uint64_t const epoch = m_pIndex->GetEpoch();
   TMWMVector mwmsInfo;
   m_pIndex->GetMwmsInfo(mwmsInfo);
 
@@ -1503,7 +1686,7 @@ void Query::SearchAddress(Results & res)
 
           m2::RectD const rect = MercatorBounds::RectByCenterXYAndSizeInMeters(
                 city.m_value.m_pt, city.m_radius);
-          SetViewportByIndex(mwmsInfo, rect, LOCALITY_V, false);
+          SetViewportByIndex(mwmsInfo, epoch, rect, LOCALITY_V, false);
 
           /// @todo Hack - do not search for address in World.mwm; Do it better in future.
           bool const b = m_worldSearch;
@@ -1538,6 +1721,7 @@ void Query::SearchAddress(Results & res)
                                                 region.m_ids))
             {
               SearchInMWM(handle, params);
+              ++m_trace.m_mwmsSearched;
             }
           }
         }
@@ -1557,7 +1741,7 @@ namespace impl
     /// Index in array equal to Locality::m_type value.
     vector<Locality> m_localities[3];
 
-    FeaturesVector m_vector;
+    FeaturesVector::Cursor m_vector;
     size_t m_index;         ///< index of processing token
 
     Locality * PushLocality(Locality const & l)
@@ -1654,7 +1838,7 @@ namespace impl
 
   public:
     DoFindLocality(Query & q, MwmValue const * pMwm, int8_t lang)
-      : m_query(q), m_vector(pMwm->m_cont, pMwm->GetHeader(), pMwm->m_table), m_lang(lang)
+      : m_query(q), m_vector(pMwm->GetFeatures()), m_lang(lang)
     {
       m_arrEn[0] = q.GetLanguage(LANG_EN);
       m_arrEn[1] = q.GetLanguage(LANG_INTERNATIONAL);
@@ -1765,6 +1949,8 @@ namespace impl
 
 void Query::SearchLocality(MwmValue const * pMwm, impl::Locality & res1, impl::Region & res2)
 {
+  ScopedQueryPhase phase(m_trace, QueryTrace::PHASE_SEARCH_LOCALITY);
+
   SearchQueryParams params;
   InitParams(true /* localitySearch */, params);
 
@@ -1773,8 +1959,7 @@ void Query::SearchLocality(MwmValue const * pMwm, impl::Locality & res1, impl::R
   ModelReaderPtr searchReader = pMwm->m_cont.GetReader(SEARCH_INDEX_FILE_TAG);
 
   unique_ptr<trie::DefaultIterator> const trieRoot(
-      trie::ReadTrie(SubReaderWrapper<Reader>(searchReader.GetPtr()), trie::ValueReader(cp),
-                     trie::TEdgeValueReader()));
+      trie::ReadSearchTrie(searchReader, cp, pMwm->GetHeader().GetFormat()));
 
   ForEachLangPrefix(params, *trieRoot, [&](TrieRootPrefix & langRoot, int8_t lang)
   {
@@ -1812,6 +1997,9 @@ void Query::SearchLocality(MwmValue const * pMwm, impl::Locality & res1, impl::R
 
 void Query::SearchFeatures()
 {
+  TRACE_SCOPE("search", "Query::SearchFeatures");
+  ScopedQueryPhase phase(m_trace, QueryTrace::PHASE_SEARCH_FEATURES);
+
   TMWMVector mwmsInfo;
   m_pIndex->GetMwmsInfo(mwmsInfo);
 
@@ -1857,16 +2045,53 @@ namespace
 void Query::SearchFeatures(SearchQueryParams const & params, TMWMVector const & mwmsInfo,
                            ViewportID vID)
 {
+  vector<Index::MwmHandle> handles;
   for (shared_ptr<MwmInfo> const & info : mwmsInfo)
   {
     // Search only mwms that intersect with viewport (world always does).
     if (m_viewport[vID].IsIntersect(info->m_limitRect))
-      SearchInMWM(m_pIndex->GetMwmHandleById(info), params, vID);
+      handles.push_back(m_pIndex->GetMwmHandleById(info));
   }
+  m_trace.m_mwmsSearched += static_cast<uint32_t>(handles.size());
+
+  // Every mwm is matched into its own shard of queues, so workers
+  // don't share any state. Shards are merged in the mwms order.
+  vector<TQueue> shards;
+  shards.reserve(handles.size() * kQueuesCount);
+  for (size_t i = 0; i < handles.size(); ++i)
+  {
+    for (size_t j = 0; j < kQueuesCount; ++j)
+    {
+      shards.push_back(m_results[j]);
+      shards.back().clear();
+    }
+  }
+
+  vector<function<void()>> tasks;
+  tasks.reserve(handles.size());
+  for (size_t i = 0; i < handles.size(); ++i)
+  {
+    tasks.emplace_back([&, i]()
+    {
+      SearchInMWM(handles[i], params, vID, &shards[i * kQueuesCount]);
+    });
+  }
+
+  // CancelException thrown by a worker is rethrown here.
+  m_pIndex->RunQueryTasks(tasks);
+
+  for (size_t i = 0; i < handles.size(); ++i)
+    MergeResults(&shards[i * kQueuesCount]);
 }
 
 void Query::SearchInMWM(Index::MwmHandle const & mwmHandle, SearchQueryParams const & params,
                         ViewportID viewportId /*= DEFAULT_V*/)
+{
+  SearchInMWM(mwmHandle, params, viewportId, m_results);
+}
+
+void Query::SearchInMWM(Index::MwmHandle const & mwmHandle, SearchQueryParams const & params,
+                        ViewportID viewportId, TQueue * results) const
 {
   MwmValue const * const value = mwmHandle.GetValue<MwmValue>();
   if (!value || !value->m_cont.IsExist(SEARCH_INDEX_FILE_TAG))
@@ -1881,20 +2106,41 @@ void Query::SearchInMWM(Index::MwmHandle const & mwmHandle, SearchQueryParams co
   serial::CodingParams cp(trie::GetCodingParams(header.GetDefCodingParams()));
   ModelReaderPtr searchReader = value->m_cont.GetReader(SEARCH_INDEX_FILE_TAG);
   unique_ptr<trie::DefaultIterator> const trieRoot(
-      trie::ReadTrie(SubReaderWrapper<Reader>(searchReader.GetPtr()), trie::ValueReader(cp),
-                     trie::TEdgeValueReader()));
+      trie::ReadSearchTrie(searchReader, cp, header.GetFormat()));
   MwmSet::MwmId const mwmId = mwmHandle.GetId();
-  FeaturesFilter filter(
-      (viewportId == DEFAULT_V || isWorld) ? 0 : &m_offsetsInViewport[viewportId][mwmId], *this);
-  MatchFeaturesInTrie(params, *trieRoot, filter, [&](TTrieValue const & value)
+
+  // This function may be called from a worker thread, so
+  // m_offsetsInViewport is only looked up here: a map without cached
+  // offsets matches no features in the viewport.
+  static vector<uint32_t> const kNoOffsets;
+  vector<uint32_t> const * offsets = nullptr;
+  if (viewportId != DEFAULT_V && !isWorld)
   {
-    AddResultFromTrie(value, mwmId, viewportId);
+    auto const & viewportOffsets = m_offsetsInViewport[viewportId];
+    auto const it = viewportOffsets.find(mwmId);
+    offsets = (it == viewportOffsets.end() ? &kNoOffsets : &it->second);
+  }
+
+  // Subtrees of the search index out of the cells of the viewport have no features of the
+  // offsets, the cells are taken by the covering of the viewport offsets.
+  trie::TCellsMask cellsMask = trie::kAllCells;
+  if (offsets && trie::EdgeValueReader::HasCellsMasks(header.GetFormat()))
+  {
+    int const cellDepth = covering::GetCodingDepth(header.GetLastScale());
+    cellsMask = trie::CellsGrid(header.GetBounds())
+                    .GetMask(covering::GetViewportCellsRect(m_viewport[viewportId], cellDepth));
+  }
+
+  FeaturesFilter filter(offsets, *this);
+  MatchFeaturesInTrie(params, *trieRoot, filter, cellsMask, [&](TTrieValue const & value)
+  {
+    AddResultFromTrie(value, mwmId, viewportId, results);
   });
 }
 
 void Query::SuggestStrings(Results & res)
 {
-  if (m_pStringsToSuggest && !m_prefix.empty())
+  if (m_pSuggests && !m_prefix.empty())
   {
     int8_t arrLocales[3];
     int const localesCount = GetCategoryLocales(arrLocales);
@@ -1910,20 +2156,17 @@ void Query::SuggestStrings(Results & res)
 void Query::MatchForSuggestionsImpl(strings::UniString const & token, int8_t locale,
                                     string const & prolog, Results & res)
 {
-  for (TSuggest const & suggest : *m_pStringsToSuggest)
+  m_pSuggests->ForEachSuggest(locale, token, [&](SuggestsIndex::Suggest const & suggest)
   {
-    strings::UniString const & s = suggest.m_name;
-    if ((suggest.m_prefixLength <= token.size()) &&
-        (token != s) &&                   // do not push suggestion if it already equals to token
-        (suggest.m_locale == locale) &&   // push suggestions only for needed language
-        StartsWith(s.begin(), s.end(), token.begin(), token.end()))
-    {
-      string const utf8Str = strings::ToUtf8(s);
-      Result r(utf8Str, prolog + utf8Str + " ");
-      MakeResultHighlight(r);
-      res.AddResult(move(r));
-    }
-  }
+    // Do not push suggestion if it already equals to token.
+    if (suggest.m_name == token)
+      return;
+
+    string const utf8Str = strings::ToUtf8(suggest.m_name);
+    Result r(utf8Str, prolog + utf8Str + " ");
+    MakeResultHighlight(r);
+    res.AddResult(move(r));
+  });
 }
 
 m2::RectD const & Query::GetViewport(ViewportID vID /*= DEFAULT_V*/) const
@@ -1951,6 +2194,8 @@ m2::PointD Query::GetPosition(ViewportID vID /*= DEFAULT_V*/) const
 
 void Query::SearchAdditional(Results & res, size_t resCount)
 {
+  TRACE_SCOPE("search", "Query::SearchAdditional");
+  ScopedQueryPhase phase(m_trace, QueryTrace::PHASE_ADDITIONAL);
   ClearQueues();
 
   string const fileName = m_pInfoGetter->GetRegionFile(m_pivot);
@@ -1971,6 +2216,7 @@ void Query::SearchAdditional(Results & res, size_t resCount)
           handle.GetValue<MwmValue>()->GetCountryFileName() == fileName)
       {
         SearchInMWM(handle, params);
+        ++m_trace.m_mwmsSearched;
       }
     }
 
@@ -1,18 +1,23 @@
 #pragma once
 #include "intermediate_result.hpp"
 #include "keyword_lang_matcher.hpp"
+#include "query_trace.hpp"
+#include "suggests_index.hpp"
 
+#include "indexer/feature_covering.hpp"
 #include "indexer/ftypes_matcher.hpp"
 #include "indexer/search_trie.hpp"
 #include "indexer/index.hpp"  // for Index::MwmHandle
 
 #include "geometry/rect2d.hpp"
 
+#include "base/arena.hpp"
 #include "base/buffer_vector.hpp"
 #include "base/cancellable.hpp"
 #include "base/limited_priority_queue.hpp"
 #include "base/string_utils.hpp"
 
+#include "std/function.hpp"
 #include "std/map.hpp"
 #include "std/string.hpp"
 #include "std/unordered_set.hpp"
@@ -48,29 +53,13 @@ namespace impl
   struct Locality;
   struct Region;
   class DoFindLocality;
-  class HouseCompFactory;
 }
 
 class Query : public my::Cancellable
 {
 public:
-  struct TSuggest
-  {
-    strings::UniString m_name;
-    uint8_t m_prefixLength;
-    int8_t m_locale;
-
-    TSuggest(strings::UniString const & name, uint8_t len, int8_t locale)
-      : m_name(name), m_prefixLength(len), m_locale(locale)
-    {
-    }
-  };
-
-  // Vector of suggests.
-  using TStringsToSuggestVector = vector<TSuggest>;
-
   Query(Index const * pIndex, CategoriesHolder const * pCategories,
-        TStringsToSuggestVector const * pStringsToSuggest,
+        SuggestsIndex const * pSuggests,
         storage::CountryInfoGetter const * pInfoGetter);
   virtual ~Query();
 
@@ -104,6 +93,18 @@ public:
   void SearchViewportPoints(Results & res);
   //@}
 
+  /// Search() calls it with the results of the current viewport, which are ranked before the
+  /// slower address search and the search in the other viewports. It's optional.
+  using TPreliminaryCallback = function<void(Results &)>;
+  inline void SetPreliminaryCallback(TPreliminaryCallback const & fn)
+  {
+    m_preliminaryCallback = fn;
+  }
+
+  /// Trace of the current query, it's cleared by Init().
+  inline QueryTrace & GetTrace() { return m_trace; }
+  inline QueryTrace const & GetTrace() const { return m_trace; }
+
   // Get scale level to make geometry index query for current viewport.
   virtual int GetQueryIndexScale(m2::RectD const & viewport) const;
 
@@ -123,7 +124,6 @@ private:
   friend class impl::BestNameFinder;
   friend class impl::PreResult2Maker;
   friend class impl::DoFindLocality;
-  friend class impl::HouseCompFactory;
 
   void ClearQueues();
 
@@ -134,12 +134,18 @@ private:
 
   using TMWMVector = vector<shared_ptr<MwmInfo>>;
   using TOffsetsVector = map<MwmSet::MwmId, vector<uint32_t>>;
+  /// Index scale and covering intervals the viewport offsets of the mwm are collected for.
+  using TCoveringsVector = map<MwmSet::MwmId, pair<int, covering::IntervalsT>>;
   using TFHeader = feature::DataHeader;
 
-  void SetViewportByIndex(TMWMVector const & mwmsInfo, m2::RectD const & viewport, size_t idx,
-                          bool forceUpdate);
+  /// @param epoch Epoch of the index which is read before mwmsInfo, the cached offsets
+  ///              are collected again when the mwms are changed since then.
+  void SetViewportByIndex(TMWMVector const & mwmsInfo, uint64_t epoch, m2::RectD const & viewport,
+                          size_t idx, bool forceUpdate);
+  /// When the index scale of an mwm is the same, e.g. on pan, only the features of
+  /// the cells which left or entered the covering are read.
   void UpdateViewportOffsets(TMWMVector const & mwmsInfo, m2::RectD const & rect,
-                             TOffsetsVector & offsets);
+                             TOffsetsVector & offsets, TCoveringsVector & coverings);
   void ClearCache(size_t ind);
 
   enum ViewportID
@@ -155,6 +161,11 @@ private:
 
   template <class T> void MakePreResult2(vector<T> & cont, vector<FeatureID> & streets);
   void FlushHouses(Results & res, bool allMWMs, vector<FeatureID> const & streets);
+  /// Looks the houses of the streets up in the houses index sections of the mwms, the streets
+  /// of the mwms without the section are added to |restStreets|.
+  void GetIndexedHouses(vector<FeatureID> const & streets, string const & number,
+                        vector<pair<m2::PointD, string>> & houses,
+                        vector<FeatureID> & restStreets);
   void FlushResults(Results & res, bool allMWMs, size_t resCount);
 
   ftypes::Type GetLocalityIndex(feature::TypesHolder const & types) const;
@@ -175,7 +186,8 @@ private:
   /// @param[in] ind Index of viewport rect to search (@see m_viewport).
   /// If ind == -1, don't do any matching with features in viewport (@see m_offsetsInViewport).
   //@{
-  /// Do search in all maps from mwmInfo.
+  /// Do search in all maps from mwmInfo. Maps are matched concurrently
+  /// on the index query thread pool (@see Index::SetQueryThreadsCount).
   void SearchFeatures(SearchQueryParams const & params, TMWMVector const & mwmsInfo,
                       ViewportID vID);
   /// Do search in particular map (mwmHandle).
@@ -193,7 +205,7 @@ private:
 
   Index const * m_pIndex;
   CategoriesHolder const * m_pCategories;
-  TStringsToSuggestVector const * m_pStringsToSuggest;
+  SuggestsIndex const * m_pSuggests;
   storage::CountryInfoGetter const * m_pInfoGetter;
 
   string m_region;
@@ -213,6 +225,8 @@ private:
 #endif
 
   m2::RectD m_viewport[COUNT_V];
+  /// Epochs of the index the viewport offsets are collected at.
+  uint64_t m_viewportEpoch[COUNT_V];
   m2::PointD m_pivot;
   bool m_worldSearch;
 
@@ -230,8 +244,16 @@ private:
   KeywordLangMatcher m_keywordsScorer;
 
   TOffsetsVector m_offsetsInViewport[COUNT_V];
+  TCoveringsVector m_coveringsInViewport[COUNT_V];
   bool m_supportOldFormat;
 
+  QueryTrace m_trace;
+
+  TPreliminaryCallback m_preliminaryCallback;
+
+  /// Temporary objects of the current query, e.g. PreResult2, cleared by Init().
+  my::Arena m_arena;
+
   template <class TParam>
   class TCompare
   {
@@ -269,6 +291,19 @@ private:
   };
   TQueue m_results[kQueuesCount];
   size_t m_queuesCount;
+
+  /// Adds result to |results| queues (m_results or shards of a parallel search).
+  /// Doesn't modify Query, so may be called from a worker thread.
+  void AddResultFromTrie(TTrieValue const & val, MwmSet::MwmId const & mwmID, ViewportID vID,
+                         TQueue * results) const;
+  /// Passes |res| with the results of the queues to m_preliminaryCallback, the queues are kept
+  /// for the final FlushResults().
+  void EmitPreliminaryResults(Results const & res, size_t resCount);
+  /// Do search in particular map and put results into |results| queues.
+  void SearchInMWM(Index::MwmHandle const & mwmHandle, SearchQueryParams const & params,
+                   ViewportID viewportId, TQueue * results) const;
+  /// Moves results from |results| queues (one parallel search shard) to m_results.
+  void MergeResults(TQueue * results);
   //@}
 };
 
@@ -13,10 +13,10 @@ public:
 
   virtual unique_ptr<Query> BuildSearchQuery(
       Index const * index, CategoriesHolder const * categories,
-      Query::TStringsToSuggestVector const * stringsToSuggest,
+      SuggestsIndex const * suggests,
       storage::CountryInfoGetter const * infoGetter)
   {
-    return make_unique<Query>(index, categories, stringsToSuggest, infoGetter);
+    return make_unique<Query>(index, categories, suggests, infoGetter);
   }
 };
 }  // namespace search
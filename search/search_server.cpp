@@ -0,0 +1,200 @@
+#include "search/search_server.hpp"
+
+#include "search/engine_data.hpp"
+#include "search/search_query.hpp"
+
+#include "indexer/index.hpp"
+#include "indexer/mercator.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+#include "base/tracing.hpp"
+
+namespace search
+{
+namespace
+{
+/// Query which is cancelled by its deadline too.
+class DeadlineQuery : public Query
+{
+public:
+  DeadlineQuery(Index const * pIndex, CategoriesHolder const * pCategories,
+                SuggestsIndex const * pSuggests, storage::CountryInfoGetter const * pInfoGetter)
+    : Query(pIndex, pCategories, pSuggests, pInfoGetter)
+  {
+  }
+
+  void SetDeadline(steady_clock::time_point deadline) { m_deadline = deadline; }
+
+  // my::Cancellable overrides:
+  bool IsCancelled() const override
+  {
+    return Query::IsCancelled() || steady_clock::now() >= m_deadline;
+  }
+
+private:
+  steady_clock::time_point m_deadline;
+};
+}  // namespace
+
+/// Query context of a worker thread.
+class SearchServer::Worker
+{
+public:
+  Worker(Index const & index, EngineData const & data)
+    : m_query(&index, &data.m_categories, &data.m_suggests, &data.m_infoGetter)
+  {
+  }
+
+  /// @return False when the task is cancelled.
+  bool Run(Task const & task, Results & results)
+  {
+    if (steady_clock::now() >= task.m_deadline)
+      return false;
+
+    Request const & request = task.m_request;
+    m_query.SetDeadline(task.m_deadline);
+    m_query.Init(false /* viewportSearch */);
+    if (request.m_locale != m_locale)
+    {
+      m_query.SetPreferredLocale(request.m_locale);
+      m_locale = request.m_locale;
+    }
+    m_query.SetInputLocale(request.m_locale);
+    m_query.SetRankPivot(request.m_viewport.Center());
+    m_query.SetSearchInWorld(true);
+    m_query.SetQuery(request.m_query);
+
+    m_query.SearchCoordinates(request.m_query, results);
+    try
+    {
+      m_query.SetViewport(request.m_viewport, true /* forceUpdate */);
+      m_query.Search(results, request.m_resultsCount);
+      if (results.GetCount() < request.m_resultsCount)
+        m_query.SearchAdditional(results, request.m_resultsCount);
+    }
+    catch (Query::CancelException const &)
+    {
+    }
+    return !m_query.IsCancelled();
+  }
+
+  void Cancel() { m_query.Cancel(); }
+
+private:
+  DeadlineQuery m_query;
+  string m_locale;
+};
+
+SearchServer::SearchServer(Index const & index, Reader * pCategoriesR, ModelReaderPtr polyR,
+                           ModelReaderPtr countryR, size_t threadsCount, size_t maxQueueSize)
+  : m_index(index), m_data(new EngineData(pCategoriesR, polyR, countryR)),
+    m_maxQueueSize(maxQueueSize)
+{
+  ASSERT_GREATER(threadsCount, 0, ());
+  for (size_t i = 0; i < threadsCount; ++i)
+    m_workers.emplace_back(new Worker(m_index, *m_data));
+  for (size_t i = 0; i < threadsCount; ++i)
+  {
+    m_threads.emplace_back([this, i]()
+    {
+      my::tracing::SetThreadName("SearchServer " + strings::to_string(i));
+      RunWorker(*m_workers[i]);
+    });
+  }
+}
+
+SearchServer::~SearchServer()
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_isStopped = true;
+  }
+  m_cv.notify_all();
+  for (unique_ptr<Worker> & worker : m_workers)
+    worker->Cancel();
+  for (thread & t : m_threads)
+    t.join();
+
+  Results const empty;
+  for (Task const & task : m_queue)
+    task.m_callback(empty, true /* isCancelled */);
+}
+
+bool SearchServer::Submit(Request const & request, TCallback const & callback)
+{
+  Task task;
+  task.m_request = request;
+  if (!task.m_request.m_viewport.IsValid())
+    task.m_request.m_viewport = MercatorBounds::FullRect();
+  task.m_callback = callback;
+  task.m_deadline = steady_clock::now() + duration_cast<steady_clock::duration>(
+                                              duration<double>(request.m_timeoutSeconds));
+  {
+    lock_guard<mutex> lock(m_mutex);
+    if (m_isStopped || m_queue.size() >= m_maxQueueSize)
+    {
+      ++m_stats.m_rejected;
+      return false;
+    }
+    m_queue.push_back(move(task));
+  }
+  m_cv.notify_one();
+  return true;
+}
+
+bool SearchServer::Search(Request const & request, Results & results)
+{
+  mutex doneMutex;
+  condition_variable doneCv;
+  bool done = false;
+  bool cancelled = false;
+  bool const submitted = Submit(request, [&](Results const & res, bool isCancelled)
+  {
+    lock_guard<mutex> lock(doneMutex);
+    results = res;
+    cancelled = isCancelled;
+    done = true;
+    doneCv.notify_one();
+  });
+  if (!submitted)
+    return false;
+
+  unique_lock<mutex> lock(doneMutex);
+  doneCv.wait(lock, [&done]() { return done; });
+  return !cancelled;
+}
+
+SearchServer::Stats SearchServer::GetStats() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_stats;
+}
+
+void SearchServer::RunWorker(Worker & worker)
+{
+  while (true)
+  {
+    Task task;
+    {
+      unique_lock<mutex> lock(m_mutex);
+      m_cv.wait(lock, [this]() { return m_isStopped || !m_queue.empty(); });
+      if (m_isStopped)
+        return;
+      task = move(m_queue.front());
+      m_queue.pop_front();
+    }
+
+    Results results;
+    bool const isCancelled = !worker.Run(task, results);
+    {
+      lock_guard<mutex> lock(m_mutex);
+      if (isCancelled)
+        ++m_stats.m_cancelled;
+      else
+        ++m_stats.m_done;
+    }
+    task.m_callback(results, isCancelled);
+  }
+}
+}  // namespace search
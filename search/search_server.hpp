@@ -0,0 +1,101 @@
+#pragma once
+
+#include "search/result.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include "coding/reader.hpp"
+
+#include "base/macros.hpp"
+
+#include "std/chrono.hpp"
+#include "std/condition_variable.hpp"
+#include "std/deque.hpp"
+#include "std/function.hpp"
+#include "std/mutex.hpp"
+#include "std/string.hpp"
+#include "std/thread.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+class Index;
+
+namespace search
+{
+class EngineData;
+
+/// Search without the Framework for the server side. The requests of all the threads share one
+/// read-only Index and the search data, each worker thread has its own query context, so the
+/// requests run on all the cores at once. Unlike Engine, a new request doesn't cancel the
+/// previous one. Requests wait in the queue, they are cancelled when their deadline is exceeded.
+class SearchServer
+{
+public:
+  struct Request
+  {
+    string m_query;
+    /// Language of the query, results are ranked for it too.
+    string m_locale = "en";
+    m2::RectD m_viewport;
+    /// Time from the submission after which the request is cancelled.
+    double m_timeoutSeconds = 1.0;
+    size_t m_resultsCount = 30;
+  };
+
+  /// It's called on a worker thread. isCancelled is true when the deadline is exceeded or the
+  /// server is stopped, results has what's found by then.
+  typedef function<void(Results const & results, bool isCancelled)> TCallback;
+
+  struct Stats
+  {
+    uint64_t m_done = 0;
+    uint64_t m_cancelled = 0;
+    /// Requests which aren't accepted because the queue is full.
+    uint64_t m_rejected = 0;
+  };
+
+  /// Doesn't take ownership of index. Takes ownership of pCategoriesR.
+  SearchServer(Index const & index, Reader * pCategoriesR, ModelReaderPtr polyR,
+               ModelReaderPtr countryR, size_t threadsCount, size_t maxQueueSize = 1024);
+  /// Cancels the queued requests and waits for the running ones.
+  ~SearchServer();
+
+  /// @return False when the queue is full, callback isn't called then.
+  bool Submit(Request const & request, TCallback const & callback);
+
+  /// Runs the request and waits for it.
+  /// @return False when the request is rejected or cancelled.
+  bool Search(Request const & request, Results & results);
+
+  Stats GetStats() const;
+
+private:
+  DISALLOW_COPY_AND_MOVE(SearchServer);
+
+  typedef steady_clock::time_point TTimePoint;
+
+  struct Task
+  {
+    Request m_request;
+    TCallback m_callback;
+    TTimePoint m_deadline;
+  };
+
+  class Worker;
+
+  void RunWorker(Worker & worker);
+
+  Index const & m_index;
+  unique_ptr<EngineData> const m_data;
+  size_t const m_maxQueueSize;
+
+  mutable mutex m_mutex;
+  condition_variable m_cv;
+  deque<Task> m_queue;
+  bool m_isStopped = false;
+  Stats m_stats;
+
+  vector<unique_ptr<Worker>> m_workers;
+  vector<thread> m_threads;
+};
+}  // namespace search
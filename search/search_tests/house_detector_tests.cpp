@@ -308,6 +308,49 @@ UNIT_TEST(HS_FindHouseSmoke)
 }
 
 
+UNIT_TEST(HS_CachedStreets)
+{
+  classificator::Load();
+
+  Index index;
+  auto const p = index.Register(LocalCountryFile::MakeForTesting("minsk-pass"));
+  TEST(p.first.IsAlive(), ());
+  TEST_EQUAL(MwmSet::RegResult::Success, p.second, ());
+
+  StreetIDsByName first;
+  first.streetNames.push_back("Московская улица");
+  index.ForEachInScale(first, scales::GetUpperScale());
+
+  StreetIDsByName second;
+  second.streetNames.push_back("проспект Независимости");
+  index.ForEachInScale(second, scales::GetUpperScale());
+
+  search::HouseDetector houser(&index);
+  vector<search::HouseResult> houses;
+
+  TEST_GREATER(houser.LoadStreets(first.GetFeatureIDs()), 0, ());
+  houser.MergeStreets();
+  houser.ReadAllHouses(100);
+  houser.GetHouseForName("7", houses);
+  TEST_EQUAL(houses.size(), 1, (houses));
+  m2::PointD const pt = houses[0].m_house->GetPosition();
+
+  TEST_GREATER(houser.LoadStreets(second.GetFeatureIDs()), 0, ());
+  houser.MergeStreets();
+  houser.ReadAllHouses(100);
+
+  // Streets of the first query are taken from the cache.
+  TEST_EQUAL(houser.LoadStreets(first.GetFeatureIDs()), 0, ());
+  houser.ReadAllHouses(100);
+  houses.clear();
+  houser.GetHouseForName("7", houses);
+  TEST_EQUAL(houses.size(), 1, (houses));
+  TEST_ALMOST_EQUAL_ULPS(houses[0].m_house->GetPosition(), pt, ());
+
+  houser.ClearCaches();
+  TEST_GREATER(houser.LoadStreets(first.GetFeatureIDs()), 0, ());
+}
+
 UNIT_TEST(HS_StreetsCompare)
 {
   search::Street A, B;
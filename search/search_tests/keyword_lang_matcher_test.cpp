@@ -69,3 +69,20 @@ UNIT_TEST(KeywordMatcher_LanguageMatchIsUsedWhenTokenMatchIsTheSame)
   TEST(matcher.Score(LANG_SOME, name) < matcher.Score(LANG_HIGH_PRIORITY, name), ());
   TEST(matcher.Score(LANG_SOME_OTHER, name) < matcher.Score(LANG_HIGH_PRIORITY, name), ());
 }
+
+UNIT_TEST(KeywordMatcher_BatchScore)
+{
+  KeywordLangMatcher matcher = CreateMatcher("test");
+
+  int8_t const langs[] = { LANG_UNKNOWN, LANG_HIGH_PRIORITY, LANG_SOME, LANG_HIGH_PRIORITY };
+  strings::UniString const names[] = {
+      search::NormalizeAndSimplifyString("test"), search::NormalizeAndSimplifyString("other"),
+      search::NormalizeAndSimplifyString("test"), search::NormalizeAndSimplifyString("test")};
+
+  ScoreT scores[ARRAY_SIZE(names)];
+  TEST_EQUAL(matcher.Score(langs, names, ARRAY_SIZE(names), scores), 3, ());
+  for (size_t i = 0; i < ARRAY_SIZE(names); ++i)
+    TEST_EQUAL(DebugPrint(scores[i]), DebugPrint(matcher.Score(langs[i], names[i])), (i));
+
+  TEST_EQUAL(matcher.Score(langs, names, 0, scores), 0, ());
+}
@@ -340,3 +340,25 @@ UNIT_TEST(KeywordMatcher_DifferentLangs)
   TEST(!(matcher.Score(arr[0]) < matcher.Score(arr[1])), ());
   TEST(!(matcher.Score(arr[1]) < matcher.Score(arr[0])), ());
 }
+
+UNIT_TEST(KeywordMatcher_StreamingEqualsTokens)
+{
+  char const * queries[] = { "san sa", "sa", "san ", "улица лен", "a b c", "zz" };
+  char const * names[] = { "San Salvador", "Salvador San", "San Sa", "sans", "Улица Ленина",
+                           "ленина улица,  дом", "a-b-c", "c b a", "", "  ", "zzz zz" };
+  for (char const * query : queries)
+  {
+    KeywordMatcher matcher;
+    InitMatcher(query, matcher);
+    for (char const * name : names)
+    {
+      strings::UniString const s = search::NormalizeAndSimplifyString(name);
+      vector<strings::UniString> tokens;
+      SplitUniString(s, MakeBackInsertFunctor(tokens), search::Delimiters());
+
+      string const expected = DebugPrint(matcher.Score(tokens.data(), tokens.size()));
+      TEST_EQUAL(DebugPrint(matcher.Score(s)), expected, (query, name));
+      TEST_EQUAL(DebugPrint(matcher.Score(name)), expected, (query, name));
+    }
+  }
+}
@@ -25,6 +25,7 @@ SOURCES += \
     query_saver_tests.cpp \
     string_intersection_test.cpp \
     string_match_test.cpp \
+    suggests_index_test.cpp \
 
 HEADERS += \
     match_cost_mock.hpp \
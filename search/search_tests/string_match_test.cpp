@@ -1,3 +1,4 @@
+#include "testing/benchmark.hpp"
 #include "testing/testing.hpp"
 #include "search/approximate_string_match.hpp"
 
@@ -8,6 +9,7 @@
 #include "base/stl_add.hpp"
 
 #include "std/cstring.hpp"
+#include "std/random.hpp"
 
 
 using namespace search;
@@ -76,6 +78,112 @@ UNIT_TEST(StringMatchCost_PrefixMatch)
   TEST_EQUAL(PrefixMatchCost("Happo", "Hello!"), 3, ());
 }
 
+UNIT_TEST(StringMatchCost_BitParallel)
+{
+  mt19937 rng(0);
+  uniform_int_distribution<int> randChar('a', 'd');
+  uniform_int_distribution<uint32_t> randSize(0, 12);
+  auto const randString = [&]()
+  {
+    UniString s(randSize(rng), 0);
+    for (auto & c : s)
+      c = randChar(rng);
+    return s;
+  };
+
+  DefaultMatchCost const costF;
+  for (int i = 0; i < 5000; ++i)
+  {
+    UniString const a = randString();
+    UniString const b = randString();
+    if (a.empty())
+      continue;
+
+    for (uint32_t maxCost : {0, 256, 511, 1024, 100000})
+    {
+      for (bool prefix : {false, true})
+      {
+        uint32_t const expected = search::impl::QueueMatchCost(a.data(), a.size(), b.data(),
+                                                               b.size(), costF, maxCost, prefix);
+        uint32_t const actual = search::impl::BitParallelMatchCost(a.data(), a.size(), b.data(),
+                                                                   b.size(), maxCost, prefix);
+        TEST_EQUAL(expected, actual, (ToUtf8(a), ToUtf8(b), maxCost, prefix));
+      }
+    }
+  }
+
+  // Max length of a bit-parallel string.
+  UniString const longA(search::impl::kMaxBitParallelSize, 'x');
+  UniString longB = longA;
+  longB[0] = 'y';
+  longB.back() = 'z';
+  TEST_EQUAL(2 * DefaultMatchCost::kEditCost,
+             StringMatchCost(longA.data(), longA.size(), longB.data(), longB.size(), costF,
+                             100000 /* maxCost */),
+             ());
+}
+
+#ifndef DEBUG
+namespace
+{
+// Most frequent tokens from the search index of minsk-pass.mwm
+// (generator_tool --dump_search_tokens).
+char const * g_searchTokens[] = {
+    "новоуфимская", "на", "мысли", "мост", "молдова", "могилевскии", "минска",
+    "мингорисполкома", "метрополитена", "менеджмента", "матвеевская", "мастер",
+    "литовская", "кристалл", "кофеберри", "кооперативныи", "комплекс", "компания",
+    "комитет", "клуб", "клиническая", "кафе", "историческии", "искусств", "изолятор",
+    "железнодорожная", "евросеть", "доктор", "дежурная", "гостиница", "городскои",
+    "гастроном", "галантереиная", "вагоноремонтныи", "буфет", "белорусская",
+    "белмедпрепараты", "белгазпромбанк", "ателье", "union", "silver", "screen", "pub",
+    "presto", "olivo", "no528", "minsk", "hotel", "funny", "chicken", "cafe", "bar"};
+
+template <typename TMatchCost>
+void BenchmarkMatchCost(TMatchCost const & matchCost)
+{
+  vector<UniString> tokens;
+  for (char const * token : g_searchTokens)
+    tokens.push_back(MakeUniString(token));
+
+  // Typos in the first tokens as in typed queries.
+  vector<UniString> queries(tokens.begin(), tokens.begin() + 10);
+  for (auto & query : queries)
+    swap(query[0], query[1]);
+
+  BENCHMARK_N_TIMES(1000, 10.0)
+  {
+    uint32_t sum = 0;
+    for (auto const & query : queries)
+    {
+      for (auto const & token : tokens)
+        sum += matchCost(query, token);
+    }
+    FORCE_USE_VALUE(sum);
+  }
+}
+}  // namespace
+
+BENCHMARK_TEST(StringMatchCost_Queue)
+{
+  BenchmarkMatchCost([](UniString const & a, UniString const & b)
+  {
+    return search::impl::QueueMatchCost(a.data(), a.size(), b.data(), b.size(),
+                                        DefaultMatchCost(), 3 * DefaultMatchCost::kEditCost,
+                                        true /* bPrefixMatch */);
+  });
+}
+
+BENCHMARK_TEST(StringMatchCost_BitParallel)
+{
+  BenchmarkMatchCost([](UniString const & a, UniString const & b)
+  {
+    return search::impl::BitParallelMatchCost(a.data(), a.size(), b.data(), b.size(),
+                                              3 * DefaultMatchCost::kEditCost,
+                                              true /* bPrefixMatch */);
+  });
+}
+#endif
+
 namespace
 {
 
@@ -0,0 +1,72 @@
+#include "testing/testing.hpp"
+
+#include "search/suggests_index.hpp"
+
+#include "base/string_utils.hpp"
+
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+using search::SuggestsIndex;
+
+namespace
+{
+int8_t const kEn = 1;
+int8_t const kRu = 2;
+
+vector<string> GetSuggests(SuggestsIndex const & index, int8_t locale, string const & prefix)
+{
+  vector<string> names;
+  index.ForEachSuggest(locale, strings::MakeUniString(prefix),
+                       [&names](SuggestsIndex::Suggest const & suggest)
+  {
+    names.push_back(strings::ToUtf8(suggest.m_name));
+  });
+  return names;
+}
+
+SuggestsIndex::Suggest MakeSuggest(string const & name, uint8_t len, int8_t locale)
+{
+  return SuggestsIndex::Suggest(strings::MakeUniString(name), len, locale);
+}
+}  // namespace
+
+UNIT_TEST(SuggestsIndex_Smoke)
+{
+  vector<SuggestsIndex::Suggest> suggests = {
+      MakeSuggest("cafe", 2, kEn),      MakeSuggest("car wash", 3, kEn),
+      MakeSuggest("cat", 1, kEn),       MakeSuggest("hotel", 1, kEn),
+      MakeSuggest("hospital", 4, kEn),  MakeSuggest("кафе", 2, kRu)};
+  SuggestsIndex const index(move(suggests));
+  TEST_EQUAL(index.GetCount(), 6, ());
+
+  TEST_EQUAL(GetSuggests(index, kEn, "c"), vector<string>({"cat"}), ());
+  TEST_EQUAL(GetSuggests(index, kEn, "ca"), vector<string>({"cat", "cafe"}), ());
+  TEST_EQUAL(GetSuggests(index, kEn, "car"), vector<string>({"car wash"}), ());
+  TEST_EQUAL(GetSuggests(index, kEn, "ho"), vector<string>({"hotel"}), ());
+  TEST_EQUAL(GetSuggests(index, kEn, "hosp"), vector<string>({"hospital"}), ());
+  TEST_EQUAL(GetSuggests(index, kEn, "hotels"), vector<string>(), ());
+  TEST_EQUAL(GetSuggests(index, kEn, "x"), vector<string>(), ());
+
+  TEST_EQUAL(GetSuggests(index, kRu, "ка"), vector<string>({"кафе"}), ());
+  TEST_EQUAL(GetSuggests(index, kRu, "ca"), vector<string>(), ());
+  TEST_EQUAL(GetSuggests(index, 3, "ca"), vector<string>(), ());
+}
+
+UNIT_TEST(SuggestsIndex_Top)
+{
+  vector<SuggestsIndex::Suggest> suggests;
+  for (char c = 'a'; c <= 'z'; ++c)
+    suggests.push_back(MakeSuggest(string("ab") + c, c == 'z' ? 1 : 2, kEn));
+  SuggestsIndex const index(move(suggests));
+
+  TEST_EQUAL(GetSuggests(index, kEn, "a"), vector<string>({"abz"}), ());
+
+  // Suggests of the shorter prefixes go first.
+  vector<string> expected = {"abz"};
+  for (char c = 'a'; expected.size() < SuggestsIndex::kTopCount; ++c)
+    expected.push_back(string("ab") + c);
+  TEST_EQUAL(GetSuggests(index, kEn, "ab"), expected, ());
+
+  TEST_EQUAL(GetSuggests(index, kEn, "abq"), vector<string>({"abq"}), ());
+}
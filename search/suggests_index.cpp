@@ -0,0 +1,128 @@
+#include "search/suggests_index.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+
+namespace search
+{
+class SuggestsIndex::TrieBuilder
+{
+public:
+  TrieBuilder(vector<Suggest> const & suggests, Trie & trie) : m_suggests(suggests), m_trie(trie)
+  {
+  }
+
+  /// @param ids Indices of the suggests of the trie, sorted by names.
+  void Build(vector<uint32_t> const & ids)
+  {
+    m_ids = &ids;
+    BuildNode(0, ids.size(), 0);
+  }
+
+private:
+  strings::UniString const & GetName(size_t i) const
+  {
+    return m_suggests[(*m_ids)[i]].m_name;
+  }
+
+  bool IsRankedHigher(uint32_t lhs, uint32_t rhs) const
+  {
+    Suggest const & l = m_suggests[lhs];
+    Suggest const & r = m_suggests[rhs];
+    if (l.m_prefixLength != r.m_prefixLength)
+      return l.m_prefixLength < r.m_prefixLength;
+    return l.m_name < r.m_name;
+  }
+
+  /// Builds the node of the names [begin, end) which have the same prefix of the depth length.
+  uint32_t BuildNode(size_t begin, size_t end, size_t depth)
+  {
+    uint32_t const node = static_cast<uint32_t>(m_trie.m_nodes.size());
+    m_trie.m_nodes.emplace_back();
+
+    vector<uint32_t> top;
+    for (size_t i = begin; i < end; ++i)
+    {
+      uint32_t const id = (*m_ids)[i];
+      if (m_suggests[id].m_prefixLength <= depth)
+        top.push_back(id);
+    }
+    size_t const topCount = min(top.size(), kTopCount);
+    partial_sort(top.begin(), top.begin() + topCount, top.end(),
+                 [this](uint32_t lhs, uint32_t rhs) { return IsRankedHigher(lhs, rhs); });
+    m_trie.m_nodes[node].m_topBegin = static_cast<uint32_t>(m_trie.m_top.size());
+    m_trie.m_top.insert(m_trie.m_top.end(), top.begin(), top.begin() + topCount);
+    m_trie.m_nodes[node].m_topEnd = static_cast<uint32_t>(m_trie.m_top.size());
+
+    // Names which end at the node go first, the others are grouped by their next chars.
+    vector<pair<size_t, size_t>> children;
+    for (size_t i = begin; i < end;)
+    {
+      if (GetName(i).size() == depth)
+      {
+        ++i;
+        continue;
+      }
+      strings::UniChar const c = GetName(i)[depth];
+      size_t j = i + 1;
+      while (j < end && GetName(j)[depth] == c)
+        ++j;
+      children.emplace_back(i, j);
+      i = j;
+    }
+
+    uint32_t const edgesBegin = static_cast<uint32_t>(m_trie.m_edges.size());
+    m_trie.m_edges.resize(m_trie.m_edges.size() + children.size());
+    m_trie.m_nodes[node].m_edgesBegin = edgesBegin;
+    m_trie.m_nodes[node].m_edgesEnd = static_cast<uint32_t>(m_trie.m_edges.size());
+    for (size_t k = 0; k < children.size(); ++k)
+    {
+      strings::UniChar const c = GetName(children[k].first)[depth];
+      uint32_t const child = BuildNode(children[k].first, children[k].second, depth + 1);
+      m_trie.m_edges[edgesBegin + k].m_char = c;
+      m_trie.m_edges[edgesBegin + k].m_node = child;
+    }
+    return node;
+  }
+
+  vector<Suggest> const & m_suggests;
+  Trie & m_trie;
+  vector<uint32_t> const * m_ids = nullptr;
+};
+
+// static
+size_t const SuggestsIndex::kTopCount;
+
+SuggestsIndex::SuggestsIndex(vector<Suggest> && suggests) : m_suggests(move(suggests))
+{
+  map<int8_t, vector<uint32_t>> localeIds;
+  for (uint32_t i = 0; i < m_suggests.size(); ++i)
+    localeIds[m_suggests[i].m_locale].push_back(i);
+
+  for (auto & locale : localeIds)
+  {
+    vector<uint32_t> & ids = locale.second;
+    sort(ids.begin(), ids.end(), [this](uint32_t lhs, uint32_t rhs)
+    {
+      return m_suggests[lhs].m_name < m_suggests[rhs].m_name;
+    });
+    TrieBuilder(m_suggests, m_tries[locale.first]).Build(ids);
+  }
+}
+
+bool SuggestsIndex::Trie::FindChild(uint32_t node, strings::UniChar c, uint32_t & child) const
+{
+  Node const & n = m_nodes[node];
+  auto const begin = m_edges.begin() + n.m_edgesBegin;
+  auto const end = m_edges.begin() + n.m_edgesEnd;
+  auto const it = lower_bound(begin, end, c, [](Edge const & e, strings::UniChar ch)
+  {
+    return e.m_char < ch;
+  });
+  if (it == end || it->m_char != c)
+    return false;
+  child = it->m_node;
+  return true;
+}
+}  // namespace search
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "search/search_common.hpp"
+
+#include "base/string_utils.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/map.hpp"
+#include "std/vector.hpp"
+
+namespace search
+{
+/// Prefix index of the strings to suggest, which are the category names of categories.txt.
+/// Each locale has its own trie of the names, and each node of the trie keeps the top suggests
+/// of its subtree which are allowed for the prefix of the node, so the suggests of a prefix
+/// are found by the walk down the trie only.
+/// Suggests are ranked by their prefix lengths, the names which are suggested from the shorter
+/// prefixes go first, and then by the names.
+class SuggestsIndex
+{
+public:
+  struct Suggest
+  {
+    Suggest(strings::UniString const & name, uint8_t len, int8_t locale)
+      : m_name(name), m_prefixLength(len), m_locale(locale)
+    {
+    }
+
+    strings::UniString m_name;
+    /// Suggest is shown when the prefix is not shorter than this length.
+    uint8_t m_prefixLength;
+    int8_t m_locale;
+  };
+
+  /// Number of the suggests which are kept by each node. The one more than the results may take
+  /// makes up for the suggest which equals to the prefix itself.
+  static size_t const kTopCount = MAX_SUGGESTS_COUNT + 1;
+
+  SuggestsIndex() = default;
+  /// @param suggests Suggests with the unique pairs of names and locales.
+  explicit SuggestsIndex(vector<Suggest> && suggests);
+
+  /// Calls toDo(suggest) for the top suggests of the locale, which start with the prefix and
+  /// are allowed for its length, in the order of their rank.
+  template <typename ToDo>
+  void ForEachSuggest(int8_t locale, strings::UniString const & prefix, ToDo && toDo) const
+  {
+    auto const it = m_tries.find(locale);
+    if (it == m_tries.end())
+      return;
+
+    Trie const & trie = it->second;
+    uint32_t node = 0;
+    for (strings::UniChar const c : prefix)
+    {
+      if (!trie.FindChild(node, c, node))
+        return;
+    }
+
+    Node const & n = trie.m_nodes[node];
+    for (uint32_t i = n.m_topBegin; i < n.m_topEnd; ++i)
+      toDo(m_suggests[trie.m_top[i]]);
+  }
+
+  inline size_t GetCount() const { return m_suggests.size(); }
+
+private:
+  struct Node
+  {
+    Node() : m_edgesBegin(0), m_edgesEnd(0), m_topBegin(0), m_topEnd(0) {}
+
+    /// Children are m_edges[m_edgesBegin, m_edgesEnd), sorted by the chars.
+    uint32_t m_edgesBegin, m_edgesEnd;
+    /// Top suggests are m_top[m_topBegin, m_topEnd).
+    uint32_t m_topBegin, m_topEnd;
+  };
+
+  struct Edge
+  {
+    strings::UniChar m_char;
+    uint32_t m_node;
+  };
+
+  struct Trie
+  {
+    bool FindChild(uint32_t node, strings::UniChar c, uint32_t & child) const;
+
+    /// Root is the first node.
+    vector<Node> m_nodes;
+    vector<Edge> m_edges;
+    /// Indices of the suggests in SuggestsIndex::m_suggests.
+    vector<uint32_t> m_top;
+  };
+
+  class TrieBuilder;
+
+  vector<Suggest> m_suggests;
+  map<int8_t, Trie> m_tries;
+};
+}  // namespace search
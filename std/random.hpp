@@ -8,6 +8,7 @@
 
 using std::mt19937;
 using std::uniform_int_distribution;
+using std::uniform_real_distribution;
 
 #ifdef DEBUG_NEW
 #define new DEBUG_NEW
@@ -8,12 +8,14 @@
 #include <type_traits>
 
 using std::conditional;
+using std::decay;
 using std::enable_if;
 using std::is_arithmetic;
 using std::is_floating_point;
 using std::is_integral;
 using std::is_pod;
 using std::is_same;
+using std::is_trivially_destructible;
 using std::is_signed;
 using std::is_unsigned;
 using std::make_signed;
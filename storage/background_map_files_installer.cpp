@@ -0,0 +1,55 @@
+#include "storage/background_map_files_installer.hpp"
+
+#include "platform/platform.hpp"
+
+#include "base/assert.hpp"
+#include "base/work_stealing_pool.hpp"
+
+#include "std/target_os.hpp"
+
+namespace storage
+{
+namespace
+{
+// Installing is mostly i/o bound, a couple of threads keep the disk busy.
+size_t constexpr kThreadsCount = 2;
+size_t constexpr kMaxPendingTasks = 1024;
+}  // namespace
+
+BackgroundMapFilesInstaller::BackgroundMapFilesInstaller() : m_alive(make_shared<bool>(true))
+{
+#if defined(OMIM_OS_MAC) || defined(OMIM_OS_IPHONE) || defined(OMIM_OS_ANDROID)
+  m_pool.reset(new threads::WorkStealingPool(kThreadsCount, kMaxPendingTasks));
+#endif
+}
+
+BackgroundMapFilesInstaller::~BackgroundMapFilesInstaller()
+{
+  ASSERT(m_checker.CalledOnOriginalThread(), ());
+  *m_alive = false;
+  // Waits for the running tasks.
+  m_pool.reset();
+}
+
+void BackgroundMapFilesInstaller::Install(TInstallFn const & install,
+                                          TInstalledCallback const & onInstalled)
+{
+  ASSERT(m_checker.CalledOnOriginalThread(), ());
+  if (!m_pool)
+  {
+    onInstalled(install());
+    return;
+  }
+
+  shared_ptr<bool> alive = m_alive;
+  m_pool->Push([alive, install, onInstalled]()
+  {
+    bool const success = install();
+    GetPlatform().RunOnGuiThread([alive, onInstalled, success]()
+    {
+      if (*alive)
+        onInstalled(success);
+    });
+  });
+}
+}  // namespace storage
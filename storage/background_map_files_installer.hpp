@@ -0,0 +1,37 @@
+#pragma once
+
+#include "storage/map_files_installer.hpp"
+
+#include "base/thread_checker.hpp"
+
+#include "std/shared_ptr.hpp"
+#include "std/unique_ptr.hpp"
+
+namespace threads
+{
+class WorkStealingPool;
+}  // namespace threads
+
+namespace storage
+{
+/// Installs the files of several countries at once on a pool of threads and returns
+/// the results on the GUI thread, so bulk downloads don't block it. The files are
+/// installed synchronously on the platforms which can't post tasks to the GUI thread.
+//
+// *NOTE*, this class is not thread-safe.
+class BackgroundMapFilesInstaller : public MapFilesInstaller
+{
+public:
+  BackgroundMapFilesInstaller();
+  ~BackgroundMapFilesInstaller() override;
+
+  // MapFilesInstaller overrides:
+  void Install(TInstallFn const & install, TInstalledCallback const & onInstalled) override;
+
+private:
+  /// Callbacks of the tasks which are done after the installer is destroyed are dropped.
+  shared_ptr<bool> m_alive;
+  unique_ptr<threads::WorkStealingPool> m_pool;
+  ThreadChecker m_checker;
+};
+}  // namespace storage
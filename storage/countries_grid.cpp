@@ -0,0 +1,117 @@
+#include "storage/countries_grid.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "base/assert.hpp"
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+
+namespace storage
+{
+// static
+uint32_t const CountriesGrid::kSize;
+
+CountriesGrid::CountriesGrid()
+  : m_rect(MercatorBounds::FullRect()),
+    m_cellWidth(m_rect.SizeX() / kSize),
+    m_cellHeight(m_rect.SizeY() / kSize)
+{
+}
+
+// static
+uint32_t CountriesGrid::GetCellCoord(double d, double min, double cellSize)
+{
+  double const coord = floor((d - min) / cellSize);
+  return static_cast<uint32_t>(my::clamp(coord, 0.0, static_cast<double>(kSize - 1)));
+}
+
+void CountriesGrid::AddRegion(size_t id, m2::RegionD const & region)
+{
+  vector<m2::PointD> const & points = region.Data();
+  if (points.empty())
+    return;
+  if (m_cells.empty())
+    m_cells.resize(kSize * kSize);
+
+  m2::RectD const rect = region.GetRect();
+  uint32_t const minX = GetCellCoord(rect.minX(), m_rect.minX(), m_cellWidth);
+  uint32_t const minY = GetCellCoord(rect.minY(), m_rect.minY(), m_cellHeight);
+  uint32_t const maxX = GetCellCoord(rect.maxX(), m_rect.minX(), m_cellWidth);
+  uint32_t const maxY = GetCellCoord(rect.maxY(), m_rect.minY(), m_cellHeight);
+  uint32_t const width = maxX - minX + 1;
+
+  // Cells which are crossed by the border, the covering by the edges rects is conservative.
+  vector<bool> isBorder(width * (maxY - minY + 1), false);
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    m2::PointD const & p1 = points[i];
+    m2::PointD const & p2 = points[(i + 1) % points.size()];
+    uint32_t const x1 = GetCellCoord(min(p1.x, p2.x), m_rect.minX(), m_cellWidth);
+    uint32_t const x2 = GetCellCoord(max(p1.x, p2.x), m_rect.minX(), m_cellWidth);
+    uint32_t const y1 = GetCellCoord(min(p1.y, p2.y), m_rect.minY(), m_cellHeight);
+    uint32_t const y2 = GetCellCoord(max(p1.y, p2.y), m_rect.minY(), m_cellHeight);
+    for (uint32_t y = y1; y <= y2; ++y)
+    {
+      for (uint32_t x = x1; x <= x2; ++x)
+        isBorder[(y - minY) * width + x - minX] = true;
+    }
+  }
+
+  uint32_t const borderEntry = static_cast<uint32_t>(id) << 1;
+  uint32_t const insideEntry = borderEntry | 1;
+  for (uint32_t y = minY; y <= maxY; ++y)
+  {
+    // The border doesn't cross the run of the non-border cells of a row,
+    // so the whole run is either inside or outside of the region.
+    bool isRunInside = false;
+    bool isRunStarted = false;
+    for (uint32_t x = minX; x <= maxX; ++x)
+    {
+      vector<uint32_t> & cell = m_cells[GetCellIndex(x, y)];
+      if (isBorder[(y - minY) * width + x - minX])
+      {
+        isRunStarted = false;
+        cell.push_back(borderEntry);
+        continue;
+      }
+
+      if (!isRunStarted)
+      {
+        m2::PointD const center(m_rect.minX() + (x + 0.5) * m_cellWidth,
+                                m_rect.minY() + (y + 0.5) * m_cellHeight);
+        isRunInside = region.Contains(center);
+        isRunStarted = true;
+      }
+      if (isRunInside)
+        cell.push_back(insideEntry);
+    }
+  }
+}
+
+void CountriesGrid::Finish()
+{
+  m_offsets.clear();
+  m_entries.clear();
+  m_offsets.reserve(kSize * kSize + 1);
+  m_offsets.push_back(0);
+  if (m_cells.empty())
+    m_cells.resize(kSize * kSize);
+
+  for (vector<uint32_t> & cell : m_cells)
+  {
+    // The inside entry of a country goes after its border ones, it's kept only.
+    sort(cell.begin(), cell.end());
+    for (size_t i = 0; i < cell.size(); ++i)
+    {
+      if (i + 1 < cell.size() && (cell[i] >> 1) == (cell[i + 1] >> 1))
+        continue;
+      m_entries.push_back(cell[i]);
+    }
+    m_offsets.push_back(static_cast<uint32_t>(m_entries.size()));
+  }
+
+  vector<vector<uint32_t>>().swap(m_cells);
+}
+}  // namespace storage
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+#include "geometry/region2d.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+namespace storage
+{
+/// Uniform grid over the mercator world with the countries of each cell. A cell which is
+/// covered by one country only answers the point queries without the country polygons,
+/// the polygons of the other cell countries should be checked in the order of the ids.
+class CountriesGrid
+{
+public:
+  /// Cells count by each side.
+  static uint32_t const kSize = 256;
+
+  CountriesGrid();
+
+  /// @name Building.
+  //@{
+  /// @param[in] id Index of the country in the packed polygons.
+  void AddRegion(size_t id, m2::RegionD const & region);
+  void Finish();
+  //@}
+
+  inline bool IsEmpty() const { return m_offsets.empty(); }
+
+  template <class TWriter> void Serialize(TWriter & writer) const;
+  template <class TSource> void Deserialize(TSource & src);
+
+  /// Calls fn(id, isCellInside) for the countries of the point cell in the order of the ids
+  /// till fn returns false. isCellInside means that the whole cell is in the country.
+  template <class TFn> void ForEachCountry(m2::PointD const & pt, TFn && fn) const
+  {
+    if (IsEmpty() || !m_rect.IsPointInside(pt))
+      return;
+
+    size_t const cell = GetCellIndex(GetCellCoord(pt.x, m_rect.minX(), m_cellWidth),
+                                     GetCellCoord(pt.y, m_rect.minY(), m_cellHeight));
+    for (uint32_t i = m_offsets[cell]; i < m_offsets[cell + 1]; ++i)
+    {
+      if (!fn(m_entries[i] >> 1, (m_entries[i] & 1) != 0))
+        return;
+    }
+  }
+
+private:
+  static inline size_t GetCellIndex(uint32_t x, uint32_t y) { return y * kSize + x; }
+  static uint32_t GetCellCoord(double d, double min, double cellSize);
+
+  m2::RectD m_rect;
+  double m_cellWidth;
+  double m_cellHeight;
+
+  /// Entries of cell i are [m_offsets[i], m_offsets[i + 1]), each entry is
+  /// (country id << 1) | isCellInside.
+  vector<uint32_t> m_offsets;
+  vector<uint32_t> m_entries;
+
+  /// Cells entries while the grid is built.
+  vector<vector<uint32_t>> m_cells;
+};
+
+template <class TWriter>
+void CountriesGrid::Serialize(TWriter & writer) const
+{
+  ASSERT(!IsEmpty(), ());
+  WriteVarUint(writer, kSize);
+  for (size_t cell = 0; cell + 1 < m_offsets.size(); ++cell)
+  {
+    WriteVarUint(writer, m_offsets[cell + 1] - m_offsets[cell]);
+    for (uint32_t i = m_offsets[cell]; i < m_offsets[cell + 1]; ++i)
+      WriteVarUint(writer, m_entries[i]);
+  }
+}
+
+template <class TSource>
+void CountriesGrid::Deserialize(TSource & src)
+{
+  uint32_t const size = ReadVarUint<uint32_t>(src);
+  CHECK_EQUAL(size, kSize, ("Unsupported grid"));
+
+  m_offsets.clear();
+  m_entries.clear();
+  m_offsets.reserve(kSize * kSize + 1);
+  m_offsets.push_back(0);
+  for (size_t cell = 0; cell < kSize * kSize; ++cell)
+  {
+    uint32_t const count = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < count; ++i)
+      m_entries.push_back(ReadVarUint<uint32_t>(src));
+    m_offsets.push_back(static_cast<uint32_t>(m_entries.size()));
+  }
+  m_entries.shrink_to_fit();
+}
+}  // namespace storage
@@ -2,8 +2,14 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/read_write_utils.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
 #include "base/logging.hpp"
 
+#include "std/vector.hpp"
+
 #include "3party/jansson/myjansson.hpp"
 
 using platform::CountryFile;
@@ -240,4 +246,125 @@ bool SaveCountries(int64_t version, CountriesContainerT const & countries, strin
   return true;
 }
 
+namespace
+{
+// Bump it when the layout of the binary file is changed.
+uint8_t const kBinaryFormat = 2;
+
+template <class TSink>
+void SaveBinaryImpl(CountriesContainerT const & v, uint32_t depth, TSink & sink)
+{
+  for (size_t i = 0; i < v.SiblingsCount(); ++i)
+  {
+    Country const & country = v[i].Value();
+    WriteVarUint(sink, depth);
+    rw::Write(sink, country.Name());
+    rw::Write(sink, country.Flag());
+
+    size_t const filesCount = country.GetFilesCount();
+    ASSERT_LESS_OR_EQUAL(filesCount, 1, ());
+    WriteVarUint(sink, static_cast<uint32_t>(filesCount));
+    if (filesCount > 0)
+    {
+      CountryFile const & file = country.GetFile();
+      rw::Write(sink, file.GetNameWithoutExt());
+      WriteVarUint(sink, file.GetRemoteSize(MapOptions::Map));
+      WriteVarUint(sink, file.GetRemoteSize(MapOptions::CarRouting));
+    }
+
+    SaveBinaryImpl(v[i], depth + 1, sink);
+  }
+}
+
+class NodesCounter
+{
+public:
+  NodesCounter() : m_count(0) {}
+  void operator()(CountriesContainerT const &) { ++m_count; }
+
+  uint32_t m_count;
+};
+}  // namespace
+
+uint64_t HashCountriesJson(string const & jsonBuffer)
+{
+  // FNV-1a, it's stable between the platforms unlike std::hash.
+  uint64_t hash = 14695981039346656037ULL;
+  for (char const c : jsonBuffer)
+  {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+void SaveCountriesBinary(int64_t version, string const & jsonBuffer,
+                         CountriesContainerT const & countries, Writer & writer)
+{
+  WriteToSink(writer, kBinaryFormat);
+  WriteToSink(writer, static_cast<uint64_t>(jsonBuffer.size()));
+  WriteToSink(writer, HashCountriesJson(jsonBuffer));
+  WriteVarInt(writer, version);
+
+  // The nodes are prefixed with their size to detect the truncated file.
+  vector<char> nodes;
+  {
+    MemWriter<vector<char>> nodesWriter(nodes);
+    NodesCounter counter;
+    countries.ForEachChildren(counter);
+    WriteVarUint(nodesWriter, counter.m_count);
+    SaveBinaryImpl(countries, 0 /* depth */, nodesWriter);
+  }
+  WriteVarUint(writer, static_cast<uint64_t>(nodes.size()));
+  writer.Write(nodes.data(), nodes.size());
+}
+
+int64_t LoadCountriesBinary(ReaderPtr<Reader> const & reader, string const & jsonBuffer,
+                            CountriesContainerT & countries)
+{
+  countries.Clear();
+
+  try
+  {
+    ReaderSource<ReaderPtr<Reader>> src(reader);
+    if (ReadPrimitiveFromSource<uint8_t>(src) != kBinaryFormat)
+      return -1;
+    // The size is compared first, so the json of another size isn't hashed.
+    if (ReadPrimitiveFromSource<uint64_t>(src) != jsonBuffer.size())
+      return -1;
+    if (ReadPrimitiveFromSource<uint64_t>(src) != HashCountriesJson(jsonBuffer))
+      return -1;
+    int64_t const version = ReadVarInt<int64_t>(src);
+    if (ReadVarUint<uint64_t>(src) != src.Size())
+      return -1;
+
+    uint32_t const count = ReadVarUint<uint32_t>(src);
+    string name, flag, file;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      uint32_t const depth = ReadVarUint<uint32_t>(src);
+      rw::Read(src, name);
+      rw::Read(src, flag);
+
+      Country country(name, flag);
+      if (ReadVarUint<uint32_t>(src) > 0)
+      {
+        rw::Read(src, file);
+        uint32_t const mapSize = ReadVarUint<uint32_t>(src);
+        uint32_t const routingSize = ReadVarUint<uint32_t>(src);
+        CountryFile countryFile(file);
+        countryFile.SetRemoteSizes(mapSize, routingSize);
+        country.AddFile(countryFile);
+      }
+      countries.AddAtDepth(static_cast<int>(depth), country);
+    }
+    return version;
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LWARNING, ("Can't load binary countries file", e.Msg()));
+    countries.Clear();
+    return -1;
+  }
+}
 }  // namespace storage
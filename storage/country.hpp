@@ -8,6 +8,9 @@
 
 #include "platform/country_defines.hpp"
 
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
 #include "defines.hpp"
 
 #include "geometry/rect2d.hpp"
@@ -69,4 +72,19 @@ void LoadCountryFile2CountryInfo(string const & jsonBuffer, map<string, CountryI
 void LoadCountryCode2File(string const & jsonBuffer, multimap<string, string> & code2file);
 
 bool SaveCountries(int64_t version, CountriesContainerT const & countries, string & jsonBuffer);
+
+/// @name Binary countries file.
+/// It's the tree from countries.txt flattened in the preorder, so it's loaded without
+/// the json parsing. The json stays the source of truth: the binary file keeps the size
+/// and the hash of the json it's built from and it isn't loaded for another json.
+//@{
+uint64_t HashCountriesJson(string const & jsonBuffer);
+
+void SaveCountriesBinary(int64_t version, string const & jsonBuffer,
+                         CountriesContainerT const & countries, Writer & writer);
+
+/// @return version of country file or -1 if the file is broken or it's built from another json.
+int64_t LoadCountriesBinary(ReaderPtr<Reader> const & reader, string const & jsonBuffer,
+                            CountriesContainerT & countries);
+//@}
 }  // namespace storage
@@ -42,7 +42,7 @@ namespace storage
   */
 
   CountryInfoGetter::CountryInfoGetter(ModelReaderPtr polyR, ModelReaderPtr countryR)
-    : m_reader(polyR), m_cache(3)
+    : m_reader(polyR), m_cache(8 /* count */, 8 /* maxWeight */)
   {
     ReaderSource<ModelReaderPtr> src(m_reader.GetReader(PACKED_POLYGONS_INFO_TAG));
     rw::Read(src, m_countries);
@@ -57,6 +57,12 @@ namespace storage
 #endif
 */
 
+    if (m_reader.IsExist(PACKED_POLYGONS_GRID_TAG))
+    {
+      ReaderSource<ModelReaderPtr> gridSrc(m_reader.GetReader(PACKED_POLYGONS_GRID_TAG));
+      m_grid.Deserialize(gridSrc);
+    }
+
     string buffer;
     countryR.ReadAsString(buffer);
     LoadCountryFile2CountryInfo(buffer, m_id2info);
@@ -73,7 +79,8 @@ namespace storage
 
   bool CountryInfoGetter::GetByPoint::operator() (size_t id)
   {
-    vector<m2::RegionD> const & rgnV = m_info.GetRegions(id);
+    TRegionsPtr const regions = m_info.GetRegions(id);
+    vector<m2::RegionD> const & rgnV = *regions;
 
     for (size_t i = 0; i < rgnV.size(); ++i)
     {
@@ -87,48 +94,63 @@ namespace storage
     return true;
   }
 
-  vector<m2::RegionD> const & CountryInfoGetter::GetRegions(size_t id) const
+  CountryInfoGetter::TRegionsPtr CountryInfoGetter::GetRegions(size_t id) const
   {
-    bool isFound = false;
-    vector<m2::RegionD> & rgnV = m_cache.Find(static_cast<uint32_t>(id), isFound);
-
-    if (!isFound)
-    {
-      rgnV.clear();
+    TRegionsPtr regions;
+    if (m_cache.Find(static_cast<uint32_t>(id), regions))
+      return regions;
 
-      // load regions from file
-      ReaderSource<ModelReaderPtr> src(m_reader.GetReader(strings::to_string(id)));
+    // load regions from file
+    auto rgnV = make_shared<vector<m2::RegionD>>();
+    ReaderSource<ModelReaderPtr> src(m_reader.GetReader(strings::to_string(id)));
 
-      uint32_t const count = ReadVarUint<uint32_t>(src);
-      for (size_t i = 0; i < count; ++i)
-      {
-        vector<m2::PointD> points;
-        serial::LoadOuterPath(src, serial::CodingParams(), points);
-        rgnV.emplace_back(points.begin(), points.end());
-      }
+    uint32_t const count = ReadVarUint<uint32_t>(src);
+    for (size_t i = 0; i < count; ++i)
+    {
+      vector<m2::PointD> points;
+      serial::LoadOuterPath(src, serial::CodingParams(), points);
+      rgnV->emplace_back(points.begin(), points.end());
     }
 
+    m_cache.Insert(static_cast<uint32_t>(id), rgnV);
     return rgnV;
   }
 
-  string CountryInfoGetter::GetRegionFile(m2::PointD const & pt) const
+  size_t CountryInfoGetter::FindCountry(m2::PointD const & pt) const
   {
     GetByPoint doGet(*this, pt);
-    ForEachCountry(pt, doGet);
+    if (m_grid.IsEmpty())
+    {
+      ForEachCountry(pt, doGet);
+      return doGet.m_res;
+    }
 
-    if (doGet.m_res != -1)
-      return m_countries[doGet.m_res].m_name;
+    m_grid.ForEachCountry(pt, [&](size_t id, bool isCellInside)
+    {
+      if (isCellInside)
+      {
+        doGet.m_res = id;
+        return false;
+      }
+      return !m_countries[id].m_rect.IsPointInside(pt) || doGet(id);
+    });
+    return doGet.m_res;
+  }
+
+  string CountryInfoGetter::GetRegionFile(m2::PointD const & pt) const
+  {
+    size_t const id = FindCountry(pt);
+    if (id != static_cast<size_t>(-1))
+      return m_countries[id].m_name;
     else
       return string();
   }
 
   void CountryInfoGetter::GetRegionInfo(m2::PointD const & pt, CountryInfo & info) const
   {
-    GetByPoint doGet(*this, pt);
-    ForEachCountry(pt, doGet);
-
-    if (doGet.m_res != -1)
-      GetRegionInfo(m_countries[doGet.m_res].m_name, info);
+    size_t const id = FindCountry(pt);
+    if (id != static_cast<size_t>(-1))
+      GetRegionInfo(m_countries[id].m_name, info);
   }
 
   void CountryInfoGetter::GetRegionInfo(string const & id, CountryInfo & info) const
@@ -236,22 +258,8 @@ namespace storage
     return false;
   }
 
-namespace
-{
-  class DoFreeCacheMemory
-  {
-  public:
-    void operator() (vector<m2::RegionD> & v) const
-    {
-      vector<m2::RegionD> emptyV;
-      emptyV.swap(v);
-    }
-  };
-}
-
   void CountryInfoGetter::ClearCaches() const
   {
-    m_cache.ForEachValue(DoFreeCacheMemory());
-    m_cache.Reset();
+    m_cache.Clear();
   }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "storage/countries_grid.hpp"
 #include "storage/country_decl.hpp"
 
 #include "geometry/region2d.hpp"
@@ -8,6 +9,9 @@
 
 #include "base/cache.hpp"
 
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+
 
 namespace storage
 {
@@ -22,9 +26,20 @@ namespace storage
     /// ID - is a country file name without an extension.
     map<string, CountryInfo> m_id2info;
 
-    mutable my::Cache<uint32_t, vector<m2::RegionD> > m_cache;
+    using TRegionsPtr = shared_ptr<vector<m2::RegionD> const>;
+
+    /// Regions of the last looked up countries, it's shared by the threads.
+    mutable my::SetAssociativeCache<uint32_t, TRegionsPtr, hash<uint32_t>,
+                                    my::cache::UnitWeight<TRegionsPtr>, mutex> m_cache;
+
+    /// Most of the points are resolved by the grid without the polygons,
+    /// it's empty for the old packed polygons.
+    CountriesGrid m_grid;
+
+    TRegionsPtr GetRegions(size_t id) const;
 
-    vector<m2::RegionD> const & GetRegions(size_t id) const;
+    /// @return Index in m_countries or -1.
+    size_t FindCountry(m2::PointD const & pt) const;
 
     template <class ToDo>
     void ForEachCountry(m2::PointD const & pt, ToDo & toDo) const;
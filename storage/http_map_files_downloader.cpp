@@ -3,7 +3,10 @@
 #include "platform/platform.hpp"
 #include "platform/servers_list.hpp"
 
+#include "coding/file_writer.hpp"
+
 #include "base/assert.hpp"
+#include "base/logging.hpp"
 
 #include "std/bind.hpp"
 #include "base/string_utils.hpp"
@@ -35,6 +38,16 @@ void HttpMapFilesDownloader::DownloadMapFile(vector<string> const & urls, string
       bind(&HttpMapFilesDownloader::OnMapFileDownloadingProgress, this, onProgress, _1)));
 }
 
+void HttpMapFilesDownloader::DownloadDiffFile(vector<string> const & urls, string const & path,
+                                              TDiffDownloadedCallback const & onDownloaded)
+{
+  ASSERT(m_checker.CalledOnOriginalThread(), ());
+  ASSERT(!urls.empty(), ());
+  // Diffs are small, so the first server is asked and the response is kept in memory.
+  m_request.reset(downloader::HttpRequest::Get(
+      urls.front(), bind(&HttpMapFilesDownloader::OnDiffFileDownloaded, this, path, onDownloaded, _1)));
+}
+
 MapFilesDownloader::TProgress HttpMapFilesDownloader::GetDownloadingProgress()
 {
   ASSERT(m_checker.CalledOnOriginalThread(), ());
@@ -70,6 +83,32 @@ void HttpMapFilesDownloader::OnMapFileDownloaded(TFileDownloadedCallback const &
   onDownloaded(success, request.Progress());
 }
 
+void HttpMapFilesDownloader::OnDiffFileDownloaded(string const & path,
+                                                  TDiffDownloadedCallback const & onDownloaded,
+                                                  downloader::HttpRequest & request)
+{
+  ASSERT(m_checker.CalledOnOriginalThread(), ());
+  if (request.Status() != downloader::HttpRequest::ECompleted)
+  {
+    onDownloaded(false);
+    return;
+  }
+
+  try
+  {
+    string const & data = request.Data();
+    FileWriter writer(path);
+    writer.Write(data.data(), data.size());
+  }
+  catch (Writer::Exception const & ex)
+  {
+    LOG(LWARNING, ("Can't write diff file", path, ex.Msg()));
+    onDownloaded(false);
+    return;
+  }
+  onDownloaded(true);
+}
+
 void HttpMapFilesDownloader::OnMapFileDownloadingProgress(
     TDownloadingProgressCallback const & onProgress, downloader::HttpRequest & request)
 {
@@ -21,6 +21,8 @@ public:
   void DownloadMapFile(vector<string> const & urls, string const & path, int64_t size,
                        TFileDownloadedCallback const & onDownloaded,
                        TDownloadingProgressCallback const & onProgress) override;
+  void DownloadDiffFile(vector<string> const & urls, string const & path,
+                        TDiffDownloadedCallback const & onDownloaded) override;
   TProgress GetDownloadingProgress() override;
   bool IsIdle() override;
   void Reset() override;
@@ -30,6 +32,8 @@ private:
                                downloader::HttpRequest & request);
   void OnMapFileDownloaded(TFileDownloadedCallback const & onDownloaded,
                            downloader::HttpRequest & request);
+  void OnDiffFileDownloaded(string const & path, TDiffDownloadedCallback const & onDownloaded,
+                            downloader::HttpRequest & request);
   void OnMapFileDownloadingProgress(TDownloadingProgressCallback const & onProgress,
                                     downloader::HttpRequest & request);
 
@@ -19,6 +19,7 @@ public:
   using TFileDownloadedCallback = function<void(bool success, TProgress const & progress)>;
   using TDownloadingProgressCallback = function<void(TProgress const & progress)>;
   using TServersListCallback = function<void(vector<string> & urls)>;
+  using TDiffDownloadedCallback = function<void(bool success)>;
 
   virtual ~MapFilesDownloader() = default;
 
@@ -34,6 +35,14 @@ public:
                                TFileDownloadedCallback const & onDownloaded,
                                TDownloadingProgressCallback const & onProgress) = 0;
 
+  /// Asynchronously downloads a diff file of unknown size to path and invokes
+  /// onDownloaded callback on the original thread. Diffs aren't supported by default.
+  virtual void DownloadDiffFile(vector<string> const & urls, string const & path,
+                                TDiffDownloadedCallback const & onDownloaded)
+  {
+    onDownloaded(false);
+  }
+
   /// Returns current downloading progress.
   virtual TProgress GetDownloadingProgress() = 0;
 
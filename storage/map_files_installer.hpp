@@ -0,0 +1,22 @@
+#pragma once
+
+#include "std/function.hpp"
+
+namespace storage
+{
+// This interface encapsulates installing of the downloaded map files:
+// applying of the diffs, verifying and moving of the files to their places.
+class MapFilesInstaller
+{
+public:
+  /// Does the heavy part of the installing, it must not touch the storage.
+  using TInstallFn = function<bool()>;
+  using TInstalledCallback = function<void(bool success)>;
+
+  virtual ~MapFilesInstaller() = default;
+
+  /// Asynchronously runs install and invokes onInstalled callback with its
+  /// result on the original thread.
+  virtual void Install(TInstallFn const & install, TInstalledCallback const & onInstalled) = 0;
+};
+}  // namespace storage
@@ -5,7 +5,12 @@
 namespace storage
 {
 QueuedCountry::QueuedCountry(TIndex const & index, MapOptions opt)
-    : m_index(index), m_init(opt), m_left(opt), m_current(MapOptions::Nothing)
+    : m_index(index)
+    , m_init(opt)
+    , m_left(opt)
+    , m_current(MapOptions::Nothing)
+    , m_diffTried(false)
+    , m_progress(0, 0)
 {
   ASSERT(GetIndex().IsValid(), ("Only valid countries may be downloaded."));
   ASSERT(m_left != MapOptions::Nothing, ("Empty file set was requested for downloading."));
@@ -3,6 +3,9 @@
 #include "storage/index.hpp"
 #include "platform/country_defines.hpp"
 
+#include "std/cstdint.hpp"
+#include "std/utility.hpp"
+
 namespace storage
 {
 /// Country queued for downloading.
@@ -20,6 +23,15 @@ public:
   inline MapOptions GetCurrentFile() const { return m_current; }
   inline MapOptions GetDownloadedFiles() const { return UnsetOptions(m_init, m_left); }
 
+  /// The map file is downloaded as a diff to the older local map at most once.
+  inline bool IsDiffTried() const { return m_diffTried; }
+  inline void SetDiffTried() { m_diffTried = true; }
+
+  /// <downloaded, total> bytes of all the files of the country, the snapshot is updated on
+  /// every downloaded chunk, so it's read without asking the downloader.
+  inline pair<int64_t, int64_t> const & GetProgress() const { return m_progress; }
+  inline void SetProgress(pair<int64_t, int64_t> const & progress) { m_progress = progress; }
+
   inline bool operator==(TIndex const & index) const { return m_index == index; }
 
 private:
@@ -27,5 +39,7 @@ private:
   MapOptions m_init;
   MapOptions m_left;
   MapOptions m_current;
+  bool m_diffTried;
+  pair<int64_t, int64_t> m_progress;
 };
 }  // namespace storage
@@ -1,4 +1,5 @@
 #include "storage/storage.hpp"
+#include "storage/background_map_files_installer.hpp"
 #include "storage/http_map_files_downloader.hpp"
 
 #include "defines.hpp"
@@ -7,6 +8,7 @@
 #include "platform/platform.hpp"
 #include "platform/servers_list.hpp"
 
+#include "coding/container_diff.hpp"
 #include "coding/file_name_utils.hpp"
 #include "coding/internal/file_data.hpp"
 #include "coding/reader.hpp"
@@ -15,6 +17,7 @@
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
+#include "base/tracing.hpp"
 
 #include "std/algorithm.hpp"
 #include "std/bind.hpp"
@@ -31,6 +34,8 @@ namespace storage
 {
 namespace
 {
+// Progress of the downloading is reported at most ten times a second.
+double constexpr kProgressReportIntervalSec = 0.1;
 
 template <typename T>
 void RemoveIf(vector<T> & v, function<bool(T const & t)> const & p)
@@ -67,24 +72,52 @@ void DeleteCountryIndexes(LocalCountryFile const & localFile)
   platform::CountryIndexes::DeleteFromDisk(localFile);
 }
 
-class EqualFileName
+struct DownloadedFile
 {
-  string const & m_name;
+  string m_path;
+  string m_installPath;
+  uint64_t m_size;
+};
 
-public:
-  explicit EqualFileName(string const & name) : m_name(name) {}
-  bool operator()(SimpleTree<Country> const & node) const
+/// Verifies the sizes of the downloaded files and moves them to their places.
+/// It's run by the installer, so everything is passed by value.
+bool InstallDownloadedFiles(vector<DownloadedFile> const & files, LocalCountryFile const & localFile)
+{
+  bool ok = true;
+  for (DownloadedFile const & file : files)
   {
-    Country const & c = node.Value();
-    if (c.GetFilesCount() > 0)
-      return (c.GetFile().GetNameWithoutExt() == m_name);
-    else
-      return false;
+    uint64_t size = 0;
+    if (!my::GetFileSize(file.m_path, size) || size != file.m_size)
+    {
+      LOG(LWARNING, ("Downloaded file", file.m_path, "has size", size, "instead of", file.m_size));
+      ok = false;
+      break;
+    }
+    if (!my::RenameFileX(file.m_path, file.m_installPath))
+    {
+      ok = false;
+      break;
+    }
   }
-};
+
+  if (!ok)
+  {
+    for (DownloadedFile const & file : files)
+      my::DeleteFileX(file.m_installPath);
+    return false;
+  }
+
+  DeleteCountryIndexes(localFile);
+  return true;
+}
 }  // namespace
 
-Storage::Storage() : m_downloader(new HttpMapFilesDownloader()), m_currentSlotId(0)
+Storage::Storage()
+  : m_downloader(new HttpMapFilesDownloader())
+  , m_installer(new BackgroundMapFilesInstaller())
+  , m_currentSlotId(0)
+  , m_lastProgressReport(-kProgressReportIntervalSec)
+  , m_progressReportInterval(kProgressReportIntervalSec)
 {
   LoadCountriesFile(false /* forceReload */);
 }
@@ -95,6 +128,7 @@ void Storage::Clear()
 {
   m_downloader->Reset();
   m_queue.clear();
+  m_installingCountries.clear();
   m_failedCountries.clear();
   m_localFiles.clear();
   m_localFilesForFakeCountries.clear();
@@ -221,11 +255,8 @@ LocalAndRemoteSizeT Storage::CountrySizeInBytes(TIndex const & index, MapOptions
   }
 
   LocalAndRemoteSizeT sizes(0, GetRemoteSize(countryFile, opt));
-  if (!m_downloader->IsIdle() && IsCountryFirstInQueue(index))
-  {
-    sizes.first = m_downloader->GetDownloadingProgress().first +
-                  GetRemoteSize(countryFile, queuedCountry->GetDownloadedFiles());
-  }
+  if (IsCountryFirstInQueue(index))
+    sizes.first = queuedCountry->GetProgress().first;
   return sizes;
 }
 
@@ -269,6 +300,9 @@ Storage::TLocalFilePtr Storage::GetLatestLocalFile(TIndex const & index) const
 
 TStatus Storage::CountryStatus(TIndex const & index) const
 {
+  if (m_installingCountries.count(index) > 0)
+    return TStatus::EDownloading;
+
   // Check if we already downloading this country or have it in the queue
   if (IsCountryInQueue(index))
   {
@@ -308,6 +342,9 @@ void Storage::CountryStatusEx(TIndex const & index, TStatus & status, MapOptions
 void Storage::DownloadCountry(TIndex const & index, MapOptions opt)
 {
   opt = NormalizeDownloadFileSet(index, opt);
+  auto const installingIt = m_installingCountries.find(index);
+  if (installingIt != m_installingCountries.end())
+    opt = UnsetOptions(opt, installingIt->second);
   if (opt == MapOptions::Nothing)
     return;
 
@@ -331,6 +368,15 @@ void Storage::DeleteCountry(TIndex const & index, MapOptions opt)
   DeleteCountryFiles(index, opt);
   DeleteCountryFilesFromDownloader(index, opt);
 
+  // Files of the country which are being installed are deleted when they are installed.
+  auto const installingIt = m_installingCountries.find(index);
+  if (installingIt != m_installingCountries.end())
+  {
+    installingIt->second = UnsetOptions(installingIt->second, opt);
+    if (installingIt->second == MapOptions::Nothing)
+      m_installingCountries.erase(installingIt);
+  }
+
   TLocalFilePtr localFile = GetLatestLocalFile(index);
   if (localFile)
     m_update(*localFile);
@@ -415,9 +461,12 @@ bool Storage::DeleteFromDownloader(TIndex const & index)
   return true;
 }
 
-bool Storage::IsDownloadInProgress() const { return !m_queue.empty(); }
+bool Storage::IsDownloadInProgress() const
+{
+  return !m_queue.empty() || !m_installingCountries.empty();
+}
 
-TIndex Storage::GetCurrentDownloadingCountryIndex() const { return IsDownloadInProgress() ? m_queue.front().GetIndex() : storage::TIndex(); }
+TIndex Storage::GetCurrentDownloadingCountryIndex() const { return !m_queue.empty() ? m_queue.front().GetIndex() : storage::TIndex(); }
 
 void Storage::LoadCountriesFile(bool forceReload)
 {
@@ -428,9 +477,52 @@ void Storage::LoadCountriesFile(bool forceReload)
   {
     string json;
     ReaderPtr<Reader>(GetPlatform().GetReader(COUNTRIES_FILE)).ReadAsString(json);
-    m_currentVersion = LoadCountries(json, m_countries);
+
+    // The binary file is loaded much faster, but it's used only when it's built from this json.
+    m_currentVersion = -1;
+    try
+    {
+      m_currentVersion =
+          LoadCountriesBinary(GetPlatform().GetReader(COUNTRIES_BINARY_FILE), json, m_countries);
+    }
+    catch (RootException const & e)
+    {
+      LOG(LDEBUG, ("Can't open binary countries file", e.Msg()));
+    }
+
+    if (m_currentVersion < 0)
+      m_currentVersion = LoadCountries(json, m_countries);
     if (m_currentVersion < 0)
       LOG(LERROR, ("Can't load countries file", COUNTRIES_FILE));
+
+    BuildFileIndex();
+  }
+}
+
+void Storage::BuildFileIndex()
+{
+  m_fileIndex.clear();
+  auto const add = [this](SimpleTree<Country> const & node, TIndex const & index)
+  {
+    Country const & country = node.Value();
+    if (country.GetFilesCount() > 0)
+      m_fileIndex[country.GetFile().GetNameWithoutExt()].push_back(index);
+  };
+
+  for (size_t i = 0; i < m_countries.SiblingsCount(); ++i)
+  {
+    add(m_countries[i], TIndex(static_cast<int>(i)));
+
+    for (size_t j = 0; j < m_countries[i].SiblingsCount(); ++j)
+    {
+      add(m_countries[i][j], TIndex(static_cast<int>(i), static_cast<int>(j)));
+
+      for (size_t k = 0; k < m_countries[i][j].SiblingsCount(); ++k)
+      {
+        add(m_countries[i][j][k],
+            TIndex(static_cast<int>(i), static_cast<int>(j), static_cast<int>(k)));
+      }
+    }
   }
 }
 
@@ -462,6 +554,7 @@ void Storage::Unsubscribe(int slotId)
 void Storage::OnMapFileDownloadFinished(bool success,
                                         MapFilesDownloader::TProgress const & progress)
 {
+  TRACE_SCOPE("storage", "Storage::OnMapFileDownloadFinished");
   if (m_queue.empty())
     return;
 
@@ -474,11 +567,12 @@ void Storage::OnMapFileDownloadFinished(bool success,
     return;
   }
 
-  OnMapDownloadFinished(index, success, queuedCountry.GetInitOptions());
+  // The country is installed while the next one is downloaded.
+  MapOptions const files = queuedCountry.GetInitOptions();
   m_queue.pop_front();
-
-  NotifyStatusChanged(index);
   m_downloader->Reset();
+
+  OnMapDownloadFinished(index, success, files);
   DownloadNextCountryFromQueue();
 }
 
@@ -494,10 +588,27 @@ void Storage::OnServerListDownloaded(vector<string> const & urls)
   if (m_queue.empty())
     return;
 
-  QueuedCountry const & queuedCountry = m_queue.front();
+  QueuedCountry & queuedCountry = m_queue.front();
   TIndex const & index = queuedCountry.GetIndex();
   MapOptions const file = queuedCountry.GetCurrentFile();
 
+  if (file == MapOptions::Map && !queuedCountry.IsDiffTried())
+  {
+    queuedCountry.SetDiffTried();
+    TLocalFilePtr const oldMap = GetLocalMapForDiff(index);
+    if (oldMap)
+    {
+      vector<string> diffUrls;
+      diffUrls.reserve(urls.size());
+      for (string const & url : urls)
+        diffUrls.push_back(GetDiffDownloadUrl(url, index, oldMap->GetVersion()));
+
+      m_downloader->DownloadDiffFile(diffUrls, GetDiffDownloadPath(index),
+                                     bind(&Storage::OnDiffFileDownloaded, this, urls, _1));
+      return;
+    }
+  }
+
   vector<string> fileUrls;
   fileUrls.reserve(urls.size());
   for (string const & url : urls)
@@ -509,61 +620,84 @@ void Storage::OnServerListDownloaded(vector<string> const & urls)
                                 bind(&Storage::OnMapFileDownloadProgress, this, _1));
 }
 
-void Storage::OnMapFileDownloadProgress(MapFilesDownloader::TProgress const & progress)
+void Storage::OnDiffFileDownloaded(vector<string> const & urls, bool success)
 {
   // Queue can be empty because countries were deleted from queue.
   if (m_queue.empty())
     return;
 
-  if (!m_observers.empty())
+  TIndex const index = m_queue.front().GetIndex();
+  string const diffPath = GetDiffDownloadPath(index);
+  TLocalFilePtr const oldMap = GetLocalMapForDiff(index);
+  if (!success || !oldMap)
   {
-    QueuedCountry & queuedCountry = m_queue.front();
-    CountryFile const & countryFile = GetCountryFile(queuedCountry.GetIndex());
-    MapFilesDownloader::TProgress p = progress;
-    p.first += GetRemoteSize(countryFile, queuedCountry.GetDownloadedFiles());
-    p.second = GetRemoteSize(countryFile, queuedCountry.GetInitOptions());
-
-    ReportProgress(m_queue.front().GetIndex(), p);
+    my::DeleteFileX(diffPath);
+    OnDiffApplied(index, urls, false /* success */);
+    return;
   }
+
+  // The queue waits for the diff, but the main thread doesn't.
+  string const oldPath = oldMap->GetPath(MapOptions::Map);
+  string const newPath = GetFileDownloadPath(index, MapOptions::Map);
+  m_installer->Install([oldPath, diffPath, newPath]()
+                       {
+                         MY_SCOPE_GUARD(deleteDiff, bind(&my::DeleteFileX, cref(diffPath)));
+                         return diff::ApplyContainerDiff(oldPath, diffPath, newPath);
+                       },
+                       bind(&Storage::OnDiffApplied, this, index, urls, _1));
 }
 
-bool Storage::RegisterDownloadedFiles(TIndex const & index, MapOptions files)
+void Storage::OnDiffApplied(TIndex const & index, vector<string> const & urls, bool success)
 {
-  CountryFile const countryFile = GetCountryFile(index);
-  TLocalFilePtr localFile = GetLocalFile(index, GetCurrentDataVersion());
-  if (!localFile)
-    localFile = PreparePlaceForCountryFiles(countryFile, GetCurrentDataVersion());
-  if (!localFile)
+  // The country can be deleted from the queue while the diff is applied.
+  if (m_queue.empty() || m_queue.front().GetIndex() != index ||
+      m_queue.front().GetCurrentFile() != MapOptions::Map)
   {
-    LOG(LERROR, ("Local file data structure can't be prepared for downloaded file(", countryFile,
-                 files, ")."));
-    return false;
+    if (success)
+      my::DeleteFileX(GetFileDownloadPath(index, MapOptions::Map));
+    return;
   }
 
-  bool ok = true;
-  for (MapOptions file : {MapOptions::Map, MapOptions::CarRouting})
+  if (success)
   {
-    if (!HasOptions(files, file))
-      continue;
-    string const path = GetFileDownloadPath(index, file);
-    if (!my::RenameFileX(path, localFile->GetPath(file)))
-    {
-      ok = false;
-      break;
-    }
-  }
-  localFile->SyncWithDisk();
-  if (!ok)
-  {
-    localFile->DeleteFromDisk(files);
-    return false;
+    int64_t const size = GetDownloadSize(m_queue.front());
+    OnMapFileDownloadFinished(true, MapFilesDownloader::TProgress(size, size));
+    return;
   }
-  RegisterCountryFiles(localFile);
-  return true;
+
+  LOG(LINFO, ("Diff for", GetCountryFile(index), "isn't applied, the map is downloaded in full."));
+  m_downloader->Reset();
+  OnServerListDownloaded(urls);
+}
+
+void Storage::OnMapFileDownloadProgress(MapFilesDownloader::TProgress const & progress)
+{
+  // Queue can be empty because countries were deleted from queue.
+  if (m_queue.empty())
+    return;
+
+  QueuedCountry & queuedCountry = m_queue.front();
+  CountryFile const & countryFile = GetCountryFile(queuedCountry.GetIndex());
+  MapFilesDownloader::TProgress p = progress;
+  p.first += GetRemoteSize(countryFile, queuedCountry.GetDownloadedFiles());
+  p.second = GetRemoteSize(countryFile, queuedCountry.GetInitOptions());
+  queuedCountry.SetProgress(p);
+
+  if (m_observers.empty())
+    return;
+
+  // The last chunk of a file is always reported.
+  double const now = m_progressTimer.ElapsedSeconds();
+  if (progress.first != progress.second && now - m_lastProgressReport < m_progressReportInterval)
+    return;
+  m_lastProgressReport = now;
+
+  ReportProgress(queuedCountry.GetIndex(), p);
 }
 
 void Storage::OnMapDownloadFinished(TIndex const & index, bool success, MapOptions files)
 {
+  TRACE_SCOPE("storage", "Storage::OnMapDownloadFinished");
   ASSERT_NOT_EQUAL(MapOptions::Nothing, files,
                    ("This method should not be called for empty files set."));
   {
@@ -574,18 +708,80 @@ void Storage::OnMapDownloadFinished(TIndex const & index, bool success, MapOptio
                                  {"option", DebugPrint(files)}}));
   }
 
-  success = success && RegisterDownloadedFiles(index, files);
+  CountryFile const countryFile = GetCountryFile(index);
+  TLocalFilePtr localFile;
+  if (success)
+  {
+    localFile = GetLocalFile(index, GetCurrentDataVersion());
+    if (!localFile)
+      localFile = PreparePlaceForCountryFiles(countryFile, GetCurrentDataVersion());
+    if (!localFile)
+    {
+      LOG(LERROR, ("Local file data structure can't be prepared for downloaded file(", countryFile,
+                   files, ")."));
+    }
+  }
+
+  if (!localFile)
+  {
+    m_failedCountries.insert(index);
+    NotifyStatusChanged(index);
+    return;
+  }
+
+  vector<DownloadedFile> downloaded;
+  for (MapOptions file : {MapOptions::Map, MapOptions::CarRouting})
+  {
+    if (HasOptions(files, file))
+    {
+      downloaded.push_back({GetFileDownloadPath(index, file), localFile->GetPath(file),
+                            countryFile.GetRemoteSize(file)});
+    }
+  }
+
+  MapOptions & installing = m_installingCountries[index];
+  installing = SetOptions(installing, files);
+  m_installer->Install(bind(&InstallDownloadedFiles, downloaded, LocalCountryFile(*localFile)),
+                       bind(&Storage::OnMapFilesInstalled, this, index, localFile, files, _1));
+}
+
+void Storage::OnMapFilesInstalled(TIndex const & index, TLocalFilePtr localFile, MapOptions files,
+                                  bool success)
+{
+  // The files which are deleted while they are installed aren't in m_installingCountries.
+  MapOptions deleted = files;
+  auto const it = m_installingCountries.find(index);
+  if (it != m_installingCountries.end())
+  {
+    deleted = UnsetOptions(files, it->second);
+    it->second = UnsetOptions(it->second, files);
+    if (it->second == MapOptions::Nothing)
+      m_installingCountries.erase(it);
+  }
 
   if (!success)
   {
     m_failedCountries.insert(index);
+    NotifyStatusChanged(index);
     return;
   }
 
-  TLocalFilePtr localFile = GetLocalFile(index, GetCurrentDataVersion());
-  ASSERT(localFile, ());
-  DeleteCountryIndexes(*localFile);
+  if (deleted != MapOptions::Nothing)
+  {
+    localFile->SyncWithDisk();
+    localFile->DeleteFromDisk(deleted);
+    localFile->SyncWithDisk();
+  }
+  if (deleted == files)
+    return;
+
+  // Files of the version can be registered while these ones are installed.
+  TLocalFilePtr const registered = GetLocalFile(index, localFile->GetVersion());
+  if (registered)
+    localFile = registered;
+  RegisterCountryFiles(localFile);
   m_update(*localFile);
+  NotifyStatusChanged(index);
 }
 
 string Storage::GetFileDownloadUrl(string const & baseUrl, TIndex const & index,
@@ -603,53 +799,14 @@ string Storage::GetFileDownloadUrl(string const & baseUrl, string const & fName)
 
 TIndex Storage::FindIndexByFile(string const & name) const
 {
-  EqualFileName fn(name);
-
-  for (size_t i = 0; i < m_countries.SiblingsCount(); ++i)
-  {
-    if (fn(m_countries[i]))
-      return TIndex(static_cast<int>(i));
-
-    for (size_t j = 0; j < m_countries[i].SiblingsCount(); ++j)
-    {
-      if (fn(m_countries[i][j]))
-        return TIndex(static_cast<int>(i), static_cast<int>(j));
-
-      for (size_t k = 0; k < m_countries[i][j].SiblingsCount(); ++k)
-      {
-        if (fn(m_countries[i][j][k]))
-          return TIndex(static_cast<int>(i), static_cast<int>(j), static_cast<int>(k));
-      }
-    }
-  }
-
-  return TIndex();
+  auto const it = m_fileIndex.find(name);
+  return it == m_fileIndex.end() ? TIndex() : it->second.front();
 }
 
 vector<TIndex> Storage::FindAllIndexesByFile(string const & name) const
 {
-  EqualFileName fn(name);
-  vector<TIndex> res;
-
-  for (size_t i = 0; i < m_countries.SiblingsCount(); ++i)
-  {
-    if (fn(m_countries[i]))
-      res.emplace_back(static_cast<int>(i));
-
-    for (size_t j = 0; j < m_countries[i].SiblingsCount(); ++j)
-    {
-      if (fn(m_countries[i][j]))
-        res.emplace_back(static_cast<int>(i), static_cast<int>(j));
-
-      for (size_t k = 0; k < m_countries[i][j].SiblingsCount(); ++k)
-      {
-        if (fn(m_countries[i][j][k]))
-          res.emplace_back(static_cast<int>(i), static_cast<int>(j), static_cast<int>(k));
-      }
-    }
-  }
-
-  return res;
+  auto const it = m_fileIndex.find(name);
+  return it == m_fileIndex.end() ? vector<TIndex>() : it->second;
 }
 
 void Storage::GetOutdatedCountries(vector<Country const *> & countries) const
@@ -669,6 +826,9 @@ void Storage::GetOutdatedCountries(vector<Country const *> & countries) const
 
 TStatus Storage::CountryStatusWithoutFailed(TIndex const & index) const
 {
+  if (m_installingCountries.count(index) > 0)
+    return TStatus::EDownloading;
+
   // First, check if we already downloading this country or have in in the queue.
   if (!IsCountryInQueue(index))
     return CountryStatusFull(index, TStatus::EUnknown);
@@ -747,6 +907,16 @@ void Storage::SetDownloaderForTesting(unique_ptr<MapFilesDownloader> && download
   m_downloader = move(downloader);
 }
 
+void Storage::SetInstallerForTesting(unique_ptr<MapFilesInstaller> && installer)
+{
+  m_installer = move(installer);
+}
+
+void Storage::SetProgressReportIntervalForTesting(double seconds)
+{
+  m_progressReportInterval = seconds;
+}
+
 Storage::TLocalFilePtr Storage::GetLocalFile(TIndex const & index, int64_t version) const
 {
   auto const it = m_localFiles.find(index);
@@ -862,4 +1032,30 @@ string Storage::GetFileDownloadPath(TIndex const & index, MapOptions file) const
   CountryFile const & countryFile = GetCountryFile(index);
   return platform.WritablePathForFile(countryFile.GetNameWithExt(file) + READY_FILE_EXTENSION);
 }
+
+Storage::TLocalFilePtr Storage::GetLocalMapForDiff(TIndex const & index) const
+{
+  TLocalFilePtr const localFile = GetLatestLocalFile(index);
+  if (!localFile || !localFile->OnDisk(MapOptions::Map) ||
+      localFile->GetVersion() >= GetCurrentDataVersion())
+  {
+    return TLocalFilePtr();
+  }
+  return localFile;
+}
+
+string Storage::GetDiffDownloadUrl(string const & baseUrl, TIndex const & index,
+                                   int64_t fromVersion) const
+{
+  CountryFile const & countryFile = GetCountryFile(index);
+  return baseUrl + OMIM_OS_NAME "/" + strings::to_string(GetCurrentDataVersion()) + "/diffs/" +
+         strings::to_string(fromVersion) + "/" +
+         UrlEncode(countryFile.GetNameWithoutExt() + DIFF_FILE_EXTENSION);
+}
+
+string Storage::GetDiffDownloadPath(TIndex const & index) const
+{
+  CountryFile const & countryFile = GetCountryFile(index);
+  return GetPlatform().WritablePathForFile(countryFile.GetNameWithoutExt() + DIFF_FILE_EXTENSION);
+}
 }  // namespace storage
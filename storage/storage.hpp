@@ -3,15 +3,20 @@
 #include "storage/country.hpp"
 #include "storage/index.hpp"
 #include "storage/map_files_downloader.hpp"
+#include "storage/map_files_installer.hpp"
 #include "storage/queued_country.hpp"
 #include "storage/storage_defines.hpp"
 
+#include "base/timer.hpp"
+
 #include "std/function.hpp"
 #include "std/list.hpp"
+#include "std/map.hpp"
 #include "std/set.hpp"
 #include "std/shared_ptr.hpp"
 #include "std/string.hpp"
 #include "std/unique_ptr.hpp"
+#include "std/unordered_map.hpp"
 #include "std/vector.hpp"
 
 
@@ -27,11 +32,21 @@ private:
   /// We support only one simultaneous request at the moment
   unique_ptr<MapFilesDownloader> m_downloader;
 
+  /// Installs the downloaded files while the next countries are downloaded.
+  unique_ptr<MapFilesInstaller> m_installer;
+
+  /// Downloaded files of the countries which are being installed. For GUI the
+  /// countries are still downloading.
+  map<TIndex, MapOptions> m_installingCountries;
+
   /// stores timestamp for update checks
   int64_t m_currentVersion;
 
   CountriesContainerT m_countries;
 
+  /// Indexes of the countries by their file names, in the order of the tree traversal.
+  unordered_map<string, vector<TIndex>> m_fileIndex;
+
   typedef list<QueuedCountry> TQueue;
 
   /// @todo. It appeared that our application uses m_queue from
@@ -71,6 +86,13 @@ private:
 
   typedef list<CountryObservers> ObserversContT;
   ObserversContT m_observers;
+
+  /// Chunks may be downloaded much faster than the observers redraw, so the progress
+  /// is reported at most once in m_progressReportInterval seconds, the skipped chunks
+  /// are coalesced into the next report.
+  my::Timer m_progressTimer;
+  double m_lastProgressReport;
+  double m_progressReportInterval;
   //@}
 
   // This function is called each time all files requested for a
@@ -80,6 +102,7 @@ private:
   void DownloadNextCountryFromQueue();
 
   void LoadCountriesFile(bool forceReload);
+  void BuildFileIndex();
 
   void ReportProgress(TIndex const & index, pair<int64_t, int64_t> const & p);
 
@@ -91,13 +114,27 @@ private:
   /// downloading of a map file succeeds/fails.
   void OnMapFileDownloadFinished(bool success, MapFilesDownloader::TProgress const & progress);
 
+  /// Called on the main thread by MapFilesDownloader when downloading of
+  /// a diff to the older local map succeeds/fails. The map is downloaded
+  /// from urls in full when the diff can't be applied.
+  void OnDiffFileDownloaded(vector<string> const & urls, bool success);
+
   /// Periodically called on the main thread by MapFilesDownloader
   /// during the downloading process.
   void OnMapFileDownloadProgress(MapFilesDownloader::TProgress const & progress);
 
-  bool RegisterDownloadedFiles(TIndex const & index, MapOptions files);
+  /// Starts installing of the downloaded files of the country.
   void OnMapDownloadFinished(TIndex const & index, bool success, MapOptions files);
 
+  /// Called on the main thread by MapFilesInstaller when the downloaded
+  /// files are moved to localFile.
+  void OnMapFilesInstalled(TIndex const & index, TLocalFilePtr localFile, MapOptions files,
+                           bool success);
+
+  /// Called on the main thread by MapFilesInstaller when the downloaded
+  /// diff is applied to the older local map or fails to.
+  void OnDiffApplied(TIndex const & index, vector<string> const & urls, bool success);
+
   /// Initiates downloading of the next file from the queue.
   void DownloadNextFile(QueuedCountry const & country);
 
@@ -179,6 +216,8 @@ public:
   inline int64_t GetCurrentDataVersion() const { return m_currentVersion; }
 
   void SetDownloaderForTesting(unique_ptr<MapFilesDownloader> && downloader);
+  void SetInstallerForTesting(unique_ptr<MapFilesInstaller> && installer);
+  void SetProgressReportIntervalForTesting(double seconds);
 
 private:
   friend void UnitTest_StorageTest_DeleteCountry();
@@ -238,5 +277,10 @@ private:
   // Returns a path to a place on disk downloader can use for
   // downloaded files.
   string GetFileDownloadPath(TIndex const & index, MapOptions file) const;
+
+  /// Returns the older local map the current one can be patched from, or nullptr.
+  TLocalFilePtr GetLocalMapForDiff(TIndex const & index) const;
+  string GetDiffDownloadUrl(string const & baseUrl, TIndex const & index, int64_t fromVersion) const;
+  string GetDiffDownloadPath(TIndex const & index) const;
 };
 }  // storage
@@ -11,6 +11,8 @@ include($$ROOT_DIR/common.pri)
 INCLUDEPATH += $$ROOT_DIR/3party/jansson/src
 
 HEADERS += \
+  background_map_files_installer.hpp \
+  countries_grid.hpp \
   country.hpp \
   country_decl.hpp \
   country_info.hpp \
@@ -18,12 +20,15 @@ HEADERS += \
   http_map_files_downloader.hpp \
   index.hpp \
   map_files_downloader.hpp \
+  map_files_installer.hpp \
   queued_country.hpp \
   simple_tree.hpp \
   storage.hpp \
   storage_defines.hpp \
 
 SOURCES += \
+  background_map_files_installer.cpp \
+  countries_grid.cpp \
   country.cpp \
   country_decl.cpp \
   country_info.cpp \
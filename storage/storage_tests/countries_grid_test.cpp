@@ -0,0 +1,90 @@
+#include "testing/testing.hpp"
+
+#include "storage/countries_grid.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+using namespace storage;
+
+namespace
+{
+m2::RegionD MakeStar(m2::PointD const & center, double r1, double r2, size_t count)
+{
+  vector<m2::PointD> points;
+  for (size_t i = 0; i < 2 * count; ++i)
+  {
+    double const angle = math::pi * i / count;
+    double const r = i % 2 == 0 ? r1 : r2;
+    points.emplace_back(center.x + r * cos(angle), center.y + r * sin(angle));
+  }
+  return m2::RegionD(points.begin(), points.end());
+}
+}  // namespace
+
+UNIT_TEST(CountriesGrid_SameAsRegions)
+{
+  // Overlapping stars and two regions of the same country.
+  vector<vector<m2::RegionD>> countries = {
+      {MakeStar(m2::PointD(0.0, 0.0), 40.0, 15.0, 7), MakeStar(m2::PointD(100.0, 50.0), 5.0, 2.0, 5)},
+      {MakeStar(m2::PointD(30.0, 10.0), 30.0, 20.0, 11)},
+      {MakeStar(m2::PointD(-120.0, -60.0), 50.0, 45.0, 100)}};
+
+  CountriesGrid builder;
+  for (size_t id = 0; id < countries.size(); ++id)
+  {
+    for (m2::RegionD const & region : countries[id])
+      builder.AddRegion(id, region);
+  }
+  builder.Finish();
+
+  vector<char> buffer;
+  MemWriter<vector<char>> writer(buffer);
+  builder.Serialize(writer);
+
+  CountriesGrid grid;
+  ReaderSource<MemReader> src(MemReader(buffer.data(), buffer.size()));
+  grid.Deserialize(src);
+
+  mt19937 rnd(0);
+  uniform_int_distribution<int> coord(-100000, 100000);
+  size_t insideCount = 0;
+  for (size_t i = 0; i < 100000; ++i)
+  {
+    m2::PointD const pt(coord(rnd) * 1.0E-5 * MercatorBounds::maxX,
+                        coord(rnd) * 1.0E-5 * MercatorBounds::maxY);
+
+    size_t expected = -1;
+    for (size_t id = 0; id < countries.size() && expected == static_cast<size_t>(-1); ++id)
+    {
+      for (m2::RegionD const & region : countries[id])
+      {
+        if (region.Contains(pt))
+          expected = id;
+      }
+    }
+
+    size_t found = -1;
+    grid.ForEachCountry(pt, [&](size_t id, bool isCellInside)
+    {
+      if (isCellInside)
+        ++insideCount;
+      for (m2::RegionD const & region : countries[id])
+      {
+        if (isCellInside || region.Contains(pt))
+        {
+          found = id;
+          return false;
+        }
+      }
+      return true;
+    });
+    TEST_EQUAL(found, expected, (pt));
+  }
+  TEST_GREATER(insideCount, 0, ());
+}
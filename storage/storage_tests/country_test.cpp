@@ -0,0 +1,90 @@
+#include "testing/testing.hpp"
+
+#include "storage/country.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "defines.hpp"
+
+#include "std/vector.hpp"
+
+using namespace storage;
+
+namespace
+{
+void TestEqualTrees(CountriesContainerT const & lhs, CountriesContainerT const & rhs)
+{
+  TEST_EQUAL(lhs.SiblingsCount(), rhs.SiblingsCount(), ());
+  for (size_t i = 0; i < lhs.SiblingsCount(); ++i)
+  {
+    Country const & l = lhs[i].Value();
+    Country const & r = rhs[i].Value();
+    TEST_EQUAL(l.Name(), r.Name(), ());
+    TEST_EQUAL(l.Flag(), r.Flag(), ());
+    TEST_EQUAL(l.GetFilesCount(), r.GetFilesCount(), (l.Name()));
+    if (l.GetFilesCount() > 0)
+    {
+      TEST_EQUAL(l.GetFile().GetNameWithoutExt(), r.GetFile().GetNameWithoutExt(), ());
+      TEST_EQUAL(l.Size(MapOptions::MapWithCarRouting), r.Size(MapOptions::MapWithCarRouting),
+                 (l.Name()));
+    }
+    TestEqualTrees(lhs[i], rhs[i]);
+  }
+}
+}  // namespace
+
+UNIT_TEST(CountriesBinary_Smoke)
+{
+  string json;
+  ReaderPtr<Reader>(GetPlatform().GetReader(COUNTRIES_FILE)).ReadAsString(json);
+  CountriesContainerT fromJson;
+  int64_t const version = LoadCountries(json, fromJson);
+  TEST_GREATER(version, 0, ());
+
+  vector<char> buffer;
+  {
+    MemWriter<vector<char>> writer(buffer);
+    SaveCountriesBinary(version, json, fromJson, writer);
+  }
+
+  CountriesContainerT fromBinary;
+  ReaderPtr<Reader> const reader(new MemReader(buffer.data(), buffer.size()));
+  TEST_EQUAL(LoadCountriesBinary(reader, json, fromBinary), version, ());
+  TestEqualTrees(fromJson, fromBinary);
+
+  // The file which is built from another json isn't loaded.
+  TEST_EQUAL(LoadCountriesBinary(reader, json + ' ', fromBinary), -1, ());
+  TEST_EQUAL(fromBinary.SiblingsCount(), 0, ());
+
+  // Even if the json keeps its size, as on the version bump.
+  string const versionTag = "\"v\":";
+  size_t const versionPos = json.find(versionTag);
+  TEST_NOT_EQUAL(versionPos, string::npos, ());
+  string bumped = json;
+  char & digit = bumped[versionPos + versionTag.size()];
+  digit = digit == '9' ? '8' : digit + 1;
+  TEST_EQUAL(LoadCountriesBinary(reader, bumped, fromBinary), -1, ());
+  TEST_EQUAL(fromBinary.SiblingsCount(), 0, ());
+
+  // And the broken one.
+  ReaderPtr<Reader> const truncated(new MemReader(buffer.data(), buffer.size() / 2));
+  TEST_EQUAL(LoadCountriesBinary(truncated, json, fromBinary), -1, ());
+  TEST_EQUAL(fromBinary.SiblingsCount(), 0, ());
+}
+
+UNIT_TEST(CountriesBinary_ShippedFileIsActual)
+{
+  // Storage falls back to the slow json parsing when the shipped binary file is outdated.
+  string json;
+  ReaderPtr<Reader>(GetPlatform().GetReader(COUNTRIES_FILE)).ReadAsString(json);
+  CountriesContainerT fromJson;
+  int64_t const version = LoadCountries(json, fromJson);
+
+  CountriesContainerT fromBinary;
+  TEST_EQUAL(LoadCountriesBinary(GetPlatform().GetReader(COUNTRIES_BINARY_FILE), json, fromBinary),
+             version, ("Rebuild", COUNTRIES_BINARY_FILE, "with -generate_countries_binary"));
+  TestEqualTrees(fromJson, fromBinary);
+}
@@ -0,0 +1,22 @@
+#include "storage/storage_tests/fake_map_files_installer.hpp"
+
+#include "storage/storage_tests/task_runner.hpp"
+
+#include "base/assert.hpp"
+
+namespace storage
+{
+FakeMapFilesInstaller::FakeMapFilesInstaller(TaskRunner & taskRunner) : m_taskRunner(taskRunner) {}
+
+FakeMapFilesInstaller::~FakeMapFilesInstaller() { CHECK(m_checker.CalledOnOriginalThread(), ()); }
+
+void FakeMapFilesInstaller::Install(TInstallFn const & install,
+                                    TInstalledCallback const & onInstalled)
+{
+  CHECK(m_checker.CalledOnOriginalThread(), ());
+  m_taskRunner.PostTask([install, onInstalled]()
+  {
+    onInstalled(install());
+  });
+}
+}  // namespace storage
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "storage/map_files_installer.hpp"
+
+#include "base/thread_checker.hpp"
+
+namespace storage
+{
+class TaskRunner;
+
+// This class can be used in tests to mimic a real installer. It
+// installs the files on the task runner, so the tests decide when
+// the downloaded countries are installed.
+//
+// *NOTE*, this class is not thread-safe.
+class FakeMapFilesInstaller : public MapFilesInstaller
+{
+public:
+  FakeMapFilesInstaller(TaskRunner & taskRunner);
+  virtual ~FakeMapFilesInstaller();
+
+  // MapFilesInstaller overrides:
+  void Install(TInstallFn const & install, TInstalledCallback const & onInstalled) override;
+
+private:
+  TaskRunner & m_taskRunner;
+  ThreadChecker m_checker;
+};
+}  // namespace storage
@@ -3,6 +3,7 @@
 #include "storage/storage.hpp"
 #include "storage/storage_defines.hpp"
 #include "storage/storage_tests/fake_map_files_downloader.hpp"
+#include "storage/storage_tests/fake_map_files_installer.hpp"
 #include "storage/storage_tests/task_runner.hpp"
 
 #include "indexer/indexer_tests/test_mwm_set.hpp"
@@ -265,6 +266,9 @@ void InitStorage(Storage & storage, TaskRunner & runner,
   storage.Init(update);
   storage.RegisterAllLocalMaps();
   storage.SetDownloaderForTesting(make_unique<FakeMapFilesDownloader>(runner));
+  storage.SetInstallerForTesting(make_unique<FakeMapFilesInstaller>(runner));
+  // Every chunk is reported, so the checkers see the whole progress.
+  storage.SetProgressReportIntervalForTesting(0.0);
 }
 }  // namespace
 
@@ -345,6 +349,87 @@ UNIT_TEST(StorageTest_TwoCountriesDownloading)
   runner.Run();
 }
 
+UNIT_TEST(StorageTest_CountryIsInstalledAfterDownloading)
+{
+  Storage storage;
+  TaskRunner runner;
+  InitStorage(storage, runner);
+  TaskRunner installRunner;
+  storage.SetInstallerForTesting(make_unique<FakeMapFilesInstaller>(installRunner));
+
+  TIndex const index = storage.FindIndexByFile("Azerbaijan");
+  TEST(index.IsValid(), ());
+  storage.DeleteCountry(index, MapOptions::MapWithCarRouting);
+  MY_SCOPE_GUARD(cleanupCountryFiles, bind(&Storage::DeleteCountry, &storage, index,
+                                           MapOptions::MapWithCarRouting));
+
+  storage.DownloadCountry(index, MapOptions::Map);
+  runner.Run();
+
+  // The country is downloading for GUI until it's installed.
+  TEST_EQUAL(TStatus::EDownloading, storage.CountryStatusEx(index), ());
+  TEST(storage.IsDownloadInProgress(), ());
+  TEST(!storage.GetLatestLocalFile(index), ());
+
+  installRunner.Run();
+  TEST_EQUAL(TStatus::EOnDisk, storage.CountryStatusEx(index), ());
+  TEST(!storage.IsDownloadInProgress(), ());
+  TLocalFilePtr localFile = storage.GetLatestLocalFile(index);
+  TEST(localFile, ());
+  TEST_EQUAL(MapOptions::Map, localFile->GetFiles(), ());
+
+  // Files of the country which is deleted while it's installed are deleted too.
+  storage.DeleteCountry(index, MapOptions::Map);
+  storage.DownloadCountry(index, MapOptions::Map);
+  runner.Run();
+  storage.DeleteCountry(index, MapOptions::Map);
+  TEST_EQUAL(TStatus::ENotDownloaded, storage.CountryStatusEx(index), ());
+
+  installRunner.Run();
+  TEST_EQUAL(TStatus::ENotDownloaded, storage.CountryStatusEx(index), ());
+  TEST(!storage.GetLatestLocalFile(index), ());
+  localFile->SyncWithDisk();
+  TEST_EQUAL(MapOptions::Nothing, localFile->GetFiles(), ());
+}
+
+UNIT_TEST(StorageTest_ProgressReportsAreCoalesced)
+{
+  Storage storage;
+  TaskRunner runner;
+  InitStorage(storage, runner);
+  storage.SetProgressReportIntervalForTesting(1000.0);
+
+  TIndex const index = storage.FindIndexByFile("Azerbaijan");
+  TEST(index.IsValid(), ());
+  storage.DeleteCountry(index, MapOptions::MapWithCarRouting);
+  MY_SCOPE_GUARD(cleanupCountryFiles, bind(&Storage::DeleteCountry, &storage, index,
+                                           MapOptions::MapWithCarRouting));
+
+  vector<LocalAndRemoteSizeT> reports;
+  auto const onProgress = [&](TIndex const & i, LocalAndRemoteSizeT const & progress)
+  {
+    TEST_EQUAL(i, index, ());
+    // The snapshot is read without asking the downloader.
+    TEST_EQUAL(storage.CountrySizeInBytes(i, MapOptions::MapWithCarRouting), progress, ());
+    reports.push_back(progress);
+  };
+  int const slot = storage.Subscribe([](TIndex const &) {}, onProgress);
+  MY_SCOPE_GUARD(unsubscribe, bind(&Storage::Unsubscribe, &storage, slot));
+
+  storage.DownloadCountry(index, MapOptions::MapWithCarRouting);
+  runner.Run();
+
+  // Only the last chunks of the files are reported.
+  CountryFile const & countryFile = storage.GetCountryFile(index);
+  int64_t const mapSize = countryFile.GetRemoteSize(MapOptions::Map);
+  int64_t const totalSize = mapSize + countryFile.GetRemoteSize(MapOptions::CarRouting);
+  TEST_GREATER(mapSize, FakeMapFilesDownloader::kBlockSize, ());
+  TEST_EQUAL(reports, vector<LocalAndRemoteSizeT>({LocalAndRemoteSizeT(mapSize, totalSize),
+                                                   LocalAndRemoteSizeT(totalSize, totalSize)}),
+             ());
+  TEST_EQUAL(TStatus::EOnDisk, storage.CountryStatusEx(index), ());
+}
+
 UNIT_TEST(StorageTest_DeleteTwoVersionsOfTheSameCountry)
 {
   Storage storage;
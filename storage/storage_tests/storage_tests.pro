@@ -17,12 +17,16 @@ QT *= core
 
 HEADERS += \
   fake_map_files_downloader.hpp \
+  fake_map_files_installer.hpp \
   task_runner.hpp \
 
 SOURCES += \
   ../../testing/testingmain.cpp \
+  countries_grid_test.cpp \
   country_info_test.cpp \
+  country_test.cpp \
   fake_map_files_downloader.cpp \
+  fake_map_files_installer.cpp \
   queued_country_tests.cpp \
   simple_tree_test.cpp \
   storage_tests.cpp \
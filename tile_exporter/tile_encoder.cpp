@@ -0,0 +1,241 @@
+#include "tile_exporter/tile_encoder.hpp"
+
+#include "indexer/classificator.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/feature_data.hpp"
+#include "indexer/feature_visibility.hpp"
+#include "indexer/mercator.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/multilang_utf8_string.hpp"
+#include "coding/varint.hpp"
+
+#include "base/assert.hpp"
+#include "base/math.hpp"
+#include "base/stl_add.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/sstream.hpp"
+
+namespace tile_exporter
+{
+namespace
+{
+template <typename TSink>
+void WriteString(TSink & sink, string const & s)
+{
+  WriteVarUint(sink, static_cast<uint32_t>(s.size()));
+  sink.Write(s.data(), s.size());
+}
+}  // namespace
+
+m2::RectD TileKey::GetRect() const
+{
+  double const size = (MercatorBounds::maxX - MercatorBounds::minX) / (1 << m_zoom);
+  double const minX = MercatorBounds::minX + m_x * size;
+  double const minY = MercatorBounds::minY + m_y * size;
+  return m2::RectD(minX, minY, minX + size, minY + size);
+}
+
+string DebugPrint(TileKey const & key)
+{
+  ostringstream out;
+  out << "TileKey [ " << key.m_zoom << "/" << key.m_x << "/" << key.m_y << " ]";
+  return out.str();
+}
+
+// static
+uint32_t const TileEncoder::kExtent;
+
+void TileEncoder::Stats::Add(Stats const & rhs)
+{
+  m_features += rhs.m_features;
+  m_geometries += rhs.m_geometries;
+  m_sharedGeometries += rhs.m_sharedGeometries;
+  m_points += rhs.m_points;
+}
+
+struct TileEncoder::TrianglesAdder
+{
+  explicit TrianglesAdder(TileEncoder & encoder) : m_encoder(encoder) {}
+
+  void operator()(m2::PointD const & p1, m2::PointD const & p2, m2::PointD const & p3)
+  {
+    m2::RectD r(p1, p2);
+    r.Add(p3);
+    if (!r.IsIntersect(m_encoder.m_rect))
+      return;
+
+    m2::PointI const a = m_encoder.Quantize(p1);
+    m2::PointI const b = m_encoder.Quantize(p2);
+    m2::PointI const c = m_encoder.Quantize(p3);
+    int64_t const cross = int64_t(b.x - a.x) * (c.y - a.y) - int64_t(b.y - a.y) * (c.x - a.x);
+    if (cross == 0)
+      return;
+    m_encoder.m_points.push_back(a);
+    m_encoder.m_points.push_back(b);
+    m_encoder.m_points.push_back(c);
+  }
+
+  TileEncoder & m_encoder;
+};
+
+TileEncoder::TileEncoder(TileKey const & key, int scale) : m_rect(key.GetRect()), m_scale(scale)
+{
+}
+
+void TileEncoder::AddFeature(FeatureType const & ft)
+{
+  feature::TypesHolder const types(ft);
+  pair<int, int> const range = feature::GetDrawableScaleRange(types);
+  if (range.first < 0 || m_scale < range.first || m_scale > range.second)
+    return;
+
+  m_points.clear();
+  EGeomKind kind;
+  switch (ft.GetFeatureType())
+  {
+  case feature::GEOM_POINT:
+  {
+    // Points at the borders go to one tile only.
+    m2::PointD const center = ft.GetCenter();
+    if (!m_rect.IsPointInside(center) || center.x == m_rect.maxX() || center.y == m_rect.maxY())
+      return;
+    m_points.push_back(Quantize(center));
+    kind = KIND_POINT;
+    break;
+  }
+  case feature::GEOM_LINE:
+  {
+    if (!ft.GetLimitRect(m_scale).IsIntersect(m_rect))
+      return;
+    vector<m2::PointD> points;
+    ft.ForEachPoint(MakeBackInsertFunctor(points), m_scale);
+    AddLinePoints(points);
+    if (m_points.size() < 2)
+      return;
+    kind = KIND_LINE;
+    break;
+  }
+  case feature::GEOM_AREA:
+  {
+    if (!ft.GetLimitRect(m_scale).IsIntersect(m_rect))
+      return;
+    TrianglesAdder adder(*this);
+    ft.ForEachTriangleRef(adder, m_scale);
+    if (m_points.empty())
+      return;
+    kind = KIND_AREA;
+    break;
+  }
+  default:
+    return;
+  }
+
+  Feature feature;
+  feature.m_geometry = AddGeometry(kind);
+
+  string name;
+  feature.m_name = ft.GetName(StringUtf8Multilang::DEFAULT_CODE, name) && !name.empty()
+                       ? AddName(name) + 1
+                       : 0;
+
+  Classificator const & c = classif();
+  for (uint32_t const type : types)
+    feature.m_types.push_back(c.GetIndexForType(type));
+
+  m_features.push_back(move(feature));
+  ++m_stats.m_features;
+}
+
+void TileEncoder::Encode(vector<uint8_t> & buffer) const
+{
+  buffer.clear();
+  PushBackByteSink<vector<uint8_t>> sink(buffer);
+
+  WriteVarUint(sink, static_cast<uint32_t>(m_geometries.size()));
+  for (string const & geometry : m_geometries)
+    sink.Write(geometry.data(), geometry.size());
+
+  WriteVarUint(sink, static_cast<uint32_t>(m_names.size()));
+  for (string const & name : m_names)
+    WriteString(sink, name);
+
+  WriteVarUint(sink, static_cast<uint32_t>(m_features.size()));
+  for (Feature const & feature : m_features)
+  {
+    WriteVarUint(sink, feature.m_geometry);
+    WriteVarUint(sink, feature.m_name);
+    WriteVarUint(sink, static_cast<uint32_t>(feature.m_types.size()));
+    for (uint32_t const type : feature.m_types)
+      WriteVarUint(sink, type);
+  }
+}
+
+void TileEncoder::AddLinePoints(vector<m2::PointD> const & points)
+{
+  // Segments out of the tile at the ends of the line are dropped.
+  size_t first = points.size();
+  size_t last = 0;
+  for (size_t i = 0; i + 1 < points.size(); ++i)
+  {
+    if (m2::RectD(points[i], points[i + 1]).IsIntersect(m_rect))
+    {
+      first = min(first, i);
+      last = i + 1;
+    }
+  }
+
+  for (size_t i = first; i <= last && i < points.size(); ++i)
+  {
+    m2::PointI const p = Quantize(points[i]);
+    // Points which fall to the same cell of the grid give nothing but the size.
+    if (m_points.empty() || m_points.back() != p)
+      m_points.push_back(p);
+  }
+}
+
+m2::PointI TileEncoder::Quantize(m2::PointD const & pt) const
+{
+  double const x = (pt.x - m_rect.minX()) / m_rect.SizeX() * kExtent;
+  double const y = (m_rect.maxY() - pt.y) / m_rect.SizeY() * kExtent;
+  return m2::PointI(my::rounds(x), my::rounds(y));
+}
+
+uint32_t TileEncoder::AddGeometry(EGeomKind kind)
+{
+  ASSERT(!m_points.empty(), ());
+
+  string geometry;
+  PushBackByteSink<string> sink(geometry);
+  WriteVarUint(sink, static_cast<uint32_t>(kind));
+  WriteVarUint(sink, static_cast<uint32_t>(m_points.size()));
+  m2::PointI prev(0, 0);
+  for (m2::PointI const & p : m_points)
+  {
+    WriteVarInt(sink, p.x - prev.x);
+    WriteVarInt(sink, p.y - prev.y);
+    prev = p;
+  }
+
+  auto const res = m_geometryIndices.emplace(geometry, static_cast<uint32_t>(m_geometries.size()));
+  if (!res.second)
+  {
+    ++m_stats.m_sharedGeometries;
+    return res.first->second;
+  }
+
+  m_geometries.push_back(move(geometry));
+  ++m_stats.m_geometries;
+  m_stats.m_points += m_points.size();
+  return res.first->second;
+}
+
+uint32_t TileEncoder::AddName(string const & name)
+{
+  auto const res = m_nameIndices.emplace(name, static_cast<uint32_t>(m_names.size()));
+  if (res.second)
+    m_names.push_back(name);
+  return res.first->second;
+}
+}  // namespace tile_exporter
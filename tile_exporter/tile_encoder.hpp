@@ -0,0 +1,122 @@
+#pragma once
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/unordered_map.hpp"
+#include "std/vector.hpp"
+
+class FeatureType;
+
+namespace tile_exporter
+{
+/// Tile of the Mercator square in the TMS scheme, y goes from the south to the north.
+struct TileKey
+{
+  TileKey() : m_zoom(0), m_x(0), m_y(0) {}
+  TileKey(uint32_t zoom, uint32_t x, uint32_t y) : m_zoom(zoom), m_x(x), m_y(y) {}
+
+  m2::RectD GetRect() const;
+
+  inline bool operator<(TileKey const & rhs) const
+  {
+    if (m_zoom != rhs.m_zoom)
+      return m_zoom < rhs.m_zoom;
+    if (m_y != rhs.m_y)
+      return m_y < rhs.m_y;
+    return m_x < rhs.m_x;
+  }
+
+  uint32_t m_zoom;
+  uint32_t m_x;
+  uint32_t m_y;
+};
+
+string DebugPrint(TileKey const & key);
+
+/// Encodes the features of a tile by their geometry at the scale of the tile. Points are
+/// quantized to the tile-local grid of kExtent x kExtent with the origin in the top left corner,
+/// so the geometry of the features near the border may go out of the grid.
+/// Geometries and names are stored once per tile, the features which share them refer
+/// to the same record.
+///
+/// Tile is a list of the varuints:
+///   geometries count, for each: kind, points count, zigzag deltas of the points coordinates;
+///   names count, for each: size and the utf8 bytes;
+///   features count, for each: geometry, name + 1 or 0, types count and classificator indices
+///   of the types.
+class TileEncoder
+{
+public:
+  static uint32_t const kExtent = 4096;
+
+  enum EGeomKind
+  {
+    KIND_POINT = 0,
+    KIND_LINE = 1,
+    /// Area is the list of the triangles, as it's stored in the mwm.
+    KIND_AREA = 2
+  };
+
+  struct Stats
+  {
+    Stats() : m_features(0), m_geometries(0), m_sharedGeometries(0), m_points(0) {}
+
+    void Add(Stats const & rhs);
+
+    uint64_t m_features;
+    uint64_t m_geometries;
+    /// Number of the features which refer to the geometry of another feature.
+    uint64_t m_sharedGeometries;
+    uint64_t m_points;
+  };
+
+  TileEncoder(TileKey const & key, int scale);
+
+  /// Adds the feature when it's drawable at the scale and its geometry doesn't degenerate
+  /// at the grid of the tile.
+  void AddFeature(FeatureType const & ft);
+
+  inline bool IsEmpty() const { return m_features.empty(); }
+  inline Stats const & GetStats() const { return m_stats; }
+
+  void Encode(vector<uint8_t> & buffer) const;
+
+private:
+  struct Feature
+  {
+    uint32_t m_geometry;
+    uint32_t m_name;
+    vector<uint32_t> m_types;
+  };
+
+  struct TrianglesAdder;
+
+  /// Adds the points of the line, which are in the tile, to m_points.
+  void AddLinePoints(vector<m2::PointD> const & points);
+  m2::PointI Quantize(m2::PointD const & pt) const;
+  /// Finishes the geometry of m_points.
+  /// @return Index of the geometry.
+  uint32_t AddGeometry(EGeomKind kind);
+  uint32_t AddName(string const & name);
+
+  m2::RectD const m_rect;
+  int const m_scale;
+
+  /// Quantized points of the geometry which is being added.
+  vector<m2::PointI> m_points;
+
+  /// Encoded geometries and names, each one is stored once.
+  //@{
+  vector<string> m_geometries;
+  unordered_map<string, uint32_t> m_geometryIndices;
+  vector<string> m_names;
+  unordered_map<string, uint32_t> m_nameIndices;
+  //@}
+
+  vector<Feature> m_features;
+  Stats m_stats;
+};
+}  // namespace tile_exporter
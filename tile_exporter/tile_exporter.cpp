@@ -0,0 +1,226 @@
+// Exports the features of the local maps to vector tiles for the server-side consumers.
+//
+// Tiles of each zoom of [--min_zoom, --max_zoom] which intersect the maps (and --rect, when
+// it's set) are encoded by TileEncoder in parallel, the geometry of the features is taken at
+// the scale of the zoom. Encoded tiles are streamed to the --output container by TilesWriter
+// in batches, and the throughput and the size of the tiles are reported per zoom.
+
+#include "tile_exporter/tile_encoder.hpp"
+#include "tile_exporter/tiles_writer.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/index.hpp"
+#include "indexer/mercator.hpp"
+#include "indexer/scales.hpp"
+
+#include "platform/local_country_file_utils.hpp"
+#include "platform/platform.hpp"
+
+#include "base/logging.hpp"
+#include "base/math.hpp"
+#include "base/stl_add.hpp"
+#include "base/string_utils.hpp"
+#include "base/task_scheduler.hpp"
+#include "base/timer.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/iomanip.hpp"
+#include "std/iostream.hpp"
+#include "std/set.hpp"
+#include "std/vector.hpp"
+
+#include "3party/gflags/src/gflags/gflags.h"
+
+DEFINE_string(output, "", "Path to the container of the tiles");
+DEFINE_int32(min_zoom, 0, "First zoom of the tiles");
+DEFINE_int32(max_zoom, 10, "Last zoom of the tiles");
+DEFINE_string(rect, "", "Exported area \"minLat,minLon,maxLat,maxLon\", all the maps if empty");
+DEFINE_int32(threads, 0, "Number of the encoding threads, zero means the number of cores");
+DEFINE_int32(batch, 1024, "Number of the tiles which are encoded before they are written");
+
+namespace
+{
+using tile_exporter::TileEncoder;
+using tile_exporter::TileKey;
+using tile_exporter::TilesWriter;
+
+bool ParseRect(string const & s, m2::RectD & rect)
+{
+  vector<string> parts;
+  strings::Tokenize(s, ",", MakeBackInsertFunctor(parts));
+  double coords[4];
+  if (parts.size() != 4)
+    return false;
+  for (size_t i = 0; i < parts.size(); ++i)
+  {
+    if (!strings::to_double(parts[i], coords[i]))
+      return false;
+  }
+  rect = m2::RectD(MercatorBounds::FromLatLon(coords[0], coords[1]),
+                   MercatorBounds::FromLatLon(coords[2], coords[3]));
+  return true;
+}
+
+/// Adds the tiles of zoom which intersect rect.
+void AddTiles(m2::RectD const & rect, uint32_t zoom, set<TileKey> & tiles)
+{
+  uint32_t const count = 1 << zoom;
+  double const size = (MercatorBounds::maxX - MercatorBounds::minX) / count;
+  auto const toTile = [count, size](double v, double min) -> uint32_t
+  {
+    double const i = floor((v - min) / size);
+    return static_cast<uint32_t>(my::clamp(i, 0.0, static_cast<double>(count - 1)));
+  };
+
+  uint32_t const minX = toTile(rect.minX(), MercatorBounds::minX);
+  uint32_t const maxX = toTile(rect.maxX(), MercatorBounds::minX);
+  uint32_t const minY = toTile(rect.minY(), MercatorBounds::minY);
+  uint32_t const maxY = toTile(rect.maxY(), MercatorBounds::minY);
+  for (uint32_t y = minY; y <= maxY; ++y)
+  {
+    for (uint32_t x = minX; x <= maxX; ++x)
+      tiles.emplace(zoom, x, y);
+  }
+}
+
+void CollectTiles(Index const & index, m2::RectD const & limit, uint32_t zoom,
+                  vector<TileKey> & tiles)
+{
+  vector<shared_ptr<MwmInfo>> mwmsInfo;
+  index.GetMwmsInfo(mwmsInfo);
+
+  set<TileKey> keys;
+  for (shared_ptr<MwmInfo> const & info : mwmsInfo)
+  {
+    // The world mwms have the features of the low scales only.
+    if (info->GetType() != MwmInfo::COUNTRY &&
+        zoom > static_cast<uint32_t>(scales::GetUpperWorldScale()))
+    {
+      continue;
+    }
+
+    m2::RectD rect = info->m_limitRect;
+    if (!limit.IsEmptyInterior() && !rect.Intersect(limit))
+      continue;
+    AddTiles(rect, zoom, keys);
+  }
+  tiles.assign(keys.begin(), keys.end());
+}
+
+struct ZoomStats
+{
+  ZoomStats() : m_tiles(0), m_bytes(0), m_seconds(0) {}
+
+  TileEncoder::Stats m_encoder;
+  size_t m_tiles;
+  uint64_t m_bytes;
+  double m_seconds;
+};
+
+void PrintStats(string const & name, ZoomStats const & stats)
+{
+  double const megabyte = 1024.0 * 1024.0;
+  TileEncoder::Stats const & s = stats.m_encoder;
+  cout << name << "[ tiles:" << stats.m_tiles << " features:" << s.m_features
+       << " geometries:" << s.m_geometries << " shared geometries:" << s.m_sharedGeometries
+       << " points:" << s.m_points << " MB:" << stats.m_bytes / megabyte << " bytes per tile:"
+       << (stats.m_tiles == 0 ? 0.0 : double(stats.m_bytes) / stats.m_tiles)
+       << " seconds:" << stats.m_seconds << " tiles per second:"
+       << (stats.m_seconds == 0 ? 0.0 : stats.m_tiles / stats.m_seconds) << " ]" << endl;
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  google::SetUsageMessage("Exports the local maps to vector tiles");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_output.empty() || FLAGS_min_zoom < 0 || FLAGS_min_zoom > FLAGS_max_zoom ||
+      FLAGS_max_zoom > 30)
+  {
+    cout << google::ProgramUsage() << endl;
+    return 1;
+  }
+
+  m2::RectD limit;
+  if (!FLAGS_rect.empty() && !ParseRect(FLAGS_rect, limit))
+  {
+    cout << "Bad rect " << FLAGS_rect << endl;
+    return 1;
+  }
+
+  classificator::Load();
+
+  Index index;
+  vector<platform::LocalCountryFile> localFiles;
+  platform::FindAllLocalMaps(localFiles);
+  for (platform::LocalCountryFile & localFile : localFiles)
+  {
+    localFile.SyncWithDisk();
+    if (index.RegisterMap(localFile).second != MwmSet::RegResult::Success)
+      LOG(LWARNING, ("Can't register", localFile));
+  }
+
+  threads::TaskScheduler scheduler(static_cast<size_t>(max(FLAGS_threads, 0)));
+  TilesWriter writer(FLAGS_output);
+  size_t const batchSize = static_cast<size_t>(max(FLAGS_batch, 1));
+
+  cout << fixed << setprecision(3);
+  ZoomStats total;
+  for (uint32_t zoom = FLAGS_min_zoom; zoom <= static_cast<uint32_t>(FLAGS_max_zoom); ++zoom)
+  {
+    vector<TileKey> tiles;
+    CollectTiles(index, limit, zoom, tiles);
+    int const scale = min(static_cast<int>(zoom), scales::GetUpperScale());
+
+    ZoomStats stats;
+    uint64_t const startSize = writer.GetSize();
+    my::Timer timer;
+    vector<vector<uint8_t>> blobs;
+    vector<TileEncoder::Stats> encoderStats;
+    for (size_t begin = 0; begin < tiles.size(); begin += batchSize)
+    {
+      size_t const end = min(tiles.size(), begin + batchSize);
+      blobs.assign(end - begin, vector<uint8_t>());
+      encoderStats.assign(end - begin, TileEncoder::Stats());
+
+      threads::ParallelFor(begin, end, [&](size_t i)
+      {
+        TileEncoder encoder(tiles[i], scale);
+        auto addFeature = [&encoder](FeatureType & ft) { encoder.AddFeature(ft); };
+        index.ForEachInRect(addFeature, tiles[i].GetRect(), scale);
+        if (!encoder.IsEmpty())
+          encoder.Encode(blobs[i - begin]);
+        encoderStats[i - begin] = encoder.GetStats();
+      }, 1 /* grainSize */, scheduler);
+
+      // Tiles are written in the order of the keys, as the index of the container needs.
+      for (size_t i = begin; i < end; ++i)
+      {
+        vector<uint8_t> const & blob = blobs[i - begin];
+        if (blob.empty())
+          continue;
+        writer.Add(tiles[i], blob);
+        stats.m_encoder.Add(encoderStats[i - begin]);
+        ++stats.m_tiles;
+      }
+    }
+    stats.m_seconds = timer.ElapsedSeconds();
+    stats.m_bytes = writer.GetSize() - startSize;
+
+    PrintStats("ZOOM " + strings::to_string(zoom), stats);
+    total.m_encoder.Add(stats.m_encoder);
+    total.m_tiles += stats.m_tiles;
+    total.m_bytes += stats.m_bytes;
+    total.m_seconds += stats.m_seconds;
+  }
+
+  writer.Finish();
+  PrintStats("TOTAL", total);
+  cout << "CONTAINER[ tiles:" << writer.GetTilesCount()
+       << " shared tiles:" << writer.GetSharedTilesCount() << " bytes:" << writer.GetSize() << " ]"
+       << endl;
+  return 0;
+}
@@ -0,0 +1,27 @@
+# Exporter of the local maps to vector tiles for the server-side consumers.
+
+TARGET = tile_exporter
+CONFIG += console warn_on
+CONFIG -= app_bundle
+TEMPLATE = app
+
+ROOT_DIR = ..
+DEPENDENCIES = storage indexer platform geometry coding base \
+               gflags jansson protobuf tomcrypt succinct stats_client
+
+include($$ROOT_DIR/common.pri)
+
+INCLUDEPATH *= $$ROOT_DIR/3party/gflags/src
+
+QT *= core
+
+macx-*: LIBS *= "-framework IOKit"
+
+SOURCES += \
+    tile_encoder.cpp \
+    tile_exporter.cpp \
+    tiles_writer.cpp \
+
+HEADERS += \
+    tile_encoder.hpp \
+    tiles_writer.hpp \
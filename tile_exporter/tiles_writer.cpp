@@ -0,0 +1,80 @@
+#include "tile_exporter/tiles_writer.hpp"
+
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+
+namespace tile_exporter
+{
+namespace
+{
+// Bigger tiles are hardly identical and aren't worth to be kept in memory.
+size_t const kMaxSharedBlobSize = 1024;
+
+uint64_t const kIndexOffsetPos = sizeof(TilesWriter::kMagic) + sizeof(uint32_t);
+}  // namespace
+
+// static
+char const TilesWriter::kMagic[8] = {'M', 'W', 'M', 'T', 'I', 'L', 'E', 'S'};
+// static
+uint32_t const TilesWriter::kVersion;
+
+TilesWriter::TilesWriter(string const & path) : m_writer(path), m_sharedCount(0), m_finished(false)
+{
+  m_writer.Write(kMagic, sizeof(kMagic));
+  WriteToSink(m_writer, kVersion);
+  // Offset of the index is written by Finish().
+  WriteToSink(m_writer, static_cast<uint64_t>(0));
+}
+
+void TilesWriter::Add(TileKey const & key, vector<uint8_t> const & blob)
+{
+  ASSERT(!m_finished, ());
+  ASSERT(m_index.empty() || m_index.back().m_key < key, (m_index.back().m_key, key));
+
+  Entry entry;
+  entry.m_key = key;
+  entry.m_size = static_cast<uint32_t>(blob.size());
+  entry.m_offset = GetSize();
+
+  if (blob.size() <= kMaxSharedBlobSize)
+  {
+    auto const res = m_blobs.emplace(string(blob.begin(), blob.end()), entry.m_offset);
+    if (!res.second)
+    {
+      entry.m_offset = res.first->second;
+      ++m_sharedCount;
+      m_index.push_back(entry);
+      return;
+    }
+  }
+
+  m_writer.Write(blob.data(), blob.size());
+  m_index.push_back(entry);
+}
+
+void TilesWriter::Finish()
+{
+  ASSERT(!m_finished, ());
+  m_finished = true;
+
+  uint64_t const indexOffset = GetSize();
+  WriteToSink(m_writer, static_cast<uint32_t>(m_index.size()));
+  for (Entry const & entry : m_index)
+  {
+    WriteToSink(m_writer, entry.m_key.m_zoom);
+    WriteToSink(m_writer, entry.m_key.m_x);
+    WriteToSink(m_writer, entry.m_key.m_y);
+    WriteToSink(m_writer, entry.m_size);
+    WriteToSink(m_writer, entry.m_offset);
+  }
+
+  uint64_t const endPos = GetSize();
+  m_writer.Seek(kIndexOffsetPos);
+  WriteToSink(m_writer, indexOffset);
+  m_writer.Seek(endPos);
+  m_writer.Flush();
+}
+}  // namespace tile_exporter
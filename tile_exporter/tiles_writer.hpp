@@ -0,0 +1,52 @@
+#pragma once
+
+#include "tile_exporter/tile_encoder.hpp"
+
+#include "coding/file_writer.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/unordered_map.hpp"
+#include "std/vector.hpp"
+
+namespace tile_exporter
+{
+/// Writes the tiles to a single file container, alike mbtiles but without sqlite:
+///   header: kMagic, kVersion (uint32_t) and the offset (uint64_t) of the index;
+///   blobs of the tiles;
+///   index: tiles count (uint32_t) and, for each tile in the order of TileKey, zoom, x, y, size
+///   of the blob (uint32_t) and its offset (uint64_t).
+/// All the numbers are little endian. Tiles are streamed to the file as they are added, only
+/// the index is kept in memory. Small identical tiles, e.g. of the sea, share a blob.
+class TilesWriter
+{
+public:
+  static char const kMagic[8];
+  static uint32_t const kVersion = 0;
+
+  explicit TilesWriter(string const & path);
+
+  void Add(TileKey const & key, vector<uint8_t> const & blob);
+  /// Writes the index, no tiles are added after it.
+  void Finish();
+
+  inline size_t GetTilesCount() const { return m_index.size(); }
+  inline size_t GetSharedTilesCount() const { return m_sharedCount; }
+  inline uint64_t GetSize() const { return static_cast<uint64_t>(m_writer.Pos()); }
+
+private:
+  struct Entry
+  {
+    TileKey m_key;
+    uint64_t m_offset;
+    uint32_t m_size;
+  };
+
+  FileWriter m_writer;
+  vector<Entry> m_index;
+  /// Offsets of the small blobs which are shared by the tiles.
+  unordered_map<string, uint64_t> m_blobs;
+  size_t m_sharedCount;
+  bool m_finished;
+};
+}  // namespace tile_exporter
@@ -226,7 +226,7 @@ void BookMarkManager::RemoveCurBookMark()
   if (category)
   {
     category->DeleteBookmark(bookmarkAndCategory.second);
-    category->SaveToKMLFile();
+    category->SaveToFile();
   }
   pFramework->Invalidate();
   ActivateBookMark(pFramework->GetAddressMark(ptOrg)->Copy());
@@ -239,7 +239,7 @@ void BookMarkManager::DeleteBookMark(size_t category, size_t index)
   if (pCategory)
   {
     pCategory->DeleteBookmark(index);
-    pCategory->SaveToKMLFile();
+    pCategory->SaveToFile();
   }
   pFramework->Invalidate();
   ActivateBookMark(0);
@@ -272,7 +272,7 @@ void BookMarkManager::AddCurMarkToBookMarks()
   BookmarkData data(FromTizenString(GetMarkName(pUserMark)), pFramework->LastEditedBMType());
   m2::PointD const ptOrg = pUserMark->GetOrg();
   int i = pFramework->AddBookmark(categoryIndex, ptOrg, data);
-  pFramework->GetBmCategory(categoryIndex)->SaveToKMLFile();
+  pFramework->GetBmCategory(categoryIndex)->SaveToFile();
   pFramework->Invalidate();
   ActivateBookMark(pFramework->GetBmCategory(categoryIndex)->GetBookmark(i)->Copy());
 }
@@ -310,7 +310,7 @@ void BookMarkManager::SetBookMarkMessage(Tizen::Base::String const & s)
     BookmarkData data = pBM->GetData();
     data.SetDescription(FromTizenString(s));
     pFW->ReplaceBookmark(bmAndCat.first, bmAndCat.second, data);
-    pFW->GetBmCategory(bmAndCat.first)->SaveToKMLFile();
+    pFW->GetBmCategory(bmAndCat.first)->SaveToFile();
   }
 }
 
@@ -337,7 +337,7 @@ void BookMarkManager::SetCategoryName(int const index, Tizen::Base::String const
     return;
   BookmarkCategory * pCategory = GetFramework()->GetBmCategory(index);
   pCategory->SetName(FromTizenString(sName));
-  pCategory->SaveToKMLFile();
+  pCategory->SaveToFile();
 }
 
 Tizen::Base::String BookMarkManager::GetCurrentCategoryName() const
@@ -354,7 +354,7 @@ int BookMarkManager::AddCategory(Tizen::Base::String const & sName) const
   {
     Framework * pFW = GetFramework();
     int i = pFW->AddCategory(FromTizenString(sName));
-    pFW->GetBmCategory(i)->SaveToKMLFile();
+    pFW->GetBmCategory(i)->SaveToFile();
     return i;
   }
   return -1;
@@ -385,8 +385,8 @@ void BookMarkManager::SetNewCurBookMarkCategory(int const nNewCategory)
   if (nNewCategory == bmAndCat.first)
     return;
   int newIndex = pFW->MoveBookmark(bmAndCat.second, bmAndCat.first, nNewCategory);
-  pFW->GetBmCategory(bmAndCat.first)->SaveToKMLFile();
-  pFW->GetBmCategory(nNewCategory)->SaveToKMLFile();
+  pFW->GetBmCategory(bmAndCat.first)->SaveToFile();
+  pFW->GetBmCategory(nNewCategory)->SaveToFile();
 
   Bookmark const * bookmark = pFW->GetBmCategory(nNewCategory)->GetBookmark(newIndex);
   m_pCurBookMarkCopy.reset(bookmark->Copy());
@@ -402,7 +402,7 @@ void BookMarkManager::SetCurBookMarkColor(EColor const color)
     BookmarkData data = pBM->GetData();
     data.SetType(fromEColorTostring(color));
     pFW->ReplaceBookmark(bmAndCat.first, bmAndCat.second, data);
-    pFW->GetBmCategory(bmAndCat.first)->SaveToKMLFile();
+    pFW->GetBmCategory(bmAndCat.first)->SaveToFile();
     pFW->Invalidate();
   }
 }
@@ -429,7 +429,7 @@ void BookMarkManager::SetCategoryVisible(int index, bool bVisible)
   if (index >= pFW->GetBmCategoriesCount())
     return;
   pFW->GetBmCategory(index)->SetVisible(bVisible);
-  pFW->GetBmCategory(index)->SaveToKMLFile();
+  pFW->GetBmCategory(index)->SaveToFile();
   pFW->Invalidate();
 }
 
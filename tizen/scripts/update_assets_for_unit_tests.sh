@@ -10,7 +10,7 @@ DST=$1
 
 files=(copyright.html resources-ldpi resources-mdpi resources-hdpi resources-xhdpi resources-xxhdpi categories.txt classificator.txt
        types.txt fonts_blacklist.txt fonts_whitelist.txt languages.txt unicode_blocks.txt \
-       drules_proto.bin packed_polygons.bin countries.txt World.mwm WorldCoasts.mwm 00_roboto_regular.ttf 01_dejavusans.ttf 02_droidsans-fallback.ttf
+       drules_proto.bin packed_polygons.bin countries.txt countries.bin World.mwm WorldCoasts.mwm 00_roboto_regular.ttf 01_dejavusans.ttf 02_droidsans-fallback.ttf
        03_jomolhari-id-a3d.ttf 04_padauk.ttf 05_khmeros.ttf 06_code2000.ttf
        minsk-pass.mwm)
 
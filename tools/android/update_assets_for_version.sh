@@ -12,7 +12,7 @@ files=(copyright.html faq.html resources-ldpi resources-mdpi resources-hdpi reso
        resources-ldpi_dark resources-mdpi_dark resources-hdpi_dark resources-xhdpi_dark resources-xxhdpi_dark
        resources-ldpi_clear resources-mdpi_clear resources-hdpi_clear resources-xhdpi_clear resources-xxhdpi_clear
        types.txt fonts_blacklist.txt fonts_whitelist.txt languages.txt unicode_blocks.txt
-       drules_proto.bin drules_proto_dark.bin drules_proto_clear.bin city_rank.txt external_resources.txt packed_polygons.bin countries.txt sound-strings)
+       drules_proto.bin drules_proto_dark.bin drules_proto_clear.bin city_rank.txt external_resources.txt packed_polygons.bin countries.txt countries.bin sound-strings)
 
 for item in ${files[*]}
 do
@@ -393,11 +393,13 @@ if [ "$MODE" == "resources" ]; then
     sed -e "s/\"v\":[0-9]\\{6\\}/\"v\":$UPDATE_DATE/" "$TARGET/countries.txt" > "$INTDIR/countries.txt"
     mv "$INTDIR/countries.txt" "$TARGET"
   fi
+  # The binary countries file is built from the final countries.txt
+  "$GENERATOR_TOOL" --data_path="$TARGET" --user_resource_path="$TARGET/" -generate_countries_binary 2>> "$PLANET_LOG"
   # A quick fix: chmodding to a+rw all generated files
   for file in "$TARGET"/*.mwm*; do
     chmod 0666 "$file"
   done
-  chmod 0666 "$TARGET/countries.txt"
+  chmod 0666 "$TARGET/countries.txt" "$TARGET/countries.bin"
 
   if [ -n "$OPT_WORLD" ]; then
     # Update external resources